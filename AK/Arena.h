@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// Hands out memory by bumping a pointer through a few large chunks, which are all freed at once when
+// the arena goes away. This is meant for things like syntax trees, where lots of small objects are
+// created together and die together.
+//
+// Objects that need to be destroyed are remembered when they are made, and their destructors run
+// (in reverse order of construction) when the arena is cleared. Trivially destructible objects
+// don't cost anything extra.
+class Arena {
+    AK_MAKE_NONCOPYABLE(Arena);
+
+public:
+    static constexpr size_t default_chunk_size = 64 * KiB;
+    static constexpr size_t default_alignment = 2 * sizeof(void*);
+
+    explicit Arena(size_t chunk_size = default_chunk_size)
+        : m_chunk_size(chunk_size)
+    {
+    }
+
+    Arena(Arena&& other)
+        : m_chunk_size(other.m_chunk_size)
+        , m_current_chunk(exchange(other.m_current_chunk, nullptr))
+        , m_destructors(exchange(other.m_destructors, nullptr))
+        , m_next(exchange(other.m_next, 0))
+        , m_end(exchange(other.m_end, 0))
+        , m_allocated_bytes(exchange(other.m_allocated_bytes, 0))
+    {
+    }
+
+    Arena& operator=(Arena&& other)
+    {
+        if (this != &other) {
+            clear();
+            m_chunk_size = other.m_chunk_size;
+            m_current_chunk = exchange(other.m_current_chunk, nullptr);
+            m_destructors = exchange(other.m_destructors, nullptr);
+            m_next = exchange(other.m_next, 0);
+            m_end = exchange(other.m_end, 0);
+            m_allocated_bytes = exchange(other.m_allocated_bytes, 0);
+        }
+        return *this;
+    }
+
+    ~Arena() { clear(); }
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = default_alignment)
+    {
+        VERIFY(alignment && !(alignment & (alignment - 1)));
+        FlatPtr address = (m_next + alignment - 1) & ~(alignment - 1);
+        if (!m_current_chunk || address + size > m_end) [[unlikely]] {
+            add_chunk(size + alignment);
+            address = (m_next + alignment - 1) & ~(alignment - 1);
+        }
+        m_next = address + size;
+        m_allocated_bytes += size;
+        return reinterpret_cast<void*>(address);
+    }
+
+    // Returns storage for count objects of type T, which the caller has to construct itself.
+    template<typename T>
+    [[nodiscard]] T* allocate_uninitialized(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    T& make(Args&&... args)
+    {
+        auto* storage = allocate(sizeof(T), alignof(T));
+        auto* object = new (storage) T(forward<Args>(args)...);
+        if constexpr (!IsTriviallyDestructible<T>)
+            track_destruction(object, [](void* object) { static_cast<T*>(object)->~T(); });
+        return *object;
+    }
+
+    // Runs all pending destructors and frees every chunk, after which the arena can be used again.
+    void clear()
+    {
+        for (auto* destructor = m_destructors; destructor; destructor = destructor->previous)
+            destructor->destroy(destructor->object);
+        m_destructors = nullptr;
+
+        while (m_current_chunk) {
+            auto* previous = m_current_chunk->previous;
+            kfree_sized(m_current_chunk, m_current_chunk->size);
+            m_current_chunk = previous;
+        }
+        m_next = 0;
+        m_end = 0;
+        m_allocated_bytes = 0;
+    }
+
+    [[nodiscard]] size_t allocated_bytes() const { return m_allocated_bytes; }
+
+private:
+    struct Chunk {
+        Chunk* previous;
+        size_t size;
+    };
+
+    struct Destructor {
+        Destructor* previous;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    void track_destruction(void* object, void (*destroy)(void*))
+    {
+        auto* destructor = new (allocate(sizeof(Destructor), alignof(Destructor))) Destructor { m_destructors, destroy, object };
+        m_destructors = destructor;
+    }
+
+    void add_chunk(size_t minimum_size)
+    {
+        // Allocations that don't fit into a regular chunk get one of their own.
+        size_t size = max(m_chunk_size, sizeof(Chunk) + minimum_size);
+        auto* chunk = static_cast<Chunk*>(kmalloc(size));
+        VERIFY(chunk);
+        chunk->previous = m_current_chunk;
+        chunk->size = size;
+        m_current_chunk = chunk;
+        m_next = reinterpret_cast<FlatPtr>(chunk + 1);
+        m_end = reinterpret_cast<FlatPtr>(chunk) + size;
+    }
+
+    size_t m_chunk_size { default_chunk_size };
+    Chunk* m_current_chunk { nullptr };
+    Destructor* m_destructors { nullptr };
+    FlatPtr m_next { 0 };
+    FlatPtr m_end { 0 };
+    size_t m_allocated_bytes { 0 };
+};
+
+// A growable array whose storage lives in an Arena. Growing leaves the old storage behind in the arena,
+// so this works best when the final size is roughly known up front, or when it stays small.
+template<typename T>
+class ArenaVector {
+    AK_MAKE_NONCOPYABLE(ArenaVector);
+
+public:
+    explicit ArenaVector(Arena& arena)
+        : m_arena(arena)
+    {
+    }
+
+    ArenaVector(ArenaVector&& other)
+        : m_arena(other.m_arena)
+        , m_elements(exchange(other.m_elements, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+    {
+    }
+
+    ~ArenaVector() { clear(); }
+
+    [[nodiscard]] bool is_empty() const { return !m_size; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    [[nodiscard]] T* data() { return m_elements; }
+    [[nodiscard]] const T* data() const { return m_elements; }
+
+    [[nodiscard]] Span<T> span() { return { m_elements, m_size }; }
+    [[nodiscard]] Span<const T> span() const { return { m_elements, m_size }; }
+
+    T& at(size_t i)
+    {
+        VERIFY(i < m_size);
+        return m_elements[i];
+    }
+    const T& at(size_t i) const
+    {
+        VERIFY(i < m_size);
+        return m_elements[i];
+    }
+    T& operator[](size_t i) { return at(i); }
+    const T& operator[](size_t i) const { return at(i); }
+
+    T& first() { return at(0); }
+    const T& first() const { return at(0); }
+    T& last() { return at(m_size - 1); }
+    const T& last() const { return at(m_size - 1); }
+
+    T* begin() { return m_elements; }
+    T* end() { return m_elements + m_size; }
+    const T* begin() const { return m_elements; }
+    const T* end() const { return m_elements + m_size; }
+
+    template<typename... Args>
+    T& empend(Args&&... args)
+    {
+        grow_if_needed();
+        return *new (&m_elements[m_size++]) T(forward<Args>(args)...);
+    }
+
+    void append(T&& value) { empend(move(value)); }
+    void append(const T& value) { empend(value); }
+
+    void ensure_capacity(size_t capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+        auto* new_elements = m_arena.allocate_uninitialized<T>(capacity);
+        for (size_t i = 0; i < m_size; ++i) {
+            new (&new_elements[i]) T(move(m_elements[i]));
+            m_elements[i].~T();
+        }
+        m_elements = new_elements;
+        m_capacity = capacity;
+    }
+
+    void clear()
+    {
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_size; ++i)
+                m_elements[i].~T();
+        }
+        m_size = 0;
+    }
+
+private:
+    void grow_if_needed()
+    {
+        if (m_size == m_capacity)
+            ensure_capacity(max(static_cast<size_t>(4), m_capacity * 2));
+    }
+
+    Arena& m_arena;
+    T* m_elements { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+};
+
+}
+
+using AK::Arena;
+using AK::ArenaVector;
@@ -4,14 +4,23 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
 #include <AK/Optional.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/String.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
 
+#ifdef KERNEL
+#    include <Kernel/Arch/x86/Processor.h>
+#else
+#    include <sched.h>
+#endif
+
 namespace AK {
 
 struct FlyStringImplTraits : public Traits<StringImpl*> {
@@ -24,16 +33,59 @@ struct FlyStringImplTraits : public Traits<StringImpl*> {
     }
 };
 
-static AK::Singleton<HashTable<StringImpl*, FlyStringImplTraits>> s_table;
+// The table is split into shards, each with a lock of its own, so threads interning different strings
+// rarely have to wait for each other. The locks are only ever held for a single lookup or insertion.
+class FlyStringTable {
+public:
+    static constexpr size_t shard_count = 64;
+
+    template<typename Callback>
+    decltype(auto) with_shard(unsigned hash, Callback callback)
+    {
+        // The buckets within a shard are picked by the lower bits of the hash, so the upper ones pick the shard.
+        auto& shard = m_shards[hash >> 26];
+        while (shard.locked.exchange(true, AK::MemoryOrder::memory_order_acquire)) {
+#ifdef KERNEL
+            Kernel::Processor::wait_check();
+#else
+            sched_yield();
+#endif
+        }
+        ScopeGuard unlock_guard = [&] { shard.locked.store(false, AK::MemoryOrder::memory_order_release); };
+        return callback(shard.impls);
+    }
+
+private:
+    struct Shard {
+        Atomic<bool> locked { false };
+        HashTable<StringImpl*, FlyStringImplTraits> impls;
+    };
+
+    Array<Shard, shard_count> m_shards;
+};
+
+static_assert(FlyStringTable::shard_count == 1 << (32 - 26));
 
-static HashTable<StringImpl*, FlyStringImplTraits>& fly_impls()
+static AK::Singleton<FlyStringTable> s_table;
+
+// An impl that is still in the table may already be on its way to destruction on another thread, in which case
+// it's about to be removed, and must not be handed out anymore.
+static RefPtr<StringImpl> try_adopt_fly_impl(StringImpl* impl)
 {
-    return *s_table;
+    VERIFY(impl->is_fly());
+    if (!impl->try_ref())
+        return nullptr;
+    return adopt_ref(*impl);
 }
 
 void FlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    s_table->with_shard(impl.hash(), [&](auto& impls) {
+        // If the same string has been interned again in the meantime, it took this impl's place in the table.
+        auto it = impls.find(impl.hash(), [&](auto* candidate) { return candidate == &impl; });
+        if (it != impls.end())
+            impls.remove(it);
+    });
 }
 
 FlyString::FlyString(const String& string)
@@ -44,33 +96,37 @@ FlyString::FlyString(const String& string)
         m_impl = string.impl();
         return;
     }
-    auto it = fly_impls().find(const_cast<StringImpl*>(string.impl()));
-    if (it == fly_impls().end()) {
-        fly_impls().set(const_cast<StringImpl*>(string.impl()));
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+    auto* impl = const_cast<StringImpl*>(string.impl());
+    m_impl = s_table->with_shard(impl->hash(), [&](auto& impls) -> RefPtr<StringImpl> {
+        auto it = impls.find(impl);
+        if (it != impls.end()) {
+            if (auto existing_impl = try_adopt_fly_impl(*it))
+                return existing_impl;
+        }
+        impls.set(impl);
+        impl->set_fly({}, true);
+        return impl;
+    });
 }
 
 FlyString::FlyString(StringView const& string)
 {
     if (string.is_null())
         return;
-    auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
-        return string == candidate;
-    });
-    if (it == fly_impls().end()) {
+    auto hash = string.hash();
+    m_impl = s_table->with_shard(hash, [&](auto& impls) -> RefPtr<StringImpl> {
+        auto it = impls.find(hash, [&](auto& candidate) {
+            return string == candidate;
+        });
+        if (it != impls.end()) {
+            if (auto existing_impl = try_adopt_fly_impl(*it))
+                return existing_impl;
+        }
         auto new_string = string.to_string();
-        fly_impls().set(new_string.impl());
+        impls.set(new_string.impl());
         new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+        return new_string.impl();
+    });
 }
 
 template<typename T>
@@ -8,6 +8,7 @@
 
 #include <AK/Forward.h>
 #include <AK/HashFunctions.h>
+#include <AK/SIMD.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <AK/kmalloc.h>
@@ -25,6 +26,90 @@ enum class HashSetExistingEntryBehavior {
     Replace
 };
 
+namespace Detail {
+
+// Every bucket has a control byte, which is kept in an array of its own. Full buckets store 7 bits of
+// the hash there, so probing can skip over most buckets holding other values without touching them.
+static constexpr i8 hash_table_control_empty = -128;
+static constexpr i8 hash_table_control_deleted = -2;
+static constexpr i8 hash_table_control_sentinel = -1;
+
+ALWAYS_INLINE constexpr bool hash_table_control_is_full(i8 control) { return control >= 0; }
+
+// A set of matching buckets within a group, as a bit mask with one bit (or one byte) per bucket.
+template<typename MaskType, size_t width, size_t shift>
+class HashTableBitMask {
+public:
+    explicit HashTableBitMask(MaskType mask)
+        : m_mask(mask)
+    {
+    }
+
+    explicit operator bool() const { return m_mask != 0; }
+
+    size_t lowest_set_bit() const { return __builtin_ctzll(m_mask) >> shift; }
+    void clear_lowest_set_bit() { m_mask &= m_mask - 1; }
+
+    size_t trailing_zeros() const { return m_mask ? lowest_set_bit() : width; }
+    size_t leading_zeros() const
+    {
+        if (!m_mask)
+            return width;
+        constexpr size_t unused_bits = 64 - (width << shift);
+        return (__builtin_clzll(m_mask) - unused_bits) >> shift;
+    }
+
+private:
+    MaskType m_mask;
+};
+
+#ifdef __SSE2__
+// Looks at 16 control bytes at once.
+class HashTableGroup {
+public:
+    static constexpr size_t width = 16;
+    using BitMask = HashTableBitMask<u32, width, 0>;
+
+    explicit HashTableGroup(const i8* control) { __builtin_memcpy(&m_control, control, width); }
+
+    BitMask match(i8 hash) const { return mask_of(m_control == hash); }
+    BitMask match_empty() const { return mask_of(m_control == hash_table_control_empty); }
+    BitMask match_empty_or_deleted() const { return mask_of(m_control < hash_table_control_sentinel); }
+
+private:
+    static BitMask mask_of(SIMD::i8x16 comparison) { return BitMask(__builtin_ia32_pmovmskb128((SIMD::c8x16)comparison)); }
+
+    SIMD::i8x16 m_control;
+};
+#else
+// Looks at 8 control bytes at once, using bit tricks on a u64 where SSE2 isn't available (like in the kernel).
+class HashTableGroup {
+public:
+    static constexpr size_t width = 8;
+    using BitMask = HashTableBitMask<u64, width, 3>;
+
+    explicit HashTableGroup(const i8* control) { __builtin_memcpy(&m_control, control, width); }
+
+    // NOTE: This can also match a full bucket right after a matching one, callers have to compare the value anyway.
+    BitMask match(i8 hash) const
+    {
+        auto bytes = m_control ^ (lsbs * (u8)hash);
+        return BitMask((bytes - lsbs) & ~bytes & msbs);
+    }
+
+    BitMask match_empty() const { return BitMask(m_control & (~m_control << 6) & msbs); }
+    BitMask match_empty_or_deleted() const { return BitMask(m_control & (~m_control << 7) & msbs); }
+
+private:
+    static constexpr u64 lsbs = 0x0101010101010101ull;
+    static constexpr u64 msbs = 0x8080808080808080ull;
+
+    u64 m_control;
+};
+#endif
+
+}
+
 template<typename HashTableType, typename T, typename BucketType>
 class HashTableIterator {
     friend HashTableType;
@@ -43,19 +128,20 @@ private:
             return;
         do {
             ++m_bucket;
-            if (m_bucket->used)
-                return;
-        } while (!m_bucket->end);
-        if (m_bucket->end)
+            ++m_control;
+        } while (*m_control < Detail::hash_table_control_sentinel);
+        if (*m_control == Detail::hash_table_control_sentinel)
             m_bucket = nullptr;
     }
 
-    explicit HashTableIterator(BucketType* bucket)
+    HashTableIterator(BucketType* bucket, const i8* control)
         : m_bucket(bucket)
+        , m_control(control)
     {
     }
 
     BucketType* m_bucket { nullptr };
+    const i8* m_control { nullptr };
 };
 
 template<typename OrderedHashTableType, typename T, typename BucketType>
@@ -81,12 +167,15 @@ private:
 
 template<typename T, typename TraitsForT, bool IsOrdered>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
+    using Group = Detail::HashTableGroup;
+
+    // Full buckets are allowed to take up 7/8 of the table, as the control bytes keep probing
+    // through long runs of them cheap.
+    static constexpr size_t max_load_numerator = 7;
+    static constexpr size_t max_load_denominator = 8;
+    static constexpr size_t minimum_capacity = 7;
 
     struct Bucket {
-        bool used;
-        bool deleted;
-        bool end;
         alignas(T) u8 storage[sizeof(T)];
 
         T* slot() { return reinterpret_cast<T*>(storage); }
@@ -96,8 +185,6 @@ class HashTable {
     struct OrderedBucket {
         OrderedBucket* previous;
         OrderedBucket* next;
-        bool used;
-        bool deleted;
         alignas(T) u8 storage[sizeof(T)];
         T* slot() { return reinterpret_cast<T*>(storage); }
         const T* slot() const { return reinterpret_cast<const T*>(storage); }
@@ -115,6 +202,31 @@ class HashTable {
 
     using CollectionDataType = Conditional<IsOrdered, OrderedCollectionData, CollectionData>;
 
+    // Visits the groups starting at the hash and then at increasing distances from it. As the capacity is
+    // one less than a power of two, this eventually looks at all of them.
+    class ProbeSequence {
+    public:
+        ProbeSequence(unsigned hash, size_t mask)
+            : m_mask(mask)
+            , m_offset(hash & mask)
+        {
+        }
+
+        size_t offset() const { return m_offset; }
+        size_t offset(size_t i) const { return (m_offset + i) & m_mask; }
+
+        void next()
+        {
+            m_index += Group::width;
+            m_offset = (m_offset + m_index) & m_mask;
+        }
+
+    private:
+        size_t m_mask;
+        size_t m_offset;
+        size_t m_index { 0 };
+    };
+
 public:
     HashTable() = default;
     explicit HashTable(size_t capacity) { rehash(capacity); }
@@ -125,7 +237,7 @@ public:
             return;
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
+            if (Detail::hash_table_control_is_full(m_control[i]))
                 m_buckets[i].slot()->~T();
         }
 
@@ -148,6 +260,7 @@ public:
 
     HashTable(HashTable&& other) noexcept
         : m_buckets(other.m_buckets)
+        , m_control(other.m_control)
         , m_collection_data(other.m_collection_data)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
@@ -157,6 +270,7 @@ public:
         other.m_capacity = 0;
         other.m_deleted_count = 0;
         other.m_buckets = nullptr;
+        other.m_control = nullptr;
         if constexpr (IsOrdered)
             other.m_collection_data = { nullptr, nullptr };
     }
@@ -171,6 +285,7 @@ public:
     friend void swap(HashTable& a, HashTable& b) noexcept
     {
         swap(a.m_buckets, b.m_buckets);
+        swap(a.m_control, b.m_control);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
         swap(a.m_deleted_count, b.m_deleted_count);
@@ -194,7 +309,7 @@ public:
     void ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        rehash(capacity * 2);
+        rehash(capacity * max_load_denominator / max_load_numerator + 1);
     }
 
     [[nodiscard]] bool contains(T const& value) const
@@ -208,19 +323,20 @@ public:
 
     [[nodiscard]] Iterator begin()
     {
-        if constexpr (IsOrdered)
+        if constexpr (IsOrdered) {
             return Iterator(m_collection_data.head);
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return Iterator(&m_buckets[i]);
+        } else {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Detail::hash_table_control_is_full(m_control[i]))
+                    return Iterator(&m_buckets[i], &m_control[i]);
+            }
+            return end();
         }
-        return end();
     }
 
     [[nodiscard]] Iterator end()
     {
-        return Iterator(nullptr);
+        return iterator_for<Iterator>(nullptr);
     }
 
     using ConstIterator = Conditional<IsOrdered,
@@ -229,19 +345,20 @@ public:
 
     [[nodiscard]] ConstIterator begin() const
     {
-        if constexpr (IsOrdered)
+        if constexpr (IsOrdered) {
             return ConstIterator(m_collection_data.head);
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return ConstIterator(&m_buckets[i]);
+        } else {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Detail::hash_table_control_is_full(m_control[i]))
+                    return ConstIterator(&m_buckets[i], &m_control[i]);
+            }
+            return end();
         }
-        return end();
     }
 
     [[nodiscard]] ConstIterator end() const
     {
-        return ConstIterator(nullptr);
+        return iterator_for<ConstIterator>(nullptr);
     }
 
     void clear()
@@ -252,30 +369,17 @@ public:
     template<typename U = T>
     HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behaviour = HashSetExistingEntryBehavior::Replace)
     {
-        auto& bucket = lookup_for_writing(value);
-        if (bucket.used) {
+        auto hash = TraitsForT::hash(value);
+        if (auto* existing_bucket = lookup_with_hash(hash, [&](auto& other) { return TraitsForT::equals(other, value); })) {
             if (existing_entry_behaviour == HashSetExistingEntryBehavior::Keep)
                 return HashSetResult::KeptExistingEntry;
-            (*bucket.slot()) = forward<U>(value);
+            (*existing_bucket->slot()) = forward<U>(value);
             return HashSetResult::ReplacedExistingEntry;
         }
 
+        auto& bucket = claim_bucket(hash);
         new (bucket.slot()) T(forward<U>(value));
-        bucket.used = true;
-        if (bucket.deleted) {
-            bucket.deleted = false;
-            --m_deleted_count;
-        }
-
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = &bucket;
-            } else {
-                bucket.previous = m_collection_data.tail;
-                m_collection_data.tail->next = &bucket;
-            }
-            m_collection_data.tail = &bucket;
-        }
+        append_to_collection(bucket);
 
         ++m_size;
         return HashSetResult::InsertedNewEntry;
@@ -284,7 +388,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
     {
-        return Iterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_for<Iterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] Iterator find(T const& value)
@@ -295,7 +399,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_for<ConstIterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] ConstIterator find(T const& value) const
@@ -317,17 +421,25 @@ public:
     {
         VERIFY(iterator.m_bucket);
         auto& bucket = *iterator.m_bucket;
-        VERIFY(bucket.used);
-        VERIFY(!bucket.deleted);
-
-        if constexpr (!IsOrdered)
-            VERIFY(!bucket.end);
+        size_t index = &bucket - m_buckets;
+        VERIFY(Detail::hash_table_control_is_full(m_control[index]));
 
         bucket.slot()->~T();
-        bucket.used = false;
-        bucket.deleted = true;
         --m_size;
-        ++m_deleted_count;
+
+        // If there never were enough full buckets around this one to fill a whole group, no probe sequence
+        // can have passed over it, so it can become empty again. Otherwise, it has to be marked as deleted,
+        // which is cleaned up the next time the table is rehashed.
+        size_t index_before = (index - Group::width) & m_capacity;
+        auto empty_after = Group(m_control + index).match_empty();
+        auto empty_before = Group(m_control + index_before).match_empty();
+        bool was_never_full = empty_before && empty_after && empty_after.trailing_zeros() + empty_before.leading_zeros() < Group::width;
+        if (was_never_full) {
+            set_control(index, Detail::hash_table_control_empty);
+        } else {
+            set_control(index, Detail::hash_table_control_deleted);
+            ++m_deleted_count;
+        }
 
         if constexpr (IsOrdered) {
             if (bucket.previous)
@@ -343,57 +455,82 @@ public:
     }
 
 private:
-    void insert_during_rehash(T&& value)
+    template<typename IteratorType>
+    IteratorType iterator_for(BucketType* bucket) const
     {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.used = true;
+        if constexpr (IsOrdered)
+            return IteratorType(bucket);
+        else
+            return IteratorType(bucket, bucket ? m_control + (bucket - m_buckets) : nullptr);
+    }
 
+    void append_to_collection(BucketType& bucket)
+    {
         if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
+            bucket.previous = m_collection_data.tail;
+            bucket.next = nullptr;
+            if (!m_collection_data.head) [[unlikely]]
                 m_collection_data.head = &bucket;
-            } else {
-                bucket.previous = m_collection_data.tail;
+            else
                 m_collection_data.tail->next = &bucket;
-            }
             m_collection_data.tail = &bucket;
         }
     }
 
+    void insert_during_rehash(T&& value)
+    {
+        auto hash = TraitsForT::hash(value);
+        auto index = find_first_non_full(hash);
+        set_control(index, control_hash(hash));
+
+        auto& bucket = m_buckets[index];
+        new (bucket.slot()) T(move(value));
+        append_to_collection(bucket);
+    }
+
+    // The lower bits of the hash pick the first group to probe, so the control byte is taken from the upper bits
+    // of the hash mixed once more.
+    [[nodiscard]] static i8 control_hash(unsigned hash) { return static_cast<i8>((hash * 0x9e3779b1u) >> 25); }
+
+    // There is a sentinel after the last control byte, to find the end of the table when iterating, followed by
+    // copies of the first control bytes, so groups can be loaded at any offset without wrapping around.
     [[nodiscard]] static size_t size_in_bytes(size_t capacity)
     {
-        if constexpr (IsOrdered) {
-            return sizeof(BucketType) * capacity;
-        } else {
-            return sizeof(BucketType) * (capacity + 1);
-        }
+        return sizeof(BucketType) * capacity + capacity + Group::width;
+    }
+
+    [[nodiscard]] static constexpr size_t max_load(size_t capacity)
+    {
+        return capacity * max_load_numerator / max_load_denominator;
+    }
+
+    void set_control(size_t index, i8 control)
+    {
+        m_control[index] = control;
+        m_control[((index - (Group::width - 1)) & m_capacity) + ((Group::width - 1) & m_capacity)] = control;
     }
 
     void rehash(size_t new_capacity)
     {
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
-        new_capacity = kmalloc_good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
+        // The capacity is always one less than a power of two, so it can be used as the mask for the probe sequence.
+        new_capacity = max(new_capacity, minimum_capacity);
+        new_capacity = (static_cast<size_t>(1) << (sizeof(size_t) * 8 - __builtin_clzl(new_capacity))) - 1;
 
         auto* old_buckets = m_buckets;
         auto old_capacity = m_capacity;
         Iterator old_iter = begin();
 
-        if constexpr (IsOrdered) {
-            m_buckets = (BucketType*)kmalloc(size_in_bytes(new_capacity));
-            __builtin_memset(m_buckets, 0, size_in_bytes(new_capacity));
+        m_buckets = (BucketType*)kmalloc(size_in_bytes(new_capacity));
+        m_control = reinterpret_cast<i8*>(m_buckets + new_capacity);
+        __builtin_memset(m_control, Detail::hash_table_control_empty, new_capacity + Group::width);
+        m_control[new_capacity] = Detail::hash_table_control_sentinel;
 
+        if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        } else {
-            m_buckets = (BucketType*)kmalloc(size_in_bytes(new_capacity));
-            __builtin_memset(m_buckets, 0, size_in_bytes(new_capacity));
-        }
 
         m_capacity = new_capacity;
         m_deleted_count = 0;
 
-        if constexpr (!IsOrdered)
-            m_buckets[m_capacity].end = true;
-
         if (!old_buckets)
             return;
 
@@ -411,48 +548,54 @@ private:
         if (is_empty())
             return nullptr;
 
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (bucket.used && predicate(*bucket.slot()))
-                return &bucket;
-
-            if (!bucket.used && !bucket.deleted)
+        auto control = control_hash(hash);
+        for (ProbeSequence probe(hash, m_capacity);; probe.next()) {
+            Group group(m_control + probe.offset());
+            for (auto match = group.match(control); match; match.clear_lowest_set_bit()) {
+                auto& bucket = m_buckets[probe.offset(match.lowest_set_bit())];
+                if (predicate(*bucket.slot()))
+                    return &bucket;
+            }
+            if (group.match_empty())
                 return nullptr;
-
-            hash = double_hash(hash);
         }
     }
 
-    [[nodiscard]] BucketType& lookup_for_writing(T const& value)
+    [[nodiscard]] size_t find_first_non_full(unsigned hash) const
     {
-        if (should_grow())
-            rehash(capacity() * 2);
-
-        auto hash = TraitsForT::hash(value);
-        BucketType* first_empty_bucket = nullptr;
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (bucket.used && TraitsForT::equals(*bucket.slot(), value))
-                return bucket;
-
-            if (!bucket.used) {
-                if (!first_empty_bucket)
-                    first_empty_bucket = &bucket;
+        for (ProbeSequence probe(hash, m_capacity);; probe.next()) {
+            auto mask = Group(m_control + probe.offset()).match_empty_or_deleted();
+            if (mask)
+                return probe.offset(mask.lowest_set_bit());
+        }
+    }
 
-                if (!bucket.deleted)
-                    return *const_cast<BucketType*>(first_empty_bucket);
-            }
+    // Finds a bucket for a new value with the given hash and marks it as full, growing the table if needed.
+    [[nodiscard]] BucketType& claim_bucket(unsigned hash)
+    {
+        if (!m_buckets)
+            rehash(minimum_capacity);
 
-            hash = double_hash(hash);
+        auto index = find_first_non_full(hash);
+        if (m_control[index] == Detail::hash_table_control_empty && used_bucket_count() + 1 > max_load(m_capacity)) {
+            // If most of the used buckets are deleted ones, getting rid of them makes enough room.
+            if (m_size * 32 <= m_capacity * 25)
+                rehash(m_capacity);
+            else
+                rehash(m_capacity * 2 + 1);
+            index = find_first_non_full(hash);
         }
+
+        if (m_control[index] == Detail::hash_table_control_deleted)
+            --m_deleted_count;
+        set_control(index, control_hash(hash));
+        return m_buckets[index];
     }
 
     [[nodiscard]] size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    [[nodiscard]] bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
 
     BucketType* m_buckets { nullptr };
+    i8* m_control { nullptr };
 
     [[no_unique_address]] CollectionDataType m_collection_data;
     size_t m_size { 0 };
@@ -8,6 +8,7 @@
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonParser.h>
+#include <AK/SIMD.h>
 
 namespace AK {
 
@@ -16,108 +17,122 @@ constexpr bool is_space(int ch)
     return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
 }
 
-String JsonParser::consume_and_unescape_string()
+static constexpr bool is_special_string_character(char ch)
 {
-    if (!consume_specific('"'))
-        return {};
-    StringBuilder final_sb;
+    return ch == '"' || ch == '\\' || is_ascii_c0_control(ch);
+}
 
-    for (;;) {
-        size_t peek_index = m_index;
-        char ch = 0;
-        for (;;) {
-            if (peek_index == m_input.length())
-                break;
-            ch = m_input[peek_index];
-            if (ch == '"' || ch == '\\')
-                break;
-            if (is_ascii_c0_control(ch))
-                return {};
-            ++peek_index;
-        }
+// Returns the index of the first quote, backslash or control character at or after `index`, as everything up to there
+// can be taken over from the input as it is.
+static size_t find_special_string_character(const StringView& input, size_t index)
+{
+    auto* characters = input.characters_without_null_termination();
+#ifdef __SSE2__
+    // Looks at 16 characters at once.
+    for (; index + 16 <= input.length(); index += 16) {
+        SIMD::c8x16 chunk;
+        __builtin_memcpy(&chunk, characters + index, 16);
+        auto specials = (chunk == '"') | (chunk == '\\') | ((SIMD::u8x16)chunk < 0x20);
+        if (auto mask = __builtin_ia32_pmovmskb128((SIMD::c8x16)specials))
+            return index + __builtin_ctz(mask);
+    }
+#else
+    // Looks at 8 characters at once, using bit tricks on a u64 where SSE2 isn't available (like in the kernel). These can
+    // also match a character right after a special one, so the exact position is left for the loop below.
+    constexpr u64 lsbs = 0x0101010101010101ull;
+    constexpr u64 msbs = 0x8080808080808080ull;
+    auto has_zero_byte = [&](u64 word) { return (word - lsbs) & ~word & msbs; };
+    for (; index + 8 <= input.length(); index += 8) {
+        u64 word;
+        __builtin_memcpy(&word, characters + index, 8);
+        if (has_zero_byte(word ^ (lsbs * '"')) | has_zero_byte(word ^ (lsbs * '\\')) | ((word - lsbs * 0x20) & ~word & msbs))
+            break;
+    }
+#endif
+    while (index < input.length() && !is_special_string_character(characters[index]))
+        ++index;
+    return index;
+}
 
-        while (peek_index != m_index) {
-            final_sb.append(m_input[m_index]);
-            m_index++;
-        }
+Optional<StringView> JsonParser::consume_string()
+{
+    if (!consume_specific('"'))
+        return {};
 
-        if (m_index == m_input.length())
-            break;
-        if (ch == '"')
-            break;
-        if (ch != '\\') {
-            final_sb.append(consume());
-            continue;
-        }
+    size_t start = m_index;
+    m_index = find_special_string_character(m_input, m_index);
+    if (next_is('"')) {
         ignore();
-        if (next_is('"')) {
-            ignore();
-            final_sb.append('"');
-            continue;
-        }
-
-        if (next_is('\\')) {
-            ignore();
-            final_sb.append('\\');
-            continue;
-        }
+        return m_input.substring_view(start, m_index - start - 1);
+    }
 
-        if (next_is('/')) {
+    m_unescaped_string.clear();
+    m_unescaped_string.append(m_input.substring_view(start, m_index - start));
+    for (;;) {
+        if (is_eof())
+            return {};
+        if (next_is('"')) {
             ignore();
-            final_sb.append('/');
-            continue;
+            return m_unescaped_string.string_view();
         }
+        // Control characters have to be escaped.
+        if (!next_is('\\'))
+            return {};
+        ignore();
 
-        if (next_is('n')) {
+        switch (peek()) {
+        case '"':
+        case '\\':
+        case '/':
+            m_unescaped_string.append(consume());
+            break;
+        case 'n':
             ignore();
-            final_sb.append('\n');
-            continue;
-        }
-
-        if (next_is('r')) {
+            m_unescaped_string.append('\n');
+            break;
+        case 'r':
             ignore();
-            final_sb.append('\r');
-            continue;
-        }
-
-        if (next_is('t')) {
+            m_unescaped_string.append('\r');
+            break;
+        case 't':
             ignore();
-            final_sb.append('\t');
-            continue;
-        }
-
-        if (next_is('b')) {
+            m_unescaped_string.append('\t');
+            break;
+        case 'b':
             ignore();
-            final_sb.append('\b');
-            continue;
-        }
-
-        if (next_is('f')) {
+            m_unescaped_string.append('\b');
+            break;
+        case 'f':
             ignore();
-            final_sb.append('\f');
-            continue;
-        }
-
-        if (next_is('u')) {
+            m_unescaped_string.append('\f');
+            break;
+        case 'u': {
             ignore();
             if (tell_remaining() < 4)
                 return {};
 
             auto code_point = AK::StringUtils::convert_to_uint_from_hex(consume(4));
-            if (code_point.has_value()) {
-                final_sb.append_code_point(code_point.value());
-                continue;
-            } else {
+            if (!code_point.has_value())
                 return {};
-            }
+            m_unescaped_string.append_code_point(code_point.value());
+            break;
+        }
+        default:
+            return {};
         }
 
-        return {};
+        size_t plain_start = m_index;
+        m_index = find_special_string_character(m_input, m_index);
+        m_unescaped_string.append(m_input.substring_view(plain_start, m_index - plain_start));
     }
-    if (!consume_specific('"'))
-        return {};
+}
 
-    return final_sb.to_string();
+String JsonParser::consume_and_unescape_string()
+{
+    auto string = consume_string();
+    if (!string.has_value())
+        return {};
+    return string.value();
 }
 
 Optional<JsonValue> JsonParser::parse_object()
@@ -194,8 +209,8 @@ Optional<JsonValue> JsonParser::parse_string()
 Optional<JsonValue> JsonParser::parse_number()
 {
     JsonValue value;
-    Vector<char, 128> number_buffer;
-    Vector<char, 128> fraction_buffer;
+    size_t number_start = m_index;
+    size_t number_end = 0;
 
     bool is_double = false;
     for (;;) {
@@ -205,36 +220,27 @@ Optional<JsonValue> JsonParser::parse_number()
                 return {};
 
             is_double = true;
+            number_end = m_index;
             ++m_index;
             continue;
         }
         if (ch == '-' || (ch >= '0' && ch <= '9')) {
-            if (is_double) {
-                if (ch == '-')
-                    return {};
-
-                fraction_buffer.append(ch);
-            } else {
-                if (number_buffer.size() > 0) {
-                    if (number_buffer.at(0) == '0')
-                        return {};
-                }
-
-                if (number_buffer.size() > 1) {
-                    if (number_buffer.at(0) == '-' && number_buffer.at(1) == '0')
-                        return {};
-                }
-
-                number_buffer.append(ch);
-            }
+            if (is_double && ch == '-')
+                return {};
             ++m_index;
             continue;
         }
         break;
     }
+    if (!is_double)
+        number_end = m_index;
 
-    StringView number_string(number_buffer.data(), number_buffer.size());
-    StringView fraction_string(fraction_buffer.data(), fraction_buffer.size());
+    auto number_string = m_input.substring_view(number_start, number_end - number_start);
+    auto fraction_string = is_double ? m_input.substring_view(number_end + 1, m_index - number_end - 1) : StringView {};
+    if (number_string.length() > 1 && number_string[0] == '0')
+        return {};
+    if (number_string.length() > 2 && number_string.starts_with("-0"))
+        return {};
 
 #ifndef KERNEL
     if (is_double) {
@@ -257,7 +263,7 @@ Optional<JsonValue> JsonParser::parse_number()
         fraction *= (whole < 0) ? -1 : 1;
 
         auto divider = 1;
-        for (size_t i = 0; i < fraction_buffer.size(); ++i) {
+        for (size_t i = 0; i < fraction_string.length(); ++i) {
             divider *= 10;
         }
         value = JsonValue((double)whole + ((double)fraction / divider));
@@ -342,6 +348,95 @@ Optional<JsonValue> JsonParser::parse_helper()
     return {};
 }
 
+bool JsonParser::parse_object_events(JsonEventHandler& handler)
+{
+    if (!consume_specific('{') || !handler.on_object_start())
+        return false;
+    for (;;) {
+        ignore_while(is_space);
+        if (peek() == '}')
+            break;
+        auto name = consume_string();
+        if (!name.has_value() || !handler.on_object_key(name.value()))
+            return false;
+        ignore_while(is_space);
+        if (!consume_specific(':'))
+            return false;
+        if (!parse_events_helper(handler))
+            return false;
+        ignore_while(is_space);
+        if (peek() == '}')
+            break;
+        if (!consume_specific(','))
+            return false;
+        ignore_while(is_space);
+        if (peek() == '}')
+            return false;
+    }
+    if (!consume_specific('}'))
+        return false;
+    return handler.on_object_end();
+}
+
+bool JsonParser::parse_array_events(JsonEventHandler& handler)
+{
+    if (!consume_specific('[') || !handler.on_array_start())
+        return false;
+    for (;;) {
+        ignore_while(is_space);
+        if (peek() == ']')
+            break;
+        if (!parse_events_helper(handler))
+            return false;
+        ignore_while(is_space);
+        if (peek() == ']')
+            break;
+        if (!consume_specific(','))
+            return false;
+        ignore_while(is_space);
+        if (peek() == ']')
+            return false;
+    }
+    if (!consume_specific(']'))
+        return false;
+    return handler.on_array_end();
+}
+
+bool JsonParser::parse_events_helper(JsonEventHandler& handler)
+{
+    ignore_while(is_space);
+    switch (peek()) {
+    case '{':
+        return parse_object_events(handler);
+    case '[':
+        return parse_array_events(handler);
+    case '"': {
+        auto string = consume_string();
+        return string.has_value() && handler.on_string(string.value());
+    }
+    case 'f':
+        return consume_specific("false") && handler.on_boolean(false);
+    case 't':
+        return consume_specific("true") && handler.on_boolean(true);
+    case 'n':
+        return consume_specific("null") && handler.on_null();
+    }
+
+    if (peek() == '-' || is_ascii_digit(peek())) {
+        auto number = parse_number();
+        return number.has_value() && handler.on_number(number.value());
+    }
+    return false;
+}
+
+bool JsonParser::parse_events(JsonEventHandler& handler)
+{
+    if (!parse_events_helper(handler))
+        return false;
+    ignore_while(is_space);
+    return is_eof();
+}
+
 Optional<JsonValue> JsonParser::parse()
 {
     auto result = parse_helper();
@@ -8,9 +8,29 @@
 
 #include <AK/GenericLexer.h>
 #include <AK/JsonValue.h>
+#include <AK/StringBuilder.h>
 
 namespace AK {
 
+// Gets told about the values in a JSON document one by one as JsonParser::parse_events() comes across them, which
+// saves building a JsonValue for all of it when it's only going to be looked at once. Returning false from any of
+// these stops the parsing. The StringViews point into the input or into a buffer that's reused for the next string,
+// so they have to be copied to be kept around.
+class JsonEventHandler {
+public:
+    virtual ~JsonEventHandler() = default;
+
+    virtual bool on_object_start() { return true; }
+    virtual bool on_object_key(const StringView&) { return true; }
+    virtual bool on_object_end() { return true; }
+    virtual bool on_array_start() { return true; }
+    virtual bool on_array_end() { return true; }
+    virtual bool on_string(const StringView&) { return true; }
+    virtual bool on_number(const JsonValue&) { return true; }
+    virtual bool on_boolean(bool) { return true; }
+    virtual bool on_null() { return true; }
+};
+
 class JsonParser : private GenericLexer {
 public:
     explicit JsonParser(const StringView& input)
@@ -19,10 +39,16 @@ public:
     }
 
     Optional<JsonValue> parse();
+    // Returns whether the input was valid JSON, and the handler didn't stop early.
+    bool parse_events(JsonEventHandler&);
 
 private:
     Optional<JsonValue> parse_helper();
+    bool parse_events_helper(JsonEventHandler&);
+    bool parse_object_events(JsonEventHandler&);
+    bool parse_array_events(JsonEventHandler&);
 
+    Optional<StringView> consume_string();
     String consume_and_unescape_string();
     Optional<JsonValue> parse_array();
     Optional<JsonValue> parse_object();
@@ -33,8 +59,11 @@ private:
     Optional<JsonValue> parse_null();
 
     String m_last_string_starting_with_character[256];
+    // Holds the last string that had escapes in it, the others are returned straight out of the input.
+    StringBuilder m_unescaped_string;
 };
 
 }
 
+using AK::JsonEventHandler;
 using AK::JsonParser;
@@ -28,18 +28,45 @@ const static void* bitap_bitwise(const void* haystack, size_t haystack_length, c
         needle_mask[i] = 0xffffffff;
 
     for (size_t i = 0; i < needle_length; ++i)
-        needle_mask[((const u8*)needle)[i]] &= ~(0x00000001 << i);
+        needle_mask[((const u8*)needle)[i]] &= ~((u64)1 << i);
 
     for (size_t i = 0; i < haystack_length; ++i) {
         lookup |= needle_mask[((const u8*)haystack)[i]];
         lookup <<= 1;
 
-        if (!(lookup & (0x00000001 << needle_length)))
+        if (!(lookup & ((u64)1 << needle_length)))
             return ((const u8*)haystack) + i - needle_length + 1;
     }
 
     return nullptr;
 }
+
+// Looks at a whole word at a time. XOR-ing a word with the byte repeated turns matching bytes into zero bytes,
+// and (word - 0x0101...) & ~word & 0x8080... is non-zero exactly when the word has a zero byte.
+const static u8* find_byte(const u8* haystack, size_t haystack_length, u8 byte)
+{
+    auto* end = haystack + haystack_length;
+    // Aligned words never reach across a page boundary, so the loads can't fault past the end of the haystack.
+    for (; haystack < end && (FlatPtr)haystack % sizeof(FlatPtr) != 0; ++haystack) {
+        if (*haystack == byte)
+            return haystack;
+    }
+
+    auto pattern = explode_byte(byte);
+    for (; (size_t)(end - haystack) >= sizeof(FlatPtr); haystack += sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, haystack, sizeof(word));
+        word ^= pattern;
+        if ((word - explode_byte(0x01)) & ~word & explode_byte(0x80))
+            break;
+    }
+
+    for (; haystack < end; ++haystack) {
+        if (*haystack == byte)
+            return haystack;
+    }
+    return nullptr;
+}
 }
 
 template<typename HaystackIterT>
@@ -114,16 +141,48 @@ static inline Optional<size_t> memmem_optional(const void* haystack, size_t hays
         return {};
     }
 
+    auto* haystack_bytes = (const u8*)haystack;
+    auto* needle_bytes = (const u8*)needle;
+    if (needle_length == 1) {
+        auto ptr = find_byte(haystack_bytes, haystack_length, needle_bytes[0]);
+        if (ptr)
+            return static_cast<size_t>(ptr - haystack_bytes);
+        return {};
+    }
+
+    // Most of the time the first byte of the needle is rare enough that skipping from one occurrence of it to the
+    // next and comparing there is the fastest way through. Once the comparisons have cost about as much as
+    // a pass over what was skipped, the rest is left to the searches below, which take linear time regardless.
+    size_t offset = 0;
+    size_t compared_bytes = 0;
+    while (offset <= haystack_length - needle_length && compared_bytes <= offset + 64) {
+        auto ptr = find_byte(haystack_bytes + offset, haystack_length - needle_length + 1 - offset, needle_bytes[0]);
+        if (!ptr)
+            return {};
+        offset = ptr - haystack_bytes;
+        if (__builtin_memcmp(ptr + 1, needle_bytes + 1, needle_length - 1) == 0)
+            return offset;
+        compared_bytes += needle_length;
+        ++offset;
+    }
+    if (offset > haystack_length - needle_length)
+        return {};
+    haystack_bytes += offset;
+    haystack_length -= offset;
+
     if (needle_length < 32) {
-        auto ptr = bitap_bitwise(haystack, haystack_length, needle, needle_length);
+        auto ptr = bitap_bitwise(haystack_bytes, haystack_length, needle, needle_length);
         if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+            return offset + static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack_bytes);
         return {};
     }
 
     // Fallback to KMP.
-    Array<Span<const u8>, 1> spans { Span<const u8> { (const u8*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (const u8*)needle, needle_length });
+    Array<Span<const u8>, 1> spans { Span<const u8> { haystack_bytes, haystack_length } };
+    auto position = memmem(spans.begin(), spans.end(), { needle_bytes, needle_length });
+    if (position.has_value())
+        return offset + position.value();
+    return {};
 }
 
 static inline const void* memmem(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
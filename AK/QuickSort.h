@@ -7,34 +7,119 @@
 #pragma once
 
 #include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
 
 namespace AK {
 
-/* This is a dual pivot quick sort. It is quite a bit faster than the single
- * pivot quick_sort below. The other quick_sort below should only be used when
- * you are stuck with simple iterators to a container and you don't have access
- * to the container itself.
- */
+namespace Detail {
+
+// Ranges up to this size are finished off with an insertion sort, which beats partitioning them further.
+static constexpr int quick_sort_insertion_sort_threshold = 16;
+
+// Once partitioning has gone this many levels deeper than log2(size) would suggest, the pivots are
+// clearly not working out and the rest is heap sorted instead, so no input can make us go quadratic.
+ALWAYS_INLINE int quick_sort_depth_limit(int size)
+{
+    if (size <= 1)
+        return 0;
+    return 2 * (static_cast<int>(sizeof(unsigned) * 8) - __builtin_clz(static_cast<unsigned>(size)));
+}
+
+// Lets the collection based helpers below work on a random access iterator.
+template<typename Iterator>
+struct IteratorAsCollection {
+    Iterator start;
+    decltype(auto) operator[](int index) { return *(start + index); }
+};
+
+// All of these only ever swap elements, so they also work on collections whose elements can't be
+// moved into a temporary, like the SizedObjects of qsort().
 template<typename Collection, typename LessThan>
-void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_than)
+void insertion_sort(Collection& col, int start, int end, LessThan& less_than)
+{
+    for (int i = start + 1; i <= end; ++i) {
+        for (int j = i; j > start && less_than(col[j], col[j - 1]); --j)
+            swap(col[j], col[j - 1]);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void heap_sort(Collection& col, int start, int end, LessThan& less_than)
 {
-    while (start < end) {
+    int size = end - start + 1;
+    auto sift_down = [&](int root, int heap_size) {
+        for (;;) {
+            int child = 2 * root + 1;
+            if (child >= heap_size)
+                return;
+            if (child + 1 < heap_size && less_than(col[start + child], col[start + child + 1]))
+                ++child;
+            if (!less_than(col[start + root], col[start + child]))
+                return;
+            swap(col[start + root], col[start + child]);
+            root = child;
+        }
+    };
+    for (int i = size / 2 - 1; i >= 0; --i)
+        sift_down(i, size);
+    for (int i = size - 1; i > 0; --i) {
+        swap(col[start], col[start + i]);
+        sift_down(0, i);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_than, int depth_limit)
+{
+    while (end - start + 1 > quick_sort_insertion_sort_threshold) {
+        if (depth_limit-- == 0) {
+            heap_sort(col, start, end, less_than);
+            return;
+        }
+
+        // Pick the pivots from five samples around the middle rather than taking the first and last
+        // element, which would make already sorted input the worst case.
         int size = end - start + 1;
-        if (size > 3) {
-            int third = size / 3;
-            if (less_than(col[start + third], col[end - third])) {
-                swap(col[start + third], col[start]);
-                swap(col[end - third], col[end]);
-            } else {
-                swap(col[start + third], col[end]);
-                swap(col[end - third], col[start]);
+        int seventh = size / 7;
+        int samples[5];
+        samples[2] = start + size / 2;
+        samples[1] = samples[2] - seventh;
+        samples[0] = samples[1] - seventh;
+        samples[3] = samples[2] + seventh;
+        samples[4] = samples[3] + seventh;
+        for (int i = 1; i < 5; ++i) {
+            for (int j = i; j > 0 && less_than(col[samples[j]], col[samples[j - 1]]); --j)
+                swap(col[samples[j]], col[samples[j - 1]]);
+        }
+
+        if (!less_than(col[samples[1]], col[samples[3]])) {
+            // The pivots would be equal, so there are lots of duplicates. Split into less, equal and greater
+            // than the middle sample instead, and leave all the equal elements out of the recursion.
+            swap(col[start], col[samples[2]]);
+            int less = start;
+            int greater = end;
+            for (int i = start + 1; i <= greater;) {
+                // col[less] is always an element that's equal to the pivot.
+                if (less_than(col[i], col[less]))
+                    swap(col[less++], col[i++]);
+                else if (less_than(col[less], col[i]))
+                    swap(col[i], col[greater--]);
+                else
+                    ++i;
             }
-        } else {
-            if (!less_than(col[start], col[end])) {
-                swap(col[start], col[end]);
+            if (less - start < end - greater) {
+                dual_pivot_quick_sort(col, start, less - 1, less_than, depth_limit);
+                start = greater + 1;
+            } else {
+                dual_pivot_quick_sort(col, greater + 1, end, less_than, depth_limit);
+                end = less - 1;
             }
+            continue;
         }
 
+        swap(col[samples[1]], col[start]);
+        swap(col[samples[3]], col[end]);
+
         int j = start + 1;
         int k = start + 1;
         int g = end - 1;
@@ -73,29 +158,38 @@ void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_th
         int right_size = (end + 1) - (right_pointer + 1);
 
         if (left_size >= middle_size && left_size >= right_size) {
-            dual_pivot_quick_sort(col, left_pointer + 1, right_pointer - 1, less_than);
-            dual_pivot_quick_sort(col, right_pointer + 1, end, less_than);
+            dual_pivot_quick_sort(col, left_pointer + 1, right_pointer - 1, less_than, depth_limit);
+            dual_pivot_quick_sort(col, right_pointer + 1, end, less_than, depth_limit);
             end = left_pointer - 1;
         } else if (middle_size >= right_size) {
-            dual_pivot_quick_sort(col, start, left_pointer - 1, less_than);
-            dual_pivot_quick_sort(col, right_pointer + 1, end, less_than);
+            dual_pivot_quick_sort(col, start, left_pointer - 1, less_than, depth_limit);
+            dual_pivot_quick_sort(col, right_pointer + 1, end, less_than, depth_limit);
             start = left_pointer + 1;
             end = right_pointer - 1;
         } else {
-            dual_pivot_quick_sort(col, start, left_pointer - 1, less_than);
-            dual_pivot_quick_sort(col, left_pointer + 1, right_pointer - 1, less_than);
+            dual_pivot_quick_sort(col, start, left_pointer - 1, less_than, depth_limit);
+            dual_pivot_quick_sort(col, left_pointer + 1, right_pointer - 1, less_than, depth_limit);
             start = right_pointer + 1;
         }
     }
+    insertion_sort(col, start, end, less_than);
 }
 
 template<typename Iterator, typename LessThan>
-void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
+void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than, int depth_limit)
 {
     for (;;) {
         int size = end - start;
-        if (size <= 1)
+        if (size <= quick_sort_insertion_sort_threshold) {
+            IteratorAsCollection<Iterator> col { start };
+            insertion_sort(col, 0, size - 1, less_than);
+            return;
+        }
+        if (depth_limit-- == 0) {
+            IteratorAsCollection<Iterator> col { start };
+            heap_sort(col, 0, size - 1, less_than);
             return;
+        }
 
         int pivot_point = size / 2;
         if (pivot_point)
@@ -115,15 +209,38 @@ void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
         // Recur into the shorter part of the remaining data
         // to ensure a stack depth of at most log(n).
         if (i > size / 2) {
-            single_pivot_quick_sort(start + i, end, less_than);
+            single_pivot_quick_sort(start + i, end, less_than, depth_limit);
             end = start + i - 1;
         } else {
-            single_pivot_quick_sort(start, start + i - 1, less_than);
+            single_pivot_quick_sort(start, start + i - 1, less_than, depth_limit);
             start = start + i;
         }
     }
 }
 
+}
+
+/* This is a dual pivot quick sort. It is quite a bit faster than the single
+ * pivot quick_sort below. The other quick_sort below should only be used when
+ * you are stuck with simple iterators to a container and you don't have access
+ * to the container itself.
+ *
+ * Both of them are introsorts: small ranges are insertion sorted, and ranges
+ * that keep partitioning badly are heap sorted, so they run in O(n log n) even
+ * on adversarial input. Neither of them is stable, use stable_sort() for that.
+ */
+template<typename Collection, typename LessThan>
+void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_than)
+{
+    Detail::dual_pivot_quick_sort(col, start, end, move(less_than), Detail::quick_sort_depth_limit(end - start + 1));
+}
+
+template<typename Iterator, typename LessThan>
+void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
+{
+    Detail::single_pivot_quick_sort(start, end, move(less_than), Detail::quick_sort_depth_limit(end - start));
+}
+
 template<typename Iterator>
 void quick_sort(Iterator start, Iterator end)
 {
@@ -149,6 +266,61 @@ void quick_sort(Collection& collection)
         [](auto& a, auto& b) { return a < b; });
 }
 
+// Merges the sorted ranges [start, middle) and [middle, end) into one sorted range. On ties, elements
+// of the first range go first. The first range is moved into buffer while merging, so passing the same
+// buffer to many merges saves allocations.
+template<typename Collection, typename LessThan, typename T>
+void merge_sorted_halves(Collection& col, size_t start, size_t middle, size_t end, LessThan& less_than, Vector<T>& buffer)
+{
+    if (start == middle || middle == end || !less_than(col[middle], col[middle - 1]))
+        return;
+
+    buffer.clear_with_capacity();
+    buffer.ensure_capacity(middle - start);
+    for (size_t i = start; i < middle; ++i)
+        buffer.unchecked_append(move(col[i]));
+
+    size_t left = 0;
+    size_t right = middle;
+    size_t out = start;
+    while (left < buffer.size() && right < end) {
+        if (less_than(col[right], buffer[left]))
+            col[out++] = move(col[right++]);
+        else
+            col[out++] = move(buffer[left++]);
+    }
+    while (left < buffer.size())
+        col[out++] = move(buffer[left++]);
+}
+
+// A merge sort that keeps equal elements in their original order. Unlike quick_sort(), this needs
+// the elements to be movable, and temporary storage for half of them.
+template<typename Collection, typename LessThan>
+void stable_sort(Collection& collection, LessThan less_than)
+{
+    using ElementType = RemoveCVReference<decltype(collection[0])>;
+    size_t size = collection.size();
+
+    // Insertion sort only swaps neighbours that are strictly out of order, so it's stable too.
+    constexpr size_t run_size = Detail::quick_sort_insertion_sort_threshold;
+    for (size_t start = 0; start < size; start += run_size)
+        Detail::insertion_sort(collection, start, min(start + run_size, size) - 1, less_than);
+
+    Vector<ElementType> buffer;
+    for (size_t width = run_size; width < size; width *= 2) {
+        for (size_t start = 0; start + width < size; start += 2 * width)
+            merge_sorted_halves(collection, start, start + width, min(start + 2 * width, size), less_than, buffer);
+    }
+}
+
+template<typename Collection>
+void stable_sort(Collection& collection)
+{
+    stable_sort(collection, [](auto& a, auto& b) { return a < b; });
+}
+
 }
 
+using AK::merge_sorted_halves;
 using AK::quick_sort;
+using AK::stable_sort;
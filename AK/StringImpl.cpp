@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/CharacterTypes.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
@@ -26,6 +27,29 @@ StringImpl& StringImpl::the_empty_stringimpl()
     return *s_the_empty_stringimpl;
 }
 
+// Strings of a single character are so common (and so small) that all of them share one StringImpl per character,
+// like the empty string does. These are created on first use and never destroyed.
+static Atomic<StringImpl*> s_single_character_stringimpls[256];
+
+StringImpl& StringImpl::the_single_character_stringimpl(char ch)
+{
+    auto& slot = s_single_character_stringimpls[static_cast<u8>(ch)];
+    if (auto* impl = slot.load(AK::MemoryOrder::memory_order_acquire))
+        return *impl;
+
+    char* buffer;
+    auto* new_impl = &create_uninitialized(1, buffer).leak_ref();
+    buffer[0] = ch;
+
+    StringImpl* expected = nullptr;
+    if (!slot.compare_exchange_strong(expected, new_impl, AK::MemoryOrder::memory_order_acq_rel)) {
+        // Another thread got there first.
+        new_impl->unref();
+        return *expected;
+    }
+    return *new_impl;
+}
+
 StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
     : m_length(length)
 {
@@ -65,6 +89,8 @@ RefPtr<StringImpl> StringImpl::create(const char* cstring, size_t length, Should
 
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_character_stringimpl(cstring[0]);
 
     char* buffer;
     auto new_stringimpl = create_uninitialized(length, buffer);
@@ -92,6 +118,8 @@ RefPtr<StringImpl> StringImpl::create_lowercased(char const* cstring, size_t len
         return nullptr;
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_character_stringimpl((char)to_ascii_lowercase(cstring[0]));
     char* buffer;
     auto impl = create_uninitialized(length, buffer);
     for (size_t i = 0; i < length; ++i)
@@ -105,6 +133,8 @@ RefPtr<StringImpl> StringImpl::create_uppercased(char const* cstring, size_t len
         return nullptr;
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_character_stringimpl((char)to_ascii_uppercase(cstring[0]));
     char* buffer;
     auto impl = create_uninitialized(length, buffer);
     for (size_t i = 0; i < length; ++i)
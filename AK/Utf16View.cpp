@@ -20,37 +20,57 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<typename UtfViewType>
-static Vector<u16> to_utf16_impl(UtfViewType const& view) requires(IsSame<UtfViewType, Utf8View> || IsSame<UtfViewType, Utf32View>)
+static void append_code_point(Vector<u16>& utf16_data, u32 code_point)
 {
-    Vector<u16> utf16_data;
-
-    for (auto code_point : view) {
-        if (code_point < first_supplementary_plane_code_point) {
-            utf16_data.append(static_cast<u16>(code_point));
-        } else {
-            code_point -= first_supplementary_plane_code_point;
-            utf16_data.append(static_cast<u16>(high_surrogate_min | (code_point >> 10)));
-            utf16_data.append(static_cast<u16>(low_surrogate_min | (code_point & 0x3ff)));
-        }
+    if (code_point < first_supplementary_plane_code_point) {
+        utf16_data.append(static_cast<u16>(code_point));
+    } else {
+        code_point -= first_supplementary_plane_code_point;
+        utf16_data.append(static_cast<u16>(high_surrogate_min | (code_point >> 10)));
+        utf16_data.append(static_cast<u16>(low_surrogate_min | (code_point & 0x3ff)));
     }
-
-    return utf16_data;
 }
 
 Vector<u16> utf8_to_utf16(StringView const& utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 Vector<u16> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    Vector<u16> utf16_data;
+    // Every byte turns into one code unit at most, even an invalid one.
+    utf16_data.ensure_capacity(utf8_view.byte_length());
+
+    auto const* bytes = utf8_view.bytes();
+    size_t length = utf8_view.byte_length();
+    size_t offset = 0;
+    while (offset < length) {
+        auto ascii_length = Detail::count_leading_ascii_bytes(bytes + offset, length - offset);
+        for (size_t i = 0; i < ascii_length; ++i)
+            utf16_data.unchecked_append(bytes[offset + i]);
+        offset += ascii_length;
+
+        auto iterator = utf8_view.substring_view(offset).begin();
+        while (offset < length && bytes[offset] >= 0x80) {
+            append_code_point(utf16_data, *iterator);
+            offset += iterator.underlying_code_point_length_in_bytes();
+            ++iterator;
+        }
+    }
+
+    return utf16_data;
 }
 
 Vector<u16> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Vector<u16> utf16_data;
+    utf16_data.ensure_capacity(utf32_view.length());
+
+    for (auto code_point : utf32_view)
+        append_code_point(utf16_data, code_point);
+
+    return utf16_data;
 }
 
 bool Utf16View::is_high_surrogate(u16 code_unit)
@@ -73,7 +93,7 @@ u32 Utf16View::decode_surrogate_pair(u16 high_surrogate, u16 low_surrogate)
 
 String Utf16View::to_utf8(AllowInvalidCodeUnits allow_invalid_code_units) const
 {
-    StringBuilder builder;
+    StringBuilder builder(length_in_code_units());
 
     if (allow_invalid_code_units == AllowInvalidCodeUnits::Yes) {
         for (auto const* ptr = begin_ptr(); ptr < end_ptr(); ++ptr) {
@@ -7,6 +7,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Format.h>
+#include <AK/SIMD.h>
 #include <AK/Utf8View.h>
 
 namespace AK {
@@ -122,10 +123,33 @@ static inline bool decode_first_byte(
     return false;
 }
 
+size_t Detail::count_leading_ascii_bytes(unsigned char const* bytes, size_t length)
+{
+    // Most text is mostly ASCII, so look for the first byte with its top bit set a whole vector at a time.
+    size_t offset = 0;
+    for (; offset + sizeof(SIMD::u64x2) <= length; offset += sizeof(SIMD::u64x2)) {
+        SIMD::u64x2 block;
+        __builtin_memcpy(&block, bytes + offset, sizeof(block));
+        if ((block[0] | block[1]) & 0x8080808080808080ull)
+            break;
+    }
+    while (offset < length && bytes[offset] < 0x80)
+        ++offset;
+    return offset;
+}
+
 bool Utf8View::validate(size_t& valid_bytes) const
 {
     valid_bytes = 0;
     for (auto ptr = begin_ptr(); ptr < end_ptr(); ptr++) {
+        if (*ptr < 0x80) {
+            auto ascii_length = Detail::count_leading_ascii_bytes(ptr, end_ptr() - ptr);
+            valid_bytes += ascii_length;
+            // The loop steps over the last one.
+            ptr += ascii_length - 1;
+            continue;
+        }
+
         size_t code_point_length_in_bytes;
         u32 value;
         bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, value);
@@ -149,8 +173,17 @@ bool Utf8View::validate(size_t& valid_bytes) const
 size_t Utf8View::calculate_length() const
 {
     size_t length = 0;
-    for ([[maybe_unused]] auto code_point : *this) {
+    auto iterator = begin();
+    while (!iterator.done()) {
+        if (*iterator.m_ptr < 0x80) {
+            auto ascii_length = Detail::count_leading_ascii_bytes(iterator.m_ptr, iterator.m_length);
+            length += ascii_length;
+            iterator.m_ptr += ascii_length;
+            iterator.m_length -= ascii_length;
+            continue;
+        }
         ++length;
+        ++iterator;
     }
     return length;
 }
@@ -111,6 +111,13 @@ private:
     mutable bool m_have_length { false };
 };
 
+namespace Detail {
+
+// Returns how many of the bytes at the start are ASCII, which are each a code point of their own.
+size_t count_leading_ascii_bytes(unsigned char const* bytes, size_t length);
+
+}
+
 }
 
 using AK::Utf8CodePointIterator;
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Operations for event_poll_ctl().
+#define EVENT_POLL_CTL_ADD 1
+#define EVENT_POLL_CTL_MOD 2
+#define EVENT_POLL_CTL_DEL 3
+
+// By default, a watched file descriptor is reported by every event_poll_wait() for as long as it
+// is ready (level-triggered). With this flag, it is only reported once each time it becomes ready.
+#define EVENT_POLL_EDGE_TRIGGERED (1u << 0)
+
+struct event_poll_event {
+    u32 events; // POLLIN, POLLPRI and POLLOUT as with poll(); event_poll_wait() returns the ready subset.
+    u32 flags;
+    u64 user_data; // Returned unchanged by event_poll_wait().
+};
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// The memory shared between the kernel and userspace through mmap()ing an I/O ring.
+// It starts with an IORingHeader, followed by the submission and completion entries.
+// Both queues have `entry_count` entries, and their head and tail indices only ever
+// increase (and wrap around); use `index & (entry_count - 1)` to find the actual entry.
+
+enum class IORingOpcode : u8 {
+    Read = 0,
+    Write,
+    Accept,
+    Recv,
+    Send,
+    Fsync,
+};
+
+// Use this as the offset of a Read or Write to use (and advance) the current file offset.
+constexpr u64 IORING_OFFSET_CURRENT = ~0ull;
+
+constexpr u32 IORING_MAX_ENTRIES = 4096;
+
+struct IORingHeader {
+    u32 submission_head; // Advanced by the kernel as it consumes submissions.
+    u32 submission_tail; // Advanced by userspace after filling in submissions.
+    u32 completion_head; // Advanced by userspace after consuming completions.
+    u32 completion_tail; // Advanced by the kernel after filling in completions.
+    u32 entry_count;
+    u32 submission_entries_offset;
+    u32 completion_entries_offset;
+    u32 reserved;
+};
+
+struct IORingSubmission {
+    u64 user_data; // Passed back unchanged in the completion.
+    u64 offset;    // For Read and Write only.
+    u64 buffer;    // For Read, Write, Recv and Send only.
+    u32 length;
+    i32 fd;
+    IORingOpcode opcode;
+    u8 reserved[3];
+    u32 flags; // MSG_* flags for Recv and Send, SOCK_NONBLOCK and SOCK_CLOEXEC for Accept.
+};
+
+struct IORingCompletion {
+    u64 user_data;
+    i64 result; // The return value of the operation, or a negated errno.
+};
+
+constexpr u32 io_ring_submission_entries_offset()
+{
+    return sizeof(IORingHeader);
+}
+
+constexpr u32 io_ring_completion_entries_offset(u32 entry_count)
+{
+    return io_ring_submission_entries_offset() + entry_count * sizeof(IORingSubmission);
+}
+
+// The size to pass to mmap() for a ring with the given number of entries.
+constexpr size_t io_ring_mapping_size(u32 entry_count)
+{
+    size_t size = io_ring_completion_entries_offset(entry_count) + entry_count * sizeof(IORingCompletion);
+    return (size + 4095) & ~(size_t)4095;
+}
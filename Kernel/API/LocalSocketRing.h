@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// The memory shared through mmap()ing a connected local stream socket. Mapping it switches
+// the connection over from the kernel's socket buffers to two byte rings, one per direction,
+// that both ends (and the kernel, for read() and write()) access directly.
+//
+// Each end finds the ring it sends through at offset 0 and the ring it receives from at offset
+// LOCAL_SOCKET_RING_MAPPING_SIZE; both mappings have to be LOCAL_SOCKET_RING_MAPPING_SIZE bytes.
+// A ring starts with a LocalSocketRingHeader, its data follows at `data_offset`. The head and tail
+// count bytes and only ever increase (and wrap around); byte `i` is at `data_offset + (i & (capacity - 1))`.
+//
+// After moving the tail (or head) of a ring by hand, use ioctl(fd, LOCAL_SOCKET_RING_NOTIFY)
+// to wake up whoever is waiting for the other end.
+
+struct LocalSocketRingHeader {
+    u32 head; // Advanced by the receiving end after consuming data.
+    u32 tail; // Advanced by the sending end after producing data.
+    u32 capacity;
+    u32 data_offset;
+};
+
+constexpr u32 LOCAL_SOCKET_RING_CAPACITY = 256 * 1024;
+constexpr u32 LOCAL_SOCKET_RING_DATA_OFFSET = 4096;
+constexpr u32 LOCAL_SOCKET_RING_MAPPING_SIZE = LOCAL_SOCKET_RING_DATA_OFFSET + LOCAL_SOCKET_RING_CAPACITY;
+
+static_assert((LOCAL_SOCKET_RING_CAPACITY & (LOCAL_SOCKET_RING_CAPACITY - 1)) == 0);
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Reading /dev/mempressure yields one of these as a single byte. The device becomes readable again whenever the level
+// has changed since the last read through the same file description, so the first read never blocks.
+enum class MemoryPressureLevel : u8 {
+    None = 0,
+    // Less than 1/16 of physical memory is available. Caches should give back what they can easily do without.
+    Moderate = 1,
+    // Less than 1/32 of physical memory is available. Allocations are about to start failing.
+    Critical = 2,
+};
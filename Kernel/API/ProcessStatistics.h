@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// The layout of /proc/all_binary, which has the same contents as the JSON in /proc/all but can be read without
+// any parsing. It starts with a ProcessStatisticsHeader, followed by `process_count` processes. Each process is a
+// ProcessStatisticsRecord, followed by its strings and then by `thread_count` threads. Each thread is a
+// ThreadStatisticsRecord, followed by its strings. The strings aren't null-terminated, and follow each other in the
+// order their lengths are listed in the record.
+//
+// New fields only ever get appended to the records, so readers have to step over them with the record sizes from
+// the header, and treat fields beyond those sizes as zero. Anything else that changes bumps the version.
+
+constexpr u32 PROCESS_STATISTICS_VERSION = 1;
+
+struct ProcessStatisticsHeader {
+    u32 version;
+    u32 header_size;
+    u32 process_record_size;
+    u32 thread_record_size;
+    u32 process_count;
+    u32 padding;
+    u64 total_time;
+    u64 total_time_kernel;
+};
+
+struct ProcessStatisticsRecord {
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u32 nfds;
+    u8 kernel;
+    u8 dumpable;
+    u16 padding;
+    u32 thread_count;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_shared;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+    u64 big_lock_wait_time_ns;
+    u64 big_lock_contention_count;
+    u16 name_length;
+    u16 executable_length;
+    u16 tty_length;
+    u16 pledge_length;
+    u16 veil_length;
+    u16 padding2[3];
+};
+
+struct ThreadStatisticsRecord {
+    i32 tid;
+    u32 times_scheduled;
+    u64 time_user;
+    u64 time_kernel;
+    u32 syscall_count;
+    u32 inode_faults;
+    u32 zero_faults;
+    u32 cow_faults;
+    u32 unix_socket_read_bytes;
+    u32 unix_socket_write_bytes;
+    u32 ipv4_socket_read_bytes;
+    u32 ipv4_socket_write_bytes;
+    u32 file_read_bytes;
+    u32 file_write_bytes;
+    u32 cpu;
+    u32 priority;
+    u16 name_length;
+    u16 state_length;
+    u32 padding;
+};
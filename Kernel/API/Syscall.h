@@ -46,7 +46,7 @@ enum class NeedsBigProcessLock {
     S(yield, NeedsBigProcessLock::No)                       \
     S(open, NeedsBigProcessLock::Yes)                       \
     S(close, NeedsBigProcessLock::Yes)                      \
-    S(read, NeedsBigProcessLock::Yes)                       \
+    S(read, NeedsBigProcessLock::No)                        \
     S(lseek, NeedsBigProcessLock::Yes)                      \
     S(kill, NeedsBigProcessLock::Yes)                       \
     S(getuid, NeedsBigProcessLock::Yes)                     \
@@ -59,8 +59,8 @@ enum class NeedsBigProcessLock {
     S(getresuid, NeedsBigProcessLock::Yes)                  \
     S(getresgid, NeedsBigProcessLock::Yes)                  \
     S(waitid, NeedsBigProcessLock::Yes)                     \
-    S(mmap, NeedsBigProcessLock::Yes)                       \
-    S(munmap, NeedsBigProcessLock::Yes)                     \
+    S(mmap, NeedsBigProcessLock::No)                        \
+    S(munmap, NeedsBigProcessLock::No)                      \
     S(get_dir_entries, NeedsBigProcessLock::Yes)            \
     S(getcwd, NeedsBigProcessLock::Yes)                     \
     S(gettimeofday, NeedsBigProcessLock::Yes)               \
@@ -68,9 +68,9 @@ enum class NeedsBigProcessLock {
     S(sethostname, NeedsBigProcessLock::No)                 \
     S(chdir, NeedsBigProcessLock::Yes)                      \
     S(uname, NeedsBigProcessLock::No)                       \
-    S(set_mmap_name, NeedsBigProcessLock::Yes)              \
+    S(set_mmap_name, NeedsBigProcessLock::No)               \
     S(readlink, NeedsBigProcessLock::Yes)                   \
-    S(write, NeedsBigProcessLock::Yes)                      \
+    S(write, NeedsBigProcessLock::No)                       \
     S(ttyname, NeedsBigProcessLock::Yes)                    \
     S(stat, NeedsBigProcessLock::Yes)                       \
     S(getsid, NeedsBigProcessLock::Yes)                     \
@@ -98,7 +98,7 @@ enum class NeedsBigProcessLock {
     S(setresuid, NeedsBigProcessLock::Yes)                  \
     S(setresgid, NeedsBigProcessLock::Yes)                  \
     S(alarm, NeedsBigProcessLock::Yes)                      \
-    S(fstat, NeedsBigProcessLock::Yes)                      \
+    S(fstat, NeedsBigProcessLock::No)                       \
     S(access, NeedsBigProcessLock::Yes)                     \
     S(fcntl, NeedsBigProcessLock::Yes)                      \
     S(ioctl, NeedsBigProcessLock::Yes)                      \
@@ -107,9 +107,9 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::Yes)                      \
     S(sync, NeedsBigProcessLock::Yes)                       \
     S(ptsname, NeedsBigProcessLock::Yes)                    \
-    S(select, NeedsBigProcessLock::Yes)                     \
+    S(select, NeedsBigProcessLock::No)                      \
     S(unlink, NeedsBigProcessLock::Yes)                     \
-    S(poll, NeedsBigProcessLock::Yes)                       \
+    S(poll, NeedsBigProcessLock::No)                        \
     S(rmdir, NeedsBigProcessLock::Yes)                      \
     S(chmod, NeedsBigProcessLock::Yes)                      \
     S(socket, NeedsBigProcessLock::Yes)                     \
@@ -121,8 +121,8 @@ enum class NeedsBigProcessLock {
     S(chown, NeedsBigProcessLock::Yes)                      \
     S(fchmod, NeedsBigProcessLock::Yes)                     \
     S(symlink, NeedsBigProcessLock::Yes)                    \
-    S(sendmsg, NeedsBigProcessLock::Yes)                    \
-    S(recvmsg, NeedsBigProcessLock::Yes)                    \
+    S(sendmsg, NeedsBigProcessLock::No)                     \
+    S(recvmsg, NeedsBigProcessLock::No)                     \
     S(getsockopt, NeedsBigProcessLock::Yes)                 \
     S(setsockopt, NeedsBigProcessLock::Yes)                 \
     S(create_thread, NeedsBigProcessLock::Yes)              \
@@ -131,7 +131,7 @@ enum class NeedsBigProcessLock {
     S(ftruncate, NeedsBigProcessLock::Yes)                  \
     S(exit_thread, NeedsBigProcessLock::Yes)                \
     S(mknod, NeedsBigProcessLock::Yes)                      \
-    S(writev, NeedsBigProcessLock::Yes)                     \
+    S(writev, NeedsBigProcessLock::No)                      \
     S(beep, NeedsBigProcessLock::Yes)                       \
     S(getsockname, NeedsBigProcessLock::Yes)                \
     S(getpeername, NeedsBigProcessLock::Yes)                \
@@ -149,7 +149,7 @@ enum class NeedsBigProcessLock {
     S(create_inode_watcher, NeedsBigProcessLock::Yes)       \
     S(inode_watcher_add_watch, NeedsBigProcessLock::Yes)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::Yes) \
-    S(mprotect, NeedsBigProcessLock::Yes)                   \
+    S(mprotect, NeedsBigProcessLock::No)                    \
     S(realpath, NeedsBigProcessLock::Yes)                   \
     S(get_process_name, NeedsBigProcessLock::Yes)           \
     S(fchdir, NeedsBigProcessLock::Yes)                     \
@@ -165,12 +165,12 @@ enum class NeedsBigProcessLock {
     S(detach_thread, NeedsBigProcessLock::Yes)              \
     S(set_thread_name, NeedsBigProcessLock::Yes)            \
     S(get_thread_name, NeedsBigProcessLock::Yes)            \
-    S(madvise, NeedsBigProcessLock::Yes)                    \
+    S(madvise, NeedsBigProcessLock::No)                     \
     S(purge, NeedsBigProcessLock::Yes)                      \
     S(profiling_enable, NeedsBigProcessLock::Yes)           \
     S(profiling_disable, NeedsBigProcessLock::Yes)          \
     S(profiling_free_buffer, NeedsBigProcessLock::Yes)      \
-    S(futex, NeedsBigProcessLock::Yes)                      \
+    S(futex, NeedsBigProcessLock::No)                       \
     S(chroot, NeedsBigProcessLock::Yes)                     \
     S(pledge, NeedsBigProcessLock::Yes)                     \
     S(unveil, NeedsBigProcessLock::Yes)                     \
@@ -186,15 +186,27 @@ enum class NeedsBigProcessLock {
     S(adjtime, NeedsBigProcessLock::Yes)                    \
     S(allocate_tls, NeedsBigProcessLock::Yes)               \
     S(prctl, NeedsBigProcessLock::Yes)                      \
-    S(mremap, NeedsBigProcessLock::Yes)                     \
+    S(mremap, NeedsBigProcessLock::No)                      \
     S(set_coredump_metadata, NeedsBigProcessLock::Yes)      \
     S(anon_create, NeedsBigProcessLock::Yes)                \
     S(msyscall, NeedsBigProcessLock::Yes)                   \
-    S(readv, NeedsBigProcessLock::Yes)                      \
+    S(readv, NeedsBigProcessLock::No)                       \
     S(emuctl, NeedsBigProcessLock::Yes)                     \
     S(statvfs, NeedsBigProcessLock::Yes)                    \
     S(fstatvfs, NeedsBigProcessLock::Yes)                   \
-    S(kill_thread, NeedsBigProcessLock::Yes)
+    S(kill_thread, NeedsBigProcessLock::Yes)                \
+    S(io_ring_create, NeedsBigProcessLock::Yes)             \
+    S(io_ring_enter, NeedsBigProcessLock::Yes)              \
+    S(event_poll_create, NeedsBigProcessLock::Yes)          \
+    S(event_poll_ctl, NeedsBigProcessLock::Yes)             \
+    S(event_poll_wait, NeedsBigProcessLock::Yes)            \
+    S(sendfile, NeedsBigProcessLock::Yes)                   \
+    S(sendmmsg, NeedsBigProcessLock::No)                    \
+    S(recvmmsg, NeedsBigProcessLock::No)                    \
+    S(map_time_page, NeedsBigProcessLock::No)               \
+    S(posix_spawn, NeedsBigProcessLock::Yes)                \
+    S(profiling_read, NeedsBigProcessLock::Yes)             \
+    S(profiling_set_sampling_frequency, NeedsBigProcessLock::Yes)
 
 namespace Syscall {
 
@@ -395,6 +407,37 @@ struct SC_execve_params {
     StringListArgument environment;
 };
 
+enum class SpawnFileActionType {
+    Open,
+    Close,
+    Dup2,
+    Chdir,
+    Fchdir,
+};
+
+struct SC_posix_spawn_file_action {
+    SpawnFileActionType type;
+    int fd;
+    int new_fd;
+    int options;
+    u16 mode;
+    StringArgument path;
+};
+
+struct SC_posix_spawn_params {
+    StringArgument path;
+    StringListArgument arguments;
+    StringListArgument environment;
+    const SC_posix_spawn_file_action* file_actions;
+    size_t file_action_count;
+    int flags;
+    int pgroup;
+    int priority;
+    u32 sigdefault;
+    u32 sigmask;
+    int tty_fd;
+};
+
 struct SC_readlink_params {
     StringArgument path;
     MutableBufferArgument<char, size_t> buffer;
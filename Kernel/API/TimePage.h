@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// A read-only page that the kernel updates on every tick of the system timer, and that
+// every process can map with sys$map_time_page(). It lets clock_gettime() tell the time
+// without entering the kernel.
+//
+// `sequence` is odd while the kernel is updating the page. Readers have to try again if it is
+// odd, or if it changed while they were reading the other fields.
+
+// The TSC fields are valid, and userspace is allowed to execute RDTSC.
+constexpr u32 TIME_PAGE_HAS_TSC = 1 << 0;
+
+struct TimePage {
+    u32 sequence;
+    u32 flags;
+
+    // CLOCK_MONOTONIC_COARSE and CLOCK_REALTIME_COARSE, as of the last update.
+    u64 monotonic_coarse_ns;
+    i64 realtime_coarse_ns;
+
+    // CLOCK_MONOTONIC and CLOCK_REALTIME are these plus the time that passed since the TSC read `tsc_base`.
+    u64 tsc_base;
+    u64 tsc_multiplier; // Nanoseconds per TSC cycle, as a 32.32 fixed point number.
+    u64 monotonic_base_ns;
+    i64 realtime_base_ns;
+};
+
+inline u64 time_page_tsc_delta_to_ns(u64 tsc_delta, u64 multiplier)
+{
+    // Split everything into 32 bit halves, so none of the products can overflow.
+    u64 delta_high = tsc_delta >> 32;
+    u64 delta_low = tsc_delta & 0xffffffff;
+    u64 multiplier_high = multiplier >> 32;
+    u64 multiplier_low = multiplier & 0xffffffff;
+    return delta_high * multiplier + delta_low * multiplier_high + ((delta_low * multiplier_low) >> 32);
+}
@@ -94,6 +94,7 @@ public:
         UserSupervisor = 1 << 2,
         WriteThrough = 1 << 3,
         CacheDisabled = 1 << 4,
+        PAT = 1 << 7,
         Global = 1 << 8,
         NoExecute = 0x8000000000000000ULL,
     };
@@ -113,6 +114,9 @@ public:
     bool is_cache_disabled() const { return raw() & CacheDisabled; }
     void set_cache_disabled(bool b) { set_bit(CacheDisabled, b); }
 
+    bool is_pat() const { return raw() & PAT; }
+    void set_pat(bool b) { set_bit(PAT, b); }
+
     bool is_global() const { return raw() & Global; }
     void set_global(bool b) { set_bit(Global, b); }
 
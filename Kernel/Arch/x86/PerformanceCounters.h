@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/KResult.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+struct RegisterState;
+
+// The architectural performance-monitoring counters (CPUID leaf 0xA), programmed to raise an interrupt
+// every time they counted a fixed number of hardware events. Each of these interrupts is recorded as a
+// sample of the corresponding perf event type.
+class PerformanceCounters {
+public:
+    static constexpr u64 event_mask = PERF_EVENT_CPU_CYCLES | PERF_EVENT_INSTRUCTIONS | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES;
+
+    static u64 supported_event_mask();
+
+    // Starts counting the hardware events in the mask on all processors, on top of the ones that are already counted.
+    static KResult enable(u64 event_mask);
+    // Stops counting on all processors once every enable() has been balanced by a disable().
+    static void disable();
+
+    static void handle_overflow(const RegisterState&);
+};
+
+}
@@ -29,6 +29,8 @@ enum class ProcessorSpecificDataID {
     __Count,
 };
 
+#define MSR_IA32_PAT 0x277
+
 #if ARCH(X86_64)
 #    define MSR_FS_BASE 0xc0000100
 #    define MSR_GS_BASE 0xc0000101
@@ -136,6 +138,10 @@ class Processor {
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The page directory that was last loaded into CR3 on this processor, or 0 if we don't know.
+    // This lets us skip TLB shootdowns for processors that can't have the affected translations cached.
+    Atomic<FlatPtr> m_loaded_cr3;
+
     bool m_invoke_scheduler_async;
     bool m_scheduler_initialized;
     Atomic<bool> m_halt_requested;
@@ -157,6 +163,7 @@ class Processor {
     bool smp_queue_message(ProcessorMessage& msg);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static void smp_multicast_message(u32 cpu_mask, ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -382,6 +389,9 @@ public:
 
     ALWAYS_INLINE u32 in_critical() { return m_in_critical.load(); }
 
+    ALWAYS_INLINE FlatPtr loaded_cr3() const { return m_loaded_cr3.load(); }
+    ALWAYS_INLINE void set_loaded_cr3(FlatPtr cr3) { m_loaded_cr3.store(cr3); }
+
     ALWAYS_INLINE const FPUState& clean_fpu_state() const
     {
         return s_clean_fpu_state;
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <Kernel/Arch/x86/CPUID.h>
+#include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
+#include <Kernel/Interrupts/APIC.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/PerformanceManager.h>
+
+#define IA32_PMC0 0xc1
+#define IA32_PERFEVTSEL0 0x186
+#define IA32_PERF_GLOBAL_STATUS 0x38e
+#define IA32_PERF_GLOBAL_CTRL 0x38f
+#define IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+namespace Kernel {
+
+struct HardwareEvent {
+    u64 type;
+    u8 event_select;
+    u8 unit_mask;
+    // The bit in CPUID.0AH:EBX that is set if the CPU doesn't support this event.
+    u8 unavailable_bit;
+    // Take a sample every time this many events have been counted.
+    u32 period;
+};
+
+static constexpr HardwareEvent s_hardware_events[] = {
+    { PERF_EVENT_CPU_CYCLES, 0x3c, 0x00, 0, 1'000'000 },
+    { PERF_EVENT_INSTRUCTIONS, 0xc0, 0x00, 1, 1'000'000 },
+    { PERF_EVENT_CACHE_MISSES, 0x2e, 0x41, 4, 10'000 },
+    { PERF_EVENT_BRANCH_MISSES, 0xc5, 0x00, 6, 10'000 },
+};
+
+static constexpr size_t max_counter_count = 8;
+
+struct CounterInfo {
+    size_t counter_count { 0 };
+    u32 unavailable_events { 0 };
+};
+
+static Optional<CounterInfo> counter_info()
+{
+    if (CPUID(0).eax() < 0xa)
+        return {};
+    CPUID id(0xa);
+    u8 version = id.eax() & 0xff;
+    u8 counter_count = (id.eax() >> 8) & 0xff;
+    u8 event_bit_count = (id.eax() >> 24) & 0xff;
+    // The global control and overflow MSRs were only added in version 2.
+    if (version < 2 || counter_count == 0)
+        return {};
+    CounterInfo info;
+    info.counter_count = min<size_t>(counter_count, max_counter_count);
+    info.unavailable_events = id.ebx();
+    if (event_bit_count < 32)
+        info.unavailable_events |= ~((1u << event_bit_count) - 1);
+    return info;
+}
+
+static Mutex s_lock { "PerformanceCounters" };
+static size_t s_enable_count;
+static u64 s_enabled_event_mask;
+// Every processor uses the same counter for the same event. These are only written while all counters are stopped.
+static Array<const HardwareEvent*, max_counter_count> s_counter_events;
+static size_t s_counter_count;
+
+static void reset_counter(size_t index, const HardwareEvent& event)
+{
+    // The counter is written as a sign-extended 32-bit value, which is fine as the periods are way below 2^31.
+    MSR(IA32_PMC0 + index).set(static_cast<u32>(-static_cast<i32>(event.period)));
+}
+
+static void program_counters_on_current_processor()
+{
+    MSR global_control(IA32_PERF_GLOBAL_CTRL);
+    global_control.set(0);
+
+    u64 enabled_counters = 0;
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        MSR event_select(IA32_PERFEVTSEL0 + i);
+        auto* event = s_counter_events[i];
+        if (!event) {
+            event_select.set(0);
+            continue;
+        }
+        reset_counter(i, *event);
+        event_select.set(event->event_select | (event->unit_mask << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN);
+        enabled_counters |= 1ull << i;
+    }
+    MSR(IA32_PERF_GLOBAL_OVF_CTRL).set((1ull << s_counter_count) - 1);
+
+    if (enabled_counters)
+        APIC::the().enable_performance_counter_interrupt();
+    else
+        APIC::the().disable_performance_counter_interrupt();
+    global_control.set(enabled_counters);
+}
+
+static void program_counters_on_all_processors()
+{
+    auto current_processor_id = Processor::id();
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        if (cpu != current_processor_id)
+            Processor::smp_unicast(cpu, program_counters_on_current_processor, false);
+    }
+    ScopedCritical critical;
+    program_counters_on_current_processor();
+}
+
+u64 PerformanceCounters::supported_event_mask()
+{
+    auto info = counter_info();
+    if (!info.has_value())
+        return 0;
+    u64 mask = 0;
+    for (auto& event : s_hardware_events) {
+        if (!(info->unavailable_events & (1u << event.unavailable_bit)))
+            mask |= event.type;
+    }
+    return mask;
+}
+
+KResult PerformanceCounters::enable(u64 requested_event_mask)
+{
+    requested_event_mask &= event_mask;
+    if (!requested_event_mask)
+        return KSuccess;
+    if ((requested_event_mask & supported_event_mask()) != requested_event_mask)
+        return ENOTSUP;
+
+    MutexLocker locker(s_lock);
+    auto new_event_mask = s_enabled_event_mask | requested_event_mask;
+    auto info = counter_info();
+    VERIFY(info.has_value());
+
+    Array<const HardwareEvent*, max_counter_count> counter_events {};
+    size_t counter_index = 0;
+    for (auto& event : s_hardware_events) {
+        if (!(new_event_mask & event.type))
+            continue;
+        if (counter_index == info->counter_count)
+            return ENOTSUP;
+        counter_events[counter_index++] = &event;
+    }
+
+    ++s_enable_count;
+    if (new_event_mask == s_enabled_event_mask)
+        return KSuccess;
+
+    // Stop all counters before the assignment of events to counters changes under them.
+    s_counter_events = {};
+    program_counters_on_all_processors();
+
+    s_enabled_event_mask = new_event_mask;
+    s_counter_events = counter_events;
+    s_counter_count = info->counter_count;
+    program_counters_on_all_processors();
+    return KSuccess;
+}
+
+void PerformanceCounters::disable()
+{
+    MutexLocker locker(s_lock);
+    if (s_enable_count == 0 || --s_enable_count > 0)
+        return;
+    s_enabled_event_mask = 0;
+    s_counter_events = {};
+    program_counters_on_all_processors();
+}
+
+void PerformanceCounters::handle_overflow(const RegisterState& regs)
+{
+    MSR global_status(IA32_PERF_GLOBAL_STATUS);
+    auto status = global_status.get();
+
+    auto* current_thread = Thread::current();
+    bool should_sample = current_thread && current_thread != Processor::current().idle_thread();
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        if (!(status & (1ull << i)))
+            continue;
+        auto* event = s_counter_events[i];
+        if (!event)
+            continue;
+        reset_counter(i, *event);
+        if (should_sample)
+            PerformanceManager::add_hardware_counter_event(*current_thread, regs, event->type);
+    }
+
+    MSR(IA32_PERF_GLOBAL_OVF_CTRL).set(status);
+}
+
+}
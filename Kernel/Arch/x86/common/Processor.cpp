@@ -71,6 +71,8 @@ UNMAP_AFTER_INIT void Processor::cpu_detect()
         set_feature(CPUFeature::PAE);
     if (processor_info.edx() & (1 << 13))
         set_feature(CPUFeature::PGE);
+    if (processor_info.edx() & (1 << 16))
+        set_feature(CPUFeature::PAT);
     if (processor_info.edx() & (1 << 23))
         set_feature(CPUFeature::MMX);
     if (processor_info.edx() & (1 << 24))
@@ -170,6 +172,13 @@ UNMAP_AFTER_INIT void Processor::cpu_setup()
         write_cr4(read_cr4() | 0x80);
     }
 
+    if (has_feature(CPUFeature::PAT)) {
+        // Make PAT entry 4, which PTEs select with PAT set and PCD and PWT clear, write-combining (type 1).
+        // The other entries keep their power-on types, so nothing that is already mapped changes.
+        MSR pat_msr(MSR_IA32_PAT);
+        pat_msr.set((pat_msr.get() & ~(0xffULL << 32)) | (0x01ULL << 32));
+    }
+
     if (has_feature(CPUFeature::NX)) {
         // Turn on IA32_EFER.NXE
         asm volatile(
@@ -270,6 +279,8 @@ String Processor::features_string() const
             return "lm";
         case CPUFeature::HYPERVISOR:
             return "hypervisor";
+        case CPUFeature::PAT:
+            return "pat";
             // no default statement here intentionally so that we get
             // a warning if a new feature is forgotten to be added here
         }
@@ -302,6 +313,7 @@ UNMAP_AFTER_INIT void Processor::early_initialize(u32 cpu)
     m_scheduler_initialized = false;
 
     m_message_queue = nullptr;
+    m_loaded_cr3 = 0;
     m_idle_thread = nullptr;
     m_current_thread = nullptr;
     m_info = nullptr;
@@ -644,6 +656,13 @@ void Processor::check_invoke_scheduler()
 
 void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    // For large user ranges it's cheaper to just drop all (non-global) translations.
+    constexpr size_t max_pages_to_invalidate_individually = 256;
+    if (page_count > max_pages_to_invalidate_individually && is_user_range(vaddr, page_count * PAGE_SIZE)) {
+        flush_entire_tlb_local();
+        return;
+    }
+
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -659,7 +678,7 @@ void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 
 void Processor::flush_tlb(const PageDirectory* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!is_user_address(vaddr) || Process::current()->thread_count() > 1))
+    if (s_smp_enabled)
         smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
     else
         flush_tlb_local(vaddr, page_count);
@@ -891,6 +910,25 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+void Processor::smp_multicast_message(u32 cpu_mask, ProcessorMessage& msg)
+{
+    auto& cur_proc = Processor::current();
+    VERIFY(!(cpu_mask & (1u << cur_proc.get_id())));
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpu mask: {:#x} proc: {}", cur_proc.get_id(), VirtualAddress(&msg), cpu_mask, VirtualAddress(&cur_proc));
+
+    msg.refs.store(__builtin_popcount(cpu_mask), AK::MemoryOrder::memory_order_release);
+    VERIFY(msg.refs > 0);
+    for_each(
+        [&](Processor& proc) {
+            if (!(cpu_mask & (1u << proc.get_id())))
+                return;
+            // Only send an IPI if the target didn't already have messages queued
+            if (proc.smp_queue_message(msg))
+                APIC::the().send_ipi(proc.get_id());
+        });
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -951,13 +989,38 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
 
 void Processor::smp_broadcast_flush_tlb(const PageDirectory* page_directory, VirtualAddress vaddr, size_t page_count)
 {
+    auto& cur_proc = Processor::current();
+
+    // Make sure our page table updates are visible before we look at which
+    // page directories the other processors have loaded.
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+
+    // Kernel mappings are shared by all page directories, but user mappings can only
+    // be cached by processors that have this page directory loaded.
+    bool is_user = is_user_address(vaddr);
+    u32 cpu_mask = 0;
+    for_each(
+        [&](Processor& proc) {
+            if (&proc == &cur_proc)
+                return;
+            auto loaded_cr3 = proc.loaded_cr3();
+            if (!is_user || loaded_cr3 == 0 || loaded_cr3 == page_directory->cr3())
+                cpu_mask |= 1u << proc.get_id();
+        });
+
+    if (cpu_mask == 0) {
+        dbgln_if(SMP_DEBUG, "SMP[{}]: No other processor needs to flush {} pages at {}", cur_proc.get_id(), page_count, vaddr);
+        flush_tlb_local(vaddr, page_count);
+        return;
+    }
+
     auto& msg = smp_get_from_pool();
     msg.async = false;
     msg.type = ProcessorMessage::FlushTlb;
     msg.flush_tlb.page_directory = page_directory;
     msg.flush_tlb.ptr = vaddr.as_ptr();
     msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+    smp_multicast_message(cpu_mask, msg);
     // While the other processors handle this request, we'll flush ours
     flush_tlb_local(vaddr, page_count);
     // Now wait until everybody is done as well
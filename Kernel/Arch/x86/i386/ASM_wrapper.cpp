@@ -47,6 +47,9 @@ FlatPtr read_cr3()
 
 void write_cr3(FlatPtr cr3)
 {
+    // Publish the new page directory before loading it, so that anyone changing its mappings
+    // after this point knows to send us a TLB shootdown.
+    Processor::current().set_loaded_cr3(cr3);
     // NOTE: If you're here from a GPF crash, it's very likely that a PDPT entry is incorrect, not this!
     asm volatile("mov %%eax, %%cr3" ::"a"(cr3)
                  : "memory");
@@ -145,6 +145,52 @@ UNMAP_AFTER_INIT AcpiFeatureLevel CommandLine::acpi_feature_level() const
     return AcpiFeatureLevel::Enabled;
 }
 
+UNMAP_AFTER_INIT bool CommandLine::is_dynamic_ticks_enabled() const
+{
+    return lookup("dynamic_ticks"sv).value_or("off"sv) == "on"sv;
+}
+
+UNMAP_AFTER_INIT bool CommandLine::is_userspace_tsc_enabled() const
+{
+    return lookup("userspace_tsc"sv).value_or("on"sv) == "on"sv;
+}
+
+UNMAP_AFTER_INIT size_t CommandLine::fault_around_page_count() const
+{
+    const auto value = lookup("fault_around_pages"sv).value_or("4"sv);
+    auto page_count = value.to_uint();
+    if (!page_count.has_value())
+        PANIC("Invalid fault_around_pages value: {}", value);
+    return page_count.value();
+}
+
+UNMAP_AFTER_INIT size_t CommandLine::read_ahead_page_count() const
+{
+    const auto value = lookup("read_ahead_pages"sv).value_or("32"sv);
+    auto page_count = value.to_uint();
+    if (!page_count.has_value())
+        PANIC("Invalid read_ahead_pages value: {}", value);
+    return page_count.value();
+}
+
+UNMAP_AFTER_INIT size_t CommandLine::dirty_background_ratio() const
+{
+    const auto value = lookup("dirty_background_ratio"sv).value_or("10"sv);
+    auto ratio = value.to_uint();
+    if (!ratio.has_value())
+        PANIC("Invalid dirty_background_ratio value: {}", value);
+    return ratio.value();
+}
+
+UNMAP_AFTER_INIT size_t CommandLine::dirty_ratio() const
+{
+    const auto value = lookup("dirty_ratio"sv).value_or("20"sv);
+    auto ratio = value.to_uint();
+    if (!ratio.has_value())
+        PANIC("Invalid dirty_ratio value: {}", value);
+    return ratio.value();
+}
+
 UNMAP_AFTER_INIT HPETMode CommandLine::hpet_mode() const
 {
     auto hpet_mode = lookup("hpet"sv).value_or("periodic"sv);
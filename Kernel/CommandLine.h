@@ -64,6 +64,12 @@ public:
     [[nodiscard]] AcpiFeatureLevel acpi_feature_level() const;
     [[nodiscard]] BootMode boot_mode() const;
     [[nodiscard]] HPETMode hpet_mode() const;
+    [[nodiscard]] bool is_dynamic_ticks_enabled() const;
+    [[nodiscard]] bool is_userspace_tsc_enabled() const;
+    [[nodiscard]] size_t fault_around_page_count() const;
+    [[nodiscard]] size_t read_ahead_page_count() const;
+    [[nodiscard]] size_t dirty_background_ratio() const;
+    [[nodiscard]] size_t dirty_ratio() const;
     [[nodiscard]] bool disable_physical_storage() const;
     [[nodiscard]] bool disable_ps2_controller() const;
     [[nodiscard]] bool disable_uhci_controller() const;
@@ -17,6 +17,7 @@
 #include <Kernel/Process.h>
 #include <Kernel/RTC.h>
 #include <Kernel/SpinLock.h>
+#include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/ProcessPagingScope.h>
 #include <LibC/elf.h>
 #include <LibELF/CoreDump.h>
@@ -39,7 +40,6 @@ OwnPtr<CoreDump> CoreDump::create(NonnullRefPtr<Process> process, const String&
 CoreDump::CoreDump(NonnullRefPtr<Process> process, NonnullRefPtr<FileDescription>&& fd)
     : m_process(move(process))
     , m_fd(move(fd))
-    , m_num_program_headers(m_process->space().region_count() + 1) // +1 for NOTE segment
 {
 }
 
@@ -71,6 +71,49 @@ RefPtr<FileDescription> CoreDump::create_target_file(const Process& process, con
     return fd_or_error.value();
 }
 
+// Shorter runs of untouched pages aren't worth a segment of their own, and are written out as zeroes.
+static constexpr size_t min_untouched_pages_to_leave_out = 16;
+
+static bool page_is_untouched(const Region& region, size_t page_index)
+{
+    if (region.is_kernel())
+        return true;
+    auto* page = region.physical_page(page_index);
+    return !page || page->is_shared_zero_page() || page->is_lazy_committed_page();
+}
+
+void CoreDump::collect_segments(bool leave_out_untouched_pages)
+{
+    m_segments.clear();
+    for (auto& region : m_process->space().regions()) {
+        if (!leave_out_untouched_pages) {
+            m_segments.append({ region.ptr(), 0, region->page_count(), !region->is_kernel() });
+            continue;
+        }
+
+        size_t segment_start = 0;
+        size_t page_index = 0;
+        while (page_index < region->page_count()) {
+            if (!page_is_untouched(*region, page_index)) {
+                ++page_index;
+                continue;
+            }
+            size_t run_end = page_index;
+            while (run_end < region->page_count() && page_is_untouched(*region, run_end))
+                ++run_end;
+            if (run_end - page_index >= min_untouched_pages_to_leave_out || (page_index == 0 && run_end == region->page_count())) {
+                if (page_index > segment_start)
+                    m_segments.append({ region.ptr(), segment_start, page_index - segment_start, true });
+                m_segments.append({ region.ptr(), page_index, run_end - page_index, false });
+                segment_start = run_end;
+            }
+            page_index = run_end;
+        }
+        if (segment_start < region->page_count())
+            m_segments.append({ region.ptr(), segment_start, region->page_count() - segment_start, true });
+    }
+}
+
 KResult CoreDump::write_elf_header()
 {
     ElfW(Ehdr) elf_file_header;
@@ -107,7 +150,7 @@ KResult CoreDump::write_elf_header()
     elf_file_header.e_ehsize = sizeof(ElfW(Ehdr));
     elf_file_header.e_shentsize = sizeof(ElfW(Shdr));
     elf_file_header.e_phentsize = sizeof(ElfW(Phdr));
-    elf_file_header.e_phnum = m_num_program_headers;
+    elf_file_header.e_phnum = m_segments.size() + 1; // +1 for NOTE segment
     elf_file_header.e_shnum = 0;
     elf_file_header.e_shstrndx = SHN_UNDEF;
 
@@ -119,23 +162,24 @@ KResult CoreDump::write_elf_header()
 
 KResult CoreDump::write_program_headers(size_t notes_size)
 {
-    size_t offset = sizeof(ElfW(Ehdr)) + m_num_program_headers * sizeof(ElfW(Phdr));
-    for (auto& region : m_process->space().regions()) {
+    size_t offset = sizeof(ElfW(Ehdr)) + (m_segments.size() + 1) * sizeof(ElfW(Phdr));
+    for (auto& segment : m_segments) {
+        auto& region = *segment.region;
         ElfW(Phdr) phdr {};
 
         phdr.p_type = PT_LOAD;
         phdr.p_offset = offset;
-        phdr.p_vaddr = region->vaddr().get();
+        phdr.p_vaddr = region.vaddr().offset(segment.first_page * PAGE_SIZE).get();
         phdr.p_paddr = 0;
 
-        phdr.p_filesz = region->page_count() * PAGE_SIZE;
-        phdr.p_memsz = region->page_count() * PAGE_SIZE;
+        phdr.p_filesz = segment.has_data ? segment.page_count * PAGE_SIZE : 0;
+        phdr.p_memsz = segment.page_count * PAGE_SIZE;
         phdr.p_align = 0;
 
-        phdr.p_flags = region->is_readable() ? PF_R : 0;
-        if (region->is_writable())
+        phdr.p_flags = region.is_readable() ? PF_R : 0;
+        if (region.is_writable())
             phdr.p_flags |= PF_W;
-        if (region->is_executable())
+        if (region.is_executable())
             phdr.p_flags |= PF_X;
 
         offset += phdr.p_filesz;
@@ -159,23 +203,26 @@ KResult CoreDump::write_program_headers(size_t notes_size)
     return KSuccess;
 }
 
-KResult CoreDump::write_regions()
+KResult CoreDump::write_segments()
 {
-    for (auto& region : m_process->space().regions()) {
-        if (region->is_kernel())
+    Region* previous_region = nullptr;
+    for (auto& segment : m_segments) {
+        if (!segment.has_data)
             continue;
 
-        region->set_readable(true);
-        region->remap();
-
-        for (size_t i = 0; i < region->page_count(); i++) {
-            auto* page = region->physical_page(i);
+        auto& region = *segment.region;
+        if (&region != previous_region) {
+            region.set_readable(true);
+            region.remap();
+            previous_region = &region;
+        }
 
+        for (size_t i = segment.first_page; i < segment.first_page + segment.page_count; i++) {
             uint8_t zero_buffer[PAGE_SIZE] = {};
             Optional<UserOrKernelBuffer> src_buffer;
 
-            if (page) {
-                src_buffer = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region->vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
+            if (!page_is_untouched(region, i)) {
+                src_buffer = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
             } else {
                 // If the current page is not backed by a physical page, we zero it in the coredump file.
                 // TODO: Do we want to include the contents of pages that have not been faulted-in in the coredump?
@@ -254,7 +301,7 @@ ByteBuffer CoreDump::create_notes_threads_data() const
 ByteBuffer CoreDump::create_notes_regions_data() const
 {
     ByteBuffer regions_data;
-    size_t region_index = 0;
+    size_t segment_index = 0;
     for (auto& region : m_process->space().regions()) {
 
         ByteBuffer memory_region_info_buffer;
@@ -263,7 +310,10 @@ ByteBuffer CoreDump::create_notes_regions_data() const
 
         info.region_start = region->vaddr().get();
         info.region_end = region->vaddr().offset(region->size()).get();
-        info.program_header_index = region_index++;
+        // The region's segments follow each other, starting with this one.
+        info.program_header_index = segment_index;
+        while (segment_index < m_segments.size() && m_segments[segment_index].region == region.ptr())
+            ++segment_index;
 
         memory_region_info_buffer.append((void*)&info, sizeof(info));
         // NOTE: The region name *is* null-terminated, so the following is ok:
@@ -321,6 +371,11 @@ KResult CoreDump::write()
     ScopedSpinLock lock(m_process->space().get_lock());
     ProcessPagingScope scope(m_process);
 
+    // Both e_phnum and the program header indices in the notes are 16 bits wide.
+    collect_segments(true);
+    if (m_segments.size() + 1 > NumericLimits<u16>::max())
+        collect_segments(false);
+
     ByteBuffer notes_segment = create_notes_segment_data();
 
     auto result = write_elf_header();
@@ -329,7 +384,7 @@ KResult CoreDump::write()
     result = write_program_headers(notes_segment.size());
     if (result.is_error())
         return result;
-    result = write_regions();
+    result = write_segments();
     if (result.is_error())
         return result;
     result = write_notes_segment(notes_segment);
@@ -9,6 +9,7 @@
 
 #include <AK/NonnullRefPtr.h>
 #include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 
 namespace Kernel {
@@ -24,9 +25,20 @@ private:
     CoreDump(NonnullRefPtr<Process>, NonnullRefPtr<FileDescription>&&);
     static RefPtr<FileDescription> create_target_file(const Process&, const String& output_path);
 
+    // A run of pages of a region that goes into the coredump as one PT_LOAD segment. Runs of pages that were never
+    // touched get a segment without any data in the file, which readers take as zeroes.
+    struct Segment {
+        Region* region { nullptr };
+        size_t first_page { 0 };
+        size_t page_count { 0 };
+        bool has_data { true };
+    };
+
+    void collect_segments(bool leave_out_untouched_pages);
+
     [[nodiscard]] KResult write_elf_header();
     [[nodiscard]] KResult write_program_headers(size_t notes_size);
-    [[nodiscard]] KResult write_regions();
+    [[nodiscard]] KResult write_segments();
     [[nodiscard]] KResult write_notes_segment(ByteBuffer&);
 
     ByteBuffer create_notes_segment_data() const;
@@ -37,7 +49,7 @@ private:
 
     NonnullRefPtr<Process> m_process;
     NonnullRefPtr<FileDescription> m_fd;
-    const size_t m_num_program_headers;
+    Vector<Segment> m_segments;
 };
 
 }
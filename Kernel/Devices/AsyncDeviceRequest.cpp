@@ -6,12 +6,14 @@
 
 #include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/Devices/Device.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
 AsyncDeviceRequest::AsyncDeviceRequest(Device& device)
     : m_device(device)
     , m_process(*Process::current())
+    , m_trace_start(Tracepoints::begin())
 {
 }
 
@@ -74,11 +76,10 @@ void AsyncDeviceRequest::add_sub_request(NonnullRefPtr<AsyncDeviceRequest> sub_r
     VERIFY(sub_request->m_parent_request == nullptr);
     sub_request->m_parent_request = this;
 
+    // NOTE: The sub-request is started by its own device, once that device is ready for it.
     ScopedSpinLock lock(m_lock);
     VERIFY(!is_completed_result(m_result));
     m_sub_requests_pending.append(sub_request);
-    if (m_result == Started)
-        sub_request->do_start(move(lock));
 }
 
 void AsyncDeviceRequest::sub_request_finished(AsyncDeviceRequest& sub_request)
@@ -135,6 +136,7 @@ void AsyncDeviceRequest::complete(RequestResult result)
         VERIFY(m_result == Started);
         m_result = result;
     }
+    Tracepoints::end(Tracepoint::BlockIO, m_trace_start);
     if (Processor::current().in_irq()) {
         ref(); // Make sure we don't get freed
         Processor::deferred_call_queue([this]() {
@@ -150,6 +150,8 @@ private:
     WaitQueue m_queue;
     NonnullRefPtr<Process> m_process;
     void* m_private { nullptr };
+    // When the request was submitted, if latency tracing is enabled.
+    Optional<u64> m_trace_start;
     mutable SpinLock<u8> m_lock;
 };
 
@@ -63,11 +63,26 @@ String Device::absolute_path(const FileDescription&) const
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest& completed_request)
 {
     ScopedSpinLock lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
+    VERIFY(m_started_request_count > 0);
+
+    // NOTE: Requests that were started together may complete in any order.
+    size_t index = 0;
+    auto it = m_requests.begin();
+    while (it != m_requests.end() && it->ptr() != &completed_request) {
+        ++it;
+        ++index;
+    }
+    VERIFY(index < m_started_request_count);
+    m_requests.remove(it);
+    m_started_request_count--;
+
+    // The next request to start is the first one after all those still in progress.
+    it = m_requests.begin();
+    for (index = 0; index < m_started_request_count && it != m_requests.end(); index++)
+        ++it;
+    if (it != m_requests.end()) {
+        m_started_request_count++;
+        auto* next_request = it->ptr();
         next_request->do_start(move(lock));
     }
 
@@ -48,15 +48,19 @@ public:
 
     void process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest&);
 
+    // How many requests this device can be working on at once. Any further requests are queued until one completes.
+    virtual size_t max_concurrent_requests() const { return 1; }
+
     template<typename AsyncRequestType, typename... Args>
     NonnullRefPtr<AsyncRequestType> make_request(Args&&... args)
     {
         auto request = adopt_ref(*new AsyncRequestType(*this, forward<Args>(args)...));
         ScopedSpinLock lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
         m_requests.append(request);
-        if (was_empty)
+        if (m_started_request_count < max_concurrent_requests()) {
+            m_started_request_count++;
             request->do_start(move(lock));
+        }
         return request;
     }
 
@@ -74,7 +78,9 @@ private:
     gid_t m_gid { 0 };
 
     SpinLock<u8> m_requests_lock;
+    // Requests are started in order, so the first m_started_request_count of these are the ones in progress.
     DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_started_request_count { 0 };
 };
 
 }
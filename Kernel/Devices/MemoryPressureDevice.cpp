@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Devices/MemoryPressureDevice.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Sections.h>
+#include <LibC/errno_numbers.h>
+
+namespace Kernel {
+
+// No level has this value, so that every file description starts out readable.
+static constexpr u8 no_level_read_yet = 0xff;
+
+struct MemoryPressureDescriptionData : public FileDescriptionData {
+    u8 last_read_level { no_level_read_yet };
+};
+
+static MemoryPressureDevice* s_the;
+
+UNMAP_AFTER_INIT NonnullRefPtr<MemoryPressureDevice> MemoryPressureDevice::must_create()
+{
+    auto device = adopt_ref(*new MemoryPressureDevice);
+    s_the = device.ptr();
+    return device;
+}
+
+MemoryPressureDevice* MemoryPressureDevice::the()
+{
+    return s_the;
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::MemoryPressureDevice()
+    : CharacterDevice(1, 10)
+{
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::~MemoryPressureDevice()
+{
+}
+
+void MemoryPressureDevice::set_level(MemoryPressureLevel level)
+{
+    if (m_level.exchange(to_underlying(level)) != to_underlying(level))
+        evaluate_block_conditions();
+}
+
+KResultOr<NonnullRefPtr<FileDescription>> MemoryPressureDevice::open(int options)
+{
+    auto description_or_error = CharacterDevice::open(options);
+    if (description_or_error.is_error())
+        return description_or_error;
+    auto data = adopt_own_if_nonnull(new (nothrow) MemoryPressureDescriptionData);
+    if (!data)
+        return ENOMEM;
+    description_or_error.value()->data() = data.release_nonnull();
+    return description_or_error;
+}
+
+bool MemoryPressureDevice::can_read(const FileDescription& description, size_t) const
+{
+    auto& data = static_cast<MemoryPressureDescriptionData const&>(*description.data());
+    return data.last_read_level != m_level.load();
+}
+
+KResultOr<size_t> MemoryPressureDevice::read(FileDescription& description, u64, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (size == 0)
+        return 0;
+    u8 level = m_level.load();
+    if (!buffer.write(&level, 1))
+        return EFAULT;
+    static_cast<MemoryPressureDescriptionData&>(*description.data()).last_read_level = level;
+    return 1;
+}
+
+KResultOr<size_t> MemoryPressureDevice::write(FileDescription&, u64, const UserOrKernelBuffer&, size_t)
+{
+    return EINVAL;
+}
+
+}
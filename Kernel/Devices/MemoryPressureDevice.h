@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <Kernel/Devices/CharacterDevice.h>
+
+namespace Kernel {
+
+// Publishes the memory pressure level to userspace, so that processes can shrink their caches before the kernel has to
+// start purging their volatile memory. See Kernel/API/MemoryPressure.h for how it's read.
+class MemoryPressureDevice final : public CharacterDevice {
+    AK_MAKE_ETERNAL
+public:
+    static NonnullRefPtr<MemoryPressureDevice> must_create();
+    static MemoryPressureDevice* the();
+    virtual ~MemoryPressureDevice() override;
+
+    // Wakes up everyone waiting to read if the level changed.
+    void set_level(MemoryPressureLevel);
+
+    // ^File
+    virtual KResultOr<NonnullRefPtr<FileDescription>> open(int options) override;
+
+    // ^Device
+    virtual mode_t required_mode() const override { return 0444; }
+    virtual String device_name() const override { return "mempressure"; }
+
+private:
+    MemoryPressureDevice();
+
+    // ^CharacterDevice
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override;
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual StringView class_name() const override { return "MemoryPressureDevice"; }
+
+    Atomic<u8> m_level { to_underlying(MemoryPressureLevel::None) };
+};
+
+}
@@ -5,9 +5,13 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tasks/WriteBackTask.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
@@ -16,42 +20,52 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
 };
 
 class DiskCache {
 public:
+    // The cache grows in chunks of this many blocks whenever it would otherwise evict a block,
+    // for as long as there is enough free physical memory. It only goes back down to
+    // min_chunk_count when the memory manager reports memory pressure.
+    static constexpr size_t entries_per_chunk = 256;
+    static constexpr size_t min_chunk_count = 4;
+
     explicit DiskCache(BlockBasedFileSystem& fs)
         : m_fs(fs)
-        , m_cached_block_data(KBuffer::create_with_size(m_entry_count * m_fs.block_size()))
-        , m_entries(KBuffer::create_with_size(m_entry_count * sizeof(CacheEntry)))
     {
-        for (size_t i = 0; i < m_entry_count; ++i) {
-            entries()[i].data = m_cached_block_data.data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        for (size_t i = 0; i < min_chunk_count; ++i)
+            VERIFY(try_grow());
     }
 
     ~DiskCache() = default;
 
-    bool is_dirty() const { return m_dirty; }
-    void set_dirty(bool b) { m_dirty = b; }
+    bool is_dirty() const { return m_dirty_count > 0; }
+    size_t dirty_count() const { return m_dirty_count; }
 
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-        m_dirty = false;
+            mark_clean(*entry);
+        VERIFY(m_dirty_count == 0);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
         m_dirty_list.prepend(entry);
-        m_dirty = true;
+        if (!entry.is_dirty) {
+            entry.is_dirty = true;
+            ++m_dirty_count;
+        }
     }
 
     void mark_clean(CacheEntry& entry)
     {
         m_clean_list.prepend(entry);
+        if (entry.is_dirty) {
+            entry.is_dirty = false;
+            --m_dirty_count;
+        }
     }
 
     CacheEntry& get(BlockBasedFileSystem::BlockIndex block_index) const
@@ -62,6 +76,12 @@ public:
             return entry;
         }
 
+        // Rather than evicting a block we might need again, see if we can afford to cache more blocks.
+        if (m_clean_list.is_empty() || m_clean_list.last()->has_data) {
+            if (m_chunks.size() < max_chunk_count())
+                const_cast<DiskCache&>(*this).try_grow();
+        }
+
         if (m_clean_list.is_empty()) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
@@ -74,7 +94,7 @@ public:
         auto& new_entry = *m_clean_list.last();
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
+        remove_from_hash(new_entry);
         m_hash.set(block_index, &new_entry);
 
         new_entry.block_index = block_index;
@@ -83,8 +103,23 @@ public:
         return new_entry;
     }
 
-    const CacheEntry* entries() const { return (const CacheEntry*)m_entries.data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries.data(); }
+    // Gives back half of the cache's chunks (but not less than min_chunk_count).
+    // All entries must be clean, i.e. the caller has to flush writes first.
+    void shrink()
+    {
+        VERIFY(!is_dirty());
+        size_t target_chunk_count = max(m_chunks.size() / 2, min_chunk_count);
+        while (m_chunks.size() > target_chunk_count) {
+            auto chunk = m_chunks.take_last();
+            for (size_t i = 0; i < entries_per_chunk; ++i) {
+                auto& entry = chunk->entries()[i];
+                remove_from_hash(entry);
+                m_clean_list.remove(entry);
+            }
+        }
+    }
+
+    size_t entry_count() const { return m_chunks.size() * entries_per_chunk; }
 
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
@@ -94,14 +129,57 @@ public:
     }
 
 private:
+    struct Chunk {
+        Chunk(NonnullOwnPtr<KBuffer> block_data, NonnullOwnPtr<KBuffer> entries)
+            : block_data(move(block_data))
+            , entry_data(move(entries))
+        {
+        }
+
+        CacheEntry* entries() { return (CacheEntry*)entry_data->data(); }
+
+        NonnullOwnPtr<KBuffer> block_data;
+        NonnullOwnPtr<KBuffer> entry_data;
+    };
+
+    void remove_from_hash(CacheEntry& entry) const
+    {
+        if (auto it = m_hash.find(entry.block_index); it != m_hash.end() && it->value == &entry)
+            m_hash.remove(it);
+    }
+
+    size_t max_chunk_count() const
+    {
+        // Allow the cache to grow into a quarter of the physical memory that's still available.
+        auto memory_info = MM.get_system_memory_info();
+        size_t available_bytes = memory_info.user_physical_pages_uncommitted * PAGE_SIZE;
+        return m_chunks.size() + available_bytes / 4 / (entries_per_chunk * m_fs.block_size());
+    }
+
+    bool try_grow()
+    {
+        auto block_data = KBuffer::try_create_with_size(entries_per_chunk * m_fs.block_size(), Region::Access::Read | Region::Access::Write, "Disk cache");
+        auto entry_data = KBuffer::try_create_with_size(entries_per_chunk * sizeof(CacheEntry));
+        if (!block_data || !entry_data)
+            return false;
+        auto chunk = adopt_own_if_nonnull(new (nothrow) Chunk(block_data.release_nonnull(), entry_data.release_nonnull()));
+        if (!chunk)
+            return false;
+        for (size_t i = 0; i < entries_per_chunk; ++i) {
+            auto* entry = new (&chunk->entries()[i]) CacheEntry;
+            entry->data = chunk->block_data->data() + i * m_fs.block_size();
+            m_clean_list.append(*entry);
+        }
+        m_chunks.append(chunk.release_nonnull());
+        return true;
+    }
+
     BlockBasedFileSystem& m_fs;
-    size_t m_entry_count { 10000 };
     mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
     mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_clean_list;
     mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_dirty_list;
-    KBuffer m_cached_block_data;
-    KBuffer m_entries;
-    bool m_dirty { false };
+    NonnullOwnPtrVector<Chunk> m_chunks;
+    size_t m_dirty_count { 0 };
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(FileDescription& file_description)
@@ -144,9 +222,104 @@ KResult BlockBasedFileSystem::write_block(BlockIndex index, const UserOrKernelBu
 
     cache().mark_dirty(entry);
     entry.has_data = true;
+
+    locker.unlock();
+    throttle_writer_if_needed();
     return KSuccess;
 }
 
+BlockBasedFileSystem::DirtyThresholds BlockBasedFileSystem::dirty_thresholds() const
+{
+    VERIFY(m_cache_lock.is_locked());
+    auto entry_count = cache().entry_count();
+    return {
+        .background = entry_count * WriteBackTask::dirty_background_ratio() / 100,
+        .limit = entry_count * WriteBackTask::dirty_ratio() / 100,
+    };
+}
+
+void BlockBasedFileSystem::throttle_writer_if_needed()
+{
+    size_t dirty_count;
+    DirtyThresholds thresholds;
+    {
+        MutexLocker locker(m_cache_lock);
+        dirty_count = cache().dirty_count();
+        thresholds = dirty_thresholds();
+    }
+    if (dirty_count <= thresholds.background)
+        return;
+
+    WriteBackTask::wake();
+
+    // Slow down writers in proportion to how far we are past the background threshold,
+    // so that the write-back task can catch up without anyone having to flush everything.
+    if (thresholds.limit <= thresholds.background)
+        return;
+    auto excess = min(dirty_count, thresholds.limit) - thresholds.background;
+    auto delay_ms = max_writer_throttle_ms * excess / (thresholds.limit - thresholds.background);
+    if (delay_ms > 0)
+        (void)Thread::current()->sleep(Time::from_milliseconds(delay_ms));
+}
+
+void BlockBasedFileSystem::write_back_dirty_blocks()
+{
+    Vector<CacheEntry*> dirty_entries;
+    Vector<BlockIndex> dirty_block_indices;
+    {
+        MutexLocker locker(m_cache_lock);
+        if (!m_cache || m_write_back_in_progress || cache().dirty_count() <= dirty_thresholds().background)
+            return;
+        cache().for_each_dirty_entry([&](CacheEntry& entry) {
+            dirty_entries.append(&entry);
+        });
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+        for (auto* entry : dirty_entries)
+            dirty_block_indices.append(entry->block_index);
+        m_write_back_in_progress = true;
+    }
+
+    // Write the blocks back in ascending order, one request at a time. We only hold the cache lock
+    // while a single request is in flight, so that writers never have to wait for all of it.
+    size_t max_blocks_per_write = max(max_coalesced_transfer_size / block_size(), (size_t)1);
+    auto run_data = ByteBuffer::create_uninitialized(max_blocks_per_write * block_size());
+    auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(run_data.data());
+    Vector<CacheEntry*, 16> run;
+    size_t count = 0;
+    for (size_t i = 0; i < dirty_entries.size();) {
+        MutexLocker locker(m_cache_lock);
+        if (cache().dirty_count() <= dirty_thresholds().background)
+            break;
+
+        // The entry may have been written out (and even reused) while we didn't hold the lock.
+        auto is_still_dirty = [&](size_t index) {
+            return dirty_entries[index]->is_dirty && dirty_entries[index]->block_index == dirty_block_indices[index];
+        };
+
+        run.clear_with_capacity();
+        for (; i < dirty_entries.size() && run.size() < max_blocks_per_write; ++i) {
+            if (!is_still_dirty(i))
+                continue;
+            if (!run.is_empty() && dirty_block_indices[i].value() != run.last()->block_index.value() + 1)
+                break;
+            run.append(dirty_entries[i]);
+        }
+        if (run.is_empty())
+            continue;
+
+        for (size_t j = 0; j < run.size(); ++j)
+            memcpy(run_data.data() + j * block_size(), run[j]->data, block_size());
+        [[maybe_unused]] auto rc = write_to_device(run[0]->block_index.value() * block_size(), run.size() * block_size(), run_buffer);
+        for (auto* entry : run)
+            cache().mark_clean(*entry);
+        count += run.size();
+    }
+
+    MutexLocker locker(m_cache_lock);
+    m_write_back_in_progress = false;
+    dbgln_if(BBFS_DEBUG, "{}: Wrote back {} blocks", class_name(), count);
+}
+
 bool BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
 {
     auto base_offset = index.value() * m_logical_block_size;
@@ -237,6 +410,51 @@ KResult BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count, User
     VERIFY(m_logical_block_size);
     if (!count)
         return EINVAL;
+    if (count == 1 || !allow_cache)
+        return read_blocks_one_by_one(index, count, buffer, allow_cache);
+
+    MutexLocker locker(m_cache_lock);
+
+    size_t max_blocks_per_read = max(max_coalesced_transfer_size / block_size(), (size_t)1);
+    unsigned i = 0;
+    while (i < count) {
+        auto& entry = cache().get(BlockIndex { index.value() + i });
+        if (entry.has_data) {
+            if (!buffer.write(entry.data, i * block_size(), block_size()))
+                return EFAULT;
+            ++i;
+            continue;
+        }
+
+        // Gather the run of adjacent blocks that aren't cached either, and read them with one request.
+        Vector<CacheEntry*, 16> run;
+        run.append(&entry);
+        while (i + run.size() < count && run.size() < max_blocks_per_read) {
+            auto& next_entry = cache().get(BlockIndex { index.value() + i + run.size() });
+            if (next_entry.has_data)
+                break;
+            run.append(&next_entry);
+        }
+
+        auto run_data = ByteBuffer::create_uninitialized(run.size() * block_size());
+        auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(run_data.data());
+        if (auto result = read_from_device((index.value() + i) * block_size(), run_data.size(), run_buffer); result.is_error())
+            return result;
+
+        for (size_t j = 0; j < run.size(); ++j) {
+            memcpy(run[j]->data, run_data.data() + j * block_size(), block_size());
+            run[j]->has_data = true;
+        }
+        if (!buffer.write(run_data.data(), i * block_size(), run_data.size()))
+            return EFAULT;
+        i += run.size();
+    }
+
+    return KSuccess;
+}
+
+KResult BlockBasedFileSystem::read_blocks_one_by_one(BlockIndex index, unsigned count, UserOrKernelBuffer& buffer, bool allow_cache) const
+{
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
     auto out = buffer;
@@ -250,6 +468,36 @@ KResult BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count, User
     return KSuccess;
 }
 
+KResult BlockBasedFileSystem::read_from_device(u64 offset, size_t size, UserOrKernelBuffer& buffer) const
+{
+    // The device may split up large transfers, so keep going until we have everything.
+    size_t nread = 0;
+    while (nread < size) {
+        auto buffer_offset = buffer.offset(nread);
+        auto result = file_description().read(buffer_offset, offset + nread, size - nread);
+        if (result.is_error())
+            return result.error();
+        if (result.value() == 0)
+            return EIO;
+        nread += result.value();
+    }
+    return KSuccess;
+}
+
+KResult BlockBasedFileSystem::write_to_device(u64 offset, size_t size, const UserOrKernelBuffer& buffer)
+{
+    size_t nwritten = 0;
+    while (nwritten < size) {
+        auto result = file_description().write(offset + nwritten, buffer.offset(nwritten), size - nwritten);
+        if (result.is_error())
+            return result.error();
+        if (result.value() == 0)
+            return EIO;
+        nwritten += result.value();
+    }
+    return KSuccess;
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
     MutexLocker locker(m_cache_lock);
@@ -275,20 +523,52 @@ void BlockBasedFileSystem::flush_writes_impl()
     MutexLocker locker(m_cache_lock);
     if (!cache().is_dirty())
         return;
-    u32 count = 0;
+    Vector<CacheEntry*> dirty_entries;
     cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        auto base_offset = entry.block_index.value() * block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-        [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-        ++count;
+        dirty_entries.append(&entry);
     });
+    quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+    // Write out runs of adjacent dirty blocks with a single request each.
+    size_t max_blocks_per_write = max(max_coalesced_transfer_size / block_size(), (size_t)1);
+    auto run_data = ByteBuffer::create_uninitialized(max_blocks_per_write * block_size());
+    auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(run_data.data());
+    u32 count = 0;
+    for (size_t i = 0; i < dirty_entries.size();) {
+        auto first_block_index = dirty_entries[i]->block_index.value();
+        size_t run_length = 1;
+        while (i + run_length < dirty_entries.size() && run_length < max_blocks_per_write
+            && dirty_entries[i + run_length]->block_index.value() == first_block_index + run_length)
+            ++run_length;
+
+        for (size_t j = 0; j < run_length; ++j)
+            memcpy(run_data.data() + j * block_size(), dirty_entries[i + j]->data, block_size());
+        [[maybe_unused]] auto rc = write_to_device(first_block_index * block_size(), run_length * block_size(), run_buffer);
+
+        count += run_length;
+        i += run_length;
+    }
     cache().mark_all_clean();
     dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
+void BlockBasedFileSystem::shrink_cache_if_under_memory_pressure()
+{
+    MutexLocker locker(m_cache_lock);
+    // The write-back task holds on to cache entries while it isn't holding the lock.
+    if (!m_cache || m_write_back_in_progress || !MM.is_under_memory_pressure())
+        return;
+    if (cache().is_dirty())
+        flush_writes_impl();
+    auto old_entry_count = cache().entry_count();
+    cache().shrink();
+    dbgln_if(BBFS_DEBUG, "{}: Shrunk disk cache from {} to {} blocks", class_name(), old_entry_count, cache().entry_count());
+}
+
 void BlockBasedFileSystem::flush_writes()
 {
     flush_writes_impl();
+    shrink_cache_if_under_memory_pressure();
 }
 
 DiskCache& BlockBasedFileSystem::cache() const
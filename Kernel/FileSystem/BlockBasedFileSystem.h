@@ -20,6 +20,8 @@ public:
 
     virtual void flush_writes() override;
     void flush_writes_impl();
+    virtual void write_back_dirty_blocks() override;
+    virtual void shrink_cache() override { shrink_cache_if_under_memory_pressure(); }
 
 protected:
     explicit BlockBasedFileSystem(FileDescription&);
@@ -39,11 +41,30 @@ protected:
     u64 m_logical_block_size { 512 };
 
 private:
+    // Runs of adjacent blocks are transferred to and from the device in requests of up to this size.
+    static constexpr size_t max_coalesced_transfer_size = 64 * KiB;
+
+    KResult read_blocks_one_by_one(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache) const;
+    KResult read_from_device(u64 offset, size_t size, UserOrKernelBuffer&) const;
+    KResult write_to_device(u64 offset, size_t size, const UserOrKernelBuffer&);
+
     DiskCache& cache() const;
     void flush_specific_block_if_needed(BlockIndex index);
+    void shrink_cache_if_under_memory_pressure();
+
+    // Writers are slowed down by up to this much once the background write-back threshold is exceeded.
+    static constexpr size_t max_writer_throttle_ms = 50;
+
+    struct DirtyThresholds {
+        size_t background { 0 };
+        size_t limit { 0 };
+    };
+    DirtyThresholds dirty_thresholds() const;
+    void throttle_writer_if_needed();
 
     mutable Mutex m_cache_lock;
     mutable OwnPtr<DiskCache> m_cache;
+    bool m_write_back_in_progress { false };
 };
 
 }
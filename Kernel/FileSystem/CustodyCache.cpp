@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/CustodyCache.h>
+#include <Kernel/FileSystem/Inode.h>
+
+namespace Kernel {
+
+static AK::Singleton<CustodyCache> s_the;
+
+CustodyCache& CustodyCache::the()
+{
+    return *s_the;
+}
+
+Optional<RefPtr<Custody>> CustodyCache::lookup(Custody& parent, StringView name, u64& generation)
+{
+    auto hash = hash_for(parent.inode(), name);
+    auto& shard = shard_for(hash);
+    MutexLocker locker(shard.lock);
+
+    generation = shard.generation;
+    auto it = shard.buckets.find(hash, [&](auto& entry) { return entry.key.directory == &parent.inode() && entry.key.name == name; });
+    if (it == shard.buckets.end())
+        return {};
+    for (auto& entry : it->value) {
+        if (entry->parent.ptr() != &parent)
+            continue;
+        shard.lru_list.remove(*entry);
+        shard.lru_list.append(*entry);
+        return entry->child;
+    }
+    return {};
+}
+
+void CustodyCache::add(Custody& parent, StringView name, Custody* child, u64 generation)
+{
+    auto hash = hash_for(parent.inode(), name);
+    auto& shard = shard_for(hash);
+
+    auto new_entry = adopt_own_if_nonnull(new (nothrow) Entry { parent, name, child, {} });
+    if (!new_entry)
+        return;
+
+    // Entries are destroyed once the shard is unlocked, as dropping the last reference
+    // to a Custody may also drop the last reference to its Inode.
+    OwnPtr<Entry> evicted_entry;
+
+    MutexLocker locker(shard.lock);
+    if (shard.generation != generation)
+        return;
+
+    auto it = shard.buckets.find(hash, [&](auto& entry) { return entry.key.directory == &parent.inode() && entry.key.name == name; });
+    if (it != shard.buckets.end()) {
+        for (auto& entry : it->value) {
+            if (entry->parent.ptr() == &parent)
+                return;
+        }
+    }
+
+    if (shard.entry_count >= max_entries_per_shard)
+        evicted_entry = take_entry(shard, *shard.lru_list.first());
+
+    // The eviction may have emptied and removed the bucket we found above.
+    it = shard.buckets.find(hash, [&](auto& entry) { return entry.key.directory == &parent.inode() && entry.key.name == name; });
+    if (it == shard.buckets.end()) {
+        shard.buckets.set({ &parent.inode(), name }, {});
+        it = shard.buckets.find(hash, [&](auto& entry) { return entry.key.directory == &parent.inode() && entry.key.name == name; });
+        VERIFY(it != shard.buckets.end());
+    }
+    shard.lru_list.append(*new_entry);
+    it->value.append(new_entry.release_nonnull());
+    ++shard.entry_count;
+}
+
+NonnullOwnPtr<CustodyCache::Entry> CustodyCache::take_entry(Shard& shard, Entry& entry)
+{
+    VERIFY(shard.lock.is_locked());
+    auto& directory = entry.parent->inode();
+    auto hash = hash_for(directory, entry.name);
+    auto it = shard.buckets.find(hash, [&](auto& bucket) { return bucket.key.directory == &directory && bucket.key.name == entry.name; });
+    VERIFY(it != shard.buckets.end());
+
+    auto& bucket = it->value;
+    for (size_t i = 0; i < bucket.size(); ++i) {
+        if (bucket[i].ptr() != &entry)
+            continue;
+        auto taken_entry = bucket.take(i);
+        if (bucket.is_empty())
+            shard.buckets.remove(it);
+        shard.lru_list.remove(*taken_entry);
+        --shard.entry_count;
+        return taken_entry;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void CustodyCache::invalidate(Inode const& directory, StringView name)
+{
+    auto hash = hash_for(directory, name);
+    auto& shard = shard_for(hash);
+
+    Vector<NonnullOwnPtr<Entry>, 1> invalidated_entries;
+    {
+        MutexLocker locker(shard.lock);
+        ++shard.generation;
+        auto it = shard.buckets.find(hash, [&](auto& entry) { return entry.key.directory == &directory && entry.key.name == name; });
+        if (it == shard.buckets.end())
+            return;
+        invalidated_entries = move(it->value);
+        shard.buckets.remove(it);
+        for (auto& entry : invalidated_entries)
+            shard.lru_list.remove(*entry);
+        shard.entry_count -= invalidated_entries.size();
+    }
+    dbgln_if(CUSTODY_CACHE_DEBUG, "CustodyCache: Invalidated {} entries for '{}' in directory {}", invalidated_entries.size(), name, directory.identifier());
+}
+
+void CustodyCache::invalidate_all()
+{
+    for (auto& shard : m_shards) {
+        HashMap<Key, Vector<NonnullOwnPtr<Entry>, 1>, KeyTraits> invalidated_buckets;
+        {
+            MutexLocker locker(shard.lock);
+            ++shard.generation;
+            while (auto* entry = shard.lru_list.first())
+                shard.lru_list.remove(*entry);
+            invalidated_buckets = move(shard.buckets);
+            shard.entry_count = 0;
+        }
+    }
+    dbgln_if(CUSTODY_CACHE_DEBUG, "CustodyCache: Invalidated all entries");
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/Mutex.h>
+
+namespace Kernel {
+
+// Remembers the Custody that path resolution produced for a name inside a parent Custody,
+// as well as names that turned out not to exist. Entries are keyed by the parent directory's
+// Inode so that the Inode child hooks can invalidate them, and then by the parent Custody itself.
+// Only file systems that report their child changes (i.e. support watchers) may be cached.
+class CustodyCache {
+public:
+    static CustodyCache& the();
+
+    CustodyCache() = default;
+
+    // Returns an empty Optional if nothing is known about the name. A null Custody means
+    // that the name is known not to exist. On a miss, `generation` has to be passed to add().
+    Optional<RefPtr<Custody>> lookup(Custody& parent, StringView name, u64& generation);
+    void add(Custody& parent, StringView name, Custody* child, u64 generation);
+
+    void invalidate(Inode const& directory, StringView name);
+    void invalidate_all();
+
+private:
+    static constexpr size_t shard_count = 8;
+    static constexpr size_t max_entries_per_shard = 512;
+
+    struct Entry {
+        NonnullRefPtr<Custody> parent;
+        String name;
+        RefPtr<Custody> child;
+        IntrusiveListNode<Entry> lru_list_node;
+    };
+
+    struct Key {
+        Inode const* directory { nullptr };
+        String name;
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key) { return hash_for(*key.directory, key.name); }
+        static bool equals(Key const& a, Key const& b) { return a.directory == b.directory && a.name == b.name; }
+    };
+
+    struct Shard {
+        Mutex lock { "CustodyCacheShard" };
+        HashMap<Key, Vector<NonnullOwnPtr<Entry>, 1>, KeyTraits> buckets;
+        IntrusiveList<Entry, RawPtr<Entry>, &Entry::lru_list_node> lru_list;
+        size_t entry_count { 0 };
+        // Bumped by every invalidation, so that add() can tell whether the result
+        // of a lookup that raced with a change is still good.
+        u64 generation { 0 };
+    };
+
+    static unsigned hash_for(Inode const& directory, StringView name) { return pair_int_hash(ptr_hash(&directory), name.hash()); }
+    Shard& shard_for(unsigned hash) { return m_shards[hash % shard_count]; }
+
+    NonnullOwnPtr<Entry> take_entry(Shard&, Entry&);
+
+    Array<Shard, shard_count> m_shards;
+};
+
+}
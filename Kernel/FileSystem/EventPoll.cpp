@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr u32 supported_events = POLLIN | POLLPRI | POLLOUT;
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::Exception; // Always report errors and hang-ups, like poll() does.
+    if (events & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & POLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    return block_flags;
+}
+
+static u32 events_for_block_flags(BlockFlags block_flags)
+{
+    u32 events = 0;
+    if (has_flag(block_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(block_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    if (has_flag(block_flags, BlockFlags::ReadPriority))
+        events |= POLLPRI;
+    if (has_flag(block_flags, BlockFlags::ReadHangUp))
+        events |= POLLRDHUP;
+    if (has_flag(block_flags, BlockFlags::WriteError))
+        events |= POLLERR;
+    if (has_flag(block_flags, BlockFlags::WriteHangUp))
+        events |= POLLNVAL;
+    return events;
+}
+
+KResultOr<NonnullRefPtr<EventPoll>> EventPoll::try_create()
+{
+    auto event_poll = adopt_ref_if_nonnull(new (nothrow) EventPoll);
+    if (!event_poll)
+        return ENOMEM;
+    return event_poll.release_nonnull();
+}
+
+EventPoll::~EventPoll()
+{
+    // The watches unlink themselves from the ready list, so they have to go first.
+    m_watches.clear();
+    VERIFY(m_ready_watches.is_empty());
+}
+
+EventPoll::Watch::Watch(EventPoll& event_poll, int fd, FileDescription& description, event_poll_event const& event)
+    : m_event_poll(event_poll)
+    , m_fd(fd)
+    , m_description(description)
+    , m_event(event)
+{
+}
+
+EventPoll::Watch::~Watch()
+{
+    m_description->block_condition().remove_blocker(*this, nullptr);
+    m_event_poll.remove_from_ready_list(*this);
+}
+
+void EventPoll::Watch::update(event_poll_event const& event)
+{
+    ScopedSpinLock lock(m_lock);
+    m_event = event;
+}
+
+event_poll_event EventPoll::Watch::event() const
+{
+    ScopedSpinLock lock(m_lock);
+    return m_event;
+}
+
+u32 EventPoll::Watch::ready_events() const
+{
+    return events_for_block_flags(m_description->should_unblock(block_flags_for_events(event().events)));
+}
+
+bool EventPoll::Watch::unblock(bool, void*)
+{
+    // This is called with the block condition of the watched file locked, whenever that file might
+    // have become ready. We never actually unblock anything, so that we stay registered with it.
+    if (ready_events() != 0)
+        m_event_poll.mark_ready(*this);
+    return false;
+}
+
+void EventPoll::mark_ready(Watch& watch)
+{
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        if (watch.m_ready_list_node.is_in_list())
+            return;
+        m_ready_watches.append(watch);
+    }
+    evaluate_block_conditions();
+}
+
+void EventPoll::remove_from_ready_list(Watch& watch)
+{
+    ScopedSpinLock lock(m_ready_lock);
+    if (watch.m_ready_list_node.is_in_list())
+        m_ready_watches.remove(watch);
+}
+
+bool EventPoll::can_read(const FileDescription&, size_t) const
+{
+    ScopedSpinLock lock(m_ready_lock);
+    return !m_ready_watches.is_empty();
+}
+
+KResult EventPoll::add_watch(int fd, FileDescription& description, event_poll_event const& event)
+{
+    if (description.file().is_event_poll())
+        return EINVAL;
+    if (event.events & ~supported_events || event.flags & ~EVENT_POLL_EDGE_TRIGGERED)
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (auto it = m_watches.find(fd); it != m_watches.end()) {
+        if (&it->value->description() == &description)
+            return EEXIST;
+        // The file descriptor was closed and has been reused since it was added, so drop the old watch.
+        m_watches.remove(it);
+    }
+
+    auto watch = adopt_own_if_nonnull(new (nothrow) Watch(*this, fd, description, event));
+    if (!watch)
+        return ENOMEM;
+    auto& watch_ref = *watch;
+    m_watches.set(fd, watch.release_nonnull());
+
+    // NOTE: This checks whether the file is ready right away, and puts the watch on the ready list if so.
+    bool was_added = description.block_condition().add_blocker(watch_ref, nullptr);
+    VERIFY(was_added);
+
+    dbgln_if(EVENT_POLL_DEBUG, "EventPoll: Added watch for fd {} with events {:#x} and flags {:#x}", fd, event.events, event.flags);
+    return KSuccess;
+}
+
+KResult EventPoll::modify_watch(int fd, FileDescription& description, event_poll_event const& event)
+{
+    if (event.events & ~supported_events || event.flags & ~EVENT_POLL_EDGE_TRIGGERED)
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end() || &it->value->description() != &description)
+        return ENOENT;
+
+    auto& watch = *it->value;
+    watch.update(event);
+    // Report the file descriptor if it is ready for the new set of events, like when it was added.
+    watch.unblock(false, nullptr);
+    return KSuccess;
+}
+
+KResult EventPoll::remove_watch(int fd)
+{
+    MutexLocker locker(m_lock);
+    if (!m_watches.remove(fd))
+        return ENOENT;
+    dbgln_if(EVENT_POLL_DEBUG, "EventPoll: Removed watch for fd {}", fd);
+    return KSuccess;
+}
+
+KResultOr<size_t> EventPoll::collect_ready_events(Process& process, Span<event_poll_event> events)
+{
+    MutexLocker locker(m_lock);
+
+    Vector<Watch*, 32> candidates;
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        while (!m_ready_watches.is_empty() && candidates.size() < events.size()) {
+            auto& watch = *m_ready_watches.first();
+            if (!candidates.try_append(&watch))
+                break;
+            m_ready_watches.remove(watch);
+        }
+    }
+
+    size_t ready_count = 0;
+    for (auto* watch : candidates) {
+        // Watches are not removed when their file descriptor is closed, so catch that here.
+        auto description = process.fds().file_description(watch->fd());
+        if (description.ptr() != &watch->description()) {
+            dbgln_if(EVENT_POLL_DEBUG, "EventPoll: Dropping watch for closed fd {}", watch->fd());
+            m_watches.remove(watch->fd());
+            continue;
+        }
+
+        // The file may not be ready anymore by now, in which case it will be put back once it is.
+        auto ready_events = watch->ready_events();
+        if (ready_events == 0)
+            continue;
+
+        auto event = watch->event();
+        event.events = ready_events;
+        events[ready_count++] = event;
+
+        // A level-triggered watch is checked again by the next wait, and only then dropped from the
+        // ready list if its file isn't ready anymore. An edge-triggered one waits for the next change.
+        if (!(event.flags & EVENT_POLL_EDGE_TRIGGERED)) {
+            ScopedSpinLock lock(m_ready_lock);
+            if (!watch->m_ready_list_node.is_in_list())
+                m_ready_watches.append(*watch);
+        }
+    }
+    return ready_count;
+}
+
+}
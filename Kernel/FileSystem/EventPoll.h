@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <Kernel/API/EventPoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/Thread.h>
+
+namespace Kernel {
+
+// A persistent set of watched file descriptors. Each watch stays registered with the block condition
+// of its file, and moves itself onto the ready list when the file's state changes, so that waiting
+// for events costs time proportional to the number of ready file descriptors, not the watched ones.
+class EventPoll final : public File {
+public:
+    static KResultOr<NonnullRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    KResult add_watch(int fd, FileDescription&, event_poll_event const&);
+    KResult modify_watch(int fd, FileDescription&, event_poll_event const&);
+    KResult remove_watch(int fd);
+
+    // Fills in (at most) the given events without blocking, and returns how many are ready.
+    KResultOr<size_t> collect_ready_events(Process&, Span<event_poll_event>);
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+
+    virtual String absolute_path(const FileDescription&) const override { return ":event-poll:"; }
+    virtual StringView class_name() const override { return "EventPoll"; }
+    virtual bool is_event_poll() const override { return true; }
+
+private:
+    class Watch final : public Thread::FileBlocker {
+    public:
+        Watch(EventPoll&, int fd, FileDescription&, event_poll_event const&);
+        virtual ~Watch() override;
+
+        int fd() const { return m_fd; }
+        FileDescription& description() { return m_description; }
+
+        void update(event_poll_event const&);
+        event_poll_event event() const;
+        u32 ready_events() const;
+
+        virtual bool unblock(bool, void*) override;
+        virtual void not_blocking(bool) override { }
+        virtual const char* state_string() const override { return "EventPoll"; }
+
+        IntrusiveListNode<Watch> m_ready_list_node;
+
+    private:
+        EventPoll& m_event_poll;
+        int const m_fd;
+        NonnullRefPtr<FileDescription> m_description;
+        event_poll_event m_event;
+    };
+
+    EventPoll() = default;
+
+    void mark_ready(Watch&);
+    void remove_from_ready_list(Watch&);
+
+    Mutex m_lock { "EventPoll" };
+    HashMap<int, NonnullOwnPtr<Watch>> m_watches;
+
+    mutable SpinLock<u8> m_ready_lock;
+    IntrusiveList<Watch, RawPtr<Watch>, &Watch::m_ready_list_node> m_ready_watches;
+};
+
+}
@@ -691,27 +691,9 @@ void Ext2FS::flush_writes()
 {
     {
         MutexLocker locker(m_lock);
-        if (m_super_block_dirty) {
-            flush_super_block();
-            m_super_block_dirty = false;
-        }
-        if (m_block_group_descriptors_dirty) {
-            flush_block_group_descriptor_table();
-            m_block_group_descriptors_dirty = false;
-        }
-        for (auto& cached_bitmap : m_cached_bitmaps) {
-            if (cached_bitmap->dirty) {
-                auto buffer = UserOrKernelBuffer::for_kernel_buffer(cached_bitmap->buffer.data());
-                if (auto result = write_block(cached_bitmap->bitmap_block_index, buffer, block_size()); result.is_error()) {
-                    dbgln("Ext2FS[{}]::flush_writes(): Failed to write blocks: {}", fsid(), result.error());
-                }
-                cached_bitmap->dirty = false;
-                dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::flush_writes(): Flushed bitmap block {}", fsid(), cached_bitmap->bitmap_block_index);
-            }
-        }
-
         // Uncache Inodes that are only kept alive by the index-to-inode lookup cache.
         // We don't uncache Inodes that are being watched by at least one InodeWatcher.
+        // NOTE: This happens before flushing the metadata, since uncached Inodes give back their preallocated blocks.
 
         // FIXME: It would be better to keep a capped number of Inodes around.
         //        The problem is that they are quite heavy objects, and use a lot of heap memory
@@ -733,6 +715,25 @@ void Ext2FS::flush_writes()
         }
         for (auto index : unused_inodes)
             uncache_inode(index);
+
+        if (m_super_block_dirty) {
+            flush_super_block();
+            m_super_block_dirty = false;
+        }
+        if (m_block_group_descriptors_dirty) {
+            flush_block_group_descriptor_table();
+            m_block_group_descriptors_dirty = false;
+        }
+        for (auto& cached_bitmap : m_cached_bitmaps) {
+            if (cached_bitmap->dirty) {
+                auto buffer = UserOrKernelBuffer::for_kernel_buffer(cached_bitmap->buffer.data());
+                if (auto result = write_block(cached_bitmap->bitmap_block_index, buffer, block_size()); result.is_error()) {
+                    dbgln("Ext2FS[{}]::flush_writes(): Failed to write blocks: {}", fsid(), result.error());
+                }
+                cached_bitmap->dirty = false;
+                dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::flush_writes(): Flushed bitmap block {}", fsid(), cached_bitmap->bitmap_block_index);
+            }
+        }
     }
 
     BlockBasedFileSystem::flush_writes();
@@ -745,6 +746,7 @@ Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
 
 Ext2FSInode::~Ext2FSInode()
 {
+    discard_preallocated_blocks();
     if (m_raw_inode.i_links_count == 0)
         fs().free_inode(*this);
 }
@@ -863,6 +865,19 @@ KResultOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKern
 
     bool allow_cache = !description || !description->is_direct();
 
+    size_t nread = 0;
+    if (allow_cache) {
+        // If the file is mapped into memory, some of its pages may already be resident.
+        auto nread_or_error = read_bytes_from_shared_vmobject(offset, min((off_t)count, (off_t)size() - offset), buffer);
+        if (nread_or_error.is_error())
+            return nread_or_error.error();
+        nread = nread_or_error.value();
+        if (nread == count || static_cast<u64>(offset + nread) >= size())
+            return nread;
+        offset += nread;
+        count -= nread;
+    }
+
     const int block_size = fs().block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -872,7 +887,6 @@ KResultOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKern
 
     int offset_into_first_block = offset % block_size;
 
-    size_t nread = 0;
     auto remaining_count = min((off_t)count, (off_t)size() - offset);
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
@@ -886,6 +900,19 @@ KResultOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKern
             // This is a hole, act as if it's filled with zeroes.
             if (!buffer_offset.memset(0, num_bytes_to_copy))
                 return EFAULT;
+        } else if (offset_into_block == 0 && num_bytes_to_copy == (size_t)block_size) {
+            // Read whole blocks that are also adjacent on disk with a single call.
+            unsigned run_length = 1;
+            while (bi.value() + run_length <= last_block_logical_index.value()
+                && (size_t)remaining_count >= (run_length + 1) * block_size
+                && m_block_list[bi.value() + run_length].value() == block_index.value() + run_length)
+                ++run_length;
+            if (auto result = fs().read_blocks(block_index, run_length, buffer_offset, allow_cache); result.is_error()) {
+                dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read {} blocks starting at {} (index {})", identifier(), run_length, block_index.value(), bi);
+                return result.error();
+            }
+            num_bytes_to_copy = run_length * block_size;
+            bi = bi.value() + run_length - 1;
         } else {
             if (auto result = fs().read_block(block_index, &buffer_offset, num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
                 dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read block {} (index {})", identifier(), block_index.value(), bi);
@@ -919,7 +946,7 @@ KResult Ext2FSInode::resize(u64 new_size)
 
     if (blocks_needed_after > blocks_needed_before) {
         auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
-        if (additional_blocks_needed > fs().super_block().s_free_blocks_count)
+        if (additional_blocks_needed > fs().super_block().s_free_blocks_count + m_preallocated_block_count)
             return ENOSPC;
     }
 
@@ -927,12 +954,11 @@ KResult Ext2FSInode::resize(u64 new_size)
         m_block_list = this->compute_block_list();
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before);
-        if (blocks_or_error.is_error())
-            return blocks_or_error.error();
-        if (!m_block_list.try_extend(blocks_or_error.release_value()))
-            return ENOMEM;
+        if (auto result = grow_block_list(blocks_needed_after - blocks_needed_before); result.is_error())
+            return result;
     } else if (blocks_needed_after < blocks_needed_before) {
+        // The preallocated blocks only make sense right after the end of the block list.
+        discard_preallocated_blocks();
         if constexpr (EXT2_VERY_DEBUG) {
             dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
             for (auto block_index : m_block_list) {
@@ -978,6 +1004,74 @@ KResult Ext2FSInode::resize(u64 new_size)
     return KSuccess;
 }
 
+KResult Ext2FSInode::grow_block_list(size_t count)
+{
+    Vector<BlockBasedFileSystem::BlockIndex> new_blocks;
+    if (!new_blocks.try_ensure_capacity(count))
+        return ENOMEM;
+
+    while (new_blocks.size() < count && m_preallocated_block_count) {
+        new_blocks.unchecked_append(m_preallocated_block_index);
+        m_preallocated_block_index = m_preallocated_block_index.value() + 1;
+        --m_preallocated_block_count;
+    }
+
+    if (new_blocks.size() < count) {
+        VERIFY(!m_preallocated_block_count);
+        auto blocks_needed = count - new_blocks.size();
+
+        // Ask for the blocks right after the current end of the inode, so that appending keeps the file contiguous.
+        BlockBasedFileSystem::BlockIndex goal_block_index;
+        if (!new_blocks.is_empty())
+            goal_block_index = new_blocks.last().value() + 1;
+        else if (!m_block_list.is_empty() && m_block_list.last().value())
+            goal_block_index = m_block_list.last().value() + 1;
+
+        // Regular files mostly grow by appending, so reserve a few more blocks for the next append while we're at it.
+        size_t blocks_to_preallocate = 0;
+        if (Kernel::is_regular_file(m_raw_inode.i_mode) && fs().super_block().s_free_blocks_count > blocks_needed + preallocation_window_size)
+            blocks_to_preallocate = preallocation_window_size;
+
+        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed + blocks_to_preallocate, goal_block_index);
+        if (blocks_or_error.is_error())
+            return blocks_or_error.error();
+        auto blocks = blocks_or_error.release_value();
+
+        for (size_t i = 0; i < blocks_needed; ++i)
+            new_blocks.unchecked_append(blocks[i]);
+
+        // Only the extra blocks that directly follow the new end of the inode are worth keeping around.
+        auto last_block_index = new_blocks.last();
+        for (size_t i = blocks_needed; i < blocks.size(); ++i) {
+            if (blocks[i].value() == last_block_index.value() + 1 + m_preallocated_block_count) {
+                if (!m_preallocated_block_count)
+                    m_preallocated_block_index = blocks[i];
+                ++m_preallocated_block_count;
+                continue;
+            }
+            if (auto result = fs().set_block_allocation_state(blocks[i], false); result.is_error()) {
+                dbgln("Ext2FSInode[{}]::grow_block_list(): Failed to free block {}: {}", identifier(), blocks[i], result.error());
+                return result;
+            }
+        }
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::grow_block_list(): Preallocated {} block(s) starting at {}", identifier(), m_preallocated_block_count, m_preallocated_block_index);
+    }
+
+    if (!m_block_list.try_extend(move(new_blocks)))
+        return ENOMEM;
+    return KSuccess;
+}
+
+void Ext2FSInode::discard_preallocated_blocks()
+{
+    while (m_preallocated_block_count) {
+        --m_preallocated_block_count;
+        BlockBasedFileSystem::BlockIndex block_index = m_preallocated_block_index.value() + m_preallocated_block_count;
+        if (auto result = fs().set_block_allocation_state(block_index, false); result.is_error())
+            dbgln("Ext2FSInode[{}]::discard_preallocated_blocks(): Failed to free block {}: {}", identifier(), block_index, result.error());
+    }
+}
+
 KResultOr<size_t> Ext2FSInode::write_bytes(off_t offset, size_t count, const UserOrKernelBuffer& data, FileDescription* description)
 {
     VERIFY(offset >= 0);
@@ -1031,6 +1125,9 @@ KResultOr<size_t> Ext2FSInode::write_bytes(off_t offset, size_t count, const Use
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes(): Writing {} bytes, {} bytes into inode from {}", identifier(), count, offset, data.user_or_kernel_ptr());
 
+    // Make sure that neither read_bytes() nor page faults keep seeing the old contents.
+    release_shared_vmobject_pages(offset, remaining_count);
+
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
@@ -1170,6 +1267,132 @@ KResult Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries)
     return KSuccess;
 }
 
+void Ext2FSInode::drop_directory_index()
+{
+    // We don't maintain the hash tree index of indexed directories, so make sure that
+    // nobody trusts a stale one once we start changing the directory entries in place.
+    if (m_raw_inode.i_flags & EXT2_INDEX_FL) {
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::drop_directory_index(): Clearing the directory index flag", identifier());
+        m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
+        set_metadata_dirty(true);
+    }
+}
+
+KResult Ext2FSInode::insert_directory_entry(StringView name, InodeIndex inode_index, u8 file_type)
+{
+    MutexLocker locker(m_inode_lock);
+    VERIFY(is_directory());
+    drop_directory_index();
+
+    u8 buffer[max_block_size];
+    auto buf = UserOrKernelBuffer::for_kernel_buffer(buffer);
+
+    auto block_size = fs().block_size();
+    auto block_count = size() / block_size;
+    auto needed_length = EXT2_DIR_REC_LEN(name.length());
+
+    auto write_entry = [&](ext2_dir_entry_2& entry, u16 record_length) {
+        entry.inode = inode_index.value();
+        entry.rec_len = record_length;
+        entry.name_len = name.length();
+        entry.file_type = file_type;
+        memcpy(entry.name, name.characters_without_null_termination(), name.length());
+    };
+
+    auto write_directory_block = [&](u64 block) -> KResult {
+        auto result = write_bytes(block * block_size, block_size, buf, nullptr);
+        if (result.is_error())
+            return result.error();
+        if (result.value() != block_size)
+            return EIO;
+        m_directory_insert_hint = block;
+        set_metadata_dirty(true);
+        return KSuccess;
+    };
+
+    // Look for an entry with enough slack space after it, starting at the block that last had some.
+    auto first_block = m_directory_insert_hint < block_count ? m_directory_insert_hint : 0;
+    for (u64 i = 0; i < block_count; ++i) {
+        auto block = (first_block + i) % block_count;
+        if (auto result = read_bytes(block * block_size, block_size, buf, nullptr); result.is_error())
+            return result.error();
+
+        size_t entry_offset = 0;
+        while (entry_offset < block_size) {
+            auto* entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + entry_offset);
+            if (entry->rec_len < EXT2_DIR_REC_LEN(0) || entry_offset + entry->rec_len > block_size) {
+                dbgln("Ext2FSInode[{}]::insert_directory_entry(): Invalid record length {} in block {}", identifier(), entry->rec_len, block);
+                return EIO;
+            }
+            size_t used_length = entry->inode ? EXT2_DIR_REC_LEN(entry->name_len) : 0;
+            if (entry->rec_len >= used_length + needed_length) {
+                u16 free_length = entry->rec_len - used_length;
+                if (used_length)
+                    entry->rec_len = used_length;
+                write_entry(*reinterpret_cast<ext2_dir_entry_2*>(buffer + entry_offset + used_length), free_length);
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::insert_directory_entry(): Inserted '{}' into block {} at offset {}", identifier(), name, block, entry_offset + used_length);
+                return write_directory_block(block);
+            }
+            entry_offset += entry->rec_len;
+        }
+    }
+
+    // There was no room anywhere, so the entry gets a new block to itself.
+    memset(buffer, 0, block_size);
+    write_entry(*reinterpret_cast<ext2_dir_entry_2*>(buffer), block_size);
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::insert_directory_entry(): Inserted '{}' into new block {}", identifier(), name, block_count);
+    return write_directory_block(block_count);
+}
+
+KResult Ext2FSInode::remove_directory_entry(StringView name)
+{
+    MutexLocker locker(m_inode_lock);
+    VERIFY(is_directory());
+    drop_directory_index();
+
+    u8 buffer[max_block_size];
+    auto buf = UserOrKernelBuffer::for_kernel_buffer(buffer);
+
+    auto block_size = fs().block_size();
+    auto block_count = size() / block_size;
+
+    for (u64 block = 0; block < block_count; ++block) {
+        if (auto result = read_bytes(block * block_size, block_size, buf, nullptr); result.is_error())
+            return result.error();
+
+        ext2_dir_entry_2* previous_entry = nullptr;
+        size_t entry_offset = 0;
+        while (entry_offset < block_size) {
+            auto* entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + entry_offset);
+            if (entry->rec_len < EXT2_DIR_REC_LEN(0) || entry_offset + entry->rec_len > block_size) {
+                dbgln("Ext2FSInode[{}]::remove_directory_entry(): Invalid record length {} in block {}", identifier(), entry->rec_len, block);
+                return EIO;
+            }
+            if (entry->inode != 0 && name == StringView(entry->name, entry->name_len)) {
+                // The space of the removed entry goes to the entry before it. The first entry
+                // in a block has no such entry, so it just becomes unused instead.
+                if (previous_entry)
+                    previous_entry->rec_len += entry->rec_len;
+                else
+                    entry->inode = 0;
+
+                auto result = write_bytes(block * block_size, block_size, buf, nullptr);
+                if (result.is_error())
+                    return result.error();
+                if (result.value() != block_size)
+                    return EIO;
+                m_directory_insert_hint = block;
+                set_metadata_dirty(true);
+                return KSuccess;
+            }
+            previous_entry = entry;
+            entry_offset += entry->rec_len;
+        }
+    }
+
+    return ENOENT;
+}
+
 KResultOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, uid_t uid, gid_t gid)
 {
     if (::is_directory(mode))
@@ -1187,37 +1410,22 @@ KResult Ext2FSInode::add_child(Inode& child, const StringView& name, mode_t mode
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    bool name_already_exists = false;
-    KResult result = traverse_as_directory([&](auto& entry) {
-        if (name == entry.name) {
-            name_already_exists = true;
-            return false;
-        }
-        entries.append({ entry.name, entry.inode.index(), entry.file_type });
-        return true;
-    });
-
-    if (result.is_error())
-        return result;
+    if (auto populate_result = populate_lookup_cache(); populate_result.is_error())
+        return populate_result;
 
-    if (name_already_exists) {
+    if (m_lookup_cache.contains(name)) {
         dbgln("Ext2FSInode[{}]::add_child(): Name '{}' already exists", identifier(), name);
         return EEXIST;
     }
 
-    result = child.increment_link_count();
+    auto result = child.increment_link_count();
     if (result.is_error())
         return result;
 
-    entries.empend(name, child.index(), to_ext2_file_type(mode));
-    result = write_directory(entries);
+    result = insert_directory_entry(name, child.index(), to_ext2_file_type(mode));
     if (result.is_error())
         return result;
 
-    if (auto populate_result = populate_lookup_cache(); populate_result.is_error())
-        return populate_result;
-
     m_lookup_cache.set(name, child.index());
     did_add_child(child.identifier(), name);
     return KSuccess;
@@ -1239,16 +1447,7 @@ KResult Ext2FSInode::remove_child(const StringView& name)
 
     InodeIdentifier child_id { fsid(), child_inode_index };
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    KResult result = traverse_as_directory([&](auto& entry) {
-        if (name != entry.name)
-            entries.append({ entry.name, entry.inode.index(), entry.file_type });
-        return true;
-    });
-    if (result.is_error())
-        return result;
-
-    result = write_directory(entries);
+    auto result = remove_directory_entry(name);
     if (result.is_error())
         return result;
 
@@ -1292,9 +1491,9 @@ bool Ext2FS::write_ext2_inode(InodeIndex inode, const ext2_inode& e2inode)
     return write_block(block_index, buffer, inode_size(), offset) >= 0;
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> KResultOr<Vector<BlockIndex>>
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal_block_index) -> KResultOr<Vector<BlockIndex>>
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal: {})", preferred_group_index, count, goal_block_index);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -1303,6 +1502,34 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
         return ENOMEM;
 
     MutexLocker locker(m_lock);
+
+    // Take as many free blocks as we can starting at the goal block before looking anywhere else.
+    if (goal_block_index.value() >= first_block_index().value() && goal_block_index.value() < super_block().s_blocks_count) {
+        GroupIndex goal_group_index = (goal_block_index.value() - first_block_index().value()) / blocks_per_group() + 1;
+        auto& bgd = group_descriptor(goal_group_index);
+        if (bgd.bg_free_blocks_count) {
+            auto cached_bitmap_or_error = get_bitmap_block(bgd.bg_block_bitmap);
+            if (cached_bitmap_or_error.is_error())
+                return cached_bitmap_or_error.error();
+            auto& cached_bitmap = *cached_bitmap_or_error.value();
+
+            int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+            auto block_bitmap = cached_bitmap.bitmap(blocks_in_group);
+
+            BlockIndex first_block_in_group = (goal_group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+            for (size_t bit_index = goal_block_index.value() - first_block_in_group.value(); bit_index < block_bitmap.size() && blocks.size() < count; ++bit_index) {
+                BlockIndex block_index = bit_index + first_block_in_group.value();
+                if (block_index.value() >= super_block().s_blocks_count || block_bitmap.get(bit_index))
+                    break;
+                if (auto result = set_block_allocation_state(block_index, true); result.is_error()) {
+                    dbgln("Ext2FS: Failed to allocate block {} in allocate_blocks()", block_index);
+                    return result;
+                }
+                blocks.unchecked_append(block_index);
+                dbgln_if(EXT2_DEBUG, "  allocated > {} (goal)", block_index);
+            }
+        }
+    }
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
@@ -58,8 +58,13 @@ private:
     virtual KResultOr<int> get_block_address(int) override;
 
     KResult write_directory(Vector<Ext2FSDirectoryEntry>&);
+    KResult insert_directory_entry(StringView name, InodeIndex, u8 file_type);
+    KResult remove_directory_entry(StringView name);
+    void drop_directory_index();
     KResult populate_lookup_cache() const;
     KResult resize(u64);
+    KResult grow_block_list(size_t);
+    void discard_preallocated_blocks();
     KResult write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     KResult grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     KResult shrink_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
@@ -75,8 +80,16 @@ private:
     const Ext2FS& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
+    static constexpr size_t preallocation_window_size = 8;
+
     mutable Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
+
+    // Blocks directly following the end of m_block_list that are marked as used on disk,
+    // but don't belong to the inode yet. Growing the inode takes these first.
+    BlockBasedFileSystem::BlockIndex m_preallocated_block_index;
+    size_t m_preallocated_block_count { 0 };
     mutable HashMap<String, InodeIndex> m_lookup_cache;
+    u64 m_directory_insert_hint { 0 };
     ext2_inode m_raw_inode;
 };
 
@@ -136,7 +149,7 @@ private:
 
     BlockIndex first_block_index() const;
     KResultOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    KResultOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    KResultOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal_block_index = {});
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
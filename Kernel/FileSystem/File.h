@@ -109,7 +109,9 @@ public:
     virtual bool is_block_device() const { return false; }
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
+    virtual bool is_event_poll() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_io_ring() const { return false; }
 
     virtual FileBlockCondition& block_condition() { return m_block_condition; }
 
@@ -116,6 +116,7 @@ public:
     void set_fifo_direction(Badge<FIFO>, FIFO::Direction direction) { m_fifo_direction = direction; }
 
     OwnPtr<FileDescriptionData>& data() { return m_data; }
+    OwnPtr<FileDescriptionData> const& data() const { return m_data; }
 
     void set_original_inode(Badge<VirtualFileSystem>, NonnullRefPtr<Inode>&& inode) { m_inode = move(inode); }
 
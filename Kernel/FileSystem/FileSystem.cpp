@@ -64,6 +64,32 @@ void FileSystem::sync()
         fs.flush_writes();
 }
 
+void FileSystem::write_back()
+{
+    NonnullRefPtrVector<FileSystem, 32> file_systems;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_file_systems())
+            file_systems.append(*it.value);
+    }
+
+    for (auto& fs : file_systems)
+        fs.write_back_dirty_blocks();
+}
+
+void FileSystem::shrink_caches()
+{
+    NonnullRefPtrVector<FileSystem, 32> file_systems;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_file_systems())
+            file_systems.append(*it.value);
+    }
+
+    for (auto& fs : file_systems)
+        fs.shrink_cache();
+}
+
 void FileSystem::lock_all()
 {
     for (auto& it : all_file_systems()) {
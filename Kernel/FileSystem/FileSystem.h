@@ -29,6 +29,8 @@ public:
     unsigned fsid() const { return m_fsid; }
     static FileSystem* from_fsid(u32);
     static void sync();
+    static void write_back();
+    static void shrink_caches();
     static void lock_all();
 
     virtual bool initialize() = 0;
@@ -55,6 +57,12 @@ public:
 
     virtual void flush_writes() { }
 
+    // Called by the write-back task to write out some dirty data before it has to be flushed.
+    virtual void write_back_dirty_blocks() { }
+
+    // Called by the memory reclaim task to give back memory that is only used for caching.
+    virtual void shrink_cache() { }
+
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Process.h>
+#include <Kernel/VM/MemoryManager.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+KResultOr<NonnullRefPtr<IORing>> IORing::try_create(u32 entry_count)
+{
+    if (entry_count == 0 || entry_count > IORING_MAX_ENTRIES || (entry_count & (entry_count - 1)) != 0)
+        return EINVAL;
+
+    auto size = io_ring_mapping_size(entry_count);
+    auto vmobject = AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow);
+    if (!vmobject)
+        return ENOMEM;
+    auto kernel_region = MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing", Region::Access::Read | Region::Access::Write);
+    if (!kernel_region)
+        return ENOMEM;
+
+    auto ring = adopt_ref_if_nonnull(new (nothrow) IORing(entry_count, vmobject.release_nonnull(), kernel_region.release_nonnull()));
+    if (!ring)
+        return ENOMEM;
+    return ring.release_nonnull();
+}
+
+IORing::IORing(u32 entry_count, NonnullRefPtr<AnonymousVMObject> vmobject, NonnullOwnPtr<Region> kernel_region)
+    : m_entry_count(entry_count)
+    , m_vmobject(move(vmobject))
+    , m_kernel_region(move(kernel_region))
+{
+    auto& header = this->header();
+    memset(&header, 0, sizeof(header));
+    header.entry_count = entry_count;
+    header.submission_entries_offset = io_ring_submission_entries_offset();
+    header.completion_entries_offset = io_ring_completion_entries_offset(entry_count);
+}
+
+IORing::~IORing()
+{
+    VERIFY(m_worker_count == 0);
+}
+
+IORingHeader& IORing::header()
+{
+    return *reinterpret_cast<IORingHeader*>(m_kernel_region->vaddr().as_ptr());
+}
+
+IORingHeader const& IORing::header() const
+{
+    return *reinterpret_cast<IORingHeader const*>(m_kernel_region->vaddr().as_ptr());
+}
+
+IORingSubmission const& IORing::submission_at(u32 index) const
+{
+    auto* entries = reinterpret_cast<IORingSubmission const*>(m_kernel_region->vaddr().offset(io_ring_submission_entries_offset()).as_ptr());
+    return entries[index & (m_entry_count - 1)];
+}
+
+IORingCompletion& IORing::completion_at(u32 index)
+{
+    auto* entries = reinterpret_cast<IORingCompletion*>(m_kernel_region->vaddr().offset(io_ring_completion_entries_offset(m_entry_count)).as_ptr());
+    return entries[index & (m_entry_count - 1)];
+}
+
+u32 IORing::unreaped_completion_count() const
+{
+    // NOTE: Userspace owns the head, so treat any nonsense in it as a full completion queue.
+    auto head = AK::atomic_load(const_cast<u32 volatile*>(&header().completion_head), AK::memory_order_acquire);
+    return min(m_completion_tail - head, m_entry_count);
+}
+
+bool IORing::can_read(const FileDescription&, size_t) const
+{
+    return unreaped_completion_count() > 0;
+}
+
+KResultOr<Region*> IORing::mmap(Process& process, FileDescription&, const Range& range, u64 offset, int prot, bool shared)
+{
+    if (offset != 0 || range.size() != m_vmobject->size())
+        return EINVAL;
+
+    // A private mapping would never see any of the completions.
+    if (!shared)
+        return EINVAL;
+
+    return process.space().allocate_region_with_vmobject(range, m_vmobject, offset, "IORing", prot, shared);
+}
+
+KResult IORing::close()
+{
+    MutexLocker locker(m_lock);
+    m_closed = true;
+    m_work_wait_queue.wake_all();
+    return KSuccess;
+}
+
+KResultOr<size_t> IORing::submit(Process& process)
+{
+    MutexLocker locker(m_lock);
+    if (m_closed)
+        return EBADF;
+
+    auto tail = AK::atomic_load(&header().submission_tail, AK::memory_order_acquire);
+    if (tail - m_submission_head > m_entry_count)
+        return EINVAL;
+
+    size_t submitted_count = 0;
+    while (m_submission_head != tail) {
+        // Every operation we take on will need a completion entry, so don't take on more than there is room for.
+        if (m_in_flight_count + unreaped_completion_count() >= m_entry_count)
+            break;
+
+        auto submission = submission_at(m_submission_head);
+        ++m_submission_head;
+        AK::atomic_store(&header().submission_head, m_submission_head, AK::memory_order_release);
+        ++submitted_count;
+
+        if (submission.opcode > IORingOpcode::Fsync) {
+            post_completion(submission.user_data, -EINVAL);
+            continue;
+        }
+        if (submission.opcode == IORingOpcode::Accept)
+            REQUIRE_PROMISE(accept);
+
+        auto description = process.fds().file_description(submission.fd);
+        if (!description) {
+            post_completion(submission.user_data, -EBADF);
+            continue;
+        }
+
+        dbgln_if(IO_RING_DEBUG, "IORing: Queueing operation {} on fd {} (user data {:p})", (u8)submission.opcode, submission.fd, submission.user_data);
+        m_pending_operations.append({ submission, description.release_nonnull() });
+        ++m_in_flight_count;
+    }
+
+    auto pending_count = m_pending_operations.size_slow();
+    while (m_idle_worker_count < pending_count && m_worker_count < max_worker_count) {
+        // The worker takes over this reference, see worker_main().
+        ref();
+        auto thread = process.create_kernel_thread(worker_main, this, THREAD_PRIORITY_NORMAL, "IORing worker", THREAD_AFFINITY_DEFAULT, false);
+        if (!thread) {
+            unref();
+            break;
+        }
+        ++m_worker_count;
+        ++m_idle_worker_count;
+    }
+
+    if (pending_count)
+        m_work_wait_queue.wake_all();
+    return submitted_count;
+}
+
+KResult IORing::wait_for_completions(u32 count)
+{
+    count = min(count, m_entry_count);
+    for (;;) {
+        {
+            MutexLocker locker(m_lock);
+            if (unreaped_completion_count() >= count)
+                return KSuccess;
+            // Nothing else is going to complete, so don't wait for it.
+            if (m_in_flight_count == 0)
+                return KSuccess;
+        }
+        if (m_completion_wait_queue.wait_on({}, "IORing").was_interrupted())
+            return EINTR;
+    }
+}
+
+void IORing::post_completion(u64 user_data, i64 result)
+{
+    VERIFY(m_lock.is_locked());
+    auto& completion = completion_at(m_completion_tail);
+    completion.user_data = user_data;
+    completion.result = result;
+    ++m_completion_tail;
+    AK::atomic_store(&header().completion_tail, m_completion_tail, AK::memory_order_release);
+
+    m_completion_wait_queue.wake_all();
+    evaluate_block_conditions();
+}
+
+void IORing::worker_main(void* data)
+{
+    {
+        auto ring = adopt_ref(*static_cast<IORing*>(data));
+        auto& thread = *Thread::current();
+        for (;;) {
+            Optional<Operation> operation;
+            {
+                MutexLocker locker(ring->m_lock);
+                if (thread.should_die() || (ring->m_pending_operations.is_empty() && ring->m_closed)) {
+                    --ring->m_worker_count;
+                    --ring->m_idle_worker_count;
+                    break;
+                }
+                if (ring->m_pending_operations.is_empty()) {
+                    locker.unlock();
+                    ring->m_work_wait_queue.wait_forever("IORing");
+                    continue;
+                }
+                operation = ring->m_pending_operations.take_first();
+                --ring->m_idle_worker_count;
+            }
+
+            auto result = ring->perform(*operation);
+            dbgln_if(IO_RING_DEBUG, "IORing: Operation {} on fd {} (user data {:p}) completed: {}", (u8)operation->submission.opcode, operation->submission.fd, operation->submission.user_data, result.is_error() ? result.error().error() : (i64)result.value());
+
+            MutexLocker locker(ring->m_lock);
+            ring->post_completion(operation->submission.user_data, result.is_error() ? result.error().error() : (i64)result.value());
+            --ring->m_in_flight_count;
+            ++ring->m_idle_worker_count;
+        }
+    }
+    // NOTE: Thread::exit() doesn't return, so the reference to the ring has to be gone by now.
+    Thread::current()->exit();
+}
+
+KResultOr<size_t> IORing::perform(Operation& operation)
+{
+    auto& submission = operation.submission;
+    auto& description = *operation.description;
+
+    // Run the operation the same way the corresponding syscall would.
+    MutexLocker big_locker(Process::current()->big_lock());
+
+    switch (submission.opcode) {
+    case IORingOpcode::Read: {
+        if (!description.is_readable())
+            return EBADF;
+        if (description.is_directory())
+            return EISDIR;
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return EFAULT;
+        if (submission.offset != IORING_OFFSET_CURRENT) {
+            if (!description.file().is_seekable())
+                return ESPIPE;
+            return description.read(buffer.value(), submission.offset, submission.length);
+        }
+        if (description.is_blocking() && !description.can_read()) {
+            auto unblock_flags = BlockFlags::None;
+            if (Thread::current()->block<Thread::ReadBlocker>({}, description, unblock_flags).was_interrupted())
+                return EINTR;
+            if (!has_flag(unblock_flags, BlockFlags::Read))
+                return EAGAIN;
+        }
+        return description.read(buffer.value(), submission.length);
+    }
+    case IORingOpcode::Write: {
+        if (!description.is_writable())
+            return EBADF;
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return EFAULT;
+        if (submission.offset != IORING_OFFSET_CURRENT) {
+            if (!description.file().is_seekable())
+                return ESPIPE;
+            return description.write(submission.offset, buffer.value(), submission.length);
+        }
+        if (description.is_blocking() && !description.can_write()) {
+            auto unblock_flags = BlockFlags::None;
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted())
+                return EINTR;
+            if (!has_flag(unblock_flags, BlockFlags::Write))
+                return EAGAIN;
+        }
+        return description.write(buffer.value(), submission.length);
+    }
+    case IORingOpcode::Accept:
+        return perform_accept(operation);
+    case IORingOpcode::Recv: {
+        if (!description.is_socket())
+            return ENOTSOCK;
+        auto& socket = *description.socket();
+        if (socket.is_shut_down_for_reading())
+            return 0;
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return EFAULT;
+        Time timestamp {};
+        return socket.recvfrom(description, buffer.value(), submission.length, submission.flags, {}, {}, timestamp);
+    }
+    case IORingOpcode::Send: {
+        if (!description.is_socket())
+            return ENOTSOCK;
+        auto& socket = *description.socket();
+        if (socket.is_shut_down_for_writing())
+            return EPIPE;
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return EFAULT;
+        return socket.sendto(description, buffer.value(), submission.length, submission.flags, {}, 0);
+    }
+    case IORingOpcode::Fsync: {
+        auto* inode = description.inode();
+        if (!inode)
+            return EINVAL;
+        if (inode->is_metadata_dirty())
+            inode->flush_metadata();
+        inode->fs().flush_writes();
+        return 0;
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+KResultOr<size_t> IORing::perform_accept(Operation& operation)
+{
+    auto& description = *operation.description;
+    if (!description.is_socket())
+        return ENOTSOCK;
+    auto& socket = *description.socket();
+    auto& process = *Process::current();
+
+    auto accepted_socket_fd_or_error = process.fds().allocate();
+    if (accepted_socket_fd_or_error.is_error())
+        return accepted_socket_fd_or_error.error();
+    auto accepted_socket_fd = accepted_socket_fd_or_error.release_value();
+
+    // NOTE: Unlike sys$accept4(), we may race with other workers accepting on the same socket.
+    RefPtr<Socket> accepted_socket;
+    for (;;) {
+        if (socket.can_accept()) {
+            accepted_socket = socket.accept();
+            if (accepted_socket)
+                break;
+        }
+        if (!description.is_blocking())
+            return EAGAIN;
+        auto unblock_flags = BlockFlags::None;
+        if (Thread::current()->block<Thread::AcceptBlocker>({}, description, unblock_flags).was_interrupted())
+            return EINTR;
+    }
+
+    auto accepted_socket_description_result = FileDescription::create(*accepted_socket);
+    if (accepted_socket_description_result.is_error())
+        return accepted_socket_description_result.error();
+
+    accepted_socket_description_result.value()->set_readable(true);
+    accepted_socket_description_result.value()->set_writable(true);
+    if (operation.submission.flags & SOCK_NONBLOCK)
+        accepted_socket_description_result.value()->set_blocking(false);
+    int fd_flags = 0;
+    if (operation.submission.flags & SOCK_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+    process.fds()[accepted_socket_fd.fd].set(accepted_socket_description_result.release_value(), fd_flags);
+
+    // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+    accepted_socket->set_setup_state(Socket::SetupState::Completed);
+    return accepted_socket_fd.fd;
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/SinglyLinkedList.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// The kernel side of an I/O ring. Submissions are picked up by sys$io_ring_enter(), and then carried
+// out by a small pool of kernel threads that belong to the submitting process, so that they can block
+// on (and access the user memory of) the operations independently of each other and of the submitter.
+class IORing final : public File {
+public:
+    static KResultOr<NonnullRefPtr<IORing>> try_create(u32 entry_count);
+    virtual ~IORing() override;
+
+    KResultOr<size_t> submit(Process&);
+    KResult wait_for_completions(u32 count);
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual KResultOr<Region*> mmap(Process&, FileDescription&, const Range&, u64 offset, int prot, bool shared) override;
+    virtual KResult close() override;
+
+    virtual String absolute_path(const FileDescription&) const override { return ":io-ring:"; }
+    virtual StringView class_name() const override { return "IORing"; }
+    virtual bool is_io_ring() const override { return true; }
+
+private:
+    static constexpr size_t max_worker_count = 32;
+
+    struct Operation {
+        IORingSubmission submission;
+        NonnullRefPtr<FileDescription> description;
+    };
+
+    IORing(u32 entry_count, NonnullRefPtr<AnonymousVMObject>, NonnullOwnPtr<Region>);
+
+    IORingHeader& header();
+    IORingHeader const& header() const;
+    IORingSubmission const& submission_at(u32 index) const;
+    IORingCompletion& completion_at(u32 index);
+    u32 unreaped_completion_count() const;
+
+    static void worker_main(void*);
+    KResultOr<size_t> perform(Operation&);
+    KResultOr<size_t> perform_accept(Operation&);
+    void post_completion(u64 user_data, i64 result);
+
+    u32 const m_entry_count;
+    NonnullRefPtr<AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Region> m_kernel_region;
+
+    mutable Mutex m_lock { "IORing" };
+    // The kernel's own copies of the indices it advances, as userspace may scribble over the shared ones.
+    u32 m_submission_head { 0 };
+    u32 m_completion_tail { 0 };
+    SinglyLinkedList<Operation> m_pending_operations;
+    size_t m_in_flight_count { 0 };
+    size_t m_worker_count { 0 };
+    size_t m_idle_worker_count { 0 };
+    bool m_closed { false };
+
+    WaitQueue m_work_wait_queue;
+    WaitQueue m_completion_wait_queue;
+};
+
+}
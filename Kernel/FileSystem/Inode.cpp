@@ -11,6 +11,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/CustodyCache.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
@@ -217,6 +218,7 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 void Inode::did_add_child(InodeIdentifier const&, String const& name)
 {
     MutexLocker locker(m_inode_lock);
+    CustodyCache::the().invalidate(*this, name);
 
     for (auto& watcher : m_watchers) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
@@ -226,6 +228,7 @@ void Inode::did_add_child(InodeIdentifier const&, String const& name)
 void Inode::did_remove_child(InodeIdentifier const&, String const& name)
 {
     MutexLocker locker(m_inode_lock);
+    CustodyCache::the().invalidate(*this, name);
 
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
@@ -274,6 +277,37 @@ RefPtr<SharedInodeVMObject> Inode::shared_vmobject() const
     return m_shared_vmobject.strong_ref();
 }
 
+KResultOr<size_t> Inode::read_bytes_from_shared_vmobject(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    auto vmobject = m_shared_vmobject.strong_ref();
+    if (!vmobject)
+        return 0;
+
+    u8 page_buffer[PAGE_SIZE];
+    size_t nread = 0;
+    while (nread < count) {
+        size_t page_index = (offset + nread) / PAGE_SIZE;
+        size_t offset_in_page = (offset + nread) % PAGE_SIZE;
+        if (!vmobject->read_resident_page(page_index, { page_buffer, sizeof(page_buffer) }))
+            break;
+        size_t nread_from_page = min(PAGE_SIZE - offset_in_page, count - nread);
+        if (!buffer.write(page_buffer + offset_in_page, nread, nread_from_page))
+            return EFAULT;
+        nread += nread_from_page;
+    }
+    return nread;
+}
+
+void Inode::release_shared_vmobject_pages(off_t offset, size_t count)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (auto vmobject = m_shared_vmobject.strong_ref())
+        vmobject->release_pages_in_range(offset, count);
+}
+
 template<typename T>
 static inline bool range_overlap(T start1, T len1, T start2, T len2)
 {
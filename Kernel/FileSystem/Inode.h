@@ -111,6 +111,10 @@ protected:
     void did_modify_contents();
     void did_delete_self();
 
+    // The pages of the shared VMObject (if any) double as a page cache for read_bytes().
+    KResultOr<size_t> read_bytes_from_shared_vmobject(off_t offset, size_t count, UserOrKernelBuffer& buffer) const;
+    void release_shared_vmobject_pages(off_t offset, size_t count);
+
     mutable Mutex m_inode_lock { "Inode" };
 
 private:
@@ -9,6 +9,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/CustodyCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/FileSystem.h>
@@ -62,6 +63,7 @@ KResult VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int flags
     // FIXME: check that this is not already a mount point
     Mount mount { fs, &mount_point, flags };
     m_mounts.append(move(mount));
+    CustodyCache::the().invalidate_all();
     return KSuccess;
 }
 
@@ -73,6 +75,7 @@ KResult VirtualFileSystem::bind_mount(Custody& source, Custody& mount_point, int
     // FIXME: check that this is not already a mount point
     Mount mount { source.inode(), mount_point, flags };
     m_mounts.append(move(mount));
+    CustodyCache::the().invalidate_all();
     return KSuccess;
 }
 
@@ -87,6 +90,7 @@ KResult VirtualFileSystem::remount(Custody& mount_point, int new_flags)
         return ENODEV;
 
     mount->set_flags(new_flags);
+    CustodyCache::the().invalidate_all();
     return KSuccess;
 }
 
@@ -95,6 +99,9 @@ KResult VirtualFileSystem::unmount(Inode& guest_inode)
     MutexLocker locker(m_lock);
     dbgln("VirtualFileSystem: unmount called with inode {}", guest_inode.identifier());
 
+    // The cached custodies keep their inodes alive, which would keep the file system busy.
+    CustodyCache::the().invalidate_all();
+
     for (size_t i = 0; i < m_mounts.size(); ++i) {
         auto& mount = m_mounts.at(i);
         if (&mount.guest() == &guest_inode) {
@@ -945,9 +952,40 @@ KResultOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(S
             continue;
         }
 
-        // Okay, let's look up this part.
-        auto child_inode = parent.inode().lookup(part);
-        if (!child_inode) {
+        // Okay, let's look up this part, unless we already did so before.
+        RefPtr<Custody> child_custody;
+        bool use_custody_cache = parent.inode().fs().supports_watchers();
+        bool found_in_custody_cache = false;
+        u64 custody_cache_generation = 0;
+        if (use_custody_cache) {
+            if (auto cached_custody = CustodyCache::the().lookup(parent, part, custody_cache_generation); cached_custody.has_value()) {
+                child_custody = cached_custody.release_value();
+                found_in_custody_cache = true;
+            }
+        }
+
+        if (!found_in_custody_cache) {
+            auto child_inode = parent.inode().lookup(part);
+            if (child_inode) {
+                int mount_flags_for_child = parent.mount_flags();
+
+                // See if there's something mounted on the child; in that case
+                // we would need to return the guest inode, not the host inode.
+                if (auto mount = find_mount_for_host(child_inode->identifier())) {
+                    child_inode = mount->guest();
+                    mount_flags_for_child = mount->flags();
+                }
+
+                auto new_custody_or_error = Custody::try_create(&parent, part, *child_inode, mount_flags_for_child);
+                if (new_custody_or_error.is_error())
+                    return new_custody_or_error.error();
+                child_custody = new_custody_or_error.release_value();
+            }
+            if (use_custody_cache)
+                CustodyCache::the().add(parent, part, child_custody, custody_cache_generation);
+        }
+
+        if (!child_custody) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
                 // we found the immediate parent of the file, but the file itself
@@ -957,22 +995,10 @@ KResultOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(S
             return ENOENT;
         }
 
-        int mount_flags_for_child = parent.mount_flags();
-
-        // See if there's something mounted on the child; in that case
-        // we would need to return the guest inode, not the host inode.
-        if (auto mount = find_mount_for_host(child_inode->identifier())) {
-            child_inode = mount->guest();
-            mount_flags_for_child = mount->flags();
-        }
-
-        auto new_custody_or_error = Custody::try_create(&parent, part, *child_inode, mount_flags_for_child);
-        if (new_custody_or_error.is_error())
-            return new_custody_or_error.error();
-
-        custody = new_custody_or_error.release_value();
+        custody = child_custody.release_nonnull();
+        auto& child_inode = custody->inode();
 
-        if (child_inode->metadata().is_symlink()) {
+        if (child_inode.metadata().is_symlink()) {
             if (!have_more_parts) {
                 if (options & O_NOFOLLOW)
                     return ELOOP;
@@ -980,13 +1006,13 @@ KResultOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(S
                     break;
             }
 
-            if (!safe_to_follow_symlink(*child_inode, parent_metadata))
+            if (!safe_to_follow_symlink(child_inode, parent_metadata))
                 return EACCES;
 
             if (auto result = validate_path_against_process_veil(*custody, options); result.is_error())
                 return result;
 
-            auto symlink_target = child_inode->resolve_as_link(parent, out_parent, options, symlink_recursion_level + 1);
+            auto symlink_target = child_inode.resolve_as_link(parent, out_parent, options, symlink_recursion_level + 1);
             if (symlink_target.is_error() || !have_more_parts)
                 return symlink_target;
 
@@ -23,6 +23,11 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void* data)
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was removed", this, *static_cast<Thread*>(data));
         return false;
     }
+    if (m_pending_wakeups > 0) {
+        m_pending_wakeups--;
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was woken before blocking", this, *static_cast<Thread*>(data));
+        return false;
+    }
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, *static_cast<Thread*>(data));
 
     return true;
@@ -133,6 +138,30 @@ u32 FutexQueue::wake_all(bool& is_empty)
     return did_wake;
 }
 
+Optional<ThreadID> FutexQueue::wake_one_for_handover(bool& is_empty)
+{
+    ScopedSpinLock lock(m_lock);
+    dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_one_for_handover", this);
+    Optional<ThreadID> woken_thread_id;
+    do_unblock([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
+        VERIFY(data);
+        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+        auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+        if (blocker.unblock()) {
+            woken_thread_id = static_cast<Thread*>(data)->tid();
+            stop_iterating = true;
+            return true;
+        }
+        return false;
+    });
+    if (!woken_thread_id.has_value() && m_imminent_waits > 0) {
+        // Nobody has blocked yet, but somebody is about to. Make sure they notice that the futex was unlocked.
+        m_pending_wakeups++;
+    }
+    is_empty = is_empty_and_no_imminent_waits_locked();
+    return woken_thread_id;
+}
+
 bool FutexQueue::is_empty_and_no_imminent_waits_locked()
 {
     return m_imminent_waits == 0 && is_empty_locked();
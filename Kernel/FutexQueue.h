@@ -24,6 +24,8 @@ public:
     u32 wake_n_requeue(u32, const Function<FutexQueue*()>&, u32, bool&, bool&);
     u32 wake_n(u32, const Optional<u32>&, bool&);
     u32 wake_all(bool&);
+    // Wakes up the first waiter and returns its thread ID, so that a priority-inheriting futex can be handed over to it.
+    Optional<ThreadID> wake_one_for_handover(bool&);
 
     template<class... Args>
     Thread::BlockResult wait_on(const Thread::BlockTimeout& timeout, Args&&... args)
@@ -54,6 +56,7 @@ private:
     WeakPtr<VMObject> m_vmobject;
     const bool m_is_global;
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
+    size_t m_pending_wakeups { 0 }; // Handed to imminent waiters, so that they don't block after all
     bool m_was_removed { false };
 };
 
@@ -6,6 +6,7 @@
 
 #include <AK/JsonObjectSerializer.h>
 #include <AK/UBSanitizer.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
@@ -29,6 +30,7 @@
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/ProcessExposed.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/TTY/TTY.h>
 
 namespace Kernel {
@@ -59,6 +61,8 @@ private:
             obj.add("bytes_out", adapter.bytes_out());
             obj.add("link_up", adapter.link_up());
             obj.add("mtu", adapter.mtu());
+            obj.add("transmit_checksum_offload", adapter.has_offload(NetworkAdapter::Offloads::TransmitChecksum));
+            obj.add("receive_checksum_offload", adapter.has_offload(NetworkAdapter::Offloads::ReceiveChecksum));
         });
         array.finish();
         return true;
@@ -107,6 +111,16 @@ private:
             obj.add("bytes_in", socket.bytes_in());
             obj.add("packets_out", socket.packets_out());
             obj.add("bytes_out", socket.bytes_out());
+            obj.add("congestion_control", socket.congestion_control_name());
+            obj.add("congestion_window", socket.congestion_window());
+            obj.add("slow_start_threshold", socket.slow_start_threshold());
+            obj.add("send_window_size", socket.send_window_size());
+            obj.add("send_window_scale", (u32)socket.send_window_scale());
+            obj.add("receive_window_scale", (u32)socket.receive_window_scale());
+            obj.add("sack_permitted", socket.is_sack_permitted());
+            obj.add("smoothed_round_trip_time", socket.smoothed_round_trip_time().to_milliseconds());
+            obj.add("retransmission_timeout", socket.retransmission_timeout().to_milliseconds());
+            obj.add("retransmitted_packets", socket.retransmitted_packets());
         });
         array.finish();
         return true;
@@ -288,6 +302,25 @@ private:
     mutable Mutex m_lock;
 };
 
+class ProcFSLatencyTracing : public ProcFSSystemBoolean {
+public:
+    static NonnullRefPtr<ProcFSLatencyTracing> must_create(const ProcFSSystemDirectory&);
+    virtual bool value() const override
+    {
+        MutexLocker locker(m_lock);
+        return g_latency_tracing_enabled.load();
+    }
+    virtual void set_value(bool new_value) override
+    {
+        MutexLocker locker(m_lock);
+        Tracepoints::set_enabled(new_value);
+    }
+
+private:
+    ProcFSLatencyTracing();
+    mutable Mutex m_lock;
+};
+
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDumpKmallocStacks> ProcFSDumpKmallocStacks::must_create(const ProcFSSystemDirectory&)
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDumpKmallocStacks).release_nonnull();
@@ -301,6 +334,11 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSCapsLockRemap> ProcFSCapsLockRemap::must_cr
     return adopt_ref_if_nonnull(new (nothrow) ProcFSCapsLockRemap).release_nonnull();
 }
 
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSLatencyTracing> ProcFSLatencyTracing::must_create(const ProcFSSystemDirectory&)
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSLatencyTracing).release_nonnull();
+}
+
 UNMAP_AFTER_INIT ProcFSDumpKmallocStacks::ProcFSDumpKmallocStacks()
     : ProcFSSystemBoolean("kmalloc_stacks"sv)
 {
@@ -316,6 +354,11 @@ UNMAP_AFTER_INIT ProcFSCapsLockRemap::ProcFSCapsLockRemap()
 {
 }
 
+UNMAP_AFTER_INIT ProcFSLatencyTracing::ProcFSLatencyTracing()
+    : ProcFSSystemBoolean("latency_tracing"sv)
+{
+}
+
 class ProcFSSelfProcessDirectory final : public ProcFSExposedLink {
 public:
     static NonnullRefPtr<ProcFSSelfProcessDirectory> must_create();
@@ -384,20 +427,66 @@ private:
         json.add("user_physical_available", system_memory.user_physical_pages - system_memory.user_physical_pages_used);
         json.add("user_physical_committed", system_memory.user_physical_pages_committed);
         json.add("user_physical_uncommitted", system_memory.user_physical_pages_uncommitted);
+        json.add("user_physical_zeroed", system_memory.user_physical_pages_zeroed);
+        json.add("zeroed_page_pool_hits", system_memory.zeroed_page_pool_hits);
+        json.add("zeroed_page_pool_misses", system_memory.zeroed_page_pool_misses);
         json.add("super_physical_allocated", system_memory.super_physical_pages_used);
         json.add("super_physical_available", system_memory.super_physical_pages - system_memory.super_physical_pages_used);
         json.add("kmalloc_call_count", stats.kmalloc_call_count);
         json.add("kfree_call_count", stats.kfree_call_count);
-        slab_alloc_stats([&json](size_t slab_size, size_t num_allocated, size_t num_free) {
-            auto prefix = String::formatted("slab_{}", slab_size);
-            json.add(String::formatted("{}_num_allocated", prefix), num_allocated);
-            json.add(String::formatted("{}_num_free", prefix), num_free);
+        json.add("kmalloc_cached", stats.bytes_cached);
+        for (auto& size_class : stats.size_classes) {
+            auto prefix = String::formatted("kmalloc_{}", size_class.allocation_size);
+            json.add(String::formatted("{}_num_cached", prefix), size_class.num_cached);
+            json.add(String::formatted("{}_cache_hits", prefix), size_class.cache_hits);
+            json.add(String::formatted("{}_cache_misses", prefix), size_class.cache_misses);
+        }
+        slab_alloc_stats([&json](SlabAllocatorStats const& slab_stats) {
+            auto prefix = String::formatted("slab_{}", slab_stats.slab_size);
+            json.add(String::formatted("{}_num_allocated", prefix), slab_stats.num_allocated);
+            json.add(String::formatted("{}_num_free", prefix), slab_stats.num_free);
+            json.add(String::formatted("{}_num_cached", prefix), slab_stats.num_cached);
+            json.add(String::formatted("{}_cache_hits", prefix), slab_stats.cache_hits);
+            json.add(String::formatted("{}_cache_misses", prefix), slab_stats.cache_misses);
         });
         json.finish();
         return true;
     }
 };
 
+static String pledge_string(Process const& process)
+{
+    if (!process.is_user_process())
+        return String();
+
+    StringBuilder pledge_builder;
+
+#define __ENUMERATE_PLEDGE_PROMISE(promise)      \
+    if (process.has_promised(Pledge::promise)) { \
+        pledge_builder.append(#promise " ");     \
+    }
+    ENUMERATE_PLEDGE_PROMISES
+#undef __ENUMERATE_PLEDGE_PROMISE
+
+    return pledge_builder.to_string();
+}
+
+static StringView veil_string(Process const& process)
+{
+    if (!process.is_user_process())
+        return {};
+
+    switch (process.veil_state()) {
+    case VeilState::None:
+        return "None"sv;
+    case VeilState::Dropped:
+        return "Dropped"sv;
+    case VeilState::Locked:
+        return "Locked"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 class ProcFSOverallProcesses final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSOverallProcesses> must_create();
@@ -412,33 +501,8 @@ private:
         auto build_process = [&](JsonArraySerializer<KBufferBuilder>& array, const Process& process) {
             auto process_object = array.add_object();
 
-            if (process.is_user_process()) {
-                StringBuilder pledge_builder;
-
-#define __ENUMERATE_PLEDGE_PROMISE(promise)      \
-    if (process.has_promised(Pledge::promise)) { \
-        pledge_builder.append(#promise " ");     \
-    }
-                ENUMERATE_PLEDGE_PROMISES
-#undef __ENUMERATE_PLEDGE_PROMISE
-
-                process_object.add("pledge", pledge_builder.to_string());
-
-                switch (process.veil_state()) {
-                case VeilState::None:
-                    process_object.add("veil", "None");
-                    break;
-                case VeilState::Dropped:
-                    process_object.add("veil", "Dropped");
-                    break;
-                case VeilState::Locked:
-                    process_object.add("veil", "Locked");
-                    break;
-                }
-            } else {
-                process_object.add("pledge", String());
-                process_object.add("veil", String());
-            }
+            process_object.add("pledge", pledge_string(process));
+            process_object.add("veil", veil_string(process));
 
             process_object.add("pid", process.pid().value());
             process_object.add("pgid", process.tty() ? process.tty()->pgid().value() : 0);
@@ -460,6 +524,8 @@ private:
             process_object.add("amount_purgeable_nonvolatile", process.space().amount_purgeable_nonvolatile());
             process_object.add("dumpable", process.is_dumpable());
             process_object.add("kernel", process.is_kernel_process());
+            process_object.add("big_lock_wait_time_ns", process.big_lock_wait_time_ns());
+            process_object.add("big_lock_contention_count", process.big_lock_contention_count());
             auto thread_array = process_object.add_array("threads");
             process.for_each_thread([&](const Thread& thread) {
                 auto thread_object = thread_array.add_object();
@@ -504,6 +570,113 @@ private:
         return true;
     }
 };
+
+// The same as ProcFSOverallProcesses, laid out as described in Kernel/API/ProcessStatistics.h.
+class ProcFSOverallProcessesBinary final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSOverallProcessesBinary> must_create();
+
+private:
+    ProcFSOverallProcessesBinary();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        auto truncated = [](StringView string) {
+            return string.substring_view(0, min(string.length(), NumericLimits<u16>::max()));
+        };
+
+        auto build_thread = [&](const Thread& thread) {
+            auto name = thread.name();
+            auto state = truncated(thread.state_string());
+            ThreadStatisticsRecord record {};
+            record.tid = thread.tid().value();
+            record.times_scheduled = thread.times_scheduled();
+            record.time_user = thread.time_in_user();
+            record.time_kernel = thread.time_in_kernel();
+            record.syscall_count = thread.syscall_count();
+            record.inode_faults = thread.inode_faults();
+            record.zero_faults = thread.zero_faults();
+            record.cow_faults = thread.cow_faults();
+            record.unix_socket_read_bytes = thread.unix_socket_read_bytes();
+            record.unix_socket_write_bytes = thread.unix_socket_write_bytes();
+            record.ipv4_socket_read_bytes = thread.ipv4_socket_read_bytes();
+            record.ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes();
+            record.file_read_bytes = thread.file_read_bytes();
+            record.file_write_bytes = thread.file_write_bytes();
+            record.cpu = thread.cpu();
+            record.priority = thread.priority();
+            record.name_length = truncated(name).length();
+            record.state_length = state.length();
+            builder.append_bytes({ &record, sizeof(record) });
+            builder.append(truncated(name));
+            builder.append(state);
+        };
+
+        auto build_process = [&](const Process& process) {
+            auto executable = process.executable() ? process.executable()->absolute_path() : String::empty();
+            auto tty = truncated(process.tty() ? process.tty()->tty_name().view() : "notty"sv);
+            auto pledge = pledge_string(process);
+            auto veil = veil_string(process);
+
+            ProcessStatisticsRecord record {};
+            record.pid = process.pid().value();
+            record.pgid = process.tty() ? process.tty()->pgid().value() : 0;
+            record.pgp = process.pgid().value();
+            record.sid = process.sid().value();
+            record.uid = process.uid();
+            record.gid = process.gid();
+            record.ppid = process.ppid().value();
+            record.nfds = process.fds().open_count();
+            record.kernel = process.is_kernel_process();
+            record.dumpable = process.is_dumpable();
+            process.for_each_thread([&](const Thread&) {
+                ++record.thread_count;
+            });
+            record.amount_virtual = process.space().amount_virtual();
+            record.amount_resident = process.space().amount_resident();
+            record.amount_shared = process.space().amount_shared();
+            record.amount_dirty_private = process.space().amount_dirty_private();
+            record.amount_clean_inode = process.space().amount_clean_inode();
+            record.amount_purgeable_volatile = process.space().amount_purgeable_volatile();
+            record.amount_purgeable_nonvolatile = process.space().amount_purgeable_nonvolatile();
+            record.big_lock_wait_time_ns = process.big_lock_wait_time_ns();
+            record.big_lock_contention_count = process.big_lock_contention_count();
+            record.name_length = truncated(process.name()).length();
+            record.executable_length = truncated(executable).length();
+            record.tty_length = tty.length();
+            record.pledge_length = truncated(pledge).length();
+            record.veil_length = veil.length();
+            builder.append_bytes({ &record, sizeof(record) });
+            builder.append(truncated(process.name()));
+            builder.append(truncated(executable));
+            builder.append(tty);
+            builder.append(truncated(pledge));
+            builder.append(veil);
+
+            process.for_each_thread([&](const Thread& thread) {
+                build_thread(thread);
+            });
+        };
+
+        ScopedSpinLock lock(g_scheduler_lock);
+        auto processes = Process::all_processes();
+        auto total_time_scheduled = Scheduler::get_total_time_scheduled();
+
+        ProcessStatisticsHeader header {};
+        header.version = PROCESS_STATISTICS_VERSION;
+        header.header_size = sizeof(ProcessStatisticsHeader);
+        header.process_record_size = sizeof(ProcessStatisticsRecord);
+        header.thread_record_size = sizeof(ThreadStatisticsRecord);
+        header.process_count = processes.size() + 1;
+        header.total_time = total_time_scheduled.total;
+        header.total_time_kernel = total_time_scheduled.total_kernel;
+        builder.append_bytes({ &header, sizeof(header) });
+
+        build_process(*Scheduler::colonel());
+        for (auto& process : processes)
+            build_process(process);
+        return true;
+    }
+};
 class ProcFSCPUInformation final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSCPUInformation> must_create();
@@ -535,6 +708,38 @@ private:
         return true;
     }
 };
+class ProcFSSchedulerStatistics final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSSchedulerStatistics> must_create();
+
+private:
+    ProcFSSchedulerStatistics();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        JsonArraySerializer array { builder };
+        Scheduler::for_each_processor_statistics([&](auto& statistics) {
+            auto obj = array.add_object();
+            obj.add("processor", statistics.processor);
+            obj.add("queued_threads", statistics.queued_threads);
+            obj.add("wakeups_on_last_processor", statistics.wakeups_on_last_processor);
+            obj.add("wakeups_migrated", statistics.wakeups_migrated);
+            obj.add("threads_stolen", statistics.threads_stolen);
+        });
+        array.finish();
+        return true;
+    }
+};
+class ProcFSLatency final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSLatency> must_create();
+
+private:
+    ProcFSLatency();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        return Tracepoints::to_json(builder);
+    }
+};
 class ProcFSDmesg final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSDmesg> must_create();
@@ -747,10 +952,22 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSOverallProcesses> ProcFSOverallProcesses::m
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSOverallProcesses).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSOverallProcessesBinary> ProcFSOverallProcessesBinary::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSOverallProcessesBinary).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSCPUInformation> ProcFSCPUInformation::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSCPUInformation).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSSchedulerStatistics> ProcFSSchedulerStatistics::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSSchedulerStatistics).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSLatency> ProcFSLatency::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSLatency).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDmesg> ProcFSDmesg::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDmesg).release_nonnull();
@@ -809,10 +1026,22 @@ UNMAP_AFTER_INIT ProcFSOverallProcesses::ProcFSOverallProcesses()
     : ProcFSGlobalInformation("all"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSOverallProcessesBinary::ProcFSOverallProcessesBinary()
+    : ProcFSGlobalInformation("all_binary"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSCPUInformation::ProcFSCPUInformation()
     : ProcFSGlobalInformation("cpuinfo"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSSchedulerStatistics::ProcFSSchedulerStatistics()
+    : ProcFSGlobalInformation("schedstat"sv)
+{
+}
+UNMAP_AFTER_INIT ProcFSLatency::ProcFSLatency()
+    : ProcFSGlobalInformation("latency"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSDmesg::ProcFSDmesg()
     : ProcFSGlobalInformation("dmesg"sv)
 {
@@ -861,6 +1090,7 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSSystemDirectory> ProcFSSystemDirectory::mus
     directory->m_components.append(ProcFSDumpKmallocStacks::must_create(directory));
     directory->m_components.append(ProcFSUBSanDeadly::must_create(directory));
     directory->m_components.append(ProcFSCapsLockRemap::must_create(directory));
+    directory->m_components.append(ProcFSLatencyTracing::must_create(directory));
     return directory;
 }
 
@@ -876,7 +1106,10 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSRootDirectory> ProcFSRootDirectory::must_cr
     directory->m_components.append(ProcFSDiskUsage::must_create());
     directory->m_components.append(ProcFSMemoryStatus::must_create());
     directory->m_components.append(ProcFSOverallProcesses::must_create());
+    directory->m_components.append(ProcFSOverallProcessesBinary::must_create());
     directory->m_components.append(ProcFSCPUInformation::must_create());
+    directory->m_components.append(ProcFSSchedulerStatistics::must_create());
+    directory->m_components.append(ProcFSLatency::must_create());
     directory->m_components.append(ProcFSDmesg::must_create());
     directory->m_components.append(ProcFSInterrupts::must_create());
     directory->m_components.append(ProcFSKeymap::must_create());
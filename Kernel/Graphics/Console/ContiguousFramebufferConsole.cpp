@@ -30,6 +30,8 @@ void ContiguousFramebufferConsole::set_resolution(size_t width, size_t height, s
     dbgln("Framebuffer Console: taking {} bytes", page_round_up(pitch * height));
     m_framebuffer_region = MM.allocate_kernel_region(m_framebuffer_address, page_round_up(pitch * height), "Framebuffer Console", Region::Access::Read | Region::Access::Write, Region::Cacheable::Yes);
     VERIFY(m_framebuffer_region);
+    m_framebuffer_region->set_write_combining(true);
+    m_framebuffer_region->remap();
 
     // Just to start cleanly, we clean the entire framebuffer
     memset(m_framebuffer_region->vaddr().as_ptr(), 0, pitch * height);
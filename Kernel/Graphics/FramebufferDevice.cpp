@@ -53,6 +53,8 @@ KResultOr<Region*> FramebufferDevice::mmap(Process& process, FileDescription&, c
     m_real_framebuffer_region = MM.allocate_kernel_region_with_vmobject(*m_real_framebuffer_vmobject, page_round_up(framebuffer_size_in_bytes()), "Framebuffer", Region::Access::Read | Region::Access::Write);
     if (!m_real_framebuffer_region)
         return ENOMEM;
+    m_real_framebuffer_region->set_write_combining(true);
+    m_real_framebuffer_region->remap();
 
     m_swapped_framebuffer_region = MM.allocate_kernel_region_with_vmobject(*m_swapped_framebuffer_vmobject, page_round_up(framebuffer_size_in_bytes()), "Framebuffer Swap (Blank)", Region::Access::Read | Region::Access::Write);
     if (!m_swapped_framebuffer_region)
@@ -73,6 +75,11 @@ KResultOr<Region*> FramebufferDevice::mmap(Process& process, FileDescription&, c
         shared);
     if (!result.is_error()) {
         m_userspace_framebuffer_region = result.value();
+        // Only the real framebuffer is write-combined, the blank swap buffer is ordinary memory.
+        if (m_graphical_writes_enabled) {
+            result.value()->set_write_combining(true);
+            result.value()->remap();
+        }
     }
     return result;
 }
@@ -85,6 +92,7 @@ void FramebufferDevice::deactivate_writes()
     memcpy(m_swapped_framebuffer_region->vaddr().as_ptr(), m_real_framebuffer_region->vaddr().as_ptr(), page_round_up(framebuffer_size_in_bytes()));
     auto vmobject = m_swapped_framebuffer_vmobject;
     m_userspace_framebuffer_region->set_vmobject(vmobject.release_nonnull());
+    m_userspace_framebuffer_region->set_write_combining(false);
     m_userspace_framebuffer_region->remap();
     m_graphical_writes_enabled = false;
 }
@@ -99,6 +107,7 @@ void FramebufferDevice::activate_writes()
     memcpy(m_real_framebuffer_region->vaddr().as_ptr(), m_swapped_framebuffer_region->vaddr().as_ptr(), page_round_up(framebuffer_size_in_bytes()));
     auto vmobject = m_userspace_real_framebuffer_vmobject;
     m_userspace_framebuffer_region->set_vmobject(vmobject.release_nonnull());
+    m_userspace_framebuffer_region->set_write_combining(true);
     m_userspace_framebuffer_region->remap();
     m_graphical_writes_enabled = true;
 }
@@ -114,6 +123,8 @@ UNMAP_AFTER_INIT void FramebufferDevice::initialize()
     VERIFY(m_real_framebuffer_vmobject);
     m_real_framebuffer_region = MM.allocate_kernel_region_with_vmobject(*m_real_framebuffer_vmobject, page_round_up(framebuffer_size_in_bytes()), "Framebuffer", Region::Access::Read | Region::Access::Write);
     VERIFY(m_real_framebuffer_region);
+    m_real_framebuffer_region->set_write_combining(true);
+    m_real_framebuffer_region->remap();
     m_swapped_framebuffer_vmobject = AnonymousVMObject::try_create_with_size(page_round_up(framebuffer_size_in_bytes()), AllocationStrategy::AllocateNow);
     VERIFY(m_swapped_framebuffer_vmobject);
     m_swapped_framebuffer_region = MM.allocate_kernel_region_with_vmobject(*m_swapped_framebuffer_vmobject, page_round_up(framebuffer_size_in_bytes()), "Framebuffer Swap (Blank)", Region::Access::Read | Region::Access::Write);
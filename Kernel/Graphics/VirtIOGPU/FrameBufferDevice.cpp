@@ -140,6 +140,22 @@ void FrameBufferDevice::set_buffer(int buffer_index)
     buffer.dirty_rect = {};
 }
 
+static Protocol::Rect united_rect(Protocol::Rect const& a, Protocol::Rect const& b)
+{
+    if (a.width == 0 || a.height == 0)
+        return b;
+    if (b.width == 0 || b.height == 0)
+        return a;
+    auto x = min(a.x, b.x);
+    auto y = min(a.y, b.y);
+    return {
+        .x = x,
+        .y = y,
+        .width = max(a.x + a.width, b.x + b.width) - x,
+        .height = max(a.y + a.height, b.y + b.height) - y,
+    };
+}
+
 KResult FrameBufferDevice::ioctl(FileDescription&, unsigned request, Userspace<void*> arg)
 {
     REQUIRE_PROMISE(video);
@@ -193,6 +209,9 @@ KResult FrameBufferDevice::ioctl(FileDescription&, unsigned request, Userspace<v
         if (m_are_writes_active && flush_rects.count > 0) {
             auto& buffer = buffer_from_index(flush_rects.buffer_index);
             MutexLocker locker(m_gpu.operation_lock());
+            // Every rect has to be transferred on its own, but the display only needs one flush covering all of them,
+            // which saves a round trip to the host per rect.
+            Protocol::Rect bounding_rect {};
             for (unsigned i = 0; i < flush_rects.count; i++) {
                 FBRect user_dirty_rect;
                 if (!copy_from_user(&user_dirty_rect, &flush_rects.rects[i]))
@@ -204,22 +223,14 @@ KResult FrameBufferDevice::ioctl(FileDescription&, unsigned request, Userspace<v
                     .height = user_dirty_rect.height
                 };
                 transfer_framebuffer_data_to_host(dirty_rect, buffer);
-                if (&buffer == m_current_buffer) {
-                    // Flushing directly to screen
-                    flush_displayed_image(dirty_rect, buffer);
-                    buffer.dirty_rect = {};
-                } else {
-                    if (buffer.dirty_rect.width == 0 || buffer.dirty_rect.height == 0) {
-                        buffer.dirty_rect = dirty_rect;
-                    } else {
-                        auto current_dirty_right = buffer.dirty_rect.x + buffer.dirty_rect.width;
-                        auto current_dirty_bottom = buffer.dirty_rect.y + buffer.dirty_rect.height;
-                        buffer.dirty_rect.x = min(buffer.dirty_rect.x, dirty_rect.x);
-                        buffer.dirty_rect.y = min(buffer.dirty_rect.y, dirty_rect.y);
-                        buffer.dirty_rect.width = max(current_dirty_right, dirty_rect.x + dirty_rect.width) - buffer.dirty_rect.x;
-                        buffer.dirty_rect.height = max(current_dirty_bottom, dirty_rect.y + dirty_rect.height) - buffer.dirty_rect.y;
-                    }
-                }
+                bounding_rect = united_rect(bounding_rect, dirty_rect);
+            }
+            if (&buffer == m_current_buffer) {
+                // Flushing directly to screen
+                flush_displayed_image(bounding_rect, buffer);
+                buffer.dirty_rect = {};
+            } else {
+                buffer.dirty_rect = united_rect(buffer.dirty_rect, bounding_rect);
             }
         }
         return KSuccess;
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Memory.h>
+#include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Heap/SlabAllocator.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Sections.h>
@@ -15,6 +17,13 @@
 
 namespace Kernel {
 
+// Each processor keeps a small cache of free slabs for every size class, so that
+// the common alloc()/dealloc() pair only touches processor-local data.
+// Slabs move between a processor cache and the shared freelist in batches.
+static constexpr size_t slab_cache_max_processor_count = 8;
+static constexpr size_t slab_cache_capacity = 32;
+static constexpr size_t slab_cache_batch_size = slab_cache_capacity / 2;
+
 template<size_t templated_slab_size>
 class SlabAllocator {
 public:
@@ -39,24 +48,26 @@ public:
 
     void* alloc()
     {
-        FreeSlab* free_slab;
+        FreeSlab* free_slab = nullptr;
         {
-            // We want to avoid being swapped out in the middle of this
-            ScopedCritical critical;
-            FreeSlab* next_free;
-            free_slab = m_freelist.load(AK::memory_order_consume);
-            do {
-                if (!free_slab)
-                    return kmalloc(slab_size());
-                // It's possible another processor is doing the same thing at
-                // the same time, so next_free *can* be a bogus pointer. However,
-                // in that case compare_exchange_strong would fail and we would
-                // try again.
-                next_free = free_slab->next;
-            } while (!m_freelist.compare_exchange_strong(free_slab, next_free, AK::memory_order_acq_rel));
-
-            m_num_allocated++;
+            // The processor cache may also be used from interrupt handlers,
+            // and we must not be moved to another processor while using it.
+            InterruptDisabler disabler;
+            if (auto* cache = current_processor_cache()) {
+                if (cache->count == 0)
+                    refill_cache(*cache);
+                if (cache->count > 0) {
+                    free_slab = cache->slabs[--cache->count];
+                    ++cache->hits;
+                } else {
+                    ++cache->misses;
+                }
+            } else {
+                free_slab = take_from_freelist();
+            }
         }
+        if (!free_slab)
+            return kmalloc(slab_size());
 
 #ifdef SANITIZE_SLABS
         memset(free_slab, SLAB_ALLOC_SCRUB_BYTE, slab_size());
@@ -77,18 +88,43 @@ public:
             memset(free_slab->padding, SLAB_DEALLOC_SCRUB_BYTE, sizeof(FreeSlab::padding));
 #endif
 
-        // We want to avoid being swapped out in the middle of this
-        ScopedCritical critical;
-        FreeSlab* next_free = m_freelist.load(AK::memory_order_consume);
-        do {
-            free_slab->next = next_free;
-        } while (!m_freelist.compare_exchange_strong(next_free, free_slab, AK::memory_order_acq_rel));
+        InterruptDisabler disabler;
+        auto* cache = current_processor_cache();
+        if (!cache) {
+            give_to_freelist(free_slab, free_slab, 1);
+            return;
+        }
+        if (cache->count == slab_cache_capacity)
+            flush_cache(*cache);
+        cache->slabs[cache->count++] = free_slab;
+    }
+
+    size_t num_allocated() const { return m_num_allocated - num_cached(); }
+    size_t num_free() const { return m_slab_count - num_allocated(); }
 
-        m_num_allocated--;
+    size_t num_cached() const
+    {
+        size_t count = 0;
+        for (auto& cache : m_processor_caches)
+            count += cache.count;
+        return count;
     }
 
-    size_t num_allocated() const { return m_num_allocated; }
-    size_t num_free() const { return m_slab_count - m_num_allocated; }
+    size_t cache_hits() const
+    {
+        size_t hits = 0;
+        for (auto& cache : m_processor_caches)
+            hits += cache.hits;
+        return hits;
+    }
+
+    size_t cache_misses() const
+    {
+        size_t misses = 0;
+        for (auto& cache : m_processor_caches)
+            misses += cache.misses;
+        return misses;
+    }
 
 private:
     struct FreeSlab {
@@ -96,11 +132,78 @@ private:
         char padding[templated_slab_size - sizeof(FreeSlab*)];
     };
 
+    struct ProcessorCache {
+        Array<FreeSlab*, slab_cache_capacity> slabs;
+        size_t count { 0 };
+        size_t hits { 0 };
+        size_t misses { 0 };
+    };
+
+    ProcessorCache* current_processor_cache()
+    {
+        VERIFY_INTERRUPTS_DISABLED();
+        auto cpu = Processor::id();
+        if (cpu >= m_processor_caches.size())
+            return nullptr;
+        return &m_processor_caches[cpu];
+    }
+
+    FreeSlab* take_from_freelist()
+    {
+        // It's possible another processor is doing the same thing at
+        // the same time, so next_free *can* be a bogus pointer. However,
+        // in that case compare_exchange_strong would fail and we would
+        // try again.
+        FreeSlab* next_free;
+        FreeSlab* free_slab = m_freelist.load(AK::memory_order_consume);
+        do {
+            if (!free_slab)
+                return nullptr;
+            next_free = free_slab->next;
+        } while (!m_freelist.compare_exchange_strong(free_slab, next_free, AK::memory_order_acq_rel));
+
+        m_num_allocated++;
+        return free_slab;
+    }
+
+    void give_to_freelist(FreeSlab* first, FreeSlab* last, size_t count)
+    {
+        FreeSlab* next_free = m_freelist.load(AK::memory_order_consume);
+        do {
+            last->next = next_free;
+        } while (!m_freelist.compare_exchange_strong(next_free, first, AK::memory_order_acq_rel));
+
+        m_num_allocated -= count;
+    }
+
+    void refill_cache(ProcessorCache& cache)
+    {
+        while (cache.count < slab_cache_batch_size) {
+            auto* free_slab = take_from_freelist();
+            if (!free_slab)
+                break;
+            cache.slabs[cache.count++] = free_slab;
+        }
+    }
+
+    void flush_cache(ProcessorCache& cache)
+    {
+        // Give the oldest half of the cache back to the shared freelist as one chain.
+        VERIFY(cache.count >= slab_cache_batch_size);
+        for (size_t i = 0; i < slab_cache_batch_size - 1; ++i)
+            cache.slabs[i]->next = cache.slabs[i + 1];
+        give_to_freelist(cache.slabs[0], cache.slabs[slab_cache_batch_size - 1], slab_cache_batch_size);
+        for (size_t i = slab_cache_batch_size; i < cache.count; ++i)
+            cache.slabs[i - slab_cache_batch_size] = cache.slabs[i];
+        cache.count -= slab_cache_batch_size;
+    }
+
     Atomic<FreeSlab*> m_freelist { nullptr };
     Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_num_allocated;
     size_t m_slab_count;
     void* m_base { nullptr };
     void* m_end { nullptr };
+    Array<ProcessorCache, slab_cache_max_processor_count> m_processor_caches;
 
     static_assert(sizeof(FreeSlab) == templated_slab_size);
 };
@@ -164,12 +267,17 @@ void slab_dealloc(void* ptr, size_t slab_size)
     VERIFY_NOT_REACHED();
 }
 
-void slab_alloc_stats(Function<void(size_t slab_size, size_t allocated, size_t free)> callback)
+void slab_alloc_stats(Function<void(SlabAllocatorStats const&)> callback)
 {
     for_each_allocator([&](auto& allocator) {
-        auto num_allocated = allocator.num_allocated();
-        auto num_free = allocator.slab_count() - num_allocated;
-        callback(allocator.slab_size(), num_allocated, num_free);
+        SlabAllocatorStats stats;
+        stats.slab_size = allocator.slab_size();
+        stats.num_allocated = allocator.num_allocated();
+        stats.num_free = allocator.slab_count() - stats.num_allocated;
+        stats.num_cached = allocator.num_cached();
+        stats.cache_hits = allocator.cache_hits();
+        stats.cache_misses = allocator.cache_misses();
+        callback(stats);
     });
 }
 
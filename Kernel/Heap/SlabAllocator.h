@@ -14,10 +14,19 @@ namespace Kernel {
 #define SLAB_ALLOC_SCRUB_BYTE 0xab
 #define SLAB_DEALLOC_SCRUB_BYTE 0xbc
 
+struct SlabAllocatorStats {
+    size_t slab_size { 0 };
+    size_t num_allocated { 0 };
+    size_t num_free { 0 };
+    size_t num_cached { 0 };
+    size_t cache_hits { 0 };
+    size_t cache_misses { 0 };
+};
+
 void* slab_alloc(size_t slab_size);
 void slab_dealloc(void*, size_t slab_size);
 void slab_alloc_init();
-void slab_alloc_stats(Function<void(size_t slab_size, size_t allocated, size_t free)>);
+void slab_alloc_stats(Function<void(SlabAllocatorStats const&)>);
 
 #define MAKE_SLAB_ALLOCATED(type)                                            \
 public:                                                                      \
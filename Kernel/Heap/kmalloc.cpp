@@ -9,9 +9,11 @@
  * just to get going. Don't ever let anyone see this shit. :^)
  */
 
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Types.h>
+#include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
@@ -27,6 +29,14 @@
 #define POOL_SIZE (2 * MiB)
 #define ETERNAL_RANGE_SIZE (3 * MiB)
 
+// The heap grows by the size of the backup memory region. Every time the backup
+// memory is used up, the next one is twice as large (up to the maximum), and
+// every time a subheap is given back, it shrinks again. This way bursts of
+// allocations are satisfied by few large subheaps, while an idle heap goes back
+// to keeping just a small backup region around.
+#define MIN_BACKUP_MEMORY_SIZE (1 * MiB)
+#define MAX_BACKUP_MEMORY_SIZE (32 * MiB)
+
 namespace std {
 const nothrow_t nothrow;
 }
@@ -78,6 +88,7 @@ struct KmallocGlobalHeap {
 
             auto& subheap = m_global_heap.m_heap.add_subheap(region->vaddr().as_ptr(), region->size());
             m_global_heap.m_subheap_memory.append(region.release_nonnull());
+            m_global_heap.m_backup_memory_size = min(m_global_heap.m_backup_memory_size * 2, (size_t)MAX_BACKUP_MEMORY_SIZE);
 
             // Since we pulled in our backup heap, make sure we allocate another
             // backup heap before returning. Otherwise we potentially lose
@@ -98,7 +109,7 @@ struct KmallocGlobalHeap {
                 // Add some more to the new heap. We're already using it for other
                 // allocations not including the original allocation_request
                 // that triggered heap expansion. If we don't allocate
-                memory_size += 1 * MiB;
+                memory_size += m_global_heap.m_backup_memory_size;
                 region = MM.allocate_kernel_region(memory_size, "kmalloc subheap", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
                 if (region) {
                     dbgln("kmalloc: Adding even more memory to heap at {}, bytes: {}", region->vaddr(), region->size());
@@ -120,7 +131,9 @@ struct KmallocGlobalHeap {
             for (size_t i = 0; i < m_global_heap.m_subheap_memory.size(); i++) {
                 if (m_global_heap.m_subheap_memory[i].vaddr().as_ptr() == memory) {
                     auto region = m_global_heap.m_subheap_memory.take(i);
-                    if (!m_global_heap.m_backup_memory) {
+                    m_global_heap.m_backup_memory_size = max(m_global_heap.m_backup_memory_size / 2, (size_t)MIN_BACKUP_MEMORY_SIZE);
+                    // Don't keep a huge subheap around as backup memory after a burst of allocations is over.
+                    if (!m_global_heap.m_backup_memory && region->size() <= m_global_heap.m_backup_memory_size) {
                         if constexpr (KMALLOC_DEBUG) {
                             dmesgln("kmalloc: Using removed memory as backup: {}, bytes: {}", region->vaddr(), region->size());
                         }
@@ -137,7 +150,7 @@ struct KmallocGlobalHeap {
                             // memory, in which case we want to use the region as the
                             // new backup.
                             ScopedSpinLock lock(s_lock);
-                            if (!m_global_heap.m_backup_memory) {
+                            if (!m_global_heap.m_backup_memory && region->size() <= m_global_heap.m_backup_memory_size) {
                                 if constexpr (KMALLOC_DEBUG) {
                                     dmesgln("kmalloc: Queued memory region at {}, bytes: {} will be used as new backup", region->vaddr(), region->size());
                                 }
@@ -164,6 +177,7 @@ struct KmallocGlobalHeap {
     HeapType m_heap;
     NonnullOwnPtrVector<Region> m_subheap_memory;
     OwnPtr<Region> m_backup_memory;
+    size_t m_backup_memory_size { MIN_BACKUP_MEMORY_SIZE };
 
     KmallocGlobalHeap(u8* memory, size_t memory_size)
         : m_heap(memory, memory_size, ExpandGlobalHeap(*this))
@@ -173,7 +187,12 @@ struct KmallocGlobalHeap {
     {
         if (m_backup_memory)
             return;
-        m_backup_memory = MM.allocate_kernel_region(1 * MiB, "kmalloc subheap", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+        m_backup_memory = MM.allocate_kernel_region(m_backup_memory_size, "kmalloc subheap", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+        if (!m_backup_memory && m_backup_memory_size > MIN_BACKUP_MEMORY_SIZE) {
+            // We may simply be low on physical memory, fall back to the smallest size.
+            m_backup_memory_size = MIN_BACKUP_MEMORY_SIZE;
+            m_backup_memory = MM.allocate_kernel_region(m_backup_memory_size, "kmalloc subheap", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+        }
     }
 
     size_t backup_memory_bytes() const
@@ -198,6 +217,29 @@ bool g_dump_kmalloc_stacks;
 static u8* s_next_eternal_ptr;
 READONLY_AFTER_INIT static u8* s_end_of_eternal_range;
 
+// Each processor keeps a cache of recently freed small allocations, grouped by
+// their size in chunks. This lets the common kmalloc()/kfree() pair avoid s_lock.
+// Once a size class fills up, half of it is given back to the heap at once.
+static constexpr size_t kmalloc_cache_max_processor_count = 8;
+static constexpr size_t kmalloc_cache_capacity = 32;
+static constexpr size_t kmalloc_cache_batch_size = kmalloc_cache_capacity / 2;
+
+struct KmallocProcessorCache {
+    struct SizeClass {
+        Array<void*, kmalloc_cache_capacity> ptrs;
+        size_t count { 0 };
+        size_t hits { 0 };
+        size_t misses { 0 };
+    };
+
+    Array<SizeClass, KMALLOC_CACHE_SIZE_CLASS_COUNT> size_classes;
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+};
+
+static Array<KmallocProcessorCache, kmalloc_cache_max_processor_count> s_kmalloc_processor_caches;
+
 static void kmalloc_allocate_backup_memory()
 {
     g_kmalloc_global->allocate_backup_memory();
@@ -243,9 +285,89 @@ void* kmalloc_eternal(size_t size)
     return ptr;
 }
 
+static KmallocProcessorCache* kmalloc_current_processor_cache()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto cpu = Processor::id();
+    if (cpu >= s_kmalloc_processor_caches.size())
+        return nullptr;
+    return &s_kmalloc_processor_caches[cpu];
+}
+
+static void* kmalloc_from_processor_cache(KmallocProcessorCache& cache, size_t size)
+{
+    size_t chunks = KmallocGlobalHeap::HeapType::chunks_needed_for_allocation(size);
+    if (chunks > KMALLOC_CACHE_SIZE_CLASS_COUNT)
+        return nullptr;
+    auto& size_class = cache.size_classes[chunks - 1];
+    if (size_class.count == 0) {
+        ++size_class.misses;
+        return nullptr;
+    }
+    ++size_class.hits;
+    ++cache.kmalloc_call_count;
+
+    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        dbgln("kmalloc({})", size);
+        Kernel::dump_backtrace();
+    }
+
+    void* ptr = size_class.ptrs[--size_class.count];
+    memset(ptr, KMALLOC_SCRUB_BYTE, KmallocGlobalHeap::HeapType::usable_size_for_chunks(chunks));
+    return ptr;
+}
+
+static bool kfree_to_processor_cache(KmallocProcessorCache& cache, void* ptr)
+{
+    size_t chunks = KmallocGlobalHeap::HeapType::allocation_size_in_chunks(ptr);
+    if (chunks > KMALLOC_CACHE_SIZE_CLASS_COUNT)
+        return false;
+    auto& size_class = cache.size_classes[chunks - 1];
+    ++cache.kfree_call_count;
+    ++cache.nested_kfree_calls;
+
+    if (cache.nested_kfree_calls == 1) {
+        Thread* current_thread = Thread::current();
+        if (!current_thread)
+            current_thread = Processor::idle_thread();
+        if (current_thread)
+            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+    }
+
+    // Only scrub the data, the allocation header is kept for when the memory is handed out again.
+    memset(ptr, KFREE_SCRUB_BYTE, KmallocGlobalHeap::HeapType::usable_size_for_chunks(chunks));
+
+    if (size_class.count == kmalloc_cache_capacity) {
+        ScopedSpinLock lock(s_lock);
+        for (size_t i = 0; i < kmalloc_cache_batch_size; ++i)
+            g_kmalloc_global->m_heap.deallocate(size_class.ptrs[i]);
+        for (size_t i = kmalloc_cache_batch_size; i < size_class.count; ++i)
+            size_class.ptrs[i - kmalloc_cache_batch_size] = size_class.ptrs[i];
+        size_class.count -= kmalloc_cache_batch_size;
+    }
+    size_class.ptrs[size_class.count++] = ptr;
+
+    --cache.nested_kfree_calls;
+    return true;
+}
+
 void* kmalloc(size_t size)
 {
     kmalloc_verify_nospinlock_held();
+    {
+        InterruptDisabler disabler;
+        if (auto* cache = kmalloc_current_processor_cache()) {
+            if (void* ptr = kmalloc_from_processor_cache(*cache, size)) {
+                Thread* current_thread = Thread::current();
+                if (!current_thread)
+                    current_thread = Processor::idle_thread();
+                if (current_thread)
+                    PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+                return ptr;
+            }
+        }
+    }
+
     ScopedSpinLock lock(s_lock);
     ++g_kmalloc_call_count;
 
@@ -280,6 +402,14 @@ void kfree(void* ptr)
         return;
 
     kmalloc_verify_nospinlock_held();
+    {
+        InterruptDisabler disabler;
+        if (auto* cache = kmalloc_current_processor_cache()) {
+            if (kfree_to_processor_cache(*cache, ptr))
+                return;
+        }
+    }
+
     ScopedSpinLock lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
@@ -377,9 +507,31 @@ void operator delete[](void* ptr, size_t size) noexcept
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
     ScopedSpinLock lock(s_lock);
-    stats.bytes_allocated = g_kmalloc_global->m_heap.allocated_bytes();
-    stats.bytes_free = g_kmalloc_global->m_heap.free_bytes() + g_kmalloc_global->backup_memory_bytes();
-    stats.bytes_eternal = g_kmalloc_bytes_eternal;
+    stats.bytes_cached = 0;
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    for (size_t i = 0; i < KMALLOC_CACHE_SIZE_CLASS_COUNT; ++i) {
+        auto& size_class_stats = stats.size_classes[i];
+        size_class_stats.allocation_size = KmallocGlobalHeap::HeapType::usable_size_for_chunks(i + 1);
+        size_class_stats.num_cached = 0;
+        size_class_stats.cache_hits = 0;
+        size_class_stats.cache_misses = 0;
+    }
+    for (auto& cache : s_kmalloc_processor_caches) {
+        stats.kmalloc_call_count += cache.kmalloc_call_count;
+        stats.kfree_call_count += cache.kfree_call_count;
+        for (size_t i = 0; i < KMALLOC_CACHE_SIZE_CLASS_COUNT; ++i) {
+            auto& size_class = cache.size_classes[i];
+            auto& size_class_stats = stats.size_classes[i];
+            size_class_stats.num_cached += size_class.count;
+            size_class_stats.cache_hits += size_class.hits;
+            size_class_stats.cache_misses += size_class.misses;
+            stats.bytes_cached += size_class.count * (i + 1) * CHUNK_SIZE;
+        }
+    }
+
+    // Memory sitting in the processor caches is still allocated as far as the heap is concerned.
+    stats.bytes_allocated = g_kmalloc_global->m_heap.allocated_bytes() - stats.bytes_cached;
+    stats.bytes_free = g_kmalloc_global->m_heap.free_bytes() + g_kmalloc_global->backup_memory_bytes() + stats.bytes_cached;
+    stats.bytes_eternal = g_kmalloc_bytes_eternal;
 }
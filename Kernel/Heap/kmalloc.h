@@ -45,12 +45,23 @@ void kmalloc_init();
 void kfree(void*);
 void kfree_sized(void*, size_t);
 
+#define KMALLOC_CACHE_SIZE_CLASS_COUNT 4
+
+struct kmalloc_size_class_stats {
+    size_t allocation_size;
+    size_t num_cached;
+    size_t cache_hits;
+    size_t cache_misses;
+};
+
 struct kmalloc_stats {
     size_t bytes_allocated;
     size_t bytes_free;
     size_t bytes_eternal;
+    size_t bytes_cached;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    kmalloc_size_class_stats size_classes[KMALLOC_CACHE_SIZE_CLASS_COUNT];
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
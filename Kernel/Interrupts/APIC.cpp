@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <Kernel/ACPI/Parser.h>
 #include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/Debug.h>
 #include <Kernel/IO.h>
@@ -23,6 +24,7 @@
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/TypedMapping.h>
 
+#define IRQ_APIC_PERFORMANCE_COUNTER (0xfb - IRQ_VECTOR_BASE)
 #define IRQ_APIC_TIMER (0xfc - IRQ_VECTOR_BASE)
 #define IRQ_APIC_IPI (0xfd - IRQ_VECTOR_BASE)
 #define IRQ_APIC_ERR (0xfe - IRQ_VECTOR_BASE)
@@ -117,6 +119,37 @@ public:
 private:
 };
 
+class APICPerformanceCounterInterruptHandler final : public GenericInterruptHandler {
+public:
+    explicit APICPerformanceCounterInterruptHandler(u8 interrupt_vector)
+        : GenericInterruptHandler(interrupt_vector, true)
+    {
+    }
+    virtual ~APICPerformanceCounterInterruptHandler()
+    {
+    }
+
+    static void initialize(u8 interrupt_number)
+    {
+        auto* handler = new APICPerformanceCounterInterruptHandler(interrupt_number);
+        handler->register_interrupt_handler();
+    }
+
+    virtual bool handle_interrupt(const RegisterState&) override;
+
+    virtual bool eoi() override;
+
+    virtual HandlerType type() const override { return HandlerType::IRQHandler; }
+    virtual StringView purpose() const override { return "Performance Counter Handler"; }
+    virtual StringView controller() const override { return nullptr; }
+
+    virtual size_t sharing_devices_count() const override { return 0; }
+    virtual bool is_shared_handler() const override { return false; }
+    virtual bool is_sharing_with_others() const override { return false; }
+
+private:
+};
+
 bool APIC::initialized()
 {
     return s_apic.is_initialized();
@@ -409,6 +442,9 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
         // register IPI interrupt vector
         APICIPIInterruptHandler::initialize(IRQ_APIC_IPI);
+
+        // register performance counter overflow interrupt vector, the LVT entry stays masked until it's used
+        APICPerformanceCounterInterruptHandler::initialize(IRQ_APIC_PERFORMANCE_COUNTER);
     }
 
     // set spurious interrupt vector
@@ -539,7 +575,7 @@ void APIC::setup_local_timer(u32 ticks, TimerMode timer_mode, bool enable)
     }
     write_register(APIC_REG_TIMER_CONFIGURATION, config);
 
-    if (timer_mode == TimerMode::Periodic)
+    if (timer_mode == TimerMode::Periodic || (timer_mode == TimerMode::OneShot && enable))
         write_register(APIC_REG_TIMER_INITIAL_COUNT, ticks / get_timer_divisor());
 }
 
@@ -553,6 +589,16 @@ u32 APIC::get_timer_divisor()
     return 16;
 }
 
+void APIC::enable_performance_counter_interrupt()
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(IRQ_APIC_PERFORMANCE_COUNTER + IRQ_VECTOR_BASE, 0));
+}
+
+void APIC::disable_performance_counter_interrupt()
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(0, 0) | APIC_LVT_MASKED);
+}
+
 bool APICIPIInterruptHandler::handle_interrupt(const RegisterState&)
 {
     dbgln_if(APIC_SMP_DEBUG, "APIC IPI on CPU #{}", Processor::id());
@@ -566,6 +612,20 @@ bool APICIPIInterruptHandler::eoi()
     return true;
 }
 
+bool APICPerformanceCounterInterruptHandler::handle_interrupt(const RegisterState& regs)
+{
+    PerformanceCounters::handle_overflow(regs);
+    // The local APIC masks the LVT entry whenever it delivers this interrupt.
+    APIC::the().enable_performance_counter_interrupt();
+    return true;
+}
+
+bool APICPerformanceCounterInterruptHandler::eoi()
+{
+    APIC::the().eoi();
+    return true;
+}
+
 bool APICErrInterruptHandler::handle_interrupt(const RegisterState&)
 {
     dbgln("APIC: SMP error on CPU #{}", Processor::id());
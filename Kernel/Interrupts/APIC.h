@@ -46,6 +46,9 @@ public:
     u32 get_timer_current_count();
     u32 get_timer_divisor();
 
+    void enable_performance_counter_interrupt();
+    void disable_performance_counter_interrupt();
+
 private:
     class ICRReg {
         u32 m_low { 0 };
@@ -143,6 +143,45 @@ void Mutex::lock(Mode mode)
     }
 }
 
+#if LOCK_DEBUG
+bool Mutex::try_lock(const SourceLocation& location)
+#else
+bool Mutex::try_lock()
+#endif
+{
+    VERIFY(!Processor::current().in_irq());
+    auto current_thread = Thread::current();
+
+    ScopedSpinLock lock(m_lock);
+    switch (m_mode) {
+    case Mode::Unlocked:
+        VERIFY(!m_holder);
+        VERIFY(m_shared_holders.is_empty());
+        VERIFY(m_times_locked == 0);
+        m_mode = Mode::Exclusive;
+        m_holder = current_thread;
+        break;
+    case Mode::Exclusive:
+        VERIFY(m_holder);
+        if (m_holder != current_thread)
+            return false;
+        break;
+    case Mode::Shared:
+        // NOTE: Even if we are the only shared holder, converting to an exclusive lock is left to lock().
+        return false;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    m_times_locked++;
+    dbgln_if(LOCK_TRACE_DEBUG, "Mutex::try_lock @ {} ({}): acquired exclusive, locks held {}", this, m_name, m_times_locked);
+
+#if LOCK_DEBUG
+    if (current_thread)
+        current_thread->holding_lock(*this, 1, location);
+#endif
+    return true;
+}
+
 void Mutex::unlock()
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -33,9 +33,12 @@ public:
 
 #if LOCK_DEBUG
     void lock(Mode mode = Mode::Exclusive, const SourceLocation& location = SourceLocation::current());
+    [[nodiscard]] bool try_lock(const SourceLocation& location = SourceLocation::current());
     void restore_lock(Mode, u32, const SourceLocation& location = SourceLocation::current());
 #else
     void lock(Mode = Mode::Exclusive);
+    // Takes the lock exclusively if that is possible without blocking.
+    [[nodiscard]] bool try_lock();
     void restore_lock(Mode, u32);
 #endif
 
@@ -37,6 +37,7 @@ namespace Kernel {
 #define REG_RADV 0x282C             // RX Int. Absolute Delay Timer
 #define REG_RSRPD 0x2C00            // RX Small Packet Detect Interrupt
 #define REG_TIPG 0x0410             // Transmit Inter Packet Gap
+#define REG_RXCSUM 0x5000           // RX Checksum Control
 #define ECTRL_SLU 0x40              //set link up
 #define RCTL_EN (1 << 1)            // Receiver Enable
 #define RCTL_SBP (1 << 2)           // Store Bad Packets
@@ -60,6 +61,9 @@ namespace Kernel {
 #define RCTL_PMCF (1 << 23)         // Pass MAC Control Frames
 #define RCTL_SECRC (1 << 26)        // Strip Ethernet CRC
 
+#define RXCSUM_IPOFL (1 << 8) // IP Checksum Off-load Enable
+#define RXCSUM_TUOFL (1 << 9) // TCP/UDP Checksum Off-load Enable
+
 // Buffer Sizes
 #define RCTL_BSIZE_256 (3 << 16)
 #define RCTL_BSIZE_512 (2 << 16)
@@ -93,6 +97,15 @@ namespace Kernel {
 #define TSTA_LC (1 << 2) // Late Collision
 #define LSTA_TU (1 << 3) // Transmit Underrun
 
+// Receive Descriptor Status and Errors
+
+#define RSTA_DD (1 << 0)    // Descriptor Done
+#define RSTA_IXSM (1 << 2)  // Ignore Checksum Indication
+#define RSTA_TCPCS (1 << 5) // TCP/UDP Checksum Calculated
+#define RSTA_IPCS (1 << 6)  // IP Checksum Calculated
+#define RERR_TCPE (1 << 5)  // TCP/UDP Checksum Error
+#define RERR_IPE (1 << 6)   // IP Checksum Error
+
 // STATUS Register
 
 #define STATUS_FD 0x01
@@ -213,6 +226,7 @@ UNMAP_AFTER_INIT bool E1000NetworkAdapter::initialize()
 
     initialize_rx_descriptors();
     initialize_tx_descriptors();
+    setup_offloads();
 
     setup_link();
     setup_interrupts();
@@ -362,6 +376,13 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
     out32(REG_TIPG, 0x0060200A);
 }
 
+UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_offloads()
+{
+    // Outgoing checksums are inserted through the legacy transmit descriptors, which every model supports.
+    out32(REG_RXCSUM, in32(REG_RXCSUM) | RXCSUM_IPOFL | RXCSUM_TUOFL);
+    set_offloads(Offloads::TransmitChecksum | Offloads::ReceiveChecksum);
+}
+
 void E1000NetworkAdapter::out8(u16 address, u8 data)
 {
     dbgln_if(E1000_DEBUG, "E1000: OUT8 {:#02x} @ {:#04x}", data, address);
@@ -420,6 +441,19 @@ u32 E1000NetworkAdapter::in32(u16 address)
 }
 
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    transmit(payload, 0, 0, 0);
+}
+
+void E1000NetworkAdapter::send_raw_with_checksum_offload(ReadonlyBytes payload, ChecksumOffload checksum_offload)
+{
+    // The descriptor only has room for 8-bit offsets, which is plenty for the headers in front of the checksum.
+    VERIFY(checksum_offload.start <= NumericLimits<u8>::max());
+    VERIFY(checksum_offload.offset <= NumericLimits<u8>::max());
+    transmit(payload, CMD_IC, checksum_offload.offset, checksum_offload.start);
+}
+
+void E1000NetworkAdapter::transmit(ReadonlyBytes payload, u8 cmd, u8 cso, u8 css)
 {
     disable_irq();
     size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
@@ -431,7 +465,9 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     memcpy(vptr, payload.data(), payload.size());
     descriptor.length = payload.size();
     descriptor.status = 0;
-    descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+    descriptor.cso = cso;
+    descriptor.css = css;
+    descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS | cmd;
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
     tx_current = (tx_current + 1) % number_of_tx_descriptors;
     cli();
@@ -449,18 +485,24 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 
 void E1000NetworkAdapter::receive()
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     u32 rx_current;
     for (;;) {
         rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
         rx_current = (rx_current + 1) % number_of_rx_descriptors;
-        if (!(rx_descriptors[rx_current].status & 1))
+        u8 status = rx_descriptors[rx_current].status;
+        if (!(status & RSTA_DD))
             break;
         auto* buffer = m_rx_buffers[rx_current];
         u16 length = rx_descriptors[rx_current].length;
         VERIFY(length <= 8192);
-        dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
-        did_receive({ buffer, length });
+        u8 errors = rx_descriptors[rx_current].errors;
+        if (!(status & RSTA_IXSM) && (errors & (RERR_IPE | RERR_TCPE))) {
+            dbgln_if(E1000_DEBUG, "E1000: Dropping packet @ {:p} ({} bytes) with bad checksum, errors {:#02x}", buffer, length, errors);
+        } else {
+            dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
+            did_receive({ buffer, length });
+        }
         rx_descriptors[rx_current].status = 0;
         out32(REG_RXDESCTAIL, rx_current);
     }
@@ -26,6 +26,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_checksum_offload(ReadonlyBytes, ChecksumOffload) override;
     virtual bool link_up() override;
 
     virtual StringView purpose() const override { return class_name(); }
@@ -33,6 +34,7 @@ public:
 protected:
     void setup_interrupts();
     void setup_link();
+    void setup_offloads();
 
     E1000NetworkAdapter(PCI::Address, u8 irq);
     virtual bool handle_irq(const RegisterState&) override;
@@ -75,6 +77,7 @@ protected:
     u32 in32(u16 address);
 
     void receive();
+    void transmit(ReadonlyBytes, u8 cmd, u8 cso, u8 css);
 
     static constexpr size_t number_of_rx_descriptors = 32;
     static constexpr size_t number_of_tx_descriptors = 8;
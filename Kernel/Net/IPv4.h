@@ -114,6 +114,9 @@ inline NetworkOrdered<u16> internet_checksum(const void* ptr, size_t count)
             checksum = (checksum & 0xffff) | (checksum >> 16);
         count -= 2;
     }
+    // An odd trailing byte is summed up as if it was padded with a zero byte.
+    if (count)
+        checksum += (u16)(*(const u8*)w) << 8;
     while (checksum >> 16)
         checksum = (checksum & 0xffff) + (checksum >> 16);
     return ~checksum & 0xffff;
@@ -186,7 +186,7 @@ PortAllocationResult IPv4Socket::allocate_local_port_if_needed()
     return { m_local_port, true };
 }
 
-KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer& data, size_t data_length, [[maybe_unused]] int flags, Userspace<const sockaddr*> addr, socklen_t addr_length)
+KResultOr<size_t> IPv4Socket::sendto(FileDescription& description, const UserOrKernelBuffer& data, size_t data_length, [[maybe_unused]] int flags, Userspace<const sockaddr*> addr, socklen_t addr_length)
 {
     MutexLocker locker(lock());
 
@@ -240,6 +240,16 @@ KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer&
     }
 
     auto nsent_or_error = protocol_send(data, data_length);
+    while (nsent_or_error.is_error() && nsent_or_error.error() == EAGAIN && description.is_blocking()) {
+        // The protocol can't send anything right now, so wait until it can.
+        locker.unlock();
+        auto unblocked_flags = BlockFlags::None;
+        auto res = Thread::current()->block<Thread::WriteBlocker>({}, description, unblocked_flags);
+        locker.lock();
+        if (res.was_interrupted())
+            return EINTR;
+        nsent_or_error = protocol_send(data, data_length);
+    }
     if (!nsent_or_error.is_error())
         Thread::current()->did_ipv4_socket_write(nsent_or_error.value());
     return nsent_or_error;
@@ -399,6 +409,21 @@ KResultOr<size_t> IPv4Socket::recvfrom(FileDescription& description, UserOrKerne
 bool IPv4Socket::did_receive(const IPv4Address& source_address, u16 source_port, ReadonlyBytes packet, const Time& packet_timestamp)
 {
     MutexLocker locker(lock());
+    return did_receive_locked(source_address, source_port, packet, packet_timestamp);
+}
+
+Optional<bool> IPv4Socket::try_did_receive(const IPv4Address& source_address, u16 source_port, ReadonlyBytes packet, const Time& packet_timestamp)
+{
+    if (!lock().try_lock())
+        return {};
+    auto result = did_receive_locked(source_address, source_port, packet, packet_timestamp);
+    lock().unlock();
+    return result;
+}
+
+bool IPv4Socket::did_receive_locked(const IPv4Address& source_address, u16 source_port, ReadonlyBytes packet, const Time& packet_timestamp)
+{
+    VERIFY(lock().own_lock());
 
     if (is_shut_down_for_reading())
         return false;
@@ -13,7 +13,9 @@
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
 #include <Kernel/UnixTypes.h>
+#include <Kernel/VM/MemoryManager.h>
 #include <LibC/errno_numbers.h>
+#include <LibC/sys/ioctl_numbers.h>
 
 namespace Kernel {
 
@@ -259,13 +261,20 @@ bool LocalSocket::can_read(const FileDescription& description, size_t) const
     auto role = this->role(description);
     if (role == Role::Listener)
         return can_accept();
-    if (role == Role::Accepted)
-        return !has_attached_peer(description) || !m_for_server.is_empty();
-    if (role == Role::Connected)
-        return !has_attached_peer(description) || !m_for_client.is_empty();
+    if (role == Role::Accepted || role == Role::Connected)
+        return !has_attached_peer(description) || has_data_for_reading(description);
     return false;
 }
 
+bool LocalSocket::has_data_for_reading(const FileDescription& description) const
+{
+    auto& socket_buffer = role(description) == Role::Accepted ? m_for_server : m_for_client;
+    if (!socket_buffer.is_empty())
+        return true;
+    auto* ring = receive_ring_for(description);
+    return ring && !ring->is_empty();
+}
+
 bool LocalSocket::has_attached_peer(const FileDescription& description) const
 {
     auto role = this->role(description);
@@ -278,6 +287,8 @@ bool LocalSocket::has_attached_peer(const FileDescription& description) const
 
 bool LocalSocket::can_write(const FileDescription& description, size_t) const
 {
+    if (auto* ring = send_ring_for(description))
+        return !has_attached_peer(description) || ring->space_for_writing();
     auto role = this->role(description);
     if (role == Role::Accepted)
         return !has_attached_peer(description) || m_for_client.space_for_writing();
@@ -293,7 +304,11 @@ KResultOr<size_t> LocalSocket::sendto(FileDescription& description, const UserOr
     auto* socket_buffer = send_buffer_for(description);
     if (!socket_buffer)
         return EINVAL;
-    auto nwritten_or_error = socket_buffer->write(data, data_size);
+    KResultOr<size_t> nwritten_or_error = 0;
+    if (auto* ring = send_ring_for(description))
+        nwritten_or_error = ring->write(data, data_size);
+    else
+        nwritten_or_error = socket_buffer->write(data, data_size);
     if (!nwritten_or_error.is_error() && nwritten_or_error.value() > 0)
         Thread::current()->did_unix_socket_write(nwritten_or_error.value());
     return nwritten_or_error;
@@ -325,7 +340,7 @@ KResultOr<size_t> LocalSocket::recvfrom(FileDescription& description, UserOrKern
     if (!socket_buffer)
         return EINVAL;
     if (!description.is_blocking()) {
-        if (socket_buffer->is_empty()) {
+        if (!has_data_for_reading(description)) {
             if (!has_attached_peer(description))
                 return 0;
             return EAGAIN;
@@ -335,10 +350,19 @@ KResultOr<size_t> LocalSocket::recvfrom(FileDescription& description, UserOrKern
         if (Thread::current()->block<Thread::ReadBlocker>({}, description, unblock_flags).was_interrupted())
             return EINTR;
     }
-    if (!has_attached_peer(description) && socket_buffer->is_empty())
+    if (!has_attached_peer(description) && !has_data_for_reading(description))
         return 0;
-    VERIFY(!socket_buffer->is_empty());
-    auto nread_or_error = socket_buffer->read(buffer, buffer_size);
+    // Whatever was sent before the rings were set up has to be received first.
+    KResultOr<size_t> nread_or_error = 0;
+    if (!socket_buffer->is_empty()) {
+        nread_or_error = socket_buffer->read(buffer, buffer_size);
+    } else {
+        // NOTE: The receiving end may have drained the ring by hand in the meantime.
+        auto* ring = receive_ring_for(description);
+        if (!ring || ring->is_empty())
+            return EAGAIN;
+        nread_or_error = ring->read(buffer, buffer_size);
+    }
     if (!nread_or_error.is_error() && nread_or_error.value() > 0)
         Thread::current()->did_unix_socket_read(nread_or_error.value());
     return nread_or_error;
@@ -453,6 +477,84 @@ NonnullRefPtrVector<FileDescription>& LocalSocket::recvfd_queue_for(const FileDe
     VERIFY_NOT_REACHED();
 }
 
+LocalSocketRing* LocalSocket::receive_ring_for(const FileDescription& description) const
+{
+    if (!m_has_rings.load(AK::memory_order_acquire))
+        return nullptr;
+    auto role = this->role(description);
+    if (role == Role::Accepted)
+        return const_cast<LocalSocketRing*>(m_ring_for_server.ptr());
+    if (role == Role::Connected)
+        return const_cast<LocalSocketRing*>(m_ring_for_client.ptr());
+    return nullptr;
+}
+
+LocalSocketRing* LocalSocket::send_ring_for(const FileDescription& description) const
+{
+    if (!m_has_rings.load(AK::memory_order_acquire))
+        return nullptr;
+    auto role = this->role(description);
+    if (role == Role::Connected)
+        return const_cast<LocalSocketRing*>(m_ring_for_server.ptr());
+    if (role == Role::Accepted)
+        return const_cast<LocalSocketRing*>(m_ring_for_client.ptr());
+    return nullptr;
+}
+
+KResult LocalSocket::set_up_rings()
+{
+    MutexLocker locker(lock());
+    if (m_has_rings.load(AK::memory_order_relaxed))
+        return KSuccess;
+    auto ring_for_client = LocalSocketRing::try_create();
+    auto ring_for_server = LocalSocketRing::try_create();
+    if (!ring_for_client || !ring_for_server)
+        return ENOMEM;
+    ring_for_client->set_unblock_callback([this]() {
+        evaluate_block_conditions();
+    });
+    ring_for_server->set_unblock_callback([this]() {
+        evaluate_block_conditions();
+    });
+    m_ring_for_client = move(ring_for_client);
+    m_ring_for_server = move(ring_for_server);
+    m_has_rings.store(true, AK::memory_order_release);
+    return KSuccess;
+}
+
+KResultOr<Region*> LocalSocket::mmap(Process& process, FileDescription& description, const Range& range, u64 offset, int prot, bool shared)
+{
+    if (type() != SOCK_STREAM)
+        return ENODEV;
+    auto role = this->role(description);
+    if (role != Role::Accepted && role != Role::Connected)
+        return ENOTCONN;
+    // The other end would never see anything written into a private mapping.
+    if (!shared || range.size() != LOCAL_SOCKET_RING_MAPPING_SIZE)
+        return EINVAL;
+    if (offset != 0 && offset != LOCAL_SOCKET_RING_MAPPING_SIZE)
+        return EINVAL;
+
+    if (auto result = set_up_rings(); result.is_error())
+        return result;
+    auto* ring = offset == 0 ? send_ring_for(description) : receive_ring_for(description);
+    VERIFY(ring);
+    return process.space().allocate_region_with_vmobject(range, ring->vmobject(), 0, "LocalSocket ring", prot, shared);
+}
+
+KResult LocalSocket::ioctl(FileDescription& description, unsigned request, Userspace<void*>)
+{
+    switch (request) {
+    case LOCAL_SOCKET_RING_NOTIFY:
+        if (!send_ring_for(description))
+            return EINVAL;
+        // One end produced or consumed data through its mapping, so whoever waits for the other end may be able to continue.
+        evaluate_block_conditions();
+        return KSuccess;
+    }
+    return EINVAL;
+}
+
 NonnullRefPtrVector<FileDescription>& LocalSocket::sendfd_queue_for(const FileDescription& description)
 {
     auto role = this->role(description);
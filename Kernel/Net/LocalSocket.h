@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/IntrusiveList.h>
 #include <Kernel/DoubleBuffer.h>
+#include <Kernel/Net/LocalSocketRing.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -49,6 +51,8 @@ public:
     virtual KResult getsockopt(FileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
     virtual KResult chown(FileDescription&, uid_t, gid_t) override;
     virtual KResult chmod(FileDescription&, mode_t) override;
+    virtual KResult ioctl(FileDescription&, unsigned request, Userspace<void*> arg) override;
+    virtual KResultOr<Region*> mmap(Process&, FileDescription&, const Range&, u64 offset, int prot, bool shared) override;
 
 private:
     explicit LocalSocket(int type);
@@ -57,6 +61,10 @@ private:
     bool has_attached_peer(const FileDescription&) const;
     DoubleBuffer* receive_buffer_for(FileDescription&);
     DoubleBuffer* send_buffer_for(FileDescription&);
+    LocalSocketRing* receive_ring_for(const FileDescription&) const;
+    LocalSocketRing* send_ring_for(const FileDescription&) const;
+    bool has_data_for_reading(const FileDescription&) const;
+    KResult set_up_rings();
     NonnullRefPtrVector<FileDescription>& sendfd_queue_for(const FileDescription&);
     NonnullRefPtrVector<FileDescription>& recvfd_queue_for(const FileDescription&);
 
@@ -96,6 +104,11 @@ private:
     DoubleBuffer m_for_client;
     DoubleBuffer m_for_server;
 
+    // Set up by the first mmap() of either end; once they exist, everything that is sent goes through them.
+    OwnPtr<LocalSocketRing> m_ring_for_client;
+    OwnPtr<LocalSocketRing> m_ring_for_server;
+    Atomic<bool> m_has_rings { false };
+
     NonnullRefPtrVector<FileDescription> m_fds_for_client;
     NonnullRefPtrVector<FileDescription> m_fds_for_server;
 
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Net/LocalSocketRing.h>
+#include <Kernel/VM/MemoryManager.h>
+
+namespace Kernel {
+
+OwnPtr<LocalSocketRing> LocalSocketRing::try_create()
+{
+    auto vmobject = AnonymousVMObject::try_create_with_size(LOCAL_SOCKET_RING_MAPPING_SIZE, AllocationStrategy::AllocateNow);
+    if (!vmobject)
+        return {};
+    auto kernel_region = MM.allocate_kernel_region_with_vmobject(*vmobject, LOCAL_SOCKET_RING_MAPPING_SIZE, "LocalSocketRing", Region::Access::Read | Region::Access::Write);
+    if (!kernel_region)
+        return {};
+    return adopt_own_if_nonnull(new (nothrow) LocalSocketRing(vmobject.release_nonnull(), kernel_region.release_nonnull()));
+}
+
+LocalSocketRing::LocalSocketRing(NonnullRefPtr<AnonymousVMObject> vmobject, NonnullOwnPtr<Region> kernel_region)
+    : m_vmobject(move(vmobject))
+    , m_kernel_region(move(kernel_region))
+{
+    auto& header = this->header();
+    memset(&header, 0, sizeof(header));
+    header.capacity = LOCAL_SOCKET_RING_CAPACITY;
+    header.data_offset = LOCAL_SOCKET_RING_DATA_OFFSET;
+}
+
+u32 LocalSocketRing::head() const
+{
+    return AK::atomic_load(const_cast<u32 volatile*>(&header().head), AK::memory_order_acquire);
+}
+
+u32 LocalSocketRing::tail() const
+{
+    return AK::atomic_load(const_cast<u32 volatile*>(&header().tail), AK::memory_order_acquire);
+}
+
+size_t LocalSocketRing::used_space() const
+{
+    // NOTE: Both ends can scribble over the indices, so treat any nonsense in them as a full ring.
+    return min(tail() - head(), LOCAL_SOCKET_RING_CAPACITY);
+}
+
+KResultOr<size_t> LocalSocketRing::write(const UserOrKernelBuffer& buffer, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_lock);
+    auto tail = this->tail();
+    size_t bytes_to_write = min(size, space_for_writing());
+    size_t nwritten = 0;
+    while (nwritten < bytes_to_write) {
+        auto index = (tail + nwritten) & (LOCAL_SOCKET_RING_CAPACITY - 1);
+        auto chunk_size = min(bytes_to_write - nwritten, LOCAL_SOCKET_RING_CAPACITY - index);
+        if (!buffer.read(data() + index, nwritten, chunk_size))
+            return EFAULT;
+        nwritten += chunk_size;
+    }
+    AK::atomic_store(&header().tail, tail + static_cast<u32>(nwritten), AK::memory_order_release);
+    if (m_unblock_callback && nwritten)
+        m_unblock_callback();
+    return nwritten;
+}
+
+KResultOr<size_t> LocalSocketRing::read(UserOrKernelBuffer& buffer, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_lock);
+    auto head = this->head();
+    size_t bytes_to_read = min(size, used_space());
+    size_t nread = 0;
+    while (nread < bytes_to_read) {
+        auto index = (head + nread) & (LOCAL_SOCKET_RING_CAPACITY - 1);
+        auto chunk_size = min(bytes_to_read - nread, LOCAL_SOCKET_RING_CAPACITY - index);
+        if (!buffer.write(data() + index, nread, chunk_size))
+            return EFAULT;
+        nread += chunk_size;
+    }
+    AK::atomic_store(&header().head, head + static_cast<u32>(nread), AK::memory_order_release);
+    if (m_unblock_callback && nread)
+        m_unblock_callback();
+    return nread;
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/LocalSocketRing.h>
+#include <Kernel/KResult.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/UserOrKernelBuffer.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+
+namespace Kernel {
+
+// One direction of a LocalSocket whose ends share their buffers with the kernel, see Kernel/API/LocalSocketRing.h.
+class LocalSocketRing {
+public:
+    static OwnPtr<LocalSocketRing> try_create();
+
+    KResultOr<size_t> write(const UserOrKernelBuffer&, size_t);
+    KResultOr<size_t> read(UserOrKernelBuffer&, size_t);
+
+    bool is_empty() const { return used_space() == 0; }
+    size_t space_for_writing() const { return LOCAL_SOCKET_RING_CAPACITY - used_space(); }
+
+    AnonymousVMObject& vmobject() { return m_vmobject; }
+
+    void set_unblock_callback(Function<void()> callback) { m_unblock_callback = move(callback); }
+
+private:
+    LocalSocketRing(NonnullRefPtr<AnonymousVMObject>, NonnullOwnPtr<Region>);
+
+    LocalSocketRingHeader& header() { return *reinterpret_cast<LocalSocketRingHeader*>(m_kernel_region->vaddr().as_ptr()); }
+    LocalSocketRingHeader const& header() const { return *reinterpret_cast<LocalSocketRingHeader const*>(m_kernel_region->vaddr().as_ptr()); }
+    u8* data() { return m_kernel_region->vaddr().offset(LOCAL_SOCKET_RING_DATA_OFFSET).as_ptr(); }
+
+    u32 head() const;
+    u32 tail() const;
+    size_t used_space() const;
+
+    NonnullRefPtr<AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Region> m_kernel_region;
+    Function<void()> m_unblock_callback;
+    Mutex m_lock { "LocalSocketRing" };
+};
+
+}
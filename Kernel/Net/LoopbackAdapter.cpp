@@ -5,7 +5,13 @@
  */
 
 #include <AK/Singleton.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
+#include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Net/UDP.h>
+#include <Kernel/Net/UDPSocket.h>
+#include <Kernel/Process.h>
 
 namespace Kernel {
 
@@ -23,6 +29,8 @@ LoopbackAdapter::LoopbackAdapter()
     set_loopback_name();
     set_mtu(65536);
     set_mac_address({ 19, 85, 2, 9, 0x55, 0xaa });
+    // Nothing can corrupt the packets on their way, so there is no point in computing checksums.
+    set_offloads(Offloads::TransmitChecksum | Offloads::ReceiveChecksum);
 }
 
 LoopbackAdapter::~LoopbackAdapter()
@@ -31,8 +39,52 @@ LoopbackAdapter::~LoopbackAdapter()
 
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
-    dbgln("LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+    dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+    if (try_deliver_directly(payload))
+        return;
     did_receive(payload);
 }
 
+void LoopbackAdapter::send_raw_with_checksum_offload(ReadonlyBytes payload, ChecksumOffload)
+{
+    send_raw(payload);
+}
+
+bool LoopbackAdapter::try_deliver_directly(ReadonlyBytes frame)
+{
+    // UDP datagrams are handed straight to the receiving socket, which saves waking up a receive worker.
+    // TCP segments always take the regular path, as their sender only finishes updating its state after
+    // sending them, so they can't be processed before that.
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(UDPPacket))
+        return false;
+    auto& eth = *(const EthernetFrameHeader*)frame.data();
+    if (eth.ether_type() != EtherType::IPv4)
+        return false;
+    auto& ipv4_packet = *(const IPv4Packet*)eth.payload();
+    if (ipv4_packet.protocol() != (u8)IPv4Protocol::UDP || ipv4_packet.internet_header_length() != 5 || ipv4_packet.is_a_fragment())
+        return false;
+    if (ipv4_packet.length() > frame.size() - sizeof(EthernetFrameHeader) || ipv4_packet.payload_size() < sizeof(UDPPacket))
+        return false;
+    // Broadcast and multicast datagrams are left to handle_udp().
+    if (ipv4_packet.destination() != ipv4_address())
+        return false;
+
+    auto& udp_packet = *static_cast<const UDPPacket*>(ipv4_packet.payload());
+    if (udp_packet.length() < sizeof(UDPPacket) || udp_packet.length() > ipv4_packet.payload_size())
+        return false;
+    auto socket = UDPSocket::find_by_port(udp_packet.destination_port());
+    if (!socket)
+        return false;
+
+    // If the receiver is busy, the datagram takes the regular path instead of waiting here. Datagrams may
+    // thus overtake each other, which is fine for UDP. This also keeps two sockets that are sending to each
+    // other from deadlocking on each other's locks.
+    auto result = socket->try_did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, ipv4_packet.length() }, kgettimeofday());
+    if (!result.has_value())
+        return false;
+    dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Delivered {} byte(s) straight to UDP port {}", frame.size(), udp_packet.destination_port());
+    did_receive_directly(frame.size());
+    return true;
+}
+
 }
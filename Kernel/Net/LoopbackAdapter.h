@@ -21,8 +21,12 @@ public:
     virtual ~LoopbackAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_checksum_offload(ReadonlyBytes, ChecksumOffload) override;
     virtual StringView class_name() const override { return "LoopbackAdapter"; }
     virtual bool link_up() override { return true; }
+
+private:
+    bool try_deliver_directly(ReadonlyBytes);
 };
 
 }
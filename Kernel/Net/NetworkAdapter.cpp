@@ -12,6 +12,7 @@
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
@@ -23,13 +24,49 @@ NetworkAdapter::~NetworkAdapter()
 {
 }
 
+bool NetworkAdapter::has_offload(Offloads offload) const
+{
+    return has_flag(m_offloads, offload);
+}
+
 void NetworkAdapter::send_packet(ReadonlyBytes packet)
 {
     m_packets_out++;
     m_bytes_out += packet.size();
+    ScopedTracepoint tracepoint(Tracepoint::NetworkTransmit);
     send_raw(packet);
 }
 
+void NetworkAdapter::send_packet(PacketWithTimestamp& packet)
+{
+    Bytes bytes { packet.buffer.data(), packet.buffer.size() };
+    if (!packet.checksum_offload.has_value())
+        return send_packet(bytes);
+
+    if (!has_offload(Offloads::TransmitChecksum)) {
+        // The packet was built for an adapter that computes checksums, but it ended up on this one,
+        // e.g. because it is retransmitted after a route change.
+        fill_in_checksum(bytes, packet.checksum_offload.value());
+        packet.checksum_offload.clear();
+        return send_packet(bytes);
+    }
+
+    m_packets_out++;
+    m_bytes_out += bytes.size();
+    ScopedTracepoint tracepoint(Tracepoint::NetworkTransmit);
+    send_raw_with_checksum_offload(bytes, packet.checksum_offload.value());
+}
+
+void NetworkAdapter::fill_in_checksum(Bytes packet, ChecksumOffload checksum_offload)
+{
+    VERIFY(checksum_offload.start <= packet.size());
+    VERIFY(checksum_offload.offset + sizeof(u16) <= packet.size());
+    // The checksum field holds the sum of the pseudo-header, so summing it up along with the rest
+    // of the packet yields the complete checksum.
+    auto checksum = internet_checksum(packet.offset_pointer(checksum_offload.start), packet.size() - checksum_offload.start);
+    memcpy(packet.offset_pointer(checksum_offload.offset), &checksum, sizeof(checksum));
+}
+
 void NetworkAdapter::send(const MACAddress& destination, const ARPPacket& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -92,20 +129,20 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
         on_receive();
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+void NetworkAdapter::did_receive_directly(size_t packet_size)
+{
+    InterruptDisabler disabler;
+    m_packets_in++;
+    m_bytes_in += packet_size;
+}
+
+RefPtr<PacketWithTimestamp> NetworkAdapter::dequeue_packet()
 {
     InterruptDisabler disabler;
     if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
+        return {};
     m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer.size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer.data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    return m_packet_queue.take_first();
 }
 
 RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
@@ -123,6 +160,7 @@ RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
     auto packet = m_unused_packets.take_first();
     if (packet->buffer.capacity() >= size) {
         packet->timestamp = kgettimeofday();
+        packet->checksum_offload.clear();
         packet->buffer.set_size(size);
         return packet;
     }
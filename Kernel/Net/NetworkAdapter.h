@@ -7,9 +7,11 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
+#include <AK/Optional.h>
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
@@ -27,6 +29,13 @@ class NetworkAdapter;
 
 using NetworkByteBuffer = AK::Detail::ByteBuffer<1500>;
 
+// A checksum that is left for the adapter to compute. It covers everything from start to the end of
+// the packet, and is stored at offset, which has to hold the sum of the pseudo-header until then.
+struct ChecksumOffload {
+    u16 start { 0 };
+    u16 offset { 0 };
+};
+
 struct PacketWithTimestamp : public RefCounted<PacketWithTimestamp> {
     PacketWithTimestamp(KBuffer buffer, Time timestamp)
         : buffer(move(buffer))
@@ -36,12 +45,21 @@ struct PacketWithTimestamp : public RefCounted<PacketWithTimestamp> {
 
     KBuffer buffer;
     Time timestamp;
+    Optional<ChecksumOffload> checksum_offload;
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
 class NetworkAdapter : public RefCounted<NetworkAdapter>
     , public Weakable<NetworkAdapter> {
 public:
+    enum class Offloads : u8 {
+        None = 0,
+        // The adapter computes the checksums of outgoing packets that ask for it.
+        TransmitChecksum = 1 << 0,
+        // The adapter verifies the IPv4, TCP and UDP checksums of incoming packets, and drops bad ones.
+        ReceiveChecksum = 1 << 1,
+    };
+
     virtual ~NetworkAdapter();
 
     virtual StringView class_name() const = 0;
@@ -61,13 +79,17 @@ public:
     void send(const MACAddress&, const ARPPacket&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp);
+    // The caller has to hand the packet back through release_packet_buffer() once it is done with it.
+    RefPtr<PacketWithTimestamp> dequeue_packet();
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
+    Offloads offloads() const { return m_offloads; }
+    bool has_offload(Offloads) const;
+
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
@@ -82,13 +104,22 @@ public:
     Function<void()> on_receive;
 
     void send_packet(ReadonlyBytes);
+    // Unlike the above, this takes care of the checksum offload the packet asks for.
+    void send_packet(PacketWithTimestamp&);
+
+    static void fill_in_checksum(Bytes, ChecksumOffload);
 
 protected:
     NetworkAdapter();
     void set_interface_name(const PCI::Address&);
     void set_mac_address(const MACAddress& mac_address) { m_mac_address = mac_address; }
     void did_receive(ReadonlyBytes);
+    // For packets that were handed straight to their receiver instead of going through the packet queue.
+    void did_receive_directly(size_t packet_size);
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called if the adapter has the TransmitChecksum offload.
+    virtual void send_raw_with_checksum_offload(ReadonlyBytes, ChecksumOffload) { VERIFY_NOT_REACHED(); }
+    void set_offloads(Offloads offloads) { m_offloads = offloads; }
 
     void set_loopback_name();
 
@@ -112,6 +143,9 @@ private:
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    Offloads m_offloads { Offloads::None };
 };
 
+AK_ENUM_BITWISE_OPERATORS(NetworkAdapter::Offloads);
+
 }
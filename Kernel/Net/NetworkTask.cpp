@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CircularQueue.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Mutex.h>
 #include <Kernel/Net/ARP.h>
@@ -21,6 +22,7 @@
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
@@ -30,13 +32,31 @@ static void handle_icmp(const EthernetFrameHeader&, const IPv4Packet&, const Tim
 static void handle_udp(const IPv4Packet&, const Time& packet_timestamp);
 static void handle_tcp(const IPv4Packet&, const Time& packet_timestamp);
 static void send_delayed_tcp_ack(RefPtr<TCPSocket> socket);
-static void flush_delayed_tcp_acks();
-static void retransmit_tcp_packets();
 
 static Thread* network_task = nullptr;
-static HashTable<RefPtr<TCPSocket>>* delayed_ack_sockets;
+
+// Received packets are handed to one of several receive workers, which is picked by hashing the flow
+// the packet belongs to. All packets of a flow are thus handled in order by the same worker.
+static constexpr size_t max_receive_worker_count = 8;
+static constexpr size_t max_queued_packets_per_worker = 256;
+
+struct ReceivedPacket {
+    NonnullRefPtr<NetworkAdapter> adapter;
+    NonnullRefPtr<PacketWithTimestamp> packet;
+};
+
+struct ReceiveWorker {
+    Thread* thread { nullptr };
+    WaitQueue wait_queue;
+    SpinLock<u8> lock;
+    CircularQueue<ReceivedPacket, max_queued_packets_per_worker> queue;
+};
+
+static ReceiveWorker* receive_workers;
+static size_t receive_worker_count;
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void receive_worker_main(void*);
 
 void NetworkTask::spawn()
 {
@@ -47,15 +67,112 @@ void NetworkTask::spawn()
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    auto* current_thread = Thread::current();
+    if (current_thread == network_task)
+        return true;
+    for (size_t i = 0; i < receive_worker_count; ++i) {
+        if (current_thread == receive_workers[i].thread)
+            return true;
+    }
+    return false;
+}
+
+static u32 flow_hash(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *(const EthernetFrameHeader*)frame.data();
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+    auto& ipv4_packet = *static_cast<const IPv4Packet*>(eth.payload());
+    u32 hash = pair_int_hash(ipv4_packet.source().to_u32(), ipv4_packet.destination().to_u32());
+    hash = pair_int_hash(hash, ipv4_packet.protocol());
+
+    // Only the first fragment of a datagram carries the ports, so fragments are hashed by their addresses alone.
+    if (ipv4_packet.is_a_fragment())
+        return hash;
+    auto protocol = (IPv4Protocol)ipv4_packet.protocol();
+    if (protocol != IPv4Protocol::TCP && protocol != IPv4Protocol::UDP)
+        return hash;
+    // TCP and UDP headers both start with the source and destination ports.
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(u32))
+        return hash;
+    return pair_int_hash(hash, *(const u32*)ipv4_packet.payload());
+}
+
+static void dispatch_received_packets(NetworkAdapter& adapter)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    while (auto packet = adapter.dequeue_packet()) {
+        auto& worker = receive_workers[flow_hash(ReadonlyBytes { packet->buffer.data(), packet->buffer.size() }) % receive_worker_count];
+        ScopedSpinLock lock(worker.lock);
+        if (worker.queue.size() == worker.queue.capacity()) {
+            // FIXME: Keep track of the number of dropped packets
+            adapter.release_packet_buffer(*packet);
+            continue;
+        }
+        worker.queue.enqueue(ReceivedPacket { adapter, packet.release_nonnull() });
+        worker.wait_queue.wake_one();
+    }
+}
+
+static void handle_packet(ReadonlyBytes frame, const Time& packet_timestamp)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame.size());
+        return;
+    }
+    auto& eth = *(const EthernetFrameHeader*)frame.data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame.size());
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame.size());
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame.size(), packet_timestamp);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
+void receive_worker_main(void* data)
+{
+    auto& worker = *static_cast<ReceiveWorker*>(data);
+    for (;;) {
+        Optional<ReceivedPacket> received_packet;
+        {
+            ScopedSpinLock lock(worker.lock);
+            if (!worker.queue.is_empty())
+                received_packet = worker.queue.dequeue();
+        }
+        if (!received_packet.has_value()) {
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on({}, "NetworkTask");
+            continue;
+        }
+        auto& packet = received_packet->packet;
+        dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", received_packet->adapter->name(), packet->buffer.size());
+        auto trace_start = Tracepoints::begin();
+        handle_packet(ReadonlyBytes { packet->buffer.data(), packet->buffer.size() }, packet->timestamp);
+        Tracepoints::end(Tracepoint::NetworkReceive, trace_start);
+        received_packet->adapter->release_packet_buffer(*packet);
+    }
 }
 
 void NetworkTask_main(void*)
 {
-    delayed_ack_sockets = new HashTable<RefPtr<TCPSocket>>;
+    receive_worker_count = clamp<size_t>(Processor::count(), 1, max_receive_worker_count);
+    receive_workers = new ReceiveWorker[receive_worker_count];
+    for (size_t i = 0; i < receive_worker_count; ++i) {
+        auto thread = Process::current()->create_kernel_thread(receive_worker_main, &receive_workers[i], THREAD_PRIORITY_NORMAL, String::formatted("NetworkTask receive #{}", i), THREAD_AFFINITY_DEFAULT, false);
+        VERIFY(thread);
+        receive_workers[i].thread = thread;
+    }
 
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -65,61 +182,17 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_gateway({ 0, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.on_receive = [&adapter]() {
+            dispatch_received_packets(adapter);
         };
+        InterruptDisabler disabler;
+        dispatch_received_packets(adapter);
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
-
-    size_t buffer_size = 64 * KiB;
-    auto buffer_region = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer", Region::Access::Read | Region::Access::Write);
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    Time packet_timestamp;
-
+    // The receive workers take care of incoming packets, so all that is left to do here is running the TCP timers.
     for (;;) {
-        flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
-            auto timeout_time = Time::from_milliseconds(500);
-            auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask");
-            continue;
-        }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(const EthernetFrameHeader*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
-        }
+        TCPSocket::handle_expired_timers();
+        TCPSocket::wait_for_next_timer();
     }
 }
 
@@ -304,28 +377,7 @@ void send_delayed_tcp_ack(RefPtr<TCPSocket> socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
-}
-
-void flush_delayed_tcp_acks()
-{
-    Vector<RefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
-        MutexLocker locker(socket->lock());
-        if (socket->should_delay_next_ack()) {
-            remaining_sockets.append(socket);
-            continue;
-        }
-        [[maybe_unused]] auto result = socket->send_ack();
-    }
-
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
-        if (remaining_sockets.size() > 0)
-            dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
-        for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
-    }
+    socket->schedule_delayed_ack();
 }
 
 void handle_tcp(const IPv4Packet& ipv4_packet, const Time& packet_timestamp)
@@ -427,6 +479,7 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const Time& packet_timestamp)
             }
             MutexLocker locker(client->lock());
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
+            client->receive_syn_options(tcp_packet);
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
@@ -617,21 +670,4 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const Time& packet_timestamp)
     }
 }
 
-void retransmit_tcp_packets()
-{
-    // We must keep the sockets alive until after we've unlocked the hash table
-    // in case retransmit_packets() realizes that it wants to close the socket.
-    NonnullRefPtrVector<TCPSocket, 16> sockets;
-    {
-        MutexLocker locker(TCPSocket::sockets_for_retransmit().lock(), LockMode::Shared);
-        for (auto& socket : TCPSocket::sockets_for_retransmit().resource())
-            sockets.append(*socket);
-    }
-
-    for (auto& socket : sockets) {
-        MutexLocker socket_locker(socket.lock());
-        socket.retransmit_packets();
-    }
-}
-
 }
@@ -118,7 +118,16 @@ KResult Socket::setsockopt(int level, int option, Userspace<const void*> user_va
         return KSuccess;
     }
     case SO_KEEPALIVE:
-        // FIXME: Obviously, this is not a real keepalive.
+        if (user_value_size != sizeof(int))
+            return EINVAL;
+        if (!copy_from_user(&m_keepalive, static_ptr_cast<const int*>(user_value)))
+            return EFAULT;
+        return KSuccess;
+    case SO_REUSEPORT:
+        if (user_value_size != sizeof(int))
+            return EINVAL;
+        if (!copy_from_user(&m_reuse_port, static_ptr_cast<const int*>(user_value)))
+            return EFAULT;
         return KSuccess;
     case SO_TIMESTAMP:
         if (user_value_size != sizeof(int))
@@ -218,6 +227,24 @@ KResult Socket::getsockopt(FileDescription&, int level, int option, Userspace<vo
         if (!copy_to_user(value_size, &size))
             return EFAULT;
         return KSuccess;
+    case SO_KEEPALIVE:
+        if (size < sizeof(int))
+            return EINVAL;
+        if (!copy_to_user(static_ptr_cast<int*>(value), &m_keepalive))
+            return EFAULT;
+        size = sizeof(int);
+        if (!copy_to_user(value_size, &size))
+            return EFAULT;
+        return KSuccess;
+    case SO_REUSEPORT:
+        if (size < sizeof(int))
+            return EINVAL;
+        if (!copy_to_user(static_ptr_cast<int*>(value), &m_reuse_port))
+            return EFAULT;
+        size = sizeof(int);
+        if (!copy_to_user(value_size, &size))
+            return EFAULT;
+        return KSuccess;
     default:
         dbgln("setsockopt({}) at SOL_SOCKET not implemented.", option);
         return ENOPROTOOPT;
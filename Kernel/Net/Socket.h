@@ -114,6 +114,8 @@ public:
     const Time& send_timeout() const { return m_send_timeout; }
 
     bool wants_timestamp() const { return m_timestamp; }
+    bool wants_keepalive() const { return m_keepalive; }
+    bool wants_reuse_port() const { return m_reuse_port; }
 
 protected:
     Socket(int domain, int type, int protocol);
@@ -153,6 +155,8 @@ private:
     Time m_receive_timeout {};
     Time m_send_timeout {};
     int m_timestamp { 0 };
+    int m_keepalive { 0 };
+    int m_reuse_port { 0 };
 
     NonnullRefPtrVector<Socket> m_pending;
 };
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <Kernel/Mutex.h>
+
+namespace Kernel {
+
+// A hash map that is split into stripes, each guarded by a lock of its own. Looking up or
+// registering the socket of one connection thus doesn't contend with the sockets of others.
+template<typename K, typename V, size_t stripe_count = 32>
+class SocketTable {
+public:
+    using Map = HashMap<K, V>;
+
+    template<typename Callback>
+    decltype(auto) with_shared(const K& key, Callback callback)
+    {
+        auto& stripe = stripe_for(key);
+        MutexLocker locker(stripe.lock(), Mutex::Mode::Shared);
+        return callback(stripe.resource());
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(const K& key, Callback callback)
+    {
+        auto& stripe = stripe_for(key);
+        MutexLocker locker(stripe.lock());
+        return callback(stripe.resource());
+    }
+
+    // NOTE: Only one stripe is locked at a time, so this is not a consistent snapshot of the whole table.
+    template<typename Callback>
+    void for_each_shared(Callback callback)
+    {
+        for (auto& stripe : m_stripes) {
+            MutexLocker locker(stripe.lock(), Mutex::Mode::Shared);
+            for (auto& it : stripe.resource())
+                callback(it.key, it.value);
+        }
+    }
+
+private:
+    Lockable<Map>& stripe_for(const K& key)
+    {
+        // The hash is mixed once more, as the maps inside the stripes use it to pick their buckets as well.
+        return m_stripes[int_hash(Traits<K>::hash(key)) % stripe_count];
+    }
+
+    Array<Lockable<Map>, stripe_count> m_stripes;
+};
+
+}
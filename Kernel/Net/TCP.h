@@ -21,6 +21,15 @@ struct TCPFlags {
     };
 };
 
+enum class TCPOptionKind : u8 {
+    End = 0,
+    NoOperation = 1,
+    MSS = 2,
+    WindowScale = 3,
+    SACKPermitted = 4,
+    SACK = 5,
+};
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -31,13 +40,54 @@ public:
     u16 value() const { return m_value; }
 
 private:
-    u8 m_option_kind { 0x02 };
+    u8 m_option_kind { (u8)TCPOptionKind::MSS };
     u8 m_option_length { sizeof(TCPOptionMSS) };
     NetworkOrdered<u16> m_value;
 };
 
 static_assert(sizeof(TCPOptionMSS) == 4);
 
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 value)
+        : m_value(value)
+    {
+    }
+
+    u8 value() const { return m_value; }
+
+private:
+    u8 m_option_kind { (u8)TCPOptionKind::WindowScale };
+    u8 m_option_length { sizeof(TCPOptionWindowScale) };
+    u8 m_value;
+};
+
+static_assert(sizeof(TCPOptionWindowScale) == 3);
+
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_option_kind { (u8)TCPOptionKind::SACKPermitted };
+    u8 m_option_length { sizeof(TCPOptionSACKPermitted) };
+};
+
+static_assert(sizeof(TCPOptionSACKPermitted) == 2);
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+static_assert(sizeof(TCPSACKBlock) == 8);
+
+// RFC 7323 limits the window scale shift count to 14.
+static constexpr u8 maximum_tcp_window_scale = 14;
+
+// Sequence numbers wrap around, so they can only be compared relative to each other.
+constexpr bool tcp_sequence_number_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -73,6 +123,7 @@ public:
 
     u16 checksum() const { return m_checksum; }
     void set_checksum(u16 checksum) { m_checksum = checksum; }
+    static constexpr size_t checksum_offset = 16;
 
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
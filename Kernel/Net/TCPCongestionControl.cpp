@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+OwnPtr<TCPCongestionControl> TCPCongestionControl::try_create_default()
+{
+    return adopt_own_if_nonnull(new (nothrow) TCPNewRenoCongestionControl);
+}
+
+void TCPNewRenoCongestionControl::initialize(u32 maximum_segment_size)
+{
+    m_maximum_segment_size = maximum_segment_size;
+    // RFC 3390 initial window, which is 4 segments for a typical Ethernet MSS.
+    m_congestion_window = min(4 * maximum_segment_size, max(2 * maximum_segment_size, 4380u));
+    m_slow_start_threshold = NumericLimits<u32>::max();
+    m_in_recovery = false;
+}
+
+void TCPNewRenoCongestionControl::reduce_slow_start_threshold(u32 bytes_in_flight)
+{
+    m_slow_start_threshold = max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+bool TCPNewRenoCongestionControl::on_ack(u32 ack_number, u32 bytes_acked)
+{
+    if (m_in_recovery) {
+        if (!tcp_sequence_number_before(ack_number, m_recovery_point)) {
+            // Full acknowledgement: everything that was outstanding when the loss was detected has arrived.
+            m_in_recovery = false;
+            m_congestion_window = m_slow_start_threshold;
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPNewRenoCongestionControl: leaving fast recovery, cwnd={}", m_congestion_window);
+            return false;
+        }
+
+        // Partial acknowledgement: the next segment was lost as well, so deflate the window by the
+        // amount of new data acknowledged and retransmit it.
+        m_congestion_window -= min(m_congestion_window, bytes_acked);
+        m_congestion_window += m_maximum_segment_size;
+        return true;
+    }
+
+    if (m_congestion_window < m_slow_start_threshold) {
+        m_congestion_window += min(bytes_acked, m_maximum_segment_size);
+    } else {
+        u32 increment = m_maximum_segment_size * m_maximum_segment_size / m_congestion_window;
+        m_congestion_window += max(increment, 1u);
+    }
+    return false;
+}
+
+bool TCPNewRenoCongestionControl::on_duplicate_ack(u32 duplicate_ack_count, u32 bytes_in_flight, u32 send_next)
+{
+    if (m_in_recovery) {
+        // Every duplicate acknowledgement means that another segment has left the network.
+        m_congestion_window += m_maximum_segment_size;
+        return false;
+    }
+
+    if (duplicate_ack_count != 3)
+        return false;
+
+    reduce_slow_start_threshold(bytes_in_flight);
+    m_congestion_window = m_slow_start_threshold + 3 * m_maximum_segment_size;
+    m_in_recovery = true;
+    m_recovery_point = send_next;
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPNewRenoCongestionControl: entering fast recovery, ssthresh={}, recovery point={}", m_slow_start_threshold, m_recovery_point);
+    return true;
+}
+
+void TCPNewRenoCongestionControl::on_retransmit_timeout(u32 bytes_in_flight, u32 previous_timeouts)
+{
+    // The window has already been collapsed if the segment timed out before, so the little that
+    // is in flight now says nothing about the capacity of the path.
+    if (previous_timeouts == 0)
+        reduce_slow_start_threshold(bytes_in_flight);
+    m_congestion_window = m_maximum_segment_size;
+    m_in_recovery = false;
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// A congestion controller decides how much data a TCPSocket may have in flight at once,
+// based on the acknowledgements and losses it is told about.
+class TCPCongestionControl {
+public:
+    static OwnPtr<TCPCongestionControl> try_create_default();
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual StringView name() const = 0;
+
+    // Called once the maximum segment size of the connection is known, before any data is sent.
+    virtual void initialize(u32 maximum_segment_size) = 0;
+
+    // Called for every acknowledgement of new data.
+    // Returns true if the first unacknowledged segment should be retransmitted right away.
+    virtual bool on_ack(u32 ack_number, u32 bytes_acked) = 0;
+
+    // Called for every duplicate acknowledgement, where send_next is the next sequence number that would be sent.
+    // Returns true if the first unacknowledged segment should be retransmitted right away.
+    virtual bool on_duplicate_ack(u32 duplicate_ack_count, u32 bytes_in_flight, u32 send_next) = 0;
+
+    // Called when the retransmission timer expires, where previous_timeouts is the number of times it has
+    // already expired for the same segment.
+    virtual void on_retransmit_timeout(u32 bytes_in_flight, u32 previous_timeouts) = 0;
+
+    virtual bool is_in_recovery() const = 0;
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+
+protected:
+    TCPCongestionControl() = default;
+
+    u32 m_maximum_segment_size { 536 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+};
+
+// Slow start, congestion avoidance, fast retransmit and fast recovery as in RFC 5681,
+// with the NewReno modification to fast recovery from RFC 6582.
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    TCPNewRenoCongestionControl() = default;
+    virtual ~TCPNewRenoCongestionControl() override = default;
+
+    virtual StringView name() const override { return "newreno"; }
+    virtual void initialize(u32 maximum_segment_size) override;
+    virtual bool on_ack(u32 ack_number, u32 bytes_acked) override;
+    virtual bool on_duplicate_ack(u32 duplicate_ack_count, u32 bytes_in_flight, u32 send_next) override;
+    virtual void on_retransmit_timeout(u32 bytes_in_flight, u32 previous_timeouts) override;
+    virtual bool is_in_recovery() const override { return m_in_recovery; }
+
+private:
+    void reduce_slow_start_threshold(u32 bytes_in_flight);
+
+    bool m_in_recovery { false };
+    u32 m_recovery_point { 0 };
+};
+
+}
@@ -18,14 +18,24 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
 void TCPSocket::for_each(Function<void(const TCPSocket&)> callback)
 {
-    MutexLocker locker(sockets_by_tuple().lock(), Mutex::Mode::Shared);
-    for (auto& it : sockets_by_tuple().resource())
-        callback(*it.value);
+    listening_sockets().for_each_shared([&](auto&, auto& listeners) {
+        for (auto* socket : listeners)
+            callback(*socket);
+    });
+    connected_sockets().for_each_shared([&](auto&, auto* socket) {
+        callback(*socket);
+    });
+}
+
+static bool is_listening_tuple(const IPv4SocketTuple& tuple)
+{
+    return tuple.peer_address().is_zero() && tuple.peer_port() == 0;
 }
 
 void TCPSocket::set_state(State new_state)
@@ -40,7 +50,20 @@ void TCPSocket::set_state(State new_state)
     if (new_state == State::Established && m_direction == Direction::Outgoing)
         m_role = Role::Connected;
 
+    if (new_state == State::Established) {
+        MutexLocker locker(m_not_acked_lock);
+        m_congestion_control->initialize(m_maximum_segment_size);
+    }
+    update_keepalive_timer();
+
+    if (new_state == State::TimeWait)
+        start_timer(m_time_wait_timer, time_wait_timeout);
+
     if (new_state == State::Closed) {
+        cancel_timer(m_retransmit_timer);
+        cancel_timer(m_delayed_ack_timer);
+        cancel_timer(m_time_wait_timer);
+
         MutexLocker locker(closing_sockets().lock());
         closing_sockets().resource().remove(tuple());
 
@@ -59,43 +82,105 @@ Lockable<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& TCPSocket::closing_socket
     return *s_socket_closing;
 }
 
-static AK::Singleton<Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
+static AK::Singleton<SocketTable<IPv4SocketTuple, TCPSocket*>> s_connected_sockets;
 
-Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
+SocketTable<IPv4SocketTuple, TCPSocket*>& TCPSocket::connected_sockets()
 {
-    return *s_socket_tuples;
+    return *s_connected_sockets;
+}
+
+static AK::Singleton<SocketTable<IPv4SocketTuple, Vector<TCPSocket*, 1>>> s_listening_sockets;
+
+SocketTable<IPv4SocketTuple, Vector<TCPSocket*, 1>>& TCPSocket::listening_sockets()
+{
+    return *s_listening_sockets;
 }
 
 RefPtr<TCPSocket> TCPSocket::from_tuple(const IPv4SocketTuple& tuple)
 {
-    MutexLocker locker(sockets_by_tuple().lock(), Mutex::Mode::Shared);
+    auto connected_socket = connected_sockets().with_shared(tuple, [&](auto& table) -> RefPtr<TCPSocket> {
+        auto it = table.find(tuple);
+        if (it == table.end())
+            return {};
+        return *it->value;
+    });
+    if (connected_socket)
+        return connected_socket;
+
+    auto find_listener = [&](const IPv4SocketTuple& listening_tuple) {
+        return listening_sockets().with_shared(listening_tuple, [&](auto& table) -> RefPtr<TCPSocket> {
+            auto it = table.find(listening_tuple);
+            if (it == table.end())
+                return {};
+            // Connections are spread across the listeners sharing a port by their tuple, so that every
+            // segment of a handshake ends up at the same listener.
+            auto& listeners = it->value;
+            return *listeners[Traits<IPv4SocketTuple>::hash(tuple) % listeners.size()];
+        });
+    };
 
-    auto exact_match = sockets_by_tuple().resource().get(tuple);
-    if (exact_match.has_value())
-        return { *exact_match.value() };
+    if (auto address_match = find_listener(IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0)))
+        return address_match;
+    return find_listener(IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0));
+}
 
-    auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
-    auto address_match = sockets_by_tuple().resource().get(address_tuple);
-    if (address_match.has_value())
-        return { *address_match.value() };
+KResult TCPSocket::add_to_socket_table(const IPv4SocketTuple& tuple)
+{
+    if (!is_listening_tuple(tuple)) {
+        return connected_sockets().with_exclusive(tuple, [&](auto& table) -> KResult {
+            if (table.contains(tuple))
+                return EADDRINUSE;
+            table.set(tuple, this);
+            return KSuccess;
+        });
+    }
 
-    auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
-    auto wildcard_match = sockets_by_tuple().resource().get(wildcard_tuple);
-    if (wildcard_match.has_value())
-        return { *wildcard_match.value() };
+    return listening_sockets().with_exclusive(tuple, [&](auto& table) -> KResult {
+        auto it = table.find(tuple);
+        if (it == table.end()) {
+            Vector<TCPSocket*, 1> listeners;
+            listeners.append(this);
+            table.set(tuple, move(listeners));
+            return KSuccess;
+        }
+        // A port can only be shared by listeners of the same user, and only if every one of them asked for it.
+        if (!wants_reuse_port())
+            return EADDRINUSE;
+        for (auto* listener : it->value) {
+            if (!listener->wants_reuse_port() || listener->origin_uid() != origin_uid())
+                return EADDRINUSE;
+        }
+        it->value.append(this);
+        return KSuccess;
+    });
+}
+
+void TCPSocket::remove_from_socket_table()
+{
+    auto tuple = this->tuple();
+    if (!is_listening_tuple(tuple)) {
+        connected_sockets().with_exclusive(tuple, [&](auto& table) {
+            auto it = table.find(tuple);
+            if (it != table.end() && it->value == this)
+                table.remove(it);
+        });
+        return;
+    }
 
-    return {};
+    listening_sockets().with_exclusive(tuple, [&](auto& table) {
+        auto it = table.find(tuple);
+        if (it == table.end())
+            return;
+        it->value.remove_first_matching([&](auto* listener) { return listener == this; });
+        if (it->value.is_empty())
+            table.remove(it);
+    });
 }
+
 RefPtr<TCPSocket> TCPSocket::create_client(const IPv4Address& new_local_address, u16 new_local_port, const IPv4Address& new_peer_address, u16 new_peer_port)
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
 
-    {
-        MutexLocker locker(sockets_by_tuple().lock(), Mutex::Mode::Shared);
-        if (sockets_by_tuple().resource().contains(tuple))
-            return {};
-    }
-
     auto result = TCPSocket::create(protocol());
     if (result.is_error())
         return {};
@@ -109,9 +194,9 @@ RefPtr<TCPSocket> TCPSocket::create_client(const IPv4Address& new_local_address,
     client->set_direction(Direction::Incoming);
     client->set_originator(*this);
 
-    MutexLocker locker(sockets_by_tuple().lock());
+    if (client->add_to_socket_table(tuple).is_error())
+        return {};
     m_pending_release_for_accept.set(tuple, client);
-    sockets_by_tuple().resource().set(tuple, client);
 
     return client;
 }
@@ -131,25 +216,32 @@ void TCPSocket::release_for_accept(RefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(*socket);
 }
 
-TCPSocket::TCPSocket(int protocol)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol)
+    , m_congestion_control(move(congestion_control))
 {
     m_last_retransmit_time = kgettimeofday();
+    m_last_receive_time = m_last_retransmit_time;
 }
 
 TCPSocket::~TCPSocket()
 {
-    MutexLocker locker(sockets_by_tuple().lock());
-    sockets_by_tuple().resource().remove(tuple());
+    remove_from_socket_table();
 
-    dequeue_for_retransmit();
+    cancel_timer(m_retransmit_timer);
+    cancel_timer(m_delayed_ack_timer);
+    cancel_timer(m_time_wait_timer);
+    cancel_timer(m_keepalive_timer);
 
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
 KResultOr<NonnullRefPtr<TCPSocket>> TCPSocket::create(int protocol)
 {
-    auto socket = adopt_ref_if_nonnull(new (nothrow) TCPSocket(protocol));
+    auto congestion_control = TCPCongestionControl::try_create_default();
+    if (!congestion_control)
+        return ENOMEM;
+    auto socket = adopt_ref_if_nonnull(new (nothrow) TCPSocket(protocol, congestion_control.release_nonnull()));
     if (socket)
         return socket.release_nonnull();
     return ENOMEM;
@@ -167,19 +259,88 @@ KResultOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, Use
     return payload_size;
 }
 
+KResultOr<size_t> TCPSocket::next_segment_size(RoutingDecision& routing_decision)
+{
+    size_t mss = min<size_t>(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket), m_maximum_segment_size);
+    MutexLocker locker(m_not_acked_lock);
+    if (m_state != State::Closed && !can_send_segment())
+        return EAGAIN;
+    // Never send more than the peer and the congestion window allow, unless the peer has
+    // to be probed for a window update.
+    if (size_t in_flight = bytes_in_flight(); in_flight > 0) {
+        size_t window = min(m_send_window_size, m_congestion_control->congestion_window());
+        mss = min(mss, window - in_flight);
+    }
+    return mss;
+}
+
 KResultOr<size_t> TCPSocket::protocol_send(const UserOrKernelBuffer& data, size_t data_length)
 {
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return EHOSTUNREACH;
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
+    auto mss_or_error = next_segment_size(routing_decision);
+    if (mss_or_error.is_error())
+        return mss_or_error.error();
+    data_length = min(data_length, mss_or_error.value());
     int err = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &data, data_length, &routing_decision);
     if (err < 0)
         return KResult((ErrnoCode)-err);
     return data_length;
 }
 
+KResultOr<size_t> TCPSocket::send_file_data(FileDescription& description, FileDescription& file, u64 offset, size_t count)
+{
+    MutexLocker locker(lock());
+    size_t total_sent = 0;
+    while (total_sent < count) {
+        if (is_shut_down_for_writing())
+            return EPIPE;
+        if (!is_connected())
+            return ENOTCONN;
+        RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
+        if (routing_decision.is_zero())
+            return EHOSTUNREACH;
+
+        auto segment_size_or_error = next_segment_size(routing_decision);
+        if (segment_size_or_error.is_error()) {
+            if (total_sent > 0)
+                break;
+            if (segment_size_or_error.error() != EAGAIN || !description.is_blocking())
+                return segment_size_or_error.error();
+            // Nothing has been sent yet, so wait until something can be.
+            locker.unlock();
+            auto unblocked_flags = Thread::FileBlocker::BlockFlags::None;
+            auto block_result = Thread::current()->block<Thread::WriteBlocker>({}, description, unblocked_flags);
+            locker.lock();
+            if (block_result.was_interrupted())
+                return EINTR;
+            continue;
+        }
+
+        size_t segment_size = min(segment_size_or_error.value(), count - total_sent);
+        u64 segment_offset = offset + total_sent;
+        auto result = send_tcp_segment(TCPFlags::PUSH | TCPFlags::ACK, segment_size, &routing_decision, [&](Bytes payload) -> KResult {
+            auto payload_buffer = UserOrKernelBuffer::for_kernel_buffer(payload.data());
+            auto nread_or_error = file.read(payload_buffer, segment_offset, payload.size());
+            if (nread_or_error.is_error())
+                return nread_or_error.error();
+            // The file was truncated since we looked at its size.
+            if (nread_or_error.value() != payload.size())
+                return EIO;
+            return KSuccess;
+        });
+        if (result.is_error()) {
+            if (total_sent > 0)
+                break;
+            return result;
+        }
+        total_sent += segment_size;
+    }
+    Thread::current()->did_ipv4_socket_write(total_sent);
+    return total_sent;
+}
+
 KResult TCPSocket::send_ack(bool allow_duplicate)
 {
     if (!allow_duplicate && m_last_ack_number_sent == m_ack_number)
@@ -188,6 +349,17 @@ KResult TCPSocket::send_ack(bool allow_duplicate)
 }
 
 KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload, size_t payload_size, RoutingDecision* user_routing_decision)
+{
+    if (!payload)
+        return send_tcp_segment(flags, 0, user_routing_decision, {});
+    return send_tcp_segment(flags, payload_size, user_routing_decision, [&](Bytes buffer) -> KResult {
+        if (!payload->read(buffer.data(), buffer.size()))
+            return EFAULT;
+        return KSuccess;
+    });
+}
+
+KResult TCPSocket::send_tcp_segment(u16 flags, size_t payload_size, RoutingDecision* user_routing_decision, const Function<KResult(Bytes)>& write_payload)
 {
     RoutingDecision routing_decision = user_routing_decision ? *user_routing_decision : route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
@@ -195,8 +367,19 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    const bool has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    // Window scaling and SACK are offered with every connection we open. When answering a SYN,
+    // they are only used if the peer has offered them as well.
+    const bool is_syn = flags & TCPFlags::SYN;
+    const bool is_passive_syn = is_syn && (flags & TCPFlags::ACK);
+    const bool has_window_scale_option = is_syn && (!is_passive_syn || m_window_scaling);
+    const bool has_sack_permitted_option = is_syn && (!is_passive_syn || m_sack_permitted);
+    size_t options_size = 0;
+    if (is_syn)
+        options_size += sizeof(TCPOptionMSS);
+    if (has_window_scale_option)
+        options_size += 1 + sizeof(TCPOptionWindowScale);
+    if (has_sack_permitted_option)
+        options_size += 2 + sizeof(TCPOptionSACKPermitted);
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -210,7 +393,7 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    tcp_packet.set_window_size(advertised_window_size(is_syn));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -221,9 +404,11 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
         tcp_packet.set_ack_number(m_ack_number);
     }
 
-    if (payload && !payload->read(tcp_packet.payload(), payload_size)) {
-        routing_decision.adapter->release_packet_buffer(*packet);
-        return EFAULT;
+    if (write_payload) {
+        if (auto result = write_payload({ tcp_packet.payload(), payload_size }); result.is_error()) {
+            routing_decision.adapter->release_packet_buffer(*packet);
+            return result;
+        }
     }
 
     if (flags & TCPFlags::SYN) {
@@ -232,24 +417,49 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
+    if (is_syn) {
         u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+        m_maximum_segment_size = min<u32>(m_maximum_segment_size, mss);
+
+        auto* options = packet->buffer.data() + ipv4_payload_offset + sizeof(TCPPacket);
+        VERIFY(packet->buffer.size() >= ipv4_payload_offset + sizeof(TCPPacket) + options_size);
         TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer.size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer.data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+        memcpy(options, &mss_option, sizeof(mss_option));
+        options += sizeof(mss_option);
+        if (has_window_scale_option) {
+            TCPOptionWindowScale window_scale_option { offered_receive_window_scale };
+            *options++ = (u8)TCPOptionKind::NoOperation;
+            memcpy(options, &window_scale_option, sizeof(window_scale_option));
+            options += sizeof(window_scale_option);
+        }
+        if (has_sack_permitted_option) {
+            TCPOptionSACKPermitted sack_permitted_option;
+            *options++ = (u8)TCPOptionKind::NoOperation;
+            *options++ = (u8)TCPOptionKind::NoOperation;
+            memcpy(options, &sack_permitted_option, sizeof(sack_permitted_option));
+        }
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    if (routing_decision.adapter->has_offload(NetworkAdapter::Offloads::TransmitChecksum)) {
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_sum(local_address(), peer_address(), tcp_header_size + payload_size));
+        packet->checksum_offload = ChecksumOffload { (u16)ipv4_payload_offset, (u16)(ipv4_payload_offset + TCPPacket::checksum_offset) };
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
-    routing_decision.adapter->send_packet({ packet->buffer.data(), packet->buffer.size() });
+    routing_decision.adapter->send_packet(*packet);
 
     m_packets_out++;
     m_bytes_out += buffer_size;
     if (tcp_packet.has_syn() || payload_size > 0) {
         MutexLocker locker(m_not_acked_lock);
-        m_not_acked.append({ m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter });
+        auto now = kgettimeofday();
+        // Start the retransmission timer if it isn't running already.
+        if (m_not_acked.is_empty())
+            m_last_retransmit_time = now;
+        m_not_acked.append({ tcp_packet.sequence_number(), m_sequence_number, move(packet), ipv4_payload_offset, payload_size, *routing_decision.adapter, now });
         m_not_acked_size += payload_size;
-        enqueue_for_retransmit();
+        update_retransmit_timer();
     } else {
         routing_decision.adapter->release_packet_buffer(*packet);
     }
@@ -257,47 +467,260 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     return KSuccess;
 }
 
+template<typename Callback>
+static void for_each_tcp_option(const TCPPacket& packet, Callback callback)
+{
+    auto* options = (const u8*)&packet + sizeof(TCPPacket);
+    size_t options_size = packet.header_size() - sizeof(TCPPacket);
+    size_t offset = 0;
+    while (offset < options_size) {
+        auto kind = (TCPOptionKind)options[offset];
+        if (kind == TCPOptionKind::End)
+            return;
+        if (kind == TCPOptionKind::NoOperation) {
+            ++offset;
+            continue;
+        }
+        if (offset + 1 >= options_size)
+            return;
+        size_t length = options[offset + 1];
+        if (length < 2 || offset + length > options_size) {
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: Option {} has invalid length {}", (u8)kind, length);
+            return;
+        }
+        callback(kind, ReadonlyBytes { options + offset + 2, length - 2 });
+        offset += length;
+    }
+}
+
+void TCPSocket::receive_syn_options(const TCPPacket& packet)
+{
+    VERIFY(packet.has_syn());
+    for_each_tcp_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == sizeof(u16))
+                m_maximum_segment_size = min<u32>(m_maximum_segment_size, (data[0] << 8) | data[1]);
+            break;
+        case TCPOptionKind::WindowScale:
+            if (data.size() == sizeof(u8)) {
+                m_window_scaling = true;
+                m_send_window_scale = min(data[0], maximum_tcp_window_scale);
+                m_receive_window_scale = offered_receive_window_scale;
+            }
+            break;
+        case TCPOptionKind::SACKPermitted:
+            m_sack_permitted = true;
+            break;
+        default:
+            break;
+        }
+    });
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) SYN options: mss={}, window scaling={} ({}/{}), sack={}", this, m_maximum_segment_size, m_window_scaling, m_send_window_scale, m_receive_window_scale, m_sack_permitted);
+}
+
+void TCPSocket::receive_sack_blocks(const TCPPacket& packet)
+{
+    VERIFY(m_not_acked_lock.is_locked());
+    for_each_tcp_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK)
+            return;
+        for (size_t offset = 0; offset + sizeof(TCPSACKBlock) <= data.size(); offset += sizeof(TCPSACKBlock)) {
+            auto& block = *(const TCPSACKBlock*)(data.data() + offset);
+            u32 left_edge = block.left_edge;
+            u32 right_edge = block.right_edge;
+            for (auto& outgoing_packet : m_not_acked) {
+                if (outgoing_packet.sacked)
+                    continue;
+                if (tcp_sequence_number_before(outgoing_packet.sequence_number, left_edge) || tcp_sequence_number_before(right_edge, outgoing_packet.ack_number))
+                    continue;
+                if (outgoing_packet.lost) {
+                    outgoing_packet.lost = false;
+                    m_lost_size -= outgoing_packet.payload_size;
+                    --m_lost_packet_count;
+                }
+                outgoing_packet.sacked = true;
+                m_sacked_size += outgoing_packet.payload_size;
+            }
+        }
+    });
+}
+
+void TCPSocket::update_round_trip_time(const Time& sample)
+{
+    // The clock granularity and bounds of the retransmission timeout, as in RFC 6298.
+    constexpr i64 clock_granularity_us = 10'000;
+    constexpr i64 minimum_retransmission_timeout_us = 1'000'000;
+    constexpr i64 maximum_retransmission_timeout_us = 60'000'000;
+
+    i64 sample_us = sample.to_microseconds();
+    i64 smoothed_us = m_smoothed_round_trip_time.to_microseconds();
+    i64 variance_us = m_round_trip_time_variance.to_microseconds();
+    if (!m_has_round_trip_time_sample) {
+        smoothed_us = sample_us;
+        variance_us = sample_us / 2;
+        m_has_round_trip_time_sample = true;
+    } else {
+        i64 difference_us = smoothed_us - sample_us;
+        variance_us = (3 * variance_us + (difference_us < 0 ? -difference_us : difference_us)) / 4;
+        smoothed_us = (7 * smoothed_us + sample_us) / 8;
+    }
+    m_smoothed_round_trip_time = Time::from_microseconds(smoothed_us);
+    m_round_trip_time_variance = Time::from_microseconds(variance_us);
+    i64 timeout_us = smoothed_us + max(clock_granularity_us, 4 * variance_us);
+    m_retransmission_timeout = Time::from_microseconds(clamp(timeout_us, minimum_retransmission_timeout_us, maximum_retransmission_timeout_us));
+}
+
 void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
 {
+    if (packet.has_syn() && m_state == State::SynSent)
+        receive_syn_options(packet);
+
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
-        int removed = 0;
         MutexLocker locker(m_not_acked_lock);
+
+        // The window in a SYN is never scaled.
+        u32 previous_send_window_size = m_send_window_size;
+        m_send_window_size = packet.has_syn() ? packet.window_size() : (u32)packet.window_size() << m_send_window_scale;
+
+        receive_sack_blocks(packet);
+
+        auto now = kgettimeofday();
+        size_t bytes_acked = 0;
+        int removed = 0;
         while (!m_not_acked.is_empty()) {
             auto& packet = m_not_acked.first();
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-            if (packet.ack_number <= ack_number) {
-                auto old_adapter = packet.adapter.strong_ref();
-                if (old_adapter)
-                    old_adapter->release_packet_buffer(*packet.buffer);
-                TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
-                auto payload_size = packet.buffer->buffer.data() + packet.buffer->buffer.size() - (u8*)tcp_packet.payload();
-                m_not_acked_size -= payload_size;
-                evaluate_block_conditions();
-                m_not_acked.take_first();
-                removed++;
-            } else {
+            if (tcp_sequence_number_before(ack_number, packet.ack_number))
                 break;
+
+            // Per Karn's algorithm, retransmitted packets are ambiguous and can't be used to measure the round trip time.
+            if (packet.tx_counter == 0 && removed == 0)
+                update_round_trip_time(now - packet.sent_time);
+
+            auto old_adapter = packet.adapter.strong_ref();
+            if (old_adapter)
+                old_adapter->release_packet_buffer(*packet.buffer);
+            m_not_acked_size -= packet.payload_size;
+            if (packet.sacked)
+                m_sacked_size -= packet.payload_size;
+            if (packet.lost) {
+                m_lost_size -= packet.payload_size;
+                --m_lost_packet_count;
             }
+            bytes_acked += packet.payload_size;
+            m_not_acked.take_first();
+            removed++;
+        }
+
+        size_t payload_size = size - packet.header_size();
+        if (removed > 0) {
+            m_duplicate_acks_received = 0;
+            m_retransmit_attempts = 0;
+            // Restart the retransmission timer for whatever is still in flight.
+            m_last_retransmit_time = now;
+            update_retransmit_timer();
+            if (m_congestion_control->on_ack(ack_number, bytes_acked))
+                mark_first_unacked_packet_lost();
+            evaluate_block_conditions();
+        } else if (!m_not_acked.is_empty() && ack_number == m_not_acked.first().sequence_number && payload_size == 0 && !packet.has_syn() && !packet.has_fin() && m_send_window_size == previous_send_window_size) {
+            ++m_duplicate_acks_received;
+            if (m_congestion_control->on_duplicate_ack(m_duplicate_acks_received, bytes_in_flight(), m_sequence_number))
+                mark_first_unacked_packet_lost();
+        } else if (m_send_window_size != previous_send_window_size) {
+            evaluate_block_conditions();
         }
 
         if (m_not_acked.is_empty()) {
             m_retransmit_attempts = 0;
-            dequeue_for_retransmit();
+            cancel_timer(m_retransmit_timer);
+        } else {
+            retransmit_lost_packets();
         }
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets, cwnd={}, in flight={}", removed, congestion_window(), bytes_in_flight());
     }
 
+    m_last_receive_time = kgettimeofday();
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+u16 TCPSocket::advertised_window_size(bool is_syn) const
+{
+    size_t window_size = receive_buffer_space();
+    if (!is_syn)
+        window_size >>= m_receive_window_scale;
+    return min<size_t>(window_size, NumericLimits<u16>::max());
+}
+
+size_t TCPSocket::bytes_in_flight() const
+{
+    VERIFY(m_not_acked_lock.is_locked());
+    return m_not_acked_size - m_sacked_size - m_lost_size;
+}
+
+bool TCPSocket::can_send_segment() const
+{
+    VERIFY(m_not_acked_lock.is_locked());
+    // With nothing in flight, one segment may always be sent. This keeps probing a peer
+    // that has closed its window, in case the update that opens it again gets lost.
+    size_t in_flight = bytes_in_flight();
+    if (in_flight == 0)
+        return true;
+    size_t window = min(m_send_window_size, m_congestion_control->congestion_window());
+    return in_flight + min<size_t>(m_maximum_segment_size, window) <= window;
+}
+
+void TCPSocket::mark_packet_lost(OutgoingPacket& packet)
+{
+    VERIFY(!packet.sacked);
+    if (packet.lost)
+        return;
+    packet.lost = true;
+    m_lost_size += packet.payload_size;
+    ++m_lost_packet_count;
+}
+
+void TCPSocket::mark_first_unacked_packet_lost()
+{
+    for (auto& packet : m_not_acked) {
+        if (packet.sacked)
+            continue;
+        mark_packet_lost(packet);
+        return;
+    }
+}
+
+void TCPSocket::retransmit_lost_packets()
+{
+    VERIFY(m_not_acked_lock.is_locked());
+    if (m_lost_packet_count == 0)
+        return;
+
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return;
+
+    for (auto& packet : m_not_acked) {
+        if (!packet.lost)
+            continue;
+        size_t in_flight = bytes_in_flight();
+        if (in_flight > 0 && in_flight + packet.payload_size > m_congestion_control->congestion_window())
+            break;
+        packet.lost = false;
+        m_lost_size -= packet.payload_size;
+        --m_lost_packet_count;
+        retransmit_packet(packet, routing_decision);
+    }
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -314,7 +737,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+u16 TCPSocket::compute_tcp_pseudo_header_sum(const IPv4Address& source, const IPv4Address& destination, u16 tcp_size)
 {
     struct [[gnu::packed]] PseudoHeader {
         IPv4Address source;
@@ -324,7 +747,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
         NetworkOrdered<u16> payload_size;
     };
 
-    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, packet.header_size() + payload_size };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_size };
 
     u32 checksum = 0;
     auto* w = (const NetworkOrdered<u16>*)&pseudo_header;
@@ -333,7 +756,13 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
-    w = (const NetworkOrdered<u16>*)&packet;
+    return checksum;
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+{
+    u32 checksum = compute_tcp_pseudo_header_sum(source, destination, packet.header_size() + payload_size);
+    auto* w = (const NetworkOrdered<u16>*)&packet;
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += w[i];
         if (checksum > 0xffff)
@@ -369,10 +798,8 @@ KResult TCPSocket::protocol_bind()
 KResult TCPSocket::protocol_listen(bool did_allocate_port)
 {
     if (!did_allocate_port) {
-        MutexLocker socket_locker(sockets_by_tuple().lock());
-        if (sockets_by_tuple().resource().contains(tuple()))
-            return EADDRINUSE;
-        sockets_by_tuple().resource().set(tuple(), this);
+        if (auto result = add_to_socket_table(tuple()); result.is_error())
+            return result;
     }
 
     set_direction(Direction::Passive);
@@ -434,14 +861,11 @@ KResultOr<u16> TCPSocket::protocol_allocate_local_port()
     constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    MutexLocker locker(sockets_by_tuple().lock());
     for (u16 port = first_scan_port;;) {
         IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
 
-        auto it = sockets_by_tuple().resource().find(proposed_tuple);
-        if (it == sockets_by_tuple().resource().end()) {
+        if (!add_to_socket_table(proposed_tuple).is_error()) {
             set_local_port(port);
-            sockets_by_tuple().resource().set(proposed_tuple, this);
             return port;
         }
         ++port;
@@ -497,86 +921,252 @@ KResult TCPSocket::close()
     return result;
 }
 
-static AK::Singleton<Lockable<HashTable<TCPSocket*>>> s_sockets_for_retransmit;
+struct TCPTimers {
+    // FIXME: Make this configurable (sysctl)
+    static constexpr Time tick_duration = Time::from_milliseconds(10);
+
+    Mutex lock { "TCPTimers" };
+    TimerWheel wheel { tick_duration, TimeManagement::the().monotonic_time() };
+    WaitQueue wait_queue;
+    // When the timer thread wakes up next, so that it only needs to be woken for timers that expire earlier.
+    Time wake_up_time { Time::max() };
+};
 
-Lockable<HashTable<TCPSocket*>>& TCPSocket::sockets_for_retransmit()
+static AK::Singleton<TCPTimers> s_timers;
+
+void TCPSocket::start_timer(Timer& timer, const Time& delay)
 {
-    return *s_sockets_for_retransmit;
+    MutexLocker locker(s_timers->lock);
+    if (timer.is_scheduled())
+        return;
+    locker.unlock();
+    restart_timer(timer, delay);
 }
 
-void TCPSocket::enqueue_for_retransmit()
+void TCPSocket::restart_timer(Timer& timer, const Time& delay)
 {
-    MutexLocker locker(sockets_for_retransmit().lock());
-    sockets_for_retransmit().resource().set(this);
+    MutexLocker locker(s_timers->lock);
+    s_timers->wheel.schedule(timer, delay);
+    if (TimeManagement::the().monotonic_time() + delay < s_timers->wake_up_time) {
+        s_timers->wake_up_time = Time::min();
+        s_timers->wait_queue.wake_all();
+    }
 }
 
-void TCPSocket::dequeue_for_retransmit()
+void TCPSocket::cancel_timer(Timer& timer)
 {
-    MutexLocker locker(sockets_for_retransmit().lock());
-    sockets_for_retransmit().resource().remove(this);
+    MutexLocker locker(s_timers->lock);
+    s_timers->wheel.cancel(timer);
 }
 
-void TCPSocket::retransmit_packets()
+void TCPSocket::handle_expired_timers()
 {
-    auto now = kgettimeofday();
+    struct ExpiredTimer {
+        NonnullRefPtr<TCPSocket> socket;
+        TimerType type;
+    };
+    Vector<ExpiredTimer, 16> expired_timers;
+    {
+        MutexLocker locker(s_timers->lock);
+        TimerWheelEntry::List expired;
+        s_timers->wheel.advance(TimeManagement::the().monotonic_time(), expired);
+        while (!expired.is_empty()) {
+            auto& timer = static_cast<Timer&>(*expired.first());
+            expired.remove(timer);
+            // The socket is already being destroyed, so its timers don't matter anymore.
+            if (!timer.socket.try_ref())
+                continue;
+            expired_timers.append({ adopt_ref(timer.socket), timer.type });
+        }
+    }
+
+    for (auto& timer : expired_timers) {
+        MutexLocker locker(timer.socket->lock());
+        timer.socket->handle_timer(timer.type);
+    }
+}
+
+void TCPSocket::wait_for_next_timer()
+{
+    Optional<Time> deadline;
+    {
+        MutexLocker locker(s_timers->lock);
+        deadline = s_timers->wheel.next_deadline();
+        s_timers->wake_up_time = deadline.value_or(Time::max());
+    }
+
+    if (!deadline.has_value()) {
+        [[maybe_unused]] auto result = s_timers->wait_queue.wait_on({}, "TCPTimers");
+        return;
+    }
+    Thread::BlockTimeout timeout { true, &deadline.value() };
+    [[maybe_unused]] auto result = s_timers->wait_queue.wait_on(timeout, "TCPTimers");
+}
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
+void TCPSocket::handle_timer(TimerType type)
+{
+    VERIFY(lock().is_locked());
+    switch (type) {
+    case TimerType::Retransmit:
+        retransmit_packets();
+        return;
+    case TimerType::DelayedAck: {
+        [[maybe_unused]] auto result = send_ack();
+        return;
+    }
+    case TimerType::TimeWait:
+        if (m_state == State::TimeWait)
+            set_state(State::Closed);
+        return;
+    case TimerType::Keepalive:
+        handle_keepalive_timer();
+        return;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void TCPSocket::schedule_delayed_ack()
+{
+    start_timer(m_delayed_ack_timer, delayed_ack_timeout);
+}
+
+Time TCPSocket::retransmit_interval() const
+{
+    // According to RFC1122 we must do exponential backoff - even for SYN packets.
+    auto interval = m_retransmission_timeout;
     for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+        interval += interval;
+    return interval;
+}
+
+void TCPSocket::update_retransmit_timer()
+{
+    restart_timer(m_retransmit_timer, m_last_retransmit_time + retransmit_interval() - kgettimeofday());
+}
+
+void TCPSocket::retransmit_packets()
+{
+    auto now = kgettimeofday();
 
-    if (m_last_retransmit_time > now - Time::from_seconds(retransmit_interval))
+    if (now < m_last_retransmit_time + retransmit_interval()) {
+        update_retransmit_timer();
         return;
+    }
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
     m_last_retransmit_time = now;
-    ++m_retransmit_attempts;
 
-    if (m_retransmit_attempts > maximum_retransmits) {
+    if (m_retransmit_attempts >= maximum_retransmits) {
         set_state(TCPSocket::State::Closed);
         set_error(TCPSocket::Error::RetransmitTimeout);
         set_setup_state(Socket::SetupState::Completed);
         return;
     }
 
-    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    if (routing_decision.is_zero())
+    MutexLocker locker(m_not_acked_lock);
+    if (m_not_acked.is_empty())
         return;
+    m_congestion_control->on_retransmit_timeout(bytes_in_flight(), m_retransmit_attempts);
+    ++m_retransmit_attempts;
+    m_duplicate_acks_received = 0;
 
-    MutexLocker locker(m_not_acked_lock, Mutex::Mode::Shared);
+    // Everything the peer hasn't told us about is presumed lost now, and gets retransmitted
+    // as the congestion window opens up again.
     for (auto& packet : m_not_acked) {
-        packet.tx_counter++;
-
-        if constexpr (TCP_SOCKET_DEBUG) {
-            auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
-            dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                local_address(), local_port(),
-                peer_address(), peer_port(),
-                (tcp_packet.has_syn() ? "SYN " : ""),
-                (tcp_packet.has_ack() ? "ACK " : ""),
-                (tcp_packet.has_fin() ? "FIN " : ""),
-                (tcp_packet.has_rst() ? "RST " : ""),
-                tcp_packet.sequence_number(),
-                tcp_packet.ack_number(),
-                packet.tx_counter);
-        }
+        if (!packet.sacked)
+            mark_packet_lost(packet);
+    }
+    retransmit_lost_packets();
+    update_retransmit_timer();
+}
 
-        size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-        if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-            // FIXME: Add support for this. This can happen if after a route change
-            // we ended up on another adapter which doesn't have the same layer 2 type
-            // like the previous adapter.
-            VERIFY_NOT_REACHED();
-        }
-        routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-            local_address(), routing_decision.next_hop, peer_address(),
-            IPv4Protocol::TCP, packet.buffer->buffer.size() - ipv4_payload_offset, ttl());
-        routing_decision.adapter->send_packet({ packet.buffer->buffer.data(), packet.buffer->buffer.size() });
-        m_packets_out++;
-        m_bytes_out += packet.buffer->buffer.size();
+void TCPSocket::update_keepalive_timer()
+{
+    if (wants_keepalive() && m_state == State::Established)
+        start_timer(m_keepalive_timer, keepalive_idle_time);
+    else
+        cancel_timer(m_keepalive_timer);
+}
+
+void TCPSocket::handle_keepalive_timer()
+{
+    if (!wants_keepalive() || m_state != State::Established)
+        return;
+
+    auto idle_time = kgettimeofday() - m_last_receive_time;
+    if (idle_time < keepalive_idle_time) {
+        m_keepalive_probes_sent = 0;
+        restart_timer(m_keepalive_timer, keepalive_idle_time - idle_time);
+        return;
+    }
+
+    if (m_keepalive_probes_sent >= maximum_keepalive_probes) {
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) peer did not answer {} keepalive probes", this, m_keepalive_probes_sent);
+        set_state(State::Closed);
+        set_error(Error::KeepaliveTimeout);
+        set_connected(false);
+        return;
+    }
+
+    // A keepalive probe is an ACK for data we have already sent, which the peer has to answer.
+    // If there is unacknowledged data, the retransmission timer takes care of this instead.
+    bool has_unacked_packets;
+    {
+        MutexLocker locker(m_not_acked_lock);
+        has_unacked_packets = !m_not_acked.is_empty();
+    }
+    if (!has_unacked_packets) {
+        --m_sequence_number;
+        [[maybe_unused]] auto result = send_tcp_packet(TCPFlags::ACK);
+        ++m_sequence_number;
+        ++m_keepalive_probes_sent;
+    }
+    restart_timer(m_keepalive_timer, keepalive_probe_interval);
+}
+
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    packet.tx_counter++;
+    m_retransmitted_packets++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
     }
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet.buffer->buffer.size() - ipv4_payload_offset, ttl());
+    routing_decision.adapter->send_packet(*packet.buffer);
+    m_packets_out++;
+    m_bytes_out += packet.buffer->buffer.size();
+}
+
+KResult TCPSocket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    auto result = IPv4Socket::setsockopt(level, option, user_value, user_value_size);
+    if (!result.is_error() && level == SOL_SOCKET && option == SO_KEEPALIVE) {
+        MutexLocker locker(lock());
+        update_keepalive_timer();
+    }
+    return result;
 }
 
 bool TCPSocket::can_write(const FileDescription& file_description, size_t size) const
@@ -587,11 +1177,12 @@ bool TCPSocket::can_write(const FileDescription& file_description, size_t size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
+    // Whatever is still in flight will never be acknowledged once the connection is closed.
+    if (m_state == State::Closed)
         return true;
 
     MutexLocker lock(m_not_acked_lock);
-    return m_not_acked_size + size <= m_send_window_size;
+    return can_send_segment();
 }
 
 }
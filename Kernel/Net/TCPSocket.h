@@ -12,6 +12,9 @@
 #include <AK/WeakPtr.h>
 #include <Kernel/KResult.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+#include <Kernel/Net/TimerWheel.h>
 
 namespace Kernel {
 
@@ -94,6 +97,7 @@ public:
         RSTDuringConnect,
         UnexpectedFlagsDuringConnect,
         RetransmitTimeout,
+        KeepaliveTimeout,
     };
 
     static const char* to_string(Error error)
@@ -107,6 +111,10 @@ public:
             return "RSTDuringConnect";
         case Error::UnexpectedFlagsDuringConnect:
             return "UnexpectedFlagsDuringConnect";
+        case Error::RetransmitTimeout:
+            return "RetransmitTimeout";
+        case Error::KeepaliveTimeout:
+            return "KeepaliveTimeout";
         default:
             return "Invalid";
         }
@@ -135,13 +143,31 @@ public:
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
     u32 duplicate_acks() const { return m_duplicate_acks; }
 
+    StringView congestion_control_name() const { return m_congestion_control->name(); }
+    u32 congestion_window() const { return m_congestion_control->congestion_window(); }
+    u32 slow_start_threshold() const { return m_congestion_control->slow_start_threshold(); }
+    u32 send_window_size() const { return m_send_window_size; }
+    u8 send_window_scale() const { return m_send_window_scale; }
+    u8 receive_window_scale() const { return m_receive_window_scale; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+    Time smoothed_round_trip_time() const { return m_smoothed_round_trip_time; }
+    Time retransmission_timeout() const { return m_retransmission_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+
     KResult send_ack(bool allow_duplicate = false);
     KResult send_tcp_packet(u16 flags, const UserOrKernelBuffer* = nullptr, size_t = 0, RoutingDecision* = nullptr);
+    // Sends up to count bytes of file, starting at offset. The data is read straight into the packet buffers.
+    KResultOr<size_t> send_file_data(FileDescription&, FileDescription& file, u64 offset, size_t count);
     void receive_tcp_packet(const TCPPacket&, u16 size);
+    void receive_syn_options(const TCPPacket&);
 
     bool should_delay_next_ack() const;
+    void schedule_delayed_ack();
 
-    static Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
+    // Connected sockets are found by their full tuple, listening ones by their local address and port.
+    // Several listeners are only allowed to share a port with SO_REUSEPORT.
+    static SocketTable<IPv4SocketTuple, TCPSocket*>& connected_sockets();
+    static SocketTable<IPv4SocketTuple, Vector<TCPSocket*, 1>>& listening_sockets();
     static RefPtr<TCPSocket> from_tuple(const IPv4SocketTuple& tuple);
 
     static Lockable<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& closing_sockets();
@@ -152,21 +178,25 @@ public:
     void release_to_originator();
     void release_for_accept(RefPtr<TCPSocket>);
 
-    static Lockable<HashTable<TCPSocket*>>& sockets_for_retransmit();
-    void retransmit_packets();
+    // All the timers of all sockets are kept in one timer wheel, which is driven by NetworkTask.
+    static void handle_expired_timers();
+    static void wait_for_next_timer();
 
     virtual KResult close() override;
 
     virtual bool can_write(const FileDescription&, size_t) const override;
 
+    virtual KResult setsockopt(int level, int option, Userspace<const void*>, socklen_t) override;
+
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol);
+    TCPSocket(int protocol, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"; }
 
     static NetworkOrdered<u16> compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket&, u16 payload_size);
+    static u16 compute_tcp_pseudo_header_sum(const IPv4Address& source, const IPv4Address& destination, u16 tcp_size);
 
     virtual void shut_down_for_writing() override;
 
@@ -178,8 +208,51 @@ private:
     virtual KResult protocol_bind() override;
     virtual KResult protocol_listen(bool did_allocate_port) override;
 
-    void enqueue_for_retransmit();
-    void dequeue_for_retransmit();
+    KResult add_to_socket_table(const IPv4SocketTuple&);
+    void remove_from_socket_table();
+
+    enum class TimerType {
+        Retransmit,
+        DelayedAck,
+        TimeWait,
+        Keepalive,
+    };
+
+    struct Timer : public TimerWheelEntry {
+        Timer(TCPSocket& socket, TimerType type)
+            : socket(socket)
+            , type(type)
+        {
+        }
+
+        TCPSocket& socket;
+        TimerType type;
+    };
+
+    void start_timer(Timer&, const Time& delay);
+    void restart_timer(Timer&, const Time& delay);
+    void cancel_timer(Timer&);
+    void handle_timer(TimerType);
+
+    Time retransmit_interval() const;
+    void update_retransmit_timer();
+    void retransmit_packets();
+    void update_keepalive_timer();
+    void handle_keepalive_timer();
+
+    KResult send_tcp_segment(u16 flags, size_t payload_size, RoutingDecision*, const Function<KResult(Bytes)>& write_payload);
+    KResultOr<size_t> next_segment_size(RoutingDecision&);
+
+    struct OutgoingPacket;
+    u16 advertised_window_size(bool is_syn) const;
+    size_t bytes_in_flight() const;
+    bool can_send_segment() const;
+    void receive_sack_blocks(const TCPPacket&);
+    void update_round_trip_time(const Time& sample);
+    void mark_first_unacked_packet_lost();
+    void mark_packet_lost(OutgoingPacket&);
+    void retransmit_lost_packets();
+    void retransmit_packet(OutgoingPacket&, RoutingDecision&);
 
     WeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullRefPtr<TCPSocket>> m_pending_release_for_accept;
@@ -195,28 +268,70 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
+        size_t payload_size { 0 };
         WeakPtr<NetworkAdapter> adapter;
+        Time sent_time;
         int tx_counter { 0 };
+        // The peer told us that it has received this packet, but it can't acknowledge it yet.
+        bool sacked { false };
+        // This packet has to be retransmitted as soon as the congestion window allows.
+        bool lost { false };
     };
 
     mutable Mutex m_not_acked_lock { "TCPSocket unacked packets" };
     SinglyLinkedList<OutgoingPacket> m_not_acked;
     size_t m_not_acked_size { 0 };
+    size_t m_sacked_size { 0 };
+    size_t m_lost_size { 0 };
+    size_t m_lost_packet_count { 0 };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
 
     u32 m_duplicate_acks { 0 };
+    u32 m_duplicate_acks_received { 0 };
 
     u32 m_last_ack_number_sent { 0 };
     Time m_last_ack_sent_time;
+    Time m_last_receive_time;
+
+    // FIXME: Make these configurable (sysctl)
+    static constexpr Time delayed_ack_timeout = Time::from_milliseconds(200);
+    static constexpr Time time_wait_timeout = Time::from_seconds(60);
+    static constexpr Time keepalive_idle_time = Time::from_seconds(2 * 60 * 60);
+    static constexpr Time keepalive_probe_interval = Time::from_seconds(75);
+    static constexpr u32 maximum_keepalive_probes = 9;
+    u32 m_keepalive_probes_sent { 0 };
+
+    Timer m_retransmit_timer { *this, TimerType::Retransmit };
+    Timer m_delayed_ack_timer { *this, TimerType::DelayedAck };
+    Timer m_time_wait_timer { *this, TimerType::TimeWait };
+    Timer m_keepalive_timer { *this, TimerType::Keepalive };
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
+    u32 m_retransmitted_packets { 0 };
+
+    // RFC 6298 round trip time estimation.
+    bool m_has_round_trip_time_sample { false };
+    Time m_smoothed_round_trip_time;
+    Time m_round_trip_time_variance;
+    Time m_retransmission_timeout { Time::from_seconds(1) };
+
+    u32 m_maximum_segment_size { NumericLimits<u16>::max() };
+
+    // Large enough to advertise all of the receive buffer of a socket.
+    static constexpr u8 offered_receive_window_scale = 3;
+    bool m_window_scaling { false };
+    u8 m_send_window_scale { 0 };
+    u8 m_receive_window_scale { 0 };
+    bool m_sack_permitted { false };
 
-    // FIXME: Parse window size TCP option from the peer
     u32 m_send_window_size { 64 * KiB };
 };
 
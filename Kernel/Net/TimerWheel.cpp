@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TimerWheel.h>
+
+namespace Kernel {
+
+TimerWheel::TimerWheel(const Time& tick_duration, const Time& now)
+    : m_tick_duration(tick_duration)
+    , m_start_time(now)
+{
+}
+
+void TimerWheel::schedule(TimerWheelEntry& entry, const Time& delay)
+{
+    if (entry.is_scheduled())
+        cancel(entry);
+
+    // Round up, so that a timer never fires early.
+    i64 tick_us = m_tick_duration.to_microseconds();
+    i64 delay_ticks = (delay.to_microseconds() + tick_us - 1) / tick_us;
+    entry.m_expiration_tick = m_current_tick + max<i64>(delay_ticks, 1);
+    insert(entry);
+    ++m_scheduled_count;
+}
+
+void TimerWheel::cancel(TimerWheelEntry& entry)
+{
+    if (!entry.is_scheduled())
+        return;
+    entry.m_list_node.remove();
+    --m_scheduled_count;
+}
+
+void TimerWheel::insert(TimerWheelEntry& entry)
+{
+    // Cascading can bring down timers that expire right at the current tick, which is about to be handled.
+    if (entry.m_expiration_tick <= m_current_tick) {
+        m_levels[0][m_current_tick & (slots_per_level - 1)].append(entry);
+        return;
+    }
+
+    // Timers beyond the range of the wheel are parked in the last slot it can reach,
+    // and are inserted again once that slot comes around.
+    u64 ticks = min(entry.m_expiration_tick - m_current_tick, maximum_ticks - 1);
+    u64 tick = m_current_tick + ticks;
+
+    size_t level = 0;
+    while (ticks >= (1ull << (slot_bits * (level + 1))))
+        ++level;
+    size_t slot = (tick >> (slot_bits * level)) & (slots_per_level - 1);
+    m_levels[level][slot].append(entry);
+}
+
+void TimerWheel::cascade(size_t level)
+{
+    size_t slot = (m_current_tick >> (slot_bits * level)) & (slots_per_level - 1);
+    auto& list = m_levels[level][slot];
+    while (!list.is_empty()) {
+        auto& entry = *list.first();
+        list.remove(entry);
+        insert(entry);
+    }
+}
+
+void TimerWheel::advance(const Time& now, TimerWheelEntry::List& expired)
+{
+    i64 elapsed_us = (now - m_start_time).to_microseconds();
+    u64 target_tick = elapsed_us / m_tick_duration.to_microseconds();
+
+    while (m_current_tick < target_tick) {
+        if (m_scheduled_count == 0) {
+            m_current_tick = target_tick;
+            return;
+        }
+
+        ++m_current_tick;
+
+        // Whenever a level has gone around once, the next slot of the level above is due.
+        for (size_t level = 1; level < level_count; ++level) {
+            if ((m_current_tick & ((1ull << (slot_bits * level)) - 1)) != 0)
+                break;
+            cascade(level);
+        }
+
+        auto& list = m_levels[0][m_current_tick & (slots_per_level - 1)];
+        while (!list.is_empty()) {
+            auto& entry = *list.first();
+            list.remove(entry);
+            if (entry.m_expiration_tick > m_current_tick) {
+                insert(entry);
+                continue;
+            }
+            --m_scheduled_count;
+            expired.append(entry);
+        }
+    }
+}
+
+Optional<Time> TimerWheel::next_deadline() const
+{
+    if (m_scheduled_count == 0)
+        return {};
+
+    // Look for the next occupied slot of the finest level. If there is none,
+    // the wheel has to be advanced once a level above is due.
+    u64 ticks = 1;
+    for (; ticks < slots_per_level; ++ticks) {
+        u64 tick = m_current_tick + ticks;
+        if (!m_levels[0][tick & (slots_per_level - 1)].is_empty())
+            break;
+        if ((tick & (slots_per_level - 1)) == 0)
+            break;
+    }
+    return m_start_time + Time::from_microseconds((m_current_tick + ticks) * m_tick_duration.to_microseconds());
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+class TimerWheelEntry {
+    friend class TimerWheel;
+
+public:
+    bool is_scheduled() const { return m_list_node.is_in_list(); }
+
+private:
+    u64 m_expiration_tick { 0 };
+    IntrusiveListNode<TimerWheelEntry> m_list_node;
+
+public:
+    using List = IntrusiveList<TimerWheelEntry, RawPtr<TimerWheelEntry>, &TimerWheelEntry::m_list_node>;
+};
+
+// A hierarchical timing wheel, which schedules and cancels timers in constant time and only
+// spends time on the timers that actually expire. Timers that are far out are kept in coarser
+// levels of the wheel, and are moved down to finer levels as their expiration comes closer.
+// NOTE: This does no locking of its own.
+class TimerWheel {
+public:
+    explicit TimerWheel(const Time& tick_duration, const Time& now);
+
+    void schedule(TimerWheelEntry&, const Time& delay);
+    void cancel(TimerWheelEntry&);
+
+    // Advances the wheel to now, and moves all the timers that have expired until then to expired.
+    void advance(const Time& now, TimerWheelEntry::List& expired);
+
+    // Returns the next time the wheel has to be advanced, or nothing if no timer is scheduled.
+    Optional<Time> next_deadline() const;
+
+    bool is_empty() const { return m_scheduled_count == 0; }
+
+private:
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t slots_per_level = 1 << slot_bits;
+    static constexpr size_t level_count = 4;
+    static constexpr u64 maximum_ticks = 1ull << (slot_bits * level_count);
+
+    using Level = Array<TimerWheelEntry::List, slots_per_level>;
+
+    void insert(TimerWheelEntry&);
+    void cascade(size_t level);
+
+    Array<Level, level_count> m_levels;
+    Time m_tick_duration;
+    Time m_start_time;
+    u64 m_current_tick { 0 };
+    size_t m_scheduled_count { 0 };
+};
+
+}
@@ -17,29 +17,34 @@ namespace Kernel {
 
 void UDPSocket::for_each(Function<void(const UDPSocket&)> callback)
 {
-    MutexLocker locker(sockets_by_port().lock(), Mutex::Mode::Shared);
-    for (auto it : sockets_by_port().resource())
-        callback(*it.value);
+    sockets_by_port().for_each_shared([&](auto, auto* socket) {
+        callback(*socket);
+    });
 }
 
-static AK::Singleton<Lockable<HashMap<u16, UDPSocket*>>> s_map;
+static AK::Singleton<SocketTable<u16, UDPSocket*>> s_map;
 
-Lockable<HashMap<u16, UDPSocket*>>& UDPSocket::sockets_by_port()
+SocketTable<u16, UDPSocket*>& UDPSocket::sockets_by_port()
 {
     return *s_map;
 }
 
-SocketHandle<UDPSocket> UDPSocket::from_port(u16 port)
+RefPtr<UDPSocket> UDPSocket::find_by_port(u16 port)
 {
-    RefPtr<UDPSocket> socket;
-    {
-        MutexLocker locker(sockets_by_port().lock(), Mutex::Mode::Shared);
-        auto it = sockets_by_port().resource().find(port);
-        if (it == sockets_by_port().resource().end())
+    return sockets_by_port().with_shared(port, [&](auto& table) -> RefPtr<UDPSocket> {
+        auto it = table.find(port);
+        if (it == table.end())
             return {};
-        socket = (*it).value;
-        VERIFY(socket);
-    }
+        VERIFY(it->value);
+        return *it->value;
+    });
+}
+
+SocketHandle<UDPSocket> UDPSocket::from_port(u16 port)
+{
+    auto socket = find_by_port(port);
+    if (!socket)
+        return {};
     return { *socket };
 }
 
@@ -50,8 +55,11 @@ UDPSocket::UDPSocket(int protocol)
 
 UDPSocket::~UDPSocket()
 {
-    MutexLocker locker(sockets_by_port().lock());
-    sockets_by_port().resource().remove(local_port());
+    sockets_by_port().with_exclusive(local_port(), [&](auto& table) {
+        auto it = table.find(local_port());
+        if (it != table.end() && it->value == this)
+            table.remove(it);
+    });
 }
 
 KResultOr<NonnullRefPtr<UDPSocket>> UDPSocket::create(int protocol)
@@ -112,12 +120,15 @@ KResultOr<u16> UDPSocket::protocol_allocate_local_port()
     constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    MutexLocker locker(sockets_by_port().lock());
     for (u16 port = first_scan_port;;) {
-        auto it = sockets_by_port().resource().find(port);
-        if (it == sockets_by_port().resource().end()) {
+        bool did_add = sockets_by_port().with_exclusive(port, [&](auto& table) {
+            if (table.contains(port))
+                return false;
+            table.set(port, this);
+            return true;
+        });
+        if (did_add) {
             set_local_port(port);
-            sockets_by_port().resource().set(port, this);
             return port;
         }
         ++port;
@@ -131,11 +142,12 @@ KResultOr<u16> UDPSocket::protocol_allocate_local_port()
 
 KResult UDPSocket::protocol_bind()
 {
-    MutexLocker locker(sockets_by_port().lock());
-    if (sockets_by_port().resource().contains(local_port()))
-        return EADDRINUSE;
-    sockets_by_port().resource().set(local_port(), this);
-    return KSuccess;
+    return sockets_by_port().with_exclusive(local_port(), [&](auto& table) -> KResult {
+        if (table.contains(local_port()))
+            return EADDRINUSE;
+        table.set(local_port(), this);
+        return KSuccess;
+    });
 }
 
 }
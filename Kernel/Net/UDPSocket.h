@@ -8,6 +8,7 @@
 
 #include <Kernel/KResult.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
 
 namespace Kernel {
 
@@ -17,12 +18,14 @@ public:
     virtual ~UDPSocket() override;
 
     static SocketHandle<UDPSocket> from_port(u16);
+    // Unlike from_port(), this doesn't lock the socket.
+    static RefPtr<UDPSocket> find_by_port(u16);
     static void for_each(Function<void(const UDPSocket&)>);
 
 private:
     explicit UDPSocket(int protocol);
     virtual StringView class_name() const override { return "UDPSocket"; }
-    static Lockable<HashMap<u16, UDPSocket*>>& sockets_by_port();
+    static SocketTable<u16, UDPSocket*>& sockets_by_port();
 
     virtual KResultOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual KResultOr<size_t> protocol_send(const UserOrKernelBuffer&, size_t) override;
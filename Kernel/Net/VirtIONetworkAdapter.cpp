@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MACAddress.h>
+#include <Kernel/Bus/PCI/IDs.h>
+#include <Kernel/CommandLine.h>
+#include <Kernel/Debug.h>
+#include <Kernel/IO.h>
+#include <Kernel/Net/VirtIONetworkAdapter.h>
+#include <Kernel/Process.h>
+#include <Kernel/Random.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT RefPtr<VirtIONetworkAdapter> VirtIONetworkAdapter::try_to_initialize(PCI::Address address)
+{
+    if (kernel_command_line().disable_virtio())
+        return {};
+    auto id = PCI::get_id(address);
+    if (id.vendor_id != PCI::VendorID::VirtIO || id.device_id != PCI::DeviceID::VirtIONetwork)
+        return {};
+    auto adapter = adopt_ref_if_nonnull(new (nothrow) VirtIONetworkAdapter(address));
+    if (!adapter)
+        return {};
+    if (adapter->initialize())
+        return adapter;
+    return {};
+}
+
+UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(PCI::Address address)
+    : VirtIODevice(address, "VirtIONetwork")
+{
+    set_interface_name(address);
+}
+
+UNMAP_AFTER_INIT VirtIONetworkAdapter::~VirtIONetworkAdapter()
+{
+}
+
+UNMAP_AFTER_INIT bool VirtIONetworkAdapter::initialize()
+{
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM))
+            negotiated |= VIRTIO_NET_F_CSUM;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MAC))
+            negotiated |= VIRTIO_NET_F_MAC;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_STATUS))
+            negotiated |= VIRTIO_NET_F_STATUS;
+        // The number of queue pairs in use can only be changed through the control queue.
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CTRL_VQ | VIRTIO_NET_F_MQ))
+            negotiated |= VIRTIO_NET_F_CTRL_VQ | VIRTIO_NET_F_MQ;
+        return negotiated;
+    });
+    if (!success)
+        return false;
+
+    auto* config = get_config(ConfigurationType::Device);
+    if (!config) {
+        dbgln("{}: Could not find device configuration", m_class_name);
+        return false;
+    }
+
+    MACAddress mac;
+    u16 device_queue_pair_count = 1;
+    read_config_atomic([&]() {
+        if (is_feature_accepted(VIRTIO_NET_F_MAC)) {
+            for (size_t i = 0; i < 6; i++)
+                mac[i] = config_read8(*config, i);
+        }
+        if (is_feature_accepted(VIRTIO_NET_F_MQ))
+            device_queue_pair_count = config_read16(*config, 0x8);
+    });
+    if (!is_feature_accepted(VIRTIO_NET_F_MAC)) {
+        // Make up a locally administered unicast address.
+        for (size_t i = 0; i < 6; i++)
+            mac[i] = get_fast_random<u8>();
+        mac[0] = (mac[0] & 0xfc) | 0x02;
+    }
+    set_mac_address(mac);
+    if (device_queue_pair_count == 0)
+        device_queue_pair_count = 1;
+
+    // The control queue comes after the queue pairs, of which we might only use some.
+    u16 queue_count = 2 * device_queue_pair_count;
+    if (is_feature_accepted(VIRTIO_NET_F_CTRL_VQ)) {
+        m_control_queue_index = queue_count;
+        queue_count++;
+    }
+    if (!setup_queues(queue_count))
+        return false;
+    m_queue_pair_count = clamp<size_t>(Processor::count(), 1, min<size_t>(device_queue_pair_count, max_queue_pair_count));
+
+    for (size_t pair_index = 0; pair_index < m_queue_pair_count; pair_index++) {
+        auto& pair = m_queue_pairs[pair_index];
+        pair.receive_buffer_count = min<size_t>(get_queue(receive_queue_index(pair_index)).size(), max_buffer_count);
+        pair.receive_buffers = MM.allocate_contiguous_kernel_region(page_round_up(pair.receive_buffer_count * buffer_size), "VirtIONetwork RX Buffers", Region::Access::Read | Region::Access::Write);
+        size_t transmit_buffer_count = min<size_t>(get_queue(transmit_queue_index(pair_index)).size(), max_buffer_count);
+        pair.transmit_buffers = MM.allocate_contiguous_kernel_region(page_round_up(transmit_buffer_count * buffer_size), "VirtIONetwork TX Buffers", Region::Access::Read | Region::Access::Write);
+        if (!pair.receive_buffers || !pair.transmit_buffers)
+            return false;
+        if (!pair.free_transmit_buffers.try_ensure_capacity(transmit_buffer_count))
+            return false;
+        for (size_t index = 0; index < transmit_buffer_count; index++)
+            pair.free_transmit_buffers.unchecked_append(index);
+
+        // Transmit queues are only checked for finished packets when sending another one, unless they are full.
+        auto& transmit_queue = get_queue(transmit_queue_index(pair_index));
+        {
+            ScopedSpinLock lock(transmit_queue.lock());
+            transmit_queue.disable_interrupts();
+        }
+
+        // The device mustn't be notified before it is ready, so only hand it the receive buffers for now.
+        auto& receive_queue = get_queue(receive_queue_index(pair_index));
+        ScopedSpinLock lock(receive_queue.lock());
+        for (size_t index = 0; index < pair.receive_buffer_count; index++) {
+            VirtIOQueueChain chain(receive_queue);
+            if (!chain.add_buffer_to_chain(buffer_address(*pair.receive_buffers, index), buffer_size, BufferType::DeviceWritable))
+                return false;
+            chain.submit_to_queue();
+        }
+    }
+
+    if (m_control_queue_index.has_value()) {
+        m_control_region = MM.allocate_kernel_region(PAGE_SIZE, "VirtIONetwork Control", Region::Access::Read | Region::Access::Write);
+        if (!m_control_region)
+            return false;
+    }
+
+    finish_init();
+
+    if (m_queue_pair_count > 1 && !set_queue_pair_count(m_queue_pair_count)) {
+        dbgln("{}: Failed to use {} queue pairs, falling back to one", m_class_name, m_queue_pair_count);
+        m_queue_pair_count = 1;
+    }
+
+    for (size_t pair_index = 0; pair_index < m_queue_pair_count; pair_index++) {
+        start_receive_thread(pair_index);
+        auto& receive_queue = get_queue(receive_queue_index(pair_index));
+        ScopedSpinLock lock(receive_queue.lock());
+        notify_queue_if_needed(receive_queue_index(pair_index));
+    }
+
+    dmesgln("{}: MAC address: {}, Queue pairs: {}{}", m_class_name, mac.to_string(), m_queue_pair_count, is_feature_accepted(VIRTIO_NET_F_CSUM) ? ", checksum offload" : "");
+    if (is_feature_accepted(VIRTIO_NET_F_CSUM))
+        set_offloads(Offloads::TransmitChecksum);
+    return true;
+}
+
+UNMAP_AFTER_INIT bool VirtIONetworkAdapter::set_queue_pair_count(u16 count)
+{
+    VERIFY(m_control_queue_index.has_value());
+    auto control_queue_index = m_control_queue_index.value();
+    auto& queue = get_queue(control_queue_index);
+    auto& command = *reinterpret_cast<volatile ControlCommand*>(m_control_region->vaddr().as_ptr());
+    command.command_class = VIRTIO_NET_CTRL_MQ;
+    command.command = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+    command.data = count;
+    command.ack = 0xff;
+
+    auto address = m_control_region->physical_page(0)->paddr();
+    {
+        ScopedSpinLock lock(queue.lock());
+        // We wait for the command right here, so there is no need to be interrupted about it.
+        queue.disable_interrupts();
+        VirtIOQueueChain chain(queue);
+        bool success = chain.add_buffer_to_chain(address, 2 * sizeof(u8), BufferType::DeviceReadable);
+        if (success)
+            success = chain.add_buffer_to_chain(address.offset(2 * sizeof(u8)), sizeof(u16), BufferType::DeviceReadable);
+        if (success)
+            success = chain.add_buffer_to_chain(address.offset(2 * sizeof(u8) + sizeof(u16)), sizeof(u8), BufferType::DeviceWritable);
+        if (!success) {
+            chain.release_buffer_slots_to_queue();
+            return false;
+        }
+        supply_chain_and_notify(control_queue_index, chain);
+    }
+
+    for (size_t attempt = 0; attempt < 1000; attempt++) {
+        {
+            ScopedSpinLock lock(queue.lock());
+            size_t used;
+            auto chain = queue.pop_used_buffer_chain(used);
+            if (!chain.is_empty()) {
+                chain.release_buffer_slots_to_queue();
+                return command.ack == VIRTIO_NET_CTRL_OK;
+            }
+        }
+        IO::delay(100);
+    }
+    dbgln("{}: Timed out waiting for a control command", m_class_name);
+    return false;
+}
+
+UNMAP_AFTER_INIT void VirtIONetworkAdapter::start_receive_thread(size_t pair_index)
+{
+    // Spread the queue pairs across the processors.
+    u32 affinity = pair_index < Processor::count() ? (1u << pair_index) : THREAD_AFFINITY_DEFAULT;
+    RefPtr<Thread> thread;
+    Process::create_kernel_process(thread, String::formatted("VirtIONetwork RX #{}", pair_index), [this, pair_index] {
+        receive_thread_main(pair_index);
+    },
+        affinity);
+    VERIFY(thread);
+}
+
+size_t VirtIONetworkAdapter::buffer_index(const Region& region, PhysicalAddress address)
+{
+    auto index = (address.get() - region.physical_page(0)->paddr().get()) / buffer_size;
+    VERIFY(index < region.size() / buffer_size);
+    return index;
+}
+
+PhysicalAddress VirtIONetworkAdapter::buffer_address(const Region& region, size_t index)
+{
+    // NOTE: The buffers are physically contiguous.
+    return region.physical_page(0)->paddr().offset(index * buffer_size);
+}
+
+bool VirtIONetworkAdapter::link_up()
+{
+    if (!is_feature_accepted(VIRTIO_NET_F_STATUS))
+        return true;
+    auto* config = get_config(ConfigurationType::Device);
+    VERIFY(config);
+    return config_read16(*config, 0x6) & VIRTIO_NET_S_LINK_UP;
+}
+
+bool VirtIONetworkAdapter::handle_device_config_change()
+{
+    // NOTE: The link status is read whenever it is asked for, and nothing else in the configuration changes.
+    return true;
+}
+
+void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
+{
+    if (m_control_queue_index.has_value() && queue_index == m_control_queue_index.value())
+        return;
+    size_t pair_index = queue_index / 2;
+    if (pair_index >= m_queue_pair_count)
+        return;
+    auto& queue = get_queue(queue_index);
+    {
+        ScopedSpinLock lock(queue.lock());
+        // Whoever gets woken up takes it from here, and turns interrupts back on once it has caught up.
+        queue.disable_interrupts();
+    }
+    auto& pair = m_queue_pairs[pair_index];
+    if (queue_index == receive_queue_index(pair_index))
+        pair.receive_wait_queue.wake_one();
+    else
+        pair.transmit_wait_queue.wake_all();
+}
+
+void VirtIONetworkAdapter::receive_thread_main(size_t pair_index)
+{
+    auto& pair = m_queue_pairs[pair_index];
+    auto& queue = get_queue(receive_queue_index(pair_index));
+    for (;;) {
+        pair.receive_wait_queue.wait_forever("VirtIONetworkAdapter");
+        // As long as packets keep coming in, poll the queue instead of taking an interrupt for each of them.
+        for (;;) {
+            if (receive(pair_index, receive_budget) == receive_budget) {
+                Scheduler::yield();
+                continue;
+            }
+            ScopedSpinLock lock(queue.lock());
+            queue.enable_interrupts();
+            full_memory_barrier();
+            // A packet arriving right before interrupts were enabled again didn't raise one, so look once more.
+            if (!queue.new_data_available())
+                break;
+            queue.disable_interrupts();
+        }
+    }
+}
+
+size_t VirtIONetworkAdapter::receive(size_t pair_index, size_t budget)
+{
+    auto& pair = m_queue_pairs[pair_index];
+    auto queue_index = receive_queue_index(pair_index);
+    auto& queue = get_queue(queue_index);
+    ScopedSpinLock lock(queue.lock());
+    size_t received = 0;
+    while (received < budget) {
+        size_t used;
+        auto chain = queue.pop_used_buffer_chain(used);
+        if (chain.is_empty())
+            break;
+        PhysicalAddress address;
+        chain.for_each([&](PhysicalAddress buffer_address, size_t) {
+            address = buffer_address;
+        });
+        chain.release_buffer_slots_to_queue();
+        received++;
+
+        auto* buffer = pair.receive_buffers->vaddr().offset(buffer_index(*pair.receive_buffers, address) * buffer_size).as_ptr();
+        if (used > sizeof(VirtIONetHeader) && used <= buffer_size) {
+            dbgln_if(VIRTIO_DEBUG, "{}: Received 1 packet on queue pair {} ({} bytes)", m_class_name, pair_index, used - sizeof(VirtIONetHeader));
+            did_receive({ buffer + sizeof(VirtIONetHeader), used - sizeof(VirtIONetHeader) });
+        }
+
+        // did_receive() has copied the packet, so the buffer can go back to the device right away.
+        VirtIOQueueChain refill(queue);
+        bool success = refill.add_buffer_to_chain(address, buffer_size, BufferType::DeviceWritable);
+        VERIFY(success);
+        refill.submit_to_queue();
+    }
+    // The device is told about all of the buffers that were handed back at once.
+    if (received > 0)
+        notify_queue_if_needed(queue_index);
+    return received;
+}
+
+void VirtIONetworkAdapter::reclaim_transmit_buffers(size_t pair_index)
+{
+    auto& pair = m_queue_pairs[pair_index];
+    auto& queue = get_queue(transmit_queue_index(pair_index));
+    VERIFY(queue.lock().is_locked());
+    size_t used;
+    for (auto chain = queue.pop_used_buffer_chain(used); !chain.is_empty(); chain = queue.pop_used_buffer_chain(used)) {
+        chain.for_each([&](PhysicalAddress address, size_t) {
+            pair.free_transmit_buffers.unchecked_append(buffer_index(*pair.transmit_buffers, address));
+        });
+        chain.release_buffer_slots_to_queue();
+    }
+}
+
+void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    transmit(payload, {});
+}
+
+void VirtIONetworkAdapter::send_raw_with_checksum_offload(ReadonlyBytes payload, ChecksumOffload checksum_offload)
+{
+    transmit(payload, checksum_offload);
+}
+
+void VirtIONetworkAdapter::transmit(ReadonlyBytes payload, Optional<ChecksumOffload> checksum_offload)
+{
+    VERIFY(sizeof(VirtIONetHeader) + payload.size() <= buffer_size);
+    // Every processor sends through a queue pair of its own, if there are enough of them.
+    size_t pair_index = Processor::id() % m_queue_pair_count;
+    auto& pair = m_queue_pairs[pair_index];
+    auto queue_index = transmit_queue_index(pair_index);
+    auto& queue = get_queue(queue_index);
+    for (;;) {
+        {
+            ScopedSpinLock lock(queue.lock());
+            reclaim_transmit_buffers(pair_index);
+            if (!pair.free_transmit_buffers.is_empty()) {
+                auto index = pair.free_transmit_buffers.take_last();
+                auto* buffer = pair.transmit_buffers->vaddr().offset(index * buffer_size).as_ptr();
+                auto& header = *reinterpret_cast<VirtIONetHeader*>(buffer);
+                memset(&header, 0, sizeof(header));
+                header.gso_type = VIRTIO_NET_HDR_GSO_NONE;
+                if (checksum_offload.has_value()) {
+                    header.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+                    header.checksum_start = checksum_offload->start;
+                    header.checksum_offset = checksum_offload->offset - checksum_offload->start;
+                }
+                memcpy(buffer + sizeof(VirtIONetHeader), payload.data(), payload.size());
+                dbgln_if(VIRTIO_DEBUG, "{}: Sending packet on queue pair {} ({} bytes)", m_class_name, pair_index, payload.size());
+
+                VirtIOQueueChain chain(queue);
+                bool success = chain.add_buffer_to_chain(buffer_address(*pair.transmit_buffers, index), sizeof(VirtIONetHeader) + payload.size(), BufferType::DeviceReadable);
+                VERIFY(success);
+                supply_chain_and_notify(queue_index, chain);
+                return;
+            }
+            // Every buffer is in flight, so let the device tell us once it is done with one of them.
+            queue.enable_interrupts();
+            full_memory_barrier();
+            if (queue.new_data_available()) {
+                queue.disable_interrupts();
+                continue;
+            }
+        }
+        pair.transmit_wait_queue.wait_forever("VirtIONetworkAdapter");
+    }
+}
+
+}
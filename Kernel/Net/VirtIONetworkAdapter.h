@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/VirtIO/VirtIO.h>
+#include <Kernel/WaitQueue.h>
+
+#define VIRTIO_NET_F_CSUM (1 << 0)
+#define VIRTIO_NET_F_MAC (1 << 5)
+#define VIRTIO_NET_F_STATUS (1 << 16)
+#define VIRTIO_NET_F_CTRL_VQ (1 << 17)
+#define VIRTIO_NET_F_MQ (1 << 22)
+
+#define VIRTIO_NET_S_LINK_UP (1 << 0)
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM (1 << 0)
+#define VIRTIO_NET_HDR_GSO_NONE 0
+
+#define VIRTIO_NET_CTRL_OK 0
+#define VIRTIO_NET_CTRL_MQ 4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+namespace Kernel {
+
+class VirtIONetworkAdapter final : public NetworkAdapter
+    , public VirtIODevice {
+public:
+    static RefPtr<VirtIONetworkAdapter> try_to_initialize(PCI::Address);
+    virtual ~VirtIONetworkAdapter() override;
+
+    virtual StringView purpose() const override { return class_name(); }
+    virtual StringView class_name() const override { return "VirtIONetworkAdapter"sv; }
+
+    virtual bool link_up() override;
+
+    // Every queue pair gets a receive thread; the packets of each queue pair are received on a processor of its own.
+    static constexpr size_t max_queue_pair_count = 8;
+    // A receive thread handles at most this many packets before giving other threads a chance to run.
+    static constexpr size_t receive_budget = 64;
+    static constexpr size_t max_buffer_count = 128;
+    static constexpr size_t buffer_size = 2 * KiB;
+
+private:
+    struct [[gnu::packed]] VirtIONetHeader {
+        u8 flags;
+        u8 gso_type;
+        u16 header_length;
+        u16 gso_size;
+        u16 checksum_start;
+        u16 checksum_offset;
+        u16 buffer_count;
+    };
+    static_assert(sizeof(VirtIONetHeader) == 12);
+
+    struct [[gnu::packed]] ControlCommand {
+        u8 command_class;
+        u8 command;
+        u16 data;
+        u8 ack;
+    };
+
+    struct QueuePair {
+        OwnPtr<Region> receive_buffers;
+        OwnPtr<Region> transmit_buffers;
+        size_t receive_buffer_count { 0 };
+        // These are guarded by the lock of the transmit queue.
+        Vector<u16> free_transmit_buffers;
+        WaitQueue receive_wait_queue;
+        WaitQueue transmit_wait_queue;
+    };
+
+    explicit VirtIONetworkAdapter(PCI::Address);
+    bool initialize();
+
+    static u16 receive_queue_index(size_t pair_index) { return 2 * pair_index; }
+    static u16 transmit_queue_index(size_t pair_index) { return 2 * pair_index + 1; }
+    static size_t buffer_index(const Region&, PhysicalAddress);
+    static PhysicalAddress buffer_address(const Region&, size_t index);
+
+    bool set_queue_pair_count(u16 count);
+    void start_receive_thread(size_t pair_index);
+    [[noreturn]] void receive_thread_main(size_t pair_index);
+    size_t receive(size_t pair_index, size_t budget);
+    void reclaim_transmit_buffers(size_t pair_index);
+    void transmit(ReadonlyBytes, Optional<ChecksumOffload>);
+
+    // ^VirtIODevice
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    // ^NetworkAdapter
+    virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_checksum_offload(ReadonlyBytes, ChecksumOffload) override;
+
+    Array<QueuePair, max_queue_pair_count> m_queue_pairs;
+    size_t m_queue_pair_count { 0 };
+    Optional<u16> m_control_queue_index;
+    OwnPtr<Region> m_control_region;
+};
+
+}
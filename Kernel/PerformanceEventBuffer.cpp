@@ -15,9 +15,19 @@
 
 namespace Kernel {
 
-PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer)
+PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer, size_t ring_count)
     : m_buffer(move(buffer))
+    , m_rings(ring_count)
 {
+    auto slots_per_ring = m_buffer->size() / sizeof(Slot) / ring_count;
+    auto* slots = reinterpret_cast<Slot*>(m_buffer->data());
+    for (size_t i = 0; i < ring_count; ++i) {
+        auto& ring = m_rings[i];
+        ring.slots = slots + i * slots_per_ring;
+        ring.capacity = slots_per_ring;
+        for (size_t j = 0; j < slots_per_ring; ++j)
+            new (&ring.slots[j]) Slot;
+    }
 }
 
 NEVER_INLINE KResult PerformanceEventBuffer::append(int type, FlatPtr arg1, FlatPtr arg2, const StringView& arg3, Thread* current_thread)
@@ -57,9 +67,6 @@ static Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(Fl
 KResult PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID tid,
     FlatPtr ip, FlatPtr bp, int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, const StringView& arg3)
 {
-    if (count() >= capacity())
-        return ENOBUFS;
-
     if ((g_profiling_event_mask & type) == 0)
         return EINVAL;
 
@@ -133,7 +140,16 @@ KResult PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID ti
         event.data.kfree.size = arg1;
         event.data.kfree.ptr = arg2;
         break;
+    case PERF_EVENT_BLOCK:
+    case PERF_EVENT_UNBLOCK:
+        event.data.block.blocker_type = arg1;
+        event.data.block.blocked_time = arg2;
+        break;
     case PERF_EVENT_PAGE_FAULT:
+    case PERF_EVENT_CPU_CYCLES:
+    case PERF_EVENT_INSTRUCTIONS:
+    case PERF_EVENT_CACHE_MISSES:
+    case PERF_EVENT_BRANCH_MISSES:
         break;
     default:
         return EINVAL;
@@ -146,15 +162,209 @@ KResult PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID ti
     event.pid = pid.value();
     event.tid = tid.value();
     event.timestamp = TimeManagement::the().uptime_ms();
-    at(m_count++) = event;
+
+    // Reserve a slot in the ring of this processor. We might get preempted and migrated to another processor
+    // in the meantime, or interrupted by a sample on this one, so this has to be atomic nonetheless.
+    auto& ring = ring_for_current_processor();
+    auto position = ring.tail.load(AK::MemoryOrder::memory_order_relaxed);
+    do {
+        if (position - ring.head.load(AK::MemoryOrder::memory_order_acquire) >= ring.capacity) {
+            ring.lost_events.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            return ENOBUFS;
+        }
+    } while (!ring.tail.compare_exchange_strong(position, position + 1, AK::MemoryOrder::memory_order_acq_rel));
+
+    auto& slot = ring.slots[position % ring.capacity];
+    slot.precise_timestamp_ns = TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds();
+    slot.event = event;
+    slot.sequence.store(position + 1, AK::MemoryOrder::memory_order_release);
     return KSuccess;
 }
 
-PerformanceEvent& PerformanceEventBuffer::at(size_t index)
+void PerformanceEventBuffer::clear()
+{
+    // NOTE: This doesn't take m_read_lock, as it's called with preemption disabled when profiling is (re-)enabled.
+    for (auto& ring : m_rings)
+        ring.head.store(ring.tail.load(AK::MemoryOrder::memory_order_acquire), AK::MemoryOrder::memory_order_release);
+    m_streamed_first_sample = false;
+}
+
+size_t PerformanceEventBuffer::capacity() const
+{
+    size_t capacity = 0;
+    for (auto& ring : m_rings)
+        capacity += ring.capacity;
+    return capacity;
+}
+
+size_t PerformanceEventBuffer::count() const
 {
-    VERIFY(index < capacity());
-    auto* events = reinterpret_cast<PerformanceEvent*>(m_buffer->data());
-    return events[index];
+    size_t count = 0;
+    for (auto& ring : m_rings)
+        count += ring.tail.load(AK::MemoryOrder::memory_order_relaxed) - ring.head.load(AK::MemoryOrder::memory_order_relaxed);
+    return count;
+}
+
+size_t PerformanceEventBuffer::lost_event_count() const
+{
+    size_t count = 0;
+    for (auto& ring : m_rings)
+        count += ring.lost_events.load(AK::MemoryOrder::memory_order_relaxed);
+    return count;
+}
+
+template<typename Callback>
+void PerformanceEventBuffer::for_each_event_in_order(Callback callback)
+{
+    VERIFY(m_read_lock.is_locked());
+
+    Vector<size_t, 16> cursors;
+    for (auto& ring : m_rings)
+        cursors.append(ring.head.load(AK::MemoryOrder::memory_order_acquire));
+
+    for (;;) {
+        Slot* next_slot = nullptr;
+        size_t next_ring_index = 0;
+        for (size_t i = 0; i < m_rings.size(); ++i) {
+            auto& ring = m_rings[i];
+            auto& slot = ring.slots[cursors[i] % ring.capacity];
+            // Either this ring has no more events, or the next one hasn't been completely written yet.
+            if (slot.sequence.load(AK::MemoryOrder::memory_order_acquire) != cursors[i] + 1)
+                continue;
+            if (!next_slot || slot.precise_timestamp_ns < next_slot->precise_timestamp_ns) {
+                next_slot = &slot;
+                next_ring_index = i;
+            }
+        }
+        if (!next_slot)
+            return;
+        if (callback(next_slot->event, m_rings[next_ring_index]) == IterationDecision::Break)
+            return;
+        ++cursors[next_ring_index];
+    }
+}
+
+static StringView blocker_type_name(u32 blocker_type)
+{
+    switch (static_cast<Thread::Blocker::Type>(blocker_type)) {
+    case Thread::Blocker::Type::File:
+        return "file"sv;
+    case Thread::Blocker::Type::Futex:
+        return "futex"sv;
+    case Thread::Blocker::Type::Plan9FS:
+        return "plan9fs"sv;
+    case Thread::Blocker::Type::Join:
+        return "join"sv;
+    case Thread::Blocker::Type::Queue:
+        return "queue"sv;
+    case Thread::Blocker::Type::Routing:
+        return "routing"sv;
+    case Thread::Blocker::Type::Sleep:
+        return "sleep"sv;
+    case Thread::Blocker::Type::Wait:
+        return "wait"sv;
+    default:
+        return "unknown"sv;
+    }
+}
+
+template<typename Serializer>
+void PerformanceEventBuffer::serialize_event(Serializer& event_object, const PerformanceEvent& event, bool& seen_first_sample)
+{
+    switch (event.type) {
+    case PERF_EVENT_SAMPLE:
+        event_object.add("type", "sample");
+        break;
+    case PERF_EVENT_MALLOC:
+        event_object.add("type", "malloc");
+        event_object.add("ptr", static_cast<u64>(event.data.malloc.ptr));
+        event_object.add("size", static_cast<u64>(event.data.malloc.size));
+        break;
+    case PERF_EVENT_FREE:
+        event_object.add("type", "free");
+        event_object.add("ptr", static_cast<u64>(event.data.free.ptr));
+        break;
+    case PERF_EVENT_MMAP:
+        event_object.add("type", "mmap");
+        event_object.add("ptr", static_cast<u64>(event.data.mmap.ptr));
+        event_object.add("size", static_cast<u64>(event.data.mmap.size));
+        event_object.add("name", event.data.mmap.name);
+        break;
+    case PERF_EVENT_MUNMAP:
+        event_object.add("type", "munmap");
+        event_object.add("ptr", static_cast<u64>(event.data.munmap.ptr));
+        event_object.add("size", static_cast<u64>(event.data.munmap.size));
+        break;
+    case PERF_EVENT_PROCESS_CREATE:
+        event_object.add("type", "process_create");
+        event_object.add("parent_pid", static_cast<u64>(event.data.process_create.parent_pid));
+        event_object.add("executable", event.data.process_create.executable);
+        break;
+    case PERF_EVENT_PROCESS_EXEC:
+        event_object.add("type", "process_exec");
+        event_object.add("executable", event.data.process_exec.executable);
+        break;
+    case PERF_EVENT_PROCESS_EXIT:
+        event_object.add("type", "process_exit");
+        break;
+    case PERF_EVENT_THREAD_CREATE:
+        event_object.add("type", "thread_create");
+        event_object.add("parent_tid", static_cast<u64>(event.data.thread_create.parent_tid));
+        break;
+    case PERF_EVENT_THREAD_EXIT:
+        event_object.add("type", "thread_exit");
+        break;
+    case PERF_EVENT_CONTEXT_SWITCH:
+        event_object.add("type", "context_switch");
+        event_object.add("next_pid", static_cast<u64>(event.data.context_switch.next_pid));
+        event_object.add("next_tid", static_cast<u64>(event.data.context_switch.next_tid));
+        break;
+    case PERF_EVENT_KMALLOC:
+        event_object.add("type", "kmalloc");
+        event_object.add("ptr", static_cast<u64>(event.data.kmalloc.ptr));
+        event_object.add("size", static_cast<u64>(event.data.kmalloc.size));
+        break;
+    case PERF_EVENT_KFREE:
+        event_object.add("type", "kfree");
+        event_object.add("ptr", static_cast<u64>(event.data.kfree.ptr));
+        event_object.add("size", static_cast<u64>(event.data.kfree.size));
+        break;
+    case PERF_EVENT_PAGE_FAULT:
+        event_object.add("type", "page_fault");
+        break;
+    case PERF_EVENT_CPU_CYCLES:
+        event_object.add("type", "cpu_cycles");
+        break;
+    case PERF_EVENT_INSTRUCTIONS:
+        event_object.add("type", "instructions");
+        break;
+    case PERF_EVENT_CACHE_MISSES:
+        event_object.add("type", "cache_misses");
+        break;
+    case PERF_EVENT_BRANCH_MISSES:
+        event_object.add("type", "branch_misses");
+        break;
+    case PERF_EVENT_BLOCK:
+        event_object.add("type", "block");
+        event_object.add("blocker", blocker_type_name(event.data.block.blocker_type));
+        break;
+    case PERF_EVENT_UNBLOCK:
+        event_object.add("type", "unblock");
+        event_object.add("blocker", blocker_type_name(event.data.block.blocker_type));
+        event_object.add("blocked_time", event.data.block.blocked_time);
+        break;
+    }
+    event_object.add("pid", event.pid);
+    event_object.add("tid", event.tid);
+    event_object.add("timestamp", event.timestamp);
+    event_object.add("lost_samples", seen_first_sample ? event.lost_samples : 0);
+    if (event.type == PERF_EVENT_SAMPLE)
+        seen_first_sample = true;
+    auto stack_array = event_object.add_array("stack");
+    for (size_t j = 0; j < event.stack_size; ++j) {
+        stack_array.add(event.stack[j]);
+    }
+    stack_array.finish();
 }
 
 template<typename Serializer>
@@ -162,101 +372,57 @@ bool PerformanceEventBuffer::to_json_impl(Serializer& object) const
 {
     auto array = object.add_array("events");
     bool seen_first_sample = false;
-    for (size_t i = 0; i < m_count; ++i) {
-        auto& event = at(i);
+    const_cast<PerformanceEventBuffer&>(*this).for_each_event_in_order([&](auto& event, auto&) {
         auto event_object = array.add_object();
-        switch (event.type) {
-        case PERF_EVENT_SAMPLE:
-            event_object.add("type", "sample");
-            break;
-        case PERF_EVENT_MALLOC:
-            event_object.add("type", "malloc");
-            event_object.add("ptr", static_cast<u64>(event.data.malloc.ptr));
-            event_object.add("size", static_cast<u64>(event.data.malloc.size));
-            break;
-        case PERF_EVENT_FREE:
-            event_object.add("type", "free");
-            event_object.add("ptr", static_cast<u64>(event.data.free.ptr));
-            break;
-        case PERF_EVENT_MMAP:
-            event_object.add("type", "mmap");
-            event_object.add("ptr", static_cast<u64>(event.data.mmap.ptr));
-            event_object.add("size", static_cast<u64>(event.data.mmap.size));
-            event_object.add("name", event.data.mmap.name);
-            break;
-        case PERF_EVENT_MUNMAP:
-            event_object.add("type", "munmap");
-            event_object.add("ptr", static_cast<u64>(event.data.munmap.ptr));
-            event_object.add("size", static_cast<u64>(event.data.munmap.size));
-            break;
-        case PERF_EVENT_PROCESS_CREATE:
-            event_object.add("type", "process_create");
-            event_object.add("parent_pid", static_cast<u64>(event.data.process_create.parent_pid));
-            event_object.add("executable", event.data.process_create.executable);
-            break;
-        case PERF_EVENT_PROCESS_EXEC:
-            event_object.add("type", "process_exec");
-            event_object.add("executable", event.data.process_exec.executable);
-            break;
-        case PERF_EVENT_PROCESS_EXIT:
-            event_object.add("type", "process_exit");
-            break;
-        case PERF_EVENT_THREAD_CREATE:
-            event_object.add("type", "thread_create");
-            event_object.add("parent_tid", static_cast<u64>(event.data.thread_create.parent_tid));
-            break;
-        case PERF_EVENT_THREAD_EXIT:
-            event_object.add("type", "thread_exit");
-            break;
-        case PERF_EVENT_CONTEXT_SWITCH:
-            event_object.add("type", "context_switch");
-            event_object.add("next_pid", static_cast<u64>(event.data.context_switch.next_pid));
-            event_object.add("next_tid", static_cast<u64>(event.data.context_switch.next_tid));
-            break;
-        case PERF_EVENT_KMALLOC:
-            event_object.add("type", "kmalloc");
-            event_object.add("ptr", static_cast<u64>(event.data.kmalloc.ptr));
-            event_object.add("size", static_cast<u64>(event.data.kmalloc.size));
-            break;
-        case PERF_EVENT_KFREE:
-            event_object.add("type", "kfree");
-            event_object.add("ptr", static_cast<u64>(event.data.kfree.ptr));
-            event_object.add("size", static_cast<u64>(event.data.kfree.size));
-            break;
-        case PERF_EVENT_PAGE_FAULT:
-            event_object.add("type", "page_fault");
-            break;
-        }
-        event_object.add("pid", event.pid);
-        event_object.add("tid", event.tid);
-        event_object.add("timestamp", event.timestamp);
-        event_object.add("lost_samples", seen_first_sample ? event.lost_samples : 0);
-        if (event.type == PERF_EVENT_SAMPLE)
-            seen_first_sample = true;
-        auto stack_array = event_object.add_array("stack");
-        for (size_t j = 0; j < event.stack_size; ++j) {
-            stack_array.add(event.stack[j]);
-        }
-        stack_array.finish();
+        serialize_event(event_object, event, seen_first_sample);
         event_object.finish();
-    }
+        return IterationDecision::Continue;
+    });
     array.finish();
+    object.add("lost_events", static_cast<u64>(lost_event_count()));
     object.finish();
     return true;
 }
 
 bool PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
 {
+    MutexLocker locker(m_read_lock);
     JsonObjectSerializer object(builder);
     return to_json_impl(object);
 }
 
+KResultOr<size_t> PerformanceEventBuffer::read_events(UserOrKernelBuffer& buffer, size_t size)
+{
+    if (size < max_serialized_event_size)
+        return EINVAL;
+
+    MutexLocker locker(m_read_lock);
+    StringBuilder builder;
+    for_each_event_in_order([&](auto& event, auto& ring) {
+        if (builder.length() + max_serialized_event_size > size)
+            return IterationDecision::Break;
+        JsonObjectSerializer event_object { builder };
+        serialize_event(event_object, event, m_streamed_first_sample);
+        event_object.finish();
+        builder.append('\n');
+        ring.head.fetch_add(1, AK::MemoryOrder::memory_order_release);
+        return IterationDecision::Continue;
+    });
+
+    if (!buffer.write(builder.string_view().characters_without_null_termination(), builder.length()))
+        return EFAULT;
+    return builder.length();
+}
+
 OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size)
 {
+    auto ring_count = Processor::count();
+    if (buffer_size / sizeof(Slot) < ring_count)
+        return {};
     auto buffer = KBuffer::try_create_with_size(buffer_size, Region::Access::Read | Region::Access::Write, "Performance events", AllocationStrategy::AllocateNow);
     if (!buffer)
         return {};
-    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer.release_nonnull()));
+    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer.release_nonnull(), ring_count));
 }
 
 void PerformanceEventBuffer::add_process(const Process& process, ProcessEventType event_type)
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
+#include <AK/FixedArray.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/KResult.h>
+#include <Kernel/Mutex.h>
 
 namespace Kernel {
 
@@ -62,8 +65,14 @@ struct [[gnu::packed]] KFreePerformanceEvent {
     FlatPtr ptr;
 };
 
+struct [[gnu::packed]] BlockPerformanceEvent {
+    u32 blocker_type;
+    // In microseconds, only set for unblock events.
+    u32 blocked_time;
+};
+
 struct [[gnu::packed]] PerformanceEvent {
-    u16 type { 0 };
+    u32 type { 0 };
     u8 stack_size { 0 };
     u32 pid { 0 };
     u32 tid { 0 };
@@ -80,6 +89,7 @@ struct [[gnu::packed]] PerformanceEvent {
         ContextSwitchPerformanceEvent context_switch;
         KMallocPerformanceEvent kmalloc;
         KFreePerformanceEvent kfree;
+        BlockPerformanceEvent block;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
@@ -98,32 +108,59 @@ public:
     KResult append_with_ip_and_bp(ProcessID pid, ThreadID tid, FlatPtr eip, FlatPtr ebp,
         int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, const StringView& arg3);
 
-    void clear()
-    {
-        m_count = 0;
-    }
+    void clear();
 
-    size_t capacity() const { return m_buffer->size() / sizeof(PerformanceEvent); }
-    size_t count() const { return m_count; }
-    const PerformanceEvent& at(size_t index) const
-    {
-        return const_cast<PerformanceEventBuffer&>(*this).at(index);
-    }
+    size_t capacity() const;
+    size_t count() const;
+    size_t lost_event_count() const;
 
     bool to_json(KBufferBuilder&) const;
 
+    // Serializes the oldest events into the buffer, one JSON object per line, and removes them from this buffer.
+    // Only whole events are read, so the buffer has to be at least max_serialized_event_size bytes long.
+    KResultOr<size_t> read_events(UserOrKernelBuffer&, size_t size);
+    static constexpr size_t max_serialized_event_size = 4 * KiB;
+
     void add_process(const Process&, ProcessEventType event_type);
 
 private:
-    explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
+    struct Slot {
+        // This is the position of the event in its ring plus one, and is only stored once the event has been written.
+        Atomic<size_t> sequence { 0 };
+        u64 precise_timestamp_ns { 0 };
+        PerformanceEvent event;
+    };
+
+    // Every processor appends to a ring of its own, so appending never takes a lock, and the events
+    // of threads that are running at the same time don't contend for the same cache lines.
+    struct Ring {
+        Slot* slots { nullptr };
+        size_t capacity { 0 };
+        Atomic<size_t> head { 0 };
+        Atomic<size_t> tail { 0 };
+        Atomic<size_t> lost_events { 0 };
+    };
+
+    PerformanceEventBuffer(NonnullOwnPtr<KBuffer>, size_t ring_count);
 
     template<typename Serializer>
     bool to_json_impl(Serializer&) const;
 
-    PerformanceEvent& at(size_t index);
+    template<typename Serializer>
+    static void serialize_event(Serializer& event_object, const PerformanceEvent&, bool& seen_first_sample);
+
+    // Walks the committed events that haven't been read yet, merging the rings in timestamp order.
+    template<typename Callback>
+    void for_each_event_in_order(Callback);
+
+    Ring& ring_for_current_processor() { return m_rings[Processor::id() % m_rings.size()]; }
 
-    size_t m_count { 0 };
     NonnullOwnPtr<KBuffer> m_buffer;
+    FixedArray<Ring> m_rings;
+
+    // Readers (serializing the events, or streaming them out) are serialized, appending isn't.
+    mutable Mutex m_read_lock { "PerformanceEventBuffer" };
+    bool m_streamed_first_sample { false };
 };
 
 extern bool g_profiling_all_threads;
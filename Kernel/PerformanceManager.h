@@ -67,6 +67,17 @@ public:
         }
     }
 
+    inline static void add_hardware_counter_event(Thread& current_thread, const RegisterState& regs, int type)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append_with_ip_and_bp(
+                current_thread.pid(), current_thread.tid(),
+                regs.ip(), regs.bp(), type, 0, 0, 0, nullptr);
+        }
+    }
+
     inline static void add_mmap_perf_event(Process& current_process, Region const& region)
     {
         if (auto* event_buffer = current_process.current_perf_events_buffer()) {
@@ -90,6 +101,24 @@ public:
         }
     }
 
+    inline static void add_block_perf_event(Thread& current_thread, Thread::Blocker::Type blocker_type)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto res = event_buffer->append(PERF_EVENT_BLOCK, to_underlying(blocker_type), 0, nullptr, &current_thread);
+        }
+    }
+
+    inline static void add_unblock_perf_event(Thread& current_thread, Thread::Blocker::Type blocker_type, u32 blocked_time_us)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto res = event_buffer->append(PERF_EVENT_UNBLOCK, to_underlying(blocker_type), blocked_time_us, nullptr, &current_thread);
+        }
+    }
+
     inline static void add_kmalloc_perf_event(Thread& current_thread, size_t size, FlatPtr ptr)
     {
         if (current_thread.is_profiling_suppressed())
@@ -123,19 +152,45 @@ public:
     {
         static Time last_wakeup;
         auto now = kgettimeofday();
-        constexpr auto ideal_interval = Time::from_microseconds(1000'000 / OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE);
+        auto ideal_interval = Time::from_microseconds(1000'000 / TimeManagement::the().profile_timer_frequency());
         auto expected_wakeup = last_wakeup + ideal_interval;
         auto delay = (now > expected_wakeup) ? now - expected_wakeup : Time::from_microseconds(0);
         last_wakeup = now;
-        auto current_thread = Thread::current();
+        auto lost_samples = delay.to_microseconds() / ideal_interval.to_microseconds();
+
+        // The profile timer only interrupts one processor, so ask the others to sample whatever they're running too.
+        if (Processor::count() > 1)
+            sample_other_processors(lost_samples);
+
         // FIXME: We currently don't collect samples while idle.
         //        That will be an interesting mode to add in the future. :^)
+        auto current_thread = Thread::current();
         if (!current_thread || current_thread == Processor::current().idle_thread())
             return;
 
-        auto lost_samples = delay.to_microseconds() / ideal_interval.to_microseconds();
         PerformanceManager::add_cpu_sample_event(*current_thread, regs, lost_samples);
     }
+
+private:
+    static void sample_other_processors(u32 lost_samples)
+    {
+        auto current_processor_id = Processor::id();
+        for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+            if (cpu == current_processor_id)
+                continue;
+            Processor::smp_unicast(
+                cpu, [lost_samples] {
+                    auto* thread = Thread::current();
+                    if (!thread || thread == Processor::current().idle_thread())
+                        return;
+                    // The innermost trap is the IPI that got us here, so its registers are the ones of the
+                    // code that was interrupted.
+                    if (auto* trap = thread->current_trap())
+                        PerformanceManager::add_cpu_sample_event(*thread, *trap->regs, lost_samples);
+                },
+                true);
+        }
+    }
 };
 
 }
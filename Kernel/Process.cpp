@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/CoreDump.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/KCOVDevice.h>
@@ -595,6 +596,11 @@ void Process::finalize()
         }
     }
 
+    if (m_uses_performance_counters) {
+        PerformanceCounters::disable();
+        m_uses_performance_counters = false;
+    }
+
     m_threads_for_coredump.clear();
 
     if (m_alarm_timer)
@@ -836,7 +842,8 @@ bool Process::create_perf_events_buffer_if_needed()
 {
     if (!m_perf_event_buffer) {
         m_perf_event_buffer = PerformanceEventBuffer::try_create_with_size(4 * MiB);
-        m_perf_event_buffer->add_process(*this, ProcessEventType::Create);
+        if (m_perf_event_buffer)
+            m_perf_event_buffer->add_process(*this, ProcessEventType::Create);
     }
     return !!m_perf_event_buffer;
 }
@@ -16,6 +16,7 @@
 #include <AK/Userspace.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
+#include <Kernel/API/EventPoll.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/AtomicEdgeAction.h>
 #include <Kernel/FileSystem/FileDescription.h>
@@ -80,8 +81,6 @@ enum class VeilState {
     Locked,
 };
 
-typedef HashMap<FlatPtr, RefPtr<FutexQueue>> FutexQueues;
-
 struct LoadResult;
 
 class ProtectedProcessBase {
@@ -384,6 +383,10 @@ public:
     KResultOr<FlatPtr> sys$shutdown(int sockfd, int how);
     KResultOr<FlatPtr> sys$sendmsg(int sockfd, Userspace<const struct msghdr*>, int flags);
     KResultOr<FlatPtr> sys$recvmsg(int sockfd, Userspace<struct msghdr*>, int flags);
+    KResultOr<FlatPtr> sys$sendmmsg(int sockfd, Userspace<struct mmsghdr*>, unsigned message_count, int flags);
+    KResultOr<FlatPtr> sys$recvmmsg(int sockfd, Userspace<struct mmsghdr*>, unsigned message_count, int flags);
+    KResultOr<FlatPtr> sys$map_time_page();
+    KResultOr<FlatPtr> sys$posix_spawn(Userspace<const Syscall::SC_posix_spawn_params*>);
     KResultOr<FlatPtr> sys$getsockopt(Userspace<const Syscall::SC_getsockopt_params*>);
     KResultOr<FlatPtr> sys$setsockopt(Userspace<const Syscall::SC_setsockopt_params*>);
     KResultOr<FlatPtr> sys$getsockname(Userspace<const Syscall::SC_getsockname_params*>);
@@ -411,6 +414,8 @@ public:
     KResultOr<FlatPtr> sys$profiling_enable(pid_t, u64);
     KResultOr<FlatPtr> sys$profiling_disable(pid_t);
     KResultOr<FlatPtr> sys$profiling_free_buffer(pid_t);
+    KResultOr<FlatPtr> sys$profiling_read(pid_t, Userspace<u8*>, size_t);
+    KResultOr<FlatPtr> sys$profiling_set_sampling_frequency(unsigned);
     KResultOr<FlatPtr> sys$futex(Userspace<const Syscall::SC_futex_params*>);
     KResultOr<FlatPtr> sys$chroot(Userspace<const char*> path, size_t path_length, int mount_flags);
     KResultOr<FlatPtr> sys$pledge(Userspace<const Syscall::SC_pledge_params*>);
@@ -428,6 +433,12 @@ public:
     KResultOr<FlatPtr> sys$anon_create(size_t, int options);
     KResultOr<FlatPtr> sys$statvfs(Userspace<const Syscall::SC_statvfs_params*> user_params);
     KResultOr<FlatPtr> sys$fstatvfs(int fd, statvfs* buf);
+    KResultOr<FlatPtr> sys$io_ring_create(u32 entry_count, int options);
+    KResultOr<FlatPtr> sys$io_ring_enter(int fd, u32 min_completions);
+    KResultOr<FlatPtr> sys$event_poll_create(int options);
+    KResultOr<FlatPtr> sys$event_poll_ctl(int fd, int operation, int watched_fd, Userspace<const event_poll_event*>);
+    KResultOr<FlatPtr> sys$event_poll_wait(int fd, Userspace<event_poll_event*>, size_t max_events, Userspace<const timespec*>);
+    KResultOr<FlatPtr> sys$sendfile(int out_fd, int in_fd, Userspace<off_t*>, size_t count);
 
     template<bool sockname, typename Params>
     int get_sock_or_peer_name(const Params&);
@@ -471,6 +482,16 @@ public:
 
     Mutex& big_lock() { return m_big_lock; }
     Mutex& ptrace_lock() { return m_ptrace_lock; }
+    // Serializes the changes to the address space, as the mmap() family of syscalls doesn't take the big lock.
+    Mutex& space_lock() { return m_space_lock; }
+
+    u64 big_lock_wait_time_ns() const { return m_big_lock_wait_time_ns.load(AK::MemoryOrder::memory_order_relaxed); }
+    u64 big_lock_contention_count() const { return m_big_lock_contention_count.load(AK::MemoryOrder::memory_order_relaxed); }
+    void did_wait_for_big_lock(Time const& duration)
+    {
+        m_big_lock_wait_time_ns.fetch_add(duration.to_nanoseconds(), AK::MemoryOrder::memory_order_relaxed);
+        m_big_lock_contention_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    }
 
     Custody& root_directory();
     Custody& root_directory_relative_to_global_root();
@@ -538,6 +559,7 @@ private:
     bool create_perf_events_buffer_if_needed();
     void delete_perf_events_buffer();
 
+    void copy_state_into_child(Process& child);
     KResult do_exec(NonnullRefPtr<FileDescription> main_program_description, Vector<String> arguments, Vector<String> environment, RefPtr<FileDescription> interpreter_description, Thread*& new_main_thread, u32& prev_flags, const ElfW(Ehdr) & main_program_header);
     KResultOr<FlatPtr> do_write(FileDescription&, const UserOrKernelBuffer&, size_t);
 
@@ -725,6 +747,7 @@ private:
     const bool m_is_kernel_process;
     Atomic<State> m_state { State::Running };
     bool m_profiling { false };
+    bool m_uses_performance_counters { false };
     Atomic<bool, AK::MemoryOrder::memory_order_relaxed> m_is_stopped { false };
     bool m_should_dump_core { false };
 
@@ -744,6 +767,10 @@ private:
 
     Mutex m_big_lock { "Process" };
     Mutex m_ptrace_lock { "ptrace" };
+    Mutex m_space_lock { "Space" };
+
+    Atomic<u64> m_big_lock_wait_time_ns { 0 };
+    Atomic<u64> m_big_lock_contention_count { 0 };
 
     RefPtr<Timer> m_alarm_timer;
 
@@ -752,9 +779,6 @@ private:
 
     OwnPtr<PerformanceEventBuffer> m_perf_event_buffer;
 
-    FutexQueues m_futex_queues;
-    SpinLock<u8> m_futex_lock;
-
     // This member is used in the implementation of ptrace's PT_TRACEME flag.
     // If it is set to true, the process will stop at the next execve syscall
     // and wait for a tracer to attach.
@@ -327,7 +327,6 @@ private:
     }
     virtual bool output(KBufferBuilder& builder) override
     {
-        InterruptDisabler disabler;
         auto parent_directory = m_parent_directory.strong_ref();
         if (parent_directory.is_null())
             return false;
@@ -463,6 +462,8 @@ private:
                 region_object.add("size", region->size());
                 region_object.add("amount_resident", region->amount_resident());
                 region_object.add("amount_dirty", region->amount_dirty());
+                region_object.add("amount_shared", region->amount_shared());
+                region_object.add("amount_private", region->amount_private());
                 region_object.add("cow_pages", region->cow_pages());
                 region_object.add("name", region->name());
                 region_object.add("vmobject", region->vmobject().class_name());
@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Time.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
@@ -21,6 +24,11 @@
 
 namespace Kernel {
 
+struct ThreadReadyQueue {
+    IntrusiveList<Thread, RawPtr<Thread>, &Thread::m_ready_queue_node> thread_list;
+};
+static constexpr u32 g_ready_queue_buckets = sizeof(u32) * 8;
+
 class SchedulerData {
     AK_MAKE_NONCOPYABLE(SchedulerData);
     AK_MAKE_NONMOVABLE(SchedulerData);
@@ -31,6 +39,19 @@ public:
     SchedulerData() = default;
 
     bool m_in_scheduler { true };
+
+    // Each processor has its own set of priority-bucketed ready queues,
+    // protected by its own lock. Idle processors steal from their peers.
+    SpinLock<u8> m_ready_queues_lock;
+    u32 m_ready_queues_mask { 0 };
+    Array<ThreadReadyQueue, g_ready_queue_buckets> m_ready_queues;
+
+    // These are only used as placement hints and statistics, so they
+    // are updated and read without holding m_ready_queues_lock.
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_queued_thread_count { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_wakeups_on_last_processor { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_wakeups_migrated { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_threads_stolen { 0 };
 };
 
 RecursiveSpinLock g_scheduler_lock;
@@ -48,13 +69,9 @@ READONLY_AFTER_INIT WaitQueue* g_finalizer_wait_queue;
 Atomic<bool> g_finalizer_has_work { false };
 READONLY_AFTER_INIT static Process* s_colonel_process;
 
-struct ThreadReadyQueue {
-    IntrusiveList<Thread, RawPtr<Thread>, &Thread::m_ready_queue_node> thread_list;
-};
-static SpinLock<u8> g_ready_queues_lock;
-static u32 g_ready_queues_mask;
-static constexpr u32 g_ready_queue_buckets = sizeof(g_ready_queues_mask) * 8;
-READONLY_AFTER_INIT static ThreadReadyQueue* g_ready_queues; // g_ready_queue_buckets entries
+// Indexed by processor id, so that we can reach the ready queues of other processors.
+// Note: This has the same capacity as ProcessorContainer.
+static Array<SchedulerData*, 8> s_scheduler_data;
 
 static TotalTimeScheduled g_total_time_scheduled;
 static SpinLock<u8> g_total_time_scheduled_lock;
@@ -65,10 +82,19 @@ u64 (*Scheduler::current_time)();
 
 static void dump_thread_list(bool = false);
 
+static void initialize_scheduler_data_for_current_processor()
+{
+    auto& processor = Processor::current();
+    if (s_scheduler_data[processor.get_id()])
+        return;
+    ProcessorSpecific<SchedulerData>::initialize();
+    s_scheduler_data[processor.get_id()] = processor.get_specific<SchedulerData>();
+}
+
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -77,26 +103,27 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+Thread* Scheduler::find_runnable_thread_in(SchedulerData& scheduler_data, u32 affinity_mask, ShouldDequeue should_dequeue)
 {
-    auto affinity_mask = 1u << Processor::id();
-
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority_mask = g_ready_queues_mask;
+    ScopedSpinLock lock(scheduler_data.m_ready_queues_lock);
+    auto priority_mask = scheduler_data.m_ready_queues_mask;
     while (priority_mask != 0) {
         auto priority = __builtin_ffsl(priority_mask);
         VERIFY(priority > 0);
-        auto& ready_queue = g_ready_queues[--priority];
+        auto& ready_queue = scheduler_data.m_ready_queues[--priority];
         for (auto& thread : ready_queue.thread_list) {
             VERIFY(thread.m_runnable_priority == (int)priority);
             if (thread.is_active())
                 continue;
             if (!(thread.affinity() & affinity_mask))
                 continue;
+            if (should_dequeue == ShouldDequeue::No)
+                return &thread;
             thread.m_runnable_priority = -1;
             ready_queue.thread_list.remove(thread);
+            scheduler_data.m_queued_thread_count--;
             if (ready_queue.thread_list.is_empty())
-                g_ready_queues_mask &= ~(1u << priority);
+                scheduler_data.m_ready_queues_mask &= ~(1u << priority);
             // Mark it as active because we are using this thread. This is similar
             // to comparing it with Processor::current_thread, but when there are
             // multiple processors there's no easy way to check whether the thread
@@ -108,45 +135,64 @@ Thread& Scheduler::pull_next_runnable_thread()
             // switching to it.
             // FIXME: Figure out a better way maybe?
             thread.set_active(true);
-            return thread;
+            return &thread;
         }
         priority_mask &= ~(1u << priority);
     }
-    return *Processor::idle_thread();
+    return nullptr;
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+Thread* Scheduler::find_runnable_thread(ShouldDequeue should_dequeue)
 {
-    auto affinity_mask = 1u << Processor::id();
-
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority_mask = g_ready_queues_mask;
-    while (priority_mask != 0) {
-        auto priority = __builtin_ffsl(priority_mask);
-        VERIFY(priority > 0);
-        auto& ready_queue = g_ready_queues[--priority];
-        for (auto& thread : ready_queue.thread_list) {
-            VERIFY(thread.m_runnable_priority == (int)priority);
-            if (thread.is_active())
-                continue;
-            if (!(thread.affinity() & affinity_mask))
-                continue;
-            return &thread;
+    auto cpu = Processor::id();
+    auto affinity_mask = 1u << cpu;
+
+    // Always prefer our own ready queues, and only look at the
+    // other processors' queues if we'd otherwise go idle.
+    if (auto* thread = find_runnable_thread_in(*s_scheduler_data[cpu], affinity_mask, should_dequeue))
+        return thread;
+
+    for (u32 i = 1; i < s_scheduler_data.size(); i++) {
+        auto victim = (cpu + i) % s_scheduler_data.size();
+        auto* scheduler_data = s_scheduler_data[victim];
+        if (!scheduler_data)
+            continue;
+        // Peek at the mask without taking the lock, there's no point in
+        // contending on the lock of a processor that has nothing queued.
+        if (AK::atomic_load(&scheduler_data->m_ready_queues_mask, AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+        if (auto* thread = find_runnable_thread_in(*scheduler_data, affinity_mask, should_dequeue)) {
+            if (should_dequeue == ShouldDequeue::Yes) {
+                dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", cpu, *thread, victim);
+                s_scheduler_data[cpu]->m_threads_stolen++;
+            }
+            return thread;
         }
-        priority_mask &= ~(1u << priority);
     }
+    return nullptr;
+}
 
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    if (auto* thread = find_runnable_thread(ShouldDequeue::Yes))
+        return *thread;
+    return *Processor::idle_thread();
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
     // Unlike in pull_next_runnable_thread() we don't want to fall back to
     // the idle thread. We just want to see if we have any other thread ready
     // to be scheduled.
-    return nullptr;
+    return find_runnable_thread(ShouldDequeue::No);
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
 {
     if (thread.is_idle_thread())
         return true;
-    ScopedSpinLock lock(g_ready_queues_lock);
+    auto& scheduler_data = *s_scheduler_data[thread.m_runnable_processor];
+    ScopedSpinLock lock(scheduler_data.m_ready_queues_lock);
     auto priority = thread.m_runnable_priority;
     if (priority < 0) {
         VERIFY(!thread.m_ready_queue_node.is_in_list());
@@ -156,31 +202,78 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (check_affinity && !(thread.affinity() & (1 << Processor::id())))
         return false;
 
-    VERIFY(g_ready_queues_mask & (1u << priority));
-    auto& ready_queue = g_ready_queues[priority];
+    VERIFY(scheduler_data.m_ready_queues_mask & (1u << priority));
+    auto& ready_queue = scheduler_data.m_ready_queues[priority];
     thread.m_runnable_priority = -1;
     ready_queue.thread_list.remove(thread);
+    scheduler_data.m_queued_thread_count--;
     if (ready_queue.thread_list.is_empty())
-        g_ready_queues_mask &= ~(1u << priority);
+        scheduler_data.m_ready_queues_mask &= ~(1u << priority);
     return true;
 }
 
+// How many more queued threads the processor a thread last ran on may have,
+// compared to the least loaded processor, before we give up on its warm caches.
+static constexpr u32 max_queue_imbalance_for_last_processor = 1;
+
+static u32 processor_to_queue_thread_on(Thread const& thread)
+{
+#if SCHEDULE_ON_ALL_PROCESSORS
+    auto is_eligible = [&](u32 cpu) {
+        return cpu < s_scheduler_data.size() && s_scheduler_data[cpu] && (thread.affinity() & (1u << cpu));
+    };
+
+    Optional<u32> least_loaded_cpu;
+    u32 least_load = NumericLimits<u32>::max();
+    for (u32 cpu = 0; cpu < s_scheduler_data.size(); cpu++) {
+        if (!is_eligible(cpu))
+            continue;
+        auto load = s_scheduler_data[cpu]->m_queued_thread_count.load();
+        if (load < least_load) {
+            least_load = load;
+            least_loaded_cpu = cpu;
+        }
+    }
+    if (!least_loaded_cpu.has_value())
+        return 0;
+
+    // Prefer the processor the thread last ran on, its caches are most likely
+    // still warm. Only move the thread if that processor is noticeably busier.
+    auto last_cpu = thread.cpu();
+    if (is_eligible(last_cpu) && s_scheduler_data[last_cpu]->m_queued_thread_count <= least_load + max_queue_imbalance_for_last_processor)
+        return last_cpu;
+    return least_loaded_cpu.value();
+#else
+    // Only the bootstrap processor is scheduling, so queue everything there.
+    (void)thread;
+    return 0;
+#endif
+}
+
 void Scheduler::queue_runnable_thread(Thread& thread)
 {
     VERIFY(g_scheduler_lock.own_lock());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
-
-    ScopedSpinLock lock(g_ready_queues_lock);
+    auto cpu = processor_to_queue_thread_on(thread);
+    auto& scheduler_data = *s_scheduler_data[cpu];
+    if (cpu == thread.cpu())
+        scheduler_data.m_wakeups_on_last_processor++;
+    else
+        scheduler_data.m_wakeups_migrated++;
+
+    ScopedSpinLock lock(scheduler_data.m_ready_queues_lock);
     VERIFY(thread.m_runnable_priority < 0);
     thread.m_runnable_priority = (int)priority;
+    thread.m_runnable_processor = cpu;
     VERIFY(!thread.m_ready_queue_node.is_in_list());
-    auto& ready_queue = g_ready_queues[priority];
+    auto& ready_queue = scheduler_data.m_ready_queues[priority];
     bool was_empty = ready_queue.thread_list.is_empty();
     ready_queue.thread_list.append(thread);
+    scheduler_data.m_queued_thread_count++;
     if (was_empty)
-        g_ready_queues_mask |= (1u << priority);
+        scheduler_data.m_ready_queues_mask |= (1u << priority);
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -192,7 +285,7 @@ UNMAP_AFTER_INIT void Scheduler::start()
     g_scheduler_lock.lock();
 
     auto& processor = Processor::current();
-    ProcessorSpecific<SchedulerData>::initialize();
+    initialize_scheduler_data_for_current_processor();
     VERIFY(processor.is_initialized());
     auto& idle_thread = *Processor::idle_thread();
     VERIFY(processor.current_thread() == &idle_thread);
@@ -417,7 +510,7 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
 
     RefPtr<Thread> idle_thread;
     g_finalizer_wait_queue = new WaitQueue;
-    g_ready_queues = new ThreadReadyQueue[g_ready_queue_buckets];
+    initialize_scheduler_data_for_current_processor();
 
     g_finalizer_has_work.store(false, AK::MemoryOrder::memory_order_release);
     s_colonel_process = Process::create_kernel_process(idle_thread, "colonel", idle_loop, nullptr, 1, Process::RegisterProcess::No).leak_ref();
@@ -534,7 +627,26 @@ void Scheduler::idle_loop(void*)
 
     for (;;) {
         proc.idle_begin();
-        asm("hlt");
+        if (TimeManagement::the().is_dynamic_ticks_enabled()) {
+            // Check for runnable threads and stop the scheduler ticks with
+            // interrupts disabled, otherwise a thread that is woken up in
+            // between would have to wait for the next timer deadline.
+            cli();
+#if SCHEDULE_ON_ALL_PROCESSORS
+            bool has_runnable_thread = peek_next_runnable_thread();
+#else
+            bool has_runnable_thread = Processor::id() == 0 && peek_next_runnable_thread();
+#endif
+            if (!has_runnable_thread) {
+                TimeManagement::the().stop_ticks_for_idle();
+                asm volatile("sti; hlt");
+                cli();
+            }
+            TimeManagement::the().restart_ticks_after_idle();
+            sti();
+        } else {
+            asm("hlt");
+        }
 
         proc.idle_end();
         VERIFY_INTERRUPTS_ENABLED();
@@ -564,6 +676,22 @@ TotalTimeScheduled Scheduler::get_total_time_scheduled()
     return g_total_time_scheduled;
 }
 
+void Scheduler::for_each_processor_statistics(Function<void(SchedulerProcessorStatistics const&)> callback)
+{
+    for (u32 cpu = 0; cpu < s_scheduler_data.size(); cpu++) {
+        auto* scheduler_data = s_scheduler_data[cpu];
+        if (!scheduler_data)
+            continue;
+        callback({
+            .processor = cpu,
+            .queued_threads = scheduler_data->m_queued_thread_count,
+            .wakeups_on_last_processor = scheduler_data->m_wakeups_on_last_processor,
+            .wakeups_migrated = scheduler_data->m_wakeups_migrated,
+            .threads_stolen = scheduler_data->m_threads_stolen,
+        });
+    }
+}
+
 void dump_thread_list(bool with_stack_traces)
 {
     dbgln("Scheduler thread list for processor {}:", Processor::id());
@@ -18,6 +18,7 @@
 namespace Kernel {
 
 struct RegisterState;
+class SchedulerData;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -29,6 +30,14 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct SchedulerProcessorStatistics {
+    u32 processor { 0 };
+    u32 queued_threads { 0 };
+    u64 wakeups_on_last_processor { 0 };
+    u64 wakeups_migrated { 0 };
+    u64 threads_stolen { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -55,7 +64,16 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static void for_each_processor_statistics(Function<void(SchedulerProcessorStatistics const&)>);
     static u64 (*current_time)();
+
+private:
+    enum class ShouldDequeue {
+        No,
+        Yes,
+    };
+    static Thread* find_runnable_thread(ShouldDequeue);
+    static Thread* find_runnable_thread_in(SchedulerData&, u32 affinity_mask, ShouldDequeue);
 };
 
 }
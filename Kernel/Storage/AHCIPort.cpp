@@ -44,12 +44,9 @@ AHCIPort::AHCIPort(const AHCIPortHandler& handler, volatile AHCI::PortRegisters&
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Command list page at {}", representative_port_index(), m_command_list_page->paddr());
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: FIS receive page at {}", representative_port_index(), m_command_list_page->paddr());
 
-    for (size_t index = 0; index < 1; index++) {
-        m_dma_buffers.append(MM.allocate_supervisor_physical_page().release_nonnull());
-    }
-    for (size_t index = 0; index < 1; index++) {
-        m_command_table_pages.append(MM.allocate_supervisor_physical_page().release_nonnull());
-    }
+    // The first command slot is also used to identify the device, so it is set up right away.
+    bool first_slot_allocated = try_to_allocate_command_slot_buffers(m_command_slots[0]);
+    VERIFY(first_slot_allocated);
     m_command_list_region = MM.allocate_kernel_region(m_command_list_page->paddr(), PAGE_SIZE, "AHCI Port Command List", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Command list region at {}", representative_port_index(), m_command_list_region->vaddr());
 }
@@ -84,38 +81,68 @@ void AHCIPort::handle_interrupt()
         });
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
+        // Clear the interrupt status before looking at which commands are done, so that
+        // a command finishing right after we looked will raise another interrupt.
+        m_interrupt_status.clear();
         m_wait_for_completion = false;
 
-        // Now schedule reading/writing the buffer as soon as we leave the irq handler.
-        // This is important so that we can safely access the buffers, which could
-        // trigger page faults
-        if (!m_current_request) {
+        ScopedSpinLock lock(m_hard_lock);
+        u32 finished_slots = m_issued_slots_mask & ~(m_port_registers.ci | m_port_registers.sact);
+        if (finished_slots == 0) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
-        } else {
+            return;
+        }
+        m_issued_slots_mask &= ~finished_slots;
+
+        // Now schedule reading/writing the buffers as soon as we leave the irq handler.
+        // This is important so that we can safely access the buffers, which could
+        // trigger page faults. All requests that finish until then are handled together.
+        bool completion_already_queued = m_finished_slots_mask != 0;
+        m_finished_slots_mask |= finished_slots;
+        if (!completion_already_queued) {
             g_io_work->queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                MutexLocker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (!m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count())) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
+                complete_finished_requests();
             });
         }
+        return;
     }
 
     m_interrupt_status.clear();
 }
 
+void AHCIPort::complete_finished_requests()
+{
+    MutexLocker locker(m_lock);
+    u32 finished_slots;
+    {
+        ScopedSpinLock lock(m_hard_lock);
+        finished_slots = exchange(m_finished_slots_mask, 0);
+    }
+
+    for (u8 slot_index = 0; slot_index < max_command_slot_count; slot_index++) {
+        if (!(finished_slots & (1u << slot_index)))
+            continue;
+        auto& slot = m_command_slots[slot_index];
+        // The request may have been failed already while recovering from an error.
+        if (!slot.request)
+            continue;
+
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request in command slot {} handled", representative_port_index(), slot_index);
+        auto result = AsyncDeviceRequest::Success;
+        auto& request = *slot.request;
+        if (request.request_type() == AsyncBlockDeviceRequest::Read) {
+            if (!request.write_to_buffer(request.buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                result = AsyncDeviceRequest::MemoryFault;
+            }
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request {}", representative_port_index(), result == AsyncDeviceRequest::Success ? "success" : "failure");
+        // NOTE: This frees up the command slot before the next request gets started by completing this one.
+        release_command_slot(slot_index)->complete(result);
+    }
+}
+
 bool AHCIPort::is_interrupts_enabled() const
 {
     return !m_interrupt_enable.is_cleared();
@@ -124,12 +151,26 @@ bool AHCIPort::is_interrupts_enabled() const
 void AHCIPort::recover_from_fatal_error()
 {
     MutexLocker locker(m_lock);
-    ScopedSpinLock lock(m_hard_lock);
-    dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
-    dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
-    stop_command_list_processing();
-    stop_fis_receiving();
-    m_interrupt_enable.clear();
+    {
+        ScopedSpinLock lock(m_hard_lock);
+        dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
+        dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
+        stop_command_list_processing();
+        stop_fis_receiving();
+        m_interrupt_enable.clear();
+        m_issued_slots_mask = 0;
+        m_finished_slots_mask = 0;
+    }
+    fail_outstanding_requests();
+}
+
+void AHCIPort::fail_outstanding_requests()
+{
+    VERIFY(m_lock.is_locked());
+    for (u8 slot_index = 0; slot_index < max_command_slot_count; slot_index++) {
+        if (m_command_slots[slot_index].request)
+            release_command_slot(slot_index)->complete(AsyncDeviceRequest::Failure);
+    }
 }
 
 void AHCIPort::eject()
@@ -148,7 +189,9 @@ void AHCIPort::eject()
     auto unused_command_header = try_to_find_unused_command_header();
     VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
+    auto& slot = m_command_slots[unused_command_header.value()];
+    VERIFY(slot.command_table_region);
+    command_list_entries[unused_command_header.value()].ctba = slot.command_table_page->paddr().get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
     command_list_entries[unused_command_header.value()].prdbc = 0;
     command_list_entries[unused_command_header.value()].prdtl = 0;
@@ -159,8 +202,7 @@ void AHCIPort::eject()
     // handshake error bit in PxSERR register if CFL is incorrect.
     command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | AHCI::CommandHeaderAttributes::C | AHCI::CommandHeaderAttributes::A;
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = *(volatile AHCI::CommandTable*)slot.command_table_region->vaddr().as_ptr();
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
     auto& fis = *(volatile FIS::HostToDevice::Register*)command_table.command_fis;
     fis.header.fis_type = (u8)FIS::Type::RegisterHostToDevice;
@@ -288,6 +330,7 @@ bool AHCIPort::initialize(ScopedSpinLock<SpinLock<u8>>& main_lock)
         if (is_atapi_attached()) {
             m_port_registers.cmd = m_port_registers.cmd | (1 << 24);
         }
+        configure_command_queuing(*identify_block);
 
         dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
 
@@ -423,25 +466,70 @@ size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
     size_t needed_dma_regions_count = page_round_up((block_count * m_connected_device->block_size())) / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    VERIFY(needed_dma_regions_count <= dma_buffer_page_count);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+bool AHCIPort::try_to_allocate_command_slot_buffers(CommandSlot& slot)
+{
+    if (slot.command_table_region)
+        return true;
+
+    NonnullRefPtrVector<PhysicalPage> dma_buffers;
+    for (size_t index = 0; index < dma_buffer_page_count; index++) {
+        auto dma_buffer = MM.allocate_supervisor_physical_page();
+        if (!dma_buffer)
+            return false;
+        dma_buffers.append(dma_buffer.release_nonnull());
+    }
+    auto command_table_page = MM.allocate_supervisor_physical_page();
+    if (!command_table_page)
+        return false;
+    auto command_table_region = MM.allocate_kernel_region(command_table_page->paddr(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
+    if (!command_table_region)
+        return false;
+
+    slot.dma_buffers = move(dma_buffers);
+    slot.command_table_page = move(command_table_page);
+    slot.command_table_region = move(command_table_region);
+    return true;
+}
+
+void AHCIPort::configure_command_queuing(const ATAIdentifyBlock& identify_block)
+{
+    m_command_slot_count = 1;
+    m_native_command_queuing_enabled = false;
+    if (is_atapi_attached() || !m_parent_handler->hba_capabilities().native_command_queuing_supported)
+        return;
+    // Word 76 tells whether the device supports native command queuing, and word 75 how many commands it can queue.
+    if (!(identify_block.serial_ata_capabilities & (1 << 8)))
+        return;
+    size_t queue_depth = (identify_block.queue_depth & 0x1f) + 1;
+    size_t command_slot_count = min(min(queue_depth, m_parent_handler->hba_capabilities().max_command_list_entries_count), max_command_slot_count);
+    if (command_slot_count <= 1)
+        return;
+    m_command_slot_count = command_slot_count;
+    m_native_command_queuing_enabled = true;
+    dmesgln("AHCI Port {}: Using native command queuing with {} command slots", representative_port_index(), m_command_slot_count);
+}
+
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(CommandSlot& slot)
 {
     VERIFY(m_lock.is_locked());
+    VERIFY(slot.request);
+    auto& request = *slot.request;
     VERIFY(request.block_count() > 0);
 
     NonnullRefPtrVector<PhysicalPage> allocated_dma_regions;
     for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
+        allocated_dma_regions.append(slot.dma_buffers.at(index));
     }
 
-    m_current_scatter_list = ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
-    if (!m_current_scatter_list)
+    slot.scatter_list = ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
+    if (!slot.scatter_list)
         return AsyncDeviceRequest::Failure;
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (!request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
+        if (!request.read_from_buffer(request.buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
@@ -452,34 +540,54 @@ void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     MutexLocker locker(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    // NOTE: The device doesn't start more requests at once than we have command slots,
+    //       so there is only no free slot left if the port was shut down in the meantime.
+    auto slot_index = try_to_find_unused_command_header();
+    if (!slot_index.has_value() || !is_operable()) {
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, no usable command slot.", representative_port_index());
+        locker.unlock();
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+
+    auto& slot = m_command_slots[slot_index.value()];
+    VERIFY(!slot.request);
+    VERIFY(!slot.scatter_list);
+    slot.request = request;
 
-    auto result = prepare_and_set_scatter_list(request);
-    if (result.has_value()) {
+    auto fail_request = [&](AsyncDeviceRequest::RequestResult result) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
+        auto failed_request = release_command_slot(slot_index.value());
         locker.unlock();
-        complete_current_request(result.value());
+        failed_request->complete(result);
+    };
+
+    if (!try_to_allocate_command_slot_buffers(slot)) {
+        fail_request(AsyncDeviceRequest::Failure);
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto result = prepare_and_set_scatter_list(slot);
+    if (result.has_value()) {
+        fail_request(result.value());
+        return;
+    }
+
+    auto success = access_device(slot_index.value(), request.request_type(), request.block_index(), request.block_count());
     if (!success) {
-        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
-        locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        fail_request(AsyncDeviceRequest::Failure);
         return;
     }
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+NonnullRefPtr<AsyncBlockDeviceRequest> AHCIPort::release_command_slot(u8 slot_index)
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_command_slots[slot_index];
+    VERIFY(slot.request);
+    slot.scatter_list = nullptr;
+    return slot.request.release_nonnull();
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -498,44 +606,42 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 slot_index, AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
+    auto& slot = m_command_slots[slot_index];
+    VERIFY(slot.scatter_list);
     ScopedSpinLock lock(m_hard_lock);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, command slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, slot_index);
     if (!spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[slot_index].ctba = slot.command_table_page->paddr().get();
+    command_list_entries[slot_index].ctbau = 0;
+    command_list_entries[slot_index].prdbc = 0;
+    command_list_entries[slot_index].prdtl = slot.scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
+    command_list_entries[slot_index].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[slot_index].ctba, (u32)command_list_entries[slot_index].ctbau, (u32)command_list_entries[slot_index].prdbc, (u16)command_list_entries[slot_index].prdtl, (u16)command_list_entries[slot_index].attributes);
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = *(volatile AHCI::CommandTable*)slot.command_table_region->vaddr().as_ptr();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Using command table at {}", representative_port_index(), slot.command_table_region->vaddr());
 
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : slot.scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -559,6 +665,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -577,17 +688,28 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing_enabled) {
+        // Queued commands take the block count in the features register, and their tag in the count register.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = slot_index << 3;
+    } else {
+        fis.count = (block_count);
+    }
 
     // The below loop waits until the port is no longer busy before issuing a new command
     if (!spin_until_ready())
         return false;
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    // Note: The AHCI specification requires a queued command to be marked as active before it is issued.
+    if (m_native_command_queuing_enabled)
+        m_port_registers.sact = 1u << slot_index;
+    m_issued_slots_mask |= 1u << slot_index;
+    mark_command_header_ready_to_process(slot_index);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, slot.dma_buffers[0].paddr());
     return true;
 }
 
@@ -601,7 +723,9 @@ bool AHCIPort::identify_device(ScopedSpinLock<SpinLock<u8>>& main_lock)
     auto unused_command_header = try_to_find_unused_command_header();
     VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
+    auto& slot = m_command_slots[unused_command_header.value()];
+    VERIFY(slot.command_table_region);
+    command_list_entries[unused_command_header.value()].ctba = slot.command_table_page->paddr().get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
     command_list_entries[unused_command_header.value()].prdbc = 512;
     command_list_entries[unused_command_header.value()].prdtl = 1;
@@ -610,8 +734,7 @@ bool AHCIPort::identify_device(ScopedSpinLock<SpinLock<u8>>& main_lock)
     // QEMU doesn't care if we don't set the correct CFL field in this register, real hardware will set an handshake error bit in PxSERR register.
     command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P;
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write);
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = *(volatile AHCI::CommandTable*)slot.command_table_region->vaddr().as_ptr();
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
     command_table.descriptors[0].base_high = 0;
     command_table.descriptors[0].base_low = m_parent_handler->get_identify_metadata_physical_region(m_port_index).get();
@@ -664,8 +787,8 @@ Optional<u8> AHCIPort::try_to_find_unused_command_header()
 {
     VERIFY(m_lock.is_locked());
     u32 commands_issued = m_port_registers.ci;
-    for (size_t index = 0; index < 32; index++) {
-        if (!(commands_issued & 1)) {
+    for (size_t index = 0; index < m_command_slot_count; index++) {
+        if (!(commands_issued & 1) && !m_command_slots[index].request) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: unused command header at index {}", representative_port_index(), index);
             return index;
         }
@@ -688,8 +811,6 @@ void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) con
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
     m_port_registers.ci = 1 << command_header_index;
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <Kernel/Devices/Device.h>
@@ -27,6 +28,7 @@
 namespace Kernel {
 
 class AsyncBlockDeviceRequest;
+struct ATAIdentifyBlock;
 
 class AHCIPortHandler;
 class SATADiskDevice;
@@ -45,11 +47,29 @@ public:
 
     RefPtr<StorageDevice> connected_device() const { return m_connected_device; }
 
+    // A single request is transferred through the DMA buffers of its command slot, so this is the most it can move at once.
+    static constexpr size_t dma_buffer_page_count = 16;
+    static constexpr size_t max_transfer_size() { return dma_buffer_page_count * PAGE_SIZE; }
+
+    // Every request in progress occupies one command slot. Unless the device supports native
+    // command queuing, only one slot is used.
+    static constexpr size_t max_command_slot_count = 32;
+    size_t command_slot_count() const { return m_command_slot_count; }
+
     bool reset();
     UNMAP_AFTER_INIT bool initialize_without_reset();
     void handle_interrupt();
 
 private:
+    struct CommandSlot {
+        RefPtr<AsyncBlockDeviceRequest> request;
+        RefPtr<ScatterGatherList> scatter_list;
+        // These are allocated the first time the slot is used.
+        NonnullRefPtrVector<PhysicalPage> dma_buffers;
+        RefPtr<PhysicalPage> command_table_page;
+        OwnPtr<Region> command_table_region;
+    };
+
     bool is_phy_enabled() const { return (m_port_registers.ssts & 0xf) == 3; }
     bool initialize(ScopedSpinLock<SpinLock<u8>>&);
 
@@ -70,10 +90,14 @@ private:
     ALWAYS_INLINE void power_on() const;
 
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    [[nodiscard]] NonnullRefPtr<AsyncBlockDeviceRequest> release_command_slot(u8 slot);
+    void complete_finished_requests();
+    void fail_outstanding_requests();
+    bool access_device(u8 slot, AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    bool try_to_allocate_command_slot_buffers(CommandSlot&);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(CommandSlot&);
+    void configure_command_queuing(const ATAIdentifyBlock&);
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -100,15 +124,19 @@ private:
     // Data members
 
     EntropySource m_entropy_source;
-    RefPtr<AsyncBlockDeviceRequest> m_current_request;
     SpinLock<u8> m_hard_lock;
     Mutex m_lock { "AHCIPort" };
 
     mutable bool m_wait_for_completion { false };
     bool m_wait_connect_for_completion { false };
 
-    NonnullRefPtrVector<PhysicalPage> m_dma_buffers;
-    NonnullRefPtrVector<PhysicalPage> m_command_table_pages;
+    // The requests in the command slots are guarded by m_lock, the slot masks by m_hard_lock.
+    Array<CommandSlot, max_command_slot_count> m_command_slots;
+    size_t m_command_slot_count { 1 };
+    bool m_native_command_queuing_enabled { false };
+    u32 m_issued_slots_mask { 0 };
+    u32 m_finished_slots_mask { 0 };
+
     RefPtr<PhysicalPage> m_command_list_page;
     OwnPtr<Region> m_command_list_region;
     RefPtr<PhysicalPage> m_fis_receive_page;
@@ -120,7 +148,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    RefPtr<ScatterGatherList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
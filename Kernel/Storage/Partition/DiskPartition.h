@@ -28,6 +28,8 @@ public:
     // ^Device
     virtual mode_t required_mode() const override { return 0600; }
     virtual String device_name() const override;
+    // Requests are handed straight to the underlying device, so as many can be in progress as it allows.
+    virtual size_t max_concurrent_requests() const override { return m_device->max_concurrent_requests(); }
 
     const DiskPartitionMetadata& metadata() const;
 
@@ -32,6 +32,16 @@ StringView SATADiskDevice::class_name() const
     return "SATADiskDevice";
 }
 
+size_t SATADiskDevice::max_blocks_per_request() const
+{
+    return AHCIPort::max_transfer_size() / block_size();
+}
+
+size_t SATADiskDevice::max_concurrent_requests() const
+{
+    return m_port->command_slot_count();
+}
+
 void SATADiskDevice::start_request(AsyncBlockDeviceRequest& request)
 {
     m_port->start_request(request);
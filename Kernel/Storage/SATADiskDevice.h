@@ -28,6 +28,11 @@ public:
     virtual ~SATADiskDevice() override;
 
     // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override;
+
+    // ^Device
+    virtual size_t max_concurrent_requests() const override;
+
     // ^BlockDevice
     virtual void start_request(AsyncBlockDeviceRequest&) override;
     virtual String device_name() const override;
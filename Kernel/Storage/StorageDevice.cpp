@@ -43,12 +43,12 @@ KResultOr<size_t> StorageDevice::read(FileDescription&, u64 offset, UserOrKernel
     u16 whole_blocks = len / block_size();
     size_t remaining = len % block_size();
 
-    unsigned blocks_per_page = PAGE_SIZE / block_size();
-
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= blocks_per_page) {
-        whole_blocks = blocks_per_page;
+    // The device may not be able to transfer everything at once, e.g. PATAChannel
+    // will chuck a wobbly if we try to read more than PAGE_SIZE at a time,
+    // because it uses a single page for its DMA buffer.
+    size_t blocks_per_request = max_blocks_per_request();
+    if (whole_blocks >= blocks_per_request) {
+        whole_blocks = blocks_per_request;
         remaining = 0;
     }
 
@@ -108,12 +108,12 @@ KResultOr<size_t> StorageDevice::write(FileDescription&, u64 offset, const UserO
     u16 whole_blocks = len / block_size();
     size_t remaining = len % block_size();
 
-    unsigned blocks_per_page = PAGE_SIZE / block_size();
-
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= blocks_per_page) {
-        whole_blocks = blocks_per_page;
+    // The device may not be able to transfer everything at once, e.g. PATAChannel
+    // will chuck a wobbly if we try to write more than PAGE_SIZE at a time,
+    // because it uses a single page for its DMA buffer.
+    size_t blocks_per_request = max_blocks_per_request();
+    if (whole_blocks >= blocks_per_request) {
+        whole_blocks = blocks_per_request;
         remaining = 0;
     }
 
@@ -23,6 +23,9 @@ public:
 
     NonnullRefPtr<StorageController> controller() const;
 
+    // The largest number of blocks that read() and write() will transfer with a single request.
+    virtual size_t max_blocks_per_request() const { return PAGE_SIZE / block_size(); }
+
     // ^BlockDevice
     virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual bool can_read(const FileDescription&, size_t) const override;
@@ -6,6 +6,7 @@
 
 #include <AK/UUID.h>
 #include <Kernel/Bus/PCI/Access.h>
+#include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/CommandLine.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Ext2FileSystem.h>
@@ -17,6 +18,7 @@
 #include <Kernel/Storage/Partition/MBRPartitionTable.h>
 #include <Kernel/Storage/RamdiskController.h>
 #include <Kernel/Storage/StorageManagement.h>
+#include <Kernel/Storage/VirtIOBlockController.h>
 
 namespace Kernel {
 
@@ -58,6 +60,13 @@ UNMAP_AFTER_INIT NonnullRefPtrVector<StorageController> StorageManagement::enume
                 controllers.append(AHCIController::initialize(address));
             }
         });
+        if (!kernel_command_line().disable_virtio()) {
+            PCI::enumerate([&](const PCI::Address& address, PCI::ID id) {
+                if (id.vendor_id == PCI::VendorID::VirtIO && id.device_id == PCI::DeviceID::VirtIOBlock) {
+                    controllers.append(VirtIOBlockController::initialize(address));
+                }
+            });
+        }
     }
     controllers.append(RamdiskController::initialize());
     return controllers;
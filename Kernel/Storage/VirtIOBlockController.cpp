@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Storage/VirtIOBlockController.h>
+#include <Kernel/Storage/VirtIODiskDevice.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+static constexpr u16 request_queue = 0;
+static constexpr size_t sector_size = 512;
+
+UNMAP_AFTER_INIT NonnullRefPtr<VirtIOBlockController> VirtIOBlockController::initialize(PCI::Address address)
+{
+    return adopt_ref(*new VirtIOBlockController(address));
+}
+
+UNMAP_AFTER_INIT VirtIOBlockController::VirtIOBlockController(PCI::Address address)
+    : StorageController()
+    , VirtIODevice(address, "VirtIOBlock")
+{
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_SEG_MAX))
+            negotiated |= VIRTIO_BLK_F_SEG_MAX;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_RO))
+            negotiated |= VIRTIO_BLK_F_RO;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_BLK_SIZE))
+            negotiated |= VIRTIO_BLK_F_BLK_SIZE;
+        return negotiated;
+    });
+    if (!success)
+        return;
+
+    auto* config = get_config(ConfigurationType::Device);
+    if (!config) {
+        dbgln("{}: Could not find device configuration", m_class_name);
+        return;
+    }
+
+    u64 capacity = 0;
+    u32 segment_max = 0;
+    u32 block_size = sector_size;
+    read_config_atomic([&]() {
+        capacity = config_read32(*config, 0x0) | ((u64)config_read32(*config, 0x4) << 32);
+        if (is_feature_accepted(VIRTIO_BLK_F_SEG_MAX))
+            segment_max = config_read32(*config, 0xc);
+        if (is_feature_accepted(VIRTIO_BLK_F_BLK_SIZE))
+            block_size = config_read32(*config, 0x14);
+    });
+    // The device always counts in 512-byte sectors, but may prefer to be accessed in larger blocks.
+    if (block_size < sector_size || block_size > PAGE_SIZE || (block_size & (block_size - 1)) != 0) {
+        dbgln("{}: Ignoring unsupported block size {}", m_class_name, block_size);
+        block_size = sector_size;
+    }
+    m_sectors_per_block = block_size / sector_size;
+    m_read_only = is_feature_accepted(VIRTIO_BLK_F_RO);
+
+    if (!setup_queues(1))
+        return;
+
+    // Besides one descriptor per page of data, every request needs one for its header and one for its status.
+    auto queue_size = get_queue(request_queue).size();
+    if (queue_size < 3) {
+        dbgln("{}: Request queue with {} descriptors is too small", m_class_name, queue_size);
+        return;
+    }
+    m_dma_buffer_page_count = min(max_dma_buffer_page_count, queue_size - 2);
+    if (segment_max != 0)
+        m_dma_buffer_page_count = min(m_dma_buffer_page_count, segment_max);
+    m_request_slot_count = min(max_request_slot_count, queue_size / (m_dma_buffer_page_count + 2));
+
+    m_slot_control_region = MM.allocate_contiguous_kernel_region(page_round_up(sizeof(RequestSlotControl) * max_request_slot_count), "VirtIOBlock Requests", Region::Access::Read | Region::Access::Write);
+    if (!m_slot_control_region)
+        return;
+
+    finish_init();
+
+    m_device = VirtIODiskDevice::create(*this, block_size, capacity / m_sectors_per_block);
+    dmesgln("{}: Device found, Capacity={}, Bytes per block={}, Request slots={}{}", m_class_name, capacity * sector_size, block_size, m_request_slot_count, m_read_only ? ", read-only" : "");
+}
+
+VirtIOBlockController::~VirtIOBlockController()
+{
+}
+
+RefPtr<StorageDevice> VirtIOBlockController::device(u32 index) const
+{
+    if (index != 0)
+        return nullptr;
+    return m_device;
+}
+
+size_t VirtIOBlockController::devices_count() const
+{
+    return m_device ? 1 : 0;
+}
+
+bool VirtIOBlockController::reset()
+{
+    TODO();
+}
+
+bool VirtIOBlockController::shutdown()
+{
+    TODO();
+}
+
+void VirtIOBlockController::complete_current_request(AsyncDeviceRequest::RequestResult)
+{
+    VERIFY_NOT_REACHED();
+}
+
+bool VirtIOBlockController::handle_device_config_change()
+{
+    // FIXME: Handle the capacity of the disk changing.
+    return true;
+}
+
+bool VirtIOBlockController::try_to_allocate_dma_buffer(RequestSlot& slot)
+{
+    if (slot.dma_buffer)
+        return true;
+    // NOTE: The pages of the buffer don't have to be physically contiguous, as each of them gets its own descriptor.
+    slot.dma_buffer = MM.allocate_kernel_region(m_dma_buffer_page_count * PAGE_SIZE, "VirtIOBlock DMA Buffer", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+    return slot.dma_buffer != nullptr;
+}
+
+auto VirtIOBlockController::slot_control(size_t slot_index) -> volatile RequestSlotControl&
+{
+    VERIFY(slot_index < m_request_slot_count);
+    return reinterpret_cast<volatile RequestSlotControl*>(m_slot_control_region->vaddr().as_ptr())[slot_index];
+}
+
+PhysicalAddress VirtIOBlockController::slot_control_address(size_t slot_index) const
+{
+    VERIFY(slot_index < m_request_slot_count);
+    return m_slot_control_region->physical_page(0)->paddr().offset(slot_index * sizeof(RequestSlotControl));
+}
+
+void VirtIOBlockController::start_request(const StorageDevice&, AsyncBlockDeviceRequest& request)
+{
+    MutexLocker locker(m_lock);
+
+    // NOTE: The disk doesn't start more requests at once than we have request slots.
+    Optional<size_t> slot_index;
+    for (size_t index = 0; index < m_request_slot_count; index++) {
+        if (!m_request_slots[index].request) {
+            slot_index = index;
+            break;
+        }
+    }
+    VERIFY(slot_index.has_value());
+    auto& slot = m_request_slots[slot_index.value()];
+    slot.request = request;
+
+    auto fail_request = [&](AsyncDeviceRequest::RequestResult result) {
+        dbgln_if(VIRTIO_DEBUG, "{}: Request failure.", m_class_name);
+        auto failed_request = release_request_slot(slot_index.value());
+        locker.unlock();
+        failed_request->complete(result);
+    };
+
+    if (request.request_type() == AsyncBlockDeviceRequest::Write && m_read_only) {
+        fail_request(AsyncDeviceRequest::Failure);
+        return;
+    }
+    if (!try_to_allocate_dma_buffer(slot)) {
+        fail_request(AsyncDeviceRequest::Failure);
+        return;
+    }
+
+    size_t transfer_size = request.block_count() * m_device->block_size();
+    VERIFY(transfer_size <= max_transfer_size());
+    if (request.request_type() == AsyncBlockDeviceRequest::Write) {
+        if (!request.read_from_buffer(request.buffer(), slot.dma_buffer->vaddr().as_ptr(), transfer_size)) {
+            fail_request(AsyncDeviceRequest::MemoryFault);
+            return;
+        }
+    }
+
+    if (!submit_request(slot_index.value())) {
+        fail_request(AsyncDeviceRequest::Failure);
+        return;
+    }
+}
+
+bool VirtIOBlockController::submit_request(size_t slot_index)
+{
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_request_slots[slot_index];
+    VERIFY(slot.request);
+    auto& request = *slot.request;
+    bool is_write = request.request_type() == AsyncBlockDeviceRequest::Write;
+
+    auto& control = slot_control(slot_index);
+    control.header.type = is_write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+    control.header.reserved = 0;
+    control.header.sector = request.block_index() * m_sectors_per_block;
+    control.status = VIRTIO_BLK_S_IOERR;
+
+    dbgln_if(VIRTIO_DEBUG, "{}: Do a {}, sector {}, block count {}, request slot {}", m_class_name, is_write ? "write" : "read", request.block_index() * m_sectors_per_block, request.block_count(), slot_index);
+
+    auto& queue = get_queue(request_queue);
+    ScopedSpinLock lock(queue.lock());
+    VirtIOQueueChain chain(queue);
+    bool success = chain.add_buffer_to_chain(slot_control_address(slot_index), sizeof(RequestHeader), BufferType::DeviceReadable);
+    size_t remaining = request.block_count() * m_device->block_size();
+    for (size_t page_index = 0; success && remaining > 0; page_index++) {
+        size_t length = min(remaining, PAGE_SIZE);
+        success = chain.add_buffer_to_chain(slot.dma_buffer->physical_page(page_index)->paddr(), length, is_write ? BufferType::DeviceReadable : BufferType::DeviceWritable);
+        remaining -= length;
+    }
+    if (success)
+        success = chain.add_buffer_to_chain(slot_control_address(slot_index).offset(sizeof(RequestHeader)), sizeof(u8), BufferType::DeviceWritable);
+    if (!success) {
+        chain.release_buffer_slots_to_queue();
+        return false;
+    }
+    supply_chain_and_notify(request_queue, chain);
+    return true;
+}
+
+NonnullRefPtr<AsyncBlockDeviceRequest> VirtIOBlockController::release_request_slot(size_t slot_index)
+{
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_request_slots[slot_index];
+    VERIFY(slot.request);
+    return slot.request.release_nonnull();
+}
+
+void VirtIOBlockController::collect_finished_requests()
+{
+    auto& queue = get_queue(request_queue);
+    VERIFY(queue.lock().is_locked());
+    auto first_slot_control_address = slot_control_address(0);
+    size_t used;
+    for (auto chain = queue.pop_used_buffer_chain(used); !chain.is_empty(); chain = queue.pop_used_buffer_chain(used)) {
+        // Every chain starts with the header of its request, which tells us the slot it came from.
+        Optional<size_t> slot_index;
+        chain.for_each([&](PhysicalAddress address, size_t) {
+            if (!slot_index.has_value())
+                slot_index = (address.get() - first_slot_control_address.get()) / sizeof(RequestSlotControl);
+        });
+        chain.release_buffer_slots_to_queue();
+        VERIFY(slot_index.value() < m_request_slot_count);
+        m_finished_slots_mask |= 1u << slot_index.value();
+    }
+}
+
+void VirtIOBlockController::handle_queue_update(u16 queue_index)
+{
+    VERIFY(queue_index == request_queue);
+    auto& queue = get_queue(request_queue);
+    ScopedSpinLock lock(queue.lock());
+    collect_finished_requests();
+    if (m_finished_slots_mask == 0 || m_completion_pending)
+        return;
+
+    // Now schedule reading the buffers as soon as we leave the irq handler, as that could trigger page faults.
+    // Until that has caught up with the device, it doesn't have to interrupt us for every request it finishes.
+    m_completion_pending = true;
+    queue.disable_interrupts();
+    g_io_work->queue([this]() {
+        complete_finished_requests();
+    });
+}
+
+void VirtIOBlockController::complete_finished_requests()
+{
+    MutexLocker locker(m_lock);
+    auto& queue = get_queue(request_queue);
+    for (;;) {
+        u32 finished_slots;
+        {
+            ScopedSpinLock lock(queue.lock());
+            collect_finished_requests();
+            if (m_finished_slots_mask == 0) {
+                queue.enable_interrupts();
+                full_memory_barrier();
+                // A request finishing right before interrupts were enabled again didn't raise one, so look once more.
+                collect_finished_requests();
+                if (m_finished_slots_mask == 0) {
+                    m_completion_pending = false;
+                    return;
+                }
+                queue.disable_interrupts();
+            }
+            finished_slots = exchange(m_finished_slots_mask, 0);
+        }
+
+        for (size_t slot_index = 0; slot_index < m_request_slot_count; slot_index++) {
+            if (!(finished_slots & (1u << slot_index)))
+                continue;
+            auto& slot = m_request_slots[slot_index];
+            VERIFY(slot.request);
+            auto& request = *slot.request;
+
+            auto result = AsyncDeviceRequest::Success;
+            u8 status = slot_control(slot_index).status;
+            if (status != VIRTIO_BLK_S_OK) {
+                dbgln("{}: Request in slot {} failed with status {}", m_class_name, slot_index, status);
+                result = AsyncDeviceRequest::Failure;
+            } else if (request.request_type() == AsyncBlockDeviceRequest::Read) {
+                if (!request.write_to_buffer(request.buffer(), slot.dma_buffer->vaddr().as_ptr(), request.block_count() * m_device->block_size()))
+                    result = AsyncDeviceRequest::MemoryFault;
+            }
+            // NOTE: This frees up the slot before the next request gets started by completing this one.
+            release_request_slot(slot_index)->complete(result);
+        }
+    }
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/OwnPtr.h>
+#include <AK/RefPtr.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Storage/StorageController.h>
+#include <Kernel/Storage/StorageDevice.h>
+#include <Kernel/VirtIO/VirtIO.h>
+
+#define VIRTIO_BLK_F_SIZE_MAX (1 << 1)
+#define VIRTIO_BLK_F_SEG_MAX (1 << 2)
+#define VIRTIO_BLK_F_RO (1 << 5)
+#define VIRTIO_BLK_F_BLK_SIZE (1 << 6)
+
+#define VIRTIO_BLK_T_IN 0
+#define VIRTIO_BLK_T_OUT 1
+
+#define VIRTIO_BLK_S_OK 0
+#define VIRTIO_BLK_S_IOERR 1
+#define VIRTIO_BLK_S_UNSUPP 2
+
+namespace Kernel {
+
+class AsyncBlockDeviceRequest;
+class VirtIODiskDevice;
+
+class VirtIOBlockController final : public StorageController
+    , public VirtIODevice {
+    AK_MAKE_ETERNAL
+public:
+    UNMAP_AFTER_INIT static NonnullRefPtr<VirtIOBlockController> initialize(PCI::Address);
+    virtual ~VirtIOBlockController() override;
+
+    virtual RefPtr<StorageDevice> device(u32 index) const override;
+    virtual bool reset() override;
+    virtual bool shutdown() override;
+    virtual size_t devices_count() const override;
+    virtual void start_request(const StorageDevice&, AsyncBlockDeviceRequest&) override;
+    virtual void complete_current_request(AsyncDeviceRequest::RequestResult) override;
+
+    // Every request in progress occupies one request slot, which transfers its data through a DMA buffer of its own.
+    static constexpr size_t max_request_slot_count = 32;
+    static constexpr size_t max_dma_buffer_page_count = 16;
+    size_t request_slot_count() const { return m_request_slot_count; }
+    size_t max_transfer_size() const { return m_dma_buffer_page_count * PAGE_SIZE; }
+
+private:
+    struct [[gnu::packed]] RequestHeader {
+        u32 type;
+        u32 reserved;
+        u64 sector;
+    };
+
+    // The header and status of all requests are kept together in a single page.
+    struct [[gnu::packed]] RequestSlotControl {
+        RequestHeader header;
+        u8 status;
+        u8 padding[15];
+    };
+
+    struct RequestSlot {
+        RefPtr<AsyncBlockDeviceRequest> request;
+        // This is allocated the first time the slot is used.
+        OwnPtr<Region> dma_buffer;
+    };
+
+    explicit VirtIOBlockController(PCI::Address);
+
+    // ^VirtIODevice
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    bool try_to_allocate_dma_buffer(RequestSlot&);
+    volatile RequestSlotControl& slot_control(size_t slot_index);
+    PhysicalAddress slot_control_address(size_t slot_index) const;
+    bool submit_request(size_t slot_index);
+    [[nodiscard]] NonnullRefPtr<AsyncBlockDeviceRequest> release_request_slot(size_t slot_index);
+    void collect_finished_requests();
+    void complete_finished_requests();
+
+    Mutex m_lock { "VirtIOBlockController" };
+    RefPtr<VirtIODiskDevice> m_device;
+    OwnPtr<Region> m_slot_control_region;
+    // The requests in the slots are guarded by m_lock.
+    Array<RequestSlot, max_request_slot_count> m_request_slots;
+    size_t m_request_slot_count { 0 };
+    size_t m_dma_buffer_page_count { max_dma_buffer_page_count };
+    size_t m_sectors_per_block { 1 };
+    bool m_read_only { false };
+
+    // These are guarded by the lock of the request queue.
+    u32 m_finished_slots_mask { 0 };
+    bool m_completion_pending { false };
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <Kernel/Storage/VirtIOBlockController.h>
+#include <Kernel/Storage/VirtIODiskDevice.h>
+
+namespace Kernel {
+
+NonnullRefPtr<VirtIODiskDevice> VirtIODiskDevice::create(const VirtIOBlockController& controller, size_t block_size, u64 max_addressable_block)
+{
+    return adopt_ref(*new VirtIODiskDevice(controller, block_size, max_addressable_block));
+}
+
+VirtIODiskDevice::VirtIODiskDevice(const VirtIOBlockController& controller, size_t block_size, u64 max_addressable_block)
+    : StorageDevice(controller, block_size, max_addressable_block)
+    , m_controller(controller)
+{
+}
+
+VirtIODiskDevice::~VirtIODiskDevice()
+{
+}
+
+StringView VirtIODiskDevice::class_name() const
+{
+    return "VirtIODiskDevice";
+}
+
+size_t VirtIODiskDevice::max_blocks_per_request() const
+{
+    return m_controller->max_transfer_size() / block_size();
+}
+
+size_t VirtIODiskDevice::max_concurrent_requests() const
+{
+    return m_controller->request_slot_count();
+}
+
+void VirtIODiskDevice::start_request(AsyncBlockDeviceRequest& request)
+{
+    m_controller->start_request(*this, request);
+}
+
+String VirtIODiskDevice::device_name() const
+{
+    return String::formatted("hd{:c}", 'a' + minor());
+}
+
+}
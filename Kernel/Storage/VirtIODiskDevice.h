@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Storage/StorageDevice.h>
+
+namespace Kernel {
+
+class VirtIOBlockController;
+
+class VirtIODiskDevice final : public StorageDevice {
+public:
+    static NonnullRefPtr<VirtIODiskDevice> create(const VirtIOBlockController&, size_t block_size, u64 max_addressable_block);
+    virtual ~VirtIODiskDevice() override;
+
+    // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override;
+
+    // ^Device
+    virtual size_t max_concurrent_requests() const override;
+
+    // ^BlockDevice
+    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual String device_name() const override;
+
+private:
+    VirtIODiskDevice(const VirtIOBlockController&, size_t block_size, u64 max_addressable_block);
+
+    // ^DiskDevice
+    virtual StringView class_name() const override;
+
+    NonnullRefPtr<VirtIOBlockController> m_controller;
+};
+
+}
@@ -11,6 +11,8 @@
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/ThreadTracer.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
@@ -122,7 +124,15 @@ KResultOr<FlatPtr> handle(RegisterState& regs, FlatPtr function, FlatPtr arg1, F
     MutexLocker mutex_locker;
     const auto needs_big_lock = syscall_metadata.needs_lock == NeedsBigProcessLock::Yes;
     if (needs_big_lock) {
-        mutex_locker.attach_and_lock(process.big_lock());
+        // Reading the clock isn't free, so only time the acquisitions that look like they will have to wait.
+        auto& big_lock = process.big_lock();
+        if (big_lock.is_locked() && !big_lock.own_lock()) {
+            auto start = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+            mutex_locker.attach_and_lock(big_lock);
+            process.did_wait_for_big_lock(TimeManagement::the().monotonic_time(TimePrecision::Precise) - start);
+        } else {
+            mutex_locker.attach_and_lock(big_lock);
+        }
     };
 
     if (function == SC_exit || function == SC_exit_thread) {
@@ -210,7 +220,9 @@ NEVER_INLINE void syscall_handler(TrapFrame* trap)
     FlatPtr arg4;
     regs.capture_syscall_params(function, arg1, arg2, arg3, arg4);
 
+    auto trace_start = Tracepoints::begin();
     auto result = Syscall::handle(regs, function, arg1, arg2, arg3, arg4);
+    Tracepoints::end_syscall(function, trace_start);
 
     if (result.is_error()) {
         regs.set_return_reg(result.error());
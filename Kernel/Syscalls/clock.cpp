@@ -7,6 +7,7 @@
 #include <AK/Time.h>
 #include <Kernel/Process.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/VM/AnonymousVMObject.h>
 
 namespace Kernel {
 
@@ -126,4 +127,20 @@ KResultOr<FlatPtr> Process::sys$gettimeofday(Userspace<timeval*> user_tv)
     return 0;
 }
 
+KResultOr<FlatPtr> Process::sys$map_time_page()
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
+
+    auto range = space().allocate_range({}, PAGE_SIZE);
+    if (!range.has_value())
+        return ENOMEM;
+    // NOTE: This is not an mmap() region, so userspace can neither unmap it nor make it writable.
+    auto region_or_error = space().allocate_region_with_vmobject(range.value(), TimeManagement::the().time_page_vmobject(), 0, "Time page", PROT_READ, true);
+    if (region_or_error.is_error())
+        return region_or_error.error();
+    return region_or_error.value()->vaddr().get();
+}
+
 }
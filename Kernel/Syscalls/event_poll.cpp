@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr size_t max_events_per_wait = 256;
+
+KResultOr<FlatPtr> Process::sys$event_poll_create(int options)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+
+    if (options & ~O_CLOEXEC)
+        return EINVAL;
+
+    auto new_fd_or_error = m_fds.allocate();
+    if (new_fd_or_error.is_error())
+        return new_fd_or_error.error();
+    auto new_fd = new_fd_or_error.release_value();
+
+    auto event_poll_or_error = EventPoll::try_create();
+    if (event_poll_or_error.is_error())
+        return event_poll_or_error.error();
+
+    auto description_or_error = FileDescription::create(*event_poll_or_error.value());
+    if (description_or_error.is_error())
+        return description_or_error.error();
+
+    auto description = description_or_error.release_value();
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    m_fds[new_fd.fd].set(move(description), fd_flags);
+    return new_fd.fd;
+}
+
+KResultOr<FlatPtr> Process::sys$event_poll_ctl(int fd, int operation, int watched_fd, Userspace<const event_poll_event*> user_event)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(description->file());
+
+    // NOTE: Removing a watch doesn't need the file descriptor to still be open.
+    if (operation == EVENT_POLL_CTL_DEL)
+        return event_poll.remove_watch(watched_fd);
+
+    auto watched_description = fds().file_description(watched_fd);
+    if (!watched_description)
+        return EBADF;
+
+    event_poll_event event;
+    if (!copy_from_user(&event, user_event))
+        return EFAULT;
+
+    switch (operation) {
+    case EVENT_POLL_CTL_ADD:
+        return event_poll.add_watch(watched_fd, *watched_description, event);
+    case EVENT_POLL_CTL_MOD:
+        return event_poll.modify_watch(watched_fd, *watched_description, event);
+    default:
+        return EINVAL;
+    }
+}
+
+KResultOr<FlatPtr> Process::sys$event_poll_wait(int fd, Userspace<event_poll_event*> user_events, size_t max_events, Userspace<const timespec*> user_timeout)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+
+    if (max_events == 0)
+        return EINVAL;
+
+    auto description = fds().file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(description->file());
+
+    Thread::BlockTimeout timeout;
+    if (user_timeout) {
+        auto timeout_time = copy_time_from_user(user_timeout);
+        if (!timeout_time.has_value())
+            return EFAULT;
+        timeout = Thread::BlockTimeout(false, &timeout_time.value());
+    }
+
+    Vector<event_poll_event> events;
+    if (!events.try_resize(min(max_events, max_events_per_wait)))
+        return ENOMEM;
+
+    for (;;) {
+        auto ready_count_or_error = event_poll.collect_ready_events(*this, events.span());
+        if (ready_count_or_error.is_error())
+            return ready_count_or_error.error();
+        if (auto ready_count = ready_count_or_error.value(); ready_count > 0) {
+            if (!copy_n_to_user(user_events, events.data(), ready_count))
+                return EFAULT;
+            return ready_count;
+        }
+
+        if (!timeout.should_block())
+            return 0;
+
+        auto unblock_flags = BlockFlags::None;
+        auto result = Thread::current()->block<Thread::ReadBlocker>(timeout, *description, unblock_flags);
+        if (result.was_interrupted())
+            return EINTR;
+        if (result.timed_out())
+            return 0;
+    }
+}
+
+}
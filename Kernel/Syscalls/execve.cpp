@@ -14,6 +14,7 @@
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
+#include <Kernel/TTY/TTY.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/VM/AllocationStrategy.h>
 #include <Kernel/VM/MemoryManager.h>
@@ -558,6 +559,8 @@ KResult Process::do_exec(NonnullRefPtr<FileDescription> main_program_description
         // we might otherwise end up walking the stack into the process' space that
         // is about to be destroyed.
         TemporaryChange global_profiling_disabler(g_profiling_all_threads, false);
+        // The threads we just told to die may still be in the middle of an mmap() or the like.
+        MutexLocker space_locker(space_lock());
         m_space = load_result.space.release_nonnull();
     }
     MemoryManager::enter_space(*m_space);
@@ -580,7 +583,9 @@ KResult Process::do_exec(NonnullRefPtr<FileDescription> main_program_description
     m_coredump_metadata.clear();
 
     auto current_thread = Thread::current();
-    current_thread->clear_signals();
+    // NOTE: posix_spawn() execs its child from the parent's thread, whose signals are none of our business.
+    if (&current_thread->process() == this)
+        current_thread->clear_signals();
 
     clear_futex_queues_on_exec();
 
@@ -930,6 +935,29 @@ KResult Process::exec(String path, Vector<String> arguments, Vector<String> envi
     return KSuccess;
 }
 
+static bool copy_user_strings(const Syscall::StringListArgument& list, Vector<String>& output)
+{
+    if (!list.length)
+        return true;
+    Checked<size_t> size = sizeof(*list.strings);
+    size *= list.length;
+    if (size.has_overflow())
+        return false;
+    Vector<Syscall::StringArgument, 32> strings;
+    if (!strings.try_resize(list.length))
+        return false;
+    if (!copy_from_user(strings.data(), list.strings, size.value()))
+        return false;
+    for (size_t i = 0; i < list.length; ++i) {
+        auto string = copy_string_from_user(strings[i]);
+        if (string.is_null())
+            return false;
+        if (!output.try_append(move(string)))
+            return false;
+    }
+    return true;
+}
+
 KResultOr<FlatPtr> Process::sys$execve(Userspace<const Syscall::SC_execve_params*> user_params)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -952,28 +980,6 @@ KResultOr<FlatPtr> Process::sys$execve(Userspace<const Syscall::SC_execve_params
         path = path_arg.value()->view();
     }
 
-    auto copy_user_strings = [](const auto& list, auto& output) {
-        if (!list.length)
-            return true;
-        Checked<size_t> size = sizeof(*list.strings);
-        size *= list.length;
-        if (size.has_overflow())
-            return false;
-        Vector<Syscall::StringArgument, 32> strings;
-        if (!strings.try_resize(list.length))
-            return false;
-        if (!copy_from_user(strings.data(), list.strings, size.value()))
-            return false;
-        for (size_t i = 0; i < list.length; ++i) {
-            auto string = copy_string_from_user(strings[i]);
-            if (string.is_null())
-                return false;
-            if (!output.try_append(move(string)))
-                return false;
-        }
-        return true;
-    };
-
     Vector<String> arguments;
     if (!copy_user_strings(params.arguments, arguments))
         return EFAULT;
@@ -987,4 +993,223 @@ KResultOr<FlatPtr> Process::sys$execve(Userspace<const Syscall::SC_execve_params
     return result.error();
 }
 
+// posix_spawn() creates the child without ever copying our address space: the child starts out with
+// an empty one, gets its file descriptions and attributes set up by us, and is then exec'd directly.
+// Until that exec has succeeded, the child has not run and can simply be thrown away again.
+KResultOr<FlatPtr> Process::sys$posix_spawn(Userspace<const Syscall::SC_posix_spawn_params*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    REQUIRE_PROMISE(proc);
+    REQUIRE_PROMISE(exec);
+
+    Syscall::SC_posix_spawn_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX)
+        return E2BIG;
+    if (params.file_action_count > 1024)
+        return E2BIG;
+
+    String path;
+    {
+        auto path_arg = get_syscall_path_argument(params.path);
+        if (path_arg.is_error())
+            return path_arg.error();
+        path = path_arg.value()->view();
+    }
+
+    Vector<String> arguments;
+    if (!copy_user_strings(params.arguments, arguments))
+        return EFAULT;
+
+    Vector<String> environment;
+    if (!copy_user_strings(params.environment, environment))
+        return EFAULT;
+
+    Vector<Syscall::SC_posix_spawn_file_action> file_actions;
+    if (params.file_action_count > 0) {
+        if (!file_actions.try_resize(params.file_action_count))
+            return ENOMEM;
+        if (!copy_n_from_user(file_actions.data(), params.file_actions, params.file_action_count))
+            return EFAULT;
+    }
+
+    if ((params.flags & POSIX_SPAWN_SETPGROUP) && params.pgroup < 0)
+        return EINVAL;
+    if ((params.flags & POSIX_SPAWN_TCSETPGROUP) && (params.flags & POSIX_SPAWN_SETSID))
+        return EINVAL;
+    if ((params.flags & POSIX_SPAWN_SETSCHEDPARAM) && (params.priority < THREAD_PRIORITY_MIN || params.priority > THREAD_PRIORITY_MAX))
+        return EINVAL;
+
+    RefPtr<Thread> child_first_thread;
+    auto child = Process::create(child_first_thread, m_name, uid(), gid(), pid(), false, m_cwd, m_executable, m_tty, this);
+    if (!child || !child_first_thread)
+        return ENOMEM;
+    copy_state_into_child(*child);
+
+    ArmedScopeGuard discard_child([&] {
+        child_first_thread->drop_thread_count(true);
+    });
+
+    {
+        ProtectedDataMutationScope scope { *child };
+        if (params.flags & POSIX_SPAWN_RESETIDS) {
+            child->m_euid = uid();
+            child->m_egid = gid();
+        } else {
+            child->m_euid = euid();
+            child->m_egid = egid();
+        }
+        child->m_suid = child->m_euid;
+        child->m_sgid = child->m_egid;
+    }
+
+    if (params.flags & POSIX_SPAWN_SETPGROUP) {
+        auto pgid = params.pgroup ? ProcessGroupID(params.pgroup) : ProcessGroupID(child->pid().value());
+        if (params.pgroup && get_sid_from_pgid(pgid) != sid())
+            return EPERM;
+        child->m_pg = ProcessGroup::find_or_create(pgid);
+        if (!child->m_pg)
+            return ENOMEM;
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSID) {
+        child->m_pg = ProcessGroup::create(ProcessGroupID(child->pid().value()));
+        if (!child->m_pg)
+            return ENOMEM;
+        child->m_tty = nullptr;
+        ProtectedDataMutationScope scope { *child };
+        child->m_sid = child->pid().value();
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSCHEDPARAM)
+        child_first_thread->set_priority((u32)params.priority);
+
+    if (params.flags & POSIX_SPAWN_SETSIGDEF) {
+        for (size_t signal = 1; signal < NSIG; ++signal) {
+            if (params.sigdefault & (1u << (signal - 1)))
+                child_first_thread->m_signal_action_data[signal] = {};
+        }
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSIGMASK)
+        child_first_thread->m_signal_mask = params.sigmask;
+
+    // FIXME: POSIX_SPAWN_SETSCHEDULER
+
+    auto place_description = [&](int fd, NonnullRefPtr<FileDescription> description, u32 fd_flags) -> KResult {
+        if (fd < 0 || static_cast<size_t>(fd) >= child->fds().max_open())
+            return EBADF;
+        if (!child->m_fds.m_fds_metadatas[fd].is_allocated())
+            child->m_fds.m_fds_metadatas[fd].allocate();
+        child->m_fds[fd].set(move(description), fd_flags);
+        return KSuccess;
+    };
+
+    // NOTE: The file actions are carried out with our credentials and unveiled paths,
+    //       which the child shares unless POSIX_SPAWN_RESETIDS was given.
+    auto perform_file_action = [&](const Syscall::SC_posix_spawn_file_action& action) -> KResult {
+        switch (action.type) {
+        case Syscall::SpawnFileActionType::Open: {
+            auto action_path = get_syscall_path_argument(action.path);
+            if (action_path.is_error())
+                return action_path.error();
+            auto description_or_error = VirtualFileSystem::the().open(action_path.value()->view(), action.options, (action.mode & 0777) & ~child->umask(), child->current_directory());
+            if (description_or_error.is_error())
+                return description_or_error.error();
+            return place_description(action.fd, description_or_error.release_value(), (action.options & O_CLOEXEC) ? FD_CLOEXEC : 0);
+        }
+        case Syscall::SpawnFileActionType::Close:
+            if (!child->fds().file_description(action.fd))
+                return EBADF;
+            child->m_fds[action.fd] = {};
+            return KSuccess;
+        case Syscall::SpawnFileActionType::Dup2: {
+            auto description = child->fds().file_description(action.fd);
+            if (!description)
+                return EBADF;
+            if (action.fd == action.new_fd)
+                return KSuccess;
+            return place_description(action.new_fd, description.release_nonnull(), 0);
+        }
+        case Syscall::SpawnFileActionType::Chdir: {
+            auto action_path = get_syscall_path_argument(action.path);
+            if (action_path.is_error())
+                return action_path.error();
+            auto directory_or_error = VirtualFileSystem::the().open_directory(action_path.value()->view(), child->current_directory());
+            if (directory_or_error.is_error())
+                return directory_or_error.error();
+            child->m_cwd = *directory_or_error.value();
+            return KSuccess;
+        }
+        case Syscall::SpawnFileActionType::Fchdir: {
+            auto description = child->fds().file_description(action.fd);
+            if (!description)
+                return EBADF;
+            if (!description->is_directory())
+                return ENOTDIR;
+            if (!description->metadata().may_execute(*child))
+                return EACCES;
+            child->m_cwd = description->custody();
+            return KSuccess;
+        }
+        }
+        return EINVAL;
+    };
+
+    for (auto& action : file_actions) {
+        auto result = perform_file_action(action);
+        if (result.is_error())
+            return result;
+    }
+
+    // The terminal is handed over before the exec, as the child may start running right after it, and reading from the
+    // terminal while still in the background would stop it. It's taken back if the exec doesn't work out.
+    RefPtr<TTY> tty;
+    RefPtr<ProcessGroup> previous_foreground_process_group;
+    RefPtr<Process> previous_original_process_parent;
+    if (params.flags & POSIX_SPAWN_TCSETPGROUP) {
+        auto description = fds().file_description(params.tty_fd);
+        if (!description)
+            return EBADF;
+        if (!description->is_tty() || description->tty() != m_tty.ptr())
+            return ENOTTY;
+        tty = description->tty();
+        previous_foreground_process_group = tty->foreground_process_group();
+        previous_original_process_parent = tty->original_process_parent();
+
+        // Just like TIOCSPGRP, remember the parent of the process group's leader.
+        RefPtr<Process> original_process_parent = this;
+        if (child->pgid().value() != child->pid().value()) {
+            original_process_parent = nullptr;
+            if (auto leader = Process::from_pid(ProcessID(child->pgid().value())))
+                original_process_parent = Process::from_pid(leader->ppid());
+        }
+        tty->set_foreground_process_group(child->m_pg, original_process_parent);
+    }
+
+    dbgln_if(EXEC_DEBUG, "posix_spawn: child={}, path={}", child, path);
+
+    auto result = child->exec(move(path), move(arguments), move(environment));
+    // Loading the new program switched us over to the child's address space, so come back home.
+    MemoryManager::enter_process_paging_scope(*this);
+    if (result.is_error()) {
+        if (tty)
+            tty->set_foreground_process_group(previous_foreground_process_group, previous_original_process_parent);
+        return result;
+    }
+
+    discard_child.disarm();
+    Process::register_new(*child);
+    PerformanceManager::add_process_created_event(*child);
+
+    auto child_pid = child->pid().value();
+
+    // NOTE: All user processes have a leaked ref on them. It's balanced by Thread::WaitBlockCondition::finalize().
+    (void)child.leak_ref();
+
+    return child_pid;
+}
+
 }
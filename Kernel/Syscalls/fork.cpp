@@ -14,6 +14,31 @@
 
 namespace Kernel {
 
+void Process::copy_state_into_child(Process& child)
+{
+    child.m_root_directory = m_root_directory;
+    child.m_root_directory_relative_to_global_root = m_root_directory_relative_to_global_root;
+    child.m_veil_state = m_veil_state;
+    child.m_unveiled_paths = m_unveiled_paths.deep_copy();
+    child.m_fds = m_fds;
+    child.m_pg = m_pg;
+
+    {
+        ProtectedDataMutationScope scope { child };
+        child.m_promises = m_promises;
+        child.m_execpromises = m_execpromises;
+        child.m_has_promises = m_has_promises;
+        child.m_has_execpromises = m_has_execpromises;
+        child.m_sid = m_sid;
+        child.m_extra_gids = m_extra_gids;
+        child.m_umask = m_umask;
+        child.m_signal_trampoline = m_signal_trampoline;
+        child.m_dumpable = m_dumpable;
+    }
+
+    child.space().set_enforces_syscall_regions(space().enforces_syscall_regions());
+}
+
 KResultOr<FlatPtr> Process::sys$fork(RegisterState& regs)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -22,28 +47,9 @@ KResultOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     auto child = Process::create(child_first_thread, m_name, uid(), gid(), pid(), m_is_kernel_process, m_cwd, m_executable, m_tty, this);
     if (!child || !child_first_thread)
         return ENOMEM;
-    child->m_root_directory = m_root_directory;
-    child->m_root_directory_relative_to_global_root = m_root_directory_relative_to_global_root;
-    child->m_veil_state = m_veil_state;
-    child->m_unveiled_paths = m_unveiled_paths.deep_copy();
-    child->m_fds = m_fds;
-    child->m_pg = m_pg;
-
-    {
-        ProtectedDataMutationScope scope { *child };
-        child->m_promises = m_promises;
-        child->m_execpromises = m_execpromises;
-        child->m_has_promises = m_has_promises;
-        child->m_has_execpromises = m_has_execpromises;
-        child->m_sid = m_sid;
-        child->m_extra_gids = m_extra_gids;
-        child->m_umask = m_umask;
-        child->m_signal_trampoline = m_signal_trampoline;
-        child->m_dumpable = m_dumpable;
-    }
+    copy_state_into_child(*child);
 
     dbgln_if(FORK_DEBUG, "fork: child={}", child);
-    child->space().set_enforces_syscall_regions(space().enforces_syscall_regions());
 
 #if ARCH(I386)
     auto& child_regs = child_first_thread->m_regs;
@@ -93,6 +99,7 @@ KResultOr<FlatPtr> Process::sys$fork(RegisterState& regs)
 #endif
 
     {
+        MutexLocker space_locker(space_lock());
         ScopedSpinLock lock(space().get_lock());
         for (auto& region : space().regions()) {
             dbgln_if(FORK_DEBUG, "fork: cloning Region({}) '{}' @ {}", region, region->name(), region->vaddr());
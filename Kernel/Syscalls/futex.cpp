@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
 #include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Process.h>
@@ -11,8 +13,43 @@
 
 namespace Kernel {
 
-static SpinLock<u8> g_global_futex_lock;
-static AK::Singleton<HashMap<VMObject*, FutexQueues>> g_global_futex_queues;
+struct FutexKey {
+    // Private futexes are identified by their process and user space address,
+    // global futexes by their VMObject and the offset into it.
+    const void* object { nullptr };
+    FlatPtr user_address_or_offset { 0 };
+
+    bool operator==(const FutexKey& other) const { return object == other.object && user_address_or_offset == other.user_address_or_offset; }
+};
+
+}
+
+namespace AK {
+
+template<>
+struct Traits<Kernel::FutexKey> : public GenericTraits<Kernel::FutexKey> {
+    static unsigned hash(const Kernel::FutexKey& key) { return pair_int_hash(ptr_hash(key.object), ptr_hash(key.user_address_or_offset)); }
+};
+
+}
+
+namespace Kernel {
+
+// All futex queues live in one table of hash buckets, each guarded by a lock of its own,
+// so that threads using unrelated futexes don't contend with each other.
+struct FutexBucket {
+    RecursiveSpinLock lock;
+    HashMap<FutexKey, NonnullRefPtr<FutexQueue>> queues;
+};
+
+static constexpr size_t futex_bucket_count = 256;
+static AK::Singleton<Array<FutexBucket, futex_bucket_count>> s_futex_buckets;
+
+static FutexBucket& futex_bucket_for(const FutexKey& key)
+{
+    // The hash is mixed once more, as the maps inside the buckets use it to pick their slots as well.
+    return (*s_futex_buckets)[int_hash(Traits<FutexKey>::hash(key)) % futex_bucket_count];
+}
 
 FutexQueue::FutexQueue(FlatPtr user_address_or_offset, VMObject* vmobject)
     : m_user_address_or_offset(user_address_or_offset)
@@ -43,7 +80,7 @@ FutexQueue::~FutexQueue()
 void FutexQueue::vmobject_deleted(VMObject& vmobject)
 {
     VERIFY(m_is_global); // If we got called we must be a global futex
-    // Because we're taking ourselves out of the global queue, we need
+    // Because we're taking ourselves out of the futex table, we need
     // to make sure we have at last a reference until we're done
     NonnullRefPtr<FutexQueue> own_ref(*this);
 
@@ -56,8 +93,11 @@ void FutexQueue::vmobject_deleted(VMObject& vmobject)
     m_vmobject = nullptr; // Just to be safe...
 
     {
-        ScopedSpinLock lock(g_global_futex_lock);
-        g_global_futex_queues->remove(&vmobject);
+        FutexKey key { &vmobject, m_user_address_or_offset };
+        auto& bucket = futex_bucket_for(key);
+        ScopedSpinLock lock(bucket.lock);
+        if (auto it = bucket.queues.find(key); it != bucket.queues.end() && it->value.ptr() == this)
+            bucket.queues.remove(it);
     }
 
     bool did_wake_all;
@@ -73,18 +113,25 @@ void FutexQueue::vmobject_deleted(VMObject& vmobject)
 
 void Process::clear_futex_queues_on_exec()
 {
-    ScopedSpinLock lock(m_futex_lock);
-    for (auto& it : m_futex_queues) {
-        bool did_wake_all;
-        it.value->wake_all(did_wake_all);
-        VERIFY(did_wake_all); // No one should be left behind...
+    for (auto& bucket : *s_futex_buckets) {
+        ScopedSpinLock lock(bucket.lock);
+        Vector<FutexKey> keys_to_remove;
+        for (auto& it : bucket.queues) {
+            if (it.key.object != this)
+                continue;
+            bool did_wake_all;
+            it.value->wake_all(did_wake_all);
+            VERIFY(did_wake_all); // No one should be left behind...
+            keys_to_remove.append(it.key);
+        }
+        for (auto& key : keys_to_remove)
+            bucket.queues.remove(key);
     }
-    m_futex_queues.clear();
 }
 
 KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     Syscall::SC_futex_params params;
     if (!copy_from_user(&params, user_params))
         return EFAULT;
@@ -101,13 +148,15 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
     case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_CMP_REQUEUE:
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = copy_time_from_user(params.timeout);
             if (!timeout_time.has_value())
                 return EFAULT;
             bool is_absolute = cmd != FUTEX_WAIT;
-            clockid_t clock_id = use_realtime_clock ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+            // NOTE: Like on other systems, the timeout of FUTEX_LOCK_PI is always measured against the realtime clock.
+            clockid_t clock_id = (use_realtime_clock || cmd == FUTEX_LOCK_PI) ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time.value(), nullptr, clock_id);
         }
         if (cmd == FUTEX_WAIT_BITSET && params.val3 == FUTEX_BITSET_MATCH_ANY)
@@ -121,100 +170,80 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
     }
 
     bool is_private = (params.futex_op & FUTEX_PRIVATE_FLAG) != 0;
-    auto& queue_lock = is_private ? m_futex_lock : g_global_futex_lock;
-    auto user_address_or_offset = FlatPtr(params.userspace_address);
-    auto user_address_or_offset2 = FlatPtr(params.userspace_address2);
+    FutexKey key { this, FlatPtr(params.userspace_address) };
+    FutexKey key2 { this, FlatPtr(params.userspace_address2) };
 
-    // If this is a global lock, look up the underlying VMObject *before*
-    // acquiring the queue lock
+    // If this is a global futex, look up the underlying VMObject *before*
+    // acquiring any bucket lock
     RefPtr<VMObject> vmobject, vmobject2;
     if (!is_private) {
-        auto region = space().find_region_containing(Range { VirtualAddress { user_address_or_offset }, sizeof(u32) });
+        // NOTE: We don't hold the big lock, so keep the regions from going away while we look at them.
+        ScopedSpinLock locker(space().get_lock());
+        auto region = space().find_region_containing(Range { VirtualAddress { key.user_address_or_offset }, sizeof(u32) });
         if (!region)
             return EFAULT;
         vmobject = region->vmobject();
-        user_address_or_offset = region->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset));
+        key = { vmobject.ptr(), region->offset_in_vmobject_from_vaddr(VirtualAddress(key.user_address_or_offset)) };
 
         switch (cmd) {
         case FUTEX_REQUEUE:
         case FUTEX_CMP_REQUEUE:
         case FUTEX_WAKE_OP: {
-            auto region2 = space().find_region_containing(Range { VirtualAddress { user_address_or_offset2 }, sizeof(u32) });
+            auto region2 = space().find_region_containing(Range { VirtualAddress { key2.user_address_or_offset }, sizeof(u32) });
             if (!region2)
                 return EFAULT;
             vmobject2 = region2->vmobject();
-            user_address_or_offset2 = region->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset2));
+            key2 = { vmobject2.ptr(), region2->offset_in_vmobject_from_vaddr(VirtualAddress(key2.user_address_or_offset)) };
             break;
         }
         }
     }
 
-    auto find_global_futex_queues = [&](VMObject& vmobject, bool create_if_not_found) -> FutexQueues* {
-        auto& global_queues = *g_global_futex_queues;
-        auto it = global_queues.find(&vmobject);
-        if (it != global_queues.end())
-            return &it->value;
-        if (create_if_not_found) {
-            // TODO: is there a better way than setting and finding it again?
-            auto result = global_queues.set(&vmobject, {});
-            VERIFY(result == AK::HashSetResult::InsertedNewEntry);
-            it = global_queues.find(&vmobject);
-            VERIFY(it != global_queues.end());
-            return &it->value;
-        }
-        return nullptr;
-    };
-
-    auto find_futex_queue = [&](VMObject* vmobject, FlatPtr user_address_or_offset, bool create_if_not_found, bool* did_create = nullptr) -> RefPtr<FutexQueue> {
-        VERIFY(is_private || vmobject);
+    // NOTE: The lock of the key's bucket has to be held while calling these.
+    auto find_futex_queue = [&](const FutexKey& key, VMObject* vmobject, bool create_if_not_found, bool* did_create = nullptr) -> RefPtr<FutexQueue> {
+        VERIFY(is_private || vmobject || !create_if_not_found);
         VERIFY(!create_if_not_found || did_create != nullptr);
-        auto* queues = is_private ? &m_futex_queues : find_global_futex_queues(*vmobject, create_if_not_found);
-        if (!queues)
-            return {};
-        auto it = queues->find(user_address_or_offset);
-        if (it != queues->end())
+        auto& queues = futex_bucket_for(key).queues;
+        if (auto it = queues.find(key); it != queues.end())
             return it->value;
         if (create_if_not_found) {
             *did_create = true;
-            auto futex_queue = adopt_ref(*new FutexQueue(user_address_or_offset, vmobject));
-            auto result = queues->set(user_address_or_offset, futex_queue);
+            auto futex_queue = adopt_ref(*new FutexQueue(key.user_address_or_offset, vmobject));
+            auto result = queues.set(key, futex_queue);
             VERIFY(result == AK::HashSetResult::InsertedNewEntry);
             return futex_queue;
         }
         return {};
     };
 
-    auto remove_futex_queue = [&](VMObject* vmobject, FlatPtr user_address_or_offset) {
-        auto* queues = is_private ? &m_futex_queues : find_global_futex_queues(*vmobject, false);
-        if (queues) {
-            if (auto it = queues->find(user_address_or_offset); it != queues->end()) {
-                if (it->value->try_remove()) {
-                    it->value->did_remove();
-                    queues->remove(it);
-                }
+    auto remove_futex_queue = [&](const FutexKey& key) {
+        auto& queues = futex_bucket_for(key).queues;
+        if (auto it = queues.find(key); it != queues.end()) {
+            if (it->value->try_remove()) {
+                it->value->did_remove();
+                queues.remove(it);
             }
-            if (!is_private && queues->is_empty())
-                g_global_futex_queues->remove(vmobject);
         }
     };
 
-    auto do_wake = [&](VMObject* vmobject, FlatPtr user_address_or_offset, u32 count, Optional<u32> bitmask) -> int {
+    auto do_wake = [&](const FutexKey& key, u32 count, Optional<u32> bitmask) -> int {
         if (count == 0)
             return 0;
-        ScopedSpinLock lock(queue_lock);
-        auto futex_queue = find_futex_queue(vmobject, user_address_or_offset, false);
+        ScopedSpinLock lock(futex_bucket_for(key).lock);
+        auto futex_queue = find_futex_queue(key, nullptr, false);
         if (!futex_queue)
             return 0;
         bool is_empty;
         u32 woke_count = futex_queue->wake_n(count, bitmask, is_empty);
         if (is_empty) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(vmobject, user_address_or_offset);
+            remove_futex_queue(key);
         }
         return (int)woke_count;
     };
 
     auto do_wait = [&](u32 bitset) -> int {
+        auto& bucket = futex_bucket_for(key);
         bool did_create;
         RefPtr<FutexQueue> futex_queue;
         do {
@@ -227,9 +256,9 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
             }
             atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
-            ScopedSpinLock lock(queue_lock);
+            ScopedSpinLock lock(bucket.lock);
             did_create = false;
-            futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, true, &did_create);
+            futex_queue = find_futex_queue(key, vmobject.ptr(), true, &did_create);
             VERIFY(futex_queue);
             // We need to try again if we didn't create this queue and the existing queue
             // was removed before we were able to queue an imminent wait.
@@ -240,10 +269,10 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
 
         Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset);
 
-        ScopedSpinLock lock(queue_lock);
+        ScopedSpinLock lock(bucket.lock);
         if (futex_queue->is_empty_and_no_imminent_waits()) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(vmobject, user_address_or_offset);
+            remove_futex_queue(key);
         }
         if (block_result == Thread::BlockResult::InterruptedByTimeout) {
             return ETIMEDOUT;
@@ -259,9 +288,15 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
             return EAGAIN;
         atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
+        // Always take the two bucket locks in the same order, so that requeues
+        // in opposite directions can't deadlock. Both futexes may also share a bucket.
+        auto& bucket = futex_bucket_for(key);
+        auto& bucket2 = futex_bucket_for(key2);
+        ScopedSpinLock lock(&bucket < &bucket2 ? bucket.lock : bucket2.lock);
+        ScopedSpinLock lock2(&bucket < &bucket2 ? bucket2.lock : bucket.lock);
+
         int woken_or_requeued = 0;
-        ScopedSpinLock lock(queue_lock);
-        if (auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, false)) {
+        if (auto futex_queue = find_futex_queue(key, vmobject.ptr(), false)) {
             RefPtr<FutexQueue> target_futex_queue;
             bool is_empty, is_target_empty;
             woken_or_requeued = futex_queue->wake_n_requeue(
@@ -269,24 +304,142 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
                     // NOTE: futex_queue's lock is being held while this callback is called
                     // The reason we're doing this in a callback is that we don't want to always
                     // create a target queue, only if we actually have anything to move to it!
-                    target_futex_queue = find_futex_queue(vmobject2.ptr(), user_address_or_offset2, true);
+                    bool did_create = false;
+                    target_futex_queue = find_futex_queue(key2, vmobject2.ptr(), true, &did_create);
                     return target_futex_queue.ptr();
                 },
                 params.val2, is_empty, is_target_empty);
             if (is_empty)
-                remove_futex_queue(vmobject, user_address_or_offset);
+                remove_futex_queue(key);
             if (is_target_empty && target_futex_queue)
-                remove_futex_queue(vmobject2, user_address_or_offset2);
+                remove_futex_queue(key2);
         }
         return woken_or_requeued;
     };
 
+    // Priority-inheriting futexes hold the thread ID of their owner, and FUTEX_WAITERS once somebody
+    // had to wait for them. Userspace takes an unowned futex by exchanging 0 for its thread ID and
+    // releases it by exchanging the thread ID for 0; everything else goes through the kernel, which
+    // hands the futex directly over to the next waiter.
+    // NOTE: The futex word is only ever modified with the bucket lock held, and it is faulted in
+    //       for writing beforehand so that accessing it doesn't page fault with the lock held.
+    auto do_lock_pi = [&](bool try_only) -> int {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        if (!user_atomic_fetch_or_relaxed(params.userspace_address, 0).has_value())
+            return EFAULT;
+
+        auto& bucket = futex_bucket_for(key);
+        for (;;) {
+            RefPtr<FutexQueue> futex_queue;
+            {
+                ScopedSpinLock lock(bucket.lock);
+                auto user_value = user_atomic_load_relaxed(params.userspace_address);
+                if (!user_value.has_value())
+                    return EFAULT;
+                u32 value = user_value.value();
+                u32 owner_tid = value & FUTEX_TID_MASK;
+                if (owner_tid == tid)
+                    return EDEADLK;
+
+                if (owner_tid == 0) {
+                    // Nobody owns the futex. We keep FUTEX_WAITERS, so that whoever else is waiting still gets woken up later.
+                    u32 expected = value;
+                    auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, tid | (value & FUTEX_WAITERS));
+                    if (!did_exchange.has_value())
+                        return EFAULT;
+                    if (!did_exchange.value())
+                        continue;
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+
+                if (try_only)
+                    return EAGAIN;
+
+                if (!(value & FUTEX_WAITERS)) {
+                    u32 expected = value;
+                    auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, value | FUTEX_WAITERS);
+                    if (!did_exchange.has_value())
+                        return EFAULT;
+                    if (!did_exchange.value())
+                        continue;
+                }
+
+                bool did_create = false;
+                futex_queue = find_futex_queue(key, vmobject.ptr(), true, &did_create);
+                VERIFY(futex_queue);
+                if (!did_create && !futex_queue->queue_imminent_wait())
+                    continue;
+
+                // Lend our priority to the owner until it has released the futex, so that it
+                // can't be kept from doing so by threads of a priority between ours and its own.
+                auto owner = Thread::from_tid(owner_tid);
+                if (owner && owner->process().euid() == euid() && owner->priority() < current_thread->priority())
+                    owner->set_priority_boost(current_thread->priority());
+            }
+
+            Thread::BlockResult block_result = futex_queue->wait_on(timeout, FUTEX_BITSET_MATCH_ANY);
+
+            ScopedSpinLock lock(bucket.lock);
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(key);
+
+            // Whoever released the futex may have handed it over to us, even if we timed out in the meantime.
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            if ((user_value.value() & FUTEX_TID_MASK) == tid) {
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                return 0;
+            }
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result == Thread::BlockResult::InterruptedBySignal)
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> int {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        if (!user_atomic_fetch_or_relaxed(params.userspace_address, 0).has_value())
+            return EFAULT;
+
+        ScopedSpinLock lock(futex_bucket_for(key).lock);
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != tid)
+            return EPERM;
+
+        u32 new_value = 0;
+        if (auto futex_queue = find_futex_queue(key, nullptr, false)) {
+            bool is_empty;
+            auto new_owner_tid = futex_queue->wake_one_for_handover(is_empty);
+            if (new_owner_tid.has_value())
+                new_value = (u32)new_owner_tid.value().value();
+            if (!is_empty)
+                new_value |= FUTEX_WAITERS;
+            else
+                remove_futex_queue(key);
+        }
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_store_relaxed(params.userspace_address, new_value))
+            return EFAULT;
+
+        // FIXME: This also drops the priority lent to us through other futexes that we still hold.
+        current_thread->set_priority_boost(0);
+        return 0;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
 
     case FUTEX_WAKE:
-        return do_wake(vmobject.ptr(), user_address_or_offset, params.val, {});
+        return do_wake(key, params.val, {});
 
     case FUTEX_WAKE_OP: {
         Optional<u32> oldval;
@@ -294,7 +447,7 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
         auto op = _FUTEX_OP(params.val3);
         if (op & FUTEX_OP_ARG_SHIFT) {
             op_arg = 1 << op_arg;
-            op &= FUTEX_OP_ARG_SHIFT;
+            op &= ~FUTEX_OP_ARG_SHIFT;
         }
         atomic_thread_fence(AK::MemoryOrder::memory_order_release);
         switch (op) {
@@ -319,7 +472,7 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
         if (!oldval.has_value())
             return EFAULT;
         atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
-        int result = do_wake(vmobject.ptr(), user_address_or_offset, params.val, {});
+        int result = do_wake(key, params.val, {});
         if (params.val2 > 0) {
             bool compare_result;
             switch (_FUTEX_CMP(params.val3)) {
@@ -345,7 +498,7 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
                 return EINVAL;
             }
             if (compare_result)
-                result += do_wake(vmobject2.ptr(), user_address_or_offset2, params.val2, {});
+                result += do_wake(key2, params.val2, {});
         }
         return result;
     }
@@ -362,11 +515,20 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
             return EINVAL;
         return do_wait(params.val3);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAKE_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAKE
         if (params.val3 == 0)
             return EINVAL;
-        return do_wake(vmobject.ptr(), user_address_or_offset, params.val, params.val3);
+        return do_wake(key, params.val, params.val3);
     }
     return ENOSYS;
 }
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+KResultOr<FlatPtr> Process::sys$io_ring_create(u32 entry_count, int options)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto new_fd_or_error = m_fds.allocate();
+    if (new_fd_or_error.is_error())
+        return new_fd_or_error.error();
+    auto new_fd = new_fd_or_error.release_value();
+
+    auto ring_or_error = IORing::try_create(entry_count);
+    if (ring_or_error.is_error())
+        return ring_or_error.error();
+
+    auto description_or_error = FileDescription::create(*ring_or_error.value());
+    if (description_or_error.is_error())
+        return description_or_error.error();
+
+    auto description = description_or_error.release_value();
+    description->set_readable(true);
+    description->set_writable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    m_fds[new_fd.fd].set(move(description), fd_flags);
+    return new_fd.fd;
+}
+
+KResultOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 min_completions)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->file().is_io_ring())
+        return EINVAL;
+    auto& ring = static_cast<IORing&>(description->file());
+
+    auto submitted_or_error = ring.submit(*this);
+    if (submitted_or_error.is_error())
+        return submitted_or_error.error();
+
+    if (min_completions) {
+        if (auto result = ring.wait_for_completions(min_completions); result.is_error() && submitted_or_error.value() == 0)
+            return result;
+    }
+    return submitted_or_error.value();
+}
+
+}
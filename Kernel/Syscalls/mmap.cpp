@@ -18,6 +18,7 @@
 #include <Kernel/VM/PrivateInodeVMObject.h>
 #include <Kernel/VM/Region.h>
 #include <Kernel/VM/SharedInodeVMObject.h>
+#include <Kernel/VM/TLBGather.h>
 #include <LibC/limits.h>
 #include <LibELF/Validation.h>
 
@@ -128,8 +129,9 @@ static bool validate_inode_mmap_prot(const Process& process, int prot, const Ino
 
 KResultOr<FlatPtr> Process::sys$mmap(Userspace<const Syscall::SC_mmap_params*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     Syscall::SC_mmap_params params;
     if (!copy_from_user(&params, user_params))
@@ -291,8 +293,9 @@ static KResultOr<Range> expand_range_to_page_boundaries(FlatPtr address, size_t
 
 KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int prot)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     if (prot & PROT_EXEC) {
         REQUIRE_PROMISE(prot_exec);
@@ -346,7 +349,10 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
         auto region = space().take_region(*old_region);
 
         // Unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No);
+        // The TLB is flushed once all the new regions are mapped (or on error, when the gather goes out of scope).
+        TLBGather tlb_gather(space().page_directory());
+        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No, ShouldFlushTLB::No);
+        tlb_gather.add(region->range());
 
         // This vector is the region(s) adjacent to our range.
         // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -366,9 +372,9 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
 
         // Map the new regions using our page directory (they were just allocated and don't have one).
         for (auto* adjacent_region : adjacent_regions) {
-            adjacent_region->map(space().page_directory());
+            adjacent_region->map(space().page_directory(), ShouldFlushTLB::No);
         }
-        new_region.map(space().page_directory());
+        new_region.map(space().page_directory(), ShouldFlushTLB::No);
         return 0;
     }
 
@@ -392,7 +398,8 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
         if (full_size_found != range_to_mprotect.size())
             return ENOMEM;
 
-        // then do all the other stuff
+        // then do all the other stuff, flushing the TLB only once at the end
+        TLBGather tlb_gather(space().page_directory());
         for (auto* old_region : regions) {
             const auto intersection_to_mprotect = range_to_mprotect.intersect(old_region->range());
             // full sub region
@@ -401,7 +408,8 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
                 old_region->set_writable(prot & PROT_WRITE);
                 old_region->set_executable(prot & PROT_EXEC);
 
-                old_region->remap();
+                old_region->remap(ShouldFlushTLB::No);
+                tlb_gather.add(old_region->range());
                 continue;
             }
             // Remove the old region from our regions tree, since were going to add another region
@@ -409,7 +417,8 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
             auto region = space().take_region(*old_region);
 
             // Unmap the old region here, specifying that we *don't* want the VM deallocated.
-            region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No);
+            region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No, ShouldFlushTLB::No);
+            tlb_gather.add(region->range());
 
             // This vector is the region(s) adjacent to our range.
             // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -433,9 +442,9 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
 
             // Map the new region using our page directory (they were just allocated and don't have one) if any.
             if (adjacent_regions.size())
-                adjacent_regions[0]->map(space().page_directory());
+                adjacent_regions[0]->map(space().page_directory(), ShouldFlushTLB::No);
 
-            new_region.map(space().page_directory());
+            new_region.map(space().page_directory(), ShouldFlushTLB::No);
         }
 
         return 0;
@@ -446,8 +455,9 @@ KResultOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int
 
 KResultOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int advice)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     auto range_or_error = expand_range_to_page_boundaries(address, size);
     if (range_or_error.is_error())
@@ -487,8 +497,9 @@ KResultOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, i
 
 KResultOr<FlatPtr> Process::sys$set_mmap_name(Userspace<const Syscall::SC_set_mmap_name_params*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     Syscall::SC_set_mmap_name_params params;
     if (!copy_from_user(&params, user_params))
@@ -522,8 +533,9 @@ KResultOr<FlatPtr> Process::sys$set_mmap_name(Userspace<const Syscall::SC_set_mm
 
 KResultOr<FlatPtr> Process::sys$munmap(Userspace<void*> addr, size_t size)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     auto result = space().unmap_mmap_range(VirtualAddress { addr }, size);
     if (result.is_error())
@@ -533,8 +545,9 @@ KResultOr<FlatPtr> Process::sys$munmap(Userspace<void*> addr, size_t size)
 
 KResultOr<FlatPtr> Process::sys$mremap(Userspace<const Syscall::SC_mremap_params*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     Syscall::SC_mremap_params params {};
     if (!copy_from_user(&params, user_params))
@@ -585,6 +598,7 @@ KResultOr<FlatPtr> Process::sys$allocate_tls(Userspace<const char*> initial_data
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
     REQUIRE_PROMISE(stdio);
+    MutexLocker space_locker(space_lock());
 
     if (!size || size % PAGE_SIZE != 0)
         return EINVAL;
@@ -646,6 +660,7 @@ KResultOr<FlatPtr> Process::sys$allocate_tls(Userspace<const char*> initial_data
 KResultOr<FlatPtr> Process::sys$msyscall(Userspace<void*> address)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    MutexLocker space_locker(space_lock());
     if (space().enforces_syscall_regions())
         return EPERM;
 
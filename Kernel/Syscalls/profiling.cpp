@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/CoreDump.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -16,6 +17,32 @@ namespace Kernel {
 bool g_profiling_all_threads;
 PerformanceEventBuffer* g_global_perf_events;
 u64 g_profiling_event_mask;
+static bool s_global_profiling_uses_performance_counters;
+
+// Event types that need a hardware counter which this CPU doesn't have are silently ignored,
+// so that e.g. PERF_EVENT_MASK_ALL keeps working everywhere.
+static bool enable_performance_counters(u64 event_mask, bool& uses_performance_counters)
+{
+    if (uses_performance_counters) {
+        PerformanceCounters::disable();
+        uses_performance_counters = false;
+    }
+    auto hardware_event_mask = event_mask & PerformanceCounters::supported_event_mask();
+    if (!hardware_event_mask)
+        return true;
+    if (PerformanceCounters::enable(hardware_event_mask).is_error())
+        return false;
+    uses_performance_counters = true;
+    return true;
+}
+
+static void disable_performance_counters(bool& uses_performance_counters)
+{
+    if (!uses_performance_counters)
+        return;
+    PerformanceCounters::disable();
+    uses_performance_counters = false;
+}
 
 KResultOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, u64 event_mask)
 {
@@ -25,6 +52,8 @@ KResultOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, u64 event_mask)
     if (pid == -1) {
         if (!is_superuser())
             return EPERM;
+        if (!enable_performance_counters(event_mask, s_global_profiling_uses_performance_counters))
+            return ENOTSUP;
         ScopedCritical critical;
         g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
         if (g_global_perf_events)
@@ -64,6 +93,9 @@ KResultOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, u64 event_mask)
         process->set_profiling(false);
         return ENOTSUP;
     }
+    lock.unlock();
+    if (!enable_performance_counters(event_mask, process->m_uses_performance_counters))
+        return ENOTSUP;
     return 0;
 }
 
@@ -75,6 +107,7 @@ KResultOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     if (pid == -1) {
         if (!is_superuser())
             return EPERM;
+        disable_performance_counters(s_global_profiling_uses_performance_counters);
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
@@ -94,6 +127,8 @@ KResultOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
     process->set_profiling(false);
+    lock.unlock();
+    disable_performance_counters(process->m_uses_performance_counters);
     return 0;
 }
 
@@ -129,4 +164,49 @@ KResultOr<FlatPtr> Process::sys$profiling_free_buffer(pid_t pid)
     process->delete_perf_events_buffer();
     return 0;
 }
+
+KResultOr<FlatPtr> Process::sys$profiling_read(pid_t pid, Userspace<u8*> user_buffer, size_t size)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_NO_PROMISES;
+
+    auto buffer = UserOrKernelBuffer::for_user_buffer(user_buffer, size);
+    if (!buffer.has_value())
+        return EFAULT;
+
+    if (pid == -1) {
+        if (!is_superuser())
+            return EPERM;
+        if (!g_global_perf_events)
+            return ENOENT;
+        return g_global_perf_events->read_events(buffer.value(), size);
+    }
+
+    RefPtr<Process> process;
+    {
+        ScopedSpinLock lock(g_processes_lock);
+        process = Process::from_pid(pid);
+    }
+    if (!process)
+        return ESRCH;
+    if (!is_superuser() && process->uid() != euid())
+        return EPERM;
+    auto* perf_events = process->perf_events();
+    if (!perf_events)
+        return ENOENT;
+    return perf_events->read_events(buffer.value(), size);
+}
+
+KResultOr<FlatPtr> Process::sys$profiling_set_sampling_frequency(unsigned frequency)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_NO_PROMISES;
+
+    if (frequency == 0 || frequency > MAX_PROFILE_TICKS_PER_SECOND_RATE)
+        return EINVAL;
+    if (!TimeManagement::the().set_profile_timer_frequency(frequency))
+        return ENOTSUP;
+    return 0;
+}
+
 }
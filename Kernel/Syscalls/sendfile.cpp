@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCPSocket.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Anything other than a TCP socket is written to through a bounce buffer of this size.
+static constexpr size_t sendfile_buffer_size = 64 * KiB;
+
+KResultOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    REQUIRE_PROMISE(stdio);
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto out_description = fds().file_description(out_fd);
+    if (!out_description)
+        return EBADF;
+    if (!out_description->is_writable())
+        return EBADF;
+    auto in_description = fds().file_description(in_fd);
+    if (!in_description)
+        return EBADF;
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    if (!in_description->inode() || !in_description->file().is_seekable())
+        return EINVAL;
+
+    off_t offset;
+    if (user_offset) {
+        if (!copy_from_user(&offset, user_offset))
+            return EFAULT;
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    // Never read past the end of the file, so that a short read means that it was truncated.
+    off_t file_size = in_description->metadata().size;
+    if (offset >= file_size)
+        return 0;
+    count = min<u64>(count, file_size - offset);
+
+    size_t total_sent = 0;
+    auto* socket = out_description->socket();
+    if (socket && socket->is_ipv4() && socket->type() == SOCK_STREAM) {
+        if (socket->is_shut_down_for_writing())
+            return EPIPE;
+        auto nsent_or_error = static_cast<TCPSocket&>(*socket).send_file_data(*out_description, *in_description, offset, count);
+        if (nsent_or_error.is_error())
+            return nsent_or_error.error();
+        total_sent = nsent_or_error.value();
+    } else {
+        auto buffer = KBuffer::try_create_with_size(min(count, sendfile_buffer_size));
+        if (!buffer)
+            return ENOMEM;
+        while (total_sent < count) {
+            auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+            auto nread_or_error = in_description->read(chunk_buffer, offset + total_sent, min(count - total_sent, buffer->size()));
+            if (nread_or_error.is_error()) {
+                if (total_sent > 0)
+                    break;
+                return nread_or_error.error();
+            }
+            if (nread_or_error.value() == 0)
+                break;
+            auto nwritten_or_error = do_write(*out_description, chunk_buffer, nread_or_error.value());
+            if (nwritten_or_error.is_error()) {
+                if (total_sent > 0)
+                    break;
+                return nwritten_or_error.error();
+            }
+            total_sent += nwritten_or_error.value();
+            if (nwritten_or_error.value() < nread_or_error.value())
+                break;
+        }
+    }
+
+    offset += total_sent;
+    if (user_offset) {
+        if (!copy_to_user(user_offset, &offset))
+            return EFAULT;
+    } else {
+        auto seek_result = in_description->seek(offset, SEEK_SET);
+        if (seek_result.is_error())
+            return seek_result.error();
+    }
+    return total_sent;
+}
+
+}
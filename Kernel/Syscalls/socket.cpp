@@ -184,14 +184,8 @@ KResultOr<FlatPtr> Process::sys$shutdown(int sockfd, int how)
     return socket.shutdown(how);
 }
 
-KResultOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*> user_msg, int flags)
+static KResultOr<size_t> send_message(FileDescription& description, Socket& socket, const msghdr& msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
-    REQUIRE_PROMISE(stdio);
-    struct msghdr msg;
-    if (!copy_from_user(&msg, user_msg))
-        return EFAULT;
-
     if (msg.msg_iovlen != 1)
         return ENOTSUP; // FIXME: Support this :)
     Vector<iovec, 1> iovs;
@@ -205,29 +199,16 @@ KResultOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghd
     Userspace<const sockaddr*> user_addr((FlatPtr)msg.msg_name);
     socklen_t addr_length = msg.msg_namelen;
 
-    auto description = fds().file_description(sockfd);
-    if (!description)
-        return EBADF;
-    if (!description->is_socket())
-        return ENOTSOCK;
-    auto& socket = *description->socket();
     if (socket.is_shut_down_for_writing())
         return EPIPE;
     auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len);
     if (!data_buffer.has_value())
         return EFAULT;
-    auto result = socket.sendto(*description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, addr_length);
-    if (result.is_error())
-        return result.error();
-    else
-        return result.release_value();
+    return socket.sendto(description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, addr_length);
 }
 
-KResultOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user_msg, int flags)
+static KResultOr<size_t> receive_message(FileDescription& description, Socket& socket, Userspace<struct msghdr*> user_msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
-    REQUIRE_PROMISE(stdio);
-
     struct msghdr msg;
     if (!copy_from_user(&msg, user_msg))
         return EFAULT;
@@ -243,27 +224,20 @@ KResultOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> us
     Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
     Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
 
-    auto description = fds().file_description(sockfd);
-    if (!description)
-        return EBADF;
-    if (!description->is_socket())
-        return ENOTSOCK;
-    auto& socket = *description->socket();
-
     if (socket.is_shut_down_for_reading())
         return 0;
 
-    bool original_blocking = description->is_blocking();
+    bool original_blocking = description.is_blocking();
     if (flags & MSG_DONTWAIT)
-        description->set_blocking(false);
+        description.set_blocking(false);
 
     auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len);
     if (!data_buffer.has_value())
         return EFAULT;
     Time timestamp {};
-    auto result = socket.recvfrom(*description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp);
+    auto result = socket.recvfrom(description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp);
     if (flags & MSG_DONTWAIT)
-        description->set_blocking(original_blocking);
+        description.set_blocking(original_blocking);
 
     if (result.is_error())
         return result.error();
@@ -298,6 +272,113 @@ KResultOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> us
     return result.value();
 }
 
+KResultOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*> user_msg, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
+    REQUIRE_PROMISE(stdio);
+    struct msghdr msg;
+    if (!copy_from_user(&msg, user_msg))
+        return EFAULT;
+
+    auto description = fds().file_description(sockfd);
+    if (!description)
+        return EBADF;
+    if (!description->is_socket())
+        return ENOTSOCK;
+    auto result = send_message(*description, *description->socket(), msg, flags);
+    if (result.is_error())
+        return result.error();
+    else
+        return result.release_value();
+}
+
+KResultOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user_msg, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(sockfd);
+    if (!description)
+        return EBADF;
+    if (!description->is_socket())
+        return ENOTSOCK;
+    auto result = receive_message(*description, *description->socket(), user_msg, flags);
+    if (result.is_error())
+        return result.error();
+    return result.value();
+}
+
+// Just like Linux, the number of messages handled by one call is limited to UIO_MAXIOV.
+static constexpr unsigned max_message_count = 1024;
+
+KResultOr<FlatPtr> Process::sys$sendmmsg(int sockfd, Userspace<struct mmsghdr*> user_msgs, unsigned message_count, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(sockfd);
+    if (!description)
+        return EBADF;
+    if (!description->is_socket())
+        return ENOTSOCK;
+    auto& socket = *description->socket();
+
+    message_count = min(message_count, max_message_count);
+    unsigned sent_count = 0;
+    for (; sent_count < message_count; ++sent_count) {
+        auto* user_msg = user_msgs.unsafe_userspace_ptr() + sent_count;
+        struct msghdr msg;
+        if (!copy_from_user(&msg, &user_msg->msg_hdr))
+            return EFAULT;
+        auto result = send_message(*description, socket, msg, flags);
+        if (result.is_error()) {
+            // An error is only reported if no message was sent at all, the caller will run into it again otherwise.
+            if (sent_count > 0)
+                break;
+            return result.error();
+        }
+        unsigned length = result.value();
+        if (!copy_to_user(&user_msg->msg_len, &length))
+            return EFAULT;
+    }
+    return sent_count;
+}
+
+KResultOr<FlatPtr> Process::sys$recvmmsg(int sockfd, Userspace<struct mmsghdr*> user_msgs, unsigned message_count, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this)
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(sockfd);
+    if (!description)
+        return EBADF;
+    if (!description->is_socket())
+        return ENOTSOCK;
+    auto& socket = *description->socket();
+
+    message_count = min(message_count, max_message_count);
+    unsigned received_count = 0;
+    for (; received_count < message_count; ++received_count) {
+        auto* user_msg = user_msgs.unsafe_userspace_ptr() + received_count;
+        // Only the first message is waited for, after that we only take what is already there.
+        auto message_flags = received_count > 0 ? flags | MSG_DONTWAIT : flags;
+        auto result = receive_message(*description, socket, Userspace<struct msghdr*>((FlatPtr)&user_msg->msg_hdr), message_flags);
+        if (result.is_error()) {
+            if (received_count > 0)
+                break;
+            return result.error();
+        }
+        unsigned length = result.value();
+        if (!copy_to_user(&user_msg->msg_len, &length))
+            return EFAULT;
+        if (socket.is_shut_down_for_reading()) {
+            ++received_count;
+            break;
+        }
+    }
+    return received_count;
+}
+
 template<bool sockname, typename Params>
 int Process::get_sock_or_peer_name(const Params& params)
 {
@@ -360,6 +360,18 @@ void TTY::flush_input()
     evaluate_block_conditions();
 }
 
+RefPtr<Process> TTY::original_process_parent() const
+{
+    return m_original_process_parent.strong_ref();
+}
+
+void TTY::set_foreground_process_group(RefPtr<ProcessGroup> const& process_group, RefPtr<Process> const& original_process_parent)
+{
+    InterruptDisabler disabler;
+    m_pg = process_group;
+    m_original_process_parent = original_process_parent;
+}
+
 KResult TTY::set_termios(const termios& t)
 {
     KResult rc = KSuccess;
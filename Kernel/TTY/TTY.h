@@ -40,6 +40,12 @@ public:
         return 0;
     }
 
+    RefPtr<ProcessGroup> foreground_process_group() const { return m_pg.strong_ref(); }
+    RefPtr<Process> original_process_parent() const;
+    // This skips the checks of TIOCSPGRP, which is for posix_spawn(): it hands the terminal over to its child's process
+    // group before anyone else gets to see the child, and has checked everything itself.
+    void set_foreground_process_group(RefPtr<ProcessGroup> const&, RefPtr<Process> const& original_process_parent);
+
     KResult set_termios(const termios&);
     bool should_generate_signals() const { return m_termios.c_lflag & ISIG; }
     bool should_flush_on_signal() const { return !(m_termios.c_lflag & NOFLSH); }
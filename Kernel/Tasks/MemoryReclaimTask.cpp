@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NonnullRefPtrVector.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Devices/MemoryPressureDevice.h>
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryReclaimTask.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VM/InodeVMObject.h>
+#include <Kernel/VM/MemoryManager.h>
+
+namespace Kernel {
+
+// How often the memory pressure level is checked. It's checked more often while there is pressure, so that memory is
+// given back quickly enough to keep allocations from failing.
+static constexpr i64 poll_interval_ms = 250;
+static constexpr i64 poll_interval_under_pressure_ms = 50;
+
+template<typename VMObjectType, typename Filter>
+static NonnullRefPtrVector<VMObjectType> collect_vmobjects(Filter filter)
+{
+    NonnullRefPtrVector<VMObjectType> vmobjects;
+    MM.for_each_vmobject([&](auto& vmobject) {
+        if (filter(vmobject)) {
+            if (!vmobjects.try_append(static_cast<VMObjectType&>(vmobject)))
+                return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    return vmobjects;
+}
+
+static size_t purge_volatile_memory()
+{
+    auto vmobjects = collect_vmobjects<AnonymousVMObject>([](VMObject& vmobject) {
+        if (!vmobject.is_anonymous())
+            return false;
+        auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+        return anonymous_vmobject.is_purgeable() && anonymous_vmobject.is_volatile();
+    });
+    size_t purged_page_count = 0;
+    for (auto& vmobject : vmobjects) {
+        if (!MM.is_under_memory_pressure())
+            break;
+        purged_page_count += vmobject.purge();
+    }
+    return purged_page_count;
+}
+
+static size_t release_clean_inode_pages()
+{
+    auto vmobjects = collect_vmobjects<InodeVMObject>([](VMObject& vmobject) {
+        return vmobject.is_inode();
+    });
+    size_t released_page_count = 0;
+    for (auto& vmobject : vmobjects) {
+        if (MM.memory_pressure_level() != MemoryPressureLevel::Critical)
+            break;
+        released_page_count += vmobject.release_all_clean_pages();
+    }
+    return released_page_count;
+}
+
+static void reclaim_memory()
+{
+    // Volatile memory is there to be given back, so it goes first. Clean file pages and disk cache blocks can always be
+    // read again, but only by going to the disk, so they're left alone until the pressure is critical.
+    auto purged_page_count = purge_volatile_memory();
+    dbgln_if(MEMORY_RECLAIM_DEBUG, "MemoryReclaimTask: Purged {} volatile pages", purged_page_count);
+    if (MM.memory_pressure_level() != MemoryPressureLevel::Critical)
+        return;
+
+    auto released_page_count = release_clean_inode_pages();
+    dbgln_if(MEMORY_RECLAIM_DEBUG, "MemoryReclaimTask: Released {} clean inode pages", released_page_count);
+    if (MM.memory_pressure_level() != MemoryPressureLevel::Critical)
+        return;
+
+    FileSystem::shrink_caches();
+}
+
+static void memory_reclaim_task(void*)
+{
+    // Keeps volatile memory and caches from piling up until an allocation runs out of pages, at which point
+    // MemoryManager would have to purge on the faulting thread while it waits.
+    for (;;) {
+        auto level = MM.memory_pressure_level();
+        // Userspace gets to hear about it first, so that it can shrink its caches while we're at it.
+        if (auto* device = MemoryPressureDevice::the())
+            device->set_level(level);
+        if (level != MemoryPressureLevel::None)
+            reclaim_memory();
+        (void)Thread::current()->sleep(Time::from_milliseconds(level == MemoryPressureLevel::None ? poll_interval_ms : poll_interval_under_pressure_ms));
+    }
+}
+
+UNMAP_AFTER_INIT void MemoryReclaimTask::spawn()
+{
+    RefPtr<Thread> memory_reclaim_thread;
+    auto memory_reclaim_process = Process::create_kernel_process(memory_reclaim_thread, "MemoryReclaimTask", memory_reclaim_task, nullptr);
+    VERIFY(memory_reclaim_process);
+}
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
+#include <Kernel/VM/MemoryManager.h>
+
+namespace Kernel {
+
+static void page_zeroing_task(void*)
+{
+    // Keep a pool of zeroed pages around, so that zero-fill page faults
+    // don't have to clear the page while the faulting thread is waiting.
+    Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+    for (;;) {
+        while (MM.zero_page_for_zeroed_page_pool())
+            ;
+        (void)Thread::current()->sleep(Time::from_milliseconds(100));
+    }
+}
+
+UNMAP_AFTER_INIT void PageZeroingTask::spawn()
+{
+    RefPtr<Thread> page_zeroing_thread;
+    auto page_zeroing_process = Process::create_kernel_process(page_zeroing_thread, "PageZeroingTask", page_zeroing_task, nullptr);
+    VERIFY(page_zeroing_process);
+}
+
+}
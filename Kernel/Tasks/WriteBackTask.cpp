@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/CommandLine.h>
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/Panic.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/WriteBackTask.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+static AK::Singleton<WaitQueue> s_write_back_wait_queue;
+READONLY_AFTER_INIT static size_t s_dirty_background_ratio = 10;
+READONLY_AFTER_INIT static size_t s_dirty_ratio = 20;
+
+static void write_back_task(void*)
+{
+    for (;;) {
+        s_write_back_wait_queue->wait_forever("WriteBackTask");
+        FileSystem::write_back();
+    }
+}
+
+UNMAP_AFTER_INIT void WriteBackTask::spawn()
+{
+    s_dirty_background_ratio = kernel_command_line().dirty_background_ratio();
+    s_dirty_ratio = kernel_command_line().dirty_ratio();
+    if (s_dirty_background_ratio > 100 || s_dirty_ratio > 100 || s_dirty_background_ratio > s_dirty_ratio)
+        PANIC("Invalid dirty_background_ratio ({}) or dirty_ratio ({})", s_dirty_background_ratio, s_dirty_ratio);
+
+    RefPtr<Thread> write_back_thread;
+    auto write_back_process = Process::create_kernel_process(write_back_thread, "WriteBackTask", write_back_task, nullptr);
+    VERIFY(write_back_process);
+}
+
+void WriteBackTask::wake()
+{
+    s_write_back_wait_queue->wake_one();
+}
+
+size_t WriteBackTask::dirty_background_ratio()
+{
+    return s_dirty_background_ratio;
+}
+
+size_t WriteBackTask::dirty_ratio()
+{
+    return s_dirty_ratio;
+}
+
+}
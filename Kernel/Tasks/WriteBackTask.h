@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+class WriteBackTask {
+public:
+    static void spawn();
+    static void wake();
+
+    // Percentages of a file system's disk cache that may be dirty before
+    // write-back starts, and before writers are slowed down the most.
+    static size_t dirty_background_ratio();
+    static size_t dirty_ratio();
+};
+}
@@ -15,6 +15,7 @@
 #include <Kernel/KSyms.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
 #include <Kernel/ProcessExposed.h>
 #include <Kernel/Scheduler.h>
@@ -416,6 +417,21 @@ void Thread::exit(void* exit_value)
     die_if_needed();
 }
 
+Optional<Time> Thread::add_block_perf_event(const Blocker& blocker)
+{
+    if (!process().current_perf_events_buffer() || (g_profiling_event_mask & (PERF_EVENT_BLOCK | PERF_EVENT_UNBLOCK)) == 0)
+        return {};
+    PerformanceManager::add_block_perf_event(*this, blocker.blocker_type());
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise);
+}
+
+void Thread::add_unblock_perf_event(const Blocker& blocker, Time block_start_time)
+{
+    auto blocked_time = TimeManagement::the().monotonic_time(TimePrecision::Precise) - block_start_time;
+    auto blocked_time_us = min(blocked_time.to_microseconds(), static_cast<i64>(NumericLimits<u32>::max()));
+    PerformanceManager::add_unblock_perf_event(*this, blocker.blocker_type(), blocked_time_us);
+}
+
 void Thread::yield_assuming_not_holding_big_lock()
 {
     VERIFY(!g_scheduler_lock.own_lock());
@@ -161,7 +161,11 @@ public:
     ProcessID pid() const;
 
     void set_priority(u32 p) { m_priority = p; }
-    u32 priority() const { return m_priority; }
+    u32 priority() const { return max(m_priority, m_priority_boost); }
+
+    // Lent to us by higher priority threads while they wait for a priority-inheriting futex we hold.
+    void set_priority_boost(u32 boost) { m_priority_boost = boost; }
+    u32 priority_boost() const { return m_priority_boost; }
 
     void detach()
     {
@@ -915,6 +919,8 @@ public:
         scheduler_lock.unlock();
         block_lock.unlock();
 
+        auto block_start_time = add_block_perf_event(blocker);
+
         dbgln_if(THREAD_DEBUG, "Thread {} blocking on {} ({}) -->", *this, &blocker, blocker.state_string());
         bool did_timeout = false;
         u32 lock_count_to_restore = 0;
@@ -951,6 +957,9 @@ public:
             break;
         }
 
+        if (block_start_time.has_value())
+            add_unblock_perf_event(blocker, block_start_time.value());
+
         if (blocker.was_interrupted_by_signal()) {
             ScopedSpinLock scheduler_lock(g_scheduler_lock);
             ScopedSpinLock lock(m_lock);
@@ -1213,6 +1222,10 @@ public:
     bool is_profiling_suppressed() const { return m_is_profiling_suppressed; }
     void set_profiling_suppressed() { m_is_profiling_suppressed = true; }
 
+    // For off-CPU profiling; these return/take the time we started blocking, or nothing if we aren't being profiled.
+    Optional<Time> add_block_perf_event(const Blocker&);
+    void add_unblock_perf_event(const Blocker&, Time block_start_time);
+
     InodeIndex global_procfs_inode_index() const { return m_global_procfs_inode_index; }
 
     String backtrace();
@@ -1222,6 +1235,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1351,6 +1365,7 @@ private:
     State m_state { Invalid };
     String m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    u32 m_priority_boost { 0 };
 
     State m_stop_state { Invalid };
 
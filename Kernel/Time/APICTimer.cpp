@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <Kernel/IO.h>
 #include <Kernel/Interrupts/APIC.h>
 #include <Kernel/Panic.h>
@@ -137,6 +138,15 @@ void APICTimer::disable_local_timer()
     APIC::the().setup_local_timer(0, APIC::TimerMode::OneShot, false);
 }
 
+void APICTimer::set_one_shot_deadline(u64 nanoseconds_from_now)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    // m_timer_period is the number of APIC bus clock ticks per timer period (1 / m_frequency seconds)
+    u64 ticks = (nanoseconds_from_now * m_timer_period * m_frequency) / 1'000'000'000ull;
+    ticks = clamp(ticks, (u64)APIC::the().get_timer_divisor(), (u64)NumericLimits<u32>::max());
+    APIC::the().setup_local_timer((u32)ticks, APIC::TimerMode::OneShot, true);
+}
+
 size_t APICTimer::ticks_per_second() const
 {
     return m_frequency;
@@ -24,6 +24,8 @@ public:
     virtual void set_periodic() override;
     virtual void set_non_periodic() override;
     virtual void disable() override { }
+    virtual bool is_capable_of_one_shot_deadlines() const override { return true; }
+    virtual void set_one_shot_deadline(u64 nanoseconds_from_now) override;
 
     virtual void reset_to_default_ticks_per_second() override;
     virtual bool try_to_set_frequency(size_t frequency) override;
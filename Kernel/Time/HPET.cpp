@@ -220,14 +220,20 @@ void HPET::update_periodic_comparator_value()
 }
 
 void HPET::update_non_periodic_comparator_value(const HPETComparator& comparator)
+{
+    update_non_periodic_comparator_value(comparator, frequency() / comparator.ticks_per_second());
+}
+
+void HPET::update_non_periodic_comparator_value(const HPETComparator& comparator, u64 raw_ticks_from_now)
 {
     VERIFY_INTERRUPTS_DISABLED();
     VERIFY(!comparator.is_periodic());
     VERIFY(comparator.comparator_number() <= m_comparators.size());
     auto& regs = registers();
     auto& timer = regs.timers[comparator.comparator_number()];
-    u64 value = frequency() / comparator.ticks_per_second();
     // NOTE: If the main counter passes this new value before we finish writing it, we will never receive an interrupt!
+    //       So don't allow deadlines that are closer than the minimum tick the HPET claims to support.
+    u64 value = max(raw_ticks_from_now, (u64)max(m_minimum_tick, (u16)1));
     u64 new_counter_value = read_main_counter() + value;
     timer.comparator_value.high = (u32)(new_counter_value >> 32);
     timer.comparator_value.low = (u32)new_counter_value;
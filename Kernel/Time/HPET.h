@@ -35,6 +35,7 @@ public:
 
     void update_periodic_comparator_value();
     void update_non_periodic_comparator_value(const HPETComparator& comparator);
+    void update_non_periodic_comparator_value(const HPETComparator& comparator, u64 raw_ticks_from_now);
 
     void set_comparator_irq_vector(u8 comparator_number, u8 irq_vector);
 
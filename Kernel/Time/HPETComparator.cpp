@@ -55,10 +55,19 @@ void HPETComparator::set_non_periodic()
 
 bool HPETComparator::handle_irq(const RegisterState& regs)
 {
-    auto result = HardwareTimer::handle_irq(regs);
+    // Arm the next countdown before invoking the callback, so that it
+    // can choose a different deadline with set_one_shot_deadline().
     if (!is_periodic())
         set_new_countdown();
-    return result;
+    return HardwareTimer::handle_irq(regs);
+}
+
+void HPETComparator::set_one_shot_deadline(u64 nanoseconds_from_now)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(is_capable_of_one_shot_deadlines());
+    auto& hpet = HPET::the();
+    hpet.update_non_periodic_comparator_value(*this, hpet.ns_to_raw_counter_ticks(nanoseconds_from_now));
 }
 
 void HPETComparator::set_new_countdown()
@@ -35,6 +35,8 @@ public:
     virtual bool can_query_raw() const override { return true; }
     virtual u64 current_raw() const override;
     virtual u64 raw_to_ns(u64) const override;
+    virtual bool is_capable_of_one_shot_deadlines() const override { return m_enabled && !m_periodic; }
+    virtual void set_one_shot_deadline(u64 nanoseconds_from_now) override;
 
     virtual void reset_to_default_ticks_per_second() override;
     virtual bool try_to_set_frequency(size_t frequency) override;
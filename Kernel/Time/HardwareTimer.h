@@ -49,6 +49,11 @@ public:
     virtual u64 current_raw() const { return 0; }
     virtual u64 raw_to_ns(u64) const { return 0; }
 
+    // Timers that can be armed to fire once at an arbitrary point in time
+    // allow the system timer to be used in dynamic tick mode.
+    virtual bool is_capable_of_one_shot_deadlines() const { return false; }
+    virtual void set_one_shot_deadline(u64 /* nanoseconds_from_now */) { VERIFY_NOT_REACHED(); }
+
     virtual size_t ticks_per_second() const = 0;
 
     virtual void reset_to_default_ticks_per_second() = 0;
@@ -22,6 +22,8 @@
 #include <Kernel/Time/RTC.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/TimerQueue.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
@@ -145,8 +147,12 @@ UNMAP_AFTER_INIT void TimeManagement::initialize(u32 cpu)
             dmesgln("Time: Using APIC timer as system timer");
             s_the->set_system_timer(*apic_timer);
         }
+
+        s_the->enable_dynamic_ticks_if_requested();
+        s_the->enable_userspace_tsc_on_current_processor();
     } else {
         VERIFY(s_the.is_initialized());
+        s_the->enable_userspace_tsc_on_current_processor();
         if (auto* apic_timer = APIC::the().get_timer()) {
             dmesgln("Time: Enable APIC timer on CPU #{}", cpu);
             apic_timer->enable_local_timer();
@@ -175,6 +181,9 @@ time_t TimeManagement::boot_time() const
 
 UNMAP_AFTER_INIT TimeManagement::TimeManagement()
 {
+    // The time page is updated from the timer interrupts, so it has to exist before any of them can fire.
+    initialize_time_page();
+
     bool probe_non_legacy_hardware_timers = !(kernel_command_line().is_legacy_time_enabled());
     if (ACPI::is_enabled()) {
         if (!ACPI::Parser::the()->x86_specific_flags().cmos_rtc_not_present) {
@@ -340,6 +349,89 @@ void TimeManagement::update_time(const RegisterState&)
     TimeManagement::the().increment_time_since_boot();
 }
 
+UNMAP_AFTER_INIT void TimeManagement::initialize_time_page()
+{
+    m_time_page_vmobject = AnonymousVMObject::try_create_with_size(PAGE_SIZE, AllocationStrategy::AllocateNow);
+    VERIFY(m_time_page_vmobject);
+    m_time_page_region = MM.allocate_kernel_region_with_vmobject(*m_time_page_vmobject, PAGE_SIZE, "Time page", Region::Access::Read | Region::Access::Write);
+    VERIFY(m_time_page_region);
+    memset(&time_page(), 0, sizeof(TimePage));
+
+    // NOTE: Userspace can only extrapolate from the TSC if it ticks at the same rate on all processors, no matter their power state.
+    auto& processor = Processor::current();
+    m_time_page_has_tsc = kernel_command_line().is_userspace_tsc_enabled()
+        && processor.has_feature(CPUFeature::TSC)
+        && processor.has_feature(CPUFeature::CONSTANT_TSC)
+        && processor.has_feature(CPUFeature::NONSTOP_TSC);
+}
+
+AnonymousVMObject& TimeManagement::time_page_vmobject()
+{
+    return *m_time_page_vmobject;
+}
+
+TimePage& TimeManagement::time_page()
+{
+    return *reinterpret_cast<TimePage*>(m_time_page_region->vaddr().as_ptr());
+}
+
+UNMAP_AFTER_INIT void TimeManagement::enable_userspace_tsc_on_current_processor()
+{
+    // The processors are set up to keep RDTSC in userspace from working, undo that.
+    if (m_time_page_has_tsc)
+        write_cr4(read_cr4() & ~0x4);
+}
+
+void TimeManagement::update_time_page()
+{
+    auto monotonic_coarse_ns = monotonic_time(TimePrecision::Coarse).to_nanoseconds();
+    auto monotonic_ns = monotonic_time(TimePrecision::Precise).to_nanoseconds();
+    auto realtime_ns = epoch_time().to_nanoseconds();
+    auto& page = time_page();
+
+    u64 tsc = 0;
+    u64 tsc_multiplier = 0;
+    u64 monotonic_base_ns = monotonic_ns;
+    if (m_time_page_has_tsc) {
+        tsc = read_tsc();
+        tsc_multiplier = m_tsc_multiplier;
+        if (page.tsc_multiplier) {
+            // Userspace may have already seen a later time than ours, if the TSC runs a little fast
+            // compared to our clock. Go on from there instead, and slightly slower until we have caught up.
+            auto extrapolated_ns = page.monotonic_base_ns + time_page_tsc_delta_to_ns(tsc - page.tsc_base, page.tsc_multiplier);
+            if (extrapolated_ns > monotonic_base_ns) {
+                monotonic_base_ns = extrapolated_ns;
+                tsc_multiplier -= tsc_multiplier / 1024;
+            }
+        }
+
+        // Measure the TSC frequency against our clock about once per second.
+        constexpr u64 calibration_period_ns = 1'000'000'000;
+        auto calibration_ns = monotonic_ns - m_tsc_calibration_start_ns;
+        if (m_tsc_calibration_start_tsc == 0 || calibration_ns >= 4 * calibration_period_ns || tsc <= m_tsc_calibration_start_tsc) {
+            // (Re)start the measurement, the delta would overflow below if we waited for too long.
+            m_tsc_calibration_start_tsc = tsc;
+            m_tsc_calibration_start_ns = monotonic_ns;
+        } else if (calibration_ns >= calibration_period_ns) {
+            m_tsc_multiplier = (calibration_ns << 32) / (tsc - m_tsc_calibration_start_tsc);
+            m_tsc_calibration_start_tsc = tsc;
+            m_tsc_calibration_start_ns = monotonic_ns;
+        }
+    }
+
+    auto sequence = page.sequence;
+    AK::atomic_store(&page.sequence, sequence + 1, AK::MemoryOrder::memory_order_relaxed);
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+    page.flags = tsc_multiplier ? TIME_PAGE_HAS_TSC : 0;
+    page.monotonic_coarse_ns = monotonic_coarse_ns;
+    page.realtime_coarse_ns = realtime_ns;
+    page.tsc_base = tsc;
+    page.tsc_multiplier = tsc_multiplier;
+    page.monotonic_base_ns = monotonic_base_ns;
+    page.realtime_base_ns = realtime_ns + static_cast<i64>(monotonic_base_ns - monotonic_ns);
+    AK::atomic_store(&page.sequence, sequence + 2, AK::MemoryOrder::memory_order_release);
+}
+
 void TimeManagement::increment_time_since_boot_hpet()
 {
     VERIFY(!m_time_keeper_timer.is_null());
@@ -360,6 +452,7 @@ void TimeManagement::increment_time_since_boot_hpet()
     // TODO: Apply m_remaining_epoch_time_adjustment
     timespec_add(m_epoch_time, { (time_t)(delta_ns / 1000000000), (long)(delta_ns % 1000000000) }, m_epoch_time);
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+    update_time_page();
 }
 
 void TimeManagement::increment_time_since_boot()
@@ -390,10 +483,17 @@ void TimeManagement::increment_time_since_boot()
         m_ticks_this_second = 0;
     }
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+    update_time_page();
 }
 
 void TimeManagement::system_timer_tick(const RegisterState& regs)
 {
+    auto& time_management = TimeManagement::the();
+    if (time_management.m_dynamic_ticks_enabled) {
+        time_management.dynamic_system_timer_tick(time_management.dynamic_tick_state_for_current_processor(), regs);
+        return;
+    }
+
     if (Processor::current().in_irq() <= 1) {
         // Don't expire timers while handling IRQs
         TimerQueue::the().fire();
@@ -401,12 +501,142 @@ void TimeManagement::system_timer_tick(const RegisterState& regs)
     Scheduler::timer_tick(regs);
 }
 
+// How long an idle processor may go without any timer interrupt.
+// This needs to be short enough for the HPET to notice wraparounds of a 32-bit main counter.
+static constexpr i64 max_dynamic_tick_idle_ms = 1000;
+
+UNMAP_AFTER_INIT void TimeManagement::enable_dynamic_ticks_if_requested()
+{
+    if (!kernel_command_line().is_dynamic_ticks_enabled())
+        return;
+    if (!m_can_query_precise_time) {
+        dmesgln("Time: Dynamic ticks need a precise time source, using periodic ticks");
+        return;
+    }
+    if (!m_system_timer->is_capable_of_one_shot_deadlines()) {
+        dmesgln("Time: {} system timer is not capable of one-shot deadlines, using periodic ticks", m_system_timer->model());
+        return;
+    }
+    m_scheduler_tick_duration = Time::from_nanoseconds(1'000'000'000 / m_system_timer->ticks_per_second());
+    dmesgln("Time: Using dynamic ticks, scheduler tick every {}us", m_scheduler_tick_duration.to_microseconds());
+    m_dynamic_ticks_enabled = true;
+}
+
+bool TimeManagement::is_system_timer_local_to_each_processor() const
+{
+    // The Local APIC timer interrupts every processor individually, all other
+    // timers only interrupt the bootstrap processor.
+    return m_system_timer->timer_type() == HardwareTimerType::LocalAPICTimer;
+}
+
+TimeManagement::DynamicTickState& TimeManagement::dynamic_tick_state_for_current_processor()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (is_system_timer_local_to_each_processor())
+        return m_dynamic_tick_states[Processor::id()];
+    return m_dynamic_tick_states[0];
+}
+
+void TimeManagement::dynamic_system_timer_tick(DynamicTickState& state, const RegisterState& regs)
+{
+    auto now = monotonic_time(TimePrecision::Precise);
+    bool is_scheduler_tick;
+    {
+        ScopedSpinLock lock(state.lock);
+        // Allow for a little bit of slack, we don't want to schedule another
+        // interrupt just because this one fired a few microseconds early.
+        auto slack = Time::from_nanoseconds(m_scheduler_tick_duration.to_nanoseconds() / 16);
+        is_scheduler_tick = now + slack >= state.next_scheduler_tick;
+        if (is_scheduler_tick)
+            state.next_scheduler_tick = now + m_scheduler_tick_duration;
+    }
+
+    if (Processor::current().in_irq() <= 1) {
+        // Don't expire timers while handling IRQs
+        TimerQueue::the().fire();
+    }
+    // If we only woke up early to expire a timer, don't charge the current thread for a tick.
+    if (is_scheduler_tick)
+        Scheduler::timer_tick(regs);
+
+    program_next_dynamic_tick(state);
+}
+
+void TimeManagement::program_next_dynamic_tick(DynamicTickState& state)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto now = monotonic_time(TimePrecision::Precise);
+
+    ScopedSpinLock lock(state.lock);
+    auto deadline = state.is_idle ? now + Time::from_milliseconds(max_dynamic_tick_idle_ms) : state.next_scheduler_tick;
+    // Idle application processors leave expiring timers to the bootstrap
+    // processor, there's no point in waking all processors up for them.
+    if (!state.is_idle || &state == &m_dynamic_tick_states[0]) {
+        if (auto time_until_next_timer_due = TimerQueue::the().time_until_next_timer_due(); time_until_next_timer_due.has_value())
+            deadline = min(deadline, now + time_until_next_timer_due.value());
+    }
+
+    i64 nanoseconds_from_now = deadline > now ? (deadline - now).to_nanoseconds() : 0;
+    m_system_timer->set_one_shot_deadline((u64)nanoseconds_from_now);
+}
+
+void TimeManagement::stop_ticks_for_idle()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(m_dynamic_ticks_enabled);
+    if (!is_system_timer_local_to_each_processor() && !Processor::is_bootstrap_processor())
+        return;
+    auto& state = dynamic_tick_state_for_current_processor();
+    {
+        ScopedSpinLock lock(state.lock);
+        state.is_idle = true;
+    }
+    program_next_dynamic_tick(state);
+}
+
+void TimeManagement::restart_ticks_after_idle()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(m_dynamic_ticks_enabled);
+    if (!is_system_timer_local_to_each_processor() && !Processor::is_bootstrap_processor())
+        return;
+    auto& state = dynamic_tick_state_for_current_processor();
+    {
+        ScopedSpinLock lock(state.lock);
+        state.is_idle = false;
+        state.next_scheduler_tick = monotonic_time(TimePrecision::Precise) + m_scheduler_tick_duration;
+    }
+    program_next_dynamic_tick(state);
+}
+
+void TimeManagement::next_timer_due_changed()
+{
+    if (!m_dynamic_ticks_enabled)
+        return;
+    // A timer may have been added that is due before our next scheduler tick,
+    // make sure we wake up in time for it instead of rounding up to a full tick.
+    InterruptDisabler disabler;
+    program_next_dynamic_tick(dynamic_tick_state_for_current_processor());
+}
+
 bool TimeManagement::enable_profile_timer()
 {
     if (!m_profile_timer)
         return false;
     if (m_profile_enable_count.fetch_add(1) == 0)
-        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE));
+        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(profile_timer_frequency()));
+    return true;
+}
+
+bool TimeManagement::set_profile_timer_frequency(u32 frequency)
+{
+    VERIFY(frequency > 0);
+    if (!m_profile_timer)
+        return false;
+    m_profile_timer_frequency.store(frequency, AK::MemoryOrder::memory_order_relaxed);
+    // The profile timer is shared by everyone who's profiling, so the frequency that was set last wins.
+    if (m_profile_enable_count.load() > 0)
+        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(frequency));
     return true;
 }
 
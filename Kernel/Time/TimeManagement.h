@@ -6,19 +6,26 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/Time.h>
 #include <AK/Types.h>
+#include <Kernel/API/TimePage.h>
+#include <Kernel/Forward.h>
 #include <Kernel/Arch/x86/RegisterState.h>
 #include <Kernel/KResult.h>
+#include <Kernel/SpinLock.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
 
 #define OPTIMAL_TICKS_PER_SECOND_RATE 250
 #define OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE 1000
+#define MAX_PROFILE_TICKS_PER_SECOND_RATE 10000
 
+class AnonymousVMObject;
 class HardwareTimerBase;
 
 enum class TimePrecision {
@@ -58,6 +65,8 @@ public:
 
     bool enable_profile_timer();
     bool disable_profile_timer();
+    u32 profile_timer_frequency() const { return m_profile_timer_frequency.load(AK::MemoryOrder::memory_order_relaxed); }
+    bool set_profile_timer_frequency(u32);
 
     u64 uptime_ms() const;
     static Time now();
@@ -71,6 +80,13 @@ public:
 
     bool can_query_precise_time() const { return m_can_query_precise_time; }
 
+    bool is_dynamic_ticks_enabled() const { return m_dynamic_ticks_enabled; }
+    void stop_ticks_for_idle();
+    void restart_ticks_after_idle();
+    void next_timer_due_changed();
+
+    AnonymousVMObject& time_page_vmobject();
+
 private:
     bool probe_and_set_legacy_hardware_timers();
     bool probe_and_set_non_legacy_hardware_timers();
@@ -80,8 +96,24 @@ private:
     void set_system_timer(HardwareTimerBase&);
     static void system_timer_tick(const RegisterState&);
 
+    struct DynamicTickState {
+        SpinLock<u8> lock;
+        Time next_scheduler_tick {};
+        bool is_idle { false };
+    };
+    void enable_dynamic_ticks_if_requested();
+    bool is_system_timer_local_to_each_processor() const;
+    DynamicTickState& dynamic_tick_state_for_current_processor();
+    void dynamic_system_timer_tick(DynamicTickState&, RegisterState const&);
+    void program_next_dynamic_tick(DynamicTickState&);
+
     static u64 scheduling_current_time(bool);
 
+    void initialize_time_page();
+    void enable_userspace_tsc_on_current_processor();
+    void update_time_page();
+    TimePage& time_page();
+
     // Variables between m_update1 and m_update2 are synchronized
     Atomic<u32> m_update1 { 0 };
     u32 m_ticks_this_second { 0 };
@@ -99,7 +131,21 @@ private:
     RefPtr<HardwareTimerBase> m_time_keeper_timer;
 
     Atomic<u32> m_profile_enable_count { 0 };
+    Atomic<u32> m_profile_timer_frequency { OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE };
     RefPtr<HardwareTimerBase> m_profile_timer;
+
+    bool m_dynamic_ticks_enabled { false };
+    Time m_scheduler_tick_duration {};
+    // Note: This has the same capacity as ProcessorContainer.
+    Array<DynamicTickState, 8> m_dynamic_tick_states;
+
+    RefPtr<AnonymousVMObject> m_time_page_vmobject;
+    OwnPtr<Region> m_time_page_region;
+    bool m_time_page_has_tsc { false };
+    // These are only ever touched by update_time_page().
+    u64 m_tsc_calibration_start_tsc { 0 };
+    u64 m_tsc_calibration_start_ns { 0 };
+    u64 m_tsc_multiplier { 0 };
 };
 
 }
@@ -70,7 +70,11 @@ bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t cloc
 
     ScopedSpinLock lock(g_timerqueue_lock);
     timer->m_id = 0; // Don't generate a timer id
-    add_timer_locked(move(timer));
+    bool next_timer_due_changed = add_timer_locked(move(timer));
+    lock.unlock();
+
+    if (next_timer_due_changed)
+        TimeManagement::the().next_timer_due_changed();
     return true;
 }
 
@@ -81,11 +85,15 @@ TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
     timer->m_id = ++m_timer_id_count;
     VERIFY(timer->m_id != 0); // wrapped
     auto id = timer->m_id;
-    add_timer_locked(move(timer));
+    bool next_timer_due_changed = add_timer_locked(move(timer));
+    lock.unlock();
+
+    if (next_timer_due_changed)
+        TimeManagement::the().next_timer_due_changed();
     return id;
 }
 
-void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
+bool TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
 {
     Time timer_expiration = timer->m_expires;
 
@@ -96,23 +104,26 @@ void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
     if (queue.list.is_empty()) {
         queue.list.append(timer.leak_ref());
         queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        for (auto& t : queue.list) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
-                break;
-            }
-        }
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.first() == following_timer;
-            queue.list.insert_before(*following_timer, timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(timer.leak_ref());
+        return true;
+    }
+
+    Timer* following_timer = nullptr;
+    for (auto& t : queue.list) {
+        if (t.m_expires > timer_expiration) {
+            following_timer = &t;
+            break;
         }
     }
+    if (!following_timer) {
+        queue.list.append(timer.leak_ref());
+        return false;
+    }
+
+    bool next_timer_needs_update = queue.list.first() == following_timer;
+    queue.list.insert_before(*following_timer, timer.leak_ref());
+    if (next_timer_needs_update)
+        queue.next_timer_due = timer_expiration;
+    return next_timer_needs_update;
 }
 
 TimerId TimerQueue::add_timer(clockid_t clock_id, const Time& deadline, Function<void()>&& callback)
@@ -282,6 +293,24 @@ void TimerQueue::fire()
         fire_timers(m_timer_queue_realtime);
 }
 
+Optional<Time> TimerQueue::time_until_next_timer_due() const
+{
+    ScopedSpinLock lock(g_timerqueue_lock);
+
+    Optional<Time> time_until_due;
+    auto check_queue = [&](Queue const& queue, clockid_t clock_id) {
+        if (queue.list.is_empty())
+            return;
+        auto now = TimeManagement::the().current_time(clock_id);
+        auto remaining = queue.next_timer_due > now ? queue.next_timer_due - now : Time::zero();
+        if (!time_until_due.has_value() || remaining < time_until_due.value())
+            time_until_due = remaining;
+    };
+    check_queue(m_timer_queue_monotonic, CLOCK_MONOTONIC);
+    check_queue(m_timer_queue_realtime, CLOCK_REALTIME);
+    return time_until_due;
+}
+
 void TimerQueue::update_next_timer_due(Queue& queue)
 {
     VERIFY(g_timerqueue_lock.is_locked());
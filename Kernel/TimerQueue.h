@@ -9,6 +9,7 @@
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Time.h>
@@ -89,6 +90,7 @@ public:
         return cancel_timer(*move(timer));
     }
     void fire();
+    Optional<Time> time_until_next_timer_due() const;
 
 private:
     struct Queue {
@@ -97,7 +99,7 @@ private:
     };
     void remove_timer_locked(Queue&, Timer&);
     void update_next_timer_due(Queue&);
-    void add_timer_locked(NonnullRefPtr<Timer>);
+    bool add_timer_locked(NonnullRefPtr<Timer>);
 
     Queue& queue_for_timer(Timer& timer)
     {
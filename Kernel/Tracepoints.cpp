@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracepoints.h>
+
+namespace Kernel {
+
+Atomic<bool> g_latency_tracing_enabled { false };
+
+static Array<LatencyHistogram, to_underlying(Tracepoint::__Count)> s_histograms;
+static Array<LatencyHistogram, Syscall::Function::__Count> s_syscall_histograms;
+
+void LatencyHistogram::record(u64 latency_ns)
+{
+    size_t bucket_index = latency_ns == 0 ? 0 : min<size_t>(bucket_count - 1, 63 - __builtin_clzll(latency_ns));
+    m_buckets[bucket_index].fetch_add(1);
+    m_count.fetch_add(1);
+    m_total_ns.fetch_add(latency_ns);
+    auto max_ns = m_max_ns.load();
+    while (latency_ns > max_ns && !m_max_ns.compare_exchange_strong(max_ns, latency_ns))
+        ;
+}
+
+void LatencyHistogram::clear()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0);
+    m_count.store(0);
+    m_total_ns.store(0);
+    m_max_ns.store(0);
+}
+
+LatencyHistogram& Tracepoints::histogram(Tracepoint tracepoint)
+{
+    return s_histograms[to_underlying(tracepoint)];
+}
+
+LatencyHistogram& Tracepoints::syscall_histogram(FlatPtr function)
+{
+    return s_syscall_histograms[function];
+}
+
+StringView Tracepoints::name(Tracepoint tracepoint)
+{
+    switch (tracepoint) {
+    case Tracepoint::PageFault:
+        return "page_fault"sv;
+    case Tracepoint::BlockIO:
+        return "block_io"sv;
+    case Tracepoint::NetworkReceive:
+        return "network_receive"sv;
+    case Tracepoint::NetworkTransmit:
+        return "network_transmit"sv;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void Tracepoints::set_enabled(bool enabled)
+{
+    // Every tracing session starts out with empty histograms, so they only show what happened since.
+    if (enabled && !g_latency_tracing_enabled.load()) {
+        for (auto& histogram : s_histograms)
+            histogram.clear();
+        for (auto& histogram : s_syscall_histograms)
+            histogram.clear();
+    }
+    g_latency_tracing_enabled.store(enabled);
+}
+
+u64 Tracepoints::now_ns()
+{
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds();
+}
+
+template<typename Serializer>
+static void serialize_histogram(Serializer& object, const LatencyHistogram& histogram)
+{
+    object.add("count", histogram.count());
+    object.add("total_ns", histogram.total_ns());
+    object.add("max_ns", histogram.max_ns());
+    auto buckets = object.add_array("buckets");
+    for (size_t i = 0; i < LatencyHistogram::bucket_count; ++i)
+        buckets.add(histogram.bucket(i));
+    buckets.finish();
+}
+
+bool Tracepoints::to_json(KBufferBuilder& builder)
+{
+    JsonObjectSerializer object(builder);
+    object.add("enabled", g_latency_tracing_enabled.load());
+    for (size_t i = 0; i < to_underlying(Tracepoint::__Count); ++i) {
+        auto tracepoint = static_cast<Tracepoint>(i);
+        auto histogram_object = object.add_object(name(tracepoint));
+        serialize_histogram(histogram_object, histogram(tracepoint));
+        histogram_object.finish();
+    }
+    auto syscalls_object = object.add_object("syscalls");
+    for (size_t function = 0; function < Syscall::Function::__Count; ++function) {
+        auto& histogram = s_syscall_histograms[function];
+        if (histogram.count() == 0)
+            continue;
+        auto histogram_object = syscalls_object.add_object(Syscall::to_string(static_cast<Syscall::Function>(function)));
+        serialize_histogram(histogram_object, histogram);
+        histogram_object.finish();
+    }
+    syscalls_object.finish();
+    object.finish();
+    return true;
+}
+
+}
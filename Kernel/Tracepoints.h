@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <Kernel/API/Syscall.h>
+
+namespace Kernel {
+
+class KBufferBuilder;
+
+// Toggled through /proc/sys/latency_tracing. While it's off, a tracepoint costs a single load.
+extern Atomic<bool> g_latency_tracing_enabled;
+
+class LatencyHistogram {
+public:
+    // Bucket i counts the latencies in [2^i, 2^(i + 1)) nanoseconds, the last one also counts everything above.
+    static constexpr size_t bucket_count = 36;
+
+    void record(u64 latency_ns);
+    void clear();
+
+    u64 count() const { return m_count.load(); }
+    u64 total_ns() const { return m_total_ns.load(); }
+    u64 max_ns() const { return m_max_ns.load(); }
+    u64 bucket(size_t index) const { return m_buckets[index].load(); }
+
+private:
+    Array<Atomic<u64, AK::MemoryOrder::memory_order_relaxed>, bucket_count> m_buckets {};
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_count { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_total_ns { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_max_ns { 0 };
+};
+
+enum class Tracepoint {
+    PageFault,
+    BlockIO,
+    NetworkReceive,
+    NetworkTransmit,
+    __Count
+};
+
+class Tracepoints {
+public:
+    // Returns the time to pass to the end functions, or nothing if latency tracing is disabled.
+    static ALWAYS_INLINE Optional<u64> begin()
+    {
+        if (!g_latency_tracing_enabled.load(AK::MemoryOrder::memory_order_relaxed))
+            return {};
+        return now_ns();
+    }
+
+    static ALWAYS_INLINE void end(Tracepoint tracepoint, Optional<u64> start_ns)
+    {
+        if (start_ns.has_value())
+            histogram(tracepoint).record(now_ns() - start_ns.value());
+    }
+
+    static ALWAYS_INLINE void end_syscall(FlatPtr function, Optional<u64> start_ns)
+    {
+        if (start_ns.has_value() && function < Syscall::Function::__Count)
+            syscall_histogram(function).record(now_ns() - start_ns.value());
+    }
+
+    static LatencyHistogram& histogram(Tracepoint);
+    static LatencyHistogram& syscall_histogram(FlatPtr function);
+    static StringView name(Tracepoint);
+
+    static void set_enabled(bool);
+
+    // Writes all histograms that have recorded something as JSON, with the syscalls below "syscalls".
+    static bool to_json(KBufferBuilder&);
+
+    static u64 now_ns();
+};
+
+class ScopedTracepoint {
+public:
+    explicit ScopedTracepoint(Tracepoint tracepoint)
+        : m_tracepoint(tracepoint)
+        , m_start_ns(Tracepoints::begin())
+    {
+    }
+
+    ~ScopedTracepoint() { Tracepoints::end(m_tracepoint, m_start_ns); }
+
+private:
+    Tracepoint m_tracepoint;
+    Optional<u64> m_start_ns;
+};
+
+}
@@ -62,8 +62,23 @@ enum {
     PERF_EVENT_KMALLOC = 2048,
     PERF_EVENT_KFREE = 4096,
     PERF_EVENT_PAGE_FAULT = 8192,
+    PERF_EVENT_CPU_CYCLES = 16384,
+    PERF_EVENT_INSTRUCTIONS = 32768,
+    PERF_EVENT_CACHE_MISSES = 65536,
+    PERF_EVENT_BRANCH_MISSES = 131072,
+    PERF_EVENT_BLOCK = 262144,
+    PERF_EVENT_UNBLOCK = 524288,
 };
 
+#define POSIX_SPAWN_RESETIDS (1 << 0)
+#define POSIX_SPAWN_SETPGROUP (1 << 1)
+#define POSIX_SPAWN_SETSCHEDPARAM (1 << 2)
+#define POSIX_SPAWN_SETSCHEDULER (1 << 3)
+#define POSIX_SPAWN_SETSIGDEF (1 << 4)
+#define POSIX_SPAWN_SETSIGMASK (1 << 5)
+#define POSIX_SPAWN_SETSID (1 << 6)
+#define POSIX_SPAWN_TCSETPGROUP (1 << 7)
+
 #define WNOHANG 1
 #define WUNTRACED 2
 #define WSTOPPED WUNTRACED
@@ -147,6 +162,9 @@ enum {
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -156,6 +174,9 @@ enum {
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 #define S_IFMT 0170000
 #define S_IFDIR 0040000
 #define S_IFCHR 0020000
@@ -524,6 +545,7 @@ enum {
     SO_TIMESTAMP,
     SO_BROADCAST,
     SO_LINGER,
+    SO_REUSEPORT,
 };
 
 enum {
@@ -640,6 +662,11 @@ struct msghdr {
     int msg_flags;
 };
 
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+};
+
 struct sched_param {
     int sched_priority;
 };
@@ -6,6 +6,7 @@
 
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/VM/InodeVMObject.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
@@ -69,6 +70,49 @@ int InodeVMObject::release_all_clean_pages()
     return count;
 }
 
+bool InodeVMObject::read_resident_page(size_t page_index, Bytes buffer)
+{
+    VERIFY(buffer.size() == PAGE_SIZE);
+    RefPtr<PhysicalPage> page;
+    {
+        ScopedSpinLock locker(m_lock);
+        if (page_index >= page_count())
+            return false;
+        page = m_physical_pages[page_index];
+    }
+    if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page())
+        return false;
+
+    ScopedSpinLock mm_locker(s_mm_lock);
+    u8* page_ptr = MM.quickmap_page(*page);
+    memcpy(buffer.data(), page_ptr, PAGE_SIZE);
+    MM.unquickmap_page();
+    return true;
+}
+
+void InodeVMObject::release_pages_in_range(u64 offset, u64 size)
+{
+    if (size == 0)
+        return;
+    ScopedSpinLock locker(m_lock);
+
+    size_t first_page_index = offset / PAGE_SIZE;
+    size_t end_page_index = min(ceil_div(offset + size, (u64)PAGE_SIZE), (u64)page_count());
+    bool released_any_page = false;
+    for (size_t i = first_page_index; i < end_page_index; ++i) {
+        if (!m_physical_pages[i])
+            continue;
+        m_physical_pages[i] = nullptr;
+        m_dirty_pages.set(i, false);
+        released_any_page = true;
+    }
+    if (released_any_page) {
+        for_each_region([](auto& region) {
+            region.remap();
+        });
+    }
+}
+
 u32 InodeVMObject::writable_mappings() const
 {
     u32 count = 0;
@@ -89,4 +133,39 @@ u32 InodeVMObject::executable_mappings() const
     return count;
 }
 
+InodeVMObject::PageRange InodeVMObject::pages_to_read_for_fault(size_t page_index)
+{
+    ScopedSpinLock locker(m_lock);
+    VERIFY(page_index < page_count());
+
+    auto fault_around_page_count = max(MM.inode_fault_around_page_count(), (size_t)1);
+    auto max_read_ahead_page_count = MM.inode_read_ahead_page_count();
+
+    size_t first_page_index;
+    size_t end_page_index;
+    if (page_index == m_next_sequential_fault_page_index && max_read_ahead_page_count > 1) {
+        // This fault picks up right where the previous one left off, so we're most likely
+        // being read sequentially. Keep growing the read-ahead window while that holds.
+        m_read_ahead_page_count = min(max(m_read_ahead_page_count, fault_around_page_count) * 2, max_read_ahead_page_count);
+        first_page_index = page_index;
+        end_page_index = page_index + m_read_ahead_page_count;
+    } else {
+        m_read_ahead_page_count = 0;
+        first_page_index = page_index - (page_index % fault_around_page_count);
+        end_page_index = first_page_index + fault_around_page_count;
+    }
+    end_page_index = min(end_page_index, page_count());
+
+    // Narrow it down to the missing pages adjacent to the faulting page.
+    size_t first_missing_page_index = page_index;
+    while (first_missing_page_index > first_page_index && m_physical_pages[first_missing_page_index - 1].is_null())
+        --first_missing_page_index;
+    size_t end_missing_page_index = page_index + 1;
+    while (end_missing_page_index < end_page_index && m_physical_pages[end_missing_page_index].is_null())
+        ++end_missing_page_index;
+
+    m_next_sequential_fault_page_index = end_missing_page_index;
+    return { first_missing_page_index, end_missing_page_index - first_missing_page_index };
+}
+
 }
@@ -24,9 +24,24 @@ public:
 
     int release_all_clean_pages();
 
+    // Copies the contents of the given page into the buffer, if it is resident.
+    bool read_resident_page(size_t page_index, Bytes buffer);
+
+    // Drops all resident pages overlapping the given range of the inode, e.g. because it was written to.
+    void release_pages_in_range(u64 offset, u64 size);
+
     u32 writable_mappings() const;
     u32 executable_mappings() const;
 
+    struct PageRange {
+        size_t first_page_index { 0 };
+        size_t page_count { 0 };
+    };
+
+    // Returns the run of missing pages that should be read in to resolve a page fault at the given index.
+    // This is at least the faulting page itself, and tracks the access pattern to decide how far to read ahead.
+    PageRange pages_to_read_for_fault(size_t page_index);
+
 protected:
     explicit InodeVMObject(Inode&, size_t);
     explicit InodeVMObject(InodeVMObject const&);
@@ -39,6 +54,9 @@ protected:
 
     NonnullRefPtr<Inode> m_inode;
     Bitmap m_dirty_pages;
+
+    size_t m_next_sequential_fault_page_index { 0 };
+    size_t m_read_ahead_page_count { 0 };
 };
 
 }
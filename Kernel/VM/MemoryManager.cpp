@@ -9,12 +9,14 @@
 #include <AK/StringView.h>
 #include <Kernel/BootInfo.h>
 #include <Kernel/CMOS.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Multiboot.h>
 #include <Kernel/Panic.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/StdLib.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
@@ -49,6 +51,13 @@ namespace Kernel {
 static MemoryManager* s_the;
 RecursiveSpinLock s_mm_lock;
 
+// Indexed by processor id, so that we can get at the page caches of other processors.
+// Note: This has the same capacity as ProcessorContainer.
+static Array<MemoryManagerData*, 8> s_mm_data;
+
+// Upper bound for both fault-around and read-ahead, so a single inode fault never reads more than 1 MiB.
+static constexpr size_t max_inode_fault_read_page_count = 256;
+
 MemoryManager& MM
 {
     return *s_the;
@@ -63,6 +72,9 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
 {
     s_the = this;
 
+    m_inode_fault_around_page_count = min(kernel_command_line().fault_around_page_count(), max_inode_fault_read_page_count);
+    m_inode_read_ahead_page_count = min(kernel_command_line().read_ahead_page_count(), max_inode_fault_read_page_count);
+
     ScopedSpinLock lock(s_mm_lock);
     parse_memory_map();
     write_cr3(kernel_page_directory().cr3());
@@ -514,6 +526,7 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+    VERIFY(!pde.is_huge());
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -555,11 +568,69 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         auto result = page_directory.m_page_tables.set(vaddr.get() & ~(FlatPtr)0x1fffff, move(page_table));
         // If you're hitting this VERIFY on x86_64 chances are a 64-bit pointer was truncated somewhere
         VERIFY(result == AK::HashSetResult::InsertedNewEntry);
+    } else if (pde.is_huge()) {
+        // Someone wants to change an individual page inside a huge page mapping,
+        // so we have to split it up into a page table with the same mappings.
+        auto page_table = allocate_user_physical_page(ShouldZeroFill::No);
+        if (!page_table) {
+            dbgln("MM: Unable to allocate page table to split huge page mapping {}", vaddr);
+            return nullptr;
+        }
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+        VERIFY(&pde == &pd[page_directory_index]); // Sanity check
+        VERIFY(pde.is_huge());
+
+        PhysicalPtr huge_page_base = pde.page_table_base();
+        auto* pt = quickmap_pt(page_table->paddr());
+        for (size_t i = 0; i < 512; ++i) {
+            auto& pte = pt[i];
+            pte.clear();
+            pte.set_physical_page_base(huge_page_base + i * PAGE_SIZE);
+            pte.set_writable(pde.is_writable());
+            pte.set_user_allowed(pde.is_user_allowed());
+            pte.set_write_through(pde.is_write_through());
+            pte.set_cache_disabled(pde.is_cache_disabled());
+            pte.set_execute_disabled(pde.is_execute_disabled());
+            pte.set_global(pde.is_global());
+            pte.set_present(true);
+        }
+
+        pde.set_huge(false);
+        pde.set_page_table_base(page_table->paddr().get());
+        pde.set_user_allowed(true);
+        pde.set_writable(true);
+        pde.set_write_through(false);
+        pde.set_cache_disabled(false);
+        pde.set_execute_disabled(false);
+        pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+        auto result = page_directory.m_page_tables.set(vaddr.get() & ~(FlatPtr)0x1fffff, move(page_table));
+        VERIFY(result == AK::HashSetResult::InsertedNewEntry);
+        flush_tlb(&page_directory, VirtualAddress(vaddr.get() & ~(FlatPtr)0x1fffff), pages_per_huge_page);
     }
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
 
+PageDirectoryEntry* MemoryManager::ensure_pde_for_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(page_directory.get_lock().own_lock());
+    VERIFY(vaddr.get() % huge_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge()) {
+        // The range used to be mapped with individual pages, the page table is no longer needed.
+        auto result = page_directory.m_page_tables.remove(vaddr.get());
+        VERIFY(result);
+    }
+    pde.clear();
+    return &pde;
+}
+
 void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress vaddr, bool is_last_release)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -571,6 +642,12 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_present() && pde.is_huge()) {
+        // Huge pages are only used for ranges that are entirely covered by a single region,
+        // so releasing any page in it means that the whole huge page is going away.
+        pde.clear();
+        return;
+    }
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -599,6 +676,8 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
+    VERIFY(cpu < s_mm_data.size());
+    s_mm_data[cpu] = &get_data();
 
     if (cpu == 0) {
         new MemoryManager;
@@ -682,6 +761,7 @@ Region* MemoryManager::find_region_from_vaddr(VirtualAddress vaddr)
 PageFaultResponse MemoryManager::handle_page_fault(PageFault const& fault)
 {
     VERIFY_INTERRUPTS_DISABLED();
+    ScopedTracepoint tracepoint(Tracepoint::PageFault);
     if (Processor::current().in_irq()) {
         dbgln("CPU[{}] BUG! Page fault while handling IRQ! code={}, vaddr={}, irq level: {}",
             Processor::id(), fault.code(), fault.vaddr(), Processor::current().in_irq());
@@ -796,11 +876,8 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     ScopedSpinLock lock(s_mm_lock);
 
     // Are we returning a user page?
-    for (auto& region : m_user_physical_regions) {
-        if (!region.contains(paddr))
-            continue;
-
-        region.return_page(paddr);
+    if (user_physical_region_containing(paddr)) {
+        return_user_physical_page_to_cache(paddr);
         --m_system_memory_info.user_physical_pages_used;
 
         // Always return pages to the uncommitted pool. Pages that were
@@ -825,7 +902,7 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     PANIC("MM: deallocate_user_physical_page couldn't figure out region for page @ {}", paddr);
 }
 
-RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
+RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed, ShouldZeroFill& should_zero_fill)
 {
     VERIFY(s_mm_lock.is_locked());
     RefPtr<PhysicalPage> page;
@@ -839,33 +916,169 @@ RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
             return {};
         m_system_memory_info.user_physical_pages_uncommitted--;
     }
-    for (auto& region : m_user_physical_regions) {
-        page = region.take_free_page();
-        if (!page.is_null()) {
-            ++m_system_memory_info.user_physical_pages_used;
-            break;
+
+    Optional<PhysicalAddress> paddr;
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        paddr = take_page_from_zeroed_page_pool();
+        if (paddr.has_value()) {
+            ++m_system_memory_info.zeroed_page_pool_hits;
+            should_zero_fill = ShouldZeroFill::No;
+        } else {
+            ++m_system_memory_info.zeroed_page_pool_misses;
         }
     }
+    if (!paddr.has_value())
+        paddr = take_user_physical_page_from_cache();
+    if (!paddr.has_value()) {
+        // Pages in the zeroed page pool are free too, so use them as a last resort.
+        paddr = take_page_from_zeroed_page_pool();
+    }
+
+    if (paddr.has_value()) {
+        page = PhysicalPage::create(paddr.value());
+        ++m_system_memory_info.user_physical_pages_used;
+    }
     VERIFY(!committed || !page.is_null());
     return page;
 }
 
-NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(ShouldZeroFill should_zero_fill)
+Optional<PhysicalAddress> MemoryManager::take_page_from_zeroed_page_pool()
+{
+    VERIFY(s_mm_lock.is_locked());
+    auto& count = m_system_memory_info.user_physical_pages_zeroed;
+    if (count == 0)
+        return {};
+    return m_zeroed_page_pool[--count];
+}
+
+bool MemoryManager::zero_page_for_zeroed_page_pool()
 {
+    Optional<PhysicalAddress> paddr;
+    {
+        ScopedSpinLock lock(s_mm_lock);
+        if (m_system_memory_info.user_physical_pages_zeroed == m_zeroed_page_pool.size())
+            return false;
+        // Don't hold on to pages while we're running low on memory. This also guarantees
+        // that committed pages are available while we're zeroing a page outside the lock.
+        if (m_system_memory_info.user_physical_pages_uncommitted <= m_zeroed_page_pool.size())
+            return false;
+        paddr = take_user_physical_page_from_cache();
+        if (!paddr.has_value())
+            return false;
+    }
+
+    auto* ptr = quickmap_page(paddr.value());
+    memset(ptr, 0, PAGE_SIZE);
+    unquickmap_page();
+
     ScopedSpinLock lock(s_mm_lock);
-    auto page = find_free_user_physical_page(true);
-    if (should_zero_fill == ShouldZeroFill::Yes) {
-        auto* ptr = quickmap_page(*page);
-        memset(ptr, 0, PAGE_SIZE);
-        unquickmap_page();
+    // Only the PageZeroingTask ever adds pages to the pool.
+    VERIFY(m_system_memory_info.user_physical_pages_zeroed < m_zeroed_page_pool.size());
+    m_zeroed_page_pool[m_system_memory_info.user_physical_pages_zeroed++] = paddr.value();
+    return true;
+}
+
+PhysicalRegion* MemoryManager::user_physical_region_containing(PhysicalAddress paddr)
+{
+    for (auto& region : m_user_physical_regions) {
+        if (region.contains(paddr))
+            return &region;
     }
+    return nullptr;
+}
+
+Optional<PhysicalAddress> MemoryManager::take_user_physical_page_from_cache()
+{
+    VERIFY(s_mm_lock.is_locked());
+    auto& data = get_data();
+    auto& cache = data.m_user_physical_page_cache;
+    auto& count = data.m_user_physical_page_cache_count;
+
+    if (count == 0) {
+        // Refill the cache in one go, so that we only have to walk the
+        // physical regions once for a whole batch of allocations.
+        for (auto& region : m_user_physical_regions) {
+            count += region.take_free_pages(cache.span().slice(count, MemoryManagerData::user_physical_page_cache_batch_size - count));
+            if (count == MemoryManagerData::user_physical_page_cache_batch_size)
+                break;
+        }
+    }
+
+    if (count == 0) {
+        // The physical regions are exhausted, but other processors
+        // might still be holding on to some free pages.
+        for (auto* other_data : s_mm_data) {
+            if (!other_data || other_data->m_user_physical_page_cache_count == 0)
+                continue;
+            return other_data->m_user_physical_page_cache[--other_data->m_user_physical_page_cache_count];
+        }
+        return {};
+    }
+
+    return cache[--count];
+}
+
+void MemoryManager::return_user_physical_page_to_cache(PhysicalAddress paddr)
+{
+    VERIFY(s_mm_lock.is_locked());
+    auto& data = get_data();
+    auto& cache = data.m_user_physical_page_cache;
+    auto& count = data.m_user_physical_page_cache_count;
+
+    if (count == cache.size()) {
+        // The cache is full, give the oldest batch of pages back to the physical regions.
+        // We keep the most recently freed pages around, as they are likely still hot in the CPU cache.
+        constexpr auto batch_size = MemoryManagerData::user_physical_page_cache_batch_size;
+        for (size_t i = 0; i < batch_size; ++i) {
+            auto* region = user_physical_region_containing(cache[i]);
+            VERIFY(region);
+            region->return_page(cache[i]);
+        }
+        for (size_t i = batch_size; i < count; ++i)
+            cache[i - batch_size] = cache[i];
+        count -= batch_size;
+    }
+
+    cache[count++] = paddr;
+}
+
+void MemoryManager::zero_fill_physical_page(PhysicalPage& page)
+{
+    auto* ptr = quickmap_page(page);
+    memset(ptr, 0, PAGE_SIZE);
+    unquickmap_page();
+}
+
+NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(ShouldZeroFill should_zero_fill)
+{
+    RefPtr<PhysicalPage> page;
+    {
+        ScopedSpinLock lock(s_mm_lock);
+        page = find_free_user_physical_page(true, should_zero_fill);
+    }
+    if (should_zero_fill == ShouldZeroFill::Yes)
+        zero_fill_physical_page(*page);
     return page.release_nonnull();
 }
 
+void MemoryManager::allocate_committed_user_physical_pages(Span<RefPtr<PhysicalPage>> pages, ShouldZeroFill should_zero_fill)
+{
+    ScopedSpinLock lock(s_mm_lock);
+    for (auto& page : pages) {
+        auto page_should_zero_fill = should_zero_fill;
+        page = find_free_user_physical_page(true, page_should_zero_fill);
+        if (page_should_zero_fill == ShouldZeroFill::Yes) {
+            lock.unlock();
+            zero_fill_physical_page(*page);
+            lock.lock();
+        }
+    }
+}
+
 RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     ScopedSpinLock lock(s_mm_lock);
-    auto page = find_free_user_physical_page(false);
+    auto page = find_free_user_physical_page(false, should_zero_fill);
     bool purged_pages = false;
 
     if (!page) {
@@ -879,7 +1092,7 @@ RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill s
                 return IterationDecision::Continue;
             if (auto purged_page_count = anonymous_vmobject.purge()) {
                 dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                page = find_free_user_physical_page(false);
+                page = find_free_user_physical_page(false, should_zero_fill);
                 purged_pages = true;
                 VERIFY(page);
                 return IterationDecision::Break;
@@ -892,17 +1105,28 @@ RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill s
         }
     }
 
-    if (should_zero_fill == ShouldZeroFill::Yes) {
-        auto* ptr = quickmap_page(*page);
-        memset(ptr, 0, PAGE_SIZE);
-        unquickmap_page();
-    }
+    lock.unlock();
+
+    if (should_zero_fill == ShouldZeroFill::Yes)
+        zero_fill_physical_page(*page);
 
     if (did_purge)
         *did_purge = purged_pages;
     return page;
 }
 
+MemoryPressureLevel MemoryManager::memory_pressure_level()
+{
+    ScopedSpinLock lock(s_mm_lock);
+    // The pressure is measured by how much of the user physical memory is neither in use nor committed.
+    auto available = m_system_memory_info.user_physical_pages_uncommitted;
+    if (available < m_system_memory_info.user_physical_pages / 32)
+        return MemoryPressureLevel::Critical;
+    if (available < m_system_memory_info.user_physical_pages / 16)
+        return MemoryPressureLevel::Moderate;
+    return MemoryPressureLevel::None;
+}
+
 NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_supervisor_physical_pages(size_t size)
 {
     VERIFY(!(size % PAGE_SIZE));
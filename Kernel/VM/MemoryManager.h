@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/String.h>
+#include <Kernel/API/MemoryPressure.h>
 #include <Kernel/Arch/x86/PageFault.h>
 #include <Kernel/Arch/x86/TrapFrame.h>
 #include <Kernel/Forward.h>
@@ -23,6 +25,10 @@
 
 namespace Kernel {
 
+// A single page directory entry can map this much memory at once.
+constexpr size_t huge_page_size = 2 * MiB;
+constexpr size_t pages_per_huge_page = huge_page_size / PAGE_SIZE;
+
 constexpr bool page_round_up_would_wrap(FlatPtr x)
 {
     return x > (explode_byte(0xFF) & ~0xFFF);
@@ -98,6 +104,14 @@ struct MemoryManagerData {
 
     PhysicalAddress m_last_quickmap_pd;
     PhysicalAddress m_last_quickmap_pt;
+
+    // Free user physical pages kept on this processor, so that most allocations
+    // don't have to go looking through the physical regions. Pages in here are
+    // accounted for as free. Protected by s_mm_lock.
+    static constexpr size_t user_physical_page_cache_capacity = 64;
+    static constexpr size_t user_physical_page_cache_batch_size = 32;
+    Array<PhysicalAddress, user_physical_page_cache_capacity> m_user_physical_page_cache;
+    size_t m_user_physical_page_cache_count { 0 };
 };
 
 extern RecursiveSpinLock s_mm_lock;
@@ -106,7 +120,9 @@ class MemoryManager {
     AK_MAKE_ETERNAL
     friend class PageDirectory;
     friend class AnonymousVMObject;
+    friend class InodeVMObject;
     friend class Region;
+    friend class TLBGather;
     friend class VMObject;
 
 public:
@@ -142,10 +158,12 @@ public:
     bool commit_user_physical_pages(size_t);
     void uncommit_user_physical_pages(size_t);
     NonnullRefPtr<PhysicalPage> allocate_committed_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
+    void allocate_committed_user_physical_pages(Span<RefPtr<PhysicalPage>>, ShouldZeroFill = ShouldZeroFill::Yes);
     RefPtr<PhysicalPage> allocate_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     RefPtr<PhysicalPage> allocate_supervisor_physical_page();
     NonnullRefPtrVector<PhysicalPage> allocate_contiguous_supervisor_physical_pages(size_t size);
     void deallocate_physical_page(PhysicalAddress);
+    bool zero_page_for_zeroed_page_pool();
 
     OwnPtr<Region> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
     OwnPtr<Region> allocate_kernel_region(size_t, StringView name, Region::Access access, AllocationStrategy strategy = AllocationStrategy::Reserve, Region::Cacheable = Region::Cacheable::Yes);
@@ -159,6 +177,9 @@ public:
         PhysicalSize user_physical_pages_used { 0 };
         PhysicalSize user_physical_pages_committed { 0 };
         PhysicalSize user_physical_pages_uncommitted { 0 };
+        PhysicalSize user_physical_pages_zeroed { 0 };
+        u64 zeroed_page_pool_hits { 0 };
+        u64 zeroed_page_pool_misses { 0 };
         PhysicalSize super_physical_pages { 0 };
         PhysicalSize super_physical_pages_used { 0 };
     };
@@ -169,6 +190,10 @@ public:
         return m_system_memory_info;
     }
 
+    MemoryPressureLevel memory_pressure_level();
+    // Caches should give memory back when this returns true.
+    bool is_under_memory_pressure() { return memory_pressure_level() != MemoryPressureLevel::None; }
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -192,6 +217,9 @@ public:
 
     void dump_kernel_regions();
 
+    size_t inode_fault_around_page_count() const { return m_inode_fault_around_page_count; }
+    size_t inode_read_ahead_page_count() const { return m_inode_read_ahead_page_count; }
+
     PhysicalPage& shared_zero_page() { return *m_shared_zero_page; }
     PhysicalPage& lazy_committed_page() { return *m_lazy_committed_page; }
 
@@ -224,7 +252,12 @@ private:
 
     static Region* find_region_from_vaddr(VirtualAddress);
 
-    RefPtr<PhysicalPage> find_free_user_physical_page(bool);
+    RefPtr<PhysicalPage> find_free_user_physical_page(bool committed, ShouldZeroFill&);
+    Optional<PhysicalAddress> take_user_physical_page_from_cache();
+    Optional<PhysicalAddress> take_page_from_zeroed_page_pool();
+    void return_user_physical_page_to_cache(PhysicalAddress);
+    PhysicalRegion* user_physical_region_containing(PhysicalAddress);
+    void zero_fill_physical_page(PhysicalPage&);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
@@ -238,6 +271,7 @@ private:
 
     PageTableEntry* pte(PageDirectory&, VirtualAddress);
     PageTableEntry* ensure_pte(PageDirectory&, VirtualAddress);
+    PageDirectoryEntry* ensure_pde_for_huge_page(PageDirectory&, VirtualAddress);
     void release_pte(PageDirectory&, VirtualAddress, bool);
 
     RefPtr<PageDirectory> m_kernel_page_directory;
@@ -247,6 +281,14 @@ private:
 
     SystemMemoryInfo m_system_memory_info;
 
+    size_t m_inode_fault_around_page_count { 0 };
+    size_t m_inode_read_ahead_page_count { 0 };
+
+    // Free pages that have already been zeroed by the PageZeroingTask.
+    // Like the per-processor page caches, these are accounted for as free.
+    static constexpr size_t zeroed_page_pool_capacity = 256;
+    Array<PhysicalAddress, zeroed_page_pool_capacity> m_zeroed_page_pool;
+
     NonnullOwnPtrVector<PhysicalRegion> m_user_physical_regions;
     NonnullOwnPtrVector<PhysicalRegion> m_super_physical_regions;
     OwnPtr<PhysicalRegion> m_physical_pages_region;
@@ -120,6 +120,23 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
     return PhysicalPage::create(page.value());
 }
 
+size_t PhysicalRegion::take_free_pages(Span<PhysicalAddress> pages)
+{
+    size_t taken = 0;
+    while (taken < pages.size() && !m_usable_zones.is_empty()) {
+        auto& zone = *m_usable_zones.first();
+        auto page = zone.allocate_block(0);
+        VERIFY(page.has_value());
+        pages[taken++] = page.value();
+
+        if (zone.is_empty()) {
+            // We've exhausted this zone, move it to the full zones list.
+            m_full_zones.append(zone);
+        }
+    }
+    return taken;
+}
+
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
     // FIXME: Find a way to avoid looping over the zones here.
@@ -35,6 +35,7 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(unsigned);
 
     RefPtr<PhysicalPage> take_free_page();
+    size_t take_free_pages(Span<PhysicalAddress>);
     NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/Memory.h>
 #include <AK/StringView.h>
 #include <Kernel/Debug.h>
@@ -71,6 +72,7 @@ OwnPtr<Region> Region::clone()
             return nullptr;
         }
         region->set_mmap(m_mmap);
+        region->set_write_combining(m_write_combining);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
         return region;
@@ -99,6 +101,7 @@ OwnPtr<Region> Region::clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap);
+    clone_region->set_write_combining(m_write_combining);
     return clone_region;
 }
 
@@ -138,15 +141,26 @@ size_t Region::amount_resident() const
 
 size_t Region::amount_shared() const
 {
+    // The pages of a VMObject are only reffed by the VMObject itself, so all of its resident pages are shared
+    // as soon as it's mapped by another region (e.g. the .text of a library that's mapped in many processes).
+    // Pages that are still shared with another VMObject after a fork() have more than one ref.
+    bool vmobject_is_shared = vmobject().is_mapped_by_multiple_regions();
     size_t bytes = 0;
     for (size_t i = 0; i < page_count(); ++i) {
         auto* page = physical_page(i);
-        if (page && page->ref_count() > 1 && !page->is_shared_zero_page() && !page->is_lazy_committed_page())
+        if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page())
+            continue;
+        if (vmobject_is_shared || page->ref_count() > 1)
             bytes += PAGE_SIZE;
     }
     return bytes;
 }
 
+size_t Region::amount_private() const
+{
+    return amount_resident() - amount_shared();
+}
+
 OwnPtr<Region> Region::try_create_user_accessible(Range const& range, NonnullRefPtr<VMObject> vmobject, size_t offset_in_vmobject, OwnPtr<KString> name, Region::Access access, Cacheable cacheable, bool shared)
 {
     auto region = adopt_own_if_nonnull(new (nothrow) Region(range, move(vmobject), offset_in_vmobject, move(name), access, cacheable, shared));
@@ -195,6 +209,7 @@ bool Region::map_individual_page_impl(size_t page_index)
         pte->clear();
     } else {
         pte->set_cache_disabled(!m_cacheable);
+        pte->set_pat(m_cacheable && m_write_combining && Processor::current().has_feature(CPUFeature::PAT));
         pte->set_physical_page_base(page->paddr().get());
         pte->set_present(true);
         if (page->is_shared_zero_page() || page->is_lazy_committed_page() || should_cow(page_index))
@@ -208,6 +223,58 @@ bool Region::map_individual_page_impl(size_t page_index)
     return true;
 }
 
+bool Region::can_map_with_huge_page(size_t page_index) const
+{
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if (page_vaddr.get() % huge_page_size != 0 || page_index + pages_per_huge_page > page_count())
+        return false;
+    if (!is_readable() && !is_writable())
+        return false;
+    // The PAT bit of a huge page lives among the address bits, so write-combining regions stick to small pages.
+    if (m_write_combining)
+        return false;
+
+    // All the pages have to be physically contiguous, starting at a huge page boundary,
+    // and they all need to be mapped with the same permissions.
+    auto* first_page = physical_page(page_index);
+    if (!first_page || first_page->paddr().get() % huge_page_size != 0)
+        return false;
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto* page = physical_page(page_index + i);
+        if (!page || page->paddr() != first_page->paddr().offset(i * PAGE_SIZE))
+            return false;
+        if (page->is_shared_zero_page() || page->is_lazy_committed_page() || should_cow(page_index + i))
+            return false;
+    }
+    return true;
+}
+
+bool Region::map_huge_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().own_lock());
+    auto page_vaddr = vaddr_from_page_index(page_index);
+
+    bool user_allowed = page_vaddr.get() >= 0x00800000 && is_user_address(page_vaddr);
+    if (is_mmap() && !user_allowed) {
+        PANIC("About to map mmap'ed page at a kernel address");
+    }
+
+    // NOTE: We have to take the MM lock for PDE's to stay valid while we use them.
+    ScopedSpinLock mm_locker(s_mm_lock);
+
+    auto* pde = MM.ensure_pde_for_huge_page(*m_page_directory, page_vaddr);
+    auto* page = physical_page(page_index);
+    pde->set_page_table_base(page->paddr().get());
+    pde->set_huge(true);
+    pde->set_cache_disabled(!m_cacheable);
+    pde->set_writable(is_writable());
+    if (Processor::current().has_feature(CPUFeature::NX))
+        pde->set_execute_disabled(!is_executable());
+    pde->set_user_allowed(user_allowed);
+    pde->set_present(true);
+    return true;
+}
+
 bool Region::do_remap_vmobject_page(size_t page_index, bool with_flush)
 {
     ScopedSpinLock lock(vmobject().m_lock);
@@ -234,7 +301,7 @@ bool Region::remap_vmobject_page(size_t page_index, bool with_flush)
     return success;
 }
 
-void Region::unmap(ShouldDeallocateVirtualMemoryRange deallocate_range)
+void Region::unmap(ShouldDeallocateVirtualMemoryRange deallocate_range, ShouldFlushTLB should_flush_tlb)
 {
     ScopedSpinLock lock(s_mm_lock);
     if (!m_page_directory)
@@ -245,7 +312,8 @@ void Region::unmap(ShouldDeallocateVirtualMemoryRange deallocate_range)
         auto vaddr = vaddr_from_page_index(i);
         MM.release_pte(*m_page_directory, vaddr, i == count - 1);
     }
-    MM.flush_tlb(m_page_directory, vaddr(), page_count());
+    if (should_flush_tlb == ShouldFlushTLB::Yes)
+        MM.flush_tlb(m_page_directory, vaddr(), page_count());
     if (deallocate_range == ShouldDeallocateVirtualMemoryRange::Yes) {
         if (m_page_directory->range_allocator().contains(range()))
             m_page_directory->range_allocator().deallocate(range());
@@ -275,6 +343,12 @@ bool Region::map(PageDirectory& page_directory, ShouldFlushTLB should_flush_tlb)
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (can_map_with_huge_page(page_index)) {
+            if (!map_huge_page_impl(page_index))
+                break;
+            page_index += pages_per_huge_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -287,10 +361,10 @@ bool Region::map(PageDirectory& page_directory, ShouldFlushTLB should_flush_tlb)
     return false;
 }
 
-void Region::remap()
+void Region::remap(ShouldFlushTLB should_flush_tlb)
 {
     VERIFY(m_page_directory);
-    map(*m_page_directory);
+    map(*m_page_directory, should_flush_tlb);
 }
 
 PageFaultResponse Region::handle_fault(PageFault const& fault)
@@ -412,11 +486,25 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (current_thread)
         current_thread->did_inode_fault();
 
+    // Rather than reading just the faulting page, read in the missing pages around it
+    // (or ahead of it, if the faults look sequential) with a single inode read.
+    auto pages_to_read = inode_vmobject.pages_to_read_for_fault(page_index_in_vmobject);
+    VERIFY(page_index_in_vmobject >= pages_to_read.first_page_index);
+    VERIFY(page_index_in_vmobject < pages_to_read.first_page_index + pages_to_read.page_count);
+    dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Reading {} page(s) starting at page index {}", pages_to_read.page_count, pages_to_read.first_page_index);
+
     u8 page_buffer[PAGE_SIZE];
+    ByteBuffer read_ahead_buffer;
+    u8* read_buffer = page_buffer;
+    if (pages_to_read.page_count > 1) {
+        read_ahead_buffer = ByteBuffer::create_uninitialized(pages_to_read.page_count * PAGE_SIZE);
+        read_buffer = read_ahead_buffer.data();
+    }
+    auto read_size = pages_to_read.page_count * PAGE_SIZE;
     auto& inode = inode_vmobject.inode();
 
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(read_buffer);
+    auto result = inode.read_bytes(pages_to_read.first_page_index * PAGE_SIZE, read_size, buffer, nullptr);
 
     if (result.is_error()) {
         dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
@@ -424,34 +512,49 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     }
 
     auto nread = result.value();
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+    if (nread < read_size) {
+        // If we read less than we asked for, zero out the rest to avoid leaking uninitialized data.
+        memset(read_buffer + nread, 0, read_size - nread);
     }
 
     ScopedSpinLock locker(inode_vmobject.m_lock);
 
-    if (!vmobject_physical_page_entry.is_null()) {
-        // Someone else faulted in this page while we were reading from the inode.
-        // No harm done (other than some duplicate work), remap the page here and return.
-        dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-        if (!remap_vmobject_page(page_index_in_vmobject))
+    for (size_t i = 0; i < pages_to_read.page_count; ++i) {
+        auto page_index = pages_to_read.first_page_index + i;
+        bool is_faulting_page = page_index == page_index_in_vmobject;
+        // Don't bother with read-ahead pages that are entirely past the end of the inode.
+        if (!is_faulting_page && i * PAGE_SIZE >= nread)
+            continue;
+
+        auto& physical_page_entry = inode_vmobject.physical_pages()[page_index];
+        if (!physical_page_entry.is_null()) {
+            // Someone else faulted in this page while we were reading from the inode.
+            // No harm done (other than some duplicate work), remap the page here and move on.
+            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
+            if (!remap_vmobject_page(page_index) && is_faulting_page)
+                return PageFaultResponse::OutOfMemory;
+            continue;
+        }
+
+        physical_page_entry = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
+
+        if (physical_page_entry.is_null()) {
+            if (!is_faulting_page) {
+                // We're only reading ahead, the faulting page itself can still be resolved.
+                continue;
+            }
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
             return PageFaultResponse::OutOfMemory;
-        return PageFaultResponse::Continue;
-    }
+        }
 
-    vmobject_physical_page_entry = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
+        u8* dest_ptr = MM.quickmap_page(*physical_page_entry);
+        memcpy(dest_ptr, read_buffer + i * PAGE_SIZE, PAGE_SIZE);
+        MM.unquickmap_page();
 
-    if (vmobject_physical_page_entry.is_null()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
+        // The read-ahead pages were not present before, so there are no stale TLB entries to flush.
+        remap_vmobject_page(page_index, is_faulting_page);
     }
 
-    u8* dest_ptr = MM.quickmap_page(*vmobject_physical_page_entry);
-    memcpy(dest_ptr, page_buffer, PAGE_SIZE);
-    MM.unquickmap_page();
-
-    remap_vmobject_page(page_index_in_vmobject);
     return PageFaultResponse::Continue;
 }
 
@@ -63,6 +63,11 @@ public:
     bool has_been_executable() const { return m_access & Access::HasBeenExecutable; }
 
     bool is_cacheable() const { return m_cacheable; }
+
+    // Writes to a write-combining region are buffered and go out in bursts, which suits framebuffers that are only ever
+    // written by the CPU. This falls back to the usual caching on CPUs without PAT.
+    bool is_write_combining() const { return m_write_combining; }
+    void set_write_combining(bool write_combining) { m_write_combining = write_combining; }
     StringView name() const { return m_name ? m_name->view() : StringView {}; }
     OwnPtr<KString> take_name() { return move(m_name); }
     Region::Access access() const { return static_cast<Region::Access>(m_access); }
@@ -155,6 +160,7 @@ public:
 
     size_t amount_resident() const;
     size_t amount_shared() const;
+    size_t amount_private() const;
     size_t amount_dirty() const;
 
     bool should_cow(size_t page_index) const;
@@ -172,9 +178,9 @@ public:
         No,
         Yes,
     };
-    void unmap(ShouldDeallocateVirtualMemoryRange = ShouldDeallocateVirtualMemoryRange::Yes);
+    void unmap(ShouldDeallocateVirtualMemoryRange = ShouldDeallocateVirtualMemoryRange::Yes, ShouldFlushTLB = ShouldFlushTLB::Yes);
 
-    void remap();
+    void remap(ShouldFlushTLB = ShouldFlushTLB::Yes);
 
     bool is_syscall_region() const { return m_syscall_region; }
     void set_syscall_region(bool b) { m_syscall_region = b; }
@@ -198,6 +204,8 @@ private:
     PageFaultResponse handle_zero_fault(size_t page_index);
 
     bool map_individual_page_impl(size_t page_index);
+    bool can_map_with_huge_page(size_t page_index) const;
+    bool map_huge_page_impl(size_t page_index);
 
     RefPtr<PageDirectory> m_page_directory;
     Range m_range;
@@ -207,6 +215,7 @@ private:
     u8 m_access { Region::None };
     bool m_shared : 1 { false };
     bool m_cacheable : 1 { false };
+    bool m_write_combining : 1 { false };
     bool m_stack : 1 { false };
     bool m_mmap : 1 { false };
     bool m_syscall_region : 1 { false };
@@ -12,6 +12,7 @@
 #include <Kernel/VM/InodeVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/Space.h>
+#include <Kernel/VM/TLBGather.h>
 
 namespace Kernel {
 
@@ -69,20 +70,24 @@ KResult Space::unmap_mmap_range(VirtualAddress addr, size_t size)
         auto region = take_region(*old_region);
 
         // We manually unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No);
+        // The TLB flush is deferred until the new region(s) are mapped, so that it only happens once.
+        TLBGather tlb_gather(page_directory());
+        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No, ShouldFlushTLB::No);
+        tlb_gather.add(region->range());
 
         auto new_regions_or_error = try_split_region_around_range(*region, range_to_unmap);
         if (new_regions_or_error.is_error())
             return new_regions_or_error.error();
         auto& new_regions = new_regions_or_error.value();
 
-        // Instead we give back the unwanted VM manually.
-        page_directory().range_allocator().deallocate(range_to_unmap);
-
-        // And finally we map the new region(s) using our page directory (they were just allocated and don't have one).
+        // We map the new region(s) using our page directory (they were just allocated and don't have one).
         for (auto* new_region : new_regions) {
-            new_region->map(page_directory());
+            new_region->map(page_directory(), ShouldFlushTLB::No);
         }
+        tlb_gather.flush();
+
+        // And finally we give back the unwanted VM manually.
+        page_directory().range_allocator().deallocate(range_to_unmap);
 
         PerformanceManager::add_unmap_perf_event(*Process::current(), range_to_unmap);
 
@@ -102,6 +107,7 @@ KResult Space::unmap_mmap_range(VirtualAddress addr, size_t size)
     }
 
     Vector<Region*, 2> new_regions;
+    TLBGather tlb_gather(page_directory());
 
     for (auto* old_region : regions) {
         // If it's a full match we can remove the entire old region.
@@ -115,7 +121,8 @@ KResult Space::unmap_mmap_range(VirtualAddress addr, size_t size)
         auto region = take_region(*old_region);
 
         // We manually unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No);
+        region->unmap(Region::ShouldDeallocateVirtualMemoryRange::No, ShouldFlushTLB::No);
+        tlb_gather.add(region->range());
 
         // Otherwise, split the regions and collect them for future mapping.
         auto split_regions_or_error = try_split_region_around_range(*region, range_to_unmap);
@@ -126,13 +133,14 @@ KResult Space::unmap_mmap_range(VirtualAddress addr, size_t size)
             return ENOMEM;
     }
 
-    // Give back any unwanted VM to the range allocator.
-    page_directory().range_allocator().deallocate(range_to_unmap);
-
-    // And finally map the new region(s) into our page directory.
+    // Map the new region(s) into our page directory.
     for (auto* new_region : new_regions) {
-        new_region->map(page_directory());
+        new_region->map(page_directory(), ShouldFlushTLB::No);
     }
+    tlb_gather.flush();
+
+    // And finally give back any unwanted VM to the range allocator.
+    page_directory().range_allocator().deallocate(range_to_unmap);
 
     PerformanceManager::add_unmap_perf_event(*Process::current(), range_to_unmap);
 
@@ -397,10 +405,7 @@ size_t Space::amount_resident() const
 size_t Space::amount_shared() const
 {
     ScopedSpinLock lock(m_lock);
-    // FIXME: This will double count if multiple regions use the same physical page.
-    // FIXME: It doesn't work at the moment, since it relies on PhysicalPage ref counts,
-    //        and each PhysicalPage is only reffed by its VMObject. This needs to be refactored
-    //        so that every Region contributes +1 ref to each of its PhysicalPages.
+    // FIXME: This will double count if multiple regions of this space use the same physical page.
     size_t amount = 0;
     for (auto& region : m_regions) {
         amount += region->amount_shared();
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/VM/Range.h>
+
+namespace Kernel {
+
+// Collects the ranges of a page directory whose mappings were changed, so that
+// they can all be flushed from the TLBs with a single shootdown at the end.
+class TLBGather {
+    AK_MAKE_NONCOPYABLE(TLBGather);
+    AK_MAKE_NONMOVABLE(TLBGather);
+
+public:
+    explicit TLBGather(PageDirectory const& page_directory)
+        : m_page_directory(page_directory)
+    {
+    }
+
+    ~TLBGather() { flush(); }
+
+    void add(Range const& range)
+    {
+        if (!m_range.has_value()) {
+            m_range = range;
+            return;
+        }
+        auto base = range.base() < m_range->base() ? range.base() : m_range->base();
+        auto end = range.end() > m_range->end() ? range.end() : m_range->end();
+        m_range = Range { base, end.get() - base.get() };
+    }
+
+    void flush()
+    {
+        if (!m_range.has_value())
+            return;
+        MM.flush_tlb(&m_page_directory, m_range->base(), m_range->size() / PAGE_SIZE);
+        m_range.clear();
+    }
+
+private:
+    PageDirectory const& m_page_directory;
+    Optional<Range> m_range;
+};
+
+}
@@ -36,6 +36,14 @@ UNMAP_AFTER_INIT void VirtIO::detect()
             // This should have been initialized by the graphics subsystem
             break;
         }
+        case PCI::DeviceID::VirtIOBlock: {
+            // This should have been initialized by the storage subsystem
+            break;
+        }
+        case PCI::DeviceID::VirtIONetwork: {
+            // This is initialized by the networking subsystem
+            break;
+        }
         default:
             dbgln_if(VIRTIO_DEBUG, "VirtIO: Unknown VirtIO device with ID: {}", id.device_id);
             break;
@@ -364,13 +372,16 @@ bool VirtIODevice::handle_irq(const RegisterState&)
     }
     if (isr_type & QUEUE_INTERRUPT) {
         dbgln_if(VIRTIO_DEBUG, "{}: VirtIO Queue interrupt!", m_class_name);
+        // All of the queues share one interrupt, so every one of them may have been updated.
+        bool handled_update = false;
         for (size_t i = 0; i < m_queues.size(); i++) {
             if (get_queue(i).new_data_available()) {
                 handle_queue_update(i);
-                return true;
+                handled_update = true;
             }
         }
-        dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", m_class_name);
+        if (!handled_update)
+            dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", m_class_name);
     }
     return true;
 }
@@ -381,6 +392,13 @@ void VirtIODevice::supply_chain_and_notify(u16 queue_index, VirtIOQueueChain& ch
     VERIFY(&chain.queue() == &queue);
     VERIFY(queue.lock().is_locked());
     chain.submit_to_queue();
+    notify_queue_if_needed(queue_index);
+}
+
+void VirtIODevice::notify_queue_if_needed(u16 queue_index)
+{
+    auto& queue = get_queue(queue_index);
+    VERIFY(queue.lock().is_locked());
     if (queue.should_notify())
         notify_queue(queue_index);
 }
@@ -196,6 +196,8 @@ protected:
     }
 
     void supply_chain_and_notify(u16 queue_index, VirtIOQueueChain& chain);
+    // Lets the device know about the chains that were submitted to the queue, unless it has asked not to be told.
+    void notify_queue_if_needed(u16 queue_index);
 
     virtual bool handle_device_config_change() = 0;
     virtual void handle_queue_update(u16 queue_index) = 0;
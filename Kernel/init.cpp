@@ -20,6 +20,7 @@
 #include <Kernel/Devices/HID/HIDManagement.h>
 #include <Kernel/Devices/KCOVDevice.h>
 #include <Kernel/Devices/MemoryDevice.h>
+#include <Kernel/Devices/MemoryPressureDevice.h>
 #include <Kernel/Devices/NullDevice.h>
 #include <Kernel/Devices/PCISerialDevice.h>
 #include <Kernel/Devices/RandomDevice.h>
@@ -53,7 +54,10 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/MemoryReclaimTask.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/WriteBackTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VirtIO/VirtIO.h>
@@ -297,6 +301,9 @@ void init_stage2(void*)
 
     SyncTask::spawn();
     FinalizerTask::spawn();
+    PageZeroingTask::spawn();
+    WriteBackTask::spawn();
+    MemoryReclaimTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -317,6 +324,7 @@ void init_stage2(void*)
     (void)ZeroDevice::must_create().leak_ref();
     (void)FullDevice::must_create().leak_ref();
     (void)RandomDevice::must_create().leak_ref();
+    (void)MemoryPressureDevice::must_create().leak_ref();
     PTYMultiplexer::initialize();
     SB16::detect();
 
@@ -25,6 +25,7 @@ set(CSS_LOADER_DEBUG ON)
 set(CSS_PARSER_DEBUG ON)
 set(CSS_TOKENIZER_DEBUG ON)
 set(CURSOR_TOOL_DEBUG ON)
+set(CUSTODY_CACHE_DEBUG ON)
 set(DDS_DEBUG ON)
 set(DEBUG_AUTOCOMPLETE ON)
 set(DEBUG_CPP_LANGUAGE_SERVER ON)
@@ -46,12 +47,14 @@ set(ETHERNET_DEBUG ON)
 set(ETHERNET_VERY_DEBUG ON)
 set(EVENT_DEBUG ON)
 set(EVENTLOOP_DEBUG ON)
+set(EVENT_POLL_DEBUG ON)
 set(EXEC_DEBUG ON)
 set(EXT2_BLOCKLIST_DEBUG ON)
 set(EXT2_DEBUG ON)
 set(EXT2_VERY_DEBUG ON)
 set(FILE_CONTENT_DEBUG ON)
 set(FILEDESCRIPTION_DEBUG ON)
+set(FILE_INDEX_DEBUG ON)
 set(FILE_WATCHER_DEBUG ON)
 set(FILL_PATH_DEBUG ON)
 set(FORK_DEBUG ON)
@@ -74,16 +77,20 @@ set(HIGHLIGHT_FOCUSED_FRAME_DEBUG ON)
 set(HPET_COMPARATOR_DEBUG ON)
 set(HPET_DEBUG ON)
 set(HTML_SCRIPT_DEBUG ON)
+set(HTTP2_DEBUG ON)
 set(HTTPSJOB_DEBUG ON)
+set(HTTP_CACHE_DEBUG ON)
 set(HUNKS_DEBUG ON)
 set(ICMP_DEBUG ON)
 set(ICO_DEBUG ON)
+set(ICON_CACHE_DEBUG ON)
 set(IMAGE_DECODER_DEBUG ON)
 set(IMAGE_LOADER_DEBUG ON)
 set(INTEL_GRAPHICS_DEBUG ON)
 set(INTERRUPT_DEBUG ON)
 set(IOAPIC_DEBUG ON)
 set(IO_DEBUG ON)
+set(IO_RING_DEBUG ON)
 set(IPV4_DEBUG ON)
 set(IPV4_SOCKET_DEBUG ON)
 set(IRC_DEBUG ON)
@@ -103,6 +110,7 @@ set(LOCK_DEBUG ON)
 set(LOCK_RESTORE_DEBUG ON)
 set(LOCK_TRACE_DEBUG ON)
 set(LOOKUPSERVER_DEBUG ON)
+set(LOOPBACK_DEBUG ON)
 set(MALLOC_DEBUG ON)
 set(MARKDOWN_DEBUG ON)
 set(MATROSKA_DEBUG ON)
@@ -110,6 +118,7 @@ set(MATROSKA_TRACE_DEBUG ON)
 set(MASTERPTY_DEBUG ON)
 set(MBR_DEBUG ON)
 set(MEMORY_DEBUG ON)
+set(MEMORY_RECLAIM_DEBUG ON)
 set(MENU_DEBUG ON)
 set(MENUS_DEBUG ON)
 set(MINIMIZE_ANIMATION_DEBUG ON)
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// These cover the common ways the tables are used across the system. To compare against another
+// implementation of HashTable, run them before and after the change, e.g. with `BenchmarkHashTable --bench`.
+static constexpr size_t element_count = 100000;
+static constexpr size_t run_count = 20;
+
+static HashTable<int> make_int_table()
+{
+    HashTable<int> table;
+    for (size_t i = 0; i < element_count; ++i)
+        table.set(i * 3);
+    return table;
+}
+
+BENCHMARK_CASE(insert_ints)
+{
+    for (size_t run = 0; run < run_count; ++run) {
+        auto table = make_int_table();
+        EXPECT_EQ(table.size(), element_count);
+    }
+}
+
+BENCHMARK_CASE(insert_ints_with_reserved_capacity)
+{
+    for (size_t run = 0; run < run_count; ++run) {
+        HashTable<int> table;
+        table.ensure_capacity(element_count);
+        for (size_t i = 0; i < element_count; ++i)
+            table.set(i * 3);
+        EXPECT_EQ(table.size(), element_count);
+    }
+}
+
+BENCHMARK_CASE(lookup_present_ints)
+{
+    auto table = make_int_table();
+    size_t found = 0;
+    for (size_t run = 0; run < run_count; ++run) {
+        for (size_t i = 0; i < element_count; ++i)
+            found += table.contains(i * 3);
+    }
+    EXPECT_EQ(found, element_count * run_count);
+}
+
+BENCHMARK_CASE(lookup_missing_ints)
+{
+    auto table = make_int_table();
+    size_t found = 0;
+    for (size_t run = 0; run < run_count; ++run) {
+        for (size_t i = 0; i < element_count; ++i)
+            found += table.contains(i * 3 + 1);
+    }
+    EXPECT_EQ(found, 0u);
+}
+
+// Keeps the size constant while replacing every element, which is where deleted buckets pile up.
+BENCHMARK_CASE(remove_and_insert_ints)
+{
+    auto table = make_int_table();
+    for (size_t run = 0; run < run_count; ++run) {
+        for (size_t i = 0; i < element_count; ++i) {
+            table.remove((run * element_count + i) * 3);
+            table.set(((run + 1) * element_count + i) * 3);
+        }
+    }
+    EXPECT_EQ(table.size(), element_count);
+}
+
+BENCHMARK_CASE(iterate_ints)
+{
+    auto table = make_int_table();
+    size_t sum = 0;
+    for (size_t run = 0; run < run_count; ++run) {
+        for (auto value : table)
+            sum += value;
+    }
+    EXPECT_EQ(sum, run_count * 3 * (element_count * (element_count - 1) / 2));
+}
+
+BENCHMARK_CASE(lookup_strings)
+{
+    Vector<String> keys;
+    HashMap<String, size_t> map;
+    for (size_t i = 0; i < element_count; ++i) {
+        keys.append(String::formatted("key_{}", i));
+        map.set(keys.last(), i);
+    }
+
+    size_t sum = 0;
+    for (size_t run = 0; run < run_count; ++run) {
+        for (auto& key : keys)
+            sum += map.get(key).value();
+    }
+    EXPECT_EQ(sum, run_count * (element_count * (element_count - 1) / 2));
+}
+
+// Lots of small maps, like the ones hanging off objects all over LibJS and LibWeb.
+BENCHMARK_CASE(many_small_maps)
+{
+    for (size_t run = 0; run < run_count; ++run) {
+        for (size_t i = 0; i < element_count / 8; ++i) {
+            HashMap<int, int> map;
+            for (int j = 0; j < 8; ++j)
+                map.set(j, j);
+            EXPECT_EQ(map.get(7).value(), 7);
+        }
+    }
+}
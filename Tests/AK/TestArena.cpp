@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Arena.h>
+#include <AK/String.h>
+
+TEST_CASE(make_trivial_objects)
+{
+    Arena arena;
+    auto& a = arena.make<int>(1);
+    auto& b = arena.make<u64>(2u);
+    auto& c = arena.make<char>('c');
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 2u);
+    EXPECT_EQ(c, 'c');
+    EXPECT_EQ(reinterpret_cast<FlatPtr>(&b) % alignof(u64), 0u);
+}
+
+TEST_CASE(alignment)
+{
+    Arena arena;
+    (void)arena.allocate(1, 1);
+    for (size_t alignment = 1; alignment <= 4096; alignment *= 2) {
+        auto address = reinterpret_cast<FlatPtr>(arena.allocate(3, alignment));
+        EXPECT_EQ(address % alignment, 0u);
+    }
+}
+
+TEST_CASE(allocations_spanning_many_chunks)
+{
+    Arena arena(256);
+    Vector<u32*> values;
+    for (u32 i = 0; i < 10000; ++i)
+        values.append(&arena.make<u32>(i));
+    for (u32 i = 0; i < 10000; ++i)
+        EXPECT_EQ(*values[i], i);
+
+    // This doesn't fit a regular chunk at all.
+    auto* big = arena.allocate_uninitialized<u8>(4096);
+    __builtin_memset(big, 0xaa, 4096);
+    EXPECT_EQ(*values[9999], 9999u);
+}
+
+struct DestructionCounter {
+    explicit DestructionCounter(Vector<int>& destroyed, int id)
+        : destroyed(destroyed)
+        , id(id)
+    {
+    }
+    ~DestructionCounter() { destroyed.append(id); }
+
+    Vector<int>& destroyed;
+    int id;
+};
+
+TEST_CASE(destructors_run_in_reverse_order)
+{
+    Vector<int> destroyed;
+    {
+        Arena arena;
+        arena.make<DestructionCounter>(destroyed, 1);
+        arena.make<DestructionCounter>(destroyed, 2);
+        arena.make<DestructionCounter>(destroyed, 3);
+        EXPECT(destroyed.is_empty());
+    }
+    EXPECT_EQ(destroyed.size(), 3u);
+    EXPECT_EQ(destroyed[0], 3);
+    EXPECT_EQ(destroyed[1], 2);
+    EXPECT_EQ(destroyed[2], 1);
+}
+
+TEST_CASE(clear_and_reuse)
+{
+    Vector<int> destroyed;
+    Arena arena;
+    arena.make<DestructionCounter>(destroyed, 1);
+    EXPECT(arena.allocated_bytes() > 0);
+    arena.clear();
+    EXPECT_EQ(destroyed.size(), 1u);
+    EXPECT_EQ(arena.allocated_bytes(), 0u);
+
+    auto& string = arena.make<String>("still works");
+    EXPECT_EQ(string, "still works");
+}
+
+TEST_CASE(move_arena)
+{
+    Vector<int> destroyed;
+    Arena arena;
+    auto& value = arena.make<int>(42);
+    arena.make<DestructionCounter>(destroyed, 1);
+    {
+        Arena other = move(arena);
+        EXPECT_EQ(value, 42);
+        EXPECT_EQ(arena.allocated_bytes(), 0u);
+    }
+    EXPECT_EQ(destroyed.size(), 1u);
+}
+
+TEST_CASE(arena_vector)
+{
+    Arena arena;
+    ArenaVector<String> strings(arena);
+    EXPECT(strings.is_empty());
+    for (int i = 0; i < 100; ++i)
+        strings.append(String::number(i));
+    EXPECT_EQ(strings.size(), 100u);
+    EXPECT_EQ(strings.first(), "0");
+    EXPECT_EQ(strings.last(), "99");
+
+    int i = 0;
+    for (auto& string : strings)
+        EXPECT_EQ(string, String::number(i++));
+}
+
+TEST_CASE(arena_vector_destroys_its_elements)
+{
+    Vector<int> destroyed;
+    Arena arena;
+    {
+        auto& vector = arena.make<ArenaVector<DestructionCounter>>(arena);
+        vector.ensure_capacity(2);
+        vector.empend(destroyed, 1);
+        vector.empend(destroyed, 2);
+    }
+    EXPECT(destroyed.is_empty());
+    arena.clear();
+    EXPECT_EQ(destroyed.size(), 2u);
+}
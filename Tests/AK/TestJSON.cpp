@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
 #include <AK/JsonValue.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -123,3 +124,74 @@ TEST_CASE(json_u64_roundtrip)
     EXPECT_EQ_FORCE(value.has_value(), true);
     EXPECT_EQ(value->as_u64(), big_value);
 }
+
+TEST_CASE(json_long_strings_with_escapes)
+{
+    // Long enough to be scanned in chunks, with the escapes and the end landing on either side of a chunk boundary.
+    for (size_t length = 0; length < 40; ++length) {
+        StringBuilder expected;
+        StringBuilder json;
+        json.append('"');
+        for (size_t i = 0; i < length; ++i) {
+            if (i % 7 == 3) {
+                expected.append("\"\n");
+                json.append("\\\"\\n");
+            } else {
+                expected.append('a' + i % 26);
+                json.append('a' + i % 26);
+            }
+        }
+        json.append('"');
+        auto value = JsonValue::from_string(json.string_view());
+        EXPECT(value.has_value());
+        EXPECT_EQ(value->as_string(), expected.to_string());
+    }
+
+    EXPECT(!JsonValue::from_string("\"0123456789abcdef\x01\"").has_value());
+    EXPECT(!JsonValue::from_string("\"0123456789abcdef").has_value());
+}
+
+TEST_CASE(json_parse_events)
+{
+    class Recorder final : public JsonEventHandler {
+    public:
+        virtual bool on_object_start() override { return record("{"); }
+        virtual bool on_object_key(const StringView& key) override { return record(String::formatted("{}:", key)); }
+        virtual bool on_object_end() override { return record("}"); }
+        virtual bool on_array_start() override { return record("["); }
+        virtual bool on_array_end() override { return record("]"); }
+        virtual bool on_string(const StringView& string) override { return record(String::formatted("'{}'", string)); }
+        virtual bool on_number(const JsonValue& number) override { return record(number.to_string()); }
+        virtual bool on_boolean(bool value) override { return record(value ? "true" : "false"); }
+        virtual bool on_null() override { return record("null"); }
+
+        bool record(const String& event)
+        {
+            if (!m_events.is_empty())
+                m_events.append(' ');
+            m_events.append(event);
+            return m_events.length() < m_limit;
+        }
+
+        String events() const { return m_events.to_string(); }
+
+        size_t m_limit { NumericLimits<size_t>::max() };
+
+    private:
+        StringBuilder m_events;
+    };
+
+    auto json = R"({ "a": [1, -2, 18446744073709551615, "x\ty", true, false, null], "b": {}, "c": [] })"sv;
+    Recorder recorder;
+    EXPECT(JsonParser(json).parse_events(recorder));
+    EXPECT_EQ(recorder.events(), "{ a: [ 1 -2 18446744073709551615 'x\ty' true false null ] b: { } c: [ ] }");
+
+    Recorder stopping_recorder;
+    stopping_recorder.m_limit = 5;
+    EXPECT(!JsonParser(json).parse_events(stopping_recorder));
+    EXPECT_EQ(stopping_recorder.events(), "{ a: [");
+
+    Recorder invalid_recorder;
+    EXPECT(!JsonParser("[1, 2,]"sv).parse_events(invalid_recorder));
+    EXPECT(!JsonParser("[1] 2"sv).parse_events(invalid_recorder));
+}
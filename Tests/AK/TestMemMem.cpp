@@ -66,3 +66,40 @@ TEST_CASE(kmp_two_chunks)
     EXPECT_EQ(result_2.value_or(9), 4u);
     EXPECT(!result_3.has_value());
 }
+
+static Optional<size_t> naive_memmem(Span<const u8> haystack, Span<const u8> needle)
+{
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (__builtin_memcmp(haystack.data() + i, needle.data(), needle.size()) == 0)
+            return i;
+    }
+    return {};
+}
+
+TEST_CASE(matches_naive_search)
+{
+    // Runs of the needle's first byte make the first-byte scan fall back to the linear searches part way through.
+    Array<u8, 300> haystack {};
+    for (size_t i = 0; i < haystack.size(); ++i)
+        haystack[i] = (i % 7 == 0 || i > 150) ? 'a' : 'b' + i % 3;
+    haystack[297] = 'x';
+
+    Array<u8, 40> needle {};
+    needle.fill('a');
+    needle[needle.size() - 1] = 'x';
+
+    for (size_t start = 0; start < 16; ++start) {
+        auto haystack_span = haystack.span().slice(start);
+        for (size_t length = 1; length <= needle.size(); ++length) {
+            auto needle_span = needle.span().slice(needle.size() - length);
+            auto expected = naive_memmem(haystack_span, needle_span);
+            auto result = AK::memmem_optional(haystack_span.data(), haystack_span.size(), needle_span.data(), needle_span.size());
+            EXPECT_EQ(result, expected);
+        }
+
+        u8 byte = 'c';
+        EXPECT_EQ(AK::memmem_optional(haystack_span.data(), haystack_span.size(), &byte, 1), naive_memmem(haystack_span, { &byte, 1 }));
+        byte = 'z';
+        EXPECT(!AK::memmem_optional(haystack_span.data(), haystack_span.size(), &byte, 1).has_value());
+    }
+}
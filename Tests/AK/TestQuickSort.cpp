@@ -10,6 +10,7 @@
 #include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
 #include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
 
 TEST_CASE(sorts_without_copy)
 {
@@ -98,3 +99,82 @@ TEST_CASE(maximum_stack_depth)
 
     delete[] data;
 }
+
+static size_t sort_with_counted_comparisons(Vector<int>& values)
+{
+    size_t comparisons = 0;
+    quick_sort(values, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+    return comparisons;
+}
+
+TEST_CASE(no_quadratic_inputs)
+{
+    // A quadratic sort needs around 50 million comparisons for this many elements.
+    const int size = 10000;
+    const size_t comparison_limit = 30 * size * 14;
+
+    Vector<int> values;
+    for (int i = 0; i < size; ++i)
+        values.append(i);
+    EXPECT(sort_with_counted_comparisons(values) < comparison_limit);
+
+    values.clear();
+    for (int i = 0; i < size; ++i)
+        values.append(size - i);
+    EXPECT(sort_with_counted_comparisons(values) < comparison_limit);
+
+    values.clear();
+    for (int i = 0; i < size; ++i)
+        values.append(42);
+    EXPECT(sort_with_counted_comparisons(values) < comparison_limit);
+
+    values.clear();
+    for (int i = 0; i < size; ++i)
+        values.append(i < size / 2 ? i : size - i);
+    EXPECT(sort_with_counted_comparisons(values) < comparison_limit);
+
+    values.clear();
+    for (int i = 0; i < size; ++i)
+        values.append(i % 3);
+    EXPECT(sort_with_counted_comparisons(values) < comparison_limit);
+}
+
+TEST_CASE(sorts_pseudo_random_input)
+{
+    Vector<int> values;
+    u32 state = 1;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1103515245 + 12345;
+        values.append(static_cast<int>(state >> 16) % 1000);
+    }
+    quick_sort(values);
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+
+    quick_sort(values.begin(), values.end(), [](auto& a, auto& b) { return a > b; });
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] >= values[i]);
+}
+
+TEST_CASE(stable_sort_keeps_equal_elements_in_order)
+{
+    struct KeyAndIndex {
+        int key;
+        int index;
+    };
+    Vector<KeyAndIndex> values;
+    for (int i = 0; i < 1000; ++i)
+        values.append({ (i * 7919) % 13, i });
+
+    stable_sort(values, [](auto& a, auto& b) { return a.key < b.key; });
+    for (size_t i = 1; i < values.size(); ++i) {
+        EXPECT(values[i - 1].key <= values[i].key);
+        if (values[i - 1].key == values[i].key)
+            EXPECT(values[i - 1].index < values[i].index);
+    }
+}
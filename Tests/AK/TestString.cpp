@@ -39,6 +39,24 @@ TEST_CASE(construct_contents)
     EXPECT(test_string != "ABCDEFG");
 }
 
+TEST_CASE(construct_single_character)
+{
+    String a = "a";
+    EXPECT_EQ(a.length(), 1u);
+    EXPECT(!strcmp(a.characters(), "a"));
+    EXPECT(a.impl() == String("a").impl());
+    EXPECT(a.impl() == String::repeated('a', 1).impl());
+    EXPECT(a.impl() == String("A").to_lowercase().impl());
+    EXPECT(a.impl() != String("b").impl());
+
+    String nul { "\0", 1 };
+    EXPECT_EQ(nul.length(), 1u);
+    EXPECT_EQ(nul[0], '\0');
+
+    FlyString fly_a = "a";
+    EXPECT(fly_a.impl() == a.impl());
+}
+
 TEST_CASE(compare)
 {
     String test_string = "ABCDEF";
@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf16View.h>
@@ -50,6 +51,20 @@ TEST_CASE(decode_utf8)
     EXPECT_EQ(i, expected.size());
 }
 
+TEST_CASE(decode_long_utf8)
+{
+    // Long enough for the runs of ASCII to be looked at a block at a time, and broken up by invalid bytes.
+    auto string = String::formatted("{}😀{}\xd0{}\xc1\x81", String::repeated('a', 35), String::repeated('b', 17), String::repeated('c', 3));
+    auto utf16 = AK::utf8_to_utf16(string);
+    EXPECT_EQ(utf16.size(), 35u + 2 + 17 + 1 + 3 + 1);
+    EXPECT_EQ(utf16[34], 'a');
+    EXPECT_EQ(utf16[35], 0xd83d);
+    EXPECT_EQ(utf16[36], 0xde00);
+    EXPECT_EQ(utf16[54], 0xfffd);
+    EXPECT_EQ(utf16[58], 0x41);
+    EXPECT_EQ(Utf16View { utf16 }.to_utf8(), String::formatted("{}😀{}\ufffd{}A", String::repeated('a', 35), String::repeated('b', 17), String::repeated('c', 3)));
+}
+
 TEST_CASE(encode_utf8)
 {
     {
@@ -280,3 +295,18 @@ TEST_CASE(substring_view)
         EXPECT_EQ(view.to_utf8(Utf16View::AllowInvalidCodeUnits::No), "\ufffd"sv);
     }
 }
+
+BENCHMARK_CASE(decode_text)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 10000; ++i) {
+        builder.append("The quick brown fox jumps over the lazy dog, and then some more plain ASCII text follows.\n");
+        builder.append("Привет, мир! 😀 γειά σου κόσμος こんにちは世界\n");
+    }
+    auto text = builder.to_string();
+
+    for (size_t i = 0; i < 100; ++i) {
+        auto utf16 = AK::utf8_to_utf16(text);
+        EXPECT_EQ(utf16.size(), 10000u * (89 + 1 + 39 + 1));
+    }
+}
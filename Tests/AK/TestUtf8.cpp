@@ -7,6 +7,8 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -72,6 +74,23 @@ TEST_CASE(validate_invalid_ut8)
     EXPECT(valid_bytes == 0);
 }
 
+TEST_CASE(validate_long_utf8)
+{
+    // Long enough for the runs of ASCII to be looked at a block at a time.
+    auto string = String::formatted("{}ж{}😀{}", String::repeated('a', 35), String::repeated('b', 17), String::repeated('c', 3));
+    Utf8View utf8 { string };
+    size_t valid_bytes;
+    EXPECT(utf8.validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, string.length());
+    EXPECT_EQ(utf8.length(), 35u + 1 + 17 + 1 + 3);
+
+    auto invalid_string = String::formatted("{}\xd0{}", String::repeated('a', 35), String::repeated('b', 17));
+    Utf8View invalid_utf8 { invalid_string };
+    EXPECT(!invalid_utf8.validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, 35u);
+    EXPECT_EQ(invalid_utf8.length(), 35u + 1 + 17);
+}
+
 TEST_CASE(iterate_utf8)
 {
     Utf8View view("Some weird characters \u00A9\u266A\uA755");
@@ -217,3 +236,30 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+static String make_text(size_t paragraphs)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < paragraphs; ++i) {
+        builder.append("The quick brown fox jumps over the lazy dog, and then some more plain ASCII text follows.\n");
+        builder.append("Привет, мир! 😀 γειά σου κόσμος こんにちは世界\n");
+    }
+    return builder.to_string();
+}
+
+BENCHMARK_CASE(validate_text)
+{
+    auto text = make_text(10000);
+    Utf8View utf8 { text };
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(utf8.validate());
+}
+
+BENCHMARK_CASE(calculate_length_of_text)
+{
+    auto text = make_text(10000);
+    for (size_t i = 0; i < 100; ++i) {
+        Utf8View utf8 { text };
+        EXPECT_EQ(utf8.length(), 10000u * (89 + 1 + 38 + 1));
+    }
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Vector.h>
+#include <LibAudio/Loader.h>
+#include <LibTest/TestCase.h>
+
+// Just enough of a FLAC encoder to produce the different kinds of frames and subframes the decoder has to deal with.
+class FlacWriter {
+public:
+    static constexpr u32 block_size = 4096;
+
+    ByteBuffer encode(const Vector<i32>& left, const Vector<i32>& right, bool with_seek_table)
+    {
+        VERIFY(left.size() % block_size == 0);
+        size_t frame_count = left.size() / block_size;
+
+        // Frames go first, so that the seek table can point at them.
+        Vector<size_t> frame_offsets;
+        for (size_t frame = 0; frame < frame_count; ++frame) {
+            frame_offsets.append(m_bytes.size());
+            write_frame(frame, left.span().slice(frame * block_size, block_size), right.span().slice(frame * block_size, block_size));
+        }
+        auto frames = move(m_bytes);
+        m_bytes.clear();
+        m_bit_count = 0;
+
+        write_bits(0x664C6143, 32); // "fLaC"
+        write_bits(!with_seek_table, 1);
+        write_bits(0, 7); // STREAMINFO
+        write_bits(34, 24);
+        write_bits(block_size, 16);
+        write_bits(block_size, 16);
+        write_bits(0, 24);
+        write_bits(0, 24);
+        write_bits(44100, 20);
+        write_bits(1, 3);  // Two channels
+        write_bits(15, 5); // 16 bits per sample
+        write_bits(0, 4);
+        write_bits(left.size(), 32);
+        for (int i = 0; i < 4; ++i)
+            write_bits(0, 32); // No MD5 checksum
+        if (with_seek_table) {
+            Vector<size_t> seek_frames;
+            for (size_t frame = 0; frame < frame_count; frame += 8)
+                seek_frames.append(frame);
+            write_bits(1, 1);
+            write_bits(3, 7); // SEEKTABLE
+            write_bits((seek_frames.size() + 1) * 18, 24);
+            for (auto frame : seek_frames) {
+                write_bits(0, 32);
+                write_bits(frame * block_size, 32);
+                write_bits(0, 32);
+                write_bits(frame_offsets[frame], 32);
+                write_bits(block_size, 16);
+            }
+            // A placeholder
+            for (int i = 0; i < 4; ++i)
+                write_bits(0xffffffff, 32);
+            write_bits(0, 16);
+        }
+        m_bytes.extend(move(frames));
+        return ByteBuffer::copy(m_bytes.span());
+    }
+
+private:
+    void write_bits(u32 value, u8 count)
+    {
+        for (int bit = count - 1; bit >= 0; --bit) {
+            if (m_bit_count % 8 == 0)
+                m_bytes.append(0);
+            if ((value >> bit) & 1)
+                m_bytes[m_bytes.size() - 1] |= 0x80 >> (m_bit_count % 8);
+            ++m_bit_count;
+        }
+    }
+
+    void align()
+    {
+        m_bit_count = m_bytes.size() * 8;
+    }
+
+    void write_frame(size_t frame, Span<const i32> left, Span<const i32> right)
+    {
+        // Cycle through independent, left/side and mid/side channels.
+        u8 channel_assignment = (u8[]) { 1, 8, 10 }[frame % 3];
+        Vector<i32> first, second;
+        for (size_t i = 0; i < left.size(); ++i) {
+            if (channel_assignment == 1) {
+                first.append(left[i]);
+                second.append(right[i]);
+            } else if (channel_assignment == 8) {
+                first.append(left[i]);
+                second.append(left[i] - right[i]);
+            } else {
+                first.append((left[i] + right[i]) >> 1);
+                second.append(left[i] - right[i]);
+            }
+        }
+
+        write_bits(0b11111111111110, 14);
+        write_bits(0, 1);
+        write_bits(0, 1);  // Fixed block size
+        write_bits(12, 4); // 4096 samples
+        write_bits(9, 4);  // 44.1 kHz
+        write_bits(channel_assignment, 4);
+        write_bits(4, 3); // 16 bits per sample
+        write_bits(0, 1);
+        // The frame number, UTF-8 encoded
+        if (frame < 0x80) {
+            write_bits(frame, 8);
+        } else {
+            VERIFY(frame < 0x800);
+            write_bits(0b11000000 | (frame >> 6), 8);
+            write_bits(0b10000000 | (frame & 0b111111), 8);
+        }
+        write_bits(0, 8); // Header CRC, not checked
+
+        write_subframe(frame, first, 16);
+        write_subframe(frame + 1, second, channel_assignment == 1 ? 16 : 17);
+
+        align();
+        write_bits(0, 16); // Frame CRC, not checked
+    }
+
+    void write_subframe(size_t variant, Span<const i32> samples, u8 bits_per_sample)
+    {
+        write_bits(0, 1);
+        switch (variant % 4) {
+        case 0: {
+            // Fixed predictor of order 2
+            write_bits(0b001010, 6);
+            write_bits(0, 1);
+            for (size_t i = 0; i < 2; ++i)
+                write_bits(samples[i], bits_per_sample);
+            Vector<i32> residual;
+            for (size_t i = 2; i < samples.size(); ++i)
+                residual.append(samples[i] - (2 * samples[i - 1] - samples[i - 2]));
+            write_residual(residual, 2);
+            break;
+        }
+        case 1:
+            // An LPC with a small order and precision, which is decoded four terms at a time
+            write_lpc(samples, bits_per_sample, { 1800, -900, 100, 20, -30, 10, 0, 5 }, 12, 10);
+            break;
+        case 2:
+            // An LPC that might overflow 32 bits
+            write_lpc(samples, bits_per_sample, { 16383, -8192, 50, -20, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, -1 }, 15, 13);
+            break;
+        case 3: {
+            // Verbatim samples, with a wasted bit if they're all even
+            bool has_wasted_bit = all_of(samples.begin(), samples.end(), [](auto sample) { return sample % 2 == 0; });
+            write_bits(0b000001, 6);
+            write_bits(has_wasted_bit, 1);
+            if (has_wasted_bit)
+                write_bits(1, 1);
+            for (auto sample : samples)
+                write_bits(sample >> has_wasted_bit, bits_per_sample - has_wasted_bit);
+            break;
+        }
+        }
+    }
+
+    void write_lpc(Span<const i32> samples, u8 bits_per_sample, Vector<i32> coefficients, u8 precision, u8 shift)
+    {
+        size_t order = coefficients.size();
+        write_bits(0b100000 | (order - 1), 6);
+        write_bits(0, 1);
+        for (size_t i = 0; i < order; ++i)
+            write_bits(samples[i], bits_per_sample);
+        write_bits(precision - 1, 4);
+        write_bits(shift, 5);
+        for (auto coefficient : coefficients)
+            write_bits(coefficient, precision);
+        Vector<i32> residual;
+        for (size_t i = order; i < samples.size(); ++i) {
+            i64 prediction = 0;
+            for (size_t t = 0; t < order; ++t)
+                prediction += static_cast<i64>(coefficients[t]) * samples[i - t - 1];
+            residual.append(samples[i] - static_cast<i32>(prediction >> shift));
+        }
+        write_residual(residual, order);
+    }
+
+    void write_residual(const Vector<i32>& residual, size_t order)
+    {
+        constexpr u8 partition_order = 2;
+        write_bits(0, 2); // Four bit Rice parameters
+        write_bits(partition_order, 4);
+        size_t partition_size = (residual.size() + order) >> partition_order;
+        size_t start = 0;
+        for (size_t partition = 0; partition < (1 << partition_order); ++partition) {
+            size_t end = (partition + 1) * partition_size - order;
+            u64 sum = 0;
+            for (size_t i = start; i < end; ++i)
+                sum += zigzag(residual[i]);
+            u8 k = 0;
+            while (k < 14 && (sum / (end - start)) >> (k + 1))
+                ++k;
+            write_bits(k, 4);
+            for (size_t i = start; i < end; ++i) {
+                u32 value = zigzag(residual[i]);
+                for (u32 q = value >> k; q > 0; --q)
+                    write_bits(0, 1);
+                write_bits(1, 1);
+                write_bits(value & ((1u << k) - 1), k);
+            }
+            start = end;
+        }
+    }
+
+    static u32 zigzag(i32 value) { return value < 0 ? (static_cast<u32>(-value) << 1) - 1 : static_cast<u32>(value) << 1; }
+
+    Vector<u8> m_bytes;
+    size_t m_bit_count { 0 };
+};
+
+static constexpr size_t test_sample_count = 64 * FlacWriter::block_size;
+
+static void generate_samples(Vector<i32>& left, Vector<i32>& right)
+{
+    u32 noise = 12345;
+    for (size_t i = 0; i < test_sample_count; ++i) {
+        noise = noise * 1103515245 + 12345;
+        // Some slopes that the predictors can follow, plus noise, and a few full-scale jumps.
+        i32 wave = static_cast<i32>((i * 37) % 20000) - 10000;
+        i32 jitter = static_cast<i32>((noise >> 16) % 2000) - 1000;
+        left.append(i % 10000 == 0 ? -32768 : clamp(wave + jitter, -32768, 32767));
+        right.append(i % 7777 == 0 ? 32767 : clamp(wave / 2 - jitter, -32768, 32767));
+    }
+}
+
+// Lets the verbatim subframes of independent channels use a wasted bit.
+static void make_even(Vector<i32>& samples)
+{
+    for (auto& sample : samples)
+        sample &= ~1;
+}
+
+static bool decode_matches(Audio::Loader& loader, const Vector<i32>& left, const Vector<i32>& right, size_t start)
+{
+    size_t index = start;
+    while (auto buffer = loader.get_more_samples()) {
+        for (int i = 0; i < buffer->sample_count(); ++i, ++index) {
+            auto& frame = buffer->samples()[i];
+            if (index >= left.size() || frame.left != left[index] / 65536.0 || frame.right != right[index] / 65536.0) {
+                warnln("Mismatch at sample {}", index);
+                return false;
+            }
+        }
+    }
+    return index == left.size();
+}
+
+TEST_CASE(decode)
+{
+    Vector<i32> left, right;
+    generate_samples(left, right);
+    make_even(left);
+    make_even(right);
+    auto loader = Audio::Loader::create(FlacWriter().encode(left, right, false));
+    EXPECT(!loader->has_error());
+    EXPECT_EQ(loader->total_samples(), static_cast<int>(test_sample_count));
+    EXPECT(decode_matches(loader, left, right, 0));
+}
+
+TEST_CASE(seek)
+{
+    Vector<i32> left, right;
+    generate_samples(left, right);
+    make_even(left);
+    make_even(right);
+
+    for (bool with_seek_table : { false, true }) {
+        auto loader = Audio::Loader::create(FlacWriter().encode(left, right, with_seek_table));
+        EXPECT(!loader->has_error());
+        for (size_t target : { 200000ul, 5ul, 4096ul, 150000ul, 160000ul }) {
+            loader->seek(target);
+            EXPECT_EQ(loader->loaded_samples(), static_cast<int>(target));
+            EXPECT(decode_matches(loader, left, right, target));
+        }
+        loader->reset();
+        EXPECT(decode_matches(loader, left, right, 0));
+    }
+}
+
+BENCHMARK_CASE(decode_speed)
+{
+    Vector<i32> left, right;
+    generate_samples(left, right);
+    make_even(left);
+    make_even(right);
+    auto encoded = FlacWriter().encode(left, right, true);
+    for (int i = 0; i < 10; ++i) {
+        auto loader = Audio::Loader::create(encoded);
+        size_t decoded = 0;
+        while (auto buffer = loader->get_more_samples())
+            decoded += buffer->sample_count();
+        EXPECT_EQ(decoded, test_sample_count);
+    }
+}
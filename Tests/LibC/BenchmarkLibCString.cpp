@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <string.h>
+
+// Each size class below exercises a different variant: the overlapping loads and stores for small
+// sizes, the vector loops for medium ones and rep movsb/stosb (with ERMS) for large ones.
+static constexpr size_t small_size = 24;
+static constexpr size_t medium_size = 1024;
+static constexpr size_t large_size = 1 * MiB;
+
+static constexpr size_t bytes_per_benchmark = 256 * MiB;
+
+template<typename Callback>
+static void run_for_size(size_t size, Callback callback)
+{
+    auto a = ByteBuffer::create_zeroed(size + 1);
+    auto b = ByteBuffer::create_zeroed(size + 1);
+    // Start off unaligned, as most buffers passed to the string functions aren't.
+    for (size_t i = 0; i < bytes_per_benchmark / size; ++i)
+        callback(a.data() + 1, b.data() + 1, size);
+}
+
+BENCHMARK_CASE(memcpy_small)
+{
+    run_for_size(small_size, [](u8* a, u8* b, size_t size) { memcpy(a, b, size); });
+}
+
+BENCHMARK_CASE(memcpy_medium)
+{
+    run_for_size(medium_size, [](u8* a, u8* b, size_t size) { memcpy(a, b, size); });
+}
+
+BENCHMARK_CASE(memcpy_large)
+{
+    run_for_size(large_size, [](u8* a, u8* b, size_t size) { memcpy(a, b, size); });
+}
+
+BENCHMARK_CASE(memset_small)
+{
+    run_for_size(small_size, [](u8* a, u8*, size_t size) { memset(a, 0x42, size); });
+}
+
+BENCHMARK_CASE(memset_medium)
+{
+    run_for_size(medium_size, [](u8* a, u8*, size_t size) { memset(a, 0x42, size); });
+}
+
+BENCHMARK_CASE(memset_large)
+{
+    run_for_size(large_size, [](u8* a, u8*, size_t size) { memset(a, 0x42, size); });
+}
+
+BENCHMARK_CASE(memcmp_small)
+{
+    run_for_size(small_size, [](u8* a, u8* b, size_t size) { EXPECT_EQ(memcmp(a, b, size), 0); });
+}
+
+BENCHMARK_CASE(memcmp_medium)
+{
+    run_for_size(medium_size, [](u8* a, u8* b, size_t size) { EXPECT_EQ(memcmp(a, b, size), 0); });
+}
+
+BENCHMARK_CASE(memcmp_large)
+{
+    run_for_size(large_size, [](u8* a, u8* b, size_t size) { EXPECT_EQ(memcmp(a, b, size), 0); });
+}
+
+static void benchmark_strlen(size_t length)
+{
+    auto string = ByteBuffer::create_uninitialized(length + 2);
+    __builtin_memset(string.data(), 'x', length + 1);
+    string[length + 1] = '\0';
+    for (size_t i = 0; i < bytes_per_benchmark / length; ++i)
+        EXPECT_EQ(strlen((const char*)string.data() + 1), length);
+}
+
+BENCHMARK_CASE(strlen_small)
+{
+    benchmark_strlen(small_size);
+}
+
+BENCHMARK_CASE(strlen_medium)
+{
+    benchmark_strlen(medium_size);
+}
+
+BENCHMARK_CASE(strlen_large)
+{
+    benchmark_strlen(large_size);
+}
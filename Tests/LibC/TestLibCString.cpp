@@ -16,3 +16,73 @@ TEST_CASE(strerror_r_basic)
     EXPECT_EQ(strerror_r(EFAULT, buf, sizeof(buf)), 0);
     EXPECT_EQ(strcmp(buf, "Bad address"), 0);
 }
+
+// The string functions pick different code paths depending on the size and alignment,
+// so every combination up to a few vectors long is checked against a plain loop.
+static constexpr size_t max_tested_size = 300;
+static constexpr size_t max_tested_offset = 32;
+
+TEST_CASE(memcpy_sizes_and_alignments)
+{
+    u8 source[max_tested_size + max_tested_offset];
+    for (size_t i = 0; i < sizeof(source); ++i)
+        source[i] = i * 7 + 1;
+
+    for (size_t offset = 0; offset < max_tested_offset; offset += 3) {
+        for (size_t size = 0; size <= max_tested_size; ++size) {
+            u8 destination[max_tested_size + 2 * max_tested_offset];
+            __builtin_memset(destination, 0xee, sizeof(destination));
+            memcpy(destination + max_tested_offset - offset, source + offset, size);
+            for (size_t i = 0; i < sizeof(destination); ++i) {
+                bool is_copied = i >= max_tested_offset - offset && i < max_tested_offset - offset + size;
+                EXPECT_EQ(destination[i], is_copied ? source[i - max_tested_offset + 2 * offset] : 0xee);
+            }
+        }
+    }
+}
+
+TEST_CASE(memset_sizes_and_alignments)
+{
+    for (size_t offset = 0; offset < max_tested_offset; ++offset) {
+        for (size_t size = 0; size <= max_tested_size; ++size) {
+            u8 buffer[max_tested_size + 2 * max_tested_offset];
+            __builtin_memset(buffer, 0xee, sizeof(buffer));
+            memset(buffer + offset, 0x42, size);
+            for (size_t i = 0; i < sizeof(buffer); ++i)
+                EXPECT_EQ(buffer[i], i >= offset && i < offset + size ? 0x42 : 0xee);
+        }
+    }
+}
+
+TEST_CASE(memcmp_sizes_and_differences)
+{
+    u8 a[max_tested_size];
+    u8 b[max_tested_size];
+    for (size_t i = 0; i < max_tested_size; ++i)
+        a[i] = b[i] = i % 251;
+
+    for (size_t size = 0; size <= max_tested_size; ++size) {
+        EXPECT_EQ(memcmp(a, b, size), 0);
+        for (size_t difference = 0; difference < size; ++difference) {
+            b[difference] = a[difference] + 1;
+            EXPECT(memcmp(a, b, size) < 0);
+            EXPECT(memcmp(b, a, size) > 0);
+            b[difference] = 0xff;
+            a[difference] = 0x01;
+            EXPECT(memcmp(a, b, size) < 0);
+            a[difference] = b[difference] = difference % 251;
+        }
+    }
+}
+
+TEST_CASE(strlen_sizes_and_alignments)
+{
+    char buffer[max_tested_size + max_tested_offset + 1];
+    for (size_t offset = 0; offset < max_tested_offset; ++offset) {
+        for (size_t length = 0; length <= max_tested_size; ++length) {
+            __builtin_memset(buffer, 'x', sizeof(buffer));
+            buffer[offset + length] = '\0';
+            EXPECT_EQ(strlen(buffer + offset), length);
+        }
+    }
+}
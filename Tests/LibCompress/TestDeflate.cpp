@@ -154,3 +154,103 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(compressed.has_value());
 }
+
+static ByteBuffer decompress_through_stream(ReadonlyBytes compressed)
+{
+    InputMemoryStream memory_stream { compressed };
+    Compress::DeflateDecompressor deflate_stream { memory_stream };
+    DuplexMemoryStream output_stream;
+
+    u8 buffer[4096];
+    while (!deflate_stream.has_any_error() && !deflate_stream.unreliable_eof()) {
+        auto nread = deflate_stream.read({ buffer, sizeof(buffer) });
+        output_stream.write_or_error({ buffer, nread });
+    }
+    EXPECT(!deflate_stream.handle_any_error());
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+TEST_CASE(deflate_decompress_long_codes_and_short_distances)
+{
+    // Symbols of very different frequencies get codes longer than fit in the first lookup table,
+    // and the repeated short patterns give back references overlapping what they copy.
+    auto original = ByteBuffer::create_uninitialized(64 * KiB);
+    u32 state = 1;
+    for (size_t i = 0; i < original.size();) {
+        state = state * 1103515245 + 12345;
+        auto pattern_length = 1 + (state >> 16) % 7;
+        auto repeats = 1 + (state >> 24) % 12;
+        for (size_t repeat = 0; repeat < repeats; ++repeat) {
+            for (size_t j = 0; j < pattern_length && i < original.size(); ++j, ++i)
+                original[i] = (u8)__builtin_ctz((state >> j) | 0x10000) * 17 + j;
+        }
+    }
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GOOD);
+    EXPECT(compressed.has_value());
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+    EXPECT(decompress_through_stream(compressed.value()) == original);
+}
+
+TEST_CASE(deflate_decompress_truncated)
+{
+    auto original = ByteBuffer::create_zeroed(4096);
+    fill_with_random(original.data(), 2048);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+
+    for (size_t size : { (size_t)0, (size_t)1, compressed->size() / 2, compressed->size() - 1 })
+        EXPECT(!Compress::DeflateDecompressor::decompress_all(compressed->bytes().trim(size)).has_value());
+}
+
+static ByteBuffer repeated_random_pattern(size_t size, size_t pattern_size)
+{
+    auto pattern = ByteBuffer::create_uninitialized(pattern_size);
+    fill_with_random(pattern.data(), pattern_size);
+    auto buffer = ByteBuffer::create_uninitialized(size);
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = pattern[i % pattern_size];
+    return buffer;
+}
+
+TEST_CASE(deflate_compress_back_references_across_blocks)
+{
+    // The pattern repeats further apart than fits in a block, so only matches reaching back into the previous block find it.
+    auto original = repeated_random_pattern(Compress::DeflateCompressor::block_size * 4, 20000);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed->size() < original.size() / 4);
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+    EXPECT(decompress_through_stream(compressed.value()) == original);
+}
+
+TEST_CASE(deflate_compress_in_parallel)
+{
+    auto original = repeated_random_pattern(300 * KiB, 20000);
+    auto compressed = Compress::DeflateCompressor::compress_all_in_parallel(original, 3, Compress::DeflateCompressor::CompressionLevel::FAST, 50 * KiB);
+    EXPECT(compressed.has_value());
+    // Every chunk starts with the end of the one before as its dictionary, so the pattern only has to be stored once.
+    EXPECT(compressed->size() < 2 * 20000);
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+    EXPECT(decompress_through_stream(compressed.value()) == original);
+}
+
+TEST_CASE(deflate_compress_in_parallel_store)
+{
+    auto original = ByteBuffer::create_uninitialized(100 * KiB);
+    fill_with_random(original.data(), original.size());
+    auto compressed = Compress::DeflateCompressor::compress_all_in_parallel(original, 4, Compress::DeflateCompressor::CompressionLevel::STORE, 10 * KiB);
+    EXPECT(compressed.has_value());
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
@@ -95,3 +95,14 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_round_trip_in_parallel)
+{
+    auto original = ByteBuffer::create_zeroed(3 * MiB);
+    fill_with_random(original.data(), 1 * MiB);
+    auto compressed = Compress::GzipCompressor::compress_all(original, 4);
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibCompress/Lz4.h>
+
+static constexpr StringView hello_lz4 = "Hello LZ4! Hello LZ4! Hello LZ4! Hello LZ4! Hello!\n";
+
+TEST_CASE(lz4_decompress_frame)
+{
+    Array<u8, 40> const compressed {
+        0x04, 0x22, 0x4d, 0x18, 0x64, 0x40, 0xa7, 0x15, 0x00, 0x00, 0x00, 0xbf,
+        0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x4c, 0x5a, 0x34, 0x21, 0x20, 0x0b,
+        0x00, 0x10, 0x50, 0x6c, 0x6c, 0x6f, 0x21, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x8e, 0x57, 0xe7, 0x73
+    };
+
+    EXPECT(Compress::Lz4Decompressor::is_likely_compressed(compressed));
+    auto decompressed = Compress::Lz4Decompressor::decompress_all(compressed);
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value().bytes() == hello_lz4.bytes());
+}
+
+TEST_CASE(lz4_decompress_block_checksums_and_skippable_frame)
+{
+    Array<u8, 52> const compressed {
+        0x50, 0x2a, 0x4d, 0x18, 0x04, 0x00, 0x00, 0x00, 0xde, 0xad, 0xbe, 0xef,
+        0x04, 0x22, 0x4d, 0x18, 0x70, 0x40, 0xad, 0x15, 0x00, 0x00, 0x00, 0xbf,
+        0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x4c, 0x5a, 0x34, 0x21, 0x20, 0x0b,
+        0x00, 0x10, 0x50, 0x6c, 0x6c, 0x6f, 0x21, 0x0a, 0xde, 0xc7, 0x39, 0x0f,
+        0x00, 0x00, 0x00, 0x00
+    };
+
+    auto decompressed = Compress::Lz4Decompressor::decompress_all(compressed);
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value().bytes() == hello_lz4.bytes());
+}
+
+TEST_CASE(lz4_decompress_corrupted)
+{
+    Array<u8, 40> compressed {
+        0x04, 0x22, 0x4d, 0x18, 0x64, 0x40, 0xa7, 0x15, 0x00, 0x00, 0x00, 0xbf,
+        0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x4c, 0x5a, 0x34, 0x21, 0x20, 0x0b,
+        0x00, 0x10, 0x50, 0x6c, 0x6c, 0x6f, 0x21, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x8e, 0x57, 0xe7, 0x73
+    };
+
+    for (size_t size : { (size_t)1, (size_t)6, (size_t)20, compressed.size() - 1 })
+        EXPECT(!Compress::Lz4Decompressor::decompress_all(ReadonlyBytes { compressed }.trim(size)).has_value());
+
+    compressed[24] = 0x40; // a back reference further back than the start of the block
+    EXPECT(!Compress::Lz4Decompressor::decompress_all(compressed).has_value());
+}
+
+TEST_CASE(lz4_round_trip)
+{
+    auto original = ByteBuffer::create_zeroed(200 * KiB);
+    fill_with_random(original.data(), 50 * KiB);
+    for (size_t i = 100 * KiB; i < original.size(); ++i)
+        original[i] = original[i % 777];
+
+    auto compressed = Compress::Lz4Compressor::compress_all(original);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed->size() < original.size() / 2);
+    auto decompressed = Compress::Lz4Decompressor::decompress_all(compressed.value());
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value() == original);
+}
+
+TEST_CASE(lz4_round_trip_small)
+{
+    for (size_t size = 0; size < 20; ++size) {
+        auto original = ByteBuffer::create_uninitialized(size);
+        fill_with_random(original.data(), size);
+        auto compressed = Compress::Lz4Compressor::compress_all(original);
+        EXPECT(compressed.has_value());
+        auto decompressed = Compress::Lz4Decompressor::decompress_all(compressed.value());
+        EXPECT(decompressed.has_value());
+        EXPECT(decompressed.value() == original);
+    }
+}
+
+TEST_CASE(lz4_stream_in_pieces)
+{
+    auto original = ByteBuffer::create_uninitialized(150 * KiB);
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "abcdefgh"[(i * i) % 7];
+
+    DuplexMemoryStream compressed_stream;
+    Compress::Lz4Compressor compressor { compressed_stream };
+    for (size_t offset = 0; offset < original.size(); offset += 1000)
+        EXPECT(compressor.write_or_error(original.bytes().slice(offset, min<size_t>(1000, original.size() - offset))));
+    compressor.final_flush();
+    auto compressed = compressed_stream.copy_into_contiguous_buffer();
+
+    InputMemoryStream input_stream { compressed };
+    Compress::Lz4Decompressor decompressor { input_stream };
+    auto decompressed = ByteBuffer::create_uninitialized(original.size());
+    for (size_t offset = 0; offset < decompressed.size(); offset += 333)
+        EXPECT(decompressor.read_or_error(decompressed.bytes().slice(offset, min<size_t>(333, decompressed.size() - offset))));
+    EXPECT(decompressed == original);
+    u8 byte;
+    EXPECT_EQ(decompressor.read({ &byte, 1 }), 0u);
+    EXPECT(decompressor.unreliable_eof());
+    EXPECT(!decompressor.handle_any_error());
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibCompress/Zstd.h>
+
+static constexpr StringView hello_zstd = "Hello Zstd! Hello Zstd! Hello Zstd! Hello Zstd! Hello!\n";
+
+TEST_CASE(zstd_decompress_frame)
+{
+    Array<u8, 33> const compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x37, 0xa5, 0x00, 0x00, 0x70, 0x48, 0x65,
+        0x6c, 0x6c, 0x6f, 0x20, 0x5a, 0x73, 0x74, 0x64, 0x21, 0x20, 0x21, 0x0a,
+        0x01, 0x00, 0x0e, 0x95, 0x24, 0xd8, 0x14, 0x10, 0x48
+    };
+
+    EXPECT(Compress::ZstdDecompressor::is_likely_compressed(compressed));
+    auto decompressed = Compress::ZstdDecompressor::decompress_all(compressed);
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value().bytes() == hello_zstd.bytes());
+}
+
+TEST_CASE(zstd_decompress_huffman_literals)
+{
+    // Literals with a Huffman code whose weights are entropy coded themselves, the content checksum covers the rest.
+    Array<u8, 213> const compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x64, 0x5d, 0x01, 0x3d, 0x06, 0x00, 0x82, 0x04,
+        0x0f, 0x11, 0xa0, 0x6f, 0x60, 0x43, 0x1c, 0x59, 0xed, 0xf5, 0xb7, 0xfa,
+        0x06, 0x00, 0x80, 0x41, 0x15, 0x8c, 0x07, 0x40, 0x0d, 0x24, 0xdf, 0x89,
+        0xa4, 0x85, 0xef, 0xe9, 0xfd, 0xce, 0xfa, 0xfb, 0x70, 0xf5, 0x62, 0x6f,
+        0x58, 0xdc, 0xcc, 0xa1, 0x71, 0xe2, 0x98, 0x4c, 0xac, 0x06, 0x92, 0x0f,
+        0x92, 0x77, 0xca, 0x1f, 0xda, 0xb9, 0xc0, 0xad, 0x4f, 0xe4, 0x46, 0xfd,
+        0x45, 0x54, 0xa8, 0x81, 0x07, 0x6d, 0x4a, 0xed, 0x1b, 0x20, 0x02, 0x82,
+        0x94, 0xc3, 0x1d, 0x30, 0x02, 0x33, 0x94, 0xa4, 0xe9, 0x43, 0x9c, 0x23,
+        0x96, 0x44, 0x16, 0x34, 0xc2, 0x1d, 0x42, 0xba, 0xe4, 0xd0, 0x55, 0xd8,
+        0xf1, 0xba, 0x03, 0x7d, 0x86, 0xbb, 0xe4, 0xc3, 0x56, 0xb4, 0x17, 0x71,
+        0x3e, 0xf1, 0x48, 0x5b, 0xcc, 0x61, 0xbb, 0x98, 0x40, 0xb4, 0x04, 0xb2,
+        0xff, 0xc6, 0x03, 0x96, 0x26, 0x17, 0x9c, 0x46, 0x9b, 0xa4, 0xe6, 0x2f,
+        0x54, 0xb7, 0xc1, 0x1c, 0x59, 0xad, 0x0c, 0xc8, 0x85, 0xe8, 0xd6, 0x83,
+        0xa5, 0xe0, 0x20, 0xb4, 0x29, 0x67, 0x17, 0x36, 0x76, 0x41, 0x82, 0x15,
+        0x77, 0xa3, 0x75, 0x7c, 0x58, 0xfc, 0x23, 0xda, 0xab, 0xf8, 0xb0, 0x78,
+        0x0d, 0x84, 0xfb, 0xeb, 0x16, 0xb7, 0x80, 0xbf, 0x0b, 0xca, 0xd6, 0x1e,
+        0xe6, 0xae, 0x00, 0x9e, 0x88, 0x6e, 0xf8, 0x79, 0xfb, 0xf8, 0x89, 0xd3,
+        0x0d, 0x75, 0x18, 0xaf, 0x02, 0x2d, 0xf8, 0x0a, 0xfd
+    };
+
+    auto decompressed = Compress::ZstdDecompressor::decompress_all(compressed);
+    EXPECT(decompressed.has_value());
+    EXPECT_EQ(decompressed->size(), 605u);
+    EXPECT(StringView { decompressed->bytes() }.starts_with("brown then appear words words quick jump"));
+}
+
+TEST_CASE(zstd_decompress_skippable_and_several_frames)
+{
+    Array<u8, 12> const skippable { 0x5a, 0x2a, 0x4d, 0x18, 0x04, 0x00, 0x00, 0x00, 0xde, 0xad, 0xbe, 0xef };
+    Array<u8, 33> const frame {
+        0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x37, 0xa5, 0x00, 0x00, 0x70, 0x48, 0x65,
+        0x6c, 0x6c, 0x6f, 0x20, 0x5a, 0x73, 0x74, 0x64, 0x21, 0x20, 0x21, 0x0a,
+        0x01, 0x00, 0x0e, 0x95, 0x24, 0xd8, 0x14, 0x10, 0x48
+    };
+    ByteBuffer compressed;
+    compressed.append(skippable.data(), skippable.size());
+    compressed.append(frame.data(), frame.size());
+    compressed.append(frame.data(), frame.size());
+
+    auto decompressed = Compress::ZstdDecompressor::decompress_all(compressed);
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value() == String::formatted("{}{}", hello_zstd, hello_zstd).bytes());
+}
+
+TEST_CASE(zstd_decompress_corrupted)
+{
+    Array<u8, 33> compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x37, 0xa5, 0x00, 0x00, 0x70, 0x48, 0x65,
+        0x6c, 0x6c, 0x6f, 0x20, 0x5a, 0x73, 0x74, 0x64, 0x21, 0x20, 0x21, 0x0a,
+        0x01, 0x00, 0x0e, 0x95, 0x24, 0xd8, 0x14, 0x10, 0x48
+    };
+
+    for (size_t size : { (size_t)1, (size_t)5, (size_t)20, compressed.size() - 1 })
+        EXPECT(!Compress::ZstdDecompressor::decompress_all(ReadonlyBytes { compressed }.trim(size)).has_value());
+
+    compressed[15] = 'X'; // the content checksum no longer matches
+    EXPECT(!Compress::ZstdDecompressor::decompress_all(compressed).has_value());
+}
+
+TEST_CASE(zstd_round_trip)
+{
+    auto original = ByteBuffer::create_zeroed(400 * KiB);
+    fill_with_random(original.data(), 50 * KiB);
+    for (size_t i = 100 * KiB; i < 300 * KiB; ++i)
+        original[i] = original[i % 777];
+    for (size_t i = 300 * KiB; i < original.size(); ++i)
+        original[i] = "Zstandard"[(i * i) % 9];
+
+    auto compressed = Compress::ZstdCompressor::compress_all(original);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed->size() < original.size() / 2);
+    auto decompressed = Compress::ZstdDecompressor::decompress_all(compressed.value());
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value() == original);
+}
+
+TEST_CASE(zstd_round_trip_small)
+{
+    for (size_t size = 0; size < 20; ++size) {
+        auto original = ByteBuffer::create_uninitialized(size);
+        fill_with_random(original.data(), size);
+        auto compressed = Compress::ZstdCompressor::compress_all(original);
+        EXPECT(compressed.has_value());
+        auto decompressed = Compress::ZstdDecompressor::decompress_all(compressed.value());
+        EXPECT(decompressed.has_value());
+        EXPECT(decompressed.value() == original);
+    }
+}
+
+TEST_CASE(zstd_stream_in_pieces)
+{
+    auto original = ByteBuffer::create_uninitialized(300 * KiB);
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "abcdefgh"[(i * i) % 7];
+
+    DuplexMemoryStream compressed_stream;
+    Compress::ZstdCompressor compressor { compressed_stream };
+    for (size_t offset = 0; offset < original.size(); offset += 1000)
+        EXPECT(compressor.write_or_error(original.bytes().slice(offset, min<size_t>(1000, original.size() - offset))));
+    compressor.final_flush();
+    auto compressed = compressed_stream.copy_into_contiguous_buffer();
+
+    InputMemoryStream input_stream { compressed };
+    Compress::ZstdDecompressor decompressor { input_stream };
+    auto decompressed = ByteBuffer::create_uninitialized(original.size());
+    for (size_t offset = 0; offset < decompressed.size(); offset += 333)
+        EXPECT(decompressor.read_or_error(decompressed.bytes().slice(offset, min<size_t>(333, decompressed.size() - offset))));
+    EXPECT(decompressed == original);
+    u8 byte;
+    EXPECT_EQ(decompressor.read({ &byte, 1 }), 0u);
+    EXPECT(decompressor.unreliable_eof());
+    EXPECT(!decompressor.handle_any_error());
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibCore/SharedRingBuffer.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+// The reader gets its own mapping of the same memory, as it would in another process.
+static Core::SharedRingBuffer attach_reader(const Core::SharedRingBuffer& writer)
+{
+    auto& buffer = writer.anonymous_buffer();
+    auto reader = Core::SharedRingBuffer::attach(Core::AnonymousBuffer::create_from_anon_fd(dup(buffer.fd()), buffer.size()));
+    VERIFY(reader.has_value());
+    return reader.release_value();
+}
+
+static ByteBuffer read_all(Core::SharedRingBuffer& reader)
+{
+    ByteBuffer result;
+    for (auto bytes = reader.peek(); !bytes.is_empty(); bytes = reader.peek()) {
+        result.append(bytes);
+        reader.consume(bytes.size());
+    }
+    return result;
+}
+
+TEST_CASE(write_and_read_around_the_end)
+{
+    auto writer = Core::SharedRingBuffer::create(16).release_value();
+    auto reader = attach_reader(writer);
+    EXPECT_EQ(reader.capacity(), 16u);
+    EXPECT(reader.peek().is_empty());
+
+    EXPECT_EQ(writer.write("0123456789"sv.bytes()), 10u);
+    EXPECT(read_all(reader).bytes() == "0123456789"sv.bytes());
+
+    // Only 16 bytes fit, and they wrap around the end of the buffer.
+    EXPECT_EQ(writer.write("abcdefghijklmnopqrstuvwxyz"sv.bytes()), 16u);
+    EXPECT_EQ(writer.write("q"sv.bytes()), 0u);
+    auto first_part = reader.peek();
+    EXPECT(first_part == "abcdef"sv.bytes());
+    reader.consume(3);
+    EXPECT_EQ(writer.write("qrs"sv.bytes()), 3u);
+    EXPECT(read_all(reader).bytes() == "defghijklmnopqrs"sv.bytes());
+}
+
+TEST_CASE(reader_only_needs_waking_when_asleep)
+{
+    auto writer = Core::SharedRingBuffer::create(64).release_value();
+    auto reader = attach_reader(writer);
+
+    // The reader hasn't looked at anything yet.
+    writer.write("a"sv.bytes());
+    EXPECT(writer.should_wake_reader());
+    writer.write("b"sv.bytes());
+    EXPECT(!writer.should_wake_reader());
+
+    // There's still data, so there's no sleeping yet.
+    EXPECT(!reader.prepare_to_sleep());
+    EXPECT(read_all(reader).bytes() == "ab"sv.bytes());
+    EXPECT(reader.prepare_to_sleep());
+
+    writer.write("c"sv.bytes());
+    EXPECT(writer.should_wake_reader());
+    EXPECT(!writer.should_wake_reader());
+}
+
+TEST_CASE(writer_only_needs_waking_when_waiting)
+{
+    auto writer = Core::SharedRingBuffer::create(16).release_value();
+    auto reader = attach_reader(writer);
+
+    // There's still room, so there's no waiting yet.
+    EXPECT_EQ(writer.write("0123456789"sv.bytes()), 10u);
+    EXPECT_EQ(writer.size(), 10u);
+    EXPECT(!writer.prepare_to_wait_for_room());
+    reader.consume(2);
+    EXPECT(!reader.should_wake_writer());
+
+    EXPECT_EQ(writer.write("abcdefghij"sv.bytes()), 8u);
+    EXPECT(writer.prepare_to_wait_for_room());
+    reader.consume(4);
+    EXPECT(reader.should_wake_writer());
+    EXPECT(!reader.should_wake_writer());
+    EXPECT_EQ(reader.size(), 12u);
+}
+
+TEST_CASE(misbehaving_peer)
+{
+    auto writer = Core::SharedRingBuffer::create(16).release_value();
+
+    // A buffer whose capacity isn't a power of two didn't come from create().
+    auto odd_buffer = Core::AnonymousBuffer::create_with_size(writer.anonymous_buffer().size() + 1);
+    EXPECT(!Core::SharedRingBuffer::attach(odd_buffer).has_value());
+
+    // A reader claiming to have read more than was written mustn't make the writer overrun the buffer.
+    auto reader = attach_reader(writer);
+    writer.write("abc"sv.bytes());
+    reader.consume(3);
+    auto buffer = writer.anonymous_buffer();
+    // The read offset lives at the start of the header's second cache line.
+    buffer.data<u32>()[64 / sizeof(u32)] += 100;
+    EXPECT_EQ(writer.write("abc"sv.bytes()), 0u);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(timers_fire_in_order)
+{
+    Core::EventLoop loop;
+    Vector<int> fired;
+    NonnullRefPtrVector<Core::Timer> timers;
+    for (int interval : { 30, 10, 50, 20, 40 })
+        timers.append(Core::Timer::create_single_shot(interval, [&, interval] { fired.append(interval); }));
+    for (auto& timer : timers)
+        timer.start();
+
+    // This one is stopped before it fires, so it must not show up in the queue anymore.
+    auto stopped_timer = Core::Timer::create_single_shot(15, [&] { fired.append(15); });
+    stopped_timer->start();
+    stopped_timer->stop();
+
+    auto quit_timer = Core::Timer::create_single_shot(80, [&] { loop.quit(0); });
+    quit_timer->start();
+    loop.exec();
+
+    EXPECT_EQ(fired, (Vector<int> { 10, 20, 30, 40, 50 }));
+}
+
+TEST_CASE(many_timers)
+{
+    Core::EventLoop loop;
+    constexpr size_t timer_count = 2000;
+    size_t fire_count = 0;
+    NonnullRefPtrVector<Core::Timer> timers;
+    for (size_t i = 0; i < timer_count; ++i) {
+        auto timer = Core::Timer::create_single_shot(1 + i % 37, [&] { ++fire_count; });
+        timer->start();
+        timers.append(move(timer));
+    }
+    // Stop every third timer, which takes them out of the middle of the queue.
+    for (size_t i = 0; i < timer_count; i += 3)
+        timers[i].stop();
+
+    auto quit_timer = Core::Timer::create_single_shot(100, [&] { loop.quit(0); });
+    quit_timer->start();
+    loop.exec();
+
+    EXPECT_EQ(fire_count, timer_count - (timer_count + 2) / 3);
+}
+
+TEST_CASE(repeating_timer_with_zero_interval)
+{
+    Core::EventLoop loop;
+    size_t fire_count = 0;
+    auto timer = Core::Timer::create_repeating(0, [&] {
+        if (++fire_count == 100)
+            loop.quit(0);
+    });
+    timer->start();
+    loop.exec();
+    EXPECT_EQ(fire_count, 100u);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Vector.h>
+#include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/NumberTheory/ModularFunctions.h>
+
+// These cover the sizes that RSA in LibTLS works with. Run them with `BenchmarkBigInteger --bench` before and after a
+// change to the arithmetic to compare the two.
+
+// The numbers are the same on every run, but have no structure the arithmetic could take advantage of.
+static Crypto::UnsignedBigInteger number_with_bits(size_t bits, u32 seed)
+{
+    Vector<u32, Crypto::STARTING_WORD_SIZE> words;
+    u32 state = seed;
+    for (size_t i = 0; i < bits / 32; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        words.append(state);
+    }
+    words.last() |= 0x80000000;
+    return Crypto::UnsignedBigInteger { move(words) };
+}
+
+static Crypto::UnsignedBigInteger odd_number_with_bits(size_t bits, u32 seed)
+{
+    auto number = number_with_bits(bits, seed);
+    number.set_bit_inplace(0);
+    return number;
+}
+
+BENCHMARK_CASE(multiply_2048_bits)
+{
+    auto left = number_with_bits(2048, 1);
+    auto right = number_with_bits(2048, 2);
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT_EQ(left.multiplied_by(right).trimmed_length(), 128u);
+}
+
+BENCHMARK_CASE(multiply_16384_bits)
+{
+    auto left = number_with_bits(16384, 3);
+    auto right = number_with_bits(16384, 4);
+    for (size_t i = 0; i < 20; ++i)
+        EXPECT_EQ(left.multiplied_by(right).trimmed_length(), 1024u);
+}
+
+BENCHMARK_CASE(divide_4096_by_2048_bits)
+{
+    auto numerator = number_with_bits(4096, 5);
+    auto denominator = number_with_bits(2048, 6);
+    for (size_t i = 0; i < 20; ++i)
+        EXPECT(numerator.divided_by(denominator).remainder < denominator);
+}
+
+BENCHMARK_CASE(modular_power_2048_bits_public_exponent)
+{
+    auto base = number_with_bits(2048, 7);
+    auto modulus = odd_number_with_bits(2048, 8);
+    Crypto::UnsignedBigInteger exponent { 65537 };
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(Crypto::NumberTheory::ModularPower(base, exponent, modulus) < modulus);
+}
+
+BENCHMARK_CASE(modular_power_2048_bits_private_exponent)
+{
+    auto base = number_with_bits(2048, 9);
+    auto modulus = odd_number_with_bits(2048, 10);
+    auto exponent = number_with_bits(2048, 11);
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT(Crypto::NumberTheory::ModularPower(base, exponent, modulus) < modulus);
+}
+
+BENCHMARK_CASE(modular_power_1024_bits_even_modulus)
+{
+    auto base = number_with_bits(1024, 12);
+    auto modulus = number_with_bits(1024, 13);
+    modulus.set_to(modulus.shift_left(1));
+    auto exponent = number_with_bits(256, 14);
+    EXPECT(Crypto::NumberTheory::ModularPower(base, exponent, modulus) < modulus);
+}
@@ -454,3 +454,43 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+TEST_CASE(test_AES_GCM_256bit_roundtrip_many_blocks)
+{
+    // Long enough to be encrypted and hashed in several chunks, and to end in a partial block.
+    auto plaintext = ByteBuffer::create_uninitialized(3000);
+    for (size_t i = 0; i < plaintext.size(); ++i)
+        plaintext[i] = i * 7;
+    auto key = "\x60\x3d\xeb\x10\x15\xca\x71\xbe\x2b\x73\xae\xf0\x85\x7d\x77\x81\x1f\x35\x2c\x07\x3b\x61\x08\xd7\x2d\x98\x10\xa3\x09\x14\xdf\xf4"_b;
+    auto iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b;
+    auto aad = "\xde\xad\xbe\xef\xfa\xaf\x11\xcc\xde\xad\xbe\xef\xfa\xaf\x11\xcc\x01"_b;
+
+    Crypto::Cipher::AESCipher::GCMMode cipher(key, 256, Crypto::Cipher::Intent::Encryption);
+    auto ciphertext = ByteBuffer::create_uninitialized(plaintext.size());
+    u8 tag[16];
+    cipher.encrypt(plaintext, ciphertext.bytes(), iv, aad, { tag, 16 });
+
+    // The tag must be the same as hashing the whole ciphertext at once.
+    Crypto::Cipher::AESCipher block_cipher(key, 256);
+    Crypto::Cipher::AESCipherBlock block0;
+    auto counter = iv;
+    counter[15] = 1;
+    block0.overwrite(counter);
+    block_cipher.encrypt_block(block0, block0);
+    u8 zeros[16] {};
+    Crypto::Cipher::AESCipherBlock hash_key_block(zeros, 16);
+    block_cipher.encrypt_block(hash_key_block, hash_key_block);
+    Crypto::Authentication::GHash ghash(hash_key_block.bytes());
+    auto expected_tag = ghash.process(aad, ciphertext);
+    block0.apply_initialization_vector({ expected_tag.data, 16 });
+    EXPECT(memcmp(tag, block0.bytes().data(), 16) == 0);
+
+    auto decrypted = ByteBuffer::create_uninitialized(ciphertext.size());
+    auto consistency = cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, { tag, 16 });
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT(decrypted == plaintext);
+
+    tag[15] ^= 1;
+    consistency = cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, { tag, 16 });
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Inconsistent);
+}
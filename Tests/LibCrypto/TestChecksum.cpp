@@ -6,6 +6,7 @@
 
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/XxHash.h>
 #include <LibTest/TestCase.h>
 
 TEST_CASE(test_adler32)
@@ -33,3 +34,70 @@ TEST_CASE(test_crc32)
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+// Long enough for the vectorized paths, fed whole and in uneven pieces that leave scalar tails.
+template<typename Checksum>
+static void test_long_inputs(u32 expected_for_pattern, u32 expected_for_ones)
+{
+    auto do_test = [](ReadonlyBytes input, u32 expected_result) {
+        EXPECT_EQ(Checksum(input).digest(), expected_result);
+
+        Checksum checksum;
+        for (size_t offset = 0, step = 1; offset < input.size(); offset += step, step = step * 3 + 1)
+            checksum.update(input.slice(offset, min(step, input.size() - offset)));
+        EXPECT_EQ(checksum.digest(), expected_result);
+    };
+
+    auto pattern = ByteBuffer::create_uninitialized(100000);
+    for (size_t i = 0; i < pattern.size(); ++i)
+        pattern[i] = i * 7 + 3;
+    do_test(pattern, expected_for_pattern);
+
+    // All 0xff bytes are the worst case for the deferred modular reductions.
+    auto ones = ByteBuffer::create_uninitialized(100000);
+    ones.bytes().fill(0xff);
+    do_test(ones, expected_for_ones);
+}
+
+TEST_CASE(test_adler32_long)
+{
+    test_long_inputs<Crypto::Checksum::Adler32>(0x2dfb940f, 0x149a302c);
+}
+
+TEST_CASE(test_crc32_long)
+{
+    test_long_inputs<Crypto::Checksum::CRC32>(0xf730caa8, 0x68c6cec4);
+}
+
+TEST_CASE(test_xxhash32)
+{
+    auto do_test = [](ReadonlyBytes input, u32 expected_result) {
+        EXPECT_EQ(Crypto::Checksum::XxHash32(input).digest(), expected_result);
+
+        // The same, fed in pieces that do not line up with the stripes.
+        Crypto::Checksum::XxHash32 hash;
+        for (size_t offset = 0; offset < input.size(); offset += 7)
+            hash.update(input.slice(offset, min<size_t>(7, input.size() - offset)));
+        EXPECT_EQ(hash.digest(), expected_result);
+    };
+
+    do_test(String("").bytes(), 0x02CC5D05);
+    do_test(String("abc").bytes(), 0x32D153FF);
+    do_test(String("Nobody inspects the spammish repetition").bytes(), 0xE2293B2F);
+}
+
+TEST_CASE(test_xxhash64)
+{
+    auto do_test = [](ReadonlyBytes input, u64 expected_result) {
+        EXPECT_EQ(Crypto::Checksum::XxHash64(input).digest(), expected_result);
+
+        Crypto::Checksum::XxHash64 hash;
+        for (size_t offset = 0; offset < input.size(); offset += 7)
+            hash.update(input.slice(offset, min<size_t>(7, input.size() - offset)));
+        EXPECT_EQ(hash.digest(), expected_result);
+    };
+
+    do_test(String("").bytes(), 0xEF46DB3751D8E999);
+    do_test(String("abc").bytes(), 0x44BC2CF5AD770999);
+    do_test(String("Nobody inspects the spammish repetition").bytes(), 0xFBCEA83C8A378BF1);
+}
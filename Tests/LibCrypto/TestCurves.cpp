@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Curves/SECP256r1.h>
+#include <LibCrypto/Curves/X25519.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTest/TestCase.h>
+#include <cstring>
+
+// Test vectors from RFC 7748 section 6.1.
+TEST_CASE(test_x25519)
+{
+    u8 alice_private[] {
+        0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+        0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+    };
+    u8 alice_public[] {
+        0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54, 0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+        0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4, 0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a
+    };
+    u8 bob_private[] {
+        0x5d, 0xab, 0x08, 0x7e, 0x62, 0x4a, 0x8a, 0x4b, 0x79, 0xe1, 0x7f, 0x8b, 0x83, 0x80, 0x0e, 0xe6,
+        0x6f, 0x3b, 0xb1, 0x29, 0x26, 0x18, 0xb6, 0xfd, 0x1c, 0x2f, 0x8b, 0x27, 0xff, 0x88, 0xe0, 0xeb
+    };
+    u8 bob_public[] {
+        0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+        0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d, 0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+    };
+    u8 shared_secret[] {
+        0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1, 0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+        0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33, 0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+    };
+
+    Crypto::Curves::X25519 curve;
+    auto generated_alice_public = curve.generate_public_key({ alice_private, 32 });
+    EXPECT_EQ(generated_alice_public.size(), 32u);
+    EXPECT(memcmp(generated_alice_public.data(), alice_public, 32) == 0);
+
+    auto generated_bob_public = curve.generate_public_key({ bob_private, 32 });
+    EXPECT(memcmp(generated_bob_public.data(), bob_public, 32) == 0);
+
+    auto alice_shared = curve.compute_coordinate({ alice_private, 32 }, { bob_public, 32 });
+    EXPECT_EQ(alice_shared.size(), 32u);
+    EXPECT(memcmp(alice_shared.data(), shared_secret, 32) == 0);
+
+    auto bob_shared = curve.compute_coordinate({ bob_private, 32 }, { alice_public, 32 });
+    EXPECT(memcmp(bob_shared.data(), shared_secret, 32) == 0);
+}
+
+TEST_CASE(test_x25519_rejects_low_order_point)
+{
+    u8 zero_point[32] {};
+    Crypto::Curves::X25519 curve;
+    auto private_key = curve.generate_private_key();
+    EXPECT(curve.compute_coordinate(private_key, { zero_point, 32 }).is_empty());
+}
+
+TEST_CASE(test_x25519_random_agreement)
+{
+    Crypto::Curves::X25519 curve;
+    auto alice_private = curve.generate_private_key();
+    auto bob_private = curve.generate_private_key();
+    auto alice_shared = curve.compute_coordinate(alice_private, curve.generate_public_key(bob_private));
+    auto bob_shared = curve.compute_coordinate(bob_private, curve.generate_public_key(alice_private));
+    EXPECT_EQ(alice_shared.size(), 32u);
+    EXPECT(alice_shared == bob_shared);
+}
+
+// Keys, shared secret and signature generated with OpenSSL.
+TEST_CASE(test_secp256r1)
+{
+    u8 alice_private[] {
+        0x04, 0x3c, 0xbb, 0x34, 0xdf, 0x98, 0x9e, 0x7d, 0xe0, 0xb2, 0xf8, 0xbd, 0xf0, 0x13, 0x66, 0xe7,
+        0xed, 0xb4, 0x02, 0x35, 0x53, 0x16, 0xb7, 0x6f, 0x8b, 0x51, 0xdf, 0x64, 0xc2, 0xef, 0x69, 0x45
+    };
+    u8 alice_public[] {
+        0x04, 0x36, 0x9f, 0x73, 0x85, 0x2a, 0x85, 0x2f, 0x66, 0x49, 0xbe, 0x5f, 0xf9, 0x8e, 0xe3, 0xe6,
+        0xa6, 0x58, 0xd8, 0xcf, 0xc6, 0x33, 0x37, 0x56, 0x81, 0xc3, 0x59, 0x58, 0x36, 0x36, 0x08, 0xc2,
+        0x6a, 0x53, 0x18, 0x4b, 0xfe, 0x01, 0xa9, 0xd6, 0x2c, 0x8e, 0x64, 0x3d, 0x81, 0x4d, 0xdb, 0x5e,
+        0xca, 0x14, 0xb8, 0xbf, 0x35, 0x9c, 0xf2, 0x34, 0x1b, 0x4d, 0x2d, 0x11, 0x23, 0xaf, 0xd3, 0x1e,
+        0x49
+    };
+    u8 bob_private[] {
+        0x6a, 0x8a, 0x08, 0x3b, 0x7f, 0x5e, 0x79, 0xba, 0x2f, 0xc4, 0xec, 0x73, 0x93, 0x31, 0x80, 0xd7,
+        0x74, 0x30, 0xca, 0x1d, 0x69, 0xda, 0x10, 0xf2, 0x03, 0xb1, 0x7a, 0x92, 0xc8, 0x7d, 0xea, 0x55
+    };
+    u8 bob_public[] {
+        0x04, 0xaf, 0xd4, 0xcb, 0x2a, 0x01, 0x59, 0x8e, 0xa7, 0x51, 0x04, 0x24, 0x08, 0x50, 0x58, 0x5d,
+        0xb4, 0xef, 0xa7, 0xf2, 0xe4, 0xc9, 0x4c, 0xfd, 0x84, 0x3a, 0xb6, 0xa7, 0x93, 0xc4, 0xfa, 0x09,
+        0x82, 0xc2, 0x87, 0x1f, 0x1d, 0xe3, 0x63, 0x3c, 0x5c, 0xee, 0xf5, 0x9e, 0xd0, 0x59, 0x85, 0x11,
+        0x7b, 0x6a, 0x38, 0xbc, 0x0f, 0x25, 0x60, 0x42, 0x1c, 0x12, 0xdd, 0x34, 0x21, 0x28, 0x9f, 0x01,
+        0xd0
+    };
+    u8 shared_secret[] {
+        0x7f, 0x91, 0xb5, 0x3d, 0x51, 0xb6, 0x1a, 0xbb, 0x2d, 0x61, 0xbb, 0x16, 0x64, 0xdb, 0xee, 0xcc,
+        0x6f, 0x3b, 0x15, 0x92, 0xa9, 0x8f, 0x0c, 0x82, 0xef, 0x26, 0x07, 0x66, 0x11, 0xf3, 0x1a, 0xe8
+    };
+
+    Crypto::Curves::SECP256r1 curve;
+    auto generated_alice_public = curve.generate_public_key({ alice_private, 32 });
+    EXPECT_EQ(generated_alice_public.size(), 65u);
+    EXPECT(memcmp(generated_alice_public.data(), alice_public, 65) == 0);
+
+    auto generated_bob_public = curve.generate_public_key({ bob_private, 32 });
+    EXPECT(memcmp(generated_bob_public.data(), bob_public, 65) == 0);
+
+    auto alice_shared = curve.compute_coordinate({ alice_private, 32 }, { bob_public, 65 });
+    EXPECT_EQ(alice_shared.size(), 32u);
+    EXPECT(memcmp(alice_shared.data(), shared_secret, 32) == 0);
+
+    auto bob_shared = curve.compute_coordinate({ bob_private, 32 }, { alice_public, 65 });
+    EXPECT(memcmp(bob_shared.data(), shared_secret, 32) == 0);
+}
+
+TEST_CASE(test_secp256r1_rejects_invalid_point)
+{
+    u8 bob_public[] {
+        0x04, 0xaf, 0xd4, 0xcb, 0x2a, 0x01, 0x59, 0x8e, 0xa7, 0x51, 0x04, 0x24, 0x08, 0x50, 0x58, 0x5d,
+        0xb4, 0xef, 0xa7, 0xf2, 0xe4, 0xc9, 0x4c, 0xfd, 0x84, 0x3a, 0xb6, 0xa7, 0x93, 0xc4, 0xfa, 0x09,
+        0x82, 0xc2, 0x87, 0x1f, 0x1d, 0xe3, 0x63, 0x3c, 0x5c, 0xee, 0xf5, 0x9e, 0xd0, 0x59, 0x85, 0x11,
+        0x7b, 0x6a, 0x38, 0xbc, 0x0f, 0x25, 0x60, 0x42, 0x1c, 0x12, 0xdd, 0x34, 0x21, 0x28, 0x9f, 0x01,
+        0xd0
+    };
+    bob_public[64] ^= 1;
+
+    Crypto::Curves::SECP256r1 curve;
+    auto private_key = curve.generate_private_key();
+    EXPECT(curve.compute_coordinate(private_key, { bob_public, 65 }).is_empty());
+}
+
+TEST_CASE(test_secp256r1_ecdsa_verify)
+{
+    u8 alice_public[] {
+        0x04, 0x36, 0x9f, 0x73, 0x85, 0x2a, 0x85, 0x2f, 0x66, 0x49, 0xbe, 0x5f, 0xf9, 0x8e, 0xe3, 0xe6,
+        0xa6, 0x58, 0xd8, 0xcf, 0xc6, 0x33, 0x37, 0x56, 0x81, 0xc3, 0x59, 0x58, 0x36, 0x36, 0x08, 0xc2,
+        0x6a, 0x53, 0x18, 0x4b, 0xfe, 0x01, 0xa9, 0xd6, 0x2c, 0x8e, 0x64, 0x3d, 0x81, 0x4d, 0xdb, 0x5e,
+        0xca, 0x14, 0xb8, 0xbf, 0x35, 0x9c, 0xf2, 0x34, 0x1b, 0x4d, 0x2d, 0x11, 0x23, 0xaf, 0xd3, 0x1e,
+        0x49
+    };
+    u8 signature[] {
+        0x30, 0x45, 0x02, 0x20, 0x3a, 0x5d, 0x3f, 0x7b, 0x9a, 0x4f, 0x35, 0x85, 0x9d, 0xc2, 0x3d, 0x92,
+        0xa4, 0x91, 0x84, 0x87, 0x7f, 0x08, 0x8f, 0x68, 0xd5, 0xe8, 0xd1, 0x9a, 0xc6, 0xe6, 0x8d, 0x04,
+        0x1a, 0x7d, 0x6d, 0x48, 0x02, 0x21, 0x00, 0xa9, 0x30, 0xe3, 0x2a, 0xf9, 0xd5, 0x37, 0xf4, 0xf4,
+        0xba, 0xdc, 0xde, 0x11, 0x52, 0x24, 0xfa, 0xbc, 0x0c, 0xb4, 0xf9, 0x51, 0xc0, 0xb8, 0xc3, 0xd3,
+        0x6b, 0xd8, 0xb9, 0x2a, 0x52, 0x8a, 0xb5
+    };
+
+    auto digest = Crypto::Hash::SHA256::hash("Well hello friends");
+    ReadonlyBytes hash { digest.immutable_data(), digest.data_length() };
+    EXPECT(Crypto::Curves::SECP256r1::verify(hash, { alice_public, 65 }, { signature, sizeof(signature) }));
+
+    auto other_digest = Crypto::Hash::SHA256::hash("Well hello friend");
+    EXPECT(!Crypto::Curves::SECP256r1::verify({ other_digest.immutable_data(), other_digest.data_length() }, { alice_public, 65 }, { signature, sizeof(signature) }));
+
+    signature[10] ^= 1;
+    EXPECT(!Crypto::Curves::SECP256r1::verify(hash, { alice_public, 65 }, { signature, sizeof(signature) }));
+}
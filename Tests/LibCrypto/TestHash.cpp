@@ -142,6 +142,35 @@ TEST_CASE(test_SHA1_hash_successive_updates)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_two_blocks)
+{
+    u8 result[] {
+        0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1
+    };
+    auto digest = Crypto::Hash::SHA1::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA1_hash_many)
+{
+    // Enough messages of enough different lengths to go through every lane several times,
+    // with one and two padding blocks.
+    auto data = ByteBuffer::create_uninitialized(300);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 13 + 5;
+    Vector<ReadonlyBytes> messages;
+    for (size_t length = 0; length <= data.size(); length += 7)
+        messages.append(data.bytes().trim(length));
+    Vector<Crypto::Hash::SHA1::DigestType> digests;
+    digests.resize(messages.size());
+
+    Crypto::Hash::SHA1::hash_many(messages, digests);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA1::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA1::digest_size()) == 0);
+    }
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -166,6 +195,48 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_two_blocks)
+{
+    u8 result[] {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+    };
+    auto digest = Crypto::Hash::SHA256::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_successive_updates)
+{
+    // Updates that straddle block boundaries must hash the same as one big update.
+    auto data = ByteBuffer::create_uninitialized(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 31 + 7;
+    auto expected = Crypto::Hash::SHA256::hash(data);
+
+    Crypto::Hash::SHA256 hasher;
+    for (size_t offset = 0, step = 1; offset < data.size(); offset += step, step = step * 2 + 1)
+        hasher.update(data.bytes().slice(offset, min(step, data.size() - offset)));
+    auto digest = hasher.digest();
+    EXPECT(memcmp(expected.data, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    auto data = ByteBuffer::create_uninitialized(300);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 13 + 5;
+    Vector<ReadonlyBytes> messages;
+    for (size_t length = 0; length <= data.size(); length += 7)
+        messages.append(data.bytes().trim(length));
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
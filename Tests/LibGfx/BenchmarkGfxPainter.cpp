@@ -61,3 +61,65 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_with_translucent_color)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(*bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(0, 0, 255, 128));
+    }
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    bitmap->fill(Color::White);
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size });
+    source->fill(Color(0, 0, 255, 128));
+    Gfx::Painter painter(*bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, *source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    bitmap->fill(Color::White);
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    source->fill(Color::Blue);
+    Gfx::Painter painter(*bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, *source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    bitmap->fill(Color::White);
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size / 3, bitmap_size / 3 });
+    source->fill(Color(0, 0, 255, 128));
+    Gfx::Painter painter(*bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), *source, source->rect());
+    }
+}
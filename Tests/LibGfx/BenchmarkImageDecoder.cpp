@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/StringView.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+#include <LibGfx/PNGLoader.h>
+
+// Every JPEG sampling layout we support, and PNGs with a mix of filter types.
+static constexpr StringView jpg_corpus[] = {
+    "/res/html/misc/jpgsuite_files/non-subsampled-lena.jpg"sv,
+    "/res/html/misc/jpgsuite_files/horizontally-halved-lena.jpg"sv,
+    "/res/html/misc/jpgsuite_files/vertically-halved-lena.jpg"sv,
+    "/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg"sv,
+    "/res/html/misc/jpgsuite_files/oh-lena.jpg"sv,
+};
+
+static constexpr StringView png_corpus[] = {
+    "/res/graphics/brand-banner-2x.png"sv,
+    "/res/graphics/wizard-banner-simple.png"sv,
+    "/res/wallpapers/grid.png"sv,
+    "/res/wallpapers/sunset-retro.png"sv,
+};
+
+BENCHMARK_CASE(decode_jpg_corpus)
+{
+    const int run_count = 20;
+
+    for (int run = 0; run < run_count; run++) {
+        for (auto path : jpg_corpus) {
+            auto bitmap = Gfx::load_jpg(path);
+            EXPECT(bitmap);
+        }
+    }
+}
+
+BENCHMARK_CASE(decode_png_corpus)
+{
+    const int run_count = 20;
+
+    for (int run = 0; run < run_count; run++) {
+        for (auto path : png_corpus) {
+            auto bitmap = Gfx::load_png(path);
+            EXPECT(bitmap);
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Random.h>
+#include <LibGfx/DisjointRectSet.h>
+
+static constexpr int grid_size = 48;
+
+using Grid = Array<Array<bool, grid_size>, grid_size>;
+
+static Grid grid_for(const Gfx::DisjointRectSet& set)
+{
+    Grid grid {};
+    for (auto& rect : set.rects()) {
+        for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
+            for (int x = rect.x(); x < rect.x() + rect.width(); ++x) {
+                // Every pixel is covered by one rect at most.
+                EXPECT(!grid[y][x]);
+                grid[y][x] = true;
+            }
+        }
+    }
+    return grid;
+}
+
+static void expect_banded(const Gfx::DisjointRectSet& set)
+{
+    auto& rects = set.rects();
+    for (size_t i = 1; i < rects.size(); ++i) {
+        auto& previous = rects[i - 1];
+        auto& rect = rects[i];
+        if (previous.y() == rect.y()) {
+            EXPECT_EQ(previous.height(), rect.height());
+            EXPECT(previous.x() + previous.width() < rect.x());
+        } else {
+            EXPECT(previous.y() + previous.height() <= rect.y());
+        }
+    }
+}
+
+static Gfx::IntRect random_rect()
+{
+    int x = get_random_uniform(grid_size - 1);
+    int y = get_random_uniform(grid_size - 1);
+    return { x, y, (int)get_random_uniform(grid_size - x) + 1, (int)get_random_uniform(grid_size - y) + 1 };
+}
+
+static Gfx::DisjointRectSet random_set(Grid& grid)
+{
+    Gfx::DisjointRectSet set;
+    auto count = get_random_uniform(8) + 1;
+    for (u32 i = 0; i < count; ++i) {
+        auto rect = random_rect();
+        set.add(rect);
+        for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
+            for (int x = rect.x(); x < rect.x() + rect.width(); ++x)
+                grid[y][x] = true;
+        }
+    }
+    return set;
+}
+
+TEST_CASE(operations_match_a_pixel_model)
+{
+    for (int run = 0; run < 200; ++run) {
+        Grid a_grid {};
+        Grid b_grid {};
+        auto a = random_set(a_grid);
+        auto b = random_set(b_grid);
+        EXPECT(grid_for(a) == a_grid);
+        expect_banded(a);
+
+        Grid union_grid {};
+        Grid intersection_grid {};
+        Grid difference_grid {};
+        bool any_shared = false;
+        for (int y = 0; y < grid_size; ++y) {
+            for (int x = 0; x < grid_size; ++x) {
+                union_grid[y][x] = a_grid[y][x] || b_grid[y][x];
+                intersection_grid[y][x] = a_grid[y][x] && b_grid[y][x];
+                difference_grid[y][x] = a_grid[y][x] && !b_grid[y][x];
+                any_shared |= intersection_grid[y][x];
+            }
+        }
+
+        auto united = a.clone();
+        united.add(b);
+        EXPECT(grid_for(united) == union_grid);
+        expect_banded(united);
+
+        auto intersected = a.intersected(b);
+        EXPECT(grid_for(intersected) == intersection_grid);
+        expect_banded(intersected);
+        EXPECT_EQ(a.intersects(b), any_shared);
+
+        auto shattered = a.shatter(b);
+        EXPECT(grid_for(shattered) == difference_grid);
+        expect_banded(shattered);
+    }
+}
+
+TEST_CASE(add_many_matches_adding_one_by_one)
+{
+    for (int run = 0; run < 50; ++run) {
+        Vector<Gfx::IntRect> rects;
+        for (int i = 0; i < 20; ++i)
+            rects.append(random_rect());
+
+        Gfx::DisjointRectSet one_by_one;
+        for (auto& rect : rects)
+            one_by_one.add(rect);
+        Gfx::DisjointRectSet all_at_once;
+        all_at_once.add_many(rects);
+
+        // The banded form of an area is unique.
+        EXPECT(one_by_one.rects() == all_at_once.rects());
+    }
+}
+
+TEST_CASE(contains)
+{
+    Gfx::DisjointRectSet set;
+    set.add({ 0, 0, 10, 10 });
+    set.add({ 10, 0, 10, 10 });
+    EXPECT_EQ(set.size(), 1u);
+    EXPECT(set.contains({ 5, 2, 10, 5 }));
+    EXPECT(!set.contains({ 5, 2, 20, 5 }));
+    EXPECT(!set.contains({}));
+}
+
+TEST_CASE(limit_fragmentation)
+{
+    Gfx::DisjointRectSet set;
+    for (int i = 0; i < 10; ++i)
+        set.add({ i * 4, i * 4, 2, 2 });
+    EXPECT_EQ(set.size(), 10u);
+
+    set.limit_fragmentation(10);
+    EXPECT_EQ(set.size(), 10u);
+
+    set.limit_fragmentation(4);
+    EXPECT_EQ(set.size(), 1u);
+    EXPECT_EQ(set.rects()[0], Gfx::IntRect(0, 0, 38, 38));
+
+    Gfx::DisjointRectSet columns;
+    for (int i = 0; i < 10; ++i)
+        columns.add({ i * 4, 0, 2, 20 });
+    EXPECT_EQ(columns.size(), 10u);
+    columns.limit_fragmentation(4);
+    EXPECT_EQ(columns.size(), 1u);
+    EXPECT_EQ(columns.rects()[0], Gfx::IntRect(0, 0, 38, 20));
+}
@@ -7,6 +7,8 @@
 
 #include <LibGfx/BitmapFont.h>
 #include <LibGfx/FontDatabase.h>
+#include <LibGfx/TrueTypeFont/Font.h>
+#include <LibGfx/TrueTypeFont/GlyphAtlas.h>
 #include <LibTest/TestCase.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -147,3 +149,38 @@ TEST_CASE(test_write_to_file)
     EXPECT(font->write_to_file(path));
     unlink(path);
 }
+
+TEST_CASE(test_truetype_glyphs_share_the_atlas)
+{
+    auto font_or_error = TTF::Font::try_load_from_file("/res/fonts/LiberationSerif-Regular.ttf");
+    EXPECT(!font_or_error.is_error());
+    auto& atlas = TTF::GlyphAtlas::the();
+    auto glyph_count_before = atlas.glyph_count();
+    {
+        auto font = font_or_error.release_value();
+        auto scaled_font = adopt_ref(*new TTF::ScaledFont(font, 12, 12));
+        auto other_scaled_font = adopt_ref(*new TTF::ScaledFont(font, 12, 12));
+
+        auto a = scaled_font->glyph('A');
+        auto b = scaled_font->glyph('B');
+        EXPECT(!a.is_glyph_bitmap());
+        EXPECT(!b.is_glyph_bitmap());
+        EXPECT_EQ(a.bitmap().ptr(), b.bitmap().ptr());
+        EXPECT(!a.bitmap_rect().intersects(b.bitmap_rect()));
+
+        // Another instance of the same font at the same size gets the glyph that is already in the atlas.
+        auto other_a = other_scaled_font->glyph('A');
+        EXPECT_EQ(other_a.bitmap().ptr(), a.bitmap().ptr());
+        EXPECT_EQ(other_a.bitmap_rect(), a.bitmap_rect());
+
+        auto rasterized_a = font->rasterize_glyph(font->glyph_id_for_code_point('A'), 12.0f * DEFAULT_DPI / (POINTS_PER_INCH * font->units_per_em()), 12.0f * DEFAULT_DPI / (POINTS_PER_INCH * font->units_per_em()));
+        EXPECT_EQ(rasterized_a->size(), a.bitmap_rect().size());
+        for (int y = 0; y < rasterized_a->height(); ++y) {
+            for (int x = 0; x < rasterized_a->width(); ++x)
+                EXPECT_EQ(rasterized_a->get_pixel(x, y), a.bitmap()->get_pixel(a.bitmap_rect().x() + x, a.bitmap_rect().y() + y));
+        }
+        EXPECT(atlas.glyph_count() > glyph_count_before);
+    }
+    // The font is gone, and so are its glyphs.
+    EXPECT_EQ(atlas.glyph_count(), glyph_count_before);
+}
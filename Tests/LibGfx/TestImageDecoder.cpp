@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/MappedFile.h>
 #include <AK/String.h>
 #include <LibGfx/BMPLoader.h>
 #include <LibGfx/GIFLoader.h>
@@ -79,6 +80,34 @@ TEST_CASE(test_jpg)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_jpg_target_size)
+{
+    auto file = MappedFile::map("/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg");
+    EXPECT(!file.is_error());
+    auto decoder = Gfx::ImageDecoder::try_create(file.value()->bytes());
+    EXPECT(decoder);
+
+    decoder->set_target_size({ 100, 60 });
+    auto frame = decoder->frame(0);
+    EXPECT(frame.image);
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(128, 128));
+    EXPECT_EQ(decoder->size(), Gfx::IntSize(512, 512));
+}
+
+TEST_CASE(test_jpg_partial_frame)
+{
+    auto file = MappedFile::map("/res/html/misc/jpgsuite_files/oh-lena.jpg");
+    EXPECT(!file.is_error());
+    auto decoder = Gfx::ImageDecoder::try_create(file.value()->bytes().trim(file.value()->size() / 2));
+    EXPECT(decoder);
+
+    EXPECT(!decoder->frame(0).image);
+    auto frame = decoder->partial_frame();
+    EXPECT(frame.image);
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(1200, 822));
+    EXPECT_EQ(frame.image->get_pixel(0, frame.image->height() - 1), Color(128, 128, 128));
+}
+
 TEST_CASE(test_pbm)
 {
     auto image = Gfx::load_pbm("/res/html/misc/pbmsuite_files/buggie-raw.pbm");
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/FontDatabase.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+
+// Make sure that no matter what order tests are run in, we've got some
+// default fonts for the application to use without talking to WindowServer
+static struct FontDatabaseSpoofer {
+    FontDatabaseSpoofer()
+    {
+        Gfx::FontDatabase::the().set_default_font_query("Katica 10 400"sv);
+    }
+} g_spoof;
+
+// A bitmap full of colors with every alpha value from 0 to 255, so every case Color::blend() has is covered.
+static NonnullRefPtr<Gfx::Bitmap> create_test_bitmap(Gfx::BitmapFormat format, u32 seed)
+{
+    auto bitmap = Gfx::Bitmap::try_create(format, { 67, 31 });
+    VERIFY(bitmap);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x) {
+            seed = seed * 1103515245 + 12345;
+            bitmap->scanline(y)[x] = seed;
+        }
+    }
+    return bitmap.release_nonnull();
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_opaque_test_bitmap(u32 seed)
+{
+    auto bitmap = create_test_bitmap(Gfx::BitmapFormat::BGRA8888, seed);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            bitmap->scanline(y)[x] |= 0xff000000;
+    }
+    return bitmap;
+}
+
+static void expect_same_pixels(Gfx::Bitmap const& bitmap, Gfx::Bitmap const& expected)
+{
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x)
+            EXPECT_EQ(bitmap.scanline(y)[x], expected.scanline(y)[x]);
+    }
+}
+
+static void test_fill_rect_with_translucent_color(Gfx::Bitmap& target)
+{
+    auto expected = target.clone();
+    VERIFY(expected);
+    Color color { 10, 200, 30, 77 };
+    Gfx::IntRect rect { 3, 2, 50, 20 };
+
+    Gfx::Painter painter(target);
+    painter.fill_rect(rect, color);
+
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        for (int x = rect.left(); x <= rect.right(); ++x)
+            expected->scanline(y)[x] = Color::from_rgba(expected->scanline(y)[x]).blend(color).value();
+    }
+    expect_same_pixels(target, *expected);
+}
+
+TEST_CASE(fill_rect_with_translucent_color)
+{
+    test_fill_rect_with_translucent_color(create_test_bitmap(Gfx::BitmapFormat::BGRA8888, 1));
+    test_fill_rect_with_translucent_color(create_opaque_test_bitmap(2));
+}
+
+static void test_blit_with_opacity(Gfx::Bitmap& target, Gfx::Bitmap const& source, float opacity)
+{
+    auto expected = target.clone();
+    VERIFY(expected);
+
+    Gfx::Painter painter(target);
+    painter.blit({ 1, 1 }, source, { 0, 0, 60, 25 }, opacity);
+
+    for (int y = 0; y < 25; ++y) {
+        for (int x = 0; x < 60; ++x) {
+            auto src_color = Color::from_rgba(source.scanline(y)[x]);
+            float pixel_opacity = src_color.alpha() / 255.0;
+            src_color.set_alpha(255 * (opacity * pixel_opacity));
+            auto& pixel = expected->scanline(y + 1)[x + 1];
+            auto dest_color = target.has_alpha_channel() ? Color::from_rgba(pixel) : Color::from_rgb(pixel);
+            pixel = dest_color.blend(src_color).value();
+        }
+    }
+    expect_same_pixels(target, *expected);
+}
+
+TEST_CASE(blit_with_alpha_and_opacity)
+{
+    auto source = create_test_bitmap(Gfx::BitmapFormat::BGRA8888, 3);
+    for (float opacity : { 1.0f, 0.6f }) {
+        test_blit_with_opacity(create_test_bitmap(Gfx::BitmapFormat::BGRA8888, 4), source, opacity);
+        test_blit_with_opacity(create_opaque_test_bitmap(5), source, opacity);
+        test_blit_with_opacity(create_test_bitmap(Gfx::BitmapFormat::BGRx8888, 6), source, opacity);
+    }
+}
+
+static void add_rect_to_path(Gfx::Path& path, float x, float y, float width, float height, bool clockwise = true)
+{
+    path.move_to({ x, y });
+    if (clockwise) {
+        path.line_to({ x + width, y });
+        path.line_to({ x + width, y + height });
+        path.line_to({ x, y + height });
+    } else {
+        path.line_to({ x, y + height });
+        path.line_to({ x + width, y + height });
+        path.line_to({ x + width, y });
+    }
+    path.close();
+}
+
+TEST_CASE(fill_path_covers_exactly_the_pixels_inside)
+{
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { 40, 30 });
+    VERIFY(bitmap);
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(*bitmap);
+    // The path starts outside of the bitmap, which must not change what it covers inside.
+    Gfx::Path path;
+    add_rect_to_path(path, -5, 4, 20.5f, 10);
+    // This one is left open, and must get filled all the same.
+    path.move_to({ 30, 20 });
+    path.line_to({ 35, 20 });
+    path.line_to({ 35, 25 });
+    path.line_to({ 30, 25 });
+    painter.fill_path(path, Color::Black);
+
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x) {
+            auto pixel = bitmap->get_pixel(x, y);
+            if (x >= 30 && x < 35 && y >= 20 && y < 25)
+                EXPECT_EQ(pixel, Color::Black);
+            else if (y < 4 || y >= 14 || x > 15)
+                EXPECT_EQ(pixel, Color::White);
+            else if (x < 15)
+                EXPECT_EQ(pixel, Color::Black);
+            else
+                EXPECT(pixel.red() > 120 && pixel.red() < 135); // Half covered
+        }
+    }
+}
+
+TEST_CASE(fill_path_winding_rules)
+{
+    auto fill_with_hole = [](Gfx::Painter::WindingRule winding_rule, bool inner_clockwise) {
+        auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { 30, 30 });
+        VERIFY(bitmap);
+        bitmap->fill(Color::White);
+        Gfx::Painter painter(*bitmap);
+        Gfx::Path path;
+        add_rect_to_path(path, 2, 2, 26, 26);
+        add_rect_to_path(path, 10, 10, 10, 10, inner_clockwise);
+        painter.fill_path(path, Color::Black, winding_rule);
+        return bitmap->get_pixel(15, 15);
+    };
+
+    EXPECT_EQ(fill_with_hole(Gfx::Painter::WindingRule::EvenOdd, true), Color::White);
+    EXPECT_EQ(fill_with_hole(Gfx::Painter::WindingRule::EvenOdd, false), Color::White);
+    EXPECT_EQ(fill_with_hole(Gfx::Painter::WindingRule::Nonzero, true), Color::Black);
+    EXPECT_EQ(fill_with_hole(Gfx::Painter::WindingRule::Nonzero, false), Color::White);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <AK/Hex.h>
+#include <LibHTTP/HPack.h>
+
+using HTTP::HPack::HeaderField;
+
+static ByteBuffer from_hex(StringView hex)
+{
+    return decode_hex(hex).release_value();
+}
+
+static void expect_fields(const Optional<Vector<HeaderField>>& fields, const Vector<HeaderField>& expected)
+{
+    EXPECT(fields.has_value());
+    if (!fields.has_value())
+        return;
+    EXPECT_EQ(fields->size(), expected.size());
+    for (size_t i = 0; i < min(fields->size(), expected.size()); ++i) {
+        EXPECT_EQ(fields->at(i).name, expected[i].name);
+        EXPECT_EQ(fields->at(i).value, expected[i].value);
+    }
+}
+
+// RFC 7541 appendix C.4
+TEST_CASE(requests_with_huffman_coding)
+{
+    Vector<HeaderField> first {
+        { ":method", "GET" },
+        { ":scheme", "http" },
+        { ":path", "/" },
+        { ":authority", "www.example.com" },
+    };
+    Vector<HeaderField> second {
+        { ":method", "GET" },
+        { ":scheme", "http" },
+        { ":path", "/" },
+        { ":authority", "www.example.com" },
+        { "cache-control", "no-cache" },
+    };
+    Vector<HeaderField> third {
+        { ":method", "GET" },
+        { ":scheme", "https" },
+        { ":path", "/index.html" },
+        { ":authority", "www.example.com" },
+        { "custom-key", "custom-value" },
+    };
+    auto first_block = from_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff");
+    auto second_block = from_hex("828684be5886a8eb10649cbf");
+    auto third_block = from_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf");
+
+    HTTP::HPack::Encoder encoder;
+    EXPECT_EQ(encoder.encode(first), first_block);
+    EXPECT_EQ(encoder.encode(second), second_block);
+    EXPECT_EQ(encoder.encode(third), third_block);
+
+    HTTP::HPack::Decoder decoder;
+    expect_fields(decoder.decode(first_block), first);
+    expect_fields(decoder.decode(second_block), second);
+    expect_fields(decoder.decode(third_block), third);
+}
+
+// RFC 7541 appendix C.6, where the table is small enough for entries to be evicted.
+TEST_CASE(responses_with_huffman_coding_and_eviction)
+{
+    HTTP::HPack::Decoder decoder;
+    decoder.set_max_table_size(256);
+
+    expect_fields(decoder.decode(from_hex("488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e919d29ad171863c78f0b97c8e9ae82ae43d3")),
+        {
+            { ":status", "302" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+            { "location", "https://www.example.com" },
+        });
+    expect_fields(decoder.decode(from_hex("4883640effc1c0bf")),
+        {
+            { ":status", "307" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+            { "location", "https://www.example.com" },
+        });
+    expect_fields(decoder.decode(from_hex("88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007")),
+        {
+            { ":status", "200" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:22 GMT" },
+            { "location", "https://www.example.com" },
+            { "content-encoding", "gzip" },
+            { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" },
+        });
+}
+
+TEST_CASE(sensitive_fields_stay_out_of_the_table)
+{
+    HTTP::HPack::Encoder encoder;
+    Vector<HeaderField> fields { { "authorization", "secret" } };
+    auto first_block = encoder.encode(fields);
+    // Literal never indexed, with the name from the static table.
+    EXPECT_EQ(first_block[0], 0x1f);
+    EXPECT_EQ(encoder.encode(fields), first_block);
+
+    HTTP::HPack::Decoder decoder;
+    expect_fields(decoder.decode(first_block), fields);
+}
+
+TEST_CASE(malformed_blocks)
+{
+    HTTP::HPack::Decoder decoder;
+    // Index 0, and an index past the end of the (empty) dynamic table.
+    EXPECT(!decoder.decode(from_hex("80")).has_value());
+    EXPECT(!decoder.decode(from_hex("be")).has_value());
+    // A string running past the end of the block.
+    EXPECT(!decoder.decode(from_hex("4185f1e3")).has_value());
+    // Huffman padding that isn't all ones, and padding of a whole byte.
+    EXPECT(!decoder.decode(from_hex("418100")).has_value());
+    EXPECT(!decoder.decode(from_hex("4182f1ff")).has_value());
+    // A table size update larger than we allowed.
+    EXPECT(!decoder.decode(from_hex("3fe21f")).has_value());
+}
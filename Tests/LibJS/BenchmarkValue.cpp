@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/Value.h>
+
+static_assert(sizeof(JS::Value) == 8);
+
+TEST_CASE(values_survive_boxing)
+{
+    EXPECT(JS::Value().is_empty());
+    EXPECT(JS::js_undefined().is_undefined());
+    EXPECT(JS::js_null().is_null());
+    EXPECT(JS::js_null().is_nullish());
+    EXPECT_EQ(JS::Value(true).as_bool(), true);
+    EXPECT_EQ(JS::Value(false).as_bool(), false);
+
+    EXPECT_EQ(JS::Value(42).type(), JS::Value::Type::Int32);
+    EXPECT_EQ(JS::Value(-1).as_i32(), -1);
+    EXPECT_EQ(JS::Value(NumericLimits<i32>::min()).as_double(), static_cast<double>(NumericLimits<i32>::min()));
+    EXPECT_EQ(JS::Value(4294967295u).as_double(), 4294967295.0);
+    EXPECT_EQ(JS::Value(0.5).type(), JS::Value::Type::Double);
+    EXPECT_EQ(JS::Value(0.5).as_double(), 0.5);
+    EXPECT(JS::Value(-0.0).is_negative_zero());
+    EXPECT(JS::Value(INFINITY).is_positive_infinity());
+    EXPECT(JS::Value(-INFINITY).is_negative_infinity());
+
+    // Every NaN has to come out as a number, whatever its bits were.
+    EXPECT(JS::Value(bit_cast<double>(0xffffffffffffffffull)).is_nan());
+    EXPECT(JS::Value(bit_cast<double>(0x7ffc000000000001ull)).is_nan());
+    EXPECT(JS::js_nan().is_number());
+}
+
+TEST_CASE(cells_survive_boxing)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto& global_object = interpreter->global_object();
+
+    JS::Value object_value(&global_object);
+    EXPECT(object_value.is_object());
+    EXPECT(object_value.is_cell());
+    EXPECT_EQ(&object_value.as_object(), &global_object);
+
+    JS::Value string_value(JS::js_string(*vm, "well hello friends"));
+    EXPECT(string_value.is_string());
+    EXPECT_EQ(string_value.as_string().string(), "well hello friends");
+
+    EXPECT(JS::Value(static_cast<JS::Object*>(nullptr)).is_null());
+}
+
+static void run_script(StringView source, bool use_bytecode)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    VERIFY(!parser.has_errors());
+
+    if (use_bytecode) {
+        auto executable = JS::Bytecode::Generator::generate(*program);
+        JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object());
+        bytecode_interpreter.run(executable);
+    } else {
+        interpreter->run(interpreter->global_object(), *program);
+    }
+    EXPECT(!vm->exception());
+}
+
+// Mostly moves Values in and out of an Array's dense storage.
+static constexpr auto array_script = R"(
+    let values = [];
+    for (let i = 0; i < 20000; ++i)
+        values.push(i % 2 ? i : i + 0.5);
+    let sum = 0;
+    for (let i = 0; i < values.length; ++i)
+        sum += values[i];
+)"sv;
+
+// Mostly copies Values between bytecode registers.
+static constexpr auto arithmetic_script = R"(
+    let a = 1, b = 2.5, c = 0;
+    for (let i = 0; i < 200000; ++i) {
+        c = a + b * i;
+        a = c - a;
+    }
+)"sv;
+
+BENCHMARK_CASE(array_dense_storage)
+{
+    run_script(array_script, false);
+}
+
+BENCHMARK_CASE(array_dense_storage_bytecode)
+{
+    run_script(array_script, true);
+}
+
+BENCHMARK_CASE(register_arithmetic_bytecode)
+{
+    run_script(arithmetic_script, true);
+}
+
+BENCHMARK_CASE(copy_values)
+{
+    Vector<JS::Value> values;
+    for (i32 i = 0; i < 1'000'000; ++i)
+        values.append(i % 3 ? JS::Value(i) : JS::Value(i + 0.25));
+
+    double sum = 0;
+    for (int run = 0; run < 10; ++run) {
+        auto copy = values;
+        for (auto& value : copy)
+            sum += value.as_double();
+    }
+    EXPECT(sum > 0);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibJS/Heap/DeferGC.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/WeakSet.h>
+
+TEST_CASE(incremental_sweep)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto& global_object = interpreter->global_object();
+    auto& heap = vm->heap();
+    heap.set_sweeps_incrementally(true);
+
+    size_t sweep_requests = 0;
+    heap.on_sweep_pending = [&] { ++sweep_requests; };
+
+    auto* weak_set = JS::WeakSet::create(global_object);
+    auto weak_set_handle = JS::make_handle(weak_set);
+    {
+        JS::DeferGC defer_gc(heap);
+        for (size_t i = 0; i < 1000; ++i)
+            weak_set->values().set(JS::Object::create(global_object, nullptr));
+    }
+
+    heap.collect_garbage();
+    EXPECT(heap.has_pending_sweep());
+    EXPECT_EQ(sweep_requests, 1u);
+
+    // The dead cells have to be gone from weak containers right away, not only once they're swept.
+    // (A stray pointer on the stack may keep one or two of them alive.)
+    EXPECT(weak_set->values().size() < 10u);
+
+    // Allocating while sweeping is still pending mustn't hand out cells that get swept later.
+    auto survivor = JS::make_handle(JS::Object::create(global_object, nullptr));
+
+    while (heap.sweep_incrementally(1)) { }
+    EXPECT(!heap.has_pending_sweep());
+    EXPECT_EQ(survivor.cell()->state(), JS::Cell::State::Live);
+    for (auto* cell : weak_set->values())
+        EXPECT_EQ(cell->state(), JS::Cell::State::Live);
+
+    heap.collect_garbage();
+    heap.finish_sweeping();
+    EXPECT(!heap.has_pending_sweep());
+    EXPECT_EQ(survivor.cell()->state(), JS::Cell::State::Live);
+}
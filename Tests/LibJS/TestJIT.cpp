@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/String.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+
+static String run_bytecode(StringView source, bool jit_enabled, bool optimize)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    VERIFY(!parser.has_errors());
+
+    auto executable = JS::Bytecode::Generator::generate(*program);
+    if (optimize)
+        JS::Bytecode::Interpreter::optimization_pipeline().perform(executable);
+    JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object());
+    bytecode_interpreter.set_jit_enabled(jit_enabled);
+    bytecode_interpreter.run(executable);
+    EXPECT(!vm->exception());
+    return vm->last_value().to_string_without_side_effects();
+}
+
+static void expect_same_result(StringView source, StringView expected)
+{
+    for (auto optimize : { false, true }) {
+        EXPECT_EQ(run_bytecode(source, false, optimize), expected);
+        EXPECT_EQ(run_bytecode(source, true, optimize), expected);
+    }
+}
+
+TEST_CASE(int32_arithmetic)
+{
+    expect_same_result("let s = 0; for (let i = 0; i < 1000; i++) s = s + i; s"sv, "499500"sv);
+    expect_same_result("let s = 1; for (let i = 1; i <= 100; ++i) { s = (s * 3) & 0xffff; s = (s ^ i) | 1; } s"sv, "46221"sv);
+    expect_same_result("let a = 10; a - 20"sv, "-10"sv);
+}
+
+TEST_CASE(int32_overflow_turns_into_doubles)
+{
+    expect_same_result("2147483647 + 1"sv, "2147483648"sv);
+    expect_same_result("-2147483648 - 1"sv, "-2147483649"sv);
+    expect_same_result("65536 * 65536"sv, "4294967296"sv);
+    expect_same_result("1 / (0 * -5)"sv, "-Infinity"sv);
+    expect_same_result("let x = 2147483647; x++; x"sv, "2147483648"sv);
+    expect_same_result("let y = -2147483648; y--; y"sv, "-2147483649"sv);
+}
+
+TEST_CASE(comparisons_and_jumps)
+{
+    expect_same_result("[3 < 4, 4 <= 4, 5 > 6, 6 >= 6, 1 === 1, 1 !== 1].join()"sv, "true,true,false,true,true,false"sv);
+    expect_same_result("let c = 0; if (0) c = 1; else c = 2; c"sv, "2"sv);
+    expect_same_result("let w = 0; while (w < 10) { if (w === 5) break; w++; } w"sv, "5"sv);
+    expect_same_result("let t = 0; if ('') t = 1; if ('x') t += 2; t"sv, "2"sv);
+}
+
+TEST_CASE(operands_without_a_fast_path)
+{
+    expect_same_result("[1.5 < 2, 'a' + 1, 1 + 'a', 0.5 + 0.25].join()"sv, "true,a1,1a,0.75"sv);
+    expect_same_result("let r = 'none'; try { null.x; } catch (e) { r = 'caught'; } r"sv, "caught"sv);
+}
+
+TEST_CASE(folded_constants_and_coalesced_registers)
+{
+    expect_same_result("let k = 2 + 3 * 4; if (k > 10) k = -k; k"sv, "-14"sv);
+    expect_same_result("[~5, 1 << 31, -1 >>> 28, !0, -(3 - 3)].join()"sv, "-6,-2147483648,15,true,0"sv);
+    expect_same_result("let a = 1, b = 2, c = 3; [a + b, b + c, a + b + c, a * b * c].join()"sv, "3,5,6,6"sv);
+    expect_same_result("let u; if (u === undefined) u = 'undefined'; u"sv, "undefined"sv);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/String.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+
+static String run(StringView source, bool lazy_function_parsing)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto parser = JS::Parser(JS::Lexer(source));
+    parser.set_lazy_function_parsing(lazy_function_parsing);
+    auto program = parser.parse_program();
+    VERIFY(!parser.has_errors());
+
+    interpreter->run(interpreter->global_object(), *program);
+    EXPECT(!vm->exception());
+    return vm->last_value().to_string_without_side_effects();
+}
+
+static void expect_same_result(StringView source, StringView expected)
+{
+    EXPECT_EQ(run(source, false), expected);
+    EXPECT_EQ(run(source, true), expected);
+}
+
+TEST_CASE(functions_run_the_same)
+{
+    expect_same_result("function f(n) { return n <= 1 ? 1 : n * f(n - 1); } f(5)"sv, "120"sv);
+    expect_same_result("var g = function () { var x = 1; function h() { return x + 1; } return h(); }; g()"sv, "2"sv);
+    expect_same_result("function k() { var o = { a: '}' }; return `${ { b: 2 }.b }}` + o.a + /}{/.source; } k()"sv, "2}}}{"sv);
+}
+
+TEST_CASE(strictness_is_known_without_parsing_the_body)
+{
+    expect_same_result("function s() { 'use strict'; return this; } typeof s()"sv, "undefined"sv);
+    expect_same_result("function t() { return this; } typeof t()"sv, "object"sv);
+    expect_same_result("'use strict'; function u() { return this; } typeof u()"sv, "undefined"sv);
+}
+
+TEST_CASE(syntax_errors_are_thrown_on_first_call)
+{
+    EXPECT_EQ(run("function broken() { return 1 + ; } 42"sv, true), "42"sv);
+    EXPECT_EQ(run("function broken() { return 1 + ; } let r; try { broken(); } catch (e) { r = e.name; } r"sv, true), "SyntaxError"sv);
+}
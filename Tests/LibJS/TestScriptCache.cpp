@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/ScriptCache.h>
+
+TEST_CASE(same_script_is_only_parsed_once)
+{
+    auto& cache = JS::ScriptCache::the();
+    cache.clear();
+
+    auto first = cache.parse("https://example.com/a.js"sv, "var a = 1;"sv).release_value();
+    auto second = cache.parse("https://example.com/a.js"sv, "var a = 1;"sv).release_value();
+    EXPECT_EQ(first.ptr(), second.ptr());
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_CASE(changed_script_is_parsed_again)
+{
+    auto& cache = JS::ScriptCache::the();
+    cache.clear();
+
+    auto old_script = cache.parse("https://example.com/a.js"sv, "var a = 1;"sv).release_value();
+    auto new_script = cache.parse("https://example.com/a.js"sv, "var a = 2;"sv).release_value();
+    auto other_script = cache.parse("https://example.com/b.js"sv, "var a = 2;"sv).release_value();
+    EXPECT_NE(old_script.ptr(), new_script.ptr());
+    EXPECT_NE(new_script.ptr(), other_script.ptr());
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST_CASE(scripts_with_syntax_errors_are_not_cached)
+{
+    auto& cache = JS::ScriptCache::the();
+    cache.clear();
+
+    EXPECT(cache.parse("broken.js"sv, "var = ;"sv).is_error());
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_CASE(least_recently_used_script_is_evicted)
+{
+    auto& cache = JS::ScriptCache::the();
+    cache.clear();
+    cache.set_capacity(2);
+
+    auto a = cache.parse("a.js"sv, "1"sv).release_value();
+    auto b = cache.parse("b.js"sv, "2"sv).release_value();
+    EXPECT_EQ(cache.parse("a.js"sv, "1"sv).release_value().ptr(), a.ptr());
+    (void)cache.parse("c.js"sv, "3"sv);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.parse("a.js"sv, "1"sv).release_value().ptr(), a.ptr());
+    EXPECT_NE(cache.parse("b.js"sv, "2"sv).release_value().ptr(), b.ptr());
+
+    cache.set_capacity(32);
+}
+
+TEST_CASE(cached_script_runs_again_in_a_new_realm)
+{
+    auto script = JS::ScriptCache::the().parse("run.js"sv, "function f(n) { return n * 2; } f(21)"sv, true).release_value();
+    for (auto use_bytecode : { false, true, false, true }) {
+        auto vm = JS::VM::create();
+        auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+        if (use_bytecode) {
+            JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object());
+            bytecode_interpreter.run(script->executable());
+        } else {
+            interpreter->run(interpreter->global_object(), script->program());
+        }
+        EXPECT_EQ(vm->last_value().to_string_without_side_effects(), "42");
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibPthread/pthread.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <time.h>
+
+TEST_CASE(rwlock_readers_share_writers_exclude)
+{
+    pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+    EXPECT_EQ(pthread_rwlock_rdlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_tryrdlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_trywrlock(&lock), EBUSY);
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), 0);
+
+    EXPECT_EQ(pthread_rwlock_trywrlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_tryrdlock(&lock), EBUSY);
+    EXPECT_EQ(pthread_rwlock_trywrlock(&lock), EBUSY);
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), 0);
+
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), EPERM);
+}
+
+TEST_CASE(rwlock_timed_lock_times_out)
+{
+    pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+    EXPECT_EQ(pthread_rwlock_rdlock(&lock), 0);
+
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += 20'000'000;
+    if (deadline.tv_nsec >= 1'000'000'000) {
+        deadline.tv_nsec -= 1'000'000'000;
+        ++deadline.tv_sec;
+    }
+    EXPECT_EQ(pthread_rwlock_timedwrlock(&lock, &deadline), ETIMEDOUT);
+
+    // The writer that gave up must not keep new readers out.
+    EXPECT_EQ(pthread_rwlock_tryrdlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), 0);
+    EXPECT_EQ(pthread_rwlock_unlock(&lock), 0);
+}
+
+static pthread_rwlock_t s_lock = PTHREAD_RWLOCK_INITIALIZER;
+static Atomic<int> s_readers_inside { 0 };
+static int s_counter { 0 };
+static Atomic<bool> s_saw_writer_with_readers { false };
+
+static constexpr int iterations_per_thread = 10000;
+
+static void* stress_thread(void* arg)
+{
+    bool writer = arg != nullptr;
+    for (int i = 0; i < iterations_per_thread; ++i) {
+        if (writer) {
+            pthread_rwlock_wrlock(&s_lock);
+            if (s_readers_inside.load() != 0)
+                s_saw_writer_with_readers.store(true);
+            ++s_counter;
+        } else {
+            pthread_rwlock_rdlock(&s_lock);
+            s_readers_inside.fetch_add(1);
+            (void)AK::atomic_load(&s_counter, AK::memory_order_relaxed);
+            s_readers_inside.fetch_sub(1);
+        }
+        pthread_rwlock_unlock(&s_lock);
+    }
+    return nullptr;
+}
+
+TEST_CASE(rwlock_stress)
+{
+    static constexpr int writer_count = 2;
+    static constexpr int reader_count = 6;
+    pthread_t threads[writer_count + reader_count];
+    for (int i = 0; i < writer_count + reader_count; ++i)
+        pthread_create(&threads[i], nullptr, stress_thread, i < writer_count ? &threads[i] : nullptr);
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+
+    EXPECT(!s_saw_writer_with_readers.load());
+    EXPECT_EQ(s_counter, writer_count * iterations_per_thread);
+}
@@ -726,3 +726,95 @@ TEST_CASE(case_insensitive_match)
         EXPECT_EQ(result.matches.at(0).column, 4ul);
     }
 }
+
+TEST_CASE(nested_repetition_without_backtracking)
+{
+    // Backtracking would try every way of splitting the a's between the two alternatives.
+    Regex<ECMA262> re("(?:a|a)*b");
+    EXPECT_EQ(re.parser_result.error, Error::NoError);
+    EXPECT_EQ(re.match(String::repeated('a', 64)).success, false);
+
+    auto result = re.search(String::formatted("{}b", String::repeated('a', 64)));
+    EXPECT_EQ(result.success, true);
+    if (result.success) {
+        EXPECT_EQ(result.matches.at(0).column, 0ul);
+        EXPECT_EQ(result.matches.at(0).view.length(), 65ul);
+    }
+
+    Regex<ECMA262> lazy("x(?:a|b)+?b");
+    auto lazy_result = lazy.search("cxaabbb");
+    EXPECT_EQ(lazy_result.success, true);
+    if (lazy_result.success) {
+        EXPECT_EQ(lazy_result.matches.at(0).column, 1ul);
+        EXPECT_EQ(lazy_result.matches.at(0).view.to_string(), "xaab");
+    }
+}
+
+TEST_CASE(search_for_literal_prefix)
+{
+    String subject = "a nam, a name, his names and Name";
+    // Both with and without capture groups, which take different paths through the matcher.
+    for (auto& pattern : { "names?", "(na)(me)s?" }) {
+        Regex<ECMA262> re(pattern);
+        auto result = re.search(subject);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.count, 2u);
+        if (result.count == 2) {
+            EXPECT_EQ(result.matches.at(0).global_offset, 9u);
+            EXPECT_EQ(result.matches.at(1).view.to_string(), "names");
+        }
+    }
+    EXPECT_EQ(Regex<ECMA262>("(na)(me)s?").parser_result.bytecode.literal_prefix(), "name");
+
+    Regex<PosixExtended> insensitive("name", PosixFlags::Global | PosixFlags::Insensitive);
+    EXPECT_EQ(insensitive.match(subject).count, 3u);
+
+    Regex<ECMA262> anchored("^name");
+    EXPECT_EQ(anchored.parser_result.bytecode.literal_prefix(), "");
+}
+
+TEST_CASE(compiled_pattern_cache)
+{
+    auto regex = Regex<ECMA262>::cached("(?<word>[a-z]+)!");
+    auto again = Regex<ECMA262>::cached("(?<word>[a-z]+)!");
+    EXPECT(regex.parser_result.bytecode == again.parser_result.bytecode);
+    EXPECT(regex.pattern_value.characters() == again.pattern_value.characters());
+    // Different options make for a different pattern.
+    auto insensitive = Regex<ECMA262>::cached("(?<word>[a-z]+)!", ECMAScriptFlags::Insensitive);
+    EXPECT_EQ(insensitive.search("HEY!").success, true);
+    EXPECT_EQ(again.search("HEY!").success, false);
+
+    // Push the pattern out of the cache, the regexes compiled from it keep working.
+    for (size_t i = 0; i <= Regex<ECMA262>::compiled_pattern_cache_size; ++i)
+        (void)Regex<ECMA262>::cached(String::formatted("{}", i));
+    auto result = again.search("hey! you!");
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.count, 2u);
+    if (result.success)
+        EXPECT_EQ(result.named_capture_group_matches.at(1).ensure("word").view, "you");
+
+    EXPECT_NE(Regex<ECMA262>::cached("(").parser_result.error, Error::NoError);
+}
+
+TEST_CASE(character_class_lookup_table)
+{
+    Regex<ECMA262> re("[a-c\\d]+[^x-z]");
+    auto& bytecode = re.parser_result.bytecode;
+    EXPECT(bytecode.contains_slow((regex::ByteCodeValueType)regex::CharacterCompareType::LookupTable));
+
+    auto result = re.search("zzab12cq");
+    EXPECT_EQ(result.success, true);
+    if (result.success)
+        EXPECT_EQ(result.matches.at(0).view.to_string(), "ab12cq");
+
+    // Views that aren't looked up in the table go through the original arguments, and match the same.
+    u32 code_points[] = { 'z', 'z', 'a', 'b', '1', '2', 'c', 'q' };
+    result = re.search(Utf32View { code_points, 8 });
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.matches.at(0).global_offset, 2u);
+
+    Regex<ECMA262> insensitive("[a-c\\d]+[^x-z]", ECMAScriptFlags::Insensitive);
+    EXPECT_EQ(insensitive.search("ZZAB12CQ").matches.at(0).view.to_string(), "AB12CQ");
+    EXPECT_EQ(insensitive.search("ABC").success, true);
+    EXPECT_EQ(insensitive.search("Z1Z").success, false);
+}
@@ -123,6 +123,7 @@ constexpr static u32 pointers[] = {
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Heap& heap);
 void insert_and_get_to_and_from_btree(int num_keys);
 void insert_into_and_scan_btree(int num_keys);
+void bulk_load_and_scan_btree(int num_keys, float fill_factor);
 
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Heap& heap)
 {
@@ -309,3 +310,129 @@ TEST_CASE(btree_scan_50_keys)
 {
     insert_into_and_scan_btree(50);
 }
+
+void bulk_load_and_scan_btree(int num_keys, float fill_factor)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        auto btree = setup_btree(heap);
+
+        Vector<SQL::Key> bulk_keys;
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = (ix * 7919) % num_keys;
+            k.set_pointer((ix * 7919) % num_keys + 1000);
+            bulk_keys.append(k);
+        }
+        // One duplicate, which the unique tree drops.
+        bulk_keys.append(bulk_keys.first());
+        EXPECT_EQ(btree->bulk_load(move(bulk_keys), fill_factor), (size_t)num_keys);
+    }
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        auto btree = setup_btree(heap);
+
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = ix;
+            auto pointer_opt = btree->get(k);
+            EXPECT(pointer_opt.has_value());
+            EXPECT_EQ(pointer_opt.value(), (u32)ix + 1000);
+        }
+
+        int count = 0;
+        for (auto iter = btree->begin(); !iter.is_end(); iter++, count++)
+            EXPECT_EQ((int)(*iter)[0], count);
+        EXPECT_EQ(count, num_keys);
+
+        SQL::Key k(btree->descriptor());
+        k[0] = num_keys;
+        k.set_pointer(num_keys + 1000);
+        EXPECT(btree->insert(k));
+        EXPECT_EQ(btree->get(k).value_or(0), (u32)num_keys + 1000);
+    }
+}
+
+TEST_CASE(btree_bulk_load_one_key)
+{
+    bulk_load_and_scan_btree(1, SQL::BTree::default_fill_factor);
+}
+
+TEST_CASE(btree_bulk_load_50_keys)
+{
+    bulk_load_and_scan_btree(50, SQL::BTree::default_fill_factor);
+}
+
+TEST_CASE(btree_bulk_load_10000_keys)
+{
+    bulk_load_and_scan_btree(10000, SQL::BTree::default_fill_factor);
+}
+
+TEST_CASE(btree_bulk_load_10000_keys_half_full)
+{
+    bulk_load_and_scan_btree(10000, 0.5f);
+}
+
+TEST_CASE(btree_bulk_load_into_non_empty_tree)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    auto heap = SQL::Heap::construct("/tmp/test.db");
+    auto btree = setup_btree(heap);
+    for (auto ix = 0; ix < 10; ix++) {
+        SQL::Key k(btree->descriptor());
+        k[0] = keys[ix];
+        k.set_pointer(pointers[ix]);
+        btree->insert(k);
+    }
+
+    Vector<SQL::Key> bulk_keys;
+    for (auto ix = 5; ix < 20; ix++) {
+        SQL::Key k(btree->descriptor());
+        k[0] = keys[ix];
+        k.set_pointer(pointers[ix]);
+        bulk_keys.append(k);
+    }
+    EXPECT_EQ(btree->bulk_load(move(bulk_keys)), 10u);
+    for (auto ix = 0; ix < 20; ix++) {
+        SQL::Key k(btree->descriptor());
+        k[0] = keys[ix];
+        EXPECT_EQ(btree->get(k).value_or(0), (u32)pointers[ix]);
+    }
+}
+
+TEST_CASE(btree_text_keys_with_shared_prefixes)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    SQL::TupleDescriptor tuple_descriptor;
+    tuple_descriptor.append({ "key_value", SQL::SQLType::Text, SQL::Order::Ascending });
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        heap->set_user_value(0, heap->new_record_pointer());
+        auto btree = SQL::BTree::construct(heap, tuple_descriptor, true, heap->user_value(0));
+        btree->on_new_root = [&]() {
+            heap->set_user_value(0, btree->root());
+        };
+        for (auto ix = 0; ix < 500; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = String::formatted("customer-{:05}", (ix * 7919) % 500);
+            k.set_pointer(ix + 1);
+            EXPECT(btree->insert(k));
+        }
+    }
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        auto btree = SQL::BTree::construct(heap, tuple_descriptor, true, heap->user_value(0));
+        int count = 0;
+        for (auto iter = btree->begin(); !iter.is_end(); iter++, count++)
+            EXPECT_EQ((*iter)[0].to_string().value(), String::formatted("customer-{:05}", count));
+        EXPECT_EQ(count, 500);
+
+        SQL::Key k(btree->descriptor());
+        k[0] = "customer-00042";
+        auto pointer = btree->get(k);
+        EXPECT(pointer.has_value());
+        EXPECT_EQ((pointer.value() - 1) * 7919 % 500, 42u);
+    }
+}
@@ -4,16 +4,23 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <fcntl.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <LibSQL/BTree.h>
+#include <LibSQL/Cursor.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Meta.h>
+#include <LibSQL/Planner.h>
 #include <LibSQL/Row.h>
+#include <LibSQL/Snapshot.h>
 #include <LibSQL/Value.h>
 #include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
 
 NonnullRefPtr<SQL::SchemaDef> setup_schema(SQL::Database&);
 NonnullRefPtr<SQL::SchemaDef> setup_table(SQL::Database&);
@@ -174,3 +181,387 @@ TEST_CASE(insert_100_into_table)
 {
     insert_and_verify(100);
 }
+
+TEST_CASE(page_cache_stays_bounded)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        insert_into_table(db, 300);
+        db->checkpoint();
+        EXPECT(db->heap().cached_pages() <= SQL::Heap::page_cache_size);
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        verify_table_contents(db, 300);
+        EXPECT(db->heap().cached_pages() <= SQL::Heap::page_cache_size);
+    }
+}
+
+TEST_CASE(page_cache_serves_repeated_reads)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        insert_into_table(db, 100);
+        db->commit();
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        verify_table_contents(db, 100);
+        auto hits = db->heap().cache_hits();
+        auto misses = db->heap().cache_misses();
+        verify_table_contents(db, 100);
+        EXPECT(db->heap().cache_hits() > hits);
+        EXPECT_EQ(db->heap().cache_misses(), misses);
+    }
+}
+
+TEST_CASE(block_size_is_kept_in_zero_block)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db", 4 * KiB);
+        EXPECT_EQ(heap->block_size(), 4 * KiB);
+    }
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT_EQ(heap->block_size(), 4 * KiB);
+    }
+}
+
+TEST_CASE(insert_100_with_large_blocks_and_mapped_reads)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db", 16 * KiB, SQL::Heap::ReadMode::MappedFile);
+        setup_table(db);
+        db->commit();
+        insert_into_table(db, 100);
+        db->commit();
+        verify_table_contents(db, 100);
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db", SQL::Heap::default_block_size, SQL::Heap::ReadMode::MappedFile);
+        EXPECT_EQ(db->heap().block_size(), 16 * KiB);
+        verify_table_contents(db, 100);
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        verify_table_contents(db, 100);
+    }
+}
+
+// Runs the function in a child process, which then exits without destroying the database it returned, like a
+// crash would.
+static void run_and_crash(Function<NonnullRefPtr<SQL::Database>()> function)
+{
+    auto pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        auto db = function();
+        _exit(0);
+    }
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+}
+
+TEST_CASE(committed_rows_survive_a_crash)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    run_and_crash([] {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        insert_into_table(db, 20);
+        db->commit();
+        return db;
+    });
+    struct stat stat_buffer;
+    EXPECT_EQ(stat("/tmp/test.db-wal", &stat_buffer), 0);
+    EXPECT(stat_buffer.st_size > 0);
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        verify_table_contents(db, 20);
+    }
+    EXPECT_NE(stat("/tmp/test.db-wal", &stat_buffer), 0);
+}
+
+TEST_CASE(uncommitted_and_torn_writes_are_dropped)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    run_and_crash([] {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        insert_into_table(db, 10);
+        db->commit();
+        insert_into_table(db, 10);
+        return db;
+    });
+    {
+        // Half a block record, as a crash in the middle of a write would leave.
+        int fd = open("/tmp/test.db-wal", O_WRONLY | O_APPEND);
+        EXPECT(fd >= 0);
+        u32 record[] = { 0x4b4c4257, 1, 1024, 0 };
+        EXPECT_EQ(write(fd, record, sizeof(record)), (ssize_t)sizeof(record));
+        close(fd);
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        verify_table_contents(db, 10);
+    }
+}
+
+TEST_CASE(cursor_pipeline)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    auto db = SQL::Database::construct("/tmp/test.db");
+    setup_table(db);
+    insert_into_table(db, 100);
+    auto table = db->get_table("TestSchema", "TestTable");
+    EXPECT(table);
+
+    // Rows come out of the table newest first.
+    auto even = make<SQL::Filter>(db->scan(*table), [](auto& row) { return row["IntColumn"].to_int().value() % 2 == 0; });
+    auto projected = make<SQL::Project>(move(even), Vector<String> { "IntColumn" });
+    SQL::Limit cursor(move(projected), 5, 2);
+    int expected = 94;
+    for (auto row = cursor.next(); row.has_value(); row = cursor.next()) {
+        EXPECT_EQ(row->length(), 1u);
+        EXPECT_EQ(row.value()["IntColumn"].to_int().value(), expected);
+        expected -= 2;
+    }
+    EXPECT_EQ(expected, 84);
+
+    SQL::Key key(table->to_tuple_descriptor());
+    key["TextColumn"] = "Test42";
+    key["IntColumn"] = 42;
+    auto matches = db->match(*table, key);
+    EXPECT_EQ(matches.size(), 1u);
+}
+
+static SQL::Condition condition(String column, SQL::Condition::Operator op, int value)
+{
+    SQL::Value condition_value(SQL::SQLType::Integer);
+    condition_value = value;
+    return { move(column), op, condition_value };
+}
+
+static Vector<int> plan_and_collect(SQL::QueryPlan plan)
+{
+    Vector<int> values;
+    auto cursor = plan.open();
+    for (auto row = cursor->next(); row.has_value(); row = cursor->next())
+        values.append(row.value()["IntColumn"].to_int().value());
+    quick_sort(values);
+    return values;
+}
+
+TEST_CASE(planner_chooses_indexes_by_cost)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    auto db = SQL::Database::construct("/tmp/test.db");
+    setup_table(db);
+    insert_into_table(db, 200);
+    auto table = db->get_table("TestSchema", "TestTable");
+    EXPECT(table);
+
+    SQL::TupleDescriptor descriptor;
+    descriptor.append({ "IntColumn", SQL::SQLType::Integer, SQL::Order::Ascending });
+    auto tree = SQL::BTree::construct(db->heap(), descriptor, true, 0);
+    auto hash_index = SQL::HashIndex::construct(db->heap(), descriptor, db->heap().new_record_pointer());
+    auto cursor = db->scan(*table);
+    for (auto row = cursor->next(); row.has_value(); row = cursor->next()) {
+        SQL::Key key(descriptor);
+        key[0] = row.value()["IntColumn"];
+        key.set_pointer(row->pointer());
+        tree->insert(key);
+        hash_index->insert(key);
+    }
+
+    auto stats = SQL::IndexStatistics::of(*tree);
+    EXPECT_EQ(stats.entries, 200u);
+    EXPECT_EQ(stats.distinct_keys, 200u);
+    EXPECT_EQ(stats.minimum.value(), 0.0);
+    EXPECT_EQ(stats.maximum.value(), 199.0);
+
+    SQL::Planner no_indexes(db->heap(), *table);
+    auto scan = no_indexes.plan({ condition("IntColumn", SQL::Condition::Operator::Equals, 42) });
+    EXPECT_EQ(scan.access(), SQL::QueryPlan::Access::TableScan);
+    EXPECT_EQ(plan_and_collect(move(scan)), Vector<int> { 42 });
+
+    SQL::Planner planner(db->heap(), *table);
+    planner.add_index(*tree);
+    planner.add_index(*hash_index);
+    EXPECT_EQ(planner.estimated_rows(), 200u);
+
+    auto lookup = planner.plan({ condition("IntColumn", SQL::Condition::Operator::Equals, 42) });
+    EXPECT_EQ(lookup.access(), SQL::QueryPlan::Access::HashLookup);
+    EXPECT_EQ(lookup.explain(), "SEARCH TestTable USING HASH INDEX ON IntColumn (IntColumn = 42) (estimated cost 2)");
+    EXPECT_EQ(plan_and_collect(move(lookup)), Vector<int> { 42 });
+
+    auto range = planner.plan({ condition("IntColumn", SQL::Condition::Operator::GreaterThan, 10),
+        condition("IntColumn", SQL::Condition::Operator::LessThanOrEquals, 14) });
+    EXPECT_EQ(range.access(), SQL::QueryPlan::Access::IndexRangeScan);
+    EXPECT(range.explain().starts_with("SEARCH TestTable USING INDEX ON IntColumn (IntColumn > 10 AND IntColumn <= 14)"));
+    EXPECT_EQ(plan_and_collect(move(range)), (Vector<int> { 11, 12, 13, 14 }));
+
+    // A range covering nearly the whole table is cheaper to read by scanning it.
+    auto wide = planner.plan({ condition("IntColumn", SQL::Condition::Operator::GreaterThanOrEquals, 1) });
+    EXPECT_EQ(wide.access(), SQL::QueryPlan::Access::TableScan);
+    EXPECT(wide.explain().starts_with("SCAN TestTable WHERE IntColumn >= 1"));
+    EXPECT_EQ(plan_and_collect(move(wide)).size(), 199u);
+}
+
+TEST_CASE(rows_with_nulls_and_long_text)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    auto long_text = String::repeated('x', 100);
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        auto table = db->get_table("TestSchema", "TestTable");
+        SQL::Row null_int(*table);
+        null_int["TextColumn"] = long_text;
+        EXPECT(db->insert(null_int));
+        SQL::Row null_text(*table);
+        null_text["IntColumn"] = 42;
+        EXPECT(db->insert(null_text));
+        db->commit();
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        auto table = db->get_table("TestSchema", "TestTable");
+        auto rows = db->select_all(*table);
+        EXPECT_EQ(rows.size(), 2u);
+        // Rows come out of the table newest first.
+        EXPECT(rows[0]["TextColumn"].is_null());
+        EXPECT_EQ(rows[0]["IntColumn"].to_int().value(), 42);
+        EXPECT(rows[1]["IntColumn"].is_null());
+        EXPECT_EQ(rows[1]["TextColumn"].to_string().value(), long_text.substring(0, SQL::Tuple::max_text_length));
+    }
+}
+
+static int sum_of_int_column(SQL::Cursor& cursor, int& count)
+{
+    int sum = 0;
+    count = 0;
+    for (auto row = cursor.next(); row.has_value(); row = cursor.next()) {
+        sum += row.value()["IntColumn"].to_int().value();
+        count++;
+    }
+    return sum;
+}
+
+TEST_CASE(snapshot_keeps_what_was_committed)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    auto db = SQL::Database::construct("/tmp/test.db");
+    setup_table(db);
+    insert_into_table(db, 100);
+    auto table = db->get_table("TestSchema", "TestTable");
+    EXPECT(table);
+
+    auto snapshot = db->snapshot();
+    insert_into_table(db, 300);
+    db->checkpoint();
+    EXPECT(snapshot->preserved_blocks() > 0u);
+
+    int count = 0;
+    auto cursor = snapshot->scan(*table);
+    EXPECT_EQ(sum_of_int_column(*cursor, count), 99 * 100 / 2);
+    EXPECT_EQ(count, 100);
+
+    cursor = db->scan(*table);
+    EXPECT_EQ(sum_of_int_column(*cursor, count), 99 * 100 / 2 + 299 * 300 / 2);
+    EXPECT_EQ(count, 400);
+}
+
+TEST_CASE(snapshots_are_read_by_other_threads_while_writing)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    auto db = SQL::Database::construct("/tmp/test.db");
+    setup_table(db);
+    insert_into_table(db, 50);
+    auto table = db->get_table("TestSchema", "TestTable");
+    EXPECT(table);
+
+    NonnullRefPtrVector<Threading::Thread> readers;
+    Vector<int> sums;
+    sums.resize(4);
+    for (size_t ix = 0; ix < sums.size(); ix++) {
+        auto snapshot = db->snapshot();
+        auto expected_count = 50 + (int)ix * 20;
+        readers.append(Threading::Thread::construct([snapshot, table, &sums, ix, expected_count]() mutable -> intptr_t {
+            for (auto pass = 0; pass < 10; pass++) {
+                int count = 0;
+                auto cursor = snapshot->scan(*table);
+                sums[ix] = sum_of_int_column(*cursor, count);
+                if (count != expected_count)
+                    return 1;
+            }
+            return 0;
+        }));
+        readers.last().start();
+        insert_into_table(db, 20);
+        db->commit();
+    }
+    for (auto& reader : readers) {
+        auto result = reader.join<void*>();
+        EXPECT(!result.is_error());
+        EXPECT_EQ(result.value(), nullptr);
+    }
+    for (size_t ix = 0; ix < sums.size(); ix++)
+        EXPECT_EQ(sums[ix], 49 * 50 / 2 + (int)ix * (19 * 20 / 2));
+}
+
+TEST_CASE(heap_counts_its_work)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        setup_table(db);
+        insert_into_table(db, 100);
+        EXPECT_EQ(db->heap().commits(), 0u);
+        db->commit();
+        EXPECT_EQ(db->heap().commits(), 1u);
+        EXPECT(db->heap().wal_bytes_written() >= 100 * db->heap().block_size());
+        EXPECT_EQ(db->heap().blocks_written(), 0u);
+        db->checkpoint();
+        EXPECT_EQ(db->heap().checkpoints(), 1u);
+        EXPECT(db->heap().blocks_written() >= 100u);
+    }
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT_EQ(db->heap().blocks_written(), 0u);
+        verify_table_contents(db, 100);
+        EXPECT(db->heap().blocks_read() >= 100u);
+        EXPECT_EQ(db->heap().blocks_read(), db->heap().cache_misses());
+    }
+}
@@ -131,6 +131,15 @@ TEST_CASE(null_literal)
     validate("NULL");
 }
 
+TEST_CASE(placeholder)
+{
+    auto result = parse("?");
+    EXPECT(!result.is_error());
+    auto expression = result.release_value();
+    EXPECT(is<SQL::AST::Placeholder>(*expression));
+    EXPECT_EQ(static_cast<const SQL::AST::Placeholder&>(*expression).parameter_index(), 0u);
+}
+
 TEST_CASE(column_name)
 {
     EXPECT(parse(".column_name").is_error());
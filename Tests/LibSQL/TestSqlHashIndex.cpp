@@ -327,3 +327,34 @@ TEST_CASE(hash_index_scan_50_keys)
 {
     insert_into_and_scan_hash_index(50);
 }
+
+TEST_CASE(hash_index_directory_in_several_nodes)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    constexpr int num_keys = 3000;
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        auto hash_index = setup_hash_index(heap);
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(hash_index->descriptor());
+            k[0] = ix;
+            k[1] = String::formatted("Key {}", ix);
+            k.set_pointer(ix + 1);
+            hash_index->insert(k);
+        }
+        EXPECT(hash_index->size() > SQL::HashDirectoryNode::max_pointers_in_node(heap));
+        heap->checkpoint();
+    }
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        auto hash_index = setup_hash_index(heap);
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(hash_index->descriptor());
+            k[0] = ix;
+            k[1] = String::formatted("Key {}", ix);
+            auto pointer = hash_index->get(k);
+            EXPECT(pointer.has_value());
+            EXPECT_EQ(pointer.value_or(0), (u32)ix + 1);
+        }
+    }
+}
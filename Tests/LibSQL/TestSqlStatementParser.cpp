@@ -750,3 +750,21 @@ TEST_CASE(nested_subquery_limit)
     EXPECT(!parse(String::formatted("SELECT * FROM {};", subquery)).is_error());
     EXPECT(parse(String::formatted("SELECT * FROM ({});", subquery)).is_error());
 }
+
+TEST_CASE(placeholders)
+{
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer("INSERT INTO table_name VALUES (?, ?, 3); SELECT * FROM table_name WHERE column_name = ?;"));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+    EXPECT(is<SQL::AST::Insert>(*statement));
+    EXPECT_EQ(parser.placeholders_in_last_statement(), 2u);
+
+    auto const& insert = static_cast<const SQL::AST::Insert&>(*statement);
+    auto const& values = insert.chained_expressions()[0].expressions();
+    EXPECT_EQ(static_cast<const SQL::AST::Placeholder&>(values[0]).parameter_index(), 0u);
+    EXPECT_EQ(static_cast<const SQL::AST::Placeholder&>(values[1]).parameter_index(), 1u);
+
+    statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+    EXPECT_EQ(parser.placeholders_in_last_statement(), 1u);
+}
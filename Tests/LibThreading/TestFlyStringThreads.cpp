@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/FlyString.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Vector.h>
+#include <LibThreading/Thread.h>
+
+static constexpr size_t thread_count = 8;
+static constexpr size_t string_count = 2000;
+
+template<typename Callback>
+static void run_on_threads(Callback callback)
+{
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.append(Threading::Thread::construct([i, &callback] {
+            callback(i);
+            return 0;
+        }));
+    }
+    for (auto& thread : threads)
+        thread.start();
+    for (auto& thread : threads)
+        EXPECT(!thread.join().is_error());
+}
+
+TEST_CASE(concurrent_interning_gives_the_same_impl)
+{
+    Vector<Vector<FlyString>> interned_per_thread;
+    interned_per_thread.resize(thread_count);
+
+    run_on_threads([&](size_t thread_index) {
+        auto& interned = interned_per_thread[thread_index];
+        interned.ensure_capacity(string_count);
+        for (size_t i = 0; i < string_count; ++i)
+            interned.append(FlyString(String::formatted("concurrent_{}", i)));
+    });
+
+    for (size_t i = 0; i < string_count; ++i) {
+        auto* impl = interned_per_thread[0][i].impl();
+        for (size_t thread_index = 1; thread_index < thread_count; ++thread_index)
+            EXPECT_EQ(interned_per_thread[thread_index][i].impl(), impl);
+    }
+}
+
+TEST_CASE(concurrent_interning_and_destruction)
+{
+    // Every thread keeps interning and dropping the same few strings, so impls regularly die on one thread
+    // while another one looks them up.
+    run_on_threads([&](size_t) {
+        for (size_t round = 0; round < 200; ++round) {
+            for (size_t i = 0; i < 16; ++i) {
+                FlyString fly { String::formatted("short_lived_{}", i) };
+                EXPECT_EQ(fly.view(), String::formatted("short_lived_{}", i));
+            }
+        }
+    });
+}
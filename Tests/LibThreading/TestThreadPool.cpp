@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(submitted_jobs_all_run_before_destruction)
+{
+    Atomic<size_t> count { 0 };
+    {
+        auto pool = Threading::ThreadPool::construct(4u);
+        EXPECT_EQ(pool->worker_count(), 4u);
+        for (size_t i = 0; i < 1000; ++i)
+            pool->submit([&count] { count.fetch_add(1); });
+    }
+    EXPECT_EQ(count.load(), 1000u);
+}
+
+TEST_CASE(parallel_for_visits_every_element_once)
+{
+    auto pool = Threading::ThreadPool::construct(4u);
+    Vector<int> values;
+    for (int i = 0; i < 10000; ++i)
+        values.append(i);
+
+    pool->parallel_for(values.span(), [](int& value) { value *= 2; });
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(values[i], i * 2);
+
+    pool->parallel_for(values.span().trim(3), [](int& value) { value = -1; });
+    EXPECT_EQ(values[2], -1);
+    EXPECT_EQ(values[3], 6);
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    auto pool = Threading::ThreadPool::construct(2u);
+    Vector<Vector<int>> rows;
+    rows.resize(64);
+    for (auto& row : rows)
+        row.resize(100);
+
+    pool->parallel_for(rows.span(), [&](Vector<int>& row) {
+        pool->parallel_for(row.span(), [](int& value) { value = 1; });
+    });
+    for (auto& row : rows) {
+        for (auto value : row)
+            EXPECT_EQ(value, 1);
+    }
+}
+
+TEST_CASE(parallel_reduce_combines_in_order)
+{
+    auto pool = Threading::ThreadPool::construct(4u);
+    Vector<u64> values;
+    for (u64 i = 1; i <= 100000; ++i)
+        values.append(i);
+
+    auto sum = pool->parallel_reduce(
+        values.span(), static_cast<u64>(0),
+        [](u64 total, u64 value) { return total + value; },
+        [](u64 a, u64 b) { return a + b; });
+    EXPECT_EQ(sum, 100000ull * 100001ull / 2);
+
+    Vector<char> letters;
+    for (char c = 'a'; c <= 'z'; ++c)
+        letters.append(c);
+    auto concatenated = pool->parallel_reduce(
+        letters.span(), String::empty(),
+        [](String string, char c) { return String::formatted("{}{}", string, c); },
+        [](String a, String b) { return String::formatted("{}{}", a, b); });
+    EXPECT_EQ(concatenated, "abcdefghijklmnopqrstuvwxyz");
+
+    EXPECT_EQ(pool->parallel_reduce(Span<u64> {}, static_cast<u64>(42), [](u64 a, u64) { return a; }, [](u64 a, u64) { return a; }), 42u);
+}
+
+TEST_CASE(completion_runs_on_the_event_loop)
+{
+    Core::EventLoop loop;
+    auto pool = Threading::ThreadPool::construct(2u);
+    pool->submit<int>([] { return 42; }, [&](int result) {
+        EXPECT_EQ(result, 42);
+        loop.quit(result);
+    });
+    EXPECT_EQ(loop.exec(), 42);
+}
+
+TEST_CASE(parallel_sort)
+{
+    auto pool = Threading::ThreadPool::construct(3u);
+    Vector<String> values;
+    u32 state = 1;
+    for (int i = 0; i < 20000; ++i) {
+        state = state * 1103515245 + 12345;
+        values.append(String::number(state >> 8));
+    }
+
+    pool->parallel_sort(values.span(), [](auto& a, auto& b) { return a < b; });
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+
+    Threading::parallel_sort(values.span(), [](auto& a, auto& b) { return a > b; });
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] >= values[i]);
+}
@@ -34,6 +34,15 @@ TEST_CASE(to_unicode_lowercase)
     EXPECT_EQ(Unicode::to_unicode_lowercase(0x3401u), 0x3401u);
     EXPECT_EQ(Unicode::to_unicode_lowercase(0x3402u), 0x3402u);
     EXPECT_EQ(Unicode::to_unicode_lowercase(0x4dbfu), 0x4dbfu);
+    EXPECT_EQ(Unicode::to_unicode_lowercase(0x20000u), 0x20000u);
+    EXPECT_EQ(Unicode::to_unicode_lowercase(0x2a6ddu), 0x2a6ddu);
+
+    // Code points outside of the Basic Multilingual Plane
+    EXPECT_EQ(Unicode::to_unicode_lowercase(0x10400u), 0x10428u); // "𐐀" to "𐐨"
+
+    // Unassigned code points
+    EXPECT_EQ(Unicode::to_unicode_lowercase(0x0378u), 0x0378u);
+    EXPECT_EQ(Unicode::to_unicode_lowercase(0x10ffffu), 0x10ffffu);
 }
 
 TEST_CASE(to_unicode_uppercase)
@@ -48,6 +57,15 @@ TEST_CASE(to_unicode_uppercase)
     EXPECT_EQ(Unicode::to_unicode_uppercase(0x3401u), 0x3401u);
     EXPECT_EQ(Unicode::to_unicode_uppercase(0x3402u), 0x3402u);
     EXPECT_EQ(Unicode::to_unicode_uppercase(0x4dbfu), 0x4dbfu);
+    EXPECT_EQ(Unicode::to_unicode_uppercase(0x20000u), 0x20000u);
+    EXPECT_EQ(Unicode::to_unicode_uppercase(0x2a6ddu), 0x2a6ddu);
+
+    // Code points outside of the Basic Multilingual Plane
+    EXPECT_EQ(Unicode::to_unicode_uppercase(0x10428u), 0x10400u); // "𐐨" to "𐐀"
+
+    // Unassigned code points
+    EXPECT_EQ(Unicode::to_unicode_uppercase(0x0378u), 0x0378u);
+    EXPECT_EQ(Unicode::to_unicode_uppercase(0x10ffffu), 0x10ffffu);
 }
 
 TEST_CASE(to_unicode_lowercase_unconditional_special_casing)
@@ -6,12 +6,10 @@
 
 #include "Providers.h"
 #include "FuzzyMatch.h"
-#include <AK/LexicalPath.h>
 #include <AK/URL.h>
-#include <LibCore/DirIterator.h>
-#include <LibCore/ElapsedTimer.h>
 #include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
+#include <LibDesktop/FileIndex.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Clipboard.h>
 #include <LibGUI/FileIconProvider.h>
@@ -120,88 +118,21 @@ Gfx::Bitmap const* FileResult::bitmap() const
     return GUI::FileIconProvider::icon_for_path(title()).bitmap_for_size(16);
 }
 
-FileProvider::FileProvider()
-{
-    build_filesystem_cache();
-}
-
 void FileProvider::query(const String& query, Function<void(NonnullRefPtrVector<Result>)> on_complete)
 {
-    build_filesystem_cache();
-
-    if (m_fuzzy_match_work)
-        m_fuzzy_match_work->cancel();
-
-    m_fuzzy_match_work = Threading::BackgroundAction<NonnullRefPtrVector<Result>>::create(
-        [this, query](auto& task) {
-            NonnullRefPtrVector<Result> results;
-
-            for (auto& path : m_full_path_cache) {
-                if (task.is_cancelled())
-                    return results;
-
-                auto match_result = fuzzy_match(query, path);
-                if (!match_result.matched)
-                    continue;
-                if (match_result.score < 0)
-                    continue;
-
-                results.append(adopt_ref(*new FileResult(path, match_result.score)));
-            }
-            return results;
-        },
-        [on_complete = move(on_complete)](auto results) {
-            on_complete(move(results));
-        });
-}
-
-void FileProvider::build_filesystem_cache()
-{
-    if (m_full_path_cache.size() > 0 || m_building_cache)
+    // IndexServer only knows about names that contain the query, which are then ranked the same way as everything else.
+    auto paths = Desktop::FileIndex::search(query, {}, max_indexed_results);
+    if (!paths.has_value())
         return;
 
-    m_building_cache = true;
-    m_work_queue.enqueue("/");
-
-    Threading::BackgroundAction<int>::create(
-        [this](auto&) {
-            String slash = "/";
-            Core::ElapsedTimer timer;
-            timer.start();
-            while (!m_work_queue.is_empty()) {
-                auto base_directory = m_work_queue.dequeue();
-
-                if (base_directory.template is_one_of("/dev"sv, "/proc"sv, "/sys"sv))
-                    continue;
-
-                Core::DirIterator di(base_directory, Core::DirIterator::SkipDots);
-
-                while (di.has_next()) {
-                    auto path = di.next_path();
-                    struct stat st = {};
-                    if (fstatat(di.fd(), path.characters(), &st, AT_SYMLINK_NOFOLLOW) < 0) {
-                        perror("fstatat");
-                        continue;
-                    }
-
-                    if (S_ISLNK(st.st_mode))
-                        continue;
-
-                    auto full_path = LexicalPath::join(slash, base_directory, path).string();
-
-                    m_full_path_cache.append(full_path);
-
-                    if (S_ISDIR(st.st_mode)) {
-                        m_work_queue.enqueue(full_path);
-                    }
-                }
-            }
-            dbgln("Built cache in {} ms", timer.elapsed());
-            return 0;
-        },
-        [this](auto) {
-            m_building_cache = false;
-        });
+    NonnullRefPtrVector<Result> results;
+    for (auto& path : paths.value()) {
+        auto match_result = fuzzy_match(query, path);
+        if (!match_result.matched || match_result.score < 0)
+            continue;
+        results.append(adopt_ref(*new FileResult(path, match_result.score)));
+    }
+    on_complete(move(results));
 }
 
 void TerminalProvider::query(String const& query, Function<void(NonnullRefPtrVector<Result>)> on_complete)
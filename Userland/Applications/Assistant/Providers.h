@@ -6,14 +6,12 @@
 
 #pragma once
 
-#include <AK/Queue.h>
 #include <AK/String.h>
 #include <AK/URL.h>
 #include <LibDesktop/AppFile.h>
 #include <LibGUI/Desktop.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/VM.h>
-#include <LibThreading/BackgroundAction.h>
 #include <typeinfo>
 
 namespace Assistant {
@@ -147,16 +145,10 @@ public:
 
 class FileProvider final : public Provider {
 public:
-    FileProvider();
-
     void query(String const& query, Function<void(NonnullRefPtrVector<Result>)> on_complete) override;
-    void build_filesystem_cache();
 
 private:
-    RefPtr<Threading::BackgroundAction<NonnullRefPtrVector<Result>>> m_fuzzy_match_work;
-    bool m_building_cache { false };
-    Vector<String> m_full_path_cache;
-    Queue<String> m_work_queue;
+    static constexpr size_t max_indexed_results = 200;
 };
 
 class TerminalProvider final : public Provider {
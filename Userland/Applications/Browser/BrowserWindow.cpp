@@ -388,6 +388,7 @@ void BrowserWindow::build_menus()
                 for (auto& sheet : tab.m_page_view->document()->style_sheets().sheets()) {
                     Web::dump_sheet(sheet);
                 }
+                dbgln("Selector match attempts: {}", tab.m_page_view->document()->style_resolver().selector_match_attempts());
             } else {
                 tab.m_web_content_view->debug_request("dump-style-sheets");
             }
@@ -14,6 +14,7 @@
 #include <LibGUI/CheckBox.h>
 #include <LibGUI/FileIconProvider.h>
 #include <LibGUI/FilePicker.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/IconView.h>
 #include <LibGUI/LinkLabel.h>
 #include <LibGUI/MessageBox.h>
@@ -39,7 +40,7 @@ PropertiesWindow::PropertiesWindow(String const& path, bool disable_rename, Wind
     set_rect({ 0, 0, 360, 420 });
     set_resizable(false);
 
-    set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/properties.png"));
+    set_icon(GUI::IconCache::load_bitmap("/res/icons/16x16/properties.png"));
 
     auto& tab_widget = main_widget.add<GUI::TabWidget>();
 
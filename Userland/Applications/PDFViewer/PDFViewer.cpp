@@ -8,6 +8,7 @@
 #include <LibGUI/Action.h>
 #include <LibGUI/Painter.h>
 #include <LibPDF/Renderer.h>
+#include <LibThreading/BackgroundAction.h>
 
 static constexpr int PAGE_PADDING = 25;
 
@@ -41,9 +42,23 @@ RefPtr<Gfx::Bitmap> PDFViewer::get_rendered_page(u32 index)
     if (existing_rendered_page.has_value())
         return existing_rendered_page.value();
 
-    auto rendered_page = render_page(m_document->get_page(index));
-    rendered_page_map.set(m_zoom_level, rendered_page);
-    return rendered_page;
+    rendered_page_map.set(m_zoom_level, nullptr);
+    auto document = m_document;
+    auto zoom_level = m_zoom_level;
+    auto available_height = height() - 2 * frame_thickness() - PAGE_PADDING * 2;
+    Threading::BackgroundAction<RefPtr<Gfx::Bitmap>>::create(
+        [document, index, available_height, zoom_level](auto&) mutable {
+            return render_page(*document, index, available_height, zoom_level);
+        },
+        [this, document, index, zoom_level](auto rendered_page) {
+            // The document may have been replaced while we were rendering.
+            if (m_document != document)
+                return;
+            m_rendered_page_list[index].set(zoom_level, move(rendered_page));
+            if (index == m_current_page_index && zoom_level == m_zoom_level)
+                update();
+        });
+    return nullptr;
 }
 
 void PDFViewer::paint_event(GUI::PaintEvent& event)
@@ -59,6 +74,8 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
         return;
 
     auto page = get_rendered_page(m_current_page_index);
+    if (!page)
+        return;
     set_content_size(page->size());
 
     painter.translate(frame_thickness(), frame_thickness());
@@ -116,10 +133,19 @@ void PDFViewer::mousewheel_event(GUI::MouseEvent& event)
 
 void PDFViewer::timer_event(Core::TimerEvent&)
 {
-    // Clear the bitmap vector of all pages except the current page
+    // Clear the bitmap vector of all pages except the current page. Pages that are still being
+    // rendered keep their placeholder, so that they aren't rendered twice.
     for (size_t i = 0; i < m_rendered_page_list.size(); i++) {
-        if (i != m_current_page_index)
-            m_rendered_page_list[i].clear();
+        if (i == m_current_page_index)
+            continue;
+        auto& rendered_page_map = m_rendered_page_list[i];
+        Vector<u32> finished_zoom_levels;
+        for (auto& it : rendered_page_map) {
+            if (it.value)
+                finished_zoom_levels.append(it.key);
+        }
+        for (auto zoom_level : finished_zoom_levels)
+            rendered_page_map.remove(zoom_level);
     }
 }
 
@@ -135,19 +161,20 @@ void PDFViewer::zoom_out()
         m_zoom_level--;
 }
 
-RefPtr<Gfx::Bitmap> PDFViewer::render_page(const PDF::Page& page)
+RefPtr<Gfx::Bitmap> PDFViewer::render_page(PDF::Document& document, u32 index, int available_height, u8 zoom_level)
 {
-    auto zoom_scale_factor = static_cast<float>(zoom_levels[m_zoom_level]) / 100.0f;
+    auto page = document.get_page(index);
+    auto zoom_scale_factor = static_cast<float>(zoom_levels[zoom_level]) / 100.0f;
 
     auto page_width = page.media_box.upper_right_x - page.media_box.lower_left_x;
     auto page_height = page.media_box.upper_right_y - page.media_box.lower_left_y;
     auto page_scale_factor = page_height / page_width;
 
-    auto height = static_cast<float>(this->height() - 2 * frame_thickness() - PAGE_PADDING * 2) * zoom_scale_factor;
+    auto height = static_cast<float>(available_height) * zoom_scale_factor;
     auto width = height / page_scale_factor;
     auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { width, height });
 
-    PDF::Renderer::render(*m_document, page, bitmap);
+    PDF::Renderer::render(document, page, bitmap);
 
     if (page.rotate != 0) {
         int rotation_count = (page.rotate / 90) % 4;
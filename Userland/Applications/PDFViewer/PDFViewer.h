@@ -57,14 +57,17 @@ protected:
     virtual void timer_event(Core::TimerEvent&) override;
 
 private:
+    // Returns null while the page is still being rendered, and repaints once it's done.
     RefPtr<Gfx::Bitmap> get_rendered_page(u32 index);
-    RefPtr<Gfx::Bitmap> render_page(const PDF::Page&);
+    static RefPtr<Gfx::Bitmap> render_page(PDF::Document&, u32 index, int available_height, u8 zoom_level);
 
     void zoom_in();
     void zoom_out();
 
     RefPtr<PDF::Document> m_document;
     u32 m_current_page_index { 0 };
+    // Pages are rendered on the background thread, which also gets to do all the parsing of the document. A
+    // null bitmap marks a page that is still being rendered at that zoom level.
     Vector<HashMap<u32, RefPtr<Gfx::Bitmap>>> m_rendered_page_list;
 
     u8 m_zoom_level { initial_zoom_level };
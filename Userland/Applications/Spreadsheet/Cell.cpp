@@ -94,6 +94,10 @@ void Cell::update_data(Badge<Sheet>)
 
     if (m_dirty) {
         m_dirty = false;
+        // Whatever this reads gets referenced again while evaluating it, so references that the formula has dropped
+        // since don't keep causing updates. The cells referencing this one are left to the sheet to update.
+        if (!m_evaluated_externally)
+            forget_referenced_cells();
         if (m_kind == Formula) {
             if (!m_evaluated_externally) {
                 auto [value, exception] = m_sheet->evaluate(m_data, this);
@@ -101,13 +105,6 @@ void Cell::update_data(Badge<Sheet>)
                 m_js_exception = move(exception);
             }
         }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
-        }
     }
 
     m_evaluated_formats.background_color.clear();
@@ -166,6 +163,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::forget_referenced_cells()
+{
+    for (auto& cell : m_referenced_cells) {
+        if (cell)
+            cell->m_referencing_cells.remove_first_matching([this](auto& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(const Cell& other)
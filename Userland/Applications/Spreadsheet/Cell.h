@@ -47,6 +47,7 @@ struct Cell : public Weakable<Cell> {
     void set_data(String new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void mark_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
 
     void set_exception(JS::Exception* exc) { m_js_exception = exc; }
@@ -99,6 +100,8 @@ struct Cell : public Weakable<Cell> {
     void copy_from(const Cell&);
 
 private:
+    void forget_referenced_cells();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
     String m_data;
@@ -107,6 +110,8 @@ private:
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    // The cells this one read when it was last evaluated, which all have it among their referencing cells.
+    Vector<WeakPtr<Cell>> m_referenced_cells;
     const CellType* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
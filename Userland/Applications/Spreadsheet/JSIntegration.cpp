@@ -101,7 +101,7 @@ SheetGlobalObject::~SheetGlobalObject()
 {
 }
 
-JS::Value SheetGlobalObject::internal_get(const JS::PropertyName& property_name, JS::Value receiver) const
+JS::Value SheetGlobalObject::internal_get(const JS::PropertyName& property_name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (property_name.is_string()) {
         if (property_name.as_string() == "value") {
@@ -120,7 +120,7 @@ JS::Value SheetGlobalObject::internal_get(const JS::PropertyName& property_name,
     return Base::internal_get(property_name, receiver);
 }
 
-bool SheetGlobalObject::internal_set(const JS::PropertyName& property_name, JS::Value value, JS::Value receiver)
+bool SheetGlobalObject::internal_set(const JS::PropertyName& property_name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     if (property_name.is_string()) {
         if (auto pos = m_sheet.parse_cell_name(property_name.as_string()); pos.has_value()) {
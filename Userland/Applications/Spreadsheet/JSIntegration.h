@@ -26,8 +26,8 @@ public:
 
     virtual ~SheetGlobalObject() override;
 
-    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver) const override;
-    virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) const override;
+    virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) override;
     virtual void initialize_global_object() override;
 
     JS_DECLARE_NATIVE_FUNCTION(get_real_cell_contents);
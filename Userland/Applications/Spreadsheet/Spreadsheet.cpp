@@ -115,18 +115,66 @@ void Sheet::update()
         return;
     }
     m_visited_cells_in_update.clear();
-    Vector<Cell&> cells_copy;
 
-    // Grab a copy as updates might insert cells into the table.
+    // Everything that references a dirty cell, directly or not, has to be evaluated again. Each of those gets
+    // evaluated once, after everything it references, rather than by following references cell by cell.
+    Vector<Cell*> cells_to_update;
+    HashMap<Cell*, size_t> pending_reference_counts;
     for (auto& it : m_cells) {
         if (it.value->dirty()) {
-            cells_copy.append(*it.value);
+            cells_to_update.append(it.value.ptr());
+            pending_reference_counts.set(it.value.ptr(), 0);
             m_workbook.set_dirty(true);
         }
     }
+    for (size_t i = 0; i < cells_to_update.size(); ++i) {
+        for (auto& referencing_cell : cells_to_update[i]->referencing_cells()) {
+            if (!referencing_cell)
+                continue;
+            if (pending_reference_counts.set(referencing_cell.ptr(), 0) == AK::HashSetResult::InsertedNewEntry)
+                cells_to_update.append(referencing_cell.ptr());
+        }
+    }
+    for (auto* cell : cells_to_update) {
+        cell->mark_dirty();
+        for (auto& referencing_cell : cell->referencing_cells()) {
+            if (referencing_cell)
+                ++pending_reference_counts.find(referencing_cell.ptr())->value;
+        }
+    }
+
+    Vector<Cell*> ready_cells;
+    for (auto* cell : cells_to_update) {
+        if (pending_reference_counts.get(cell).value() == 0)
+            ready_cells.append(cell);
+    }
 
-    for (auto& cell : cells_copy)
-        update(cell);
+    HashTable<Cell*> updated_cells;
+    size_t next_cell_in_cycle = 0;
+    while (updated_cells.size() < cells_to_update.size()) {
+        if (ready_cells.is_empty()) {
+            // What's left references itself, or its references have changed while evaluating; either way, there's no
+            // order that works, so just go through them in the order they were found in.
+            while (updated_cells.contains(cells_to_update[next_cell_in_cycle]))
+                ++next_cell_in_cycle;
+            ready_cells.append(cells_to_update[next_cell_in_cycle]);
+        }
+
+        auto* cell = ready_cells.take_last();
+        if (updated_cells.set(cell) != AK::HashSetResult::InsertedNewEntry)
+            continue;
+        cell->update();
+
+        for (auto& referencing_cell : cell->referencing_cells()) {
+            if (!referencing_cell)
+                continue;
+            auto it = pending_reference_counts.find(referencing_cell.ptr());
+            if (it == pending_reference_counts.end() || it->value == 0)
+                continue;
+            if (--it->value == 0 && !updated_cells.contains(referencing_cell.ptr()))
+                ready_cells.append(referencing_cell.ptr());
+        }
+    }
 
     m_visited_cells_in_update.clear();
 }
@@ -11,6 +11,7 @@
 #include <LibGUI/ImageWidget.h>
 #include <LibGUI/Window.h>
 #include <LibGfx/Bitmap.h>
+#include <LibThreading/BackgroundAction.h>
 #include <LibVideo/MatroskaReader.h>
 #include <LibVideo/VP9/Decoder.h>
 
@@ -35,21 +36,35 @@ int main(int argc, char** argv)
     image_widget.set_fixed_size(video_track.pixel_height, video_track.pixel_width);
     main_widget.add_child(image_widget);
 
-    Video::VP9::Decoder vp9_decoder;
-    for (auto const& cluster : document->clusters()) {
-        for (auto const& block : cluster.blocks()) {
-            if (block.track_number() != track.track_number())
-                continue;
+    // Decode on the background thread, so that the window doesn't have to wait for the whole video.
+    auto track_number = track.track_number();
+    auto decode_action = Threading::BackgroundAction<bool>::create(
+        [document = move(document), track_number](auto& action) mutable {
+            Video::VP9::Decoder vp9_decoder;
+            for (auto const& cluster : document->clusters()) {
+                for (auto const& block : cluster.blocks()) {
+                    if (action.is_cancelled())
+                        return true;
+                    if (block.track_number() != track_number)
+                        continue;
 
-            auto const& frame = block.frame(0);
-            dbgln("Reading frame 0 from block @ {}", block.timestamp());
-            bool failed = !vp9_decoder.decode_frame(frame);
-            vp9_decoder.dump_frame_info();
-            if (failed)
-                return 1;
-        }
-    }
+                    auto const& frame = block.frame(0);
+                    dbgln("Reading frame 0 from block @ {}", block.timestamp());
+                    bool failed = !vp9_decoder.decode_frame(frame);
+                    vp9_decoder.dump_frame_info();
+                    if (failed)
+                        return false;
+                }
+            }
+            return true;
+        },
+        [&](bool succeeded) {
+            if (!succeeded)
+                app->quit(1);
+        });
 
     window->show();
-    return app->exec();
+    auto exit_code = app->exec();
+    decode_action->cancel();
+    return exit_code;
 }
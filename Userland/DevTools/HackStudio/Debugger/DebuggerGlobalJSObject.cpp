@@ -21,7 +21,7 @@ DebuggerGlobalJSObject::DebuggerGlobalJSObject()
     m_variables = lib->debug_info->get_variables_in_current_scope(regs);
 }
 
-JS::Value DebuggerGlobalJSObject::internal_get(JS::PropertyName const& property_name, JS::Value receiver) const
+JS::Value DebuggerGlobalJSObject::internal_get(JS::PropertyName const& property_name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (m_variables.is_empty() || !property_name.is_string())
         return Base::internal_get(property_name, receiver);
@@ -40,7 +40,7 @@ JS::Value DebuggerGlobalJSObject::internal_get(JS::PropertyName const& property_
     return {};
 }
 
-bool DebuggerGlobalJSObject::internal_set(JS::PropertyName const& property_name, JS::Value value, JS::Value receiver)
+bool DebuggerGlobalJSObject::internal_set(JS::PropertyName const& property_name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     if (m_variables.is_empty() || !property_name.is_string())
         return Base::internal_set(property_name, value, receiver);
@@ -20,8 +20,8 @@ class DebuggerGlobalJSObject final
 public:
     DebuggerGlobalJSObject();
 
-    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver) const override;
-    virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) const override;
+    virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) override;
 
     Optional<JS::Value> debugger_to_js(const Debug::DebugInfo::VariableInfo&) const;
     Optional<u32> js_to_debugger(JS::Value value, const Debug::DebugInfo::VariableInfo&) const;
@@ -24,7 +24,7 @@ public:
 
     virtual const char* class_name() const override { return m_variable_info.type_name.characters(); }
 
-    bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) override;
 
 private:
     DebuggerGlobalJSObject& debugger_object() const;
@@ -41,6 +41,7 @@ void ClientConnection::greet(String const& project_root)
         perror("unveil");
         exit(1);
     }
+    m_autocomplete_engine->project_opened();
 }
 
 void ClientConnection::file_opened(String const& filename, IPC::File const& file)
@@ -33,7 +33,7 @@ void CodeComprehensionEngine::set_declarations_of_document(const String& filenam
     set_declarations_of_document_callback(filename, move(declarations));
 }
 
-void CodeComprehensionEngine::set_todo_entries_of_document(String const& filename, Vector<Cpp::Parser::TodoEntry>&& todo_entries)
+void CodeComprehensionEngine::set_todo_entries_of_document(String const& filename, Vector<::Cpp::Parser::TodoEntry>&& todo_entries)
 {
     // Callback may not be configured if we're running tests
     if (!set_todo_entries_of_document_callback)
@@ -25,6 +25,8 @@ public:
     // TODO: In the future we can pass the range that was edited and only re-parse what we have to.
     virtual void on_edit([[maybe_unused]] const String& file) {};
     virtual void file_opened([[maybe_unused]] const String& file) {};
+    // Called once the project root is known.
+    virtual void project_opened() {};
 
     virtual Optional<GUI::AutocompleteProvider::ProjectLocation> find_declaration_of(const String&, const GUI::TextPosition&) { return {}; }
 
@@ -36,12 +38,12 @@ public:
 
 public:
     Function<void(const String&, Vector<GUI::AutocompleteProvider::Declaration>&&)> set_declarations_of_document_callback;
-    Function<void(String const&, Vector<Cpp::Parser::TodoEntry>&&)> set_todo_entries_of_document_callback;
+    Function<void(String const&, Vector<::Cpp::Parser::TodoEntry>&&)> set_todo_entries_of_document_callback;
 
 protected:
     const FileDB& filedb() const { return m_filedb; }
     void set_declarations_of_document(const String&, Vector<GUI::AutocompleteProvider::Declaration>&&);
-    void set_todo_entries_of_document(String const&, Vector<Cpp::Parser::TodoEntry>&&);
+    void set_todo_entries_of_document(String const&, Vector<::Cpp::Parser::TodoEntry>&&);
     const HashMap<String, Vector<GUI::AutocompleteProvider::Declaration>>& all_declarations() const { return m_all_declarations; }
 
 private:
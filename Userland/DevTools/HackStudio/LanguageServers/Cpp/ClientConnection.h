@@ -15,10 +15,12 @@ class ClientConnection final : public LanguageServers::ClientConnection {
     C_OBJECT(ClientConnection);
 
 public:
-    ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id)
+    ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id, RefPtr<DeclarationIndex> declaration_index)
         : LanguageServers::ClientConnection(move(socket), client_id)
     {
-        m_autocomplete_engine = make<CppComprehensionEngine>(m_filedb);
+        auto engine = make<CppComprehensionEngine>(m_filedb);
+        engine->set_declaration_index(move(declaration_index));
+        m_autocomplete_engine = move(engine);
         m_autocomplete_engine->set_declarations_of_document_callback = [this](const String& filename, Vector<GUI::AutocompleteProvider::Declaration>&& declarations) {
             async_declarations_in_document(filename, move(declarations));
         };
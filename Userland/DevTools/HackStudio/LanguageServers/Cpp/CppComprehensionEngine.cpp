@@ -27,7 +27,7 @@ CppComprehensionEngine::CppComprehensionEngine(const FileDB& filedb)
 const CppComprehensionEngine::DocumentData* CppComprehensionEngine::get_or_create_document_data(const String& file)
 {
     auto absolute_path = filedb().to_absolute_path(file);
-    if (!m_documents.contains(absolute_path)) {
+    if (!m_documents.contains(absolute_path) || m_stale_documents.remove(absolute_path)) {
         set_document_data(absolute_path, create_document_data_for(absolute_path));
     }
     return get_document_data(absolute_path);
@@ -380,7 +380,26 @@ String CppComprehensionEngine::document_path_from_include_path(const StringView&
 
 void CppComprehensionEngine::on_edit(const String& file)
 {
-    set_document_data(file, create_document_data_for(file));
+    auto absolute_path = filedb().to_absolute_path(file);
+    auto document = filedb().get_or_create_from_filesystem(file);
+    if (!document) {
+        set_document_data(file, nullptr);
+        return;
+    }
+
+    auto text = document->text();
+    auto* document_data = get_document_data(absolute_path);
+    if (document_data && document_data->text() == text && !m_stale_documents.contains(absolute_path))
+        return;
+
+    // Whatever includes this was parsed with what it used to say, so it has to be parsed again the next time it's needed.
+    for (auto& it : m_documents) {
+        if (it.value && it.value->m_available_headers.contains(absolute_path))
+            m_stale_documents.set(it.key);
+    }
+    m_stale_documents.remove(absolute_path);
+
+    set_document_data(file, create_document_data(move(text), file));
 }
 
 void CppComprehensionEngine::file_opened([[maybe_unused]] const String& file)
@@ -388,6 +407,67 @@ void CppComprehensionEngine::file_opened([[maybe_unused]] const String& file)
     get_or_create_document_data(file);
 }
 
+void CppComprehensionEngine::project_opened()
+{
+    if (!m_declaration_index || filedb().project_root().is_null())
+        return;
+
+    m_directories_to_index.enqueue(filedb().project_root());
+    if (!m_indexing_timer)
+        m_indexing_timer = Core::Timer::create_repeating(0, [this] { index_next_file(); });
+    m_indexing_timer->start();
+}
+
+void CppComprehensionEngine::index_next_file()
+{
+    // Only one file at a time, so that requests from the editor never have to wait for much more than one file to be parsed.
+    while (m_files_to_index.is_empty() && !m_directories_to_index.is_empty()) {
+        auto directory = m_directories_to_index.dequeue();
+        // Hidden directories (like .git) don't have anything worth indexing.
+        Core::DirIterator iterator(directory, Core::DirIterator::SkipDots);
+        while (iterator.has_next()) {
+            auto path = iterator.next_full_path();
+            auto type = iterator.last_type();
+            if (type == DT_DIR || (type == DT_UNKNOWN && Core::File::is_directory(path)))
+                m_directories_to_index.enqueue(move(path));
+            else if (path.ends_with(".h") || path.ends_with(".cpp"))
+                m_files_to_index.enqueue(move(path));
+        }
+    }
+
+    if (m_files_to_index.is_empty()) {
+        dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "Finished indexing {}", filedb().project_root());
+        m_indexing_timer->stop();
+        m_declaration_index->flush();
+        return;
+    }
+    index_file(m_files_to_index.dequeue());
+}
+
+void CppComprehensionEngine::index_file(const String& path)
+{
+    // Whatever has been parsed is in the index already.
+    if (m_documents.contains(path))
+        return;
+
+    auto file_or_error = Core::File::open(path, Core::OpenMode::ReadOnly);
+    if (file_or_error.is_error())
+        return;
+    auto text = file_or_error.value()->read_all();
+    auto declarations = m_declaration_index->declarations_of(path, DeclarationIndex::hash_of(StringView { text }));
+    if (declarations.has_value()) {
+        set_declarations_of_document(path, declarations.release_value());
+        return;
+    }
+
+    dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "Indexing {}", path);
+    get_or_create_document_data(path);
+    // Headers are likely to be included by whatever gets opened next, so they're kept around. Nobody is going to need
+    // the document of a source file until it's opened though.
+    if (!path.ends_with(".h") && !filedb().is_open(path))
+        m_documents.remove(path);
+}
+
 Optional<GUI::AutocompleteProvider::ProjectLocation> CppComprehensionEngine::find_declaration_of(const String& filename, const GUI::TextPosition& identifier_position)
 {
     const auto* document_ptr = get_or_create_document_data(filename);
@@ -404,7 +484,25 @@ Optional<GUI::AutocompleteProvider::ProjectLocation> CppComprehensionEngine::fin
     if (decl)
         return GUI::AutocompleteProvider::ProjectLocation { decl->filename(), decl->start().line, decl->start().column };
 
-    return find_preprocessor_definition(document, identifier_position);
+    if (auto location = find_preprocessor_definition(document, identifier_position); location.has_value())
+        return location;
+    return find_declaration_in_project(*node);
+}
+
+Optional<GUI::AutocompleteProvider::ProjectLocation> CppComprehensionEngine::find_declaration_in_project(const ASTNode& node) const
+{
+    // This is a last resort for symbols that aren't declared in anything the document includes, say, a function that is
+    // defined in another source file. All that's known about them is their name, so the first one that fits has to do.
+    if (!node.is_identifier())
+        return {};
+    auto name = static_cast<const Identifier&>(node).name();
+    for (auto& it : all_declarations()) {
+        for (auto& declaration : it.value) {
+            if (declaration.name == name && declaration.type != GUI::AutocompleteProvider::DeclarationType::PreprocessorDefinition)
+                return declaration.position;
+        }
+    }
+    return {};
 }
 
 Optional<GUI::AutocompleteProvider::ProjectLocation> CppComprehensionEngine::find_preprocessor_definition(const DocumentData& document, const GUI::TextPosition& text_position)
@@ -536,6 +634,8 @@ void CppComprehensionEngine::update_declared_symbols(DocumentData& document)
     for (auto& definition : document.preprocessor().definitions()) {
         declarations.append({ definition.key, { document.filename(), definition.value.line, definition.value.column }, GUI::AutocompleteProvider::DeclarationType::PreprocessorDefinition, {} });
     }
+    if (m_declaration_index)
+        m_declaration_index->set_declarations_of(filedb().to_absolute_path(document.filename()), DeclarationIndex::hash_of(document.text()), declarations);
     set_declarations_of_document(document.filename(), move(declarations));
 }
 
@@ -581,7 +681,7 @@ OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_docu
         if (!included_document)
             continue;
 
-        document_data->m_available_headers.set(include_fullpath);
+        document_data->m_available_headers.set(filedb().to_absolute_path(include_fullpath));
 
         for (auto& header : included_document->m_available_headers)
             document_data->m_available_headers.set(header);
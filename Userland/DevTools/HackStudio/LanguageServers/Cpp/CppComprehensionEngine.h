@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "DeclarationIndex.h"
 #include <AK/Function.h>
+#include <AK/Queue.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <DevTools/HackStudio/AutoCompleteResponse.h>
@@ -28,9 +30,13 @@ public:
     virtual Vector<GUI::AutocompleteProvider::Entry> get_suggestions(const String& file, const GUI::TextPosition& autocomplete_position) override;
     virtual void on_edit(const String& file) override;
     virtual void file_opened([[maybe_unused]] const String& file) override;
+    virtual void project_opened() override;
     virtual Optional<GUI::AutocompleteProvider::ProjectLocation> find_declaration_of(const String& filename, const GUI::TextPosition& identifier_position) override;
     virtual Optional<FunctionParamsHint> get_function_params_hint(const String&, const GUI::TextPosition&) override;
 
+    // Without an index, nothing gets indexed in the background, and the declarations of every file are found by parsing it.
+    void set_declaration_index(RefPtr<DeclarationIndex> index) { m_declaration_index = move(index); }
+
 private:
     struct SymbolName {
         StringView name;
@@ -125,6 +131,10 @@ private:
     Vector<StringView> scope_of_reference_to_symbol(const ASTNode&) const;
 
     Optional<GUI::AutocompleteProvider::ProjectLocation> find_preprocessor_definition(const DocumentData&, const GUI::TextPosition&);
+    Optional<GUI::AutocompleteProvider::ProjectLocation> find_declaration_in_project(const ASTNode&) const;
+
+    void index_next_file();
+    void index_file(const String& path);
 
     OwnPtr<DocumentData> create_document_data(String&& text, const String& filename);
     Optional<Vector<GUI::AutocompleteProvider::Entry>> try_autocomplete_property(const DocumentData&, const ASTNode&, Optional<Token> containing_token) const;
@@ -140,6 +150,14 @@ private:
     void for_each_included_document_recursive(const DocumentData&, Func) const;
 
     HashMap<String, OwnPtr<DocumentData>> m_documents;
+    // Documents that include a header which has been edited since they were parsed.
+    HashTable<String> m_stale_documents;
+
+    RefPtr<DeclarationIndex> m_declaration_index;
+    // The parts of the project that are still waiting to be indexed in the background.
+    Queue<String> m_directories_to_index;
+    Queue<String> m_files_to_index;
+    RefPtr<Core::Timer> m_indexing_timer;
 };
 
 template<typename Func>
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "DeclarationIndex.h"
+#include <AK/Debug.h>
+#include <AK/MappedFile.h>
+#include <AK/MemoryStream.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace LanguageServers::Cpp {
+
+static constexpr u32 index_file_magic = 0x58444443; // "CDDX"
+static constexpr u32 index_file_version = 1;
+static constexpr int save_delay_ms = 5000;
+
+DeclarationIndex::DeclarationIndex(String index_path)
+    : m_index_path(move(index_path))
+{
+    m_save_timer = Core::Timer::create_single_shot(save_delay_ms, [this] { flush(); }, this);
+    if (!load())
+        m_entries.clear();
+}
+
+DeclarationIndex::~DeclarationIndex()
+{
+}
+
+u64 DeclarationIndex::hash_of(StringView text)
+{
+    if (text.ends_with('\n'))
+        text = text.substring_view(0, text.length() - 1);
+
+    // FNV-1a, which is plenty to tell whether a file has changed.
+    u64 hash = 0xcbf29ce484222325;
+    for (u8 byte : text.bytes()) {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+Optional<Vector<GUI::AutocompleteProvider::Declaration>> DeclarationIndex::declarations_of(String const& path, u64 text_hash) const
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || it->value.text_hash != text_hash)
+        return {};
+
+    Vector<GUI::AutocompleteProvider::Declaration> declarations;
+    declarations.ensure_capacity(it->value.declarations.size());
+    for (auto& declaration : it->value.declarations)
+        declarations.unchecked_append({ declaration.name, { path, declaration.line, declaration.column }, declaration.type, declaration.scope });
+    return declarations;
+}
+
+void DeclarationIndex::set_declarations_of(String const& path, u64 text_hash, Vector<GUI::AutocompleteProvider::Declaration> const& declarations)
+{
+    Entry entry { text_hash, {} };
+    entry.declarations.ensure_capacity(declarations.size());
+    for (auto& declaration : declarations)
+        entry.declarations.unchecked_append({ declaration.name, declaration.scope, static_cast<u32>(declaration.position.line), static_cast<u32>(declaration.position.column), declaration.type });
+    m_entries.set(path, move(entry));
+
+    m_has_unsaved_changes = true;
+    m_save_timer->restart();
+}
+
+void DeclarationIndex::flush()
+{
+    m_save_timer->stop();
+    if (m_has_unsaved_changes)
+        save();
+}
+
+// The index file is a header of magic, version and entry count, followed by the entries. Each one is the length of the
+// path, the path, the hash of the text and the declaration count, followed by the declarations. Each of those is its line,
+// column and type, and the lengths of its name and scope, followed by the name and the scope.
+bool DeclarationIndex::load()
+{
+    auto file_or_error = MappedFile::map(m_index_path);
+    if (file_or_error.is_error())
+        return false;
+    auto file = file_or_error.release_value();
+    InputMemoryStream stream { file->bytes() };
+
+    auto read_string = [&](u32 length, String& string) {
+        if (length > stream.remaining())
+            return false;
+        string = String { reinterpret_cast<char const*>(file->bytes().offset_pointer(stream.offset())), length };
+        stream.discard_or_error(length);
+        return true;
+    };
+
+    u32 magic = 0;
+    u32 version = 0;
+    u32 entry_count = 0;
+    stream >> magic >> version >> entry_count;
+    if (stream.handle_any_error() || magic != index_file_magic || version != index_file_version)
+        return false;
+
+    for (u32 i = 0; i < entry_count; ++i) {
+        u32 path_length = 0;
+        stream >> path_length;
+        String path;
+        if (stream.handle_any_error() || !read_string(path_length, path))
+            return false;
+
+        Entry entry;
+        u32 declaration_count = 0;
+        stream >> entry.text_hash >> declaration_count;
+        if (stream.handle_any_error())
+            return false;
+        for (u32 j = 0; j < declaration_count; ++j) {
+            Declaration declaration;
+            u8 type = 0;
+            u32 name_length = 0;
+            u32 scope_length = 0;
+            stream >> declaration.line >> declaration.column >> type >> name_length >> scope_length;
+            if (stream.handle_any_error() || type > static_cast<u8>(GUI::AutocompleteProvider::DeclarationType::Member))
+                return false;
+            declaration.type = static_cast<GUI::AutocompleteProvider::DeclarationType>(type);
+            if (!read_string(name_length, declaration.name) || !read_string(scope_length, declaration.scope))
+                return false;
+            entry.declarations.append(move(declaration));
+        }
+        m_entries.set(move(path), move(entry));
+    }
+    dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "DeclarationIndex: Loaded {} files from {}", m_entries.size(), m_index_path);
+    return true;
+}
+
+void DeclarationIndex::save()
+{
+    DuplexMemoryStream stream;
+    stream << index_file_magic << index_file_version << static_cast<u32>(m_entries.size());
+    for (auto& it : m_entries) {
+        stream << static_cast<u32>(it.key.length()) << it.key.bytes();
+        stream << it.value.text_hash << static_cast<u32>(it.value.declarations.size());
+        for (auto& declaration : it.value.declarations) {
+            stream << declaration.line << declaration.column << static_cast<u8>(declaration.type);
+            stream << static_cast<u32>(declaration.name.length()) << static_cast<u32>(declaration.scope.length());
+            stream << declaration.name.bytes() << declaration.scope.bytes();
+        }
+    }
+    auto data = stream.copy_into_contiguous_buffer();
+
+    // Never leave a partially written index behind.
+    auto temporary_path = String::formatted("{}.new", m_index_path);
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dbgln("DeclarationIndex: Failed to create {}: {}", temporary_path, strerror(errno));
+        return;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        auto rc = write(fd, data.data() + written, data.size() - written);
+        if (rc <= 0)
+            break;
+        written += rc;
+    }
+    close(fd);
+    if (written < data.size() || rename(temporary_path.characters(), m_index_path.characters()) < 0) {
+        dbgln("DeclarationIndex: Failed to write {}: {}", m_index_path, strerror(errno));
+        unlink(temporary_path.characters());
+        return;
+    }
+    m_has_unsaved_changes = false;
+    dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "DeclarationIndex: Saved {} files to {}", m_entries.size(), m_index_path);
+}
+
+}
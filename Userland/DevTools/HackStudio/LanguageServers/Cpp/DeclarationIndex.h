@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/Object.h>
+#include <LibCore/Timer.h>
+#include <LibGUI/AutocompleteProvider.h>
+
+namespace LanguageServers::Cpp {
+
+// The declarations in every file that has been parsed, along with a hash of the text they were found in, which is saved
+// to disk. As long as a file doesn't change, its declarations are known without parsing it again, even in a later session.
+class DeclarationIndex final : public Core::Object {
+    C_OBJECT(DeclarationIndex);
+
+public:
+    virtual ~DeclarationIndex() override;
+
+    // This ignores a newline at the very end, which documents from FileDB leave out.
+    static u64 hash_of(StringView text);
+
+    // The declarations in a file, if they were found in exactly this text.
+    Optional<Vector<GUI::AutocompleteProvider::Declaration>> declarations_of(String const& path, u64 text_hash) const;
+    void set_declarations_of(String const& path, u64 text_hash, Vector<GUI::AutocompleteProvider::Declaration> const&);
+
+    // Saves whatever changed right away, instead of waiting for the save timer.
+    void flush();
+
+private:
+    explicit DeclarationIndex(String index_path);
+
+    struct Declaration {
+        String name;
+        String scope;
+        u32 line { 0 };
+        u32 column { 0 };
+        GUI::AutocompleteProvider::DeclarationType type;
+    };
+
+    struct Entry {
+        u64 text_hash { 0 };
+        Vector<Declaration> declarations;
+    };
+
+    bool load();
+    void save();
+
+    String m_index_path;
+    HashMap<String, Entry> m_entries;
+    bool m_has_unsaved_changes { false };
+    RefPtr<Core::Timer> m_save_timer;
+};
+
+}
@@ -11,7 +11,9 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/StandardPaths.h>
 #include <LibIPC/ClientConnection.h>
+#include <errno.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -35,14 +37,22 @@ int main(int argc, char** argv)
 int mode_server()
 {
     Core::EventLoop event_loop;
-    if (pledge("stdio unix recvfd rpath ", nullptr) < 0) {
+    if (pledge("stdio unix recvfd rpath wpath cpath", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
 
+    auto cache_directory = String::formatted("{}/.cache", Core::StandardPaths::home_directory());
+    auto index_directory = String::formatted("{}/CppLanguageServer", cache_directory);
+    for (auto& directory : { cache_directory, index_directory }) {
+        if (mkdir(directory.characters(), 0700) < 0 && errno != EEXIST)
+            perror("mkdir");
+    }
+    auto declaration_index = LanguageServers::Cpp::DeclarationIndex::construct(String::formatted("{}/declarations", index_directory));
+
     auto socket = Core::LocalSocket::take_over_accepted_socket_from_system_server();
-    IPC::new_client_connection<LanguageServers::Cpp::ClientConnection>(socket.release_nonnull(), 1);
-    if (pledge("stdio recvfd rpath", nullptr) < 0) {
+    IPC::new_client_connection<LanguageServers::Cpp::ClientConnection>(socket.release_nonnull(), 1, declaration_index);
+    if (pledge("stdio recvfd rpath wpath cpath", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -52,6 +62,11 @@ int mode_server()
         return 1;
     }
 
+    if (unveil(index_directory.characters(), "rwc") < 0) {
+        perror("unveil");
+        return 1;
+    }
+
     // unveil will be sealed later, when we know the project's root path.
     return event_loop.exec();
 }
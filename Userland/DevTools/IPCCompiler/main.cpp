@@ -369,6 +369,26 @@ enum class MessageID : i32 {
             message_generator.set("message.response_type", response_type);
             message_generator.set("message.constructor", constructor_for_message(pascal_name, parameters));
 
+            // Messages made up only of types that are encoded as their bytes in memory get copied in one go.
+            // The result is the same as encoding the parameters one after another, so both sides always agree.
+            if (parameters.is_empty()) {
+                message_generator.set("message.has_fixed_layout", "true");
+                message_generator.set("message.fixed_layout_size", "0");
+            } else {
+                StringBuilder fixed_layout_builder;
+                StringBuilder fixed_layout_size_builder;
+                for (size_t i = 0; i < parameters.size(); ++i) {
+                    if (i != 0) {
+                        fixed_layout_builder.append(" && ");
+                        fixed_layout_size_builder.append(" + ");
+                    }
+                    fixed_layout_builder.appendff("IPC::HasFixedLayout<{}>", parameters[i].type);
+                    fixed_layout_size_builder.appendff("sizeof({})", parameters[i].type);
+                }
+                message_generator.set("message.has_fixed_layout", fixed_layout_builder.build());
+                message_generator.set("message.fixed_layout_size", fixed_layout_size_builder.build());
+            }
+
             message_generator.append(R"~~~(
 class @message.pascal_name@ final : public IPC::Message {
 public:
@@ -391,9 +411,48 @@ public:
     virtual i32 message_id() const override { return (int)MessageID::@message.pascal_name@; }
     static i32 static_message_id() { return (int)MessageID::@message.pascal_name@; }
     virtual const char* message_name() const override { return "@endpoint.name@::@message.pascal_name@"; }
+    static constexpr bool has_fixed_layout = @message.has_fixed_layout@;
+    static constexpr size_t fixed_layout_size = @message.fixed_layout_size@;
 
     static OwnPtr<@message.pascal_name@> decode(InputMemoryStream& stream, [[maybe_unused]] int sockfd)
     {
+)~~~");
+
+            if (!parameters.is_empty()) {
+                message_generator.append(R"~~~(
+        if constexpr (has_fixed_layout) {
+            u8 bytes[fixed_layout_size];
+            stream >> Bytes { bytes, sizeof(bytes) };
+            if (stream.handle_any_error())
+                return {};
+            [[maybe_unused]] size_t offset = 0;
+)~~~");
+
+                for (auto& parameter : parameters) {
+                    auto parameter_generator = message_generator.fork();
+                    parameter_generator.set("parameter.type", parameter.type);
+                    parameter_generator.set("parameter.name", parameter.name);
+                    parameter_generator.append(R"~~~(
+            @parameter.type@ @parameter.name@;
+            memcpy(static_cast<void*>(&@parameter.name@), bytes + offset, sizeof(@parameter.name@));
+            offset += sizeof(@parameter.name@);
+)~~~");
+                }
+
+                StringBuilder builder;
+                for (size_t i = 0; i < parameters.size(); ++i) {
+                    if (i != 0)
+                        builder.append(", ");
+                    builder.append(parameters[i].name);
+                }
+                message_generator.set("message.fixed_layout_constructor_call_parameters", builder.build());
+                message_generator.append(R"~~~(
+            return make<@message.pascal_name@>(@message.fixed_layout_constructor_call_parameters@);
+        }
+)~~~");
+            }
+
+            message_generator.append(R"~~~(
         IPC::Decoder decoder { stream, sockfd };
 )~~~");
 
@@ -447,6 +506,36 @@ public:
         VERIFY(valid());
 
         IPC::MessageBuffer buffer;
+)~~~");
+
+            if (!parameters.is_empty()) {
+                message_generator.append(R"~~~(
+        if constexpr (has_fixed_layout) {
+            buffer.data.resize(sizeof(u32) + sizeof(i32) + fixed_layout_size);
+            u8* bytes = buffer.data.data();
+            u32 magic = endpoint_magic();
+            i32 id = (int)MessageID::@message.pascal_name@;
+            memcpy(bytes, &magic, sizeof(magic));
+            memcpy(bytes + sizeof(magic), &id, sizeof(id));
+            [[maybe_unused]] size_t offset = sizeof(magic) + sizeof(id);
+)~~~");
+
+                for (auto& parameter : parameters) {
+                    auto parameter_generator = message_generator.fork();
+                    parameter_generator.set("parameter.name", parameter.name);
+                    parameter_generator.append(R"~~~(
+            memcpy(bytes + offset, static_cast<const void*>(&m_@parameter.name@), sizeof(m_@parameter.name@));
+            offset += sizeof(m_@parameter.name@);
+)~~~");
+                }
+
+                message_generator.append(R"~~~(
+            return buffer;
+        }
+)~~~");
+            }
+
+            message_generator.append(R"~~~(
         IPC::Encoder stream(buffer);
         stream << endpoint_magic();
         stream << (int)MessageID::@message.pascal_name@;
@@ -610,7 +699,12 @@ public:
         if (!result)
             return IPC::ErrorCode::PeerDisconnected;
 )~~~");
-                    if (inner_return_type != "void") {
+                    if (message.outputs.size() == 1) {
+                        message_generator.set("output.name", message.outputs[0].name);
+                        message_generator.append(R"~~~(
+        return result->take_@output.name@();
+)~~~");
+                    } else if (inner_return_type != "void") {
                         message_generator.append(R"~~~(
         return move(*result);
 )~~~");
@@ -9,6 +9,7 @@
 #include "ProfileModel.h"
 #include "SamplesModel.h"
 #include <AK/HashTable.h>
+#include <AK/JsonParser.h>
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
 #include <AK/NonnullOwnPtrVector.h>
@@ -83,6 +84,7 @@ void Profile::rebuild_tree()
     });
 
     m_filtered_event_indices.clear();
+    m_filtered_event_weight = 0;
 
     for (size_t event_index = 0; event_index < m_events.size(); ++event_index) {
         auto& event = m_events.at(event_index);
@@ -96,7 +98,15 @@ void Profile::rebuild_tree()
         if (!process_filter_contains(event.pid, event.serial))
             continue;
 
+        if (m_event_type_filter.has_value() && event.type != m_event_type_filter.value())
+            continue;
+
+        if (m_show_off_cpu_time && event.type != "unblock"sv)
+            continue;
+
+        u64 weight = m_show_off_cpu_time ? event.blocked_time : 1;
         m_filtered_event_indices.append(event_index);
+        m_filtered_event_weight += weight;
 
         if (event.type == "malloc"sv && !live_allocations.contains(event.ptr))
             continue;
@@ -121,7 +131,7 @@ void Profile::rebuild_tree()
         if (!m_show_top_functions) {
             ProfileNode* node = nullptr;
             auto& process_node = find_or_create_process_node(event.pid, event.serial);
-            process_node.increment_event_count();
+            process_node.increment_event_count(weight);
             for_each_frame([&](const Frame& frame, bool is_innermost_frame) {
                 auto& object_name = frame.object_name;
                 auto& symbol = frame.symbol;
@@ -136,16 +146,16 @@ void Profile::rebuild_tree()
                     node = &process_node;
                 node = &node->find_or_create_child(object_name, symbol, address, offset, event.timestamp, event.pid);
 
-                node->increment_event_count();
+                node->increment_event_count(weight);
                 if (is_innermost_frame) {
-                    node->add_event_address(address);
-                    node->increment_self_count();
+                    node->add_event_address(address, weight);
+                    node->increment_self_count(weight);
                 }
                 return IterationDecision::Continue;
             });
         } else {
             auto& process_node = find_or_create_process_node(event.pid, event.serial);
-            process_node.increment_event_count();
+            process_node.increment_event_count(weight);
             for (size_t i = 0; i < event.frames.size(); ++i) {
                 ProfileNode* node = nullptr;
                 ProfileNode* root = nullptr;
@@ -170,14 +180,14 @@ void Profile::rebuild_tree()
 
                     if (!root->has_seen_event(event_index)) {
                         root->did_see_event(event_index);
-                        root->increment_event_count();
+                        root->increment_event_count(weight);
                     } else if (node != root) {
-                        node->increment_event_count();
+                        node->increment_event_count(weight);
                     }
 
                     if (j == event.frames.size() - 1) {
-                        node->add_event_address(address);
-                        node->increment_self_count();
+                        node->add_event_address(address, weight);
+                        node->increment_self_count(weight);
                     }
                 }
             }
@@ -190,68 +200,197 @@ void Profile::rebuild_tree()
     m_model->update();
 }
 
+// Picks the events out of a perfcore file one at a time, instead of building a JsonValue for the whole file first.
+class PerfcoreParser final : public JsonEventHandler {
+public:
+    struct PerfEvent {
+        String type;
+        u64 timestamp { 0 };
+        u64 lost_samples { 0 };
+        u64 pid { 0 };
+        u64 tid { 0 };
+        u64 ptr { 0 };
+        u64 size { 0 };
+        String name;
+        u64 parent_pid { 0 };
+        u64 parent_tid { 0 };
+        String executable;
+        String blocker;
+        u64 blocked_time { 0 };
+        Vector<u64> stack;
+    };
+
+    explicit PerfcoreParser(Function<void(PerfEvent&)> on_event)
+        : m_on_event(move(on_event))
+    {
+    }
+
+    bool is_object() const { return m_is_object; }
+    bool has_events() const { return m_has_events; }
+
+private:
+    virtual bool on_object_start() override
+    {
+        if (m_depth == 0)
+            m_is_object = true;
+        else if (m_depth == 2 && m_in_events)
+            m_event = {};
+        ++m_depth;
+        return true;
+    }
+
+    virtual bool on_object_end() override
+    {
+        --m_depth;
+        if (m_depth == 2 && m_in_events)
+            m_on_event(m_event);
+        return true;
+    }
+
+    virtual bool on_array_start() override
+    {
+        if (m_depth == 0)
+            return false;
+        if (m_depth == 1 && m_is_events_key) {
+            m_in_events = true;
+            m_has_events = true;
+        } else if (m_depth == 3 && m_in_events && m_is_stack_key) {
+            m_in_stack = true;
+        }
+        ++m_depth;
+        return true;
+    }
+
+    virtual bool on_array_end() override
+    {
+        --m_depth;
+        if (m_depth == 1)
+            m_in_events = false;
+        else if (m_depth == 3)
+            m_in_stack = false;
+        return true;
+    }
+
+    virtual bool on_object_key(const StringView& key) override
+    {
+        if (m_depth == 1) {
+            m_is_events_key = key == "events"sv;
+            return true;
+        }
+        if (m_depth != 3 || !m_in_events)
+            return true;
+
+        m_number_field = nullptr;
+        m_string_field = nullptr;
+        m_is_stack_key = false;
+        if (key == "type"sv)
+            m_string_field = &m_event.type;
+        else if (key == "timestamp"sv)
+            m_number_field = &m_event.timestamp;
+        else if (key == "lost_samples"sv)
+            m_number_field = &m_event.lost_samples;
+        else if (key == "pid"sv)
+            m_number_field = &m_event.pid;
+        else if (key == "tid"sv)
+            m_number_field = &m_event.tid;
+        else if (key == "ptr"sv)
+            m_number_field = &m_event.ptr;
+        else if (key == "size"sv)
+            m_number_field = &m_event.size;
+        else if (key == "name"sv)
+            m_string_field = &m_event.name;
+        else if (key == "parent_pid"sv)
+            m_number_field = &m_event.parent_pid;
+        else if (key == "parent_tid"sv)
+            m_number_field = &m_event.parent_tid;
+        else if (key == "executable"sv)
+            m_string_field = &m_event.executable;
+        else if (key == "blocker"sv)
+            m_string_field = &m_event.blocker;
+        else if (key == "blocked_time"sv)
+            m_number_field = &m_event.blocked_time;
+        else if (key == "stack"sv)
+            m_is_stack_key = true;
+        return true;
+    }
+
+    virtual bool on_number(const JsonValue& value) override
+    {
+        if (m_depth == 4 && m_in_stack)
+            m_event.stack.append(value.to_number<u64>());
+        else if (m_depth == 3 && m_in_events && m_number_field)
+            *m_number_field = value.to_number<u64>();
+        return true;
+    }
+
+    virtual bool on_string(const StringView& value) override
+    {
+        if (m_depth == 3 && m_in_events && m_string_field)
+            *m_string_field = value;
+        return true;
+    }
+
+    Function<void(PerfEvent&)> m_on_event;
+    PerfEvent m_event;
+    size_t m_depth { 0 };
+    bool m_is_object { false };
+    bool m_has_events { false };
+    bool m_is_events_key { false };
+    bool m_in_events { false };
+    bool m_is_stack_key { false };
+    bool m_in_stack { false };
+    u64* m_number_field { nullptr };
+    String* m_string_field { nullptr };
+};
+
 Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const StringView& path)
 {
     auto file = Core::File::construct(path);
     if (!file->open(Core::OpenMode::ReadOnly))
         return String::formatted("Unable to open {}, error: {}", path, file->error_string());
 
-    auto json = JsonValue::from_string(file->read_all());
-    if (!json.has_value() || !json.value().is_object())
-        return String { "Invalid perfcore format (not a JSON object)" };
-
-    auto& object = json.value().as_object();
-
     auto file_or_error = MappedFile::map("/boot/Kernel.debug");
     OwnPtr<ELF::Image> kernel_elf;
     if (!file_or_error.is_error())
         kernel_elf = make<ELF::Image>(file_or_error.value()->bytes());
 
-    auto events_value = object.get_ptr("events");
-    if (!events_value || !events_value->is_array())
-        return String { "Malformed profile (events is not an array)" };
-
-    auto& perf_events = events_value->as_array();
-
     NonnullOwnPtrVector<Process> all_processes;
     HashMap<pid_t, Process*> current_processes;
     Vector<Event> events;
     EventSerialNumber next_serial;
 
-    for (auto& perf_event_value : perf_events.values()) {
-        auto& perf_event = perf_event_value.as_object();
-
+    PerfcoreParser parser([&](PerfcoreParser::PerfEvent& perf_event) {
         Event event;
 
         event.serial = next_serial;
         next_serial.increment();
-        event.timestamp = perf_event.get("timestamp").to_number<u64>();
-        event.lost_samples = perf_event.get("lost_samples").to_number<u32>();
-        event.type = perf_event.get("type").to_string();
-        event.pid = perf_event.get("pid").to_i32();
-        event.tid = perf_event.get("tid").to_i32();
+        event.timestamp = perf_event.timestamp;
+        event.lost_samples = perf_event.lost_samples;
+        event.type = perf_event.type;
+        event.pid = perf_event.pid;
+        event.tid = perf_event.tid;
 
         if (event.type == "malloc"sv) {
-            event.ptr = perf_event.get("ptr").to_number<FlatPtr>();
-            event.size = perf_event.get("size").to_number<size_t>();
+            event.ptr = perf_event.ptr;
+            event.size = perf_event.size;
         } else if (event.type == "free"sv) {
-            event.ptr = perf_event.get("ptr").to_number<FlatPtr>();
+            event.ptr = perf_event.ptr;
         } else if (event.type == "mmap"sv) {
-            event.ptr = perf_event.get("ptr").to_number<FlatPtr>();
-            event.size = perf_event.get("size").to_number<size_t>();
-            event.name = perf_event.get("name").to_string();
+            event.ptr = perf_event.ptr;
+            event.size = perf_event.size;
+            event.name = perf_event.name;
 
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->library_metadata.handle_mmap(event.ptr, event.size, event.name);
-            continue;
+            return;
         } else if (event.type == "munmap"sv) {
-            event.ptr = perf_event.get("ptr").to_number<FlatPtr>();
-            event.size = perf_event.get("size").to_number<size_t>();
-            continue;
+            event.ptr = perf_event.ptr;
+            event.size = perf_event.size;
+            return;
         } else if (event.type == "process_create"sv) {
-            event.parent_pid = perf_event.get("parent_pid").to_number<FlatPtr>();
-            event.executable = perf_event.get("executable").to_string();
+            event.parent_pid = perf_event.parent_pid;
+            event.executable = perf_event.executable;
 
             auto sampled_process = adopt_own(*new Process {
                 .pid = event.pid,
@@ -263,9 +402,9 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
 
             current_processes.set(sampled_process->pid, sampled_process);
             all_processes.append(move(sampled_process));
-            continue;
+            return;
         } else if (event.type == "process_exec"sv) {
-            event.executable = perf_event.get("executable").to_string();
+            event.executable = perf_event.executable;
 
             auto old_process = current_processes.get(event.pid).value();
             old_process->end_valid = event.serial;
@@ -282,34 +421,35 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
 
             current_processes.set(sampled_process->pid, sampled_process);
             all_processes.append(move(sampled_process));
-            continue;
+            return;
         } else if (event.type == "process_exit"sv) {
             auto old_process = current_processes.get(event.pid).value();
             old_process->end_valid = event.serial;
 
             current_processes.remove(event.pid);
-            continue;
+            return;
         } else if (event.type == "thread_create"sv) {
-            event.parent_tid = perf_event.get("parent_tid").to_i32();
+            event.parent_tid = perf_event.parent_tid;
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->handle_thread_create(event.tid, event.serial);
-            continue;
+            return;
         } else if (event.type == "thread_exit"sv) {
             auto it = current_processes.find(event.pid);
             if (it != current_processes.end())
                 it->value->handle_thread_exit(event.tid, event.serial);
-            continue;
+            return;
+        } else if (event.type == "block"sv) {
+            event.blocker = perf_event.blocker;
+        } else if (event.type == "unblock"sv) {
+            event.blocker = perf_event.blocker;
+            event.blocked_time = perf_event.blocked_time;
         }
 
         auto maybe_kernel_base = Symbolication::kernel_base();
 
-        auto* stack = perf_event.get_ptr("stack");
-        VERIFY(stack);
-        auto& stack_array = stack->as_array();
-        for (ssize_t i = stack_array.values().size() - 1; i >= 0; --i) {
-            auto& frame = stack_array.at(i);
-            auto ptr = frame.to_number<u64>();
+        for (ssize_t i = perf_event.stack.size() - 1; i >= 0; --i) {
+            auto ptr = perf_event.stack[i];
             u32 offset = 0;
             FlyString object_name;
             String symbol;
@@ -338,13 +478,19 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
         }
 
         if (event.frames.size() < 2)
-            continue;
+            return;
 
         FlatPtr innermost_frame_address = event.frames.at(1).address;
         event.in_kernel = maybe_kernel_base.has_value() && innermost_frame_address >= maybe_kernel_base.value();
 
         events.append(move(event));
-    }
+    });
+
+    auto file_contents = file->read_all();
+    if (!JsonParser(file_contents).parse_events(parser) || !parser.is_object())
+        return String { "Invalid perfcore format (not a JSON object)" };
+    if (!parser.has_events())
+        return String { "Malformed profile (events is not an array)" };
 
     if (events.is_empty())
         return String { "No events captured (targeted process was never on CPU)" };
@@ -457,6 +603,40 @@ void Profile::set_show_top_functions(bool show)
     rebuild_tree();
 }
 
+void Profile::set_show_off_cpu_time(bool show_off_cpu_time)
+{
+    if (m_show_off_cpu_time == show_off_cpu_time)
+        return;
+    m_show_off_cpu_time = show_off_cpu_time;
+    rebuild_tree();
+    if (m_disassembly_model)
+        m_disassembly_model->update();
+    m_samples_model->update();
+}
+
+void Profile::set_event_type_filter(Optional<String> event_type)
+{
+    if (m_event_type_filter == event_type)
+        return;
+    m_event_type_filter = move(event_type);
+    rebuild_tree();
+    if (m_disassembly_model)
+        m_disassembly_model->update();
+    m_samples_model->update();
+}
+
+Vector<String> Profile::event_types() const
+{
+    HashTable<String> seen_types;
+    Vector<String> types;
+    for (auto& event : m_events) {
+        if (seen_types.set(event.type) == AK::HashSetResult::InsertedNewEntry)
+            types.append(event.type);
+    }
+    quick_sort(types);
+    return types;
+}
+
 void Profile::set_show_percentages(bool show_percentages)
 {
     if (m_show_percentages == show_percentages)
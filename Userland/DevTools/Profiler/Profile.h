@@ -18,6 +18,7 @@
 #include <AK/JsonValue.h>
 #include <AK/MappedFile.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/Result.h>
 #include <LibELF/Image.h>
@@ -53,8 +54,8 @@ public:
     u32 offset() const { return m_offset; }
     u64 timestamp() const { return m_timestamp; }
 
-    u32 event_count() const { return m_event_count; }
-    u32 self_count() const { return m_self_count; }
+    u64 event_count() const { return m_event_count; }
+    u64 self_count() const { return m_self_count; }
 
     int child_count() const { return m_children.size(); }
     const Vector<NonnullRefPtr<ProfileNode>>& children() const { return m_children; }
@@ -84,19 +85,19 @@ public:
     ProfileNode* parent() { return m_parent; }
     const ProfileNode* parent() const { return m_parent; }
 
-    void increment_event_count() { ++m_event_count; }
-    void increment_self_count() { ++m_self_count; }
+    void increment_event_count(u64 weight = 1) { m_event_count += weight; }
+    void increment_self_count(u64 weight = 1) { m_self_count += weight; }
 
     void sort_children();
 
     const HashMap<FlatPtr, size_t>& events_per_address() const { return m_events_per_address; }
-    void add_event_address(FlatPtr address)
+    void add_event_address(FlatPtr address, u64 weight = 1)
     {
         auto it = m_events_per_address.find(address);
         if (it == m_events_per_address.end())
-            m_events_per_address.set(address, 1);
+            m_events_per_address.set(address, weight);
         else
-            m_events_per_address.set(address, it->value + 1);
+            m_events_per_address.set(address, it->value + weight);
     }
 
     pid_t pid() const { return m_pid; }
@@ -116,8 +117,8 @@ private:
     pid_t m_pid { 0 };
     FlatPtr m_address { 0 };
     u32 m_offset { 0 };
-    u32 m_event_count { 0 };
-    u32 m_self_count { 0 };
+    u64 m_event_count { 0 };
+    u64 m_self_count { 0 };
     u64 m_timestamp { 0 };
     Vector<NonnullRefPtr<ProfileNode>> m_children;
     HashMap<FlatPtr, size_t> m_events_per_address;
@@ -175,12 +176,17 @@ public:
         int pid { 0 };
         int tid { 0 };
         u32 lost_samples { 0 };
+        String blocker;
+        // In microseconds, for unblock events.
+        u32 blocked_time { 0 };
         bool in_kernel { false };
         Vector<Frame> frames;
     };
 
     const Vector<Event>& events() const { return m_events; }
     const Vector<size_t>& filtered_event_indices() const { return m_filtered_event_indices; }
+    // The sum of what the filtered events count for in the tree, i.e. their blocked time when showing the off-CPU time.
+    u64 filtered_event_weight() const { return m_filtered_event_weight; }
 
     u64 length_in_ms() const { return m_last_timestamp - m_first_timestamp; }
     u64 first_timestamp() const { return m_first_timestamp; }
@@ -204,6 +210,15 @@ public:
     bool show_percentages() const { return m_show_percentages; }
     void set_show_percentages(bool);
 
+    // Only the events of this type are shown in the tree, e.g. to only see where the cache misses happen.
+    // Builds the tree from the unblock events instead, weighted by how long each thread was blocked.
+    bool show_off_cpu_time() const { return m_show_off_cpu_time; }
+    void set_show_off_cpu_time(bool);
+
+    const Optional<String>& event_type_filter() const { return m_event_type_filter; }
+    void set_event_type_filter(Optional<String>);
+    Vector<String> event_types() const;
+
     const Vector<Process>& processes() const { return m_processes; }
 
     template<typename Callback>
@@ -232,6 +247,7 @@ private:
 
     Vector<NonnullRefPtr<ProfileNode>> m_roots;
     Vector<size_t> m_filtered_event_indices;
+    u64 m_filtered_event_weight { 0 };
     u64 m_first_timestamp { 0 };
     u64 m_last_timestamp { 0 };
 
@@ -247,6 +263,8 @@ private:
     bool m_inverted { false };
     bool m_show_top_functions { false };
     bool m_show_percentages { false };
+    bool m_show_off_cpu_time { false };
+    Optional<String> m_event_type_filter;
 };
 
 }
@@ -81,8 +81,12 @@ String ProfileModel::column_name(int column) const
 {
     switch (column) {
     case Column::SampleCount:
+        if (m_profile.show_off_cpu_time())
+            return m_profile.show_percentages() ? "% Off-CPU" : "Off-CPU (us)";
         return m_profile.show_percentages() ? "% Samples" : "# Samples";
     case Column::SelfCount:
+        if (m_profile.show_off_cpu_time())
+            return m_profile.show_percentages() ? "% Self" : "Self (us)";
         return m_profile.show_percentages() ? "% Self" : "# Self";
     case Column::ObjectName:
         return "Object";
@@ -116,12 +120,12 @@ GUI::Variant ProfileModel::data(const GUI::ModelIndex& index, GUI::ModelRole rol
     if (role == GUI::ModelRole::Display) {
         if (index.column() == Column::SampleCount) {
             if (m_profile.show_percentages())
-                return ((float)node->event_count() / (float)m_profile.filtered_event_indices().size()) * 100.0f;
+                return ((float)node->event_count() / (float)m_profile.filtered_event_weight()) * 100.0f;
             return node->event_count();
         }
         if (index.column() == Column::SelfCount) {
             if (m_profile.show_percentages())
-                return ((float)node->self_count() / (float)m_profile.filtered_event_indices().size()) * 100.0f;
+                return ((float)node->self_count() / (float)m_profile.filtered_event_weight()) * 100.0f;
             return node->self_count();
         }
         if (index.column() == Column::ObjectName)
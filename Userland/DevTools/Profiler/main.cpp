@@ -17,6 +17,7 @@
 #include <LibCore/Timer.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
+#include <LibGUI/ActionGroup.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
@@ -195,6 +196,20 @@ int main(int argc, char** argv)
             auto end = normalized_end_time - start_of_trace;
             builder.appendff(", Selection: {} - {} ms", start, end);
             builder.appendff(", Duration: {} ms", end - start);
+
+            // Cycles and instructions are both sampled once every million, so the ratio of their samples is the IPC.
+            size_t cycle_samples = 0;
+            size_t instruction_samples = 0;
+            for (auto& event : profile->events()) {
+                if (event.timestamp < normalized_start_time || event.timestamp > normalized_end_time)
+                    continue;
+                if (event.type == "cpu_cycles"sv)
+                    ++cycle_samples;
+                else if (event.type == "instructions"sv)
+                    ++instruction_samples;
+            }
+            if (cycle_samples != 0)
+                builder.appendff(", IPC: {:.2}", static_cast<double>(instruction_samples) / cycle_samples);
         }
         statusbar.set_text(builder.to_string());
     };
@@ -224,8 +239,34 @@ int main(int argc, char** argv)
     percent_action->set_checked(false);
     view_menu.add_action(percent_action);
 
+    auto off_cpu_action = GUI::Action::create_checkable("Show &Off-CPU Time", { Mod_Ctrl, Key_O }, [&](auto& action) {
+        profile->set_show_off_cpu_time(action.is_checked());
+        tree_view.update();
+        disassembly_view.update();
+    });
+    off_cpu_action->set_checked(false);
+    view_menu.add_action(off_cpu_action);
+
     view_menu.add_action(disassembly_action);
 
+    auto& event_type_menu = window->add_menu("&Events");
+    GUI::ActionGroup event_type_actions;
+    event_type_actions.set_exclusive(true);
+    auto add_event_type_action = [&](String title, Optional<String> event_type) {
+        auto action = GUI::Action::create_checkable(title, [&, event_type](auto&) {
+            profile->set_event_type_filter(event_type);
+            tree_view.update();
+            disassembly_view.update();
+        });
+        event_type_actions.add_action(action);
+        event_type_menu.add_action(action);
+        return action;
+    };
+    add_event_type_action("&All Events", {})->set_checked(true);
+    event_type_menu.add_separator();
+    for (auto& event_type : profile->event_types())
+        add_event_type_action(event_type, event_type);
+
     auto& help_menu = window->add_menu("&Help");
     help_menu.add_action(GUI::CommonActions::make_help_action([](auto&) {
         Desktop::Launcher::open(URL::create_with_file_protocol("/usr/share/man/man1/Profiler.md"), "/bin/Help");
@@ -7,6 +7,7 @@
 
 #include "Emulator.h"
 #include "MmapRegion.h"
+#include "ShadowBits.h"
 #include "SimpleRegion.h"
 #include "SoftCPU.h"
 #include <AK/Debug.h>
@@ -185,7 +186,7 @@ bool Emulator::load_elf()
             if (program_header.is_executable() && !program_header.is_writable())
                 region->set_text(true);
             memcpy(region->data(), program_header.raw_data(), program_header.size_in_image());
-            memset(region->shadow_data(), 0x01, program_header.size_in_memory());
+            fill_shadow(region->shadow_data(), 0, program_header.size_in_memory(), true);
             if (program_header.is_executable()) {
                 m_loader_text_base = region->base();
                 m_loader_text_size = region->size();
@@ -220,8 +221,7 @@ int Emulator::exec()
 
     while (!m_shutdown) {
         if (m_steps_til_pause) [[likely]] {
-            m_cpu.save_base_eip();
-            auto insn = X86::Instruction::from_stream(m_cpu, true, true);
+            auto insn = m_cpu.fetch_instruction();
             // Exec cycle
             if constexpr (trace) {
                 outln("{:p}  \033[33;1m{}\033[0m", m_cpu.base_eip(), insn.to_string(m_cpu.base_eip(), symbol_provider));
@@ -42,6 +42,7 @@ public:
     u32 virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3);
 
     SoftMMU& mmu() { return m_mmu; }
+    SoftCPU& cpu() { return m_cpu; }
 
     MallocTracer* malloc_tracer() { return m_malloc_tracer; }
 
@@ -6,6 +6,7 @@
 
 #include "Emulator.h"
 #include "MmapRegion.h"
+#include "ShadowBits.h"
 #include "SimpleRegion.h"
 #include <AK/Debug.h>
 #include <AK/Format.h>
@@ -961,6 +962,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
     if (has_non_mmapped_region)
         return -EINVAL;
 
+    m_cpu.did_modify_memory(base, size);
     return 0;
 }
 
@@ -1474,11 +1476,11 @@ u32 Emulator::virt$allocate_tls(FlatPtr initial_data, size_t size)
         memcpy(tcb_region->data() + offset, buffer, read_bytes);
         offset += read_bytes;
     }
-    memset(tcb_region->shadow_data(), 0x01, size);
+    fill_shadow(tcb_region->shadow_data(), 0, size, true);
 
     auto tls_region = make<SimpleRegion>(0, 4);
     tls_region->write32(0, shadow_wrap_as_initialized(tcb_region->base() + (u32)size));
-    memset(tls_region->shadow_data(), 0x01, 4);
+    fill_shadow(tls_region->shadow_data(), 0, 4, true);
 
     u32 tls_base = tcb_region->base();
     mmu().add_region(move(tcb_region));
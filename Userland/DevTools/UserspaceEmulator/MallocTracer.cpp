@@ -8,6 +8,7 @@
 #include "MallocTracer.h"
 #include "Emulator.h"
 #include "MmapRegion.h"
+#include "ShadowBits.h"
 #include <AK/Debug.h>
 #include <AK/TemporaryChange.h>
 #include <mallocdefs.h>
@@ -65,8 +66,7 @@ void MallocTracer::target_did_malloc(Badge<Emulator>, FlatPtr address, size_t si
     VERIFY(region);
     auto& mmap_region = verify_cast<MmapRegion>(*region);
 
-    auto* shadow_bits = mmap_region.shadow_data() + address - mmap_region.base();
-    memset(shadow_bits, 0, size);
+    fill_shadow(mmap_region.shadow_data(), address - mmap_region.base(), size, false);
 
     if (auto* existing_mallocation = find_mallocation(address)) {
         VERIFY(existing_mallocation->freed);
@@ -161,12 +161,12 @@ void MallocTracer::target_did_realloc(Badge<Emulator>, FlatPtr address, size_t s
 
     size_t old_size = existing_mallocation->size;
 
-    auto* shadow_bits = mmap_region.shadow_data() + address - mmap_region.base();
+    auto offset_in_region = address - mmap_region.base();
 
     if (size > old_size) {
-        memset(shadow_bits + old_size, 1, size - old_size);
+        fill_shadow(mmap_region.shadow_data(), offset_in_region + old_size, size - old_size, true);
     } else {
-        memset(shadow_bits + size, 1, old_size - size);
+        fill_shadow(mmap_region.shadow_data(), offset_in_region + size, old_size - size, true);
     }
 
     existing_mallocation->size = size;
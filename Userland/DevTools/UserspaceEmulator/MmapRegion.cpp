@@ -6,6 +6,7 @@
 
 #include "MmapRegion.h"
 #include "Emulator.h"
+#include "ShadowBits.h"
 #include <string.h>
 #include <sys/mman.h>
 
@@ -28,7 +29,7 @@ static void free_pages(void* ptr, size_t bytes)
 NonnullOwnPtr<MmapRegion> MmapRegion::create_anonymous(u32 base, u32 size, u32 prot, String name)
 {
     auto data = (u8*)mmap_initialized(size, 0, nullptr);
-    auto shadow_data = (u8*)mmap_initialized(size, 1, "MmapRegion ShadowData");
+    auto shadow_data = (u8*)mmap_initialized(shadow_bits_size_for(size), 0xff, "MmapRegion ShadowData");
     auto region = adopt_own(*new MmapRegion(base, size, prot, data, shadow_data));
     region->m_name = move(name);
     return region;
@@ -40,7 +41,7 @@ NonnullOwnPtr<MmapRegion> MmapRegion::create_file_backed(u32 base, u32 size, u32
     auto real_flags = flags & ~MAP_FIXED;
     auto data = (u8*)mmap_with_name(nullptr, size, prot, real_flags, fd, offset, name.is_empty() ? nullptr : name.characters());
     VERIFY(data != MAP_FAILED);
-    auto shadow_data = (u8*)mmap_initialized(size, 1, "MmapRegion ShadowData");
+    auto shadow_data = (u8*)mmap_initialized(shadow_bits_size_for(size), 0xff, "MmapRegion ShadowData");
     auto region = adopt_own(*new MmapRegion(base, size, prot, data, shadow_data));
     region->m_file_backed = true;
     region->m_name = move(name);
@@ -51,6 +52,7 @@ MmapRegion::MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_data)
     : Region(base, size, true)
     , m_data(data)
     , m_shadow_data(shadow_data)
+    , m_shadow_data_size(shadow_bits_size_for(size))
 {
     set_prot(prot);
 }
@@ -58,7 +60,7 @@ MmapRegion::MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_data)
 MmapRegion::~MmapRegion()
 {
     free_pages(m_data, size());
-    free_pages(m_shadow_data, size());
+    free_pages(m_shadow_data, m_shadow_data_size);
 }
 
 ValueWithShadow<u8> MmapRegion::read8(FlatPtr offset)
@@ -75,7 +77,7 @@ ValueWithShadow<u8> MmapRegion::read8(FlatPtr offset)
     }
 
     VERIFY(offset < size());
-    return { m_data[offset], m_shadow_data[offset] };
+    return { m_data[offset], load_shadow<u8>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u16> MmapRegion::read16(u32 offset)
@@ -92,11 +94,10 @@ ValueWithShadow<u16> MmapRegion::read16(u32 offset)
     }
 
     VERIFY(offset + 1 < size());
-    u16 value, shadow;
+    u16 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u16>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u32> MmapRegion::read32(u32 offset)
@@ -113,11 +114,10 @@ ValueWithShadow<u32> MmapRegion::read32(u32 offset)
     }
 
     VERIFY(offset + 3 < size());
-    u32 value, shadow;
+    u32 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u32>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u64> MmapRegion::read64(u32 offset)
@@ -134,11 +134,10 @@ ValueWithShadow<u64> MmapRegion::read64(u32 offset)
     }
 
     VERIFY(offset + 7 < size());
-    u64 value, shadow;
+    u64 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u64>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u128> MmapRegion::read128(u32 offset)
@@ -155,10 +154,9 @@ ValueWithShadow<u128> MmapRegion::read128(u32 offset)
     }
 
     VERIFY(offset + 15 < size());
-    u128 value, shadow;
+    u128 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, load_shadow<u128>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u256> MmapRegion::read256(u32 offset)
@@ -175,10 +173,9 @@ ValueWithShadow<u256> MmapRegion::read256(u32 offset)
     }
 
     VERIFY(offset + 31 < size());
-    u256 value, shadow;
+    u256 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, load_shadow<u256>(m_shadow_data, offset) };
 }
 
 void MmapRegion::write8(u32 offset, ValueWithShadow<u8> value)
@@ -196,7 +193,7 @@ void MmapRegion::write8(u32 offset, ValueWithShadow<u8> value)
 
     VERIFY(offset < size());
     m_data[offset] = value.value();
-    m_shadow_data[offset] = value.shadow();
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void MmapRegion::write16(u32 offset, ValueWithShadow<u16> value)
@@ -214,7 +211,7 @@ void MmapRegion::write16(u32 offset, ValueWithShadow<u16> value)
 
     VERIFY(offset + 1 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void MmapRegion::write32(u32 offset, ValueWithShadow<u32> value)
@@ -233,7 +230,7 @@ void MmapRegion::write32(u32 offset, ValueWithShadow<u32> value)
     VERIFY(offset + 3 < size());
     VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void MmapRegion::write64(u32 offset, ValueWithShadow<u64> value)
@@ -252,7 +249,7 @@ void MmapRegion::write64(u32 offset, ValueWithShadow<u64> value)
     VERIFY(offset + 7 < size());
     VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void MmapRegion::write128(u32 offset, ValueWithShadow<u128> value)
@@ -270,7 +267,7 @@ void MmapRegion::write128(u32 offset, ValueWithShadow<u128> value)
     VERIFY(offset + 15 < size());
     VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void MmapRegion::write256(u32 offset, ValueWithShadow<u256> value)
@@ -288,7 +285,7 @@ void MmapRegion::write256(u32 offset, ValueWithShadow<u256> value)
     VERIFY(offset + 31 < size());
     VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 NonnullOwnPtr<MmapRegion> MmapRegion::split_at(VirtualAddress offset)
@@ -297,7 +294,10 @@ NonnullOwnPtr<MmapRegion> MmapRegion::split_at(VirtualAddress offset)
     VERIFY(!m_malloc_metadata);
     Range new_range = range();
     Range other_range = new_range.split_at(offset);
-    auto other_region = adopt_own(*new MmapRegion(other_range.base().get(), other_range.size(), prot(), data() + new_range.size(), shadow_data() + new_range.size()));
+    // The bits can't be split along with the pages of data, so the other half gets a copy of its own.
+    auto other_shadow_data = (u8*)mmap_initialized(shadow_bits_size_for(other_range.size()), 0xff, "MmapRegion ShadowData");
+    memcpy(other_shadow_data, shadow_data() + new_range.size() / 8, other_range.size() / 8);
+    auto other_region = adopt_own(*new MmapRegion(other_range.base().get(), other_range.size(), prot(), data() + new_range.size(), other_shadow_data));
     other_region->m_file_backed = m_file_backed;
     other_region->m_name = m_name;
     set_range(new_range);
@@ -59,6 +59,7 @@ private:
 
     u8* m_data { nullptr };
     u8* m_shadow_data { nullptr };
+    size_t m_shadow_data_size { 0 };
     bool m_file_backed { false };
     bool m_malloc { false };
 
@@ -59,6 +59,7 @@ public:
     void set_executable(bool b) { m_executable = b; }
 
     virtual u8* data() = 0;
+    // One bit per byte of data(), see ShadowBits.h.
     virtual u8* shadow_data() = 0;
 
     Emulator& emulator() { return m_emulator; }
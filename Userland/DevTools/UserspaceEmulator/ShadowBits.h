@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "ValueWithShadow.h"
+#include <AK/Array.h>
+#include <AK/ByteReader.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <string.h>
+
+namespace UserspaceEmulator {
+
+// Regions keep the shadow of their memory packed into one bit per byte, which is set while that byte is initialized.
+// ValueWithShadow still has a whole shadow byte per value byte, so the bits are spread out when loading a value and
+// gathered back up when storing one.
+
+// A few bytes more than the bits strictly need, so that the last bits can be read and written through a u16.
+constexpr size_t shadow_bits_size_for(size_t size)
+{
+    return ceil_div(size, static_cast<size_t>(8)) + 1;
+}
+
+static constexpr auto s_shadow_bytes_for_bits = [] {
+    Array<u64, 256> table {};
+    for (size_t bits = 0; bits < 256; ++bits) {
+        for (size_t i = 0; i < 8; ++i) {
+            if (bits & (1 << i))
+                table[bits] |= 1llu << (i * 8);
+        }
+    }
+    return table;
+}();
+
+ALWAYS_INLINE u8 shadow_bits_for_bytes(u64 shadow)
+{
+    // Moves the low bit of every byte into the top byte, in order.
+    return ((shadow & _inititalized_64) * 0x0102040810204080llu) >> 56;
+}
+
+template<typename T>
+ALWAYS_INLINE T load_shadow(u8 const* shadow_bits, u32 offset)
+{
+    if constexpr (sizeof(T) == 32) {
+        return T(load_shadow<u128>(shadow_bits, offset), load_shadow<u128>(shadow_bits, offset + 16));
+    } else if constexpr (sizeof(T) == 16) {
+        return T(load_shadow<u64>(shadow_bits, offset), load_shadow<u64>(shadow_bits, offset + 8));
+    } else {
+        constexpr u32 mask = (1u << sizeof(T)) - 1;
+        auto shift = offset % 8;
+        u32 bits;
+        // Aligned accesses never straddle two bytes of bits.
+        if (shift + sizeof(T) <= 8) {
+            bits = (shadow_bits[offset / 8] >> shift) & mask;
+        } else {
+            u16 window;
+            ByteReader::load(shadow_bits + offset / 8, window);
+            bits = (window >> shift) & mask;
+        }
+        if (bits == mask) [[likely]]
+            return static_cast<T>(_inititalized_64);
+        return static_cast<T>(s_shadow_bytes_for_bits[bits]);
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE void store_shadow(u8* shadow_bits, u32 offset, T shadow)
+{
+    if constexpr (sizeof(T) == 32) {
+        store_shadow<u128>(shadow_bits, offset, shadow.low());
+        store_shadow<u128>(shadow_bits, offset + 16, shadow.high());
+    } else if constexpr (sizeof(T) == 16) {
+        store_shadow<u64>(shadow_bits, offset, shadow.low());
+        store_shadow<u64>(shadow_bits, offset + 8, shadow.high());
+    } else {
+        constexpr u32 mask = (1u << sizeof(T)) - 1;
+        auto shift = offset % 8;
+        u32 bits = shadow_bits_for_bytes(shadow) & mask;
+        if (shift + sizeof(T) <= 8) {
+            auto& byte = shadow_bits[offset / 8];
+            byte = (byte & ~(mask << shift)) | (bits << shift);
+        } else {
+            u16 window;
+            ByteReader::load(shadow_bits + offset / 8, window);
+            window = (window & ~(mask << shift)) | (bits << shift);
+            ByteReader::store(shadow_bits + offset / 8, window);
+        }
+    }
+}
+
+inline void fill_shadow(u8* shadow_bits, u32 offset, size_t size, bool initialized)
+{
+    auto set = [&](u32 bit_offset) {
+        if (initialized)
+            shadow_bits[bit_offset / 8] |= 1 << (bit_offset % 8);
+        else
+            shadow_bits[bit_offset / 8] &= ~(1 << (bit_offset % 8));
+    };
+    u32 end = offset + size;
+    for (; offset < end && offset % 8; ++offset)
+        set(offset);
+    u32 whole_bytes_end = end - end % 8;
+    if (offset < whole_bytes_end) {
+        memset(shadow_bits + offset / 8, initialized ? 0xff : 0, (whole_bytes_end - offset) / 8);
+        offset = whole_bytes_end;
+    }
+    for (; offset < end; ++offset)
+        set(offset);
+}
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include "SimpleRegion.h"
+#include "ShadowBits.h"
 #include <AK/ByteReader.h>
 #include <string.h>
 
@@ -14,8 +15,8 @@ SimpleRegion::SimpleRegion(u32 base, u32 size)
     : Region(base, size)
 {
     m_data = (u8*)calloc(1, size);
-    m_shadow_data = (u8*)malloc(size);
-    memset(m_shadow_data, 1, size);
+    m_shadow_data = (u8*)malloc(shadow_bits_size_for(size));
+    memset(m_shadow_data, 0xff, shadow_bits_size_for(size));
 }
 
 SimpleRegion::~SimpleRegion()
@@ -27,98 +28,93 @@ SimpleRegion::~SimpleRegion()
 ValueWithShadow<u8> SimpleRegion::read8(FlatPtr offset)
 {
     VERIFY(offset < size());
-    return { m_data[offset], m_shadow_data[offset] };
+    return { m_data[offset], load_shadow<u8>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u16> SimpleRegion::read16(u32 offset)
 {
     VERIFY(offset + 1 < size());
 
-    u16 value, shadow;
+    u16 value;
     ByteReader::load<u16>(m_data + offset, value);
-    ByteReader::load<u16>(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u16>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u32> SimpleRegion::read32(u32 offset)
 {
     VERIFY(offset + 3 < size());
 
-    u32 value, shadow;
+    u32 value;
     ByteReader::load<u32>(m_data + offset, value);
-    ByteReader::load<u32>(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u32>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u64> SimpleRegion::read64(u32 offset)
 {
     VERIFY(offset + 7 < size());
 
-    u64 value, shadow;
+    u64 value;
     ByteReader::load<u64>(m_data + offset, value);
-    ByteReader::load<u64>(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, load_shadow<u64>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u128> SimpleRegion::read128(u32 offset)
 {
     VERIFY(offset + 15 < size());
-    u128 value, shadow;
+    u128 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, load_shadow<u128>(m_shadow_data, offset) };
 }
 
 ValueWithShadow<u256> SimpleRegion::read256(u32 offset)
 {
     VERIFY(offset + 31 < size());
-    u256 value, shadow;
+    u256 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, load_shadow<u256>(m_shadow_data, offset) };
 }
 
 void SimpleRegion::write8(u32 offset, ValueWithShadow<u8> value)
 {
     VERIFY(offset < size());
     m_data[offset] = value.value();
-    m_shadow_data[offset] = value.shadow();
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void SimpleRegion::write16(u32 offset, ValueWithShadow<u16> value)
 {
     VERIFY(offset + 1 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void SimpleRegion::write32(u32 offset, ValueWithShadow<u32> value)
 {
     VERIFY(offset + 3 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 void SimpleRegion::write64(u32 offset, ValueWithShadow<u64> value)
 {
     VERIFY(offset + 7 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 void SimpleRegion::write128(u32 offset, ValueWithShadow<u128> value)
 {
     VERIFY(offset + 15 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 void SimpleRegion::write256(u32 offset, ValueWithShadow<u256> value)
 {
     VERIFY(offset + 31 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    store_shadow(m_shadow_data, offset, value.shadow());
 }
 
 u8* SimpleRegion::cacheable_ptr(u32 offset)
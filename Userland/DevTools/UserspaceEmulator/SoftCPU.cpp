@@ -104,11 +104,67 @@ void SoftCPU::update_code_cache()
         TODO();
     }
 
-    // FIXME: This cache needs to be invalidated if the code region is ever unmapped.
     m_cached_code_region = region;
     m_cached_code_base_ptr = region->data();
 }
 
+X86::Instruction SoftCPU::fetch_instruction()
+{
+    bool falls_through = m_current_block && m_eip == m_current_block->instructions[m_current_block_index].next_eip;
+    if (falls_through && m_current_block_index + 1 < max_block_length) {
+        ++m_current_block_index;
+    } else {
+        auto it = m_decoded_blocks.find(m_eip);
+        if (it == m_decoded_blocks.end()) {
+            auto block = make<DecodedBlock>();
+            m_current_block = block.ptr();
+            m_decoded_blocks.set(m_eip, move(block));
+        } else {
+            m_current_block = it->value.ptr();
+        }
+        m_current_block_index = 0;
+    }
+
+    auto& instructions = m_current_block->instructions;
+    if (m_current_block_index < instructions.size()) {
+        auto& decoded = instructions[m_current_block_index];
+        m_base_eip = decoded.eip;
+        m_eip = decoded.next_eip;
+        return decoded.instruction;
+    }
+
+    save_base_eip();
+    auto instruction = X86::Instruction::from_stream(*this, true, true);
+    size_t first_page = m_base_eip / PAGE_SIZE;
+    size_t last_page = (m_eip - 1) / PAGE_SIZE;
+    for (size_t page = first_page; page <= last_page; ++page) {
+        if (!m_page_has_decoded_instructions[page]) {
+            m_page_has_decoded_instructions[page] = true;
+            m_pages_with_decoded_instructions.append(page);
+        }
+    }
+    instructions.append({ instruction, m_base_eip, m_eip });
+    return instruction;
+}
+
+void SoftCPU::invalidate_decoded_instructions()
+{
+    for (auto page : m_pages_with_decoded_instructions)
+        m_page_has_decoded_instructions[page] = false;
+    m_pages_with_decoded_instructions.clear();
+    m_decoded_blocks.clear();
+    m_current_block = nullptr;
+}
+
+void SoftCPU::did_remove_region(Region const& region)
+{
+    did_modify_memory(region.base(), region.size());
+    if (m_cached_code_region == &region) {
+        m_cached_code_region = nullptr;
+        m_cached_code_base_ptr = nullptr;
+    }
+}
+
 ValueWithShadow<u8> SoftCPU::read_memory8(X86::LogicalAddress address)
 {
     VERIFY(address.selector() == 0x1b || address.selector() == 0x23 || address.selector() == 0x2b);
@@ -10,6 +10,9 @@
 #include "SoftFPU.h"
 #include "ValueWithShadow.h"
 #include <AK/ByteReader.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -58,6 +61,27 @@ public:
         m_eip = eip;
     }
 
+    // Returns the instruction at eip and moves eip past it, just like X86::Instruction::from_stream() would, but only
+    // decodes each instruction once. The decoded instructions are kept in blocks that run from where a jump landed up
+    // to where execution jumped away again, so following a block along doesn't even need a lookup.
+    X86::Instruction fetch_instruction();
+
+    // Has to be called whenever memory changes behind the decoded instructions' backs, be it a write or an munmap().
+    ALWAYS_INLINE void did_modify_memory(u32 address, size_t size)
+    {
+        if (!size)
+            return;
+        size_t first_page = address / PAGE_SIZE;
+        size_t last_page = min<size_t>((address + size - 1) / PAGE_SIZE, max_page_count - 1);
+        for (size_t page = first_page; page <= last_page; ++page) {
+            if (m_page_has_decoded_instructions[page]) [[unlikely]] {
+                invalidate_decoded_instructions();
+                return;
+            }
+        }
+    }
+    void did_remove_region(Region const&);
+
     struct Flags {
         enum Flag {
             CF = 0x0001, // 0b0000'0000'0000'0001
@@ -1168,6 +1192,7 @@ private:
     void generic_RM32_CL(Op, const X86::Instruction&);
 
     void update_code_cache();
+    void invalidate_decoded_instructions();
 
 private:
     Emulator& m_emulator;
@@ -1186,6 +1211,26 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+
+    struct DecodedInstruction {
+        X86::Instruction instruction;
+        u32 eip;
+        u32 next_eip;
+    };
+    struct DecodedBlock {
+        Vector<DecodedInstruction> instructions;
+    };
+
+    // Straight-line code longer than this continues in a block of its own.
+    static constexpr size_t max_block_length = 64;
+    static constexpr size_t max_page_count = 786432;
+
+    HashMap<u32, NonnullOwnPtr<DecodedBlock>> m_decoded_blocks;
+    DecodedBlock* m_current_block { nullptr };
+    size_t m_current_block_index { 0 };
+    // Which pages have instructions in m_decoded_blocks, so that writes elsewhere don't have to look any further.
+    bool m_page_has_decoded_instructions[max_page_count] { false };
+    Vector<u32> m_pages_with_decoded_instructions;
 };
 
 ALWAYS_INLINE u8 SoftCPU::read8()
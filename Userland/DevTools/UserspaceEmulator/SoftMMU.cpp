@@ -8,6 +8,7 @@
 #include "Emulator.h"
 #include "MmapRegion.h"
 #include "Report.h"
+#include "ShadowBits.h"
 #include <AK/ByteBuffer.h>
 #include <AK/Memory.h>
 #include <AK/QuickSort.h>
@@ -35,6 +36,10 @@ void SoftMMU::add_region(NonnullOwnPtr<Region> region)
 
 void SoftMMU::remove_region(Region& region)
 {
+    m_emulator.cpu().did_remove_region(region);
+    if (m_last_region == &region)
+        m_last_region = nullptr;
+
     size_t first_page_in_region = region.base() / PAGE_SIZE;
     for (size_t i = 0; i < ceil_div(region.size(), PAGE_SIZE); ++i) {
         m_page_to_region_map[first_page_in_region + i] = nullptr;
@@ -213,6 +218,8 @@ void SoftMMU::write8(X86::LogicalAddress address, ValueWithShadow<u8> value)
         TODO();
     }
     region->write8(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::write16(X86::LogicalAddress address, ValueWithShadow<u16> value)
@@ -231,6 +238,8 @@ void SoftMMU::write16(X86::LogicalAddress address, ValueWithShadow<u16> value)
     }
 
     region->write16(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::write32(X86::LogicalAddress address, ValueWithShadow<u32> value)
@@ -249,6 +258,8 @@ void SoftMMU::write32(X86::LogicalAddress address, ValueWithShadow<u32> value)
     }
 
     region->write32(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::write64(X86::LogicalAddress address, ValueWithShadow<u64> value)
@@ -267,6 +278,8 @@ void SoftMMU::write64(X86::LogicalAddress address, ValueWithShadow<u64> value)
     }
 
     region->write64(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::write128(X86::LogicalAddress address, ValueWithShadow<u128> value)
@@ -285,6 +298,8 @@ void SoftMMU::write128(X86::LogicalAddress address, ValueWithShadow<u128> value)
     }
 
     region->write128(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
@@ -303,6 +318,8 @@ void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
     }
 
     region->write256(address.offset() - region->base(), value);
+    if (address.selector() != 0x2b)
+        m_emulator.cpu().did_modify_memory(address.offset(), sizeof(value.value()));
 }
 
 void SoftMMU::copy_to_vm(FlatPtr destination, const void* source, size_t size)
@@ -347,7 +364,8 @@ bool SoftMMU::fast_fill_memory8(X86::LogicalAddress address, size_t size, ValueW
 
     size_t offset_in_region = address.offset() - region->base();
     memset(region->data() + offset_in_region, value.value(), size);
-    memset(region->shadow_data() + offset_in_region, value.shadow(), size);
+    fill_shadow(region->shadow_data(), offset_in_region, size, value.shadow() & 0x01);
+    m_emulator.cpu().did_modify_memory(address.offset(), size);
     return true;
 }
 
@@ -372,7 +390,13 @@ bool SoftMMU::fast_fill_memory32(X86::LogicalAddress address, size_t count, Valu
 
     size_t offset_in_region = address.offset() - region->base();
     fast_u32_fill((u32*)(region->data() + offset_in_region), value.value(), count);
-    fast_u32_fill((u32*)(region->shadow_data() + offset_in_region), value.shadow(), count);
+    if ((value.shadow() & 0x01010101) == 0x01010101 || (value.shadow() & 0x01010101) == 0) {
+        fill_shadow(region->shadow_data(), offset_in_region, count * sizeof(u32), value.shadow() & 0x01);
+    } else {
+        for (size_t i = 0; i < count; ++i)
+            store_shadow(region->shadow_data(), offset_in_region + i * sizeof(u32), value.shadow());
+    }
+    m_emulator.cpu().did_modify_memory(address.offset(), count * sizeof(u32));
     return true;
 }
 
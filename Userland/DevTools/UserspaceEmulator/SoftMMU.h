@@ -41,8 +41,15 @@ public:
         if (address.selector() == 0x2b)
             return m_tls_region.ptr();
 
+        // Most accesses land in the same region as the one before, so look there first.
+        if (m_last_region && m_last_region->contains(address.offset())) [[likely]]
+            return m_last_region;
+
         size_t page_index = address.offset() / PAGE_SIZE;
-        return m_page_to_region_map[page_index];
+        auto* region = m_page_to_region_map[page_index];
+        if (region)
+            m_last_region = region;
+        return region;
     }
 
     void add_region(NonnullOwnPtr<Region>);
@@ -97,6 +104,7 @@ private:
     Emulator& m_emulator;
 
     Region* m_page_to_region_map[786432] = { nullptr };
+    Region* m_last_region { nullptr };
 
     OwnPtr<Region> m_tls_region;
     NonnullOwnPtrVector<Region> m_regions;
@@ -37,6 +37,10 @@ Optional<Zip> Zip::try_create(const ReadonlyBytes& buffer)
     if (end_of_central_directory.disk_number != 0 || end_of_central_directory.central_directory_start_disk != 0 || end_of_central_directory.disk_records_count != end_of_central_directory.total_records_count)
         return {}; // TODO: support multi-volume zip archives
 
+    Zip zip;
+    zip.m_input_data = buffer;
+    zip.m_member_offsets.ensure_capacity(end_of_central_directory.total_records_count);
+
     size_t member_offset = end_of_central_directory.central_directory_offset;
     for (size_t i = 0; i < end_of_central_directory.total_records_count; i++) {
         CentralDirectoryRecord central_directory_record {};
@@ -48,7 +52,7 @@ Optional<Zip> Zip::try_create(const ReadonlyBytes& buffer)
             return {}; // TODO: support encrypted zip members
         if (central_directory_record.general_purpose_flags & 3)
             return {}; // TODO: support zip data descriptors
-        if (central_directory_record.compression_method != ZipCompressionMethod::Store && central_directory_record.compression_method != ZipCompressionMethod::Deflate)
+        if (central_directory_record.compression_method != ZipCompressionMethod::Store && central_directory_record.compression_method != ZipCompressionMethod::Deflate && central_directory_record.compression_method != ZipCompressionMethod::Zstd)
             return {}; // TODO: support obsolete zip compression methods
         if (central_directory_record.compression_method == ZipCompressionMethod::Store && central_directory_record.uncompressed_size != central_directory_record.compressed_size)
             return {};
@@ -63,44 +67,71 @@ Optional<Zip> Zip::try_create(const ReadonlyBytes& buffer)
             return {};
         if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < central_directory_record.compressed_size)
             return {};
+
+        String name { StringView { central_directory_record.name, central_directory_record.name_length } };
+        zip.m_member_indices.set(move(name), zip.m_member_offsets.size());
+        zip.m_member_offsets.append(member_offset);
         member_offset += central_directory_record.size();
     }
 
-    Zip zip;
-    zip.m_input_data = buffer;
-    zip.member_count = end_of_central_directory.total_records_count;
-    zip.members_start_offset = end_of_central_directory.central_directory_offset;
     return zip;
 }
 
+Optional<Zip> Zip::try_create(NonnullRefPtr<MappedFile> mapped_file)
+{
+    auto zip = try_create(mapped_file->bytes());
+    if (!zip.has_value())
+        return {};
+    zip->m_mapped_file = move(mapped_file);
+    return zip;
+}
+
+ZipMember Zip::member_at(size_t index) const
+{
+    CentralDirectoryRecord central_directory_record {};
+    VERIFY(central_directory_record.read(m_input_data.slice(m_member_offsets[index])));
+    LocalFileHeader local_file_header {};
+    VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
+
+    ZipMember member;
+    member.name = StringView { central_directory_record.name, central_directory_record.name_length };
+    member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
+    member.compression_method = static_cast<ZipCompressionMethod>(central_directory_record.compression_method);
+    member.uncompressed_size = central_directory_record.uncompressed_size;
+    member.crc32 = central_directory_record.crc32;
+    member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.ends_with('/'); // FIXME: better directory detection
+    return member;
+}
+
+Optional<ZipMember> Zip::find_member(const StringView& name) const
+{
+    auto index = m_member_indices.get(name);
+    if (!index.has_value())
+        return {};
+    return member_at(index.value());
+}
+
 bool Zip::for_each_member(Function<IterationDecision(const ZipMember&)> callback)
 {
-    size_t member_offset = members_start_offset;
-    for (size_t i = 0; i < member_count; i++) {
-        CentralDirectoryRecord central_directory_record {};
-        VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
-        LocalFileHeader local_file_header {};
-        VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
-
-        ZipMember member;
-        char null_terminated_name[central_directory_record.name_length + 1];
-        memcpy(null_terminated_name, central_directory_record.name, central_directory_record.name_length);
-        null_terminated_name[central_directory_record.name_length] = 0;
-        member.name = String { null_terminated_name };
-        member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
-        member.compression_method = static_cast<ZipCompressionMethod>(central_directory_record.compression_method);
-        member.uncompressed_size = central_directory_record.uncompressed_size;
-        member.crc32 = central_directory_record.crc32;
-        member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.ends_with('/'); // FIXME: better directory detection
-
-        if (callback(member) == IterationDecision::Break)
+    for (size_t i = 0; i < member_count(); i++) {
+        if (callback(member_at(i)) == IterationDecision::Break)
             return false;
-
-        member_offset += central_directory_record.size();
     }
     return true;
 }
 
+static u16 minimum_version_for(ZipCompressionMethod compression_method)
+{
+    switch (compression_method) {
+    case ZipCompressionMethod::Deflate:
+        return 20; // Deflate was added in PKZip 2.0
+    case ZipCompressionMethod::Zstd:
+        return 63; // Zstandard was added in version 6.3.7 of the specification
+    default:
+        return 10;
+    }
+}
+
 ZipOutputStream::ZipOutputStream(OutputStream& stream)
     : m_stream(stream)
 {
@@ -114,7 +145,7 @@ void ZipOutputStream::add_member(const ZipMember& member)
     m_members.append(member);
 
     LocalFileHeader local_file_header {};
-    local_file_header.minimum_version = member.compression_method == ZipCompressionMethod::Deflate ? 20 : 10; // Deflate was added in PKZip 2.0
+    local_file_header.minimum_version = minimum_version_for(member.compression_method);
     local_file_header.general_purpose_flags = 0;
     local_file_header.compression_method = static_cast<u16>(member.compression_method);
     local_file_header.modification_time = 0; // TODO: support modification time
@@ -139,7 +170,7 @@ void ZipOutputStream::finish()
     auto central_directory_size = 0;
     for (const ZipMember& member : m_members) {
         CentralDirectoryRecord central_directory_record {};
-        auto zip_version = member.compression_method == ZipCompressionMethod::Deflate ? 20 : 10; // Deflate was added in PKZip 2.0
+        auto zip_version = minimum_version_for(member.compression_method);
         central_directory_record.made_by_version = zip_version;
         central_directory_record.minimum_version = zip_version;
         central_directory_record.general_purpose_flags = 0;
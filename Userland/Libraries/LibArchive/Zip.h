@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/IterationDecision.h>
+#include <AK/MappedFile.h>
 #include <AK/Span.h>
 #include <AK/Stream.h>
 #include <AK/String.h>
@@ -193,7 +195,8 @@ enum ZipCompressionMethod : u16 {
     Reduce4 = 5,
     Implode = 6,
     Reserved = 7,
-    Deflate = 8
+    Deflate = 8,
+    Zstd = 93
 };
 
 struct ZipMember {
@@ -208,14 +211,24 @@ struct ZipMember {
 class Zip {
 public:
     static Optional<Zip> try_create(const ReadonlyBytes& buffer);
+    // Members read straight out of the mapping, which is kept alive for as long as the Zip is.
+    static Optional<Zip> try_create(NonnullRefPtr<MappedFile>);
+
+    size_t member_count() const { return m_member_offsets.size(); }
+    ZipMember member_at(size_t index) const;
+    Optional<ZipMember> find_member(const StringView& name) const;
     bool for_each_member(Function<IterationDecision(const ZipMember&)>);
 
 private:
     static bool find_end_of_central_directory_offset(const ReadonlyBytes&, size_t& offset);
 
-    u16 member_count { 0 };
-    size_t members_start_offset { 0 };
     ReadonlyBytes m_input_data;
+    RefPtr<MappedFile> m_mapped_file;
+
+    // The offset of every member's central directory record, and the index of every member by name.
+    // Members with the same name are looked up as the last one, which is the one that wins on extraction.
+    Vector<size_t> m_member_offsets;
+    HashMap<String, size_t> m_member_indices;
 };
 
 class ZipOutputStream {
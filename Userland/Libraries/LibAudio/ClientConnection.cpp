@@ -6,6 +6,7 @@
 
 #include <LibAudio/Buffer.h>
 #include <LibAudio/ClientConnection.h>
+#include <unistd.h>
 
 namespace Audio {
 
@@ -14,6 +15,12 @@ ClientConnection::ClientConnection()
 {
 }
 
+ClientConnection::~ClientConnection()
+{
+    if (m_stream_fd >= 0)
+        close(m_stream_fd);
+}
+
 void ClientConnection::enqueue(Buffer const& buffer)
 {
     for (;;) {
@@ -36,6 +43,52 @@ bool ClientConnection::try_enqueue(Buffer const& buffer)
     return enqueue_buffer(buffer.anonymous_buffer(), buffer.id(), buffer.sample_count());
 }
 
+bool ClientConnection::open_stream()
+{
+    auto response = create_stream();
+    if (!response.wakeup_fd().has_value())
+        return false;
+    int fd = response.wakeup_fd().value().take_fd();
+    auto stream = Core::SharedRingBuffer::attach(response.ring_buffer());
+    if (!stream.has_value()) {
+        close(fd);
+        return false;
+    }
+    if (m_stream_fd >= 0)
+        close(m_stream_fd);
+    m_stream = stream.release_value();
+    m_stream_fd = fd;
+    return true;
+}
+
+size_t ClientConnection::try_write_to_stream(Span<Frame const> frames)
+{
+    VERIFY(m_stream.has_value());
+    // Only ever writing whole frames keeps the mixer from seeing half of one.
+    return m_stream->write({ frames.data(), frames.size() * sizeof(Frame) }) / sizeof(Frame);
+}
+
+void ClientConnection::write_to_stream(Span<Frame const> frames)
+{
+    for (;;) {
+        frames = frames.slice(try_write_to_stream(frames));
+        if (frames.is_empty())
+            return;
+        if (!m_stream->prepare_to_wait_for_room())
+            continue;
+        // The pipe only carries wake-up calls, until it's closed because AudioServer has dropped the stream.
+        u8 wakeups[64];
+        if (read(m_stream_fd, wakeups, sizeof(wakeups)) <= 0)
+            return;
+    }
+}
+
+size_t ClientConnection::frames_in_stream() const
+{
+    VERIFY(m_stream.has_value());
+    return m_stream->size() / sizeof(Frame);
+}
+
 void ClientConnection::finished_playing_buffer(i32 buffer_id)
 {
     if (on_finish_playing_buffer)
@@ -8,11 +8,13 @@
 
 #include <AudioServer/AudioClientEndpoint.h>
 #include <AudioServer/AudioServerEndpoint.h>
+#include <LibCore/SharedRingBuffer.h>
 #include <LibIPC/ServerConnection.h>
 
 namespace Audio {
 
 class Buffer;
+struct Frame;
 
 class ClientConnection final
     : public IPC::ServerConnection<AudioClientEndpoint, AudioServerEndpoint>
@@ -20,11 +22,22 @@ class ClientConnection final
     C_OBJECT(ClientConnection)
 public:
     ClientConnection();
+    virtual ~ClientConnection() override;
 
     void enqueue(Buffer const&);
     bool try_enqueue(Buffer const&);
     void async_enqueue(Buffer const&);
 
+    // Instead of enqueuing buffers, samples can be written to a stream in shared memory, from where the mixer
+    // picks them up as it goes. This costs no IPC at all, and keeps only a couple of mixing periods queued up.
+    bool open_stream();
+    // Writes as many frames as there's room for, and returns how many that were.
+    size_t try_write_to_stream(Span<Frame const>);
+    // Writes all of the frames, waiting for the mixer to make room as needed.
+    void write_to_stream(Span<Frame const>);
+    // How many frames the mixer has yet to pick up.
+    size_t frames_in_stream() const;
+
     Function<void(i32 buffer_id)> on_finish_playing_buffer;
     Function<void(bool muted)> on_muted_state_change;
     Function<void(int volume)> on_main_mix_volume_change;
@@ -33,6 +46,9 @@ private:
     virtual void finished_playing_buffer(i32) override;
     virtual void muted_state_changed(bool) override;
     virtual void main_mix_volume_changed(i32) override;
+
+    Optional<Core::SharedRingBuffer> m_stream;
+    int m_stream_fd { -1 };
 };
 
 }
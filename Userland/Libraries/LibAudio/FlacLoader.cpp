@@ -6,19 +6,85 @@
 
 #include "FlacLoader.h"
 #include "Buffer.h"
-#include <AK/BitStream.h>
+#include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/FlyString.h>
 #include <AK/Format.h>
 #include <AK/Math.h>
-#include <AK/Stream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/File.h>
-#include <LibCore/FileStream.h>
+#include <string.h>
 
 namespace Audio {
 
+void FlacBitReader::set_error()
+{
+    m_has_error = true;
+    m_bit_offset = m_data.size() * 8;
+}
+
+void FlacBitReader::seek_to_byte(size_t offset)
+{
+    if (offset > m_data.size()) {
+        set_error();
+        return;
+    }
+    m_bit_offset = offset * 8;
+    m_has_error = false;
+}
+
+u32 FlacBitReader::read_bits(u8 count)
+{
+    VERIFY(count <= 32);
+    if (count == 0)
+        return 0;
+    if (m_bit_offset + count > m_data.size() * 8) {
+        set_error();
+        return 0;
+    }
+    // The bits are spread over at most five bytes.
+    size_t first_byte = m_bit_offset / 8;
+    size_t last_byte = (m_bit_offset + count - 1) / 8;
+    u64 bits = 0;
+    for (size_t i = first_byte; i <= last_byte; ++i)
+        bits = (bits << 8) | m_data[i];
+    bits >>= (last_byte + 1) * 8 - m_bit_offset - count;
+    m_bit_offset += count;
+    return bits & ((1ull << count) - 1);
+}
+
+u32 FlacBitReader::read_unary()
+{
+    u32 zeros = 0;
+    while (m_bit_offset < m_data.size() * 8) {
+        u8 bit_in_byte = m_bit_offset % 8;
+        u8 remaining_bits = m_data[m_bit_offset / 8] << bit_in_byte;
+        if (remaining_bits != 0) {
+            u8 leading_zeros = __builtin_clz(remaining_bits) - 24;
+            m_bit_offset += leading_zeros + 1;
+            return zeros + leading_zeros;
+        }
+        zeros += 8 - bit_in_byte;
+        m_bit_offset += 8 - bit_in_byte;
+    }
+    set_error();
+    return 0;
+}
+
+ReadonlyBytes FlacBitReader::read_bytes(size_t count)
+{
+    VERIFY(m_bit_offset % 8 == 0);
+    if (byte_offset() + count > m_data.size()) {
+        set_error();
+        return {};
+    }
+    auto bytes = m_data.slice(byte_offset(), count);
+    m_bit_offset += count * 8;
+    return bytes;
+}
+
 FlacLoaderPlugin::FlacLoaderPlugin(const StringView& path)
     : m_file(Core::File::construct(path))
 {
@@ -26,24 +92,27 @@ FlacLoaderPlugin::FlacLoaderPlugin(const StringView& path)
         m_error_string = String::formatted("Can't open file: {}", m_file->error_string());
         return;
     }
+    auto mapped_file_or_error = MappedFile::map(path);
+    if (mapped_file_or_error.is_error()) {
+        m_error_string = String::formatted("Can't map file: {}", mapped_file_or_error.error().string());
+        return;
+    }
+    m_mapped_file = mapped_file_or_error.release_value();
+    m_reader = FlacBitReader(m_mapped_file->bytes());
 
     m_valid = parse_header();
     if (!m_valid)
         return;
 
-    m_stream = make<FlacInputStream>(Core::InputFileStream(*m_file));
     reset();
 
     m_resampler = make<ResampleHelper<double>>(m_sample_rate, 44100);
 }
 
 FlacLoaderPlugin::FlacLoaderPlugin(const ByteBuffer& buffer)
+    : m_buffer(buffer)
 {
-    m_stream = make<FlacInputStream>(InputMemoryStream(buffer));
-    if (!m_stream) {
-        m_error_string = String::formatted("Can't open memory stream");
-        return;
-    }
+    m_reader = FlacBitReader(m_buffer.bytes());
 
     m_valid = parse_header();
     if (!m_valid)
@@ -60,17 +129,8 @@ bool FlacLoaderPlugin::sniff()
 
 bool FlacLoaderPlugin::parse_header()
 {
-    Optional<Core::InputFileStream> fis;
     bool ok = true;
 
-    InputBitStream bit_input = [&]() -> InputBitStream {
-        if (m_file) {
-            fis = Core::InputFileStream(*m_file);
-            return InputBitStream(*fis);
-        }
-        return InputBitStream(m_stream->get<InputMemoryStream>());
-    }();
-
 #define CHECK_OK(msg)                                                      \
     do {                                                                   \
         if (!ok) {                                                         \
@@ -80,36 +140,34 @@ bool FlacLoaderPlugin::parse_header()
     } while (0)
 
     // Magic number
-    u32 flac = bit_input.read_bits_big_endian(32);
-    m_data_start_location += 4;
+    u32 flac = m_reader.read_bits(32);
     ok = ok && flac == 0x664C6143; // "flaC"
     CHECK_OK("FLAC magic number");
 
     // Receive the streaminfo block
-    FlacRawMetadataBlock streaminfo = next_meta_block(bit_input);
+    FlacRawMetadataBlock streaminfo = next_meta_block();
     // next_meta_block sets the error string if something goes wrong
     ok = ok && m_error_string.is_empty();
     CHECK_OK(m_error_string);
     ok = ok && (streaminfo.type == FlacMetadataBlockType::STREAMINFO);
     CHECK_OK("First block type");
-    InputMemoryStream streaminfo_data_memory(streaminfo.data.bytes());
-    InputBitStream streaminfo_data(streaminfo_data_memory);
+    FlacBitReader streaminfo_data(streaminfo.data.bytes());
 
     // STREAMINFO block
-    m_min_block_size = streaminfo_data.read_bits_big_endian(16);
+    m_min_block_size = streaminfo_data.read_bits(16);
     ok = ok && (m_min_block_size >= 16);
     CHECK_OK("Minimum block size");
-    m_max_block_size = streaminfo_data.read_bits_big_endian(16);
+    m_max_block_size = streaminfo_data.read_bits(16);
     ok = ok && (m_max_block_size >= 16);
     CHECK_OK("Maximum block size");
-    m_min_frame_size = streaminfo_data.read_bits_big_endian(24);
-    m_max_frame_size = streaminfo_data.read_bits_big_endian(24);
-    m_sample_rate = streaminfo_data.read_bits_big_endian(20);
+    m_min_frame_size = streaminfo_data.read_bits(24);
+    m_max_frame_size = streaminfo_data.read_bits(24);
+    m_sample_rate = streaminfo_data.read_bits(20);
     ok = ok && (m_sample_rate <= 655350);
     CHECK_OK("Sample rate");
-    m_num_channels = streaminfo_data.read_bits_big_endian(3) + 1; // 0 ^= one channel
+    m_num_channels = streaminfo_data.read_bits(3) + 1; // 0 ^= one channel
 
-    u8 bits_per_sample = streaminfo_data.read_bits_big_endian(5) + 1;
+    u8 bits_per_sample = streaminfo_data.read_bits(5) + 1;
     if (bits_per_sample == 8) {
         // FIXME: Signed/Unsigned issues?
         m_sample_format = PcmSampleFormat::Uint8;
@@ -124,24 +182,29 @@ bool FlacLoaderPlugin::parse_header()
         CHECK_OK("Sample bit depth");
     }
 
-    m_total_samples = streaminfo_data.read_bits_big_endian(36);
-    // Parse checksum into a buffer first
-    ByteBuffer md5_checksum = ByteBuffer::create_uninitialized(128 / 8);
-    streaminfo_data.read(md5_checksum);
-    md5_checksum.bytes().copy_to({ m_md5_checksum, sizeof(m_md5_checksum) });
+    m_total_samples = static_cast<u64>(streaminfo_data.read_bits(4)) << 32;
+    m_total_samples |= streaminfo_data.read_bits(32);
+    auto md5_checksum = streaminfo_data.read_bytes(128 / 8);
+    ok = ok && !streaminfo_data.has_error();
+    CHECK_OK("STREAMINFO size");
+    md5_checksum.copy_to({ m_md5_checksum, sizeof(m_md5_checksum) });
 
     // Parse other blocks
-    // TODO: For a simple first implementation, all other blocks are skipped as allowed by the FLAC specification.
-    // Especially the SEEKTABLE block may become useful in a more sophisticated version.
+    // All blocks except for the SEEKTABLE are skipped as allowed by the FLAC specification.
     [[maybe_unused]] u16 meta_blocks_parsed = 1;
     [[maybe_unused]] u16 total_meta_blocks = meta_blocks_parsed;
     FlacRawMetadataBlock block = streaminfo;
     while (!block.is_last_block) {
-        block = next_meta_block(bit_input);
+        block = next_meta_block();
         ++total_meta_blocks;
         ok = ok && m_error_string.is_empty();
         CHECK_OK(m_error_string);
+        if (block.type == FlacMetadataBlockType::SEEKTABLE) {
+            parse_seek_table(block.data);
+            ++meta_blocks_parsed;
+        }
     }
+    m_data_start_location = m_reader.byte_offset();
 
     if constexpr (AFLACLOADER_DEBUG) {
         // HACK: u128 should be able to format itself
@@ -149,73 +212,116 @@ bool FlacLoaderPlugin::parse_header()
         for (unsigned int i = 0; i < md5_checksum.size(); ++i) {
             checksum_string.appendff("{:0X}", md5_checksum[i]);
         }
-        dbgln("Parsed FLAC header: blocksize {}-{}{}, framesize {}-{}, {}Hz, {}bit, {} channels, {} samples total ({:.2f}s), MD5 {}, data start at {:x} bytes, {} headers total (skipped {})", m_min_block_size, m_max_block_size, is_fixed_blocksize_stream() ? " (constant)" : "", m_min_frame_size, m_max_frame_size, m_sample_rate, pcm_bits_per_sample(m_sample_format), m_num_channels, m_total_samples, m_total_samples / static_cast<double>(m_sample_rate), checksum_string.to_string(), m_data_start_location, total_meta_blocks, total_meta_blocks - meta_blocks_parsed);
+        dbgln("Parsed FLAC header: blocksize {}-{}{}, framesize {}-{}, {}Hz, {}bit, {} channels, {} samples total ({:.2f}s), MD5 {}, data start at {:x} bytes, {} seek points, {} headers total (skipped {})", m_min_block_size, m_max_block_size, is_fixed_blocksize_stream() ? " (constant)" : "", m_min_frame_size, m_max_frame_size, m_sample_rate, pcm_bits_per_sample(m_sample_format), m_num_channels, m_total_samples, m_total_samples / static_cast<double>(m_sample_rate), checksum_string.to_string(), m_data_start_location, m_seek_table.size(), total_meta_blocks, total_meta_blocks - meta_blocks_parsed);
     }
 
     return true;
 #undef CHECK_OK
 }
 
-FlacRawMetadataBlock FlacLoaderPlugin::next_meta_block(InputBitStream& bit_input)
+FlacRawMetadataBlock FlacLoaderPlugin::next_meta_block()
 {
-#define CHECK_IO_ERROR()                    \
-    do {                                    \
-        if (bit_input.handle_any_error()) { \
-            m_error_string = "Read error";  \
-            return FlacRawMetadataBlock {}; \
-        }                                   \
-    } while (0)
-
-    bool is_last_block = bit_input.read_bit_big_endian();
-    CHECK_IO_ERROR();
+    bool is_last_block = m_reader.read_bit();
     // The block type enum constants agree with the specification
-    FlacMetadataBlockType type = (FlacMetadataBlockType)bit_input.read_bits_big_endian(7);
-    CHECK_IO_ERROR();
+    FlacMetadataBlockType type = (FlacMetadataBlockType)m_reader.read_bits(7);
     if (type == FlacMetadataBlockType::INVALID) {
         m_error_string = "Invalid metadata block";
         return FlacRawMetadataBlock {};
     }
-    m_data_start_location += 1;
 
-    u32 block_length = bit_input.read_bits_big_endian(24);
-    m_data_start_location += 3;
-    CHECK_IO_ERROR();
-    ByteBuffer block_data = ByteBuffer::create_uninitialized(block_length);
-    // Reads exactly the bytes necessary into the Bytes container
-    bit_input.read(block_data);
-    m_data_start_location += block_length;
-    CHECK_IO_ERROR();
+    u32 block_length = m_reader.read_bits(24);
+    auto block_data = m_reader.read_bytes(block_length);
+    if (m_reader.has_error()) {
+        m_error_string = "Read error";
+        return FlacRawMetadataBlock {};
+    }
     return FlacRawMetadataBlock {
         is_last_block,
         type,
         block_length,
-        block_data,
+        ByteBuffer::copy(block_data),
     };
+}
 
-#undef CHECK_IO_ERROR
+void FlacLoaderPlugin::parse_seek_table(ReadonlyBytes data)
+{
+    constexpr size_t seek_point_size = 18;
+    constexpr u64 placeholder_sample_index = NumericLimits<u64>::max();
+
+    FlacBitReader reader(data);
+    for (size_t i = 0; i < data.size() / seek_point_size; ++i) {
+        u64 sample_index = static_cast<u64>(reader.read_bits(32)) << 32;
+        sample_index |= reader.read_bits(32);
+        u64 byte_offset = static_cast<u64>(reader.read_bits(32)) << 32;
+        byte_offset |= reader.read_bits(32);
+        [[maybe_unused]] u16 sample_count = reader.read_bits(16);
+        // Seek points are sorted by their sample, and placeholders come last.
+        if (sample_index == placeholder_sample_index)
+            break;
+        if (!m_seek_table.is_empty() && sample_index <= m_seek_table.last().sample_index)
+            continue;
+        m_seek_table.append({ sample_index, byte_offset });
+    }
 }
 
 void FlacLoaderPlugin::reset()
 {
-    seek(m_data_start_location);
-    m_current_frame.clear();
+    seek(0);
 }
 
-void FlacLoaderPlugin::seek(const int position)
+void FlacLoaderPlugin::seek(const int sample_index)
 {
-    m_stream->seek(position);
+    u64 target = clamp<i64>(sample_index, 0, m_total_samples);
+
+    // Decoding has to start at the beginning of a frame, so find the closest known one before the target. That's
+    // either a seek point, or the current frame when we're already getting there.
+    u64 start_sample = 0;
+    u64 start_offset = m_data_start_location;
+    for (auto& seek_point : m_seek_table) {
+        if (seek_point.sample_index > target || m_data_start_location + seek_point.byte_offset >= m_reader.size())
+            break;
+        start_sample = seek_point.sample_index;
+        start_offset = m_data_start_location + seek_point.byte_offset;
+    }
+
+    if (m_current_frame.has_value() && m_loaded_samples <= target && m_loaded_samples > start_sample) {
+        // Carry on from here.
+    } else {
+        m_reader.seek_to_byte(start_offset);
+        m_error_string = {};
+        m_current_frame.clear();
+        m_current_frame_data.clear_with_capacity();
+        m_current_frame_position = 0;
+        m_loaded_samples = start_sample;
+    }
+
+    // Then skip the samples up to the target, decoding whatever frames are in between.
+    while (m_loaded_samples < target) {
+        if (!m_current_frame.has_value()) {
+            next_frame();
+            if (!m_error_string.is_empty()) {
+                dbgln("Frame parsing error while seeking: {}", m_error_string);
+                return;
+            }
+        }
+        size_t skipped = min<u64>(m_current_frame_data.size() - m_current_frame_position, target - m_loaded_samples);
+        m_current_frame_position += skipped;
+        m_loaded_samples += skipped;
+        if (m_current_frame_position == m_current_frame_data.size())
+            m_current_frame.clear();
+    }
 }
 
-// TODO implement these
-RefPtr<Buffer> FlacLoaderPlugin::get_more_samples([[maybe_unused]] size_t max_bytes_to_read_from_input)
+RefPtr<Buffer> FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_input)
 {
-    Vector<Frame> samples;
     ssize_t remaining_samples = m_total_samples - m_loaded_samples;
     if (remaining_samples <= 0) {
         return nullptr;
     }
 
     size_t samples_to_read = min(max_bytes_to_read_from_input, remaining_samples);
+    Vector<Frame> samples;
+    samples.ensure_capacity(samples_to_read);
     while (samples_to_read > 0) {
         if (!m_current_frame.has_value()) {
             next_frame();
@@ -223,16 +329,14 @@ RefPtr<Buffer> FlacLoaderPlugin::get_more_samples([[maybe_unused]] size_t max_by
                 dbgln("Frame parsing error: {}", m_error_string);
                 return nullptr;
             }
-            // HACK: Test the start of the next subframe
-            // auto input = m_stream->bit_stream();
-            // u64 next = input.read_bits_big_endian(64);
-            // dbgln("After frame end: {}", next);
         }
-        samples.append(m_current_frame_data.take_first());
-        if (m_current_frame_data.size() == 0) {
+        auto frame_samples = m_current_frame_data.span().slice(m_current_frame_position);
+        frame_samples = frame_samples.trim(samples_to_read);
+        samples.append(frame_samples.data(), frame_samples.size());
+        m_current_frame_position += frame_samples.size();
+        if (m_current_frame_position == m_current_frame_data.size())
             m_current_frame.clear();
-        }
-        --samples_to_read;
+        samples_to_read -= frame_samples.size();
     }
 
     m_loaded_samples += samples.size();
@@ -242,15 +346,14 @@ RefPtr<Buffer> FlacLoaderPlugin::get_more_samples([[maybe_unused]] size_t max_by
 void FlacLoaderPlugin::next_frame()
 {
     bool ok = true;
-    InputBitStream bit_stream = m_stream->bit_stream();
-#define CHECK_OK(msg)                                                                                                      \
-    do {                                                                                                                   \
-        if (!ok) {                                                                                                         \
-            m_error_string = String::formatted("Frame parsing failed: {}", msg);                                           \
-            bit_stream.align_to_byte_boundary();                                                                           \
-            dbgln_if(AFLACLOADER_DEBUG, "Crash in FLAC loader: next bytes are {:x}", bit_stream.read_bits_big_endian(32)); \
-            return;                                                                                                        \
-        }                                                                                                                  \
+#define CHECK_OK(msg)                                                                                         \
+    do {                                                                                                      \
+        if (!ok) {                                                                                            \
+            m_error_string = String::formatted("Frame parsing failed: {}", msg);                              \
+            m_reader.align_to_byte_boundary();                                                                \
+            dbgln_if(AFLACLOADER_DEBUG, "Crash in FLAC loader: next bytes are {:x}", m_reader.read_bits(32)); \
+            return;                                                                                           \
+        }                                                                                                     \
     } while (0)
 
 #define CHECK_ERROR_STRING                                             \
@@ -264,54 +367,56 @@ void FlacLoaderPlugin::next_frame()
     // TODO: Check the CRC-16 checksum (and others) by keeping track of read data
 
     // FLAC frame sync code starts header
-    u16 sync_code = bit_stream.read_bits_big_endian(14);
+    u16 sync_code = m_reader.read_bits(14);
     ok = ok && (sync_code == 0b11111111111110);
     CHECK_OK("Sync code");
-    bool reserved_bit = bit_stream.read_bit_big_endian();
+    bool reserved_bit = m_reader.read_bit();
     ok = ok && (reserved_bit == 0);
     CHECK_OK("Reserved frame header bit");
-    [[maybe_unused]] bool blocking_strategy = bit_stream.read_bit_big_endian();
+    [[maybe_unused]] bool blocking_strategy = m_reader.read_bit();
 
-    u32 sample_count = convert_sample_count_code(bit_stream.read_bits_big_endian(4));
+    u32 sample_count = convert_sample_count_code(m_reader.read_bits(4));
     CHECK_ERROR_STRING;
 
-    u32 frame_sample_rate = convert_sample_rate_code(bit_stream.read_bits_big_endian(4));
+    u32 frame_sample_rate = convert_sample_rate_code(m_reader.read_bits(4));
     CHECK_ERROR_STRING;
 
-    u8 channel_type_num = bit_stream.read_bits_big_endian(4);
+    u8 channel_type_num = m_reader.read_bits(4);
     if (channel_type_num >= 0b1011) {
         ok = false;
         CHECK_OK("Channel assignment");
     }
     FlacFrameChannelType channel_type = (FlacFrameChannelType)channel_type_num;
 
-    PcmSampleFormat bit_depth = convert_bit_depth_code(bit_stream.read_bits_big_endian(3));
+    PcmSampleFormat bit_depth = convert_bit_depth_code(m_reader.read_bits(3));
     CHECK_ERROR_STRING;
 
-    reserved_bit = bit_stream.read_bit_big_endian();
+    reserved_bit = m_reader.read_bit();
     ok = ok && (reserved_bit == 0);
     CHECK_OK("Reserved frame header end bit");
 
     // FIXME: sample number can be 8-56 bits, frame number can be 8-48 bits
-    m_current_sample_or_frame = read_utf8_char(bit_stream);
+    m_current_sample_or_frame = read_utf8_char(m_reader);
 
     // Conditional header variables
     if (sample_count == FLAC_BLOCKSIZE_AT_END_OF_HEADER_8) {
-        sample_count = bit_stream.read_bits_big_endian(8) + 1;
+        sample_count = m_reader.read_bits(8) + 1;
     } else if (sample_count == FLAC_BLOCKSIZE_AT_END_OF_HEADER_16) {
-        sample_count = bit_stream.read_bits_big_endian(16) + 1;
+        sample_count = m_reader.read_bits(16) + 1;
     }
 
     if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_8) {
-        frame_sample_rate = bit_stream.read_bits_big_endian(8) * 1000;
+        frame_sample_rate = m_reader.read_bits(8) * 1000;
     } else if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_16) {
-        frame_sample_rate = bit_stream.read_bits_big_endian(16);
+        frame_sample_rate = m_reader.read_bits(16);
     } else if (frame_sample_rate == FLAC_SAMPLERATE_AT_END_OF_HEADER_16X10) {
-        frame_sample_rate = bit_stream.read_bits_big_endian(16) * 10;
+        frame_sample_rate = m_reader.read_bits(16) * 10;
     }
 
     // TODO: check header checksum, see above
-    [[maybe_unused]] u8 checksum = bit_stream.read_bits(8);
+    [[maybe_unused]] u8 checksum = m_reader.read_bits(8);
+    ok = ok && !m_reader.has_error();
+    CHECK_OK("End of stream in frame header");
 
     dbgln_if(AFLACLOADER_DEBUG, "Frame: {} samples, {}bit {}Hz, channeltype {:x}, {} number {}, header checksum {}", sample_count, pcm_bits_per_sample(bit_depth), frame_sample_rate, channel_type_num, blocking_strategy ? "sample" : "frame", m_current_sample_or_frame, checksum);
 
@@ -323,29 +428,30 @@ void FlacLoaderPlugin::next_frame()
     };
 
     u8 subframe_count = frame_channel_type_to_channel_count(channel_type);
-    Vector<Vector<i32>> current_subframes;
-    current_subframes.ensure_capacity(subframe_count);
+    if (m_subframe_samples.size() < subframe_count)
+        m_subframe_samples.resize(subframe_count);
 
     for (u8 i = 0; i < subframe_count; ++i) {
-        FlacSubframeHeader new_subframe = next_subframe_header(bit_stream, i);
+        FlacSubframeHeader new_subframe = next_subframe_header(i);
         CHECK_ERROR_STRING;
-        Vector<i32> subframe_samples = parse_subframe(new_subframe, bit_stream);
-        // HACK: Test the start of the next subframe
+        parse_subframe(new_subframe, m_subframe_samples[i]);
         CHECK_ERROR_STRING;
-        current_subframes.append(move(subframe_samples));
     }
 
-    bit_stream.align_to_byte_boundary();
+    m_reader.align_to_byte_boundary();
 
     // TODO: check checksum, see above
-    [[maybe_unused]] u16 footer_checksum = bit_stream.read_bits_big_endian(16);
+    [[maybe_unused]] u16 footer_checksum = m_reader.read_bits(16);
+    ok = ok && !m_reader.has_error();
+    CHECK_OK("End of stream in frame");
 
-    Vector<i32> left, right;
+    // The channels are decoded in place, with the left and right channel ending up in the first two subframes.
+    auto* first = m_subframe_samples[0].data();
+    auto* second = subframe_count > 1 ? m_subframe_samples[1].data() : first;
+    sample_count = m_subframe_samples[0].size();
 
     switch (channel_type) {
     case FlacFrameChannelType::Mono:
-        left = right = current_subframes[0];
-        break;
     case FlacFrameChannelType::Stereo:
     // TODO mix together surround channels on each side?
     case FlacFrameChannelType::StereoCenter:
@@ -354,53 +460,43 @@ void FlacLoaderPlugin::next_frame()
     case FlacFrameChannelType::Surround5p1:
     case FlacFrameChannelType::Surround6p1:
     case FlacFrameChannelType::Surround7p1:
-        left = current_subframes[0];
-        right = current_subframes[1];
         break;
     case FlacFrameChannelType::LeftSideStereo:
         // channels are left (0) and side (1)
-        left = current_subframes[0];
-        right.ensure_capacity(left.size());
-        for (size_t i = 0; i < left.size(); ++i) {
+        for (size_t i = 0; i < sample_count; ++i) {
             // right = left - side
-            right.unchecked_append(left[i] - current_subframes[1][i]);
+            second[i] = first[i] - second[i];
         }
         break;
     case FlacFrameChannelType::RightSideStereo:
         // channels are side (0) and right (1)
-        right = current_subframes[1];
-        left.ensure_capacity(right.size());
-        for (size_t i = 0; i < right.size(); ++i) {
+        for (size_t i = 0; i < sample_count; ++i) {
             // left = right + side
-            left.unchecked_append(right[i] + current_subframes[0][i]);
+            first[i] = second[i] + first[i];
         }
         break;
     case FlacFrameChannelType::MidSideStereo:
         // channels are mid (0) and side (1)
-        left.ensure_capacity(current_subframes[0].size());
-        right.ensure_capacity(current_subframes[0].size());
-        for (size_t i = 0; i < current_subframes[0].size(); ++i) {
-            i64 mid = current_subframes[0][i];
-            i64 side = current_subframes[1][i];
-            mid *= 2;
-            // prevent integer division errors
-            left.unchecked_append(static_cast<i32>((mid + side) / 2));
-            right.unchecked_append(static_cast<i32>((mid - side) / 2));
+        for (size_t i = 0; i < sample_count; ++i) {
+            i64 side = second[i];
+            // The bit of the mid channel that got lost by averaging is the same as the lowest bit of the side channel.
+            i64 mid = (static_cast<i64>(first[i]) << 1) | (side & 1);
+            first[i] = static_cast<i32>((mid + side) >> 1);
+            second[i] = static_cast<i32>((mid - side) >> 1);
         }
         break;
     }
 
-    VERIFY(left.size() == right.size());
-
     // TODO: find the correct rescale offset
-    double sample_rescale = static_cast<double>(1 << pcm_bits_per_sample(m_current_frame->bit_depth));
-    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {:.1f}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
+    double sample_rescale = 1.0 / static_cast<double>(1 << pcm_bits_per_sample(m_current_frame->bit_depth));
+    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
 
     m_current_frame_data.clear_with_capacity();
-    m_current_frame_data.ensure_capacity(left.size());
+    m_current_frame_data.ensure_capacity(sample_count);
+    m_current_frame_position = 0;
     // zip together channels
-    for (size_t i = 0; i < left.size(); ++i) {
-        Frame frame = { left[i] / sample_rescale, right[i] / sample_rescale };
+    for (size_t i = 0; i < sample_count; ++i) {
+        Frame frame = { first[i] * sample_rescale, second[i] * sample_rescale };
         m_current_frame_data.unchecked_append(frame);
     }
 
@@ -495,7 +591,7 @@ u8 frame_channel_type_to_channel_count(FlacFrameChannelType channel_type)
     return 2;
 }
 
-FlacSubframeHeader FlacLoaderPlugin::next_subframe_header(InputBitStream& bit_stream, u8 channel_index)
+FlacSubframeHeader FlacLoaderPlugin::next_subframe_header(u8 channel_index)
 {
     u8 bits_per_sample = pcm_bits_per_sample(m_current_frame->bit_depth);
 
@@ -518,13 +614,13 @@ FlacSubframeHeader FlacLoaderPlugin::next_subframe_header(InputBitStream& bit_st
     }
 
     // zero-bit padding
-    if (bit_stream.read_bit_big_endian() != 0) {
+    if (m_reader.read_bit() != 0) {
         m_error_string = "Zero bit padding";
         return {};
     };
 
     // subframe type (encoding)
-    u8 subframe_code = bit_stream.read_bits_big_endian(6);
+    u8 subframe_code = m_reader.read_bits(6);
     if ((subframe_code >= 0b000010 && subframe_code <= 0b000111) || (subframe_code > 0b001100 && subframe_code < 0b100000)) {
         m_error_string = "Subframe type";
         return {};
@@ -545,15 +641,18 @@ FlacSubframeHeader FlacLoaderPlugin::next_subframe_header(InputBitStream& bit_st
     }
 
     // wasted bits per sample (unary encoding)
-    bool has_wasted_bits = bit_stream.read_bit_big_endian();
+    bool has_wasted_bits = m_reader.read_bit();
     u8 k = 0;
-    if (has_wasted_bits) {
-        bool current_k_bit = 0;
-        u8 k = 0;
-        do {
-            current_k_bit = bit_stream.read_bit_big_endian();
-            ++k;
-        } while (current_k_bit != 1);
+    if (has_wasted_bits)
+        k = m_reader.read_unary() + 1;
+
+    if (k >= bits_per_sample || bits_per_sample - k > 32) {
+        m_error_string = "Bits per sample";
+        return {};
+    }
+    if (order > m_current_frame->sample_count) {
+        m_error_string = "Predictor order exceeds block size";
+        return {};
     }
 
     return FlacSubframeHeader {
@@ -564,236 +663,263 @@ FlacSubframeHeader FlacLoaderPlugin::next_subframe_header(InputBitStream& bit_st
     };
 }
 
-Vector<i32> FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, InputBitStream& bit_input)
+// The vectorized linear predictor reads up to this many samples past the current one.
+static constexpr size_t lpc_window_padding = 3;
+
+void FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, Vector<i32>& samples)
 {
-    Vector<i32> samples;
+    u32 sample_count = m_current_frame->sample_count;
+    samples.resize_and_keep_capacity(sample_count + lpc_window_padding);
+    auto frame_samples = samples.span().trim(sample_count);
 
     switch (subframe_header.type) {
     case FlacSubframeType::Constant: {
-        u64 constant_value = bit_input.read_bits_big_endian(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample);
+        i32 constant_value = sign_extend(m_reader.read_bits(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample), subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample);
         dbgln_if(AFLACLOADER_DEBUG, "Constant subframe: {}", constant_value);
-
-        samples.ensure_capacity(m_current_frame->sample_count);
-        for (u32 i = 0; i < m_current_frame->sample_count; ++i) {
-            samples.unchecked_append(constant_value);
-        }
+        frame_samples.fill(constant_value);
         break;
     }
     case FlacSubframeType::Fixed: {
         dbgln_if(AFLACLOADER_DEBUG, "Fixed LPC subframe order {}", subframe_header.order);
-        samples = decode_fixed_lpc(subframe_header, bit_input);
+        decode_fixed_lpc(subframe_header, frame_samples);
         break;
     }
     case FlacSubframeType::Verbatim: {
         dbgln_if(AFLACLOADER_DEBUG, "Verbatim subframe");
-        samples = decode_verbatim(subframe_header, bit_input);
+        decode_verbatim(subframe_header, frame_samples);
         break;
     }
     case FlacSubframeType::LPC: {
         dbgln_if(AFLACLOADER_DEBUG, "Custom LPC subframe order {}", subframe_header.order);
-        samples = decode_custom_lpc(subframe_header, bit_input);
+        decode_custom_lpc(subframe_header, frame_samples);
         break;
     }
     default:
         m_error_string = "Unhandled FLAC subframe type";
-        return {};
-    }
-    if (!m_error_string.is_empty()) {
-        return {};
+        return;
     }
+    if (m_reader.has_error() && m_error_string.is_empty())
+        m_error_string = "End of stream in subframe";
+    if (!m_error_string.is_empty())
+        return;
 
-    for (size_t i = 0; i < samples.size(); ++i) {
-        samples[i] <<= subframe_header.wasted_bits_per_sample;
+    samples.resize_and_keep_capacity(sample_count);
+
+    if (subframe_header.wasted_bits_per_sample > 0) {
+        for (auto& sample : samples)
+            sample <<= subframe_header.wasted_bits_per_sample;
     }
 
-    ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
-    return resampler.resample(samples);
+    if (m_current_frame->sample_rate != m_sample_rate) {
+        ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
+        samples = resampler.resample(move(samples));
+    }
 }
 
 // Decode a subframe that isn't actually encoded
-Vector<i32> FlacLoaderPlugin::decode_verbatim([[maybe_unused]] FlacSubframeHeader& subframe, [[maybe_unused]] InputBitStream& bit_input)
+void FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, Span<i32> samples)
 {
-    TODO();
+    u8 bits_per_sample = subframe.bits_per_sample - subframe.wasted_bits_per_sample;
+    for (auto& sample : samples)
+        sample = sign_extend(m_reader.read_bits(bits_per_sample), bits_per_sample);
+}
+
+// Restores the samples from the residual, one at a time as each prediction depends on the samples before. As long as
+// the prediction can't overflow 32 bits, four of its terms are computed at once.
+static void restore_lpc(Span<i32> samples, Span<const i32> coefficients, u8 shift, bool fits_in_32_bits)
+{
+    size_t order = coefficients.size();
+
+    if (!fits_in_32_bits) {
+        for (size_t i = order; i < samples.size(); ++i) {
+            i64 prediction = 0;
+            for (size_t t = 0; t < order; ++t)
+                prediction += static_cast<i64>(coefficients[t]) * samples[i - t - 1];
+            samples[i] += static_cast<i32>(prediction >> shift);
+        }
+        return;
+    }
+
+    using AK::SIMD::i32x4;
+    // The coefficients in the order of the samples they apply to, padded with zeros, which the (up to three)
+    // samples past the current one are multiplied with.
+    size_t vector_count = (order + 3) / 4;
+    i32x4 reversed_coefficients[32 / 4] {};
+    for (size_t t = 0; t < order; ++t)
+        reversed_coefficients[(order - t - 1) / 4][(order - t - 1) % 4] = coefficients[t];
+
+    for (size_t i = order; i < samples.size(); ++i) {
+        const i32* window = samples.data() + i - order;
+        i32x4 prediction {};
+        for (size_t v = 0; v < vector_count; ++v) {
+            i32x4 previous_samples;
+            memcpy(&previous_samples, window + 4 * v, sizeof(i32x4));
+            prediction += previous_samples * reversed_coefficients[v];
+        }
+        samples[i] += (prediction[0] + prediction[1] + prediction[2] + prediction[3]) >> shift;
+    }
 }
 
 // Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
-Vector<i32> FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, InputBitStream& bit_input)
+void FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, Span<i32> samples)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    u8 bits_per_sample = subframe.bits_per_sample - subframe.wasted_bits_per_sample;
 
     // warm-up samples
-    for (auto i = 0; i < subframe.order; ++i) {
-        decoded.unchecked_append(sign_extend(bit_input.read_bits_big_endian(subframe.bits_per_sample - subframe.wasted_bits_per_sample), subframe.bits_per_sample));
-        decoded[i] <<= subframe.wasted_bits_per_sample;
-    }
+    for (auto i = 0; i < subframe.order; ++i)
+        samples[i] = sign_extend(m_reader.read_bits(bits_per_sample), bits_per_sample);
 
     // precision of the coefficients
-    u8 lpc_precision = bit_input.read_bits_big_endian(4);
+    u8 lpc_precision = m_reader.read_bits(4);
     if (lpc_precision == 0b1111) {
         m_error_string = "Invalid linear predictor coefficient precision";
-        return {};
+        return;
     }
     lpc_precision += 1;
 
     // shift needed on the data (signed!)
-    i8 lpc_shift = sign_extend(bit_input.read_bits_big_endian(5), 5);
+    i8 lpc_shift = sign_extend(m_reader.read_bits(5), 5);
+    if (lpc_shift < 0) {
+        m_error_string = "Negative linear predictor shift";
+        return;
+    }
 
-    Vector<i32> coefficients;
-    coefficients.ensure_capacity(subframe.order);
+    Array<i32, 32> coefficients;
     // read coefficients
     for (auto i = 0; i < subframe.order; ++i) {
-        u32 raw_coefficient = bit_input.read_bits_big_endian(lpc_precision);
-        i32 coefficient = sign_extend(raw_coefficient, lpc_precision);
-        coefficients.unchecked_append(coefficient);
+        u32 raw_coefficient = m_reader.read_bits(lpc_precision);
+        coefficients[i] = sign_extend(raw_coefficient, lpc_precision);
     }
+    auto used_coefficients = coefficients.span().trim(subframe.order);
 
-    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients);
+    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, used_coefficients);
 
-    // decode residual
-    // FIXME: This order may be incorrect, the LPC is applied to the residual, probably leading to incorrect results.
-    decoded = decode_residual(decoded, subframe, bit_input);
+    decode_residual(subframe, samples);
+    if (!m_error_string.is_empty())
+        return;
 
-    // approximate the waveform with the predictor
-    for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
-        i32 sample = 0;
-        for (size_t t = 0; t < subframe.order; ++t) {
-            sample += coefficients[t] * decoded[i - t - 1];
-        }
-        decoded[i] += sample >> lpc_shift;
-    }
+    // Each term of the prediction has at most bits_per_sample + lpc_precision bits, and there are order of them.
+    u8 order_bits = 0;
+    while ((1u << order_bits) < subframe.order)
+        ++order_bits;
+    bool fits_in_32_bits = bits_per_sample + lpc_precision + order_bits <= 32;
 
-    return decoded;
+    // approximate the waveform with the predictor
+    // NOTE: The samples span is followed by lpc_window_padding more entries, see parse_subframe().
+    restore_lpc(samples, used_coefficients, lpc_shift, fits_in_32_bits);
 }
 
 // Decode a subframe encoded with one of the fixed linear predictor codings
-Vector<i32> FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, InputBitStream& bit_input)
+void FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, Span<i32> decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    u8 bits_per_sample = subframe.bits_per_sample - subframe.wasted_bits_per_sample;
 
-    // warm-up samples
-    for (auto i = 0; i < subframe.order; ++i) {
-        decoded.unchecked_append(bit_input.read_bits_big_endian(subframe.bits_per_sample - subframe.wasted_bits_per_sample));
+    if (subframe.order > 4) {
+        m_error_string = String::formatted("Unrecognized predictor order {}", subframe.order);
+        return;
     }
 
-    decode_residual(decoded, subframe, bit_input);
+    // warm-up samples
+    for (auto i = 0; i < subframe.order; ++i)
+        decoded[i] = sign_extend(m_reader.read_bits(bits_per_sample), bits_per_sample);
+
+    decode_residual(subframe, decoded);
     if (!m_error_string.is_empty())
-        return {};
+        return;
     dbgln_if(AFLACLOADER_DEBUG, "decoded length {}, {} order predictor", decoded.size(), subframe.order);
 
     switch (subframe.order) {
     case 0:
         // s_0(t) = 0
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
-            decoded[i] += 0;
         break;
     case 1:
         // s_1(t) = s(t-1)
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
+        for (u32 i = subframe.order; i < decoded.size(); ++i)
             decoded[i] += decoded[i - 1];
         break;
     case 2:
         // s_2(t) = 2s(t-1) - s(t-2)
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
+        for (u32 i = subframe.order; i < decoded.size(); ++i)
             decoded[i] += 2 * decoded[i - 1] - decoded[i - 2];
         break;
     case 3:
         // s_3(t) = 3s(t-1) - 3s(t-2) + s(t-3)
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
+        for (u32 i = subframe.order; i < decoded.size(); ++i)
             decoded[i] += 3 * decoded[i - 1] - 3 * decoded[i - 2] + decoded[i - 3];
         break;
     case 4:
         // s_4(t) = 4s(t-1) - 6s(t-2) + 4s(t-3) - s(t-4)
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
+        for (u32 i = subframe.order; i < decoded.size(); ++i)
             decoded[i] += 4 * decoded[i - 1] - 6 * decoded[i - 2] + 4 * decoded[i - 3] - decoded[i - 4];
         break;
-    default:
-        m_error_string = String::formatted("Unrecognized predictor order {}", subframe.order);
-        break;
     }
-    return decoded;
 }
 
 // Decode the residual, the "error" between the function approximation and the actual audio data
-Vector<i32> FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe, InputBitStream& bit_input)
+void FlacLoaderPlugin::decode_residual(FlacSubframeHeader& subframe, Span<i32> samples)
 {
-    u8 residual_mode = bit_input.read_bits_big_endian(2);
-    u8 partition_order = bit_input.read_bits_big_endian(4);
+    u8 residual_mode = m_reader.read_bits(2);
+    u8 partition_order = m_reader.read_bits(4);
     u32 partitions = 1 << partition_order;
 
+    u8 parameter_bits;
     if (residual_mode == FlacResidualMode::Rice4Bit) {
-        // decode a single Rice partition with four bits for the order k
-        for (u32 i = 0; i < partitions; ++i) {
-            auto rice_partition = decode_rice_partition(4, partitions, i, subframe, bit_input);
-            decoded.extend(move(rice_partition));
-        }
+        // a four bit Rice parameter k for each partition
+        parameter_bits = 4;
     } else if (residual_mode == FlacResidualMode::Rice5Bit) {
         // five bits equivalent
-        for (u32 i = 0; i < partitions; ++i) {
-            auto rice_partition = decode_rice_partition(5, partitions, i, subframe, bit_input);
-            decoded.extend(move(rice_partition));
-        }
+        parameter_bits = 5;
     } else {
         m_error_string = "Reserved residual coding method";
-        return {};
+        return;
     }
 
-    return decoded;
-}
+    u32 partition_sample_count = samples.size() >> partition_order;
+    if ((partition_sample_count << partition_order) != samples.size() || partition_sample_count < subframe.order) {
+        m_error_string = "Residual partition size";
+        return;
+    }
 
-// Decode a single Rice partition as part of the residual, every partition can have its own Rice parameter k
-ALWAYS_INLINE Vector<i32> FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, InputBitStream& bit_input)
-{
-    // Rice parameter / Exp-Golomb order
-    u8 k = bit_input.read_bits_big_endian(partition_type);
-
-    u32 residual_sample_count;
-    if (partitions == 0)
-        residual_sample_count = m_current_frame->sample_count - subframe.order;
-    else
-        residual_sample_count = m_current_frame->sample_count / partitions;
-    if (partition_index == 0)
-        residual_sample_count -= subframe.order;
-
-    Vector<i32> rice_partition;
-    rice_partition.resize(residual_sample_count);
-
-    // escape code for unencoded binary partition
-    if (k == (1 << partition_type) - 1) {
-        u8 unencoded_bps = bit_input.read_bits_big_endian(5);
-        for (u32 r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = bit_input.read_bits_big_endian(unencoded_bps);
+    // The warm-up samples take the place of the first partition's first residuals.
+    size_t sample_index = subframe.order;
+    for (u32 partition = 0; partition < partitions; ++partition) {
+        size_t partition_end = (partition + 1) * partition_sample_count;
+        // Rice parameter / Exp-Golomb order
+        u8 k = m_reader.read_bits(parameter_bits);
+
+        if (k == (1 << parameter_bits) - 1) {
+            // escape code for unencoded binary partition
+            u8 unencoded_bps = m_reader.read_bits(5);
+            for (; sample_index < partition_end; ++sample_index)
+                samples[sample_index] = unencoded_bps ? sign_extend(m_reader.read_bits(unencoded_bps), unencoded_bps) : 0;
+        } else {
+            for (; sample_index < partition_end; ++sample_index)
+                samples[sample_index] = decode_unsigned_exp_golomb(k, m_reader);
         }
-    } else {
-        for (u32 r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = decode_unsigned_exp_golomb(k, bit_input);
+
+        if (m_reader.has_error()) {
+            m_error_string = "End of stream in residual";
+            return;
         }
     }
-
-    return rice_partition;
 }
 
 // Decode a single number encoded with Rice/Exponential-Golomb encoding (the unsigned variant)
-ALWAYS_INLINE i32 decode_unsigned_exp_golomb(u8 k, InputBitStream& bit_input)
+ALWAYS_INLINE i32 decode_unsigned_exp_golomb(u8 k, FlacBitReader& bit_input)
 {
-    u8 q = 0;
-    while (bit_input.read_bit_big_endian() == 0)
-        ++q;
+    u32 q = bit_input.read_unary();
 
     // least significant bits (remainder)
-    u32 rem = bit_input.read_bits_big_endian(k);
+    u32 rem = bit_input.read_bits(k);
     u32 value = (u32)(q << k | rem);
 
     return rice_to_signed(value);
 }
 
-u64 read_utf8_char(InputStream& input)
+u64 read_utf8_char(FlacBitReader& input)
 {
     u64 character;
-    ByteBuffer single_byte_buffer = ByteBuffer::create_uninitialized(1);
-    input.read(single_byte_buffer);
-    u8 start_byte = single_byte_buffer[0];
+    u8 start_byte = input.read_bits(8);
     // Signal byte is zero: ASCII character
     if ((start_byte & 0b10000000) == 0) {
         return start_byte;
@@ -809,8 +935,7 @@ u64 read_utf8_char(InputStream& input)
     u8 start_byte_bitmask = AK::exp2(bits_from_start_byte) - 1;
     character = start_byte_bitmask & start_byte;
     for (u8 i = length - 1; i > 0; --i) {
-        input.read(single_byte_buffer);
-        u8 current_byte = single_byte_buffer[0];
+        u8 current_byte = input.read_bits(8);
         character = (character << 6) | (current_byte & 0b00111111);
     }
     return character;
@@ -818,6 +943,8 @@ u64 read_utf8_char(InputStream& input)
 
 i64 sign_extend(u32 n, u8 size)
 {
+    if (size >= 32)
+        return static_cast<i32>(n);
     // negative
     if ((n & (1 << (size - 1))) > 0) {
         return static_cast<i64>(n | (0xffffffff << size));
@@ -9,34 +9,41 @@
 #include "Buffer.h"
 #include "FlacTypes.h"
 #include "Loader.h"
-#include <AK/BitStream.h>
-#include <AK/Stream.h>
+#include <AK/MappedFile.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
-#include <AK/Variant.h>
-#include <LibCore/FileStream.h>
 
 namespace Audio {
 
-class FlacInputStream : public Variant<Core::InputFileStream, InputMemoryStream> {
-
+// Reads the bits of a FLAC stream that is entirely in memory, most significant bit first.
+// Reading past the end yields zeros and sets an error.
+class FlacBitReader {
 public:
-    using Variant<Core::InputFileStream, InputMemoryStream>::Variant;
-
-    void seek(size_t pos)
+    FlacBitReader() = default;
+    explicit FlacBitReader(ReadonlyBytes data)
+        : m_data(data)
     {
-        this->visit(
-            [&](auto& stream) {
-                stream.seek(pos);
-            });
     }
 
-    InputBitStream bit_stream()
-    {
-        return this->visit(
-            [&](auto& stream) {
-                return InputBitStream(stream);
-            });
-    }
+    bool has_error() const { return m_has_error; }
+    size_t size() const { return m_data.size(); }
+    size_t byte_offset() const { return m_bit_offset / 8; }
+    void seek_to_byte(size_t);
+
+    // Up to 32 bits at a time.
+    u32 read_bits(u8 count);
+    bool read_bit() { return read_bits(1); }
+    // Counts the zero bits up to the next one bit, which is consumed as well.
+    u32 read_unary();
+    void align_to_byte_boundary() { m_bit_offset = round_up_to_power_of_two(m_bit_offset, 8); }
+    ReadonlyBytes read_bytes(size_t count);
+
+private:
+    void set_error();
+
+    ReadonlyBytes m_data;
+    size_t m_bit_offset { 0 };
+    bool m_has_error { false };
 };
 
 ALWAYS_INLINE u8 frame_channel_type_to_channel_count(FlacFrameChannelType channel_type);
@@ -48,9 +55,9 @@ ALWAYS_INLINE i32 rice_to_signed(u32 x);
 
 // decoders
 // read a UTF-8 encoded number, even if it is not a valid codepoint
-ALWAYS_INLINE u64 read_utf8_char(InputStream& input);
+ALWAYS_INLINE u64 read_utf8_char(FlacBitReader& input);
 // decode a single number encoded with exponential golomb encoding of the specified order
-ALWAYS_INLINE i32 decode_unsigned_exp_golomb(u8 order, InputBitStream& bit_input);
+ALWAYS_INLINE i32 decode_unsigned_exp_golomb(u8 order, FlacBitReader& bit_input);
 
 class FlacLoaderPlugin : public LoaderPlugin {
 public:
@@ -80,21 +87,21 @@ public:
 private:
     bool parse_header();
     // Either returns the metadata block or sets error message.
-    // Additionally, increments m_data_start_location past the read meta block.
-    FlacRawMetadataBlock next_meta_block(InputBitStream& bit_input);
-    // Fetches and sets the next FLAC frame
+    FlacRawMetadataBlock next_meta_block();
+    void parse_seek_table(ReadonlyBytes);
+    // Fetches and decodes the next FLAC frame
     void next_frame();
     // Helper of next_frame that fetches a sub frame's header
-    FlacSubframeHeader next_subframe_header(InputBitStream& bit_input, u8 channel_index);
-    // Helper of next_frame that decompresses a subframe
-    Vector<i32> parse_subframe(FlacSubframeHeader& subframe_header, InputBitStream& bit_input);
+    FlacSubframeHeader next_subframe_header(u8 channel_index);
+    // Helper of next_frame that decompresses a subframe into the given buffer, which has room for a few more samples than
+    // there are in the frame.
+    void parse_subframe(FlacSubframeHeader& subframe_header, Vector<i32>& samples);
     // Subframe-internal data decoders (heavy lifting)
-    Vector<i32> decode_fixed_lpc(FlacSubframeHeader& subframe, InputBitStream& bit_input);
-    Vector<i32> decode_verbatim(FlacSubframeHeader& subframe, InputBitStream& bit_input);
-    Vector<i32> decode_custom_lpc(FlacSubframeHeader& subframe, InputBitStream& bit_input);
-    Vector<i32> decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe, InputBitStream& bit_input);
-    // decode a single rice partition that has its own rice parameter
-    ALWAYS_INLINE Vector<i32> decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, InputBitStream& bit_input);
+    void decode_fixed_lpc(FlacSubframeHeader& subframe, Span<i32> samples);
+    void decode_verbatim(FlacSubframeHeader& subframe, Span<i32> samples);
+    void decode_custom_lpc(FlacSubframeHeader& subframe, Span<i32> samples);
+    // Decodes the residual into the samples after the warm-up samples
+    void decode_residual(FlacSubframeHeader& subframe, Span<i32> samples);
 
     // Converters for special coding used in frame headers
     ALWAYS_INLINE u32 convert_sample_count_code(u8 sample_count_code);
@@ -119,13 +126,22 @@ private:
     u64 m_total_samples { 0 };  // 36 bit
     u8 m_md5_checksum[128 / 8]; // 128 bit (!)
     size_t m_loaded_samples { 0 };
+    Vector<FlacSeekPoint> m_seek_table;
 
+    // The whole stream is decoded from memory, which is either the mapped file or a copy of the given buffer.
+    RefPtr<MappedFile> m_mapped_file;
+    ByteBuffer m_buffer;
+    FlacBitReader m_reader;
     // keep track of the start of the data in the FLAC stream to seek back more easily
     u64 m_data_start_location { 0 };
-    OwnPtr<FlacInputStream> m_stream;
+
     Optional<FlacFrameHeader> m_current_frame;
     Vector<Frame> m_current_frame_data;
+    // How many samples of the current frame have been handed out already.
+    size_t m_current_frame_position { 0 };
     u64 m_current_sample_or_frame { 0 };
+    // These are reused for every frame, so decoding doesn't have to allocate.
+    Vector<Vector<i32>, 8> m_subframe_samples;
 };
 
 }
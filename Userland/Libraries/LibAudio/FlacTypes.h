@@ -25,7 +25,7 @@ enum FlacMetadataBlockType : u8 {
     STREAMINFO = 0,     // Important data about the audio format
     PADDING = 1,        // Non-data block to be ignored
     APPLICATION = 2,    // Ignored
-    SEEKTABLE = 3,      // Seeking info, maybe to be used later
+    SEEKTABLE = 3,      // Seeking info
     VORBIS_COMMENT = 4, // Ignored
     CUESHEET = 5,       // Ignored
     PICTURE = 6,        // Ignored
@@ -71,6 +71,12 @@ struct FlacRawMetadataBlock {
     ByteBuffer data;
 };
 
+// A point in the stream that decoding can start at
+struct FlacSeekPoint {
+    u64 sample_index;
+    u64 byte_offset; // From the first frame
+};
+
 // An abstract, parsed and validated FLAC frame
 struct FlacFrameHeader {
     u32 sample_count;
@@ -22,6 +22,7 @@ bool __stdio_is_initialized;
 
 void __libc_init()
 {
+    __string_init();
     __malloc_init();
     __stdio_init();
 }
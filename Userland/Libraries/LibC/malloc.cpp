@@ -10,6 +10,7 @@
 #include <LibELF/AuxiliaryVector.h>
 #include <assert.h>
 #include <errno.h>
+#include <malloc.h>
 #include <mallocdefs.h>
 #include <pthread.h>
 #include <serenity.h>
@@ -19,6 +20,7 @@
 #include <sys/internals.h>
 #include <sys/mman.h>
 #include <syscall.h>
+#include <time.h>
 
 class PthreadMutexLocker {
 public:
@@ -37,17 +39,28 @@ private:
 
 #define RECYCLE_BIG_ALLOCATIONS
 
+// The dynamic loader allocates memory before thread-local storage is set up.
+#ifndef _DYNAMIC_LOADER
+#    define USE_THREAD_CACHE
+#endif
+
 static pthread_mutex_t s_malloc_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
+constexpr size_t recycled_big_block_size = 64 * KiB;
+
+// Empty blocks that haven't been needed for this long are handed back to the kernel in stages: hot blocks
+// become cold (volatile, so the kernel may purge them), and cold and big blocks are unmapped.
+constexpr i64 kept_block_decay_interval_ms = 5000;
 
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
 static bool s_in_userspace_emulator = false;
+static bool s_use_thread_cache = true;
 
 ALWAYS_INLINE static void ue_notify_malloc(const void* ptr, size_t size)
 {
@@ -95,6 +108,13 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_hot_decays;
+    size_t number_of_cold_decays;
+    size_t number_of_big_decays;
+
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -103,6 +123,14 @@ static ChunkedBlock* s_hot_empty_blocks[number_of_hot_chunked_blocks_to_keep_aro
 static size_t s_cold_empty_block_count { 0 };
 static ChunkedBlock* s_cold_empty_blocks[number_of_cold_chunked_blocks_to_keep_around] { nullptr };
 
+// The kept blocks are used like stacks, so the ones below the lowest count since the last decay weren't touched since.
+static size_t s_hot_empty_block_low_water { 0 };
+static size_t s_cold_empty_block_low_water { 0 };
+static i64 s_last_decay_time_ms { 0 };
+
+static size_t s_big_allocation_count { 0 };
+static size_t s_big_allocation_bytes { 0 };
+
 struct Allocator {
     size_t size { 0 };
     size_t block_count { 0 };
@@ -112,6 +140,7 @@ struct Allocator {
 
 struct BigAllocator {
     Vector<BigAllocationBlock*, number_of_big_blocks_to_keep_around_per_size_class> blocks;
+    size_t low_water { 0 };
 };
 
 // Allocators will be initialized in __malloc_init.
@@ -148,7 +177,7 @@ static Allocator* allocator_for_size(size_t size, size_t& good_size)
 #ifdef RECYCLE_BIG_ALLOCATIONS
 static BigAllocator* big_allocator_for_size(size_t size)
 {
-    if (size == 65536)
+    if (size == recycled_big_block_size)
         return &big_allocators()[0];
     return nullptr;
 }
@@ -178,69 +207,87 @@ enum class CallerWillInitializeMemory {
     Yes,
 };
 
-static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+static void make_block_cold_locked(ChunkedBlock& block)
 {
-    if (s_log_malloc)
-        dbgln("LibC: malloc({})", size);
-
-    if (!size) {
-        // Legally we could just return a null pointer here, but this is more
-        // compatible with existing software.
-        size = 1;
-    }
-
-    g_malloc_stats.number_of_malloc_calls++;
+    s_cold_empty_blocks[s_cold_empty_block_count++] = &block;
+    mprotect(&block, ChunkedBlock::block_size, PROT_NONE);
+    madvise(&block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+}
 
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size);
+static void remove_oldest_kept_blocks(ChunkedBlock** blocks, size_t& count, size_t number_to_remove)
+{
+    VERIFY(number_to_remove <= count);
+    count -= number_to_remove;
+    memmove(&blocks[0], &blocks[number_to_remove], count * sizeof(ChunkedBlock*));
+}
 
-    PthreadMutexLocker locker(s_malloc_mutex);
+// Gives the kept blocks that weren't needed since the last decay (or all of them) a step closer to the kernel.
+static bool decay_kept_blocks_locked(bool release_all)
+{
+    auto cold_to_release = release_all ? s_cold_empty_block_count : s_cold_empty_block_low_water;
+    for (size_t i = 0; i < cold_to_release; ++i)
+        os_free(s_cold_empty_blocks[i], ChunkedBlock::block_size);
+    remove_oldest_kept_blocks(s_cold_empty_blocks, s_cold_empty_block_count, cold_to_release);
+    g_malloc_stats.number_of_cold_decays += cold_to_release;
+
+    auto hot_to_decay = release_all ? s_hot_empty_block_count : s_hot_empty_block_low_water;
+    for (size_t i = 0; i < hot_to_decay; ++i) {
+        auto& block = *s_hot_empty_blocks[i];
+        if (!release_all && s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around)
+            make_block_cold_locked(block);
+        else
+            os_free(&block, ChunkedBlock::block_size);
+    }
+    remove_oldest_kept_blocks(s_hot_empty_blocks, s_hot_empty_block_count, hot_to_decay);
+    g_malloc_stats.number_of_hot_decays += hot_to_decay;
 
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
+    size_t big_blocks_released = 0;
 #ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                ue_notify_malloc(&block->m_slot[0], size);
-                return &block->m_slot[0];
-            }
-        }
-#endif
-        g_malloc_stats.number_of_big_allocs++;
-        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
-        new (block) BigAllocationBlock(real_size);
-        ue_notify_malloc(&block->m_slot[0], size);
-        return &block->m_slot[0];
+    for (auto& allocator : big_allocators()) {
+        auto big_to_release = release_all ? allocator.blocks.size() : allocator.low_water;
+        // NOTE: The kept blocks are inaccessible, so we can't look at their headers to find out their size.
+        for (size_t i = 0; i < big_to_release; ++i)
+            os_free(allocator.blocks[i], recycled_big_block_size);
+        allocator.blocks.remove(0, big_to_release);
+        allocator.low_water = allocator.blocks.size();
+        big_blocks_released += big_to_release;
     }
+    g_malloc_stats.number_of_big_decays += big_blocks_released;
+#endif
+
+    s_hot_empty_block_low_water = s_hot_empty_block_count;
+    s_cold_empty_block_low_water = s_cold_empty_block_count;
+    return cold_to_release || hot_to_decay || big_blocks_released;
+}
+
+static void maybe_decay_kept_blocks_locked()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    i64 now_ms = (i64)now.tv_sec * 1000 + now.tv_nsec / 1'000'000;
+    if (now_ms - s_last_decay_time_ms < kept_block_decay_interval_ms)
+        return;
+    s_last_decay_time_ms = now_ms;
+    decay_kept_blocks_locked(false);
+}
 
+static void* allocate_chunk_locked(Allocator& allocator, size_t good_size)
+{
     ChunkedBlock* block = nullptr;
-    for (auto& current : allocator->usable_blocks) {
+    for (auto& current : allocator.usable_blocks) {
         if (current.free_chunks()) {
             block = &current;
             break;
         }
     }
 
+    if (!block)
+        maybe_decay_kept_blocks_locked();
+
     if (!block && s_hot_empty_block_count) {
         g_malloc_stats.number_of_hot_empty_block_hits++;
         block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        s_hot_empty_block_low_water = min(s_hot_empty_block_low_water, s_hot_empty_block_count);
         if (block->m_size != good_size) {
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
@@ -248,12 +295,13 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block && s_cold_empty_block_count) {
         g_malloc_stats.number_of_cold_empty_block_hits++;
         block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        s_cold_empty_block_low_water = min(s_cold_empty_block_low_water, s_cold_empty_block_count);
         int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
         bool this_block_was_purged = rc == 1;
         if (rc < 0) {
@@ -271,7 +319,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
@@ -280,8 +328,8 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     --block->m_free_chunks;
@@ -296,13 +344,207 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+static void free_chunk_locked(ChunkedBlock& block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block.m_freelist;
+    block.m_freelist = entry;
+
+    if (block.is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block.m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", &block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(block);
+        allocator->usable_blocks.prepend(block);
+    }
+
+    ++block.m_free_chunks;
+
+    if (!block.used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block.m_size, good_size);
+        maybe_decay_kept_blocks_locked();
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", &block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = &block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", &block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(block);
+            make_block_cold_locked(block);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", &block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(block);
+        --allocator->block_count;
+        os_free(&block, ChunkedBlock::block_size);
+    }
+}
+
+#ifdef USE_THREAD_CACHE
+// Every thread keeps some chunks of each size class around, so most calls to malloc() and free() don't
+// have to take s_malloc_mutex. The chunks are moved between these caches and the blocks in batches.
+constexpr size_t thread_cache_max_chunks_per_size_class = 64;
+constexpr size_t thread_cache_max_bytes_per_size_class = 32 * KiB;
+
+struct ThreadCache {
+    FreelistEntry* chunks[num_size_classes];
+    size_t chunk_counts[num_size_classes];
+};
+static __thread ThreadCache t_thread_cache;
+
+static size_t size_class_index(size_t chunk_size)
+{
+    for (size_t i = 0; i < num_size_classes; ++i) {
+        if (size_classes[i] == chunk_size)
+            return i;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static constexpr size_t thread_cache_limit(size_t chunk_size)
+{
+    return clamp<size_t>(thread_cache_max_bytes_per_size_class / chunk_size, 1, thread_cache_max_chunks_per_size_class);
+}
+
+static constexpr size_t thread_cache_batch_size(size_t chunk_size)
+{
+    return max<size_t>(thread_cache_limit(chunk_size) / 2, 1);
+}
+
+static void* allocate_from_thread_cache(Allocator& allocator)
+{
+    auto index = &allocator - allocators();
+    auto& cache = t_thread_cache;
+    if (!cache.chunk_counts[index]) {
+        g_malloc_stats.number_of_thread_cache_refills++;
+        PthreadMutexLocker locker(s_malloc_mutex);
+        for (size_t i = 0; i < thread_cache_batch_size(allocator.size); ++i) {
+            auto* entry = (FreelistEntry*)allocate_chunk_locked(allocator, allocator.size);
+            entry->next = cache.chunks[index];
+            cache.chunks[index] = entry;
+            ++cache.chunk_counts[index];
+        }
+    }
+    auto* entry = cache.chunks[index];
+    cache.chunks[index] = entry->next;
+    --cache.chunk_counts[index];
+    return entry;
+}
+
+static void return_chunks_from_thread_cache_locked(size_t index, size_t count)
+{
+    auto& cache = t_thread_cache;
+    for (size_t i = 0; i < count && cache.chunks[index]; ++i) {
+        auto* entry = cache.chunks[index];
+        cache.chunks[index] = entry->next;
+        --cache.chunk_counts[index];
+        auto* block = (ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask);
+        free_chunk_locked(*block, entry);
+    }
+}
+
+static void free_to_thread_cache(ChunkedBlock& block, void* ptr)
+{
+    auto index = size_class_index(block.m_size);
+    auto& cache = t_thread_cache;
+    if (cache.chunk_counts[index] == thread_cache_limit(block.m_size)) {
+        g_malloc_stats.number_of_thread_cache_flushes++;
+        PthreadMutexLocker locker(s_malloc_mutex);
+        return_chunks_from_thread_cache_locked(index, thread_cache_batch_size(block.m_size));
+    }
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = cache.chunks[index];
+    cache.chunks[index] = entry;
+    ++cache.chunk_counts[index];
+}
+#endif
+
+static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if (s_log_malloc)
+        dbgln("LibC: malloc({})", size);
+
+    if (!size) {
+        // Legally we could just return a null pointer here, but this is more
+        // compatible with existing software.
+        size = 1;
+    }
+
+    g_malloc_stats.number_of_malloc_calls++;
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size);
+
+#ifdef USE_THREAD_CACHE
+    if (allocator && s_use_thread_cache) {
+        void* ptr = allocate_from_thread_cache(*allocator);
+        if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+#endif
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+
+    if (!allocator) {
+        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
+#ifdef RECYCLE_BIG_ALLOCATIONS
+        if (auto* allocator = big_allocator_for_size(real_size)) {
+            if (!allocator->blocks.is_empty()) {
+                g_malloc_stats.number_of_big_allocator_hits++;
+                auto* block = allocator->blocks.take_last();
+                allocator->low_water = min(allocator->low_water, allocator->blocks.size());
+                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+                bool this_block_was_purged = rc == 1;
+                if (rc < 0) {
+                    perror("madvise");
+                    VERIFY_NOT_REACHED();
+                }
+                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                    perror("mprotect");
+                    VERIFY_NOT_REACHED();
+                }
+                if (this_block_was_purged) {
+                    g_malloc_stats.number_of_big_allocator_purge_hits++;
+                    new (block) BigAllocationBlock(real_size);
+                }
+                ++s_big_allocation_count;
+                s_big_allocation_bytes += real_size;
+
+                ue_notify_malloc(&block->m_slot[0], size);
+                return &block->m_slot[0];
+            }
+        }
+#endif
+        g_malloc_stats.number_of_big_allocs++;
+        maybe_decay_kept_blocks_locked();
+        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
+        new (block) BigAllocationBlock(real_size);
+        ++s_big_allocation_count;
+        s_big_allocation_bytes += real_size;
+        ue_notify_malloc(&block->m_slot[0], size);
+        return &block->m_slot[0];
+    }
+
+    void* ptr = allocate_chunk_locked(*allocator, good_size);
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -320,10 +562,12 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
+        PthreadMutexLocker locker(s_malloc_mutex);
         auto* block = (BigAllocationBlock*)block_base;
+        --s_big_allocation_count;
+        s_big_allocation_bytes -= block->m_size;
+        maybe_decay_kept_blocks_locked();
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
             if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
@@ -355,46 +599,15 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
+#ifdef USE_THREAD_CACHE
+    if (s_use_thread_cache) {
+        free_to_thread_cache(*block, ptr);
+        return;
     }
+#endif
 
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    PthreadMutexLocker locker(s_malloc_mutex);
+    free_chunk_locked(*block, ptr);
 }
 
 [[gnu::flatten]] void* malloc(size_t size)
@@ -470,6 +683,71 @@ void* realloc(void* ptr, size_t size)
     return new_ptr;
 }
 
+int malloc_trim(size_t)
+{
+    // Only the calling thread's cache can be flushed, the other threads might be using theirs right now.
+    __malloc_flush_thread_cache();
+    PthreadMutexLocker locker(s_malloc_mutex);
+    return decay_kept_blocks_locked(true) ? 1 : 0;
+}
+
+struct mallinfo2 mallinfo2()
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+    struct mallinfo2 info = {};
+    auto account_block = [&](ChunkedBlock& block) {
+        info.arena += ChunkedBlock::block_size;
+        info.ordblks += block.free_chunks();
+        info.uordblks += block.used_chunks() * block.bytes_per_chunk();
+        info.fordblks += block.free_chunks() * block.bytes_per_chunk();
+    };
+    for (auto& allocator : allocators()) {
+        for (auto& block : allocator.usable_blocks)
+            account_block(block);
+        for (auto& block : allocator.full_blocks)
+            account_block(block);
+    }
+
+    size_t kept_empty_block_bytes = (s_hot_empty_block_count + s_cold_empty_block_count) * ChunkedBlock::block_size;
+    info.arena += kept_empty_block_bytes;
+    info.keepcost = kept_empty_block_bytes;
+#ifdef RECYCLE_BIG_ALLOCATIONS
+    for (auto& allocator : big_allocators())
+        info.keepcost += allocator.blocks.size() * recycled_big_block_size;
+#endif
+    info.fordblks += info.keepcost;
+    info.hblks = s_big_allocation_count;
+    info.hblkhd = s_big_allocation_bytes;
+    return info;
+}
+
+struct mallinfo mallinfo()
+{
+    auto info = mallinfo2();
+    auto clamp_to_int = [](size_t value) { return (int)min<size_t>(value, NumericLimits<int>::max()); };
+    return {
+        .arena = clamp_to_int(info.arena),
+        .ordblks = clamp_to_int(info.ordblks),
+        .smblks = clamp_to_int(info.smblks),
+        .hblks = clamp_to_int(info.hblks),
+        .hblkhd = clamp_to_int(info.hblkhd),
+        .usmblks = clamp_to_int(info.usmblks),
+        .fsmblks = clamp_to_int(info.fsmblks),
+        .uordblks = clamp_to_int(info.uordblks),
+        .fordblks = clamp_to_int(info.fordblks),
+        .keepcost = clamp_to_int(info.keepcost),
+    };
+}
+
+void __malloc_flush_thread_cache()
+{
+#ifdef USE_THREAD_CACHE
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (size_t i = 0; i < num_size_classes; ++i)
+        return_chunks_from_thread_cache_locked(i, t_thread_cache.chunk_counts[i]);
+#endif
+}
+
 void __malloc_init()
 {
     s_in_userspace_emulator = (int)syscall(SC_emuctl, 0) != -ENOSYS;
@@ -478,6 +756,8 @@ void __malloc_init()
         // keeps track of heap memory anyway.
         s_scrub_malloc = false;
         s_scrub_free = false;
+        // UE tracks the state of every chunk in the blocks, so it has to see them being freed.
+        s_use_thread_cache = false;
     }
 
     if (secure_getenv("LIBC_NOSCRUB_MALLOC"))
@@ -520,5 +800,12 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("hot block decays: {}", g_malloc_stats.number_of_hot_decays);
+    dbgln("cold block decays: {}", g_malloc_stats.number_of_cold_decays);
+    dbgln("big block decays: {}", g_malloc_stats.number_of_big_decays);
+    dbgln();
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+// The small allocations are carved out of the "arena" of chunked blocks, the big ones are mapped separately.
+struct mallinfo2 {
+    size_t arena;    // Bytes in the blocks that small allocations are made in, including the empty ones kept around.
+    size_t ordblks;  // Number of free chunks in those blocks.
+    size_t smblks;   // Unused.
+    size_t hblks;    // Number of big allocations.
+    size_t hblkhd;   // Bytes in big allocations.
+    size_t usmblks;  // Unused.
+    size_t fsmblks;  // Unused.
+    size_t uordblks; // Bytes in allocated chunks, this includes the chunks cached by threads.
+    size_t fordblks; // Bytes in free chunks and in the empty blocks kept around.
+    size_t keepcost; // Bytes in the empty blocks kept around, which malloc_trim() would release.
+};
+
+// Same as mallinfo2, but the values are clamped to INT_MAX.
+struct mallinfo {
+    int arena;
+    int ordblks;
+    int smblks;
+    int hblks;
+    int hblkhd;
+    int usmblks;
+    int fsmblks;
+    int uordblks;
+    int fordblks;
+    int keepcost;
+};
+
+struct mallinfo mallinfo(void);
+struct mallinfo2 mallinfo2(void);
+int malloc_trim(size_t pad);
+
+__END_DECLS
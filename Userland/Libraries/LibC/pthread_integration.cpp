@@ -97,6 +97,19 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// How often pthread_mutex_lock() checks on a locked mutex before going to sleep. Spinning only
+// makes sense if the owner can make progress at the same time, so there's none of it on a single CPU.
+static u32 mutex_spin_count()
+{
+    static Atomic<i32, AK::memory_order_relaxed> s_spin_count { -1 };
+    auto spin_count = s_spin_count.load();
+    if (spin_count < 0) [[unlikely]] {
+        spin_count = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 100 : 0;
+        s_spin_count.store(spin_count);
+    }
+    return spin_count;
+}
+
 int __pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attributes)
 {
     mutex->lock = 0;
@@ -150,6 +163,21 @@ int __pthread_mutex_lock(pthread_mutex_t* mutex)
         }
     }
 
+    // The owner is usually running on another CPU and about to release the mutex, which is a lot
+    // cheaper to wait out here than by going to sleep in the kernel.
+    for (u32 i = 0; i < mutex_spin_count(); ++i) {
+        __builtin_ia32_pause();
+        if (AK::atomic_load(&mutex->lock, AK::memory_order_relaxed) != MUTEX_UNLOCKED)
+            continue;
+        value = MUTEX_UNLOCKED;
+        if (AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire)) {
+            if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+                AK::atomic_store(&mutex->owner, __pthread_self(), AK::memory_order_relaxed);
+            mutex->level = 0;
+            return 0;
+        }
+    }
+
     // Slow path: wait, record the fact that we're going to wait, and always
     // remember to wake the next thread up once we release the mutex.
     if (value != MUTEX_LOCKED_NEED_TO_WAKE)
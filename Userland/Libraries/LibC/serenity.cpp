@@ -48,6 +48,18 @@ int profiling_free_buffer(pid_t pid)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+ssize_t profiling_read(pid_t pid, void* buffer, size_t size)
+{
+    int rc = syscall(SC_profiling_read, pid, buffer, size);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int profiling_set_sampling_frequency(unsigned frequency)
+{
+    int rc = syscall(SC_profiling_set_sampling_frequency, frequency);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int futex(uint32_t* userspace_address, int futex_op, uint32_t value, const struct timespec* timeout, uint32_t* userspace_address2, uint32_t value3)
 {
     int rc;
@@ -107,6 +119,36 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int io_ring_create(unsigned entry_count, int options)
+{
+    int rc = syscall(SC_io_ring_create, entry_count, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, unsigned min_completions)
+{
+    int rc = syscall(SC_io_ring_enter, fd, min_completions);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_poll_create(int options)
+{
+    int rc = syscall(SC_event_poll_create, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_poll_ctl(int fd, int operation, int watched_fd, const struct event_poll_event* event)
+{
+    int rc = syscall(SC_event_poll_ctl, fd, operation, watched_fd, event);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_poll_wait(int fd, struct event_poll_event* events, size_t max_events, const struct timespec* timeout)
+{
+    int rc = syscall(SC_event_poll_wait, fd, events, max_events, timeout);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size)
 {
     Syscall::SC_readlink_params small_params {
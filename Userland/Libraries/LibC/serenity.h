@@ -22,6 +22,8 @@ int module_unload(const char* name, size_t name_length);
 int profiling_enable(pid_t, uint64_t);
 int profiling_disable(pid_t);
 int profiling_free_buffer(pid_t);
+ssize_t profiling_read(pid_t, void* buffer, size_t);
+int profiling_set_sampling_frequency(unsigned);
 
 #define THREAD_PRIORITY_MIN 1
 #define THREAD_PRIORITY_LOW 10
@@ -61,6 +63,9 @@ int profiling_free_buffer(pid_t);
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -70,6 +75,9 @@ int profiling_free_buffer(pid_t);
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 int futex(uint32_t* userspace_address, int futex_op, uint32_t value, const struct timespec* timeout, uint32_t* userspace_address2, uint32_t value3);
 
 static ALWAYS_INLINE int futex_wait(uint32_t* userspace_address, uint32_t value, const struct timespec* abstime, int clockid)
@@ -112,6 +120,12 @@ enum {
     PERF_EVENT_KMALLOC = 2048,
     PERF_EVENT_KFREE = 4096,
     PERF_EVENT_PAGE_FAULT = 8192,
+    PERF_EVENT_CPU_CYCLES = 16384,
+    PERF_EVENT_INSTRUCTIONS = 32768,
+    PERF_EVENT_CACHE_MISSES = 65536,
+    PERF_EVENT_BRANCH_MISSES = 131072,
+    PERF_EVENT_BLOCK = 262144,
+    PERF_EVENT_UNBLOCK = 524288,
 };
 
 #define PERF_EVENT_MASK_ALL (~0ull)
@@ -122,6 +136,14 @@ int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+int io_ring_create(unsigned entry_count, int options);
+int io_ring_enter(int fd, unsigned min_completions);
+
+struct event_poll_event;
+int event_poll_create(int options);
+int event_poll_ctl(int fd, int operation, int watched_fd, const struct event_poll_event* event);
+int event_poll_wait(int fd, struct event_poll_event* events, size_t max_events, const struct timespec* timeout);
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
@@ -13,154 +13,115 @@
 
 #include <spawn.h>
 
-#include <AK/Function.h>
+#include <AK/String.h>
 #include <AK/Vector.h>
 #include <errno.h>
 #include <fcntl.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <sys/stat.h>
+#include <string.h>
+#include <syscall.h>
 #include <sys/types.h>
-#include <unistd.h>
 
 struct posix_spawn_file_actions_state {
-    Vector<Function<int()>, 4> actions;
+    struct Action {
+        Syscall::SpawnFileActionType type;
+        int fd { -1 };
+        int new_fd { -1 };
+        int options { 0 };
+        mode_t mode { 0 };
+        String path {};
+    };
+    Vector<Action, 4> actions;
 };
 
 extern "C" {
 
-[[noreturn]] static void posix_spawn_child(const char* path, const posix_spawn_file_actions_t* file_actions, const posix_spawnattr_t* attr, char* const argv[], char* const envp[], int (*exec)(const char*, char* const[], char* const[]))
+static int spawn(pid_t* out_pid, const char* path, const posix_spawn_file_actions_t* file_actions, const posix_spawnattr_t* attr, char* const argv[], char* const envp[])
 {
-    if (attr) {
-        short flags = attr->flags;
-        if (flags & POSIX_SPAWN_RESETIDS) {
-            if (seteuid(getuid()) < 0) {
-                perror("posix_spawn seteuid");
-                _exit(127);
-            }
-            if (setegid(getgid()) < 0) {
-                perror("posix_spawn setegid");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETPGROUP) {
-            if (setpgid(0, attr->pgroup) < 0) {
-                perror("posix_spawn setpgid");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSCHEDPARAM) {
-            if (sched_setparam(0, &attr->schedparam) < 0) {
-                perror("posix_spawn sched_setparam");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSIGDEF) {
-            struct sigaction default_action;
-            default_action.sa_flags = 0;
-            sigemptyset(&default_action.sa_mask);
-            default_action.sa_handler = SIG_DFL;
-
-            sigset_t sigdefault = attr->sigdefault;
-            for (int i = 0; i < NSIG; ++i) {
-                if (sigismember(&sigdefault, i) && sigaction(i, &default_action, nullptr) < 0) {
-                    perror("posix_spawn sigaction");
-                    _exit(127);
-                }
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSIGMASK) {
-            if (sigprocmask(SIG_SETMASK, &attr->sigmask, nullptr) < 0) {
-                perror("posix_spawn sigprocmask");
-                _exit(127);
-            }
-        }
-        if (flags & POSIX_SPAWN_SETSID) {
-            if (setsid() < 0) {
-                perror("posix_spawn setsid");
-                _exit(127);
-            }
-        }
-
-        // FIXME: POSIX_SPAWN_SETSCHEDULER
-    }
+    Vector<Syscall::StringArgument, 16> arguments;
+    for (size_t i = 0; argv[i]; ++i)
+        arguments.append({ argv[i], strlen(argv[i]) });
+
+    Vector<Syscall::StringArgument, 64> environment;
+    for (size_t i = 0; envp[i]; ++i)
+        environment.append({ envp[i], strlen(envp[i]) });
 
+    Vector<Syscall::SC_posix_spawn_file_action, 4> actions;
     if (file_actions) {
-        for (const auto& action : file_actions->state->actions) {
-            if (action() < 0) {
-                perror("posix_spawn file action");
-                _exit(127);
-            }
-        }
+        for (auto& action : file_actions->state->actions)
+            actions.append({ action.type, action.fd, action.new_fd, action.options, (u16)action.mode, { action.path.characters(), action.path.length() } });
     }
 
-    exec(path, argv, envp);
-    perror("posix_spawn exec");
-    _exit(127);
+    Syscall::SC_posix_spawn_params params {
+        { path, strlen(path) },
+        { arguments.data(), arguments.size() },
+        { environment.data(), environment.size() },
+        actions.data(),
+        actions.size(),
+        attr ? attr->flags : 0,
+        attr ? attr->pgroup : 0,
+        attr ? attr->schedparam.sched_priority : 0,
+        attr ? attr->sigdefault : 0,
+        attr ? attr->sigmask : 0,
+        attr ? attr->tty_fd : -1,
+    };
+
+    int rc = syscall(SC_posix_spawn, &params);
+    if (rc < 0)
+        return -rc;
+    *out_pid = rc;
+    return 0;
 }
 
 int posix_spawn(pid_t* out_pid, const char* path, const posix_spawn_file_actions_t* file_actions, const posix_spawnattr_t* attr, char* const argv[], char* const envp[])
 {
-    pid_t child_pid = fork();
-    if (child_pid < 0)
-        return errno;
-
-    if (child_pid != 0) {
-        *out_pid = child_pid;
-        return 0;
-    }
-
-    posix_spawn_child(path, file_actions, attr, argv, envp, execve);
+    return spawn(out_pid, path, file_actions, attr, argv, envp);
 }
 
 int posix_spawnp(pid_t* out_pid, const char* path, const posix_spawn_file_actions_t* file_actions, const posix_spawnattr_t* attr, char* const argv[], char* const envp[])
 {
-    pid_t child_pid = fork();
-    if (child_pid < 0)
-        return errno;
+    if (strchr(path, '/'))
+        return spawn(out_pid, path, file_actions, attr, argv, envp);
 
-    if (child_pid != 0) {
-        *out_pid = child_pid;
-        return 0;
+    String search_path = getenv("PATH");
+    if (search_path.is_empty())
+        search_path = "/bin:/usr/bin";
+    for (auto& part : search_path.split(':')) {
+        auto candidate = String::formatted("{}/{}", part, path);
+        int rc = spawn(out_pid, candidate.characters(), file_actions, attr, argv, envp);
+        if (rc != ENOENT)
+            return rc;
     }
-
-    posix_spawn_child(path, file_actions, attr, argv, envp, execvpe);
+    return ENOENT;
 }
 
 int posix_spawn_file_actions_addchdir(posix_spawn_file_actions_t* actions, const char* path)
 {
-    actions->state->actions.append([path]() { return chdir(path); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Chdir, .path = path });
     return 0;
 }
 
 int posix_spawn_file_actions_addfchdir(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return fchdir(fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Fchdir, .fd = fd });
     return 0;
 }
 
 int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return close(fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Close, .fd = fd });
     return 0;
 }
 
 int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int old_fd, int new_fd)
 {
-    actions->state->actions.append([old_fd, new_fd]() { return dup2(old_fd, new_fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Dup2, .fd = old_fd, .new_fd = new_fd });
     return 0;
 }
 
 int posix_spawn_file_actions_addopen(posix_spawn_file_actions_t* actions, int want_fd, const char* path, int flags, mode_t mode)
 {
-    actions->state->actions.append([want_fd, path, flags, mode]() {
-        int opened_fd = open(path, flags, mode);
-        if (opened_fd < 0 || opened_fd == want_fd)
-            return opened_fd;
-        if (int rc = dup2(opened_fd, want_fd); rc < 0)
-            return rc;
-        return close(opened_fd);
-    });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Open, .fd = want_fd, .options = flags, .mode = mode, .path = path });
     return 0;
 }
 
@@ -225,12 +186,13 @@ int posix_spawnattr_init(posix_spawnattr_t* attr)
     // attr->schedpolicy intentionally not written; its default value is unspecified.
     sigemptyset(&attr->sigdefault);
     // attr->sigmask intentionally not written; its default value is unspecified.
+    attr->tty_fd = -1;
     return 0;
 }
 
 int posix_spawnattr_setflags(posix_spawnattr_t* attr, short flags)
 {
-    if (flags & ~(POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID))
+    if (flags & ~(POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID | POSIX_SPAWN_TCSETPGROUP))
         return EINVAL;
 
     attr->flags = flags;
@@ -266,4 +228,16 @@ int posix_spawnattr_setsigmask(posix_spawnattr_t* attr, const sigset_t* sigmask)
     attr->sigmask = *sigmask;
     return 0;
 }
+
+int posix_spawnattr_tcgetpgrp_np(const posix_spawnattr_t* attr, int* out_tty_fd)
+{
+    *out_tty_fd = attr->tty_fd;
+    return 0;
+}
+
+int posix_spawnattr_tcsetpgrp_np(posix_spawnattr_t* attr, int tty_fd)
+{
+    attr->tty_fd = tty_fd;
+    return 0;
+}
 }
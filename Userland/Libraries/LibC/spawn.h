@@ -31,9 +31,14 @@ enum {
     POSIX_SPAWN_SETSIGMASK = 1 << 5,
 
     POSIX_SPAWN_SETSID = 1 << 6,
+
+    // Makes the child's process group the foreground one of the terminal given with posix_spawnattr_tcsetpgrp_np(),
+    // before the child starts running. This is a GNU extension.
+    POSIX_SPAWN_TCSETPGROUP = 1 << 7,
 };
 
 #define POSIX_SPAWN_SETSID POSIX_SPAWN_SETSID
+#define POSIX_SPAWN_TCSETPGROUP POSIX_SPAWN_TCSETPGROUP
 
 struct posix_spawn_file_actions_state;
 typedef struct {
@@ -47,6 +52,7 @@ typedef struct {
     int schedpolicy;
     sigset_t sigdefault;
     sigset_t sigmask;
+    int tty_fd;
 } posix_spawnattr_t;
 
 int posix_spawn(pid_t*, const char*, const posix_spawn_file_actions_t*, const posix_spawnattr_t*, char* const argv[], char* const envp[]);
@@ -74,5 +80,7 @@ int posix_spawnattr_setschedparam(posix_spawnattr_t*, const struct sched_param*)
 int posix_spawnattr_setschedpolicy(posix_spawnattr_t*, int);
 int posix_spawnattr_setsigdefault(posix_spawnattr_t*, const sigset_t*);
 int posix_spawnattr_setsigmask(posix_spawnattr_t*, const sigset_t*);
+int posix_spawnattr_tcgetpgrp_np(const posix_spawnattr_t*, int*);
+int posix_spawnattr_tcsetpgrp_np(posix_spawnattr_t*, int);
 
 __END_DECLS
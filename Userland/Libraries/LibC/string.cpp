@@ -4,11 +4,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Endian.h>
 #include <AK/Format.h>
 #include <AK/MemMem.h>
 #include <AK/Platform.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
+#include <LibELF/AuxiliaryVector.h>
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
@@ -16,6 +18,264 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/internals.h>
+
+// The generic versions are used until __string_init() has had a look at the CPU, after that
+// the string functions below dispatch to the fastest variant it supports.
+
+static size_t strlen_generic(const char* str)
+{
+    size_t len = 0;
+    while (*(str++))
+        ++len;
+    return len;
+}
+
+static int memcmp_generic(const void* v1, const void* v2, size_t n)
+{
+    auto* s1 = (const uint8_t*)v1;
+    auto* s2 = (const uint8_t*)v2;
+    while (n-- > 0) {
+        if (*s1++ != *s2++)
+            return s1[-1] < s2[-1] ? -1 : 1;
+    }
+    return 0;
+}
+
+static void* memcpy_generic(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    void* original_dest = dest_ptr;
+    asm volatile(
+        "rep movsb"
+        : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
+    return original_dest;
+}
+
+static void* memset_generic(void* dest_ptr, int c, size_t n)
+{
+    size_t dest = (size_t)dest_ptr;
+    // FIXME: Support starting at an unaligned address.
+    if (!(dest & 0x3) && n >= 12) {
+        size_t size_ts = n / sizeof(size_t);
+        size_t expanded_c = explode_byte((u8)c);
+#if ARCH(I386)
+        asm volatile(
+            "rep stosl\n"
+            : "=D"(dest)
+            : "D"(dest), "c"(size_ts), "a"(expanded_c)
+            : "memory");
+#else
+        asm volatile(
+            "rep stosq\n"
+            : "=D"(dest)
+            : "D"(dest), "c"(size_ts), "a"(expanded_c)
+            : "memory");
+#endif
+        n -= size_ts * sizeof(size_t);
+        if (n == 0)
+            return dest_ptr;
+    }
+    asm volatile(
+        "rep stosb\n"
+        : "=D"(dest), "=c"(n)
+        : "0"(dest), "1"(n), "a"(c)
+        : "memory");
+    return dest_ptr;
+}
+
+// Every x86_64 CPU has SSE2, on i386 these are only picked if CPUID says it's there.
+#define SSE2_TARGET __attribute__((target("sse2")))
+
+typedef char v16qi __attribute__((vector_size(16), may_alias));
+
+template<typename T>
+struct [[gnu::packed, gnu::may_alias]] Unaligned {
+    T value;
+};
+
+template<typename T>
+SSE2_TARGET ALWAYS_INLINE static T load(const u8* ptr)
+{
+    return ((const Unaligned<T>*)ptr)->value;
+}
+
+template<typename T>
+SSE2_TARGET ALWAYS_INLINE static void store(u8* ptr, T value)
+{
+    ((Unaligned<T>*)ptr)->value = value;
+}
+
+SSE2_TARGET ALWAYS_INLINE static unsigned zero_byte_mask(v16qi chunk)
+{
+    return __builtin_ia32_pmovmskb128((v16qi)(chunk == v16qi {}));
+}
+
+SSE2_TARGET ALWAYS_INLINE static unsigned difference_mask(const u8* s1, const u8* s2)
+{
+    return __builtin_ia32_pmovmskb128((v16qi)(load<v16qi>(s1) == load<v16qi>(s2))) ^ 0xffff;
+}
+
+// Up to twice the size of T is handled by copying (or filling) both ends of the range, which may overlap.
+template<typename T>
+SSE2_TARGET ALWAYS_INLINE static void copy_both_ends(u8* dest, const u8* src, size_t n)
+{
+    auto head = load<T>(src);
+    auto tail = load<T>(src + n - sizeof(T));
+    store<T>(dest, head);
+    store<T>(dest + n - sizeof(T), tail);
+}
+
+template<typename T>
+SSE2_TARGET ALWAYS_INLINE static void fill_both_ends(u8* dest, T pattern, size_t n)
+{
+    store<T>(dest, pattern);
+    store<T>(dest + n - sizeof(T), pattern);
+}
+
+template<typename T>
+SSE2_TARGET ALWAYS_INLINE static int compare_big_endian(const u8* s1, const u8* s2)
+{
+    auto a = load<T>(s1);
+    auto b = load<T>(s2);
+    if (a == b)
+        return 0;
+    return AK::convert_between_host_and_big_endian(a) < AK::convert_between_host_and_big_endian(b) ? -1 : 1;
+}
+
+// Below this size, rep movsb and rep stosb take longer to get going than a loop of vector stores,
+// even with ERMS (Enhanced REP MOVSB/STOSB).
+static constexpr size_t rep_string_threshold = 2048;
+
+SSE2_TARGET static size_t strlen_sse2(const char* str)
+{
+    // Aligned loads never cross into the next page, so it's fine to read a bit before and after the string.
+    auto address = (FlatPtr)str;
+    auto* chunk = (const v16qi*)(address & ~(FlatPtr)15);
+    if (auto mask = zero_byte_mask(*chunk) >> (address & 15))
+        return __builtin_ctz(mask);
+    for (;;) {
+        ++chunk;
+        if (auto mask = zero_byte_mask(*chunk))
+            return (const char*)chunk - str + __builtin_ctz(mask);
+    }
+}
+
+SSE2_TARGET static int memcmp_sse2(const void* v1, const void* v2, size_t n)
+{
+    auto* s1 = (const u8*)v1;
+    auto* s2 = (const u8*)v2;
+    if (n < 16) {
+        if (n >= 8) {
+            if (auto result = compare_big_endian<u64>(s1, s2))
+                return result;
+            return compare_big_endian<u64>(s1 + n - 8, s2 + n - 8);
+        }
+        if (n >= 4) {
+            if (auto result = compare_big_endian<u32>(s1, s2))
+                return result;
+            return compare_big_endian<u32>(s1 + n - 4, s2 + n - 4);
+        }
+        return memcmp_generic(s1, s2, n);
+    }
+
+    // The last chunk overlaps the one before it, instead of comparing the remaining bytes one by one.
+    for (size_t offset = 0;; offset += 16) {
+        if (offset > n - 16)
+            offset = n - 16;
+        if (auto mask = difference_mask(s1 + offset, s2 + offset)) {
+            auto index = offset + __builtin_ctz(mask);
+            return s1[index] < s2[index] ? -1 : 1;
+        }
+        if (offset == n - 16)
+            return 0;
+    }
+}
+
+template<bool has_erms>
+SSE2_TARGET static void* memcpy_sse2(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    auto* src = (const u8*)src_ptr;
+    if (n <= 32) {
+        if (n >= 16)
+            copy_both_ends<v16qi>(dest, src, n);
+        else if (n >= 8)
+            copy_both_ends<u64>(dest, src, n);
+        else if (n >= 4)
+            copy_both_ends<u32>(dest, src, n);
+        else if (n >= 2)
+            copy_both_ends<u16>(dest, src, n);
+        else if (n == 1)
+            *dest = *src;
+        return dest_ptr;
+    }
+
+    if (has_erms && n >= rep_string_threshold)
+        return memcpy_generic(dest_ptr, src_ptr, n);
+
+    // Both ends are loaded up front and stored unaligned afterwards, everything in between is stored
+    // 16-byte aligned. Loading the ends first keeps this safe for the overlapping forward copies of memmove().
+    auto head = load<v16qi>(src);
+    auto tail = load<v16qi>(src + n - 16);
+    for (size_t offset = 16 - ((FlatPtr)dest & 15); offset < n - 16; offset += 16)
+        *(v16qi*)(dest + offset) = load<v16qi>(src + offset);
+    store<v16qi>(dest, head);
+    store<v16qi>(dest + n - 16, tail);
+    return dest_ptr;
+}
+
+template<bool has_erms>
+SSE2_TARGET static void* memset_sse2(void* dest_ptr, int c, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    if (n < 16) {
+        u64 pattern = 0x0101010101010101ull * (u8)c;
+        if (n >= 8)
+            fill_both_ends<u64>(dest, pattern, n);
+        else if (n >= 4)
+            fill_both_ends<u32>(dest, (u32)pattern, n);
+        else if (n >= 2)
+            fill_both_ends<u16>(dest, (u16)pattern, n);
+        else if (n == 1)
+            *dest = (u8)c;
+        return dest_ptr;
+    }
+
+    if (has_erms && n >= rep_string_threshold) {
+        asm volatile(
+            "rep stosb\n"
+            : "+D"(dest), "+c"(n)
+            : "a"(c)
+            : "memory");
+        return dest_ptr;
+    }
+
+    auto pattern = v16qi {} + (char)c;
+    fill_both_ends<v16qi>(dest, pattern, n);
+    for (size_t offset = 16 - ((FlatPtr)dest & 15); offset < n - 16; offset += 16)
+        *(v16qi*)(dest + offset) = pattern;
+    return dest_ptr;
+}
+
+static size_t (*s_strlen)(const char*) = strlen_generic;
+static int (*s_memcmp)(const void*, const void*, size_t) = memcmp_generic;
+static void* (*s_memcpy)(void*, const void*, size_t) = memcpy_generic;
+static void* (*s_memset)(void*, int, size_t) = memset_generic;
+
+static bool cpu_has_erms()
+{
+    u32 max_leaf, ebx, ecx, edx;
+    asm("cpuid"
+        : "=a"(max_leaf), "=b"(ebx), "=c"(ecx), "=d"(edx)
+        : "a"(0));
+    if (max_leaf < 7)
+        return false;
+    u32 eax;
+    asm("cpuid"
+        : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+        : "a"(7), "c"(0));
+    return ebx & (1u << 9);
+}
 
 extern "C" {
 
@@ -47,10 +307,7 @@ size_t strcspn(const char* s, const char* reject)
 
 size_t strlen(const char* str)
 {
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
+    return s_strlen(str);
 }
 
 size_t strnlen(const char* str, size_t maxlen)
@@ -102,54 +359,32 @@ int strncmp(const char* s1, const char* s2, size_t n)
 
 int memcmp(const void* v1, const void* v2, size_t n)
 {
-    auto* s1 = (const uint8_t*)v1;
-    auto* s2 = (const uint8_t*)v2;
-    while (n-- > 0) {
-        if (*s1++ != *s2++)
-            return s1[-1] < s2[-1] ? -1 : 1;
-    }
-    return 0;
+    return s_memcmp(v1, v2, n);
 }
 
 void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
 {
-    void* original_dest = dest_ptr;
-    asm volatile(
-        "rep movsb"
-        : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
-    return original_dest;
+    return s_memcpy(dest_ptr, src_ptr, n);
 }
 
 void* memset(void* dest_ptr, int c, size_t n)
 {
-    size_t dest = (size_t)dest_ptr;
-    // FIXME: Support starting at an unaligned address.
-    if (!(dest & 0x3) && n >= 12) {
-        size_t size_ts = n / sizeof(size_t);
-        size_t expanded_c = explode_byte((u8)c);
-#if ARCH(I386)
-        asm volatile(
-            "rep stosl\n"
-            : "=D"(dest)
-            : "D"(dest), "c"(size_ts), "a"(expanded_c)
-            : "memory");
-#else
-        asm volatile(
-            "rep stosq\n"
-            : "=D"(dest)
-            : "D"(dest), "c"(size_ts), "a"(expanded_c)
-            : "memory");
-#endif
-        n -= size_ts * sizeof(size_t);
-        if (n == 0)
-            return dest_ptr;
+    return s_memset(dest_ptr, c, n);
+}
+
+void __string_init()
+{
+    if (!(getauxval(AT_HWCAP) & (1 << 26)))
+        return;
+    s_strlen = strlen_sse2;
+    s_memcmp = memcmp_sse2;
+    if (cpu_has_erms()) {
+        s_memcpy = memcpy_sse2<true>;
+        s_memset = memset_sse2<true>;
+    } else {
+        s_memcpy = memcpy_sse2<false>;
+        s_memset = memset_sse2<false>;
     }
-    asm volatile(
-        "rep stosb\n"
-        : "=D"(dest), "=c"(n)
-        : "0"(dest), "1"(n), "a"(c)
-        : "memory");
-    return dest_ptr;
 }
 
 void* memmove(void* dest, const void* src, size_t n)
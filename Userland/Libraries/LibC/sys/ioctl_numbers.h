@@ -86,6 +86,7 @@ enum IOCtlNumber {
     KCOV_SETBUFSIZE,
     KCOV_ENABLE,
     KCOV_DISABLE,
+    LOCAL_SOCKET_RING_NOTIFY,
 };
 
 #define TIOCGPGRP TIOCGPGRP
@@ -126,3 +127,4 @@ enum IOCtlNumber {
 #define SIOCDARP SIOCDARP
 #define FIBMAP FIBMAP
 #define FIONBIO FIONBIO
+#define LOCAL_SOCKET_RING_NOTIFY LOCAL_SOCKET_RING_NOTIFY
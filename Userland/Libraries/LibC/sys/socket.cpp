@@ -103,6 +103,23 @@ ssize_t recv(int sockfd, void* buffer, size_t buffer_length, int flags)
     return recvfrom(sockfd, buffer, buffer_length, flags, nullptr, nullptr);
 }
 
+int sendmmsg(int sockfd, struct mmsghdr* msgs, unsigned int message_count, int flags)
+{
+    int rc = syscall(SC_sendmmsg, sockfd, msgs, message_count, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int recvmmsg(int sockfd, struct mmsghdr* msgs, unsigned int message_count, int flags, struct timespec* timeout)
+{
+    // FIXME: Implement the timeout.
+    if (timeout) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    int rc = syscall(SC_recvmmsg, sockfd, msgs, message_count, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int getsockopt(int sockfd, int level, int option, void* value, socklen_t* value_size)
 {
     Syscall::SC_getsockopt_params params { sockfd, level, option, value, value_size };
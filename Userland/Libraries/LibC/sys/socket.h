@@ -13,6 +13,8 @@
 
 __BEGIN_DECLS
 
+struct timespec;
+
 #define AF_MASK 0xff
 #define AF_UNSPEC 0
 #define AF_LOCAL 1
@@ -68,6 +70,11 @@ struct msghdr {
     int msg_flags;
 };
 
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+};
+
 struct sockaddr {
     sa_family_t sa_family;
     char sa_data[14];
@@ -101,6 +108,7 @@ enum {
     SO_TIMESTAMP,
     SO_BROADCAST,
     SO_LINGER,
+    SO_REUSEPORT,
 };
 #define SO_RCVTIMEO SO_RCVTIMEO
 #define SO_SNDTIMEO SO_SNDTIMEO
@@ -115,6 +123,7 @@ enum {
 #define SO_SNDBUF SO_SNDBUF
 #define SO_RCVBUF SO_RCVBUF
 #define SO_LINGER SO_LINGER
+#define SO_REUSEPORT SO_REUSEPORT
 
 enum {
     SCM_TIMESTAMP,
@@ -144,6 +153,8 @@ ssize_t sendto(int sockfd, const void*, size_t, int flags, const struct sockaddr
 ssize_t recv(int sockfd, void*, size_t, int flags);
 ssize_t recvmsg(int sockfd, struct msghdr*, int flags);
 ssize_t recvfrom(int sockfd, void*, size_t, int flags, struct sockaddr*, socklen_t*);
+int sendmmsg(int sockfd, struct mmsghdr*, unsigned int message_count, int flags);
+int recvmmsg(int sockfd, struct mmsghdr*, unsigned int message_count, int flags, struct timespec* timeout);
 int getsockopt(int sockfd, int level, int option, void*, socklen_t*);
 int setsockopt(int sockfd, int level, int option, const void*, socklen_t);
 int getsockname(int sockfd, struct sockaddr*, socklen_t*);
@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <AK/Time.h>
+#include <Kernel/API/TimePage.h>
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
@@ -353,8 +355,65 @@ clock_t clock()
     return tms.tms_utime + tms.tms_stime;
 }
 
+static TimePage const* time_page()
+{
+    static Atomic<TimePage const*> s_time_page;
+    static Atomic<bool> s_time_page_is_unavailable;
+
+    if (auto* time_page = s_time_page.load(AK::MemoryOrder::memory_order_acquire))
+        return time_page;
+    if (s_time_page_is_unavailable.load(AK::MemoryOrder::memory_order_relaxed))
+        return nullptr;
+
+    ptrdiff_t rc = syscall(SC_map_time_page);
+    if (rc < 0 && -rc < EMAXERRNO) {
+        s_time_page_is_unavailable.store(true, AK::MemoryOrder::memory_order_relaxed);
+        return nullptr;
+    }
+    // NOTE: If another thread beat us to it, our mapping just stays unused.
+    TimePage const* time_page = nullptr;
+    if (!s_time_page.compare_exchange_strong(time_page, reinterpret_cast<TimePage const*>(rc), AK::MemoryOrder::memory_order_acq_rel))
+        return time_page;
+    return reinterpret_cast<TimePage const*>(rc);
+}
+
+static bool read_time_page(clockid_t clock_id, struct timespec& ts)
+{
+    bool is_coarse = clock_id == CLOCK_MONOTONIC_COARSE || clock_id == CLOCK_REALTIME_COARSE;
+    bool is_realtime = clock_id == CLOCK_REALTIME || clock_id == CLOCK_REALTIME_COARSE;
+    if (!is_coarse && !is_realtime && clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_MONOTONIC_RAW)
+        return false;
+
+    auto* page = time_page();
+    if (!page)
+        return false;
+
+    i64 ns = 0;
+    u32 sequence;
+    do {
+        sequence = AK::atomic_load(const_cast<u32 volatile*>(&page->sequence), AK::MemoryOrder::memory_order_acquire);
+        if (sequence & 1)
+            continue;
+        if (is_coarse) {
+            ns = is_realtime ? page->realtime_coarse_ns : static_cast<i64>(page->monotonic_coarse_ns);
+        } else {
+            if (!(page->flags & TIME_PAGE_HAS_TSC))
+                return false;
+            auto elapsed_ns = time_page_tsc_delta_to_ns(__builtin_ia32_rdtsc() - page->tsc_base, page->tsc_multiplier);
+            ns = (is_realtime ? page->realtime_base_ns : static_cast<i64>(page->monotonic_base_ns)) + static_cast<i64>(elapsed_ns);
+        }
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+    } while ((sequence & 1) || sequence != AK::atomic_load(const_cast<u32 volatile*>(&page->sequence), AK::MemoryOrder::memory_order_relaxed));
+
+    ts = Time::from_nanoseconds(ns).to_timespec();
+    return true;
+}
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
+    if (ts && read_time_page(clock_id, *ts))
+        return 0;
+
     int rc = syscall(SC_clock_gettime, clock_id, ts);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
@@ -8,11 +8,12 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -59,15 +60,16 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
+        code.m_code_counts[1] = 1;
         code.m_symbol_values.append(last_non_zero);
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
+        code.build_lookup_table();
         return code;
     }
 
     auto next_code = 0;
-    for (size_t code_length = 1; code_length <= 15; ++code_length) {
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
 
@@ -78,7 +80,7 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
+            code.m_code_counts[code_length]++;
             code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
@@ -91,24 +93,78 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         return {};
     }
 
+    code.build_lookup_table();
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+void CanonicalCode::build_lookup_table()
 {
-    u32 code_bits = 1;
+    // The codes are stored lsb-first, so all inputs starting with a code of length n put it in every 2^n-th
+    // entry from the code on. Codes longer than primary_lookup_bits go into a subtable for their first bits,
+    // indexed by the rest, that is as big as the longest of them needs.
+    constexpr size_t primary_size = 1 << primary_lookup_bits;
+    m_lookup_table.clear();
+    m_lookup_table.resize(primary_size);
+
+    Array<u8, primary_size> subtable_bits {};
+    for (auto symbol : m_symbol_values) {
+        auto length = m_bit_code_lengths[symbol];
+        auto code = m_bit_codes[symbol];
+        if (length <= primary_lookup_bits) {
+            for (size_t index = code; index < primary_size; index += 1 << length)
+                m_lookup_table[index] = { symbol, (u8)length, false };
+        } else {
+            auto& bits = subtable_bits[code & (primary_size - 1)];
+            bits = max<u8>(bits, length - primary_lookup_bits);
+        }
+    }
 
-    for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
-            return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    for (size_t prefix = 0; prefix < primary_size; ++prefix) {
+        if (!subtable_bits[prefix])
+            continue;
+        m_lookup_table[prefix] = { (u16)m_lookup_table.size(), subtable_bits[prefix], true };
+        m_lookup_table.resize(m_lookup_table.size() + (1 << subtable_bits[prefix]));
+    }
+
+    for (auto symbol : m_symbol_values) {
+        auto length = m_bit_code_lengths[symbol];
+        if (length <= primary_lookup_bits)
+            continue;
+        auto code = m_bit_codes[symbol];
+        auto subtable = m_lookup_table[code & (primary_size - 1)];
+        for (size_t index = code >> primary_lookup_bits; index < (1u << subtable.bits); index += 1 << (length - primary_lookup_bits))
+            m_lookup_table[subtable.value + index] = { symbol, (u8)length, false };
+    }
+}
+
+u32 CanonicalCode::decode_symbol(u32 bits, size_t& code_length) const
+{
+    auto entry = m_lookup_table[bits & ((1 << primary_lookup_bits) - 1)];
+    if (entry.is_subtable)
+        entry = m_lookup_table[entry.value + ((bits >> primary_lookup_bits) & ((1 << entry.bits) - 1))];
+    if (!entry.bits)
+        return UINT32_MAX;
+    code_length = entry.bits;
+    return entry.value;
+}
+
+u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+{
+    // The codes of each length are consecutive numbers following on from the shorter ones, so after each
+    // bit it's enough to check whether the code read so far is among the codes of its length.
+    u32 code = 0;
+    u32 first_code = 0;
+    size_t first_index = 0;
+    for (size_t length = 1; length <= max_code_length; ++length) {
+        code |= stream.read_bits(1);
+        auto count = m_code_counts[length];
+        if (code - first_code < count)
+            return m_symbol_values[first_index + code - first_code];
+        first_index += count;
+        first_code = (first_code + count) << 1;
+        code <<= 1;
     }
+    return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
 }
 
 void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
@@ -116,6 +172,224 @@ void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
     stream.write_bits(m_bit_codes[symbol], m_bit_code_lengths[symbol]);
 }
 
+// Reads bits lsb-first from input that is all in memory, so that the next ones can be looked at before
+// it's known how many of them to take. Past the end of the input it reads zeroes, and remembers it did.
+class MemoryBitReader {
+public:
+    explicit MemoryBitReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    ALWAYS_INLINE u32 peek_bits(size_t count)
+    {
+        VERIFY(count <= 32);
+        if (m_bit_count < count)
+            refill();
+        return m_bit_buffer & ((1ull << count) - 1);
+    }
+
+    ALWAYS_INLINE void consume_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer >>= count;
+        m_bit_count -= count;
+    }
+
+    ALWAYS_INLINE u32 read_bits(size_t count)
+    {
+        auto bits = peek_bits(count);
+        consume_bits(count);
+        return bits;
+    }
+
+    void align_to_byte_boundary() { consume_bits(m_bit_count % 8); }
+
+    // Takes the next count bytes at once. Has to be byte aligned.
+    Optional<ReadonlyBytes> read_bytes(size_t count)
+    {
+        VERIFY(m_bit_count % 8 == 0);
+        auto position = m_position - m_bit_count / 8;
+        m_bit_buffer = 0;
+        m_bit_count = 0;
+        if (position > m_bytes.size() || m_bytes.size() - position < count) {
+            m_position = m_bytes.size() + 1;
+            return {};
+        }
+        m_position = position + count;
+        return m_bytes.slice(position, count);
+    }
+
+    bool is_past_end() const { return (m_position - m_bit_count / 8) > m_bytes.size(); }
+
+private:
+    void refill()
+    {
+        if (m_position + sizeof(u64) <= m_bytes.size()) {
+            // Bits above the ones counted get set too, but only to what the next refill will set them to.
+            u64 word;
+            __builtin_memcpy(&word, m_bytes.offset_pointer(m_position), sizeof(word));
+            m_bit_buffer |= AK::convert_between_host_and_little_endian(word) << m_bit_count;
+            auto byte_count = (63 - m_bit_count) / 8;
+            m_position += byte_count;
+            m_bit_count += byte_count * 8;
+            return;
+        }
+        while (m_bit_count <= 56) {
+            u64 byte = m_position < m_bytes.size() ? m_bytes[m_position] : 0;
+            m_bit_buffer |= byte << m_bit_count;
+            m_bit_count += 8;
+            ++m_position;
+        }
+    }
+
+    ReadonlyBytes m_bytes;
+    size_t m_position { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+};
+
+static u32 read_symbol(InputBitStream& stream, CanonicalCode const& code)
+{
+    return code.read_symbol(stream);
+}
+
+static ALWAYS_INLINE u32 read_symbol(MemoryBitReader& reader, CanonicalCode const& code)
+{
+    size_t code_length = 0;
+    auto symbol = code.decode_symbol(reader.peek_bits(CanonicalCode::max_code_length), code_length);
+    if (symbol != UINT32_MAX)
+        reader.consume_bits(code_length);
+    return symbol;
+}
+
+template<typename BitReader>
+static u32 decode_length(BitReader& reader, u32 symbol)
+{
+    // FIXME: I can't quite follow the algorithm here, but it seems to work.
+
+    if (symbol <= 264)
+        return symbol - 254;
+
+    if (symbol <= 284) {
+        auto extra_bits = (symbol - 261) / 4;
+        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + reader.read_bits(extra_bits);
+    }
+
+    if (symbol == 285)
+        return 258;
+
+    VERIFY_NOT_REACHED();
+}
+
+template<typename BitReader>
+static u32 decode_distance(BitReader& reader, u32 symbol)
+{
+    // FIXME: I can't quite follow the algorithm here, but it seems to work.
+
+    if (symbol <= 3)
+        return symbol + 1;
+
+    if (symbol <= 29) {
+        auto extra_bits = (symbol / 2) - 1;
+        return ((symbol % 2 + 2) << extra_bits) + 1 + reader.read_bits(extra_bits);
+    }
+
+    VERIFY_NOT_REACHED();
+}
+
+template<typename BitReader>
+static bool read_dynamic_codes(BitReader& reader, CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
+{
+    auto literal_code_count = reader.read_bits(5) + 257;
+    auto distance_code_count = reader.read_bits(5) + 1;
+    auto code_length_count = reader.read_bits(4) + 4;
+
+    // First we have to extract the code lengths of the code that was used to encode the code lengths of
+    // the code that was used to encode the block.
+
+    u8 code_lengths_code_lengths[19] = { 0 };
+    for (size_t i = 0; i < code_length_count; ++i) {
+        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = reader.read_bits(3);
+    }
+
+    // Now we can extract the code that was used to encode the code lengths of the code that was used to
+    // encode the block.
+
+    auto code_length_code_result = CanonicalCode::from_bytes({ code_lengths_code_lengths, sizeof(code_lengths_code_lengths) });
+    if (!code_length_code_result.has_value()) {
+        return false;
+    }
+    const auto code_length_code = code_length_code_result.value();
+
+    // Next we extract the code lengths of the code that was used to encode the block.
+
+    Vector<u8> code_lengths;
+    while (code_lengths.size() < literal_code_count + distance_code_count) {
+        auto symbol = read_symbol(reader, code_length_code);
+
+        if (symbol == UINT32_MAX) {
+            return false;
+        }
+
+        if (symbol < DeflateSpecialCodeLengths::COPY) {
+            code_lengths.append(static_cast<u8>(symbol));
+            continue;
+        } else if (symbol == DeflateSpecialCodeLengths::ZEROS) {
+            auto nrepeat = 3 + reader.read_bits(3);
+            for (size_t j = 0; j < nrepeat; ++j)
+                code_lengths.append(0);
+            continue;
+        } else if (symbol == DeflateSpecialCodeLengths::LONG_ZEROS) {
+            auto nrepeat = 11 + reader.read_bits(7);
+            for (size_t j = 0; j < nrepeat; ++j)
+                code_lengths.append(0);
+            continue;
+        } else {
+            VERIFY(symbol == DeflateSpecialCodeLengths::COPY);
+
+            if (code_lengths.is_empty()) {
+                return false;
+            }
+
+            auto nrepeat = 3 + reader.read_bits(2);
+            for (size_t j = 0; j < nrepeat; ++j)
+                code_lengths.append(code_lengths.last());
+        }
+    }
+
+    if (code_lengths.size() != literal_code_count + distance_code_count) {
+        return false;
+    }
+
+    // Now we extract the code that was used to encode literals and lengths in the block.
+
+    auto literal_code_result = CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count));
+    if (!literal_code_result.has_value()) {
+        return false;
+    }
+    literal_code = literal_code_result.value();
+
+    // Now we extract the code that was used to encode distances in the block.
+
+    if (distance_code_count == 1) {
+        auto length = code_lengths[literal_code_count];
+
+        if (length == 0) {
+            return true;
+        } else if (length != 1) {
+            return false;
+        }
+    }
+
+    auto distance_code_result = CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count));
+    if (!distance_code_result.has_value()) {
+        return false;
+    }
+    distance_code = distance_code_result.value();
+    return true;
+}
+
 DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
     : m_decompressor(decompressor)
     , m_literal_codes(literal_codes)
@@ -147,22 +421,24 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
             return false;
         }
 
-        const auto length = m_decompressor.decode_length(symbol);
+        const auto length = decode_length(m_decompressor.m_input_stream, symbol);
         const auto distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
         if (distance_symbol >= 30) { // invalid deflate distance symbol
             m_decompressor.set_fatal_error();
             return false;
         }
-        const auto distance = m_decompressor.decode_distance(distance_symbol);
+        const auto distance = decode_distance(m_decompressor.m_input_stream, distance_symbol);
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
+        // Copy in pieces of at most distance bytes, each of which is in the window before it's copied.
+        u8 buffer[258];
+        for (size_t copied = 0; copied < length;) {
+            auto nread = m_decompressor.m_output_stream.read({ buffer, length - copied }, distance);
             if (m_decompressor.m_output_stream.handle_any_error()) {
                 m_decompressor.set_fatal_error();
                 return false; // a back reference was requested that was too far back (outside our current sliding window)
             }
-            m_decompressor.m_output_stream << byte;
+            m_decompressor.m_output_stream.write({ buffer, nread });
+            copied += nread;
         }
 
         return true;
@@ -355,152 +631,103 @@ bool DeflateDecompressor::handle_any_error()
     return Stream::handle_any_error() || handled_errors;
 }
 
-Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
+// Decodes one compressed block onto the end of output, of which output_size bytes are used.
+static bool inflate_block(MemoryBitReader& reader, CanonicalCode const& literal_codes, CanonicalCode const* distance_codes, ByteBuffer& output, size_t& output_size)
 {
-    InputMemoryStream memory_stream { bytes };
-    DeflateDecompressor deflate_stream { memory_stream };
-    DuplexMemoryStream output_stream;
-
-    u8 buffer[4096];
-    while (!deflate_stream.has_any_error() && !deflate_stream.unreliable_eof()) {
-        const auto nread = deflate_stream.read({ buffer, sizeof(buffer) });
-        output_stream.write_or_error({ buffer, nread });
-    }
+    // A back reference can write up to 258 bytes, and copying it in words up to 7 more.
+    constexpr size_t max_bytes_per_symbol = 258 + sizeof(u64);
 
-    if (deflate_stream.handle_any_error())
-        return {};
-
-    return output_stream.copy_into_contiguous_buffer();
-}
-
-u32 DeflateDecompressor::decode_length(u32 symbol)
-{
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
+    for (;;) {
+        if (reader.is_past_end())
+            return false;
+        if (output.size() - output_size < max_bytes_per_symbol)
+            output.resize(max(output.size() * 2, output_size + max_bytes_per_symbol));
+        auto* out = output.data() + output_size;
+
+        auto symbol = read_symbol(reader, literal_codes);
+        if (symbol < 256) {
+            *out = symbol;
+            ++output_size;
+            continue;
+        }
+        if (symbol == 256)
+            return true;
+        if (symbol >= 286 || !distance_codes) // invalid deflate literal/length symbol
+            return false;
 
-    if (symbol <= 264)
-        return symbol - 254;
+        auto length = decode_length(reader, symbol);
+        auto distance_symbol = read_symbol(reader, *distance_codes);
+        if (distance_symbol >= 30) // invalid deflate distance symbol
+            return false;
+        auto distance = decode_distance(reader, distance_symbol);
+        if (distance > output_size)
+            return false;
 
-    if (symbol <= 284) {
-        auto extra_bits = (symbol - 261) / 4;
-        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + m_input_stream.read_bits(extra_bits);
+        u8 const* from = out - distance;
+        if (distance >= sizeof(u64)) {
+            // Each word is copied from before where it goes, so it's all been written already.
+            for (size_t i = 0; i < length; i += sizeof(u64))
+                __builtin_memcpy(out + i, from + i, sizeof(u64));
+        } else if (distance == 1) {
+            __builtin_memset(out, *from, length);
+        } else {
+            for (size_t i = 0; i < length; ++i)
+                out[i] = from[i];
+        }
+        output_size += length;
     }
-
-    if (symbol == 285)
-        return 258;
-
-    VERIFY_NOT_REACHED();
 }
 
-u32 DeflateDecompressor::decode_distance(u32 symbol)
+Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
-    if (symbol <= 3)
-        return symbol + 1;
+    MemoryBitReader reader { bytes };
+    ByteBuffer output;
+    output.resize(max<size_t>(bytes.size() * 4, 4 * KiB));
+    size_t output_size = 0;
+
+    bool read_final_block = false;
+    while (!read_final_block) {
+        read_final_block = reader.read_bits(1);
+        auto block_type = reader.read_bits(2);
+
+        if (block_type == 0b00) {
+            reader.align_to_byte_boundary();
+            auto length = reader.read_bits(16);
+            auto negated_length = reader.read_bits(16);
+            if ((length ^ 0xffff) != negated_length)
+                return {};
+            auto block = reader.read_bytes(length);
+            if (!block.has_value())
+                return {};
+            output.resize(max(output.size(), output_size + length));
+            block->copy_to(output.bytes().slice(output_size));
+            output_size += length;
+        } else if (block_type == 0b01) {
+            if (!inflate_block(reader, CanonicalCode::fixed_literal_codes(), &CanonicalCode::fixed_distance_codes(), output, output_size))
+                return {};
+        } else if (block_type == 0b10) {
+            CanonicalCode literal_codes;
+            Optional<CanonicalCode> distance_codes;
+            if (!read_dynamic_codes(reader, literal_codes, distance_codes))
+                return {};
+            if (!inflate_block(reader, literal_codes, distance_codes.has_value() ? &distance_codes.value() : nullptr, output, output_size))
+                return {};
+        } else {
+            return {};
+        }
 
-    if (symbol <= 29) {
-        auto extra_bits = (symbol / 2) - 1;
-        return ((symbol % 2 + 2) << extra_bits) + 1 + m_input_stream.read_bits(extra_bits);
+        if (reader.is_past_end())
+            return {};
     }
 
-    VERIFY_NOT_REACHED();
+    output.resize(output_size);
+    return output;
 }
 
 void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
 {
-    auto literal_code_count = m_input_stream.read_bits(5) + 257;
-    auto distance_code_count = m_input_stream.read_bits(5) + 1;
-    auto code_length_count = m_input_stream.read_bits(4) + 4;
-
-    // First we have to extract the code lengths of the code that was used to encode the code lengths of
-    // the code that was used to encode the block.
-
-    u8 code_lengths_code_lengths[19] = { 0 };
-    for (size_t i = 0; i < code_length_count; ++i) {
-        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = m_input_stream.read_bits(3);
-    }
-
-    // Now we can extract the code that was used to encode the code lengths of the code that was used to
-    // encode the block.
-
-    auto code_length_code_result = CanonicalCode::from_bytes({ code_lengths_code_lengths, sizeof(code_lengths_code_lengths) });
-    if (!code_length_code_result.has_value()) {
+    if (!read_dynamic_codes(m_input_stream, literal_code, distance_code))
         set_fatal_error();
-        return;
-    }
-    const auto code_length_code = code_length_code_result.value();
-
-    // Next we extract the code lengths of the code that was used to encode the block.
-
-    Vector<u8> code_lengths;
-    while (code_lengths.size() < literal_code_count + distance_code_count) {
-        auto symbol = code_length_code.read_symbol(m_input_stream);
-
-        if (symbol == UINT32_MAX) {
-            set_fatal_error();
-            return;
-        }
-
-        if (symbol < DeflateSpecialCodeLengths::COPY) {
-            code_lengths.append(static_cast<u8>(symbol));
-            continue;
-        } else if (symbol == DeflateSpecialCodeLengths::ZEROS) {
-            auto nrepeat = 3 + m_input_stream.read_bits(3);
-            for (size_t j = 0; j < nrepeat; ++j)
-                code_lengths.append(0);
-            continue;
-        } else if (symbol == DeflateSpecialCodeLengths::LONG_ZEROS) {
-            auto nrepeat = 11 + m_input_stream.read_bits(7);
-            for (size_t j = 0; j < nrepeat; ++j)
-                code_lengths.append(0);
-            continue;
-        } else {
-            VERIFY(symbol == DeflateSpecialCodeLengths::COPY);
-
-            if (code_lengths.is_empty()) {
-                set_fatal_error();
-                return;
-            }
-
-            auto nrepeat = 3 + m_input_stream.read_bits(2);
-            for (size_t j = 0; j < nrepeat; ++j)
-                code_lengths.append(code_lengths.last());
-        }
-    }
-
-    if (code_lengths.size() != literal_code_count + distance_code_count) {
-        set_fatal_error();
-        return;
-    }
-
-    // Now we extract the code that was used to encode literals and lengths in the block.
-
-    auto literal_code_result = CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count));
-    if (!literal_code_result.has_value()) {
-        set_fatal_error();
-        return;
-    }
-    literal_code = literal_code_result.value();
-
-    // Now we extract the code that was used to encode distances in the block.
-
-    if (distance_code_count == 1) {
-        auto length = code_lengths[literal_code_count];
-
-        if (length == 0) {
-            return;
-        } else if (length != 1) {
-            set_fatal_error();
-            return;
-        }
-    }
-
-    auto distance_code_result = CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count));
-    if (!distance_code_result.has_value()) {
-        set_fatal_error();
-        return;
-    }
-    distance_code = distance_code_result.value();
 }
 
 DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel compression_level)
@@ -590,8 +817,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
-            break; // outside the window
+        if (start - candidate > max_back_reference_distance)
+            break; // further back than a distance can reach, and so is the rest of the chain
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
 
@@ -724,6 +951,10 @@ void DeflateCompressor::lz77_compress_block()
 
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+
+    // the previous block (or the dictionary) is still in the window before it, so matches may start there as well
+    for (auto position = block_size - m_history_size; position < min(block_size, block_end - min_match_length + 1); position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -1043,6 +1274,7 @@ void DeflateCompressor::flush()
     m_distance_frequencies.fill(0);
     // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
     pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+    m_history_size = block_size;
 }
 
 void DeflateCompressor::final_flush()
@@ -1052,6 +1284,35 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished);
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+
+    m_history_size = min(dictionary.size(), block_size);
+    dictionary.slice(dictionary.size() - m_history_size).copy_to({ m_rolling_window + block_size - m_history_size, m_history_size });
+}
+
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        flush();
+    m_finished = true;
+
+    if (m_output_stream.handle_any_error()) {
+        set_fatal_error();
+        return;
+    }
+
+    m_output_stream.write_bit(false);
+    m_output_stream.write_bits(0b00, 2); // no compression
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    LittleEndian<u16> nlen = ~0;
+    m_output_stream << len << nlen;
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(const ReadonlyBytes& bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
@@ -1067,4 +1328,58 @@ Optional<ByteBuffer> DeflateCompressor::compress_all(const ReadonlyBytes& bytes,
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> DeflateCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel compression_level, size_t chunk_size)
+{
+    VERIFY(chunk_size > 0);
+    auto chunk_count = max<size_t>(1, ceil_div(bytes.size(), chunk_size));
+    thread_count = min(thread_count, chunk_count);
+    if (thread_count <= 1)
+        return compress_all(bytes, compression_level);
+
+    Vector<Optional<ByteBuffer>> compressed_chunks;
+    compressed_chunks.resize(chunk_count);
+
+    auto compress_chunk = [&](size_t index) -> Optional<ByteBuffer> {
+        auto start = index * chunk_size;
+        auto chunk = bytes.slice(start, min(chunk_size, bytes.size() - start));
+        auto is_last_chunk = index == chunk_count - 1;
+
+        DuplexMemoryStream output_stream;
+        auto deflate_stream = make<DeflateCompressor>(output_stream, compression_level);
+        deflate_stream->set_dictionary(bytes.slice(0, start));
+        deflate_stream->write_or_error(chunk);
+        if (is_last_chunk)
+            deflate_stream->final_flush();
+        else
+            deflate_stream->sync_flush();
+
+        if (deflate_stream->handle_any_error())
+            return {};
+        return output_stream.copy_into_contiguous_buffer();
+    };
+
+    // Every thread takes every thread_count'th chunk, so that they all get about the same amount of work.
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+        threads.append(Threading::Thread::construct([&, thread_index]() -> intptr_t {
+            for (auto index = thread_index; index < chunk_count; index += thread_count)
+                compressed_chunks[index] = compress_chunk(index);
+            return 0;
+        },
+            "Deflate"));
+    }
+    for (auto& thread : threads)
+        thread.start();
+    for (auto& thread : threads)
+        (void)thread.join();
+
+    DuplexMemoryStream output_stream;
+    for (auto& compressed_chunk : compressed_chunks) {
+        if (!compressed_chunk.has_value())
+            return {};
+        output_stream.write_or_error(compressed_chunk.value());
+    }
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -18,19 +18,38 @@ namespace Compress {
 
 class CanonicalCode {
 public:
+    static constexpr size_t max_code_length = 15;
+
     CanonicalCode() = default;
     u32 read_symbol(InputBitStream&) const;
     void write_symbol(OutputBitStream&, u32) const;
 
+    // Decodes the symbol whose code starts at the lowest bit of bits, which has to hold at least the next
+    // max_code_length bits of the input, and sets code_length to how many of them the code took up. This
+    // takes one or two table lookups instead of a step for each bit. Returns UINT32_MAX if no code starts
+    // with these bits.
+    u32 decode_symbol(u32 bits, size_t& code_length) const;
+
     static const CanonicalCode& fixed_literal_codes();
     static const CanonicalCode& fixed_distance_codes();
 
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
+    static constexpr size_t primary_lookup_bits = 9;
+
+    struct LookupEntry {
+        u16 value { 0 };           // the symbol, or the index of the subtable for codes longer than primary_lookup_bits
+        u8 bits { 0 };             // the code length, or how many more bits index the subtable; 0 if no code starts like this
+        bool is_subtable { false };
+    };
+
+    void build_lookup_table();
+
     // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
+    Array<u16, max_code_length + 1> m_code_counts {}; // the number of codes of each length
     Vector<u16> m_symbol_values;
+    Vector<LookupEntry> m_lookup_table; // indexed by the next primary_lookup_bits bits of the input
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -84,11 +103,11 @@ public:
     bool unreliable_eof() const override;
     bool handle_any_error() override;
 
+    // Decompresses a whole deflate stream that is in memory. This goes much faster than reading from a
+    // DeflateDecompressor, which has to take the input bit by bit so as not to read past its end.
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
 private:
-    u32 decode_length(u32);
-    u32 decode_distance(u32);
     void decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
 
     bool m_read_final_bock { false };
@@ -118,6 +137,8 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
+    static constexpr size_t default_parallel_chunk_size = 1 * MiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -151,8 +172,20 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
 
+    // Lets the first block refer back into the end of the dictionary, as if it had just been compressed by this stream.
+    // Must be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
+    // Ends the stream with an empty stored block that is not final instead, so that it stops on a byte boundary and the output of
+    // another DeflateCompressor (primed with the data written here as its dictionary) can follow it in the same deflate stream.
+    void sync_flush();
+
     static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Splits the bytes into chunks that are compressed independently on up to thread_count threads, each with the end of the
+    // chunk before it as its dictionary, and joins them into one deflate stream.
+    static Optional<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel = CompressionLevel::GOOD, size_t chunk_size = default_parallel_chunk_size);
+
 private:
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
 
@@ -188,6 +221,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_history_size { 0 }; // bytes right before the pending block that back references may point into
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
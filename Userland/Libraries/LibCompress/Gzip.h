@@ -81,16 +81,18 @@ private:
 
 class GzipCompressor final : public OutputStream {
 public:
-    GzipCompressor(OutputStream&);
+    // With more than one thread, the data is deflated in chunks that are compressed in parallel.
+    GzipCompressor(OutputStream&, size_t thread_count = 1);
     ~GzipCompressor();
 
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
 
-    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes);
+    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, size_t thread_count = 1);
 
 private:
     OutputStream& m_output_stream;
+    size_t m_thread_count { 1 };
 };
 
 }
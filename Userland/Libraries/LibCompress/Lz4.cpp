@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Lz4.h>
+#include <string.h>
+
+namespace Compress {
+
+static constexpr u32 skippable_frame_magic = 0x184D2A50; // the low four bits may be anything
+static constexpr size_t min_match_length = 4;
+static constexpr size_t max_distance = 65535;
+static constexpr size_t last_literals = 5;     // a block always ends with this many literals...
+static constexpr size_t match_start_limit = 12; // ...and its last match starts at least this far from the end
+static constexpr size_t linked_block_history = 64 * KiB;
+
+enum FrameFlags : u8 {
+    DictionaryId = 1 << 0,
+    ContentChecksum = 1 << 2,
+    ContentSize = 1 << 3,
+    BlockChecksum = 1 << 4,
+    BlockIndependence = 1 << 5,
+    VersionMask = 3 << 6,
+    Version = 1 << 6,
+};
+
+static constexpr u32 uncompressed_block_flag = 0x80000000;
+
+static u8 header_checksum(ReadonlyBytes descriptor)
+{
+    return (Crypto::Checksum::XxHash32(descriptor).digest() >> 8) & 0xff;
+}
+
+// Reads as many bytes as the stream has, up to the size of the buffer.
+static size_t read_fully(InputStream& stream, Bytes bytes)
+{
+    size_t nread = 0;
+    while (nread < bytes.size()) {
+        auto count = stream.read(bytes.slice(nread));
+        if (count == 0)
+            break;
+        nread += count;
+    }
+    return nread;
+}
+
+Lz4Decompressor::Lz4Decompressor(InputStream& stream)
+    : m_input_stream(stream)
+{
+}
+
+Lz4Decompressor::~Lz4Decompressor()
+{
+}
+
+Optional<size_t> Lz4Decompressor::decompress_block(ReadonlyBytes block, Bytes buffer, size_t offset)
+{
+    auto* in = block.data();
+    auto* in_end = in + block.size();
+    auto* out = buffer.offset_pointer(offset);
+    auto* out_end = buffer.data() + buffer.size();
+
+    auto read_length = [&](size_t length) -> Optional<size_t> {
+        if (length != 15)
+            return length;
+        u8 byte;
+        do {
+            if (in == in_end)
+                return {};
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return length;
+    };
+
+    for (;;) {
+        if (in == in_end)
+            return {};
+        auto token = *in++;
+
+        auto literal_length = read_length(token >> 4);
+        if (!literal_length.has_value() || literal_length.value() > (size_t)(in_end - in) || literal_length.value() > (size_t)(out_end - out))
+            return {};
+        memcpy(out, in, literal_length.value());
+        in += literal_length.value();
+        out += literal_length.value();
+
+        if (in == in_end)
+            break; // the last sequence has only literals
+
+        if (in_end - in < 2)
+            return {};
+        size_t distance = in[0] | (in[1] << 8);
+        in += 2;
+        if (distance == 0 || distance > (size_t)(out - buffer.data()))
+            return {};
+
+        auto match_length = read_length(token & 0xf);
+        if (!match_length.has_value())
+            return {};
+        auto length = match_length.value() + min_match_length;
+        if (length > (size_t)(out_end - out))
+            return {};
+
+        auto* match = out - distance;
+        if (distance >= length) {
+            memcpy(out, match, length);
+            out += length;
+        } else {
+            // The match overlaps what it writes, so it repeats the last distance bytes.
+            for (size_t i = 0; i < length; ++i)
+                *out++ = match[i];
+        }
+    }
+
+    return out - buffer.offset_pointer(offset);
+}
+
+bool Lz4Decompressor::read_frame_header()
+{
+    u8 magic_bytes[4];
+    auto nread = read_fully(m_input_stream, { magic_bytes, sizeof(magic_bytes) });
+    if (nread == 0 && m_input_stream.unreliable_eof()) {
+        m_eof = true;
+        return false;
+    }
+    if (nread < sizeof(magic_bytes)) {
+        set_fatal_error();
+        return false;
+    }
+
+    u32 magic = magic_bytes[0] | magic_bytes[1] << 8 | magic_bytes[2] << 16 | magic_bytes[3] << 24;
+    if ((magic & 0xfffffff0) == skippable_frame_magic) {
+        LittleEndian<u32> frame_size;
+        m_input_stream >> frame_size;
+        if (m_input_stream.has_any_error() || !m_input_stream.discard_or_error(frame_size)) {
+            set_fatal_error();
+            return false;
+        }
+        return true;
+    }
+    if (magic != frame_magic) {
+        set_fatal_error();
+        return false;
+    }
+
+    u8 descriptor[2 + sizeof(u64)];
+    size_t descriptor_size = 2;
+    if (!m_input_stream.read_or_error({ descriptor, 2 })) {
+        set_fatal_error();
+        return false;
+    }
+    auto flags = descriptor[0];
+    auto block_descriptor = descriptor[1];
+    auto block_maximum_size_code = (block_descriptor >> 4) & 7;
+    if ((flags & VersionMask) != Version || (flags & DictionaryId) || (flags & 0x02) || (block_descriptor & 0x8f) || block_maximum_size_code < 4) {
+        set_fatal_error();
+        return false;
+    }
+
+    m_content_size.clear();
+    if (flags & ContentSize) {
+        if (!m_input_stream.read_or_error({ descriptor + descriptor_size, sizeof(u64) })) {
+            set_fatal_error();
+            return false;
+        }
+        u64 content_size = 0;
+        for (size_t i = 0; i < sizeof(u64); ++i)
+            content_size |= (u64)descriptor[descriptor_size + i] << (i * 8);
+        m_content_size = content_size;
+        descriptor_size += sizeof(u64);
+    }
+
+    u8 checksum;
+    m_input_stream >> checksum;
+    if (m_input_stream.has_any_error() || checksum != header_checksum({ descriptor, descriptor_size })) {
+        set_fatal_error();
+        return false;
+    }
+
+    m_blocks_are_independent = flags & BlockIndependence;
+    m_has_block_checksums = flags & BlockChecksum;
+    m_has_content_checksum = flags & ContentChecksum;
+    m_block_maximum_size = 1u << (8 + 2 * block_maximum_size_code);
+    m_frame_size = 0;
+    m_content_checksum = Crypto::Checksum::XxHash32();
+
+    auto history_size = m_blocks_are_independent ? 0 : linked_block_history;
+    m_output = ByteBuffer::create_uninitialized(2 * history_size + m_block_maximum_size);
+    m_output_end = 0;
+    m_read_offset = 0;
+    m_in_frame = true;
+    return true;
+}
+
+bool Lz4Decompressor::read_block()
+{
+    LittleEndian<u32> block_header;
+    m_input_stream >> block_header;
+    if (m_input_stream.has_any_error()) {
+        set_fatal_error();
+        return false;
+    }
+
+    if (block_header == 0) {
+        // This is the end mark of the frame.
+        if (m_has_content_checksum) {
+            LittleEndian<u32> checksum;
+            m_input_stream >> checksum;
+            if (m_input_stream.has_any_error() || checksum != m_content_checksum.digest()) {
+                set_fatal_error();
+                return false;
+            }
+        }
+        if (m_content_size.has_value() && m_content_size.value() != m_frame_size) {
+            set_fatal_error();
+            return false;
+        }
+        m_in_frame = false;
+        return true;
+    }
+
+    bool is_uncompressed = block_header & uncompressed_block_flag;
+    size_t block_size = block_header & ~uncompressed_block_flag;
+    if (block_size > m_block_maximum_size) {
+        set_fatal_error();
+        return false;
+    }
+
+    if (m_compressed_block.size() < block_size)
+        m_compressed_block.resize(m_block_maximum_size);
+    auto block = m_compressed_block.bytes().trim(block_size);
+    if (!m_input_stream.read_or_error(block)) {
+        set_fatal_error();
+        return false;
+    }
+
+    if (m_has_block_checksums) {
+        LittleEndian<u32> checksum;
+        m_input_stream >> checksum;
+        if (m_input_stream.has_any_error() || checksum != Crypto::Checksum::XxHash32(block).digest()) {
+            set_fatal_error();
+            return false;
+        }
+    }
+
+    // Keep only as much of what was decompressed before as the next block could refer back to.
+    if (m_output_end + m_block_maximum_size > m_output.size()) {
+        auto keep = m_blocks_are_independent ? 0 : min(linked_block_history, m_output_end);
+        memmove(m_output.data(), m_output.offset_pointer(m_output_end - keep), keep);
+        m_output_end = keep;
+    }
+    if (m_blocks_are_independent)
+        m_output_end = 0;
+    m_read_offset = m_output_end;
+
+    size_t decompressed_size;
+    if (is_uncompressed) {
+        memcpy(m_output.offset_pointer(m_output_end), block.data(), block_size);
+        decompressed_size = block_size;
+    } else {
+        auto block_end = m_output_end + m_block_maximum_size;
+        auto maybe_size = decompress_block(block, m_output.bytes().trim(block_end), m_output_end);
+        if (!maybe_size.has_value()) {
+            set_fatal_error();
+            return false;
+        }
+        decompressed_size = maybe_size.value();
+    }
+
+    auto decompressed = m_output.bytes().slice(m_output_end, decompressed_size);
+    if (m_has_content_checksum)
+        m_content_checksum.update(decompressed);
+    m_frame_size += decompressed_size;
+    m_output_end += decompressed_size;
+    return true;
+}
+
+size_t Lz4Decompressor::read(Bytes bytes)
+{
+    size_t total_read = 0;
+    while (total_read < bytes.size()) {
+        if (has_any_error() || m_eof)
+            break;
+
+        if (m_read_offset < m_output_end) {
+            auto nread = m_output.bytes().slice(m_read_offset, m_output_end - m_read_offset).copy_trimmed_to(bytes.slice(total_read));
+            m_read_offset += nread;
+            total_read += nread;
+            continue;
+        }
+
+        if (m_in_frame)
+            read_block();
+        else
+            read_frame_header();
+    }
+    return total_read;
+}
+
+bool Lz4Decompressor::read_or_error(Bytes bytes)
+{
+    if (read(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool Lz4Decompressor::discard_or_error(size_t count)
+{
+    u8 buffer[4096];
+
+    size_t ndiscarded = 0;
+    while (ndiscarded < count) {
+        if (unreliable_eof()) {
+            set_fatal_error();
+            return false;
+        }
+
+        ndiscarded += read({ buffer, min<size_t>(count - ndiscarded, sizeof(buffer)) });
+    }
+
+    return true;
+}
+
+bool Lz4Decompressor::unreliable_eof() const { return m_eof; }
+
+bool Lz4Decompressor::handle_any_error()
+{
+    bool handled_errors = m_input_stream.handle_any_error();
+    return Stream::handle_any_error() || handled_errors;
+}
+
+Optional<ByteBuffer> Lz4Decompressor::decompress_all(ReadonlyBytes bytes)
+{
+    InputMemoryStream memory_stream { bytes };
+    Lz4Decompressor lz4_stream { memory_stream };
+    DuplexMemoryStream output_stream;
+
+    u8 buffer[4096];
+    while (!lz4_stream.has_any_error() && !lz4_stream.unreliable_eof()) {
+        auto nread = lz4_stream.read({ buffer, sizeof(buffer) });
+        output_stream.write_or_error({ buffer, nread });
+    }
+
+    if (lz4_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+bool Lz4Decompressor::is_likely_compressed(ReadonlyBytes bytes)
+{
+    return bytes.size() >= 4 && (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (u32)bytes[3] << 24) == frame_magic;
+}
+
+Lz4Compressor::Lz4Compressor(OutputStream& stream)
+    : m_output_stream(stream)
+{
+}
+
+Lz4Compressor::~Lz4Compressor()
+{
+    VERIFY(m_finished);
+}
+
+static ALWAYS_INLINE u32 read_u32(u8 const* bytes)
+{
+    u32 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void Lz4Compressor::compress_block(ReadonlyBytes input, ByteBuffer& output)
+{
+    constexpr size_t hash_bits = 14;
+    auto hash = [](u32 sequence) { return (sequence * 2654435761u) >> (32 - hash_bits); };
+
+    auto write_length = [&](size_t length) {
+        for (; length >= 255; length -= 255)
+            output.append("\xff", 1);
+        u8 byte = length;
+        output.append(&byte, 1);
+    };
+
+    auto emit_sequence = [&](ReadonlyBytes literals, size_t distance, size_t match_length) {
+        u8 token = min<size_t>(literals.size(), 15) << 4;
+        if (match_length != 0)
+            token |= min<size_t>(match_length - min_match_length, 15);
+        output.append(&token, 1);
+        if (literals.size() >= 15)
+            write_length(literals.size() - 15);
+        output.append(literals);
+        if (match_length == 0)
+            return;
+        u8 distance_bytes[2] = { (u8)distance, (u8)(distance >> 8) };
+        output.append(distance_bytes, 2);
+        if (match_length - min_match_length >= 15)
+            write_length(match_length - min_match_length - 15);
+    };
+
+    size_t anchor = 0;
+    if (input.size() > match_start_limit) {
+        // Holds one more than the position where each hash was last seen, so that zero means none.
+        Vector<u32> hash_table;
+        hash_table.resize(1 << hash_bits);
+
+        auto match_end_limit = input.size() - last_literals;
+        size_t position = 0;
+        while (position < input.size() - match_start_limit) {
+            auto sequence = read_u32(input.offset_pointer(position));
+            auto& slot = hash_table[hash(sequence)];
+            auto candidate = (size_t)slot - 1;
+            slot = position + 1;
+
+            if (candidate >= position || position - candidate > max_distance || read_u32(input.offset_pointer(candidate)) != sequence) {
+                ++position;
+                continue;
+            }
+
+            auto match_length = min_match_length;
+            while (position + match_length < match_end_limit && input[candidate + match_length] == input[position + match_length])
+                ++match_length;
+            // The match may also begin a little earlier, in what would otherwise be literals.
+            while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1]) {
+                --position;
+                --candidate;
+                ++match_length;
+            }
+
+            emit_sequence(input.slice(anchor, position - anchor), position - candidate, match_length);
+            position += match_length;
+            anchor = position;
+            if (position < input.size() - match_start_limit)
+                hash_table[hash(read_u32(input.offset_pointer(position - 2)))] = position - 1;
+        }
+    }
+    emit_sequence(input.slice(anchor), 0, 0);
+}
+
+void Lz4Compressor::write_frame_header()
+{
+    u8 descriptor[2] = { Version | BlockIndependence | ContentChecksum, 4 << 4 }; // blocks of up to 64 KiB
+    LittleEndian<u32> magic = Lz4Decompressor::frame_magic;
+    m_output_stream << magic;
+    m_output_stream << ReadonlyBytes { descriptor, sizeof(descriptor) };
+    m_output_stream << header_checksum({ descriptor, sizeof(descriptor) });
+    m_wrote_frame_header = true;
+}
+
+void Lz4Compressor::write_block()
+{
+    if (!m_wrote_frame_header)
+        write_frame_header();
+
+    ReadonlyBytes block { m_pending_block, m_pending_block_size };
+    m_content_checksum.update(block);
+
+    m_compressed_block.clear();
+    compress_block(block, m_compressed_block);
+    if (m_compressed_block.size() < block.size()) {
+        LittleEndian<u32> block_header = m_compressed_block.size();
+        m_output_stream << block_header << m_compressed_block.bytes();
+    } else {
+        LittleEndian<u32> block_header = block.size() | uncompressed_block_flag;
+        m_output_stream << block_header << block;
+    }
+    m_pending_block_size = 0;
+}
+
+size_t Lz4Compressor::write(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    size_t total_written = 0;
+    while (total_written < bytes.size()) {
+        auto nwritten = bytes.slice(total_written).copy_trimmed_to({ m_pending_block + m_pending_block_size, block_size - m_pending_block_size });
+        m_pending_block_size += nwritten;
+        total_written += nwritten;
+        if (m_pending_block_size == block_size)
+            write_block();
+    }
+    return total_written;
+}
+
+bool Lz4Compressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void Lz4Compressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    if (m_pending_block_size != 0)
+        write_block();
+    if (!m_wrote_frame_header)
+        write_frame_header();
+
+    LittleEndian<u32> end_mark = 0;
+    LittleEndian<u32> checksum = m_content_checksum.digest();
+    m_output_stream << end_mark << checksum;
+}
+
+Optional<ByteBuffer> Lz4Compressor::compress_all(ReadonlyBytes bytes)
+{
+    DuplexMemoryStream output_stream;
+    Lz4Compressor lz4_stream { output_stream };
+
+    lz4_stream.write_or_error(bytes);
+    lz4_stream.final_flush();
+
+    if (lz4_stream.handle_any_error() || output_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <LibCrypto/Checksum/XxHash.h>
+
+namespace Compress {
+
+// Reads the LZ4 frame format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md), one block at a time.
+// Several frames may follow each other, skippable frames are skipped. Frames that need a dictionary are not supported.
+class Lz4Decompressor final : public InputStream {
+public:
+    static constexpr u32 frame_magic = 0x184D2204;
+
+    Lz4Decompressor(InputStream&);
+    ~Lz4Decompressor();
+
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t) override;
+
+    bool unreliable_eof() const override;
+    bool handle_any_error() override;
+
+    static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
+    static bool is_likely_compressed(ReadonlyBytes bytes);
+
+    // Decodes a single LZ4 block into the buffer from the offset on, returning how large it was decompressed.
+    // Back references may reach into what the buffer holds before the offset.
+    static Optional<size_t> decompress_block(ReadonlyBytes block, Bytes buffer, size_t offset);
+
+private:
+    bool read_frame_header();
+    bool read_block();
+
+    InputStream& m_input_stream;
+
+    bool m_in_frame { false };
+    bool m_blocks_are_independent { false };
+    bool m_has_block_checksums { false };
+    bool m_has_content_checksum { false };
+    Optional<u64> m_content_size;
+    size_t m_block_maximum_size { 0 };
+    u64 m_frame_size { 0 };
+    Crypto::Checksum::XxHash32 m_content_checksum;
+
+    ByteBuffer m_compressed_block;
+    ByteBuffer m_output; // the blocks decompressed last, so that linked blocks can refer back into them
+    size_t m_output_end { 0 };
+    size_t m_read_offset { 0 };
+
+    bool m_eof { false };
+};
+
+// Writes one LZ4 frame of independent blocks with a content checksum.
+class Lz4Compressor final : public OutputStream {
+public:
+    static constexpr size_t block_size = 64 * KiB;
+
+    Lz4Compressor(OutputStream&);
+    ~Lz4Compressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+    void final_flush();
+
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes);
+
+    // Appends the input compressed as a single LZ4 block to the output.
+    static void compress_block(ReadonlyBytes input, ByteBuffer& output);
+
+private:
+    void write_frame_header();
+    void write_block();
+
+    OutputStream& m_output_stream;
+    bool m_wrote_frame_header { false };
+    bool m_finished { false };
+    Crypto::Checksum::XxHash32 m_content_checksum;
+
+    u8 m_pending_block[block_size];
+    size_t m_pending_block_size { 0 };
+    ByteBuffer m_compressed_block;
+};
+
+}
@@ -9,6 +9,7 @@
 #include <AK/Vector.h>
 #include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 
 namespace Compress {
 
@@ -48,7 +49,12 @@ Zlib::Zlib(const ReadonlyBytes& data)
 
 Optional<ByteBuffer> Zlib::decompress()
 {
-    return DeflateDecompressor::decompress_all(m_data_bytes);
+    auto data = DeflateDecompressor::decompress_all(m_data_bytes);
+    if (!data.has_value())
+        return {};
+    if (Crypto::Checksum::Adler32(data->bytes()).digest() != checksum())
+        return {}; // the data is corrupted
+    return data;
 }
 
 Optional<ByteBuffer> Zlib::decompress_all(ReadonlyBytes bytes)
@@ -63,7 +69,7 @@ u32 Zlib::checksum()
 {
     if (!m_checksum) {
         auto bytes = m_input_data.slice(m_input_data.size() - 4, 4);
-        m_checksum = bytes.at(0) << 24 | bytes.at(1) << 16 | bytes.at(2) << 8 || bytes.at(3);
+        m_checksum = bytes.at(0) << 24 | bytes.at(1) << 16 | bytes.at(2) << 8 | bytes.at(3);
     }
 
     return m_checksum;
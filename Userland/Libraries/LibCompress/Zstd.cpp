@@ -0,0 +1,1494 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Zstd.h>
+#include <string.h>
+
+namespace Compress {
+
+static constexpr u32 skippable_frame_magic = 0x184D2A50; // the low four bits may be anything
+
+enum BlockType : u8 {
+    Raw = 0,
+    Rle = 1,
+    Compressed = 2,
+};
+
+enum LiteralsType : u8 {
+    RawLiterals = 0,
+    RleLiterals = 1,
+    CompressedLiterals = 2,
+    TreelessLiterals = 3,
+};
+
+enum SymbolCompressionMode : u8 {
+    Predefined = 0,
+    RleMode = 1,
+    FseCompressed = 2,
+    Repeat = 3,
+};
+
+static constexpr u8 max_huffman_bits = 11;
+static constexpr u8 max_literal_length_code = 35;
+static constexpr u8 max_match_length_code = 52;
+static constexpr u8 max_offset_code = 31;
+
+static constexpr Array<u32, 36> literal_length_baselines {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+    8192, 16384, 32768, 65536
+};
+static constexpr Array<u8, 36> literal_length_extra_bits {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+    13, 14, 15, 16
+};
+static constexpr Array<u32, 53> match_length_baselines {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+    19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+    35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+    4099, 8195, 16387, 32771, 65539
+};
+static constexpr Array<u8, 53> match_length_extra_bits {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+    12, 13, 14, 15, 16
+};
+
+// The distributions of the predefined entropy tables, -1 stands for "less than 1".
+static constexpr u8 predefined_literal_length_accuracy_log = 6;
+static constexpr Array<i16, 36> predefined_literal_length_distribution {
+    4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+    -1, -1, -1, -1
+};
+static constexpr u8 predefined_match_length_accuracy_log = 6;
+static constexpr Array<i16, 53> predefined_match_length_distribution {
+    1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+    -1, -1, -1, -1, -1
+};
+static constexpr u8 predefined_offset_accuracy_log = 5;
+static constexpr Array<i16, 29> predefined_offset_distribution {
+    1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+static ALWAYS_INLINE u32 highest_bit(u32 value)
+{
+    VERIFY(value != 0);
+    return 31 - __builtin_clz(value);
+}
+
+static u64 read_little_endian(ReadonlyBytes bytes)
+{
+    u64 value = 0;
+    for (size_t i = 0; i < bytes.size(); ++i)
+        value |= (u64)bytes[i] << (i * 8);
+    return value;
+}
+
+// Reads the bits of the bytes from the least significant bit of the first byte on. Reading beyond the end gives zeros.
+class ForwardBitReader {
+public:
+    explicit ForwardBitReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    u32 peek(size_t count) const
+    {
+        VERIFY(count <= 25);
+        auto byte = m_position / 8;
+        u64 value = 0;
+        for (size_t i = 0; i < 5 && byte + i < m_bytes.size(); ++i)
+            value |= (u64)m_bytes[byte + i] << (i * 8);
+        return (value >> (m_position % 8)) & ((1u << count) - 1);
+    }
+    void consume(size_t count) { m_position += count; }
+    u32 read(size_t count)
+    {
+        auto value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    bool is_past_end() const { return m_position > m_bytes.size() * 8; }
+    size_t bytes_consumed() const { return ceil_div(m_position, (size_t)8); }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_position { 0 };
+};
+
+// Reads the bits of the bytes from the end backwards, the first bit being below the highest set bit of the last byte.
+// Every read returns its first bit as the most significant one. Reading beyond the start gives zeros.
+class BackwardBitReader {
+public:
+    static Optional<BackwardBitReader> create(ReadonlyBytes bytes)
+    {
+        if (bytes.is_empty() || bytes[bytes.size() - 1] == 0)
+            return {};
+        return BackwardBitReader { bytes, (ssize_t)((bytes.size() - 1) * 8 + highest_bit(bytes[bytes.size() - 1])) };
+    }
+
+    u64 peek(size_t count) const
+    {
+        if (count == 0)
+            return 0;
+        auto start = m_position - (ssize_t)count;
+        if (start >= 0)
+            return extract(start, count);
+        if (m_position <= 0)
+            return 0;
+        return extract(0, m_position) << -start;
+    }
+    void consume(size_t count) { m_position -= count; }
+    u64 read(size_t count)
+    {
+        auto value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    bool is_overflowed() const { return m_position < 0; }
+    bool is_finished() const { return m_position == 0; }
+
+private:
+    BackwardBitReader(ReadonlyBytes bytes, ssize_t position)
+        : m_bytes(bytes)
+        , m_position(position)
+    {
+    }
+
+    u64 extract(size_t start, size_t count) const
+    {
+        VERIFY(count <= 32);
+        auto byte = start / 8;
+        u64 value;
+        if (byte + sizeof(u64) <= m_bytes.size())
+            value = read_little_endian(m_bytes.slice(byte, sizeof(u64)));
+        else
+            value = read_little_endian(m_bytes.slice(byte));
+        return (value >> (start % 8)) & ((1ull << count) - 1);
+    }
+
+    ReadonlyBytes m_bytes;
+    ssize_t m_position { 0 };
+};
+
+// Reads the normalized probabilities of an entropy table, returns how many bytes they took.
+static Optional<size_t> read_fse_table_description(ReadonlyBytes bytes, u8 max_accuracy_log, size_t max_symbol, Vector<i16>& probabilities, u8& accuracy_log)
+{
+    ForwardBitReader bits { bytes };
+    accuracy_log = bits.read(4) + 5;
+    if (accuracy_log > max_accuracy_log)
+        return {};
+
+    probabilities.clear();
+    i32 remaining = (1 << accuracy_log) + 1;
+    i32 threshold = 1 << accuracy_log;
+    size_t bit_count = accuracy_log + 1;
+    bool previous_was_zero = false;
+    while (remaining > 1 && probabilities.size() <= max_symbol) {
+        if (previous_was_zero) {
+            // a zero probability is followed by how many more there are, in 2 bit steps where 3 means there are more steps
+            for (;;) {
+                auto repeat = bits.read(2);
+                for (u32 i = 0; i < repeat; ++i)
+                    probabilities.append(0);
+                if (repeat != 3)
+                    break;
+                if (bits.is_past_end() || probabilities.size() > max_symbol)
+                    return {};
+            }
+            if (probabilities.size() > max_symbol)
+                return {};
+        }
+
+        i32 max = (2 * threshold - 1) - remaining;
+        i32 value = bits.peek(bit_count);
+        i32 count;
+        if ((value & (threshold - 1)) < max) {
+            count = value & (threshold - 1);
+            bits.consume(bit_count - 1);
+        } else {
+            count = value & (2 * threshold - 1);
+            if (count >= threshold)
+                count -= max;
+            bits.consume(bit_count);
+        }
+        count--;
+        remaining -= count < 0 ? -count : count;
+        probabilities.append(count);
+        previous_was_zero = count == 0;
+        if (remaining < 1)
+            return {};
+        while (remaining < threshold) {
+            bit_count--;
+            threshold >>= 1;
+        }
+        if (bits.is_past_end())
+            return {};
+    }
+
+    if (remaining != 1 || bits.is_past_end())
+        return {};
+    return bits.bytes_consumed();
+}
+
+static Optional<ZstdDecompressor::FseTable> build_fse_table(Span<i16 const> probabilities, u8 accuracy_log)
+{
+    size_t table_size = 1u << accuracy_log;
+    ZstdDecompressor::FseTable table;
+    table.accuracy_log = accuracy_log;
+    table.entries.resize(table_size);
+
+    // Symbols with a probability of "less than 1" get the last states, the others are spread over the rest.
+    Vector<u16, 64> next_state;
+    next_state.resize(probabilities.size());
+    size_t high_threshold = table_size - 1;
+    for (size_t symbol = 0; symbol < probabilities.size(); ++symbol) {
+        if (probabilities[symbol] == -1) {
+            table.entries[high_threshold--].symbol = symbol;
+            next_state[symbol] = 1;
+        } else {
+            next_state[symbol] = probabilities[symbol];
+        }
+    }
+
+    size_t step = (table_size >> 1) + (table_size >> 3) + 3;
+    size_t position = 0;
+    for (size_t symbol = 0; symbol < probabilities.size(); ++symbol) {
+        for (i16 i = 0; i < probabilities[symbol]; ++i) {
+            table.entries[position].symbol = symbol;
+            do {
+                position = (position + step) & (table_size - 1);
+            } while (position > high_threshold);
+        }
+    }
+    if (position != 0)
+        return {};
+
+    for (auto& entry : table.entries) {
+        auto state = next_state[entry.symbol]++;
+        entry.bits = accuracy_log - highest_bit(state);
+        entry.base = (state << entry.bits) - table_size;
+    }
+    return table;
+}
+
+static ZstdDecompressor::FseTable rle_fse_table(u8 symbol)
+{
+    ZstdDecompressor::FseTable table;
+    table.entries.append({ 0, symbol, 0 });
+    return table;
+}
+
+static bool build_huffman_table(Span<u8 const> weights, ZstdDecompressor::HuffmanTable& table)
+{
+    // The weight of the last symbol is not stored, it is whatever makes the code complete.
+    u32 weight_sum = 0;
+    for (auto weight : weights) {
+        if (weight > max_huffman_bits)
+            return false;
+        if (weight != 0)
+            weight_sum += 1u << (weight - 1);
+    }
+    if (weight_sum == 0)
+        return false;
+    auto max_bits = highest_bit(weight_sum) + 1;
+    auto left_over = (1u << max_bits) - weight_sum;
+    if (max_bits > max_huffman_bits || (left_over & (left_over - 1)) != 0)
+        return false;
+    auto last_weight = highest_bit(left_over) + 1;
+
+    Array<u32, max_huffman_bits + 2> rank_start {};
+    Array<u32, max_huffman_bits + 2> weight_counts {};
+    for (auto weight : weights)
+        weight_counts[weight]++;
+    weight_counts[last_weight]++;
+    u32 current = 0;
+    for (size_t weight = 1; weight <= max_bits; ++weight) {
+        rank_start[weight] = current;
+        current += weight_counts[weight] << (weight - 1);
+    }
+
+    table.max_bits = max_bits;
+    table.entries.resize(1u << max_bits);
+    for (size_t symbol = 0; symbol <= weights.size(); ++symbol) {
+        auto weight = symbol < weights.size() ? weights[symbol] : last_weight;
+        if (weight == 0)
+            continue;
+        auto length = 1u << (weight - 1);
+        for (size_t i = 0; i < length; ++i)
+            table.entries[rank_start[weight] + i] = { (u8)symbol, (u8)(max_bits + 1 - weight) };
+        rank_start[weight] += length;
+    }
+    return true;
+}
+
+// Reads the description of a Huffman code and returns how many bytes it took.
+static Optional<size_t> read_huffman_table(ReadonlyBytes bytes, ZstdDecompressor::HuffmanTable& table)
+{
+    if (bytes.is_empty())
+        return {};
+
+    Vector<u8, 256> weights;
+    auto header = bytes[0];
+    size_t size;
+    if (header < 128) {
+        // The weights are compressed with an entropy table of their own, decoded with two interleaved states.
+        size = 1 + header;
+        if (size > bytes.size())
+            return {};
+        auto data = bytes.slice(1, header);
+
+        Vector<i16> probabilities;
+        u8 accuracy_log;
+        auto description_size = read_fse_table_description(data, 6, max_huffman_bits, probabilities, accuracy_log);
+        if (!description_size.has_value() || description_size.value() >= data.size())
+            return {};
+        auto weight_table = build_fse_table(probabilities.span(), accuracy_log);
+        if (!weight_table.has_value())
+            return {};
+        auto bits = BackwardBitReader::create(data.slice(description_size.value()));
+        if (!bits.has_value())
+            return {};
+
+        auto const& entries = weight_table->entries;
+        u32 states[2] = { (u32)bits->read(accuracy_log), (u32)bits->read(accuracy_log) };
+        for (size_t state_index = 0;; state_index ^= 1) {
+            if (weights.size() >= 255)
+                return {};
+            auto& entry = entries[states[state_index]];
+            weights.append(entry.symbol);
+            states[state_index] = entry.base + bits->read(entry.bits);
+            if (bits->is_overflowed()) {
+                weights.append(entries[states[state_index ^ 1]].symbol);
+                break;
+            }
+        }
+    } else {
+        size_t weight_count = header - 127;
+        size = 1 + ceil_div(weight_count, (size_t)2);
+        if (size > bytes.size())
+            return {};
+        for (size_t i = 0; i < weight_count; ++i) {
+            auto byte = bytes[1 + i / 2];
+            weights.append(i % 2 == 0 ? byte >> 4 : byte & 0xf);
+        }
+    }
+
+    if (!build_huffman_table(weights.span(), table))
+        return {};
+    return size;
+}
+
+static bool decode_huffman_stream(ZstdDecompressor::HuffmanTable const& table, ReadonlyBytes stream, Bytes output)
+{
+    auto bits = BackwardBitReader::create(stream);
+    if (!bits.has_value())
+        return false;
+
+    for (auto& byte : output) {
+        auto& entry = table.entries[bits->peek(table.max_bits)];
+        byte = entry.symbol;
+        bits->consume(entry.bits);
+    }
+    return bits->is_finished();
+}
+
+template<size_t Size>
+static u8 code_for(Array<u32, Size> const& baselines, u32 value)
+{
+    // The last code whose baseline is not larger than the value.
+    size_t low = 0;
+    size_t high = Size;
+    while (high - low > 1) {
+        auto middle = (low + high) / 2;
+        if (baselines[middle] <= value)
+            low = middle;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+ZstdDecompressor::ZstdDecompressor(InputStream& stream)
+    : m_input_stream(stream)
+{
+}
+
+ZstdDecompressor::~ZstdDecompressor()
+{
+}
+
+bool ZstdDecompressor::decode_literals(ReadonlyBytes block, size_t& consumed)
+{
+    if (block.is_empty())
+        return false;
+
+    auto type = block[0] & 3;
+    auto size_format = (block[0] >> 2) & 3;
+    if (m_literals.is_empty())
+        m_literals = ByteBuffer::create_uninitialized(max_block_size);
+
+    if (type == RawLiterals || type == RleLiterals) {
+        size_t header_size = size_format == 1 ? 2 : (size_format == 3 ? 3 : 1);
+        if (header_size > block.size())
+            return false;
+        size_t size;
+        if (header_size == 1)
+            size = block[0] >> 3;
+        else if (header_size == 2)
+            size = (block[0] >> 4) | (block[1] << 4);
+        else
+            size = (block[0] >> 4) | (block[1] << 4) | (block[2] << 12);
+        if (size > m_block_maximum_size)
+            return false;
+
+        if (type == RawLiterals) {
+            if (header_size + size > block.size())
+                return false;
+            memcpy(m_literals.data(), block.offset_pointer(header_size), size);
+            consumed = header_size + size;
+        } else {
+            if (header_size + 1 > block.size())
+                return false;
+            memset(m_literals.data(), block[header_size], size);
+            consumed = header_size + 1;
+        }
+        m_literals_size = size;
+        return true;
+    }
+
+    static constexpr size_t header_sizes[] = { 3, 3, 4, 5 };
+    static constexpr size_t size_bits[] = { 10, 10, 14, 18 };
+    auto header_size = header_sizes[size_format];
+    if (header_size > block.size())
+        return false;
+    auto header = read_little_endian(block.trim(header_size));
+    auto mask = (1u << size_bits[size_format]) - 1;
+    size_t size = (header >> 4) & mask;
+    size_t compressed_size = (header >> (4 + size_bits[size_format])) & mask;
+    if (size > m_block_maximum_size || header_size + compressed_size > block.size())
+        return false;
+    auto data = block.slice(header_size, compressed_size);
+
+    if (type == CompressedLiterals) {
+        HuffmanTable table;
+        auto table_size = read_huffman_table(data, table);
+        if (!table_size.has_value())
+            return false;
+        m_huffman_table = move(table);
+        data = data.slice(table_size.value());
+    } else if (!m_huffman_table.has_value()) {
+        return false;
+    }
+
+    auto literals = m_literals.bytes().trim(size);
+    if (size_format == 0) {
+        if (!decode_huffman_stream(m_huffman_table.value(), data, literals))
+            return false;
+    } else {
+        if (data.size() < 6)
+            return false;
+        size_t stream_sizes[4];
+        stream_sizes[0] = data[0] | (data[1] << 8);
+        stream_sizes[1] = data[2] | (data[3] << 8);
+        stream_sizes[2] = data[4] | (data[5] << 8);
+        auto first_streams_size = stream_sizes[0] + stream_sizes[1] + stream_sizes[2];
+        if (6 + first_streams_size > data.size())
+            return false;
+        stream_sizes[3] = data.size() - 6 - first_streams_size;
+
+        auto segment_size = ceil_div(size, (size_t)4);
+        if (3 * segment_size > size)
+            return false;
+        size_t stream_offset = 6;
+        for (size_t i = 0; i < 4; ++i) {
+            auto segment = literals.slice(i * segment_size, i < 3 ? segment_size : size - 3 * segment_size);
+            if (!decode_huffman_stream(m_huffman_table.value(), data.slice(stream_offset, stream_sizes[i]), segment))
+                return false;
+            stream_offset += stream_sizes[i];
+        }
+    }
+
+    m_literals_size = size;
+    consumed = header_size + compressed_size;
+    return true;
+}
+
+// Copies a match, which may overlap what it writes (and then repeats the last distance bytes).
+static ALWAYS_INLINE void copy_match(u8* out, size_t distance, size_t length)
+{
+    auto* match = out - distance;
+    if (distance >= length) {
+        memcpy(out, match, length);
+        return;
+    }
+    for (size_t i = 0; i < length; ++i)
+        out[i] = match[i];
+}
+
+bool ZstdDecompressor::decode_sequences(ReadonlyBytes section, Bytes output, size_t& output_size)
+{
+    // The output holds what the frame decompressed to so far, and room for this block after output_size.
+    auto block_start = output_size;
+    if (section.is_empty())
+        return false;
+
+    size_t sequence_count = section[0];
+    size_t header_size = 1;
+    if (sequence_count >= 128) {
+        if (sequence_count < 255) {
+            if (section.size() < 2)
+                return false;
+            sequence_count = ((sequence_count - 128) << 8) + section[1];
+            header_size = 2;
+        } else {
+            if (section.size() < 3)
+                return false;
+            sequence_count = section[1] + (section[2] << 8) + 0x7F00;
+            header_size = 3;
+        }
+    }
+
+    size_t literals_offset = 0;
+    if (sequence_count != 0) {
+        if (header_size >= section.size())
+            return false;
+        auto modes = section[header_size++];
+        if (modes & 3)
+            return false;
+
+        auto read_table = [&](SymbolCompressionMode mode, Optional<FseTable>& table, Span<i16 const> predefined_distribution, u8 predefined_accuracy_log, u8 max_accuracy_log, u8 max_symbol) {
+            switch (mode) {
+            case Predefined:
+                table = build_fse_table(predefined_distribution, predefined_accuracy_log);
+                return true;
+            case RleMode:
+                if (header_size >= section.size() || section[header_size] > max_symbol)
+                    return false;
+                table = rle_fse_table(section[header_size++]);
+                return true;
+            case FseCompressed: {
+                Vector<i16> probabilities;
+                u8 accuracy_log;
+                auto size = read_fse_table_description(section.slice(header_size), max_accuracy_log, max_symbol, probabilities, accuracy_log);
+                if (!size.has_value())
+                    return false;
+                header_size += size.value();
+                table = build_fse_table(probabilities.span(), accuracy_log);
+                return table.has_value();
+            }
+            case Repeat:
+                return table.has_value();
+            }
+            VERIFY_NOT_REACHED();
+        };
+        if (!read_table((SymbolCompressionMode)(modes >> 6), m_literal_length_table, predefined_literal_length_distribution.span(), predefined_literal_length_accuracy_log, 9, max_literal_length_code))
+            return false;
+        if (!read_table((SymbolCompressionMode)((modes >> 4) & 3), m_offset_table, predefined_offset_distribution.span(), predefined_offset_accuracy_log, 8, max_offset_code))
+            return false;
+        if (!read_table((SymbolCompressionMode)((modes >> 2) & 3), m_match_length_table, predefined_match_length_distribution.span(), predefined_match_length_accuracy_log, 9, max_match_length_code))
+            return false;
+        if (header_size > section.size())
+            return false;
+
+        auto bits = BackwardBitReader::create(section.slice(header_size));
+        if (!bits.has_value())
+            return false;
+
+        auto& literal_length_entries = m_literal_length_table->entries;
+        auto& offset_entries = m_offset_table->entries;
+        auto& match_length_entries = m_match_length_table->entries;
+        u32 literal_length_state = bits->read(m_literal_length_table->accuracy_log);
+        u32 offset_state = bits->read(m_offset_table->accuracy_log);
+        u32 match_length_state = bits->read(m_match_length_table->accuracy_log);
+
+        auto block_end = output.size();
+        for (size_t i = 0; i < sequence_count; ++i) {
+            auto& literal_length_entry = literal_length_entries[literal_length_state];
+            auto& offset_entry = offset_entries[offset_state];
+            auto& match_length_entry = match_length_entries[match_length_state];
+
+            u32 offset_code = offset_entry.symbol;
+            u32 offset_value = (1u << offset_code) + bits->read(offset_code);
+            auto match_length_code = match_length_entry.symbol;
+            size_t match_length = match_length_baselines[match_length_code] + bits->read(match_length_extra_bits[match_length_code]);
+            auto literal_length_code = literal_length_entry.symbol;
+            size_t literal_length = literal_length_baselines[literal_length_code] + bits->read(literal_length_extra_bits[literal_length_code]);
+
+            // Offset values of 1 to 3 pick one of the recently used offsets instead, shifted by one without literals.
+            size_t offset;
+            if (offset_value > 3) {
+                offset = offset_value - 3;
+                m_repeated_offsets[2] = m_repeated_offsets[1];
+                m_repeated_offsets[1] = m_repeated_offsets[0];
+                m_repeated_offsets[0] = offset;
+            } else {
+                if (literal_length == 0)
+                    offset_value++;
+                if (offset_value == 1) {
+                    offset = m_repeated_offsets[0];
+                } else {
+                    offset = offset_value == 4 ? m_repeated_offsets[0] - 1 : m_repeated_offsets[offset_value - 1];
+                    if (offset_value != 2)
+                        m_repeated_offsets[2] = m_repeated_offsets[1];
+                    m_repeated_offsets[1] = m_repeated_offsets[0];
+                    m_repeated_offsets[0] = offset;
+                }
+            }
+
+            if (i + 1 < sequence_count) {
+                literal_length_state = literal_length_entry.base + bits->read(literal_length_entry.bits);
+                match_length_state = match_length_entry.base + bits->read(match_length_entry.bits);
+                offset_state = offset_entry.base + bits->read(offset_entry.bits);
+            }
+            if (bits->is_overflowed())
+                return false;
+
+            if (literal_length > m_literals_size - literals_offset || literal_length + match_length > block_end - output_size)
+                return false;
+            memcpy(output.offset_pointer(output_size), m_literals.offset_pointer(literals_offset), literal_length);
+            literals_offset += literal_length;
+            output_size += literal_length;
+
+            if (offset == 0 || offset > output_size)
+                return false;
+            copy_match(output.offset_pointer(output_size), offset, match_length);
+            output_size += match_length;
+        }
+        if (!bits->is_finished())
+            return false;
+    } else if (header_size != section.size()) {
+        return false;
+    }
+
+    auto remaining_literals = m_literals_size - literals_offset;
+    if (remaining_literals > output.size() - output_size)
+        return false;
+    memcpy(output.offset_pointer(output_size), m_literals.offset_pointer(literals_offset), remaining_literals);
+    output_size += remaining_literals;
+    return output_size - block_start <= m_block_maximum_size;
+}
+
+bool ZstdDecompressor::decompress_block(ReadonlyBytes block, Bytes output, size_t& output_size)
+{
+    size_t literals_size;
+    if (!decode_literals(block, literals_size))
+        return false;
+    return decode_sequences(block.slice(literals_size), output, output_size);
+}
+
+// Reads as many bytes as the stream has, up to the size of the buffer.
+static size_t read_fully(InputStream& stream, Bytes bytes)
+{
+    size_t nread = 0;
+    while (nread < bytes.size()) {
+        auto count = stream.read(bytes.slice(nread));
+        if (count == 0)
+            break;
+        nread += count;
+    }
+    return nread;
+}
+
+bool ZstdDecompressor::read_frame_header()
+{
+    u8 magic_bytes[4];
+    auto nread = read_fully(m_input_stream, { magic_bytes, sizeof(magic_bytes) });
+    if (nread == 0 && m_input_stream.unreliable_eof()) {
+        m_eof = true;
+        return false;
+    }
+    if (nread < sizeof(magic_bytes)) {
+        set_fatal_error();
+        return false;
+    }
+
+    u32 magic = read_little_endian({ magic_bytes, sizeof(magic_bytes) });
+    if ((magic & 0xfffffff0) == skippable_frame_magic) {
+        LittleEndian<u32> frame_size;
+        m_input_stream >> frame_size;
+        if (m_input_stream.has_any_error() || !m_input_stream.discard_or_error(frame_size)) {
+            set_fatal_error();
+            return false;
+        }
+        return true;
+    }
+    if (magic != frame_magic) {
+        set_fatal_error();
+        return false;
+    }
+
+    u8 descriptor;
+    m_input_stream >> descriptor;
+    auto content_size_flag = descriptor >> 6;
+    bool is_single_segment = descriptor & 0x20;
+    m_has_content_checksum = descriptor & 0x04;
+    auto dictionary_id_flag = descriptor & 3;
+    if (m_input_stream.has_any_error() || (descriptor & 0x08)) {
+        set_fatal_error();
+        return false;
+    }
+
+    u64 window_size = 0;
+    if (!is_single_segment) {
+        u8 window_descriptor;
+        m_input_stream >> window_descriptor;
+        u64 window_base = 1ull << (10 + (window_descriptor >> 3));
+        window_size = window_base + (window_base / 8) * (window_descriptor & 7);
+    }
+
+    static constexpr size_t dictionary_id_sizes[] = { 0, 1, 2, 4 };
+    static constexpr size_t content_size_sizes[] = { 0, 2, 4, 8 };
+    u8 field[sizeof(u64)];
+    auto dictionary_id_size = dictionary_id_sizes[dictionary_id_flag];
+    if (!m_input_stream.read_or_error({ field, dictionary_id_size }) || read_little_endian({ field, dictionary_id_size }) != 0) {
+        // FIXME: Support dictionaries.
+        set_fatal_error();
+        return false;
+    }
+
+    auto content_size_size = content_size_flag == 0 && is_single_segment ? 1 : content_size_sizes[content_size_flag];
+    m_content_size.clear();
+    if (content_size_size != 0) {
+        if (!m_input_stream.read_or_error({ field, content_size_size })) {
+            set_fatal_error();
+            return false;
+        }
+        m_content_size = read_little_endian({ field, content_size_size }) + (content_size_size == 2 ? 256 : 0);
+    }
+    if (is_single_segment)
+        window_size = m_content_size.value();
+
+    if (m_input_stream.has_any_error() || window_size > max_window_size) {
+        set_fatal_error();
+        return false;
+    }
+
+    m_window_size = window_size;
+    m_block_maximum_size = min(m_window_size, max_block_size);
+    m_frame_size = 0;
+    m_content_checksum = Crypto::Checksum::XxHash64();
+    m_repeated_offsets[0] = 1;
+    m_repeated_offsets[1] = 4;
+    m_repeated_offsets[2] = 8;
+    m_huffman_table.clear();
+    m_literal_length_table.clear();
+    m_offset_table.clear();
+    m_match_length_table.clear();
+
+    m_output = ByteBuffer::create_uninitialized(2 * m_window_size + m_block_maximum_size);
+    m_output_end = 0;
+    m_read_offset = 0;
+    m_in_frame = true;
+    return true;
+}
+
+bool ZstdDecompressor::read_block()
+{
+    u8 header_bytes[3];
+    if (!m_input_stream.read_or_error({ header_bytes, sizeof(header_bytes) })) {
+        set_fatal_error();
+        return false;
+    }
+    auto header = read_little_endian({ header_bytes, sizeof(header_bytes) });
+    bool is_last_block = header & 1;
+    auto type = (header >> 1) & 3;
+    size_t block_size = header >> 3;
+    if (type > Compressed || block_size > m_block_maximum_size) {
+        set_fatal_error();
+        return false;
+    }
+
+    // Keep only as much of what was decompressed before as the window reaches back.
+    if (m_output_end + m_block_maximum_size > m_output.size()) {
+        auto keep = min(m_window_size, m_output_end);
+        memmove(m_output.data(), m_output.offset_pointer(m_output_end - keep), keep);
+        m_output_end = keep;
+    }
+    m_read_offset = m_output_end;
+
+    auto output_size = m_output_end;
+    if (type == Raw) {
+        if (!m_input_stream.read_or_error(m_output.bytes().slice(m_output_end, block_size))) {
+            set_fatal_error();
+            return false;
+        }
+        output_size += block_size;
+    } else if (type == Rle) {
+        u8 byte;
+        m_input_stream >> byte;
+        memset(m_output.offset_pointer(m_output_end), byte, block_size);
+        output_size += block_size;
+    } else {
+        if (m_block.is_empty())
+            m_block = ByteBuffer::create_uninitialized(max_block_size);
+        auto block = m_block.bytes().trim(block_size);
+        if (!m_input_stream.read_or_error(block) || !decompress_block(block, m_output.bytes().trim(m_output_end + m_block_maximum_size), output_size)) {
+            set_fatal_error();
+            return false;
+        }
+    }
+    if (m_input_stream.has_any_error()) {
+        set_fatal_error();
+        return false;
+    }
+
+    auto decompressed = m_output.bytes().slice(m_output_end, output_size - m_output_end);
+    if (m_has_content_checksum)
+        m_content_checksum.update(decompressed);
+    m_frame_size += decompressed.size();
+    m_output_end = output_size;
+
+    if (is_last_block) {
+        if (m_has_content_checksum) {
+            LittleEndian<u32> checksum;
+            m_input_stream >> checksum;
+            if (m_input_stream.has_any_error() || checksum != (u32)m_content_checksum.digest()) {
+                set_fatal_error();
+                return false;
+            }
+        }
+        if (m_content_size.has_value() && m_content_size.value() != m_frame_size) {
+            set_fatal_error();
+            return false;
+        }
+        m_in_frame = false;
+    }
+    return true;
+}
+
+size_t ZstdDecompressor::read(Bytes bytes)
+{
+    size_t total_read = 0;
+    while (total_read < bytes.size()) {
+        if (has_any_error() || m_eof)
+            break;
+
+        if (m_read_offset < m_output_end) {
+            auto nread = m_output.bytes().slice(m_read_offset, m_output_end - m_read_offset).copy_trimmed_to(bytes.slice(total_read));
+            m_read_offset += nread;
+            total_read += nread;
+            continue;
+        }
+
+        if (m_in_frame)
+            read_block();
+        else
+            read_frame_header();
+    }
+    return total_read;
+}
+
+bool ZstdDecompressor::read_or_error(Bytes bytes)
+{
+    if (read(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool ZstdDecompressor::discard_or_error(size_t count)
+{
+    u8 buffer[4096];
+
+    size_t ndiscarded = 0;
+    while (ndiscarded < count) {
+        if (unreliable_eof()) {
+            set_fatal_error();
+            return false;
+        }
+
+        ndiscarded += read({ buffer, min<size_t>(count - ndiscarded, sizeof(buffer)) });
+    }
+
+    return true;
+}
+
+bool ZstdDecompressor::unreliable_eof() const { return m_eof; }
+
+bool ZstdDecompressor::handle_any_error()
+{
+    bool handled_errors = m_input_stream.handle_any_error();
+    return Stream::handle_any_error() || handled_errors;
+}
+
+Optional<ByteBuffer> ZstdDecompressor::decompress_all(ReadonlyBytes bytes)
+{
+    InputMemoryStream memory_stream { bytes };
+    ZstdDecompressor zstd_stream { memory_stream };
+    DuplexMemoryStream output_stream;
+
+    u8 buffer[4096];
+    while (!zstd_stream.has_any_error() && !zstd_stream.unreliable_eof()) {
+        auto nread = zstd_stream.read({ buffer, sizeof(buffer) });
+        output_stream.write_or_error({ buffer, nread });
+    }
+
+    if (zstd_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+bool ZstdDecompressor::is_likely_compressed(ReadonlyBytes bytes)
+{
+    return bytes.size() >= 4 && read_little_endian(bytes.trim(4)) == frame_magic;
+}
+
+// Writes bits from the least significant bit of each byte on, for the decoder to read backwards.
+class BitWriter {
+public:
+    explicit BitWriter(ByteBuffer& output)
+        : m_output(output)
+    {
+    }
+
+    void write(u64 value, size_t count)
+    {
+        VERIFY(count <= 32);
+        m_bits |= (value & ((1ull << count) - 1)) << m_count;
+        m_count += count;
+        while (m_count >= 8) {
+            u8 byte = m_bits;
+            m_output.append(&byte, 1);
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    // Ends the bits with the set bit the decoder looks for to find where they start.
+    void finish()
+    {
+        write(1, 1);
+        if (m_count != 0)
+            write(0, 8 - m_count);
+    }
+
+private:
+    ByteBuffer& m_output;
+    u64 m_bits { 0 };
+    size_t m_count { 0 };
+};
+
+// Encodes symbols with one of the predefined entropy tables, in the reverse order of how they are decoded.
+class FseEncoder {
+public:
+    FseEncoder(Span<i16 const> probabilities, u8 accuracy_log)
+        : m_accuracy_log(accuracy_log)
+    {
+        u32 table_size = 1u << accuracy_log;
+        Vector<u8, 64> table_symbols;
+        table_symbols.resize(table_size);
+        Vector<u32, 64> cumulative;
+        cumulative.resize(probabilities.size() + 1);
+
+        u32 high_threshold = table_size - 1;
+        for (size_t symbol = 0; symbol < probabilities.size(); ++symbol) {
+            if (probabilities[symbol] == -1) {
+                cumulative[symbol + 1] = cumulative[symbol] + 1;
+                table_symbols[high_threshold--] = symbol;
+            } else {
+                cumulative[symbol + 1] = cumulative[symbol] + probabilities[symbol];
+            }
+        }
+
+        u32 step = (table_size >> 1) + (table_size >> 3) + 3;
+        u32 position = 0;
+        for (size_t symbol = 0; symbol < probabilities.size(); ++symbol) {
+            for (i16 i = 0; i < probabilities[symbol]; ++i) {
+                table_symbols[position] = symbol;
+                do {
+                    position = (position + step) & (table_size - 1);
+                } while (position > high_threshold);
+            }
+        }
+        VERIFY(position == 0);
+
+        m_state_table.resize(table_size);
+        for (u32 i = 0; i < table_size; ++i)
+            m_state_table[cumulative[table_symbols[i]]++] = table_size + i;
+
+        m_transforms.resize(probabilities.size());
+        i32 total = 0;
+        for (size_t symbol = 0; symbol < probabilities.size(); ++symbol) {
+            auto probability = probabilities[symbol];
+            VERIFY(probability != 0);
+            if (probability == -1 || probability == 1) {
+                m_transforms[symbol] = { total - 1, (accuracy_log << 16) - table_size };
+                total++;
+            } else {
+                u32 max_bits_out = accuracy_log - highest_bit(probability - 1);
+                u32 min_state_plus = (u32)probability << max_bits_out;
+                m_transforms[symbol] = { total - probability, (max_bits_out << 16) - min_state_plus };
+                total += probability;
+            }
+        }
+    }
+
+    void start(u8 symbol)
+    {
+        auto& transform = m_transforms[symbol];
+        u32 bits_out = (transform.delta_bits + (1 << 15)) >> 16;
+        u32 value = (bits_out << 16) - transform.delta_bits;
+        m_state = m_state_table[(value >> bits_out) + transform.delta_find_state];
+    }
+
+    void encode(BitWriter& writer, u8 symbol)
+    {
+        auto& transform = m_transforms[symbol];
+        u32 bits_out = (m_state + transform.delta_bits) >> 16;
+        writer.write(m_state, bits_out);
+        m_state = m_state_table[(m_state >> bits_out) + transform.delta_find_state];
+    }
+
+    void finish(BitWriter& writer)
+    {
+        writer.write(m_state, m_accuracy_log);
+    }
+
+private:
+    struct SymbolTransform {
+        i32 delta_find_state;
+        u32 delta_bits;
+    };
+
+    u8 m_accuracy_log;
+    Vector<u16, 64> m_state_table;
+    Vector<SymbolTransform, 64> m_transforms;
+    u32 m_state { 0 };
+};
+
+struct Sequence {
+    u32 literal_length;
+    u32 match_length;
+    u32 offset;
+};
+
+static void write_literals_header(ByteBuffer& output, LiteralsType type, size_t size)
+{
+    if (size < 32) {
+        u8 header = type | (size << 3);
+        output.append(&header, 1);
+    } else if (size < 4096) {
+        u8 header[2] = { (u8)(type | (1 << 2) | ((size & 0xf) << 4)), (u8)(size >> 4) };
+        output.append(header, 2);
+    } else {
+        u8 header[3] = { (u8)(type | (3 << 2) | ((size & 0xf) << 4)), (u8)(size >> 4), (u8)(size >> 12) };
+        output.append(header, 3);
+    }
+}
+
+// Huffman code lengths of at most max_huffman_bits for the symbols that occur.
+static void generate_huffman_lengths(Array<u32, 256> frequencies, size_t symbol_count, Array<u8, 256>& lengths)
+{
+    for (;;) {
+        struct Node {
+            u64 frequency;
+            i16 parent;
+        };
+        Vector<Node, 512> nodes;
+        Vector<size_t, 256> roots;
+        for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+            nodes.append({ frequencies[symbol], -1 });
+            if (frequencies[symbol] != 0)
+                roots.append(symbol);
+        }
+
+        while (roots.size() > 1) {
+            size_t smallest[2];
+            for (auto& index : smallest) {
+                size_t best = 0;
+                for (size_t i = 1; i < roots.size(); ++i) {
+                    if (nodes[roots[i]].frequency < nodes[roots[best]].frequency)
+                        best = i;
+                }
+                index = roots[best];
+                roots.remove(best);
+            }
+            nodes.append({ nodes[smallest[0]].frequency + nodes[smallest[1]].frequency, -1 });
+            nodes[smallest[0]].parent = nodes[smallest[1]].parent = nodes.size() - 1;
+            roots.append(nodes.size() - 1);
+        }
+
+        size_t max_length = 0;
+        for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+            size_t length = 0;
+            if (frequencies[symbol] != 0) {
+                for (auto node = nodes[symbol].parent; node != -1; node = nodes[node].parent)
+                    ++length;
+            }
+            lengths[symbol] = length;
+            max_length = max(max_length, length);
+        }
+        if (max_length <= max_huffman_bits)
+            return;
+
+        // Flatten the distribution until the longest code is short enough.
+        for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+            if (frequencies[symbol] != 0)
+                frequencies[symbol] = (frequencies[symbol] + 1) / 2;
+        }
+    }
+}
+
+// Appends the literals section for the literals, Huffman coded if that is smaller.
+static void compress_literals(ReadonlyBytes literals, ByteBuffer& output)
+{
+    Array<u32, 256> frequencies {};
+    for (auto byte : literals)
+        frequencies[byte]++;
+
+    size_t distinct_symbols = 0;
+    size_t last_symbol = 0;
+    for (size_t symbol = 0; symbol < 256; ++symbol) {
+        if (frequencies[symbol] != 0) {
+            distinct_symbols++;
+            last_symbol = symbol;
+        }
+    }
+
+    if (distinct_symbols == 1 && literals.size() > 1) {
+        write_literals_header(output, RleLiterals, literals.size());
+        output.append(literals.data(), 1);
+        return;
+    }
+
+    auto write_raw = [&] {
+        write_literals_header(output, RawLiterals, literals.size());
+        output.append(literals);
+    };
+
+    // FIXME: Describe the weights with an entropy table when there are too many of them to store directly.
+    if (literals.size() < 64 || distinct_symbols < 2 || last_symbol > 128)
+        return write_raw();
+
+    Array<u8, 256> lengths {};
+    generate_huffman_lengths(frequencies, last_symbol + 1, lengths);
+    u8 max_bits = 0;
+    for (size_t symbol = 0; symbol <= last_symbol; ++symbol)
+        max_bits = max(max_bits, lengths[symbol]);
+
+    Array<u8, 256> weights {};
+    Array<u32, max_huffman_bits + 2> weight_counts {};
+    for (size_t symbol = 0; symbol <= last_symbol; ++symbol) {
+        if (lengths[symbol] != 0)
+            weights[symbol] = max_bits + 1 - lengths[symbol];
+        weight_counts[weights[symbol]]++;
+    }
+
+    // Assign the codes the same way the decoder lays out its table.
+    Array<u32, max_huffman_bits + 2> rank_start {};
+    u32 current = 0;
+    for (size_t weight = 1; weight <= max_bits; ++weight) {
+        rank_start[weight] = current;
+        current += weight_counts[weight] << (weight - 1);
+    }
+    Array<u16, 256> codes {};
+    for (size_t symbol = 0; symbol <= last_symbol; ++symbol) {
+        auto weight = weights[symbol];
+        if (weight == 0)
+            continue;
+        codes[symbol] = rank_start[weight] >> (weight - 1);
+        rank_start[weight] += 1u << (weight - 1);
+    }
+
+    ByteBuffer compressed;
+    u8 tree_header = 127 + last_symbol;
+    compressed.append(&tree_header, 1);
+    for (size_t symbol = 0; symbol < last_symbol; symbol += 2) {
+        u8 byte = (weights[symbol] << 4) | (symbol + 1 < last_symbol ? weights[symbol + 1] : 0);
+        compressed.append(&byte, 1);
+    }
+
+    auto encode_stream = [&](ReadonlyBytes stream) {
+        BitWriter writer { compressed };
+        for (size_t i = stream.size(); i-- > 0;)
+            writer.write(codes[stream[i]], lengths[stream[i]]);
+        writer.finish();
+    };
+
+    bool single_stream = literals.size() <= 1023;
+    if (single_stream) {
+        encode_stream(literals);
+    } else {
+        auto jump_table_offset = compressed.size();
+        compressed.append("\0\0\0\0\0\0", 6);
+        auto segment_size = ceil_div(literals.size(), (size_t)4);
+        for (size_t i = 0; i < 4; ++i) {
+            auto stream_start = compressed.size();
+            encode_stream(literals.slice(i * segment_size, i < 3 ? segment_size : literals.size() - 3 * segment_size));
+            if (i < 3) {
+                auto stream_size = compressed.size() - stream_start;
+                if (stream_size > 0xffff)
+                    return write_raw();
+                compressed[jump_table_offset + 2 * i] = stream_size;
+                compressed[jump_table_offset + 2 * i + 1] = stream_size >> 8;
+            }
+        }
+    }
+
+    if (compressed.size() >= literals.size())
+        return write_raw();
+
+    size_t size_format = single_stream ? 0 : (literals.size() <= 16383 ? 2 : 3);
+    static constexpr size_t header_sizes[] = { 3, 3, 4, 5 };
+    static constexpr size_t size_bits[] = { 10, 10, 14, 18 };
+    u64 header = CompressedLiterals | (size_format << 2) | (literals.size() << 4) | ((u64)compressed.size() << (4 + size_bits[size_format]));
+    for (size_t i = 0; i < header_sizes[size_format]; ++i) {
+        u8 byte = header >> (i * 8);
+        output.append(&byte, 1);
+    }
+    output.append(compressed.bytes());
+}
+
+static void compress_sequences(Span<Sequence const> sequences, ByteBuffer& output)
+{
+    auto count = sequences.size();
+    if (count < 128) {
+        u8 byte = count;
+        output.append(&byte, 1);
+    } else if (count < 0x7f00) {
+        u8 bytes[2] = { (u8)((count >> 8) + 128), (u8)count };
+        output.append(bytes, 2);
+    } else {
+        u8 bytes[3] = { 255, (u8)(count - 0x7f00), (u8)((count - 0x7f00) >> 8) };
+        output.append(bytes, 3);
+    }
+    if (count == 0)
+        return;
+
+    u8 modes = (Predefined << 6) | (Predefined << 4) | (Predefined << 2);
+    output.append(&modes, 1);
+
+    FseEncoder literal_length_encoder { predefined_literal_length_distribution.span(), predefined_literal_length_accuracy_log };
+    FseEncoder offset_encoder { predefined_offset_distribution.span(), predefined_offset_accuracy_log };
+    FseEncoder match_length_encoder { predefined_match_length_distribution.span(), predefined_match_length_accuracy_log };
+
+    struct Codes {
+        u8 literal_length;
+        u8 match_length;
+        u8 offset;
+    };
+    auto codes_for = [](Sequence const& sequence) {
+        return Codes {
+            code_for(literal_length_baselines, sequence.literal_length),
+            code_for(match_length_baselines, sequence.match_length),
+            (u8)highest_bit(sequence.offset + 3),
+        };
+    };
+
+    BitWriter writer { output };
+    auto write_extra_bits = [&](Sequence const& sequence, Codes const& codes) {
+        writer.write(sequence.literal_length - literal_length_baselines[codes.literal_length], literal_length_extra_bits[codes.literal_length]);
+        writer.write(sequence.match_length - match_length_baselines[codes.match_length], match_length_extra_bits[codes.match_length]);
+        writer.write(sequence.offset + 3 - (1u << codes.offset), codes.offset);
+    };
+
+    auto last_codes = codes_for(sequences[count - 1]);
+    match_length_encoder.start(last_codes.match_length);
+    offset_encoder.start(last_codes.offset);
+    literal_length_encoder.start(last_codes.literal_length);
+    write_extra_bits(sequences[count - 1], last_codes);
+
+    for (size_t i = count - 1; i-- > 0;) {
+        auto codes = codes_for(sequences[i]);
+        offset_encoder.encode(writer, codes.offset);
+        match_length_encoder.encode(writer, codes.match_length);
+        literal_length_encoder.encode(writer, codes.literal_length);
+        write_extra_bits(sequences[i], codes);
+    }
+
+    match_length_encoder.finish(writer);
+    offset_encoder.finish(writer);
+    literal_length_encoder.finish(writer);
+    writer.finish();
+}
+
+static ALWAYS_INLINE u32 read_u32(u8 const* bytes)
+{
+    u32 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+// Appends the block compressed, or returns false if it could not be made smaller.
+static bool compress_block(ReadonlyBytes block, ByteBuffer& output)
+{
+    constexpr size_t hash_bits = 15;
+    constexpr size_t min_match_length = 4;
+    auto hash = [](u32 sequence) { return (sequence * 2654435761u) >> (32 - hash_bits); };
+
+    Vector<Sequence> sequences;
+    ByteBuffer literals;
+
+    size_t anchor = 0;
+    if (block.size() >= min_match_length) {
+        // Holds one more than the position where each hash was last seen, so that zero means none.
+        Vector<u32> hash_table;
+        hash_table.resize(1 << hash_bits);
+
+        size_t position = 0;
+        while (position + min_match_length <= block.size()) {
+            auto sequence = read_u32(block.offset_pointer(position));
+            auto& slot = hash_table[hash(sequence)];
+            auto candidate = (size_t)slot - 1;
+            slot = position + 1;
+
+            if (candidate >= position || read_u32(block.offset_pointer(candidate)) != sequence) {
+                ++position;
+                continue;
+            }
+
+            auto match_length = min_match_length;
+            while (position + match_length < block.size() && block[candidate + match_length] == block[position + match_length])
+                ++match_length;
+            while (position > anchor && candidate > 0 && block[position - 1] == block[candidate - 1]) {
+                --position;
+                --candidate;
+                ++match_length;
+            }
+
+            literals.append(block.slice(anchor, position - anchor));
+            sequences.append({ (u32)(position - anchor), (u32)match_length, (u32)(position - candidate) });
+            position += match_length;
+            anchor = position;
+            if (position + min_match_length <= block.size())
+                hash_table[hash(read_u32(block.offset_pointer(position - 2)))] = position - 1;
+        }
+    }
+    literals.append(block.slice(anchor));
+
+    auto start = output.size();
+    compress_literals(literals, output);
+    compress_sequences(sequences.span(), output);
+    if (output.size() - start >= block.size()) {
+        output.resize(start);
+        return false;
+    }
+    return true;
+}
+
+ZstdCompressor::ZstdCompressor(OutputStream& stream)
+    : m_output_stream(stream)
+{
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+    VERIFY(m_finished);
+}
+
+void ZstdCompressor::write_frame_header()
+{
+    LittleEndian<u32> magic = ZstdDecompressor::frame_magic;
+    u8 descriptor = 0x04;                                           // with a content checksum, but no content size or dictionary
+    u8 window_descriptor = (highest_bit(block_size) - 10) << 3; // the window is as large as a block
+    m_output_stream << magic << descriptor << window_descriptor;
+    m_wrote_frame_header = true;
+}
+
+void ZstdCompressor::write_block(bool is_last_block)
+{
+    if (!m_wrote_frame_header)
+        write_frame_header();
+
+    ReadonlyBytes block = m_pending_block.bytes().trim(m_pending_block_size);
+    m_content_checksum.update(block);
+
+    auto write_block_header = [&](BlockType type, size_t size) {
+        u32 header = is_last_block | (type << 1) | (size << 3);
+        u8 bytes[3] = { (u8)header, (u8)(header >> 8), (u8)(header >> 16) };
+        m_output_stream << ReadonlyBytes { bytes, sizeof(bytes) };
+    };
+
+    bool is_single_byte = !block.is_empty();
+    for (auto byte : block) {
+        if (byte != block[0]) {
+            is_single_byte = false;
+            break;
+        }
+    }
+
+    m_compressed_block.clear();
+    if (is_single_byte && block.size() > 1) {
+        write_block_header(Rle, block.size());
+        m_output_stream << block.trim(1);
+    } else if (compress_block(block, m_compressed_block)) {
+        write_block_header(Compressed, m_compressed_block.size());
+        m_output_stream << m_compressed_block.bytes();
+    } else {
+        write_block_header(Raw, block.size());
+        m_output_stream << block;
+    }
+    m_pending_block_size = 0;
+}
+
+size_t ZstdCompressor::write(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+    if (m_pending_block.is_empty())
+        m_pending_block = ByteBuffer::create_uninitialized(block_size);
+
+    size_t total_written = 0;
+    while (total_written < bytes.size()) {
+        // A full block is only written once more data follows, so that final_flush() has a block to mark as the last.
+        if (m_pending_block_size == block_size)
+            write_block(false);
+        auto nwritten = bytes.slice(total_written).copy_trimmed_to(m_pending_block.bytes().slice(m_pending_block_size));
+        m_pending_block_size += nwritten;
+        total_written += nwritten;
+    }
+    return total_written;
+}
+
+bool ZstdCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void ZstdCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    write_block(true);
+    LittleEndian<u32> checksum = m_content_checksum.digest();
+    m_output_stream << checksum;
+}
+
+Optional<ByteBuffer> ZstdCompressor::compress_all(ReadonlyBytes bytes)
+{
+    DuplexMemoryStream output_stream;
+    ZstdCompressor zstd_stream { output_stream };
+
+    zstd_stream.write_or_error(bytes);
+    zstd_stream.final_flush();
+
+    if (zstd_stream.handle_any_error() || output_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+}
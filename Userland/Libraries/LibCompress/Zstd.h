@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+#include <LibCrypto/Checksum/XxHash.h>
+
+namespace Compress {
+
+// Reads the Zstandard format (RFC 8878), one block at a time. Several frames may follow each other, skippable frames
+// are skipped. Frames that need a dictionary, or a window larger than max_window_size, are not supported.
+class ZstdDecompressor final : public InputStream {
+public:
+    static constexpr u32 frame_magic = 0xFD2FB528;
+    static constexpr size_t max_block_size = 128 * KiB;
+    static constexpr size_t max_window_size = 128 * MiB;
+
+    ZstdDecompressor(InputStream&);
+    ~ZstdDecompressor();
+
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t) override;
+
+    bool unreliable_eof() const override;
+    bool handle_any_error() override;
+
+    static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
+    static bool is_likely_compressed(ReadonlyBytes bytes);
+
+    // A table for decoding the finite state entropy codes of the sequences and of the Huffman weights.
+    struct FseTable {
+        struct Entry {
+            u16 base; // the next state is this plus the bits read
+            u8 symbol;
+            u8 bits;
+        };
+        u8 accuracy_log { 0 };
+        Vector<Entry> entries;
+    };
+
+    // A table for decoding the Huffman coded literals, indexed by as many bits as the longest code has.
+    struct HuffmanTable {
+        struct Entry {
+            u8 symbol;
+            u8 bits;
+        };
+        u8 max_bits { 0 };
+        Vector<Entry> entries;
+    };
+
+private:
+    bool read_frame_header();
+    bool read_block();
+    bool decompress_block(ReadonlyBytes block, Bytes output, size_t& output_size);
+    bool decode_literals(ReadonlyBytes block, size_t& consumed);
+    bool decode_sequences(ReadonlyBytes section, Bytes output, size_t& output_size);
+
+    InputStream& m_input_stream;
+
+    bool m_in_frame { false };
+    bool m_has_content_checksum { false };
+    Optional<u64> m_content_size;
+    size_t m_window_size { 0 };
+    size_t m_block_maximum_size { 0 };
+    u64 m_frame_size { 0 };
+    Crypto::Checksum::XxHash64 m_content_checksum;
+
+    // What a compressed block may take over from the blocks before it in the frame.
+    u32 m_repeated_offsets[3];
+    Optional<HuffmanTable> m_huffman_table;
+    Optional<FseTable> m_literal_length_table;
+    Optional<FseTable> m_offset_table;
+    Optional<FseTable> m_match_length_table;
+
+    ByteBuffer m_block;
+    ByteBuffer m_literals;
+    size_t m_literals_size { 0 };
+
+    ByteBuffer m_output; // the blocks decompressed last, as far back as the window reaches
+    size_t m_output_end { 0 };
+    size_t m_read_offset { 0 };
+
+    bool m_eof { false };
+};
+
+// Writes one Zstandard frame with a content checksum. Matches are found within each block, the literals are Huffman
+// coded when that helps and the sequences use the predefined entropy tables.
+class ZstdCompressor final : public OutputStream {
+public:
+    static constexpr size_t block_size = ZstdDecompressor::max_block_size;
+
+    ZstdCompressor(OutputStream&);
+    ~ZstdCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+    void final_flush();
+
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes);
+
+private:
+    void write_frame_header();
+    void write_block(bool is_last_block);
+
+    OutputStream& m_output_stream;
+    bool m_wrote_frame_header { false };
+    bool m_finished { false };
+    Crypto::Checksum::XxHash64 m_content_checksum;
+
+    ByteBuffer m_pending_block;
+    size_t m_pending_block_size { 0 };
+    ByteBuffer m_compressed_block;
+};
+
+}
@@ -44,6 +44,7 @@ bool DirIterator::advance_next()
         }
 
         m_next = de->d_name;
+        m_next_type = de->d_type;
         if (m_next.is_null())
             return false;
 
@@ -71,6 +72,7 @@ String DirIterator::next_path()
         advance_next();
 
     auto tmp = m_next;
+    m_last_type = m_next_type;
     m_next = String();
     return tmp;
 }
@@ -29,12 +29,17 @@ public:
     bool has_next();
     String next_path();
     String next_full_path();
+    // The type of the entry that next_path() returned last, as one of the DT_* values from the directory entry itself.
+    // This saves a stat() call, except on file systems that don't know, where it's DT_UNKNOWN.
+    unsigned char last_type() const { return m_last_type; }
     int fd() const;
 
 private:
     DIR* m_dir = nullptr;
     int m_error = 0;
     String m_next;
+    unsigned char m_next_type { DT_UNKNOWN };
+    unsigned char m_last_type { DT_UNKNOWN };
     String m_path;
     int m_flags;
 
@@ -19,6 +19,7 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/LocalSocket.h>
+#include <LibCore/MemoryPressure.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibThreading/Mutex.h>
@@ -35,6 +36,12 @@
 #include <time.h>
 #include <unistd.h>
 
+#ifdef __serenity__
+#    include <Kernel/API/EventPoll.h>
+#    include <poll.h>
+#    include <serenity.h>
+#endif
+
 namespace Core {
 
 class InspectorServerConnection;
@@ -48,11 +55,18 @@ struct EventLoopTimer {
     bool should_reload { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
     WeakPtr<Object> owner;
+    // Where the timer is in s_timer_queue, or -1 if it has expired while its owner wasn't visible.
+    ssize_t queue_index { -1 };
 
     void reload(const timeval& now);
     bool has_expired(const timeval& now) const;
+    bool fires_before(const EventLoopTimer& other) const;
+    bool is_waiting_for_owner_to_become_visible() const;
 };
 
+static void add_timer_to_queue(EventLoopTimer&);
+static void remove_timer_from_queue(EventLoopTimer&);
+
 struct EventLoop::Private {
     Threading::Mutex lock;
 };
@@ -61,8 +75,25 @@ static EventLoop* s_main_event_loop;
 static Vector<EventLoop&>* s_event_loop_stack;
 static NeverDestroyed<IDAllocator> s_id_allocator;
 static HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
+// A binary min-heap of the timers, ordered by when they fire next, so that neither finding out how long to wait
+// nor finding the expired timers has to look at all of them.
+static Vector<EventLoopTimer*>* s_timer_queue;
+// Expired timers whose owners aren't visible don't fire, and don't keep the event loop awake either.
+// They fire as soon as the event loop notices that their owners have become visible.
+static Vector<EventLoopTimer*>* s_timers_waiting_for_visibility;
 static HashTable<Notifier*>* s_notifiers;
 int EventLoop::s_wake_pipe_fds[2];
+
+#ifdef __serenity__
+// Instead of passing the file descriptors of all notifiers to select() every time we wait, they are
+// kept in an event poll, which only has to be updated whenever the set of notifiers changes.
+struct EventPollWatch {
+    Vector<Notifier*, 1> notifiers;
+    u32 events { 0 };
+};
+static int s_event_poll_fd = -1;
+static HashMap<int, EventPollWatch>* s_event_poll_watches;
+#endif
 static RefPtr<InspectorServerConnection> s_inspector_server_connection;
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -259,7 +290,12 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
+        s_timer_queue = new Vector<EventLoopTimer*>;
+        s_timers_waiting_for_visibility = new Vector<EventLoopTimer*>;
         s_notifiers = new HashTable<Notifier*>;
+#ifdef __serenity__
+        s_event_poll_watches = new HashMap<int, EventPollWatch>;
+#endif
     }
 
     if (!s_main_event_loop) {
@@ -274,7 +310,20 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
 
 #endif
         VERIFY(rc == 0);
+
+#ifdef __serenity__
+        s_event_poll_fd = event_poll_create(O_CLOEXEC);
+        if (s_event_poll_fd < 0) {
+            perror("event_poll_create");
+        } else {
+            event_poll_event event { POLLIN, 0, static_cast<u64>(s_wake_pipe_fds[0]) };
+            rc = event_poll_ctl(s_event_poll_fd, EVENT_POLL_CTL_ADD, s_wake_pipe_fds[0], &event);
+            VERIFY(rc == 0);
+        }
+#endif
+
         s_event_loop_stack->append(*this);
+        MemoryPressure::initialize({});
 
 #ifdef __serenity__
         if (getuid() != 0
@@ -553,8 +602,18 @@ void EventLoop::notify_forked(ForkEvent event)
     case ForkEvent::Child:
         s_main_event_loop = nullptr;
         s_event_loop_stack->clear();
+        s_timer_queue->clear();
+        s_timers_waiting_for_visibility->clear();
         s_timers->clear();
         s_notifiers->clear();
+#ifdef __serenity__
+        // The event poll is shared with the parent, so leave it alone and let the next event loop create a new one.
+        if (s_event_poll_fd >= 0) {
+            close(s_event_poll_fd);
+            s_event_poll_fd = -1;
+        }
+        s_event_poll_watches->clear();
+#endif
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
             info->next_signal_id = 0;
@@ -573,29 +632,10 @@ void EventLoop::wait_for_event(WaitMode mode)
 {
     fd_set rfds;
     fd_set wfds;
+#ifdef __serenity__
+    event_poll_event ready_events[64];
+#endif
 retry:
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
-
-    int max_fd = 0;
-    auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
-        FD_SET(fd, &set);
-        if (fd > max_fd)
-            max_fd = fd;
-    };
-
-    int max_fd_added = -1;
-    add_fd_to_set(s_wake_pipe_fds[0], rfds);
-    max_fd = max(max_fd, max_fd_added);
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            VERIFY_NOT_REACHED();
-    }
-
     bool queued_events_is_empty;
     {
         Threading::MutexLocker locker(m_private->lock);
@@ -622,19 +662,68 @@ retry:
         }
     }
 
-try_select_again:
-    int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
-    if (marked_fd_count < 0) {
-        int saved_errno = errno;
-        if (saved_errno == EINTR) {
-            if (m_exit_requested)
-                return;
-            goto try_select_again;
+    int marked_fd_count = 0;
+    bool wake_pipe_is_readable = false;
+#ifdef __serenity__
+    if (s_event_poll_fd >= 0) {
+        timespec timeout_spec = { timeout.tv_sec, timeout.tv_usec * 1000 };
+    try_event_poll_wait_again:
+        marked_fd_count = event_poll_wait(s_event_poll_fd, ready_events, array_size(ready_events), should_wait_forever ? nullptr : &timeout_spec);
+        if (marked_fd_count < 0) {
+            int saved_errno = errno;
+            if (saved_errno == EINTR) {
+                if (m_exit_requested)
+                    return;
+                goto try_event_poll_wait_again;
+            }
+            dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
+            VERIFY_NOT_REACHED();
         }
-        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
-        VERIFY_NOT_REACHED();
+        for (int i = 0; i < marked_fd_count; ++i) {
+            if (ready_events[i].user_data == static_cast<u64>(s_wake_pipe_fds[0]))
+                wake_pipe_is_readable = true;
+        }
+    } else
+#endif
+    {
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+
+        int max_fd = 0;
+        auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
+            FD_SET(fd, &set);
+            if (fd > max_fd)
+                max_fd = fd;
+        };
+
+        int max_fd_added = -1;
+        add_fd_to_set(s_wake_pipe_fds[0], rfds);
+        max_fd = max(max_fd, max_fd_added);
+        for (auto& notifier : *s_notifiers) {
+            if (notifier->event_mask() & Notifier::Read)
+                add_fd_to_set(notifier->fd(), rfds);
+            if (notifier->event_mask() & Notifier::Write)
+                add_fd_to_set(notifier->fd(), wfds);
+            if (notifier->event_mask() & Notifier::Exceptional)
+                VERIFY_NOT_REACHED();
+        }
+
+    try_select_again:
+        marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+        if (marked_fd_count < 0) {
+            int saved_errno = errno;
+            if (saved_errno == EINTR) {
+                if (m_exit_requested)
+                    return;
+                goto try_select_again;
+            }
+            dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
+            VERIFY_NOT_REACHED();
+        }
+        wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         auto nread = read(s_wake_pipe_fds[0], wake_events, sizeof(wake_events));
         if (nread < 0) {
@@ -662,22 +751,37 @@ try_select_again:
         now.tv_usec = now_spec.tv_nsec / 1000;
     }
 
-    for (auto& it : *s_timers) {
-        auto& timer = *it.value;
-        if (!timer.has_expired(now))
+    // Take all the expired timers out before reloading any of them, so that a timer with an interval of zero
+    // fires only once per wakeup.
+    Vector<EventLoopTimer*, 16> expired_timers;
+    for (size_t i = 0; i < s_timers_waiting_for_visibility->size();) {
+        auto* timer = s_timers_waiting_for_visibility->at(i);
+        if (timer->is_waiting_for_owner_to_become_visible()) {
+            ++i;
             continue;
-        auto owner = timer.owner.strong_ref();
-        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
+        }
+        s_timers_waiting_for_visibility->remove(i);
+        expired_timers.append(timer);
+    }
+    while (!s_timer_queue->is_empty() && s_timer_queue->first()->has_expired(now)) {
+        auto* timer = s_timer_queue->first();
+        remove_timer_from_queue(*timer);
+        if (timer->is_waiting_for_owner_to_become_visible()) {
+            s_timers_waiting_for_visibility->append(timer);
             continue;
         }
+        expired_timers.append(timer);
+    }
 
-        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer.timer_id, *owner);
+    for (auto* timer : expired_timers) {
+        auto owner = timer->owner.strong_ref();
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer->timer_id, *owner);
 
         if (owner)
-            post_event(*owner, make<TimerEvent>(timer.timer_id));
-        if (timer.should_reload) {
-            timer.reload(now);
+            post_event(*owner, make<TimerEvent>(timer->timer_id));
+        if (timer->should_reload) {
+            timer->reload(now);
+            add_timer_to_queue(*timer);
         } else {
             // FIXME: Support removing expired timers that don't want to reload.
             VERIFY_NOT_REACHED();
@@ -687,6 +791,24 @@ try_select_again:
     if (!marked_fd_count)
         return;
 
+#ifdef __serenity__
+    if (s_event_poll_fd >= 0) {
+        for (int i = 0; i < marked_fd_count; ++i) {
+            auto& ready_event = ready_events[i];
+            auto it = s_event_poll_watches->find(static_cast<int>(ready_event.user_data));
+            if (it == s_event_poll_watches->end())
+                continue;
+            for (auto* notifier : it->value.notifiers) {
+                if ((ready_event.events & POLLIN) && (notifier->event_mask() & Notifier::Event::Read))
+                    post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
+                if ((ready_event.events & POLLOUT) && (notifier->event_mask() & Notifier::Event::Write))
+                    post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+            }
+        }
+        return;
+    }
+#endif
+
     for (auto& notifier : *s_notifiers) {
         if (FD_ISSET(notifier->fd(), &rfds)) {
             if (notifier->event_mask() & Notifier::Event::Read)
@@ -711,20 +833,82 @@ void EventLoopTimer::reload(const timeval& now)
     fire_time.tv_usec += (interval % 1000) * 1000;
 }
 
-Optional<struct timeval> EventLoop::get_next_timer_expiration()
+bool EventLoopTimer::fires_before(const EventLoopTimer& other) const
 {
-    Optional<struct timeval> soonest {};
-    for (auto& it : *s_timers) {
-        auto& fire_time = it.value->fire_time;
-        auto owner = it.value->owner.strong_ref();
-        if (it.value->fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
-        if (!soonest.has_value() || fire_time.tv_sec < soonest.value().tv_sec || (fire_time.tv_sec == soonest.value().tv_sec && fire_time.tv_usec < soonest.value().tv_usec))
-            soonest = fire_time;
+    return fire_time.tv_sec < other.fire_time.tv_sec || (fire_time.tv_sec == other.fire_time.tv_sec && fire_time.tv_usec < other.fire_time.tv_usec);
+}
+
+bool EventLoopTimer::is_waiting_for_owner_to_become_visible() const
+{
+    if (fire_when_not_visible == TimerShouldFireWhenNotVisible::Yes)
+        return false;
+    auto owner = this->owner.strong_ref();
+    return owner && !owner->is_visible_for_timer_purposes();
+}
+
+static void place_timer_in_queue(EventLoopTimer& timer, size_t index)
+{
+    s_timer_queue->at(index) = &timer;
+    timer.queue_index = index;
+}
+
+static void sift_timer_up(EventLoopTimer& timer)
+{
+    size_t index = timer.queue_index;
+    while (index > 0) {
+        size_t parent_index = (index - 1) / 2;
+        auto& parent = *s_timer_queue->at(parent_index);
+        if (!timer.fires_before(parent))
+            break;
+        place_timer_in_queue(parent, index);
+        index = parent_index;
     }
-    return soonest;
+    place_timer_in_queue(timer, index);
+}
+
+static void sift_timer_down(EventLoopTimer& timer)
+{
+    size_t index = timer.queue_index;
+    for (;;) {
+        size_t child_index = index * 2 + 1;
+        if (child_index >= s_timer_queue->size())
+            break;
+        if (child_index + 1 < s_timer_queue->size() && s_timer_queue->at(child_index + 1)->fires_before(*s_timer_queue->at(child_index)))
+            ++child_index;
+        auto& child = *s_timer_queue->at(child_index);
+        if (!child.fires_before(timer))
+            break;
+        place_timer_in_queue(child, index);
+        index = child_index;
+    }
+    place_timer_in_queue(timer, index);
+}
+
+static void add_timer_to_queue(EventLoopTimer& timer)
+{
+    timer.queue_index = s_timer_queue->size();
+    s_timer_queue->append(&timer);
+    sift_timer_up(timer);
+}
+
+static void remove_timer_from_queue(EventLoopTimer& timer)
+{
+    VERIFY(timer.queue_index >= 0);
+    auto* last_timer = s_timer_queue->take_last();
+    if (last_timer != &timer) {
+        // The last timer takes the removed one's place, and then moves to wherever it belongs from there.
+        place_timer_in_queue(*last_timer, timer.queue_index);
+        sift_timer_up(*last_timer);
+        sift_timer_down(*last_timer);
+    }
+    timer.queue_index = -1;
+}
+
+Optional<struct timeval> EventLoop::get_next_timer_expiration()
+{
+    if (s_timer_queue->is_empty())
+        return {};
+    return s_timer_queue->first()->fire_time;
 }
 
 int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible)
@@ -743,6 +927,7 @@ int EventLoop::register_timer(Object& object, int milliseconds, bool should_relo
     timer->fire_when_not_visible = fire_when_not_visible;
     int timer_id = s_id_allocator->allocate();
     timer->timer_id = timer_id;
+    add_timer_to_queue(*timer);
     s_timers->set(timer_id, move(timer));
     return timer_id;
 }
@@ -753,18 +938,83 @@ bool EventLoop::unregister_timer(int timer_id)
     auto it = s_timers->find(timer_id);
     if (it == s_timers->end())
         return false;
+    auto& timer = *it->value;
+    if (timer.queue_index >= 0)
+        remove_timer_from_queue(timer);
+    else
+        s_timers_waiting_for_visibility->remove_first_matching([&](auto* entry) { return entry == &timer; });
     s_timers->remove(it);
     return true;
 }
 
+#ifdef __serenity__
+static void update_event_poll_watch(int fd)
+{
+    if (s_event_poll_fd < 0)
+        return;
+
+    auto& watch = s_event_poll_watches->ensure(fd);
+    u32 events = 0;
+    for (auto* notifier : watch.notifiers) {
+        if (notifier->event_mask() & Notifier::Read)
+            events |= POLLIN;
+        if (notifier->event_mask() & Notifier::Write)
+            events |= POLLOUT;
+        if (notifier->event_mask() & Notifier::Exceptional)
+            VERIFY_NOT_REACHED();
+    }
+
+    if (events != watch.events) {
+        int operation = EVENT_POLL_CTL_MOD;
+        if (watch.events == 0)
+            operation = EVENT_POLL_CTL_ADD;
+        else if (events == 0)
+            operation = EVENT_POLL_CTL_DEL;
+
+        event_poll_event event { events, 0, static_cast<u64>(fd) };
+        int rc = event_poll_ctl(s_event_poll_fd, operation, fd, &event);
+        // If the file descriptor was closed and reused without the notifiers finding out, it has to be added anew.
+        if (rc < 0 && errno == ENOENT && operation == EVENT_POLL_CTL_MOD)
+            rc = event_poll_ctl(s_event_poll_fd, EVENT_POLL_CTL_ADD, fd, &event);
+        if (rc < 0)
+            dbgln("Core::EventLoop: Failed to update the event poll watch for fd {}: {}", fd, strerror(errno));
+        else
+            watch.events = events;
+    }
+
+    if (watch.notifiers.is_empty())
+        s_event_poll_watches->remove(fd);
+}
+#endif
+
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->set(&notifier);
+    if (s_notifiers->set(&notifier) != AK::HashSetResult::InsertedNewEntry)
+        return;
+#ifdef __serenity__
+    s_event_poll_watches->ensure(notifier.fd()).notifiers.append(&notifier);
+    update_event_poll_watch(notifier.fd());
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->remove(&notifier);
+    if (!s_notifiers->remove(&notifier))
+        return;
+#ifdef __serenity__
+    if (auto it = s_event_poll_watches->find(notifier.fd()); it != s_event_poll_watches->end())
+        it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+    update_event_poll_watch(notifier.fd());
+#endif
+}
+
+void EventLoop::update_notifier(Badge<Notifier>, [[maybe_unused]] Notifier& notifier)
+{
+    if (!s_notifiers->contains(&notifier))
+        return;
+#ifdef __serenity__
+    update_event_poll_watch(notifier.fd());
+#endif
 }
 
 void EventLoop::wake()
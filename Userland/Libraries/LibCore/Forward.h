@@ -29,6 +29,7 @@ class Notifier;
 class Object;
 class ObjectClassRegistration;
 class ProcessStatisticsReader;
+class Resolver;
 class Socket;
 class SocketAddress;
 class TCPServer;
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/MemoryPressure.h>
+#include <LibCore/Notifier.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Core {
+
+static MemoryPressureLevel s_level { MemoryPressureLevel::None };
+static RefPtr<Notifier> s_notifier;
+
+static Vector<Function<void(MemoryPressureLevel)>>& handlers()
+{
+    static Vector<Function<void(MemoryPressureLevel)>> s_handlers;
+    return s_handlers;
+}
+
+void MemoryPressure::initialize(Badge<EventLoop>)
+{
+#ifdef __serenity__
+    // This is done while the main event loop is created, as most programs haven't given up their rpath promise or
+    // unveiled anything yet at that point. Those that have just never hear about memory pressure.
+    int fd = open("/dev/mempressure", O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    s_notifier = Notifier::construct(fd, Notifier::Read);
+    s_notifier->on_ready_to_read = [fd] {
+        u8 level;
+        if (read(fd, &level, sizeof(level)) != sizeof(level) || level == to_underlying(s_level))
+            return;
+        s_level = static_cast<MemoryPressureLevel>(level);
+        for (auto& handler : handlers())
+            handler(s_level);
+    };
+#endif
+}
+
+MemoryPressureLevel MemoryPressure::level()
+{
+    return s_level;
+}
+
+void MemoryPressure::add_handler(Function<void(MemoryPressureLevel)> handler)
+{
+    handlers().append(move(handler));
+}
+
+}
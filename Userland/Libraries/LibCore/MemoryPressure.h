@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/Function.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <LibCore/Forward.h>
+
+namespace Core {
+
+// Lets caches know when the kernel is running low on memory, so that they can give some of it back before allocations
+// start to stall. The handlers are called from the main event loop.
+class MemoryPressure {
+public:
+    static void initialize(Badge<EventLoop>);
+
+    static MemoryPressureLevel level();
+
+    // Called whenever the level changes, including when the pressure goes away again.
+    static void add_handler(Function<void(MemoryPressureLevel)>);
+};
+
+}
@@ -5,28 +5,74 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
+#include <string.h>
 
 namespace Core {
 
 HashMap<uid_t, String> ProcessStatisticsReader::s_usernames;
 
+namespace {
+
+// Walks through /proc/all_binary, keeping in mind that the records may be larger or smaller than the ones we know about.
+class RecordReader {
+public:
+    explicit RecordReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    bool has_failed() const { return m_has_failed; }
+
+    template<typename T>
+    T read_record(size_t record_size)
+    {
+        T record {};
+        if (!has_remaining(record_size))
+            return record;
+        memcpy(&record, m_bytes.offset_pointer(m_offset), min(record_size, sizeof(T)));
+        m_offset += record_size;
+        return record;
+    }
+
+    String read_string(size_t length)
+    {
+        if (!has_remaining(length))
+            return {};
+        auto string = String(StringView(m_bytes.offset_pointer(m_offset), length));
+        m_offset += length;
+        return string;
+    }
+
+private:
+    bool has_remaining(size_t size)
+    {
+        if (m_has_failed || size > m_bytes.size() - m_offset)
+            m_has_failed = true;
+        return !m_has_failed;
+    }
+
+    ReadonlyBytes m_bytes;
+    size_t m_offset { 0 };
+    bool m_has_failed { false };
+};
+
+}
+
 Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::File>& proc_all_file)
 {
     if (proc_all_file) {
         if (!proc_all_file->seek(0, Core::SeekMode::SetPosition)) {
-            warnln("ProcessStatisticsReader: Failed to refresh /proc/all: {}", proc_all_file->error_string());
+            warnln("ProcessStatisticsReader: Failed to refresh /proc/all_binary: {}", proc_all_file->error_string());
             return {};
         }
     } else {
-        proc_all_file = Core::File::construct("/proc/all");
+        proc_all_file = Core::File::construct("/proc/all_binary");
         if (!proc_all_file->open(Core::OpenMode::ReadOnly)) {
-            warnln("ProcessStatisticsReader: Failed to open /proc/all: {}", proc_all_file->error_string());
+            warnln("ProcessStatisticsReader: Failed to open /proc/all_binary: {}", proc_all_file->error_string());
             return {};
         }
     }
@@ -34,71 +80,87 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
     AllProcessesStatistics all_processes_statistics;
 
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (!json.has_value())
+    if (file_contents.size() < sizeof(u32) * 2)
+        return {};
+
+    u32 version;
+    u32 header_size;
+    memcpy(&version, file_contents.data(), sizeof(version));
+    memcpy(&header_size, file_contents.data() + sizeof(version), sizeof(header_size));
+    if (version != PROCESS_STATISTICS_VERSION) {
+        warnln("ProcessStatisticsReader: Unsupported /proc/all_binary version {}", version);
         return {};
+    }
 
-    auto& json_obj = json.value().as_object();
-    json_obj.get("processes").as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
+    RecordReader reader(file_contents.bytes());
+    auto header = reader.read_record<ProcessStatisticsHeader>(header_size);
+    all_processes_statistics.processes.ensure_capacity(header.process_count);
+    for (u32 i = 0; i < header.process_count && !reader.has_failed(); ++i) {
+        auto process_record = reader.read_record<ProcessStatisticsRecord>(header.process_record_size);
         Core::ProcessStatistics process;
 
         // kernel data first
-        process.pid = process_object.get("pid").to_u32();
-        process.pgid = process_object.get("pgid").to_u32();
-        process.pgp = process_object.get("pgp").to_u32();
-        process.sid = process_object.get("sid").to_u32();
-        process.uid = process_object.get("uid").to_u32();
-        process.gid = process_object.get("gid").to_u32();
-        process.ppid = process_object.get("ppid").to_u32();
-        process.nfds = process_object.get("nfds").to_u32();
-        process.kernel = process_object.get("kernel").to_bool();
-        process.name = process_object.get("name").to_string();
-        process.executable = process_object.get("executable").to_string();
-        process.tty = process_object.get("tty").to_string();
-        process.pledge = process_object.get("pledge").to_string();
-        process.veil = process_object.get("veil").to_string();
-        process.amount_virtual = process_object.get("amount_virtual").to_u32();
-        process.amount_resident = process_object.get("amount_resident").to_u32();
-        process.amount_shared = process_object.get("amount_shared").to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private").to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode").to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile").to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile").to_u32();
-
-        auto& thread_array = process_object.get_ptr("threads")->as_array();
-        process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
+        process.pid = process_record.pid;
+        process.pgid = process_record.pgid;
+        process.pgp = process_record.pgp;
+        process.sid = process_record.sid;
+        process.uid = process_record.uid;
+        process.gid = process_record.gid;
+        process.ppid = process_record.ppid;
+        process.nfds = process_record.nfds;
+        process.kernel = process_record.kernel;
+        process.name = reader.read_string(process_record.name_length);
+        process.executable = reader.read_string(process_record.executable_length);
+        process.tty = reader.read_string(process_record.tty_length);
+        process.pledge = reader.read_string(process_record.pledge_length);
+        process.veil = reader.read_string(process_record.veil_length);
+        process.amount_virtual = process_record.amount_virtual;
+        process.amount_resident = process_record.amount_resident;
+        process.amount_shared = process_record.amount_shared;
+        process.amount_dirty_private = process_record.amount_dirty_private;
+        process.amount_clean_inode = process_record.amount_clean_inode;
+        process.amount_purgeable_volatile = process_record.amount_purgeable_volatile;
+        process.amount_purgeable_nonvolatile = process_record.amount_purgeable_nonvolatile;
+        process.big_lock_wait_time_ns = process_record.big_lock_wait_time_ns;
+        process.big_lock_contention_count = process_record.big_lock_contention_count;
+
+        process.threads.ensure_capacity(process_record.thread_count);
+        for (u32 j = 0; j < process_record.thread_count && !reader.has_failed(); ++j) {
+            auto thread_record = reader.read_record<ThreadStatisticsRecord>(header.thread_record_size);
             Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid").to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled").to_u32();
-            thread.name = thread_object.get("name").to_string();
-            thread.state = thread_object.get("state").to_string();
-            thread.time_user = thread_object.get("time_user").to_u64();
-            thread.time_kernel = thread_object.get("time_kernel").to_u64();
-            thread.cpu = thread_object.get("cpu").to_u32();
-            thread.priority = thread_object.get("priority").to_u32();
-            thread.syscall_count = thread_object.get("syscall_count").to_u32();
-            thread.inode_faults = thread_object.get("inode_faults").to_u32();
-            thread.zero_faults = thread_object.get("zero_faults").to_u32();
-            thread.cow_faults = thread_object.get("cow_faults").to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes").to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes").to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes").to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes").to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes").to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes").to_u32();
+            thread.tid = thread_record.tid;
+            thread.times_scheduled = thread_record.times_scheduled;
+            thread.name = reader.read_string(thread_record.name_length);
+            thread.state = reader.read_string(thread_record.state_length);
+            thread.time_user = thread_record.time_user;
+            thread.time_kernel = thread_record.time_kernel;
+            thread.cpu = thread_record.cpu;
+            thread.priority = thread_record.priority;
+            thread.syscall_count = thread_record.syscall_count;
+            thread.inode_faults = thread_record.inode_faults;
+            thread.zero_faults = thread_record.zero_faults;
+            thread.cow_faults = thread_record.cow_faults;
+            thread.unix_socket_read_bytes = thread_record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = thread_record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = thread_record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = thread_record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = thread_record.file_read_bytes;
+            thread.file_write_bytes = thread_record.file_write_bytes;
             process.threads.append(move(thread));
-        });
+        }
 
         // and synthetic data last
         process.username = username_from_uid(process.uid);
         all_processes_statistics.processes.append(move(process));
-    });
+    }
+
+    if (reader.has_failed()) {
+        warnln("ProcessStatisticsReader: /proc/all_binary is truncated");
+        return {};
+    }
 
-    all_processes_statistics.total_time_scheduled = json_obj.get("total_time").to_u64();
-    all_processes_statistics.total_time_scheduled_kernel = json_obj.get("total_time_kernel").to_u64();
+    all_processes_statistics.total_time_scheduled = header.total_time;
+    all_processes_statistics.total_time_scheduled_kernel = header.total_time_kernel;
     return all_processes_statistics;
 }
 
@@ -34,7 +34,7 @@ struct ThreadStatistics {
 };
 
 struct ProcessStatistics {
-    // Keep this in sync with /proc/all.
+    // Keep this in sync with /proc/all and /proc/all_binary.
     // From the kernel side:
     pid_t pid;
     pid_t pgid;
@@ -57,6 +57,8 @@ struct ProcessStatistics {
     size_t amount_clean_inode;
     size_t amount_purgeable_volatile;
     size_t amount_purgeable_nonvolatile;
+    u64 big_lock_wait_time_ns;
+    u64 big_lock_contention_count;
 
     Vector<Core::ThreadStatistics> threads;
 
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/MemoryStream.h>
+#include <LibCore/Resolver.h>
+#include <errno.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+namespace Core {
+
+// NOTE: LibIPC is built on top of LibCore, so we can't use the generated endpoints and have to speak the
+//       protocol ourselves (like LibC does). These have to match LookupServer.ipc and LookupClient.ipc.
+static constexpr u32 lookup_server_endpoint_magic = 9001;
+static constexpr i32 start_lookup_name_message_id = 5;
+static constexpr u32 lookup_client_endpoint_magic = 9002;
+static constexpr i32 lookup_name_finished_message_id = 1;
+
+Resolver& Resolver::the()
+{
+    static Resolver* s_the = &Resolver::construct().leak_ref();
+    return *s_the;
+}
+
+Resolver::Resolver(Object* parent)
+    : Object(parent)
+{
+}
+
+Optional<IPv4Address> Resolver::resolve_without_waiting(String const& hostname)
+{
+    if (auto address = IPv4Address::from_string(hostname); address.has_value())
+        return address;
+
+    auto it = m_cache.find(hostname);
+    if (it == m_cache.end())
+        return {};
+    if (time(nullptr) >= it->value.expiration_time) {
+        m_cache.remove(it);
+        return {};
+    }
+    return it->value.address;
+}
+
+void Resolver::resolve(String const& hostname, Function<void(Optional<IPv4Address>)> callback)
+{
+    auto finish_later = [&](Optional<IPv4Address> address) {
+        deferred_invoke([callback = move(callback), address](auto&) {
+            callback(address);
+        });
+    };
+
+    if (auto address = resolve_without_waiting(hostname); address.has_value()) {
+        finish_later(address);
+        return;
+    }
+
+    for (auto& it : m_pending_requests) {
+        if (it.value.hostname.equals_ignoring_case(hostname)) {
+            it.value.callbacks.append(move(callback));
+            return;
+        }
+    }
+
+    if (!ensure_connected()) {
+        // There's no LookupServer to ask (like on Lagom), so let's hope that the system's resolver is quick.
+        auto* hostent = gethostbyname(hostname.characters());
+        if (!hostent || hostent->h_addrtype != AF_INET) {
+            finish_later({});
+            return;
+        }
+        finish_later(IPv4Address(reinterpret_cast<u8 const*>(hostent->h_addr_list[0])));
+        return;
+    }
+
+    auto request_id = m_next_request_id++;
+    if (!send_request(request_id, hostname)) {
+        disconnect();
+        finish_later({});
+        return;
+    }
+    PendingRequest request { hostname, {} };
+    request.callbacks.append(move(callback));
+    m_pending_requests.set(request_id, move(request));
+}
+
+bool Resolver::ensure_connected()
+{
+    if (m_socket)
+        return true;
+    auto socket = LocalSocket::construct(this);
+    if (!socket->connect(SocketAddress::local("/tmp/portal/lookup"))) {
+        remove_child(*socket);
+        return false;
+    }
+    socket->on_ready_to_read = [this] { receive_responses(); };
+    m_socket = move(socket);
+    return true;
+}
+
+void Resolver::disconnect()
+{
+    if (!m_socket)
+        return;
+    m_socket->on_ready_to_read = nullptr;
+    m_socket->close();
+    remove_child(*m_socket);
+    m_socket = nullptr;
+    m_received_data.clear();
+
+    // Whatever we were still waiting for isn't coming anymore.
+    auto pending_requests = move(m_pending_requests);
+    for (auto& it : pending_requests) {
+        for (auto& callback : it.value.callbacks)
+            callback({});
+    }
+}
+
+bool Resolver::send_request(i32 request_id, String const& hostname)
+{
+    struct [[gnu::packed]] {
+        u32 message_size;
+        u32 endpoint_magic;
+        i32 message_id;
+        i32 request_id;
+        i32 hostname_length;
+    } header = {
+        (u32)(sizeof(header) - sizeof(header.message_size) + hostname.length()),
+        lookup_server_endpoint_magic,
+        start_lookup_name_message_id,
+        request_id,
+        (i32)hostname.length(),
+    };
+    auto message = ByteBuffer::copy(&header, sizeof(header));
+    message.append(hostname.characters(), hostname.length());
+    return m_socket->send(message);
+}
+
+void Resolver::receive_responses()
+{
+    u8 buffer[4096];
+    for (;;) {
+        auto nread = recv(m_socket->fd(), buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (nread < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
+                break;
+            perror("Resolver: recv");
+            disconnect();
+            return;
+        }
+        if (nread == 0) {
+            dbgln("Resolver: LookupServer went away");
+            disconnect();
+            return;
+        }
+        m_received_data.append(buffer, nread);
+    }
+
+    size_t offset = 0;
+    while (m_received_data.size() - offset >= sizeof(u32)) {
+        u32 message_size = *reinterpret_cast<u32 const*>(m_received_data.data() + offset);
+        if (m_received_data.size() - offset - sizeof(u32) < message_size)
+            break;
+        if (!handle_response(m_received_data.bytes().slice(offset + sizeof(u32), message_size))) {
+            dbgln("Resolver: Got a message from LookupServer that we don't understand");
+            disconnect();
+            return;
+        }
+        // The callbacks may have done anything, including disconnecting.
+        if (!m_socket)
+            return;
+        offset += sizeof(u32) + message_size;
+    }
+    m_received_data = ByteBuffer::copy(m_received_data.bytes().slice(offset));
+}
+
+bool Resolver::handle_response(ReadonlyBytes message)
+{
+    InputMemoryStream stream { message };
+    u32 endpoint_magic;
+    i32 message_id;
+    i32 request_id;
+    i32 code;
+    u64 address_count;
+    stream >> endpoint_magic >> message_id >> request_id >> code >> address_count;
+    if (stream.handle_any_error() || endpoint_magic != lookup_client_endpoint_magic || message_id != lookup_name_finished_message_id)
+        return false;
+
+    Optional<IPv4Address> address;
+    for (u64 i = 0; i < address_count; ++i) {
+        i32 length;
+        stream >> length;
+        if (stream.handle_any_error() || length < 0 || (size_t)length > stream.remaining())
+            return false;
+        if (length == sizeof(IPv4Address) && !address.has_value()) {
+            u8 raw_address[sizeof(IPv4Address)];
+            stream >> Bytes { raw_address, sizeof(raw_address) };
+            address = IPv4Address(raw_address);
+        } else {
+            stream.discard_or_error(length);
+        }
+    }
+
+    u32 ttl;
+    stream >> ttl;
+    if (stream.handle_any_error())
+        return false;
+
+    auto it = m_pending_requests.find(request_id);
+    if (it == m_pending_requests.end())
+        return true;
+    if (code == 0 && address.has_value())
+        put_in_cache(it->value.hostname, address.value(), ttl);
+    finish_request(request_id, code == 0 ? address : Optional<IPv4Address> {});
+    return true;
+}
+
+void Resolver::finish_request(i32 request_id, Optional<IPv4Address> address)
+{
+    auto it = m_pending_requests.find(request_id);
+    VERIFY(it != m_pending_requests.end());
+    auto request = move(it->value);
+    m_pending_requests.remove(it);
+    if (address.has_value())
+        dbgln_if(CSOCKET_DEBUG, "Resolver: Resolved '{}' to {}", request.hostname, address.value());
+    else
+        dbgln_if(CSOCKET_DEBUG, "Resolver: Unable to resolve '{}'", request.hostname);
+    for (auto& callback : request.callbacks)
+        callback(address);
+}
+
+void Resolver::put_in_cache(String const& hostname, IPv4Address address, u32 ttl)
+{
+    if (ttl == 0)
+        return;
+
+    auto now = time(nullptr);
+    if (m_cache.size() >= MaxCacheSize) {
+        Vector<String> expired_hostnames;
+        for (auto& it : m_cache) {
+            if (now >= it.value.expiration_time)
+                expired_hostnames.append(it.key);
+        }
+        for (auto& expired_hostname : expired_hostnames)
+            m_cache.remove(expired_hostname);
+        // Everything is still good, so something has to go anyway.
+        if (m_cache.size() >= MaxCacheSize)
+            m_cache.remove(m_cache.begin());
+    }
+    m_cache.set(hostname, { address, now + ttl });
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/IPv4Address.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/LocalSocket.h>
+#include <LibCore/Object.h>
+#include <time.h>
+
+namespace Core {
+
+// Resolves hostnames through LookupServer without blocking the event loop. Lookups all go over one connection
+// that is kept open, and several of them can be on their way at once. Addresses are remembered for as long as
+// LookupServer says they are good for.
+class Resolver final : public Object {
+    C_OBJECT(Resolver);
+
+public:
+    static constexpr size_t MaxCacheSize = 128;
+
+    static Resolver& the();
+
+    // Calls the callback from the event loop, with nothing if the hostname couldn't be resolved.
+    void resolve(String const& hostname, Function<void(Optional<IPv4Address>)> callback);
+
+    // Only answers for addresses and for hostnames that were resolved recently, but does so right away.
+    Optional<IPv4Address> resolve_without_waiting(String const& hostname);
+
+private:
+    struct PendingRequest {
+        String hostname;
+        Vector<Function<void(Optional<IPv4Address>)>> callbacks;
+    };
+
+    struct CacheEntry {
+        IPv4Address address;
+        time_t expiration_time { 0 };
+    };
+
+    explicit Resolver(Object* parent = nullptr);
+
+    bool ensure_connected();
+    void disconnect();
+    bool send_request(i32 request_id, String const& hostname);
+    void receive_responses();
+    bool handle_response(ReadonlyBytes);
+    void finish_request(i32 request_id, Optional<IPv4Address>);
+    void put_in_cache(String const& hostname, IPv4Address, u32 ttl);
+
+    RefPtr<LocalSocket> m_socket;
+    ByteBuffer m_received_data;
+    i32 m_next_request_id { 1 };
+    HashMap<i32, PendingRequest> m_pending_requests;
+    HashMap<String, CacheEntry, CaseInsensitiveStringTraits> m_cache;
+};
+
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/SharedRingBuffer.h>
+#include <string.h>
+
+namespace Core {
+
+static bool is_power_of_two(size_t value)
+{
+    return value && (value & (value - 1)) == 0;
+}
+
+Optional<SharedRingBuffer> SharedRingBuffer::create(size_t capacity)
+{
+    VERIFY(is_power_of_two(capacity));
+    auto buffer = AnonymousBuffer::create_with_size(sizeof(Header) + capacity);
+    if (!buffer.is_valid())
+        return {};
+    // The buffer starts out zeroed, which is where both offsets start. Nobody has read anything yet though,
+    // so the first write has to wake the reader.
+    SharedRingBuffer ring_buffer(move(buffer), capacity);
+    ring_buffer.header().reader_is_sleeping = true;
+    return ring_buffer;
+}
+
+Optional<SharedRingBuffer> SharedRingBuffer::attach(AnonymousBuffer buffer)
+{
+    if (!buffer.is_valid() || buffer.size() <= sizeof(Header))
+        return {};
+    size_t capacity = buffer.size() - sizeof(Header);
+    if (!is_power_of_two(capacity) || capacity > NumericLimits<u32>::max() / 2)
+        return {};
+    return SharedRingBuffer(move(buffer), capacity);
+}
+
+SharedRingBuffer::SharedRingBuffer(AnonymousBuffer buffer, size_t capacity)
+    : m_buffer(move(buffer))
+    , m_capacity(capacity)
+{
+}
+
+size_t SharedRingBuffer::size() const
+{
+    auto& header = this->header();
+    u32 used = header.write_offset.load(AK::MemoryOrder::memory_order_acquire) - header.read_offset.load(AK::MemoryOrder::memory_order_acquire);
+    return min<size_t>(used, m_capacity);
+}
+
+size_t SharedRingBuffer::write(ReadonlyBytes bytes)
+{
+    auto& header = this->header();
+    u32 write_offset = header.write_offset.load(AK::MemoryOrder::memory_order_relaxed);
+    u32 used = write_offset - header.read_offset.load(AK::MemoryOrder::memory_order_acquire);
+    // The other process may not play by the rules, but that mustn't make us write out of bounds.
+    if (used > m_capacity)
+        return 0;
+
+    size_t size = min(bytes.size(), m_capacity - used);
+    size_t start = write_offset & (m_capacity - 1);
+    size_t size_until_end = min(size, m_capacity - start);
+    memcpy(data() + start, bytes.data(), size_until_end);
+    memcpy(data(), bytes.data() + size_until_end, size - size_until_end);
+
+    // This has to be sequentially consistent with the read in should_wake_reader(), see prepare_to_sleep().
+    header.write_offset.store(write_offset + size);
+    return size;
+}
+
+bool SharedRingBuffer::should_wake_reader()
+{
+    return header().reader_is_sleeping.exchange(false);
+}
+
+bool SharedRingBuffer::prepare_to_wait_for_room()
+{
+    // This mirrors prepare_to_sleep(), with consume() and should_wake_writer() on the other side.
+    auto& header = this->header();
+    header.writer_is_waiting.store(true);
+    if (header.write_offset.load(AK::MemoryOrder::memory_order_relaxed) - header.read_offset.load() >= m_capacity)
+        return true;
+    header.writer_is_waiting.store(false, AK::MemoryOrder::memory_order_relaxed);
+    return false;
+}
+
+ReadonlyBytes SharedRingBuffer::peek() const
+{
+    auto& header = this->header();
+    u32 read_offset = header.read_offset.load(AK::MemoryOrder::memory_order_relaxed);
+    u32 available = header.write_offset.load(AK::MemoryOrder::memory_order_acquire) - read_offset;
+    if (available > m_capacity)
+        return {};
+    size_t start = read_offset & (m_capacity - 1);
+    return { data() + start, min<size_t>(available, m_capacity - start) };
+}
+
+void SharedRingBuffer::consume(size_t size)
+{
+    auto& header = this->header();
+    u32 read_offset = header.read_offset.load(AK::MemoryOrder::memory_order_relaxed);
+    VERIFY(size <= header.write_offset.load(AK::MemoryOrder::memory_order_acquire) - read_offset);
+    // This has to be sequentially consistent with the read in should_wake_writer(), see prepare_to_wait_for_room().
+    header.read_offset.store(read_offset + size);
+}
+
+bool SharedRingBuffer::prepare_to_sleep()
+{
+    // Either the writer sees that we're asleep after its write and wakes us up, or we see its write here.
+    // Otherwise, we'd both think that the other one will take care of it.
+    auto& header = this->header();
+    header.reader_is_sleeping.store(true);
+    if (header.write_offset.load() == header.read_offset.load(AK::MemoryOrder::memory_order_relaxed))
+        return true;
+    header.reader_is_sleeping.store(false, AK::MemoryOrder::memory_order_relaxed);
+    return false;
+}
+
+bool SharedRingBuffer::should_wake_writer()
+{
+    return header().writer_is_waiting.exchange(false);
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <LibCore/AnonymousBuffer.h>
+
+namespace Core {
+
+// A queue of bytes in memory that is shared between two processes, one of which writes while the other reads.
+// Neither side ever blocks: the writer learns how much fit, and the reader how much is there. Once the reader
+// runs out of data it goes to sleep on some other channel (like a pipe), which the writer only has to poke when
+// should_wake_reader() says so, so that a busy stream doesn't cost a syscall for every write. The same goes the other
+// way round for a writer that is waiting for room, see prepare_to_wait_for_room().
+class SharedRingBuffer {
+public:
+    // The capacity has to be a power of two.
+    static Optional<SharedRingBuffer> create(size_t capacity);
+    // Sets up the other side of a ring buffer that was sent over from another process.
+    static Optional<SharedRingBuffer> attach(AnonymousBuffer);
+
+    const AnonymousBuffer& anonymous_buffer() const { return m_buffer; }
+    size_t capacity() const { return m_capacity; }
+    // How many bytes have been written but not consumed yet.
+    size_t size() const;
+
+    // Writer side: Copies in as much as there is room for, and returns how much that was.
+    size_t write(ReadonlyBytes);
+    // Whether the reader has gone to sleep since it was last woken up.
+    bool should_wake_reader();
+    // Lets the reader know that we'd like to be woken up once it has made room, unless there already is some.
+    // Returns whether it's fine to wait now.
+    bool prepare_to_wait_for_room();
+
+    // Reader side: The next bytes to read, which stay put until they're consumed. When the data wraps
+    // around the end of the buffer, this is only the part up to the end.
+    ReadonlyBytes peek() const;
+    void consume(size_t);
+    // Lets the writer know that we'd like to be woken up for more data, unless there already is some.
+    // Returns whether it's fine to go to sleep now.
+    bool prepare_to_sleep();
+    // Whether the writer has started waiting for room since it was last woken up.
+    bool should_wake_writer();
+
+private:
+    struct Header {
+        // Both only ever grow (wrapping around), and the amount of data in the buffer is the difference.
+        // They're updated from different processes, so keep them apart.
+        alignas(64) Atomic<u32> write_offset;
+        alignas(64) Atomic<u32> read_offset;
+        Atomic<bool> reader_is_sleeping;
+        Atomic<bool> writer_is_waiting;
+    };
+
+    SharedRingBuffer(AnonymousBuffer, size_t capacity);
+
+    Header& header() { return *reinterpret_cast<Header*>(m_buffer.data<u8>()); }
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_buffer.data<u8>()); }
+    u8* data() { return m_buffer.data<u8>() + sizeof(Header); }
+    const u8* data() const { return m_buffer.data<u8>() + sizeof(Header); }
+
+    AnonymousBuffer m_buffer;
+    size_t m_capacity { 0 };
+};
+
+}
@@ -7,7 +7,9 @@
 #include <AK/ByteBuffer.h>
 #include <AK/ByteReader.h>
 #include <AK/Debug.h>
+#include <AK/WeakPtr.h>
 #include <LibCore/Notifier.h>
+#include <LibCore/Resolver.h>
 #include <LibCore/Socket.h>
 #include <arpa/inet.h>
 #include <errno.h>
@@ -53,6 +55,26 @@ Socket::~Socket()
 
 bool Socket::connect(const String& hostname, int port)
 {
+    auto& resolver = Resolver::the();
+    if (auto address = resolver.resolve_without_waiting(hostname); address.has_value()) {
+        dbgln_if(CSOCKET_DEBUG, "Socket::connect: Resolved '{}' to {} without waiting", hostname, address.value());
+        return connect(address.value(), port);
+    }
+
+    if (on_connection_failed) {
+        resolver.resolve(hostname, [this, weak_this = make_weak_ptr(), hostname, port](Optional<IPv4Address> address) {
+            if (!weak_this)
+                return;
+            if (!address.has_value())
+                dbgln("Socket::connect: Unable to resolve '{}'", hostname);
+            if (!address.has_value() || !connect(address.value(), port)) {
+                if (on_connection_failed)
+                    on_connection_failed();
+            }
+        });
+        return true;
+    }
+
     auto* hostent = gethostbyname(hostname.characters());
     if (!hostent) {
         dbgln("Socket::connect: Unable to resolve '{}'", hostname);
@@ -138,7 +160,18 @@ bool Socket::common_connect(const struct sockaddr* addr, socklen_t addrlen)
         if (errno == EINPROGRESS) {
             dbgln_if(CSOCKET_DEBUG, "{} connection in progress (EINPROGRESS)", *this);
             m_notifier = Notifier::construct(fd(), Notifier::Event::Write, this);
-            m_notifier->on_ready_to_write = move(connected);
+            m_notifier->on_ready_to_write = [this, connected = move(connected)] {
+                int error = 0;
+                socklen_t error_size = sizeof(error);
+                if (on_connection_failed && getsockopt(fd(), SOL_SOCKET, SO_ERROR, &error, &error_size) == 0 && error != 0) {
+                    dbgln_if(CSOCKET_DEBUG, "{} failed to connect: {}", *this, strerror(error));
+                    m_notifier->remove_from_parent();
+                    m_notifier = nullptr;
+                    on_connection_failed();
+                    return;
+                }
+                connected();
+            };
             return true;
         }
         int saved_errno = errno;
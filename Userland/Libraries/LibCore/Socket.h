@@ -44,6 +44,9 @@ public:
 
     Function<void()> on_connected;
     Function<void()> on_ready_to_read;
+    // Called when connecting fails after connect() has already returned, like when the hostname doesn't resolve.
+    // As there's a way to report that, setting this also lets connect() look up hostnames without blocking.
+    Function<void()> on_connection_failed;
 
 protected:
     Socket(Type, Object* parent);
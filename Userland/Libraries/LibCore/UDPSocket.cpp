@@ -7,6 +7,7 @@
 #include <LibCore/UDPSocket.h>
 #include <errno.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #ifndef SOCK_NONBLOCK
 #    include <sys/ioctl.h>
@@ -38,4 +39,83 @@ UDPSocket::~UDPSocket()
 {
 }
 
+#if defined(__serenity__) || defined(__linux__)
+static constexpr size_t max_datagrams_per_call = 64;
+#endif
+
+Optional<size_t> UDPSocket::send_datagrams(Span<const ReadonlyBytes> datagrams)
+{
+    size_t sent_count = 0;
+    while (sent_count < datagrams.size()) {
+#if defined(__serenity__) || defined(__linux__)
+        auto batch = datagrams.slice(sent_count, min(datagrams.size() - sent_count, max_datagrams_per_call));
+        iovec iovs[max_datagrams_per_call];
+        mmsghdr messages[max_datagrams_per_call];
+        for (size_t i = 0; i < batch.size(); ++i) {
+            iovs[i] = { const_cast<u8*>(batch[i].data()), batch[i].size() };
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &iovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int rc = sendmmsg(fd(), messages, batch.size(), 0);
+#else
+        auto& datagram = datagrams[sent_count];
+        int rc = ::send(fd(), datagram.data(), datagram.size(), 0) < 0 ? -1 : 1;
+#endif
+        if (rc < 0) {
+            if (sent_count > 0 && errno == EAGAIN)
+                break;
+            set_error(errno);
+            return {};
+        }
+        sent_count += rc;
+#if defined(__serenity__) || defined(__linux__)
+        if (static_cast<size_t>(rc) < batch.size())
+            break;
+#endif
+    }
+    return sent_count;
+}
+
+Optional<size_t> UDPSocket::receive_datagrams(Span<Bytes> buffers)
+{
+    size_t received_count = 0;
+    while (received_count < buffers.size()) {
+        // Don't wait for more datagrams once some have been received.
+        int flags = received_count > 0 ? MSG_DONTWAIT : 0;
+#if defined(__serenity__) || defined(__linux__)
+        auto batch = buffers.slice(received_count, min(buffers.size() - received_count, max_datagrams_per_call));
+        iovec iovs[max_datagrams_per_call];
+        mmsghdr messages[max_datagrams_per_call];
+        for (size_t i = 0; i < batch.size(); ++i) {
+            iovs[i] = { batch[i].data(), batch[i].size() };
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &iovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int rc = recvmmsg(fd(), messages, batch.size(), flags, nullptr);
+        for (int i = 0; i < rc; ++i)
+            batch[i] = batch[i].trim(min<size_t>(messages[i].msg_len, batch[i].size()));
+#else
+        auto& buffer = buffers[received_count];
+        ssize_t nreceived = ::recv(fd(), buffer.data(), buffer.size(), flags);
+        if (nreceived >= 0)
+            buffer = buffer.trim(min<size_t>(nreceived, buffer.size()));
+        int rc = nreceived < 0 ? -1 : 1;
+#endif
+        if (rc < 0) {
+            if (received_count > 0 && errno == EAGAIN)
+                break;
+            set_error(errno);
+            return {};
+        }
+        received_count += rc;
+#if defined(__serenity__) || defined(__linux__)
+        if (static_cast<size_t>(rc) < batch.size())
+            break;
+#endif
+    }
+    return received_count;
+}
+
 }
@@ -15,6 +15,14 @@ class UDPSocket final : public Socket {
 public:
     virtual ~UDPSocket() override;
 
+    // Sends each of the datagrams to the peer, using as few syscalls as possible.
+    // Returns how many of them were sent, which is only less than all of them if the socket is non-blocking.
+    Optional<size_t> send_datagrams(Span<const ReadonlyBytes>);
+
+    // Receives up to one datagram into each of the buffers, which are trimmed to the sizes of the datagrams.
+    // Only the first datagram is waited for, if the socket is blocking. Returns how many were received.
+    Optional<size_t> receive_datagrams(Span<Bytes>);
+
 private:
     explicit UDPSocket(Object* parent = nullptr);
 };
@@ -112,9 +112,20 @@ Optional<FlatPtr> Reader::peek_memory(FlatPtr address) const
     if (!region)
         return {};
 
-    FlatPtr offset_in_region = address - region->region_start;
-    const char* region_data = image().program_header(region->program_header_index).raw_data();
-    return *(const FlatPtr*)(&region_data[offset_in_region]);
+    // A region may be split up into several segments following each other, of which the ones without any data in the
+    // file were never touched by the process.
+    for (unsigned index = region->program_header_index; index < image().program_header_count(); ++index) {
+        auto segment = image().program_header(index);
+        if (segment.type() != PT_LOAD || segment.vaddr().get() > address)
+            break;
+        FlatPtr offset_in_segment = address - segment.vaddr().get();
+        if (offset_in_segment >= segment.size_in_memory())
+            continue;
+        if (offset_in_segment >= segment.size_in_image())
+            return 0;
+        return *(const FlatPtr*)(&segment.raw_data()[offset_in_segment]);
+    }
+    return {};
 }
 
 const JsonObject Reader::process_info() const
@@ -206,12 +206,26 @@ static bool is_known_type(StringView const& string)
 Vector<Token> Lexer::lex()
 {
     Vector<Token> tokens;
+    lex_iterable([&](auto token) {
+        tokens.append(move(token));
+        return IterationDecision::Continue;
+    });
+    return tokens;
+}
+
+void Lexer::lex_iterable(Function<IterationDecision(Token)> const& callback)
+{
+    bool should_stop = false;
+    auto emit = [&](Token token) {
+        if (!should_stop)
+            should_stop = callback(move(token)) == IterationDecision::Break;
+    };
 
     size_t token_start_index = 0;
     Position token_start_position;
 
     auto emit_single_char_token = [&](auto type) {
-        tokens.empend(type, m_position, m_position, m_input.substring_view(m_index, 1));
+        emit({ type, m_position, m_position, m_input.substring_view(m_index, 1) });
         consume();
     };
 
@@ -220,7 +234,7 @@ Vector<Token> Lexer::lex()
         token_start_position = m_position;
     };
     auto commit_token = [&](auto type) {
-        tokens.empend(type, token_start_position, m_previous_position, m_input.substring_view(token_start_index, m_index - token_start_index));
+        emit({ type, token_start_position, m_previous_position, m_input.substring_view(token_start_index, m_index - token_start_index) });
     };
 
     auto emit_token_equals = [&](auto type, auto equals_type) {
@@ -304,7 +318,7 @@ Vector<Token> Lexer::lex()
         return 0;
     };
 
-    while (m_index < m_input.length()) {
+    while (m_index < m_input.length() && !should_stop) {
         auto ch = peek();
         if (is_ascii_space(ch)) {
             begin_token();
@@ -769,7 +783,6 @@ Vector<Token> Lexer::lex()
         dbgln("Unimplemented token character: {}", ch);
         emit_single_char_token(Token::Type::Unknown);
     }
-    return tokens;
 }
 
 }
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "LibCpp/Token.h"
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
 #include <AK/StringView.h>
 #include <AK/Vector.h>
 
@@ -17,6 +19,8 @@ public:
     Lexer(StringView const&);
 
     Vector<Token> lex();
+    // Hands over the tokens one at a time, until the callback says to stop.
+    void lex_iterable(Function<IterationDecision(Token)> const&);
 
 private:
     char peek(size_t offset = 0) const;
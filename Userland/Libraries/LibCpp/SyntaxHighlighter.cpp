@@ -57,25 +57,22 @@ bool SyntaxHighlighter::is_navigatable(u64 token) const
 
 void SyntaxHighlighter::rehighlight(Palette const& palette)
 {
-    auto text = m_client->get_text();
-    Cpp::Lexer lexer(text);
-    auto tokens = lexer.lex();
-
-    Vector<GUI::TextDocumentSpan> spans;
-    for (auto& token : tokens) {
-        // FIXME: The +1 for the token end column is a quick hack due to not wanting to modify the lexer (which is also used by the parser). Maybe there's a better way to do this.
-        dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ {}:{} - {}:{}", token.type_as_string(), token.start().line, token.start().column, token.end().line, token.end().column + 1);
-        GUI::TextDocumentSpan span;
-        span.range.set_start({ token.start().line, token.start().column });
-        span.range.set_end({ token.end().line, token.end().column + 1 });
-        auto style = style_for_token_type(palette, token.type());
-        span.attributes.color = style.color;
-        span.attributes.bold = style.bold;
-        span.is_skippable = token.type() == Cpp::Token::Type::Whitespace;
-        span.data = static_cast<u64>(token.type());
-        spans.append(span);
-    }
-    m_client->do_set_spans(move(spans));
+    lex_changed_text([&](auto text, auto& on_span) {
+        Cpp::Lexer lexer(text);
+        lexer.lex_iterable([&](auto token) {
+            // FIXME: The +1 for the token end column is a quick hack due to not wanting to modify the lexer (which is also used by the parser). Maybe there's a better way to do this.
+            dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ {}:{} - {}:{}", token.type_as_string(), token.start().line, token.start().column, token.end().line, token.end().column + 1);
+            GUI::TextDocumentSpan span;
+            span.range.set_start({ token.start().line, token.start().column });
+            span.range.set_end({ token.end().line, token.end().column + 1 });
+            auto style = style_for_token_type(palette, token.type());
+            span.attributes.color = style.color;
+            span.attributes.bold = style.bold;
+            span.is_skippable = token.type() == Cpp::Token::Type::Whitespace;
+            span.data = static_cast<u64>(token.type());
+            return on_span(move(span));
+        });
+    });
 
     m_has_brace_buddies = false;
     highlight_matching_token_pair();
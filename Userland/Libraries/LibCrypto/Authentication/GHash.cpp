@@ -6,26 +6,122 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Debug.h>
-#include <AK/MemoryStream.h>
 #include <AK/Types.h>
-#include <AK/Vector.h>
 #include <LibCrypto/Authentication/GHash.h>
-#include <LibCrypto/BigInt/UnsignedBigInteger.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <tmmintrin.h>
+#    include <wmmintrin.h>
+#    define USE_PCLMUL 1
+#    define PCLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#else
+#    define USE_PCLMUL 0
+#endif
 
 namespace {
 
-static u32 to_u32(const u8* b)
+/// Galois Field multiplication using <x^127 + x^7 + x^2 + x + 1>, on 128-bit big-endian numbers stored low half first.
+/// This is constant-time: the bits of y only ever select through masks.
+void multiply_portable(u64 (&z)[2], const u64 (&x_in)[2], const u64 (&y)[2])
+{
+    u64 x_low = x_in[0];
+    u64 x_high = x_in[1];
+    u64 z_low = 0;
+    u64 z_high = 0;
+
+    for (ssize_t i = 127; i > -1; --i) {
+        u64 mask = 0 - ((y[i / 64] >> (i % 64)) & 1);
+        z_low ^= x_low & mask;
+        z_high ^= x_high & mask;
+
+        u64 carry = x_low & 1;
+        x_low = (x_low >> 1) | (x_high << 63);
+        x_high = (x_high >> 1) ^ (0xe100000000000000ULL & (0 - carry));
+    }
+
+    z[0] = z_low;
+    z[1] = z_high;
+}
+
+void load_block(u64 (&block)[2], const u8* bytes)
 {
-    return AK::convert_between_host_and_big_endian(ByteReader::load32(b));
+    block[1] = AK::convert_between_host_and_big_endian(ByteReader::load64(bytes));
+    block[0] = AK::convert_between_host_and_big_endian(ByteReader::load64(bytes + 8));
 }
 
-static void to_u8s(u8* b, const u32* w)
+void update_portable(u64 (&state)[2], const u64 (&key)[2], const u8* data, size_t blocks)
 {
-    for (auto i = 0; i < 4; ++i) {
-        ByteReader::store(b + i * 4, AK::convert_between_host_and_big_endian(w[i]));
+    for (size_t i = 0; i < blocks; ++i) {
+        u64 block[2];
+        load_block(block, data + i * 16);
+        state[0] ^= block[0];
+        state[1] ^= block[1];
+        multiply_portable(state, state, key);
     }
 }
 
+#if USE_PCLMUL
+// Byte-reversing a block with PSHUFB gives the same layout as our u64 pairs.
+// GHASH reflects the bits of its operands, so after the carry-less multiplication the product
+// is shifted left by one bit, and then reduced modulo the polynomial as in Intel's
+// "Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode", algorithm 5.
+
+PCLMUL_TARGET __m128i multiply_pclmul(__m128i a, __m128i b)
+{
+    auto low = _mm_clmulepi64_si128(a, b, 0x00);
+    auto middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    auto high = _mm_clmulepi64_si128(a, b, 0x11);
+    low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+    high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+    // Shift the 256-bit product <high:low> left by one.
+    auto low_carries = _mm_srli_epi32(low, 31);
+    auto high_carries = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    auto middle_carry = _mm_srli_si128(low_carries, 12);
+    high_carries = _mm_slli_si128(high_carries, 4);
+    low_carries = _mm_slli_si128(low_carries, 4);
+    low = _mm_or_si128(low, low_carries);
+    high = _mm_or_si128(_mm_or_si128(high, high_carries), middle_carry);
+
+    // Reduce.
+    auto first = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    auto first_high = _mm_srli_si128(first, 4);
+    low = _mm_xor_si128(low, _mm_slli_si128(first, 12));
+    auto second = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    second = _mm_xor_si128(second, first_high);
+    low = _mm_xor_si128(low, second);
+    return _mm_xor_si128(high, low);
+}
+
+PCLMUL_TARGET void update_pclmul(u64 (&state)[2], const u64 (&key)[2], const u8* data, size_t blocks)
+{
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    for (size_t i = 0; i < blocks; ++i) {
+        auto block = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), reverse_bytes);
+        y = multiply_pclmul(_mm_xor_si128(y, block), h);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), y);
+}
+
+const bool s_use_pclmul = Crypto::cpu_features().pclmul && Crypto::cpu_features().ssse3;
+#endif
+
+void update_blocks(u64 (&state)[2], const u64 (&key)[2], const u8* data, size_t blocks)
+{
+#if USE_PCLMUL
+    if (s_use_pclmul) {
+        update_pclmul(state, key, data, blocks);
+        return;
+    }
+#endif
+    update_portable(state, key, data, blocks);
+}
+
 }
 
 namespace Crypto {
@@ -33,93 +129,67 @@ namespace Authentication {
 
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
-    u32 tag[4] { 0, 0, 0, 0 };
-
-    auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
-        }
-
-        if (i > buf.size()) {
-            static u8 buffer[16];
-            Bytes buffer_bytes { buffer, 16 };
-            OutputMemoryStream stream { buffer_bytes };
-            stream.write(buf.slice(i - 16));
-            stream.fill_to_end(0);
-
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
-            }
-            galois_multiply(tag, m_key, tag);
-        }
-    };
-
-    transform_one(aad);
-    transform_one(cipher);
-
-    auto aad_bits = 8 * (u64)aad.size();
-    auto cipher_bits = 8 * (u64)cipher.size();
-
-    auto high = [](u64 value) -> u32 { return value >> 32; };
-    auto low = [](u64 value) -> u32 { return value & 0xffffffff; };
+    begin();
+    update(aad);
+    update(cipher);
+    return finish(aad.size(), cipher.size());
+}
 
-    if constexpr (GHASH_PROCESS_DEBUG) {
-        dbgln("AAD bits: {} : {}", high(aad_bits), low(aad_bits));
-        dbgln("Cipher bits: {} : {}", high(cipher_bits), low(cipher_bits));
-        dbgln("Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+void GHash::begin()
+{
+    m_state[0] = 0;
+    m_state[1] = 0;
+}
+
+void GHash::update(ReadonlyBytes data)
+{
+    auto full_blocks = data.size() / 16;
+    update_blocks(m_state, m_key, data.data(), full_blocks);
+
+    auto remaining = data.size() % 16;
+    if (remaining != 0) {
+        u8 buffer[16] {};
+        __builtin_memcpy(buffer, data.offset(full_blocks * 16), remaining);
+        update_blocks(m_state, m_key, buffer, 1);
     }
+}
 
-    tag[0] ^= high(aad_bits);
-    tag[1] ^= low(aad_bits);
-    tag[2] ^= high(cipher_bits);
-    tag[3] ^= low(cipher_bits);
+GHash::TagType GHash::finish(u64 aad_length, u64 cipher_length)
+{
+    auto aad_bits = 8 * aad_length;
+    auto cipher_bits = 8 * cipher_length;
 
-    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+    if constexpr (GHASH_PROCESS_DEBUG) {
+        dbgln("AAD bits: {} : {}", aad_bits >> 32, aad_bits & 0xffffffff);
+        dbgln("Cipher bits: {} : {}", cipher_bits >> 32, cipher_bits & 0xffffffff);
+        dbgln("Tag bits: {:016x} : {:016x}", m_state[1], m_state[0]);
+    }
 
-    galois_multiply(tag, m_key, tag);
+    u8 lengths[16];
+    ByteReader::store(lengths, AK::convert_between_host_and_big_endian(aad_bits));
+    ByteReader::store(lengths + 8, AK::convert_between_host_and_big_endian(cipher_bits));
+    update_blocks(m_state, m_key, lengths, 1);
 
-    TagType digest;
-    to_u8s(digest.data, tag);
+    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {:016x} : {:016x}", m_state[1], m_state[0]);
 
+    TagType digest;
+    ByteReader::store(digest.data, AK::convert_between_host_and_big_endian(m_state[1]));
+    ByteReader::store(digest.data + 8, AK::convert_between_host_and_big_endian(m_state[0]));
     return digest;
 }
 
 /// Galois Field multiplication using <x^127 + x^7 + x^2 + x + 1>.
 /// Note that x, y, and z are strictly BE.
-void galois_multiply(u32 (&z)[4], const u32 (&_x)[4], const u32 (&_y)[4])
+void galois_multiply(u32 (&z)[4], const u32 (&x)[4], const u32 (&y)[4])
 {
-    u32 x[4] { _x[0], _x[1], _x[2], _x[3] };
-    u32 y[4] { _y[0], _y[1], _y[2], _y[3] };
-    __builtin_memset(z, 0, sizeof(z));
-
-    for (ssize_t i = 127; i > -1; --i) {
-        if ((y[3 - (i / 32)] >> (i % 32)) & 1) {
-            z[0] ^= x[0];
-            z[1] ^= x[1];
-            z[2] ^= x[2];
-            z[3] ^= x[3];
-        }
-        auto a0 = x[0] & 1;
-        x[0] >>= 1;
-        auto a1 = x[1] & 1;
-        x[1] >>= 1;
-        x[1] |= a0 << 31;
-        auto a2 = x[2] & 1;
-        x[2] >>= 1;
-        x[2] |= a1 << 31;
-        auto a3 = x[3] & 1;
-        x[3] >>= 1;
-        x[3] |= a2 << 31;
-
-        if (a3)
-            x[0] ^= 0xe1000000;
-    }
+    u64 x_wide[2] { (u64)x[2] << 32 | x[3], (u64)x[0] << 32 | x[1] };
+    u64 y_wide[2] { (u64)y[2] << 32 | y[3], (u64)y[0] << 32 | y[1] };
+    u64 z_wide[2];
+    multiply_portable(z_wide, x_wide, y_wide);
+    z[0] = z_wide[1] >> 32;
+    z[1] = z_wide[1];
+    z[2] = z_wide[0] >> 32;
+    z[3] = z_wide[0];
 }
 
 }
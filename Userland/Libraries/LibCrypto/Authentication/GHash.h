@@ -37,9 +37,8 @@ public:
     explicit GHash(const ReadonlyBytes& key)
     {
         VERIFY(key.size() >= 16);
-        for (size_t i = 0; i < 16; i += 4) {
-            m_key[i / 4] = AK::convert_between_host_and_big_endian(ByteReader::load32(key.offset(i)));
-        }
+        m_key[1] = AK::convert_between_host_and_big_endian(ByteReader::load64(key.offset(0)));
+        m_key[0] = AK::convert_between_host_and_big_endian(ByteReader::load64(key.offset(8)));
     }
 
     constexpr static size_t digest_size() { return TagType::Size; }
@@ -48,10 +47,17 @@ public:
 
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
-private:
-    inline void transform(ReadonlyBytes, ReadonlyBytes);
+    // The same in pieces: begin(), update() with the AAD and then with the ciphertext, and finish().
+    // A partial block at the end of an update() is padded with zeros, so only the last piece
+    // of the AAD and of the ciphertext may have a length that isn't a multiple of 16.
+    void begin();
+    void update(ReadonlyBytes);
+    TagType finish(u64 aad_length, u64 cipher_length);
 
-    u32 m_key[4];
+private:
+    // Both are 128-bit big-endian numbers, stored low half first.
+    u64 m_key[2];
+    u64 m_state[2] { 0, 0 };
 };
 
 }
@@ -9,40 +9,130 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = UnsignedBigInteger::DoubleWord;
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N*M) where N and M are the number of words in the numerator and the denominator
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * Knuth's algorithm D (The Art of Computer Programming, Vol. 2, 4.3.1), in the form given in "Hacker's Delight".
+ * Both numbers are first shifted left until the top bit of the denominator is set. Then, from the most
+ * significant one on, each word of the quotient is estimated by dividing the top two words of what is left of the
+ * numerator by the top word of the denominator. The estimate is at most two too large, the second word of the
+ * denominator catches almost all of those cases, and the rare last one is fixed by adding the denominator back.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    UnsignedBigInteger& temp_normalized_numerator,
+    UnsignedBigInteger& temp_normalized_denominator,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+    auto numerator_size = numerator.trimmed_length();
+    auto denominator_size = denominator.trimmed_length();
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+
+    if (denominator_size == 0) {
+        quotient.invalidate();
+        remainder.invalidate();
+        return;
+    }
+
+    if (numerator_size < denominator_size) {
+        remainder.set_to(numerator);
+        remainder.clamp_to_trimmed_length();
+        return;
+    }
+
+    if (denominator_size == 1) {
+        DoubleWord denominator_word = denominator.m_words[0];
+        DoubleWord remainder_word = 0;
+        quotient.m_words.resize_and_keep_capacity(numerator_size);
+        for (size_t i = numerator_size; i-- > 0;) {
+            DoubleWord dividend = (remainder_word << bits_in_word) | numerator.m_words[i];
+            quotient.m_words[i] = static_cast<Word>(dividend / denominator_word);
+            remainder_word = dividend % denominator_word;
+        }
+        quotient.clamp_to_trimmed_length();
+        remainder.set_to(static_cast<Word>(remainder_word));
+        return;
+    }
+
+    // We shift by less than a word, the numerator may grow by one word.
+    auto shift = __builtin_clz(denominator.m_words[denominator_size - 1]);
+    auto shifted_word = [shift](Word const* words, size_t index) {
+        Word word = words[index] << shift;
+        if (shift != 0 && index > 0)
+            word |= words[index - 1] >> (bits_in_word - shift);
+        return word;
+    };
+
+    temp_normalized_denominator.set_to_0();
+    temp_normalized_denominator.m_words.resize_and_keep_capacity(denominator_size);
+    Word* divisor = temp_normalized_denominator.m_words.data();
+    for (size_t i = 0; i < denominator_size; ++i)
+        divisor[i] = shifted_word(denominator.m_words.data(), i);
+
+    temp_normalized_numerator.set_to_0();
+    temp_normalized_numerator.m_words.resize_and_keep_capacity(numerator_size + 1);
+    Word* dividend = temp_normalized_numerator.m_words.data();
+    for (size_t i = 0; i < numerator_size; ++i)
+        dividend[i] = shifted_word(numerator.m_words.data(), i);
+    dividend[numerator_size] = shift != 0 ? numerator.m_words[numerator_size - 1] >> (bits_in_word - shift) : 0;
+
+    quotient.m_words.resize_and_keep_capacity(numerator_size - denominator_size + 1);
+    DoubleWord const word_base = static_cast<DoubleWord>(1) << bits_in_word;
+    DoubleWord const top_divisor_word = divisor[denominator_size - 1];
+    DoubleWord const second_divisor_word = divisor[denominator_size - 2];
+    for (size_t j = numerator_size - denominator_size + 1; j-- > 0;) {
+        DoubleWord top_words = (static_cast<DoubleWord>(dividend[j + denominator_size]) << bits_in_word) | dividend[j + denominator_size - 1];
+        DoubleWord estimate = top_words / top_divisor_word;
+        DoubleWord estimate_remainder = top_words % top_divisor_word;
+        while (estimate >= word_base || estimate * second_divisor_word > ((estimate_remainder << bits_in_word) | dividend[j + denominator_size - 2])) {
+            --estimate;
+            estimate_remainder += top_divisor_word;
+            if (estimate_remainder >= word_base)
+                break;
+        }
+
+        // dividend -= estimate * divisor << (j words)
+        i64 borrow = 0;
+        for (size_t i = 0; i < denominator_size; ++i) {
+            DoubleWord product = estimate * divisor[i];
+            i64 difference = static_cast<i64>(dividend[i + j]) - borrow - static_cast<i64>(product & 0xffffffff);
+            dividend[i + j] = static_cast<Word>(difference);
+            borrow = static_cast<i64>(product >> bits_in_word) - (difference >> bits_in_word);
+        }
+        i64 difference = static_cast<i64>(dividend[j + denominator_size]) - borrow;
+        dividend[j + denominator_size] = static_cast<Word>(difference);
+
+        if (difference < 0) {
+            // The estimate was one too large after all, add one denominator back.
+            --estimate;
+            DoubleWord carry = 0;
+            for (size_t i = 0; i < denominator_size; ++i) {
+                DoubleWord sum = static_cast<DoubleWord>(dividend[i + j]) + divisor[i] + carry;
+                dividend[i + j] = static_cast<Word>(sum);
+                carry = sum >> bits_in_word;
             }
+            dividend[j + denominator_size] += static_cast<Word>(carry);
         }
+        quotient.m_words[j] = static_cast<Word>(estimate);
+    }
+    quotient.clamp_to_trimmed_length();
+
+    // What is left of the numerator is the remainder, shifted back.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_size);
+    for (size_t i = 0; i < denominator_size; ++i) {
+        Word word = dividend[i] >> shift;
+        if (shift != 0)
+            word |= dividend[i + 1] << (bits_in_word - shift);
+        remainder.m_words[i] = word;
     }
+    remainder.clamp_to_trimmed_length();
 }
 
 /**
@@ -14,8 +14,6 @@ void UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(
     UnsignedBigInteger& temp_b,
     UnsignedBigInteger& temp_1,
     UnsignedBigInteger& temp_2,
-    UnsignedBigInteger& temp_3,
-    UnsignedBigInteger& temp_4,
     UnsignedBigInteger& temp_quotient,
     UnsignedBigInteger& temp_remainder,
     UnsignedBigInteger& output)
@@ -27,7 +25,7 @@ void UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(
         }
 
         // temp_b %= temp_a
-        divide_without_allocation(temp_b, temp_a, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+        divide_without_allocation(temp_b, temp_a, temp_1, temp_2, temp_quotient, temp_remainder);
         temp_b.set_to(temp_remainder);
         if (temp_b == 0) {
             output.set_to(temp_a);
@@ -35,7 +33,7 @@ void UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(
         }
 
         // temp_a %= temp_b
-        divide_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+        divide_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_quotient, temp_remainder);
         temp_a.set_to(temp_remainder);
     }
 }
@@ -15,8 +15,6 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     UnsignedBigInteger const& m,
     UnsignedBigInteger& temp_1,
     UnsignedBigInteger& temp_2,
-    UnsignedBigInteger& temp_3,
-    UnsignedBigInteger& temp_4,
     UnsignedBigInteger& temp_multiply,
     UnsignedBigInteger& temp_quotient,
     UnsignedBigInteger& temp_remainder,
@@ -26,8 +24,8 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     while (!(ep < 1)) {
         if (ep.words()[0] % 2 == 1) {
             // exp = (exp * base) % m;
-            multiply_without_allocation(exp, base, temp_1, temp_2, temp_3, temp_multiply);
-            divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+            multiply_without_allocation(exp, base, temp_1, temp_multiply);
+            divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_quotient, temp_remainder);
             exp.set_to(temp_remainder);
         }
 
@@ -36,8 +34,8 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
         ep.set_to(temp_quotient);
 
         // base = (base * base) % m;
-        multiply_without_allocation(base, base, temp_1, temp_2, temp_3, temp_multiply);
-        divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
+        multiply_without_allocation(base, base, temp_1, temp_multiply);
+        divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_quotient, temp_remainder);
         base.set_to(temp_remainder);
 
         // Note that not clamping here would cause future calculations (multiply, specifically) to allocate even more unused space
@@ -70,44 +68,27 @@ ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
     return static_cast<u32>(-k0);
 }
 
-/**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
- */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
 /**
  * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
  * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
 UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
 {
-    UnsignedBigInteger::Word carry { 0 };
+    VERIFY(x.length() >= num_words);
+    VERIFY(z.length() >= offset_in_z + num_words);
+
+    // This is the innermost loop of the modular power, so it works on the words directly rather than through
+    // the bounds-checked Vector accessors.
+    auto const* x_words = x.m_words.data();
+    auto* z_words = z.m_words.data() + offset_in_z;
+    UnsignedBigInteger::DoubleWord carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
+        // Can't overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1
+        UnsignedBigInteger::DoubleWord result = static_cast<UnsignedBigInteger::DoubleWord>(x_words[i]) * y_digit + z_words[i] + carry;
+        z_words[i] = static_cast<UnsignedBigInteger::Word>(result);
+        carry = result >> UnsignedBigInteger::BITS_IN_WORD;
     }
-    return carry;
+    return static_cast<UnsignedBigInteger::Word>(carry);
 }
 
 /**
@@ -208,13 +189,13 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 
     // rr = ( 2 ^ (2 * modulo.length() * BITS_IN_WORD) ) % modulo
     shift_left_by_n_words(one, 2 * num_words, x);
-    divide_without_allocation(x, modulo, temp_z, one, z, zz, temp_extra, rr);
+    divide_without_allocation(x, modulo, temp_z, zz, temp_extra, rr);
     rr.resize_with_leading_zeros(num_words);
 
     // x = base [% modulo, if x doesn't already fit in modulo's words]
     x.set_to(base);
     if (x.trimmed_length() > num_words)
-        divide_without_allocation(base, modulo, temp_z, one, z, zz, temp_extra, x);
+        divide_without_allocation(base, modulo, temp_z, zz, temp_extra, x);
     x.resize_with_leading_zeros(num_words);
 
     one.set_to(1);
@@ -274,7 +255,7 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
         dbgln("Encountered the modulo branch during a montgomery modular power. Params : {} - {} - {}", base, exponent, modulo);
         // We just clobber all the other temporaries that we don't need for the division.
         // This is wasteful, but we're on the edgiest of cases already.
-        divide_without_allocation(zz, modulo, temp_z, rr, z, x, temp_extra, result);
+        divide_without_allocation(zz, modulo, temp_z, rr, temp_extra, result);
     }
 
     result.clamp_to_trimmed_length();
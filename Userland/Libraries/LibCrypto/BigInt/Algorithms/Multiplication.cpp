@@ -9,38 +9,180 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = UnsignedBigInteger::DoubleWord;
+
+// Below this many words, the additions Karatsuba needs cost more than the multiplications it saves.
+static constexpr size_t karatsuba_threshold = 32;
+
+/**
+ * Complexity: O(N*M) where N and M are the number of words in the numbers
+ * Multiplication method:
+ * The long multiplication taught in school, with words as the digits: every word of the left number
+ * is multiplied by every word of the right number, giving a double word that is added into the output.
+ */
+static void schoolbook_multiply(Word const* left, size_t left_size, Word const* right, size_t right_size, Word* output)
+{
+    __builtin_memset(output, 0, (left_size + right_size) * sizeof(Word));
+    for (size_t i = 0; i < left_size; ++i) {
+        DoubleWord left_word = left[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < right_size; ++j) {
+            // Can't overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1
+            DoubleWord product = left_word * right[j] + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(product);
+            carry = product >> UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + right_size] = static_cast<Word>(carry);
+    }
+}
+
+// output = left + right, where left is at least as long as right. Returns the carry out of the top word.
+static Word add_words(Word const* left, size_t left_size, Word const* right, size_t right_size, Word* output)
+{
+    DoubleWord carry = 0;
+    for (size_t i = 0; i < left_size; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(left[i]) + (i < right_size ? right[i] : 0) + carry;
+        output[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
+// accumulator += value, where the sum fits in the accumulator.
+static void add_words_in_place(Word* accumulator, size_t accumulator_size, Word const* value, size_t value_size)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_size; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(accumulator[i]) + value[i] + carry;
+        accumulator[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry != 0 && i < accumulator_size; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(accumulator[i]) + carry;
+        accumulator[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    VERIFY(carry == 0);
+}
+
+// accumulator -= value, where the difference is not negative.
+static void subtract_words_in_place(Word* accumulator, size_t accumulator_size, Word const* value, size_t value_size)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_size; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
+    }
+    for (; borrow != 0 && i < accumulator_size; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(accumulator[i]) - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
+    }
+    VERIFY(borrow == 0);
+}
+
+static size_t karatsuba_scratch_size(size_t size)
+{
+    if (size < karatsuba_threshold)
+        return 0;
+    auto sum_size = size - size / 2 + 1;
+    return 4 * sum_size + karatsuba_scratch_size(sum_size);
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N^1.585) where N is the number of words in the numbers
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * With both numbers split into a high and a low half, (a1 * B + a0) * (b1 * B + b0) = z2 * B^2 + z1 * B + z0,
+ * where z2 = a1 * b1, z0 = a0 * b0 and z1 = (a0 + a1) * (b0 + b1) - z2 - z0.
+ * That takes three multiplications of half the size instead of four, and they are done the same way in turn.
  */
+static void karatsuba_multiply(Word const* left, Word const* right, size_t size, Word* output, Word* scratch)
+{
+    if (size < karatsuba_threshold) {
+        schoolbook_multiply(left, size, right, size, output);
+        return;
+    }
+
+    auto low_size = size / 2;
+    auto high_size = size - low_size;
+    auto sum_size = high_size + 1;
+
+    karatsuba_multiply(left, right, low_size, output, scratch);
+    karatsuba_multiply(left + low_size, right + low_size, high_size, output + 2 * low_size, scratch);
+
+    Word* left_sum = scratch;
+    Word* right_sum = left_sum + sum_size;
+    Word* middle = right_sum + sum_size;
+    left_sum[high_size] = add_words(left + low_size, high_size, left, low_size, left_sum);
+    right_sum[high_size] = add_words(right + low_size, high_size, right, low_size, right_sum);
+    karatsuba_multiply(left_sum, right_sum, sum_size, middle, middle + 2 * sum_size);
+
+    subtract_words_in_place(middle, 2 * sum_size, output, 2 * low_size);
+    subtract_words_in_place(middle, 2 * sum_size, output + 2 * low_size, 2 * high_size);
+    add_words_in_place(output + low_size, 2 * size - low_size, middle, 2 * sum_size);
+}
+
+static size_t multiply_scratch_size(size_t left_size, size_t right_size)
+{
+    if (left_size < right_size)
+        swap(left_size, right_size);
+    if (right_size < karatsuba_threshold)
+        return 0;
+    if (left_size == right_size)
+        return karatsuba_scratch_size(right_size);
+    auto last_part_size = left_size % right_size;
+    return 2 * right_size + max(karatsuba_scratch_size(right_size), last_part_size ? multiply_scratch_size(right_size, last_part_size) : 0);
+}
+
+static void multiply_words(Word const* left, size_t left_size, Word const* right, size_t right_size, Word* output, Word* scratch)
+{
+    if (left_size < right_size) {
+        swap(left, right);
+        swap(left_size, right_size);
+    }
+
+    if (right_size < karatsuba_threshold) {
+        schoolbook_multiply(left, left_size, right, right_size, output);
+        return;
+    }
+    if (left_size == right_size) {
+        karatsuba_multiply(left, right, right_size, output, scratch);
+        return;
+    }
+
+    // Karatsuba needs numbers of the same size, so the longer one is multiplied piece by piece.
+    __builtin_memset(output, 0, (left_size + right_size) * sizeof(Word));
+    Word* product = scratch;
+    for (size_t offset = 0; offset < left_size; offset += right_size) {
+        auto part_size = min(right_size, left_size - offset);
+        multiply_words(left + offset, part_size, right, right_size, product, product + 2 * right_size);
+        add_words_in_place(output + offset, left_size + right_size - offset, product, part_size + right_size);
+    }
+}
+
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
+    VERIFY(&output != &left && &output != &right);
     output.set_to_0();
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    auto left_size = left.trimmed_length();
+    auto right_size = right.trimmed_length();
+    if (left_size == 0 || right_size == 0)
+        return;
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    output.m_words.resize_and_keep_capacity(left_size + right_size);
+    temp_scratch.set_to_0();
+    temp_scratch.m_words.resize_and_keep_capacity(multiply_scratch_size(left_size, right_size));
+    multiply_words(left.m_words.data(), left_size, right.m_words.data(), right_size, output.m_words.data(), temp_scratch.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
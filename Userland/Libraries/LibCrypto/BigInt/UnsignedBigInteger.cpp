@@ -235,11 +235,9 @@ FLATTEN UnsignedBigInteger UnsignedBigInteger::shift_left(size_t num_bits) const
 FLATTEN UnsignedBigInteger UnsignedBigInteger::multiplied_by(const UnsignedBigInteger& other) const
 {
     UnsignedBigInteger result;
-    UnsignedBigInteger temp_shift_result;
-    UnsignedBigInteger temp_shift_plus;
-    UnsignedBigInteger temp_shift;
+    UnsignedBigInteger temp_scratch;
 
-    UnsignedBigIntegerAlgorithms::multiply_without_allocation(*this, other, temp_shift_result, temp_shift_plus, temp_shift, result);
+    UnsignedBigIntegerAlgorithms::multiply_without_allocation(*this, other, temp_scratch, result);
 
     return result;
 }
@@ -256,12 +254,10 @@ FLATTEN UnsignedDivisionResult UnsignedBigInteger::divided_by(const UnsignedBigI
         return UnsignedDivisionResult { quotient, remainder };
     }
 
-    UnsignedBigInteger temp_shift_result;
-    UnsignedBigInteger temp_shift_plus;
-    UnsignedBigInteger temp_shift;
-    UnsignedBigInteger temp_minus;
+    UnsignedBigInteger temp_normalized_numerator;
+    UnsignedBigInteger temp_normalized_denominator;
 
-    UnsignedBigIntegerAlgorithms::divide_without_allocation(*this, divisor, temp_shift_result, temp_shift_plus, temp_shift, temp_minus, quotient, remainder);
+    UnsignedBigIntegerAlgorithms::divide_without_allocation(*this, divisor, temp_normalized_numerator, temp_normalized_denominator, quotient, remainder);
 
     return UnsignedDivisionResult { quotient, remainder };
 }
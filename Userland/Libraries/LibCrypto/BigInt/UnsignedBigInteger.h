@@ -20,6 +20,8 @@ constexpr size_t STARTING_WORD_SIZE = 32;
 class UnsignedBigInteger {
 public:
     using Word = u32;
+    // Wide enough for the product of two words, which the arithmetic works with.
+    using DoubleWord = u64;
     static constexpr size_t BITS_IN_WORD = 32;
 
     UnsignedBigInteger(Word x) { m_words.append(x); }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+namespace Crypto {
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+#if ARCH(I386) || ARCH(X86_64)
+    u32 max_leaf, eax, ebx, ecx, edx;
+    asm("cpuid"
+        : "=a"(max_leaf), "=b"(ebx), "=c"(ecx), "=d"(edx)
+        : "a"(0));
+    if (max_leaf < 1)
+        return features;
+
+    asm("cpuid"
+        : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+        : "a"(1));
+    features.pclmul = ecx & (1u << 1);
+    features.ssse3 = ecx & (1u << 9);
+    features.sse41 = ecx & (1u << 19);
+    features.sse42 = ecx & (1u << 20);
+    features.aes = ecx & (1u << 25);
+    // The YMM registers are only usable if the OS saves them on context switches.
+    bool ymm_enabled = false;
+    if (ecx & (1u << 27)) {
+        u32 xcr0_low, xcr0_high;
+        asm("xgetbv"
+            : "=a"(xcr0_low), "=d"(xcr0_high)
+            : "c"(0));
+        ymm_enabled = (xcr0_low & 0x6) == 0x6;
+    }
+
+    if (max_leaf < 7)
+        return features;
+
+    asm("cpuid"
+        : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+        : "a"(7), "c"(0));
+    features.sha = ebx & (1u << 29);
+    features.avx2 = ymm_enabled && (ebx & (1u << 5));
+#endif
+    return features;
+}
+
+const CPUFeatures& cpu_features()
+{
+    static CPUFeatures features = detect_cpu_features();
+    return features;
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+
+namespace Crypto {
+
+// The instruction set extensions that the accelerated code paths can use.
+// They are detected once, with CPUID, and are all false on other architectures.
+// The kernel does not save the SIMD registers for itself, so it must not call this.
+struct CPUFeatures {
+    bool ssse3 { false };
+    bool sse41 { false };
+    bool sse42 { false };
+    bool aes { false };
+    bool pclmul { false };
+    bool sha { false };
+    bool avx2 { false };
+};
+
+const CPUFeatures& cpu_features();
+
+}
@@ -8,14 +8,94 @@
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <tmmintrin.h>
+#    define USE_SSSE3 1
+#    define SSSE3_TARGET __attribute__((target("ssse3")))
+#else
+#    define USE_SSSE3 0
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 modulus = 65521;
+
+// The most bytes that can be summed before b overflows 32 bits and has to be reduced.
+static constexpr size_t max_bytes_between_reductions = 5552;
+
+static void update_portable(u32& a, u32& b, ReadonlyBytes data)
+{
+    while (!data.is_empty()) {
+        auto chunk = data.trim(max_bytes_between_reductions);
+        for (auto byte : chunk) {
+            a += byte;
+            b += a;
+        }
+        a %= modulus;
+        b %= modulus;
+        data = data.slice(chunk.size());
+    }
+}
+
+#if USE_SSSE3
+// Sums 32 bytes per step: PSADBW adds them up for a, and PMADDUBSW weighs each one by the number
+// of times it is added to b (32 for the first byte down to 1 for the last). Every step also adds
+// 32 times the previous a to b, which is accumulated separately and scaled at the end.
+// Expects a multiple of 32 bytes.
+SSSE3_TARGET static void update_ssse3(u32& a, u32& b, u8 const* data, size_t size)
+{
+    constexpr size_t step_size = 32;
+    auto const weights_high = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const weights_low = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const zero = _mm_setzero_si128();
+    auto const ones = _mm_set1_epi16(1);
+
+    auto steps = size / step_size;
+    while (steps > 0) {
+        auto steps_in_chunk = min(steps, max_bytes_between_reductions / step_size);
+        steps -= steps_in_chunk;
+
+        auto previous_a_sum = _mm_set_epi32(0, 0, 0, a * steps_in_chunk);
+        auto b_sum = _mm_set_epi32(0, 0, 0, b);
+        auto a_sum = _mm_setzero_si128();
+
+        for (size_t i = 0; i < steps_in_chunk; ++i, data += step_size) {
+            auto first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+            auto second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16));
+
+            previous_a_sum = _mm_add_epi32(previous_a_sum, a_sum);
+
+            a_sum = _mm_add_epi32(a_sum, _mm_sad_epu8(first, zero));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(first, weights_high), ones));
+            a_sum = _mm_add_epi32(a_sum, _mm_sad_epu8(second, zero));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(second, weights_low), ones));
+        }
+
+        b_sum = _mm_add_epi32(b_sum, _mm_slli_epi32(previous_a_sum, 5));
+
+        // Add up the 32-bit lanes.
+        a_sum = _mm_add_epi32(a_sum, _mm_shuffle_epi32(a_sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        b_sum = _mm_add_epi32(b_sum, _mm_shuffle_epi32(b_sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        b_sum = _mm_add_epi32(b_sum, _mm_shuffle_epi32(b_sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        a = (a + _mm_cvtsi128_si32(a_sum)) % modulus;
+        b = _mm_cvtsi128_si32(b_sum) % modulus;
+    }
+}
+
+static const bool s_use_ssse3 = cpu_features().ssse3;
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+#if USE_SSSE3
+    if (s_use_ssse3 && data.size() >= 32) {
+        auto vectorized_size = data.size() & ~static_cast<size_t>(31);
+        update_ssse3(m_state_a, m_state_b, data.data(), vectorized_size);
+        data = data.slice(vectorized_size);
     }
+#endif
+    update_portable(m_state_a, m_state_b, data);
 };
 
 u32 Adler32::digest()
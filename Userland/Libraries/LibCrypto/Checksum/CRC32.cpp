@@ -4,17 +4,142 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <smmintrin.h>
+#    include <wmmintrin.h>
+#    define USE_PCLMUL 1
+#    define PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#else
+#    define USE_PCLMUL 0
+#endif
+
 namespace Crypto::Checksum {
 
+// Table n holds the CRC of each byte followed by n zero bytes, which lets the portable code
+// below consume eight bytes per step ("slicing-by-8").
+struct Tables {
+    u32 data[8][256];
+
+    constexpr Tables()
+        : data()
+    {
+        for (auto i = 0; i < 256; i++) {
+            u32 value = i;
+
+            for (auto j = 0; j < 8; j++) {
+                if (value & 1) {
+                    value = 0xEDB88320 ^ (value >> 1);
+                } else {
+                    value = value >> 1;
+                }
+            }
+
+            data[0][i] = value;
+        }
+
+        for (auto n = 1; n < 8; n++) {
+            for (auto i = 0; i < 256; i++)
+                data[n][i] = (data[n - 1][i] >> 8) ^ data[0][data[n - 1][i] & 0xFF];
+        }
+    }
+};
+
+constexpr static auto tables = Tables();
+
+static u32 update_portable(u32 state, ReadonlyBytes data)
+{
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+    for (; size >= 8; bytes += 8, size -= 8) {
+        auto low = AK::convert_between_host_and_little_endian(ByteReader::load32(bytes)) ^ state;
+        auto high = AK::convert_between_host_and_little_endian(ByteReader::load32(bytes + 4));
+        state = tables.data[7][low & 0xFF] ^ tables.data[6][(low >> 8) & 0xFF]
+            ^ tables.data[5][(low >> 16) & 0xFF] ^ tables.data[4][low >> 24]
+            ^ tables.data[3][high & 0xFF] ^ tables.data[2][(high >> 8) & 0xFF]
+            ^ tables.data[1][(high >> 16) & 0xFF] ^ tables.data[0][high >> 24];
+    }
+
+    for (; size > 0; ++bytes, --size)
+        state = tables.data[0][(state ^ *bytes) & 0xFF] ^ (state >> 8);
+
+    return state;
+}
+
+#if USE_PCLMUL
+// Folds 64 bytes at a time with carry-less multiplication, after Gopal et al., "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009). The constants are powers of x
+// modulo the bit-reflected CRC-32 polynomial, and the final 64 bits are reduced with Barrett's method.
+PCLMUL_TARGET static ALWAYS_INLINE __m128i load(u8 const* bytes)
+{
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+}
+
+PCLMUL_TARGET static ALWAYS_INLINE __m128i fold(__m128i value, __m128i constants, __m128i next)
+{
+    auto low = _mm_clmulepi64_si128(value, constants, 0x00);
+    auto high = _mm_clmulepi64_si128(value, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+// Expects a multiple of 16 bytes, at least 64 of them.
+PCLMUL_TARGET static u32 update_pclmul(u32 state, u8 const* data, size_t size)
+{
+    auto const fold_by_4 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    auto const fold_by_1 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    auto const fold_to_32 = _mm_set_epi64x(0, 0x0163cd6124);
+    auto const polynomial = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    auto const low_32_bits = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i lanes[4];
+    for (size_t i = 0; i < 4; ++i)
+        lanes[i] = load(data + i * 16);
+    lanes[0] = _mm_xor_si128(lanes[0], _mm_cvtsi32_si128(state));
+    data += 64;
+    size -= 64;
+
+    for (; size >= 64; data += 64, size -= 64) {
+        for (size_t i = 0; i < 4; ++i)
+            lanes[i] = fold(lanes[i], fold_by_4, load(data + i * 16));
+    }
+
+    auto value = lanes[0];
+    for (size_t i = 1; i < 4; ++i)
+        value = fold(value, fold_by_1, lanes[i]);
+
+    for (; size >= 16; data += 16, size -= 16)
+        value = fold(value, fold_by_1, load(data));
+
+    // 128 bits to 64 bits.
+    value = _mm_xor_si128(_mm_srli_si128(value, 8), _mm_clmulepi64_si128(value, fold_by_1, 0x10));
+    value = _mm_xor_si128(_mm_srli_si128(value, 4), _mm_clmulepi64_si128(_mm_and_si128(value, low_32_bits), fold_to_32, 0x00));
+
+    // 64 bits to 32 bits.
+    auto quotient = _mm_clmulepi64_si128(_mm_and_si128(value, low_32_bits), polynomial, 0x10);
+    auto product = _mm_clmulepi64_si128(_mm_and_si128(quotient, low_32_bits), polynomial, 0x00);
+    return _mm_extract_epi32(_mm_xor_si128(value, product), 1);
+}
+
+static const bool s_use_pclmul = cpu_features().pclmul && cpu_features().sse41;
+#endif
+
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+#if USE_PCLMUL
+    if (s_use_pclmul && data.size() >= 64) {
+        auto folded_size = data.size() & ~static_cast<size_t>(15);
+        m_state = update_pclmul(m_state, data.data(), folded_size);
+        data = data.slice(folded_size);
     }
+#endif
+    m_state = update_portable(m_state, data);
 };
 
 u32 CRC32::digest()
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/XxHash.h>
+#include <string.h>
+
+namespace Crypto::Checksum {
+
+static constexpr u32 prime32_1 = 2654435761u;
+static constexpr u32 prime32_2 = 2246822519u;
+static constexpr u32 prime32_3 = 3266489917u;
+static constexpr u32 prime32_4 = 668265263u;
+static constexpr u32 prime32_5 = 374761393u;
+
+static constexpr u64 prime64_1 = 11400714785074694791ull;
+static constexpr u64 prime64_2 = 14029467366897019727ull;
+static constexpr u64 prime64_3 = 1609587929392839161ull;
+static constexpr u64 prime64_4 = 9650029242287828579ull;
+static constexpr u64 prime64_5 = 2870177450012600261ull;
+
+template<typename T>
+static ALWAYS_INLINE T rotate_left(T value, int bits)
+{
+    return (value << bits) | (value >> (sizeof(T) * 8 - bits));
+}
+
+template<typename T>
+static ALWAYS_INLINE T read_little_endian(u8 const* bytes)
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(bytes[i]) << (i * 8);
+    return value;
+}
+
+static ALWAYS_INLINE u32 round32(u32 accumulator, u32 input)
+{
+    return rotate_left(accumulator + input * prime32_2, 13) * prime32_1;
+}
+
+static ALWAYS_INLINE u64 round64(u64 accumulator, u64 input)
+{
+    return rotate_left(accumulator + input * prime64_2, 31) * prime64_1;
+}
+
+static ALWAYS_INLINE u64 merge_round64(u64 hash, u64 accumulator)
+{
+    return (hash ^ round64(0, accumulator)) * prime64_1 + prime64_4;
+}
+
+XxHash32::XxHash32(u32 seed)
+    : m_seed(seed)
+    , m_accumulators { seed + prime32_1 + prime32_2, seed + prime32_2, seed, seed - prime32_1 }
+{
+}
+
+void XxHash32::update(ReadonlyBytes data)
+{
+    m_total_length += data.size();
+    auto consume_stripe = [&](u8 const* stripe) {
+        for (size_t lane = 0; lane < 4; ++lane)
+            m_accumulators[lane] = round32(m_accumulators[lane], read_little_endian<u32>(stripe + lane * 4));
+    };
+
+    if (m_buffered != 0) {
+        auto to_copy = min(stripe_size - m_buffered, data.size());
+        memcpy(m_buffer + m_buffered, data.data(), to_copy);
+        m_buffered += to_copy;
+        data = data.slice(to_copy);
+        if (m_buffered < stripe_size)
+            return;
+        consume_stripe(m_buffer);
+        m_buffered = 0;
+    }
+
+    while (data.size() >= stripe_size) {
+        consume_stripe(data.data());
+        data = data.slice(stripe_size);
+    }
+
+    memcpy(m_buffer, data.data(), data.size());
+    m_buffered = data.size();
+}
+
+u32 XxHash32::digest()
+{
+    u32 hash;
+    if (m_total_length >= stripe_size)
+        hash = rotate_left(m_accumulators[0], 1) + rotate_left(m_accumulators[1], 7) + rotate_left(m_accumulators[2], 12) + rotate_left(m_accumulators[3], 18);
+    else
+        hash = m_seed + prime32_5;
+    hash += static_cast<u32>(m_total_length);
+
+    size_t offset = 0;
+    for (; offset + 4 <= m_buffered; offset += 4)
+        hash = rotate_left(hash + read_little_endian<u32>(m_buffer + offset) * prime32_3, 17) * prime32_4;
+    for (; offset < m_buffered; ++offset)
+        hash = rotate_left(hash + m_buffer[offset] * prime32_5, 11) * prime32_1;
+
+    hash ^= hash >> 15;
+    hash *= prime32_2;
+    hash ^= hash >> 13;
+    hash *= prime32_3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+XxHash64::XxHash64(u64 seed)
+    : m_seed(seed)
+    , m_accumulators { seed + prime64_1 + prime64_2, seed + prime64_2, seed, seed - prime64_1 }
+{
+}
+
+void XxHash64::update(ReadonlyBytes data)
+{
+    m_total_length += data.size();
+    auto consume_stripe = [&](u8 const* stripe) {
+        for (size_t lane = 0; lane < 4; ++lane)
+            m_accumulators[lane] = round64(m_accumulators[lane], read_little_endian<u64>(stripe + lane * 8));
+    };
+
+    if (m_buffered != 0) {
+        auto to_copy = min(stripe_size - m_buffered, data.size());
+        memcpy(m_buffer + m_buffered, data.data(), to_copy);
+        m_buffered += to_copy;
+        data = data.slice(to_copy);
+        if (m_buffered < stripe_size)
+            return;
+        consume_stripe(m_buffer);
+        m_buffered = 0;
+    }
+
+    while (data.size() >= stripe_size) {
+        consume_stripe(data.data());
+        data = data.slice(stripe_size);
+    }
+
+    memcpy(m_buffer, data.data(), data.size());
+    m_buffered = data.size();
+}
+
+u64 XxHash64::digest()
+{
+    u64 hash;
+    if (m_total_length >= stripe_size) {
+        hash = rotate_left(m_accumulators[0], 1) + rotate_left(m_accumulators[1], 7) + rotate_left(m_accumulators[2], 12) + rotate_left(m_accumulators[3], 18);
+        for (auto accumulator : m_accumulators)
+            hash = merge_round64(hash, accumulator);
+    } else {
+        hash = m_seed + prime64_5;
+    }
+    hash += m_total_length;
+
+    size_t offset = 0;
+    for (; offset + 8 <= m_buffered; offset += 8)
+        hash = rotate_left(hash ^ round64(0, read_little_endian<u64>(m_buffer + offset)), 27) * prime64_1 + prime64_4;
+    if (offset + 4 <= m_buffered) {
+        hash = rotate_left(hash ^ (read_little_endian<u32>(m_buffer + offset) * prime64_1), 23) * prime64_2 + prime64_3;
+        offset += 4;
+    }
+    for (; offset < m_buffered; ++offset)
+        hash = rotate_left(hash ^ (m_buffer[offset] * prime64_5), 11) * prime64_1;
+
+    hash ^= hash >> 33;
+    hash *= prime64_2;
+    hash ^= hash >> 29;
+    hash *= prime64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/ChecksumFunction.h>
+
+namespace Crypto::Checksum {
+
+// The 32 bit variant of xxHash, as used by the LZ4 frame format.
+class XxHash32 : public ChecksumFunction<u32> {
+public:
+    explicit XxHash32(u32 seed = 0);
+    XxHash32(ReadonlyBytes data)
+        : XxHash32()
+    {
+        update(data);
+    }
+
+    void update(ReadonlyBytes data);
+    u32 digest();
+
+private:
+    static constexpr size_t stripe_size = 16;
+
+    u32 m_seed { 0 };
+    u32 m_accumulators[4];
+    u8 m_buffer[stripe_size];
+    size_t m_buffered { 0 };
+    u64 m_total_length { 0 };
+};
+
+// The 64 bit variant of xxHash, as used by the Zstandard frame format.
+class XxHash64 : public ChecksumFunction<u64> {
+public:
+    explicit XxHash64(u64 seed = 0);
+    XxHash64(ReadonlyBytes data)
+        : XxHash64()
+    {
+        update(data);
+    }
+
+    void update(ReadonlyBytes data);
+    u64 digest();
+
+private:
+    static constexpr size_t stripe_size = 32;
+
+    u64 m_seed { 0 };
+    u64 m_accumulators[4];
+    u8 m_buffer[stripe_size];
+    size_t m_buffered { 0 };
+    u64 m_total_length { 0 };
+};
+
+}
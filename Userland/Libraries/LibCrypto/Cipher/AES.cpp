@@ -7,22 +7,362 @@
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <wmmintrin.h>
+#    define USE_AES_NI 1
+#    define AES_NI_TARGET __attribute__((target("aes,sse2")))
+#else
+#    define USE_AES_NI 0
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
-template<typename T>
-constexpr u32 get_key(T pt)
+// The portable implementation below is constant-time: it does no table lookups and no branches
+// that depend on the key or the data. SubBytes is the bitsliced S-box circuit by Boyar and Peralta,
+// "A depth-16 circuit for the AES S-box" (2011), applied to all 16 bytes of the state at once.
+
+static u64 transpose_8x8_bits(u64 x)
+{
+    // Bit j of byte i becomes bit i of byte j.
+    u64 t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+static void bitsliced_sbox(u16 (&q)[8])
 {
-    return ((u32)(pt)[0] << 24) ^ ((u32)(pt)[1] << 16) ^ ((u32)(pt)[2] << 8) ^ ((u32)(pt)[3]);
+    u16 x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // Top linear transformation.
+    u16 y14 = x3 ^ x5;
+    u16 y13 = x0 ^ x6;
+    u16 y9 = x0 ^ x3;
+    u16 y8 = x0 ^ x5;
+    u16 t0 = x1 ^ x2;
+    u16 y1 = t0 ^ x7;
+    u16 y4 = y1 ^ x3;
+    u16 y12 = y13 ^ y14;
+    u16 y2 = y1 ^ x0;
+    u16 y5 = y1 ^ x6;
+    u16 y3 = y5 ^ y8;
+    u16 t1 = x4 ^ y12;
+    u16 y15 = t1 ^ x5;
+    u16 y20 = t1 ^ x1;
+    u16 y6 = y15 ^ x7;
+    u16 y10 = y15 ^ t0;
+    u16 y11 = y20 ^ y9;
+    u16 y7 = x7 ^ y11;
+    u16 y17 = y10 ^ y11;
+    u16 y19 = y10 ^ y8;
+    u16 y16 = t0 ^ y11;
+    u16 y21 = y13 ^ y16;
+    u16 y18 = x0 ^ y16;
+
+    // Non-linear section, the inversion in GF(2^8).
+    u16 t2 = y12 & y15;
+    u16 t3 = y3 & y6;
+    u16 t4 = t3 ^ t2;
+    u16 t5 = y4 & x7;
+    u16 t6 = t5 ^ t2;
+    u16 t7 = y13 & y16;
+    u16 t8 = y5 & y1;
+    u16 t9 = t8 ^ t7;
+    u16 t10 = y2 & y7;
+    u16 t11 = t10 ^ t7;
+    u16 t12 = y9 & y11;
+    u16 t13 = y14 & y17;
+    u16 t14 = t13 ^ t12;
+    u16 t15 = y8 & y10;
+    u16 t16 = t15 ^ t12;
+    u16 t17 = t4 ^ t14;
+    u16 t18 = t6 ^ t16;
+    u16 t19 = t9 ^ t14;
+    u16 t20 = t11 ^ t16;
+    u16 t21 = t17 ^ y20;
+    u16 t22 = t18 ^ y19;
+    u16 t23 = t19 ^ y21;
+    u16 t24 = t20 ^ y18;
+
+    u16 t25 = t21 ^ t22;
+    u16 t26 = t21 & t23;
+    u16 t27 = t24 ^ t26;
+    u16 t28 = t25 & t27;
+    u16 t29 = t28 ^ t22;
+    u16 t30 = t23 ^ t24;
+    u16 t31 = t22 ^ t26;
+    u16 t32 = t31 & t30;
+    u16 t33 = t32 ^ t24;
+    u16 t34 = t23 ^ t33;
+    u16 t35 = t27 ^ t33;
+    u16 t36 = t24 & t35;
+    u16 t37 = t36 ^ t34;
+    u16 t38 = t27 ^ t36;
+    u16 t39 = t29 & t38;
+    u16 t40 = t25 ^ t39;
+
+    u16 t41 = t40 ^ t37;
+    u16 t42 = t29 ^ t33;
+    u16 t43 = t29 ^ t40;
+    u16 t44 = t33 ^ t37;
+    u16 t45 = t42 ^ t41;
+    u16 z0 = t44 & y15;
+    u16 z1 = t37 & y6;
+    u16 z2 = t33 & x7;
+    u16 z3 = t43 & y16;
+    u16 z4 = t40 & y1;
+    u16 z5 = t29 & y7;
+    u16 z6 = t42 & y11;
+    u16 z7 = t45 & y17;
+    u16 z8 = t41 & y10;
+    u16 z9 = t44 & y12;
+    u16 z10 = t37 & y3;
+    u16 z11 = t33 & y4;
+    u16 z12 = t43 & y13;
+    u16 z13 = t40 & y5;
+    u16 z14 = t29 & y2;
+    u16 z15 = t42 & y9;
+    u16 z16 = t45 & y14;
+    u16 z17 = t41 & y8;
+
+    // Bottom linear transformation.
+    u16 t46 = z15 ^ z16;
+    u16 t47 = z10 ^ z11;
+    u16 t48 = z5 ^ z13;
+    u16 t49 = z9 ^ z10;
+    u16 t50 = z2 ^ z12;
+    u16 t51 = z2 ^ z5;
+    u16 t52 = z7 ^ z8;
+    u16 t53 = z0 ^ z3;
+    u16 t54 = z6 ^ z7;
+    u16 t55 = z16 ^ z17;
+    u16 t56 = z12 ^ t48;
+    u16 t57 = t50 ^ t53;
+    u16 t58 = z4 ^ t46;
+    u16 t59 = z3 ^ t54;
+    u16 t60 = t46 ^ t57;
+    u16 t61 = z14 ^ t57;
+    u16 t62 = t52 ^ t58;
+    u16 t63 = t49 ^ t58;
+    u16 t64 = z4 ^ t59;
+    u16 t65 = t61 ^ t62;
+    u16 t66 = z1 ^ t63;
+    u16 s0 = t59 ^ t63;
+    u16 s6 = t56 ^ ~t62;
+    u16 s7 = t48 ^ ~t60;
+    u16 t67 = t64 ^ t65;
+    u16 s3 = t53 ^ t66;
+    u16 s4 = t51 ^ t66;
+    u16 s5 = t47 ^ t65;
+    u16 s1 = t64 ^ ~s3;
+    u16 s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
 }
 
-constexpr void swap_keys(u32* keys, size_t i, size_t j)
+// The inverse of the affine transformation that ends the S-box.
+static void bitsliced_inverse_affine(u16 (&q)[8])
 {
-    u32 temp = keys[i];
-    keys[i] = keys[j];
-    keys[j] = temp;
+    u16 q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
 }
 
+static void sub_bytes(u8 (&state)[16], bool inverse = false)
+{
+    u64 low = 0;
+    u64 high = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        low |= (u64)state[i] << (i * 8);
+        high |= (u64)state[i + 8] << (i * 8);
+    }
+    low = transpose_8x8_bits(low);
+    high = transpose_8x8_bits(high);
+
+    // q[i] holds bit i of every byte of the state.
+    u16 q[8];
+    for (size_t i = 0; i < 8; ++i)
+        q[i] = (u16)(((low >> (i * 8)) & 0xff) | (((high >> (i * 8)) & 0xff) << 8));
+
+    if (inverse) {
+        // InvSubBytes(x) = A^-1(SubBytes(A^-1(x))), as SubBytes is A(x^-1) for the affine transformation A.
+        bitsliced_inverse_affine(q);
+        bitsliced_sbox(q);
+        bitsliced_inverse_affine(q);
+    } else {
+        bitsliced_sbox(q);
+    }
+
+    low = 0;
+    high = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        low |= (u64)(q[i] & 0xff) << (i * 8);
+        high |= (u64)(q[i] >> 8) << (i * 8);
+    }
+    low = transpose_8x8_bits(low);
+    high = transpose_8x8_bits(high);
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = low >> (i * 8);
+        state[i + 8] = high >> (i * 8);
+    }
+}
+
+// The state is stored column by column, so byte (row, column) is at index 4 * column + row.
+static void shift_rows(u8 (&state)[16])
+{
+    u8 copy[16];
+    __builtin_memcpy(copy, state, sizeof(copy));
+    for (size_t column = 0; column < 4; ++column) {
+        for (size_t row = 1; row < 4; ++row)
+            state[4 * column + row] = copy[4 * ((column + row) % 4) + row];
+    }
+}
+
+static void inverse_shift_rows(u8 (&state)[16])
+{
+    u8 copy[16];
+    __builtin_memcpy(copy, state, sizeof(copy));
+    for (size_t column = 0; column < 4; ++column) {
+        for (size_t row = 1; row < 4; ++row)
+            state[4 * ((column + row) % 4) + row] = copy[4 * column + row];
+    }
+}
+
+// Multiplies each of the four bytes in a word by x in GF(2^8).
+static u32 xtime(u32 word)
+{
+    return ((word & 0x7f7f7f7f) << 1) ^ (((word >> 7) & 0x01010101) * 0x1b);
+}
+
+static u32 rotate_right(u32 word, size_t bits)
+{
+    return (word >> bits) | (word << (32 - bits));
+}
+
+static u32 load_column(const u8* bytes)
+{
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((u32)bytes[3] << 24);
+}
+
+static void store_column(u8* bytes, u32 column)
+{
+    bytes[0] = column;
+    bytes[1] = column >> 8;
+    bytes[2] = column >> 16;
+    bytes[3] = column >> 24;
+}
+
+static u32 mix_column(u32 column)
+{
+    // Row i becomes 2 * a[i] + 3 * a[i + 1] + a[i + 2] + a[i + 3].
+    auto rotated = rotate_right(column, 8);
+    return xtime(column ^ rotated) ^ rotated ^ rotate_right(column, 16) ^ rotate_right(column, 24);
+}
+
+static u32 inverse_mix_column(u32 column)
+{
+    // InvMixColumns is MixColumns after adding 4 * (a[i] + a[i + 2]) to every row i.
+    column ^= xtime(xtime(column ^ rotate_right(column, 16)));
+    return mix_column(column);
+}
+
+static void mix_columns(u8 (&state)[16])
+{
+    for (size_t i = 0; i < 16; i += 4)
+        store_column(state + i, mix_column(load_column(state + i)));
+}
+
+static void inverse_mix_columns(u8* bytes)
+{
+    for (size_t i = 0; i < 16; i += 4)
+        store_column(bytes + i, inverse_mix_column(load_column(bytes + i)));
+}
+
+static void add_round_key(u8 (&state)[16], const u8* round_key)
+{
+    for (size_t i = 0; i < 16; ++i)
+        state[i] ^= round_key[i];
+}
+
+static void encrypt_block_portable(const u8* round_keys, size_t rounds, const u8* in, u8* out)
+{
+    u8 state[16];
+    __builtin_memcpy(state, in, sizeof(state));
+    add_round_key(state, round_keys);
+    for (size_t round = 1; round < rounds; ++round) {
+        sub_bytes(state);
+        shift_rows(state);
+        mix_columns(state);
+        add_round_key(state, round_keys + round * 16);
+    }
+    sub_bytes(state);
+    shift_rows(state);
+    add_round_key(state, round_keys + rounds * 16);
+    __builtin_memcpy(out, state, sizeof(state));
+}
+
+static void decrypt_block_portable(const u8* round_keys, size_t rounds, const u8* in, u8* out)
+{
+    u8 state[16];
+    __builtin_memcpy(state, in, sizeof(state));
+    add_round_key(state, round_keys);
+    for (size_t round = 1; round < rounds; ++round) {
+        sub_bytes(state, true);
+        inverse_shift_rows(state);
+        inverse_mix_columns(state);
+        add_round_key(state, round_keys + round * 16);
+    }
+    sub_bytes(state, true);
+    inverse_shift_rows(state);
+    add_round_key(state, round_keys + rounds * 16);
+    __builtin_memcpy(out, state, sizeof(state));
+}
+
+#if USE_AES_NI
+// AESENC and AESDEC do a whole round each, with the round keys in the same layout as ours.
+// AESDEC is a round of the equivalent inverse cipher, so it takes the decryption round keys as they are.
+
+AES_NI_TARGET static void encrypt_block_aes_ni(const u8* round_keys, size_t rounds, const u8* in, u8* out)
+{
+    auto const* keys = reinterpret_cast<const __m128i*>(round_keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_load_si128(keys));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesenc_si128(state, _mm_load_si128(keys + round));
+    state = _mm_aesenclast_si128(state, _mm_load_si128(keys + rounds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+AES_NI_TARGET static void decrypt_block_aes_ni(const u8* round_keys, size_t rounds, const u8* in, u8* out)
+{
+    auto const* keys = reinterpret_cast<const __m128i*>(round_keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_load_si128(keys));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesdec_si128(state, _mm_load_si128(keys + round));
+    state = _mm_aesdeclast_si128(state, _mm_load_si128(keys + rounds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+static const bool s_use_aes_ni = cpu_features().aes;
+#endif
+
 String AESCipherBlock::to_string() const
 {
     StringBuilder builder;
@@ -34,23 +374,19 @@ String AESCipherBlock::to_string() const
 String AESCipherKey::to_string() const
 {
     StringBuilder builder;
-    for (size_t i = 0; i < (rounds() + 1) * 4; ++i)
+    for (size_t i = 0; i < (rounds() + 1) * 16; ++i)
         builder.appendff("{:02x}", m_rd_keys[i]);
     return builder.build();
 }
 
 void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
 {
-    u32* round_key;
-    u32 temp;
-    size_t i { 0 };
+    static constexpr u8 round_constants[] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
 
     VERIFY(!user_key.is_null());
     VERIFY(is_valid_key_size(bits));
     VERIFY(user_key.size() == bits / 8);
 
-    round_key = round_keys();
-
     if (bits == 128) {
         m_rounds = 10;
     } else if (bits == 192) {
@@ -59,320 +395,71 @@ void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
         m_rounds = 14;
     }
 
-    round_key[0] = get_key(user_key.data());
-    round_key[1] = get_key(user_key.data() + 4);
-    round_key[2] = get_key(user_key.data() + 8);
-    round_key[3] = get_key(user_key.data() + 12);
-    if (bits == 128) {
-        for (;;) {
-            temp = round_key[3];
-            // clang-format off
-            round_key[4] = round_key[0] ^
-                    (AESTables::Encode2[(temp >> 16) & 0xff] & 0xff000000) ^
-                    (AESTables::Encode3[(temp >>  8) & 0xff] & 0x00ff0000) ^
-                    (AESTables::Encode0[(temp      ) & 0xff] & 0x0000ff00) ^
-                    (AESTables::Encode1[(temp >> 24)       ] & 0x000000ff) ^ AESTables::RCON[i];
-            // clang-format on
-            round_key[5] = round_key[1] ^ round_key[4];
-            round_key[6] = round_key[2] ^ round_key[5];
-            round_key[7] = round_key[3] ^ round_key[6];
-            ++i;
-            if (i == 10)
-                break;
-            round_key += 4;
-        }
-        return;
-    }
-
-    round_key[4] = get_key(user_key.data() + 16);
-    round_key[5] = get_key(user_key.data() + 20);
-    if (bits == 192) {
-        for (;;) {
-            temp = round_key[5];
-            // clang-format off
-            round_key[6] = round_key[0] ^
-                    (AESTables::Encode2[(temp >> 16) & 0xff] & 0xff000000) ^
-                    (AESTables::Encode3[(temp >>  8) & 0xff] & 0x00ff0000) ^
-                    (AESTables::Encode0[(temp      ) & 0xff] & 0x0000ff00) ^
-                    (AESTables::Encode1[(temp >> 24)       ] & 0x000000ff) ^ AESTables::RCON[i];
-            // clang-format on
-            round_key[7] = round_key[1] ^ round_key[6];
-            round_key[8] = round_key[2] ^ round_key[7];
-            round_key[9] = round_key[3] ^ round_key[8];
-
-            ++i;
-            if (i == 8)
-                break;
-
-            round_key[10] = round_key[4] ^ round_key[9];
-            round_key[11] = round_key[5] ^ round_key[10];
-
-            round_key += 6;
+    // FIPS-197, 5.2: the key schedule is built one 4-byte word at a time,
+    // from the words one and |key_words| before it.
+    auto* round_key = round_keys();
+    size_t key_words = bits / 32;
+    __builtin_memcpy(round_key, user_key.data(), user_key.size());
+    for (size_t i = key_words; i < 4 * (m_rounds + 1); ++i) {
+        u8 word[16] {};
+        __builtin_memcpy(word, round_key + 4 * (i - 1), 4);
+        if (i % key_words == 0) {
+            u8 first = word[0];
+            word[0] = word[1];
+            word[1] = word[2];
+            word[2] = word[3];
+            word[3] = first;
+            sub_bytes(word);
+            word[0] ^= round_constants[i / key_words - 1];
+        } else if (key_words > 6 && i % key_words == 4) {
+            sub_bytes(word);
         }
-        return;
-    }
-
-    round_key[6] = get_key(user_key.data() + 24);
-    round_key[7] = get_key(user_key.data() + 28);
-    if (true) { // bits == 256
-        for (;;) {
-            temp = round_key[7];
-            // clang-format off
-            round_key[8] = round_key[0] ^
-                    (AESTables::Encode2[(temp >> 16) & 0xff] & 0xff000000) ^
-                    (AESTables::Encode3[(temp >>  8) & 0xff] & 0x00ff0000) ^
-                    (AESTables::Encode0[(temp      ) & 0xff] & 0x0000ff00) ^
-                    (AESTables::Encode1[(temp >> 24)       ] & 0x000000ff) ^ AESTables::RCON[i];
-            // clang-format on
-            round_key[9] = round_key[1] ^ round_key[8];
-            round_key[10] = round_key[2] ^ round_key[9];
-            round_key[11] = round_key[3] ^ round_key[10];
-
-            ++i;
-            if (i == 7)
-                break;
-
-            temp = round_key[11];
-            // clang-format off
-            round_key[12] = round_key[4] ^
-                    (AESTables::Encode2[(temp >> 24)       ] & 0xff000000) ^
-                    (AESTables::Encode3[(temp >> 16) & 0xff] & 0x00ff0000) ^
-                    (AESTables::Encode0[(temp >>  8) & 0xff] & 0x0000ff00) ^
-                    (AESTables::Encode1[(temp      ) & 0xff] & 0x000000ff) ;
-            // clang-format on
-            round_key[13] = round_key[5] ^ round_key[12];
-            round_key[14] = round_key[6] ^ round_key[13];
-            round_key[15] = round_key[7] ^ round_key[14];
-
-            round_key += 8;
-        }
-        return;
+        for (size_t j = 0; j < 4; ++j)
+            round_key[4 * i + j] = round_key[4 * (i - key_words) + j] ^ word[j];
     }
 }
 
 void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 {
-    u32* round_key;
-
     expand_encrypt_key(user_key, bits);
 
-    round_key = round_keys();
+    auto* round_key = round_keys();
 
     // reorder round keys
-    for (size_t i = 0, j = 4 * rounds(); i < j; i += 4, j -= 4) {
-        swap_keys(round_key, i, j);
-        swap_keys(round_key, i + 1, j + 1);
-        swap_keys(round_key, i + 2, j + 2);
-        swap_keys(round_key, i + 3, j + 3);
+    for (size_t i = 0, j = rounds(); i < j; ++i, --j) {
+        u8 temp[16];
+        __builtin_memcpy(temp, round_key + i * 16, 16);
+        __builtin_memcpy(round_key + i * 16, round_key + j * 16, 16);
+        __builtin_memcpy(round_key + j * 16, temp, 16);
     }
 
     // apply inverse mix-column to middle rounds
-    for (size_t i = 1; i < rounds(); ++i) {
-        round_key += 4;
-        // clang-format off
-        round_key[0] =
-                AESTables::Decode0[AESTables::Encode1[(round_key[0] >> 24)       ] & 0xff] ^
-                AESTables::Decode1[AESTables::Encode1[(round_key[0] >> 16) & 0xff] & 0xff] ^
-                AESTables::Decode2[AESTables::Encode1[(round_key[0] >>  8) & 0xff] & 0xff] ^
-                AESTables::Decode3[AESTables::Encode1[(round_key[0]      ) & 0xff] & 0xff] ;
-        round_key[1] =
-                AESTables::Decode0[AESTables::Encode1[(round_key[1] >> 24)       ] & 0xff] ^
-                AESTables::Decode1[AESTables::Encode1[(round_key[1] >> 16) & 0xff] & 0xff] ^
-                AESTables::Decode2[AESTables::Encode1[(round_key[1] >>  8) & 0xff] & 0xff] ^
-                AESTables::Decode3[AESTables::Encode1[(round_key[1]      ) & 0xff] & 0xff] ;
-        round_key[2] =
-                AESTables::Decode0[AESTables::Encode1[(round_key[2] >> 24)       ] & 0xff] ^
-                AESTables::Decode1[AESTables::Encode1[(round_key[2] >> 16) & 0xff] & 0xff] ^
-                AESTables::Decode2[AESTables::Encode1[(round_key[2] >>  8) & 0xff] & 0xff] ^
-                AESTables::Decode3[AESTables::Encode1[(round_key[2]      ) & 0xff] & 0xff] ;
-        round_key[3] =
-                AESTables::Decode0[AESTables::Encode1[(round_key[3] >> 24)       ] & 0xff] ^
-                AESTables::Decode1[AESTables::Encode1[(round_key[3] >> 16) & 0xff] & 0xff] ^
-                AESTables::Decode2[AESTables::Encode1[(round_key[3] >>  8) & 0xff] & 0xff] ^
-                AESTables::Decode3[AESTables::Encode1[(round_key[3]      ) & 0xff] & 0xff] ;
-        // clang-format on
-    }
+    for (size_t i = 1; i < rounds(); ++i)
+        inverse_mix_columns(round_key + i * 16);
 }
 
 void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
-    u32 s0, s1, s2, s3, t0, t1, t2, t3;
-    size_t r { 0 };
-
-    const auto& dec_key = key();
-    const auto* round_keys = dec_key.round_keys();
-
-    s0 = get_key(in.bytes().offset_pointer(0)) ^ round_keys[0];
-    s1 = get_key(in.bytes().offset_pointer(4)) ^ round_keys[1];
-    s2 = get_key(in.bytes().offset_pointer(8)) ^ round_keys[2];
-    s3 = get_key(in.bytes().offset_pointer(12)) ^ round_keys[3];
-
-    r = dec_key.rounds() >> 1;
-
-    // apply the first |r - 1| rounds
-    auto i { 0 };
-    for (;;) {
-        ++i;
-        // clang-format off
-        t0 = AESTables::Encode0[(s0 >> 24)       ] ^
-             AESTables::Encode1[(s1 >> 16) & 0xff] ^
-             AESTables::Encode2[(s2 >>  8) & 0xff] ^
-             AESTables::Encode3[(s3      ) & 0xff] ^ round_keys[4];
-        t1 = AESTables::Encode0[(s1 >> 24)       ] ^
-             AESTables::Encode1[(s2 >> 16) & 0xff] ^
-             AESTables::Encode2[(s3 >>  8) & 0xff] ^
-             AESTables::Encode3[(s0      ) & 0xff] ^ round_keys[5];
-        t2 = AESTables::Encode0[(s2 >> 24)       ] ^
-             AESTables::Encode1[(s3 >> 16) & 0xff] ^
-             AESTables::Encode2[(s0 >>  8) & 0xff] ^
-             AESTables::Encode3[(s1      ) & 0xff] ^ round_keys[6];
-        t3 = AESTables::Encode0[(s3 >> 24)       ] ^
-             AESTables::Encode1[(s0 >> 16) & 0xff] ^
-             AESTables::Encode2[(s1 >>  8) & 0xff] ^
-             AESTables::Encode3[(s2      ) & 0xff] ^ round_keys[7];
-        // clang-format on
-
-        round_keys += 8;
-        --r;
-        ++i;
-        if (r == 0)
-            break;
-
-        // clang-format off
-        s0 = AESTables::Encode0[(t0 >> 24)       ] ^
-             AESTables::Encode1[(t1 >> 16) & 0xff] ^
-             AESTables::Encode2[(t2 >>  8) & 0xff] ^
-             AESTables::Encode3[(t3      ) & 0xff] ^ round_keys[0];
-        s1 = AESTables::Encode0[(t1 >> 24)       ] ^
-             AESTables::Encode1[(t2 >> 16) & 0xff] ^
-             AESTables::Encode2[(t3 >>  8) & 0xff] ^
-             AESTables::Encode3[(t0      ) & 0xff] ^ round_keys[1];
-        s2 = AESTables::Encode0[(t2 >> 24)       ] ^
-             AESTables::Encode1[(t3 >> 16) & 0xff] ^
-             AESTables::Encode2[(t0 >>  8) & 0xff] ^
-             AESTables::Encode3[(t1      ) & 0xff] ^ round_keys[2];
-        s3 = AESTables::Encode0[(t3 >> 24)       ] ^
-             AESTables::Encode1[(t0 >> 16) & 0xff] ^
-             AESTables::Encode2[(t1 >>  8) & 0xff] ^
-             AESTables::Encode3[(t2      ) & 0xff] ^ round_keys[3];
-        // clang-format on
+    const auto& enc_key = key();
+#if USE_AES_NI
+    if (s_use_aes_ni) {
+        encrypt_block_aes_ni(enc_key.round_keys(), enc_key.rounds(), in.bytes().data(), out.bytes().data());
+        return;
     }
-
-    // apply the last round and put the encrypted data into out
-    // clang-format off
-    s0 = (AESTables::Encode2[(t0 >> 24)       ] & 0xff000000) ^
-         (AESTables::Encode3[(t1 >> 16) & 0xff] & 0x00ff0000) ^
-         (AESTables::Encode0[(t2 >>  8) & 0xff] & 0x0000ff00) ^
-         (AESTables::Encode1[(t3      ) & 0xff] & 0x000000ff) ^ round_keys[0];
-    out.put(0, s0);
-
-    s1 = (AESTables::Encode2[(t1 >> 24)       ] & 0xff000000) ^
-         (AESTables::Encode3[(t2 >> 16) & 0xff] & 0x00ff0000) ^
-         (AESTables::Encode0[(t3 >>  8) & 0xff] & 0x0000ff00) ^
-         (AESTables::Encode1[(t0      ) & 0xff] & 0x000000ff) ^ round_keys[1];
-    out.put(4, s1);
-
-    s2 = (AESTables::Encode2[(t2 >> 24)       ] & 0xff000000) ^
-         (AESTables::Encode3[(t3 >> 16) & 0xff] & 0x00ff0000) ^
-         (AESTables::Encode0[(t0 >>  8) & 0xff] & 0x0000ff00) ^
-         (AESTables::Encode1[(t1      ) & 0xff] & 0x000000ff) ^ round_keys[2];
-    out.put(8, s2);
-
-    s3 = (AESTables::Encode2[(t3 >> 24)       ] & 0xff000000) ^
-         (AESTables::Encode3[(t0 >> 16) & 0xff] & 0x00ff0000) ^
-         (AESTables::Encode0[(t1 >>  8) & 0xff] & 0x0000ff00) ^
-         (AESTables::Encode1[(t2      ) & 0xff] & 0x000000ff) ^ round_keys[3];
-    out.put(12, s3);
-    // clang-format on
+#endif
+    encrypt_block_portable(enc_key.round_keys(), enc_key.rounds(), in.bytes().data(), out.bytes().data());
 }
 
 void AESCipher::decrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
-    u32 s0, s1, s2, s3, t0, t1, t2, t3;
-    size_t r { 0 };
-
     const auto& dec_key = key();
-    const auto* round_keys = dec_key.round_keys();
-
-    s0 = get_key(in.bytes().offset_pointer(0)) ^ round_keys[0];
-    s1 = get_key(in.bytes().offset_pointer(4)) ^ round_keys[1];
-    s2 = get_key(in.bytes().offset_pointer(8)) ^ round_keys[2];
-    s3 = get_key(in.bytes().offset_pointer(12)) ^ round_keys[3];
-
-    r = dec_key.rounds() >> 1;
-
-    // apply the first |r - 1| rounds
-    for (;;) {
-        // clang-format off
-        t0 = AESTables::Decode0[(s0 >> 24)       ] ^
-             AESTables::Decode1[(s3 >> 16) & 0xff] ^
-             AESTables::Decode2[(s2 >>  8) & 0xff] ^
-             AESTables::Decode3[(s1      ) & 0xff] ^ round_keys[4];
-        t1 = AESTables::Decode0[(s1 >> 24)       ] ^
-             AESTables::Decode1[(s0 >> 16) & 0xff] ^
-             AESTables::Decode2[(s3 >>  8) & 0xff] ^
-             AESTables::Decode3[(s2      ) & 0xff] ^ round_keys[5];
-        t2 = AESTables::Decode0[(s2 >> 24)       ] ^
-             AESTables::Decode1[(s1 >> 16) & 0xff] ^
-             AESTables::Decode2[(s0 >>  8) & 0xff] ^
-             AESTables::Decode3[(s3      ) & 0xff] ^ round_keys[6];
-        t3 = AESTables::Decode0[(s3 >> 24)       ] ^
-             AESTables::Decode1[(s2 >> 16) & 0xff] ^
-             AESTables::Decode2[(s1 >>  8) & 0xff] ^
-             AESTables::Decode3[(s0      ) & 0xff] ^ round_keys[7];
-        // clang-format on
-
-        round_keys += 8;
-        --r;
-        if (r == 0)
-            break;
-
-        // clang-format off
-        s0 = AESTables::Decode0[(t0 >> 24)       ] ^
-             AESTables::Decode1[(t3 >> 16) & 0xff] ^
-             AESTables::Decode2[(t2 >>  8) & 0xff] ^
-             AESTables::Decode3[(t1      ) & 0xff] ^ round_keys[0];
-        s1 = AESTables::Decode0[(t1 >> 24)       ] ^
-             AESTables::Decode1[(t0 >> 16) & 0xff] ^
-             AESTables::Decode2[(t3 >>  8) & 0xff] ^
-             AESTables::Decode3[(t2      ) & 0xff] ^ round_keys[1];
-        s2 = AESTables::Decode0[(t2 >> 24)       ] ^
-             AESTables::Decode1[(t1 >> 16) & 0xff] ^
-             AESTables::Decode2[(t0 >>  8) & 0xff] ^
-             AESTables::Decode3[(t3      ) & 0xff] ^ round_keys[2];
-        s3 = AESTables::Decode0[(t3 >> 24)       ] ^
-             AESTables::Decode1[(t2 >> 16) & 0xff] ^
-             AESTables::Decode2[(t1 >>  8) & 0xff] ^
-             AESTables::Decode3[(t0      ) & 0xff] ^ round_keys[3];
-        // clang-format on
+#if USE_AES_NI
+    if (s_use_aes_ni) {
+        decrypt_block_aes_ni(dec_key.round_keys(), dec_key.rounds(), in.bytes().data(), out.bytes().data());
+        return;
     }
-
-    // apply the last round and put the decrypted data into out
-    // clang-format off
-    s0 = ((u32)AESTables::Decode4[(t0 >> 24)       ] << 24) ^
-         ((u32)AESTables::Decode4[(t3 >> 16) & 0xff] << 16) ^
-         ((u32)AESTables::Decode4[(t2 >>  8) & 0xff] <<  8) ^
-         ((u32)AESTables::Decode4[(t1      ) & 0xff]      ) ^ round_keys[0];
-    out.put(0, s0);
-
-    s1 = ((u32)AESTables::Decode4[(t1 >> 24)       ] << 24) ^
-         ((u32)AESTables::Decode4[(t0 >> 16) & 0xff] << 16) ^
-         ((u32)AESTables::Decode4[(t3 >>  8) & 0xff] <<  8) ^
-         ((u32)AESTables::Decode4[(t2      ) & 0xff]      ) ^ round_keys[1];
-    out.put(4, s1);
-
-    s2 = ((u32)AESTables::Decode4[(t2 >> 24)       ] << 24) ^
-         ((u32)AESTables::Decode4[(t1 >> 16) & 0xff] << 16) ^
-         ((u32)AESTables::Decode4[(t0 >>  8) & 0xff] <<  8) ^
-         ((u32)AESTables::Decode4[(t3      ) & 0xff]      ) ^ round_keys[2];
-    out.put(8, s2);
-
-    s3 = ((u32)AESTables::Decode4[(t3 >> 24)       ] << 24) ^
-         ((u32)AESTables::Decode4[(t2 >> 16) & 0xff] << 16) ^
-         ((u32)AESTables::Decode4[(t1 >>  8) & 0xff] <<  8) ^
-         ((u32)AESTables::Decode4[(t0      ) & 0xff]      ) ^ round_keys[3];
-    out.put(12, s3);
-    // clang-format on
+#endif
+    decrypt_block_portable(dec_key.round_keys(), dec_key.rounds(), in.bytes().data(), out.bytes().data());
 }
 
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
@@ -78,12 +78,27 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        if (in.is_empty())
+        m_ghash->begin();
+        m_ghash->update(aad);
+
+        size_t cipher_length;
+        if (in.is_empty()) {
             CTR<T>::key_stream(out, iv);
-        else
-            CTR<T>::encrypt(in, out, iv);
+            m_ghash->update(out);
+            cipher_length = out.size();
+        } else {
+            // Hash each chunk of ciphertext right after encrypting it, while it is still in the cache.
+            VERIFY(in.size() <= out.size());
+            for (size_t offset = 0; offset < in.size(); offset += chunk_size) {
+                auto in_chunk = in.slice(offset, min(chunk_size, in.size() - offset));
+                auto out_chunk = out.slice(offset, in_chunk.size());
+                CTR<T>::encrypt_or_stream(&in_chunk, out_chunk, iv, &iv);
+                m_ghash->update(out_chunk);
+            }
+            cipher_length = in.size();
+        }
 
-        auto auth_tag = m_ghash->process(aad, out);
+        auto auth_tag = m_ghash->finish(aad.size(), cipher_length);
         block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
         block0.bytes().copy_to(tag);
     }
@@ -102,28 +117,38 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        auto auth_tag = m_ghash->process(aad, in);
-        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
-
-        auto test_consistency = [&] {
-            if (block0.block_size() != tag.size() || __builtin_memcmp(block0.bytes().data(), tag.data(), tag.size()) != 0)
-                return VerificationConsistency::Inconsistent;
-
-            return VerificationConsistency::Consistent;
-        };
-        // FIXME: This block needs constant-time comparisons.
+        m_ghash->begin();
+        m_ghash->update(aad);
 
         if (in.is_empty()) {
             out = {};
-            return test_consistency();
+        } else {
+            VERIFY(in.size() <= out.size());
+            for (size_t offset = 0; offset < in.size(); offset += chunk_size) {
+                auto in_chunk = in.slice(offset, min(chunk_size, in.size() - offset));
+                auto out_chunk = out.slice(offset, in_chunk.size());
+                m_ghash->update(in_chunk);
+                CTR<T>::encrypt_or_stream(&in_chunk, out_chunk, iv, &iv);
+            }
         }
 
-        CTR<T>::encrypt(in, out, iv);
-        return test_consistency();
+        auto auth_tag = m_ghash->finish(aad.size(), in.size());
+        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
+
+        if (block0.block_size() != tag.size())
+            return VerificationConsistency::Inconsistent;
+
+        // Compare in constant time, so the time taken doesn't tell how much of the tag was right.
+        u8 difference = 0;
+        for (size_t i = 0; i < tag.size(); ++i)
+            difference |= block0.bytes()[i] ^ tag[i];
+        return difference == 0 ? VerificationConsistency::Consistent : VerificationConsistency::Inconsistent;
     }
 
 private:
     static constexpr auto block_size = T::BlockType::BlockSizeInBits / 8;
+    // The ciphertext is encrypted and hashed in one pass, this many bytes at a time.
+    static constexpr size_t chunk_size = 64 * block_size;
     u8 m_auth_key_storage[block_size];
     Bytes m_auth_key { m_auth_key_storage, block_size };
     Optional<Authentication::GHash> m_ghash;
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Span.h>
+
+namespace Crypto::Curves {
+
+// A curve usable for ephemeral Diffie-Hellman key agreement.
+// All methods return an empty buffer on failure (e.g. an invalid peer key).
+class EllipticCurve {
+public:
+    virtual ~EllipticCurve() = default;
+
+    virtual size_t key_size() const = 0;
+    virtual ByteBuffer generate_private_key() = 0;
+    virtual ByteBuffer generate_public_key(ReadonlyBytes private_key) = 0;
+    virtual ByteBuffer compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key) = 0;
+};
+
+}
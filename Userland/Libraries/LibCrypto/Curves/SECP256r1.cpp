@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibCrypto/ASN1/DER.h>
+#include <LibCrypto/Curves/SECP256r1.h>
+
+namespace Crypto::Curves {
+
+// 256-bit integers as eight little-endian 32-bit words.
+struct U256 {
+    u32 words[8];
+};
+
+struct Modulus {
+    U256 value;
+    U256 r_squared; // 2^512 mod value, for converting into Montgomery form
+    u32 inverse;    // -value^-1 mod 2^32
+};
+
+// The field prime p = 2^256 - 2^224 + 2^192 + 2^96 - 1.
+static constexpr Modulus s_prime {
+    { { 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0xffffffff } },
+    { { 0x00000003, 0x00000000, 0xffffffff, 0xfffffffb, 0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004 } },
+    0x00000001,
+};
+
+// The order n of the base point.
+static constexpr Modulus s_order {
+    { { 0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff } },
+    { { 0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c, 0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94 } },
+    0xee00bc4f,
+};
+
+static constexpr U256 s_b { { 0x27d2604b, 0x3bce3c3e, 0xcc53b0f6, 0x651d06b0, 0x769886bc, 0xb3ebbd55, 0xaa3a93e7, 0x5ac635d8 } };
+static constexpr U256 s_generator_x { { 0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81, 0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2 } };
+static constexpr U256 s_generator_y { { 0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357, 0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2 } };
+static constexpr U256 s_one { { 1 } };
+static constexpr U256 s_zero {};
+
+static U256 import_big_endian(const u8* bytes)
+{
+    U256 result;
+    for (size_t i = 0; i < 8; ++i) {
+        auto* word = bytes + 28 - 4 * i;
+        result.words[i] = ((u32)word[0] << 24) | ((u32)word[1] << 16) | ((u32)word[2] << 8) | word[3];
+    }
+    return result;
+}
+
+static void export_big_endian(u8* bytes, const U256& value)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        auto* word = bytes + 28 - 4 * i;
+        word[0] = value.words[i] >> 24;
+        word[1] = value.words[i] >> 16;
+        word[2] = value.words[i] >> 8;
+        word[3] = value.words[i];
+    }
+}
+
+static u32 add_words(U256& out, const U256& a, const U256& b)
+{
+    u64 carry = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        carry += (u64)a.words[i] + b.words[i];
+        out.words[i] = (u32)carry;
+        carry >>= 32;
+    }
+    return (u32)carry;
+}
+
+static u32 subtract_words(U256& out, const U256& a, const U256& b)
+{
+    u64 borrow = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        u64 difference = (u64)a.words[i] - b.words[i] - borrow;
+        out.words[i] = (u32)difference;
+        borrow = difference >> 63;
+    }
+    return (u32)borrow;
+}
+
+// out = mask ? a : b, where mask is all ones or all zeros.
+static void select(U256& out, const U256& a, const U256& b, u32 mask)
+{
+    for (size_t i = 0; i < 8; ++i)
+        out.words[i] = (a.words[i] & mask) | (b.words[i] & ~mask);
+}
+
+static bool is_less_than(const U256& a, const U256& b)
+{
+    U256 unused;
+    return subtract_words(unused, a, b);
+}
+
+static bool is_zero(const U256& a)
+{
+    u32 accumulator = 0;
+    for (auto word : a.words)
+        accumulator |= word;
+    return accumulator == 0;
+}
+
+static bool is_equal(const U256& a, const U256& b)
+{
+    u32 accumulator = 0;
+    for (size_t i = 0; i < 8; ++i)
+        accumulator |= a.words[i] ^ b.words[i];
+    return accumulator == 0;
+}
+
+// Both inputs must already be reduced.
+static void modular_add(U256& out, const U256& a, const U256& b, const Modulus& modulus)
+{
+    U256 sum;
+    U256 reduced;
+    u32 carry = add_words(sum, a, b);
+    u32 borrow = subtract_words(reduced, sum, modulus.value);
+    select(out, reduced, sum, -(carry | (borrow ^ 1)));
+}
+
+static void modular_subtract(U256& out, const U256& a, const U256& b, const Modulus& modulus)
+{
+    U256 difference;
+    U256 corrected;
+    u32 borrow = subtract_words(difference, a, b);
+    add_words(corrected, difference, modulus.value);
+    select(out, corrected, difference, -borrow);
+}
+
+// out = a * b * 2^-256 mod m (CIOS Montgomery multiplication).
+static void montgomery_multiply(U256& out, const U256& a, const U256& b, const Modulus& modulus)
+{
+    u32 t[10] = {};
+    for (size_t i = 0; i < 8; ++i) {
+        u64 carry = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            carry += (u64)t[j] + (u64)a.words[j] * b.words[i];
+            t[j] = (u32)carry;
+            carry >>= 32;
+        }
+        carry += t[8];
+        t[8] = (u32)carry;
+        t[9] = (u32)(carry >> 32);
+
+        u32 q = t[0] * modulus.inverse;
+        carry = ((u64)t[0] + (u64)q * modulus.value.words[0]) >> 32;
+        for (size_t j = 1; j < 8; ++j) {
+            carry += (u64)t[j] + (u64)q * modulus.value.words[j];
+            t[j - 1] = (u32)carry;
+            carry >>= 32;
+        }
+        carry += t[8];
+        t[7] = (u32)carry;
+        t[8] = t[9] + (u32)(carry >> 32);
+    }
+
+    // The result is below 2m; subtract m once if needed.
+    U256 low;
+    for (size_t i = 0; i < 8; ++i)
+        low.words[i] = t[i];
+    U256 reduced;
+    u32 borrow = subtract_words(reduced, low, modulus.value);
+    select(out, reduced, low, -(t[8] | (borrow ^ 1)));
+}
+
+static void to_montgomery(U256& out, const U256& a, const Modulus& modulus)
+{
+    montgomery_multiply(out, a, modulus.r_squared, modulus);
+}
+
+static void from_montgomery(U256& out, const U256& a, const Modulus& modulus)
+{
+    montgomery_multiply(out, a, s_one, modulus);
+}
+
+// out = a^(m - 2), i.e. the inverse of a by Fermat's little theorem. Both in Montgomery form.
+// The exponent is public, so branching on its bits leaks nothing.
+static void montgomery_invert(U256& out, const U256& a, const Modulus& modulus)
+{
+    U256 exponent;
+    U256 two { { 2 } };
+    subtract_words(exponent, modulus.value, two);
+
+    U256 result;
+    to_montgomery(result, s_one, modulus);
+    for (int bit = 255; bit >= 0; --bit) {
+        montgomery_multiply(result, result, result, modulus);
+        if ((exponent.words[bit / 32] >> (bit % 32)) & 1)
+            montgomery_multiply(result, result, a, modulus);
+    }
+    out = result;
+}
+
+// Projective coordinates (X : Y : Z) in Montgomery form; the identity is (0 : 1 : 0).
+struct Point {
+    U256 x;
+    U256 y;
+    U256 z;
+};
+
+static U256 field_element(const U256& value)
+{
+    U256 result;
+    to_montgomery(result, value, s_prime);
+    return result;
+}
+
+static Point identity()
+{
+    return { s_zero, field_element(s_one), s_zero };
+}
+
+static void conditional_swap(Point& a, Point& b, u32 bit)
+{
+    u32 mask = -bit;
+    for (size_t i = 0; i < 8; ++i) {
+        u32 t = mask & (a.x.words[i] ^ b.x.words[i]);
+        a.x.words[i] ^= t;
+        b.x.words[i] ^= t;
+        t = mask & (a.y.words[i] ^ b.y.words[i]);
+        a.y.words[i] ^= t;
+        b.y.words[i] ^= t;
+        t = mask & (a.z.words[i] ^ b.z.words[i]);
+        a.z.words[i] ^= t;
+        b.z.words[i] ^= t;
+    }
+}
+
+// Complete addition for a = -3 (Renes, Costello, Batina 2015, algorithm 4).
+// It handles doubling and the identity without branches, so it is also used for doubling.
+static Point add_points(const Point& p1, const Point& p2)
+{
+    static const U256 b = field_element(s_b);
+    auto mul = [](U256& out, const U256& a, const U256& c) { montgomery_multiply(out, a, c, s_prime); };
+    auto add = [](U256& out, const U256& a, const U256& c) { modular_add(out, a, c, s_prime); };
+    auto sub = [](U256& out, const U256& a, const U256& c) { modular_subtract(out, a, c, s_prime); };
+
+    U256 t0, t1, t2, t3, t4, x3, y3, z3;
+    mul(t0, p1.x, p2.x);
+    mul(t1, p1.y, p2.y);
+    mul(t2, p1.z, p2.z);
+    add(t3, p1.x, p1.y);
+    add(t4, p2.x, p2.y);
+    mul(t3, t3, t4);
+    add(t4, t0, t1);
+    sub(t3, t3, t4);
+    add(t4, p1.y, p1.z);
+    add(x3, p2.y, p2.z);
+    mul(t4, t4, x3);
+    add(x3, t1, t2);
+    sub(t4, t4, x3);
+    add(x3, p1.x, p1.z);
+    add(y3, p2.x, p2.z);
+    mul(x3, x3, y3);
+    add(y3, t0, t2);
+    sub(y3, x3, y3);
+    mul(z3, b, t2);
+    sub(x3, y3, z3);
+    add(z3, x3, x3);
+    add(x3, x3, z3);
+    sub(z3, t1, x3);
+    add(x3, t1, x3);
+    mul(y3, b, y3);
+    add(t1, t2, t2);
+    add(t2, t1, t2);
+    sub(y3, y3, t2);
+    sub(y3, y3, t0);
+    add(t1, y3, y3);
+    add(y3, t1, y3);
+    add(t1, t0, t0);
+    add(t0, t1, t0);
+    sub(t0, t0, t2);
+    mul(t1, t4, y3);
+    mul(t2, t0, y3);
+    mul(y3, x3, z3);
+    add(y3, y3, t2);
+    mul(x3, t3, x3);
+    sub(x3, x3, t1);
+    mul(z3, t4, z3);
+    mul(t1, t3, t0);
+    add(z3, z3, t1);
+    return { x3, y3, z3 };
+}
+
+// Constant-time Montgomery ladder over all 256 scalar bits.
+static Point scalar_multiply(const U256& scalar, const Point& point)
+{
+    Point r0 = identity();
+    Point r1 = point;
+    for (int bit = 255; bit >= 0; --bit) {
+        u32 b = (scalar.words[bit / 32] >> (bit % 32)) & 1;
+        conditional_swap(r0, r1, b);
+        r1 = add_points(r0, r1);
+        r0 = add_points(r0, r0);
+        conditional_swap(r0, r1, b);
+    }
+    return r0;
+}
+
+// Converts to affine coordinates in normal form; returns false for the identity.
+static bool to_affine(U256& x, U256& y, const Point& point)
+{
+    if (is_zero(point.z))
+        return false;
+    U256 z_inverse;
+    montgomery_invert(z_inverse, point.z, s_prime);
+    montgomery_multiply(x, point.x, z_inverse, s_prime);
+    montgomery_multiply(y, point.y, z_inverse, s_prime);
+    from_montgomery(x, x, s_prime);
+    from_montgomery(y, y, s_prime);
+    return true;
+}
+
+static Point generator()
+{
+    return { field_element(s_generator_x), field_element(s_generator_y), field_element(s_one) };
+}
+
+// Parses an uncompressed SEC1 point, checking that it lies on the curve.
+static Optional<Point> import_point(ReadonlyBytes bytes)
+{
+    if (bytes.size() != SECP256r1::POINT_BYTE_SIZE || bytes[0] != 0x04)
+        return {};
+
+    auto x = import_big_endian(bytes.offset(1));
+    auto y = import_big_endian(bytes.offset(1 + SECP256r1::KEY_BYTE_SIZE));
+    if (!is_less_than(x, s_prime.value) || !is_less_than(y, s_prime.value))
+        return {};
+
+    Point point { field_element(x), field_element(y), field_element(s_one) };
+
+    // y^2 = x^3 - 3x + b
+    U256 left;
+    U256 right;
+    U256 three_x;
+    montgomery_multiply(left, point.y, point.y, s_prime);
+    montgomery_multiply(right, point.x, point.x, s_prime);
+    montgomery_multiply(right, right, point.x, s_prime);
+    modular_add(three_x, point.x, point.x, s_prime);
+    modular_add(three_x, three_x, point.x, s_prime);
+    modular_subtract(right, right, three_x, s_prime);
+    modular_add(right, right, field_element(s_b), s_prime);
+    if (!is_equal(left, right))
+        return {};
+
+    return point;
+}
+
+static ByteBuffer export_point(const Point& point)
+{
+    U256 x;
+    U256 y;
+    if (!to_affine(x, y, point))
+        return {};
+    auto buffer = ByteBuffer::create_uninitialized(SECP256r1::POINT_BYTE_SIZE);
+    buffer[0] = 0x04;
+    export_big_endian(buffer.offset_pointer(1), x);
+    export_big_endian(buffer.offset_pointer(1 + SECP256r1::KEY_BYTE_SIZE), y);
+    return buffer;
+}
+
+static Optional<U256> import_scalar(ReadonlyBytes bytes)
+{
+    if (bytes.size() != SECP256r1::KEY_BYTE_SIZE)
+        return {};
+    auto scalar = import_big_endian(bytes.data());
+    if (is_zero(scalar) || !is_less_than(scalar, s_order.value))
+        return {};
+    return scalar;
+}
+
+ByteBuffer SECP256r1::generate_private_key()
+{
+    auto buffer = ByteBuffer::create_uninitialized(KEY_BYTE_SIZE);
+    do {
+        fill_with_random(buffer.data(), buffer.size());
+    } while (!import_scalar(buffer).has_value());
+    return buffer;
+}
+
+ByteBuffer SECP256r1::generate_public_key(ReadonlyBytes private_key)
+{
+    auto scalar = import_scalar(private_key);
+    if (!scalar.has_value())
+        return {};
+    return export_point(scalar_multiply(scalar.value(), generator()));
+}
+
+ByteBuffer SECP256r1::compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key)
+{
+    auto scalar = import_scalar(private_key);
+    auto point = import_point(public_key);
+    if (!scalar.has_value() || !point.has_value())
+        return {};
+
+    U256 x;
+    U256 y;
+    if (!to_affine(x, y, scalar_multiply(scalar.value(), point.value())))
+        return {};
+    auto buffer = ByteBuffer::create_uninitialized(KEY_BYTE_SIZE);
+    export_big_endian(buffer.data(), x);
+    return buffer;
+}
+
+static Optional<U256> read_signature_integer(ASN1::Decoder& decoder)
+{
+    auto result = decoder.read<UnsignedBigInteger>();
+    if (result.is_error())
+        return {};
+    auto& integer = result.value();
+    if (integer.trimmed_length() > 8)
+        return {};
+    U256 value {};
+    for (size_t i = 0; i < integer.trimmed_length(); ++i)
+        value.words[i] = integer.words()[i];
+    if (is_zero(value) || !is_less_than(value, s_order.value))
+        return {};
+    return value;
+}
+
+bool SECP256r1::verify(ReadonlyBytes hash, ReadonlyBytes public_key, ReadonlyBytes signature)
+{
+    auto point = import_point(public_key);
+    if (!point.has_value())
+        return false;
+
+    ASN1::Decoder decoder(signature);
+    if (decoder.enter().has_value())
+        return false;
+    auto r = read_signature_integer(decoder);
+    auto s = read_signature_integer(decoder);
+    if (!r.has_value() || !s.has_value())
+        return false;
+
+    // e is the leftmost 256 bits of the hash, reduced mod n.
+    u8 truncated_hash[KEY_BYTE_SIZE] = {};
+    if (hash.size() >= KEY_BYTE_SIZE)
+        __builtin_memcpy(truncated_hash, hash.data(), KEY_BYTE_SIZE);
+    else
+        __builtin_memcpy(truncated_hash + KEY_BYTE_SIZE - hash.size(), hash.data(), hash.size());
+    auto e = import_big_endian(truncated_hash);
+    if (!is_less_than(e, s_order.value))
+        subtract_words(e, e, s_order.value);
+
+    // Multiplying a normal-form value by a Montgomery-form one yields a normal-form product,
+    // so u1 = e / s and u2 = r / s come straight out of montgomery_multiply().
+    U256 s_inverse;
+    to_montgomery(s_inverse, s.value(), s_order);
+    montgomery_invert(s_inverse, s_inverse, s_order);
+    U256 u1;
+    U256 u2;
+    montgomery_multiply(u1, e, s_inverse, s_order);
+    montgomery_multiply(u2, r.value(), s_inverse, s_order);
+
+    auto sum = add_points(scalar_multiply(u1, generator()), scalar_multiply(u2, point.value()));
+    U256 x;
+    U256 y;
+    if (!to_affine(x, y, sum))
+        return false;
+    if (!is_less_than(x, s_order.value))
+        subtract_words(x, x, s_order.value);
+    return is_equal(x, r.value());
+}
+
+}
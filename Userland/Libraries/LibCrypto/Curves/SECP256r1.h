@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibCrypto/Curves/EllipticCurve.h>
+
+namespace Crypto::Curves {
+
+// NIST P-256 (a.k.a. prime256v1), for ECDH and ECDSA signature verification.
+// Public keys are uncompressed SEC1 points (0x04 || X || Y), shared secrets are the X coordinate.
+class SECP256r1 final : public EllipticCurve {
+public:
+    static constexpr size_t KEY_BYTE_SIZE = 32;
+    static constexpr size_t POINT_BYTE_SIZE = 1 + 2 * KEY_BYTE_SIZE;
+
+    virtual size_t key_size() const override { return POINT_BYTE_SIZE; }
+    virtual ByteBuffer generate_private_key() override;
+    virtual ByteBuffer generate_public_key(ReadonlyBytes private_key) override;
+    virtual ByteBuffer compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key) override;
+
+    // Verifies a DER-encoded ECDSA signature (SEQUENCE { r INTEGER, s INTEGER }) over `hash`.
+    static bool verify(ReadonlyBytes hash, ReadonlyBytes public_key, ReadonlyBytes signature);
+};
+
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibCrypto/Curves/X25519.h>
+
+namespace Crypto::Curves {
+
+// Field elements of GF(2^255 - 19) are sixteen signed 16-bit limbs held in 64-bit words,
+// which leaves enough headroom to delay carries until after a multiplication.
+// Every operation is branch-free with respect to secret data.
+using FieldElement = i64[16];
+
+static constexpr FieldElement s_a24 = { 0xdb41, 1 }; // (486662 - 2) / 4
+
+static void carry(FieldElement& element)
+{
+    for (size_t i = 0; i < 16; ++i) {
+        element[i] += 1ll << 16;
+        i64 carry = element[i] >> 16;
+        if (i < 15)
+            element[i + 1] += carry - 1;
+        else
+            element[0] += 38 * (carry - 1); // 2^256 = 38 (mod p)
+        element[i] -= carry << 16;
+    }
+}
+
+static void conditional_swap(FieldElement& a, FieldElement& b, i64 bit)
+{
+    i64 mask = ~(bit - 1);
+    for (size_t i = 0; i < 16; ++i) {
+        i64 t = mask & (a[i] ^ b[i]);
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+static void add(FieldElement& out, const FieldElement& a, const FieldElement& b)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = a[i] + b[i];
+}
+
+static void subtract(FieldElement& out, const FieldElement& a, const FieldElement& b)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = a[i] - b[i];
+}
+
+static void multiply(FieldElement& out, const FieldElement& a, const FieldElement& b)
+{
+    i64 product[31] = {};
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < 16; ++j)
+            product[i + j] += a[i] * b[j];
+    }
+    for (size_t i = 0; i < 15; ++i)
+        product[i] += 38 * product[i + 16];
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = product[i];
+    carry(out);
+    carry(out);
+}
+
+static void square(FieldElement& out, const FieldElement& a)
+{
+    multiply(out, a, a);
+}
+
+static void invert(FieldElement& out, const FieldElement& a)
+{
+    // a^(p - 2), with the exponent bits known up front.
+    FieldElement c;
+    for (size_t i = 0; i < 16; ++i)
+        c[i] = a[i];
+    for (int bit = 253; bit >= 0; --bit) {
+        square(c, c);
+        if (bit != 2 && bit != 4)
+            multiply(c, c, a);
+    }
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = c[i];
+}
+
+static void unpack(FieldElement& out, const u8* bytes)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = bytes[2 * i] + ((i64)bytes[2 * i + 1] << 8);
+    out[15] &= 0x7fff;
+}
+
+static void pack(u8* bytes, const FieldElement& element)
+{
+    FieldElement t;
+    FieldElement m;
+    for (size_t i = 0; i < 16; ++i)
+        t[i] = element[i];
+    carry(t);
+    carry(t);
+    carry(t);
+
+    // Fully reduce by conditionally subtracting p (twice, as t may still be up to 2p).
+    for (size_t j = 0; j < 2; ++j) {
+        m[0] = t[0] - 0xffed;
+        for (size_t i = 1; i < 15; ++i) {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        i64 borrow = (m[15] >> 16) & 1;
+        m[14] &= 0xffff;
+        conditional_swap(t, m, 1 - borrow);
+    }
+
+    for (size_t i = 0; i < 16; ++i) {
+        bytes[2 * i] = t[i] & 0xff;
+        bytes[2 * i + 1] = t[i] >> 8;
+    }
+}
+
+static void scalar_multiply(u8* out, const u8* scalar, const u8* point)
+{
+    u8 clamped[32];
+    for (size_t i = 0; i < 32; ++i)
+        clamped[i] = scalar[i];
+    clamped[31] = (clamped[31] & 127) | 64;
+    clamped[0] &= 248;
+
+    FieldElement x;
+    unpack(x, point);
+
+    FieldElement a = { 1 };
+    FieldElement b;
+    FieldElement c = {};
+    FieldElement d = { 1 };
+    FieldElement e;
+    FieldElement f;
+    for (size_t i = 0; i < 16; ++i)
+        b[i] = x[i];
+
+    // Montgomery ladder, RFC 7748 section 5.
+    for (int i = 254; i >= 0; --i) {
+        i64 bit = (clamped[i >> 3] >> (i & 7)) & 1;
+        conditional_swap(a, b, bit);
+        conditional_swap(c, d, bit);
+        add(e, a, c);
+        subtract(a, a, c);
+        add(c, b, d);
+        subtract(b, b, d);
+        square(d, e);
+        square(f, a);
+        multiply(a, c, a);
+        multiply(c, b, e);
+        add(e, a, c);
+        subtract(a, a, c);
+        square(b, a);
+        subtract(c, d, f);
+        multiply(a, c, s_a24);
+        add(a, a, d);
+        multiply(c, c, a);
+        multiply(a, d, f);
+        multiply(d, b, x);
+        square(b, e);
+        conditional_swap(a, b, bit);
+        conditional_swap(c, d, bit);
+    }
+
+    invert(c, c);
+    multiply(a, a, c);
+    pack(out, a);
+}
+
+ByteBuffer X25519::generate_private_key()
+{
+    auto buffer = ByteBuffer::create_uninitialized(BYTES);
+    fill_with_random(buffer.data(), buffer.size());
+    return buffer;
+}
+
+ByteBuffer X25519::generate_public_key(ReadonlyBytes private_key)
+{
+    static constexpr u8 base_point[BYTES] = { 9 };
+    return compute_coordinate(private_key, { base_point, BYTES });
+}
+
+ByteBuffer X25519::compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key)
+{
+    if (private_key.size() != BYTES || public_key.size() != BYTES)
+        return {};
+
+    auto buffer = ByteBuffer::create_uninitialized(BYTES);
+    scalar_multiply(buffer.data(), private_key.data(), public_key.data());
+
+    // A low-order peer point yields the all-zero value, which must not be used as a secret.
+    u8 accumulator = 0;
+    for (size_t i = 0; i < BYTES; ++i)
+        accumulator |= buffer[i];
+    if (accumulator == 0)
+        return {};
+    return buffer;
+}
+
+}
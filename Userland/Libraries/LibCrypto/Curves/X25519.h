@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibCrypto/Curves/EllipticCurve.h>
+
+namespace Crypto::Curves {
+
+// Curve25519 Diffie-Hellman as specified in RFC 7748.
+class X25519 final : public EllipticCurve {
+public:
+    static constexpr size_t BYTES = 32;
+
+    virtual size_t key_size() const override { return BYTES; }
+    virtual ByteBuffer generate_private_key() override;
+    virtual ByteBuffer generate_public_key(ReadonlyBytes private_key) override;
+    virtual ByteBuffer compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key) override;
+};
+
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Optional.h>
+#include <AK/SIMD.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHA2.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <LibCrypto/CPUFeatures.h>
+#    define USE_AVX2 1
+#    define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#    define USE_AVX2 0
+#endif
+
+// SHA-1 and SHA-256 are sequential within one message, but independent messages can be
+// hashed side by side: word i of every vector below belongs to lane i, and each lane works
+// through its own message. With AVX2 that is eight messages per instruction; elsewhere the
+// compiler splits the vectors into whatever the target has.
+
+namespace Crypto {
+namespace Hash {
+
+using AK::SIMD::u32x8;
+
+static constexpr size_t Lanes = 8;
+static constexpr size_t BlockSize = 64;
+
+template<size_t StateWords>
+using LaneState = u32[StateWords][Lanes];
+using LaneBlocks = const u8* [Lanes];
+
+#define ROTATE_LEFT(x, bits) (((x) << (bits)) | ((x) >> (32 - (bits))))
+
+static ALWAYS_INLINE void load_big_endian_words(u32x8& words, const LaneBlocks& blocks, size_t index)
+{
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        auto* bytes = blocks[lane] + index * 4;
+        words[lane] = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    }
+}
+
+static ALWAYS_INLINE void sha256_transform_lanes(LaneState<8>& state, const LaneBlocks& blocks)
+{
+    u32x8 m[16];
+    u32x8 s[8];
+    __builtin_memcpy(s, state, sizeof(s));
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto& word = m[i % 16];
+        if (i < 16) {
+            load_big_endian_words(word, blocks, i);
+        } else {
+            auto w2 = m[(i - 2) % 16];
+            auto w15 = m[(i - 15) % 16];
+            auto sign1 = ROTATE_LEFT(w2, 15) ^ ROTATE_LEFT(w2, 13) ^ (w2 >> 10);
+            auto sign0 = ROTATE_LEFT(w15, 25) ^ ROTATE_LEFT(w15, 14) ^ (w15 >> 3);
+            word += sign1 + m[(i - 7) % 16] + sign0;
+        }
+
+        auto ep1 = ROTATE_LEFT(e, 26) ^ ROTATE_LEFT(e, 21) ^ ROTATE_LEFT(e, 7);
+        auto ch = (e & f) ^ (g & ~e);
+        auto temp0 = h + ep1 + ch + SHA256Constants::RoundConstants[i] + word;
+        auto ep0 = ROTATE_LEFT(a, 30) ^ ROTATE_LEFT(a, 19) ^ ROTATE_LEFT(a, 10);
+        auto maj = (a & b) ^ (a & c) ^ (b & c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + ep0 + maj;
+    }
+
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+    __builtin_memcpy(state, s, sizeof(s));
+}
+
+static ALWAYS_INLINE void sha1_transform_lanes(LaneState<5>& state, const LaneBlocks& blocks)
+{
+    u32x8 m[16];
+    u32x8 s[5];
+    __builtin_memcpy(s, state, sizeof(s));
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4];
+
+    for (size_t i = 0; i < 80; ++i) {
+        auto& word = m[i % 16];
+        if (i < 16) {
+            load_big_endian_words(word, blocks, i);
+        } else {
+            auto mixed = m[(i - 3) % 16] ^ m[(i - 8) % 16] ^ m[(i - 14) % 16] ^ word;
+            word = ROTATE_LEFT(mixed, 1);
+        }
+
+        u32x8 f;
+        u32 k;
+        if (i <= 19) {
+            f = (b & c) | (~b & d);
+            k = SHA1Constants::RoundConstants[0];
+        } else if (i <= 39) {
+            f = b ^ c ^ d;
+            k = SHA1Constants::RoundConstants[1];
+        } else if (i <= 59) {
+            f = (b & c) | (b & d) | (c & d);
+            k = SHA1Constants::RoundConstants[2];
+        } else {
+            f = b ^ c ^ d;
+            k = SHA1Constants::RoundConstants[3];
+        }
+        auto temp = ROTATE_LEFT(a, 5) + f + e + k + word;
+        e = d;
+        d = c;
+        c = ROTATE_LEFT(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    __builtin_memcpy(state, s, sizeof(s));
+}
+
+#undef ROTATE_LEFT
+
+static void sha256_transform_lanes_generic(LaneState<8>& state, const LaneBlocks& blocks) { sha256_transform_lanes(state, blocks); }
+static void sha1_transform_lanes_generic(LaneState<5>& state, const LaneBlocks& blocks) { sha1_transform_lanes(state, blocks); }
+
+#if USE_AVX2
+AVX2_TARGET static void sha256_transform_lanes_avx2(LaneState<8>& state, const LaneBlocks& blocks) { sha256_transform_lanes(state, blocks); }
+AVX2_TARGET static void sha1_transform_lanes_avx2(LaneState<5>& state, const LaneBlocks& blocks) { sha1_transform_lanes(state, blocks); }
+#endif
+
+// Feeds the messages through the lanes, each one block at a time, and refills a lane with the
+// next message as soon as its current one is done. The final padded blocks of each message are
+// built in the lane; everything before them is read in place.
+template<size_t StateWords, typename DigestType>
+static void hash_in_lanes(Span<const ReadonlyBytes> messages, Span<DigestType> digests, const u32 (&initial_state)[StateWords], void (*transform_lanes)(LaneState<StateWords>&, const LaneBlocks&))
+{
+    struct Lane {
+        Optional<size_t> message;
+        size_t next_block { 0 };
+        size_t full_blocks { 0 };
+        size_t total_blocks { 0 };
+        u8 tail[2 * BlockSize];
+    };
+
+    static constexpr u8 idle_block[BlockSize] {};
+    Lane lanes[Lanes];
+    LaneState<StateWords> state;
+    size_t next_message = 0;
+
+    auto start_next_message = [&](size_t lane_index) {
+        auto& lane = lanes[lane_index];
+        if (next_message == messages.size()) {
+            lane.message.clear();
+            return;
+        }
+
+        auto& message = messages[next_message];
+        lane.message = next_message++;
+        lane.next_block = 0;
+        lane.full_blocks = message.size() / BlockSize;
+
+        // The message is followed by 0x80, zeros and its length in bits as a big-endian u64.
+        auto remainder = message.size() % BlockSize;
+        auto tail_size = remainder < BlockSize - 8 ? BlockSize : 2 * BlockSize;
+        lane.total_blocks = lane.full_blocks + tail_size / BlockSize;
+        __builtin_memset(lane.tail, 0, tail_size);
+        __builtin_memcpy(lane.tail, message.data() + lane.full_blocks * BlockSize, remainder);
+        lane.tail[remainder] = 0x80;
+        u64 bit_length = (u64)message.size() * 8;
+        for (size_t i = 0; i < 8; ++i)
+            lane.tail[tail_size - 1 - i] = bit_length >> (i * 8);
+
+        for (size_t i = 0; i < StateWords; ++i)
+            state[i][lane_index] = initial_state[i];
+    };
+
+    for (size_t i = 0; i < Lanes; ++i)
+        start_next_message(i);
+
+    for (;;) {
+        LaneBlocks blocks;
+        bool any_lane_busy = false;
+        for (size_t i = 0; i < Lanes; ++i) {
+            auto& lane = lanes[i];
+            if (!lane.message.has_value()) {
+                blocks[i] = idle_block;
+                continue;
+            }
+            any_lane_busy = true;
+            if (lane.next_block < lane.full_blocks)
+                blocks[i] = messages[lane.message.value()].data() + lane.next_block * BlockSize;
+            else
+                blocks[i] = lane.tail + (lane.next_block - lane.full_blocks) * BlockSize;
+        }
+        if (!any_lane_busy)
+            break;
+
+        transform_lanes(state, blocks);
+
+        for (size_t i = 0; i < Lanes; ++i) {
+            auto& lane = lanes[i];
+            if (!lane.message.has_value() || ++lane.next_block < lane.total_blocks)
+                continue;
+
+            auto& digest = digests[lane.message.value()];
+            for (size_t word = 0; word < StateWords; ++word) {
+                for (size_t byte = 0; byte < 4; ++byte)
+                    digest.data[word * 4 + byte] = state[word][i] >> (24 - byte * 8);
+            }
+            start_next_message(i);
+        }
+    }
+}
+
+template<typename Hash>
+static bool hash_one_by_one(Span<const ReadonlyBytes> messages, Span<typename Hash::DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+#if USE_AVX2
+    // One message at a time with the SHA extensions beats eight lanes of AVX2.
+    bool prefer_one_by_one = cpu_features().sha;
+#else
+    bool prefer_one_by_one = false;
+#endif
+    if (!prefer_one_by_one && messages.size() > 1)
+        return false;
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = Hash::hash(messages[i].data(), messages[i].size());
+    return true;
+}
+
+void SHA256::hash_many(Span<const ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    if (hash_one_by_one<SHA256>(messages, digests))
+        return;
+#if USE_AVX2
+    if (cpu_features().avx2) {
+        hash_in_lanes(messages, digests, SHA256Constants::InitializationHashes, sha256_transform_lanes_avx2);
+        return;
+    }
+#endif
+    hash_in_lanes(messages, digests, SHA256Constants::InitializationHashes, sha256_transform_lanes_generic);
+}
+
+void SHA1::hash_many(Span<const ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    if (hash_one_by_one<SHA1>(messages, digests))
+        return;
+#if USE_AVX2
+    if (cpu_features().avx2) {
+        hash_in_lanes(messages, digests, SHA1Constants::InitializationHashes, sha1_transform_lanes_avx2);
+        return;
+    }
+#endif
+    hash_in_lanes(messages, digests, SHA1Constants::InitializationHashes, sha1_transform_lanes_generic);
+}
+
+}
+}
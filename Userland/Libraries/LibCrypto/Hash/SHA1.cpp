@@ -8,6 +8,15 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#    define USE_SHA_NI 1
+#    define SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#else
+#    define USE_SHA_NI 0
+#endif
+
 namespace Crypto {
 namespace Hash {
 
@@ -16,20 +25,20 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
     return (value << bits) | (value >> (32 - bits));
 }
 
-inline void SHA1::transform(const u8* data)
+static void transform_portable(u32 (&state)[5], const u8* data)
 {
     u32 blocks[80];
     for (size_t i = 0; i < 16; ++i)
         blocks[i] = AK::convert_between_host_and_network_endian(((const u32*)data)[i]);
 
     // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
-    for (size_t i = 16; i < Rounds; ++i)
+    for (size_t i = 16; i < 80; ++i)
         blocks[i] = ROTATE_LEFT(blocks[i - 3] ^ blocks[i - 8] ^ blocks[i - 14] ^ blocks[i - 16], 1);
 
-    auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
+    auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
     u32 f, k;
 
-    for (size_t i = 0; i < Rounds; ++i) {
+    for (size_t i = 0; i < 80; ++i) {
         if (i <= 19) {
             f = (b & c) | ((~b) & d);
             k = SHA1Constants::RoundConstants[0];
@@ -51,11 +60,11 @@ inline void SHA1::transform(const u8* data)
         a = temp;
     }
 
-    m_state[0] += a;
-    m_state[1] += b;
-    m_state[2] += c;
-    m_state[3] += d;
-    m_state[4] += e;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
 
     // "security" measures, as if SHA1 is secure
     a = 0;
@@ -66,16 +75,103 @@ inline void SHA1::transform(const u8* data)
     __builtin_memset(blocks, 0, 16 * sizeof(u32));
 }
 
-void SHA1::update(const u8* message, size_t length)
+#if USE_SHA_NI
+// Four rounds per SHA1RNDS4, whose immediate selects the round function and constant.
+// SHA1MSG1, a XOR and SHA1MSG2 extend the message schedule four words at a time.
+SHA_NI_TARGET static void transform_sha_ni(u32 (&state)[5], const u8* data, size_t block_count)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    auto const byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+    auto e = _mm_set_epi32(state[4], 0, 0, 0);
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto abcd_before = abcd;
+        auto e_before = e;
+        auto abcd_of_previous_group = abcd;
+        __m128i words[4];
+
+        for (size_t group = 0; group < 20; ++group) {
+            auto& current = words[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + group * 16)), byte_swap);
+            else
+                current = _mm_sha1msg2_epu32(current, words[(group + 3) % 4]);
+
+            // E for this group is the rotated A from four rounds ago, plus the message words.
+            auto e_and_message = group == 0 ? _mm_add_epi32(e, current) : _mm_sha1nexte_epu32(abcd_of_previous_group, current);
+            abcd_of_previous_group = abcd;
+            switch (group / 5) {
+            case 0:
+                abcd = _mm_sha1rnds4_epu32(abcd, e_and_message, 0);
+                break;
+            case 1:
+                abcd = _mm_sha1rnds4_epu32(abcd, e_and_message, 1);
+                break;
+            case 2:
+                abcd = _mm_sha1rnds4_epu32(abcd, e_and_message, 2);
+                break;
+            default:
+                abcd = _mm_sha1rnds4_epu32(abcd, e_and_message, 3);
+                break;
+            }
+
+            // Start on the words of groups + 3 and + 2, which reuse the slots of groups - 1 and - 2.
+            if (group >= 1 && group <= 16)
+                words[(group + 3) % 4] = _mm_sha1msg1_epu32(words[(group + 3) % 4], current);
+            if (group >= 2 && group <= 17)
+                words[(group + 2) % 4] = _mm_xor_si128(words[(group + 2) % 4], current);
         }
-        m_data_buffer[m_data_length++] = message[i];
+
+        e = _mm_sha1nexte_epu32(abcd_of_previous_group, e_before);
+        abcd = _mm_add_epi32(abcd, abcd_before);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = _mm_extract_epi32(e, 3);
+}
+
+static const bool s_use_sha_ni = cpu_features().sha && cpu_features().sse41;
+#endif
+
+void SHA1::transform(const u8* data, size_t block_count)
+{
+#if USE_SHA_NI
+    if (s_use_sha_ni) {
+        transform_sha_ni(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < block_count; ++i)
+        transform_portable(m_state, data + i * BlockSize);
+}
+
+void SHA1::update(const u8* message, size_t length)
+{
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks are hashed straight out of the message.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
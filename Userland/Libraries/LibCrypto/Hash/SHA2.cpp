@@ -7,6 +7,15 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#    define USE_SHA_NI 1
+#    define SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#else
+#    define USE_SHA_NI 0
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -25,7 +34,7 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
-inline void SHA256::transform(const u8* data)
+static void transform_portable(u32 (&state)[8], const u8* data)
 {
     u32 m[64];
 
@@ -34,16 +43,16 @@ inline void SHA256::transform(const u8* data)
         m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
     }
 
-    for (; i < BlockSize; ++i) {
+    for (; i < 64; ++i) {
         m[i] = SIGN1(m[i - 2]) + m[i - 7] + SIGN0(m[i - 15]) + m[i - 16];
     }
 
-    auto a = m_state[0], b = m_state[1],
-         c = m_state[2], d = m_state[3],
-         e = m_state[4], f = m_state[5],
-         g = m_state[6], h = m_state[7];
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
 
-    for (size_t i = 0; i < Rounds; ++i) {
+    for (size_t i = 0; i < 64; ++i) {
         auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[i] + m[i];
         auto temp1 = EP0(a) + MAJ(a, b, c);
         h = g;
@@ -56,26 +65,98 @@ inline void SHA256::transform(const u8* data)
         a = temp0 + temp1;
     }
 
-    m_state[0] += a;
-    m_state[1] += b;
-    m_state[2] += c;
-    m_state[3] += d;
-    m_state[4] += e;
-    m_state[5] += f;
-    m_state[6] += g;
-    m_state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 }
 
-void SHA256::update(const u8* message, size_t length)
+#if USE_SHA_NI
+// Two rounds per SHA256RNDS2, which keeps the state split as ABEF and CDGH.
+// SHA256MSG1 and SHA256MSG2 extend the message schedule four words at a time.
+SHA_NI_TARGET static void transform_sha_ni(u32 (&state)[8], const u8* data, size_t block_count)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    auto const byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto abef_before = abef;
+        auto cdgh_before = cdgh;
+        __m128i words[4];
+
+        for (size_t group = 0; group < 16; ++group) {
+            auto& current = words[group % 4];
+            if (group < 4) {
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + group * 16)), byte_swap);
+            } else {
+                auto const& previous = words[(group + 3) % 4];
+                auto sum = _mm_add_epi32(_mm_sha256msg1_epu32(current, words[(group + 1) % 4]), _mm_alignr_epi8(previous, words[(group + 2) % 4], 4));
+                current = _mm_sha256msg2_epu32(sum, previous);
+            }
+            auto message = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256Constants::RoundConstants[group * 4])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
         }
-        m_data_buffer[m_data_length++] = message[i];
+
+        abef = _mm_add_epi32(abef, abef_before);
+        cdgh = _mm_add_epi32(cdgh, cdgh_before);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+static const bool s_use_sha_ni = cpu_features().sha && cpu_features().sse41;
+#endif
+
+void SHA256::transform(const u8* data, size_t block_count)
+{
+#if USE_SHA_NI
+    if (s_use_sha_ni) {
+        transform_sha_ni(m_state, data, block_count);
+        return;
     }
+#endif
+    for (size_t i = 0; i < block_count; ++i)
+        transform_portable(m_state, data + i * BlockSize);
+}
+
+void SHA256::update(const u8* message, size_t length)
+{
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed straight out of the message.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA256::DigestType SHA256::digest()
@@ -18,8 +18,6 @@ UnsignedBigInteger ModularInverse(const UnsignedBigInteger& a_, const UnsignedBi
 
     UnsignedBigInteger temp_1;
     UnsignedBigInteger temp_2;
-    UnsignedBigInteger temp_3;
-    UnsignedBigInteger temp_4;
     UnsignedBigInteger temp_minus;
     UnsignedBigInteger temp_quotient;
     UnsignedBigInteger temp_d;
@@ -28,7 +26,7 @@ UnsignedBigInteger ModularInverse(const UnsignedBigInteger& a_, const UnsignedBi
     UnsignedBigInteger temp_x;
     UnsignedBigInteger result;
 
-    UnsignedBigIntegerAlgorithms::modular_inverse_without_allocation(a_, b, temp_1, temp_2, temp_3, temp_4, temp_minus, temp_quotient, temp_d, temp_u, temp_v, temp_x, result);
+    UnsignedBigIntegerAlgorithms::modular_inverse_without_allocation(a_, b, temp_1, temp_2, temp_minus, temp_quotient, temp_d, temp_u, temp_v, temp_x, result);
     return result;
 }
 
@@ -57,13 +55,11 @@ UnsignedBigInteger ModularPower(const UnsignedBigInteger& b, const UnsignedBigIn
     UnsignedBigInteger result;
     UnsignedBigInteger temp_1;
     UnsignedBigInteger temp_2;
-    UnsignedBigInteger temp_3;
-    UnsignedBigInteger temp_4;
     UnsignedBigInteger temp_multiply;
     UnsignedBigInteger temp_quotient;
     UnsignedBigInteger temp_remainder;
 
-    UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(ep, base, m, temp_1, temp_2, temp_3, temp_4, temp_multiply, temp_quotient, temp_remainder, result);
+    UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(ep, base, m, temp_1, temp_2, temp_multiply, temp_quotient, temp_remainder, result);
 
     return result;
 }
@@ -74,13 +70,11 @@ UnsignedBigInteger GCD(const UnsignedBigInteger& a, const UnsignedBigInteger& b)
     UnsignedBigInteger temp_b { b };
     UnsignedBigInteger temp_1;
     UnsignedBigInteger temp_2;
-    UnsignedBigInteger temp_3;
-    UnsignedBigInteger temp_4;
     UnsignedBigInteger temp_quotient;
     UnsignedBigInteger temp_remainder;
     UnsignedBigInteger output;
 
-    UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder, output);
+    UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_quotient, temp_remainder, output);
 
     return output;
 }
@@ -91,22 +85,20 @@ UnsignedBigInteger LCM(const UnsignedBigInteger& a, const UnsignedBigInteger& b)
     UnsignedBigInteger temp_b { b };
     UnsignedBigInteger temp_1;
     UnsignedBigInteger temp_2;
-    UnsignedBigInteger temp_3;
-    UnsignedBigInteger temp_4;
     UnsignedBigInteger temp_quotient;
     UnsignedBigInteger temp_remainder;
     UnsignedBigInteger gcd_output;
     UnsignedBigInteger output { 0 };
 
-    UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder, gcd_output);
+    UnsignedBigIntegerAlgorithms::destructive_GCD_without_allocation(temp_a, temp_b, temp_1, temp_2, temp_quotient, temp_remainder, gcd_output);
     if (gcd_output == 0) {
         dbgln_if(NT_DEBUG, "GCD is zero");
         return output;
     }
 
     // output = (a / gcd_output) * b
-    UnsignedBigIntegerAlgorithms::divide_without_allocation(a, gcd_output, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
-    UnsignedBigIntegerAlgorithms::multiply_without_allocation(temp_quotient, b, temp_1, temp_2, temp_3, output);
+    UnsignedBigIntegerAlgorithms::divide_without_allocation(a, gcd_output, temp_1, temp_2, temp_quotient, temp_remainder);
+    UnsignedBigIntegerAlgorithms::multiply_without_allocation(temp_quotient, b, temp_1, output);
 
     dbgln_if(NT_DEBUG, "quot: {} rem: {} out: {}", temp_quotient, temp_remainder, output);
 
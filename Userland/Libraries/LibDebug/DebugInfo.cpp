@@ -121,13 +121,19 @@ Optional<DebugInfo::SourcePosition> DebugInfo::get_source_position(FlatPtr targe
     if (target_address < m_sorted_lines[0].address)
         return {};
 
-    // TODO: We can do a binary search here
-    for (size_t i = 0; i < m_sorted_lines.size() - 1; ++i) {
-        if (m_sorted_lines[i + 1].address > target_address) {
-            return SourcePosition::from_line_info(m_sorted_lines[i]);
-        }
+    // Find the first line that starts after the target address, the one before it is the one containing it.
+    size_t low = 1;
+    size_t high = m_sorted_lines.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (m_sorted_lines[middle].address > target_address)
+            high = middle;
+        else
+            low = middle + 1;
     }
-    return {};
+    if (low == m_sorted_lines.size())
+        return {};
+    return SourcePosition::from_line_info(m_sorted_lines[low - 1]);
 }
 
 Optional<DebugInfo::SourcePositionAndAddress> DebugInfo::get_address_from_source_position(String const& file, size_t line) const
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <IndexServer/IndexClientEndpoint.h>
+#include <IndexServer/IndexServerEndpoint.h>
+#include <LibDesktop/FileIndex.h>
+#include <LibIPC/ServerConnection.h>
+
+namespace Desktop {
+
+class IndexServerConnection final
+    : public IPC::ServerConnection<IndexClientEndpoint, IndexServerEndpoint>
+    , public IndexClientEndpoint {
+    C_OBJECT(IndexServerConnection)
+private:
+    IndexServerConnection()
+        : IPC::ServerConnection<IndexClientEndpoint, IndexServerEndpoint>(*this, "/tmp/portal/index")
+    {
+    }
+};
+
+static IndexServerConnection& connection()
+{
+    static auto connection = IndexServerConnection::construct();
+    return connection;
+}
+
+Optional<Vector<String>> FileIndex::search(String const& query, String const& directory, size_t max_results)
+{
+    auto response_or_error = connection().try_search(query, directory, max_results);
+    if (response_or_error.is_error()) {
+        dbgln("FileIndex::search: Failed");
+        return {};
+    }
+    return response_or_error.release_value();
+}
+
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Forward.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace Desktop {
+
+// Looks up files by name in the index that IndexServer keeps of the whole file system.
+class FileIndex {
+public:
+    // The paths of files whose name contains `query`, ignoring case. When `directory` isn't empty, only files below it
+    // are considered. Returns nothing if IndexServer isn't there to ask.
+    static Optional<Vector<String>> search(String const& query, String const& directory = {}, size_t max_results = 100);
+};
+
+}
@@ -35,6 +35,9 @@ namespace ELF {
 static HashMap<String, NonnullRefPtr<ELF::DynamicLoader>> s_loaders;
 static String s_main_program_name;
 static OrderedHashMap<String, NonnullRefPtr<ELF::DynamicObject>> s_global_objects;
+// NOTE: The names are the ones from the string tables of the loaded objects, which stay mapped
+//       until the process exits, as there's no unload support yet.
+static HashMap<StringView, DynamicObject::SymbolLookupResult> s_global_symbol_cache;
 
 using EntryPointFunction = int (*)(int, char**, char**);
 using LibCExitFunction = void (*)(int);
@@ -60,6 +63,11 @@ static Result<void, DlErrorMessage> __dladdr(void* addr, Dl_info* info);
 
 Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(const StringView& name)
 {
+    // Most symbols are referenced by more than one object, and every one of them is resolved by walking
+    // the hash tables of all the global objects in load order.
+    if (auto cached_result = s_global_symbol_cache.get(name); cached_result.has_value())
+        return cached_result;
+
     Optional<DynamicObject::SymbolLookupResult> weak_result;
 
     auto symbol = DynamicObject::HashSymbol { name };
@@ -68,8 +76,12 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
         auto res = lib.value->lookup_symbol(symbol);
         if (!res.has_value())
             continue;
-        if (res.value().bind == STB_GLOBAL)
+        if (res.value().bind == STB_GLOBAL) {
+            // Objects are only ever appended to s_global_objects, so the first global definition stays the one
+            // that wins. Weak definitions and missing symbols could still be overridden by a later dlopen().
+            s_global_symbol_cache.set(name, res.value());
             return res;
+        }
         if (res.value().bind == STB_WEAK && !weak_result.has_value())
             weak_result = res;
         // We don't want to allow local symbols to be pulled in to other modules
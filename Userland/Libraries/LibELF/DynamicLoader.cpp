@@ -160,21 +160,30 @@ bool DynamicLoader::load_stage_2(unsigned flags)
     VERIFY(flags & RTLD_GLOBAL);
 
     if (m_dynamic_object->has_text_relocations()) {
-        for (auto& text_segment : m_text_segments) {
-            VERIFY(text_segment.address().get() != 0);
+        auto make_segment_writable = [](LoadedSegment const& segment) {
+            VERIFY(segment.address().get() != 0);
 
 #ifndef AK_OS_MACOS
-            // Remap this text region as private.
-            if (mremap(text_segment.address().as_ptr(), text_segment.size(), text_segment.size(), MAP_PRIVATE) == MAP_FAILED) {
+            // Remap this region as private.
+            if (mremap(segment.address().as_ptr(), segment.size(), segment.size(), MAP_PRIVATE) == MAP_FAILED) {
                 perror("mremap .text: MAP_PRIVATE");
                 return false;
             }
 #endif
 
-            if (0 > mprotect(text_segment.address().as_ptr(), text_segment.size(), PROT_READ | PROT_WRITE)) {
+            if (0 > mprotect(segment.address().as_ptr(), segment.size(), PROT_READ | PROT_WRITE)) {
                 perror("mprotect .text: PROT_READ | PROT_WRITE"); // FIXME: dlerror?
                 return false;
             }
+            return true;
+        };
+        for (auto& text_segment : m_text_segments) {
+            if (!make_segment_writable(text_segment))
+                return false;
+        }
+        for (auto& rodata_segment : m_rodata_segments) {
+            if (!make_segment_writable(rodata_segment))
+                return false;
         }
     }
     do_main_relocations();
@@ -213,6 +222,14 @@ Result<NonnullRefPtr<DynamicObject>, DlErrorMessage> DynamicLoader::load_stage_3
         }
     }
 
+    if (m_dynamic_object->has_text_relocations()) {
+        for (auto& rodata_segment : m_rodata_segments) {
+            if (mprotect(rodata_segment.address().as_ptr(), rodata_segment.size(), PROT_READ) < 0) {
+                return DlErrorMessage { String::formatted("mprotect .rodata: PROT_READ: {}", strerror(errno)) };
+            }
+        }
+    }
+
     if (m_relro_segment_size) {
         if (mprotect(m_relro_segment_address.as_ptr(), m_relro_segment_size, PROT_READ) < 0) {
             return DlErrorMessage { String::formatted("mprotect .relro: PROT_READ: {}", strerror(errno)) };
@@ -247,6 +264,7 @@ void DynamicLoader::load_program_headers()
 {
     Vector<ProgramHeaderRegion> load_regions;
     Vector<ProgramHeaderRegion> text_regions;
+    Vector<ProgramHeaderRegion> rodata_regions;
     Vector<ProgramHeaderRegion> data_regions;
     Optional<ProgramHeaderRegion> tls_region;
     Optional<ProgramHeaderRegion> relro_region;
@@ -263,6 +281,10 @@ void DynamicLoader::load_program_headers()
             load_regions.append(region);
             if (region.is_executable()) {
                 text_regions.append(region);
+            } else if (!region.is_writable() && region.size_in_memory() == region.size_in_image()) {
+                // Read-only data is never written to unless there are text relocations, so it can be
+                // mapped straight from the file and shared between processes just like .text.
+                rodata_regions.append(region);
             } else {
                 data_regions.append(region);
             }
@@ -274,7 +296,7 @@ void DynamicLoader::load_program_headers()
         }
     });
 
-    VERIFY(!text_regions.is_empty() || !data_regions.is_empty());
+    VERIFY(!text_regions.is_empty() || !rodata_regions.is_empty() || !data_regions.is_empty());
 
     auto compare_load_address = [](ProgramHeaderRegion& a, ProgramHeaderRegion& b) {
         return a.desired_load_address().as_ptr() < b.desired_load_address().as_ptr();
@@ -282,9 +304,10 @@ void DynamicLoader::load_program_headers()
 
     quick_sort(load_regions, compare_load_address);
     quick_sort(text_regions, compare_load_address);
+    quick_sort(rodata_regions, compare_load_address);
     quick_sort(data_regions, compare_load_address);
 
-    // Process regions in order: .text, .data, .tls
+    // Process regions in order: .text, .rodata, .data, .tls
     void* requested_load_address = m_elf_image.is_dynamic() ? nullptr : load_regions.first().desired_load_address().as_ptr();
 
     int reservation_mmap_flags = MAP_ANON | MAP_PRIVATE | MAP_NORESERVE;
@@ -341,6 +364,28 @@ void DynamicLoader::load_program_headers()
         m_text_segments.append({ VirtualAddress { (FlatPtr)text_segment_begin }, ph_text_end - ph_text_base });
     }
 
+    for (auto& rodata_region : rodata_regions) {
+        FlatPtr ph_rodata_desired_base = rodata_region.desired_load_address().get();
+        FlatPtr ph_rodata_base = rodata_region.desired_load_address().page_base().get();
+        FlatPtr ph_rodata_end = ph_rodata_base + round_up_to_power_of_two(rodata_region.size_in_memory() + (size_t)(rodata_region.desired_load_address().as_ptr() - ph_rodata_base), PAGE_SIZE);
+
+        auto* rodata_segment_begin = (u8*)mmap_with_name(
+            (u8*)reservation + ph_rodata_base - ph_load_base,
+            ph_rodata_desired_base - ph_rodata_base + rodata_region.size_in_image(),
+            PROT_READ,
+            MAP_FILE | MAP_SHARED | MAP_FIXED,
+            m_image_fd,
+            VirtualAddress { rodata_region.offset() }.page_base().get(),
+            String::formatted("{}: .rodata", m_filename).characters());
+
+        if (rodata_segment_begin == MAP_FAILED) {
+            perror("mmap rodata");
+            VERIFY_NOT_REACHED();
+        }
+
+        m_rodata_segments.append({ VirtualAddress { (FlatPtr)rodata_segment_begin }, ph_rodata_end - ph_rodata_base });
+    }
+
     VERIFY(requested_load_address == nullptr || requested_load_address == reservation);
 
     if (relro_region.has_value()) {
@@ -145,6 +145,7 @@ private:
 
     VirtualAddress m_base_address;
     Vector<LoadedSegment> m_text_segments;
+    Vector<LoadedSegment> m_rodata_segments;
 
     VirtualAddress m_relro_segment_address;
     size_t m_relro_segment_size { 0 };
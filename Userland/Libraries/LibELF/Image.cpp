@@ -67,9 +67,7 @@ StringView Image::section_index_to_string(unsigned index) const
 unsigned Image::symbol_count() const
 {
     VERIFY(m_valid);
-    if (!section_count())
-        return 0;
-    return section(m_symbol_table_section_index).entry_count();
+    return m_symbol_count;
 }
 
 void Image::dump() const
@@ -171,6 +169,13 @@ bool Image::parse()
         }
     }
 
+    if (m_symbol_table_section_index) {
+        auto symbol_table = section(m_symbol_table_section_index);
+        m_symbol_count = symbol_table.entry_count();
+        if (m_symbol_count)
+            m_symbol_table = reinterpret_cast<const ElfW(Sym)*>(raw_data(symbol_table.offset()));
+    }
+
     return m_valid;
 }
 
@@ -232,9 +237,8 @@ const ElfW(Shdr) & Image::section_header(unsigned index) const
 Image::Symbol Image::symbol(unsigned index) const
 {
     VERIFY(m_valid);
-    VERIFY(index < symbol_count());
-    auto* raw_syms = reinterpret_cast<const ElfW(Sym)*>(raw_data(section(m_symbol_table_section_index).offset()));
-    return Symbol(*this, index, raw_syms[index]);
+    VERIFY(index < m_symbol_count);
+    return Symbol(*this, index, m_symbol_table[index]);
 }
 
 Image::Section Image::section(unsigned index) const
@@ -275,12 +279,18 @@ Optional<Image::RelocationSection> Image::Section::relocations() const
 Optional<Image::Section> Image::lookup_section(const StringView& name) const
 {
     VERIFY(m_valid);
-    for (unsigned i = 0; i < section_count(); ++i) {
-        auto section = this->section(i);
-        if (section.name() == name)
-            return section;
+    if (m_section_index_by_name.is_empty()) {
+        m_section_index_by_name.ensure_capacity(section_count());
+        for (unsigned i = 0; i < section_count(); ++i) {
+            auto section_name = section(i).name();
+            if (!m_section_index_by_name.contains(section_name))
+                m_section_index_by_name.set(section_name, i);
+        }
     }
-    return {};
+    auto it = m_section_index_by_name.find(name);
+    if (it == m_section_index_by_name.end())
+        return {};
+    return section(it->value);
 }
 
 StringView Image::Symbol::raw_data() const
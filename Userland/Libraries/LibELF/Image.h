@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Concepts.h>
+#include <AK/HashMap.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <Kernel/VirtualAddress.h>
@@ -251,6 +252,13 @@ private:
     unsigned m_symbol_table_section_index { 0 };
     unsigned m_string_table_section_index { 0 };
 
+    // Found once by parse(), as every symbol lookup needs them.
+    const ElfW(Sym)* m_symbol_table { nullptr };
+    unsigned m_symbol_count { 0 };
+
+    // The first section with each name, indexed on the first lookup_section().
+    mutable HashMap<StringView, unsigned> m_section_index_by_name;
+
     struct SortedSymbol {
         FlatPtr address;
         StringView name;
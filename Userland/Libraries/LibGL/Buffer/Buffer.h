@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/RefCounted.h>
+#include <LibGL/GL/gl.h>
+
+namespace GL {
+
+// The storage behind a buffer object name, as filled in by glBufferData() and glBufferSubData().
+class Buffer : public RefCounted<Buffer> {
+public:
+    Buffer() = default;
+
+    ByteBuffer& data() { return m_data; }
+    const ByteBuffer& data() const { return m_data; }
+
+    GLenum usage() const { return m_usage; }
+    void set_usage(GLenum usage) { m_usage = usage; }
+
+private:
+    ByteBuffer m_data;
+    GLenum m_usage { GL_STATIC_DRAW };
+};
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "GL/gl.h"
+#include "GLContext.h"
+
+extern GL::GLContext* g_gl_context;
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    g_gl_context->gl_gen_buffers(n, buffers);
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    g_gl_context->gl_delete_buffers(n, buffers);
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    g_gl_context->gl_bind_buffer(target, buffer);
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    g_gl_context->gl_buffer_data(target, size, data, usage);
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    g_gl_context->gl_buffer_sub_data(target, offset, size, data);
+}
@@ -25,6 +25,16 @@ void glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei widt
     g_gl_context->gl_tex_image_2d(target, level, internalFormat, width, height, border, format, type, data);
 }
 
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    g_gl_context->gl_tex_parameter(target, pname, param);
+}
+
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    g_gl_context->gl_tex_parameter(target, pname, param);
+}
+
 void glBindTexture(GLenum target, GLuint texture)
 {
     g_gl_context->gl_bind_texture(target, texture);
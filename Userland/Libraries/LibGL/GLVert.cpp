@@ -159,3 +159,38 @@ void glTranslatef(GLfloat x, GLfloat y, GLfloat z)
 {
     g_gl_context->gl_translate(x, y, z);
 }
+
+void glEnableClientState(GLenum array)
+{
+    g_gl_context->gl_enable_client_state(array);
+}
+
+void glDisableClientState(GLenum array)
+{
+    g_gl_context->gl_disable_client_state(array);
+}
+
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+    g_gl_context->gl_vertex_pointer(size, type, stride, pointer);
+}
+
+void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+    g_gl_context->gl_color_pointer(size, type, stride, pointer);
+}
+
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
+{
+    g_gl_context->gl_tex_coord_pointer(size, type, stride, pointer);
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    g_gl_context->gl_draw_arrays(mode, first, count);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    g_gl_context->gl_draw_elements(mode, count, type, indices);
+}
@@ -18,6 +18,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/Vector4.h>
+#include <string.h>
 
 using AK::dbgln;
 
@@ -117,82 +118,96 @@ void SoftwareGLContext::gl_end()
     // 5.   The vertices are sorted (for the rasteriser, how are we doing this? 3Dfx did this top to bottom in terms of vertex y coordinates)
     // 6.   The vertices are then sent off to the rasteriser and drawn to the screen
 
-    float scr_width = m_frontbuffer->width();
-    float scr_height = m_frontbuffer->height();
-
     // Make sure we had a `glBegin` before this call...
     RETURN_WITH_ERROR_IF(!m_in_draw_state, GL_INVALID_OPERATION);
 
-    // Let's construct some triangles
-    if (m_current_draw_mode == GL_TRIANGLES) {
-        GLTriangle triangle;
-        for (size_t i = 0; i < vertex_list.size(); i += 3) {
-            triangle.vertices[0] = vertex_list.at(i);
-            triangle.vertices[1] = vertex_list.at(i + 1);
-            triangle.vertices[2] = vertex_list.at(i + 2);
+    // Every vertex is transformed once, no matter how many of the triangles built below share it.
+    auto model_view_projection = m_projection_matrix * m_model_view_matrix;
+    for (auto& vertex : vertex_list)
+        transform_to_clip_space(vertex, model_view_projection);
+
+    assemble_triangles(m_current_draw_mode, vertex_list.size(), [&](size_t i) -> const GLVertex& { return vertex_list[i]; });
+    rasterize_triangle_list();
+
+    vertex_list.clear();
 
+    m_in_draw_state = false;
+}
+
+void SoftwareGLContext::transform_to_clip_space(GLVertex& vertex, const FloatMatrix4x4& model_view_projection) const
+{
+    auto clip_space_position = model_view_projection * FloatVector4(vertex.x, vertex.y, vertex.z, 1.0f);
+    vertex.x = clip_space_position.x();
+    vertex.y = clip_space_position.y();
+    vertex.z = clip_space_position.z();
+    vertex.w = clip_space_position.w();
+}
+
+// Appends the triangles that the given mode makes out of vertex_count vertices to triangle_list.
+template<typename VertexAt>
+void SoftwareGLContext::assemble_triangles(GLenum mode, size_t vertex_count, VertexAt vertex_at)
+{
+    // Let's construct some triangles
+    GLTriangle triangle;
+    if (mode == GL_TRIANGLES) {
+        for (size_t i = 0; i + 2 < vertex_count; i += 3) {
+            triangle.vertices[0] = vertex_at(i);
+            triangle.vertices[1] = vertex_at(i + 1);
+            triangle.vertices[2] = vertex_at(i + 2);
             triangle_list.append(triangle);
         }
-    } else if (m_current_draw_mode == GL_QUADS) {
+    } else if (mode == GL_QUADS) {
         // We need to construct two triangles to form the quad
-        GLTriangle triangle;
-        VERIFY(vertex_list.size() % 4 == 0);
-        for (size_t i = 0; i < vertex_list.size(); i += 4) {
+        for (size_t i = 0; i + 3 < vertex_count; i += 4) {
             // Triangle 1
-            triangle.vertices[0] = vertex_list.at(i);
-            triangle.vertices[1] = vertex_list.at(i + 1);
-            triangle.vertices[2] = vertex_list.at(i + 2);
+            triangle.vertices[0] = vertex_at(i);
+            triangle.vertices[1] = vertex_at(i + 1);
+            triangle.vertices[2] = vertex_at(i + 2);
             triangle_list.append(triangle);
 
             // Triangle 2
-            triangle.vertices[0] = vertex_list.at(i + 2);
-            triangle.vertices[1] = vertex_list.at(i + 3);
-            triangle.vertices[2] = vertex_list.at(i);
+            triangle.vertices[0] = vertex_at(i + 2);
+            triangle.vertices[1] = vertex_at(i + 3);
+            triangle.vertices[2] = vertex_at(i);
             triangle_list.append(triangle);
         }
-    } else if (m_current_draw_mode == GL_TRIANGLE_FAN) {
-        GLTriangle triangle;
-        triangle.vertices[0] = vertex_list.at(0); // Root vertex is always the vertex defined first
+    } else if (mode == GL_TRIANGLE_FAN || mode == GL_POLYGON) {
+        // Polygons have to be convex, so they make a fan just fine.
+        if (vertex_count < 3)
+            return;
+        triangle.vertices[0] = vertex_at(0); // Root vertex is always the vertex defined first
 
-        for (size_t i = 1; i < vertex_list.size() - 1; i++) // This is technically `n-2` triangles. We start at index 1
+        for (size_t i = 1; i + 1 < vertex_count; i++) // This is technically `n-2` triangles. We start at index 1
         {
-            triangle.vertices[1] = vertex_list.at(i);
-            triangle.vertices[2] = vertex_list.at(i + 1);
+            triangle.vertices[1] = vertex_at(i);
+            triangle.vertices[2] = vertex_at(i + 1);
             triangle_list.append(triangle);
         }
-    } else if (m_current_draw_mode == GL_TRIANGLE_STRIP) {
-        GLTriangle triangle;
-        for (size_t i = 0; i < vertex_list.size() - 2; i++) {
-            triangle.vertices[0] = vertex_list.at(i);
-            triangle.vertices[1] = vertex_list.at(i + 1);
-            triangle.vertices[2] = vertex_list.at(i + 2);
+    } else if (mode == GL_TRIANGLE_STRIP) {
+        for (size_t i = 0; i + 2 < vertex_count; i++) {
+            triangle.vertices[0] = vertex_at(i);
+            triangle.vertices[1] = vertex_at(i + 1);
+            triangle.vertices[2] = vertex_at(i + 2);
             triangle_list.append(triangle);
         }
     } else {
-        RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
+        VERIFY_NOT_REACHED();
     }
+}
+
+// Clips, culls and rasterizes triangle_list, whose vertices are in clip space.
+void SoftwareGLContext::rasterize_triangle_list()
+{
+    float scr_width = m_frontbuffer->width();
+    float scr_height = m_frontbuffer->height();
 
-    // Now let's transform each triangle and send that to the GPU
+    // Now let's send each triangle to the GPU
     for (size_t i = 0; i < triangle_list.size(); i++) {
         GLTriangle& triangle = triangle_list.at(i);
         GLVertex& vertexa = triangle.vertices[0];
         GLVertex& vertexb = triangle.vertices[1];
         GLVertex& vertexc = triangle.vertices[2];
 
-        FloatVector4 veca({ vertexa.x, vertexa.y, vertexa.z, 1.0f });
-        FloatVector4 vecb({ vertexb.x, vertexb.y, vertexb.z, 1.0f });
-        FloatVector4 vecc({ vertexc.x, vertexc.y, vertexc.z, 1.0f });
-
-        // First multiply the vertex by the MODELVIEW matrix and then the PROJECTION matrix
-        veca = m_model_view_matrix * veca;
-        veca = m_projection_matrix * veca;
-
-        vecb = m_model_view_matrix * vecb;
-        vecb = m_projection_matrix * vecb;
-
-        vecc = m_model_view_matrix * vecc;
-        vecc = m_projection_matrix * vecc;
-
         // At this point, we're in clip space
         // Here's where we do the clipping. This is a really crude implementation of the
         // https://learnopengl.com/Getting-started/Coordinate-Systems
@@ -206,11 +221,10 @@ void SoftwareGLContext::gl_end()
         Vector<FloatVector4> vecs;
         Vector<GLVertex> verts;
 
-        vecs.append(veca);
-        vecs.append(vecb);
-        vecs.append(vecc);
+        vecs.append({ vertexa.x, vertexa.y, vertexa.z, vertexa.w });
+        vecs.append({ vertexb.x, vertexb.y, vertexb.z, vertexb.w });
+        vecs.append({ vertexc.x, vertexc.y, vertexc.z, vertexc.w });
         m_clipper.clip_triangle_against_frustum(vecs);
-
         // TODO: Copy color and UV information too!
         for (size_t vec_idx = 0; vec_idx < vecs.size(); vec_idx++) {
             FloatVector4& vec = vecs.at(vec_idx);
@@ -316,11 +330,9 @@ void SoftwareGLContext::gl_end()
 
     triangle_list.clear();
     processed_triangles.clear();
-    vertex_list.clear();
-
-    m_in_draw_state = false;
 }
 
+
 void SoftwareGLContext::gl_frustum(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble near_val, GLdouble far_val)
 {
     APPEND_TO_CALL_LIST_AND_RETURN_IF_NEEDED(gl_frustum, left, right, bottom, top, near_val, far_val);
@@ -562,8 +574,10 @@ void SoftwareGLContext::gl_vertex(GLdouble x, GLdouble y, GLdouble z, GLdouble w
 }
 
 // FIXME: We need to add `r` and `q` to our GLVertex?!
-void SoftwareGLContext::gl_tex_coord(GLfloat s, GLfloat t, GLfloat, GLfloat)
+void SoftwareGLContext::gl_tex_coord(GLfloat s, GLfloat t, GLfloat r, GLfloat q)
 {
+    APPEND_TO_CALL_LIST_AND_RETURN_IF_NEEDED(gl_tex_coord, s, t, r, q);
+
     auto& vertex = vertex_list.last(); // Get the last created vertex
 
     vertex.u = s;
@@ -676,6 +690,9 @@ void SoftwareGLContext::gl_delete_textures(GLsizei n, const GLuint* textures)
 
     m_name_allocator.free(n, textures);
 
+    // Triangles that are still queued may sample the textures that get unbound here.
+    m_rasterizer.wait_for_all_threads();
+
     for (auto i = 0; i < n; i++) {
         GLuint name = textures[i];
 
@@ -711,9 +728,46 @@ void SoftwareGLContext::gl_tex_image_2d(GLenum target, GLint level, GLint intern
     RETURN_WITH_ERROR_IF((width & 2) != 0 || (height & 2) != 0, GL_INVALID_VALUE);
     RETURN_WITH_ERROR_IF(border < 0 || border > 1, GL_INVALID_VALUE);
 
+    // Triangles that are still queued may sample the old contents.
+    m_rasterizer.wait_for_all_threads();
     m_active_texture_unit->bound_texture_2d()->upload_texture_data(target, level, internal_format, width, height, border, format, type, data);
 }
 
+void SoftwareGLContext::gl_tex_parameter(GLenum target, GLenum pname, GLfloat param)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    // We only support GL_TEXTURE_2D for now
+    RETURN_WITH_ERROR_IF(target != GL_TEXTURE_2D, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(m_active_texture_unit->currently_bound_target() != GL_TEXTURE_2D, GL_INVALID_OPERATION);
+
+    auto value = static_cast<GLint>(param);
+    auto& sampler = m_active_texture_unit->bound_texture_2d()->sampler_parameters();
+    switch (pname) {
+    case GL_TEXTURE_MIN_FILTER:
+        RETURN_WITH_ERROR_IF(!(value == GL_NEAREST || value == GL_LINEAR || value == GL_NEAREST_MIPMAP_NEAREST || value == GL_LINEAR_MIPMAP_NEAREST || value == GL_NEAREST_MIPMAP_LINEAR || value == GL_LINEAR_MIPMAP_LINEAR), GL_INVALID_ENUM);
+        m_rasterizer.wait_for_all_threads();
+        sampler.m_min_filter = value;
+        break;
+    case GL_TEXTURE_MAG_FILTER:
+        RETURN_WITH_ERROR_IF(!(value == GL_NEAREST || value == GL_LINEAR), GL_INVALID_ENUM);
+        m_rasterizer.wait_for_all_threads();
+        sampler.m_mag_filter = value;
+        break;
+    case GL_TEXTURE_WRAP_S:
+    case GL_TEXTURE_WRAP_T:
+        RETURN_WITH_ERROR_IF(!(value == GL_CLAMP || value == GL_CLAMP_TO_EDGE || value == GL_REPEAT), GL_INVALID_ENUM);
+        m_rasterizer.wait_for_all_threads();
+        if (pname == GL_TEXTURE_WRAP_S)
+            sampler.m_wrap_s_mode = value;
+        else
+            sampler.m_wrap_t_mode = value;
+        break;
+    default:
+        RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
+    }
+}
+
 void SoftwareGLContext::gl_front_face(GLenum face)
 {
     APPEND_TO_CALL_LIST_AND_RETURN_IF_NEEDED(gl_front_face, face);
@@ -1240,6 +1294,9 @@ void SoftwareGLContext::gl_bind_texture(GLenum target, GLuint texture)
     // FIXME: We only support GL_TEXTURE_2D for now
     RETURN_WITH_ERROR_IF(target != GL_TEXTURE_2D, GL_INVALID_ENUM);
 
+    // The queued triangles sample whatever their texture units have bound when they get rasterized.
+    m_rasterizer.wait_for_all_threads();
+
     if (texture == 0) {
         switch (target) {
         case GL_TEXTURE_2D:
@@ -1322,6 +1379,394 @@ void SoftwareGLContext::gl_get_floatv(GLenum pname, GLfloat* params)
     }
 }
 
+void SoftwareGLContext::gl_enable_client_state(GLenum array)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    switch (array) {
+    case GL_VERTEX_ARRAY:
+        m_vertex_array.enabled = true;
+        break;
+    case GL_COLOR_ARRAY:
+        m_color_array.enabled = true;
+        break;
+    case GL_TEXTURE_COORD_ARRAY:
+        m_tex_coord_array.enabled = true;
+        break;
+    default:
+        RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
+    }
+}
+
+void SoftwareGLContext::gl_disable_client_state(GLenum array)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    switch (array) {
+    case GL_VERTEX_ARRAY:
+        m_vertex_array.enabled = false;
+        break;
+    case GL_COLOR_ARRAY:
+        m_color_array.enabled = false;
+        break;
+    case GL_TEXTURE_COORD_ARRAY:
+        m_tex_coord_array.enabled = false;
+        break;
+    default:
+        RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
+    }
+}
+
+static bool is_vertex_attrib_type(GLenum type)
+{
+    switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+    case GL_DOUBLE:
+        return true;
+    }
+    return false;
+}
+
+static size_t vertex_attrib_type_size(GLenum type)
+{
+    switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+        return 4;
+    case GL_DOUBLE:
+        return 8;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Integer colors are mapped onto [0, 1] (or [-1, 1] for signed types), everything else is taken as is.
+static float read_vertex_attrib_component(const u8* data, GLenum type, bool normalize)
+{
+    auto read = [&]<typename T>(T) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        if constexpr (IsIntegral<T>) {
+            if (normalize)
+                return static_cast<float>(value) / static_cast<float>(NumericLimits<T>::max());
+        }
+        return static_cast<float>(value);
+    };
+
+    switch (type) {
+    case GL_BYTE:
+        return read(i8 {});
+    case GL_UNSIGNED_BYTE:
+        return read(u8 {});
+    case GL_SHORT:
+        return read(i16 {});
+    case GL_UNSIGNED_SHORT:
+        return read(u16 {});
+    case GL_INT:
+        return read(i32 {});
+    case GL_UNSIGNED_INT:
+        return read(u32 {});
+    case GL_FLOAT:
+        return read(float {});
+    case GL_DOUBLE:
+        return read(double {});
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void SoftwareGLContext::set_vertex_attrib_pointer(VertexAttribPointer& attrib, GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+    attrib.size = size;
+    attrib.type = type;
+    attrib.stride = stride;
+    attrib.pointer = pointer;
+    attrib.buffer = m_array_buffer;
+}
+
+void SoftwareGLContext::gl_vertex_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(size < 2 || size > 4, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!(type == GL_SHORT || type == GL_INT || type == GL_FLOAT || type == GL_DOUBLE), GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
+
+    set_vertex_attrib_pointer(m_vertex_array, size, type, stride, pointer);
+}
+
+void SoftwareGLContext::gl_color_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(size < 3 || size > 4, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!is_vertex_attrib_type(type), GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
+
+    set_vertex_attrib_pointer(m_color_array, size, type, stride, pointer);
+}
+
+void SoftwareGLContext::gl_tex_coord_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(size < 1 || size > 4, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!(type == GL_SHORT || type == GL_INT || type == GL_FLOAT || type == GL_DOUBLE), GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
+
+    set_vertex_attrib_pointer(m_tex_coord_array, size, type, stride, pointer);
+}
+
+// Reads the element at index of every enabled array. Anything past the end of a buffer object reads as the defaults.
+GLVertex SoftwareGLContext::fetch_vertex(size_t index) const
+{
+    auto read = [index](const VertexAttribPointer& attrib, bool normalize) -> FloatVector4 {
+        float components[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        size_t type_size = vertex_attrib_type_size(attrib.type);
+        size_t stride = attrib.stride ? attrib.stride : attrib.size * type_size;
+        size_t offset = index * stride;
+        const u8* data = reinterpret_cast<const u8*>(attrib.pointer);
+        if (attrib.buffer) {
+            offset += reinterpret_cast<FlatPtr>(attrib.pointer);
+            if (offset + attrib.size * type_size > attrib.buffer->data().size())
+                return { components[0], components[1], components[2], components[3] };
+            data = attrib.buffer->data().data();
+        }
+        for (GLint i = 0; i < attrib.size; ++i)
+            components[i] = read_vertex_attrib_component(data + offset + i * type_size, attrib.type, normalize);
+        return { components[0], components[1], components[2], components[3] };
+    };
+
+    GLVertex vertex;
+    auto position = read(m_vertex_array, false);
+    vertex.x = position.x();
+    vertex.y = position.y();
+    vertex.z = position.z();
+    vertex.w = position.w();
+
+    auto color = m_color_array.enabled ? read(m_color_array, true) : m_current_vertex_color;
+    vertex.r = color.x();
+    vertex.g = color.y();
+    vertex.b = color.z();
+    vertex.a = color.w();
+
+    auto tex_coord = m_tex_coord_array.enabled ? read(m_tex_coord_array, false) : FloatVector4 { 0.0f, 0.0f, 0.0f, 1.0f };
+    vertex.u = tex_coord.x();
+    vertex.v = tex_coord.y();
+    return vertex;
+}
+
+// Display lists take a copy of the array contents at compile time, so a draw call becomes the equivalent
+// immediate mode calls while one is being compiled.
+template<typename IndexAt>
+void SoftwareGLContext::emit_immediate_mode_draw(GLenum mode, size_t count, IndexAt index_at)
+{
+    gl_begin(mode);
+    for (size_t i = 0; i < count; ++i) {
+        auto vertex = fetch_vertex(index_at(i));
+        gl_color(vertex.r, vertex.g, vertex.b, vertex.a);
+        gl_vertex(vertex.x, vertex.y, vertex.z, vertex.w);
+        gl_tex_coord(vertex.u, vertex.v, 0.0f, 1.0f);
+    }
+    gl_end();
+}
+
+void SoftwareGLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(mode < GL_TRIANGLES || mode > GL_POLYGON, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(first < 0 || count < 0, GL_INVALID_VALUE);
+
+    if (!m_vertex_array.enabled || count == 0)
+        return;
+
+    if (should_append_to_listing()) {
+        emit_immediate_mode_draw(mode, count, [first](size_t i) { return first + i; });
+        return;
+    }
+
+    auto model_view_projection = m_projection_matrix * m_model_view_matrix;
+    vertex_list.clear_with_capacity();
+    vertex_list.ensure_capacity(count);
+    for (GLsizei i = 0; i < count; ++i) {
+        auto vertex = fetch_vertex(first + i);
+        transform_to_clip_space(vertex, model_view_projection);
+        vertex_list.unchecked_append(vertex);
+    }
+
+    assemble_triangles(mode, vertex_list.size(), [&](size_t i) -> const GLVertex& { return vertex_list[i]; });
+    rasterize_triangle_list();
+    vertex_list.clear_with_capacity();
+}
+
+void SoftwareGLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(mode < GL_TRIANGLES || mode > GL_POLYGON, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(!(type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT), GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(count < 0, GL_INVALID_VALUE);
+
+    if (!m_vertex_array.enabled || count == 0)
+        return;
+
+    // With a buffer bound to GL_ELEMENT_ARRAY_BUFFER, indices is an offset into it.
+    size_t index_size = vertex_attrib_type_size(type);
+    const u8* index_data = reinterpret_cast<const u8*>(indices);
+    if (m_element_array_buffer) {
+        auto offset = reinterpret_cast<FlatPtr>(indices);
+        RETURN_WITH_ERROR_IF(offset + count * index_size > m_element_array_buffer->data().size(), GL_INVALID_OPERATION);
+        index_data = m_element_array_buffer->data().data() + offset;
+    }
+    auto index_at = [&](size_t i) -> size_t {
+        auto* data = index_data + i * index_size;
+        if (type == GL_UNSIGNED_BYTE)
+            return *data;
+        if (type == GL_UNSIGNED_SHORT) {
+            u16 index;
+            memcpy(&index, data, sizeof(index));
+            return index;
+        }
+        u32 index;
+        memcpy(&index, data, sizeof(index));
+        return index;
+    };
+
+    if (should_append_to_listing()) {
+        emit_immediate_mode_draw(mode, count, index_at);
+        return;
+    }
+
+    // Every distinct index is fetched and transformed only once, however many primitives share it.
+    auto model_view_projection = m_projection_matrix * m_model_view_matrix;
+    vertex_list.clear_with_capacity();
+    m_element_positions.clear_with_capacity();
+    m_element_positions.ensure_capacity(count);
+    for (GLsizei i = 0; i < count; ++i) {
+        auto index = index_at(i);
+        if (index >= m_transformed_vertex_positions.size())
+            m_transformed_vertex_positions.resize(index + 1);
+        auto& position = m_transformed_vertex_positions[index];
+        if (position == 0) {
+            auto vertex = fetch_vertex(index);
+            transform_to_clip_space(vertex, model_view_projection);
+            vertex_list.append(vertex);
+            position = vertex_list.size();
+        }
+        m_element_positions.unchecked_append(position - 1);
+    }
+
+    assemble_triangles(mode, count, [&](size_t i) -> const GLVertex& { return vertex_list[m_element_positions[i]]; });
+    rasterize_triangle_list();
+
+    for (size_t i = 0; i < static_cast<size_t>(count); ++i)
+        m_transformed_vertex_positions[index_at(i)] = 0;
+    vertex_list.clear_with_capacity();
+}
+
+RefPtr<Buffer>* SoftwareGLContext::buffer_binding_for_target(GLenum target)
+{
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return &m_array_buffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return &m_element_array_buffer;
+    }
+    return nullptr;
+}
+
+void SoftwareGLContext::gl_gen_buffers(GLsizei n, GLuint* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    m_buffer_name_allocator.allocate(n, buffers);
+
+    // Like with textures, the buffer object only gets created once the name is first bound
+    for (auto i = 0; i < n; i++)
+        m_allocated_buffers.set(buffers[i], nullptr);
+}
+
+void SoftwareGLContext::gl_delete_buffers(GLsizei n, const GLuint* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    for (auto i = 0; i < n; i++) {
+        GLuint name = buffers[i];
+        auto buffer_object = m_allocated_buffers.find(name);
+        if (name == 0 || buffer_object == m_allocated_buffers.end())
+            continue;
+
+        // Deleting a bound buffer reverts the binding to zero. Array pointers that were set from it keep
+        // their reference, so they can still be drawn from.
+        if (buffer_object->value) {
+            if (m_array_buffer == buffer_object->value)
+                m_array_buffer = nullptr;
+            if (m_element_array_buffer == buffer_object->value)
+                m_element_array_buffer = nullptr;
+        }
+
+        m_buffer_name_allocator.free(1, &name);
+        m_allocated_buffers.remove(buffer_object);
+    }
+}
+
+void SoftwareGLContext::gl_bind_buffer(GLenum target, GLuint buffer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding_for_target(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+
+    if (buffer == 0) {
+        *binding = nullptr;
+        return;
+    }
+
+    auto it = m_allocated_buffers.find(buffer);
+    RETURN_WITH_ERROR_IF(it == m_allocated_buffers.end(), GL_INVALID_VALUE);
+
+    if (!it->value)
+        it->value = adopt_ref(*new Buffer);
+    *binding = it->value;
+}
+
+void SoftwareGLContext::gl_buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding_for_target(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(!(usage == GL_STREAM_DRAW || usage == GL_STATIC_DRAW || usage == GL_DYNAMIC_DRAW), GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(size < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!*binding, GL_INVALID_OPERATION);
+
+    auto& buffer = **binding;
+    buffer.set_usage(usage);
+    if (data)
+        buffer.data() = ByteBuffer::copy(data, size);
+    else
+        buffer.data() = ByteBuffer::create_zeroed(size);
+}
+
+void SoftwareGLContext::gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+    auto* binding = buffer_binding_for_target(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(offset < 0 || size < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!*binding, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(static_cast<size_t>(offset + size) > (*binding)->data().size(), GL_INVALID_VALUE);
+
+    (*binding)->data().overwrite(offset, data, size);
+}
+
 void SoftwareGLContext::present()
 {
     m_rasterizer.blit_to(*m_frontbuffer);
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "Buffer/Buffer.h"
 #include "Clipper.h"
 #include "GLContext.h"
 #include "GLStruct.h"
@@ -69,9 +70,22 @@ public:
     virtual void gl_read_pixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels) override;
     virtual void gl_tex_image_2d(GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* data) override;
     virtual void gl_tex_coord(GLfloat s, GLfloat t, GLfloat r, GLfloat q) override;
+    virtual void gl_tex_parameter(GLenum target, GLenum pname, GLfloat param) override;
     virtual void gl_bind_texture(GLenum target, GLuint texture) override;
     virtual void gl_active_texture(GLenum texture) override;
     virtual void gl_get_floatv(GLenum pname, GLfloat* params) override;
+    virtual void gl_enable_client_state(GLenum array) override;
+    virtual void gl_disable_client_state(GLenum array) override;
+    virtual void gl_vertex_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer) override;
+    virtual void gl_color_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer) override;
+    virtual void gl_tex_coord_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer) override;
+    virtual void gl_draw_arrays(GLenum mode, GLint first, GLsizei count) override;
+    virtual void gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const void* indices) override;
+    virtual void gl_gen_buffers(GLsizei n, GLuint* buffers) override;
+    virtual void gl_delete_buffers(GLsizei n, const GLuint* buffers) override;
+    virtual void gl_bind_buffer(GLenum target, GLuint buffer) override;
+    virtual void gl_buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+    virtual void gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
 
     virtual void present() override;
 
@@ -95,6 +109,26 @@ private:
     [[nodiscard]] bool should_append_to_listing() const { return m_current_listing_index.has_value(); }
     [[nodiscard]] bool should_execute_after_appending_to_listing() const { return m_current_listing_index.has_value() && m_current_listing_index->mode == GL_COMPILE_AND_EXECUTE; }
 
+    struct VertexAttribPointer {
+        bool enabled { false };
+        GLint size { 4 };
+        GLenum type { GL_FLOAT };
+        GLsizei stride { 0 };
+        // An offset into buffer if the pointer was set while a buffer was bound to GL_ARRAY_BUFFER.
+        const void* pointer { nullptr };
+        RefPtr<Buffer> buffer;
+    };
+
+    RefPtr<Buffer>* buffer_binding_for_target(GLenum target);
+    void set_vertex_attrib_pointer(VertexAttribPointer&, GLint size, GLenum type, GLsizei stride, const void* pointer);
+    GLVertex fetch_vertex(size_t index) const;
+    template<typename IndexAt>
+    void emit_immediate_mode_draw(GLenum mode, size_t count, IndexAt index_at);
+    void transform_to_clip_space(GLVertex&, const FloatMatrix4x4& model_view_projection) const;
+    template<typename VertexAt>
+    void assemble_triangles(GLenum mode, size_t vertex_count, VertexAt vertex_at);
+    void rasterize_triangle_list();
+
     GLenum m_current_draw_mode;
     GLenum m_current_matrix_mode;
     FloatMatrix4x4 m_projection_matrix;
@@ -144,6 +178,20 @@ private:
 
     SoftwareRasterizer m_rasterizer;
 
+    // Vertex arrays and buffer objects
+    VertexAttribPointer m_vertex_array;
+    VertexAttribPointer m_color_array;
+    VertexAttribPointer m_tex_coord_array;
+    TextureNameAllocator m_buffer_name_allocator;
+    HashMap<GLuint, RefPtr<Buffer>> m_allocated_buffers;
+    RefPtr<Buffer> m_array_buffer;
+    RefPtr<Buffer> m_element_array_buffer;
+
+    // The post-transform vertex cache of glDrawElements(): for every index, one more than the position in
+    // vertex_list its transformed vertex went to, or 0 while it hasn't been transformed yet.
+    Vector<u32> m_transformed_vertex_positions;
+    Vector<u32> m_element_positions;
+
     struct Listing {
 
         template<typename F>
@@ -194,7 +242,8 @@ private:
             decltype(&SoftwareGLContext::gl_shade_model),
             decltype(&SoftwareGLContext::gl_alpha_func),
             decltype(&SoftwareGLContext::gl_hint),
-            decltype(&SoftwareGLContext::gl_read_buffer)>;
+            decltype(&SoftwareGLContext::gl_read_buffer),
+            decltype(&SoftwareGLContext::gl_tex_coord)>;
 
         using ExtraSavedArguments = Variant<
             FloatMatrix4x4>;
@@ -6,46 +6,99 @@
 
 #include "SoftwareRasterizer.h"
 #include <AK/Function.h>
+#include <AK/SIMD.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/Vector2.h>
 #include <LibGfx/Vector3.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace GL {
 
 using IntVector2 = Gfx::Vector2<int>;
 using IntVector3 = Gfx::Vector3<int>;
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+using AK::SIMD::u32x4;
 
 static constexpr int RASTERIZER_BLOCK_SIZE = 16;
 
+// Triangles are binned into tiles of this many pixels, which are then rasterized in parallel. Every pixel
+// belongs to exactly one tile, so the tiles never touch each other's pixels or depth values.
+static constexpr int RASTERIZER_TILE_SIZE = RASTERIZER_BLOCK_SIZE * 4;
+
 constexpr static int edge_function(const IntVector2& a, const IntVector2& b, const IntVector2& c)
 {
     return ((c.x() - a.x()) * (b.y() - a.y()) - (c.y() - a.y()) * (b.x() - a.x()));
 }
 
-template<typename T>
-constexpr static T interpolate(const T& v0, const T& v1, const T& v2, const FloatVector3& barycentric_coords)
+// Pixels are processed in 2x2 quads, with each pixel of a quad in its own SIMD lane. These are the
+// offsets of the lanes' pixels from the top left pixel of the quad.
+static constexpr i32x4 quad_x_offsets { 0, 1, 0, 1 };
+static constexpr i32x4 quad_y_offsets { 0, 0, 1, 1 };
+
+ALWAYS_INLINE static f32x4 splat(float value)
 {
-    return v0 * barycentric_coords.x() + v1 * barycentric_coords.y() + v2 * barycentric_coords.z();
+    f32x4 vector { value, value, value, value };
+    return vector;
 }
 
-static Gfx::RGBA32 to_rgba32(const FloatVector4& v)
+ALWAYS_INLINE static bool any_lane_set(i32x4 mask)
 {
-    auto clamped = v.clamped(0, 1);
-    u8 r = clamped.x() * 255;
-    u8 g = clamped.y() * 255;
-    u8 b = clamped.z() * 255;
-    u8 a = clamped.w() * 255;
-    return a << 24 | b << 16 | g << 8 | r;
+    return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
 }
 
-static FloatVector4 to_vec4(Gfx::RGBA32 rgba)
+template<typename Vector, typename T>
+ALWAYS_INLINE static Vector load_quad(const T* top_row, const T* bottom_row)
 {
-    return {
-        (rgba & 0xff) / 255.0f,
-        ((rgba >> 8) & 0xff) / 255.0f,
-        ((rgba >> 16) & 0xff) / 255.0f,
-        ((rgba >> 24) & 0xff) / 255.0f
-    };
+    Vector quad { top_row[0], top_row[1], bottom_row[0], bottom_row[1] };
+    return quad;
+}
+
+template<typename Vector, typename T>
+ALWAYS_INLINE static void store_quad(T* top_row, T* bottom_row, Vector quad)
+{
+    top_row[0] = quad[0];
+    top_row[1] = quad[1];
+    bottom_row[0] = quad[2];
+    bottom_row[1] = quad[3];
+}
+
+ALWAYS_INLINE static f32x4 interpolate(float v0, float v1, float v2, f32x4 barycentric_x, f32x4 barycentric_y, f32x4 barycentric_z)
+{
+    return v0 * barycentric_x + v1 * barycentric_y + v2 * barycentric_z;
+}
+
+ALWAYS_INLINE static f32x4 to_channel(u32x4 rgba, int shift)
+{
+    return __builtin_convertvector((rgba >> shift) & 0xff, f32x4) / 255.0f;
+}
+
+ALWAYS_INLINE static u32x4 from_channel(f32x4 channel, int shift)
+{
+    // Clamps to [0, 1] the same way FloatVector4::clamped() does, which also turns NaN into 0.
+    channel = 0.0f < channel ? channel : 0.0f;
+    channel = 1.0f < channel ? 1.0f : channel;
+    return __builtin_convertvector(channel * 255.0f, u32x4) << shift;
+}
+
+static i32x4 alpha_test_mask(GLenum alpha_test_func, f32x4 alpha, float reference_value)
+{
+    switch (alpha_test_func) {
+    case GL_LESS:
+        return alpha < reference_value;
+    case GL_EQUAL:
+        return alpha == reference_value;
+    case GL_LEQUAL:
+        return alpha <= reference_value;
+    case GL_GREATER:
+        return alpha > reference_value;
+    case GL_NOTEQUAL:
+        return alpha != reference_value;
+    case GL_GEQUAL:
+        return alpha >= reference_value;
+    }
+    i32x4 all_pass { -1, -1, -1, -1 };
+    return all_pass;
 }
 
 static constexpr void setup_blend_factors(GLenum mode, FloatVector4& constant, float& src_alpha, float& dst_alpha, float& src_color, float& dst_color)
@@ -99,7 +152,7 @@ static constexpr void setup_blend_factors(GLenum mode, FloatVector4& constant, f
 }
 
 template<typename PS>
-static void rasterize_triangle(const RasterizerOptions& options, Gfx::Bitmap& render_target, DepthBuffer& depth_buffer, const GLTriangle& triangle, PS pixel_shader)
+static void rasterize_triangle(const RasterizerOptions& options, Gfx::Bitmap& render_target, DepthBuffer& depth_buffer, const GLTriangle& triangle, const Gfx::IntRect& tile_rect, PS pixel_shader)
 {
     // Since the algorithm is based on blocks of uniform size, we need
     // to ensure that our render_target size is actually a multiple of the block size
@@ -169,25 +222,19 @@ static void rasterize_triangle(const RasterizerOptions& options, Gfx::Bitmap& re
         };
     };
 
-    // This function tests whether a point as identified by its 3 edge values lies within the triangle
-    auto test_point = [zero](const IntVector3& edges) -> bool {
-        return edges.x() >= zero.x()
-            && edges.y() >= zero.y()
-            && edges.z() >= zero.z();
-    };
-
-    // Calculate block-based bounds
+    // Calculate block-based bounds within the tile
     // clang-format off
-    const int bx0 = max(0,                      min(min(v0.x(), v1.x()), v2.x())                            ) / RASTERIZER_BLOCK_SIZE;
-    const int bx1 = min(render_target.width(),  max(max(v0.x(), v1.x()), v2.x()) + RASTERIZER_BLOCK_SIZE - 1) / RASTERIZER_BLOCK_SIZE;
-    const int by0 = max(0,                      min(min(v0.y(), v1.y()), v2.y())                            ) / RASTERIZER_BLOCK_SIZE;
-    const int by1 = min(render_target.height(), max(max(v0.y(), v1.y()), v2.y()) + RASTERIZER_BLOCK_SIZE - 1) / RASTERIZER_BLOCK_SIZE;
+    const int bx0 = max(tile_rect.left(),       min(min(v0.x(), v1.x()), v2.x())                            ) / RASTERIZER_BLOCK_SIZE;
+    const int bx1 = min(tile_rect.right() + 1,  max(max(v0.x(), v1.x()), v2.x()) + RASTERIZER_BLOCK_SIZE - 1) / RASTERIZER_BLOCK_SIZE;
+    const int by0 = max(tile_rect.top(),        min(min(v0.y(), v1.y()), v2.y())                            ) / RASTERIZER_BLOCK_SIZE;
+    const int by1 = min(tile_rect.bottom() + 1, max(max(v0.y(), v1.y()), v2.y()) + RASTERIZER_BLOCK_SIZE - 1) / RASTERIZER_BLOCK_SIZE;
     // clang-format on
 
-    static_assert(RASTERIZER_BLOCK_SIZE < sizeof(int) * 8, "RASTERIZER_BLOCK_SIZE must be smaller than the pixel_mask's width in bits");
-    int pixel_mask[RASTERIZER_BLOCK_SIZE];
+    static_assert(RASTERIZER_BLOCK_SIZE % 2 == 0, "Blocks must be made up of whole 2x2 quads");
 
-    FloatVector4 pixel_buffer[RASTERIZER_BLOCK_SIZE][RASTERIZER_BLOCK_SIZE];
+    auto& vertex0 = triangle.vertices[0];
+    auto& vertex1 = triangle.vertices[1];
+    auto& vertex2 = triangle.vertices[2];
 
     // Iterate over all blocks within the bounds of the triangle
     for (int by = by0; by < by1; by++) {
@@ -214,187 +261,134 @@ static void rasterize_triangle(const RasterizerOptions& options, Gfx::Bitmap& re
                 continue;
 
             // edge value derivatives
+            // The edge functions are linear, so these divisions are exact.
             auto dbdx = (b1 - b0) / RASTERIZER_BLOCK_SIZE;
             auto dbdy = (b2 - b0) / RASTERIZER_BLOCK_SIZE;
-            // step edge value after each horizontal span: 1 down, BLOCK_SIZE left
-            auto step_y = dbdy - dbdx * RASTERIZER_BLOCK_SIZE;
 
             int x0 = bx * RASTERIZER_BLOCK_SIZE;
             int y0 = by * RASTERIZER_BLOCK_SIZE;
 
-            // Generate the coverage mask
-            if (test_point(b0) && test_point(b1) && test_point(b2) && test_point(b3)) {
-                // The block is fully contained within the triangle. Fill the mask with all 1s
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++) {
-                    pixel_mask[y] = -1;
-                }
-            } else {
-                // The block overlaps at least one triangle edge.
-                // We need to test coverage of every pixel within the block.
-                auto coords = b0;
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++, coords += step_y) {
-                    pixel_mask[y] = 0;
-
-                    for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, coords += dbdx) {
-                        if (test_point(coords))
-                            pixel_mask[y] |= 1 << x;
-                    }
-                }
-            }
-
-            // AND the depth mask onto the coverage mask
-            if (options.enable_depth_test) {
-                int z_pass_count = 0;
-                auto coords = b0;
-
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++, coords += step_y) {
-                    if (pixel_mask[y] == 0) {
-                        coords += dbdx * RASTERIZER_BLOCK_SIZE;
+            for (int qy = 0; qy < RASTERIZER_BLOCK_SIZE; qy += 2) {
+                auto* depth_top_row = &depth_buffer.scanline(y0 + qy)[x0];
+                auto* depth_bottom_row = &depth_buffer.scanline(y0 + qy + 1)[x0];
+                auto* color_top_row = &render_target.scanline(y0 + qy)[x0];
+                auto* color_bottom_row = &render_target.scanline(y0 + qy + 1)[x0];
+
+                for (int qx = 0; qx < RASTERIZER_BLOCK_SIZE; qx += 2) {
+                    i32x4 x = qx + quad_x_offsets;
+                    i32x4 y = qy + quad_y_offsets;
+                    i32x4 edge_x = b0.x() + dbdx.x() * x + dbdy.x() * y;
+                    i32x4 edge_y = b0.y() + dbdx.y() * x + dbdy.y() * y;
+                    i32x4 edge_z = b0.z() + dbdx.z() * x + dbdy.z() * y;
+
+                    // All bits of a lane are set while its pixel is still to be drawn.
+                    i32x4 mask = (edge_x >= zero.x()) & (edge_y >= zero.y()) & (edge_z >= zero.z());
+                    if (!any_lane_set(mask))
                         continue;
-                    }
 
-                    auto* depth = &depth_buffer.scanline(y0 + y)[x0];
-                    for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, coords += dbdx, depth++) {
-                        if (~pixel_mask[y] & (1 << x))
-                            continue;
+                    auto barycentric_x = __builtin_convertvector(edge_x, f32x4) * one_over_area;
+                    auto barycentric_y = __builtin_convertvector(edge_y, f32x4) * one_over_area;
+                    auto barycentric_z = __builtin_convertvector(edge_z, f32x4) * one_over_area;
 
-                        auto barycentric = FloatVector3(coords.x(), coords.y(), coords.z()) * one_over_area;
-                        float z = interpolate(triangle.vertices[0].z, triangle.vertices[1].z, triangle.vertices[2].z, barycentric);
-                        if (z >= *depth) {
-                            pixel_mask[y] ^= 1 << x;
-                            continue;
-                        }
+                    if (options.enable_depth_test) {
+                        auto z = interpolate(vertex0.z, vertex1.z, vertex2.z, barycentric_x, barycentric_y, barycentric_z);
+                        auto depth = load_quad<f32x4>(depth_top_row + qx, depth_bottom_row + qx);
+                        // Written as a negation so that a NaN depth passes, like it always has.
+                        mask &= ~(z >= depth);
+                        store_quad(depth_top_row + qx, depth_bottom_row + qx, mask ? z : depth);
 
-                        *depth = z;
-                        z_pass_count++;
+                        // Nice, no pixels passed the depth test -> quad rejected by early z
+                        if (!any_lane_set(mask))
+                            continue;
                     }
-                }
-
-                // Nice, no pixels passed the depth test -> block rejected by early z
-                if (z_pass_count == 0)
-                    continue;
-            }
-
-            // Draw the pixels according to the previously generated mask
-            auto coords = b0;
-            for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++, coords += step_y) {
-                if (pixel_mask[y] == 0) {
-                    coords += dbdx * RASTERIZER_BLOCK_SIZE;
-                    continue;
-                }
 
-                auto* pixel = pixel_buffer[y];
-                for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, coords += dbdx, pixel++) {
-                    if (~pixel_mask[y] & (1 << x))
+                    // FIXME: I'm not sure if this is the right place to test this.
+                    // If we tested this right at the beginning of our rasterizer routine
+                    // we could skip a lot of work but the GL spec might disagree.
+                    if (options.enable_alpha_test && options.alpha_test_func == GL_NEVER)
                         continue;
 
                     // Perspective correct barycentric coordinates
-                    auto barycentric = FloatVector3(coords.x(), coords.y(), coords.z()) * one_over_area;
-                    float interpolated_reciprocal_w = interpolate(triangle.vertices[0].w, triangle.vertices[1].w, triangle.vertices[2].w, barycentric);
-                    float interpolated_w = 1 / interpolated_reciprocal_w;
-                    barycentric = barycentric * FloatVector3(triangle.vertices[0].w, triangle.vertices[1].w, triangle.vertices[2].w) * interpolated_w;
+                    auto interpolated_reciprocal_w = interpolate(vertex0.w, vertex1.w, vertex2.w, barycentric_x, barycentric_y, barycentric_z);
+                    auto interpolated_w = 1 / interpolated_reciprocal_w;
+                    barycentric_x = barycentric_x * vertex0.w * interpolated_w;
+                    barycentric_y = barycentric_y * vertex1.w * interpolated_w;
+                    barycentric_z = barycentric_z * vertex2.w * interpolated_w;
 
                     // FIXME: make this more generic. We want to interpolate more than just color and uv
-                    FloatVector4 vertex_color;
+                    f32x4 red, green, blue, alpha;
                     if (options.shade_smooth) {
-                        vertex_color = interpolate(
-                            FloatVector4(triangle.vertices[0].r, triangle.vertices[0].g, triangle.vertices[0].b, triangle.vertices[0].a),
-                            FloatVector4(triangle.vertices[1].r, triangle.vertices[1].g, triangle.vertices[1].b, triangle.vertices[1].a),
-                            FloatVector4(triangle.vertices[2].r, triangle.vertices[2].g, triangle.vertices[2].b, triangle.vertices[2].a),
-                            barycentric);
+                        red = interpolate(vertex0.r, vertex1.r, vertex2.r, barycentric_x, barycentric_y, barycentric_z);
+                        green = interpolate(vertex0.g, vertex1.g, vertex2.g, barycentric_x, barycentric_y, barycentric_z);
+                        blue = interpolate(vertex0.b, vertex1.b, vertex2.b, barycentric_x, barycentric_y, barycentric_z);
+                        alpha = interpolate(vertex0.a, vertex1.a, vertex2.a, barycentric_x, barycentric_y, barycentric_z);
                     } else {
-                        vertex_color = { triangle.vertices[0].r, triangle.vertices[0].g, triangle.vertices[0].b, triangle.vertices[0].a };
+                        red = splat(vertex0.r);
+                        green = splat(vertex0.g);
+                        blue = splat(vertex0.b);
+                        alpha = splat(vertex0.a);
                     }
+                    auto u = interpolate(vertex0.u, vertex1.u, vertex2.u, barycentric_x, barycentric_y, barycentric_z);
+                    auto v = interpolate(vertex0.v, vertex1.v, vertex2.v, barycentric_x, barycentric_y, barycentric_z);
 
-                    auto uv = interpolate(
-                        FloatVector2(triangle.vertices[0].u, triangle.vertices[0].v),
-                        FloatVector2(triangle.vertices[1].u, triangle.vertices[1].v),
-                        FloatVector2(triangle.vertices[2].u, triangle.vertices[2].v),
-                        barycentric);
+                    // The differences across the quad approximate the derivatives of uv that texture
+                    // sampling picks the mipmap level with. Lanes outside the triangle still take part.
+                    FloatVector2 uv_dx { u[1] - u[0], v[1] - v[0] };
+                    FloatVector2 uv_dy { u[2] - u[0], v[2] - v[0] };
 
-                    *pixel = pixel_shader(uv, vertex_color);
-                }
-            }
-
-            if (options.enable_alpha_test && options.alpha_test_func != GL_ALWAYS) {
-                // FIXME: I'm not sure if this is the right place to test this.
-                // If we tested this right at the beginning of our rasterizer routine
-                // we could skip a lot of work but the GL spec might disagree.
-                if (options.alpha_test_func == GL_NEVER)
-                    continue;
-
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++) {
-                    auto src = pixel_buffer[y];
-                    for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, src++) {
-                        if (~pixel_mask[y] & (1 << x))
+                    // The pixel shader may sample textures, so it only runs for the pixels that are drawn.
+                    for (int lane = 0; lane < 4; lane++) {
+                        if (!mask[lane])
                             continue;
-
-                        bool passed = true;
-
-                        switch (options.alpha_test_func) {
-                        case GL_LESS:
-                            passed = src->w() < options.alpha_test_ref_value;
-                            break;
-                        case GL_EQUAL:
-                            passed = src->w() == options.alpha_test_ref_value;
-                            break;
-                        case GL_LEQUAL:
-                            passed = src->w() <= options.alpha_test_ref_value;
-                            break;
-                        case GL_GREATER:
-                            passed = src->w() > options.alpha_test_ref_value;
-                            break;
-                        case GL_NOTEQUAL:
-                            passed = src->w() != options.alpha_test_ref_value;
-                            break;
-                        case GL_GEQUAL:
-                            passed = src->w() >= options.alpha_test_ref_value;
-                            break;
-                        }
-
-                        if (!passed)
-                            pixel_mask[y] ^= (1 << x);
+                        auto color = pixel_shader(FloatVector2(u[lane], v[lane]), uv_dx, uv_dy, FloatVector4(red[lane], green[lane], blue[lane], alpha[lane]));
+                        red[lane] = color.x();
+                        green[lane] = color.y();
+                        blue[lane] = color.z();
+                        alpha[lane] = color.w();
                     }
-                }
-            }
 
-            if (options.enable_blending) {
-                // Blend color values from pixel_buffer into render_target
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++) {
-                    auto src = pixel_buffer[y];
-                    auto dst = &render_target.scanline(y + y0)[x0];
-                    for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, src++, dst++) {
-                        if (~pixel_mask[y] & (1 << x))
+                    if (options.enable_alpha_test && options.alpha_test_func != GL_ALWAYS) {
+                        mask &= alpha_test_mask(options.alpha_test_func, alpha, options.alpha_test_ref_value);
+                        if (!any_lane_set(mask))
                             continue;
-
-                        auto float_dst = to_vec4(*dst);
-
-                        auto src_factor = src_constant
-                            + *src * src_factor_src_color
-                            + FloatVector4(src->w(), src->w(), src->w(), src->w()) * src_factor_src_alpha
-                            + float_dst * src_factor_dst_color
-                            + FloatVector4(float_dst.w(), float_dst.w(), float_dst.w(), float_dst.w()) * src_factor_dst_alpha;
-
-                        auto dst_factor = dst_constant
-                            + *src * dst_factor_src_color
-                            + FloatVector4(src->w(), src->w(), src->w(), src->w()) * dst_factor_src_alpha
-                            + float_dst * dst_factor_dst_color
-                            + FloatVector4(float_dst.w(), float_dst.w(), float_dst.w(), float_dst.w()) * dst_factor_dst_alpha;
-
-                        *dst = to_rgba32(*src * src_factor + float_dst * dst_factor);
                     }
-                }
-            } else {
-                // Copy color values from pixel_buffer into render_target
-                for (int y = 0; y < RASTERIZER_BLOCK_SIZE; y++) {
-                    auto src = pixel_buffer[y];
-                    auto dst = &render_target.scanline(y + y0)[x0];
-                    for (int x = 0; x < RASTERIZER_BLOCK_SIZE; x++, src++, dst++) {
-                        if (~pixel_mask[y] & (1 << x))
-                            continue;
 
-                        *dst = to_rgba32(*src);
+                    auto destination = load_quad<u32x4>(color_top_row + qx, color_bottom_row + qx);
+                    if (options.enable_blending) {
+                        // Blend color values from the shaded quad into render_target
+                        auto destination_red = to_channel(destination, 0);
+                        auto destination_green = to_channel(destination, 8);
+                        auto destination_blue = to_channel(destination, 16);
+                        auto destination_alpha = to_channel(destination, 24);
+
+                        auto blend = [&](f32x4 source_channel, f32x4 destination_channel, float src_constant_channel, float dst_constant_channel) {
+                            auto src_factor = src_constant_channel
+                                + source_channel * src_factor_src_color
+                                + alpha * src_factor_src_alpha
+                                + destination_channel * src_factor_dst_color
+                                + destination_alpha * src_factor_dst_alpha;
+
+                            auto dst_factor = dst_constant_channel
+                                + source_channel * dst_factor_src_color
+                                + alpha * dst_factor_src_alpha
+                                + destination_channel * dst_factor_dst_color
+                                + destination_alpha * dst_factor_dst_alpha;
+
+                            return source_channel * src_factor + destination_channel * dst_factor;
+                        };
+
+                        auto blended_red = blend(red, destination_red, src_constant.x(), dst_constant.x());
+                        auto blended_green = blend(green, destination_green, src_constant.y(), dst_constant.y());
+                        auto blended_blue = blend(blue, destination_blue, src_constant.z(), dst_constant.z());
+                        auto blended_alpha = blend(alpha, destination_alpha, src_constant.w(), dst_constant.w());
+                        red = blended_red;
+                        green = blended_green;
+                        blue = blended_blue;
+                        alpha = blended_alpha;
                     }
+
+                    auto pixels = from_channel(red, 0) | from_channel(green, 8) | from_channel(blue, 16) | from_channel(alpha, 24);
+                    store_quad(color_top_row + qx, color_bottom_row + qx, mask ? pixels : destination);
                 }
             }
         }
@@ -412,34 +406,94 @@ SoftwareRasterizer::SoftwareRasterizer(const Gfx::IntSize& min_size)
     : m_render_target { Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, closest_multiple(min_size, RASTERIZER_BLOCK_SIZE)) }
     , m_depth_buffer { adopt_own(*new DepthBuffer(closest_multiple(min_size, RASTERIZER_BLOCK_SIZE))) }
 {
+    reset_tiles();
+}
+
+void SoftwareRasterizer::reset_tiles()
+{
+    m_horizontal_tile_count = (m_render_target->width() + RASTERIZER_TILE_SIZE - 1) / RASTERIZER_TILE_SIZE;
+    int vertical_tile_count = (m_render_target->height() + RASTERIZER_TILE_SIZE - 1) / RASTERIZER_TILE_SIZE;
+    m_tile_triangles.clear();
+    m_tile_triangles.resize(m_horizontal_tile_count * vertical_tile_count);
 }
 
 void SoftwareRasterizer::submit_triangle(const GLTriangle& triangle)
 {
-    rasterize_triangle(m_options, *m_render_target, *m_depth_buffer, triangle, [](const FloatVector2&, const FloatVector4& color) -> FloatVector4 {
-        return color;
-    });
+    queue_triangle(triangle, nullptr);
 }
 
 void SoftwareRasterizer::submit_triangle(const GLTriangle& triangle, const Array<TextureUnit, 32>& texture_units)
 {
-    rasterize_triangle(m_options, *m_render_target, *m_depth_buffer, triangle, [&texture_units](const FloatVector2& uv, const FloatVector4& color) -> FloatVector4 {
-        // TODO: We'd do some kind of multitexturing/blending here
-        // Construct a vector for the texel we want to sample
-        FloatVector4 texel = color;
+    queue_triangle(triangle, &texture_units);
+}
 
-        for (const auto& texture_unit : texture_units) {
+void SoftwareRasterizer::queue_triangle(const GLTriangle& triangle, const Array<TextureUnit, 32>* texture_units)
+{
+    IntVector2 v0 { (int)triangle.vertices[0].x, (int)triangle.vertices[0].y };
+    IntVector2 v1 { (int)triangle.vertices[1].x, (int)triangle.vertices[1].y };
+    IntVector2 v2 { (int)triangle.vertices[2].x, (int)triangle.vertices[2].y };
+    if (edge_function(v0, v1, v2) == 0)
+        return;
 
-            // No texture is bound to this texture unit
-            if (!texture_unit.is_bound())
-                continue;
+    // The same bounds rasterize_triangle() works with, just in tiles instead of blocks.
+    int left = max(0, min(min(v0.x(), v1.x()), v2.x()));
+    int right = min(m_render_target->width(), max(max(v0.x(), v1.x()), v2.x()) + RASTERIZER_BLOCK_SIZE - 1);
+    int top = max(0, min(min(v0.y(), v1.y()), v2.y()));
+    int bottom = min(m_render_target->height(), max(max(v0.y(), v1.y()), v2.y()) + RASTERIZER_BLOCK_SIZE - 1);
+    if (left >= right || top >= bottom)
+        return;
+
+    u32 index = m_queued_triangles.size();
+    m_queued_triangles.append({ triangle, texture_units });
+    for (int ty = top / RASTERIZER_TILE_SIZE; ty <= (bottom - 1) / RASTERIZER_TILE_SIZE; ty++) {
+        for (int tx = left / RASTERIZER_TILE_SIZE; tx <= (right - 1) / RASTERIZER_TILE_SIZE; tx++) {
+            size_t tile_index = ty * m_horizontal_tile_count + tx;
+            auto& triangles = m_tile_triangles[tile_index];
+            if (triangles.is_empty())
+                m_busy_tiles.append(tile_index);
+            triangles.append(index);
+        }
+    }
+}
 
-            // FIXME: Don't assume Texture2D, _and_ work out how we blend/do multitexturing properly.....
-            texel = texel * static_ptr_cast<Texture2D>(texture_unit.bound_texture())->sample_texel(uv);
+void SoftwareRasterizer::rasterize_tile(size_t tile_index)
+{
+    Gfx::IntRect tile_rect {
+        static_cast<int>(tile_index % m_horizontal_tile_count) * RASTERIZER_TILE_SIZE,
+        static_cast<int>(tile_index / m_horizontal_tile_count) * RASTERIZER_TILE_SIZE,
+        RASTERIZER_TILE_SIZE,
+        RASTERIZER_TILE_SIZE,
+    };
+    tile_rect.intersect(m_render_target->rect());
+
+    for (auto index : m_tile_triangles[tile_index]) {
+        auto& queued_triangle = m_queued_triangles[index];
+        if (!queued_triangle.texture_units) {
+            rasterize_triangle(m_options, *m_render_target, *m_depth_buffer, queued_triangle.triangle, tile_rect, [](const FloatVector2&, const FloatVector2&, const FloatVector2&, const FloatVector4& color) -> FloatVector4 {
+                return color;
+            });
+            continue;
         }
 
-        return texel;
-    });
+        auto& texture_units = *queued_triangle.texture_units;
+        rasterize_triangle(m_options, *m_render_target, *m_depth_buffer, queued_triangle.triangle, tile_rect, [&texture_units](const FloatVector2& uv, const FloatVector2& uv_dx, const FloatVector2& uv_dy, const FloatVector4& color) -> FloatVector4 {
+            // TODO: We'd do some kind of multitexturing/blending here
+            // Construct a vector for the texel we want to sample
+            FloatVector4 texel = color;
+
+            for (const auto& texture_unit : texture_units) {
+
+                // No texture is bound to this texture unit
+                if (!texture_unit.is_bound())
+                    continue;
+
+                // FIXME: Don't assume Texture2D, _and_ work out how we blend/do multitexturing properly.....
+                texel = texel * static_ptr_cast<Texture2D>(texture_unit.bound_texture())->sample_texel(uv, uv_dx, uv_dy);
+            }
+
+            return texel;
+        });
+    }
 }
 
 void SoftwareRasterizer::resize(const Gfx::IntSize& min_size)
@@ -448,6 +502,7 @@ void SoftwareRasterizer::resize(const Gfx::IntSize& min_size)
 
     m_render_target = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, closest_multiple(min_size, RASTERIZER_BLOCK_SIZE));
     m_depth_buffer = adopt_own(*new DepthBuffer(m_render_target->size()));
+    reset_tiles();
 }
 
 void SoftwareRasterizer::clear_color(const FloatVector4& color)
@@ -477,9 +532,19 @@ void SoftwareRasterizer::blit_to(Gfx::Bitmap& target)
     painter.blit({ 0, 0 }, *m_render_target, m_render_target->rect(), 1.0f, false);
 }
 
-void SoftwareRasterizer::wait_for_all_threads() const
+void SoftwareRasterizer::wait_for_all_threads()
 {
-    // FIXME: Wait for all render threads to finish when multithreading is being implemented
+    if (m_busy_tiles.is_empty())
+        return;
+
+    Threading::ThreadPool::the().parallel_for(m_busy_tiles.span(), [this](size_t tile_index) {
+        rasterize_tile(tile_index);
+    });
+
+    for (auto tile_index : m_busy_tiles)
+        m_tile_triangles[tile_index].clear_with_capacity();
+    m_busy_tiles.clear_with_capacity();
+    m_queued_triangles.clear_with_capacity();
 }
 
 void SoftwareRasterizer::set_options(const RasterizerOptions& options)
@@ -487,12 +552,12 @@ void SoftwareRasterizer::set_options(const RasterizerOptions& options)
     wait_for_all_threads();
 
     m_options = options;
-
-    // FIXME: Recreate or reinitialize render threads here when multithreading is being implemented
 }
 
 Gfx::RGBA32 SoftwareRasterizer::get_backbuffer_pixel(int x, int y)
 {
+    wait_for_all_threads();
+
     // FIXME: Reading individual pixels is very slow, rewrite this to transfer whole blocks
     if (x < 0 || y < 0 || x >= m_render_target->width() || y >= m_render_target->height())
         return 0;
@@ -502,6 +567,8 @@ Gfx::RGBA32 SoftwareRasterizer::get_backbuffer_pixel(int x, int y)
 
 float SoftwareRasterizer::get_depthbuffer_value(int x, int y)
 {
+    wait_for_all_threads();
+
     // FIXME: Reading individual pixels is very slow, rewrite this to transfer whole blocks
     if (x < 0 || y < 0 || x >= m_render_target->width() || y >= m_render_target->height())
         return 1.0f;
@@ -13,6 +13,7 @@
 #include "Tex/TextureUnit.h"
 #include <AK/Array.h>
 #include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Vector4.h>
 
@@ -39,16 +40,33 @@ public:
     void clear_color(const FloatVector4&);
     void clear_depth(float);
     void blit_to(Gfx::Bitmap&);
-    void wait_for_all_threads() const;
+    // Submitted triangles are only sorted into the tiles they touch at first. This rasterizes the tiles
+    // in parallel and returns once the render target and depth buffer are up to date.
+    void wait_for_all_threads();
     void set_options(const RasterizerOptions&);
     RasterizerOptions options() const { return m_options; }
     Gfx::RGBA32 get_backbuffer_pixel(int x, int y);
     float get_depthbuffer_value(int x, int y);
 
 private:
+    struct QueuedTriangle {
+        GLTriangle triangle;
+        const Array<TextureUnit, 32>* texture_units { nullptr };
+    };
+
+    void queue_triangle(const GLTriangle&, const Array<TextureUnit, 32>*);
+    void rasterize_tile(size_t tile_index);
+    void reset_tiles();
+
     RefPtr<Gfx::Bitmap> m_render_target;
     OwnPtr<DepthBuffer> m_depth_buffer;
     RasterizerOptions m_options;
+
+    int m_horizontal_tile_count { 0 };
+    Vector<QueuedTriangle> m_queued_triangles;
+    // The indices of the queued triangles that touch each tile, in the order they were submitted.
+    Vector<Vector<u32>> m_tile_triangles;
+    Vector<size_t> m_busy_tiles;
 };
 
 }
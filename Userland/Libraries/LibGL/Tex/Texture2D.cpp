@@ -7,7 +7,7 @@
 #include <AK/Format.h>
 #include <LibGL/GL/gl.h>
 #include <LibGL/Tex/Texture2D.h>
-#include <string.h>
+#include <math.h>
 
 namespace GL {
 
@@ -26,110 +26,164 @@ void Texture2D::upload_texture_data(GLenum, GLint lod, GLint internal_format, GL
 
     m_internal_format = internal_format;
 
-    // Get reference to the mip
     auto& mip = m_mipmaps[lod];
-    const u8* pixel_byte_array = reinterpret_cast<const u8*>(pixels);
+    mip.resize(width, height);
 
-    // Copy pixel data to storage
-
-    // Pixels are already 32-bits wide
-    if (format == GL_RGBA || format == GL_BGRA) {
-        mip.pixel_data().resize(width * height * sizeof(u32));
-        memcpy(mip.pixel_data().data(), pixels, width * height * sizeof(u32));
-    } else {
-        mip.pixel_data().resize(width * height * 3);
-        // Copy RGB or BGR pixel data
-        for (auto i = 0; i < width * height * 3; i += 3) {
-            u32 b0 = pixel_byte_array[i];     // B or R
-            u32 b1 = pixel_byte_array[i + 1]; // G
-            u32 b2 = pixel_byte_array[i + 2]; // R or B
-
-            u32 pixel = ((0xffu << 24) | (b0 << 16) | (b1 << 8) | b2);
-            mip.pixel_data().append(pixel);
+    // Convert the pixels to RGBA8 with red in the lowest byte. Formats without alpha, and textures
+    // whose internal format has none, are opaque.
+    const u8* pixel_byte_array = reinterpret_cast<const u8*>(pixels);
+    bool has_alpha = format == GL_RGBA || format == GL_BGRA;
+    bool is_bgr = format == GL_BGR || format == GL_BGRA;
+    if (!has_alpha && format != GL_RGB && format != GL_BGR) {
+        // Let's crash for now so we can implement format by format
+        VERIFY_NOT_REACHED();
+    }
+    size_t bytes_per_pixel = has_alpha ? 4 : 3;
+
+    for (GLsizei y = 0; y < height; ++y) {
+        for (GLsizei x = 0; x < width; ++x) {
+            const u8* pixel = pixel_byte_array + (y * width + x) * bytes_per_pixel;
+            u32 r = is_bgr ? pixel[2] : pixel[0];
+            u32 g = pixel[1];
+            u32 b = is_bgr ? pixel[0] : pixel[2];
+            u32 a = has_alpha && internal_format == GL_RGBA ? pixel[3] : 0xff;
+            mip.set_texel(x, y, (a << 24) | (b << 16) | (g << 8) | r);
         }
     }
 
-    // Now we need to swizzle the texture data from `format` to `internal_format`
-    switch (format) {
-    case GL_BGR: {
-        if (internal_format == GL_RGB) {
-            swizzle(mip.pixel_data(), [](u32 pixel) -> u32 {
-                u8 r = pixel & 0xff;
-                u8 g = (pixel >> 8) & 0xff;
-                u8 b = (pixel >> 16) & 0xff;
-
-                return (0xff << 24) | (r << 16) | (g << 8) | b;
-            });
-        } else if (internal_format == GL_RGBA) {
-            swizzle(mip.pixel_data(), [](u32 pixel) -> u32 {
-                u8 r = pixel & 0xff;
-                u8 g = (pixel >> 8) & 0xff;
-                u8 b = (pixel >> 16) & 0xff;
-
-                return (r << 24) | (g << 16) | (b << 8) | 0xff;
-            });
-        }
-    } break;
-    case GL_BGRA: {
-        if (internal_format == GL_RGB) {
-            swizzle(mip.pixel_data(), [](u32 pixel) -> u32 {
-                u8 r = (pixel >> 8) & 0xff;
-                u8 g = (pixel >> 16) & 0xff;
-                u8 b = (pixel >> 24) & 0xff;
-
-                return (0xff << 24) | (r << 16) | (g << 8) | b;
-            });
-        } else if (internal_format == GL_RGBA) {
-            swizzle(mip.pixel_data(), [](u32 pixel) -> u32 {
-                u8 a = pixel & 0xff;
-                u8 r = (pixel >> 8) & 0xff;
-                u8 g = (pixel >> 16) & 0xff;
-                u8 b = (pixel >> 24) & 0xff;
-
-                return (r << 24) | (g << 16) | (b << 8) | a;
-            });
-        }
-    } break;
-    case GL_RGB: {
-        if (internal_format == GL_RGBA) {
-            swizzle(mip.pixel_data(), [](u32 pixel) -> u32 {
-                u8 r = pixel & 0xff;
-                u8 g = (pixel >> 8) & 0xff;
-                u8 b = (pixel >> 16) & 0xff;
-
-                return (r << 24) | (g << 16) | (b << 8) | 0xff;
-            });
+    // We behave as if GL_GENERATE_MIPMAP were always on: a new base level brings its own mipmaps, so the
+    // default minification filter works on textures that only ever upload level 0. Levels uploaded
+    // afterwards replace the generated ones.
+    if (lod == 0)
+        generate_mipmaps();
+}
+
+void Texture2D::generate_mipmaps()
+{
+    size_t level = 1;
+    for (; level < m_mipmaps.size(); ++level) {
+        auto& previous = m_mipmaps[level - 1];
+        if (previous.width() <= 1 && previous.height() <= 1)
+            break;
+
+        auto& mip = m_mipmaps[level];
+        mip.resize(max(1, previous.width() / 2), max(1, previous.height() / 2));
+
+        // Box filter the 2x2 texels that make up each new one. Where the previous level is only one texel
+        // wide or high, the same texel is simply read twice.
+        int x_step = previous.width() > 1 ? 1 : 0;
+        int y_step = previous.height() > 1 ? 1 : 0;
+        for (int y = 0; y < mip.height(); ++y) {
+            for (int x = 0; x < mip.width(); ++x) {
+                u32 texels[4] = {
+                    previous.texel(x * 2, y * 2),
+                    previous.texel(x * 2 + x_step, y * 2),
+                    previous.texel(x * 2, y * 2 + y_step),
+                    previous.texel(x * 2 + x_step, y * 2 + y_step),
+                };
+                u32 result = 0;
+                for (u32 shift = 0; shift < 32; shift += 8) {
+                    u32 sum = 2;
+                    for (auto texel : texels)
+                        sum += (texel >> shift) & 0xff;
+                    result |= (sum / 4) << shift;
+                }
+                mip.set_texel(x, y, result);
+            }
         }
-    } break;
-    case GL_RGBA:
-        break;
-    default:
-        // Let's crash for now so we can implement format by format
-        VERIFY_NOT_REACHED();
     }
+    m_max_level = level - 1;
+}
 
-    mip.set_width(width);
-    mip.set_height(height);
+static int wrap_texel_coordinate(int coordinate, int size, GLint wrap_mode)
+{
+    if (wrap_mode == GL_REPEAT) {
+        coordinate %= size;
+        return coordinate < 0 ? coordinate + size : coordinate;
+    }
+    // FIXME: GL_CLAMP should blend in the border color at the edges.
+    return clamp(coordinate, 0, size - 1);
 }
 
-FloatVector4 Texture2D::sample_texel(const FloatVector2& uv) const
+static FloatVector4 unpack_texel(u32 texel)
 {
-    auto& mip = m_mipmaps.at(0);
+    return {
+        (texel & 0xff) / 255.0f,
+        ((texel >> 8) & 0xff) / 255.0f,
+        ((texel >> 16) & 0xff) / 255.0f,
+        (texel >> 24) / 255.0f,
+    };
+}
 
-    // FIXME: Remove this to prevent a crash when we have proper texture binding
-    if (mip.width() == 0 || mip.height() == 0)
-        return { 1.0f, 1.0f, 1.0f, 1.0f };
+FloatVector4 Texture2D::sample_level(size_t level, const FloatVector2& uv, GLint filter) const
+{
+    auto& mip = m_mipmaps[level];
+    float x = uv.x() * mip.width();
+    float y = uv.y() * mip.height();
+
+    if (filter == GL_NEAREST) {
+        int u = wrap_texel_coordinate(floorf(x), mip.width(), m_sampler_params.m_wrap_s_mode);
+        int v = wrap_texel_coordinate(floorf(y), mip.height(), m_sampler_params.m_wrap_t_mode);
+        return unpack_texel(mip.texel(u, v));
+    }
 
-    u32 u = static_cast<u32>(uv.x() * mip.width());
-    u32 v = static_cast<u32>(uv.y() * mip.height());
+    // Bilinear filtering between the four texels whose centers surround the sample point.
+    x -= 0.5f;
+    y -= 0.5f;
+    float floor_x = floorf(x);
+    float floor_y = floorf(y);
+    float fraction_x = x - floor_x;
+    float fraction_y = y - floor_y;
+    int u0 = wrap_texel_coordinate(floor_x, mip.width(), m_sampler_params.m_wrap_s_mode);
+    int u1 = wrap_texel_coordinate(floor_x + 1, mip.width(), m_sampler_params.m_wrap_s_mode);
+    int v0 = wrap_texel_coordinate(floor_y, mip.height(), m_sampler_params.m_wrap_t_mode);
+    int v1 = wrap_texel_coordinate(floor_y + 1, mip.height(), m_sampler_params.m_wrap_t_mode);
+
+    auto top = unpack_texel(mip.texel(u0, v0)) * (1 - fraction_x) + unpack_texel(mip.texel(u1, v0)) * fraction_x;
+    auto bottom = unpack_texel(mip.texel(u0, v1)) * (1 - fraction_x) + unpack_texel(mip.texel(u1, v1)) * fraction_x;
+    return top * (1 - fraction_y) + bottom * fraction_y;
+}
 
-    u32 pixel = mip.pixel_data().at(v * mip.width() + u);
+FloatVector4 Texture2D::sample_texel(const FloatVector2& uv, const FloatVector2& uv_dx, const FloatVector2& uv_dy) const
+{
+    auto& base = m_mipmaps[0];
 
-    float b0 = ((pixel)&0xff) / 255.0f;
-    float b1 = ((pixel >> 8) & 0xff) / 255.0f;
-    float b2 = ((pixel >> 16) & 0xff) / 255.0f;
+    // FIXME: Remove this to prevent a crash when we have proper texture binding
+    if (base.width() == 0 || base.height() == 0)
+        return { 1.0f, 1.0f, 1.0f, 1.0f };
 
-    return { b0, b1, b2, 1.0f };
+    // The level of detail is the log2 of how many texels of the base level one pixel step covers,
+    // along whichever screen axis covers more (OpenGL 1.5 spec, 3.8.8).
+    float texels_per_pixel_x = hypotf(uv_dx.x() * base.width(), uv_dx.y() * base.height());
+    float texels_per_pixel_y = hypotf(uv_dy.x() * base.width(), uv_dy.y() * base.height());
+    float scale_factor = max(texels_per_pixel_x, texels_per_pixel_y);
+
+    // Magnification, or a degenerate footprint that has no sensible level of detail.
+    if (!(scale_factor > 1.0f))
+        return sample_level(0, uv, m_sampler_params.m_mag_filter);
+
+    float lod = log2f(scale_factor);
+    switch (m_sampler_params.m_min_filter) {
+    case GL_NEAREST:
+    case GL_LINEAR:
+        return sample_level(0, uv, m_sampler_params.m_min_filter);
+    case GL_NEAREST_MIPMAP_NEAREST:
+    case GL_LINEAR_MIPMAP_NEAREST: {
+        auto filter = m_sampler_params.m_min_filter == GL_NEAREST_MIPMAP_NEAREST ? GL_NEAREST : GL_LINEAR;
+        return sample_level(min(static_cast<size_t>(lod + 0.5f), m_max_level), uv, filter);
+    }
+    case GL_NEAREST_MIPMAP_LINEAR:
+    case GL_LINEAR_MIPMAP_LINEAR: {
+        auto filter = m_sampler_params.m_min_filter == GL_NEAREST_MIPMAP_LINEAR ? GL_NEAREST : GL_LINEAR;
+        auto level = static_cast<size_t>(lod);
+        if (level >= m_max_level)
+            return sample_level(m_max_level, uv, filter);
+        float fraction = lod - level;
+        return sample_level(level, uv, filter) * (1 - fraction) + sample_level(level + 1, uv, filter) * fraction;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
 }
 
 }
@@ -28,17 +28,36 @@ public:
         MipMap() = default;
         ~MipMap() = default;
 
-        void set_width(GLsizei width) { m_width = width; }
-        void set_height(GLsizei height) { m_height = height; }
+        void resize(GLsizei width, GLsizei height)
+        {
+            m_width = width;
+            m_height = height;
+            m_tiles_per_row = (width + TILE_SIZE - 1) / TILE_SIZE;
+            m_pixel_data.resize(m_tiles_per_row * ((height + TILE_SIZE - 1) / TILE_SIZE) * TILE_SIZE * TILE_SIZE);
+        }
+
         GLsizei width() const { return m_width; }
         GLsizei height() const { return m_height; }
 
-        Vector<u32>& pixel_data() { return m_pixel_data; }
-        const Vector<u32>& pixel_data() const { return m_pixel_data; }
+        // Texels are RGBA8, with red in the lowest byte.
+        u32 texel(int x, int y) const { return m_pixel_data[texel_index(x, y)]; }
+        void set_texel(int x, int y, u32 texel) { m_pixel_data[texel_index(x, y)] = texel; }
 
     private:
-        GLsizei m_width;
-        GLsizei m_height;
+        // The texels are stored in 4x4 tiles of one cache line each, so the neighbouring texels a filter reads
+        // and the ones the pixels next to it hit are mostly already in the cache, whichever way the texture runs
+        // across the screen.
+        static constexpr int TILE_SIZE = 4;
+
+        size_t texel_index(int x, int y) const
+        {
+            size_t tile = (y / TILE_SIZE) * m_tiles_per_row + (x / TILE_SIZE);
+            return tile * TILE_SIZE * TILE_SIZE + (y % TILE_SIZE) * TILE_SIZE + (x % TILE_SIZE);
+        }
+
+        GLsizei m_width { 0 };
+        GLsizei m_height { 0 };
+        size_t m_tiles_per_row { 0 };
         Vector<u32> m_pixel_data;
     };
 
@@ -60,21 +79,23 @@ public:
 
     void upload_texture_data(GLenum target, GLint lod, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
     void replace_sub_texture_data(GLint lod, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* data);
-    FloatVector4 sample_texel(const FloatVector2& uv) const;
+
+    // The derivatives of uv across the screen pick the mipmap level(s) to sample from.
+    FloatVector4 sample_texel(const FloatVector2& uv, const FloatVector2& uv_dx, const FloatVector2& uv_dy) const;
 
     GLenum internal_format() const { return m_internal_format; }
 
+    TextureSamplerParamaters& sampler_parameters() { return m_sampler_params; }
+    const TextureSamplerParamaters& sampler_parameters() const { return m_sampler_params; }
+
 private:
-    template<typename TCallback>
-    void swizzle(Vector<u32>& pixels, TCallback&& callback)
-    {
-        for (auto& pixel : pixels)
-            pixel = callback(pixel);
-    }
+    void generate_mipmaps();
+    FloatVector4 sample_level(size_t level, const FloatVector2& uv, GLint filter) const;
 
 private:
-    // FIXME: Mipmaps are currently unused, but we have the plumbing for it at least
-    Array<MipMap, LOG2_MAX_TEXTURE_SIZE> m_mipmaps;
+    Array<MipMap, LOG2_MAX_TEXTURE_SIZE + 1> m_mipmaps;
+    // The levels from 0 up to this one form a complete mipmap chain.
+    size_t m_max_level { 0 };
     GLenum m_internal_format;
     TextureSamplerParamaters m_sampler_params;
 };
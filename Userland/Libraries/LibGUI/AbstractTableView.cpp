@@ -97,6 +97,16 @@ void AbstractTableView::update_column_sizes()
     int column_count = model.column_count();
     int row_count = model.row_count();
 
+    // Only the rows in view (or a screenful, before there is a view) get measured, so that a model with a million
+    // rows doesn't get all of its data fetched whenever it updates. Columns never shrink here, so they keep fitting
+    // whatever has been in view before.
+    static constexpr int minimum_rows_to_measure = 100;
+    auto visible_rect = visible_content_rect();
+    int first_row = clamp(visible_rect.top() / row_height(), 0, max(row_count - 1, 0));
+    int rows_to_measure = min(max(visible_rect.height() / row_height() + 1, minimum_rows_to_measure), row_count - first_row);
+    Vector<Variant> cells;
+    cells.resize(rows_to_measure);
+
     for (int column = 0; column < column_count; ++column) {
         if (!column_header().is_section_visible(column))
             continue;
@@ -104,8 +114,8 @@ void AbstractTableView::update_column_sizes()
         if (column == m_key_column && model.is_column_sortable(column))
             header_width += font().width(" \xE2\xAC\x86"); // UPWARDS BLACK ARROW
         int column_width = header_width;
-        for (int row = 0; row < row_count; ++row) {
-            auto cell_data = model.index(row, column).data();
+        model.fetch_data(first_row, column, cells.span());
+        for (auto& cell_data : cells) {
             int cell_width = 0;
             if (cell_data.is_icon()) {
                 cell_width = cell_data.as_icon().bitmap_for_size(16)->width();
@@ -219,17 +229,19 @@ ModelIndex AbstractTableView::index_at_event_position(const Gfx::IntPoint& posit
         return {};
 
     auto adjusted_position = this->adjusted_position(position);
-    for (int row = 0, row_count = model()->row_count(); row < row_count; ++row) {
-        if (!row_rect(row).contains(adjusted_position))
+    // All rows are the same height, so the row can be worked out rather than searched for.
+    int y = adjusted_position.y() - (column_header().is_visible() ? column_header().height() : 0);
+    if (y < 0)
+        return {};
+    int row = y / row_height();
+    if (row >= model()->row_count() || !row_rect(row).contains(adjusted_position))
+        return {};
+    for (int column = 0, column_count = model()->column_count(); column < column_count; ++column) {
+        if (!content_rect(row, column).contains(adjusted_position))
             continue;
-        for (int column = 0, column_count = model()->column_count(); column < column_count; ++column) {
-            if (!content_rect(row, column).contains(adjusted_position))
-                continue;
-            return model()->index(row, column);
-        }
-        return model()->index(row, 0);
+        return model()->index(row, column);
     }
-    return {};
+    return model()->index(row, 0);
 }
 
 ModelIndex AbstractTableView::index_at_event_position(const Gfx::IntPoint& position) const
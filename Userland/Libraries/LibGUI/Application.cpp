@@ -10,6 +10,7 @@
 #include <LibGUI/Application.h>
 #include <LibGUI/Clipboard.h>
 #include <LibGUI/Desktop.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/Menubar.h>
 #include <LibGUI/Painter.h>
@@ -75,6 +76,7 @@ Application::Application(int argc, char** argv, Core::EventLoop::MakeInspectable
     m_event_loop = make<Core::EventLoop>(make_inspectable);
     WindowServerConnection::the();
     Clipboard::initialize({});
+    IconCache::initialize({});
     if (argc > 0)
         m_invoked_as = argv[0];
 
@@ -5,6 +5,7 @@
  */
 
 #include <LibGUI/AutocompleteProvider.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Model.h>
 #include <LibGUI/TableView.h>
 #include <LibGUI/TextEditor.h>
@@ -47,13 +48,13 @@ public:
             if (index.column() == Column::Icon) {
                 if (suggestion.language == GUI::AutocompleteProvider::Language::Cpp) {
                     if (!s_cpp_identifier_icon) {
-                        s_cpp_identifier_icon = Gfx::Bitmap::try_load_from_file("/res/icons/16x16/completion/cpp-identifier.png");
+                        s_cpp_identifier_icon = IconCache::load_bitmap("/res/icons/16x16/completion/cpp-identifier.png");
                     }
                     return *s_cpp_identifier_icon;
                 }
                 if (suggestion.language == GUI::AutocompleteProvider::Language::Unspecified) {
                     if (!s_unspecified_identifier_icon) {
-                        s_unspecified_identifier_icon = Gfx::Bitmap::try_load_from_file("/res/icons/16x16/completion/unspecified-identifier.png");
+                        s_unspecified_identifier_icon = IconCache::load_bitmap("/res/icons/16x16/completion/unspecified-identifier.png");
                     }
                     return *s_unspecified_identifier_icon;
                 }
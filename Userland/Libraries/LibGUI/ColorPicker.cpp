@@ -8,6 +8,7 @@
 #include <LibGUI/Button.h>
 #include <LibGUI/ColorPicker.h>
 #include <LibGUI/Frame.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/Painter.h>
 #include <LibGUI/SpinBox.h>
@@ -129,7 +130,7 @@ ColorPicker::ColorPicker(Color color, Window* parent_window, String title)
     : Dialog(parent_window)
     , m_color(color)
 {
-    set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/color-chooser.png"));
+    set_icon(IconCache::load_bitmap("/res/icons/16x16/color-chooser.png"));
     set_title(title);
     set_resizable(false);
     resize(458, 326);
@@ -7,6 +7,7 @@
 #include <LibGUI/Button.h>
 #include <LibGUI/ComboBox.h>
 #include <LibGUI/Desktop.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/ListView.h>
 #include <LibGUI/Model.h>
 #include <LibGUI/Scrollbar.h>
@@ -75,7 +76,7 @@ ComboBox::ComboBox()
     };
 
     m_open_button = add<Button>();
-    m_open_button->set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/downward-triangle.png"));
+    m_open_button->set_icon(IconCache::load_bitmap("/res/icons/16x16/downward-triangle.png"));
     m_open_button->set_focus_policy(GUI::FocusPolicy::NoFocus);
     m_open_button->on_click = [this](auto) {
         if (m_list_window->is_visible())
@@ -16,6 +16,7 @@
 #include <LibGUI/FilePicker.h>
 #include <LibGUI/FilePickerDialogGML.h>
 #include <LibGUI/FileSystemModel.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/InputBox.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/Menu.h>
@@ -73,11 +74,11 @@ FilePicker::FilePicker(Window* parent_window, Mode mode, const StringView& filen
     case Mode::OpenMultiple:
     case Mode::OpenFolder:
         set_title("Open");
-        set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/open.png"));
+        set_icon(IconCache::load_bitmap("/res/icons/16x16/open.png"));
         break;
     case Mode::Save:
         set_title("Save as");
-        set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/save.png"));
+        set_icon(IconCache::load_bitmap("/res/icons/16x16/save.png"));
         break;
     }
     resize(560, 320);
@@ -113,7 +114,7 @@ FilePicker::FilePicker(Window* parent_window, Mode mode, const StringView& filen
     };
 
     auto open_parent_directory_action = Action::create(
-        "Open parent directory", { Mod_Alt, Key_Up }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/open-parent-directory.png"), [this](const Action&) {
+        "Open parent directory", { Mod_Alt, Key_Up }, IconCache::load_bitmap("/res/icons/16x16/open-parent-directory.png"), [this](const Action&) {
             set_path(String::formatted("{}/..", m_model->root_path()));
         },
         this);
@@ -127,7 +128,7 @@ FilePicker::FilePicker(Window* parent_window, Mode mode, const StringView& filen
     toolbar.add_separator();
 
     auto mkdir_action = Action::create(
-        "New directory...", { Mod_Ctrl | Mod_Shift, Key_N }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/mkdir.png"), [this](const Action&) {
+        "New directory...", { Mod_Ctrl | Mod_Shift, Key_N }, IconCache::load_bitmap("/res/icons/16x16/mkdir.png"), [this](const Action&) {
             String value;
             if (InputBox::show(this, value, "Enter name:", "New directory") == InputBox::ExecOK && !value.is_empty()) {
                 auto new_dir_path = LexicalPath::canonicalized_path(String::formatted("{}/{}", m_model->root_path(), value));
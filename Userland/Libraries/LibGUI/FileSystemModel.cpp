@@ -6,6 +6,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <AK/MappedFile.h>
 #include <AK/NumberFormat.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
@@ -16,6 +17,7 @@
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/ImageDecoder.h>
 #include <LibThreading/BackgroundAction.h>
 #include <grp.h>
 #include <pwd.h>
@@ -557,7 +559,15 @@ static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
 
 static RefPtr<Gfx::Bitmap> render_thumbnail(const StringView& path)
 {
-    auto png_bitmap = Gfx::Bitmap::try_load_from_file(path);
+    auto file_or_error = MappedFile::map(path);
+    if (file_or_error.is_error())
+        return nullptr;
+    auto decoder = Gfx::ImageDecoder::try_create(file_or_error.value()->bytes());
+    if (!decoder)
+        return nullptr;
+    // Formats that can decode at a reduced size then don't have to produce a full-size bitmap just to shrink it.
+    decoder->set_target_size({ 32, 32 });
+    auto png_bitmap = decoder->frame(0).image;
     if (!png_bitmap)
         return nullptr;
 
@@ -9,6 +9,7 @@
 #include <LibGUI/FontPicker.h>
 #include <LibGUI/FontPickerDialogGML.h>
 #include <LibGUI/FontPickerWeightModel.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/ListView.h>
 #include <LibGUI/Scrollbar.h>
@@ -24,7 +25,7 @@ FontPicker::FontPicker(Window* parent_window, const Gfx::Font* current_font, boo
 {
     set_title("Font picker");
     resize(430, 280);
-    set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/app-font-editor.png"));
+    set_icon(IconCache::load_bitmap("/res/icons/16x16/app-font-editor.png"));
 
     auto& widget = set_main_widget<GUI::Widget>();
     if (!widget.load_from_gml(font_picker_dialog_gml))
@@ -38,6 +38,20 @@ char IniLexer::consume()
 Vector<IniToken> IniLexer::lex()
 {
     Vector<IniToken> tokens;
+    lex_iterable([&](auto token) {
+        tokens.append(token);
+        return IterationDecision::Continue;
+    });
+    return tokens;
+}
+
+void IniLexer::lex_iterable(Function<IterationDecision(IniToken)> const& callback)
+{
+    bool should_stop = false;
+    auto emit = [&](IniToken const& token) {
+        if (!should_stop)
+            should_stop = callback(token) == IterationDecision::Break;
+    };
 
     size_t token_start_index = 0;
     IniPosition token_start_position;
@@ -48,7 +62,7 @@ Vector<IniToken> IniLexer::lex()
         token.m_start = m_position;
         consume();
         token.m_end = m_position;
-        tokens.append(token);
+        emit(token);
     };
 
     auto begin_token = [&] {
@@ -61,10 +75,10 @@ Vector<IniToken> IniLexer::lex()
         token.m_type = type;
         token.m_start = token_start_position;
         token.m_end = m_position;
-        tokens.append(token);
+        emit(token);
     };
 
-    while (m_index < m_input.length()) {
+    while (m_index < m_input.length() && !should_stop) {
         auto ch = peek();
 
         if (is_ascii_space(ch)) {
@@ -133,7 +147,6 @@ Vector<IniToken> IniLexer::lex()
             commit_token(IniToken::Type::Value);
         }
     }
-    return tokens;
 }
 
 }
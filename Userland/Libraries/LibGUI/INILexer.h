@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
 #include <AK/StringView.h>
 
 namespace GUI {
@@ -55,6 +57,8 @@ public:
     IniLexer(StringView const&);
 
     Vector<IniToken> lex();
+    // Hands over the tokens one at a time, until the callback says to stop.
+    void lex_iterable(Function<IterationDecision(IniToken)> const&);
 
 private:
     char peek(size_t offset = 0) const;
@@ -40,23 +40,20 @@ bool IniSyntaxHighlighter::is_identifier(u64 token) const
 
 void IniSyntaxHighlighter::rehighlight(const Palette& palette)
 {
-    auto text = m_client->get_text();
-    IniLexer lexer(text);
-    auto tokens = lexer.lex();
-
-    Vector<GUI::TextDocumentSpan> spans;
-    for (auto& token : tokens) {
-        GUI::TextDocumentSpan span;
-        span.range.set_start({ token.m_start.line, token.m_start.column });
-        span.range.set_end({ token.m_end.line, token.m_end.column });
-        auto style = style_for_token_type(palette, token.m_type);
-        span.attributes.color = style.color;
-        span.attributes.bold = style.bold;
-        span.is_skippable = token.m_type == IniToken::Type::Whitespace;
-        span.data = static_cast<u64>(token.m_type);
-        spans.append(span);
-    }
-    m_client->do_set_spans(move(spans));
+    lex_changed_text([&](auto text, auto& on_span) {
+        IniLexer lexer(text);
+        lexer.lex_iterable([&](auto token) {
+            GUI::TextDocumentSpan span;
+            span.range.set_start({ token.m_start.line, token.m_start.column });
+            span.range.set_end({ token.m_end.line, token.m_end.column });
+            auto style = style_for_token_type(palette, token.m_type);
+            span.attributes.color = style.color;
+            span.attributes.bold = style.bold;
+            span.is_skippable = token.m_type == IniToken::Type::Whitespace;
+            span.data = static_cast<u64>(token.m_type);
+            return on_span(move(span));
+        });
+    });
 
     m_has_brace_buddies = false;
     highlight_matching_token_pair();
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <IconCache/IconCacheClientEndpoint.h>
+#include <IconCache/IconCacheServerEndpoint.h>
+#include <LibGUI/IconCache.h>
+#include <LibGfx/Bitmap.h>
+#include <LibIPC/ServerConnection.h>
+
+namespace GUI {
+
+class IconCacheServerConnection final
+    : public IPC::ServerConnection<IconCacheClientEndpoint, IconCacheServerEndpoint>
+    , public IconCacheClientEndpoint {
+    C_OBJECT(IconCacheServerConnection);
+
+public:
+    bool is_alive() const { return m_alive; }
+
+    virtual void die() override
+    {
+        // Unlike most servers, losing this one isn't fatal, as we can always decode the icons ourselves.
+        m_alive = false;
+    }
+
+private:
+    IconCacheServerConnection()
+        : IPC::ServerConnection<IconCacheClientEndpoint, IconCacheServerEndpoint>(*this, "/tmp/portal/iconcache")
+    {
+    }
+
+    bool m_alive { true };
+};
+
+static IconCacheServerConnection* s_connection;
+
+// The service counts us as a user of every icon we've been given until we disconnect, so there's no point in asking
+// for one twice.
+static HashMap<String, RefPtr<Gfx::Bitmap>> s_bitmaps;
+
+void IconCache::initialize(Badge<Application>)
+{
+    s_connection = &IconCacheServerConnection::construct().leak_ref();
+}
+
+RefPtr<Gfx::Bitmap> IconCache::load_bitmap(String const& path)
+{
+    if (!s_connection || !s_connection->is_alive() || !path.starts_with("/res/icons/"))
+        return Gfx::Bitmap::try_load_from_file(path);
+
+    if (auto it = s_bitmaps.find(path); it != s_bitmaps.end())
+        return it->value;
+
+    auto response_or_error = s_connection->try_get_icon(path);
+    if (response_or_error.is_error())
+        return Gfx::Bitmap::try_load_from_file(path);
+
+    auto bitmap = response_or_error.value().bitmap();
+    s_bitmaps.set(path, bitmap);
+    return bitmap;
+}
+
+}
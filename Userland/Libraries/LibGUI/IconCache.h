@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/String.h>
+#include <LibGUI/Forward.h>
+#include <LibGfx/Forward.h>
+
+namespace GUI {
+
+// Icons in /res/icons are decoded once by the IconCache service and shared between every process that uses them.
+class IconCache {
+public:
+    static void initialize(Badge<Application>);
+
+    // Falls back to decoding the file in this process when it's not an icon, or the service isn't available.
+    static RefPtr<Gfx::Bitmap> load_bitmap(String const& path);
+};
+
+}
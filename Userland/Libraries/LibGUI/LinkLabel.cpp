@@ -7,6 +7,7 @@
 #include <LibGUI/Action.h>
 #include <LibGUI/Clipboard.h>
 #include <LibGUI/Event.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/LinkLabel.h>
 #include <LibGUI/Menu.h>
 #include <LibGUI/Painter.h>
@@ -29,7 +30,7 @@ LinkLabel::LinkLabel(String text)
 
 void LinkLabel::setup_actions()
 {
-    m_open_action = GUI::Action::create("Show in File Manager", {}, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/app-file-manager.png"), [&](const GUI::Action&) {
+    m_open_action = GUI::Action::create("Show in File Manager", {}, IconCache::load_bitmap("/res/icons/16x16/app-file-manager.png"), [&](const GUI::Action&) {
         if (on_click)
             on_click();
     });
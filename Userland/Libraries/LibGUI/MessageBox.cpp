@@ -6,6 +6,7 @@
 
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/ImageWidget.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/MessageBox.h>
@@ -45,13 +46,13 @@ RefPtr<Gfx::Bitmap> MessageBox::icon() const
 {
     switch (m_type) {
     case Type::Information:
-        return Gfx::Bitmap::try_load_from_file("/res/icons/32x32/msgbox-information.png");
+        return IconCache::load_bitmap("/res/icons/32x32/msgbox-information.png");
     case Type::Warning:
-        return Gfx::Bitmap::try_load_from_file("/res/icons/32x32/msgbox-warning.png");
+        return IconCache::load_bitmap("/res/icons/32x32/msgbox-warning.png");
     case Type::Error:
-        return Gfx::Bitmap::try_load_from_file("/res/icons/32x32/msgbox-error.png");
+        return IconCache::load_bitmap("/res/icons/32x32/msgbox-error.png");
     case Type::Question:
-        return Gfx::Bitmap::try_load_from_file("/res/icons/32x32/msgbox-question.png");
+        return IconCache::load_bitmap("/res/icons/32x32/msgbox-question.png");
     default:
         return nullptr;
     }
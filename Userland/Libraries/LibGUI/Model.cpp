@@ -17,6 +17,12 @@ Model::~Model()
 {
 }
 
+void Model::fetch_data(int first_row, int column, Span<Variant> data, ModelRole role, const ModelIndex& parent) const
+{
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = this->data(index(first_row + i, column, parent), role);
+}
+
 void Model::register_view(Badge<AbstractView>, AbstractView& view)
 {
     m_views.set(&view);
@@ -10,6 +10,7 @@
 #include <AK/Function.h>
 #include <AK/HashTable.h>
 #include <AK/RefCounted.h>
+#include <AK/Span.h>
 #include <AK/String.h>
 #include <LibCore/MimeData.h>
 #include <LibGUI/ModelIndex.h>
@@ -55,6 +56,9 @@ public:
     virtual int column_count(const ModelIndex& = ModelIndex()) const = 0;
     virtual String column_name(int) const { return {}; }
     virtual Variant data(const ModelIndex&, ModelRole = ModelRole::Display) const = 0;
+    // Fills data with one column of the rows starting at first_row, for views and proxies that need many rows at once.
+    // Models that can look up a batch of rows more cheaply than one row at a time should override it.
+    virtual void fetch_data(int first_row, int column, Span<Variant> data, ModelRole = ModelRole::Display, const ModelIndex& parent = ModelIndex()) const;
     virtual TriState data_matches(const ModelIndex&, const Variant&) const { return TriState::Unknown; }
     virtual void update() = 0;
     virtual ModelIndex parent_index(const ModelIndex&) const { return {}; }
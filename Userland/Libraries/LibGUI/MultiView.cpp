@@ -7,6 +7,7 @@
 #include <AK/StringBuilder.h>
 #include <LibGUI/Action.h>
 #include <LibGUI/ActionGroup.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Model.h>
 #include <LibGUI/MultiView.h>
 #include <LibGUI/Window.h>
@@ -104,19 +105,19 @@ void MultiView::set_column_visible(int column_index, bool visible)
 void MultiView::build_actions()
 {
     m_view_as_icons_action = Action::create_checkable(
-        "Icon view", { Mod_Ctrl, KeyCode::Key_1 }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/icon-view.png"), [this](auto&) {
+        "Icon view", { Mod_Ctrl, KeyCode::Key_1 }, IconCache::load_bitmap("/res/icons/16x16/icon-view.png"), [this](auto&) {
             set_view_mode(ViewMode::Icon);
         },
         this);
 
     m_view_as_table_action = Action::create_checkable(
-        "Table view", { Mod_Ctrl, KeyCode::Key_2 }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/table-view.png"), [this](auto&) {
+        "Table view", { Mod_Ctrl, KeyCode::Key_2 }, IconCache::load_bitmap("/res/icons/16x16/table-view.png"), [this](auto&) {
             set_view_mode(ViewMode::Table);
         },
         this);
 
     m_view_as_columns_action = Action::create_checkable(
-        "Columns view", { Mod_Ctrl, KeyCode::Key_3 }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/columns-view.png"), [this](auto&) {
+        "Columns view", { Mod_Ctrl, KeyCode::Key_3 }, IconCache::load_bitmap("/res/icons/16x16/columns-view.png"), [this](auto&) {
             set_view_mode(ViewMode::Columns);
         },
         this);
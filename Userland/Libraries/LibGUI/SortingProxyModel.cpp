@@ -120,15 +120,6 @@ StringView SortingProxyModel::drag_data_type() const
     return source().drag_data_type();
 }
 
-bool SortingProxyModel::less_than(const ModelIndex& index1, const ModelIndex& index2) const
-{
-    auto data1 = index1.data(m_sort_role);
-    auto data2 = index2.data(m_sort_role);
-    if (data1.is_string() && data2.is_string())
-        return data1.as_string().to_lowercase() < data2.as_string().to_lowercase();
-    return data1 < data2;
-}
-
 ModelIndex SortingProxyModel::index(int row, int column, const ModelIndex& parent) const
 {
     if (row < 0 || column < 0)
@@ -162,8 +153,17 @@ ModelIndex SortingProxyModel::parent_index(const ModelIndex& proxy_index) const
 
 void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sort_order)
 {
+    int row_count = source().row_count(mapping.source_parent);
+    if (mapping.source_rows.size() != static_cast<size_t>(row_count)) {
+        mapping.source_rows.resize(row_count);
+        mapping.proxy_rows.resize(row_count);
+        for (int i = 0; i < row_count; ++i) {
+            mapping.source_rows[i] = i;
+            mapping.proxy_rows[i] = i;
+        }
+    }
+
     if (column == -1) {
-        int row_count = source().row_count(mapping.source_parent);
         for (int i = 0; i < row_count; ++i) {
             mapping.source_rows[i] = i;
             mapping.proxy_rows[i] = i;
@@ -171,16 +171,30 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
         return;
     }
 
-    auto old_source_rows = mapping.source_rows;
-
-    int row_count = source().row_count(mapping.source_parent);
-    for (int i = 0; i < row_count; ++i)
-        mapping.source_rows[i] = i;
+    // Fetch every row's sort key once up front, rather than twice for every comparison.
+    Vector<Variant> keys;
+    keys.resize(row_count);
+    source().fetch_data(0, column, keys.span(), m_sort_role, mapping.source_parent);
+    for (auto& key : keys) {
+        if (key.is_string())
+            key = key.as_string().to_lowercase();
+    }
+    auto comes_before = [&](int row1, int row2) {
+        return sort_order == SortOrder::Ascending ? keys[row1] < keys[row2] : keys[row2] < keys[row1];
+    };
+
+    // The mapping is sorted from its previous order on, which is usually still sorted after the source model has
+    // updated. In that case, nothing moves and there's nothing to sort.
+    bool is_sorted = true;
+    for (int i = 1; i < row_count && is_sorted; ++i) {
+        if (comes_before(mapping.source_rows[i], mapping.source_rows[i - 1]))
+            is_sorted = false;
+    }
+    if (is_sorted)
+        return;
 
-    quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
-        return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
-    });
+    auto old_source_rows = mapping.source_rows;
+    quick_sort(mapping.source_rows, comes_before);
 
     for (int i = 0; i < row_count; ++i)
         mapping.proxy_rows[mapping.source_rows[i]] = i;
@@ -189,40 +203,24 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
     for_each_view([&](AbstractView& view) {
         // Update the view's cursor.
         auto cursor = view.cursor_index();
-        if (cursor.is_valid() && cursor.parent() == mapping.source_parent) {
-            for (size_t i = 0; i < mapping.source_rows.size(); ++i) {
-                if (mapping.source_rows[i] == view.cursor_index().row()) {
-                    auto new_source_index = this->index(i, view.cursor_index().column(), mapping.source_parent);
-                    view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
-                    break;
-                }
-            }
+        if (cursor.is_valid() && cursor.parent() == mapping.source_parent && static_cast<size_t>(cursor.row()) < old_source_rows.size()) {
+            auto new_cursor = this->index(mapping.proxy_rows[old_source_rows[cursor.row()]], cursor.column(), mapping.source_parent);
+            view.set_cursor(new_cursor, AbstractView::SelectionUpdate::None, false);
         }
 
         // Update the view's selection.
         view.selection().change_from_model({}, [&](ModelSelection& selection) {
-            Vector<ModelIndex> selected_indices_in_source;
             Vector<ModelIndex> stale_indices_in_selection;
             selection.for_each_index([&](const ModelIndex& index) {
-                if (index.parent() == mapping.source_parent) {
+                if (index.parent() == mapping.source_parent && static_cast<size_t>(index.row()) < old_source_rows.size())
                     stale_indices_in_selection.append(index);
-                    selected_indices_in_source.append(source().index(old_source_rows[index.row()], index.column(), mapping.source_parent));
-                }
             });
 
-            for (auto& index : stale_indices_in_selection) {
+            for (auto& index : stale_indices_in_selection)
                 selection.remove(index);
-            }
-
-            for (auto& index : selected_indices_in_source) {
-                for (size_t i = 0; i < mapping.source_rows.size(); ++i) {
-                    if (mapping.source_rows[i] == index.row()) {
-                        auto new_source_index = this->index(i, index.column(), mapping.source_parent);
-                        selection.add(new_source_index);
-                        break;
-                    }
-                }
-            }
+
+            for (auto& index : stale_indices_in_selection)
+                selection.add(this->index(mapping.proxy_rows[old_source_rows[index.row()]], index.column(), mapping.source_parent));
         });
     });
 }
@@ -250,10 +248,6 @@ SortingProxyModel::InternalMapIterator SortingProxyModel::build_mapping(const Mo
 
     mapping->source_parent = source_parent;
 
-    int row_count = source().row_count(source_parent);
-    mapping->source_rows.resize(row_count);
-    mapping->proxy_rows.resize(row_count);
-
     sort_mapping(*mapping, m_last_key_column, m_last_sort_order);
 
     if (source_parent.is_valid()) {
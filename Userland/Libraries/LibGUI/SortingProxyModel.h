@@ -33,8 +33,6 @@ public:
 
     virtual bool is_column_sortable(int column_index) const override;
 
-    virtual bool less_than(const ModelIndex&, const ModelIndex&) const;
-
     ModelIndex map_to_source(const ModelIndex&) const;
     ModelIndex map_to_proxy(const ModelIndex&) const;
 
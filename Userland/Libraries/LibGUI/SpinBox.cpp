@@ -5,6 +5,7 @@
  */
 
 #include <LibGUI/Button.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/SpinBox.h>
 #include <LibGUI/TextBox.h>
 
@@ -33,12 +34,12 @@ SpinBox::SpinBox()
     };
 
     m_increment_button = add<Button>();
-    m_increment_button->set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/upward-triangle.png"));
+    m_increment_button->set_icon(IconCache::load_bitmap("/res/icons/16x16/upward-triangle.png"));
     m_increment_button->set_focus_policy(GUI::FocusPolicy::NoFocus);
     m_increment_button->on_click = [this](auto) { set_value(m_value + 1); };
     m_increment_button->set_auto_repeat_interval(150);
     m_decrement_button = add<Button>();
-    m_decrement_button->set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/downward-triangle.png"));
+    m_decrement_button->set_icon(IconCache::load_bitmap("/res/icons/16x16/downward-triangle.png"));
     m_decrement_button->set_focus_policy(GUI::FocusPolicy::NoFocus);
     m_decrement_button->on_click = [this](auto) { set_value(m_value - 1); };
     m_decrement_button->set_auto_repeat_interval(150);
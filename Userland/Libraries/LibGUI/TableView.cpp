@@ -190,6 +190,13 @@ void TableView::keydown_event(KeyEvent& event)
     }
 }
 
+void TableView::did_scroll()
+{
+    AbstractTableView::did_scroll();
+    // Columns are only sized to fit the rows in view, so the ones coming into view may need them to grow.
+    update_column_sizes();
+}
+
 void TableView::move_cursor(CursorMovement movement, SelectionUpdate selection_update)
 {
     if (!model())
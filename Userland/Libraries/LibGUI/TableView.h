@@ -41,6 +41,7 @@ protected:
 
     virtual void keydown_event(KeyEvent&) override;
     virtual void paint_event(PaintEvent&) override;
+    virtual void did_scroll() override;
 
 private:
     GridStyle m_grid_style { GridStyle::None };
@@ -40,7 +40,7 @@ TextDocument::~TextDocument()
 {
 }
 
-bool TextDocument::set_text(const StringView& text)
+bool TextDocument::set_text(const StringView& new_text)
 {
     m_client_notifications_enabled = false;
     m_undo_stack.clear();
@@ -51,38 +51,29 @@ bool TextDocument::set_text(const StringView& text)
         set_text({});
     });
 
+    // The lines point into our own copy of the text until they are decoded.
+    m_loaded_text = ByteBuffer::copy(new_text.bytes());
+    StringView text { m_loaded_text };
+    if (!Utf8View(text).validate())
+        return false;
+
     size_t start_of_current_line = 0;
 
-    auto add_line = [&](size_t current_position) -> bool {
-        size_t line_length = current_position - start_of_current_line;
+    auto add_line = [&](size_t current_position) {
         auto line = make<TextDocumentLine>(*this);
-
-        bool success = true;
-        if (line_length)
-            success = line->set_text(*this, text.substring_view(start_of_current_line, current_position - start_of_current_line));
-
-        if (!success)
-            return false;
-
+        auto line_text = text.substring_view(start_of_current_line, current_position - start_of_current_line);
+        if (!line_text.is_empty())
+            line->set_undecoded_text(*this, line_text, Utf8View(line_text).length());
         append_line(move(line));
         start_of_current_line = current_position + 1;
-
-        return true;
     };
 
     size_t i = 0;
     for (i = 0; i < text.length(); ++i) {
-        if (text[i] != '\n')
-            continue;
-
-        auto success = add_line(i);
-        if (!success)
-            return false;
+        if (text[i] == '\n')
+            add_line(i);
     }
-
-    auto success = add_line(i);
-    if (!success)
-        return false;
+    add_line(i);
 
     // Don't show the file's trailing newline as an actual new line.
     if (line_count() > 1 && line(line_count() - 1).is_empty())
@@ -141,9 +132,10 @@ bool TextDocumentLine::can_select() const
 
 size_t TextDocumentLine::leading_spaces() const
 {
+    auto* text = code_points();
     size_t count = 0;
-    for (; count < m_text.size(); ++count) {
-        if (m_text[count] != ' ') {
+    for (; count < length(); ++count) {
+        if (text[count] != ' ') {
             break;
         }
     }
@@ -152,6 +144,8 @@ size_t TextDocumentLine::leading_spaces() const
 
 String TextDocumentLine::to_utf8() const
 {
+    if (!is_decoded())
+        return m_undecoded_text;
     StringBuilder builder;
     builder.append(view());
     return builder.to_string();
@@ -167,15 +161,36 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, const StringView& tex
     set_text(document, text);
 }
 
+void TextDocumentLine::decode() const
+{
+    if (is_decoded())
+        return;
+    m_text.ensure_capacity(m_undecoded_length);
+    for (auto code_point : Utf8View(m_undecoded_text))
+        m_text.unchecked_append(code_point);
+    m_undecoded_text = {};
+}
+
+void TextDocumentLine::set_undecoded_text(TextDocument& document, const StringView& valid_utf8, size_t length)
+{
+    VERIFY(!valid_utf8.is_null());
+    m_text.clear();
+    m_undecoded_text = valid_utf8;
+    m_undecoded_length = length;
+    document.update_views({});
+}
+
 void TextDocumentLine::clear(TextDocument& document)
 {
     m_text.clear();
+    m_undecoded_text = {};
     document.update_views({});
 }
 
 void TextDocumentLine::set_text(TextDocument& document, const Vector<u32> text)
 {
     m_text = move(text);
+    m_undecoded_text = {};
     document.update_views({});
 }
 
@@ -186,6 +201,7 @@ bool TextDocumentLine::set_text(TextDocument& document, const StringView& text)
         return true;
     }
     m_text.clear();
+    m_undecoded_text = {};
     Utf8View utf8_view(text);
     if (!utf8_view.validate()) {
         return false;
@@ -200,6 +216,7 @@ void TextDocumentLine::append(TextDocument& document, const u32* code_points, si
 {
     if (length == 0)
         return;
+    decode();
     m_text.append(code_points, length);
     document.update_views({});
 }
@@ -216,6 +233,7 @@ void TextDocumentLine::prepend(TextDocument& document, u32 code_point)
 
 void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_point)
 {
+    decode();
     if (index == length()) {
         m_text.append(code_point);
     } else {
@@ -226,6 +244,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
 {
+    decode();
     if (index == length()) {
         m_text.take_last();
     } else {
@@ -236,6 +255,7 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
 {
+    decode();
     VERIFY(length <= m_text.size());
 
     Vector<u32> new_data;
@@ -250,6 +270,7 @@ void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
+    decode();
     m_text.resize(length);
     document.update_views({});
 }
@@ -284,6 +305,8 @@ void TextDocument::remove_line(size_t line_index)
 void TextDocument::remove_all_lines()
 {
     lines().clear();
+    m_spans.clear();
+    m_changed_range = {};
     if (m_client_notifications_enabled) {
         for (auto* client : m_clients)
             client->document_did_remove_all_lines();
@@ -332,7 +355,10 @@ String TextDocument::text() const
     StringBuilder builder;
     for (size_t i = 0; i < line_count(); ++i) {
         auto& line = this->line(i);
-        builder.append(line.view());
+        if (line.is_decoded())
+            builder.append(line.view());
+        else
+            builder.append(line.undecoded_text());
         if (i != line_count() - 1)
             builder.append('\n');
     }
@@ -351,7 +377,9 @@ String TextDocument::text_in_range(const TextRange& a_range) const
         size_t selection_start_column_on_line = range.start().line() == i ? range.start().column() : 0;
         size_t selection_end_column_on_line = range.end().line() == i ? range.end().column() : line.length();
 
-        if (!line.is_empty()) {
+        if (!line.is_decoded() && selection_start_column_on_line == 0 && selection_end_column_on_line == line.length()) {
+            builder.append(line.undecoded_text());
+        } else if (!line.is_empty()) {
             builder.append(
                 Utf32View(
                     line.code_points() + selection_start_column_on_line,
@@ -882,16 +910,24 @@ void RemoveTextCommand::undo()
     m_document.set_all_cursors(new_cursor);
 }
 
-TextPosition TextDocument::insert_at(const TextPosition& position, const StringView& text, const Client* client)
+TextPosition TextDocument::insert_at(const TextPosition& position, const StringView& text, const Client*)
 {
     TextPosition cursor = position;
     Utf8View utf8_view(text);
     for (auto code_point : utf8_view)
-        cursor = insert_at(cursor, code_point, client);
+        cursor = insert_code_point_at(cursor, code_point);
+    move_spans_after_insertion(position, cursor);
     return cursor;
 }
 
 TextPosition TextDocument::insert_at(const TextPosition& position, u32 code_point, const Client*)
+{
+    auto end = insert_code_point_at(position, code_point);
+    move_spans_after_insertion(position, end);
+    return end;
+}
+
+TextPosition TextDocument::insert_code_point_at(const TextPosition& position, u32 code_point)
 {
     if (code_point == '\n') {
         auto new_line = make<TextDocumentLine>(*this);
@@ -953,9 +989,62 @@ void TextDocument::remove(const TextRange& unnormalized_range)
         append_line(make<TextDocumentLine>(*this));
     }
 
+    move_spans_after_removal(unnormalized_range.normalized());
     notify_did_change();
 }
 
+static TextPosition position_after_insertion(const TextPosition& position, const TextPosition& start, const TextPosition& end)
+{
+    if (position < start)
+        return position;
+    if (position.line() == start.line())
+        return { end.line(), end.column() + position.column() - start.column() };
+    return { position.line() + end.line() - start.line(), position.column() };
+}
+
+static TextPosition position_after_removal(const TextPosition& position, const TextRange& range)
+{
+    if (position < range.start())
+        return position;
+    if (position < range.end())
+        return range.start();
+    if (position.line() == range.end().line())
+        return { range.start().line(), range.start().column() + position.column() - range.end().column() };
+    return { position.line() - (range.end().line() - range.start().line()), position.column() };
+}
+
+// The spans after an edit move along with the text, so that everything outside of the edited region keeps
+// its highlighting until the highlighter has caught up.
+void TextDocument::move_spans_after_insertion(const TextPosition& start, const TextPosition& end)
+{
+    for (auto& span : m_spans) {
+        span.range.set_start(position_after_insertion(span.range.start(), start, end));
+        span.range.set_end(position_after_insertion(span.range.end(), start, end));
+    }
+
+    TextRange changed_range { start, end };
+    if (m_changed_range.has_value()) {
+        changed_range.set_start(min(start, position_after_insertion(m_changed_range->start(), start, end)));
+        changed_range.set_end(max(end, position_after_insertion(m_changed_range->end(), start, end)));
+    }
+    m_changed_range = changed_range;
+}
+
+void TextDocument::move_spans_after_removal(const TextRange& range)
+{
+    for (auto& span : m_spans) {
+        span.range.set_start(position_after_removal(span.range.start(), range));
+        span.range.set_end(position_after_removal(span.range.end(), range));
+    }
+
+    TextRange changed_range { range.start(), range.start() };
+    if (m_changed_range.has_value()) {
+        changed_range.set_start(min(range.start(), position_after_removal(m_changed_range->start(), range)));
+        changed_range.set_end(max(range.start(), position_after_removal(m_changed_range->end(), range)));
+    }
+    m_changed_range = changed_range;
+}
+
 bool TextDocument::is_empty() const
 {
     return line_count() == 1 && line(0).is_empty();
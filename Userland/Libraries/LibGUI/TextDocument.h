@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtr.h>
@@ -60,7 +61,14 @@ public:
     const TextDocumentLine& line(size_t line_index) const { return m_lines[line_index]; }
     TextDocumentLine& line(size_t line_index) { return m_lines[line_index]; }
 
-    void set_spans(Vector<TextDocumentSpan> spans) { m_spans = move(spans); }
+    void set_spans(Vector<TextDocumentSpan> spans)
+    {
+        m_spans = move(spans);
+        m_changed_range = {};
+    }
+    // The part of the text that changed since the spans were last set, so that a highlighter can leave the rest alone.
+    // Everything else has been moved along with the edits.
+    const Optional<TextRange>& changed_range() const { return m_changed_range; }
 
     bool set_text(const StringView&);
 
@@ -134,8 +142,16 @@ protected:
     explicit TextDocument(Client* client);
 
 private:
+    TextPosition insert_code_point_at(const TextPosition&, u32);
+    void move_spans_after_insertion(const TextPosition& start, const TextPosition& end);
+    void move_spans_after_removal(const TextRange&);
+
     NonnullOwnPtrVector<TextDocumentLine> m_lines;
     Vector<TextDocumentSpan> m_spans;
+    Optional<TextRange> m_changed_range;
+
+    // The text the document was last set to, which lines that haven't been decoded yet still point into.
+    ByteBuffer m_loaded_text;
 
     HashTable<Client*> m_clients;
     bool m_client_notifications_enabled { true };
@@ -158,8 +174,19 @@ public:
     String to_utf8() const;
 
     Utf32View view() const { return { code_points(), length() }; }
-    const u32* code_points() const { return m_text.data(); }
-    size_t length() const { return m_text.size(); }
+    const u32* code_points() const
+    {
+        decode();
+        return m_text.data();
+    }
+    size_t length() const { return is_decoded() ? m_text.size() : m_undecoded_length; }
+
+    // Lines are only decoded from the text the document was set to once something needs their code points,
+    // so a big document doesn't take up four bytes per code point for all the lines that nobody looked at.
+    bool is_decoded() const { return m_undecoded_text.is_null(); }
+    StringView undecoded_text() const { return m_undecoded_text; }
+    void set_undecoded_text(TextDocument&, const StringView& valid_utf8, size_t length);
+
     bool set_text(TextDocument&, const StringView&);
     void set_text(TextDocument&, Vector<u32>);
     void append(TextDocument&, u32);
@@ -179,8 +206,12 @@ public:
     size_t leading_spaces() const;
 
 private:
+    void decode() const;
+
     // NOTE: This vector is null terminated.
-    Vector<u32> m_text;
+    mutable Vector<u32> m_text;
+    mutable StringView m_undecoded_text;
+    size_t m_undecoded_length { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
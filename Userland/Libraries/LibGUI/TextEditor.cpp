@@ -10,11 +10,13 @@
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <AK/TemporaryChange.h>
+#include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
 #include <LibGUI/Action.h>
 #include <LibGUI/AutocompleteProvider.h>
 #include <LibGUI/Clipboard.h>
 #include <LibGUI/EditingEngine.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/InputBox.h>
 #include <LibGUI/Menu.h>
 #include <LibGUI/Painter.h>
@@ -87,7 +89,7 @@ void TextEditor::create_actions()
     m_delete_action = CommonActions::make_delete_action([&](auto&) { do_delete(); }, this);
     if (is_multi_line()) {
         m_go_to_line_action = Action::create(
-            "Go to line...", { Mod_Ctrl, Key_L }, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/go-forward.png"), [this](auto&) {
+            "Go to line...", { Mod_Ctrl, Key_L }, IconCache::load_bitmap("/res/icons/16x16/go-forward.png"), [this](auto&) {
                 String value;
                 if (InputBox::show(window(), value, "Line:", "Go to line") == InputBox::ExecOK) {
                     auto line_target = value.to_uint();
@@ -1560,6 +1562,9 @@ void TextEditor::resize_event(ResizeEvent& event)
 void TextEditor::theme_change_event(ThemeChangeEvent& event)
 {
     AbstractScrollableWidget::theme_change_event(event);
+    // None of the old spans have the right colors anymore.
+    if (m_highlighter)
+        document().set_spans({});
     m_needs_rehighlight = true;
 }
 
@@ -1632,14 +1637,25 @@ void TextEditor::recompute_visual_lines(size_t line_index)
 
     int available_width = visible_text_rect_in_inner_coordinates().width();
 
+    // Lines that haven't been decoded yet are measured as they are, there's no need to decode all of them just yet.
+    auto for_each_code_point = [&](auto callback) {
+        size_t i = 0;
+        if (line.is_decoded()) {
+            for (auto code_point : line.view())
+                callback(i++, code_point);
+        } else {
+            for (auto code_point : Utf8View(line.undecoded_text()))
+                callback(i++, code_point);
+        }
+    };
+
     if (is_wrapping_enabled()) {
         int line_width_so_far = 0;
 
         size_t last_whitespace_index = 0;
         size_t line_width_since_last_whitespace = 0;
         auto glyph_spacing = font().glyph_spacing();
-        for (size_t i = 0; i < line.length(); ++i) {
-            auto code_point = line.code_points()[i];
+        for_each_code_point([&](size_t i, u32 code_point) {
             if (is_ascii_space(code_point)) {
                 last_whitespace_index = i;
                 line_width_since_last_whitespace = 0;
@@ -1657,18 +1673,20 @@ void TextEditor::recompute_visual_lines(size_t line_index)
                     visual_data.visual_line_breaks.append(i);
                     line_width_so_far = glyph_width + glyph_spacing;
                 }
-                continue;
+                return;
             }
             line_width_so_far += glyph_width + glyph_spacing;
-        }
+        });
     }
 
     visual_data.visual_line_breaks.append(line.length());
 
     if (is_wrapping_enabled())
         visual_data.visual_rect = { m_horizontal_content_padding, 0, available_width, static_cast<int>(visual_data.visual_line_breaks.size()) * line_height() };
-    else
+    else if (line.is_decoded())
         visual_data.visual_rect = { m_horizontal_content_padding, 0, text_width_for_font(line.view(), font()), line_height() };
+    else
+        visual_data.visual_rect = { m_horizontal_content_padding, 0, text_width_for_font(Utf8View(line.undecoded_text()), font()), line_height() };
 }
 
 template<typename Callback>
@@ -1842,11 +1860,12 @@ void TextEditor::set_syntax_highlighter(OwnPtr<Syntax::Highlighter> highlighter)
     if (m_highlighter)
         m_highlighter->detach();
     m_highlighter = move(highlighter);
+    // Whatever the old highlighter left behind means nothing to the new one.
+    document().set_spans({});
     if (m_highlighter) {
         m_highlighter->attach(*this);
         m_needs_rehighlight = true;
-    } else
-        document().set_spans({});
+    }
 }
 
 AutocompleteProvider const* TextEditor::autocomplete_provider() const
@@ -254,6 +254,7 @@ private:
     virtual String highlighter_did_request_text() const final { return text(); }
     virtual GUI::TextDocument& highlighter_did_request_document() final { return document(); }
     virtual GUI::TextPosition highlighter_did_request_cursor() const final { return m_cursor; }
+    virtual Optional<GUI::TextRange> highlighter_did_request_changed_range() const final { return document().changed_range(); }
 
     // ^Clipboard::ClipboardClient
     virtual void clipboard_content_did_change(String const& mime_type) override;
@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <LibGUI/HeaderView.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/Model.h>
 #include <LibGUI/Painter.h>
 #include <LibGUI/TreeView.h>
@@ -38,8 +39,8 @@ TreeView::TreeView()
     set_background_role(ColorRole::Base);
     set_foreground_role(ColorRole::BaseText);
     set_column_headers_visible(false);
-    m_expand_bitmap = Gfx::Bitmap::try_load_from_file("/res/icons/serenity/treeview-expand.png");
-    m_collapse_bitmap = Gfx::Bitmap::try_load_from_file("/res/icons/serenity/treeview-collapse.png");
+    m_expand_bitmap = IconCache::load_bitmap("/res/icons/serenity/treeview-expand.png");
+    m_collapse_bitmap = IconCache::load_bitmap("/res/icons/serenity/treeview-collapse.png");
 }
 
 TreeView::~TreeView()
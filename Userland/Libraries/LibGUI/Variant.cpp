@@ -258,6 +258,11 @@ Variant::Variant(const Variant& other)
     copy_from(other);
 }
 
+Variant::Variant(Variant&& other)
+{
+    move_from(move(other));
+}
+
 void Variant::move_from(Variant&& other)
 {
     m_type = other.m_type;
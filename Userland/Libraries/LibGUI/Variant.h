@@ -39,7 +39,7 @@ public:
     Variant(const Variant&);
     Variant& operator=(const Variant&);
 
-    Variant(Variant&&) = delete;
+    Variant(Variant&&);
     Variant& operator=(Variant&&);
 
     void clear();
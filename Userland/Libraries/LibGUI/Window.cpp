@@ -23,6 +23,7 @@
 #include <LibGUI/WindowManagerServerConnection.h>
 #include <LibGUI/WindowServerConnection.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/DisjointRectSet.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,9 +49,14 @@ public:
 
     i32 serial() const { return m_serial; }
 
+    // What has been painted into the other backing store since this one was last shown, and is therefore
+    // out of date here. It gets copied over just before this store is painted into again.
+    Gfx::DisjointRectSet& stale_rects() { return m_stale_rects; }
+
 private:
     NonnullRefPtr<Gfx::Bitmap> m_bitmap;
     const i32 m_serial;
+    Gfx::DisjointRectSet m_stale_rects;
 };
 
 static NeverDestroyed<HashTable<Window*>> all_windows;
@@ -428,6 +434,10 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
             created_new_backing_store = true;
         }
     }
+    if (m_double_buffering_enabled && !m_front_store && !m_back_store->stale_rects().is_empty()) {
+        // There is nothing left to catch up from, so everything has to be painted again.
+        created_new_backing_store = true;
+    }
 
     auto rect = rects.first();
     if (rect.is_empty() || created_new_backing_store) {
@@ -435,6 +445,9 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
         rects.append({ {}, event.window_size() });
     }
 
+    if (m_double_buffering_enabled)
+        bring_back_store_up_to_date(rects);
+
     for (auto& rect : rects) {
         PaintEvent paint_event(rect);
         m_main_widget->dispatch_event(paint_event, this);
@@ -830,19 +843,44 @@ void Window::flip(const Vector<Gfx::IntRect, 32>& dirty_rects)
     if (!m_back_store || m_back_store->size() != m_front_store->size()) {
         m_back_store = create_backing_store(m_front_store->size());
         VERIFY(m_back_store);
-        memcpy(m_back_store->bitmap().scanline(0), m_front_store->bitmap().scanline(0), m_front_store->bitmap().size_in_bytes());
+        m_back_store->stale_rects() = Gfx::DisjointRectSet(m_back_store->bitmap().rect());
         m_back_store->bitmap().set_volatile();
         return;
     }
 
-    // Copy whatever was painted from the front to the back.
-    Painter painter(m_back_store->bitmap());
-    for (auto& dirty_rect : dirty_rects)
-        painter.blit(dirty_rect.location(), m_front_store->bitmap(), dirty_rect, 1.0f, false);
-
+    // The back store only catches up with what was painted once it is about to be painted into itself.
+    // Whatever gets painted over again by then doesn't need copying at all.
+    m_back_store->stale_rects().add_many(dirty_rects);
     m_back_store->bitmap().set_volatile();
 }
 
+void Window::bring_back_store_up_to_date(const Vector<Gfx::IntRect, 32>& rects_to_paint)
+{
+    auto& stale_rects = m_back_store->stale_rects();
+    if (stale_rects.is_empty())
+        return;
+    if (!m_front_store || m_front_store->size() != m_back_store->size()) {
+        // Only a full repaint gets us here, which makes the whole store current anyway.
+        stale_rects.clear();
+        return;
+    }
+
+    // Painting into a window with an alpha channel may blend with what is already there, so that has to be
+    // current everywhere. Opaque windows paint over their rects completely.
+    auto rects_to_copy = [&] {
+        if (m_has_alpha_channel)
+            return stale_rects.clone();
+        Gfx::DisjointRectSet painted_rects;
+        painted_rects.add_many(rects_to_paint);
+        return stale_rects.shatter(painted_rects);
+    }();
+
+    Painter painter(m_back_store->bitmap());
+    for (auto& rect : rects_to_copy.rects())
+        painter.blit(rect.location(), m_front_store->bitmap(), rect, 1.0f, false);
+    stale_rects.clear();
+}
+
 OwnPtr<WindowBackingStore> Window::create_backing_store(const Gfx::IntSize& size)
 {
     auto format = m_has_alpha_channel ? Gfx::BitmapFormat::BGRA8888 : Gfx::BitmapFormat::BGRx8888;
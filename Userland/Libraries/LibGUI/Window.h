@@ -235,6 +235,7 @@ private:
     OwnPtr<WindowBackingStore> create_backing_store(const Gfx::IntSize&);
     void set_current_backing_store(WindowBackingStore&, bool flush_immediately = false);
     void flip(const Vector<Gfx::IntRect, 32>& dirty_rects);
+    void bring_back_store_up_to_date(const Vector<Gfx::IntRect, 32>& rects_to_paint);
     void force_update();
 
     WeakPtr<Widget> m_previously_focused_widget;
@@ -45,6 +45,11 @@ void GeminiJob::start()
         if (on_certificate_requested)
             on_certificate_requested(*this);
     };
+    m_socket->on_connection_failed = [this] {
+        deferred_invoke([this](auto&) {
+            return did_fail(Core::NetworkJob::Error::ConnectionFailed);
+        });
+    };
     bool success = ((TLS::TLSv12&)*m_socket).connect(m_request.url().host(), m_request.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
@@ -475,4 +475,7 @@ namespace IPC {
 bool encode(Encoder&, const Gfx::Color&);
 bool decode(Decoder&, Gfx::Color&);
 
+template<>
+inline constexpr bool HasFixedLayout<Gfx::Color> = true;
+
 }
@@ -4,53 +4,212 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <LibGfx/DisjointRectSet.h>
 
 namespace Gfx {
 
-bool DisjointRectSet::add_no_shatter(const IntRect& new_rect)
-{
-    if (new_rect.is_empty())
-        return false;
-    for (auto& rect : m_rects) {
-        if (rect.contains(new_rect))
-            return false;
+namespace {
+
+// A horizontal stretch of a band, from left up to but not including right.
+struct XSpan {
+    int left;
+    int right;
+};
+
+struct Band {
+    int top;
+    int bottom;
+    Span<const IntRect> rects;
+};
+
+// Appends bands to a set under construction, merging each one into the band above when they line up.
+class BandBuilder {
+public:
+    explicit BandBuilder(Vector<IntRect, 32>& rects)
+        : m_rects(rects)
+    {
     }
 
-    m_rects.append(new_rect);
-    return true;
-}
-
-void DisjointRectSet::shatter()
-{
-    Vector<IntRect, 32> output;
-    output.ensure_capacity(m_rects.size());
-    bool pass_had_intersections = false;
-    do {
-        pass_had_intersections = false;
-        output.clear_with_capacity();
-        for (size_t i = 0; i < m_rects.size(); ++i) {
-            auto& r1 = m_rects[i];
-            for (size_t j = 0; j < m_rects.size(); ++j) {
-                if (i == j)
-                    continue;
-                auto& r2 = m_rects[j];
-                if (!r1.intersects(r2))
-                    continue;
-                pass_had_intersections = true;
-                auto pieces = r1.shatter(r2);
-                for (auto& piece : pieces)
-                    output.append(piece);
-                m_rects.remove(i);
-                for (; i < m_rects.size(); ++i)
-                    output.append(m_rects[i]);
-                goto next_pass;
+    void append(int top, int bottom, const Vector<XSpan, 32>& spans)
+    {
+        if (spans.is_empty() || top >= bottom)
+            return;
+
+        if (m_has_previous_band && m_previous_band_bottom == top && m_rects.size() - m_previous_band_start == spans.size()) {
+            bool same_spans = true;
+            for (size_t i = 0; i < spans.size(); ++i) {
+                auto& rect = m_rects[m_previous_band_start + i];
+                if (rect.x() != spans[i].left || rect.x() + rect.width() != spans[i].right) {
+                    same_spans = false;
+                    break;
+                }
+            }
+            if (same_spans) {
+                for (size_t i = m_previous_band_start; i < m_rects.size(); ++i)
+                    m_rects[i].set_height(bottom - m_rects[i].y());
+                m_previous_band_bottom = bottom;
+                return;
             }
-            output.append(r1);
         }
-    next_pass:
-        swap(output, m_rects);
-    } while (pass_had_intersections);
+
+        m_has_previous_band = true;
+        m_previous_band_start = m_rects.size();
+        m_previous_band_bottom = bottom;
+        for (auto& span : spans)
+            m_rects.append({ span.left, top, span.right - span.left, bottom - top });
+    }
+
+private:
+    Vector<IntRect, 32>& m_rects;
+    bool m_has_previous_band { false };
+    size_t m_previous_band_start { 0 };
+    int m_previous_band_bottom { 0 };
+};
+
+}
+
+static Band band_starting_at(const Vector<IntRect, 32>& rects, size_t index)
+{
+    if (index >= rects.size())
+        return { NumericLimits<int>::max(), NumericLimits<int>::max(), {} };
+    int top = rects[index].y();
+    size_t end = index + 1;
+    while (end < rects.size() && rects[end].y() == top)
+        ++end;
+    return { top, top + rects[index].height(), rects.span().slice(index, end - index) };
+}
+
+// Walks the edges of both rows of rects from left to right, and keeps the stretches where is_inside() holds.
+template<typename IsInside>
+static void combine_spans(Span<const IntRect> a, Span<const IntRect> b, IsInside is_inside, Vector<XSpan, 32>& spans)
+{
+    spans.clear_with_capacity();
+    auto edge = [](Span<const IntRect> rects, size_t index) {
+        if (index >= rects.size() * 2)
+            return NumericLimits<int>::max();
+        auto& rect = rects[index / 2];
+        return index % 2 == 0 ? rect.x() : rect.x() + rect.width();
+    };
+
+    size_t a_edge = 0;
+    size_t b_edge = 0;
+    bool was_inside = false;
+    int span_left = 0;
+    while (a_edge < a.size() * 2 || b_edge < b.size() * 2) {
+        int x = min(edge(a, a_edge), edge(b, b_edge));
+        while (edge(a, a_edge) == x)
+            ++a_edge;
+        while (edge(b, b_edge) == x)
+            ++b_edge;
+        // Odd edge indices mean we've passed a left edge but not its right edge yet.
+        bool inside = is_inside(a_edge % 2 == 1, b_edge % 2 == 1);
+        if (inside && !was_inside)
+            span_left = x;
+        else if (!inside && was_inside)
+            spans.append({ span_left, x });
+        was_inside = inside;
+    }
+}
+
+DisjointRectSet DisjointRectSet::combine(const DisjointRectSet& a, const DisjointRectSet& b, Operation operation)
+{
+    DisjointRectSet result;
+    BandBuilder builder(result.m_rects);
+    Vector<XSpan, 32> spans;
+    auto is_inside = [operation](bool inside_a, bool inside_b) {
+        switch (operation) {
+        case Operation::Union:
+            return inside_a || inside_b;
+        case Operation::Intersection:
+            return inside_a && inside_b;
+        case Operation::Difference:
+            return inside_a && !inside_b;
+        }
+        VERIFY_NOT_REACHED();
+    };
+
+    size_t a_index = 0;
+    size_t b_index = 0;
+    int y = NumericLimits<int>::min();
+    while (a_index < a.m_rects.size() || b_index < b.m_rects.size()) {
+        if (operation == Operation::Intersection && (a_index >= a.m_rects.size() || b_index >= b.m_rects.size()))
+            break;
+        if (operation == Operation::Difference && a_index >= a.m_rects.size())
+            break;
+
+        auto a_band = band_starting_at(a.m_rects, a_index);
+        auto b_band = band_starting_at(b.m_rects, b_index);
+        int a_top = max(a_band.top, y);
+        int b_top = max(b_band.top, y);
+
+        // The stretch of rows up to where either set's rows change next.
+        int top = min(a_top, b_top);
+        int bottom = min(a_top == top ? a_band.bottom : a_top, b_top == top ? b_band.bottom : b_top);
+        combine_spans(a_top == top ? a_band.rects : Span<const IntRect> {}, b_top == top ? b_band.rects : Span<const IntRect> {}, is_inside, spans);
+        builder.append(top, bottom, spans);
+
+        y = bottom;
+        if (y >= a_band.bottom)
+            a_index += a_band.rects.size();
+        if (y >= b_band.bottom)
+            b_index += b_band.rects.size();
+    }
+    return result;
+}
+
+DisjointRectSet DisjointRectSet::from_overlapping_rects(Span<const IntRect> rects)
+{
+    if (rects.is_empty())
+        return {};
+    if (rects.size() == 1)
+        return DisjointRectSet(rects[0]);
+    // Halving keeps the sets that get combined about the same size, rather than combining every rect
+    // with an ever growing set.
+    auto half = rects.size() / 2;
+    return combine(from_overlapping_rects(rects.trim(half)), from_overlapping_rects(rects.slice(half)), Operation::Union);
+}
+
+size_t DisjointRectSet::first_rect_reaching_below(int y) const
+{
+    // Every rect of a band ends where the band does, so the bottoms never decrease.
+    size_t low = 0;
+    size_t high = m_rects.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        auto& rect = m_rects[middle];
+        if (rect.y() + rect.height() > y)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+void DisjointRectSet::add(const IntRect& rect)
+{
+    if (rect.is_empty())
+        return;
+    if (m_rects.is_empty()) {
+        m_rects.append(rect);
+        return;
+    }
+    for (size_t i = first_rect_reaching_below(rect.y()); i < m_rects.size() && m_rects[i].y() <= rect.y(); ++i) {
+        if (m_rects[i].contains(rect))
+            return;
+    }
+    *this = combine(*this, DisjointRectSet(rect), Operation::Union);
+}
+
+void DisjointRectSet::add(const DisjointRectSet& rect_set)
+{
+    if (this == &rect_set || rect_set.is_empty())
+        return;
+    if (m_rects.is_empty()) {
+        m_rects = rect_set.m_rects;
+        return;
+    }
+    *this = combine(*this, rect_set, Operation::Union);
 }
 
 void DisjointRectSet::move_by(int dx, int dy)
@@ -63,25 +222,12 @@ bool DisjointRectSet::contains(const IntRect& rect) const
 {
     if (is_empty() || rect.is_empty())
         return false;
-
-    // TODO: This could use some optimization
-    DisjointRectSet remainder(rect);
-    for (auto& r : m_rects) {
-        auto shards = remainder.shatter(r);
-        if (shards.is_empty())
-            return true;
-        remainder = move(shards);
-    }
-    return false;
+    return DisjointRectSet(rect).shatter(*this).is_empty();
 }
 
 bool DisjointRectSet::intersects(const IntRect& rect) const
 {
-    for (auto& r : m_rects) {
-        if (r.intersects(rect))
-            return true;
-    }
-    return false;
+    return for_each_intersected(rect, [](auto&) { return IterationDecision::Break; }) == IterationDecision::Break;
 }
 
 bool DisjointRectSet::intersects(const DisjointRectSet& rects) const
@@ -89,26 +235,20 @@ bool DisjointRectSet::intersects(const DisjointRectSet& rects) const
     if (this == &rects)
         return true;
 
-    for (auto& r : m_rects) {
-        for (auto& r2 : rects.m_rects) {
-            if (r.intersects(r2))
-                return true;
-        }
+    auto& fewer = size() <= rects.size() ? *this : rects;
+    auto& more = size() <= rects.size() ? rects : *this;
+    for (auto& r : fewer.m_rects) {
+        if (more.intersects(r))
+            return true;
     }
     return false;
 }
 
 DisjointRectSet DisjointRectSet::intersected(const IntRect& rect) const
 {
-    DisjointRectSet intersected_rects;
-    intersected_rects.m_rects.ensure_capacity(m_rects.capacity());
-    for (auto& r : m_rects) {
-        auto intersected_rect = r.intersected(rect);
-        if (!intersected_rect.is_empty())
-            intersected_rects.m_rects.append(intersected_rect);
-    }
-    // Since there should be no overlaps, we don't need to call shatter()
-    return intersected_rects;
+    if (is_empty() || rect.is_empty())
+        return {};
+    return combine(*this, DisjointRectSet(rect), Operation::Intersection);
 }
 
 DisjointRectSet DisjointRectSet::intersected(const DisjointRectSet& rects) const
@@ -117,52 +257,61 @@ DisjointRectSet DisjointRectSet::intersected(const DisjointRectSet& rects) const
         return clone();
     if (is_empty() || rects.is_empty())
         return {};
-
-    DisjointRectSet intersected_rects;
-    intersected_rects.m_rects.ensure_capacity(m_rects.capacity());
-    for (auto& r : m_rects) {
-        for (auto& r2 : rects.m_rects) {
-            auto intersected_rect = r.intersected(r2);
-            if (!intersected_rect.is_empty())
-                intersected_rects.m_rects.append(intersected_rect);
-        }
-    }
-    // Since there should be no overlaps, we don't need to call shatter()
-    return intersected_rects;
+    return combine(*this, rects, Operation::Intersection);
 }
 
 DisjointRectSet DisjointRectSet::shatter(const IntRect& hammer) const
 {
-    if (hammer.is_empty())
+    if (!intersects(hammer))
         return clone();
-
-    DisjointRectSet shards;
-    for (auto& rect : m_rects) {
-        for (auto& shard : rect.shatter(hammer))
-            shards.add_no_shatter(shard);
-    }
-    // Since there should be no overlaps, we don't need to call shatter()
-    return shards;
+    return combine(*this, DisjointRectSet(hammer), Operation::Difference);
 }
 
 DisjointRectSet DisjointRectSet::shatter(const DisjointRectSet& hammer) const
 {
     if (this == &hammer)
         return {};
-    if (hammer.is_empty() || !intersects(hammer))
+    if (hammer.is_empty() || is_empty())
         return clone();
+    return combine(*this, hammer, Operation::Difference);
+}
 
-    // TODO: This could use some optimization
-    DisjointRectSet shards = shatter(hammer.m_rects[0]);
-    auto rects_count = hammer.m_rects.size();
-    for (size_t i = 1; i < rects_count && !shards.is_empty(); i++) {
-        if (hammer.m_rects[i].intersects(shards.m_rects)) {
-            auto shattered = shards.shatter(hammer.m_rects[i]);
-            shards = move(shattered);
-        }
+IntRect DisjointRectSet::bounding_rect() const
+{
+    if (is_empty())
+        return {};
+    int left = NumericLimits<int>::max();
+    int right = NumericLimits<int>::min();
+    for (auto& rect : m_rects) {
+        left = min(left, rect.x());
+        right = max(right, rect.x() + rect.width());
     }
-    // Since there should be no overlaps, we don't need to call shatter()
-    return shards;
+    int top = m_rects.first().y();
+    auto& last = m_rects.last();
+    return { left, top, right - left, last.y() + last.height() - top };
+}
+
+void DisjointRectSet::limit_fragmentation(size_t max_rect_count)
+{
+    if (m_rects.size() <= max_rect_count)
+        return;
+
+    DisjointRectSet merged;
+    BandBuilder builder(merged.m_rects);
+    Vector<XSpan, 32> spans;
+    for (size_t index = 0; index < m_rects.size();) {
+        auto band = band_starting_at(m_rects, index);
+        spans.clear_with_capacity();
+        auto& last = band.rects[band.rects.size() - 1];
+        spans.append({ band.rects[0].x(), last.x() + last.width() });
+        builder.append(band.top, band.bottom, spans);
+        index += band.rects.size();
+    }
+
+    if (merged.size() > max_rect_count)
+        *this = DisjointRectSet(bounding_rect());
+    else
+        *this = move(merged);
 }
 
 }
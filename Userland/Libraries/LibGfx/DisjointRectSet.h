@@ -6,12 +6,18 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <AK/Vector.h>
 #include <LibGfx/Point.h>
 #include <LibGfx/Rect.h>
 
 namespace Gfx {
 
+// The rects are kept in y-x banded form, like X11 and pixman regions do: the area is cut into horizontal bands
+// sorted from top to bottom, every rect of a band spans the whole band, the rects of a band are sorted from
+// left to right without touching, and bands that sit on top of each other with the same rects are merged.
+// That makes the representation of an area unique, and lets union, intersection and subtraction walk both
+// sets in order instead of testing every rect against every other rect.
 class DisjointRectSet {
 public:
     DisjointRectSet(const DisjointRectSet&) = delete;
@@ -22,7 +28,8 @@ public:
 
     DisjointRectSet(const IntRect& rect)
     {
-        m_rects.append(rect);
+        if (!rect.is_empty())
+            m_rects.append(rect);
     }
 
     DisjointRectSet(DisjointRectSet&&) = default;
@@ -41,35 +48,23 @@ public:
         move_by(delta.x(), delta.y());
     }
 
-    void add(const IntRect& rect)
-    {
-        if (add_no_shatter(rect) && m_rects.size() > 1)
-            shatter();
-    }
+    void add(const IntRect&);
 
     template<typename Container>
     void add_many(const Container& rects)
     {
-        bool added = false;
+        Vector<IntRect, 32> new_rects;
         for (const auto& rect : rects) {
-            if (add_no_shatter(rect))
-                added = true;
+            if (!rect.is_empty())
+                new_rects.append(rect);
         }
-        if (added && m_rects.size() > 1)
-            shatter();
-    }
-
-    void add(const DisjointRectSet& rect_set)
-    {
-        if (this == &rect_set)
+        if (new_rects.is_empty())
             return;
-        if (m_rects.is_empty()) {
-            m_rects = rect_set.m_rects;
-        } else {
-            add_many(rect_set.rects());
-        }
+        add(from_overlapping_rects(new_rects.span()));
     }
 
+    void add(const DisjointRectSet& rect_set);
+
     DisjointRectSet shatter(const IntRect&) const;
     DisjointRectSet shatter(const DisjointRectSet& hammer) const;
 
@@ -79,12 +74,23 @@ public:
     DisjointRectSet intersected(const IntRect&) const;
     DisjointRectSet intersected(const DisjointRectSet&) const;
 
+    // Once there are more than max_rect_count rects, every band is merged into its bounding rect, and if that
+    // isn't enough either, the whole set becomes its bounding rect. This can only make the set cover more,
+    // so it suits areas where covering a bit too much is fine, like what needs to be repainted.
+    void limit_fragmentation(size_t max_rect_count);
+
+    IntRect bounding_rect() const;
+
     template<typename Function>
     IterationDecision for_each_intersected(const IntRect& rect, Function f) const
     {
         if (is_empty() || rect.is_empty())
             return IterationDecision::Continue;
-        for (auto& r : m_rects) {
+        // Bands are sorted, so only the ones from the first that reaches down into the rect need looking at.
+        for (size_t i = first_rect_reaching_below(rect.y()); i < m_rects.size(); ++i) {
+            auto& r = m_rects[i];
+            if (r.y() >= rect.y() + rect.height())
+                break;
             auto intersected_rect = r.intersected(rect);
             if (intersected_rect.is_empty())
                 continue;
@@ -106,17 +112,13 @@ public:
                 if (decision != IterationDecision::Continue)
                     return decision;
             }
-        } else {
-            for (auto& r : m_rects) {
-                for (auto& r2 : rects.m_rects) {
-                    auto intersected_rect = r.intersected(r2);
-                    if (intersected_rect.is_empty())
-                        continue;
-                    IterationDecision decision = f(intersected_rect);
-                    if (decision != IterationDecision::Continue)
-                        return decision;
-                }
-            }
+            return IterationDecision::Continue;
+        }
+        auto intersected_rects = intersected(rects);
+        for (auto& r : intersected_rects.m_rects) {
+            IterationDecision decision = f(r);
+            if (decision != IterationDecision::Continue)
+                return decision;
         }
         return IterationDecision::Continue;
     }
@@ -141,8 +143,17 @@ public:
     }
 
 private:
-    bool add_no_shatter(const IntRect&);
-    void shatter();
+    enum class Operation {
+        Union,
+        Intersection,
+        Difference,
+    };
+
+    static DisjointRectSet combine(const DisjointRectSet&, const DisjointRectSet&, Operation);
+    static DisjointRectSet from_overlapping_rects(Span<const IntRect>);
+
+    // The index of the first rect whose band reaches further down than y.
+    size_t first_rect_reaching_below(int y) const;
 
     Vector<IntRect, 32> m_rects;
 };
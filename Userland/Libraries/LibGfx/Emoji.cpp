@@ -6,6 +6,7 @@
 
 #include <AK/HashMap.h>
 #include <AK/String.h>
+#include <LibCore/MemoryPressure.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Emoji.h>
 
@@ -13,12 +14,26 @@ namespace Gfx {
 
 static HashMap<u32, RefPtr<Gfx::Bitmap>> s_emojis;
 
+static void clear_emojis_under_memory_pressure()
+{
+    static bool s_registered = false;
+    if (s_registered)
+        return;
+    s_registered = true;
+    // Nobody holds on to an emoji for longer than it takes to paint it, and they can always be loaded again.
+    Core::MemoryPressure::add_handler([](auto level) {
+        if (level != MemoryPressureLevel::None)
+            s_emojis.clear();
+    });
+}
+
 const Bitmap* Emoji::emoji_for_code_point(u32 code_point)
 {
     auto it = s_emojis.find(code_point);
     if (it != s_emojis.end())
         return (*it).value.ptr();
 
+    clear_emojis_under_memory_pressure();
     auto bitmap = Bitmap::try_load_from_file(String::formatted("/res/emoji/U+{:X}.png", code_point));
     if (!bitmap) {
         s_emojis.set(code_point, nullptr);
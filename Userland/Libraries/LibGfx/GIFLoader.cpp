@@ -738,7 +738,9 @@ ImageFrameDescriptor GIFImageDecoderPlugin::frame(size_t i)
     }
 
     ImageFrameDescriptor frame {};
-    frame.image = m_context->frame_buffer->clone();
+    // Every frame has to be copied out of the frame buffer anyway, so copy it straight into shared memory that
+    // ImageDecoder can hand to its client without copying it yet again.
+    frame.image = m_context->frame_buffer->to_bitmap_backed_by_anonymous_buffer();
     frame.duration = m_context->images.at(i).duration * 10;
 
     if (frame.duration <= 10) {
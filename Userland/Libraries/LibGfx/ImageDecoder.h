@@ -41,6 +41,17 @@ public:
     virtual size_t frame_count() = 0;
     virtual ImageFrameDescriptor frame(size_t i) = 0;
 
+    // Tells the decoder that frames will be shown at no more than this size, so formats that can decode at a
+    // reduced size cheaply may do so. Frames still come out at least this large (unless the image itself is
+    // smaller), and the aspect ratio is kept, so callers scale whatever they get. size() keeps reporting the
+    // full size. This only has an effect before the first frame is decoded.
+    virtual void set_target_size(IntSize) { }
+
+    // For showing an image while it's still loading: decodes as much of the first frame as the data the decoder
+    // was created with covers, leaving the rest of the frame blank. Formats that can't show anything before all
+    // data is in return an empty frame.
+    virtual ImageFrameDescriptor partial_frame() { return {}; }
+
 protected:
     virtual RefPtr<Gfx::Bitmap> bitmap() = 0;
 
@@ -62,6 +73,8 @@ public:
     size_t loop_count() const { return m_plugin->loop_count(); }
     size_t frame_count() const { return m_plugin->frame_count(); }
     ImageFrameDescriptor frame(size_t i) const { return m_plugin->frame(i); }
+    void set_target_size(IntSize size) { m_plugin->set_target_size(size); }
+    ImageFrameDescriptor partial_frame() const { return m_plugin->partial_frame(); }
 
 private:
     explicit ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin>);
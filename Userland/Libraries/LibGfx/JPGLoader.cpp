@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Bitmap.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
@@ -12,6 +13,7 @@
 #include <AK/MappedFile.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
@@ -194,6 +196,11 @@ struct JPGLoadingContext {
     HuffmanStreamState huffman_stream;
     i32 previous_dc_values[3] = { 0 };
     MacroblockMeta mblock_meta;
+    IntSize target_size;
+    // Each block comes out as this many pixels across and down, which is less than 8 when decoding at a reduced size.
+    u8 scaled_block_size { 8 };
+    // When set, a stream that ends early decodes to a partial image instead of failing.
+    bool allow_truncated_data { false };
 };
 
 static void generate_huffman_codes(HuffmanTableSpec& table)
@@ -411,6 +418,8 @@ static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& con
             }
 
             if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
+                if (context.allow_truncated_data && context.huffman_stream.byte_offset >= context.huffman_stream.stream.size())
+                    return macroblocks;
                 if constexpr (JPG_DEBUG) {
                     dbgln("Failed to build Macroblock {}", i);
                     dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
@@ -862,7 +871,30 @@ static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macrobloc
     }
 }
 
-static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static AK::SIMD::f32x4 load_coefficients(const i32* coefficients)
+{
+    AK::SIMD::i32x4 values;
+    memcpy(&values, coefficients, sizeof(values));
+    return __builtin_convertvector(values, AK::SIMD::f32x4);
+}
+
+static void store_coefficients(i32* coefficients, AK::SIMD::f32x4 values)
+{
+    auto truncated = __builtin_convertvector(values, AK::SIMD::i32x4);
+    memcpy(coefficients, &truncated, sizeof(truncated));
+}
+
+static void transpose(i32* block_component)
+{
+    for (u32 i = 0; i < 8; ++i) {
+        for (u32 j = i + 1; j < 8; ++j)
+            swap(block_component[i * 8 + j], block_component[j * 8 + i]);
+    }
+}
+
+// Runs the one-dimensional IDCT down every column of the block, four columns at a time. The rows are done
+// by transposing the block around a second pass.
+static void inverse_dct_columns(i32* block_component)
 {
     static const float m0 = 2.0 * AK::cos(1.0 / 16.0 * 2.0 * AK::Pi<double>);
     static const float m1 = 2.0 * AK::cos(2.0 / 16.0 * 2.0 * AK::Pi<double>);
@@ -879,6 +911,116 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     static const float s6 = AK::cos(6.0 / 16.0 * AK::Pi<double>) / 2.0;
     static const float s7 = AK::cos(7.0 / 16.0 * AK::Pi<double>) / 2.0;
 
+    using AK::SIMD::f32x4;
+    for (u32 k = 0; k < 8; k += 4) {
+        const f32x4 g0 = load_coefficients(&block_component[0 * 8 + k]) * s0;
+        const f32x4 g1 = load_coefficients(&block_component[4 * 8 + k]) * s4;
+        const f32x4 g2 = load_coefficients(&block_component[2 * 8 + k]) * s2;
+        const f32x4 g3 = load_coefficients(&block_component[6 * 8 + k]) * s6;
+        const f32x4 g4 = load_coefficients(&block_component[5 * 8 + k]) * s5;
+        const f32x4 g5 = load_coefficients(&block_component[1 * 8 + k]) * s1;
+        const f32x4 g6 = load_coefficients(&block_component[7 * 8 + k]) * s7;
+        const f32x4 g7 = load_coefficients(&block_component[3 * 8 + k]) * s3;
+
+        const f32x4 f0 = g0;
+        const f32x4 f1 = g1;
+        const f32x4 f2 = g2;
+        const f32x4 f3 = g3;
+        const f32x4 f4 = g4 - g7;
+        const f32x4 f5 = g5 + g6;
+        const f32x4 f6 = g5 - g6;
+        const f32x4 f7 = g4 + g7;
+
+        const f32x4 e0 = f0;
+        const f32x4 e1 = f1;
+        const f32x4 e2 = f2 - f3;
+        const f32x4 e3 = f2 + f3;
+        const f32x4 e4 = f4;
+        const f32x4 e5 = f5 - f7;
+        const f32x4 e6 = f6;
+        const f32x4 e7 = f5 + f7;
+        const f32x4 e8 = f4 + f6;
+
+        const f32x4 d0 = e0;
+        const f32x4 d1 = e1;
+        const f32x4 d2 = e2 * m1;
+        const f32x4 d3 = e3;
+        const f32x4 d4 = e4 * m2;
+        const f32x4 d5 = e5 * m3;
+        const f32x4 d6 = e6 * m4;
+        const f32x4 d7 = e7;
+        const f32x4 d8 = e8 * m5;
+
+        const f32x4 c0 = d0 + d1;
+        const f32x4 c1 = d0 - d1;
+        const f32x4 c2 = d2 - d3;
+        const f32x4 c3 = d3;
+        const f32x4 c4 = d4 + d8;
+        const f32x4 c5 = d5 + d7;
+        const f32x4 c6 = d6 - d8;
+        const f32x4 c7 = d7;
+        const f32x4 c8 = c5 - c6;
+
+        const f32x4 b0 = c0 + c3;
+        const f32x4 b1 = c1 + c2;
+        const f32x4 b2 = c1 - c2;
+        const f32x4 b3 = c0 - c3;
+        const f32x4 b4 = c4 - c8;
+        const f32x4 b5 = c8;
+        const f32x4 b6 = c6 - c7;
+        const f32x4 b7 = c7;
+
+        store_coefficients(&block_component[0 * 8 + k], b0 + b7);
+        store_coefficients(&block_component[1 * 8 + k], b1 + b6);
+        store_coefficients(&block_component[2 * 8 + k], b2 + b5);
+        store_coefficients(&block_component[3 * 8 + k], b3 + b4);
+        store_coefficients(&block_component[4 * 8 + k], b3 - b4);
+        store_coefficients(&block_component[5 * 8 + k], b2 - b5);
+        store_coefficients(&block_component[6 * 8 + k], b1 - b6);
+        store_coefficients(&block_component[7 * 8 + k], b0 - b7);
+    }
+}
+
+// The IDCT for decoding at 1/2, 1/4 or 1/8 of the size: only the lowest block_size frequencies in either
+// direction are used, sampled at block_size points, which roughly averages the pixels each output pixel stands
+// for. The result ends up in the top left corner of the block.
+static void inverse_dct_scaled(i32* block_component, u8 block_size)
+{
+    // basis[log2(block_size)][m][u] for output sample m and frequency u.
+    static const auto basis = [] {
+        Array<Array<Array<float, 4>, 4>, 3> basis {};
+        for (u8 size_index = 0; size_index < 3; ++size_index) {
+            u8 size = 1 << size_index;
+            for (u8 m = 0; m < size; ++m) {
+                for (u8 u = 0; u < size; ++u) {
+                    double scale = u == 0 ? 1.0 / sqrt(8) : 0.5;
+                    basis[size_index][m][u] = scale * AK::cos((2 * m + 1) * u * AK::Pi<double> / (2 * size));
+                }
+            }
+        }
+        return basis;
+    }();
+    auto& table = basis[block_size == 1 ? 0 : (block_size == 2 ? 1 : 2)];
+
+    float columns[4][4] {};
+    for (u8 m = 0; m < block_size; ++m) {
+        for (u8 v = 0; v < block_size; ++v) {
+            for (u8 u = 0; u < block_size; ++u)
+                columns[m][v] += table[m][u] * block_component[u * 8 + v];
+        }
+    }
+    for (u8 m = 0; m < block_size; ++m) {
+        for (u8 n = 0; n < block_size; ++n) {
+            float value = 0;
+            for (u8 v = 0; v < block_size; ++v)
+                value += table[n][v] * columns[m][v];
+            block_component[m * 8 + n] = value;
+        }
+    }
+}
+
+static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u32 component_i = 0; component_i < context.component_count; component_i++) {
@@ -888,140 +1030,14 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            const float g0 = block_component[0 * 8 + k] * s0;
-                            const float g1 = block_component[4 * 8 + k] * s4;
-                            const float g2 = block_component[2 * 8 + k] * s2;
-                            const float g3 = block_component[6 * 8 + k] * s6;
-                            const float g4 = block_component[5 * 8 + k] * s5;
-                            const float g5 = block_component[1 * 8 + k] * s1;
-                            const float g6 = block_component[7 * 8 + k] * s7;
-                            const float g7 = block_component[3 * 8 + k] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            const float g0 = block_component[l * 8 + 0] * s0;
-                            const float g1 = block_component[l * 8 + 4] * s4;
-                            const float g2 = block_component[l * 8 + 2] * s2;
-                            const float g3 = block_component[l * 8 + 6] * s6;
-                            const float g4 = block_component[l * 8 + 5] * s5;
-                            const float g5 = block_component[l * 8 + 1] * s1;
-                            const float g6 = block_component[l * 8 + 7] * s7;
-                            const float g7 = block_component[l * 8 + 3] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
+                        if (context.scaled_block_size < 8) {
+                            inverse_dct_scaled(block_component, context.scaled_block_size);
+                            continue;
                         }
+                        inverse_dct_columns(block_component);
+                        transpose(block_component);
+                        inverse_dct_columns(block_component);
+                        transpose(block_component);
                     }
                 }
             }
@@ -1031,29 +1047,51 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
 
 static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
+    using AK::SIMD::f32x4;
+    using AK::SIMD::i32x4;
+
+    auto clamp_to_u8 = [](f32x4 value) {
+        auto truncated = __builtin_convertvector(value, i32x4);
+        truncated = truncated < 0 ? 0 : truncated;
+        return truncated > 255 ? 255 : truncated;
+    };
+
+    const u8 block_size = context.scaled_block_size;
+    const u8 lane_count = min<u8>(block_size, 4);
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
             const Macroblock& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
+            // Overflows are intentional. The chroma block is converted in place too, and walking everything
+            // backwards works because the chroma values a pixel needs never sit at a higher index than the pixel.
             for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
                 for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
                     u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
                     i32* y = macroblocks[mb_index].y;
                     i32* cb = macroblocks[mb_index].cb;
                     i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
+                    for (u8 i = block_size - 1; i < block_size; --i) {
+                        for (u8 j = block_size - lane_count; j < block_size; j -= lane_count) {
                             const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                            const u32 chroma_pxrow = (i / context.vsample_factor) + (block_size / context.vsample_factor) * vfactor_i;
+                            f32x4 luma {};
+                            f32x4 chroma_cb {};
+                            f32x4 chroma_cr {};
+                            for (u8 lane = 0; lane < lane_count; ++lane) {
+                                const u32 chroma_pxcol = ((j + lane) / context.hsample_factor) + (block_size / context.hsample_factor) * hfactor_i;
+                                const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
+                                luma[lane] = y[pixel + lane];
+                                chroma_cb[lane] = chroma.cb[chroma_pixel];
+                                chroma_cr[lane] = chroma.cr[chroma_pixel];
+                            }
+                            i32x4 r = clamp_to_u8(luma + 1.402f * chroma_cr + 128);
+                            i32x4 g = clamp_to_u8(luma - 0.344f * chroma_cb - 0.714f * chroma_cr + 128);
+                            i32x4 b = clamp_to_u8(luma + 1.772f * chroma_cb + 128);
+                            for (u8 lane = 0; lane < lane_count; ++lane) {
+                                y[pixel + lane] = r[lane];
+                                cb[pixel + lane] = g[lane];
+                                cr[pixel + lane] = b[lane];
+                            }
                         }
                     }
                 }
@@ -1062,22 +1100,44 @@ static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& m
     }
 }
 
+static u32 scaled_dimension(u32 dimension, u8 block_size)
+{
+    return (dimension * block_size + 7) / 8;
+}
+
+// Picks the smallest scale the IDCT can produce that still covers the target size.
+static u8 scaled_block_size_for_target_size(const JPGLoadingContext& context)
+{
+    if (context.target_size.is_empty())
+        return 8;
+    for (u8 block_size = 1; block_size < 8; block_size *= 2) {
+        if (scaled_dimension(context.frame.width, block_size) >= (u32)context.target_size.width()
+            && scaled_dimension(context.frame.height, block_size) >= (u32)context.target_size.height())
+            return block_size;
+    }
+    return 8;
+}
+
 static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
 {
-    context.bitmap = Bitmap::try_create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
+    const u8 block_size = context.scaled_block_size;
+    const u32 width = scaled_dimension(context.frame.width, block_size);
+    const u32 height = scaled_dimension(context.frame.height, block_size);
+    context.bitmap = Bitmap::try_create(BitmapFormat::BGRx8888, { width, height });
     if (!context.bitmap)
         return false;
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
+    for (u32 y = height - 1; y < height; y--) {
+        const u32 block_row = y / block_size;
+        const u32 pixel_row = y % block_size;
+        auto* scanline = context.bitmap->scanline(y);
+        for (u32 x = 0; x < width; x++) {
+            const u32 block_column = x / block_size;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
+            const u32 pixel_column = x % block_size;
             const u32 pixel_index = pixel_row * 8 + pixel_column;
             const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = color.value();
         }
     }
 
@@ -1163,6 +1223,8 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
         last_byte = current_byte;
         stream >> current_byte;
         if (stream.handle_any_error()) {
+            if (context.allow_truncated_data)
+                return true;
             dbgln_if(JPG_DEBUG, "{}: EOI not found!", stream.offset());
             return false;
         }
@@ -1213,6 +1275,7 @@ static bool decode_jpg(JPGLoadingContext& context)
     }
 
     auto macroblocks = result.release_value();
+    context.scaled_block_size = scaled_block_size_for_target_size(context);
     dequantize(context, macroblocks);
     inverse_dct(context, macroblocks);
     ycbcr_to_rgb(context, macroblocks);
@@ -1332,4 +1395,25 @@ ImageFrameDescriptor JPGImageDecoderPlugin::frame(size_t i)
     return { bitmap(), 0 };
 }
 
+void JPGImageDecoderPlugin::set_target_size(IntSize target_size)
+{
+    m_context->target_size = target_size;
+}
+
+ImageFrameDescriptor JPGImageDecoderPlugin::partial_frame()
+{
+    if (m_context->state == JPGLoadingContext::State::BitmapDecoded)
+        return { m_context->bitmap, 0 };
+
+    // Decoding what's there is a separate attempt, so that the full decode still reports truncated data as an error.
+    JPGLoadingContext context;
+    context.data = m_context->data;
+    context.data_size = m_context->data_size;
+    context.target_size = m_context->target_size;
+    context.allow_truncated_data = true;
+    if (!decode_jpg(context))
+        return {};
+    return { context.bitmap, 0 };
+}
+
 }
@@ -31,6 +31,8 @@ public:
     virtual size_t loop_count() override;
     virtual size_t frame_count() override;
     virtual ImageFrameDescriptor frame(size_t i) override;
+    virtual void set_target_size(IntSize) override;
+    virtual ImageFrameDescriptor partial_frame() override;
 
 private:
     OwnPtr<JPGLoadingContext> m_context;
@@ -8,6 +8,7 @@
 #include <AK/Endian.h>
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
+#include <AK/SIMD.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <fcntl.h>
@@ -104,6 +105,7 @@ struct PNGLoadingContext {
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
+    IntSize target_size;
 
     Checked<int> compute_row_size_for_width(int width)
     {
@@ -188,19 +190,6 @@ RefPtr<Gfx::Bitmap> load_png_from_memory(const u8* data, size_t length)
     return bitmap;
 }
 
-ALWAYS_INLINE static u8 paeth_predictor(int a, int b, int c)
-{
-    int p = a + b - c;
-    int pa = abs(p - a);
-    int pb = abs(p - b);
-    int pc = abs(p - c);
-    if (pa <= pb && pa <= pc)
-        return a;
-    if (pb <= pc)
-        return b;
-    return c;
-}
-
 union [[gnu::packed]] Pixel {
     RGBA32 rgba { 0 };
     u8 v[4];
@@ -213,85 +202,112 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(sizeof(Pixel) == 4);
 
+// The scanlines are unpacked as RGBA, while the bitmap wants BGRA.
+ALWAYS_INLINE static u32 swap_red_and_blue(u32 pixel)
+{
+    return (pixel & 0xff00ff00) | ((pixel & 0xff) << 16) | ((pixel >> 16) & 0xff);
+}
+
+ALWAYS_INLINE static AK::SIMD::u32x4 swap_red_and_blue(AK::SIMD::u32x4 pixels)
+{
+    return (pixels & 0xff00ff00) | ((pixels & 0xff) << 16) | ((pixels >> 16) & 0xff);
+}
+
+// Filters add the predictor to every channel separately. Without alpha, the alpha channel is left alone.
+template<bool has_alpha>
+ALWAYS_INLINE static u32 add_channels(u32 pixel, u32 predictor)
+{
+    if constexpr (!has_alpha)
+        predictor &= 0x00ffffff;
+    return ((pixel & 0x7f7f7f7f) + (predictor & 0x7f7f7f7f)) ^ ((pixel ^ predictor) & 0x80808080);
+}
+
+template<bool has_alpha>
+ALWAYS_INLINE static AK::SIMD::u32x4 add_channels(AK::SIMD::u32x4 pixels, AK::SIMD::u32x4 predictors)
+{
+    if constexpr (!has_alpha)
+        predictors &= 0x00ffffff;
+    return (AK::SIMD::u32x4)((AK::SIMD::u8x16)pixels + (AK::SIMD::u8x16)predictors);
+}
+
+// Rounds down the average of every channel on its own.
+ALWAYS_INLINE static u32 average_channels(u32 a, u32 b)
+{
+    return (a & b) + (((a ^ b) >> 1) & 0x7f7f7f7f);
+}
+
+ALWAYS_INLINE static u32 paeth_predictor(u32 a_pixel, u32 b_pixel, u32 c_pixel)
+{
+    using AK::SIMD::i16x4;
+    auto widen = [](u32 pixel) {
+        i16x4 channels { (i16)(pixel & 0xff), (i16)((pixel >> 8) & 0xff), (i16)((pixel >> 16) & 0xff), (i16)(pixel >> 24) };
+        return channels;
+    };
+    auto absolute = [](i16x4 value) -> i16x4 { return value < 0 ? -value : value; };
+
+    i16x4 a = widen(a_pixel);
+    i16x4 b = widen(b_pixel);
+    i16x4 c = widen(c_pixel);
+    i16x4 p = a + b - c;
+    i16x4 pa = absolute(p - a);
+    i16x4 pb = absolute(p - b);
+    i16x4 pc = absolute(p - c);
+    i16x4 predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+    return (u8)predictor[0] | ((u8)predictor[1] << 8) | ((u8)predictor[2] << 16) | ((u32)(u8)predictor[3] << 24);
+}
+
+ALWAYS_INLINE static AK::SIMD::u32x4 load_pixels(const RGBA32* pixels)
+{
+    AK::SIMD::u32x4 value;
+    memcpy(&value, pixels, sizeof(value));
+    return value;
+}
+
+ALWAYS_INLINE static void store_pixels(RGBA32* pixels, AK::SIMD::u32x4 value)
+{
+    memcpy(pixels, &value, sizeof(value));
+}
+
 template<bool has_alpha, u8 filter_type>
 ALWAYS_INLINE static void unfilter_impl(Gfx::Bitmap& bitmap, int y, const void* dummy_scanline_data)
 {
-    auto* dummy_scanline = (const Pixel*)dummy_scanline_data;
-    if constexpr (filter_type == 0) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-        }
-    }
-
-    if constexpr (filter_type == 1) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        swap(pixels[0].r, pixels[0].b);
-        for (int i = 1; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            auto& a = (const Pixel&)pixels[i - 1];
-            x.v[0] += a.v[0];
-            x.v[1] += a.v[1];
-            x.v[2] += a.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += a.v[3];
-        }
-        return;
-    }
-    if constexpr (filter_type == 2) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] += b.v[0];
-            x.v[1] += b.v[1];
-            x.v[2] += b.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += b.v[3];
+    auto* dummy_scanline = (const RGBA32*)dummy_scanline_data;
+    auto* pixels = bitmap.scanline(y);
+    const RGBA32* pixels_y_minus_1 = y == 0 ? dummy_scanline : bitmap.scanline(y - 1);
+    int width = bitmap.width();
+
+    // None and Up don't depend on the pixel to the left, so they do four pixels at a time.
+    if constexpr (filter_type == 0 || filter_type == 2) {
+        int i = 0;
+        for (; i + 4 <= width; i += 4) {
+            auto x = swap_red_and_blue(load_pixels(&pixels[i]));
+            if constexpr (filter_type == 2)
+                x = add_channels<has_alpha>(x, load_pixels(&pixels_y_minus_1[i]));
+            store_pixels(&pixels[i], x);
         }
-        return;
-    }
-    if constexpr (filter_type == 3) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            if (i != 0)
-                a = pixels[i - 1];
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] = x.v[0] + ((a.v[0] + b.v[0]) / 2);
-            x.v[1] = x.v[1] + ((a.v[1] + b.v[1]) / 2);
-            x.v[2] = x.v[2] + ((a.v[2] + b.v[2]) / 2);
-            if constexpr (has_alpha)
-                x.v[3] = x.v[3] + ((a.v[3] + b.v[3]) / 2);
+        for (; i < width; ++i) {
+            auto x = swap_red_and_blue(pixels[i]);
+            if constexpr (filter_type == 2)
+                x = add_channels<has_alpha>(x, pixels_y_minus_1[i]);
+            pixels[i] = x;
         }
         return;
     }
-    if constexpr (filter_type == 4) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            const Pixel& b = pixels_y_minus_1[i];
-            Pixel c;
-            if (i != 0) {
-                a = pixels[i - 1];
-                c = pixels_y_minus_1[i - 1];
-            }
-            x.v[0] += paeth_predictor(a.v[0], b.v[0], c.v[0]);
-            x.v[1] += paeth_predictor(a.v[1], b.v[1], c.v[1]);
-            x.v[2] += paeth_predictor(a.v[2], b.v[2], c.v[2]);
-            if constexpr (has_alpha)
-                x.v[3] += paeth_predictor(a.v[3], b.v[3], c.v[3]);
-        }
+
+    u32 a = 0;
+    u32 c = 0;
+    for (int i = 0; i < width; ++i) {
+        auto x = swap_red_and_blue(pixels[i]);
+        u32 b = pixels_y_minus_1[i];
+        if constexpr (filter_type == 1)
+            x = add_channels<has_alpha>(x, a);
+        if constexpr (filter_type == 3)
+            x = add_channels<has_alpha>(x, average_channels(a, b));
+        if constexpr (filter_type == 4)
+            x = add_channels<has_alpha>(x, paeth_predictor(a, b, c));
+        pixels[i] = x;
+        a = x;
+        c = b;
     }
 }
 
@@ -666,7 +682,7 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass, int pixel_spacing)
 {
     PNGLoadingContext subimage_context;
     subimage_context.width = adam7_width(context, pass);
@@ -716,22 +732,40 @@ static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, in
 
     // Copy the subimage data into the main image according to the pass pattern
     for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
+        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dx < context.width; ++x, dx += adam7_stepx[pass]) {
+            context.bitmap->set_pixel(dx / pixel_spacing, dy / pixel_spacing, subimage_context.bitmap->get_pixel(x, y));
         }
     }
     return true;
 }
 
+// The first pass holds every 8th pixel in both directions, the first three every 4th and the first five every
+// 2nd, so an image that's only needed at a fraction of its size can stop after those. Picks the widest spacing
+// that still covers the target size.
+static int adam7_pixel_spacing_for_target_size(const PNGLoadingContext& context)
+{
+    if (context.target_size.is_empty())
+        return 1;
+    for (int spacing = 8; spacing > 1; spacing /= 2) {
+        if ((context.width + spacing - 1) / spacing >= context.target_size.width()
+            && (context.height + spacing - 1) / spacing >= context.target_size.height())
+            return spacing;
+    }
+    return 1;
+}
+
 static bool decode_png_adam7(PNGLoadingContext& context)
 {
     Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-    context.bitmap = Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height });
+    int pixel_spacing = adam7_pixel_spacing_for_target_size(context);
+    IntSize size { (context.width + pixel_spacing - 1) / pixel_spacing, (context.height + pixel_spacing - 1) / pixel_spacing };
+    context.bitmap = Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, size);
     if (!context.bitmap)
         return false;
 
-    for (int pass = 1; pass <= 7; ++pass) {
-        if (!decode_adam7_pass(context, streamer, pass))
+    int last_pass = pixel_spacing == 8 ? 1 : (pixel_spacing == 4 ? 3 : (pixel_spacing == 2 ? 5 : 7));
+    for (int pass = 1; pass <= last_pass; ++pass) {
+        if (!decode_adam7_pass(context, streamer, pass, pixel_spacing))
             return false;
     }
     return true;
@@ -1018,4 +1052,9 @@ ImageFrameDescriptor PNGImageDecoderPlugin::frame(size_t i)
     return { bitmap(), 0 };
 }
 
+void PNGImageDecoderPlugin::set_target_size(IntSize target_size)
+{
+    m_context->target_size = target_size;
+}
+
 }
@@ -8,6 +8,7 @@
 
 #include <AK/Concepts.h>
 #include <AK/String.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/PNGWriter.h>
@@ -51,16 +52,13 @@ public:
     void finalize(PNGChunk&);
     void add_byte_to_block(u8 data, PNGChunk&);
 
-    u32 adler_s1() const { return m_adler_s1; }
-    u32 adler_s2() const { return m_adler_s2; }
+    u32 adler() { return m_adler.digest(); }
 
 private:
     void add_block_to_chunk(PNGChunk&, bool);
-    void update_adler(u8);
     bool full() { return m_non_compressible_data.size() == 65535; }
     Vector<u8> m_non_compressible_data;
-    u16 m_adler_s1 { 1 };
-    u16 m_adler_s2 { 0 };
+    Crypto::Checksum::Adler32 m_adler;
 };
 
 PNGChunk::PNGChunk(String type)
@@ -79,7 +77,7 @@ void PNGChunk::store_type()
 
 void PNGChunk::store_data_length()
 {
-    auto data_lenth = BigEndian(m_data.size() - sizeof(data_length_type) - m_type.length());
+    auto data_lenth = BigEndian<data_length_type>(m_data.size() - sizeof(data_length_type) - m_type.length());
     __builtin_memcpy(m_data.offset_pointer(0), &data_lenth, sizeof(u32));
 }
 
@@ -123,7 +121,6 @@ void PNGChunk::add_u8(u8 data)
 void NonCompressibleBlock::add_byte_to_block(u8 data, PNGChunk& chunk)
 {
     m_non_compressible_data.append(data);
-    update_adler(data);
     if (full()) {
         add_block_to_chunk(chunk, false);
         m_non_compressible_data.clear_with_capacity();
@@ -141,6 +138,7 @@ void NonCompressibleBlock::add_block_to_chunk(PNGChunk& png_chunk, bool last)
     png_chunk.add_as_little_endian(nlen);
 
     png_chunk.add(m_non_compressible_data.data(), m_non_compressible_data.size());
+    m_adler.update(m_non_compressible_data.span());
 }
 
 void NonCompressibleBlock::finalize(PNGChunk& chunk)
@@ -148,12 +146,6 @@ void NonCompressibleBlock::finalize(PNGChunk& chunk)
     add_block_to_chunk(chunk, true);
 }
 
-void NonCompressibleBlock::update_adler(u8 data)
-{
-    m_adler_s1 = (m_adler_s1 + data) % 65521;
-    m_adler_s2 = (m_adler_s2 + m_adler_s1) % 65521;
-}
-
 void PNGWriter::add_chunk(PNGChunk& png_chunk)
 {
     png_chunk.store_data_length();
@@ -210,8 +202,7 @@ void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
     }
     non_compressible_block.finalize(png_chunk);
 
-    png_chunk.add_as_big_endian(non_compressible_block.adler_s2());
-    png_chunk.add_as_big_endian(non_compressible_block.adler_s1());
+    png_chunk.add_as_big_endian(non_compressible_block.adler());
 
     add_chunk(png_chunk);
 }
@@ -11,13 +11,14 @@
 #include "Font.h"
 #include "FontDatabase.h"
 #include "Gamma.h"
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/Math.h>
 #include <AK/Memory.h>
 #include <AK/Queue.h>
-#include <AK/QuickSort.h>
+#include <AK/SIMD.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -25,6 +26,7 @@
 #include <LibGfx/CharacterBitmap.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/Path.h>
+#include <LibGfx/PathRasterizer.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextLayout.h>
 #include <stdio.h>
@@ -53,6 +55,72 @@ ALWAYS_INLINE Color get_pixel(const Gfx::Bitmap& bitmap, int x, int y)
     return bitmap.get_pixel(x, y);
 }
 
+// Blends four source pixels onto four opaque destination pixels at once. For an opaque destination, this is the
+// same as Color::blend(), just without having to divide by anything other than 255.
+ALWAYS_INLINE static AK::SIMD::u32x4 blend_onto_opaque_pixels(AK::SIMD::u32x4 dst, AK::SIMD::u32x4 src)
+{
+    using AK::SIMD::u32x4;
+
+    u32x4 alpha = src >> 24;
+    u32x4 inverse_alpha = 255 - alpha;
+    auto blend_channel = [&](int shift) -> u32x4 {
+        u32x4 value = ((dst >> shift) & 0xff) * inverse_alpha + ((src >> shift) & 0xff) * alpha;
+        // This is value / 255, which is exact for everything up to 255 * 255.
+        return ((value + 1 + (value >> 8)) >> 8) << shift;
+    };
+    return 0xff000000 | blend_channel(16) | blend_channel(8) | blend_channel(0);
+}
+
+ALWAYS_INLINE static AK::SIMD::u32x4 load_pixels(const RGBA32* pixels)
+{
+    AK::SIMD::u32x4 value;
+    __builtin_memcpy(&value, pixels, sizeof(value));
+    return value;
+}
+
+ALWAYS_INLINE static void store_pixels(RGBA32* pixels, AK::SIMD::u32x4 value)
+{
+    __builtin_memcpy(pixels, &value, sizeof(value));
+}
+
+// Does dst[i] = Color::from_rgba(dst[i]).blend(Color::from_rgba(src[i])) for the whole span. If the destination is known
+// to be opaque (say, because it has no alpha channel), the alpha of its pixels is ignored and treated as 255.
+template<bool destination_is_opaque>
+static void blend_span(RGBA32* dst, const RGBA32* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto dst_pixels = load_pixels(dst + i);
+        if (destination_is_opaque || ((dst[i] & dst[i + 1] & dst[i + 2] & dst[i + 3]) >> 24) == 0xff) {
+            store_pixels(dst + i, blend_onto_opaque_pixels(dst_pixels, load_pixels(src + i)));
+            continue;
+        }
+        for (size_t j = i; j < i + 4; ++j)
+            dst[j] = Color::from_rgba(dst[j]).blend(Color::from_rgba(src[j])).value();
+    }
+    for (; i < count; ++i) {
+        auto dest_color = destination_is_opaque ? Color::from_rgb(dst[i]) : Color::from_rgba(dst[i]);
+        dst[i] = dest_color.blend(Color::from_rgba(src[i])).value();
+    }
+}
+
+// Does dst[i] = Color::from_rgba(dst[i]).blend(color) for the whole span.
+static void blend_span_with_color(RGBA32* dst, Color color, size_t count)
+{
+    AK::SIMD::u32x4 src_pixels = { color.value(), color.value(), color.value(), color.value() };
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        if (((dst[i] & dst[i + 1] & dst[i + 2] & dst[i + 3]) >> 24) == 0xff) {
+            store_pixels(dst + i, blend_onto_opaque_pixels(load_pixels(dst + i), src_pixels));
+            continue;
+        }
+        for (size_t j = i; j < i + 4; ++j)
+            dst[j] = Color::from_rgba(dst[j]).blend(color).value();
+    }
+    for (; i < count; ++i)
+        dst[i] = Color::from_rgba(dst[i]).blend(color).value();
+}
+
 Painter::Painter(Gfx::Bitmap& bitmap)
     : m_target(bitmap)
 {
@@ -114,8 +182,7 @@ void Painter::fill_physical_rect(const IntRect& physical_rect, Color color)
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_rgba(dst[j]).blend(color).value();
+        blend_span_with_color(dst, color, physical_rect.width());
         dst += dst_skip;
     }
 }
@@ -754,19 +821,28 @@ struct BlitState {
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    // The alpha each source pixel is blended with only depends on its own alpha, so it's worked out once up front.
+    Array<u32, 256> alpha_with_opacity;
+    for (size_t alpha = 0; alpha < alpha_with_opacity.size(); ++alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = alpha / 255.0;
+            alpha_with_opacity[alpha] = static_cast<u8>(255 * (state.opacity * pixel_opacity)) << 24;
+        } else {
+            alpha_with_opacity[alpha] = static_cast<u8>(state.opacity * 255) << 24;
+        }
+    }
+
+    // Source pixels are blended a small batch at a time, so the batch can be handed to blend_span() as a whole.
+    constexpr int batch_size = 64;
+    RGBA32 src_with_alpha[batch_size];
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_rgba(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_rgba(state.src[x]);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        for (int x = 0; x < state.column_count; x += batch_size) {
+            int count = min(batch_size, state.column_count - x);
+            for (int i = 0; i < count; ++i) {
+                auto pixel = state.src[x + i];
+                src_with_alpha[i] = (pixel & 0xffffff) | alpha_with_opacity[pixel >> 24];
             }
+            blend_span<!(has_alpha & BlitState::DstAlpha)>(state.dst + x, src_with_alpha, count);
         }
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
@@ -1081,18 +1157,26 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, const IntRe
     int src_left = src_rect.left() * (1 << 16);
     int src_top = src_rect.top() * (1 << 16);
 
+    // With an alpha channel, source pixels are sampled a small batch at a time, so the batch can be blended as a whole.
+    constexpr int batch_size = 64;
+    RGBA32 src_pixels[batch_size];
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
         auto* scanline = (Color*)target.scanline(y);
-        for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
-            auto scaled_x = ((x - dst_rect.x()) * hscale + src_left) >> 16;
-            auto scaled_y = ((y - dst_rect.y()) * vscale + src_top) >> 16;
-            auto src_pixel = get_pixel(source, scaled_x, scaled_y);
-            if (has_opacity)
-                src_pixel.set_alpha(src_pixel.alpha() * opacity);
-            if constexpr (has_alpha_channel) {
-                scanline[x] = scanline[x].blend(src_pixel);
-            } else
-                scanline[x] = src_pixel;
+        auto scaled_y = ((y - dst_rect.y()) * vscale + src_top) >> 16;
+        for (int x = clipped_rect.left(); x <= clipped_rect.right(); x += batch_size) {
+            int count = min(batch_size, clipped_rect.right() - x + 1);
+            for (int i = 0; i < count; ++i) {
+                auto scaled_x = ((x + i - dst_rect.x()) * hscale + src_left) >> 16;
+                auto src_pixel = get_pixel(source, scaled_x, scaled_y);
+                if (has_opacity)
+                    src_pixel.set_alpha(src_pixel.alpha() * opacity);
+                if constexpr (has_alpha_channel)
+                    src_pixels[i] = src_pixel.value();
+                else
+                    scanline[x + i] = src_pixel;
+            }
+            if constexpr (has_alpha_channel)
+                blend_span<false>(target.scanline(y) + x, src_pixels, count);
         }
     }
 }
@@ -1166,7 +1250,7 @@ FLATTEN void Painter::draw_glyph(const IntPoint& point, u32 code_point, const Fo
     if (glyph.is_glyph_bitmap()) {
         draw_bitmap(top_left, glyph.glyph_bitmap(), color);
     } else {
-        blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap()->rect(), [color](Color pixel) -> Color {
+        blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap_rect(), [color](Color pixel) -> Color {
             return pixel.multiply(color);
         });
     }
@@ -1937,164 +2021,33 @@ void Painter::stroke_path(const Path& path, Color color, int thickness)
     }
 }
 
-[[maybe_unused]] static void approximately_place_on_int_grid(FloatPoint ffrom, FloatPoint fto, IntPoint& from, IntPoint& to, Optional<IntPoint> previous_to)
-{
-    auto diffs = fto - ffrom;
-    // Truncate all first (round down).
-    from = ffrom.to_type<int>();
-    to = fto.to_type<int>();
-    // There are 16 possible configurations, by deciding to round each
-    // coord up or down (and there are four coords, from.x from.y to.x to.y)
-    // we will simply choose one which most closely matches the correct slope
-    // with the following heuristic:
-    // - if the x diff is positive or zero (that is, a right-to-left slant), round 'from.x' up and 'to.x' down.
-    // - if the x diff is negative         (that is, a left-to-right slant), round 'from.x' down and 'to.x' up.
-    // Note that we do not need to touch the 'y' attribute, as that is our scanline.
-    if (diffs.x() >= 0) {
-        from.set_x(from.x() + 1);
-    } else {
-        to.set_x(to.x() + 1);
-    }
-    if (previous_to.has_value() && from.x() != previous_to.value().x()) // The points have to line up, since we're using these lines to fill a shape.
-        from.set_x(previous_to.value().x());
-}
-
 void Painter::fill_path(Path& path, Color color, WindingRule winding_rule)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
 
-    const auto& segments = path.split_lines();
-
-    if (segments.size() == 0)
+    auto rect = enclosing_int_rect(path.bounding_box()).translated(translation()).intersected(clip_rect());
+    if (rect.is_empty())
         return;
 
-    Vector<Path::SplitLineSegment> active_list;
-    active_list.ensure_capacity(segments.size());
-
-    // first, grab the segments for the very first scanline
-    int first_y = path.bounding_box().bottom_right().y() + 1;
-    int last_y = path.bounding_box().top_left().y() - 1;
-    float scanline = first_y;
+    PathRasterizer rasterizer(rect.size());
+    rasterizer.draw_path(path, (translation() - rect.location()).to_type<float>());
 
-    size_t last_active_segment { 0 };
-
-    for (auto& segment : segments) {
-        if (segment.maximum_y != scanline)
-            break;
-        active_list.append(segment);
-        ++last_active_segment;
-    }
-
-    auto is_inside_shape = [winding_rule](int winding_number) {
-        if (winding_rule == WindingRule::Nonzero)
-            return winding_number != 0;
-
-        if (winding_rule == WindingRule::EvenOdd)
-            return winding_number % 2 == 0;
-
-        VERIFY_NOT_REACHED();
-    };
-
-    auto increment_winding = [winding_rule](int& winding_number, const IntPoint& from, const IntPoint& to) {
-        if (winding_rule == WindingRule::EvenOdd) {
-            ++winding_number;
-            return;
-        }
-
-        if (winding_rule == WindingRule::Nonzero) {
-            if (from.dy_relative_to(to) < 0)
-                ++winding_number;
-            else
-                --winding_number;
-            return;
-        }
-
-        VERIFY_NOT_REACHED();
-    };
-
-    while (scanline >= last_y) {
-        Optional<IntPoint> previous_to;
-        if (active_list.size()) {
-            // sort the active list by 'x' from right to left
-            quick_sort(active_list, [](const auto& line0, const auto& line1) {
-                return line1.x < line0.x;
-            });
-            if constexpr (FILL_PATH_DEBUG) {
-                if ((int)scanline % 10 == 0) {
-                    draw_text(IntRect(active_list.last().x - 20, scanline, 20, 10), String::number((int)scanline));
-                }
-            }
-
-            if (active_list.size() > 1) {
-                auto winding_number { winding_rule == WindingRule::Nonzero ? 1 : 0 };
-                for (size_t i = 1; i < active_list.size(); ++i) {
-                    auto& previous = active_list[i - 1];
-                    auto& current = active_list[i];
-
-                    IntPoint from, to;
-                    IntPoint truncated_from { previous.x, scanline };
-                    IntPoint truncated_to { current.x, scanline };
-                    approximately_place_on_int_grid({ previous.x, scanline }, { current.x, scanline }, from, to, previous_to);
-
-                    if (is_inside_shape(winding_number)) {
-                        // The points between this segment and the previous are
-                        // inside the shape
-
-                        dbgln_if(FILL_PATH_DEBUG, "y={}: {} at {}: {} -- {}", scanline, winding_number, i, from, to);
-                        draw_line(from, to, color, 1);
-                    }
-
-                    auto is_passing_through_maxima = scanline == previous.maximum_y
-                        || scanline == previous.minimum_y
-                        || scanline == current.maximum_y
-                        || scanline == current.minimum_y;
-
-                    auto is_passing_through_vertex = false;
-
-                    if (is_passing_through_maxima) {
-                        is_passing_through_vertex = previous.x == current.x;
-                    }
-
-                    if (!is_passing_through_vertex || previous.inverse_slope * current.inverse_slope < 0)
-                        increment_winding(winding_number, truncated_from, truncated_to);
-
-                    // update the x coord
-                    active_list[i - 1].x -= active_list[i - 1].inverse_slope;
-                }
-                active_list.last().x -= active_list.last().inverse_slope;
-            } else {
-                auto point = IntPoint(active_list[0].x, scanline);
-                draw_line(point, point, color);
-
-                // update the x coord
-                active_list.first().x -= active_list.first().inverse_slope;
-            }
-        }
-
-        --scanline;
-        // remove any edge that goes out of bound from the active list
-        for (size_t i = 0, count = active_list.size(); i < count; ++i) {
-            if (scanline <= active_list[i].minimum_y) {
-                active_list.remove(i);
-                --count;
-                --i;
-            }
-        }
-        for (size_t j = last_active_segment; j < segments.size(); ++j, ++last_active_segment) {
-            auto& segment = segments[j];
-            if (segment.maximum_y < scanline)
-                break;
-            if (segment.minimum_y >= scanline)
-                continue;
-
-            active_list.append(segment);
-        }
-    }
+    Vector<RGBA32> pixels;
+    rasterizer.for_each_covered_span(winding_rule, [&](int y, int x, Span<u8> alphas) {
+        pixels.resize(alphas.size());
+        for (size_t i = 0; i < alphas.size(); ++i)
+            pixels[i] = color.with_alpha(color.alpha() * alphas[i] / 255).value();
+        auto* dst = m_target->scanline(rect.y() + y) + rect.x() + x;
+        if (m_target->has_alpha_channel())
+            blend_span<false>(dst, pixels.data(), pixels.size());
+        else
+            blend_span<true>(dst, pixels.data(), pixels.size());
+    });
 
     if constexpr (FILL_PATH_DEBUG) {
         size_t i { 0 };
-        for (auto& segment : segments) {
-            draw_line(Point<int>(segment.from), Point<int>(segment.to), Color::from_hsv(i++ * 360.0 / segments.size(), 1.0, 1.0), 1);
+        for (auto& segment : path.split_lines()) {
+            draw_line(Point<int>(segment.from), Point<int>(segment.to), Color::from_hsv(i++ * 360.0 / path.split_lines().size(), 1.0, 1.0), 1);
         }
     }
 }
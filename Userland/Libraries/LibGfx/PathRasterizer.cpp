@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2020, Srimanta Barua <srimanta.barua1@gmail.com>
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <LibGfx/PathRasterizer.h>
+#include <math.h>
+
+namespace Gfx {
+
+PathRasterizer::PathRasterizer(IntSize size)
+    : m_size(size)
+    , m_pitch(size.width() + 2)
+{
+    m_data.resize(m_pitch * m_size.height());
+    for (auto& value : m_data)
+        value = 0.0f;
+    m_row_extents.resize(m_size.height());
+    for (auto& extent : m_row_extents)
+        extent = { NumericLimits<int>::max(), NumericLimits<int>::min() };
+}
+
+void PathRasterizer::draw_path(Path& path, FloatPoint const& offset)
+{
+    for (auto& line : path.split_lines())
+        draw_line(line.from + offset, line.to + offset);
+
+    // The split lines are sorted, so where the subpaths start and end has to come from the segments.
+    Optional<FloatPoint> subpath_start;
+    FloatPoint cursor;
+    auto close_subpath = [&] {
+        if (subpath_start.has_value())
+            draw_line(cursor + offset, *subpath_start + offset);
+        subpath_start.clear();
+    };
+    for (auto& segment : path.segments()) {
+        if (segment.type() == Segment::Type::MoveTo) {
+            close_subpath();
+        } else if (!subpath_start.has_value()) {
+            subpath_start = cursor;
+        }
+        cursor = segment.point();
+    }
+    close_subpath();
+}
+
+void PathRasterizer::draw_line(FloatPoint p0, FloatPoint p1)
+{
+    if (p0.y() == p1.y())
+        return;
+
+    float width = m_size.width();
+    float height = m_size.height();
+    if (max(p0.y(), p1.y()) <= 0.0f || min(p0.y(), p1.y()) >= height)
+        return;
+
+    auto point_at_y = [&](float y) {
+        float t = (y - p0.y()) / (p1.y() - p0.y());
+        return FloatPoint { p0.x() + t * (p1.x() - p0.x()), y };
+    };
+    auto clip_to_rows = [&](FloatPoint point) {
+        if (point.y() < 0.0f)
+            return point_at_y(0.0f);
+        if (point.y() > height)
+            return point_at_y(height);
+        return point;
+    };
+    auto from = clip_to_rows(p0);
+    auto to = clip_to_rows(p1);
+
+    // Whatever is left of the rasterizer still counts for the pixels to its right, just as if it were drawn along
+    // the left edge. Whatever is right of it doesn't count for anything.
+    struct Crossing {
+        float t;
+        FloatPoint point;
+    };
+    Vector<Crossing, 2> crossings;
+    for (float x : { 0.0f, width }) {
+        if ((from.x() < x && to.x() > x) || (from.x() > x && to.x() < x)) {
+            float t = (x - from.x()) / (to.x() - from.x());
+            crossings.append({ t, { x, from.y() + t * (to.y() - from.y()) } });
+        }
+    }
+    if (crossings.size() == 2 && crossings[1].t < crossings[0].t)
+        swap(crossings[0], crossings[1]);
+
+    auto clamp_to_bounds = [&](FloatPoint point) {
+        return FloatPoint { clamp(point.x(), 0.0f, width), clamp(point.y(), 0.0f, height) };
+    };
+    auto start = from;
+    for (auto& crossing : crossings) {
+        draw_line_within_bounds(clamp_to_bounds(start), clamp_to_bounds(crossing.point));
+        start = crossing.point;
+    }
+    draw_line_within_bounds(clamp_to_bounds(start), clamp_to_bounds(to));
+}
+
+void PathRasterizer::draw_line_within_bounds(FloatPoint p0, FloatPoint p1)
+{
+    // If we're on the same Y, there's no need to draw
+    if (p0.y() == p1.y())
+        return;
+
+    float direction = -1.0;
+    if (p1.y() < p0.y()) {
+        direction = 1.0;
+        swap(p0, p1);
+    }
+
+    float width = m_size.width();
+    float dxdy = (p1.x() - p0.x()) / (p1.y() - p0.y());
+    u32 y0 = floorf(p0.y());
+    u32 y1 = ceilf(p1.y());
+    float x_cur = p0.x();
+
+    for (u32 y = y0; y < y1; y++) {
+        float* row = &m_data[m_pitch * y];
+        auto& extent = m_row_extents[y];
+
+        float dy = min(y + 1.0f, p1.y()) - max((float)y, p0.y());
+        float directed_dy = dy * direction;
+        float x_next = clamp(x_cur + dy * dxdy, 0.0f, width);
+        float x0 = x_cur;
+        float x1 = x_next;
+        if (x1 < x0)
+            swap(x0, x1);
+        float x0_floor = floorf(x0);
+        float x1_ceil = ceilf(x1);
+        u32 x0i = x0_floor;
+
+        if (x1_ceil <= x0_floor + 1.0f) {
+            // If x0 and x1 are within the same pixel, then area to the right is (1 - (mid(x0, x1) - x0_floor)) * dy
+            float area = ((x0 + x1) * 0.5f) - x0_floor;
+            row[x0i] += directed_dy * (1.0f - area);
+            row[x0i + 1] += directed_dy * area;
+            extent.first_x = min(extent.first_x, (int)x0i);
+            extent.last_x = max(extent.last_x, (int)x0i + 1);
+        } else {
+            float dydx = 1.0f / dxdy;
+            if (dydx < 0)
+                dydx = -dydx;
+
+            float x0_right = 1.0f - (x0 - x0_floor);
+            u32 x1_floor_i = floorf(x1);
+            float area_upto_here = 0.5f * x0_right * x0_right * dydx;
+            row[x0i] += direction * area_upto_here;
+            for (u32 x = x0i + 1; x < x1_floor_i; x++) {
+                row[x] += direction * dydx;
+                area_upto_here += dydx;
+            }
+            float remaining_area = (dy - area_upto_here);
+            row[x1_floor_i] += direction * remaining_area;
+            extent.first_x = min(extent.first_x, (int)x0i);
+            extent.last_x = max(extent.last_x, (int)x1_floor_i);
+        }
+
+        x_cur = x_next;
+    }
+}
+
+static u8 coverage_to_alpha(float coverage, Painter::WindingRule winding_rule)
+{
+    coverage = fabsf(coverage);
+    if (winding_rule == Painter::WindingRule::EvenOdd) {
+        // Every other time an outline is crossed, the pixels go from covered to uncovered again.
+        coverage = fmodf(coverage, 2.0f);
+        if (coverage > 1.0f)
+            coverage = 2.0f - coverage;
+    } else if (coverage > 1.0f) {
+        coverage = 1.0f;
+    }
+    return coverage * 255.0f;
+}
+
+static void coverage_to_alpha(Span<float const> coverage, Span<u8> alphas, Painter::WindingRule winding_rule)
+{
+    using AK::SIMD::f32x4;
+
+    size_t i = 0;
+    if (winding_rule == Painter::WindingRule::Nonzero) {
+        for (; i + 4 <= coverage.size(); i += 4) {
+            f32x4 values;
+            __builtin_memcpy(&values, &coverage[i], sizeof(values));
+            values = values < 0.0f ? -values : values;
+            values = values > 1.0f ? 1.0f : values;
+            values *= 255.0f;
+            for (size_t j = 0; j < 4; ++j)
+                alphas[i + j] = values[j];
+        }
+    }
+    for (; i < coverage.size(); ++i)
+        alphas[i] = coverage_to_alpha(coverage[i], winding_rule);
+}
+
+int PathRasterizer::alphas_of_row(int y, Painter::WindingRule winding_rule, Vector<u8>& alphas)
+{
+    alphas.clear_with_capacity();
+    auto& extent = m_row_extents[y];
+    if (extent.first_x >= m_size.width() || extent.first_x > extent.last_x)
+        return 0;
+
+    int first_x = extent.first_x;
+    int last_x = min(extent.last_x, m_size.width() - 1);
+    float const* row = &m_data[m_pitch * y];
+    m_row_coverage.resize(last_x - first_x + 1);
+    float accumulator = 0.0f;
+    for (int x = first_x; x <= last_x; ++x) {
+        accumulator += row[x];
+        m_row_coverage[x - first_x] = accumulator;
+    }
+
+    alphas.resize(m_row_coverage.size());
+    coverage_to_alpha(m_row_coverage.span(), alphas.span(), winding_rule);
+
+    // Nothing was drawn past the last cell, so if the outline isn't closed within the row, what it covers
+    // there goes all the way to the right edge.
+    if (auto trailing_alpha = coverage_to_alpha(accumulator, winding_rule); trailing_alpha != 0) {
+        for (int x = last_x + 1; x < m_size.width(); ++x)
+            alphas.append(trailing_alpha);
+    }
+    return first_x;
+}
+
+RefPtr<Bitmap> PathRasterizer::accumulate(Color color, Painter::WindingRule winding_rule)
+{
+    auto bitmap = Bitmap::try_create(BitmapFormat::BGRA8888, m_size);
+    if (!bitmap)
+        return {};
+    bitmap->fill(color.with_alpha(0));
+    for_each_covered_span(winding_rule, [&](int y, int x, Span<u8> alphas) {
+        auto* pixels = bitmap->scanline(y) + x;
+        for (size_t i = 0; i < alphas.size(); ++i)
+            pixels[i] = color.with_alpha(alphas[i]).value();
+    });
+    return bitmap;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Color.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+#include <LibGfx/Point.h>
+#include <LibGfx/Size.h>
+
+namespace Gfx {
+
+// An anti-aliasing rasterizer for filled outlines. Every line adds the area it covers within each pixel to an
+// accumulation buffer, and summing that up along a row gives the coverage of every pixel in it. Only the part of
+// each row that lines were actually drawn into is turned into coverage.
+class PathRasterizer {
+public:
+    explicit PathRasterizer(IntSize);
+
+    IntSize size() const { return m_size; }
+
+    // Adds the outline of the path, moved by offset. Subpaths that aren't closed are filled as if they were.
+    void draw_path(Path&, FloatPoint const& offset = {});
+    void draw_line(FloatPoint, FloatPoint);
+
+    // Calls callback(y, x, alphas) for every row with anything in it, with the coverage of the pixels starting at x.
+    template<typename Callback>
+    void for_each_covered_span(Painter::WindingRule winding_rule, Callback callback)
+    {
+        Vector<u8> alphas;
+        for (int y = 0; y < m_size.height(); ++y) {
+            auto x = alphas_of_row(y, winding_rule, alphas);
+            if (!alphas.is_empty())
+                callback(y, x, alphas.span());
+        }
+    }
+
+    // Returns a bitmap of the given color, with the coverage of every pixel as its alpha.
+    RefPtr<Bitmap> accumulate(Color = Color::White, Painter::WindingRule = Painter::WindingRule::Nonzero);
+
+private:
+    void draw_line_within_bounds(FloatPoint, FloatPoint);
+    int alphas_of_row(int y, Painter::WindingRule, Vector<u8>& alphas);
+
+    struct RowExtent {
+        int first_x;
+        int last_x;
+    };
+
+    IntSize m_size;
+    // Every row has two extra cells, since lines ending on the right edge add to the cell just past it.
+    int m_pitch { 0 };
+    Vector<float> m_data;
+    Vector<RowExtent> m_row_extents;
+    Vector<float> m_row_coverage;
+};
+
+}
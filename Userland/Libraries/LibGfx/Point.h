@@ -266,4 +266,7 @@ namespace IPC {
 bool encode(Encoder&, Gfx::IntPoint const&);
 bool decode(Decoder&, Gfx::IntPoint&);
 
+template<>
+inline constexpr bool HasFixedLayout<Gfx::IntPoint> = true;
+
 }
@@ -695,4 +695,7 @@ namespace IPC {
 bool decode(Decoder&, Gfx::IntRect&);
 bool encode(Encoder&, const Gfx::IntRect&);
 
+template<>
+inline constexpr bool HasFixedLayout<Gfx::IntRect> = true;
+
 }
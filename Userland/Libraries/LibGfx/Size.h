@@ -191,4 +191,7 @@ namespace IPC {
 bool encode(Encoder&, Gfx::IntSize const&);
 bool decode(Decoder&, Gfx::IntSize&);
 
+template<>
+inline constexpr bool HasFixedLayout<Gfx::IntSize> = true;
+
 }
@@ -14,6 +14,7 @@
 #include <LibGfx/TrueTypeFont/Cmap.h>
 #include <LibGfx/TrueTypeFont/Font.h>
 #include <LibGfx/TrueTypeFont/Glyf.h>
+#include <LibGfx/TrueTypeFont/GlyphAtlas.h>
 #include <LibGfx/TrueTypeFont/Tables.h>
 #include <LibTextCodec/Decoder.h>
 #include <math.h>
@@ -258,6 +259,11 @@ Result<NonnullRefPtr<Font>, String> Font::try_load_from_externally_owned_memory(
     return try_load_from_offset(move(buffer), 0);
 }
 
+Font::~Font()
+{
+    GlyphAtlas::the().forget_font(*this);
+}
+
 // FIXME: "loca" and "glyf" are not available for CFF fonts.
 Result<NonnullRefPtr<Font>, String> Font::try_load_from_offset(ReadonlyBytes buffer, u32 offset)
 {
@@ -522,23 +528,12 @@ ALWAYS_INLINE int ScaledFont::unicode_view_width(T const& view) const
     return longest_width;
 }
 
-RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id) const
-{
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(glyph_id);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
-
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
-    m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
-    return glyph_bitmap;
-}
-
 Gfx::Glyph ScaledFont::glyph(u32 code_point) const
 {
     auto id = glyph_id_for_code_point(code_point);
-    auto bitmap = rasterize_glyph(id);
+    auto entry = GlyphAtlas::the().glyph(*m_font, id, m_x_scale, m_y_scale);
     auto metrics = glyph_metrics(id);
-    return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+    return Gfx::Glyph(move(entry.bitmap), entry.rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
 }
 
 u8 ScaledFont::glyph_width(size_t code_point) const
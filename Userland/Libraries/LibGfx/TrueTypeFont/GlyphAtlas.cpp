@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/TrueTypeFont/Font.h>
+#include <LibGfx/TrueTypeFont/GlyphAtlas.h>
+#include <string.h>
+
+namespace TTF {
+
+GlyphAtlas& GlyphAtlas::the()
+{
+    // Fonts may outlive static destructors, so the atlas never goes away.
+    static GlyphAtlas* s_the = new GlyphAtlas;
+    return *s_the;
+}
+
+GlyphAtlas::Entry GlyphAtlas::glyph(Font const& font, u32 glyph_id, float x_scale, float y_scale)
+{
+    Key key { &font, glyph_id, x_scale, y_scale };
+    if (auto it = m_locations.find(key); it != m_locations.end()) {
+        auto& page = m_pages[it->value.page_index];
+        page.last_used = ++m_use_counter;
+        if (it->value.rect.is_empty())
+            return {};
+        return { page.bitmap, it->value.rect };
+    }
+
+    auto glyph_bitmap = font.rasterize_glyph(glyph_id, x_scale, y_scale);
+    if (!glyph_bitmap) {
+        // Glyphs without any outline, like the one for a space, are remembered too, so they aren't rasterized again
+        // every time they're drawn. They don't take up any room on the page they're put on.
+        if (!m_pages.is_empty()) {
+            m_pages[m_current_page_index].keys.append(key);
+            m_locations.set(key, { m_current_page_index, {} });
+        }
+        return {};
+    }
+
+    auto location = allocate(glyph_bitmap->size());
+    if (!location.has_value())
+        return { glyph_bitmap, glyph_bitmap->rect() };
+
+    auto& page = m_pages[location->page_index];
+    auto& rect = location->rect;
+    VERIFY(glyph_bitmap->format() == page.bitmap->format());
+    for (int y = 0; y < rect.height(); ++y)
+        memcpy(page.bitmap->scanline(rect.y() + y) + rect.x(), glyph_bitmap->scanline(y), rect.width() * sizeof(Gfx::RGBA32));
+
+    page.keys.append(key);
+    page.last_used = ++m_use_counter;
+    m_locations.set(key, *location);
+    return { page.bitmap, rect };
+}
+
+void GlyphAtlas::forget_font(Font const& font)
+{
+    for (auto& page : m_pages) {
+        page.keys.remove_all_matching([&](auto& key) {
+            if (key.font != &font)
+                return false;
+            m_locations.remove(key);
+            return true;
+        });
+    }
+}
+
+static Gfx::IntSize page_size_for(Gfx::IntSize const& glyph_size)
+{
+    return { max(GlyphAtlas::page_size, glyph_size.width()), max(GlyphAtlas::page_size, glyph_size.height()) };
+}
+
+Optional<GlyphAtlas::Location> GlyphAtlas::allocate(Gfx::IntSize const& size)
+{
+    if (!m_pages.is_empty()) {
+        if (auto rect = allocate_on_page(m_pages[m_current_page_index], size); rect.has_value())
+            return Location { m_current_page_index, *rect };
+    }
+
+    size_t page_index;
+    if (m_pages.size() < max_page_count) {
+        auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, page_size_for(size));
+        if (!bitmap)
+            return {};
+        Page page;
+        page.bitmap = move(bitmap);
+        m_pages.append(move(page));
+        page_index = m_pages.size() - 1;
+    } else {
+        page_index = 0;
+        for (size_t i = 1; i < m_pages.size(); ++i) {
+            if (m_pages[i].last_used < m_pages[page_index].last_used)
+                page_index = i;
+        }
+        if (!empty_page(page_index, size))
+            return {};
+    }
+
+    m_current_page_index = page_index;
+    auto rect = allocate_on_page(m_pages[page_index], size);
+    VERIFY(rect.has_value());
+    return Location { page_index, *rect };
+}
+
+Optional<Gfx::IntRect> GlyphAtlas::allocate_on_page(Page& page, Gfx::IntSize const& size)
+{
+    auto& bitmap = *page.bitmap;
+    if (page.shelf_x + size.width() > bitmap.width()) {
+        page.shelf_y += page.shelf_height;
+        page.shelf_x = 0;
+        page.shelf_height = 0;
+    }
+    if (size.width() > bitmap.width() || page.shelf_y + size.height() > bitmap.height())
+        return {};
+
+    Gfx::IntRect rect { page.shelf_x, page.shelf_y, size.width(), size.height() };
+    page.shelf_x += size.width();
+    page.shelf_height = max(page.shelf_height, size.height());
+    return rect;
+}
+
+bool GlyphAtlas::empty_page(size_t page_index, Gfx::IntSize const& minimum_size)
+{
+    auto& page = m_pages[page_index];
+
+    // Glyphs handed out earlier may still be about to be drawn from the old bitmap, so it mustn't be overwritten then.
+    auto size = page_size_for(minimum_size);
+    if (page.bitmap->ref_count() > 1 || page.bitmap->size() != size) {
+        auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, size);
+        if (!bitmap)
+            return false;
+        page.bitmap = move(bitmap);
+    }
+
+    for (auto& key : page.keys)
+        m_locations.remove(key);
+    page.keys.clear();
+    page.shelf_x = 0;
+    page.shelf_y = 0;
+    page.shelf_height = 0;
+    return true;
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/Traits.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Rect.h>
+
+namespace TTF {
+
+class Font;
+
+// Rasterized glyphs of every TrueType font, at every scale they're drawn at, packed together into a few large
+// bitmaps instead of each getting a small bitmap of its own. Once all pages are in use, the page that went
+// unused for the longest is emptied to make room.
+class GlyphAtlas {
+public:
+    static GlyphAtlas& the();
+
+    static constexpr int page_size = 256;
+    static constexpr size_t max_page_count = 16;
+
+    struct Entry {
+        RefPtr<Gfx::Bitmap> bitmap;
+        Gfx::IntRect rect;
+    };
+
+    // Returns the part of an atlas page holding the glyph, rasterizing it first if it isn't in the atlas yet.
+    Entry glyph(Font const&, u32 glyph_id, float x_scale, float y_scale);
+
+    // Drops all of a font's glyphs. Glyphs are told apart by the address of their font, so this has to
+    // happen before that address gets reused.
+    void forget_font(Font const&);
+
+    size_t page_count() const { return m_pages.size(); }
+    size_t glyph_count() const { return m_locations.size(); }
+
+private:
+    GlyphAtlas() = default;
+
+    struct Key {
+        Font const* font;
+        u32 glyph_id;
+        float x_scale;
+        float y_scale;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key)
+        {
+            auto hash = pair_int_hash(ptr_hash(key.font), key.glyph_id);
+            hash = pair_int_hash(hash, bit_cast<u32>(key.x_scale));
+            return pair_int_hash(hash, bit_cast<u32>(key.y_scale));
+        }
+    };
+
+    struct Location {
+        size_t page_index;
+        Gfx::IntRect rect;
+    };
+
+    // Glyphs are placed left to right along shelves, each new shelf starting below the tallest glyph of the one above.
+    struct Page {
+        RefPtr<Gfx::Bitmap> bitmap;
+        Vector<Key> keys;
+        int shelf_x { 0 };
+        int shelf_y { 0 };
+        int shelf_height { 0 };
+        u64 last_used { 0 };
+    };
+
+    Optional<Location> allocate(Gfx::IntSize const&);
+    Optional<Gfx::IntRect> allocate_on_page(Page&, Gfx::IntSize const&);
+    bool empty_page(size_t page_index, Gfx::IntSize const& minimum_size);
+
+    HashMap<Key, Location, KeyTraits> m_locations;
+    Vector<Page> m_pages;
+    size_t m_current_page_index { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
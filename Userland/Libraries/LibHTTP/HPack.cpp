@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/StringBuilder.h>
+#include <AK/StringView.h>
+#include <LibHTTP/HPack.h>
+
+namespace HTTP::HPack {
+
+// RFC 7541 appendix A
+static constexpr struct {
+    StringView name;
+    StringView value;
+} s_static_table[] = {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+};
+
+static constexpr size_t StaticTableSize = sizeof(s_static_table) / sizeof(s_static_table[0]);
+
+// RFC 7541 appendix B, the code (right-aligned) and its length in bits for each octet, followed by EOS.
+static constexpr struct {
+    u32 code;
+    u8 length;
+} s_huffman_codes[257] = {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+};
+
+static constexpr u16 EndOfString = 256;
+
+// The codes as a binary tree, walked one bit at a time while decoding.
+struct HuffmanTree {
+    struct Node {
+        // Indices of the child nodes, or ~symbol for leaves. The root is never a child, so 0 means "none".
+        i16 children[2] { 0, 0 };
+    };
+    Vector<Node> nodes;
+
+    HuffmanTree()
+    {
+        nodes.append({});
+        for (u16 symbol = 0; symbol < 257; ++symbol) {
+            auto& code = s_huffman_codes[symbol];
+            size_t node = 0;
+            for (int bit_index = code.length - 1; bit_index >= 0; --bit_index) {
+                auto bit = (code.code >> bit_index) & 1;
+                if (bit_index == 0) {
+                    nodes[node].children[bit] = ~(i16)symbol;
+                    break;
+                }
+                if (nodes[node].children[bit] == 0) {
+                    nodes[node].children[bit] = nodes.size();
+                    nodes.append({});
+                }
+                node = nodes[node].children[bit];
+            }
+        }
+    }
+};
+
+static const HuffmanTree& huffman_tree()
+{
+    static HuffmanTree tree;
+    return tree;
+}
+
+static Optional<String> huffman_decode(ReadonlyBytes data)
+{
+    auto& nodes = huffman_tree().nodes;
+    StringBuilder builder(data.size() * 8 / 5);
+    size_t node = 0;
+    size_t bits_since_symbol = 0;
+    bool all_ones_since_symbol = true;
+    for (auto byte : data) {
+        for (int bit_index = 7; bit_index >= 0; --bit_index) {
+            auto bit = (byte >> bit_index) & 1;
+            auto next = nodes[node].children[bit];
+            ++bits_since_symbol;
+            all_ones_since_symbol &= bit;
+            if (next == 0)
+                return {};
+            if (next > 0) {
+                node = next;
+                continue;
+            }
+            auto symbol = (u16)~next;
+            // RFC 7541 section 5.2: A string literal containing EOS is a decoding error.
+            if (symbol == EndOfString)
+                return {};
+            builder.append((char)symbol);
+            node = 0;
+            bits_since_symbol = 0;
+            all_ones_since_symbol = true;
+        }
+    }
+    // Whatever is left over is padding: fewer than 8 bits, all of them set (the start of EOS).
+    if (bits_since_symbol >= 8 || !all_ones_since_symbol)
+        return {};
+    return builder.to_string();
+}
+
+static size_t huffman_encoded_length(StringView string)
+{
+    size_t bits = 0;
+    for (auto ch : string)
+        bits += s_huffman_codes[(u8)ch].length;
+    return (bits + 7) / 8;
+}
+
+static void huffman_encode(Vector<u8>& output, StringView string)
+{
+    u64 pending = 0;
+    size_t pending_bits = 0;
+    for (auto ch : string) {
+        auto& code = s_huffman_codes[(u8)ch];
+        pending = (pending << code.length) | code.code;
+        pending_bits += code.length;
+        while (pending_bits >= 8) {
+            pending_bits -= 8;
+            output.append((u8)(pending >> pending_bits));
+        }
+    }
+    if (pending_bits > 0)
+        output.append((u8)((pending << (8 - pending_bits)) | (0xff >> pending_bits)));
+}
+
+// RFC 7541 section 5.1: An integer fills the low bits of the first byte, and continues 7 bits at a time if it doesn't fit.
+static void encode_integer(Vector<u8>& output, u8 flags, u8 prefix_bits, size_t value)
+{
+    u8 prefix_max = (1 << prefix_bits) - 1;
+    if (value < prefix_max) {
+        output.append(flags | (u8)value);
+        return;
+    }
+    output.append(flags | prefix_max);
+    value -= prefix_max;
+    while (value >= 128) {
+        output.append((u8)(value % 128 + 128));
+        value /= 128;
+    }
+    output.append((u8)value);
+}
+
+static Optional<size_t> decode_integer(ReadonlyBytes data, size_t& offset, u8 prefix_bits)
+{
+    if (offset >= data.size())
+        return {};
+    u8 prefix_max = (1 << prefix_bits) - 1;
+    size_t value = data[offset++] & prefix_max;
+    if (value < prefix_max)
+        return value;
+    for (size_t shift = 0; offset < data.size(); shift += 7) {
+        // Nothing we deal with comes anywhere near this, so anything larger is garbage.
+        if (shift > 28)
+            return {};
+        auto byte = data[offset++];
+        value += (size_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    return {};
+}
+
+static void encode_string(Vector<u8>& output, StringView string)
+{
+    auto huffman_length = huffman_encoded_length(string);
+    if (huffman_length < string.length()) {
+        encode_integer(output, 0x80, 7, huffman_length);
+        huffman_encode(output, string);
+        return;
+    }
+    encode_integer(output, 0, 7, string.length());
+    output.append((const u8*)string.characters_without_null_termination(), string.length());
+}
+
+static Optional<String> decode_string(ReadonlyBytes data, size_t& offset)
+{
+    if (offset >= data.size())
+        return {};
+    bool is_huffman_encoded = data[offset] & 0x80;
+    auto length = decode_integer(data, offset, 7);
+    if (!length.has_value() || length.value() > data.size() - offset)
+        return {};
+    auto bytes = data.slice(offset, length.value());
+    offset += length.value();
+    if (is_huffman_encoded)
+        return huffman_decode(bytes);
+    return String { bytes };
+}
+
+void DynamicTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_until_fits(0);
+}
+
+void DynamicTable::add(HeaderField field)
+{
+    auto entry_size = field.name.length() + field.value.length() + EntryOverhead;
+    // RFC 7541 section 4.4: An entry larger than the table empties it, and is not added.
+    evict_until_fits(entry_size);
+    if (entry_size > m_max_size)
+        return;
+    m_entries.prepend(move(field));
+    m_size += entry_size;
+}
+
+void DynamicTable::evict_until_fits(size_t additional_size)
+{
+    while (!m_entries.is_empty() && m_size + additional_size > m_max_size) {
+        auto evicted = m_entries.take_last();
+        m_size -= evicted.name.length() + evicted.value.length() + EntryOverhead;
+    }
+}
+
+void Encoder::set_max_table_size(size_t size)
+{
+    // We never need more than the default, and the other side may not be able to take more anyway.
+    size = min(size, DynamicTable::DefaultMaxSize);
+    if (size == m_table.max_size())
+        return;
+    if (size < m_table.max_size())
+        m_pending_size_update = min(size, m_pending_size_update.value_or(size));
+    m_table.set_max_size(size);
+}
+
+Optional<Encoder::Match> Encoder::find(const HeaderField& field) const
+{
+    Optional<Match> name_match;
+    for (size_t i = 0; i < StaticTableSize; ++i) {
+        if (s_static_table[i].name != field.name)
+            continue;
+        if (s_static_table[i].value == field.value)
+            return Match { i + 1, true };
+        if (!name_match.has_value())
+            name_match = Match { i + 1, false };
+    }
+    for (size_t i = 0; i < m_table.entry_count(); ++i) {
+        auto& entry = m_table.entry(i);
+        if (entry.name != field.name)
+            continue;
+        if (entry.value == field.value)
+            return Match { StaticTableSize + 1 + i, true };
+        if (!name_match.has_value())
+            name_match = Match { StaticTableSize + 1 + i, false };
+    }
+    return name_match;
+}
+
+static bool is_sensitive(const String& name)
+{
+    // RFC 7541 section 7.1.3: Keep secrets out of the tables, where they could be probed for.
+    return name == "authorization" || name == "proxy-authorization" || name == "cookie";
+}
+
+ByteBuffer Encoder::encode(const Vector<HeaderField>& fields)
+{
+    Vector<u8> output;
+    if (m_pending_size_update.has_value()) {
+        // RFC 7541 section 4.2: Signal the smallest size first, then the final one if it grew back.
+        encode_integer(output, 0x20, 5, m_pending_size_update.value());
+        if (m_pending_size_update.value() != m_table.max_size())
+            encode_integer(output, 0x20, 5, m_table.max_size());
+        m_pending_size_update.clear();
+    }
+
+    for (auto& field : fields) {
+        auto match = find(field);
+        if (match.has_value() && match->value_matches) {
+            // Indexed header field
+            encode_integer(output, 0x80, 7, match->index);
+            continue;
+        }
+
+        auto name_index = match.has_value() ? match->index : 0;
+        if (is_sensitive(field.name)) {
+            // Literal header field never indexed
+            encode_integer(output, 0x10, 4, name_index);
+        } else {
+            // Literal header field with incremental indexing
+            encode_integer(output, 0x40, 6, name_index);
+        }
+        if (name_index == 0)
+            encode_string(output, field.name);
+        encode_string(output, field.value);
+
+        if (!is_sensitive(field.name))
+            m_table.add(field);
+    }
+    return ByteBuffer::copy(output.data(), output.size());
+}
+
+Optional<HeaderField> Decoder::field_at(size_t index) const
+{
+    if (index == 0)
+        return {};
+    if (index <= StaticTableSize)
+        return HeaderField { s_static_table[index - 1].name, s_static_table[index - 1].value };
+    index -= StaticTableSize + 1;
+    if (index >= m_table.entry_count())
+        return {};
+    return m_table.entry(index);
+}
+
+Optional<Vector<HeaderField>> Decoder::decode(ReadonlyBytes data)
+{
+    Vector<HeaderField> fields;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        auto byte = data[offset];
+
+        if (byte & 0x80) {
+            // Indexed header field
+            auto index = decode_integer(data, offset, 7);
+            if (!index.has_value())
+                return {};
+            auto field = field_at(index.value());
+            if (!field.has_value()) {
+                dbgln_if(HTTP2_DEBUG, "HPack: Invalid index {}", index.value());
+                return {};
+            }
+            fields.append(field.release_value());
+            continue;
+        }
+
+        if ((byte & 0xe0) == 0x20) {
+            // Dynamic table size update, only allowed ahead of the first field.
+            auto size = decode_integer(data, offset, 5);
+            if (!size.has_value() || size.value() > m_max_allowed_table_size || !fields.is_empty())
+                return {};
+            m_table.set_max_size(size.value());
+            continue;
+        }
+
+        bool add_to_table = (byte & 0xc0) == 0x40;
+        auto name_index = decode_integer(data, offset, add_to_table ? 6 : 4);
+        if (!name_index.has_value())
+            return {};
+
+        HeaderField field;
+        if (name_index.value() == 0) {
+            auto name = decode_string(data, offset);
+            if (!name.has_value())
+                return {};
+            field.name = name.release_value();
+        } else {
+            auto indexed_field = field_at(name_index.value());
+            if (!indexed_field.has_value())
+                return {};
+            field.name = move(indexed_field->name);
+        }
+        auto value = decode_string(data, offset);
+        if (!value.has_value())
+            return {};
+        field.value = value.release_value();
+
+        if (add_to_table)
+            m_table.add(field);
+        fields.append(move(field));
+    }
+    return fields;
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// HPACK, the header compression of HTTP/2 (RFC 7541).
+namespace HTTP::HPack {
+
+struct HeaderField {
+    String name;
+    String value;
+};
+
+// Recently sent header fields, which both sides keep in sync so later header blocks can refer to them by index.
+class DynamicTable {
+public:
+    // RFC 7541 section 4.1: The size of an entry is the size of its name and value plus 32 bytes of overhead.
+    static constexpr size_t EntryOverhead = 32;
+    static constexpr size_t DefaultMaxSize = 4096;
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    void set_max_size(size_t);
+
+    size_t entry_count() const { return m_entries.size(); }
+    // 0 is the most recently added entry.
+    const HeaderField& entry(size_t index) const { return m_entries[index]; }
+
+    void add(HeaderField);
+
+private:
+    void evict_until_fits(size_t);
+
+    // Most recently added first.
+    Vector<HeaderField> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { DefaultMaxSize };
+};
+
+class Encoder {
+public:
+    // The largest table the decoder on the other side will keep, as announced in its SETTINGS.
+    void set_max_table_size(size_t);
+
+    // Header names are expected to be in lowercase, as HTTP/2 requires.
+    ByteBuffer encode(const Vector<HeaderField>&);
+
+private:
+    struct Match {
+        size_t index { 0 };
+        bool value_matches { false };
+    };
+    Optional<Match> find(const HeaderField&) const;
+
+    DynamicTable m_table;
+    // The smallest size the table had to shrink to since the last header block, which has to be signalled first.
+    Optional<size_t> m_pending_size_update;
+};
+
+class Decoder {
+public:
+    // The largest table we let the encoder on the other side use, as announced in our SETTINGS.
+    void set_max_table_size(size_t size)
+    {
+        m_max_allowed_table_size = size;
+        if (m_table.max_size() > size)
+            m_table.set_max_size(size);
+    }
+
+    // Returns nothing if the block is malformed, which leaves the table out of sync, so it's a connection error.
+    Optional<Vector<HeaderField>> decode(ReadonlyBytes);
+
+private:
+    Optional<HeaderField> field_at(size_t index) const;
+
+    DynamicTable m_table;
+    size_t m_max_allowed_table_size { DynamicTable::DefaultMaxSize };
+};
+
+}
@@ -0,0 +1,718 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/Http2Connection.h>
+#include <LibHTTP/Job.h>
+
+namespace HTTP {
+
+static constexpr auto ConnectionPreface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv;
+static constexpr size_t FrameHeaderSize = 9;
+// The initial SETTINGS_MAX_FRAME_SIZE, which we never raise.
+static constexpr size_t MaxReceivedFrameSize = 16384;
+// Each write to the socket goes out as a single TLS record, which can't carry any more than this.
+static constexpr size_t MaxRecordSize = 16384;
+static constexpr i64 DefaultWindowSize = 65535;
+static constexpr i64 MaxWindowSize = 0x7fffffff;
+static constexpr u32 MaxStreamId = 0x7fffffff;
+// Large enough that a single stream on a fast connection isn't held back waiting for us to acknowledge data.
+static constexpr i64 StreamReceiveWindow = 1 * MiB;
+static constexpr i64 ConnectionReceiveWindow = 16 * MiB;
+// Until the server's SETTINGS say otherwise (RFC 7540 section 6.5.2 recommends at least this many).
+static constexpr u32 InitialMaxConcurrentStreams = 100;
+
+namespace Flags {
+static constexpr u8 EndStream = 0x1;
+static constexpr u8 Ack = 0x1;
+static constexpr u8 EndHeaders = 0x4;
+static constexpr u8 Padded = 0x8;
+static constexpr u8 Priority = 0x20;
+}
+
+enum class Setting : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return ((u32)bytes[0] << 24) | ((u32)bytes[1] << 16) | ((u32)bytes[2] << 8) | bytes[3];
+}
+
+static void append_u16(Vector<u8>& output, u16 value)
+{
+    output.append(value >> 8);
+    output.append(value);
+}
+
+static void append_u32(Vector<u8>& output, u32 value)
+{
+    append_u16(output, value >> 16);
+    append_u16(output, value);
+}
+
+static Optional<ReadonlyBytes> strip_padding(u8 flags, ReadonlyBytes payload)
+{
+    if (!(flags & Flags::Padded))
+        return payload;
+    if (payload.is_empty())
+        return {};
+    size_t padding = payload[0];
+    if (padding >= payload.size())
+        return {};
+    return payload.slice(1, payload.size() - 1 - padding);
+}
+
+// RFC 7540 section 8.1.2.2: These only make sense for a single hop of an HTTP/1.1 connection.
+static bool is_connection_specific_header(const String& name)
+{
+    return name == "connection" || name == "keep-alive" || name == "proxy-connection" || name == "transfer-encoding" || name == "upgrade" || name == "host";
+}
+
+Http2Connection::Http2Connection(NonnullRefPtr<TLS::TLSv12> socket)
+    : m_socket(move(socket))
+    , m_connection_send_window(DefaultWindowSize)
+    , m_connection_receive_window(ConnectionReceiveWindow)
+    , m_peer_max_concurrent_streams(InitialMaxConcurrentStreams)
+    , m_peer_initial_window_size(DefaultWindowSize)
+    , m_peer_max_frame_size(MaxReceivedFrameSize)
+{
+    VERIFY(m_socket->is_established());
+    add_child(*m_socket);
+
+    m_socket->on_tls_ready_to_read = [this](auto&) {
+        did_receive_data();
+    };
+    m_socket->on_tls_ready_to_write = nullptr;
+    m_socket->on_tls_error = [this](auto) {
+        NonnullRefPtr protect = *this;
+        disconnect();
+    };
+    m_socket->on_tls_finished = [this] {
+        NonnullRefPtr protect = *this;
+        disconnect();
+    };
+    m_socket->on_tls_certificate_request = nullptr;
+
+    // RFC 7540 section 3.5: The preface is followed by our SETTINGS, which may be all defaults but has to be there.
+    m_socket->write(ConnectionPreface.bytes());
+    Vector<u8> settings;
+    append_u16(settings, (u16)Setting::EnablePush);
+    append_u32(settings, 0);
+    append_u16(settings, (u16)Setting::InitialWindowSize);
+    append_u32(settings, StreamReceiveWindow);
+    send_frame(FrameType::Settings, 0, 0, settings.span());
+    // The connection's window can only be changed this way.
+    send_window_update(0, ConnectionReceiveWindow - DefaultWindowSize);
+
+    // The server may have sent its SETTINGS right behind the handshake.
+    if (m_socket->can_read()) {
+        deferred_invoke([this](auto&) {
+            if (m_is_open)
+                did_receive_data();
+        });
+    }
+}
+
+Http2Connection::~Http2Connection()
+{
+    on_can_start_stream = nullptr;
+    on_close = nullptr;
+    if (m_is_open) {
+        send_error_code(FrameType::GoAway, 0, ErrorCode::NoError);
+        disconnect();
+    }
+    // We may be going away from within one of the socket's own callbacks, so let go of it once that has returned.
+    m_socket->deferred_invoke([socket = m_socket](auto&) {});
+}
+
+bool Http2Connection::can_start_stream() const
+{
+    return m_is_open && !m_is_going_away && m_streams.size() < m_peer_max_concurrent_streams && m_next_stream_id <= MaxStreamId;
+}
+
+u32 Http2Connection::start_stream(Job& job)
+{
+    VERIFY(can_start_stream());
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+
+    auto& request = job.request();
+    auto& url = request.url();
+    auto authority = url.host();
+    if (url.port() != URL::default_port_for_scheme(url.protocol()))
+        authority = String::formatted("{}:{}", url.host(), url.port());
+
+    // RFC 7540 section 8.1.2.3: The request line is replaced by pseudo-header fields, which come first.
+    Vector<HPack::HeaderField> fields;
+    fields.append({ ":method", request.method_name() });
+    fields.append({ ":scheme", "https" });
+    fields.append({ ":authority", move(authority) });
+    fields.append({ ":path", request.request_target() });
+    for (auto& header : request.headers()) {
+        auto name = header.name.to_lowercase();
+        if (is_connection_specific_header(name))
+            continue;
+        fields.append({ move(name), header.value });
+    }
+    if (!request.body().is_empty())
+        fields.append({ "content-length", String::number(request.body().size()) });
+
+    auto stream = make<Stream>();
+    stream->job = job.make_weak_ptr<Job>();
+    stream->send_window = m_peer_initial_window_size;
+    stream->receive_window = StreamReceiveWindow;
+    stream->body = request.body();
+    stream->sent_end_stream = request.body().is_empty();
+    m_streams.set(stream_id, move(stream));
+
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Starting stream {} for {}", stream_id, url);
+
+    // Whatever doesn't fit into the HEADERS frame follows in CONTINUATION frames.
+    auto header_block = m_encoder.encode(fields);
+    auto remaining = header_block.bytes();
+    auto frame_type = FrameType::Headers;
+    do {
+        auto fragment = remaining.trim(max_frame_payload_size());
+        remaining = remaining.slice(fragment.size());
+        u8 flags = remaining.is_empty() ? Flags::EndHeaders : 0;
+        if (frame_type == FrameType::Headers && request.body().is_empty())
+            flags |= Flags::EndStream;
+        send_frame(frame_type, flags, stream_id, fragment);
+        frame_type = FrameType::Continuation;
+    } while (!remaining.is_empty());
+
+    send_pending_body(stream_id);
+    return stream_id;
+}
+
+void Http2Connection::cancel_stream(u32 stream_id)
+{
+    if (!m_streams.remove(stream_id))
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Cancelling stream {}", stream_id);
+    if (m_is_open)
+        send_error_code(FrameType::ResetStream, stream_id, ErrorCode::Cancel);
+    did_close_stream();
+}
+
+void Http2Connection::close()
+{
+    if (!m_is_open)
+        return;
+    if (!m_is_going_away) {
+        m_is_going_away = true;
+        send_error_code(FrameType::GoAway, 0, ErrorCode::NoError);
+    }
+    if (m_streams.is_empty())
+        disconnect();
+    notify_close();
+}
+
+void Http2Connection::did_receive_data()
+{
+    NonnullRefPtr protect = *this;
+    while (m_socket->can_read())
+        m_receive_buffer.append(m_socket->read(64 * KiB));
+
+    size_t offset = 0;
+    while (m_is_open && m_receive_buffer.size() - offset >= FrameHeaderSize) {
+        auto header = m_receive_buffer.bytes().slice(offset, FrameHeaderSize);
+        size_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+        if (length > MaxReceivedFrameSize) {
+            connection_error(ErrorCode::FrameSizeError);
+            return;
+        }
+        if (m_receive_buffer.size() - offset - FrameHeaderSize < length)
+            break;
+        auto type = (FrameType)header[3];
+        auto flags = header[4];
+        auto stream_id = read_u32(header.slice(5)) & MaxStreamId;
+        auto payload = m_receive_buffer.bytes().slice(offset + FrameHeaderSize, length);
+        offset += FrameHeaderSize + length;
+        handle_frame(type, flags, stream_id, payload);
+    }
+
+    if (!m_is_open)
+        m_receive_buffer.clear();
+    else if (offset > 0)
+        m_receive_buffer = m_receive_buffer.slice(offset, m_receive_buffer.size() - offset);
+}
+
+void Http2Connection::handle_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame of type {} with flags {:#x} on stream {}, {} bytes", (u8)type, flags, stream_id, payload.size());
+
+    // RFC 7540 section 3.5: The server's preface is a SETTINGS frame.
+    if (!m_received_settings && type != FrameType::Settings)
+        return connection_error(ErrorCode::ProtocolError);
+    // RFC 7540 section 6.10: Nothing may come between a header block's frames.
+    if (m_expecting_continuation && type != FrameType::Continuation)
+        return connection_error(ErrorCode::ProtocolError);
+
+    switch (type) {
+    case FrameType::Data:
+        return handle_data(flags, stream_id, payload);
+    case FrameType::Headers:
+        return handle_headers(flags, stream_id, payload);
+    case FrameType::ResetStream:
+        return handle_reset_stream(stream_id, payload);
+    case FrameType::Settings:
+        return handle_settings(flags, stream_id, payload);
+    case FrameType::PushPromise:
+        // We turned server push off in our SETTINGS.
+        return connection_error(ErrorCode::ProtocolError);
+    case FrameType::Ping:
+        return handle_ping(flags, stream_id, payload);
+    case FrameType::GoAway:
+        return handle_go_away(stream_id, payload);
+    case FrameType::WindowUpdate:
+        return handle_window_update(stream_id, payload);
+    case FrameType::Continuation:
+        return handle_continuation(flags, stream_id, payload);
+    case FrameType::Priority:
+    default:
+        // Priorities are only a hint, and unknown frame types must be ignored.
+        return;
+    }
+}
+
+void Http2Connection::handle_headers(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError);
+    auto fragment = strip_padding(flags, payload);
+    if (!fragment.has_value())
+        return connection_error(ErrorCode::ProtocolError);
+    if (flags & Flags::Priority) {
+        // Stream dependency and weight, which we don't care about.
+        if (fragment->size() < 5)
+            return connection_error(ErrorCode::FrameSizeError);
+        fragment = fragment->slice(5);
+    }
+
+    m_header_block = ByteBuffer::copy(fragment.value());
+    m_header_block_stream_id = stream_id;
+    m_header_block_ends_stream = flags & Flags::EndStream;
+    m_expecting_continuation = !(flags & Flags::EndHeaders);
+    if (!m_expecting_continuation)
+        finish_header_block();
+}
+
+void Http2Connection::handle_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (!m_expecting_continuation || stream_id != m_header_block_stream_id)
+        return connection_error(ErrorCode::ProtocolError);
+    m_header_block.append(payload);
+    m_expecting_continuation = !(flags & Flags::EndHeaders);
+    if (!m_expecting_continuation)
+        finish_header_block();
+}
+
+void Http2Connection::finish_header_block()
+{
+    // The block has to be decoded even if nobody wants it anymore, as it may change the decoder's table.
+    auto fields = m_decoder.decode(m_header_block);
+    m_header_block.clear();
+    if (!fields.has_value())
+        return connection_error(ErrorCode::CompressionError);
+
+    auto stream_id = m_header_block_stream_id;
+    auto* stream = find_stream(stream_id);
+    if (!stream)
+        return;
+
+    if (!stream->received_response_headers) {
+        Optional<u32> status_code;
+        HashMap<String, String, CaseInsensitiveStringTraits> headers;
+        for (auto& field : fields.value()) {
+            if (field.name == ":status") {
+                status_code = field.value.to_uint();
+                continue;
+            }
+            if (field.name.starts_with(':'))
+                continue;
+            if (auto existing = headers.get(field.name); existing.has_value())
+                headers.set(field.name, String::formatted("{}, {}", existing.value(), field.value));
+            else
+                headers.set(field.name, field.value);
+        }
+        if (!status_code.has_value())
+            return stream_error(stream_id, ErrorCode::ProtocolError);
+
+        // An informational response, the real one is still to come on the same stream.
+        if (status_code.value() < 200) {
+            if (m_header_block_ends_stream)
+                stream_error(stream_id, ErrorCode::ProtocolError);
+            return;
+        }
+
+        stream->received_response_headers = true;
+        if (auto job = stream->job; job && !job->is_cancelled())
+            job->did_receive_http2_headers(status_code.value(), move(headers));
+    }
+    // Otherwise, these were trailers, which nobody cares about.
+
+    if (m_header_block_ends_stream)
+        end_stream(stream_id);
+}
+
+void Http2Connection::handle_data(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError);
+
+    // Flow control covers the whole payload, padding included.
+    m_connection_receive_window -= payload.size();
+    if (m_connection_receive_window < 0)
+        return connection_error(ErrorCode::FlowControlError);
+    m_connection_unacknowledged_size += payload.size();
+    if (m_connection_unacknowledged_size >= ConnectionReceiveWindow / 2) {
+        send_window_update(0, m_connection_unacknowledged_size);
+        m_connection_receive_window += m_connection_unacknowledged_size;
+        m_connection_unacknowledged_size = 0;
+    }
+
+    auto data = strip_padding(flags, payload);
+    if (!data.has_value())
+        return connection_error(ErrorCode::ProtocolError);
+
+    auto* stream = find_stream(stream_id);
+    if (!stream) {
+        // The stream has been cancelled, and what's still in flight isn't interesting.
+        return;
+    }
+    if (!stream->received_response_headers)
+        return stream_error(stream_id, ErrorCode::ProtocolError);
+
+    stream->receive_window -= payload.size();
+    if (stream->receive_window < 0)
+        return stream_error(stream_id, ErrorCode::FlowControlError);
+    stream->unacknowledged_size += payload.size();
+    if (!(flags & Flags::EndStream) && stream->unacknowledged_size >= StreamReceiveWindow / 2) {
+        send_window_update(stream_id, stream->unacknowledged_size);
+        stream->receive_window += stream->unacknowledged_size;
+        stream->unacknowledged_size = 0;
+    }
+
+    if (auto job = stream->job; job && !job->is_cancelled() && !data->is_empty())
+        job->did_receive_http2_data(data.value());
+
+    if (flags & Flags::EndStream)
+        end_stream(stream_id);
+}
+
+void Http2Connection::handle_reset_stream(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError);
+    if (payload.size() != 4)
+        return connection_error(ErrorCode::FrameSizeError);
+
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server reset stream {} with error code {}", stream_id, read_u32(payload));
+    if (auto job = stream->job)
+        job->did_fail_http2_stream(Core::NetworkJob::Error::TransmissionFailed);
+    did_close_stream();
+}
+
+void Http2Connection::handle_settings(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError);
+    if (flags & Flags::Ack) {
+        if (!payload.is_empty())
+            connection_error(ErrorCode::FrameSizeError);
+        return;
+    }
+    if (payload.size() % 6 != 0)
+        return connection_error(ErrorCode::FrameSizeError);
+
+    auto could_start_stream = can_start_stream();
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto setting = (Setting)((payload[offset] << 8) | payload[offset + 1]);
+        auto value = read_u32(payload.slice(offset + 2));
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Setting {} = {}", (u16)setting, value);
+        switch (setting) {
+        case Setting::HeaderTableSize:
+            m_encoder.set_max_table_size(value);
+            break;
+        case Setting::MaxConcurrentStreams:
+            m_peer_max_concurrent_streams = value;
+            break;
+        case Setting::InitialWindowSize: {
+            if (value > MaxWindowSize)
+                return connection_error(ErrorCode::FlowControlError);
+            // RFC 7540 section 6.9.2: The change applies to the windows of every open stream.
+            i64 delta = (i64)value - (i64)m_peer_initial_window_size;
+            for (auto& it : m_streams)
+                it.value->send_window += delta;
+            m_peer_initial_window_size = value;
+            break;
+        }
+        case Setting::MaxFrameSize:
+            if (value < MaxReceivedFrameSize || value > 0xffffff)
+                return connection_error(ErrorCode::ProtocolError);
+            m_peer_max_frame_size = value;
+            break;
+        default:
+            break;
+        }
+    }
+    m_received_settings = true;
+    send_frame(FrameType::Settings, Flags::Ack, 0);
+
+    Vector<u32> stream_ids;
+    for (auto& it : m_streams)
+        stream_ids.append(it.key);
+    for (auto id : stream_ids)
+        send_pending_body(id);
+
+    if (!could_start_stream && can_start_stream() && on_can_start_stream)
+        on_can_start_stream();
+}
+
+void Http2Connection::handle_ping(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError);
+    if (payload.size() != 8)
+        return connection_error(ErrorCode::FrameSizeError);
+    if (!(flags & Flags::Ack))
+        send_frame(FrameType::Ping, Flags::Ack, 0, payload);
+}
+
+void Http2Connection::handle_go_away(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError);
+    if (payload.size() < 8)
+        return connection_error(ErrorCode::FrameSizeError);
+
+    auto last_stream_id = read_u32(payload) & MaxStreamId;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server is going away after stream {} with error code {}", last_stream_id, read_u32(payload.slice(4)));
+    m_is_going_away = true;
+
+    // Streams past the last one the server will process never got anywhere.
+    Vector<u32> abandoned_stream_ids;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            abandoned_stream_ids.append(it.key);
+    }
+    for (auto id : abandoned_stream_ids) {
+        auto stream = take_stream(id);
+        if (auto job = stream->job)
+            job->did_fail_http2_stream(Core::NetworkJob::Error::ConnectionFailed);
+    }
+
+    if (m_streams.is_empty())
+        disconnect();
+    notify_close();
+}
+
+void Http2Connection::handle_window_update(u32 stream_id, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return connection_error(ErrorCode::FrameSizeError);
+    i64 increment = read_u32(payload) & MaxWindowSize;
+
+    if (stream_id == 0) {
+        if (increment == 0)
+            return connection_error(ErrorCode::ProtocolError);
+        m_connection_send_window += increment;
+        if (m_connection_send_window > MaxWindowSize)
+            return connection_error(ErrorCode::FlowControlError);
+        Vector<u32> stream_ids;
+        for (auto& it : m_streams)
+            stream_ids.append(it.key);
+        for (auto id : stream_ids)
+            send_pending_body(id);
+        return;
+    }
+
+    auto* stream = find_stream(stream_id);
+    if (!stream)
+        return;
+    if (increment == 0)
+        return stream_error(stream_id, ErrorCode::ProtocolError);
+    stream->send_window += increment;
+    if (stream->send_window > MaxWindowSize)
+        return stream_error(stream_id, ErrorCode::FlowControlError);
+    send_pending_body(stream_id);
+}
+
+size_t Http2Connection::max_frame_payload_size() const
+{
+    return min<size_t>(m_peer_max_frame_size, MaxRecordSize - FrameHeaderSize);
+}
+
+void Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    VERIFY(payload.size() <= max_frame_payload_size());
+    auto frame = ByteBuffer::create_uninitialized(FrameHeaderSize + payload.size());
+    frame[0] = payload.size() >> 16;
+    frame[1] = payload.size() >> 8;
+    frame[2] = payload.size();
+    frame[3] = (u8)type;
+    frame[4] = flags;
+    frame[5] = stream_id >> 24;
+    frame[6] = stream_id >> 16;
+    frame[7] = stream_id >> 8;
+    frame[8] = stream_id;
+    if (!payload.is_empty())
+        memcpy(frame.offset_pointer(FrameHeaderSize), payload.data(), payload.size());
+    m_socket->write(frame);
+}
+
+void Http2Connection::send_error_code(FrameType type, u32 stream_id, ErrorCode error_code)
+{
+    Vector<u8> payload;
+    if (type == FrameType::GoAway) {
+        // We never accept streams from the server, so there's none it could have started that we've processed.
+        append_u32(payload, 0);
+    }
+    append_u32(payload, (u32)error_code);
+    send_frame(type, 0, stream_id, payload.span());
+}
+
+void Http2Connection::send_window_update(u32 stream_id, u32 increment)
+{
+    Vector<u8> payload;
+    append_u32(payload, increment);
+    send_frame(FrameType::WindowUpdate, 0, stream_id, payload.span());
+}
+
+void Http2Connection::send_pending_body(u32 stream_id)
+{
+    auto* stream = find_stream(stream_id);
+    if (!stream || stream->sent_end_stream)
+        return;
+
+    while (!stream->sent_end_stream) {
+        auto window = min(m_connection_send_window, stream->send_window);
+        if (window <= 0)
+            return;
+        auto remaining = stream->body.size() - stream->sent_body_size;
+        auto size = min(min(remaining, (size_t)window), max_frame_payload_size());
+        bool is_last = size == remaining;
+        send_frame(FrameType::Data, is_last ? Flags::EndStream : 0, stream_id, stream->body.bytes().slice(stream->sent_body_size, size));
+        stream->sent_body_size += size;
+        stream->send_window -= size;
+        m_connection_send_window -= size;
+        if (is_last) {
+            stream->sent_end_stream = true;
+            stream->body.clear();
+        }
+    }
+}
+
+Http2Connection::Stream* Http2Connection::find_stream(u32 stream_id)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return nullptr;
+    return it->value.ptr();
+}
+
+OwnPtr<Http2Connection::Stream> Http2Connection::take_stream(u32 stream_id)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return {};
+    OwnPtr<Stream> stream = move(it->value);
+    m_streams.remove(it);
+    return stream;
+}
+
+void Http2Connection::end_stream(u32 stream_id)
+{
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} has ended", stream_id);
+    // RFC 7540 section 8.1: The server may answer before it has seen the whole request body, which it then doesn't want.
+    if (!stream->sent_end_stream)
+        send_error_code(FrameType::ResetStream, stream_id, ErrorCode::NoError);
+    if (auto job = stream->job; job && !job->is_cancelled())
+        job->did_end_http2_stream();
+    did_close_stream();
+}
+
+void Http2Connection::stream_error(u32 stream_id, ErrorCode error_code)
+{
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Error {} on stream {}", (u32)error_code, stream_id);
+    send_error_code(FrameType::ResetStream, stream_id, error_code);
+    if (auto job = stream->job)
+        job->did_fail_http2_stream(Core::NetworkJob::Error::ProtocolFailed);
+    did_close_stream();
+}
+
+void Http2Connection::did_close_stream()
+{
+    if (m_is_going_away) {
+        if (m_streams.is_empty())
+            disconnect();
+        return;
+    }
+    // Don't start another stream from within the one that just closed.
+    deferred_invoke([this](auto&) {
+        if (can_start_stream() && on_can_start_stream)
+            on_can_start_stream();
+    });
+}
+
+void Http2Connection::connection_error(ErrorCode error_code)
+{
+    if (!m_is_open)
+        return;
+    dbgln("Http2Connection: Connection error {}", (u32)error_code);
+    send_error_code(FrameType::GoAway, 0, error_code);
+    disconnect();
+}
+
+void Http2Connection::disconnect()
+{
+    if (!m_is_open)
+        return;
+    m_is_open = false;
+    m_socket->on_tls_ready_to_read = nullptr;
+    m_socket->on_tls_error = nullptr;
+    m_socket->on_tls_finished = nullptr;
+    // Whatever we've just written, like a GOAWAY, only goes out once the socket gets back to the event loop.
+    m_socket->deferred_invoke([](auto& socket) {
+        static_cast<TLS::TLSv12&>(socket).close();
+    });
+
+    auto streams = move(m_streams);
+    for (auto& it : streams) {
+        if (auto job = it.value->job)
+            job->did_fail_http2_stream(Core::NetworkJob::Error::TransmissionFailed);
+    }
+    notify_close();
+}
+
+void Http2Connection::notify_close()
+{
+    if (m_has_notified_close)
+        return;
+    m_has_notified_close = true;
+    if (on_close)
+        on_close();
+}
+
+}
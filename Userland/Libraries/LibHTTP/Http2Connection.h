@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/WeakPtr.h>
+#include <LibCore/Object.h>
+#include <LibHTTP/Forward.h>
+#include <LibHTTP/HPack.h>
+#include <LibTLS/TLSv12.h>
+
+namespace HTTP {
+
+// An HTTP/2 connection (RFC 7540) over TLS, which carries the requests of many jobs at once, each on its own stream.
+class Http2Connection final : public Core::Object {
+    C_OBJECT(Http2Connection)
+public:
+    // The protocol ID to offer during the TLS handshake (RFC 7301).
+    static constexpr StringView ProtocolId = "h2"sv;
+
+    virtual ~Http2Connection() override;
+
+    bool is_open() const { return m_is_open; }
+    // Whether start_stream() can be called right now.
+    bool can_start_stream() const;
+    size_t stream_count() const { return m_streams.size(); }
+
+    // Sends the job's request on a new stream, and passes the response on to the job as it arrives.
+    u32 start_stream(Job&);
+    // Drops a stream whose job has lost interest in it, unless it has already ended.
+    void cancel_stream(u32 stream_id);
+    // Tells the server that we're done with the connection, and closes it once the remaining streams have ended.
+    void close();
+
+    // Called when a stream has ended or the server now allows more of them, so another one may be started.
+    Function<void()> on_can_start_stream;
+    // Called once the connection can't carry any new streams, because it was closed or the server is going away.
+    Function<void()> on_close;
+
+private:
+    explicit Http2Connection(NonnullRefPtr<TLS::TLSv12>);
+
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        ResetStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    enum class ErrorCode : u32 {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeout = 0x4,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+    };
+
+    struct Stream {
+        WeakPtr<Job> job;
+        i64 send_window { 0 };
+        i64 receive_window { 0 };
+        // Received since we last told the server it may send more.
+        size_t unacknowledged_size { 0 };
+        ByteBuffer body;
+        size_t sent_body_size { 0 };
+        bool sent_end_stream { false };
+        bool received_response_headers { false };
+    };
+
+    void did_receive_data();
+    void handle_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_headers(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void finish_header_block();
+    void handle_data(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_reset_stream(u32 stream_id, ReadonlyBytes payload);
+    void handle_settings(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_ping(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_go_away(u32 stream_id, ReadonlyBytes payload);
+    void handle_window_update(u32 stream_id, ReadonlyBytes payload);
+
+    size_t max_frame_payload_size() const;
+    void send_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload = {});
+    void send_error_code(FrameType, u32 stream_id, ErrorCode);
+    void send_window_update(u32 stream_id, u32 increment);
+    void send_pending_body(u32 stream_id);
+
+    Stream* find_stream(u32 stream_id);
+    OwnPtr<Stream> take_stream(u32 stream_id);
+    void end_stream(u32 stream_id);
+    void stream_error(u32 stream_id, ErrorCode);
+    void did_close_stream();
+
+    void connection_error(ErrorCode);
+    void disconnect();
+    void notify_close();
+
+    NonnullRefPtr<TLS::TLSv12> m_socket;
+    bool m_is_open { true };
+    bool m_is_going_away { false };
+    bool m_has_notified_close { false };
+    bool m_received_settings { false };
+
+    HashMap<u32, NonnullOwnPtr<Stream>> m_streams;
+    u32 m_next_stream_id { 1 };
+
+    ByteBuffer m_receive_buffer;
+    // A header block may be split over a HEADERS frame and any number of CONTINUATION frames.
+    ByteBuffer m_header_block;
+    u32 m_header_block_stream_id { 0 };
+    bool m_header_block_ends_stream { false };
+    bool m_expecting_continuation { false };
+
+    HPack::Encoder m_encoder;
+    HPack::Decoder m_decoder;
+
+    i64 m_connection_send_window { 0 };
+    i64 m_connection_receive_window { 0 };
+    size_t m_connection_unacknowledged_size { 0 };
+
+    // From the server's SETTINGS.
+    u32 m_peer_max_concurrent_streams { 0 };
+    u32 m_peer_initial_window_size { 0 };
+    u32 m_peer_max_frame_size { 0 };
+};
+
+}
@@ -20,6 +20,11 @@ void HttpJob::start()
         dbgln_if(CHTTPJOB_DEBUG, "HttpJob: on_connected callback");
         on_socket_connected();
     };
+    m_socket->on_connection_failed = [this] {
+        deferred_invoke([this](auto&) {
+            return did_fail(Core::NetworkJob::Error::ConnectionFailed);
+        });
+    };
     bool success = m_socket->connect(m_request.url().host(), m_request.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
@@ -28,6 +33,15 @@ void HttpJob::start()
     }
 }
 
+void HttpJob::start(NonnullRefPtr<Core::Socket> socket)
+{
+    VERIFY(!m_socket);
+    VERIFY(socket->is_connected());
+    m_socket = move(socket);
+    add_child(*m_socket);
+    on_socket_connected();
+}
+
 void HttpJob::shutdown()
 {
     if (!m_socket)
@@ -35,7 +49,12 @@ void HttpJob::shutdown()
     m_socket->on_ready_to_read = nullptr;
     m_socket->on_connected = nullptr;
     remove_child(*m_socket);
-    m_socket = nullptr;
+    RefPtr<Core::Socket> socket = move(m_socket);
+    // Whatever is left to read would be mistaken for the start of the next response.
+    if (!can_reuse_connection() || !socket->is_connected() || socket->can_read())
+        socket = nullptr;
+    if (on_connection_released)
+        on_connection_released(move(socket));
 }
 
 void HttpJob::register_on_ready_to_read(Function<void()> callback)
@@ -30,6 +30,13 @@ public:
     virtual void start() override;
     virtual void shutdown() override;
 
+    // Sends the request over a socket that is already connected to the request's origin.
+    void start(NonnullRefPtr<Core::Socket>);
+
+    // Called from shutdown() once the job is done with its socket. The socket is only passed
+    // along if it can carry another request, see can_reuse_connection().
+    Function<void(RefPtr<Core::Socket>)> on_connection_released;
+
 protected:
     virtual bool should_fail_on_empty_payload() const override { return false; }
     virtual void register_on_ready_to_read(Function<void()>) override;
@@ -33,11 +33,9 @@ String HttpRequest::method_name() const
     }
 }
 
-ByteBuffer HttpRequest::to_raw_request() const
+String HttpRequest::request_target() const
 {
     StringBuilder builder;
-    builder.append(method_name());
-    builder.append(' ');
     // NOTE: The percent_encode is so that e.g. spaces are properly encoded.
     auto path = m_url.path();
     VERIFY(!path.is_empty());
@@ -46,6 +44,15 @@ ByteBuffer HttpRequest::to_raw_request() const
         builder.append('?');
         builder.append(URL::percent_encode(m_url.query(), URL::PercentEncodeSet::EncodeURI));
     }
+    return builder.to_string();
+}
+
+ByteBuffer HttpRequest::to_raw_request() const
+{
+    StringBuilder builder;
+    builder.append(method_name());
+    builder.append(' ');
+    builder.append(request_target());
     builder.append(" HTTP/1.1\r\nHost: ");
     builder.append(m_url.host());
     builder.append("\r\n");
@@ -55,7 +62,7 @@ ByteBuffer HttpRequest::to_raw_request() const
         builder.append(header.value);
         builder.append("\r\n");
     }
-    builder.append("Connection: close\r\n");
+    builder.append(m_keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
     if (!m_body.is_empty()) {
         builder.appendff("Content-Length: {}\r\n\r\n", m_body.size());
         builder.append((char const*)m_body.data(), m_body.size());
@@ -167,6 +174,17 @@ Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
     request.m_resource = URL::percent_decode(resource);
     request.m_headers = move(headers);
 
+    // HTTP/1.1 connections stay open unless the client says otherwise, HTTP/1.0 ones only if it asks for it.
+    request.m_keep_alive = protocol == "HTTP/1.1";
+    for (auto& header : request.m_headers) {
+        if (!header.name.equals_ignoring_case("Connection"))
+            continue;
+        if (header.value.equals_ignoring_case("close"))
+            request.m_keep_alive = false;
+        else if (header.value.equals_ignoring_case("keep-alive"))
+            request.m_keep_alive = true;
+    }
+
     return request;
 }
 
@@ -50,7 +50,13 @@ public:
     void set_body(ReadonlyBytes body) { m_body = ByteBuffer::copy(body); }
     void set_body(ByteBuffer&& body) { m_body = move(body); }
 
+    // Asks the server to leave the connection open after the response, so it can carry another request.
+    bool keep_alive() const { return m_keep_alive; }
+    void set_keep_alive(bool keep_alive) { m_keep_alive = keep_alive; }
+
     String method_name() const;
+    // The path and query of the URL, as they go into the request line.
+    String request_target() const;
     ByteBuffer to_raw_request() const;
 
     void set_headers(HashMap<String, String> const&);
@@ -65,6 +71,7 @@ private:
     Method m_method { GET };
     Vector<Header> m_headers;
     ByteBuffer m_body;
+    bool m_keep_alive { false };
 };
 
 }
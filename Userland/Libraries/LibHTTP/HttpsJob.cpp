@@ -19,10 +19,77 @@ void HttpsJob::start()
     VERIFY(!m_socket);
     m_socket = TLS::TLSv12::construct(this);
     m_socket->set_root_certificates(m_override_ca_certificates ? *m_override_ca_certificates : DefaultRootCACertificates::the().certificates());
+    m_socket->set_session_cache(m_session_cache);
+    m_socket->add_alpn(Http2Connection::ProtocolId);
+    m_socket->add_alpn("http/1.1");
     m_socket->on_tls_connected = [this] {
         dbgln_if(HTTPSJOB_DEBUG, "HttpsJob: on_connected callback");
-        on_socket_connected();
+        // The handshake only starts now, and the socket is first ready to write once it's done.
+        m_socket->on_tls_ready_to_write = [this](auto&) {
+            // Whoever takes over the socket will replace this callback, which can't happen while it runs.
+            m_socket->on_tls_ready_to_write = nullptr;
+            deferred_invoke([this](auto&) {
+                did_finish_handshake();
+            });
+        };
     };
+    register_socket_callbacks();
+    m_socket->on_connection_failed = [this] {
+        deferred_invoke([this](auto&) {
+            return did_fail(Core::NetworkJob::Error::ConnectionFailed);
+        });
+    };
+    bool success = ((TLS::TLSv12&)*m_socket).connect(m_request.url().host(), m_request.url().port());
+    if (!success) {
+        deferred_invoke([this](auto&) {
+            return did_fail(Core::NetworkJob::Error::ConnectionFailed);
+        });
+    }
+}
+
+void HttpsJob::start(NonnullRefPtr<TLS::TLSv12> socket)
+{
+    VERIFY(!m_socket);
+    VERIFY(socket->is_established());
+    m_socket = move(socket);
+    add_child(*m_socket);
+    register_socket_callbacks();
+    on_socket_connected();
+    // The handshake is long done, so TLS won't tell us that it's ready to write anymore.
+    send_request();
+}
+
+void HttpsJob::start(NonnullRefPtr<Http2Connection> connection)
+{
+    VERIFY(!m_socket && !m_http2_connection);
+    m_http2_connection = move(connection);
+    m_http2_stream_id = m_http2_connection->start_stream(*this);
+}
+
+void HttpsJob::did_finish_handshake()
+{
+    if (!m_socket || is_cancelled())
+        return;
+    dbgln_if(HTTPSJOB_DEBUG, "HttpsJob: Handshake done, negotiated protocol '{}'", m_socket->alpn());
+    if (m_socket->alpn() != Http2Connection::ProtocolId) {
+        on_socket_connected();
+        send_request();
+        if (on_protocol_negotiated)
+            on_protocol_negotiated(nullptr);
+        return;
+    }
+
+    // From here on the socket belongs to the HTTP/2 connection.
+    m_socket->on_tls_connected = nullptr;
+    remove_child(*m_socket);
+    auto connection = Http2Connection::construct(m_socket.release_nonnull());
+    start(connection);
+    if (on_protocol_negotiated)
+        on_protocol_negotiated(move(connection));
+}
+
+void HttpsJob::register_socket_callbacks()
+{
     m_socket->on_tls_error = [&](TLS::AlertDescription error) {
         if (error == TLS::AlertDescription::HandshakeFailure) {
             deferred_invoke([this](auto&) {
@@ -46,26 +113,38 @@ void HttpsJob::start()
         if (on_certificate_requested)
             on_certificate_requested(*this);
     };
-    bool success = ((TLS::TLSv12&)*m_socket).connect(m_request.url().host(), m_request.url().port());
-    if (!success) {
-        deferred_invoke([this](auto&) {
-            return did_fail(Core::NetworkJob::Error::ConnectionFailed);
-        });
-    }
 }
 
 void HttpsJob::shutdown()
 {
+    if (m_http2_connection) {
+        m_http2_connection->cancel_stream(m_http2_stream_id);
+        m_http2_connection = nullptr;
+        return;
+    }
     if (!m_socket)
         return;
     m_socket->on_tls_ready_to_read = nullptr;
+    m_socket->on_tls_ready_to_write = nullptr;
     m_socket->on_tls_connected = nullptr;
+    m_socket->on_tls_error = nullptr;
+    m_socket->on_tls_finished = nullptr;
+    m_socket->on_tls_certificate_request = nullptr;
     remove_child(*m_socket);
-    m_socket = nullptr;
+    RefPtr<TLS::TLSv12> socket = move(m_socket);
+    // Whatever is left to read would be mistaken for the start of the next response.
+    if (!can_reuse_connection() || !socket->is_established() || socket->can_read())
+        socket = nullptr;
+    if (on_connection_released)
+        on_connection_released(move(socket));
 }
 
 void HttpsJob::set_certificate(String certificate, String private_key)
 {
+    if (!m_socket) {
+        dbgln("LibHTTP: Can't set a client certificate for a job without its own connection");
+        return;
+    }
     if (!m_socket->add_client_key(certificate.bytes(), private_key.bytes())) {
         dbgln("LibHTTP: Failed to set a client certificate");
         // FIXME: Do something about this failure
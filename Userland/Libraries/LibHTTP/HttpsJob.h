@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <LibHTTP/Job.h>
@@ -31,6 +32,21 @@ public:
     virtual void start() override;
     virtual void shutdown() override;
     void set_certificate(String certificate, String key);
+    void set_session_cache(RefPtr<TLS::SessionCache> cache) { m_session_cache = move(cache); }
+
+    // Sends the request over a TLS connection to the request's origin that has already finished its handshake.
+    void start(NonnullRefPtr<TLS::TLSv12>);
+    // Sends the request as a new stream on an HTTP/2 connection to the request's origin.
+    void start(NonnullRefPtr<Http2Connection>);
+
+    // Called once the handshake of a connection made by start() is done. If the server agreed to speak HTTP/2,
+    // the job is already running on the new HTTP/2 connection, which is passed along so it can carry other jobs too.
+    // Such a job doesn't call on_connection_released.
+    Function<void(RefPtr<Http2Connection>)> on_protocol_negotiated;
+
+    // Called from shutdown() once the job is done with its socket. The socket is only passed
+    // along if it can carry another request, see can_reuse_connection().
+    Function<void(RefPtr<TLS::TLSv12>)> on_connection_released;
 
     Function<void(HttpsJob&)> on_certificate_requested;
 
@@ -48,8 +64,14 @@ protected:
     virtual void read_while_data_available(Function<IterationDecision()>) override;
 
 private:
+    void register_socket_callbacks();
+    void did_finish_handshake();
+
     RefPtr<TLS::TLSv12> m_socket;
+    RefPtr<Http2Connection> m_http2_connection;
+    u32 m_http2_stream_id { 0 };
     const Vector<Certificate>* m_override_ca_certificates { nullptr };
+    RefPtr<TLS::SessionCache> m_session_cache;
 };
 
 }
@@ -7,6 +7,7 @@
 #include <AK/Debug.h>
 #include <LibCompress/Gzip.h>
 #include <LibCompress/Zlib.h>
+#include <LibCompress/Zstd.h>
 #include <LibCore/Event.h>
 #include <LibCore/TCPSocket.h>
 #include <LibHTTP/HttpResponse.h>
@@ -65,6 +66,21 @@ static ByteBuffer handle_content_encoding(const ByteBuffer& buf, const String& c
             dbgln("  Output size: {}", uncompressed.value().size());
         }
 
+        return uncompressed.value();
+    } else if (content_encoding == "zstd") {
+        // https://datatracker.ietf.org/doc/html/rfc8878#section-7.2
+        auto uncompressed = Compress::ZstdDecompressor::decompress_all(buf);
+        if (!uncompressed.has_value()) {
+            dbgln("Job::handle_content_encoding: ZstdDecompressor::decompress_all() failed. Returning original buffer.");
+            return buf;
+        }
+
+        if constexpr (JOB_DEBUG) {
+            dbgln("Job::handle_content_encoding: Zstd decompression successful.");
+            dbgln("  Input size: {}", buf.size());
+            dbgln("  Output size: {}", uncompressed.value().size());
+        }
+
         return uncompressed.value();
     }
 
@@ -89,6 +105,8 @@ void Job::flush_received_buffers()
     for (size_t i = 0; i < m_received_buffers.size(); ++i) {
         auto& payload = m_received_buffers[i];
         auto written = do_write(payload);
+        if (on_body_data && written > 0)
+            on_body_data(payload.bytes().trim(written));
         m_buffered_size -= written;
         if (written == payload.size()) {
             // FIXME: Make this a take-first-friendly object?
@@ -103,249 +121,357 @@ void Job::flush_received_buffers()
     dbgln_if(JOB_DEBUG, "Job: Flushing received buffers done: have {} bytes in {} buffers", m_buffered_size, m_received_buffers.size());
 }
 
-void Job::on_socket_connected()
+void Job::send_request()
 {
-    register_on_ready_to_write([&] {
-        if (m_sent_data)
-            return;
-        m_sent_data = true;
-        auto raw_request = m_request.to_raw_request();
+    if (m_sent_data)
+        return;
+    m_sent_data = true;
+    auto raw_request = m_request.to_raw_request();
 
-        if constexpr (JOB_DEBUG) {
-            dbgln("Job: raw_request:");
-            dbgln("{}", String::copy(raw_request));
-        }
+    if constexpr (JOB_DEBUG) {
+        dbgln("Job: raw_request:");
+        dbgln("{}", String::copy(raw_request));
+    }
+
+    bool success = write(raw_request);
+    if (!success)
+        deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+}
+
+bool Job::response_allows_keep_alive() const
+{
+    if (!m_request.keep_alive() || !m_is_http_1_1)
+        return false;
+
+    auto connection = m_headers.get("Connection");
+    if (connection.has_value() && connection.value().contains("close", CaseSensitivity::CaseInsensitive))
+        return false;
+
+    // The connection can only carry another response if we can tell where this one ends
+    // without waiting for the server to close it.
+    auto transfer_encoding = m_headers.get("Transfer-Encoding");
+    if (transfer_encoding.has_value())
+        return transfer_encoding.value().trim_whitespace().equals_ignoring_case("chunked");
+    if (has_empty_body())
+        return true;
+    auto content_length = m_headers.get("Content-Length");
+    return content_length.has_value() && content_length.value().to_uint().has_value();
+}
+
+bool Job::has_empty_body() const
+{
+    if (m_code == 204 || m_code == 304)
+        return true;
+    if (m_headers.contains("Transfer-Encoding"))
+        return false;
+    auto content_length = m_headers.get("Content-Length");
+    if (!content_length.has_value())
+        return false;
+    auto length = content_length.value().to_uint();
+    return length.has_value() && length.value() == 0;
+}
+
+bool Job::expects_more_body() const
+{
+    if (m_current_chunk_remaining_size.has_value())
+        return m_state == State::InBody;
+    auto length = content_length();
+    return length.has_value() && m_received_size < length.value();
+}
+
+Optional<u32> Job::content_length() const
+{
+    auto content_length = m_headers.get("Content-Length");
+    if (!content_length.has_value())
+        return {};
+    return content_length.value().to_uint();
+}
+
+void Job::did_receive_http2_headers(u32 status_code, HashMap<String, String, CaseInsensitiveStringTraits>&& headers)
+{
+    m_code = status_code;
+    m_headers = move(headers);
+    if (m_headers.contains("Content-Encoding")) {
+        // Same as over HTTP/1.1, we can't decode it as a stream :(
+        m_can_stream_response = false;
+    }
+    if (on_headers_received)
+        on_headers_received(m_headers, m_code);
+    m_state = State::InBody;
+}
+
+void Job::did_receive_http2_data(ReadonlyBytes data)
+{
+    VERIFY(m_state == State::InBody);
+    m_received_buffers.append(ByteBuffer::copy(data));
+    m_buffered_size += data.size();
+    m_received_size += data.size();
+    flush_received_buffers();
+
+    deferred_invoke([this, content_length = content_length()](auto&) { did_progress(content_length, m_received_size); });
+}
+
+void Job::did_end_http2_stream()
+{
+    VERIFY(m_state == State::InBody);
+    m_body_was_cut_short = expects_more_body();
+    finish_up();
+}
+
+void Job::did_fail_http2_stream(Core::NetworkJob::Error error)
+{
+    deferred_invoke([this, error](auto&) { did_fail(error); });
+}
 
-        bool success = write(raw_request);
-        if (!success)
-            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+void Job::on_socket_connected()
+{
+    register_on_ready_to_write([&] {
+        send_request();
     });
     register_on_ready_to_read([&] {
-        if (is_cancelled())
-            return;
-
-        if (m_state == State::Finished) {
-            // We have everything we want, at this point, we can either get an EOF, or a bunch of extra newlines
-            // (unless "Connection: close" isn't specified)
-            // So just ignore everything after this.
-            return;
-        }
-
-        if (m_state == State::InStatus) {
-            if (!can_read_line())
+        // With a kept-alive connection the server doesn't close the socket after the response, so we won't
+        // be notified again for data that has already been read off it. Keep going for as long as we can.
+        for (;;) {
+            if (is_cancelled())
                 return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                warnln("Job: Expected HTTP status");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-            auto parts = line.split_view(' ');
-            if (parts.size() < 3) {
-                warnln("Job: Expected 3-part HTTP status, got '{}'", line);
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto code = parts[1].to_uint();
-            if (!code.has_value()) {
-                warnln("Job: Expected numeric HTTP status");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            m_code = code.value();
-            m_state = State::InHeaders;
-            return;
-        }
-        if (m_state == State::InHeaders || m_state == State::Trailers) {
-            if (!can_read_line())
+
+            if (m_state == State::Finished) {
+                // We have everything we want, at this point, we can either get an EOF, or a bunch of extra newlines
+                // (unless "Connection: close" isn't specified)
+                // So just ignore everything after this.
                 return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                warnln("Job: Expected HTTP header");
-                return did_fail(Core::NetworkJob::Error::ProtocolFailed);
             }
-            if (line.is_empty()) {
-                if (m_state == State::Trailers) {
-                    return finish_up();
-                } else {
-                    if (on_headers_received)
-                        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
-                    m_state = State::InBody;
+
+            if (m_state == State::InStatus) {
+                if (!can_read_line())
+                    return;
+                auto line = read_line(PAGE_SIZE);
+                if (line.is_null()) {
+                    warnln("Job: Expected HTTP status");
+                    return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
                 }
-                return;
-            }
-            auto parts = line.split_view(':');
-            if (parts.is_empty()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
+                auto parts = line.split_view(' ');
+                if (parts.size() < 3) {
+                    warnln("Job: Expected 3-part HTTP status, got '{}'", line);
+                    return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
                 }
-                warnln("Job: Expected HTTP header with key/value");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto name = parts[0];
-            if (line.length() < name.length() + 2) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
+                auto code = parts[1].to_uint();
+                if (!code.has_value()) {
+                    warnln("Job: Expected numeric HTTP status");
+                    return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
                 }
-                warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            m_headers.set(name, value);
-            if (name.equals_ignoring_case("Content-Encoding")) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
+                m_code = code.value();
+                m_is_http_1_1 = parts[0] == "HTTP/1.1";
+                m_state = State::InHeaders;
+                continue;
             }
-            dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
-            return;
-        }
-        VERIFY(m_state == State::InBody);
-        VERIFY(can_read());
-
-        read_while_data_available([&] {
-            auto read_size = 64 * KiB;
-            if (m_current_chunk_remaining_size.has_value()) {
-            read_chunk_size:;
-                auto remaining = m_current_chunk_remaining_size.value();
-                if (remaining == -1) {
-                    // read size
-                    auto size_data = read_line(PAGE_SIZE);
-                    if (m_should_read_chunk_ending_line) {
-                        VERIFY(size_data.is_empty());
-                        m_should_read_chunk_ending_line = false;
-                        return IterationDecision::Continue;
+            if (m_state == State::InHeaders || m_state == State::Trailers) {
+                if (!can_read_line())
+                    return;
+                auto line = read_line(PAGE_SIZE);
+                if (line.is_null()) {
+                    if (m_state == State::Trailers) {
+                        // Some servers like to send two ending chunks
+                        // use this fact as an excuse to ignore anything after the last chunk
+                        // that is not a valid trailing header.
+                        m_can_reuse_connection = false;
+                        return finish_up();
                     }
-                    auto size_lines = size_data.view().lines();
-                    dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_data);
-                    if (size_lines.size() == 0) {
-                        dbgln("Job: Reached end of stream");
-                        finish_up();
-                        return IterationDecision::Break;
+                    warnln("Job: Expected HTTP header");
+                    return did_fail(Core::NetworkJob::Error::ProtocolFailed);
+                }
+                if (line.is_empty()) {
+                    if (m_state == State::Trailers) {
+                        return finish_up();
                     } else {
-                        auto chunk = size_lines[0].split_view(';', true);
-                        String size_string = chunk[0];
-                        char* endptr;
-                        auto size = strtoul(size_string.characters(), &endptr, 16);
-                        if (*endptr) {
-                            // invalid number
-                            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                            return IterationDecision::Break;
+                        if (on_headers_received)
+                            on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
+                        m_state = State::InBody;
+                        m_can_reuse_connection = response_allows_keep_alive();
+                        // Nothing more is coming, and on a kept-alive connection nothing would tell us so.
+                        if (has_empty_body())
+                            return finish_up();
+                    }
+                    continue;
+                }
+                auto parts = line.split_view(':');
+                if (parts.is_empty()) {
+                    if (m_state == State::Trailers) {
+                        // Some servers like to send two ending chunks
+                        // use this fact as an excuse to ignore anything after the last chunk
+                        // that is not a valid trailing header.
+                        m_can_reuse_connection = false;
+                        return finish_up();
+                    }
+                    warnln("Job: Expected HTTP header with key/value");
+                    return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+                }
+                auto name = parts[0];
+                if (line.length() < name.length() + 2) {
+                    if (m_state == State::Trailers) {
+                        // Some servers like to send two ending chunks
+                        // use this fact as an excuse to ignore anything after the last chunk
+                        // that is not a valid trailing header.
+                        m_can_reuse_connection = false;
+                        return finish_up();
+                    }
+                    warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
+                    return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+                }
+                auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
+                m_headers.set(name, value);
+                if (name.equals_ignoring_case("Content-Encoding")) {
+                    // Assume that any content-encoding means that we can't decode it as a stream :(
+                    dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+                    m_can_stream_response = false;
+                }
+                dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+                continue;
+            }
+            VERIFY(m_state == State::InBody);
+            if (!can_read())
+                return;
+
+            read_while_data_available([&] {
+                auto read_size = 64 * KiB;
+                if (m_current_chunk_remaining_size.has_value()) {
+                read_chunk_size:;
+                    auto remaining = m_current_chunk_remaining_size.value();
+                    if (remaining == -1) {
+                        // read size
+                        auto size_data = read_line(PAGE_SIZE);
+                        if (m_should_read_chunk_ending_line) {
+                            VERIFY(size_data.is_empty());
+                            m_should_read_chunk_ending_line = false;
+                            return IterationDecision::Continue;
                         }
-                        if (size == 0) {
-                            // This is the last chunk
-                            // '0' *[; chunk-ext-name = chunk-ext-value]
-                            // We're going to ignore _all_ chunk extensions
-                            read_size = 0;
-                            m_current_chunk_total_size = 0;
-                            m_current_chunk_remaining_size = 0;
-
-                            dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
+                        auto size_lines = size_data.view().lines();
+                        dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_data);
+                        if (size_lines.size() == 0) {
+                            dbgln("Job: Reached end of stream");
+                            m_can_reuse_connection = false;
+                            m_body_was_cut_short = true;
+                            finish_up();
+                            return IterationDecision::Break;
                         } else {
-                            m_current_chunk_total_size = size;
-                            m_current_chunk_remaining_size = size;
-                            read_size = size;
-
-                            dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
+                            auto chunk = size_lines[0].split_view(';', true);
+                            String size_string = chunk[0];
+                            char* endptr;
+                            auto size = strtoul(size_string.characters(), &endptr, 16);
+                            if (*endptr) {
+                                // invalid number
+                                deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+                                return IterationDecision::Break;
+                            }
+                            if (size == 0) {
+                                // This is the last chunk
+                                // '0' *[; chunk-ext-name = chunk-ext-value]
+                                // We're going to ignore _all_ chunk extensions
+                                read_size = 0;
+                                m_current_chunk_total_size = 0;
+                                m_current_chunk_remaining_size = 0;
+
+                                dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
+                            } else {
+                                m_current_chunk_total_size = size;
+                                m_current_chunk_remaining_size = size;
+                                read_size = size;
+
+                                dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
+                            }
                         }
+                    } else {
+                        read_size = remaining;
+
+                        dbgln_if(JOB_DEBUG, "Job: Resuming chunk with '{}' bytes left over", remaining);
                     }
                 } else {
-                    read_size = remaining;
-
-                    dbgln_if(JOB_DEBUG, "Job: Resuming chunk with '{}' bytes left over", remaining);
-                }
-            } else {
-                auto transfer_encoding = m_headers.get("Transfer-Encoding");
-                if (transfer_encoding.has_value()) {
-                    // Note: Some servers add extra spaces around 'chunked', see #6302.
-                    auto encoding = transfer_encoding.value().trim_whitespace();
-
-                    dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
-                    if (encoding.equals_ignoring_case("chunked")) {
-                        m_current_chunk_remaining_size = -1;
-                        goto read_chunk_size;
-                    } else {
-                        dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
+                    auto transfer_encoding = m_headers.get("Transfer-Encoding");
+                    if (transfer_encoding.has_value()) {
+                        // Note: Some servers add extra spaces around 'chunked', see #6302.
+                        auto encoding = transfer_encoding.value().trim_whitespace();
+
+                        dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
+                        if (encoding.equals_ignoring_case("chunked")) {
+                            m_current_chunk_remaining_size = -1;
+                            goto read_chunk_size;
+                        } else {
+                            dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
+                        }
                     }
                 }
-            }
 
-            auto payload = receive(read_size);
-            if (payload.is_empty()) {
-                if (eof()) {
-                    finish_up();
-                    return IterationDecision::Break;
-                }
+                auto payload = receive(read_size);
+                if (payload.is_empty()) {
+                    if (eof()) {
+                        m_can_reuse_connection = false;
+                        m_body_was_cut_short = expects_more_body();
+                        finish_up();
+                        return IterationDecision::Break;
+                    }
 
-                if (should_fail_on_empty_payload()) {
-                    deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-                    return IterationDecision::Break;
+                    if (should_fail_on_empty_payload()) {
+                        deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+                        return IterationDecision::Break;
+                    }
                 }
-            }
 
-            m_received_buffers.append(payload);
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
+                m_received_buffers.append(payload);
+                m_buffered_size += payload.size();
+                m_received_size += payload.size();
+                flush_received_buffers();
 
-            if (m_current_chunk_remaining_size.has_value()) {
-                auto size = m_current_chunk_remaining_size.value() - payload.size();
+                if (m_current_chunk_remaining_size.has_value()) {
+                    auto size = m_current_chunk_remaining_size.value() - payload.size();
 
-                dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
-                if (size == 0) {
-                    dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", m_current_chunk_total_size.value());
+                    dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
+                    if (size == 0) {
+                        dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", m_current_chunk_total_size.value());
 
-                    if (m_current_chunk_total_size.value() == 0) {
-                        m_state = State::Trailers;
-                        return IterationDecision::Break;
-                    }
+                        if (m_current_chunk_total_size.value() == 0) {
+                            m_state = State::Trailers;
+                            return IterationDecision::Break;
+                        }
 
-                    // we've read everything, now let's get the next chunk
-                    size = -1;
-                    if (can_read_line()) {
-                        auto line = read_line(PAGE_SIZE);
-                        VERIFY(line.is_empty());
-                    } else {
-                        m_should_read_chunk_ending_line = true;
+                        // we've read everything, now let's get the next chunk
+                        size = -1;
+                        if (can_read_line()) {
+                            auto line = read_line(PAGE_SIZE);
+                            VERIFY(line.is_empty());
+                        } else {
+                            m_should_read_chunk_ending_line = true;
+                        }
                     }
+                    m_current_chunk_remaining_size = size;
                 }
-                m_current_chunk_remaining_size = size;
-            }
 
-            auto content_length_header = m_headers.get("Content-Length");
-            Optional<u32> content_length {};
+                auto content_length = this->content_length();
+                deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
 
-            if (content_length_header.has_value()) {
-                auto length = content_length_header.value().to_uint();
-                if (length.has_value())
-                    content_length = length.value();
-            }
+                if (content_length.has_value()) {
+                    auto length = content_length.value();
+                    if (m_received_size >= length) {
+                        // Anything past the declared length would be mistaken for the start of the next response.
+                        if (m_received_size > length)
+                            m_can_reuse_connection = false;
+                        m_received_size = length;
+                        finish_up();
+                        return IterationDecision::Break;
+                    }
+                }
+                return IterationDecision::Continue;
+            });
 
-            deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
+            if (m_state == State::Finished)
+                return;
 
-            if (content_length.has_value()) {
-                auto length = content_length.value();
-                if (m_received_size >= length) {
-                    m_received_size = length;
-                    finish_up();
-                    return IterationDecision::Break;
-                }
+            if (!is_established()) {
+                dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
+                m_can_reuse_connection = false;
+                m_body_was_cut_short = expects_more_body();
+                finish_up();
+                return;
             }
-            return IterationDecision::Continue;
-        });
-
-        if (!is_established()) {
-            dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
-            finish_up();
         }
     });
 }
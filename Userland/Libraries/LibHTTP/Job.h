@@ -24,12 +24,33 @@ public:
     virtual void start() override = 0;
     virtual void shutdown() override = 0;
 
+    const HttpRequest& request() const { return m_request; }
+
+    // Sees every part of the (decoded) response body as it is passed on to the output stream.
+    Function<void(ReadonlyBytes)> on_body_data;
+
     HttpResponse* response() { return static_cast<HttpResponse*>(Core::NetworkJob::response()); }
     const HttpResponse* response() const { return static_cast<const HttpResponse*>(Core::NetworkJob::response()); }
 
+    // Whether the response was read to its end on a connection that both sides agreed to keep open,
+    // leaving the socket ready to carry another request.
+    bool can_reuse_connection() const { return m_can_reuse_connection && m_state == State::Finished && !has_error(); }
+
+    // Whether the connection closed before the end of a body whose length was known.
+    bool body_was_cut_short() const { return m_body_was_cut_short; }
+
 protected:
+    friend class Http2Connection;
+
+    // Called by Http2Connection with the response arriving on the job's stream.
+    void did_receive_http2_headers(u32 status_code, HashMap<String, String, CaseInsensitiveStringTraits>&&);
+    void did_receive_http2_data(ReadonlyBytes);
+    void did_end_http2_stream();
+    void did_fail_http2_stream(Core::NetworkJob::Error);
+
     void finish_up();
     void on_socket_connected();
+    void send_request();
     void flush_received_buffers();
     virtual void register_on_ready_to_read(Function<void()>) = 0;
     virtual void register_on_ready_to_write(Function<void()>) = 0;
@@ -44,6 +65,11 @@ protected:
     virtual void read_while_data_available(Function<IterationDecision()> read) { read(); };
     virtual void timer_event(Core::TimerEvent&) override;
 
+    bool response_allows_keep_alive() const;
+    bool has_empty_body() const;
+    bool expects_more_body() const;
+    Optional<u32> content_length() const;
+
     enum class State {
         InStatus,
         InHeaders,
@@ -65,6 +91,9 @@ protected:
     bool m_can_stream_response { true };
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
+    bool m_is_http_1_1 { false };
+    bool m_can_reuse_connection { false };
+    bool m_body_was_cut_short { false };
 };
 
 }
@@ -8,12 +8,14 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/TemporaryChange.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalSocket.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Timer.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/MessageStatistics.h>
 #include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -21,8 +23,16 @@
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#ifdef __serenity__
+#    include <AK/Atomic.h>
+#    include <Kernel/API/LocalSocketRing.h>
+#    include <sys/ioctl.h>
+#    include <sys/mman.h>
+#endif
+
 namespace IPC {
 
 template<typename LocalEndpoint, typename PeerEndpoint>
@@ -41,6 +51,21 @@ public:
             drain_messages_from_peer();
             handle_messages();
         };
+
+#ifdef __serenity__
+        // If the kernel lets us, skip the write() for most of the messages we send by putting them into its socket buffer directly.
+        auto* send_ring = mmap(nullptr, LOCAL_SOCKET_RING_MAPPING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_socket->fd(), 0);
+        if (send_ring != MAP_FAILED)
+            m_send_ring = reinterpret_cast<LocalSocketRingHeader*>(send_ring);
+#endif
+    }
+
+    virtual ~Connection() override
+    {
+#ifdef __serenity__
+        if (m_send_ring)
+            munmap(m_send_ring, LOCAL_SOCKET_RING_MAPPING_SIZE);
+#endif
     }
 
     template<typename MessageType>
@@ -54,7 +79,6 @@ public:
         post_message(message.encode());
     }
 
-    // FIXME: unnecessary copy
     void post_message(MessageBuffer buffer)
     {
         // NOTE: If this connection is being shut down, but has not yet been destroyed,
@@ -62,10 +86,6 @@ public:
         if (!m_socket->is_open())
             return;
 
-        // Prepend the message size.
-        uint32_t message_size = buffer.data.size();
-        buffer.data.prepend(reinterpret_cast<const u8*>(&message_size), sizeof(message_size));
-
 #ifdef __serenity__
         for (auto& fd : buffer.fds) {
             auto rc = sendfd(m_socket->fd(), fd->value());
@@ -79,9 +99,60 @@ public:
             warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-        size_t total_nwritten = 0;
-        while (total_nwritten < buffer.data.size()) {
-            auto nwritten = write(m_socket->fd(), buffer.data.data() + total_nwritten, buffer.data.size() - total_nwritten);
+        m_pending_messages_size += sizeof(u32) + buffer.data.size();
+        m_pending_messages.append(move(buffer));
+        if (!m_is_batching_messages || m_pending_messages_size >= MaxPendingMessagesSize) {
+            flush_pending_messages();
+            return;
+        }
+
+        // Normally, the batch is sent off once all the incoming messages have been handled. If one of the handlers
+        // spins a nested event loop (say, for a modal dialog), the messages mustn't be held back until it returns.
+        if (!m_has_scheduled_flush) {
+            m_has_scheduled_flush = true;
+            deferred_invoke([this](auto&) {
+                m_has_scheduled_flush = false;
+                flush_pending_messages();
+            });
+        }
+    }
+
+    // Sends all messages that were held back to be sent together.
+    void flush_pending_messages()
+    {
+        if (m_pending_messages.is_empty())
+            return;
+        auto messages = move(m_pending_messages);
+        auto total_size = exchange(m_pending_messages_size, 0);
+        if (!m_socket->is_open())
+            return;
+
+#ifdef __serenity__
+        if (try_post_messages_through_ring(messages, total_size)) {
+            m_responsiveness_timer->start();
+            return;
+        }
+#else
+        (void)total_size;
+#endif
+
+        // Every message is preceded by its size.
+        Vector<u32, 16> message_sizes;
+        message_sizes.ensure_capacity(messages.size());
+        for (auto& message : messages)
+            message_sizes.unchecked_append(message.data.size());
+
+        Vector<iovec, 32> iovecs;
+        iovecs.ensure_capacity(messages.size() * 2);
+        for (size_t i = 0; i < messages.size(); ++i) {
+            iovecs.unchecked_append({ &message_sizes[i], sizeof(u32) });
+            iovecs.unchecked_append({ messages[i].data.data(), messages[i].data.size() });
+        }
+
+        size_t iovec_index = 0;
+        while (iovec_index < iovecs.size()) {
+            auto iovec_count = min(iovecs.size() - iovec_index, MaxIOVecsPerWrite);
+            auto nwritten = writev(m_socket->fd(), iovecs.data() + iovec_index, static_cast<int>(iovec_count));
             if (nwritten < 0) {
                 switch (errno) {
                 case EPIPE:
@@ -93,12 +164,23 @@ public:
                     shutdown();
                     return;
                 default:
-                    perror("Connection::post_message write");
+                    perror("Connection::post_message writev");
                     shutdown();
                     return;
                 }
             }
-            total_nwritten += nwritten;
+
+            // The write may have stopped anywhere, including in the middle of a message.
+            for (size_t remaining = nwritten; remaining > 0;) {
+                auto& iovec = iovecs[iovec_index];
+                if (remaining < iovec.iov_len) {
+                    iovec.iov_base = static_cast<u8*>(iovec.iov_base) + remaining;
+                    iovec.iov_len -= remaining;
+                    break;
+                }
+                remaining -= iovec.iov_len;
+                ++iovec_index;
+            }
         }
 
         m_responsiveness_timer->start();
@@ -140,6 +222,9 @@ protected:
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
     {
+        // Whatever we're waiting for may well be the answer to something we haven't actually sent yet.
+        flush_pending_messages();
+
         for (;;) {
             // Double check we don't already have the event waiting for us.
             // Otherwise we might end up blocked for a while for no reason.
@@ -177,16 +262,20 @@ protected:
 
     bool drain_messages_from_peer()
     {
-        Vector<u8> bytes;
-
-        if (!m_unprocessed_bytes.is_empty()) {
-            bytes.append(m_unprocessed_bytes.data(), m_unprocessed_bytes.size());
-            m_unprocessed_bytes.clear();
-        }
-
+        bool did_receive_anything = false;
         while (m_socket->is_open()) {
-            u8 buffer[4096];
-            ssize_t nread = recv(m_socket->fd(), buffer, sizeof(buffer), MSG_DONTWAIT);
+            // Leave room for all of a message we've only received the start of, so that the rest of it can be read in one go.
+            size_t wanted_space = ReceiveChunkSize;
+            if (m_received_size >= sizeof(u32)) {
+                u32 message_size = 0;
+                memcpy(&message_size, m_receive_buffer.data(), sizeof(message_size));
+                if (sizeof(u32) + message_size > m_received_size)
+                    wanted_space = clamp<size_t>(sizeof(u32) + message_size - m_received_size, ReceiveChunkSize, MaxReceivePresize);
+            }
+            if (m_receive_buffer.size() - m_received_size < wanted_space)
+                m_receive_buffer.resize(max(m_receive_buffer.size() * 2, m_received_size + wanted_space));
+
+            ssize_t nread = recv(m_socket->fd(), m_receive_buffer.data() + m_received_size, m_receive_buffer.size() - m_received_size, MSG_DONTWAIT);
             if (nread < 0) {
                 if (errno == EAGAIN)
                     break;
@@ -195,50 +284,50 @@ protected:
                 return false;
             }
             if (nread == 0) {
-                if (bytes.is_empty()) {
+                if (!did_receive_anything) {
                     deferred_invoke([this](auto&) { shutdown(); });
                     return false;
                 }
                 break;
             }
-            bytes.append(buffer, nread);
+            m_received_size += nread;
+            did_receive_anything = true;
         }
 
-        if (!bytes.is_empty()) {
+        if (did_receive_anything) {
             m_responsiveness_timer->stop();
             did_become_responsive();
         }
 
         size_t index = 0;
         u32 message_size = 0;
-        for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
-            memcpy(&message_size, bytes.data() + index, sizeof(message_size));
-            if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
+        for (; index + sizeof(message_size) < m_received_size; index += message_size) {
+            memcpy(&message_size, m_receive_buffer.data() + index, sizeof(message_size));
+            if (message_size == 0 || m_received_size - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
-            auto remaining_bytes = ReadonlyBytes { bytes.data() + index, bytes.size() - index };
-            if (auto message = LocalEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else {
+            auto remaining_bytes = ReadonlyBytes { m_receive_buffer.data() + index, m_received_size - index };
+            auto message = LocalEndpoint::decode_message(remaining_bytes, m_socket->fd());
+            if (!message)
+                message = PeerEndpoint::decode_message(remaining_bytes, m_socket->fd());
+            if (!message) {
                 dbgln("Failed to parse a message");
                 break;
             }
+            if (MessageStatistics::is_enabled())
+                MessageStatistics::did_receive(*message, message_size);
+            m_unprocessed_messages.append(message.release_nonnull());
         }
 
-        if (index < bytes.size()) {
-            // Sometimes we might receive a partial message. That's okay, just stash away
-            // the unprocessed bytes and we'll prepend them to the next incoming message
-            // in the next run of this function.
-            auto remaining_bytes = ByteBuffer::copy(bytes.data() + index, bytes.size() - index);
-            if (!m_unprocessed_bytes.is_empty()) {
-                dbgln("{}::drain_messages_from_peer: Already have unprocessed bytes", *this);
-                shutdown();
-                return false;
-            }
-            m_unprocessed_bytes = remaining_bytes;
+        // Sometimes we might receive a partial message. That's okay, just keep the bytes
+        // at the start of the buffer, and the rest will be read in after them next time.
+        if (index > 0) {
+            memmove(m_receive_buffer.data(), m_receive_buffer.data() + index, m_received_size - index);
+            m_received_size -= index;
         }
+        // Don't hold on to the memory of an unusually large message forever.
+        if (m_received_size == 0 && m_receive_buffer.size() > MaxReceivePresize)
+            m_receive_buffer.clear();
 
         if (!m_unprocessed_messages.is_empty()) {
             deferred_invoke([this](auto&) {
@@ -251,12 +340,53 @@ protected:
     void handle_messages()
     {
         auto messages = move(m_unprocessed_messages);
+        {
+            // The responses (and whatever else the handlers send) go out together, instead of one write at a time.
+            TemporaryChange batching_change { m_is_batching_messages, true };
+            for (auto& message : messages) {
+                if (message.endpoint_magic() == LocalEndpoint::static_magic())
+                    if (auto response = m_local_stub.handle(message))
+                        post_message(*response);
+            }
+        }
+        flush_pending_messages();
+    }
+
+#ifdef __serenity__
+    bool try_post_messages_through_ring(const Vector<MessageBuffer>& messages, size_t total_size)
+    {
+        if (!m_send_ring)
+            return false;
+        // NOTE: We are the only one advancing the tail, but the peer (or the kernel on its behalf) advances the head.
+        auto head = AK::atomic_load(&m_send_ring->head, AK::memory_order_acquire);
+        auto tail = m_send_ring->tail;
+        auto capacity = m_send_ring->capacity;
+        if (capacity - (tail - head) < total_size)
+            return false;
+
+        auto* data = reinterpret_cast<u8*>(m_send_ring) + m_send_ring->data_offset;
+        auto append = [&](ReadonlyBytes bytes) {
+            auto index = tail & (capacity - 1);
+            auto first_chunk_size = min(bytes.size(), capacity - index);
+            memcpy(data + index, bytes.data(), first_chunk_size);
+            memcpy(data, bytes.data() + first_chunk_size, bytes.size() - first_chunk_size);
+            tail += static_cast<u32>(bytes.size());
+        };
         for (auto& message : messages) {
-            if (message.endpoint_magic() == LocalEndpoint::static_magic())
-                if (auto response = m_local_stub.handle(message))
-                    post_message(*response);
+            u32 message_size = message.data.size();
+            append({ &message_size, sizeof(message_size) });
+            append(message.data);
         }
+        AK::atomic_store(&m_send_ring->tail, tail, AK::memory_order_release);
+
+        // One notification covers the whole batch.
+        if (ioctl(m_socket->fd(), LOCAL_SOCKET_RING_NOTIFY) < 0) {
+            perror("Connection::post_message ioctl");
+            shutdown();
+        }
+        return true;
     }
+#endif
 
 protected:
     LocalStub& m_local_stub;
@@ -265,7 +395,22 @@ protected:
 
     RefPtr<Core::Notifier> m_notifier;
     NonnullOwnPtrVector<Message> m_unprocessed_messages;
-    ByteBuffer m_unprocessed_bytes;
+
+    static constexpr size_t ReceiveChunkSize = 16 * KiB;
+    static constexpr size_t MaxReceivePresize = 1 * MiB;
+    // Only the first m_received_size bytes hold received data, the rest is room for more.
+    ByteBuffer m_receive_buffer;
+    size_t m_received_size { 0 };
+
+    static constexpr size_t MaxPendingMessagesSize = 64 * KiB;
+    static constexpr size_t MaxIOVecsPerWrite = 1024;
+    Vector<MessageBuffer> m_pending_messages;
+    size_t m_pending_messages_size { 0 };
+    bool m_is_batching_messages { false };
+    bool m_has_scheduled_flush { false };
+#ifdef __serenity__
+    LocalSocketRingHeader* m_send_ring { nullptr };
+#endif
 };
 
 }
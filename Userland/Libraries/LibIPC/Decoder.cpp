@@ -92,6 +92,9 @@ bool Decoder::decode(String& value)
         value = String::empty();
         return true;
     }
+    // Don't let a bogus length make us allocate more than the message could possibly hold.
+    if (static_cast<size_t>(length) > m_stream.remaining())
+        return false;
     char* text_buffer = nullptr;
     auto text_impl = StringImpl::create_uninitialized(static_cast<size_t>(length), text_buffer);
     m_stream >> Bytes { text_buffer, static_cast<size_t>(length) };
@@ -113,6 +116,8 @@ bool Decoder::decode(ByteBuffer& value)
         value = ByteBuffer::create_uninitialized(0);
         return true;
     }
+    if (static_cast<size_t>(length) > m_stream.remaining())
+        return false;
     value = ByteBuffer::create_uninitialized(length);
     m_stream >> value.bytes();
     return !m_stream.handle_any_error();
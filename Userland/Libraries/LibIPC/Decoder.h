@@ -8,6 +8,7 @@
 
 #include <AK/Concepts.h>
 #include <AK/Forward.h>
+#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
 #include <AK/StdLibExtras.h>
 #include <AK/String.h>
@@ -90,6 +91,8 @@ public:
         u64 size;
         if (!decode(size) || size > NumericLimits<i32>::max())
             return false;
+        // Every element takes up at least a byte, so this is as much as the message could possibly hold.
+        vector.ensure_capacity(vector.size() + min(size, m_stream.remaining()));
         for (size_t i = 0; i < size; ++i) {
             T value;
             if (!decode(value))
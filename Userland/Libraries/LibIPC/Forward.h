@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/StdLibExtras.h>
+
 namespace IPC {
 
 class Decoder;
@@ -14,4 +16,9 @@ class Encoder;
 class Message;
 class File;
 
+// Whether a type is encoded as nothing but the bytes it's made of in memory. The IPC compiler copies messages
+// that consist only of such types in one go, rather than encoding and decoding their parameters one by one.
+template<typename T>
+inline constexpr bool HasFixedLayout = IsArithmetic<T> || IsEnum<T>;
+
 }
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/QuickSort.h>
+#include <AK/String.h>
+#include <LibIPC/Message.h>
+#include <LibIPC/MessageStatistics.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+namespace IPC {
+
+struct MessageCounts {
+    size_t count { 0 };
+    size_t total_size { 0 };
+    size_t max_size { 0 };
+};
+
+// Keyed by the message's name, which starts with the name of its endpoint.
+static HashMap<String, MessageCounts>* s_counts;
+static pthread_mutex_t s_counts_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static StringView endpoint_name(const String& message_name)
+{
+    return message_name.view().substring_view(0, message_name.view().find("::"sv).value_or(message_name.length()));
+}
+
+static void dump_statistics()
+{
+    pthread_mutex_lock(&s_counts_lock);
+    Vector<String> names;
+    for (auto& it : *s_counts)
+        names.append(it.key);
+    quick_sort(names, [](auto& a, auto& b) {
+        if (endpoint_name(a) != endpoint_name(b))
+            return endpoint_name(a) < endpoint_name(b);
+        return s_counts->get(a)->total_size > s_counts->get(b)->total_size;
+    });
+
+    dbgln("IPC messages received:");
+    for (auto& name : names) {
+        auto counts = s_counts->get(name).value();
+        dbgln("  {}: {} messages, {} bytes (average {}, largest {})", name, counts.count, counts.total_size, counts.total_size / counts.count, counts.max_size);
+    }
+    pthread_mutex_unlock(&s_counts_lock);
+}
+
+bool MessageStatistics::is_enabled()
+{
+    static bool is_enabled = getenv("IPC_STATISTICS") != nullptr;
+    return is_enabled;
+}
+
+void MessageStatistics::did_receive(const Message& message, size_t size)
+{
+    pthread_mutex_lock(&s_counts_lock);
+    if (!s_counts) {
+        s_counts = new HashMap<String, MessageCounts>;
+        atexit(dump_statistics);
+    }
+    auto& counts = s_counts->ensure(message.message_name());
+    ++counts.count;
+    counts.total_size += size;
+    counts.max_size = max(counts.max_size, size);
+    pthread_mutex_unlock(&s_counts_lock);
+}
+
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibIPC/Forward.h>
+
+namespace IPC {
+
+// Keeps count of the messages this process receives, to find out which ones dominate the traffic on its connections.
+// Counting is turned on by setting IPC_STATISTICS in the environment, and the numbers are written to the debug log
+// on exit, grouped by endpoint and sorted by the number of bytes received.
+class MessageStatistics {
+public:
+    static bool is_enabled();
+    static void did_receive(const Message&, size_t size);
+};
+
+}
@@ -16,11 +16,15 @@ Client::Client()
 
 void Client::die()
 {
+    auto pending_requests = move(m_pending_requests);
+    for (auto& it : pending_requests)
+        it.value({});
+
     if (on_death)
         on_death();
 }
 
-Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
+static Optional<Core::AnonymousBuffer> copy_to_anonymous_buffer(const ByteBuffer& encoded_data)
 {
     if (encoded_data.is_empty())
         return {};
@@ -32,7 +36,30 @@ Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
     }
 
     memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
-    auto response_or_error = try_decode_image(move(encoded_buffer));
+    return encoded_buffer;
+}
+
+static DecodedImage decoded_image_from(bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    DecodedImage image;
+    image.is_animated = is_animated;
+    image.loop_count = loop_count;
+    image.frames.resize(bitmaps.size());
+    for (size_t i = 0; i < image.frames.size(); ++i) {
+        auto& frame = image.frames[i];
+        frame.bitmap = bitmaps[i].bitmap();
+        frame.duration = durations[i];
+    }
+    return image;
+}
+
+Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
+{
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value())
+        return {};
+
+    auto response_or_error = try_decode_image(encoded_buffer.release_value());
 
     if (response_or_error.is_error()) {
         dbgln("ImageDecoder died heroically");
@@ -44,16 +71,35 @@ Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
     if (response.bitmaps().is_empty())
         return {};
 
-    DecodedImage image;
-    image.is_animated = response.is_animated();
-    image.loop_count = response.loop_count();
-    image.frames.resize(response.bitmaps().size());
-    for (size_t i = 0; i < image.frames.size(); ++i) {
-        auto& frame = image.frames[i];
-        frame.bitmap = response.bitmaps()[i].bitmap();
-        frame.duration = response.durations()[i];
+    return decoded_image_from(response.is_animated(), response.loop_count(), response.bitmaps(), response.durations());
+}
+
+void Client::decode_image_async(const ByteBuffer& encoded_data, Function<void(Optional<DecodedImage>)> on_decoded)
+{
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value()) {
+        on_decoded({});
+        return;
     }
-    return image;
+
+    auto request_id = m_next_request_id++;
+    m_pending_requests.set(request_id, move(on_decoded));
+    async_decode_image_async(request_id, encoded_buffer.release_value());
+}
+
+void Client::did_decode_image(i32 request_id, bool success, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    auto it = m_pending_requests.find(request_id);
+    if (it == m_pending_requests.end())
+        return;
+    auto on_decoded = move(it->value);
+    m_pending_requests.remove(it);
+
+    if (!success || bitmaps.is_empty() || bitmaps.size() != durations.size()) {
+        on_decoded({});
+        return;
+    }
+    on_decoded(decoded_image_from(is_animated, loop_count, bitmaps, durations));
 }
 
 }
@@ -32,12 +32,21 @@ class Client final
 public:
     Optional<DecodedImage> decode_image(const ByteBuffer&);
 
+    // Doesn't wait for the image to be decoded, so that ImageDecoder can work on any number of images at once.
+    // on_decoded gets called on the event loop once it's done, with nothing if the image couldn't be decoded.
+    void decode_image_async(const ByteBuffer&, Function<void(Optional<DecodedImage>)> on_decoded);
+
     Function<void()> on_death;
 
 private:
     Client();
 
     virtual void die() override;
+
+    virtual void did_decode_image(i32 request_id, bool success, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations) override;
+
+    i32 m_next_request_id { 0 };
+    HashMap<i32, Function<void(Optional<DecodedImage>)>> m_pending_requests;
 };
 
 }
@@ -14,6 +14,7 @@
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -1335,6 +1336,34 @@ void FunctionExpression::dump(int indent) const
     FunctionNode::dump(indent, class_name());
 }
 
+BlockStatement const* LazyFunctionBody::parsed_body() const
+{
+    if (m_did_parse)
+        return m_parsed_body;
+    m_did_parse = true;
+
+    Parser parser { Lexer { m_source, m_filename, source_range().start.line, source_range().start.column - 1 } };
+    parser.set_lazy_function_parsing(true);
+    auto body = parser.parse_function_body(m_starts_in_strict_mode);
+    if (parser.has_errors()) {
+        m_syntax_error = parser.errors()[0].to_string();
+        return nullptr;
+    }
+    m_parsed_body = move(body);
+    return m_parsed_body;
+}
+
+void LazyFunctionBody::dump(int indent) const
+{
+    ASTNode::dump(indent);
+    if (auto* body = m_did_parse ? m_parsed_body.ptr() : nullptr) {
+        body->dump(indent + 1);
+        return;
+    }
+    print_indent(indent + 1);
+    outln("(Not parsed yet)");
+}
+
 void YieldExpression::dump(int indent) const
 {
     ASTNode::dump(indent);
@@ -244,6 +244,33 @@ struct BindingPattern : RefCounted<BindingPattern> {
     Kind kind { Kind::Object };
 };
 
+// The body of a function that has only been pre-parsed. Its source is parsed for real the first time it's needed.
+class LazyFunctionBody final : public Statement {
+public:
+    LazyFunctionBody(SourceRange source_range, String source, String filename, bool starts_in_strict_mode)
+        : Statement(source_range)
+        , m_source(move(source))
+        , m_filename(move(filename))
+        , m_starts_in_strict_mode(starts_in_strict_mode)
+    {
+    }
+
+    // Returns null if the body turned out to have a syntax error.
+    BlockStatement const* parsed_body() const;
+    String const& syntax_error() const { return m_syntax_error; }
+
+    virtual Value execute(Interpreter&, GlobalObject&) const override { VERIFY_NOT_REACHED(); }
+    virtual void dump(int indent) const override;
+
+private:
+    String m_source;
+    String m_filename;
+    bool m_starts_in_strict_mode { false };
+    mutable bool m_did_parse { false };
+    mutable RefPtr<BlockStatement> m_parsed_body;
+    mutable String m_syntax_error;
+};
+
 class FunctionNode {
 public:
     struct Parameter {
@@ -28,7 +28,7 @@ void ScopeNode::generate_bytecode(Bytecode::Generator& generator) const
 {
     for (auto& function : functions()) {
         generator.emit<Bytecode::Op::NewFunction>(function);
-        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(function.name()));
+        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(function.name()), generator.next_global_variable_cache());
     }
 
     HashMap<u32, Variable> scope_variables_with_declaration_kind;
@@ -40,12 +40,12 @@ void ScopeNode::generate_bytecode(Bytecode::Generator& generator) const
                 declarator.target().visit(
                     [&](const NonnullRefPtr<Identifier>& id) {
                         generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
-                        generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(id->string()));
+                        generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(id->string()), generator.next_property_lookup_cache());
                     },
                     [&](const NonnullRefPtr<BindingPattern>& binding) {
                         binding->for_each_bound_name([&](const auto& name) {
                             generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
-                            generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(name));
+                            generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(name), generator.next_property_lookup_cache());
                         });
                     });
             } else {
@@ -267,7 +267,7 @@ void RegExpLiteral::generate_bytecode(Bytecode::Generator& generator) const
 
 void Identifier::generate_bytecode(Bytecode::Generator& generator) const
 {
-    generator.emit<Bytecode::Op::GetVariable>(generator.intern_string(m_string));
+    generator.emit<Bytecode::Op::GetVariable>(generator.intern_string(m_string), generator.next_global_variable_cache());
 }
 
 void AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) const
@@ -279,7 +279,7 @@ void AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) con
 
         if (m_op == AssignmentOp::Assignment) {
             m_rhs->generate_bytecode(generator);
-            generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()));
+            generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()), generator.next_global_variable_cache());
             return;
         }
 
@@ -366,7 +366,7 @@ void AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) con
             TODO();
         }
 
-        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()));
+        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()), generator.next_global_variable_cache());
 
         if (end_block_ptr) {
             generator.emit<Bytecode::Op::Jump>().set_targets(
@@ -394,7 +394,7 @@ void AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) con
         } else {
             m_rhs->generate_bytecode(generator);
             auto identifier_table_ref = generator.intern_string(verify_cast<Identifier>(expression.property()).string());
-            generator.emit<Bytecode::Op::PutById>(object_reg, identifier_table_ref);
+            generator.emit<Bytecode::Op::PutById>(object_reg, identifier_table_ref, generator.next_property_lookup_cache());
         }
         return;
     }
@@ -583,7 +583,7 @@ void ObjectExpression::generate_bytecode(Bytecode::Generator& generator) const
             Bytecode::StringTableIndex key_name = generator.intern_string(string_literal.value());
 
             property.value().generate_bytecode(generator);
-            generator.emit<Bytecode::Op::PutById>(object_reg, key_name);
+            generator.emit<Bytecode::Op::PutById>(object_reg, key_name, generator.next_property_lookup_cache());
         } else {
             property.key().generate_bytecode(generator);
             auto property_reg = generator.allocate_register();
@@ -630,7 +630,7 @@ void MemberExpression::generate_bytecode(Bytecode::Generator& generator) const
         generator.emit<Bytecode::Op::GetByValue>(object_reg);
     } else {
         auto identifier_table_ref = generator.intern_string(verify_cast<Identifier>(property()).string());
-        generator.emit<Bytecode::Op::GetById>(identifier_table_ref);
+        generator.emit<Bytecode::Op::GetById>(identifier_table_ref, generator.next_property_lookup_cache());
     }
 }
 
@@ -662,7 +662,7 @@ static void generate_object_binding_pattern_bytecode(Bytecode::Generator& genera
             auto interned_identifier = generator.intern_string(identifier);
 
             generator.emit_with_extra_register_slots<Bytecode::Op::CopyObjectExcludingProperties>(excluded_property_names.size(), value_reg, excluded_property_names);
-            generator.emit<Bytecode::Op::SetVariable>(interned_identifier);
+            generator.emit<Bytecode::Op::SetVariable>(interned_identifier, generator.next_global_variable_cache());
 
             return;
         }
@@ -681,7 +681,7 @@ static void generate_object_binding_pattern_bytecode(Bytecode::Generator& genera
             }
 
             generator.emit<Bytecode::Op::Load>(value_reg);
-            generator.emit<Bytecode::Op::GetById>(name_index);
+            generator.emit<Bytecode::Op::GetById>(name_index, generator.next_property_lookup_cache());
         } else {
             auto expression = name.get<NonnullRefPtr<Expression>>();
             expression->generate_bytecode(generator);
@@ -723,10 +723,10 @@ static void generate_object_binding_pattern_bytecode(Bytecode::Generator& genera
                 TODO();
             }
 
-            generator.emit<Bytecode::Op::SetVariable>(name_index);
+            generator.emit<Bytecode::Op::SetVariable>(name_index, generator.next_global_variable_cache());
         } else {
             auto& identifier = alias.get<NonnullRefPtr<Identifier>>()->string();
-            generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier));
+            generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier), generator.next_global_variable_cache());
         }
     }
 }
@@ -771,7 +771,7 @@ static void generate_array_binding_pattern_bytecode(Bytecode::Generator& generat
             },
             [&](NonnullRefPtr<Identifier> const& identifier) {
                 auto interned_index = generator.intern_string(identifier->string());
-                generator.emit<Bytecode::Op::SetVariable>(interned_index);
+                generator.emit<Bytecode::Op::SetVariable>(interned_index, generator.next_global_variable_cache());
             },
             [&](NonnullRefPtr<BindingPattern> const& pattern) {
                 // Store the accumulator value in a permanent register
@@ -899,7 +899,7 @@ void VariableDeclaration::generate_bytecode(Bytecode::Generator& generator) cons
             generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
         declarator.target().visit(
             [&](NonnullRefPtr<Identifier> const& id) {
-                generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(id->string()));
+                generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(id->string()), generator.next_global_variable_cache());
             },
             [&](NonnullRefPtr<BindingPattern> const& pattern) {
                 auto value_register = generator.allocate_register();
@@ -932,7 +932,7 @@ void CallExpression::generate_bytecode(Bytecode::Generator& generator) const
             if (!is<Identifier>(member_expression.property()))
                 TODO();
             auto identifier_table_ref = generator.intern_string(static_cast<Identifier const&>(member_expression.property()).string());
-            generator.emit<Bytecode::Op::GetById>(identifier_table_ref);
+            generator.emit<Bytecode::Op::GetById>(identifier_table_ref, generator.next_property_lookup_cache());
             generator.emit<Bytecode::Op::Store>(callee_reg);
         }
     } else {
@@ -1140,7 +1140,7 @@ void TaggedTemplateLiteral::generate_bytecode(Bytecode::Generator& generator) co
     generator.emit<Bytecode::Op::Store>(raw_strings_reg);
 
     generator.emit<Bytecode::Op::Load>(strings_reg);
-    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_string("raw"));
+    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_string("raw"), generator.next_property_lookup_cache());
 
     generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
     auto this_reg = generator.allocate_register();
@@ -1153,7 +1153,7 @@ void UpdateExpression::generate_bytecode(Bytecode::Generator& generator) const
 {
     if (is<Identifier>(*m_argument)) {
         auto& identifier = static_cast<Identifier const&>(*m_argument);
-        generator.emit<Bytecode::Op::GetVariable>(generator.intern_string(identifier.string()));
+        generator.emit<Bytecode::Op::GetVariable>(generator.intern_string(identifier.string()), generator.next_global_variable_cache());
 
         Optional<Bytecode::Register> previous_value_for_postfix_reg;
         if (!m_prefixed) {
@@ -1166,7 +1166,7 @@ void UpdateExpression::generate_bytecode(Bytecode::Generator& generator) const
         else
             generator.emit<Bytecode::Op::Decrement>();
 
-        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()));
+        generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(identifier.string()), generator.next_global_variable_cache());
 
         if (!m_prefixed)
             generator.emit<Bytecode::Op::Load>(*previous_value_for_postfix_reg);
@@ -1219,7 +1219,7 @@ void TryStatement::generate_bytecode(Bytecode::Generator& generator) const
             [&](FlyString const& parameter) {
                 if (parameter.is_empty()) {
                     // FIXME: We need a separate DeclarativeEnvironment here
-                    generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(parameter));
+                    generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(parameter), generator.next_global_variable_cache());
                 }
             },
             [&](NonnullRefPtr<BindingPattern> const&) {
@@ -1313,7 +1313,7 @@ void SwitchStatement::generate_bytecode(Bytecode::Generator& generator) const
 void ClassDeclaration::generate_bytecode(Bytecode::Generator& generator) const
 {
     generator.emit<Bytecode::Op::NewClass>(m_class_expression);
-    generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(m_class_expression.ptr()->name()));
+    generator.emit<Bytecode::Op::SetVariable>(generator.intern_string(m_class_expression.ptr()->name()), generator.next_global_variable_cache());
 }
 
 }
@@ -6,6 +6,7 @@
 
 #include <AK/String.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/JIT.h>
 #include <LibJS/Bytecode/Op.h>
 #include <sys/mman.h>
 
@@ -36,7 +37,8 @@ BasicBlock::~BasicBlock()
         Instruction::destroy(const_cast<Instruction&>(to_destroy));
     }
 
-    munmap(m_buffer, m_buffer_capacity);
+    if (m_buffer)
+        munmap(m_buffer, m_buffer_capacity);
 }
 
 void BasicBlock::seal()
@@ -47,6 +49,15 @@ void BasicBlock::seal()
     // It also doesn't work because instructions that have String members use RefPtr internally which must be in writable memory.
 }
 
+CompiledBlock const* BasicBlock::compiled_block() const
+{
+    if (!m_did_try_compiling) {
+        m_did_try_compiling = true;
+        m_compiled_block = CompiledBlock::compile(*this);
+    }
+    return m_compiled_block.ptr();
+}
+
 void BasicBlock::dump(Bytecode::Executable const& executable) const
 {
     Bytecode::InstructionStreamIterator it(instruction_stream());
@@ -64,6 +75,16 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::adopt_instruction_stream(BasicBlock& other)
+{
+    munmap(m_buffer, m_buffer_capacity);
+    m_buffer = exchange(other.m_buffer, nullptr);
+    m_buffer_capacity = exchange(other.m_buffer_capacity, 0);
+    m_buffer_size = exchange(other.m_buffer_size, 0);
+    m_compiled_block = nullptr;
+    m_did_try_compiling = false;
+}
+
 void InstructionStreamIterator::operator++()
 {
     VERIFY(!at_end());
@@ -8,6 +8,7 @@
 
 #include <AK/Badge.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <LibJS/Forward.h>
 
@@ -60,11 +61,21 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Takes over the instructions of the other block, which is left empty. Whatever was in this block
+    // must have been destroyed or moved elsewhere already.
+    void adopt_instruction_stream(BasicBlock& other);
+
+    // For when the instructions have been moved elsewhere, so they aren't destroyed along with this block.
+    void forget_instructions() { m_buffer_size = 0; }
+
     void terminate(Badge<Generator>) { m_is_terminated = true; }
     bool is_terminated() const { return m_is_terminated; }
 
     String const& name() const { return m_name; }
 
+    // Compiles the block with the JIT the first time this is called. Returns nullptr if it can't be compiled.
+    CompiledBlock const* compiled_block() const;
+
 private:
     BasicBlock(String name, size_t size);
 
@@ -73,6 +84,8 @@ private:
     size_t m_buffer_size { 0 };
     bool m_is_terminated { false };
     String m_name;
+    mutable OwnPtr<CompiledBlock> m_compiled_block;
+    mutable bool m_did_try_compiling { false };
 };
 
 }
@@ -6,23 +6,63 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/SinglyLinkedList.h>
+#include <AK/WeakPtr.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Bytecode/StringTable.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Runtime/Shape.h>
 
 namespace JS::Bytecode {
 
+// Remembers where a property was found for the last few shapes an instruction saw, so that looking it up
+// again on an object with one of those shapes is a single load from the object's storage.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes_to_remember = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        u32 shape_serial_number { 0 };
+        u32 property_offset { 0 };
+    };
+
+    Optional<u32> lookup(Shape const& shape) const
+    {
+        for (auto& entry : entries) {
+            if (entry.shape.ptr() == &shape && entry.shape_serial_number == shape.serial_number())
+                return entry.property_offset;
+        }
+        return {};
+    }
+
+    // The most recently seen shape goes first, pushing out the least recently added one once all entries are taken.
+    void remember(Shape const& shape, u32 property_offset)
+    {
+        for (size_t i = entries.size() - 1; i > 0; --i)
+            entries[i] = move(entries[i - 1]);
+        entries[0] = { shape.make_weak_ptr(), shape.serial_number(), property_offset };
+    }
+
+    AK::Array<Entry, max_number_of_shapes_to_remember> entries;
+    u32 hits { 0 };
+    u32 misses { 0 };
+};
+
 struct Executable {
     NonnullOwnPtrVector<BasicBlock> basic_blocks;
     NonnullOwnPtr<StringTable> string_table;
     size_t number_of_registers { 0 };
 
+    // Instructions are immutable once generated, so the caches they fill in while running live here instead.
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
+    mutable Vector<PropertyLookupCache> global_variable_caches;
+
     String const& get_string(StringTableIndex index) const { return string_table->get(index); }
 };
 
@@ -109,6 +149,9 @@ public:
         return m_string_table->insert(string);
     }
 
+    u32 next_property_lookup_cache() { return m_next_property_lookup_cache++; }
+    u32 next_global_variable_cache() { return m_next_global_variable_cache++; }
+
     bool is_in_generator_function() const { return m_is_in_generator_function; }
     void enter_generator_context() { m_is_in_generator_function = true; }
     void leave_generator_context() { m_is_in_generator_function = false; }
@@ -126,6 +169,8 @@ private:
 
     u32 m_next_register { 2 };
     u32 m_next_block { 1 };
+    u32 m_next_property_lookup_cache { 0 };
+    u32 m_next_global_variable_cache { 0 };
     bool m_is_in_generator_function { false };
     Vector<Label> m_continuable_scopes;
     Vector<Label> m_breakable_scopes;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <LibJS/Forward.h>
 
 #define ENUMERATE_BYTECODE_OPS(O)    \
@@ -44,6 +45,14 @@
     O(JumpConditional)               \
     O(JumpNullish)                   \
     O(JumpUndefined)                 \
+    O(JumpGreaterThan)               \
+    O(JumpGreaterThanEquals)         \
+    O(JumpLessThan)                  \
+    O(JumpLessThanEquals)            \
+    O(JumpAbstractInequals)          \
+    O(JumpAbstractEquals)            \
+    O(JumpTypedInequals)             \
+    O(JumpTypedEquals)               \
     O(Call)                          \
     O(NewFunction)                   \
     O(Return)                        \
@@ -96,6 +105,19 @@ public:
     void replace_references(BasicBlock const&, BasicBlock const&);
     static void destroy(Instruction&);
 
+    enum class RegisterAccess {
+        Read,
+        Write,
+        ReadWrite,
+    };
+    using RegisterVisitor = Function<void(Register&, RegisterAccess)>;
+
+    // Calls the visitor with every register operand, which it may change to rename the register.
+    void visit_registers(RegisterVisitor const&);
+
+    // Instructions without register operands don't need to override this.
+    void visit_registers_impl(RegisterVisitor const&) { }
+
 protected:
     explicit Instruction(Type type)
         : m_type(type)
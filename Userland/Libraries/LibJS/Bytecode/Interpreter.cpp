@@ -9,6 +9,7 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/JIT.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
@@ -69,11 +70,19 @@ Value Interpreter::run(Executable const& executable, BasicBlock const* entry_poi
 
     for (;;) {
         Bytecode::InstructionStreamIterator pc(block->instruction_stream());
+        auto* compiled_block = m_jit_enabled ? block->compiled_block() : nullptr;
         bool will_jump = false;
         bool will_return = false;
         while (!pc.at_end()) {
-            auto& instruction = *pc;
-            instruction.execute(*this);
+            if (compiled_block) {
+                // The compiled code stops right after the first instruction that leaves something for us to do below.
+                pc.jump(compiled_block->run(*this, pc.offset()));
+                if (pc.at_end())
+                    break;
+            } else {
+                auto& instruction = *pc;
+                instruction.execute(*this);
+            }
             if (vm().exception()) {
                 m_saved_exception = {};
                 if (m_unwind_contexts.is_empty())
@@ -148,6 +157,11 @@ Value Interpreter::run(Executable const& executable, BasicBlock const* entry_poi
     return return_value;
 }
 
+bool Interpreter::has_pending_control_flow()
+{
+    return vm().exception() || m_pending_jump.has_value() || !m_return_value.is_empty();
+}
+
 void Interpreter::enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target)
 {
     m_unwind_contexts.empend(handler_target.has_value() ? &handler_target->block() : nullptr, finalizer_target.has_value() ? &finalizer_target->block() : nullptr);
@@ -181,6 +195,8 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
 
     auto pm = make<PassManager>();
     if (level == OptimizationLevel::Default) {
+        pm->add<Passes::FoldConstants>();
+        pm->add<Passes::EliminateDeadStores>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::UnifySameBlocks>();
         pm->add<Passes::GenerateCFG>();
@@ -191,6 +207,10 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::MergeBlocks>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
+        pm->add<Passes::FoldConstants>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::CoalesceRegisters>();
+        pm->add<Passes::FuseCompareAndJump>();
     } else {
         VERIFY_NOT_REACHED();
     }
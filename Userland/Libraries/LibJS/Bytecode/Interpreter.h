@@ -61,6 +61,15 @@ public:
 
     Executable const& current_executable() { return *m_current_executable; }
 
+    // Runs basic blocks as machine code made by the JIT, where there is one for this platform.
+    bool is_jit_enabled() const { return m_jit_enabled; }
+    void set_jit_enabled(bool enabled) { m_jit_enabled = enabled; }
+
+    // Compiled code hands control back to run() after any instruction that threw, jumped or returned,
+    // and has to reload the registers after anything that may have run other code.
+    bool has_pending_control_flow();
+    Value* register_base() { return registers().data(); }
+
     enum class OptimizationLevel {
         Default,
         __Count,
@@ -81,6 +90,7 @@ private:
     Executable const* m_current_executable { nullptr };
     Vector<UnwindInfo> m_unwind_contexts;
     Handle<Exception> m_saved_exception;
+    bool m_jit_enabled { false };
 };
 
 }
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/JIT.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Runtime/Value.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace JS::Bytecode {
+
+CompiledBlock::CompiledBlock(u8* code, size_t code_size, HashMap<size_t, size_t> entry_points)
+    : m_code(code)
+    , m_code_size(code_size)
+    , m_entry_points(move(entry_points))
+{
+}
+
+CompiledBlock::~CompiledBlock()
+{
+    munmap(m_code, m_code_size);
+}
+
+size_t CompiledBlock::run(Interpreter& interpreter, size_t offset) const
+{
+    auto entry_point = m_entry_points.get(offset);
+    VERIFY(entry_point.has_value());
+    using EntryFunction = size_t (*)(Interpreter*, Value*, u8 const*);
+    return reinterpret_cast<EntryFunction>(m_code)(&interpreter, interpreter.register_base(), m_code + entry_point.value());
+}
+
+#if ARCH(X86_64)
+
+static_assert(sizeof(Value) == 8);
+
+// These are called from the compiled code, which keeps the Interpreter in r12 and the registers in r13.
+static Value* execute_instruction(Interpreter& interpreter, Instruction const& instruction)
+{
+    instruction.execute(interpreter);
+    if (interpreter.has_pending_control_flow())
+        return nullptr;
+    return interpreter.register_base();
+}
+
+static void jump_to_label(Interpreter& interpreter, Label const& label)
+{
+    interpreter.jump(label);
+}
+
+// Just enough of an x86-64 assembler for the code we generate.
+class Assembler {
+public:
+    enum class Reg : u8 {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RSI = 6,
+    };
+
+    enum class Condition : u8 {
+        Overflow = 0x0,
+        Zero = 0x4,
+        NotZero = 0x5,
+        Less = 0xc,
+        GreaterOrEqual = 0xd,
+        LessOrEqual = 0xe,
+        Greater = 0xf,
+    };
+
+    Vector<u8> const& bytes() const { return m_bytes; }
+    size_t position() const { return m_bytes.size(); }
+
+    template<typename... Bytes>
+    void emit(Bytes... bytes) { (m_bytes.append(static_cast<u8>(bytes)), ...); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            m_bytes.append(value >> (i * 8));
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_bytes.append(value >> (i * 8));
+    }
+
+    // mov reg, [r13 + register * 8]
+    void load(Reg reg, Register src)
+    {
+        emit(0x49, 0x8b, 0x85 | (to_underlying(reg) << 3));
+        emit32(src.index() * sizeof(Value));
+    }
+
+    // mov [r13 + register * 8], rax
+    void store_rax(Register dst)
+    {
+        emit(0x49, 0x89, 0x85);
+        emit32(dst.index() * sizeof(Value));
+    }
+
+    // mov reg, imm64
+    void move_immediate(Reg reg, u64 value)
+    {
+        emit(0x48, 0xb8 + to_underlying(reg));
+        emit64(value);
+    }
+
+    // jmp or jcc with a 32-bit displacement that link() fills in later.
+    size_t jump_forward(Optional<Condition> condition = {})
+    {
+        if (condition.has_value())
+            emit(0x0f, 0x80 + to_underlying(*condition));
+        else
+            emit(0xe9);
+        auto patch_position = position();
+        emit32(0);
+        return patch_position;
+    }
+
+    void link(size_t patch_position)
+    {
+        u32 displacement = position() - (patch_position + 4);
+        for (size_t i = 0; i < 4; ++i)
+            m_bytes[patch_position + i] = displacement >> (i * 8);
+    }
+
+    void jump_back_to(size_t target)
+    {
+        emit(0xe9);
+        emit32(static_cast<u32>(target - (position() + 4)));
+    }
+
+    // Jumps to the slow path unless the Value in reg (rax or rcx) is an int32. Clobbers rdx.
+    size_t jump_unless_int32(Reg reg)
+    {
+        emit(0x48, 0x89, 0xc2 | (to_underlying(reg) << 3)); // mov rdx, reg
+        emit(0x48, 0xc1, 0xea, Value::encoded_tag_shift);   // shr rdx, 48
+        emit(0x81, 0xfa);                                   // cmp edx, imm32
+        emit32(Value::encoded_int32_tag);
+        return jump_forward(Condition::NotZero);
+    }
+
+    // Turns the low 32 bits of rax into a Value with the given tag, and stores it in the accumulator.
+    void box_rax_and_store_in_accumulator(u16 tag)
+    {
+        move_immediate(Reg::RDX, static_cast<u64>(tag) << Value::encoded_tag_shift);
+        emit(0x48, 0x09, 0xd0); // or rax, rdx
+        store_rax(Register::accumulator());
+    }
+
+private:
+    Vector<u8> m_bytes;
+};
+
+class Compiler {
+public:
+    explicit Compiler(BasicBlock const& block)
+        : m_block(block)
+    {
+    }
+
+    void compile()
+    {
+        // The entry point is called with the Interpreter in rdi, the registers in rsi, and the code of the
+        // instruction to start at in rdx. Pushing five registers keeps the stack 16-byte aligned for our calls.
+        m_assembler.emit(0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57); // push rbx, r12, r13, r14, r15
+        m_assembler.emit(0x49, 0x89, 0xfc);                                     // mov r12, rdi
+        m_assembler.emit(0x49, 0x89, 0xf5);                                     // mov r13, rsi
+        m_assembler.emit(0xff, 0xe2);                                           // jmp rdx
+
+        // Everything jumps here to return, with the offset of the instruction it stopped at in eax.
+        m_exit_position = m_assembler.position();
+        m_assembler.emit(0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3); // pop r15, r14, r13, r12, rbx; ret
+
+        InstructionStreamIterator it(m_block.instruction_stream());
+        while (!it.at_end()) {
+            m_entry_points.set(it.offset(), m_assembler.position());
+            compile_instruction(*it, it.offset());
+            ++it;
+        }
+        leave(m_block.size());
+    }
+
+    Vector<u8> const& code() const { return m_assembler.bytes(); }
+    HashMap<size_t, size_t> take_entry_points() { return move(m_entry_points); }
+
+private:
+    using Reg = Assembler::Reg;
+    using Condition = Assembler::Condition;
+
+    void leave(size_t offset)
+    {
+        m_assembler.emit(0xb8); // mov eax, imm32
+        m_assembler.emit32(offset);
+        m_assembler.jump_back_to(m_exit_position);
+    }
+
+    void call_execute(Instruction const& instruction, size_t offset)
+    {
+        m_assembler.emit(0x4c, 0x89, 0xe7); // mov rdi, r12
+        m_assembler.move_immediate(Reg::RSI, reinterpret_cast<FlatPtr>(&instruction));
+        m_assembler.move_immediate(Reg::RAX, reinterpret_cast<FlatPtr>(&execute_instruction));
+        m_assembler.emit(0xff, 0xd0);       // call rax
+        m_assembler.emit(0x48, 0x85, 0xc0); // test rax, rax
+        auto keep_going = m_assembler.jump_forward(Condition::NotZero);
+        leave(offset);
+        m_assembler.link(keep_going);
+        m_assembler.emit(0x49, 0x89, 0xc5); // mov r13, rax
+    }
+
+    void jump_to(Label const& label, size_t offset)
+    {
+        m_assembler.emit(0x4c, 0x89, 0xe7); // mov rdi, r12
+        m_assembler.move_immediate(Reg::RSI, reinterpret_cast<FlatPtr>(&label));
+        m_assembler.move_immediate(Reg::RAX, reinterpret_cast<FlatPtr>(&jump_to_label));
+        m_assembler.emit(0xff, 0xd0); // call rax
+        leave(offset);
+    }
+
+    // Finishes an instruction with an inline fast path by jumping over its slow path, which calls execute().
+    void compile_slow_path(Vector<size_t> const& slow_path_jumps, Instruction const& instruction, size_t offset)
+    {
+        auto done = m_assembler.jump_forward();
+        for (auto jump : slow_path_jumps)
+            m_assembler.link(jump);
+        call_execute(instruction, offset);
+        m_assembler.link(done);
+    }
+
+    // lhs in rax and the accumulator in rcx, both int32.
+    Vector<size_t> load_int32_operands(Register lhs)
+    {
+        m_assembler.load(Reg::RAX, lhs);
+        m_assembler.load(Reg::RCX, Register::accumulator());
+        return { m_assembler.jump_unless_int32(Reg::RAX), m_assembler.jump_unless_int32(Reg::RCX) };
+    }
+
+    template<typename OpType>
+    void compile_int32_arithmetic(OpType const& op, size_t offset, u8 opcode)
+    {
+        auto slow_path_jumps = load_int32_operands(op.lhs());
+        m_assembler.emit(opcode, 0xc8); // add/sub/and/or/xor eax, ecx
+        if (opcode == 0x01 || opcode == 0x29)
+            slow_path_jumps.append(m_assembler.jump_forward(Condition::Overflow));
+        m_assembler.box_rax_and_store_in_accumulator(Value::encoded_int32_tag);
+        compile_slow_path(slow_path_jumps, op, offset);
+    }
+
+    void compile_int32_multiplication(Op::Mul const& op, size_t offset)
+    {
+        auto slow_path_jumps = load_int32_operands(op.lhs());
+        m_assembler.emit(0x0f, 0xaf, 0xc1); // imul eax, ecx
+        slow_path_jumps.append(m_assembler.jump_forward(Condition::Overflow));
+        // A zero result may have to be -0, which is a double.
+        m_assembler.emit(0x85, 0xc0); // test eax, eax
+        slow_path_jumps.append(m_assembler.jump_forward(Condition::Zero));
+        m_assembler.box_rax_and_store_in_accumulator(Value::encoded_int32_tag);
+        compile_slow_path(slow_path_jumps, op, offset);
+    }
+
+    template<typename OpType>
+    void compile_int32_comparison(OpType const& op, size_t offset, Condition condition)
+    {
+        auto slow_path_jumps = load_int32_operands(op.lhs());
+        m_assembler.emit(0x39, 0xc8);                                  // cmp eax, ecx
+        m_assembler.emit(0x0f, 0x90 + to_underlying(condition), 0xc0); // setcc al
+        m_assembler.emit(0x0f, 0xb6, 0xc0);                            // movzx eax, al
+        m_assembler.box_rax_and_store_in_accumulator(Value::encoded_boolean_tag);
+        compile_slow_path(slow_path_jumps, op, offset);
+    }
+
+    void compile_int32_increment(Instruction const& instruction, size_t offset, u8 modrm)
+    {
+        m_assembler.load(Reg::RAX, Register::accumulator());
+        Vector<size_t> slow_path_jumps { m_assembler.jump_unless_int32(Reg::RAX) };
+        m_assembler.emit(0x83, modrm, 0x01); // add/sub eax, 1
+        slow_path_jumps.append(m_assembler.jump_forward(Condition::Overflow));
+        m_assembler.box_rax_and_store_in_accumulator(Value::encoded_int32_tag);
+        compile_slow_path(slow_path_jumps, instruction, offset);
+    }
+
+    void compile_jump_conditional(Op::JumpConditional const& op, size_t offset)
+    {
+        // Booleans and int32s are truthy unless their low 32 bits are all zero.
+        m_assembler.load(Reg::RAX, Register::accumulator());
+        m_assembler.emit(0x48, 0x89, 0xc2);                           // mov rdx, rax
+        m_assembler.emit(0x48, 0xc1, 0xea, Value::encoded_tag_shift); // shr rdx, 48
+        m_assembler.emit(0x81, 0xfa);                                 // cmp edx, imm32
+        m_assembler.emit32(Value::encoded_boolean_tag);
+        auto is_boolean = m_assembler.jump_forward(Condition::Zero);
+        m_assembler.emit(0x81, 0xfa); // cmp edx, imm32
+        m_assembler.emit32(Value::encoded_int32_tag);
+        auto not_int32 = m_assembler.jump_forward(Condition::NotZero);
+        m_assembler.link(is_boolean);
+        m_assembler.emit(0x85, 0xc0); // test eax, eax
+        auto is_falsy = m_assembler.jump_forward(Condition::Zero);
+        jump_to(*op.true_target(), offset);
+        m_assembler.link(is_falsy);
+        jump_to(*op.false_target(), offset);
+        m_assembler.link(not_int32);
+        call_execute(op, offset);
+    }
+
+    void compile_instruction(Instruction const& instruction, size_t offset)
+    {
+        switch (instruction.type()) {
+        case Instruction::Type::Load:
+            m_assembler.load(Reg::RAX, static_cast<Op::Load const&>(instruction).src());
+            m_assembler.store_rax(Register::accumulator());
+            return;
+        case Instruction::Type::LoadImmediate:
+            m_assembler.move_immediate(Reg::RAX, static_cast<Op::LoadImmediate const&>(instruction).value().encoded());
+            m_assembler.store_rax(Register::accumulator());
+            return;
+        case Instruction::Type::Store:
+            m_assembler.load(Reg::RAX, Register::accumulator());
+            m_assembler.store_rax(static_cast<Op::Store const&>(instruction).dst());
+            return;
+        case Instruction::Type::Add:
+            compile_int32_arithmetic(static_cast<Op::Add const&>(instruction), offset, 0x01);
+            return;
+        case Instruction::Type::Sub:
+            compile_int32_arithmetic(static_cast<Op::Sub const&>(instruction), offset, 0x29);
+            return;
+        case Instruction::Type::BitwiseAnd:
+            compile_int32_arithmetic(static_cast<Op::BitwiseAnd const&>(instruction), offset, 0x21);
+            return;
+        case Instruction::Type::BitwiseOr:
+            compile_int32_arithmetic(static_cast<Op::BitwiseOr const&>(instruction), offset, 0x09);
+            return;
+        case Instruction::Type::BitwiseXor:
+            compile_int32_arithmetic(static_cast<Op::BitwiseXor const&>(instruction), offset, 0x31);
+            return;
+        case Instruction::Type::Mul:
+            compile_int32_multiplication(static_cast<Op::Mul const&>(instruction), offset);
+            return;
+        case Instruction::Type::LessThan:
+            compile_int32_comparison(static_cast<Op::LessThan const&>(instruction), offset, Condition::Less);
+            return;
+        case Instruction::Type::LessThanEquals:
+            compile_int32_comparison(static_cast<Op::LessThanEquals const&>(instruction), offset, Condition::LessOrEqual);
+            return;
+        case Instruction::Type::GreaterThan:
+            compile_int32_comparison(static_cast<Op::GreaterThan const&>(instruction), offset, Condition::Greater);
+            return;
+        case Instruction::Type::GreaterThanEquals:
+            compile_int32_comparison(static_cast<Op::GreaterThanEquals const&>(instruction), offset, Condition::GreaterOrEqual);
+            return;
+        case Instruction::Type::TypedEquals:
+            compile_int32_comparison(static_cast<Op::TypedEquals const&>(instruction), offset, Condition::Zero);
+            return;
+        case Instruction::Type::TypedInequals:
+            compile_int32_comparison(static_cast<Op::TypedInequals const&>(instruction), offset, Condition::NotZero);
+            return;
+        case Instruction::Type::Increment:
+            compile_int32_increment(instruction, offset, 0xc0);
+            return;
+        case Instruction::Type::Decrement:
+            compile_int32_increment(instruction, offset, 0xe8);
+            return;
+        case Instruction::Type::Jump:
+            jump_to(*static_cast<Op::Jump const&>(instruction).true_target(), offset);
+            return;
+        case Instruction::Type::JumpConditional:
+            compile_jump_conditional(static_cast<Op::JumpConditional const&>(instruction), offset);
+            return;
+        default:
+            call_execute(instruction, offset);
+            return;
+        }
+    }
+
+    BasicBlock const& m_block;
+    Assembler m_assembler;
+    HashMap<size_t, size_t> m_entry_points;
+    size_t m_exit_position { 0 };
+};
+
+OwnPtr<CompiledBlock> CompiledBlock::compile(BasicBlock const& block)
+{
+    Compiler compiler(block);
+    compiler.compile();
+
+    // Never writable and executable at the same time.
+    auto& code = compiler.code();
+    auto* executable_code = (u8*)mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    if (executable_code == MAP_FAILED)
+        return {};
+    memcpy(executable_code, code.data(), code.size());
+    if (mprotect(executable_code, code.size(), PROT_READ | PROT_EXEC) < 0) {
+        munmap(executable_code, code.size());
+        return {};
+    }
+    return adopt_own(*new CompiledBlock(executable_code, code.size(), compiler.take_entry_points()));
+}
+
+#else
+
+OwnPtr<CompiledBlock> CompiledBlock::compile(BasicBlock const&)
+{
+    return {};
+}
+
+#endif
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Machine code for one BasicBlock, made by the baseline JIT. Most instructions become a call to their
+// regular implementation; the common ones get inline fast paths for int32 operands that fall back to
+// that call for everything else. Either way, compiled code behaves exactly like the interpreter.
+class CompiledBlock {
+    AK_MAKE_NONCOPYABLE(CompiledBlock);
+    AK_MAKE_NONMOVABLE(CompiledBlock);
+
+public:
+    // Returns nullptr if there is no JIT for this platform, or if we can't get executable memory.
+    static OwnPtr<CompiledBlock> compile(BasicBlock const&);
+
+    ~CompiledBlock();
+
+    // Runs the block from the instruction at the given offset until an instruction throws, jumps or
+    // returns, and returns that instruction's offset. Returns the size of the block if it ran to the end.
+    size_t run(Interpreter&, size_t offset) const;
+
+private:
+    CompiledBlock(u8* code, size_t code_size, HashMap<size_t, size_t> entry_points);
+
+    u8* m_code { nullptr };
+    size_t m_code_size { 0 };
+
+    // Where the code for each instruction starts in m_code, by the instruction's offset in the block.
+    HashMap<size_t, size_t> m_entry_points;
+};
+
+}
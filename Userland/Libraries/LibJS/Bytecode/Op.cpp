@@ -14,6 +14,7 @@
 #include <LibJS/Runtime/BigInt.h>
 #include <LibJS/Runtime/DeclarativeEnvironment.h>
 #include <LibJS/Runtime/Environment.h>
+#include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/IteratorOperations.h>
 #include <LibJS/Runtime/OrdinaryFunctionObject.h>
@@ -90,6 +91,26 @@ static Value typed_equals(GlobalObject&, Value src1, Value src2)
 
 JS_ENUMERATE_COMMON_BINARY_OPS(JS_DEFINE_COMMON_BINARY_OP)
 
+#define JS_DEFINE_COMPARE_AND_JUMP_OP(OpTitleCase, ComparisonTitleCase, comparison_snake_case)                     \
+    void OpTitleCase::execute_impl(Bytecode::Interpreter& interpreter) const                                       \
+    {                                                                                                              \
+        auto lhs = interpreter.reg(m_lhs_reg);                                                                     \
+        auto rhs = interpreter.accumulator();                                                                      \
+        interpreter.accumulator() = comparison_snake_case(interpreter.global_object(), lhs, rhs);                  \
+        if (interpreter.vm().exception())                                                                          \
+            return;                                                                                                \
+        if (interpreter.accumulator().to_boolean())                                                                \
+            interpreter.jump(m_true_target.value());                                                               \
+        else                                                                                                       \
+            interpreter.jump(m_false_target.value());                                                              \
+    }                                                                                                              \
+    String OpTitleCase::to_string_impl(Bytecode::Executable const&) const                                          \
+    {                                                                                                              \
+        return String::formatted(#OpTitleCase " {} true:{} false:{}", m_lhs_reg, *m_true_target, *m_false_target); \
+    }
+
+JS_ENUMERATE_COMPARE_AND_JUMP_OPS(JS_DEFINE_COMPARE_AND_JUMP_OP)
+
 static Value not_(GlobalObject&, Value value)
 {
     return Value(!value.to_boolean());
@@ -215,26 +236,113 @@ void ConcatString::execute_impl(Bytecode::Interpreter& interpreter) const
     interpreter.reg(m_lhs) = add(interpreter.global_object(), interpreter.reg(m_lhs), interpreter.accumulator());
 }
 
+static Optional<u32> lookup_cached_data_property(PropertyLookupCache& cache, Object const& object)
+{
+    auto offset = cache.lookup(object.shape());
+    // A data property turning into an accessor with the same attributes keeps the shape, so check the slot too.
+    if (offset.has_value() && !object.get_direct(*offset).is_accessor()) {
+        ++cache.hits;
+        return offset;
+    }
+    ++cache.misses;
+    return {};
+}
+
+static Value get_and_cache_property(PropertyLookupCache& cache, Object const& object, PropertyName const& property_name)
+{
+    CacheablePropertyMetadata cacheable_metadata;
+    auto value = object.get(property_name, &cacheable_metadata);
+    if (cacheable_metadata.property_offset.has_value())
+        cache.remember(object.shape(), *cacheable_metadata.property_offset);
+    return value;
+}
+
+static void set_and_cache_property(PropertyLookupCache& cache, Object& object, PropertyName const& property_name, Value value, Object::ShouldThrowExceptions throw_exceptions)
+{
+    auto* shape_before = &object.shape();
+    auto serial_number_before = shape_before->serial_number();
+    CacheablePropertyMetadata cacheable_metadata;
+    auto success = object.set(property_name, value, throw_exceptions, &cacheable_metadata);
+    if (success && cacheable_metadata.property_offset.has_value() && &object.shape() == shape_before && shape_before->serial_number() == serial_number_before)
+        cache.remember(*shape_before, *cacheable_metadata.property_offset);
+}
+
+// In top level code, the global object is the first place a binding is looked for. So as long as it has the
+// binding as a plain data property, we can skip the environment lookup and go straight to its storage.
+static bool is_looking_up_global_binding(Bytecode::Interpreter& interpreter)
+{
+    return interpreter.vm().lexical_environment() == &interpreter.global_object().environment();
+}
+
 void GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    interpreter.accumulator() = interpreter.vm().get_variable(interpreter.current_executable().get_string(m_identifier), interpreter.global_object());
+    auto& global_object = interpreter.global_object();
+    auto const& name = interpreter.current_executable().get_string(m_identifier);
+
+    if (is_looking_up_global_binding(interpreter)) {
+        auto& cache = interpreter.current_executable().global_variable_caches[m_cache_index];
+        if (auto offset = lookup_cached_data_property(cache, global_object); offset.has_value()) {
+            interpreter.accumulator() = global_object.get_direct(*offset);
+            return;
+        }
+        if (global_object.storage_has(name)) {
+            interpreter.accumulator() = get_and_cache_property(cache, global_object, name);
+            return;
+        }
+    }
+
+    interpreter.accumulator() = interpreter.vm().get_variable(name, global_object);
 }
 
 void SetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    interpreter.vm().set_variable(interpreter.current_executable().get_string(m_identifier), interpreter.accumulator(), interpreter.global_object());
+    auto& global_object = interpreter.global_object();
+    auto const& name = interpreter.current_executable().get_string(m_identifier);
+    auto value = interpreter.accumulator();
+
+    if (is_looking_up_global_binding(interpreter)) {
+        auto& cache = interpreter.current_executable().global_variable_caches[m_cache_index];
+        if (auto offset = lookup_cached_data_property(cache, global_object); offset.has_value()) {
+            global_object.put_direct(*offset, value);
+            return;
+        }
+        if (global_object.storage_has(name)) {
+            // VM::set_variable() reads the binding before assigning to it, which is only observable if it's an accessor.
+            (void)global_object.get(name);
+            if (interpreter.vm().exception())
+                return;
+            set_and_cache_property(cache, global_object, name, value, Object::ShouldThrowExceptions::No);
+            return;
+        }
+    }
+
+    interpreter.vm().set_variable(name, value, global_object);
 }
 
 void GetById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    if (auto* object = interpreter.accumulator().to_object(interpreter.global_object()))
-        interpreter.accumulator() = object->get(interpreter.current_executable().get_string(m_property));
+    auto* object = interpreter.accumulator().to_object(interpreter.global_object());
+    if (!object)
+        return;
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (auto offset = lookup_cached_data_property(cache, *object); offset.has_value()) {
+        interpreter.accumulator() = object->get_direct(*offset);
+        return;
+    }
+    interpreter.accumulator() = get_and_cache_property(cache, *object, interpreter.current_executable().get_string(m_property));
 }
 
 void PutById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    if (auto* object = interpreter.reg(m_base).to_object(interpreter.global_object()))
-        object->set(interpreter.current_executable().get_string(m_property), interpreter.accumulator(), Object::ShouldThrowExceptions::Yes);
+    auto* object = interpreter.reg(m_base).to_object(interpreter.global_object());
+    if (!object)
+        return;
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (auto offset = lookup_cached_data_property(cache, *object); offset.has_value()) {
+        object->put_direct(*offset, interpreter.accumulator());
+        return;
+    }
+    set_and_cache_property(cache, *object, interpreter.current_executable().get_string(m_property), interpreter.accumulator(), Object::ShouldThrowExceptions::Yes);
 }
 
 void Jump::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -539,22 +647,22 @@ String ConcatString::to_string_impl(Bytecode::Executable const&) const
 
 String GetVariable::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("GetVariable {} ({})", m_identifier, executable.string_table->get(m_identifier));
+    return String::formatted("GetVariable {} ({}), cache:{}", m_identifier, executable.string_table->get(m_identifier), m_cache_index);
 }
 
 String SetVariable::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("SetVariable {} ({})", m_identifier, executable.string_table->get(m_identifier));
+    return String::formatted("SetVariable {} ({}), cache:{}", m_identifier, executable.string_table->get(m_identifier), m_cache_index);
 }
 
 String PutById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("PutById base:{}, property:{} ({})", m_base, m_property, executable.string_table->get(m_property));
+    return String::formatted("PutById base:{}, property:{} ({}), cache:{}", m_base, m_property, executable.string_table->get(m_property), m_cache_index);
 }
 
 String GetById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("GetById {} ({})", m_property, executable.string_table->get(m_property));
+    return String::formatted("GetById {} ({}), cache:{}", m_property, executable.string_table->get(m_property), m_cache_index);
 }
 
 String Jump::to_string_impl(Bytecode::Executable const&) const
@@ -30,6 +30,9 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor) { visitor(m_src, RegisterAccess::Read); }
+
+    Register src() const { return m_src; }
 
 private:
     Register m_src;
@@ -47,6 +50,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -62,6 +67,9 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor) { visitor(m_dst, RegisterAccess::Write); }
+
+    Register dst() const { return m_dst; }
 
 private:
     Register m_dst;
@@ -103,6 +111,12 @@ private:
         void execute_impl(Bytecode::Interpreter&) const;                       \
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
+        void visit_registers_impl(RegisterVisitor const& visitor)              \
+        {                                                                      \
+            visitor(m_lhs_reg, RegisterAccess::Read);                          \
+        }                                                                      \
+                                                                               \
+        Register lhs() const { return m_lhs_reg; }                             \
                                                                                \
     private:                                                                   \
         Register m_lhs_reg;                                                    \
@@ -195,6 +209,12 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_from_object, RegisterAccess::Read);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            visitor(m_excluded_names[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
@@ -240,6 +260,11 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        for (size_t i = 0; i < m_element_count; ++i)
+            visitor(m_elements[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const
     {
@@ -274,6 +299,7 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor) { visitor(m_lhs, RegisterAccess::ReadWrite); }
 
 private:
     Register m_lhs;
@@ -281,9 +307,10 @@ private:
 
 class SetVariable final : public Instruction {
 public:
-    explicit SetVariable(StringTableIndex identifier)
+    explicit SetVariable(StringTableIndex identifier, u32 cache_index)
         : Instruction(Type::SetVariable)
         , m_identifier(identifier)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -293,13 +320,15 @@ public:
 
 private:
     StringTableIndex m_identifier;
+    u32 m_cache_index { 0 };
 };
 
 class GetVariable final : public Instruction {
 public:
-    explicit GetVariable(StringTableIndex identifier)
+    explicit GetVariable(StringTableIndex identifier, u32 cache_index)
         : Instruction(Type::GetVariable)
         , m_identifier(identifier)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -309,13 +338,15 @@ public:
 
 private:
     StringTableIndex m_identifier;
+    u32 m_cache_index { 0 };
 };
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(StringTableIndex property)
+    explicit GetById(StringTableIndex property, u32 cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -325,24 +356,28 @@ public:
 
 private:
     StringTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, StringTableIndex property)
+    explicit PutById(Register base, StringTableIndex property, u32 cache_index)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor) { visitor(m_base, RegisterAccess::Read); }
 
 private:
     Register m_base;
     StringTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 class GetByValue final : public Instruction {
@@ -356,6 +391,7 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor) { visitor(m_base, RegisterAccess::Read); }
 
 private:
     Register m_base;
@@ -373,6 +409,11 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_base, RegisterAccess::Read);
+        visitor(m_property, RegisterAccess::Read);
+    }
 
 private:
     Register m_base;
@@ -448,6 +489,42 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
 };
 
+// A comparison followed by a JumpConditional on its result, fused together by the FuseCompareAndJump pass.
+#define JS_ENUMERATE_COMPARE_AND_JUMP_OPS(O)                         \
+    O(JumpGreaterThan, GreaterThan, greater_than)                    \
+    O(JumpGreaterThanEquals, GreaterThanEquals, greater_than_equals) \
+    O(JumpLessThan, LessThan, less_than)                             \
+    O(JumpLessThanEquals, LessThanEquals, less_than_equals)          \
+    O(JumpAbstractInequals, AbstractInequals, abstract_inequals)     \
+    O(JumpAbstractEquals, AbstractEquals, abstract_equals)           \
+    O(JumpTypedInequals, TypedInequals, typed_inequals)              \
+    O(JumpTypedEquals, TypedEquals, typed_equals)
+
+#define JS_DECLARE_COMPARE_AND_JUMP_OP(OpTitleCase, ComparisonTitleCase, comparison_snake_case)  \
+    class OpTitleCase final : public Jump {                                                      \
+    public:                                                                                      \
+        OpTitleCase(Register lhs_reg, Optional<Label> true_target, Optional<Label> false_target) \
+            : Jump(Type::OpTitleCase, move(true_target), move(false_target))                     \
+            , m_lhs_reg(lhs_reg)                                                                 \
+        {                                                                                        \
+        }                                                                                        \
+                                                                                                 \
+        void execute_impl(Bytecode::Interpreter&) const;                                         \
+        String to_string_impl(Bytecode::Executable const&) const;                                \
+        void visit_registers_impl(RegisterVisitor const& visitor)                                \
+        {                                                                                        \
+            visitor(m_lhs_reg, RegisterAccess::Read);                                            \
+        }                                                                                        \
+                                                                                                 \
+        Register lhs() const { return m_lhs_reg; }                                               \
+                                                                                                 \
+    private:                                                                                     \
+        Register m_lhs_reg;                                                                      \
+    };
+
+JS_ENUMERATE_COMPARE_AND_JUMP_OPS(JS_DECLARE_COMPARE_AND_JUMP_OP)
+#undef JS_DECLARE_COMPARE_AND_JUMP_OP
+
 // NOTE: This instruction is variable-width depending on the number of arguments!
 class Call final : public Instruction {
 public:
@@ -470,6 +547,13 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_callee, RegisterAccess::Read);
+        visitor(m_this_value, RegisterAccess::Read);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            visitor(m_arguments[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const
     {
@@ -749,6 +833,21 @@ ALWAYS_INLINE void Instruction::replace_references(BasicBlock const& from, Basic
 #undef __BYTECODE_OP
 }
 
+ALWAYS_INLINE void Instruction::visit_registers(RegisterVisitor const& visitor)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return static_cast<Bytecode::Op::op&>(*this).visit_registers_impl(visitor);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::Call)
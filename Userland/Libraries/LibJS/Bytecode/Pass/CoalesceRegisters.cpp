@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+struct RegisterUse {
+    BasicBlock const* block { nullptr };
+    bool is_used_in_other_blocks { false };
+    // A register that is read before it's written in its block gets its value from somewhere else.
+    bool is_read_before_written { false };
+    size_t first_use { 0 };
+    size_t last_use { 0 };
+};
+
+template<typename Callback>
+static void for_each_register_operand(BasicBlock const& block, Callback callback)
+{
+    size_t position = 0;
+    InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        auto& instruction = const_cast<Instruction&>(*it);
+        ++it;
+        instruction.visit_registers([&](Register& reg, Instruction::RegisterAccess access) {
+            callback(reg, access, position);
+        });
+        ++position;
+    }
+}
+
+void CoalesceRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+
+    HashMap<u32, RegisterUse> uses;
+    for (auto& block : basic_blocks) {
+        for_each_register_operand(block, [&](Register& reg, Instruction::RegisterAccess access, size_t position) {
+            if (reg.index() <= Register::global_object_index)
+                return;
+            auto it = uses.find(reg.index());
+            if (it == uses.end()) {
+                uses.set(reg.index(), { &block, false, access != Instruction::RegisterAccess::Write, position, position });
+                return;
+            }
+            if (it->value.block != &block)
+                it->value.is_used_in_other_blocks = true;
+            it->value.last_use = position;
+        });
+    }
+
+    // Registers that carry values between blocks keep a register of their own, numbered in their original order.
+    Vector<u32> global_registers;
+    for (auto& entry : uses) {
+        if (entry.value.is_used_in_other_blocks || entry.value.is_read_before_written)
+            global_registers.append(entry.key);
+    }
+    quick_sort(global_registers);
+
+    HashMap<u32, u32> new_indices;
+    u32 next_index = Register::global_object_index + 1;
+    for (auto index : global_registers)
+        new_indices.set(index, next_index++);
+
+    // The block-local registers are then packed into the registers after those, reusing a register as soon as
+    // the live range of the previous temporary in it has ended.
+    u32 first_local_index = next_index;
+    u32 local_register_count = 0;
+    for (auto& block : basic_blocks) {
+        Vector<u32> block_locals;
+        for (auto& entry : uses) {
+            if (entry.value.block == &block && !new_indices.contains(entry.key))
+                block_locals.append(entry.key);
+        }
+        quick_sort(block_locals, [&](u32 a, u32 b) { return uses.get(a)->first_use < uses.get(b)->first_use; });
+
+        Vector<size_t> slot_free_after;
+        for (auto index : block_locals) {
+            auto& use = uses.find(index)->value;
+            Optional<size_t> free_slot;
+            for (size_t slot = 0; slot < slot_free_after.size(); ++slot) {
+                if (slot_free_after[slot] < use.first_use) {
+                    free_slot = slot;
+                    break;
+                }
+            }
+            if (!free_slot.has_value()) {
+                free_slot = slot_free_after.size();
+                slot_free_after.append(0);
+            }
+            slot_free_after[*free_slot] = use.last_use;
+            new_indices.set(index, first_local_index + *free_slot);
+        }
+        local_register_count = max(local_register_count, static_cast<u32>(slot_free_after.size()));
+    }
+
+    for (auto& block : basic_blocks) {
+        for_each_register_operand(block, [&](Register& reg, Instruction::RegisterAccess, size_t) {
+            if (auto new_index = new_indices.get(reg.index()); new_index.has_value())
+                reg = Register { *new_index };
+        });
+    }
+    executable.executable.number_of_registers = min(executable.executable.number_of_registers, static_cast<size_t>(first_local_index + local_register_count));
+
+    finished();
+}
+
+}
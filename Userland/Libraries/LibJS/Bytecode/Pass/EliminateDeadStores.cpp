@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static HashTable<u32> collect_read_registers(Executable const& executable)
+{
+    HashTable<u32> read_registers;
+    for (auto& block : executable.basic_blocks) {
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = *it;
+            ++it;
+            const_cast<Instruction&>(instruction).visit_registers([&](Register& reg, Instruction::RegisterAccess access) {
+                if (access != Instruction::RegisterAccess::Write)
+                    read_registers.set(reg.index());
+            });
+        }
+    }
+    return read_registers;
+}
+
+// Instructions that overwrite the accumulator without reading it first.
+static bool overwrites_accumulator(Instruction::Type type)
+{
+    switch (type) {
+    case Instruction::Type::Load:
+    case Instruction::Type::LoadImmediate:
+    case Instruction::Type::NewString:
+    case Instruction::Type::NewObject:
+    case Instruction::Type::GetVariable:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool eliminate_dead_stores(BasicBlock& block, HashTable<u32> const& read_registers)
+{
+    Vector<Instruction const*> instructions;
+    InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        instructions.append(&*it);
+        ++it;
+    }
+
+    // Walk the block backwards, keeping track of whether anything is going to read the accumulator. Whatever
+    // comes after the block may read it, as may whoever sees the exception if something throws along the way.
+    HashTable<Instruction const*> dead_instructions;
+    bool accumulator_is_live = true;
+    for (size_t i = instructions.size(); i > 0; --i) {
+        auto& instruction = *instructions[i - 1];
+        switch (instruction.type()) {
+        case Instruction::Type::Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst();
+            if (dst.index() > Register::global_object_index && !read_registers.contains(dst.index()))
+                dead_instructions.set(&instruction);
+            else
+                accumulator_is_live = true;
+            break;
+        }
+        case Instruction::Type::Load:
+        case Instruction::Type::LoadImmediate:
+            if (!accumulator_is_live)
+                dead_instructions.set(&instruction);
+            accumulator_is_live = false;
+            break;
+        default:
+            accumulator_is_live = !overwrites_accumulator(instruction.type());
+            break;
+        }
+    }
+
+    if (dead_instructions.is_empty())
+        return false;
+
+    BlockRewriter rewriter(block);
+    for (auto* instruction : instructions) {
+        if (dead_instructions.contains(instruction))
+            rewriter.drop(*instruction);
+        else
+            rewriter.keep(*instruction);
+    }
+    rewriter.finish();
+    return true;
+}
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    // Removing a Load may leave nothing reading a register, which makes the stores to it dead too.
+    for (;;) {
+        auto read_registers = collect_read_registers(executable.executable);
+        bool did_change = false;
+        for (auto& block : executable.executable.basic_blocks)
+            did_change |= eliminate_dead_stores(block, read_registers);
+        if (!did_change)
+            break;
+    }
+
+    finished();
+}
+
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static Optional<i32> as_exact_i32(Value value)
+{
+    if (!value.is_integral_number() || value.as_double() < NumericLimits<i32>::min() || value.as_double() > NumericLimits<i32>::max())
+        return {};
+    return static_cast<i32>(value.as_double());
+}
+
+// Only operations on numbers are folded, since those can't have side effects or throw, and don't need a GlobalObject.
+static Optional<Value> fold_binary_op(Instruction::Type type, Value lhs, Value rhs)
+{
+    if (!lhs.is_number() || !rhs.is_number())
+        return {};
+
+    auto a = lhs.as_double();
+    auto b = rhs.as_double();
+    switch (type) {
+    case Instruction::Type::Add:
+        return Value(a + b);
+    case Instruction::Type::Sub:
+        return Value(a - b);
+    case Instruction::Type::Mul:
+        return Value(a * b);
+    case Instruction::Type::Div:
+        return Value(a / b);
+    case Instruction::Type::LessThan:
+        return Value(a < b);
+    case Instruction::Type::LessThanEquals:
+        return Value(a <= b);
+    case Instruction::Type::GreaterThan:
+        return Value(a > b);
+    case Instruction::Type::GreaterThanEquals:
+        return Value(a >= b);
+    case Instruction::Type::AbstractEquals:
+    case Instruction::Type::TypedEquals:
+        return Value(a == b);
+    case Instruction::Type::AbstractInequals:
+    case Instruction::Type::TypedInequals:
+        return Value(a != b);
+    default:
+        break;
+    }
+
+    auto maybe_x = as_exact_i32(lhs);
+    auto maybe_y = as_exact_i32(rhs);
+    if (!maybe_x.has_value() || !maybe_y.has_value())
+        return {};
+
+    auto x = *maybe_x;
+    auto y = *maybe_y;
+    switch (type) {
+    case Instruction::Type::BitwiseAnd:
+        return Value(x & y);
+    case Instruction::Type::BitwiseOr:
+        return Value(x | y);
+    case Instruction::Type::BitwiseXor:
+        return Value(x ^ y);
+    case Instruction::Type::LeftShift:
+        return Value(static_cast<i32>(static_cast<u32>(x) << (y & 31)));
+    case Instruction::Type::RightShift:
+        return Value(x >> (y & 31));
+    case Instruction::Type::UnsignedRightShift:
+        return Value(static_cast<u32>(x) >> (y & 31));
+    default:
+        return {};
+    }
+}
+
+static Optional<Value> fold_unary_op(Instruction::Type type, Value value)
+{
+    if (value.is_cell())
+        return {};
+
+    switch (type) {
+    case Instruction::Type::Not:
+        return Value(!value.to_boolean());
+    case Instruction::Type::UnaryMinus:
+        if (value.is_number())
+            return Value(-value.as_double());
+        return {};
+    case Instruction::Type::UnaryPlus:
+        if (value.is_number())
+            return value;
+        return {};
+    case Instruction::Type::BitwiseNot:
+        if (auto x = as_exact_i32(value); x.has_value())
+            return Value(~*x);
+        return {};
+    default:
+        return {};
+    }
+}
+
+static void fold_constants(BasicBlock& block)
+{
+    BlockRewriter rewriter(block);
+
+    // What we know about the accumulator and the registers at the current instruction. Only Store, ConcatString
+    // and the accumulator itself ever change a register, so the registers survive everything else.
+    Optional<Value> accumulator;
+    HashMap<u32, Value> registers;
+
+    auto replace_with_constant = [&](Instruction const& instruction, Value value) {
+        rewriter.drop(instruction);
+        rewriter.emit<Op::LoadImmediate>(value);
+        accumulator = value;
+    };
+
+    auto fold_jump = [&](Op::Jump const& jump, bool taken) {
+        auto target = taken ? jump.true_target() : jump.false_target();
+        rewriter.drop(jump);
+        rewriter.emit<Op::Jump>(move(target));
+    };
+
+    InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        ++it;
+
+        switch (instruction.type()) {
+        case Instruction::Type::LoadImmediate:
+            accumulator = static_cast<Op::LoadImmediate const&>(instruction).value();
+            rewriter.keep(instruction);
+            continue;
+        case Instruction::Type::Load:
+            if (auto value = registers.get(static_cast<Op::Load const&>(instruction).src().index()); value.has_value()) {
+                replace_with_constant(instruction, *value);
+                continue;
+            }
+            accumulator = {};
+            rewriter.keep(instruction);
+            continue;
+        case Instruction::Type::Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            // Cells aren't propagated, since the instructions holding them aren't visited by the garbage collector.
+            if (accumulator.has_value() && !accumulator->is_cell())
+                registers.set(dst, *accumulator);
+            else
+                registers.remove(dst);
+            rewriter.keep(instruction);
+            continue;
+        }
+#define __BYTECODE_OP(OpTitleCase, op_snake_case)                                                                       \
+    case Instruction::Type::OpTitleCase: {                                                                              \
+        auto lhs = registers.get(static_cast<Op::OpTitleCase const&>(instruction).lhs().index());                       \
+        if (lhs.has_value() && accumulator.has_value()) {                                                               \
+            if (auto result = fold_binary_op(Instruction::Type::OpTitleCase, *lhs, *accumulator); result.has_value()) { \
+                replace_with_constant(instruction, *result);                                                            \
+                continue;                                                                                               \
+            }                                                                                                           \
+        }                                                                                                               \
+        break;                                                                                                          \
+    }
+            JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        case Instruction::Type::Not:
+        case Instruction::Type::UnaryMinus:
+        case Instruction::Type::UnaryPlus:
+        case Instruction::Type::BitwiseNot:
+            if (accumulator.has_value()) {
+                if (auto result = fold_unary_op(instruction.type(), *accumulator); result.has_value()) {
+                    replace_with_constant(instruction, *result);
+                    continue;
+                }
+            }
+            break;
+        case Instruction::Type::JumpConditional:
+            if (accumulator.has_value() && !accumulator->is_cell()) {
+                fold_jump(static_cast<Op::Jump const&>(instruction), accumulator->to_boolean());
+                continue;
+            }
+            break;
+        case Instruction::Type::JumpNullish:
+            if (accumulator.has_value()) {
+                fold_jump(static_cast<Op::Jump const&>(instruction), accumulator->is_nullish());
+                continue;
+            }
+            break;
+        case Instruction::Type::JumpUndefined:
+            if (accumulator.has_value()) {
+                fold_jump(static_cast<Op::Jump const&>(instruction), accumulator->is_undefined());
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // We don't know what this instruction does to the accumulator, but we do know which registers it writes.
+        accumulator = {};
+        const_cast<Instruction&>(instruction).visit_registers([&](Register& reg, Instruction::RegisterAccess access) {
+            if (access != Instruction::RegisterAccess::Read)
+                registers.remove(reg.index());
+        });
+        rewriter.keep(instruction);
+    }
+
+    rewriter.finish();
+}
+
+void FoldConstants::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        fold_constants(block);
+
+    finished();
+}
+
+}
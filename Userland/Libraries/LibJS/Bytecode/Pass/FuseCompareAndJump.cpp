@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static void fuse_compare_and_jump(BasicBlock& block)
+{
+    BlockRewriter rewriter(block);
+
+    InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        ++it;
+
+        if (it.at_end() || (*it).type() != Instruction::Type::JumpConditional) {
+            rewriter.keep(instruction);
+            continue;
+        }
+
+        auto& jump = static_cast<Op::JumpConditional const&>(*it);
+        switch (instruction.type()) {
+#define __BYTECODE_OP(OpTitleCase, ComparisonTitleCase, comparison_snake_case)        \
+    case Instruction::Type::ComparisonTitleCase: {                                    \
+        auto lhs = static_cast<Op::ComparisonTitleCase const&>(instruction).lhs();    \
+        rewriter.emit<Op::OpTitleCase>(lhs, jump.true_target(), jump.false_target()); \
+        ++it;                                                                         \
+        rewriter.drop(instruction);                                                   \
+        rewriter.drop(jump);                                                          \
+        continue;                                                                     \
+    }
+            JS_ENUMERATE_COMPARE_AND_JUMP_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        default:
+            rewriter.keep(instruction);
+            continue;
+        }
+    }
+
+    rewriter.finish();
+}
+
+void FuseCompareAndJump::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        fuse_compare_and_jump(block);
+
+    finished();
+}
+
+}
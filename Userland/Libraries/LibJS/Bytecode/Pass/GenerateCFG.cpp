@@ -58,7 +58,13 @@ void GenerateCFG::perform(PassPipelineExecutable& executable)
             continue;
         }
 
-        if (instruction.type() == Instruction::Type::JumpConditional || instruction.type() == Instruction::Type::JumpNullish || instruction.type() == Instruction::Type::JumpUndefined) {
+        bool is_conditional_jump = instruction.type() == Instruction::Type::JumpConditional || instruction.type() == Instruction::Type::JumpNullish || instruction.type() == Instruction::Type::JumpUndefined;
+#define __BYTECODE_OP(op, ...) \
+    is_conditional_jump |= instruction.type() == Instruction::Type::op;
+        JS_ENUMERATE_COMPARE_AND_JUMP_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+
+        if (is_conditional_jump) {
             auto& true_target = static_cast<Op::Jump const&>(instruction).true_target();
             enter_label(true_target, current_block);
             auto& false_target = static_cast<Op::Jump const&>(instruction).false_target();
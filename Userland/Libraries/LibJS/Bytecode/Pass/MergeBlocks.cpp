@@ -150,6 +150,17 @@ void MergeBlocks::perform(PassPipelineExecutable& executable)
             }
             __builtin_memcpy(block.next_slot(), entry->instruction_stream().data(), copy_end);
             block.grow(copy_end);
+
+            // The copied instructions belong to the new block now, only the terminator that was left behind is destroyed.
+            InstructionStreamIterator rest { entry->instruction_stream() };
+            while (!rest.at_end()) {
+                auto offset = rest.offset();
+                auto& instruction = *rest;
+                ++rest;
+                if (offset >= copy_end)
+                    Instruction::destroy(const_cast<Instruction&>(instruction));
+            }
+            const_cast<BasicBlock*>(entry)->forget_instructions();
         }
 
         auto first_successor_position = replace_blocks(successors, *new_block);
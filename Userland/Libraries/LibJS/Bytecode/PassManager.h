@@ -26,6 +26,8 @@ public:
     virtual ~Pass() = default;
 
     virtual void perform(PassPipelineExecutable&) = 0;
+    virtual StringView name() const = 0;
+
     void started()
     {
         gettimeofday(&m_start_time, nullptr);
@@ -79,10 +81,59 @@ public:
         finished();
     }
 
+    virtual StringView name() const override { return "PassManager"sv; }
+
+    // Logs how long each of the passes took the last time they ran.
+    void dump_timings() const
+    {
+        for (auto& pass : m_passes)
+            dbgln("  {}: {}us", pass.name(), pass.elapsed());
+    }
+
 private:
     NonnullOwnPtrVector<Pass> m_passes;
 };
 
+// Builds a new instruction stream for a block, for passes that replace or remove instructions. The block
+// itself stays the same object, so the Labels pointing at it stay valid.
+class BlockRewriter {
+public:
+    explicit BlockRewriter(BasicBlock& block)
+        : m_block(block)
+        // Nothing is ever replaced with something more than four times its size.
+        , m_new_block(BasicBlock::create(block.name(), block.size() * 4))
+    {
+    }
+
+    // Every instruction of the block has to be either kept or dropped, in order, before calling finish().
+    void keep(Instruction const& instruction)
+    {
+        auto length = instruction.length();
+        VERIFY(m_new_block->can_grow(length));
+        __builtin_memcpy(m_new_block->next_slot(), &instruction, length);
+        m_new_block->grow(length);
+    }
+
+    void drop(Instruction const& instruction)
+    {
+        Instruction::destroy(const_cast<Instruction&>(instruction));
+    }
+
+    template<typename OpType, typename... Args>
+    void emit(Args&&... args)
+    {
+        VERIFY(m_new_block->can_grow(sizeof(OpType)));
+        new (m_new_block->next_slot()) OpType(forward<Args>(args)...);
+        m_new_block->grow(sizeof(OpType));
+    }
+
+    void finish() { m_block.adopt_instruction_stream(*m_new_block); }
+
+private:
+    BasicBlock& m_block;
+    NonnullOwnPtr<BasicBlock> m_new_block;
+};
+
 namespace Passes {
 
 class GenerateCFG : public Pass {
@@ -90,6 +141,8 @@ public:
     GenerateCFG() = default;
     ~GenerateCFG() override = default;
 
+    virtual StringView name() const override { return "GenerateCFG"sv; }
+
 private:
     virtual void perform(PassPipelineExecutable&) override;
 };
@@ -99,6 +152,8 @@ public:
     MergeBlocks() = default;
     ~MergeBlocks() override = default;
 
+    virtual StringView name() const override { return "MergeBlocks"sv; }
+
 private:
     virtual void perform(PassPipelineExecutable&) override;
 };
@@ -108,6 +163,8 @@ public:
     PlaceBlocks() = default;
     ~PlaceBlocks() override = default;
 
+    virtual StringView name() const override { return "PlaceBlocks"sv; }
+
 private:
     virtual void perform(PassPipelineExecutable&) override;
 };
@@ -117,6 +174,59 @@ public:
     UnifySameBlocks() = default;
     ~UnifySameBlocks() override = default;
 
+    virtual StringView name() const override { return "UnifySameBlocks"sv; }
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Folds operations on constant numbers and booleans, propagates constants from registers
+// within each block, and turns conditional jumps on a constant into plain jumps.
+class FoldConstants : public Pass {
+public:
+    FoldConstants() = default;
+    ~FoldConstants() override = default;
+
+    virtual StringView name() const override { return "FoldConstants"sv; }
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Removes stores to registers that nothing reads, and loads into the accumulator that are
+// overwritten before anything reads them.
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    ~EliminateDeadStores() override = default;
+
+    virtual StringView name() const override { return "EliminateDeadStores"sv; }
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Temporaries that live within a single block only need a register while they are alive, so
+// they share as few registers as their live ranges allow. Registers used across blocks keep their own.
+class CoalesceRegisters : public Pass {
+public:
+    CoalesceRegisters() = default;
+    ~CoalesceRegisters() override = default;
+
+    virtual StringView name() const override { return "CoalesceRegisters"sv; }
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Fuses comparisons with the JumpConditional that branches on their result.
+class FuseCompareAndJump : public Pass {
+public:
+    FuseCompareAndJump() = default;
+    ~FuseCompareAndJump() override = default;
+
+    virtual StringView name() const override { return "FuseCompareAndJump"sv; }
+
 private:
     virtual void perform(PassPipelineExecutable&) override;
 };
@@ -130,6 +240,8 @@ public:
 
     ~DumpCFG() override = default;
 
+    virtual StringView name() const override { return "DumpCFG"sv; }
+
 private:
     virtual void perform(PassPipelineExecutable&) override;
 
@@ -170,6 +170,7 @@ class Value;
 class WeakContainer;
 enum class DeclarationKind;
 struct AlreadyResolved;
+struct CacheablePropertyMetadata;
 struct JobCallback;
 struct PromiseCapability;
 
@@ -210,6 +211,7 @@ class Handle;
 
 namespace Bytecode {
 class BasicBlock;
+class CompiledBlock;
 struct Executable;
 class Generator;
 class Instruction;
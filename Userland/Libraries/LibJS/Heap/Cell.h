@@ -53,6 +53,10 @@ public:
     virtual bool is_environment() const { return false; }
     virtual void visit_edges(Visitor&) { }
 
+    // Called when the cell has been found to be dead, but won't be destroyed until its block gets swept.
+    // Cells that can still be found by other means than their edges have to stop being findable here.
+    virtual void did_become_unreachable() { }
+
     Heap& heap() const;
     VM& vm() const;
 
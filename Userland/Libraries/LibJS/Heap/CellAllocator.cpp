@@ -23,6 +23,11 @@ CellAllocator::~CellAllocator()
 
 Cell* CellAllocator::allocate_cell(Heap& heap)
 {
+    // A cell allocated in a block that hasn't been swept yet would look just as dead as the ones that
+    // are already there, so those blocks get swept before we hand out any of their cells.
+    while (!m_usable_blocks.is_empty() && m_usable_blocks.last()->needs_sweep())
+        heap.sweep_block({}, *m_usable_blocks.last());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
         m_usable_blocks.append(*block.leak_ptr());
@@ -5,8 +5,10 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/BinarySearch.h>
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/StackInfo.h>
 #include <AK/TemporaryChange.h>
 #include <LibCore/ElapsedTimer.h>
@@ -74,6 +76,10 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 
     Core::ElapsedTimer collection_measurement_timer;
     collection_measurement_timer.start();
+
+    // Whatever the last collection left behind has to be gone before we can mark again.
+    finish_sweeping();
+
     if (collection_type == CollectionType::CollectGarbage) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
@@ -83,7 +89,7 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
         gather_roots(roots);
         mark_live_cells(roots);
     }
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    sweep_dead_cells(print_report, collection_measurement_timer, collection_type == CollectionType::CollectGarbage && m_sweeps_incrementally);
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -117,57 +123,84 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     jmp_buf buf;
     setjmp(buf);
 
-    HashTable<FlatPtr> possible_pointers;
+    // HeapBlocks are all block_size aligned, so a sorted list of their addresses is enough to tell
+    // with a binary search whether a word points into one of them.
+    Vector<FlatPtr> live_block_addresses;
+    for_each_block([&](auto& block) {
+        live_block_addresses.append(reinterpret_cast<FlatPtr>(&block));
+        return IterationDecision::Continue;
+    });
+    quick_sort(live_block_addresses);
+    if (live_block_addresses.is_empty())
+        return;
+    FlatPtr lowest_block_address = live_block_addresses.first();
+    FlatPtr highest_block_end = live_block_addresses.last() + HeapBlock::block_size;
+
+    auto add_possible_pointer = [&](FlatPtr possible_pointer) {
+        // Most words on the stack aren't anywhere near the heap, so rule those out before searching.
+        if (possible_pointer < lowest_block_address || possible_pointer >= highest_block_end)
+            return;
+        dbgln_if(HEAP_DEBUG, "  ? {}", (const void*)possible_pointer);
+        auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<const Cell*>(possible_pointer));
+        if (!binary_search(live_block_addresses, reinterpret_cast<FlatPtr>(possible_heap_block)))
+            return;
+        if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
+            if (cell->state() == Cell::State::Live) {
+                dbgln_if(HEAP_DEBUG, "  ?-> {}", (const void*)cell);
+                roots.set(cell);
+            } else {
+                dbgln_if(HEAP_DEBUG, "  #-> {}", (const void*)cell);
+            }
+        }
+    };
+
+    // Values keep their cell pointers NaN-boxed, so a word that looks like a boxed cell is also a
+    // possible pointer to that cell. On 32-bit the pointer half of a Value already is a plain pointer.
+    auto add_possible_value = [&](FlatPtr data) {
+        add_possible_pointer(data);
+        if constexpr (sizeof(FlatPtr) == sizeof(u64)) {
+            if (Value::is_cell_bits(data))
+                add_possible_pointer(Value::cell_pointer_bits(data));
+        }
+    };
 
     auto* raw_jmp_buf = reinterpret_cast<FlatPtr const*>(buf);
 
-    for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); i += sizeof(FlatPtr))
-        possible_pointers.set(raw_jmp_buf[i]);
+    for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); ++i)
+        add_possible_value(raw_jmp_buf[i]);
 
     auto stack_reference = bit_cast<FlatPtr>(&dummy);
     auto& stack_info = m_vm.stack_info();
 
     for (FlatPtr stack_address = stack_reference; stack_address < stack_info.top(); stack_address += sizeof(FlatPtr)) {
         auto data = *reinterpret_cast<FlatPtr*>(stack_address);
-        possible_pointers.set(data);
-    }
-
-    HashTable<HeapBlock*> all_live_heap_blocks;
-    for_each_block([&](auto& block) {
-        all_live_heap_blocks.set(&block);
-        return IterationDecision::Continue;
-    });
-
-    for (auto possible_pointer : possible_pointers) {
-        if (!possible_pointer)
-            continue;
-        dbgln_if(HEAP_DEBUG, "  ? {}", (const void*)possible_pointer);
-        auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<const Cell*>(possible_pointer));
-        if (all_live_heap_blocks.contains(possible_heap_block)) {
-            if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
-                if (cell->state() == Cell::State::Live) {
-                    dbgln_if(HEAP_DEBUG, "  ?-> {}", (const void*)cell);
-                    roots.set(cell);
-                } else {
-                    dbgln_if(HEAP_DEBUG, "  #-> {}", (const void*)cell);
-                }
-            }
-        }
+        add_possible_value(data);
     }
 }
 
+// Marks cells as they are found, but only visits their edges once they come off the mark stack,
+// so deep object graphs (like long linked lists) don't turn into deep recursion.
 class MarkingVisitor final : public Cell::Visitor {
 public:
     MarkingVisitor() { }
 
-    virtual void visit_impl(Cell& cell)
+    virtual void visit_impl(Cell& cell) override
     {
         if (cell.is_marked())
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
         cell.set_marked(true);
-        cell.visit_edges(*this);
+        m_mark_stack.append(&cell);
+    }
+
+    void mark_all_live_cells()
+    {
+        while (!m_mark_stack.is_empty())
+            m_mark_stack.take_last()->visit_edges(*this);
     }
+
+private:
+    Vector<Cell*> m_mark_stack;
 };
 
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
@@ -176,9 +209,10 @@ void Heap::mark_live_cells(const HashTable<Cell*>& roots)
     MarkingVisitor visitor;
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.mark_all_live_cells();
 }
 
-void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
+void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer, bool sweep_incrementally)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -193,23 +227,36 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     auto should_store_swept_cells = !m_weak_containers.is_empty();
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
+        bool block_has_dead_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
             if (!cell->is_marked()) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
                 if (should_store_swept_cells)
                     swept_cells.append(cell);
-                block.deallocate(cell);
+                if (sweep_incrementally)
+                    cell->did_become_unreachable();
+                else
+                    block.deallocate(cell);
+                block_has_dead_cells = true;
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
             } else {
-                cell->set_marked(false);
+                // Blocks that get swept later clear the marks of their survivors then.
+                if (!sweep_incrementally)
+                    cell->set_marked(false);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
             }
         });
-        if (!block_has_live_cells)
+        if (sweep_incrementally) {
+            if (block_has_dead_cells) {
+                m_blocks_pending_sweep.append(block);
+            } else {
+                block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) { cell->set_marked(false); });
+            }
+        } else if (!block_has_live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
             full_blocks_that_became_usable.append(&block);
@@ -226,8 +273,12 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
     }
 
-    for (auto& weak_container : m_weak_containers)
+    for (auto it = m_weak_containers.begin(); it != m_weak_containers.end();) {
+        // remove_swept_cells() may deregister the container, which takes it out of the list.
+        auto& weak_container = *it;
+        ++it;
         weak_container.remove_swept_cells({}, swept_cells);
+    }
 
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
@@ -252,8 +303,54 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        if (sweep_incrementally)
+            dbgln(" Pending blocks: {}", m_blocks_pending_sweep.size_slow());
         dbgln("=============================================");
     }
+
+    if (has_pending_sweep() && on_sweep_pending)
+        on_sweep_pending();
+}
+
+void Heap::sweep_pending_block(HeapBlock& block)
+{
+    VERIFY(block.needs_sweep());
+    block.m_pending_sweep_list_node.remove();
+
+    bool block_has_live_cells = false;
+    bool block_was_full = block.is_full();
+    block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+        if (!cell->is_marked()) {
+            block.deallocate(cell);
+        } else {
+            cell->set_marked(false);
+            block_has_live_cells = true;
+        }
+    });
+
+    auto& allocator = allocator_for_size(block.cell_size());
+    if (!block_has_live_cells)
+        allocator.block_did_become_empty({}, block);
+    else if (block_was_full != block.is_full())
+        allocator.block_did_become_usable({}, block);
+}
+
+bool Heap::sweep_incrementally(int time_budget_ms)
+{
+    Core::ElapsedTimer timer;
+    timer.start();
+    while (has_pending_sweep()) {
+        sweep_pending_block(*m_blocks_pending_sweep.first());
+        if (timer.elapsed() >= time_budget_ms)
+            break;
+    }
+    return has_pending_sweep();
+}
+
+void Heap::finish_sweeping()
+{
+    while (has_pending_sweep())
+        sweep_pending_block(*m_blocks_pending_sweep.first());
 }
 
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
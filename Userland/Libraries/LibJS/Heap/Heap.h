@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
@@ -66,6 +67,21 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    // With incremental sweeping, collect_garbage() only finds the dead cells and leaves destroying them
+    // to sweep_incrementally(), which the owner of the heap should call from its event loop whenever
+    // on_sweep_pending asks for it. Allocation and the next collection sweep anything that's left over.
+    bool sweeps_incrementally() const { return m_sweeps_incrementally; }
+    void set_sweeps_incrementally(bool b) { m_sweeps_incrementally = b; }
+    Function<void()> on_sweep_pending;
+
+    bool has_pending_sweep() const { return !m_blocks_pending_sweep.is_empty(); }
+
+    // Sweeps pending blocks until time_budget_ms has passed, and returns whether there are any left.
+    bool sweep_incrementally(int time_budget_ms);
+    void finish_sweeping();
+
+    void sweep_block(Badge<CellAllocator>, HeapBlock& block) { sweep_pending_block(block); }
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -86,7 +102,8 @@ private:
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(const HashTable<Cell*>& live_cells);
-    void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&, bool sweep_incrementally);
+    void sweep_pending_block(HeapBlock&);
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -103,6 +120,9 @@ private:
     size_t m_allocations_since_last_gc { 0 };
 
     bool m_should_collect_on_every_allocation { false };
+    bool m_sweeps_incrementally { false };
+
+    IntrusiveList<HeapBlock, RawPtr<HeapBlock>, &HeapBlock::m_pending_sweep_list_node> m_blocks_pending_sweep;
 
     VM& m_vm;
 
@@ -88,7 +88,11 @@ public:
         return cell_from_possible_pointer((FlatPtr)cell);
     }
 
+    // Blocks with dead cells left in them after an incremental collection.
+    bool needs_sweep() const { return m_pending_sweep_list_node.is_in_list(); }
+
     IntrusiveListNode<HeapBlock> m_list_node;
+    IntrusiveListNode<HeapBlock> m_pending_sweep_list_node;
 
 private:
     HeapBlock(Heap&, size_t cell_size);
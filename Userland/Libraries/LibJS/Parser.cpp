@@ -1657,6 +1657,64 @@ NonnullRefPtr<BlockStatement> Parser::parse_block_statement(bool& is_strict, boo
     return block;
 }
 
+NonnullRefPtr<LazyFunctionBody> Parser::pre_parse_function_body(bool& is_strict, bool error_on_binding)
+{
+    auto rule_start = push_start();
+    auto open_curly = consume(TokenType::CurlyOpen);
+
+    bool initial_strict_mode_state = m_state.strict_mode;
+    if (initial_strict_mode_state)
+        is_strict = true;
+
+    // The directive prologue decides whether the function is strict, so that part is parsed as usual.
+    while (match(TokenType::StringLiteral)) {
+        auto statement = parse_statement();
+        if (statement_is_use_strict_directive(statement)) {
+            is_strict = true;
+            m_state.strict_mode = true;
+            if (error_on_binding)
+                syntax_error("Illegal 'use strict' directive in function with non-simple parameter list");
+        }
+        if (!is<ExpressionStatement>(*statement) || !is<StringLiteral>(static_cast<ExpressionStatement const&>(*statement).expression()))
+            break;
+    }
+    m_state.strict_mode = initial_strict_mode_state;
+    m_state.string_legacy_octal_escape_sequence_in_scope = false;
+
+    // The rest is skipped up to the matching curly brace. The lexer already knows the difference
+    // between a regular expression and a division, and which braces belong to a template literal.
+    size_t depth = 1;
+    while (!done()) {
+        if (match(TokenType::CurlyOpen))
+            ++depth;
+        else if (match(TokenType::CurlyClose) && --depth == 0)
+            break;
+        consume();
+    }
+    auto close_curly = consume(TokenType::CurlyClose);
+
+    String source;
+    if (close_curly.type() == TokenType::CurlyClose) {
+        // The lexer always looks one character ahead, so a token ends right before offset() - 1.
+        auto start = open_curly.offset() - 1 - open_curly.value().length();
+        auto end = close_curly.offset() - 1;
+        source = m_state.lexer.source().substring_view(start, end - start);
+    }
+    return create_ast_node<LazyFunctionBody>({ m_state.current_token.filename(), rule_start.position(), position() }, move(source), m_state.lexer.filename(), initial_strict_mode_state);
+}
+
+NonnullRefPtr<BlockStatement> Parser::parse_function_body(bool starts_in_strict_mode)
+{
+    ScopePusher scope(*this, ScopePusher::Var, Parser::Scope::Function);
+    TemporaryChange strict_mode_change(m_state.strict_mode, starts_in_strict_mode);
+    TemporaryChange function_context_change(m_state.in_function_context, true);
+
+    bool is_strict = false;
+    auto body = parse_block_statement(is_strict);
+    scope.add_to_scope_node(body);
+    return body;
+}
+
 template<typename FunctionNodeType>
 NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options)
 {
@@ -1709,8 +1767,17 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options)
         return parameter.binding.has<NonnullRefPtr<BindingPattern>>();
     });
 
+    // Methods and generators depend on more of the parser state, so only plain functions are parsed lazily.
+    bool can_parse_lazily = m_lazy_function_parsing
+        && (parse_options & ~FunctionNodeParseOptions::CheckForFunctionAndName) == 0
+        && !m_state.in_generator_function_context;
+
     bool is_strict = false;
-    auto body = parse_block_statement(is_strict, has_binding);
+    RefPtr<Statement> body;
+    if (can_parse_lazily)
+        body = pre_parse_function_body(is_strict, has_binding);
+    else
+        body = parse_block_statement(is_strict, has_binding);
 
     // If the function contains 'use strict' we need to check the parameters (again).
     if (is_strict) {
@@ -1744,11 +1811,12 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options)
 
     m_state.function_parameters.take_last();
 
-    scope.add_to_scope_node(body);
+    if (is<BlockStatement>(*body))
+        scope.add_to_scope_node(static_cast<BlockStatement&>(*body));
 
     return create_ast_node<FunctionNodeType>(
         { m_state.current_token.filename(), rule_start.position(), position() },
-        name, move(body), move(parameters), function_length,
+        name, body.release_nonnull(), move(parameters), function_length,
         is_generator ? FunctionKind::Generator : FunctionKind::Regular, is_strict);
 }
 
@@ -39,6 +39,10 @@ public:
 
     NonnullRefPtr<Program> parse_program(bool starts_in_strict_mode = false);
 
+    // When enabled, the bodies of plain functions are only skipped over, and parsed once they are first called.
+    void set_lazy_function_parsing(bool enabled) { m_lazy_function_parsing = enabled; }
+    NonnullRefPtr<BlockStatement> parse_function_body(bool starts_in_strict_mode);
+
     template<typename FunctionNodeType>
     NonnullRefPtr<FunctionNodeType> parse_function_node(u8 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName);
     Vector<FunctionNode::Parameter> parse_formal_parameters(int& function_length, u8 parse_options = 0);
@@ -164,6 +168,7 @@ private:
     Token consume_identifier_reference();
     Token consume(TokenType type);
     Token consume_and_validate_numeric_literal();
+    NonnullRefPtr<LazyFunctionBody> pre_parse_function_body(bool& is_strict, bool error_on_binding);
     void consume_or_insert_semicolon();
     void save_state();
     void load_state();
@@ -265,6 +270,7 @@ private:
     Vector<Position> m_rule_starts;
     ParserState m_state;
     FlyString m_filename;
+    bool m_lazy_function_parsing { false };
     Vector<ParserState> m_saved_state;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
 };
@@ -34,7 +34,7 @@ void ArgumentsObject::visit_edges(Cell::Visitor& visitor)
 }
 
 // 10.4.4.3 [[Get]] ( P, Receiver ), https://tc39.es/ecma262/#sec-arguments-exotic-objects-get-p-receiver
-Value ArgumentsObject::internal_get(PropertyName const& property_name, Value receiver) const
+Value ArgumentsObject::internal_get(PropertyName const& property_name, Value receiver, CacheablePropertyMetadata*) const
 {
     // 1. Let map be args.[[ParameterMap]].
     auto& map = *m_parameter_map;
@@ -53,7 +53,7 @@ Value ArgumentsObject::internal_get(PropertyName const& property_name, Value rec
 }
 
 // 10.4.4.4 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-arguments-exotic-objects-set-p-v-receiver
-bool ArgumentsObject::internal_set(PropertyName const& property_name, Value value, Value receiver)
+bool ArgumentsObject::internal_set(PropertyName const& property_name, Value value, Value receiver, CacheablePropertyMetadata*)
 {
     bool is_mapped = false;
 
@@ -24,8 +24,8 @@ public:
 
     virtual Optional<PropertyDescriptor> internal_get_own_property(PropertyName const&) const override;
     virtual bool internal_define_own_property(PropertyName const&, PropertyDescriptor const&) override;
-    virtual Value internal_get(PropertyName const&, Value receiver) const override;
-    virtual bool internal_set(PropertyName const&, Value value, Value receiver) override;
+    virtual Value internal_get(PropertyName const&, Value receiver, CacheablePropertyMetadata* = nullptr) const override;
+    virtual bool internal_set(PropertyName const&, Value value, Value receiver, CacheablePropertyMetadata* = nullptr) override;
     virtual bool internal_delete(PropertyName const&) override;
 
     // [[ParameterMap]]
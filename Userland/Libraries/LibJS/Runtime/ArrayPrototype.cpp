@@ -9,6 +9,7 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -154,6 +155,31 @@ static Object* array_species_create(GlobalObject& global_object, Object& origina
     return &result.as_object();
 }
 
+// Plain arrays without holes keep their elements where they can be read directly, skipping the [[HasProperty]]
+// and [[Get]] per index. Everything else gets an empty span and takes the generic path.
+static Span<Value const> packed_elements_of(Object const& object)
+{
+    if (!is<Array>(object))
+        return {};
+    return object.indexed_properties().packed_elements();
+}
+
+// Performs HasProperty(O, index) and, if the element is present, Get(O, index).
+static Optional<Value> get_element_if_present(Object& object, size_t index)
+{
+    if (auto elements = packed_elements_of(object); index < elements.size())
+        return elements[index];
+
+    auto property_name = PropertyName { index };
+    auto is_present = object.has_property(property_name);
+    if (object.vm().exception() || !is_present)
+        return {};
+    auto value = object.get(property_name);
+    if (object.vm().exception())
+        return {};
+    return value;
+}
+
 // 23.1.3.7 Array.prototype.filter ( callbackfn [ , thisArg ] ), https://tc39.es/ecma262/#sec-array.prototype.filter
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::filter)
 {
@@ -252,22 +278,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::for_each)
     // 5. Repeat, while k < len,
     for (size_t k = 0; k < length; ++k) {
         // a. Let Pk be ! ToString(𝔽(k)).
-        auto property_name = PropertyName { k };
-
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = object->has_property(property_name);
+        // c. If kPresent is true, then
+        //     i. Let kValue be ? Get(O, Pk).
+        auto k_value = get_element_if_present(*object, k);
         if (vm.exception())
             return {};
 
-        // c. If kPresent is true, then
-        if (k_present) {
-            // i. Let kValue be ? Get(O, Pk).
-            auto k_value = object->get(property_name);
-            if (vm.exception())
-                return {};
-
+        if (k_value.has_value()) {
             // ii. Perform ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
-            (void)vm.call(callback_function.as_function(), this_arg, k_value, Value(k), object);
+            (void)vm.call(callback_function.as_function(), this_arg, *k_value, Value(k), object);
             if (vm.exception())
                 return {};
         }
@@ -313,19 +333,15 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         auto property_name = PropertyName { k };
 
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = object->has_property(property_name);
+        // c. If kPresent is true, then
+        //     i. Let kValue be ? Get(O, Pk).
+        auto k_value = get_element_if_present(*object, k);
         if (vm.exception())
             return {};
 
-        // c. If kPresent is true, then
-        if (k_present) {
-            // i. Let kValue be ? Get(O, Pk).
-            auto k_value = object->get(property_name);
-            if (vm.exception())
-                return {};
-
+        if (k_value.has_value()) {
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
-            auto mapped_value = vm.call(callback_function.as_function(), this_arg, k_value, Value(k), object);
+            auto mapped_value = vm.call(callback_function.as_function(), this_arg, *k_value, Value(k), object);
             if (vm.exception())
                 return {};
 
@@ -816,6 +832,19 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // Without holes or getters in the way, the elements can be compared right where they are. If they're all
+    // numbers, nothing but a number can be strictly equal to one of them.
+    if (auto elements = packed_elements_of(*object); elements.size() >= length) {
+        auto element_kind = object->indexed_properties().element_kind();
+        if (element_kind != ElementKind::Generic && !search_element.is_number())
+            return Value(-1);
+        for (; k < length; ++k) {
+            if (strict_eq(search_element, elements[k]))
+                return Value(k);
+        }
+        return Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_name = PropertyName { k };
@@ -1236,35 +1265,71 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
         return {};
 
     MarkedValueList items(vm.heap());
-    for (size_t k = 0; k < length; ++k) {
-        auto k_present = object->has_property(k);
-        if (vm.exception())
-            return {};
-
-        if (k_present) {
-            auto k_value = object->get(k);
+    auto element_kind = ElementKind::Generic;
+    if (auto elements = packed_elements_of(*object); elements.size() >= length) {
+        element_kind = object->indexed_properties().element_kind();
+        items.append(elements.data(), length);
+    } else {
+        for (size_t k = 0; k < length; ++k) {
+            auto k_present = object->has_property(k);
             if (vm.exception())
                 return {};
 
-            items.append(k_value);
+            if (k_present) {
+                auto k_value = object->get(k);
+                if (vm.exception())
+                    return {};
+
+                items.append(k_value);
+            }
         }
     }
 
-    // Perform sorting by merge sort. This isn't as efficient compared to quick sort, but
-    // quicksort can't be used in all cases because the spec requires Array.prototype.sort()
-    // to be stable. FIXME: when initially scanning through the array, maintain a flag
-    // for if an unstable sort would be indistinguishable from a stable sort (such as just
-    // just strings or numbers), and in that case use quick sort instead for better performance.
-    array_merge_sort(vm, global_object, callback.is_undefined() ? nullptr : &callback.as_function(), items);
-    if (vm.exception())
-        return {};
-
-    for (size_t j = 0; j < items.size(); ++j) {
-        object->set(j, items[j], Object::ShouldThrowExceptions::Yes);
+    if (callback.is_undefined() && element_kind != ElementKind::Generic) {
+        // Numbers are sorted by their string representation, which doesn't have side effects to get. So it's only
+        // computed once per element rather than twice per comparison, and the original position breaks ties to keep
+        // the sort stable (+0 and -0 both turn into "0").
+        struct SortKey {
+            String string;
+            size_t index;
+        };
+        Vector<SortKey> keys;
+        keys.ensure_capacity(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+            keys.unchecked_append({ items[i].to_string(global_object), i });
+        quick_sort(keys, [](auto& a, auto& b) {
+            if (a.string != b.string)
+                return a.string < b.string;
+            return a.index < b.index;
+        });
+        MarkedValueList sorted_items(vm.heap());
+        sorted_items.ensure_capacity(items.size());
+        for (auto& key : keys)
+            sorted_items.unchecked_append(items[key.index]);
+        items.clear_with_capacity();
+        items.extend(move(sorted_items));
+    } else {
+        // Perform sorting by merge sort. This isn't as efficient compared to quick sort, but
+        // quicksort can't be used in all cases because the spec requires Array.prototype.sort()
+        // to be stable.
+        array_merge_sort(vm, global_object, callback.is_undefined() ? nullptr : &callback.as_function(), items);
         if (vm.exception())
             return {};
     }
 
+    // If the array is still packed after the compare function had its way with it, every element being written
+    // back is a writable data property, so it can be stored directly.
+    if (packed_elements_of(*object).size() >= items.size()) {
+        for (size_t j = 0; j < items.size(); ++j)
+            object->indexed_properties().put(j, items[j]);
+    } else {
+        for (size_t j = 0; j < items.size(); ++j) {
+            object->set(j, items[j], Object::ShouldThrowExceptions::Yes);
+            if (vm.exception())
+                return {};
+        }
+    }
+
     // The empty parts of the array are always sorted to the end, regardless of the
     // compare function. FIXME: For performance, a similar process could be used
     // for undefined, which are sorted to right before the empty values.
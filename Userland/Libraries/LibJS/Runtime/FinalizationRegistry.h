@@ -31,6 +31,7 @@ public:
     void cleanup(FunctionObject* callback = nullptr);
 
     virtual void remove_swept_cells(Badge<Heap>, Vector<Cell*>&) override;
+    virtual void did_become_unreachable() override { WeakContainer::deregister(); }
 
 private:
     virtual void visit_edges(Visitor& visitor) override;
@@ -57,6 +57,7 @@ Value GeneratorFunctionConstructor::construct(FunctionObject& new_target)
     passes.perform(executable);
     if constexpr (JS_BYTECODE_DEBUG) {
         dbgln("Optimisation passes took {}us", passes.elapsed());
+        passes.dump_timings();
         dbgln("Compiled Bytecode::Block for function '{}':", function->name());
         for (auto& block : executable.basic_blocks)
             block.dump(executable);
@@ -17,6 +17,19 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto& value : m_packed_elements) {
+        if (value.is_empty())
+            ++m_hole_count;
+        else
+            update_element_kind(value);
+    }
+}
+
+void SimpleIndexedPropertyStorage::update_element_kind(Value value)
+{
+    if (m_element_kind == ElementKind::Generic || value.type() == Value::Type::Int32)
+        return;
+    m_element_kind = value.is_number() ? ElementKind::Double : ElementKind::Generic;
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -44,34 +57,56 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        m_hole_count += index - m_array_size + 1;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
+    if (m_packed_elements[index].is_empty())
+        --m_hole_count;
+    if (value.is_empty())
+        ++m_hole_count;
+    else
+        update_element_kind(value);
     m_packed_elements[index] = value;
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
+    if (!m_packed_elements[index].is_empty())
+        ++m_hole_count;
     m_packed_elements[index] = {};
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    auto first_element = m_packed_elements.take_first();
+    if (first_element.is_empty())
+        --m_hole_count;
+    return { first_element, default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
     auto last_element = m_packed_elements[m_array_size];
+    if (last_element.is_empty())
+        --m_hole_count;
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
 }
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size) {
+        m_hole_count += new_size - m_array_size;
+    } else {
+        for (size_t i = new_size; i < m_array_size; ++i) {
+            if (m_packed_elements[i].is_empty())
+                --m_hole_count;
+        }
+    }
     m_array_size = new_size;
     m_packed_elements.resize(new_size);
     return true;
@@ -298,6 +333,23 @@ Vector<u32> IndexedProperties::indices() const
     return indices;
 }
 
+Span<Value const> IndexedProperties::packed_elements() const
+{
+    if (!m_storage->is_simple_storage())
+        return {};
+    auto& storage = static_cast<const SimpleIndexedPropertyStorage&>(*m_storage);
+    if (!storage.is_packed())
+        return {};
+    return storage.elements().span().trim(storage.array_like_size());
+}
+
+ElementKind IndexedProperties::element_kind() const
+{
+    if (!m_storage->is_simple_storage())
+        return ElementKind::Generic;
+    return static_cast<const SimpleIndexedPropertyStorage&>(*m_storage).element_kind();
+}
+
 void IndexedProperties::switch_to_generic_storage()
 {
     auto& storage = static_cast<SimpleIndexedPropertyStorage&>(*m_storage);
@@ -21,6 +21,14 @@ class IndexedProperties;
 class IndexedPropertyIterator;
 class GenericIndexedPropertyStorage;
 
+// What the elements in simple storage are known to be. An array only ever moves towards Generic, even if the
+// elements that made it do so are gone again.
+enum class ElementKind : u8 {
+    Int32,
+    Double,
+    Generic,
+};
+
 class IndexedPropertyStorage {
 public:
     virtual ~IndexedPropertyStorage() {};
@@ -60,13 +68,20 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     const Vector<Value>& elements() const { return m_packed_elements; }
 
+    // Whether every index below the array-like size has an element.
+    bool is_packed() const { return m_hole_count == 0; }
+    ElementKind element_kind() const { return m_element_kind; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void update_element_kind(Value);
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    size_t m_hole_count { 0 };
+    ElementKind m_element_kind { ElementKind::Int32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -140,6 +155,11 @@ public:
 
     Vector<u32> indices() const;
 
+    // The elements, if they're all present in simple storage. Reading one of them is then the same as
+    // a [[Get]] that doesn't have side effects or have to look at the prototype chain.
+    Span<Value const> packed_elements() const;
+    ElementKind element_kind() const;
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
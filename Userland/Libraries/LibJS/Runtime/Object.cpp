@@ -78,7 +78,7 @@ bool Object::is_extensible() const
 // 7.3 Operations on Objects, https://tc39.es/ecma262/#sec-operations-on-objects
 
 // 7.3.2 Get ( O, P ), https://tc39.es/ecma262/#sec-get-o-p
-Value Object::get(PropertyName const& property_name) const
+Value Object::get(PropertyName const& property_name, CacheablePropertyMetadata* cacheable_metadata) const
 {
     // 1. Assert: Type(O) is Object.
 
@@ -86,13 +86,13 @@ Value Object::get(PropertyName const& property_name) const
     VERIFY(property_name.is_valid());
 
     // 3. Return ? O.[[Get]](P, O).
-    return internal_get(property_name, this);
+    return internal_get(property_name, this, cacheable_metadata);
 }
 
 // 7.3.3 GetV ( V, P ) is defined as Value::get().
 
 // 7.3.4 Set ( O, P, V, Throw ), https://tc39.es/ecma262/#sec-set-o-p-v-throw
-bool Object::set(PropertyName const& property_name, Value value, ShouldThrowExceptions throw_exceptions)
+bool Object::set(PropertyName const& property_name, Value value, ShouldThrowExceptions throw_exceptions, CacheablePropertyMetadata* cacheable_metadata)
 {
     VERIFY(!value.is_empty());
     auto& vm = this->vm();
@@ -105,7 +105,7 @@ bool Object::set(PropertyName const& property_name, Value value, ShouldThrowExce
     // 3. Assert: Type(Throw) is Boolean.
 
     // 4. Let success be ? O.[[Set]](P, V, O).
-    auto success = internal_set(property_name, value, this);
+    auto success = internal_set(property_name, value, this, cacheable_metadata);
     if (vm.exception())
         return {};
 
@@ -661,7 +661,18 @@ bool Object::internal_has_property(PropertyName const& property_name) const
 }
 
 // 10.1.8 [[Get]] ( P, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-get-p-receiver
-Value Object::internal_get(PropertyName const& property_name, Value receiver) const
+// Indexed properties don't live in the shape's storage, so only named ones can be cached.
+static Optional<u32> cacheable_property_offset(Object const& object, PropertyName const& property_name)
+{
+    if (property_name.is_number())
+        return {};
+    auto metadata = object.shape().lookup(property_name.to_string_or_symbol());
+    if (!metadata.has_value() || object.get_direct(metadata->offset).is_accessor())
+        return {};
+    return static_cast<u32>(metadata->offset);
+}
+
+Value Object::internal_get(PropertyName const& property_name, Value receiver, CacheablePropertyMetadata* cacheable_metadata) const
 {
     VERIFY(!receiver.is_empty());
     auto& vm = this->vm();
@@ -690,8 +701,11 @@ Value Object::internal_get(PropertyName const& property_name, Value receiver) co
     }
 
     // 4. If IsDataDescriptor(desc) is true, return desc.[[Value]].
-    if (descriptor->is_data_descriptor())
+    if (descriptor->is_data_descriptor()) {
+        if (cacheable_metadata)
+            cacheable_metadata->property_offset = cacheable_property_offset(*this, property_name);
         return *descriptor->value;
+    }
 
     // 5. Assert: IsAccessorDescriptor(desc) is true.
     VERIFY(descriptor->is_accessor_descriptor());
@@ -710,7 +724,7 @@ Value Object::internal_get(PropertyName const& property_name, Value receiver) co
 static bool ordinary_set_with_own_descriptor(Object&, PropertyName const&, Value, Value, Optional<PropertyDescriptor>);
 
 // 10.1.9 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-set-p-v-receiver
-bool Object::internal_set(PropertyName const& property_name, Value value, Value receiver)
+bool Object::internal_set(PropertyName const& property_name, Value value, Value receiver, CacheablePropertyMetadata* cacheable_metadata)
 {
     VERIFY(!value.is_empty());
     VERIFY(!receiver.is_empty());
@@ -724,6 +738,11 @@ bool Object::internal_set(PropertyName const& property_name, Value value, Value
     if (vm.exception())
         return {};
 
+    // Setting a writable own data property just replaces the value in storage, unless the receiver is some other object.
+    if (cacheable_metadata && own_descriptor.has_value() && own_descriptor->is_data_descriptor() && *own_descriptor->writable
+        && receiver.is_object() && &receiver.as_object() == this)
+        cacheable_metadata->property_offset = cacheable_property_offset(*this, property_name);
+
     // 3. Return OrdinarySetWithOwnDescriptor(O, P, V, Receiver, ownDesc).
     return ordinary_set_with_own_descriptor(*this, property_name, value, receiver, own_descriptor);
 }
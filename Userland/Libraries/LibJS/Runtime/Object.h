@@ -26,6 +26,13 @@ public:                               \
     using Base = base_class;          \
     virtual const char* class_name() const override { return #class_; }
 
+// Filled in by the ordinary [[Get]] and [[Set]] when the property turned out to be a plain data property
+// in the object's own storage, so that the bytecode interpreter can go straight to that slot the next
+// time it sees an object with the same shape. Objects with exotic [[Get]] or [[Set]] never fill this in.
+struct CacheablePropertyMetadata {
+    Optional<u32> property_offset;
+};
+
 class Object : public Cell {
 public:
     static Object* create(GlobalObject&, Object* prototype);
@@ -73,8 +80,8 @@ public:
 
     // 7.3 Operations on Objects, https://tc39.es/ecma262/#sec-operations-on-objects
 
-    Value get(PropertyName const&) const;
-    bool set(PropertyName const&, Value, ShouldThrowExceptions);
+    Value get(PropertyName const&, CacheablePropertyMetadata* = nullptr) const;
+    bool set(PropertyName const&, Value, ShouldThrowExceptions, CacheablePropertyMetadata* = nullptr);
     bool create_data_property(PropertyName const&, Value);
     bool create_method_property(PropertyName const&, Value);
     bool create_data_property_or_throw(PropertyName const&, Value);
@@ -96,8 +103,8 @@ public:
     virtual Optional<PropertyDescriptor> internal_get_own_property(PropertyName const&) const;
     virtual bool internal_define_own_property(PropertyName const&, PropertyDescriptor const&);
     virtual bool internal_has_property(PropertyName const&) const;
-    virtual Value internal_get(PropertyName const&, Value receiver) const;
-    virtual bool internal_set(PropertyName const&, Value value, Value receiver);
+    virtual Value internal_get(PropertyName const&, Value receiver, CacheablePropertyMetadata* = nullptr) const;
+    virtual bool internal_set(PropertyName const&, Value value, Value receiver, CacheablePropertyMetadata* = nullptr);
     virtual bool internal_delete(PropertyName const&);
     virtual MarkedValueList internal_own_property_keys() const;
 
@@ -145,6 +152,7 @@ public:
     virtual Value value_of() const { return Value(const_cast<Object*>(this)); }
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
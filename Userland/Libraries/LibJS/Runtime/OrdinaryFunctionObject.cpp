@@ -101,6 +101,16 @@ void OrdinaryFunctionObject::visit_edges(Visitor& visitor)
     visitor.visit(m_environment);
 }
 
+const Statement& OrdinaryFunctionObject::body() const
+{
+    // A function that was only pre-parsed is parsed the first time we need its body.
+    if (is<LazyFunctionBody>(*m_body)) {
+        if (auto* parsed_body = static_cast<LazyFunctionBody const&>(*m_body).parsed_body())
+            return *parsed_body;
+    }
+    return m_body;
+}
+
 FunctionEnvironment* OrdinaryFunctionObject::create_environment(FunctionObject& function_being_invoked)
 {
     HashMap<FlyString, Variable> variables;
@@ -146,6 +156,11 @@ Value OrdinaryFunctionObject::execute_function_body()
     Interpreter* ast_interpreter = nullptr;
     auto* bytecode_interpreter = Bytecode::Interpreter::current();
 
+    if (auto& body = this->body(); is<LazyFunctionBody>(body)) {
+        vm.throw_exception<SyntaxError>(global_object(), static_cast<LazyFunctionBody const&>(body).syntax_error());
+        return {};
+    }
+
     auto prepare_arguments = [&] {
         auto& execution_context_arguments = vm.running_execution_context().arguments;
         for (size_t i = 0; i < m_parameters.size(); ++i) {
@@ -181,11 +196,12 @@ Value OrdinaryFunctionObject::execute_function_body()
     if (bytecode_interpreter) {
         prepare_arguments();
         if (!m_bytecode_executable.has_value()) {
-            m_bytecode_executable = Bytecode::Generator::generate(m_body, m_kind == FunctionKind::Generator);
+            m_bytecode_executable = Bytecode::Generator::generate(body(), m_kind == FunctionKind::Generator);
             auto& passes = JS::Bytecode::Interpreter::optimization_pipeline();
             passes.perform(*m_bytecode_executable);
             if constexpr (JS_BYTECODE_DEBUG) {
                 dbgln("Optimisation passes took {}us", passes.elapsed());
+                passes.dump_timings();
                 dbgln("Compiled Bytecode::Block for function '{}':", m_name);
                 for (auto& block : m_bytecode_executable->basic_blocks)
                     block.dump(*m_bytecode_executable);
@@ -212,7 +228,7 @@ Value OrdinaryFunctionObject::execute_function_body()
         if (vm.exception())
             return {};
 
-        return ast_interpreter->execute_statement(global_object(), m_body, ScopeType::Function);
+        return ast_interpreter->execute_statement(global_object(), body(), ScopeType::Function);
     }
 }
 
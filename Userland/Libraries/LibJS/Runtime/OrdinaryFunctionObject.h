@@ -22,7 +22,7 @@ public:
     virtual void initialize(GlobalObject&) override;
     virtual ~OrdinaryFunctionObject();
 
-    const Statement& body() const { return m_body; }
+    const Statement& body() const;
     const Vector<FunctionNode::Parameter>& parameters() const { return m_parameters; };
 
     virtual Value call() override;
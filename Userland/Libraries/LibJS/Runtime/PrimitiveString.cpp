@@ -5,14 +5,28 @@
  */
 
 #include <AK/CharacterTypes.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf16View.h>
 #include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/VM.h>
 
 namespace JS {
 
+// Concatenations shorter than this are made right away, since copying a few bytes is cheaper than keeping a rope around.
+static constexpr size_t minimum_rope_length = 32;
+static constexpr size_t maximum_appended_piece_length = 256;
+
 PrimitiveString::PrimitiveString(String string)
-    : m_string(move(string))
+    : m_byte_length(string.length())
+    , m_string(move(string))
+{
+}
+
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_is_rope(true)
+    , m_lhs(&lhs)
+    , m_rhs(&rhs)
+    , m_byte_length(lhs.byte_length() + rhs.byte_length())
 {
 }
 
@@ -20,10 +34,63 @@ PrimitiveString::~PrimitiveString()
 {
 }
 
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    Cell::visit_edges(visitor);
+    if (m_is_rope) {
+        visitor.visit(m_lhs);
+        visitor.visit(m_rhs);
+    }
+}
+
+String const& PrimitiveString::string() const
+{
+    if (m_is_rope)
+        resolve_rope();
+    return m_string;
+}
+
+void PrimitiveString::resolve_rope() const
+{
+    // Ropes built by appending in a loop are as deep as the loop was long, so this walks them without recursing.
+    bool is_ascii = true;
+    StringBuilder builder(m_byte_length);
+    Vector<PrimitiveString const*> pieces;
+    pieces.append(this);
+    while (!pieces.is_empty()) {
+        auto const* piece = pieces.take_last();
+        if (piece->m_is_rope) {
+            pieces.append(piece->m_rhs);
+            pieces.append(piece->m_lhs);
+            continue;
+        }
+        for (auto ch : piece->m_string) {
+            if (!AK::is_ascii(static_cast<u8>(ch))) {
+                is_ascii = false;
+                break;
+            }
+        }
+        builder.append(piece->m_string);
+    }
+
+    // Like in js_string(), a surrogate pair that ended up split between the two halves has to be joined up again.
+    if (is_ascii) {
+        m_string = builder.to_string();
+    } else {
+        m_utf16_string = AK::utf8_to_utf16(builder.string_view());
+        m_string = Utf16View { m_utf16_string }.to_utf8(Utf16View::AllowInvalidCodeUnits::Yes);
+    }
+
+    m_is_rope = false;
+    m_lhs = nullptr;
+    m_rhs = nullptr;
+}
+
 Vector<u16> const& PrimitiveString::utf16_string() const
 {
-    if (m_utf16_string.is_empty() && !m_string.is_empty())
-        m_utf16_string = AK::utf8_to_utf16(m_string);
+    auto& string = this->string();
+    if (m_utf16_string.is_empty() && !string.is_empty())
+        m_utf16_string = AK::utf8_to_utf16(string);
     return m_utf16_string;
 }
 
@@ -82,4 +149,29 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_rope_string(VM& vm, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    if (lhs.byte_length() == 0)
+        return &rhs;
+    if (rhs.byte_length() == 0)
+        return &lhs;
+
+    auto concatenate = [&](PrimitiveString& a, PrimitiveString& b) {
+        StringBuilder builder(a.byte_length() + b.byte_length());
+        builder.append(a.string());
+        builder.append(b.string());
+        return js_string(vm, builder.to_string());
+    };
+
+    if (lhs.byte_length() + rhs.byte_length() < minimum_rope_length)
+        return concatenate(lhs, rhs);
+
+    // Appending short strings one at a time would otherwise make a rope with a node per append, which the GC
+    // then has to walk every time it runs. Short appends are collected into the last piece instead.
+    if (lhs.m_is_rope && !lhs.m_rhs->m_is_rope && lhs.m_rhs->byte_length() + rhs.byte_length() < maximum_appended_piece_length)
+        return vm.heap().allocate_without_global_object<PrimitiveString>(*lhs.m_lhs, *concatenate(*lhs.m_rhs, rhs));
+
+    return vm.heap().allocate_without_global_object<PrimitiveString>(lhs, rhs);
+}
+
 }
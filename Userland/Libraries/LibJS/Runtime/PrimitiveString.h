@@ -15,17 +15,34 @@ namespace JS {
 class PrimitiveString final : public Cell {
 public:
     explicit PrimitiveString(String);
+
+    // A rope is the concatenation of two other strings, which is only built once something needs its contents.
+    PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs);
+
     virtual ~PrimitiveString();
 
-    String const& string() const { return m_string; }
+    String const& string() const;
+
+    // The length of the string in UTF-8 code units, which doesn't resolve ropes.
+    size_t byte_length() const { return m_byte_length; }
 
     Vector<u16> const& utf16_string() const;
     Utf16View utf16_string_view() const;
 
 private:
+    friend PrimitiveString* js_rope_string(VM&, PrimitiveString&, PrimitiveString&);
+
     virtual const char* class_name() const override { return "PrimitiveString"; }
+    virtual void visit_edges(Cell::Visitor&) override;
 
-    String m_string;
+    void resolve_rope() const;
+
+    mutable bool m_is_rope { false };
+    mutable PrimitiveString* m_lhs { nullptr };
+    mutable PrimitiveString* m_rhs { nullptr };
+
+    size_t m_byte_length { 0 };
+    mutable String m_string;
     mutable Vector<u16> m_utf16_string;
 };
 
@@ -35,4 +52,6 @@ PrimitiveString* js_string(VM&, Utf16View const&);
 PrimitiveString* js_string(Heap&, String);
 PrimitiveString* js_string(VM&, String);
 
+PrimitiveString* js_rope_string(VM&, PrimitiveString& lhs, PrimitiveString& rhs);
+
 }
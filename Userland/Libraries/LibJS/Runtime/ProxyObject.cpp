@@ -556,7 +556,7 @@ bool ProxyObject::internal_has_property(PropertyName const& property_name) const
 }
 
 // 10.5.8 [[Get]] ( P, Receiver ), https://tc39.es/ecma262/#sec-proxy-object-internal-methods-and-internal-slots-get-p-receiver
-Value ProxyObject::internal_get(PropertyName const& property_name, Value receiver) const
+Value ProxyObject::internal_get(PropertyName const& property_name, Value receiver, CacheablePropertyMetadata*) const
 {
     VERIFY(!receiver.is_empty());
 
@@ -623,7 +623,7 @@ Value ProxyObject::internal_get(PropertyName const& property_name, Value receive
 }
 
 // 10.5.9 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-proxy-object-internal-methods-and-internal-slots-set-p-v-receiver
-bool ProxyObject::internal_set(PropertyName const& property_name, Value value, Value receiver)
+bool ProxyObject::internal_set(PropertyName const& property_name, Value value, Value receiver, CacheablePropertyMetadata*)
 {
     VERIFY(!value.is_empty());
     VERIFY(!receiver.is_empty());
@@ -164,7 +164,7 @@ RegExpObject* regexp_create(GlobalObject& global_object, Value pattern, Value fl
         return {};
     }
 
-    Regex<ECMA262> regex(move(parsed_pattern), parsed_flags_or_error.release_value());
+    auto regex = Regex<ECMA262>::cached(move(parsed_pattern), parsed_flags_or_error.release_value());
     if (regex.parser_result.error != regex::Error::NoError) {
         vm.throw_exception<SyntaxError>(global_object, ErrorType::RegExpCompileError, regex.error_string());
         return {};
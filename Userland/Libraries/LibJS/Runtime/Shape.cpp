@@ -182,6 +182,7 @@ void Shape::add_property_to_unique_shape(const StringOrSymbol& property_name, Pr
     VERIFY(!m_property_table->contains(property_name));
     m_property_table->set(property_name, { m_property_table->size(), attributes });
     ++m_property_count;
+    ++m_serial_number;
 }
 
 void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_name, PropertyAttributes attributes)
@@ -192,6 +193,7 @@ void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_
     VERIFY(it != m_property_table->end());
     it->value.attributes = attributes;
     m_property_table->set(property_name, it->value);
+    ++m_serial_number;
 }
 
 void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_name, size_t offset)
@@ -205,6 +207,7 @@ void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_nam
         if (it.value.offset > offset)
             --it.value.offset;
     }
+    ++m_serial_number;
 }
 
 void Shape::add_property_without_transition(StringOrSymbol const& property_name, PropertyAttributes attributes)
@@ -213,6 +216,7 @@ void Shape::add_property_without_transition(StringOrSymbol const& property_name,
     ensure_property_table();
     if (m_property_table->set(property_name, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry)
         ++m_property_count;
+    ++m_serial_number;
 }
 
 FLATTEN void Shape::add_property_without_transition(PropertyName const& property_name, PropertyAttributes attributes)
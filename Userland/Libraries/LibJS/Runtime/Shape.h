@@ -63,6 +63,11 @@ public:
     bool is_unique() const { return m_unique; }
     Shape* create_unique_clone() const;
 
+    // Bumped whenever the property table of this shape changes in place rather than through a transition,
+    // which unique shapes do all the time. Anything that remembers property offsets for a shape also has
+    // to remember this, to notice when those offsets are no longer valid.
+    u32 serial_number() const { return m_serial_number; }
+
     GlobalObject* global_object() const;
 
     Object* prototype() { return m_prototype; }
@@ -88,6 +93,7 @@ public:
 private:
     virtual const char* class_name() const override { return "Shape"; }
     virtual void visit_edges(Visitor&) override;
+    virtual void did_become_unreachable() override { revoke_weak_ptrs(); }
 
     Shape* get_or_prune_cached_forward_transition(TransitionKey const&);
     void ensure_property_table() const;
@@ -105,6 +111,7 @@ private:
     StringOrSymbol m_property_name;
     Object* m_prototype { nullptr };
     size_t m_property_count { 0 };
+    u32 m_serial_number { 0 };
 };
 
 }
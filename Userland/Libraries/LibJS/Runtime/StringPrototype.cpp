@@ -41,6 +41,16 @@ static Vector<u16> utf16_string_from(VM& vm, GlobalObject& global_object)
     return this_value.to_utf16_string(global_object);
 }
 
+// For the functions that only look at a code unit or two, this avoids copying the whole string to UTF-16 every time
+// by using the UTF-16 representation cached on the PrimitiveString.
+static PrimitiveString* primitive_string_from(VM& vm, GlobalObject& global_object)
+{
+    auto this_value = require_object_coercible(global_object, vm.this_value(global_object));
+    if (vm.exception())
+        return {};
+    return this_value.to_primitive_string(global_object);
+}
+
 // 22.1.3.21.1 SplitMatch ( S, q, R ), https://tc39.es/ecma262/#sec-splitmatch
 static Optional<size_t> split_match(Utf16View const& haystack, size_t start, Utf16View const& needle)
 {
@@ -179,14 +189,14 @@ static Value this_string_value(GlobalObject& global_object, Value value)
 // 22.1.3.1 String.prototype.charAt ( pos ), https://tc39.es/ecma262/#sec-string.prototype.charat
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_at)
 {
-    auto string = utf16_string_from(vm, global_object);
+    auto* string = primitive_string_from(vm, global_object);
     if (vm.exception())
         return {};
     auto position = vm.argument(0).to_integer_or_infinity(global_object);
     if (vm.exception())
         return {};
 
-    Utf16View utf16_string_view { string };
+    auto utf16_string_view = string->utf16_string_view();
     if (position < 0 || position >= utf16_string_view.length_in_code_units())
         return js_string(vm, String::empty());
 
@@ -196,14 +206,14 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_at)
 // 22.1.3.2 String.prototype.charCodeAt ( pos ), https://tc39.es/ecma262/#sec-string.prototype.charcodeat
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_code_at)
 {
-    auto string = utf16_string_from(vm, global_object);
+    auto* string = primitive_string_from(vm, global_object);
     if (vm.exception())
         return {};
     auto position = vm.argument(0).to_integer_or_infinity(global_object);
     if (vm.exception())
         return {};
 
-    Utf16View utf16_string_view { string };
+    auto utf16_string_view = string->utf16_string_view();
     if (position < 0 || position >= utf16_string_view.length_in_code_units())
         return js_nan();
 
@@ -213,14 +223,14 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_code_at)
 // 22.1.3.3 String.prototype.codePointAt ( pos ), https://tc39.es/ecma262/#sec-string.prototype.codepointat
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::code_point_at)
 {
-    auto string = utf16_string_from(vm, global_object);
+    auto* string = primitive_string_from(vm, global_object);
     if (vm.exception())
         return {};
     auto position = vm.argument(0).to_integer_or_infinity(global_object);
     if (vm.exception())
         return {};
 
-    Utf16View utf16_string_view { string };
+    auto utf16_string_view = string->utf16_string_view();
     if (position < 0 || position >= utf16_string_view.length_in_code_units())
         return js_undefined();
 
@@ -818,11 +828,11 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::last_index_of)
 // 3.1 String.prototype.at ( index ), https://tc39.es/proposal-relative-indexing-method/#sec-string.prototype.at
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::at)
 {
-    auto string = utf16_string_from(vm, global_object);
+    auto* string = primitive_string_from(vm, global_object);
     if (vm.exception())
         return {};
 
-    Utf16View utf16_string_view { string };
+    auto utf16_string_view = string->utf16_string_view();
     auto length = utf16_string_view.length_in_code_units();
 
     auto relative_index = vm.argument(0).to_integer_or_infinity(global_object);
@@ -309,7 +309,7 @@ public:
     }
 
     // 10.4.5.4 [[Get]] ( P, Receiver ), 10.4.5.4 [[Get]] ( P, Receiver )
-    virtual Value internal_get(PropertyName const& property_name, Value receiver) const override
+    virtual Value internal_get(PropertyName const& property_name, Value receiver, CacheablePropertyMetadata* = nullptr) const override
     {
         VERIFY(!receiver.is_empty());
 
@@ -336,7 +336,7 @@ public:
     }
 
     // 10.4.5.5 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-integer-indexed-exotic-objects-set-p-v-receiver
-    virtual bool internal_set(PropertyName const& property_name, Value value, Value receiver) override
+    virtual bool internal_set(PropertyName const& property_name, Value value, Value receiver, CacheablePropertyMetadata* = nullptr) override
     {
         VERIFY(!value.is_empty());
         VERIFY(!receiver.is_empty());
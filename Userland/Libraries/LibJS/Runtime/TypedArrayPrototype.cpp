@@ -7,10 +7,12 @@
  */
 
 #include <LibJS/Runtime/AbstractOperations.h>
+#include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayIterator.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/TypedArray.h>
 #include <LibJS/Runtime/TypedArrayPrototype.h>
+#include <string.h>
 
 namespace JS {
 
@@ -701,16 +703,10 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::set)
             return {};
         }
 
-        size_t source_byte_index;
+        size_t source_byte_index = source_byte_offset;
         bool same = false;
         // FIXME: Step 19: If both IsSharedArrayBuffer(srcBuffer) and IsSharedArrayBuffer(targetBuffer) are true...
         same = same_value(source_buffer, target_buffer);
-        if (same) {
-            // FIXME: Implement this: Step 21
-            TODO();
-        } else {
-            source_byte_index = source_byte_offset;
-        }
         Checked<size_t> checked_target_byte_index(static_cast<size_t>(target_offset));
         checked_target_byte_index *= typed_array->element_size();
         checked_target_byte_index += target_byte_offset;
@@ -729,9 +725,23 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::set)
         }
         auto limit = checked_limit.value();
 
-        if (source_typed_array.element_size() == typed_array->element_size()) {
+        if (source_typed_array.element_name() == typed_array->element_name()) {
             // FIXME: SharedBuffers use a different mechanism, implement that when SharedBuffers are implemented.
-            target_buffer->buffer().overwrite(target_byte_index, source_buffer->buffer().data(), limit - target_byte_index);
+            // The bytes are copied as they are, and memmove copes with the two views overlapping in the same buffer.
+            memmove(target_buffer->buffer().data() + target_byte_index, source_buffer->buffer().data() + source_byte_index, limit - target_byte_index);
+        } else if (same) {
+            // Step 21 clones the source bytes before anything is written, as the target may overlap them.
+            // Reading all the source values up front has the same effect.
+            MarkedValueList values(vm.heap());
+            values.ensure_capacity(source_length);
+            for (size_t i = 0; i < source_length; ++i) {
+                values.unchecked_append(source_typed_array.get_value_from_buffer(source_byte_index, ArrayBuffer::Unordered));
+                source_byte_index += source_typed_array.element_size();
+            }
+            for (auto& value : values) {
+                typed_array->set_value_in_buffer(target_byte_index, value, ArrayBuffer::Unordered);
+                target_byte_index += typed_array->element_size();
+            }
         } else {
             while (target_byte_index < limit) {
                 auto value = source_typed_array.get_value_from_buffer(source_byte_index, ArrayBuffer::Unordered);
@@ -788,6 +798,19 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::set)
         }
 
         auto limit = checked_limit.value();
+
+        // Numbers in an array without holes can be stored straight from its elements, as converting them
+        // to numbers again can't run any code that would change the array or detach the buffer.
+        if (is<Array>(*src) && typed_array->content_type() == TypedArrayBase::ContentType::Number && src->indexed_properties().element_kind() != ElementKind::Generic) {
+            if (auto elements = src->indexed_properties().packed_elements(); elements.size() >= source_length) {
+                for (size_t i = 0; i < source_length; ++i) {
+                    typed_array->set_value_in_buffer(target_byte_index, elements[i], ArrayBuffer::Unordered);
+                    target_byte_index += typed_array->element_size();
+                }
+                return js_undefined();
+            }
+        }
+
         auto k = 0;
         while (target_byte_index < limit) {
             auto value = src->get(k);
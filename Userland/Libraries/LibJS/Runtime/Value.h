@@ -49,18 +49,18 @@ public:
         Number,
     };
 
-    bool is_empty() const { return m_type == Type::Empty; }
-    bool is_undefined() const { return m_type == Type::Undefined; }
-    bool is_null() const { return m_type == Type::Null; }
-    bool is_number() const { return m_type == Type::Int32 || m_type == Type::Double; }
-    bool is_string() const { return m_type == Type::String; }
-    bool is_object() const { return m_type == Type::Object; }
-    bool is_boolean() const { return m_type == Type::Boolean; }
-    bool is_symbol() const { return m_type == Type::Symbol; }
-    bool is_accessor() const { return m_type == Type::Accessor; };
-    bool is_bigint() const { return m_type == Type::BigInt; };
+    bool is_empty() const { return m_value == encode(empty_tag, 0); }
+    bool is_undefined() const { return m_value == encode(undefined_tag, 0); }
+    bool is_null() const { return m_value == encode(null_tag, 0); }
+    bool is_number() const { return is_int32() || is_double(); }
+    bool is_string() const { return tag() == string_tag; }
+    bool is_object() const { return tag() == object_tag; }
+    bool is_boolean() const { return tag() == boolean_tag; }
+    bool is_symbol() const { return tag() == symbol_tag; }
+    bool is_accessor() const { return tag() == accessor_tag; };
+    bool is_bigint() const { return tag() == bigint_tag; };
     bool is_nullish() const { return is_null() || is_undefined(); }
-    bool is_cell() const { return is_string() || is_accessor() || is_object() || is_bigint() || is_symbol(); }
+    bool is_cell() const { return is_cell_bits(m_value); }
     bool is_array(GlobalObject&) const;
     bool is_function() const;
     bool is_constructor() const;
@@ -82,159 +82,191 @@ public:
     }
 
     Value()
-        : m_type(Type::Empty)
+        : m_value(encode(empty_tag, 0))
     {
     }
 
     explicit Value(bool value)
-        : m_type(Type::Boolean)
+        : m_value(encode(boolean_tag, value))
     {
-        m_value.as_bool = value;
     }
 
     explicit Value(double value)
     {
         bool is_negative_zero = bit_cast<u64>(value) == NEGATIVE_ZERO_BITS;
         if (value >= NumericLimits<i32>::min() && value <= NumericLimits<i32>::max() && trunc(value) == value && !is_negative_zero) {
-            m_type = Type::Int32;
-            m_value.as_i32 = static_cast<i32>(value);
+            m_value = encode(int32_tag, static_cast<u32>(static_cast<i32>(value)));
+        } else if (__builtin_isnan(value)) {
+            // All NaNs become the same one, so that none of them can be mistaken for one of the tags below.
+            m_value = canonical_nan_bits;
         } else {
-            m_type = Type::Double;
-            m_value.as_double = value;
+            m_value = bit_cast<u64>(value);
         }
     }
 
     explicit Value(unsigned long value)
     {
-        if (value > NumericLimits<i32>::max()) {
-            m_value.as_double = static_cast<double>(value);
-            m_type = Type::Double;
-        } else {
-            m_value.as_i32 = static_cast<i32>(value);
-            m_type = Type::Int32;
-        }
+        if (value > NumericLimits<i32>::max())
+            m_value = bit_cast<u64>(static_cast<double>(value));
+        else
+            m_value = encode(int32_tag, static_cast<u32>(value));
     }
 
     explicit Value(unsigned value)
     {
-        if (value > NumericLimits<i32>::max()) {
-            m_value.as_double = static_cast<double>(value);
-            m_type = Type::Double;
-        } else {
-            m_value.as_i32 = static_cast<i32>(value);
-            m_type = Type::Int32;
-        }
+        if (value > NumericLimits<i32>::max())
+            m_value = bit_cast<u64>(static_cast<double>(value));
+        else
+            m_value = encode(int32_tag, value);
     }
 
     explicit Value(i32 value)
-        : m_type(Type::Int32)
+        : m_value(encode(int32_tag, static_cast<u32>(value)))
     {
-        m_value.as_i32 = value;
     }
 
     Value(const Object* object)
-        : m_type(object ? Type::Object : Type::Null)
+        : m_value(object ? encode_cell(object_tag, object) : encode(null_tag, 0))
     {
-        m_value.as_object = const_cast<Object*>(object);
     }
 
     Value(const PrimitiveString* string)
-        : m_type(Type::String)
+        : m_value(encode_cell(string_tag, string))
     {
-        m_value.as_string = const_cast<PrimitiveString*>(string);
     }
 
     Value(const Symbol* symbol)
-        : m_type(Type::Symbol)
+        : m_value(encode_cell(symbol_tag, symbol))
     {
-        m_value.as_symbol = const_cast<Symbol*>(symbol);
     }
 
     Value(const Accessor* accessor)
-        : m_type(Type::Accessor)
+        : m_value(encode_cell(accessor_tag, accessor))
     {
-        m_value.as_accessor = const_cast<Accessor*>(accessor);
     }
 
     Value(const BigInt* bigint)
-        : m_type(Type::BigInt)
+        : m_value(encode_cell(bigint_tag, bigint))
     {
-        m_value.as_bigint = const_cast<BigInt*>(bigint);
     }
 
     explicit Value(Type type)
-        : m_type(type)
     {
+        switch (type) {
+        case Type::Empty:
+            m_value = encode(empty_tag, 0);
+            break;
+        case Type::Undefined:
+            m_value = encode(undefined_tag, 0);
+            break;
+        case Type::Null:
+            m_value = encode(null_tag, 0);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
     }
 
-    Type type() const { return m_type; }
+    Type type() const
+    {
+        switch (tag()) {
+        case empty_tag:
+            return Type::Empty;
+        case undefined_tag:
+            return Type::Undefined;
+        case null_tag:
+            return Type::Null;
+        case int32_tag:
+            return Type::Int32;
+        case boolean_tag:
+            return Type::Boolean;
+        case string_tag:
+            return Type::String;
+        case symbol_tag:
+            return Type::Symbol;
+        case object_tag:
+            return Type::Object;
+        case accessor_tag:
+            return Type::Accessor;
+        case bigint_tag:
+            return Type::BigInt;
+        default:
+            return Type::Double;
+        }
+    }
 
     double as_double() const
     {
         VERIFY(is_number());
-        if (m_type == Type::Int32)
-            return m_value.as_i32;
-        return m_value.as_double;
+        if (is_int32())
+            return int32_payload();
+        return bit_cast<double>(m_value);
     }
 
     bool as_bool() const
     {
-        VERIFY(type() == Type::Boolean);
-        return m_value.as_bool;
+        VERIFY(is_boolean());
+        return payload();
     }
 
     Object& as_object()
     {
-        VERIFY(type() == Type::Object);
-        return *m_value.as_object;
+        VERIFY(is_object());
+        return *cell_payload<Object>();
     }
 
     const Object& as_object() const
     {
-        VERIFY(type() == Type::Object);
-        return *m_value.as_object;
+        VERIFY(is_object());
+        return *cell_payload<Object>();
     }
 
     PrimitiveString& as_string()
     {
         VERIFY(is_string());
-        return *m_value.as_string;
+        return *cell_payload<PrimitiveString>();
     }
 
     const PrimitiveString& as_string() const
     {
         VERIFY(is_string());
-        return *m_value.as_string;
+        return *cell_payload<PrimitiveString>();
     }
 
     Symbol& as_symbol()
     {
         VERIFY(is_symbol());
-        return *m_value.as_symbol;
+        return *cell_payload<Symbol>();
     }
 
     const Symbol& as_symbol() const
     {
         VERIFY(is_symbol());
-        return *m_value.as_symbol;
+        return *cell_payload<Symbol>();
     }
 
     Cell& as_cell()
     {
         VERIFY(is_cell());
-        return *m_value.as_cell;
+        return *cell_payload<Cell>();
     }
 
     Accessor& as_accessor()
     {
         VERIFY(is_accessor());
-        return *m_value.as_accessor;
+        return *cell_payload<Accessor>();
     }
 
     BigInt& as_bigint()
     {
         VERIFY(is_bigint());
-        return *m_value.as_bigint;
+        return *cell_payload<BigInt>();
+    }
+
+    const BigInt& as_bigint() const
+    {
+        VERIFY(is_bigint());
+        return *cell_payload<BigInt>();
     }
 
     Array& as_array();
@@ -243,7 +275,17 @@ public:
     i32 as_i32() const;
     u32 as_u32() const;
 
-    u64 encoded() const { return m_value.encoded; }
+    u64 encoded() const { return m_value; }
+
+    // The conservative garbage collector only sees the raw bits of Values on the stack, so it needs to
+    // be able to dig the cell pointers out of those.
+    static constexpr bool is_cell_bits(u64 bits) { return (bits >> tag_shift) >= first_cell_tag; }
+    static constexpr u64 cell_pointer_bits(u64 bits) { return bits & payload_mask; }
+
+    // The bytecode JIT checks for and builds int32 and boolean Values on their raw bits.
+    static constexpr u64 encoded_tag_shift = 48;
+    static constexpr u16 encoded_int32_tag = 0x7ffc;
+    static constexpr u16 encoded_boolean_tag = 0x7ffd;
 
     String to_string(GlobalObject&, bool legacy_null_to_empty_string = false) const;
     Vector<u16> to_utf16_string(GlobalObject&) const;
@@ -259,8 +301,8 @@ public:
     StringOrSymbol to_property_key(GlobalObject&) const;
     i32 to_i32(GlobalObject& global_object) const
     {
-        if (m_type == Type::Int32)
-            return m_value.as_i32;
+        if (is_int32())
+            return int32_payload();
         return to_i32_slow_case(global_object);
     }
     u32 to_u32(GlobalObject&) const;
@@ -291,25 +333,62 @@ public:
     bool operator==(Value const&) const;
 
 private:
-    Type m_type { Type::Empty };
+    // A Value is NaN-boxed into 64 bits. Doubles are stored as they are, except that every NaN is turned
+    // into the same canonical one. That leaves all the other NaN bit patterns free to hold everything else:
+    // the top 16 bits say what kind of value it is, and the low 48 bits hold an i32, a bool, or a pointer
+    // to a cell (which always fits into 48 bits on the platforms we run on).
+    //
+    // Positive doubles never have a top half above 0x7ff8 (the canonical NaN), and negative ones never
+    // go above 0xfff0 (negative infinity), so the tags below can't be confused with a double. All cell
+    // tags are above all the others, so a single comparison tells whether a value is a cell.
+    static constexpr u64 tag_shift = encoded_tag_shift;
+    static constexpr u64 payload_mask = 0x0000ffffffffffff;
+    static constexpr u64 canonical_nan_bits = 0x7ff8000000000000;
+
+    static constexpr u16 empty_tag = 0x7ff9;
+    static constexpr u16 undefined_tag = 0x7ffa;
+    static constexpr u16 null_tag = 0x7ffb;
+    static constexpr u16 int32_tag = encoded_int32_tag;
+    static constexpr u16 boolean_tag = encoded_boolean_tag;
+
+    static constexpr u16 first_cell_tag = 0xfff9;
+    static constexpr u16 string_tag = 0xfff9;
+    static constexpr u16 symbol_tag = 0xfffa;
+    static constexpr u16 object_tag = 0xfffb;
+    static constexpr u16 accessor_tag = 0xfffc;
+    static constexpr u16 bigint_tag = 0xfffd;
+
+    static constexpr u64 encode(u16 tag, u64 payload) { return (static_cast<u64>(tag) << tag_shift) | payload; }
+
+    static u64 encode_cell(u16 tag, void const* cell)
+    {
+        auto pointer = static_cast<u64>(reinterpret_cast<FlatPtr>(cell));
+        VERIFY(!(pointer & ~payload_mask));
+        return encode(tag, pointer);
+    }
+
+    u16 tag() const { return static_cast<u16>(m_value >> tag_shift); }
+    u64 payload() const { return m_value & payload_mask; }
+
+    bool is_int32() const { return tag() == int32_tag; }
+    bool is_double() const
+    {
+        auto tag = this->tag();
+        return tag < empty_tag || (tag > boolean_tag && tag < first_cell_tag);
+    }
+
+    i32 int32_payload() const { return static_cast<i32>(static_cast<u32>(m_value)); }
+
+    template<typename T>
+    T* cell_payload() const { return reinterpret_cast<T*>(static_cast<FlatPtr>(payload())); }
 
     i32 to_i32_slow_case(GlobalObject&) const;
 
-    union {
-        bool as_bool;
-        i32 as_i32;
-        double as_double;
-        PrimitiveString* as_string;
-        Symbol* as_symbol;
-        Object* as_object;
-        Cell* as_cell;
-        Accessor* as_accessor;
-        BigInt* as_bigint;
-
-        u64 encoded;
-    } m_value { .encoded = 0 };
+    u64 m_value { encode(empty_tag, 0) };
 };
 
+static_assert(sizeof(Value) == sizeof(u64));
+
 inline Value js_undefined()
 {
     return Value(Value::Type::Undefined);
@@ -28,6 +28,7 @@ public:
     void update_execution_generation() { m_last_execution_generation = vm().execution_generation(); };
 
     virtual void remove_swept_cells(Badge<Heap>, Vector<Cell*>&) override;
+    virtual void did_become_unreachable() override { WeakContainer::deregister(); }
 
 private:
     virtual void visit_edges(Visitor&) override;
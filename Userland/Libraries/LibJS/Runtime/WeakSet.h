@@ -28,6 +28,7 @@ public:
     HashTable<Cell*>& values() { return m_values; };
 
     virtual void remove_swept_cells(Badge<Heap>, Vector<Cell*>&) override;
+    virtual void did_become_unreachable() override { WeakContainer::deregister(); }
 
 private:
     HashTable<Cell*> m_values; // This stores Cell pointers instead of Object pointers to aide with sweeping
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/ScriptCache.h>
+#include <string.h>
+
+namespace JS {
+
+ScriptCache& ScriptCache::the()
+{
+    static ScriptCache cache;
+    return cache;
+}
+
+Bytecode::Executable const& ScriptCache::Script::executable()
+{
+    if (!m_executable.has_value()) {
+        m_executable = Bytecode::Generator::generate(m_program);
+        Bytecode::Interpreter::optimization_pipeline().perform(*m_executable);
+    }
+    return *m_executable;
+}
+
+ScriptCache::ParseResult ScriptCache::parse(StringView filename, StringView source, bool lazy_function_parsing)
+{
+    auto source_hash = Crypto::Hash::SHA256::hash(source);
+    for (size_t i = 0; i < m_scripts.size(); ++i) {
+        auto& script = m_scripts[i];
+        if (script.m_filename != filename || memcmp(script.m_source_hash.data, source_hash.data, sizeof(source_hash.data)) != 0)
+            continue;
+        NonnullRefPtr<Script> found = script;
+        m_scripts.remove(i);
+        m_scripts.prepend(found);
+        return found;
+    }
+
+    // The AST keeps pointing at the filename it was parsed with, so it has to be the one the script holds on to.
+    String owned_filename = filename;
+    auto parser = Parser(Lexer(source, owned_filename));
+    parser.set_lazy_function_parsing(lazy_function_parsing);
+    auto program = parser.parse_program();
+    if (parser.has_errors())
+        return parser.errors();
+
+    auto script = adopt_ref(*new Script(move(owned_filename), source_hash, move(program)));
+    m_scripts.prepend(script);
+    if (m_scripts.size() > m_capacity)
+        m_scripts.take_last();
+    return script;
+}
+
+void ScriptCache::set_capacity(size_t capacity)
+{
+    m_capacity = capacity;
+    while (m_scripts.size() > m_capacity)
+        m_scripts.take_last();
+}
+
+}
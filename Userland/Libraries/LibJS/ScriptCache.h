@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/RefCounted.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Parser.h>
+
+namespace JS {
+
+// Keeps recently run scripts around in parsed form, so running the same script again (say, on the next
+// page load) doesn't have to lex and parse it again. Scripts are identified by their filename or URL and
+// a hash of their source, so a script that changed is never mistaken for the old one.
+class ScriptCache {
+public:
+    static ScriptCache& the();
+
+    class Script : public RefCounted<Script> {
+    public:
+        Program const& program() const { return m_program; }
+
+        // The bytecode is generated and optimized the first time it's asked for, and then kept along with the AST it refers to.
+        Bytecode::Executable const& executable();
+
+    private:
+        friend class ScriptCache;
+
+        Script(String filename, Crypto::Hash::SHA256::DigestType source_hash, NonnullRefPtr<Program> program)
+            : m_filename(move(filename))
+            , m_source_hash(source_hash)
+            , m_program(move(program))
+        {
+        }
+
+        String m_filename;
+        Crypto::Hash::SHA256::DigestType m_source_hash;
+        NonnullRefPtr<Program> m_program;
+        Optional<Bytecode::Executable> m_executable;
+    };
+
+    using ParseResult = Result<NonnullRefPtr<Script>, Vector<Parser::Error>>;
+
+    // Returns the cached script with this filename and source, or parses it and adds it to the cache.
+    // Scripts with syntax errors aren't cached.
+    ParseResult parse(StringView filename, StringView source, bool lazy_function_parsing = false);
+
+    size_t size() const { return m_scripts.size(); }
+    void set_capacity(size_t);
+    void clear() { m_scripts.clear(); }
+
+private:
+    ScriptCache() = default;
+
+    // The most recently used script comes first.
+    NonnullRefPtrVector<Script> m_scripts;
+    size_t m_capacity { 32 };
+};
+
+}
@@ -23,3 +23,23 @@ test("basic functionality", () => {
     expect([].indexOf()).toBe(-1);
     expect([undefined].indexOf()).toBe(0);
 });
+
+test("number arrays", () => {
+    var array = [1, 2.5, NaN, -0, 3];
+
+    expect(array.indexOf(2.5)).toBe(1);
+    expect(array.indexOf("2.5")).toBe(-1);
+    expect(array.indexOf(NaN)).toBe(-1);
+    expect(array.indexOf(0)).toBe(3);
+    expect(array.indexOf(3, { valueOf: () => array.push(4) && 4 })).toBe(4);
+});
+
+test("holes are looked up on the prototype", () => {
+    var array = [1, , 3];
+    Array.prototype[1] = "from prototype";
+    try {
+        expect(array.indexOf("from prototype")).toBe(1);
+    } finally {
+        delete Array.prototype[1];
+    }
+});
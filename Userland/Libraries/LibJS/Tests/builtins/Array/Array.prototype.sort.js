@@ -115,6 +115,33 @@ describe("Array.prototype.sort", () => {
         expect(arr[2].other_property == 2);
     });
 
+    test("numbers are sorted by their string representation and the sort is stable", () => {
+        var arr = [10, -0, 9, 0, 1.5, -0, -1];
+        arr.sort();
+        expect(arr).toEqual([-1, -0, 0, -0, 1.5, 10, 9]);
+        expect(Object.is(arr[1], -0)).toBeTrue();
+        expect(Object.is(arr[2], 0)).toBeTrue();
+        expect(Object.is(arr[3], -0)).toBeTrue();
+    });
+
+    test("that it copes with the compare function changing the array", () => {
+        var arr = [3, 1, 2];
+        arr.sort((a, b) => {
+            arr.length = 0;
+            return a - b;
+        });
+        expect(arr).toEqual([1, 2, 3]);
+
+        arr = [3, 1, 2];
+        expect(() =>
+            arr.sort((a, b) => {
+                Object.freeze(arr);
+                return a - b;
+            })
+        ).toThrow(TypeError);
+        expect(arr).toEqual([3, 1, 2]);
+    });
+
     test("that it makes no unnecessary calls to compare function", () => {
         expectNoCallCompareFunction = function (a, b) {
             expect().fail();
@@ -0,0 +1,68 @@
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint8ClampedArray,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.set).toHaveLength(1);
+
+        const typedArray = new T(4);
+        expect(typedArray.set([1, 2])).toBeUndefined();
+        expect(Array.from(typedArray)).toEqual([1, 2, 0, 0]);
+
+        typedArray.set([3, { valueOf: () => 4 }], 2);
+        expect(Array.from(typedArray)).toEqual([1, 2, 3, 4]);
+
+        typedArray.set(new T([5, 6]), 1);
+        expect(Array.from(typedArray)).toEqual([1, 5, 6, 4]);
+    });
+});
+
+test("source arrays with holes", () => {
+    const typedArray = new Float64Array(3);
+    typedArray.set([1, , 3]);
+    expect(typedArray[0]).toBe(1);
+    expect(typedArray[1]).toBeNaN();
+    expect(typedArray[2]).toBe(3);
+});
+
+test("typed arrays of a different type are converted", () => {
+    const typedArray = new Int32Array(2);
+    typedArray.set(new Float32Array([1.5, -2.5]));
+    expect(Array.from(typedArray)).toEqual([1, -2]);
+
+    const offsetSource = new Uint8Array([1, 2, 3, 4]).subarray(2);
+    const target = new Uint8Array(2);
+    target.set(offsetSource);
+    expect(Array.from(target)).toEqual([3, 4]);
+});
+
+test("overlapping typed arrays in the same buffer", () => {
+    const typedArray = new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8]);
+    typedArray.set(typedArray.subarray(0, 4), 2);
+    expect(Array.from(typedArray)).toEqual([1, 2, 1, 2, 3, 4, 7, 8]);
+
+    const wide = new Uint16Array(4);
+    const narrow = new Uint8Array(wide.buffer);
+    narrow.set([1, 2, 3, 4]);
+    wide.set(narrow.subarray(0, 2));
+    expect(Array.from(wide)).toEqual([1, 2, 0, 0]);
+});
+
+test("errors", () => {
+    expect(() => {
+        new Uint8Array(2).set([1, 2, 3]);
+    }).toThrowWithMessage(RangeError, "Overflow or out of bounds in target length");
+
+    expect(() => {
+        new Uint8Array(2).set([1], -1);
+    }).toThrowWithMessage(RangeError, "Invalid target offset");
+});
@@ -0,0 +1,15 @@
+test("collecting a very long chain of objects", () => {
+    let head = null;
+    for (let i = 0; i < 300000; ++i) head = { next: head, value: i };
+
+    gc();
+
+    let length = 0;
+    let sum = 0;
+    for (let node = head; node !== null; node = node.next) {
+        ++length;
+        sum += node.value;
+    }
+    expect(length).toBe(300000);
+    expect(sum).toBe((299999 * 300000) / 2);
+});
@@ -0,0 +1,32 @@
+test("appending in a loop", () => {
+    let string = "";
+    for (let i = 0; i < 1000; ++i) string += "piece " + i + ";";
+    expect(string).toHaveLength(9890);
+    expect(string.startsWith("piece 0;piece 1;")).toBeTrue();
+    expect(string.endsWith("piece 999;")).toBeTrue();
+    expect(string.charCodeAt(6)).toBe(48);
+    expect(string.indexOf("piece 500;")).toBe(4890);
+});
+
+test("prepending in a loop", () => {
+    let string = "";
+    for (let i = 0; i < 100; ++i) string = i + ":" + "x".repeat(30) + string;
+    expect(string).toHaveLength(3290);
+    expect(string.startsWith("99:")).toBeTrue();
+    expect(string.endsWith("0:" + "x".repeat(30))).toBeTrue();
+});
+
+test("surrogate pairs split across the two strings", () => {
+    const padding = "x".repeat(40);
+    const string = padding + "\ud83d" + ("\ude00" + padding);
+    expect(string).toHaveLength(82);
+    expect(string).toBe(padding + "😀" + padding);
+    expect(string.codePointAt(40)).toBe(0x1f600);
+});
+
+test("strings that survive garbage collection", () => {
+    let string = "a".repeat(40);
+    for (let i = 0; i < 100; ++i) string += "b".repeat(i % 5);
+    gc();
+    expect(string).toBe("a".repeat(40) + "b".repeat(200));
+});
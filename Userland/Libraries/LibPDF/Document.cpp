@@ -43,7 +43,9 @@ RefPtr<Document> Document::create(ReadonlyBytes const& bytes)
         return {};
 
     document->m_catalog = parser->trailer()->get_dict(document, CommonNames::Root);
-    document->build_page_tree();
+    document->m_linearized_first_page = parser->linearized_first_page();
+    if (!document->m_linearized_first_page.has_value())
+        document->build_page_tree();
     document->build_outline();
 
     return document;
@@ -55,6 +57,17 @@ Document::Document(NonnullRefPtr<Parser> const& parser)
     m_parser->set_document(this);
 }
 
+Value Document::get_value(u32 index)
+{
+    if (auto value = m_values.get(index); value.has_value())
+        return value.value();
+    auto stream = m_streams.find(index);
+    if (stream == m_streams.end())
+        return {};
+    stream->value.last_use = ++m_cache_use_counter;
+    return stream->value.value;
+}
+
 Value Document::get_or_load_value(u32 index)
 {
     auto value = get_value(index);
@@ -62,31 +75,61 @@ Value Document::get_or_load_value(u32 index)
         return value;
 
     auto object = m_parser->parse_object_with_index(index);
-    m_values.set(index, object);
+    if (object.is_object() && object.as_object()->is_stream())
+        cache_stream(index, object);
+    else
+        m_values.set(index, object);
     return object;
 }
 
+void Document::cache_stream(u32 index, Value const& value)
+{
+    if (m_streams.size() >= stream_cache_size) {
+        auto least_recently_used = m_streams.begin();
+        for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+            if (it->value.last_use < least_recently_used->value.last_use)
+                least_recently_used = it;
+        }
+        m_streams.remove(least_recently_used);
+    }
+    m_streams.set(index, { value, ++m_cache_use_counter });
+}
+
 u32 Document::get_first_page_index() const
 {
-    // FIXME: A PDF can have a different default first page, which
+    // FIXME: A non-linearized PDF can have a different default first page too, which
     // should be fetched and returned here
+    if (m_linearized_first_page.has_value())
+        return m_linearized_first_page->page_index;
     return 0;
 }
 
 u32 Document::get_page_count() const
 {
+    if (m_linearized_first_page.has_value())
+        return m_linearized_first_page->page_count;
     return m_page_object_indices.size();
 }
 
-Page Document::get_page(u32 index)
+u32 Document::get_page_object_index(u32 index)
 {
+    if (m_linearized_first_page.has_value() && index == m_linearized_first_page->page_index)
+        return m_linearized_first_page->object_index;
+    if (!m_has_page_tree)
+        build_page_tree();
     VERIFY(index < m_page_object_indices.size());
+    return m_page_object_indices[index];
+}
+
+Page Document::get_page(u32 index)
+{
+    VERIFY(index < get_page_count());
 
     auto cached_page = m_pages.get(index);
     if (cached_page.has_value())
         return cached_page.value();
 
-    auto page_object_index = m_page_object_indices[index];
+    auto page_object_index = get_page_object_index(index);
     auto raw_page_object = resolve_to<DictObject>(get_or_load_value(page_object_index));
 
     if (!raw_page_object->contains(CommonNames::Resources)) {
@@ -131,6 +174,50 @@ Page Document::get_page(u32 index)
     return page;
 }
 
+NonnullRefPtr<PageCommands> Document::get_page_commands(Page const& page)
+{
+    for (auto& cached : m_page_commands) {
+        if (cached.contents.ptr() == page.contents.ptr()) {
+            cached.last_use = ++m_cache_use_counter;
+            return cached.commands;
+        }
+    }
+
+    // Use our own vector, as the /Content can be an array with multiple
+    // streams which gets concatenated
+    // FIXME: Text operators are supposed to only have effects on the current
+    // stream object. Do the text operators treat this concatenated stream
+    // as one stream or multiple?
+    ByteBuffer byte_buffer;
+
+    if (page.contents->is_array()) {
+        auto contents = object_cast<ArrayObject>(page.contents);
+        for (auto& ref : *contents) {
+            auto stream = resolve_to<StreamObject>(ref);
+            auto bytes = stream->bytes();
+            byte_buffer.append(bytes.data(), bytes.size());
+        }
+    } else {
+        VERIFY(page.contents->is_stream());
+        auto bytes = object_cast<StreamObject>(page.contents)->bytes();
+        byte_buffer.append(bytes.data(), bytes.size());
+    }
+
+    auto commands = adopt_ref(*new PageCommands);
+    commands->commands = Parser::parse_graphics_commands(byte_buffer);
+
+    if (m_page_commands.size() >= page_commands_cache_size) {
+        size_t least_recently_used = 0;
+        for (size_t i = 1; i < m_page_commands.size(); i++) {
+            if (m_page_commands[i].last_use < m_page_commands[least_recently_used].last_use)
+                least_recently_used = i;
+        }
+        m_page_commands.remove(least_recently_used);
+    }
+    m_page_commands.append({ page.contents, commands, ++m_cache_use_counter });
+    return commands;
+}
+
 Value Document::resolve(Value const& value)
 {
     if (value.is_ref()) {
@@ -156,6 +243,7 @@ bool Document::build_page_tree()
     if (!m_catalog->contains(CommonNames::Pages))
         return false;
     auto page_tree = m_catalog->get_dict(this, CommonNames::Pages);
+    m_has_page_tree = true;
     return add_page_tree_node_to_page_tree(page_tree);
 }
 
@@ -70,6 +70,13 @@ struct OutlineDict final : public RefCounted<OutlineDict> {
     OutlineDict() = default;
 };
 
+// The graphics commands of a page, as parsed from its content streams.
+struct PageCommands final : public RefCounted<PageCommands> {
+    Vector<Command> commands;
+};
+
+// Objects are only parsed once something asks for them. A Document isn't thread-safe, so a
+// program that renders on another thread has to leave the document to that thread.
 class Document final : public RefCounted<Document> {
 public:
     static RefPtr<Document> create(ReadonlyBytes const& bytes);
@@ -84,10 +91,11 @@ public:
 
     [[nodiscard]] Page get_page(u32 index);
 
-    ALWAYS_INLINE Value get_value(u32 index) const
-    {
-        return m_values.get(index).value_or({});
-    }
+    // Parsing a page's content is most of the work of rendering it, so the commands of the
+    // last few pages that were rendered are kept around for when they are rendered again.
+    [[nodiscard]] NonnullRefPtr<PageCommands> get_page_commands(Page const&);
+
+    Value get_value(u32 index);
 
     // Strips away the layer of indirection by turning indirect value
     // refs into the value they reference, and indirect values into
@@ -124,6 +132,9 @@ private:
     // every page tree node of, say, a 1000+ page PDF file.
     bool build_page_tree();
     bool add_page_tree_node_to_page_tree(NonnullRefPtr<DictObject> const& page_tree);
+    u32 get_page_object_index(u32 index);
+
+    void cache_stream(u32 index, Value const&);
 
     void build_outline();
     NonnullRefPtr<OutlineItem> build_outline_item(NonnullRefPtr<DictObject> const& outline_item_dict);
@@ -132,9 +143,31 @@ private:
     NonnullRefPtr<Parser> m_parser;
     RefPtr<DictObject> m_catalog;
     Vector<u32> m_page_object_indices;
+    // Linearized files get by without the page tree until a page other than the first one is needed.
+    Optional<Parser::LinearizedFirstPage> m_linearized_first_page;
+    bool m_has_page_tree { false };
     HashMap<u32, Page> m_pages;
     HashMap<u32, Value> m_values;
     RefPtr<OutlineDict> m_outline;
+
+    // Streams are what most of a file is made of, so only the most recently used ones stay parsed
+    // (and decoded), while everything else is cached in m_values for as long as the document lives.
+    static constexpr size_t stream_cache_size = 64;
+    struct CachedStream {
+        Value value;
+        u64 last_use { 0 };
+    };
+    HashMap<u32, CachedStream> m_streams;
+
+    static constexpr size_t page_commands_cache_size = 8;
+    struct CachedPageCommands {
+        NonnullRefPtr<Object> contents;
+        NonnullRefPtr<PageCommands> commands;
+        u64 last_use { 0 };
+    };
+    Vector<CachedPageCommands> m_page_commands;
+
+    u64 m_cache_use_counter { 0 };
 };
 
 }
@@ -6,6 +6,7 @@
 
 #include <AK/Hex.h>
 #include <LibPDF/Document.h>
+#include <LibPDF/Filter.h>
 #include <LibPDF/Object.h>
 
 namespace PDF {
@@ -20,6 +21,17 @@ NonnullRefPtr<Object> DictObject::get_object(Document* document, FlyString const
     return document->resolve_to<Object>(get_value(key));
 }
 
+ReadonlyBytes EncodedStreamObject::bytes() const
+{
+    if (!m_decoded_buffer.has_value()) {
+        auto maybe_bytes = Filter::decode(m_encoded_bytes, m_filter);
+        if (!maybe_bytes.has_value())
+            dbgln("Failed to decode {} stream", m_filter);
+        m_decoded_buffer = maybe_bytes.value_or({});
+    }
+    return m_decoded_buffer->bytes();
+}
+
 #define DEFINE_ACCESSORS(class_name, snake_name)                                                           \
     NonnullRefPtr<class_name> ArrayObject::get_##snake_name##_at(Document* document, size_t index) const   \
     {                                                                                                      \
@@ -190,20 +190,26 @@ private:
     ReadonlyBytes m_bytes;
 };
 
+// The stream's filter is only run once its bytes are first asked for, so that parsing an object doesn't
+// decompress streams that are never looked at.
 class EncodedStreamObject final : public StreamObject {
 public:
-    EncodedStreamObject(NonnullRefPtr<DictObject> const& dict, ByteBuffer&& buffer)
+    EncodedStreamObject(NonnullRefPtr<DictObject> const& dict, ReadonlyBytes const& encoded_bytes, FlyString const& filter)
         : StreamObject(dict)
-        , m_buffer(buffer)
+        , m_encoded_bytes(encoded_bytes)
+        , m_filter(filter)
     {
     }
 
     virtual ~EncodedStreamObject() override = default;
 
-    [[nodiscard]] ALWAYS_INLINE virtual ReadonlyBytes bytes() const override { return m_buffer.bytes(); }
+    // A stream whose filter fails is treated as empty.
+    [[nodiscard]] virtual ReadonlyBytes bytes() const override;
 
 private:
-    ByteBuffer m_buffer;
+    ReadonlyBytes m_encoded_bytes;
+    FlyString m_filter;
+    mutable Optional<ByteBuffer> m_decoded_buffer;
 };
 
 class IndirectValue final : public Object {
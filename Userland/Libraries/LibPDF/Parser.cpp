@@ -10,7 +10,6 @@
 #include <AK/TypeCasts.h>
 #include <LibPDF/CommonNames.h>
 #include <LibPDF/Document.h>
-#include <LibPDF/Filter.h>
 #include <LibPDF/Parser.h>
 #include <LibTextCodec/Decoder.h>
 #include <ctype.h>
@@ -71,6 +70,18 @@ bool Parser::initialize()
     return initialize_non_linearized_xref_table();
 }
 
+Optional<Parser::LinearizedFirstPage> Parser::linearized_first_page() const
+{
+    if (!m_linearization_dictionary.has_value())
+        return {};
+    auto& dict = m_linearization_dictionary.value();
+    if (dict.number_of_pages == 0 || !m_xref_table->has_object(dict.first_page_object_number))
+        return {};
+    // The first page is the one that the file opens to, which is page 0 unless the dictionary says otherwise.
+    u32 page_index = dict.first_page < dict.number_of_pages ? dict.first_page : 0;
+    return LinearizedFirstPage { dict.first_page_object_number, page_index, dict.number_of_pages };
+}
+
 Value Parser::parse_object_with_index(u32 index)
 {
     VERIFY(m_xref_table->has_object(index));
@@ -1058,10 +1069,7 @@ RefPtr<StreamObject> Parser::parse_stream(NonnullRefPtr<DictObject> dict)
 
     if (dict->contains(CommonNames::Filter)) {
         auto filter_type = dict->get_name(m_document, CommonNames::Filter)->name();
-        auto maybe_bytes = Filter::decode(bytes, filter_type);
-        if (!maybe_bytes.has_value())
-            return {};
-        return make_object<EncodedStreamObject>(dict, move(maybe_bytes.value()));
+        return make_object<EncodedStreamObject>(dict, bytes, filter_type);
     }
 
     return make_object<PlainTextStreamObject>(dict, bytes);
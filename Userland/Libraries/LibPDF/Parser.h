@@ -36,6 +36,15 @@ public:
 
     Value parse_object_with_index(u32 index);
 
+    // A linearized file names the object of the page it opens to and the number of pages up front,
+    // so that a viewer can show that page before it has walked the page tree.
+    struct LinearizedFirstPage {
+        u32 object_index { 0 };
+        u32 page_index { 0 };
+        u32 page_count { 0 };
+    };
+    Optional<LinearizedFirstPage> linearized_first_page() const;
+
     // Specialized version of parse_dict which aborts early if the dict being parsed
     // is not a page object. A null RefPtr return indicates that the dict at this index
     // is not a page tree node, whereas ok == false indicates a malformed PDF file and
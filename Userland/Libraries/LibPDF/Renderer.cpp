@@ -58,28 +58,8 @@ Renderer::Renderer(RefPtr<Document> document, Page const& page, RefPtr<Gfx::Bitm
 
 void Renderer::render()
 {
-    // Use our own vector, as the /Content can be an array with multiple
-    // streams which gets concatenated
-    // FIXME: Text operators are supposed to only have effects on the current
-    // stream object. Do the text operators treat this concatenated stream
-    // as one stream or multiple?
-    ByteBuffer byte_buffer;
-
-    if (m_page.contents->is_array()) {
-        auto contents = object_cast<ArrayObject>(m_page.contents);
-        for (auto& ref : *contents) {
-            auto bytes = m_document->resolve_to<StreamObject>(ref)->bytes();
-            byte_buffer.append(bytes.data(), bytes.size());
-        }
-    } else {
-        VERIFY(m_page.contents->is_stream());
-        auto bytes = object_cast<StreamObject>(m_page.contents)->bytes();
-        byte_buffer.append(bytes.data(), bytes.size());
-    }
-
-    auto commands = Parser::parse_graphics_commands(byte_buffer);
-
-    for (auto& command : commands)
+    auto page_commands = m_document->get_page_commands(m_page);
+    for (auto& command : page_commands->commands)
         handle_command(command);
 }
 
@@ -6,52 +6,96 @@
 
 #include <LibProtocol/Request.h>
 #include <LibProtocol/RequestClient.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
 
 namespace Protocol {
 
+// Don't trust a server's Content-Length enough to reserve unbounded amounts of memory up front.
+static constexpr size_t MaxPreallocatedPayloadSize = 16 * MiB;
+
 Request::Request(RequestClient& client, i32 request_id)
     : m_client(client)
     , m_request_id(request_id)
 {
 }
 
+Request::~Request()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
 bool Request::stop()
 {
     return m_client->stop_request({}, *this);
 }
 
-void Request::stream_into(OutputStream& stream)
+void Request::set_response_body(Badge<RequestClient>, int fd, Core::SharedRingBuffer response_body)
 {
-    VERIFY(!m_internal_stream_data);
+    m_fd = fd;
+    m_response_body = move(response_body);
+}
 
-    auto notifier = Core::Notifier::construct(fd(), Core::Notifier::Read);
+void Request::stream_into(OutputStream& stream)
+{
+    read_body([&stream](ReadonlyBytes bytes) {
+        if (!stream.write_or_error(bytes)) {
+            // FIXME: What do we do here?
+            TODO();
+        }
+    });
+}
 
-    m_internal_stream_data = make<InternalStreamData>(fd());
-    m_internal_stream_data->read_notifier = notifier;
+void Request::read_body(Function<void(ReadonlyBytes)> on_data)
+{
+    VERIFY(!m_internal_stream_data);
 
-    auto user_on_finish = move(on_finish);
+    m_internal_stream_data = make<InternalStreamData>();
+    m_internal_stream_data->on_data = move(on_data);
+    m_internal_stream_data->on_finish = move(on_finish);
     on_finish = [this](auto success, auto total_size) {
         m_internal_stream_data->success = success;
         m_internal_stream_data->total_size = total_size;
         m_internal_stream_data->request_done = true;
+        // The body may well be complete already, in which case nothing is going to wake us up anymore.
+        if (m_internal_stream_data->body_done)
+            m_internal_stream_data->on_finish(success, total_size);
     };
 
-    notifier->on_ready_to_read = [this, &stream, user_on_finish = move(user_on_finish)] {
-        constexpr size_t buffer_size = 4096;
-        static char buf[buffer_size];
-        auto nread = m_internal_stream_data->read_stream.read({ buf, buffer_size });
-        if (!stream.write_or_error({ buf, nread })) {
-            // FIXME: What do we do here?
-            TODO();
-        }
+    m_internal_stream_data->read_notifier = Core::Notifier::construct(fd(), Core::Notifier::Read);
+    m_internal_stream_data->read_notifier->on_ready_to_read = [this] {
+        did_become_readable();
+    };
+}
 
-        if (m_internal_stream_data->read_stream.eof() && m_internal_stream_data->request_done) {
-            m_internal_stream_data->read_notifier->close();
-            user_on_finish(m_internal_stream_data->success, m_internal_stream_data->total_size);
-        } else {
-            m_internal_stream_data->read_stream.handle_any_error();
+void Request::did_become_readable()
+{
+    auto& stream_data = *m_internal_stream_data;
+
+    // The pipe only carries wake-up calls, until it's closed once RequestServer is done with the body.
+    u8 wakeups[64];
+    auto nread = read(m_fd, wakeups, sizeof(wakeups));
+    bool is_body_complete = nread == 0;
+    if (nread < 0 && errno != EINTR && errno != EAGAIN) {
+        dbgln("Request: Failed to read from the response body fd: {}", strerror(errno));
+        is_body_complete = true;
+    }
+
+    do {
+        for (auto bytes = m_response_body->peek(); !bytes.is_empty(); bytes = m_response_body->peek()) {
+            stream_data.on_data(bytes);
+            m_response_body->consume(bytes.size());
         }
-    };
+    } while (!is_body_complete && !m_response_body->prepare_to_sleep());
+
+    if (!is_body_complete)
+        return;
+    stream_data.body_done = true;
+    stream_data.read_notifier->close();
+    if (stream_data.request_done)
+        stream_data.on_finish(stream_data.success, stream_data.total_size);
 }
 
 void Request::set_should_buffer_all_input(bool value)
@@ -68,25 +112,33 @@ void Request::set_should_buffer_all_input(bool value)
     VERIFY(!m_internal_stream_data);
     VERIFY(!m_internal_buffered_data);
     VERIFY(on_buffered_request_finish); // Not having this set makes no sense.
-    m_internal_buffered_data = make<InternalBufferedData>(fd());
+    m_internal_buffered_data = make<InternalBufferedData>();
     m_should_buffer_all_input = true;
 
     on_headers_received = [this](auto& headers, auto response_code) {
         m_internal_buffered_data->response_headers = headers;
         m_internal_buffered_data->response_code = move(response_code);
+        // Content-Length is only a hint, as RequestServer may have had to decompress the body.
+        if (auto content_length = headers.get("Content-Length"); content_length.has_value())
+            m_internal_buffered_data->payload.ensure_capacity(min<size_t>(content_length.value().to_uint().value_or(0), MaxPreallocatedPayloadSize));
     };
 
     on_finish = [this](auto success, u32 total_size) {
-        auto output_buffer = m_internal_buffered_data->payload_stream.copy_into_contiguous_buffer();
         on_buffered_request_finish(
             success,
             total_size,
             m_internal_buffered_data->response_headers,
             m_internal_buffered_data->response_code,
-            output_buffer);
+            m_internal_buffered_data->payload);
     };
 
-    stream_into(m_internal_buffered_data->payload_stream);
+    read_body([this](ReadonlyBytes bytes) {
+        auto& payload = m_internal_buffered_data->payload;
+        // ByteBuffer only grows by as much as it has to, which would make this quadratic.
+        if (payload.capacity() < payload.size() + bytes.size())
+            payload.ensure_capacity(max(payload.size() + bytes.size(), payload.capacity() * 2));
+        payload.append(bytes);
+    });
 }
 
 void Request::did_finish(Badge<RequestClient>, bool success, u32 total_size)
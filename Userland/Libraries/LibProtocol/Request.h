@@ -8,13 +8,13 @@
 
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
-#include <AK/FileStream.h>
 #include <AK/Function.h>
-#include <AK/MemoryStream.h>
 #include <AK/RefCounted.h>
+#include <AK/Stream.h>
 #include <AK/String.h>
 #include <AK/WeakPtr.h>
 #include <LibCore/Notifier.h>
+#include <LibCore/SharedRingBuffer.h>
 #include <LibIPC/Forward.h>
 
 namespace Protocol {
@@ -33,6 +33,8 @@ public:
         return adopt_ref(*new Request(client, request_id));
     }
 
+    ~Request();
+
     int id() const { return m_request_id; }
     int fd() const { return m_fd; }
     bool stop();
@@ -56,39 +58,36 @@ public:
     void did_request_certificates(Badge<RequestClient>);
 
     RefPtr<Core::Notifier>& write_notifier(Badge<RequestClient>) { return m_write_notifier; }
-    void set_request_fd(Badge<RequestClient>, int fd) { m_fd = fd; }
+    // The response body arrives in a ring buffer shared with RequestServer, which wakes us up through the fd.
+    void set_response_body(Badge<RequestClient>, int fd, Core::SharedRingBuffer);
 
 private:
     explicit Request(RequestClient&, i32 request_id);
+
+    void read_body(Function<void(ReadonlyBytes)> on_data);
+    void did_become_readable();
+
     WeakPtr<RequestClient> m_client;
     int m_request_id { -1 };
     RefPtr<Core::Notifier> m_write_notifier;
     int m_fd { -1 };
+    Optional<Core::SharedRingBuffer> m_response_body;
     bool m_should_buffer_all_input { false };
 
     struct InternalBufferedData {
-        InternalBufferedData(int fd)
-            : read_stream(fd)
-        {
-        }
-
-        InputFileStream read_stream;
-        DuplexMemoryStream payload_stream;
+        ByteBuffer payload;
         HashMap<String, String, CaseInsensitiveStringTraits> response_headers;
         Optional<u32> response_code;
     };
 
     struct InternalStreamData {
-        InternalStreamData(int fd)
-            : read_stream(fd)
-        {
-        }
-
-        InputFileStream read_stream;
+        Function<void(ReadonlyBytes)> on_data;
+        Function<void(bool success, u32 total_size)> on_finish;
         RefPtr<Core::Notifier> read_notifier;
         bool success;
         u32 total_size { 0 };
         bool request_done { false };
+        bool body_done { false };
     };
 
     OwnPtr<InternalBufferedData> m_internal_buffered_data;
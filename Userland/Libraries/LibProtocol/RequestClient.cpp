@@ -7,6 +7,7 @@
 #include <AK/FileStream.h>
 #include <LibProtocol/Request.h>
 #include <LibProtocol/RequestClient.h>
+#include <unistd.h>
 
 namespace Protocol {
 
@@ -27,8 +28,14 @@ RefPtr<Request> RequestClient::start_request(String const& method, URL const& ur
     if (request_id < 0 || !response.response_fd().has_value())
         return nullptr;
     auto response_fd = response.response_fd().value().take_fd();
+    auto response_body = Core::SharedRingBuffer::attach(response.response_body());
+    if (!response_body.has_value()) {
+        close(response_fd);
+        IPCProxy::stop_request(request_id);
+        return nullptr;
+    }
     auto request = Request::create_from_id({}, *this, request_id);
-    request->set_request_fd({}, response_fd);
+    request->set_response_body({}, response_fd, response_body.release_value());
     m_requests.set(request_id, request);
     return request;
     return nullptr;
@@ -19,6 +19,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/internals.h>
 #include <sys/mman.h>
 #include <syscall.h>
 #include <time.h>
@@ -90,6 +91,8 @@ static int create_thread(pthread_t* thread, void* (*entry)(void*), void* argumen
 [[noreturn]] static void exit_thread(void* code, void* stack_location, size_t stack_size)
 {
     __pthread_key_destroy_for_current_thread();
+    // The key destructors might free memory, so this has to come last.
+    __malloc_flush_thread_cache();
     syscall(SC_exit_thread, code, stack_location, stack_size);
     VERIFY_NOT_REACHED();
 }
@@ -575,8 +578,6 @@ int pthread_equal(pthread_t t1, pthread_t t2)
     return t1 == t2;
 }
 
-// FIXME: Use the fancy futex mechanism above to write an rw lock.
-//        For the time being, let's just use a less-than-good lock to get things working.
 int pthread_rwlock_destroy(pthread_rwlock_t* rl)
 {
     if (!rl)
@@ -584,122 +585,128 @@ int pthread_rwlock_destroy(pthread_rwlock_t* rl)
     return 0;
 }
 
-// In a very non-straightforward way, this value is composed of two 32-bit integers
-// the top 32 bits are reserved for the ID of write-locking thread (if any)
-// and the bottom 32 bits are:
-//     top 2 bits (30,31): reader wake mask, writer wake mask
-//     middle 16 bits: information
-//        bit 16: someone is waiting to write
-//        bit 17: locked for write
-//     bottom 16 bits (0..15): reader count
-constexpr static u32 reader_wake_mask = 1 << 30;
-constexpr static u32 writer_wake_mask = 1 << 31;
-constexpr static u32 writer_locked_mask = 1 << 17;
-constexpr static u32 writer_intent_mask = 1 << 16;
+// The low 32 bits of a pthread_rwlock_t are the state everyone waits on: the number of readers
+// holding the lock, or rwlock_write_locked while a writer has it. The high 32 bits count the
+// threads waiting for it, readers in the low half and writers in the high half.
+//
+// Writers are preferred: as long as one is waiting, new readers wait as well, so a steady stream
+// of readers can't starve them. This also means that a thread taking a read lock it already holds
+// can deadlock with a waiting writer, which POSIX allows.
+static constexpr u32 rwlock_write_locked = 0xffffffff;
+static constexpr u32 rwlock_waiting_reader = 1;
+static constexpr u32 rwlock_waiting_writer = 1 << 16;
+
+// Readers and writers wait on the same word, these keep their wake-ups apart.
+static constexpr u32 rwlock_reader_bitset = 1 << 0;
+static constexpr u32 rwlock_writer_bitset = 1 << 1;
+
+static u32* rwlock_state(pthread_rwlock_t* lockp)
+{
+    return reinterpret_cast<u32*>(lockp);
+}
+
+static u32* rwlock_waiters(pthread_rwlock_t* lockp)
+{
+    return reinterpret_cast<u32*>(lockp) + 1;
+}
+
 int pthread_rwlock_init(pthread_rwlock_t* __restrict lockp, const pthread_rwlockattr_t* __restrict attr)
 {
     // Just ignore the attributes. use defaults for now.
     (void)attr;
 
-    // No readers, no writer, not locked at all.
+    // No readers, no writer, nobody waiting.
     *lockp = 0;
     return 0;
 }
 
-// Note that this function does not care about the top 32 bits at all.
-static int rwlock_rdlock_maybe_timed(u32* lockp, const struct timespec* timeout = nullptr, bool only_once = false, int value_if_timeout = -1, int value_if_okay = -2)
-{
-    auto current = AK::atomic_load(lockp);
-    for (; !only_once;) {
-        // First, see if this is locked for writing
-        // if it's not, try to add to the counter.
-        // If someone is waiting to write, and there is one or no other readers, let them have the lock.
-        if (!(current & writer_locked_mask)) {
-            auto count = (u16)current;
-            if (!(current & writer_intent_mask) || count > 1) {
-                ++count;
-                auto desired = (current << 16) | count;
-                auto did_exchange = AK::atomic_compare_exchange_strong(lockp, current, desired, AK::MemoryOrder::memory_order_acquire);
-                if (!did_exchange)
-                    continue; // tough luck, try again.
-                return value_if_okay;
-            }
-        }
+// Returns ETIMEDOUT if the timeout has passed, and 0 on every other kind of wake-up.
+static int rwlock_wait(u32* state, u32 value, const struct timespec* abstime, u32 bitset)
+{
+    int saved_errno = errno;
+    int op = FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG;
+    // POSIX measures the timeouts of the rwlock functions against the realtime clock.
+    if (abstime)
+        op |= FUTEX_CLOCK_REALTIME;
+    int rc = futex(state, op, value, abstime, nullptr, bitset);
+    bool timed_out = rc < 0 && errno == ETIMEDOUT;
+    errno = saved_errno;
+    return timed_out ? ETIMEDOUT : 0;
+}
 
-        // If no one else is waiting for the read wake bit, set it.
-        if (!(current & reader_wake_mask)) {
-            auto desired = current | reader_wake_mask;
-            auto did_exchange = AK::atomic_compare_exchange_strong(lockp, current, desired, AK::MemoryOrder::memory_order_acquire);
-            if (!did_exchange)
-                continue; // Something interesting happened!
+static void rwlock_wake(u32* state, u32 count, u32 bitset)
+{
+    int saved_errno = errno;
+    futex(state, FUTEX_WAKE_BITSET | FUTEX_PRIVATE_FLAG, count, nullptr, nullptr, bitset);
+    errno = saved_errno;
+}
 
-            current = desired;
-        }
+static bool rwlock_can_read(pthread_rwlock_t* lockp, u32 state)
+{
+    return state != rwlock_write_locked && state + 1 != rwlock_write_locked
+        && AK::atomic_load(rwlock_waiters(lockp), AK::memory_order_relaxed) < rwlock_waiting_writer;
+}
 
-        // Seems like someone is writing (or is interested in writing and we let them have the lock)
-        // wait until they're done.
-        auto rc = futex(lockp, FUTEX_WAIT_BITSET, current, timeout, nullptr, reader_wake_mask);
-        if (rc < 0 && errno == ETIMEDOUT && timeout) {
-            return value_if_timeout;
-        }
-        if (rc < 0 && errno != EAGAIN) {
-            // Something broke. let's just bail out.
-            return errno;
-        }
-        errno = 0;
-        // Reload the 'current' value
-        current = AK::atomic_load(lockp);
+static int rwlock_rdlock(pthread_rwlock_t* lockp, const struct timespec* abstime, bool only_once)
+{
+    auto* state = rwlock_state(lockp);
+    auto current = AK::atomic_load(state, AK::memory_order_relaxed);
+    while (rwlock_can_read(lockp, current)) {
+        if (AK::atomic_compare_exchange_strong(state, current, current + 1, AK::memory_order_acquire))
+            return 0;
     }
-    return value_if_timeout;
-}
-
-static int rwlock_wrlock_maybe_timed(pthread_rwlock_t* lockval_p, const struct timespec* timeout = nullptr, bool only_once = false, int value_if_timeout = -1, int value_if_okay = -2)
-{
-    u32* lockp = reinterpret_cast<u32*>(lockval_p);
-    auto current = AK::atomic_load(lockp);
-    for (; !only_once;) {
-        // First, see if this is locked for writing, and if there are any readers.
-        // if not, lock it.
-        // If someone is waiting to write, let them have the lock.
-        if (!(current & writer_locked_mask) && ((u16)current) == 0) {
-            if (!(current & writer_intent_mask)) {
-                auto desired = current | writer_locked_mask | writer_intent_mask;
-                auto did_exchange = AK::atomic_compare_exchange_strong(lockp, current, desired, AK::MemoryOrder::memory_order_acquire);
-                if (!did_exchange)
-                    continue;
-
-                // Now that we've locked the value, it's safe to set our thread ID.
-                AK::atomic_store(reinterpret_cast<i32*>(lockval_p) + 1, pthread_self());
-                return value_if_okay;
-            }
-        }
-
-        // That didn't work, if no one else is waiting for the write bit, set it.
-        if (!(current & writer_wake_mask)) {
-            auto desired = current | writer_wake_mask | writer_intent_mask;
-            auto did_exchange = AK::atomic_compare_exchange_strong(lockp, current, desired, AK::MemoryOrder::memory_order_acquire);
-            if (!did_exchange)
-                continue; // Something interesting happened!
+    if (only_once)
+        return EBUSY;
 
-            current = desired;
+    // Announcing ourselves before taking another look at the state makes sure that whoever changes it
+    // next will see us and wake us up.
+    AK::atomic_fetch_add(rwlock_waiters(lockp), rwlock_waiting_reader);
+    int rc = 0;
+    for (;;) {
+        current = AK::atomic_load(state);
+        if (rwlock_can_read(lockp, current)) {
+            if (AK::atomic_compare_exchange_strong(state, current, current + 1, AK::memory_order_acquire))
+                break;
+            continue;
         }
+        rc = rwlock_wait(state, current, abstime, rwlock_reader_bitset);
+        if (rc == ETIMEDOUT)
+            break;
+    }
+    AK::atomic_fetch_sub(rwlock_waiters(lockp), rwlock_waiting_reader);
+    return rc;
+}
 
-        // Seems like someone is writing (or is interested in writing and we let them have the lock)
-        // wait until they're done.
-        auto rc = futex(lockp, FUTEX_WAIT_BITSET, current, timeout, nullptr, writer_wake_mask);
-        if (rc < 0 && errno == ETIMEDOUT && timeout) {
-            return value_if_timeout;
-        }
-        if (rc < 0 && errno != EAGAIN) {
-            // Something broke. let's just bail out.
-            return errno;
+static int rwlock_wrlock(pthread_rwlock_t* lockp, const struct timespec* abstime, bool only_once)
+{
+    auto* state = rwlock_state(lockp);
+    u32 expected = 0;
+    if (AK::atomic_compare_exchange_strong(state, expected, rwlock_write_locked, AK::memory_order_acquire))
+        return 0;
+    if (only_once)
+        return EBUSY;
+
+    AK::atomic_fetch_add(rwlock_waiters(lockp), rwlock_waiting_writer);
+    int rc = 0;
+    for (;;) {
+        auto current = AK::atomic_load(state);
+        if (current == 0) {
+            if (AK::atomic_compare_exchange_strong(state, current, rwlock_write_locked, AK::memory_order_acquire))
+                break;
+            continue;
         }
-        errno = 0;
-        // Reload the 'current' value
-        current = AK::atomic_load(lockp);
+        rc = rwlock_wait(state, current, abstime, rwlock_writer_bitset);
+        if (rc == ETIMEDOUT)
+            break;
     }
+    AK::atomic_fetch_sub(rwlock_waiters(lockp), rwlock_waiting_writer);
 
-    return value_if_timeout;
+    if (rc == ETIMEDOUT) {
+        // Readers may have been waiting only because of us, and we may have eaten a wake-up that was
+        // meant for another writer. Let everyone have another look.
+        rwlock_wake(state, INT32_MAX, rwlock_reader_bitset | rwlock_writer_bitset);
+    }
+    return rc;
 }
 
 int pthread_rwlock_rdlock(pthread_rwlock_t* lockp)
@@ -707,85 +714,60 @@ int pthread_rwlock_rdlock(pthread_rwlock_t* lockp)
     if (!lockp)
         return EINVAL;
 
-    return rwlock_rdlock_maybe_timed(reinterpret_cast<u32*>(lockp), nullptr, false, 0, 0);
+    return rwlock_rdlock(lockp, nullptr, false);
 }
 int pthread_rwlock_timedrdlock(pthread_rwlock_t* __restrict lockp, const struct timespec* __restrict timespec)
 {
     if (!lockp)
         return EINVAL;
 
-    auto rc = rwlock_rdlock_maybe_timed(reinterpret_cast<u32*>(lockp), timespec);
-    if (rc == -1) // "ok"
-        return 0;
-    if (rc == -2) // "timed out"
-        return 1;
-    return rc;
+    return rwlock_rdlock(lockp, timespec, false);
 }
 int pthread_rwlock_timedwrlock(pthread_rwlock_t* __restrict lockp, const struct timespec* __restrict timespec)
 {
     if (!lockp)
         return EINVAL;
 
-    auto rc = rwlock_wrlock_maybe_timed(lockp, timespec);
-    if (rc == -1) // "ok"
-        return 0;
-    if (rc == -2) // "timed out"
-        return 1;
-    return rc;
+    return rwlock_wrlock(lockp, timespec, false);
 }
 int pthread_rwlock_tryrdlock(pthread_rwlock_t* lockp)
 {
     if (!lockp)
         return EINVAL;
 
-    return rwlock_rdlock_maybe_timed(reinterpret_cast<u32*>(lockp), nullptr, true, EBUSY, 0);
+    return rwlock_rdlock(lockp, nullptr, true);
 }
 int pthread_rwlock_trywrlock(pthread_rwlock_t* lockp)
 {
     if (!lockp)
         return EINVAL;
 
-    return rwlock_wrlock_maybe_timed(lockp, nullptr, true, EBUSY, 0);
+    return rwlock_wrlock(lockp, nullptr, true);
 }
-int pthread_rwlock_unlock(pthread_rwlock_t* lockval_p)
+int pthread_rwlock_unlock(pthread_rwlock_t* lockp)
 {
-    if (!lockval_p)
+    if (!lockp)
         return EINVAL;
 
-    // This is a weird API, we don't really know whether we're unlocking write or read...
-    auto lockp = reinterpret_cast<u32*>(lockval_p);
-    auto current = AK::atomic_load(lockp, AK::MemoryOrder::memory_order_relaxed);
-    if (current & writer_locked_mask) {
-        // If this lock is locked for writing, its owner better be us!
-        auto owner_id = AK::atomic_load(reinterpret_cast<i32*>(lockval_p) + 1);
-        auto my_id = pthread_self();
-        if (owner_id != my_id)
-            return EINVAL; // you don't own this lock, silly.
-
-        // Now just unlock it.
-        auto desired = current & ~(writer_locked_mask | writer_intent_mask);
-        AK::atomic_store(lockp, desired, AK::MemoryOrder::memory_order_release);
-        // Then wake both readers and writers, if any.
-        auto rc = futex(lockp, FUTEX_WAKE_BITSET, current, nullptr, nullptr, (current & writer_wake_mask) | reader_wake_mask);
-        if (rc < 0)
-            return errno;
-        return 0;
-    }
+    // We don't know whether this is unlocking a read or a write lock, but the state tells us.
+    auto* state = rwlock_state(lockp);
+    auto current = AK::atomic_load(state, AK::memory_order_relaxed);
+    if (current == 0)
+        return EPERM;
 
-    for (;;) {
-        auto count = (u16)current;
-        if (!count) {
-            // Are you crazy? this isn't even locked!
-            return EINVAL;
-        }
-        --count;
-        auto desired = (current << 16) | count;
-        auto did_exchange = AK::atomic_compare_exchange_strong(lockp, current, desired, AK::MemoryOrder::memory_order_release);
-        if (!did_exchange)
-            continue; // tough luck, try again.
+    if (current == rwlock_write_locked) {
+        AK::atomic_store(state, 0u);
+    } else if (AK::atomic_fetch_sub(state, 1u) != 1) {
+        // There are other readers left, the last of them takes care of the waiters.
+        return 0;
     }
 
-    // Finally, unlocked at last!
+    // Writers go first. One is enough, as it'll wake the next one when it's done.
+    auto waiters = AK::atomic_load(rwlock_waiters(lockp));
+    if (waiters >= rwlock_waiting_writer)
+        rwlock_wake(state, 1, rwlock_writer_bitset);
+    else if (waiters)
+        rwlock_wake(state, INT32_MAX, rwlock_reader_bitset);
     return 0;
 }
 int pthread_rwlock_wrlock(pthread_rwlock_t* lockp)
@@ -793,7 +775,7 @@ int pthread_rwlock_wrlock(pthread_rwlock_t* lockp)
     if (!lockp)
         return EINVAL;
 
-    return rwlock_wrlock_maybe_timed(lockp, nullptr, false, 0, 0);
+    return rwlock_wrlock(lockp, nullptr, false);
 }
 int pthread_rwlockattr_destroy(pthread_rwlockattr_t*)
 {
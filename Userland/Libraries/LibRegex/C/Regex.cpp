@@ -59,9 +59,9 @@ int regcomp(regex_t* reg, const char* pattern, int cflags)
 
     String pattern_str(pattern);
     if (is_extended)
-        preg->re = make<Regex<PosixExtended>>(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches);
+        preg->re = make<Regex<PosixExtended>>(Regex<PosixExtended>::cached(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches));
     else
-        preg->re = make<Regex<PosixBasic>>(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches);
+        preg->re = make<Regex<PosixBasic>>(Regex<PosixBasic>::cached(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches));
 
     auto parser_result = preg->re->visit([](auto& re) { return re->parser_result; });
 
@@ -178,6 +178,100 @@ OpCode& ByteCode::get_opcode(MatchState& state) const
     return opcode;
 }
 
+bool ByteCode::can_run_without_backtracking() const
+{
+    MatchState state;
+    while (state.instruction_position < size()) {
+        auto& opcode = get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Jump:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            break;
+        case OpCodeId::Compare: {
+            auto& compare = to<OpCode_Compare>(opcode);
+            size_t offset = state.instruction_position + 3;
+            for (size_t i = 0; i < compare.arguments_count(); ++i) {
+                switch ((CharacterCompareType)at(offset++)) {
+                case CharacterCompareType::Inverse:
+                case CharacterCompareType::TemporaryInverse:
+                case CharacterCompareType::AnyChar:
+                    break;
+                case CharacterCompareType::Char:
+                case CharacterCompareType::CharClass:
+                case CharacterCompareType::CharRange:
+                case CharacterCompareType::Property:
+                    ++offset;
+                    break;
+                case CharacterCompareType::String:
+                    offset += at(offset) + 1;
+                    break;
+                case CharacterCompareType::LookupTable:
+                    offset += 4;
+                    break;
+                default:
+                    return false;
+                }
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+        state.instruction_position += opcode.size();
+    }
+    return true;
+}
+
+String ByteCode::literal_prefix() const
+{
+    StringBuilder builder;
+    MatchState state;
+    while (state.instruction_position < size()) {
+        auto& opcode = get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+            state.instruction_position += opcode.size();
+            continue;
+        default:
+            break;
+        }
+        if (opcode.opcode_id() != OpCodeId::Compare)
+            break;
+
+        auto arguments_count = to<OpCode_Compare>(opcode).arguments_count();
+        size_t offset = state.instruction_position + 3;
+        if (arguments_count == 2 && (CharacterCompareType)at(offset) == CharacterCompareType::LookupTable) {
+            offset += 5;
+            --arguments_count;
+        }
+        if (arguments_count != 1)
+            break;
+
+        auto compare_type = (CharacterCompareType)at(offset++);
+        size_t length = 1;
+        if (compare_type == CharacterCompareType::String)
+            length = at(offset++);
+        else if (compare_type != CharacterCompareType::Char)
+            break;
+
+        for (size_t i = 0; i < length; ++i) {
+            auto character = at(offset + i);
+            if (!is_ascii(character))
+                return builder.to_string();
+            builder.append((char)character);
+        }
+        state.instruction_position += opcode.size();
+    }
+    return builder.to_string();
+}
+
 ALWAYS_INLINE ExecutionResult OpCode_Exit::execute(MatchInput const& input, MatchState& state, MatchOutput&) const
 {
     if (state.string_position > input.view.length() || state.instruction_position >= m_bytecode->size())
@@ -537,6 +631,30 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(MatchInput const& input, M
             auto property = static_cast<Unicode::Property>(m_bytecode->at(offset++));
             compare_property(input, state, property, current_inversion_state(), inverse_matched);
 
+        } else if (compare_type == CharacterCompareType::LookupTable) {
+            u64 table[2] { m_bytecode->at(offset), m_bytecode->at(offset + 1) };
+            auto arguments_to_skip = m_bytecode->at(offset + 2);
+            auto words_to_skip = m_bytecode->at(offset + 3);
+            offset += 4;
+
+            // Case insensitive compares, and views that take longer than a lookup to index into, go through
+            // the arguments instead.
+            if ((input.regex_options & AllFlags::Insensitive) || !(input.view.is_string_view() || input.view.is_u32_view()))
+                continue;
+
+            if (input.view.length() <= state.string_position)
+                return ExecutionResult::Failed_ExecuteLowPrioForks;
+
+            auto ch = input.view[state.string_position];
+            if (ch < 0x80 && (table[ch / 64] >> (ch % 64)) & 1) {
+                if (current_inversion_state())
+                    inverse_matched = true;
+                else
+                    ++state.string_position;
+            }
+            i += arguments_to_skip;
+            offset += words_to_skip;
+
         } else {
             warnln("Undefined comparison: {}", (int)compare_type);
             VERIFY_NOT_REACHED();
@@ -805,6 +923,9 @@ Vector<String> const OpCode_Compare::variable_arguments_to_string(Optional<Match
                 result.empend(String::formatted(
                     "compare against: '{}'",
                     input.value().view.substring_view(string_start_offset, state().string_position > view.length() ? 0 : 1).to_string()));
+        } else if (compare_type == CharacterCompareType::LookupTable) {
+            result.empend(String::formatted("table={:016x}{:016x}, stands in for {} arguments", m_bytecode->at(offset + 1), m_bytecode->at(offset), m_bytecode->at(offset + 2)));
+            offset += 4;
         } else if (compare_type == CharacterCompareType::CharRange) {
             auto value = (CharRange)m_bytecode->at(offset++);
             result.empend(String::formatted("ch_range='{:c}'-'{:c}'", value.from, value.to));
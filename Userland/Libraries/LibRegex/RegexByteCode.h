@@ -67,6 +67,7 @@ enum class OpCodeId : ByteCodeValueType {
     __ENUMERATE_CHARACTER_COMPARE_TYPE(Reference)        \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(NamedReference)   \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(Property)         \
+    __ENUMERATE_CHARACTER_COMPARE_TYPE(LookupTable)      \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(RangeExpressionDummy)
 
 enum class CharacterCompareType : ByteCodeValueType {
@@ -463,6 +464,19 @@ public:
 
     OpCode& get_opcode(MatchState& state) const;
 
+    // Whether every opcode only compares characters, checks the position or jumps, so that whether a path
+    // matches from some point on depends on nothing but the instruction and string positions there.
+    // That rules out capture groups, backreferences and lookarounds.
+    bool can_run_without_backtracking() const;
+
+    // The ASCII characters every match has to start with, taken from the compares the bytecode runs before
+    // anything else can happen. Empty if it may begin with anything but a plain character or string compare.
+    String literal_prefix() const;
+
+    // Points jumps and forks that land on a jump straight at where the chain ends up, and puts a LookupTable in
+    // front of compares that only check single ASCII characters, which answers for all of them at once.
+    void optimize();
+
 private:
     void insert_string(StringView const& view)
     {
@@ -54,6 +54,9 @@ public:
     {
     }
 
+    bool is_string_view() const { return m_view.has<StringView>(); }
+    bool is_u32_view() const { return m_view.has<Utf32View>(); }
+
     StringView const& string_view() const
     {
         return m_view.get<StringView>();
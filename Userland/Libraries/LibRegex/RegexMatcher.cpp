@@ -8,9 +8,11 @@
 #include "RegexDebug.h"
 #include "RegexParser.h"
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <LibThreading/Mutex.h>
 
 namespace regex {
 
@@ -49,6 +51,37 @@ Regex<Parser>::Regex(regex::Parser::Result parse_result, String pattern, typenam
         matcher = make<Matcher<Parser>>(this, regex_options);
 }
 
+template<class Parser>
+Regex<Parser> Regex<Parser>::cached(String pattern, typename ParserTraits<Parser>::OptionsType regex_options)
+{
+    struct CompiledPattern {
+        String pattern;
+        typename ParserTraits<Parser>::OptionsType options;
+        regex::Parser::Result parser_result;
+    };
+    static Threading::Mutex s_mutex;
+    static Vector<CompiledPattern> s_compiled_patterns;
+
+    Threading::MutexLocker locker(s_mutex);
+    for (size_t i = 0; i < s_compiled_patterns.size(); ++i) {
+        auto& compiled_pattern = s_compiled_patterns[i];
+        if (compiled_pattern.pattern != pattern || compiled_pattern.options.value() != regex_options.value())
+            continue;
+        // The bytecode points into the pattern for the names of named capture groups, so it has to be the same string.
+        Regex regex(compiled_pattern.parser_result, compiled_pattern.pattern, regex_options);
+        s_compiled_patterns.prepend(s_compiled_patterns.take(i));
+        return regex;
+    }
+
+    Regex regex(move(pattern), regex_options);
+    if (regex.parser_result.error == Error::NoError) {
+        s_compiled_patterns.prepend({ regex.pattern_value, regex_options, regex.parser_result });
+        if (s_compiled_patterns.size() > compiled_pattern_cache_size)
+            s_compiled_patterns.take_last();
+    }
+    return regex;
+}
+
 template<class Parser>
 Regex<Parser>::Regex(Regex&& regex)
     : pattern_value(move(regex.pattern_value))
@@ -209,7 +242,11 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, temp_output, 0);
+            Optional<bool> success;
+            if (m_can_search_without_backtracking)
+                success = search_without_backtracking(input, state, view_index, true, temp_output);
+            else
+                success = execute(input, state, temp_output, 0);
             // This success is acceptable only if it doesn't read anything from the input (input length is 0).
             if (state.string_position <= view_index) {
                 if (success.value()) {
@@ -223,7 +260,14 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const views, Optional
             }
         }
 
+        bool can_skip_to_literal_prefix = continue_search && this->can_skip_to_literal_prefix(input);
         for (; view_index < view_length; ++view_index) {
+            if (can_skip_to_literal_prefix) {
+                view_index = skip_to_literal_prefix(input, view_index);
+                if (view_index == view_length)
+                    break;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -240,7 +284,15 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, output, 0);
+            Optional<bool> success;
+            if (m_can_search_without_backtracking) {
+                success = search_without_backtracking(input, state, view_index, !continue_search, output);
+                // Nothing matches from any of the remaining start positions either.
+                if (!success.value())
+                    break;
+            } else {
+                success = execute(input, state, output, 0);
+            }
             if (!success.has_value())
                 return { false, 0, {}, {}, {}, output.operations };
 
@@ -402,6 +454,137 @@ Optional<bool> Matcher<Parser>::execute(MatchInput const& input, MatchState& sta
     VERIFY_NOT_REACHED();
 }
 
+template<class Parser>
+bool Matcher<Parser>::search_without_backtracking(MatchInput const& input, MatchState& state, size_t& start_position, bool anchored, MatchOutput& output) const
+{
+    // A thread is one path through the bytecode. Threads are kept in the order execute() would try them in,
+    // and one that consumed more than one character sits out the steps until the input catches up with it.
+    struct Thread {
+        size_t instruction_position { 0 };
+        size_t start_position { 0 };
+        size_t steps_to_wait { 0 };
+    };
+
+    auto& bytecode = m_pattern->parser_result.bytecode;
+    auto view_length = input.view.length();
+
+    Vector<Thread, 64> current_threads;
+    Vector<Thread, 64> next_threads;
+    Vector<size_t, 64> pending_positions;
+    // Once a path has reached an instruction at some string position, any later one reaching it there would
+    // fare exactly the same, so only the first one is followed.
+    Vector<size_t> visited_in_step;
+    visited_in_step.resize(bytecode.size());
+    size_t step = 0;
+
+    Optional<size_t> match_start;
+    size_t match_end = 0;
+    MatchState thread_state;
+
+    // Follows every path from instruction_position up to the next character it consumes, in the order execute()
+    // would. Returns true if one of them reaches the end of the bytecode, which also cuts off all that come after it.
+    auto add_thread = [&](size_t instruction_position, size_t thread_start, size_t string_position) {
+        pending_positions.clear_with_capacity();
+        pending_positions.append(instruction_position);
+        while (!pending_positions.is_empty()) {
+            auto position = pending_positions.take_last();
+            if (position >= bytecode.size()) {
+                match_start = thread_start;
+                match_end = string_position;
+                return true;
+            }
+            if (visited_in_step[position] == step)
+                continue;
+            visited_in_step[position] = step;
+
+            ++output.operations;
+            thread_state.instruction_position = position;
+            thread_state.string_position = string_position;
+            auto& opcode = bytecode.get_opcode(thread_state);
+            auto opcode_size = opcode.size();
+            auto result = opcode.execute(input, thread_state, output);
+            switch (opcode.opcode_id()) {
+            case OpCodeId::Jump:
+                pending_positions.append(thread_state.instruction_position + opcode_size);
+                break;
+            case OpCodeId::ForkJump:
+                pending_positions.append(position + opcode_size);
+                pending_positions.append(thread_state.fork_at_position);
+                break;
+            case OpCodeId::ForkStay:
+                pending_positions.append(thread_state.fork_at_position);
+                pending_positions.append(position + opcode_size);
+                break;
+            case OpCodeId::Compare:
+                if (result != ExecutionResult::Continue)
+                    break;
+                if (thread_state.string_position == string_position)
+                    pending_positions.append(position + opcode_size);
+                else
+                    next_threads.append({ position + opcode_size, thread_start, thread_state.string_position - string_position - 1 });
+                break;
+            default:
+                if (result == ExecutionResult::Continue)
+                    pending_positions.append(position + opcode_size);
+                break;
+            }
+        }
+        return false;
+    };
+
+    bool can_skip_to_literal_prefix = !anchored && this->can_skip_to_literal_prefix(input);
+    for (size_t string_position = start_position;; ++string_position) {
+        // With no path under way, nothing can happen before the next place a match could start.
+        if (can_skip_to_literal_prefix && next_threads.is_empty() && !match_start.has_value())
+            string_position = skip_to_literal_prefix(input, string_position);
+
+        ++step;
+        swap(current_threads, next_threads);
+        next_threads.clear_with_capacity();
+
+        bool matched = false;
+        for (auto& thread : current_threads) {
+            if (thread.steps_to_wait > 0) {
+                next_threads.append({ thread.instruction_position, thread.start_position, thread.steps_to_wait - 1 });
+                continue;
+            }
+            if (add_thread(thread.instruction_position, thread.start_position, string_position)) {
+                matched = true;
+                break;
+            }
+        }
+
+        // Starting later makes for a worse match than any that is already under way, so new ones come last.
+        if (!matched && !match_start.has_value() && (anchored ? string_position == start_position : string_position < view_length))
+            add_thread(0, string_position, string_position);
+
+        bool can_start_more = !match_start.has_value() && !anchored && string_position + 1 < view_length;
+        if (string_position >= view_length || (next_threads.is_empty() && !can_start_more))
+            break;
+    }
+
+    if (!match_start.has_value()) {
+        // Like a failed execute() does.
+        state.string_position = 0;
+        return false;
+    }
+    start_position = match_start.value();
+    state.string_position = match_end;
+    return true;
+}
+
+template<class Parser>
+size_t Matcher<Parser>::skip_to_literal_prefix(MatchInput const& input, size_t start_position) const
+{
+    auto view = input.view.string_view();
+    if (start_position >= view.length())
+        return view.length();
+    auto position = AK::memmem_optional(view.characters_without_null_termination() + start_position, view.length() - start_position, m_literal_prefix.characters(), m_literal_prefix.length());
+    if (!position.has_value())
+        return view.length();
+    return start_position + position.value();
+}
+
 template<class Parser>
 ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(MatchInput const& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const
 {
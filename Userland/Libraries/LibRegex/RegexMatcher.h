@@ -47,6 +47,8 @@ public:
     Matcher(Regex<Parser> const* pattern, Optional<typename ParserTraits<Parser>::OptionsType> regex_options = {})
         : m_pattern(pattern)
         , m_regex_options(regex_options.value_or({}))
+        , m_can_search_without_backtracking(pattern->parser_result.bytecode.can_run_without_backtracking())
+        , m_literal_prefix(pattern->parser_result.bytecode.literal_prefix())
     {
     }
     ~Matcher() = default;
@@ -68,8 +70,24 @@ private:
     Optional<bool> execute(MatchInput const& input, MatchState& state, MatchOutput& output, size_t recursion_level) const;
     ALWAYS_INLINE Optional<bool> execute_low_prio_forks(MatchInput const& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const;
 
+    // Finds the match execute() would have found first when trying every start position from start_position up to
+    // the end of the input, or only start_position itself if anchored. Instead of backtracking, all paths through the bytecode advance
+    // over the input together, which takes time linear in the input length however the repetitions nest. Only
+    // usable with bytecode that can_run_without_backtracking().
+    bool search_without_backtracking(MatchInput const& input, MatchState& state, size_t& start_position, bool anchored, MatchOutput& output) const;
+
+    // The first position from start_position on where the input continues with the literal prefix, so that no match
+    // can start anywhere before it. Returns the input length if there is none.
+    size_t skip_to_literal_prefix(MatchInput const& input, size_t start_position) const;
+    bool can_skip_to_literal_prefix(MatchInput const& input) const
+    {
+        return !m_literal_prefix.is_empty() && input.view.is_string_view() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
+    }
+
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+    bool m_can_search_without_backtracking { false };
+    String m_literal_prefix;
 };
 
 template<class Parser>
@@ -84,6 +102,11 @@ public:
 
     explicit Regex(String pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
     Regex(regex::Parser::Result parse_result, String pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
+
+    // Like constructing a Regex from the pattern, but the bytecode of the patterns used most recently is
+    // kept for the whole process, so compiling one of them again only copies it.
+    static constexpr size_t compiled_pattern_cache_size = 32;
+    static Regex cached(String pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
     ~Regex() = default;
     Regex(Regex&&);
     Regex& operator=(Regex&&);
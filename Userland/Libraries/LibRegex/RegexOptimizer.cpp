@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RegexByteCode.h"
+#include <AK/CharacterTypes.h>
+
+namespace regex {
+
+static bool is_jump(OpCodeId id)
+{
+    return id == OpCodeId::Jump || id == OpCodeId::ForkJump || id == OpCodeId::ForkStay;
+}
+
+// Fills in which ASCII characters one compare argument accepts. Returns false if it might accept anything
+// else, or behaves differently when inverted, so that a table can't stand in for it.
+static bool add_to_lookup_table(CharacterCompareType type, ByteCodeValueType value, u64 (&table)[2])
+{
+    auto add = [&](u32 from, u32 to) {
+        for (auto ch = from; ch <= to; ++ch)
+            table[ch / 64] |= (u64)1 << (ch % 64);
+    };
+
+    switch (type) {
+    case CharacterCompareType::Char:
+        if (!is_ascii(value))
+            return false;
+        add(value, value);
+        return true;
+    case CharacterCompareType::CharRange: {
+        CharRange range(value);
+        if (range.from > range.to)
+            return true;
+        if (range.to > 0x7f)
+            return false;
+        add(range.from, range.to);
+        return true;
+    }
+    case CharacterCompareType::CharClass: {
+        auto character_class = (CharClass)value;
+        for (u32 ch = 0; ch < 0x80; ++ch) {
+            bool matches = false;
+            switch (character_class) {
+            case CharClass::Alnum:
+                matches = is_ascii_alphanumeric(ch);
+                break;
+            case CharClass::Blank:
+                matches = is_ascii_blank(ch);
+                break;
+            case CharClass::Cntrl:
+                matches = is_ascii_control(ch);
+                break;
+            case CharClass::Digit:
+                matches = is_ascii_digit(ch);
+                break;
+            case CharClass::Graph:
+                matches = is_ascii_graphical(ch);
+                break;
+            case CharClass::Lower:
+                matches = is_ascii_lower_alpha(ch);
+                break;
+            case CharClass::Print:
+                matches = is_ascii_printable(ch);
+                break;
+            case CharClass::Punct:
+                matches = is_ascii_punctuation(ch);
+                break;
+            case CharClass::Space:
+                matches = is_ascii_space(ch);
+                break;
+            case CharClass::Upper:
+                matches = is_ascii_upper_alpha(ch);
+                break;
+            case CharClass::Word:
+                matches = is_ascii_alphanumeric(ch) || ch == '_';
+                break;
+            case CharClass::Xdigit:
+                matches = is_ascii_hex_digit(ch);
+                break;
+            default:
+                // Alpha ignores inversion.
+                return false;
+            }
+            if (matches)
+                add(ch, ch);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// The arguments of a compare at position, with a LookupTable put in front of the ones it can answer for,
+// or nothing if there are none.
+static Optional<Vector<ByteCodeValueType>> arguments_with_lookup_table(ByteCode const& bytecode, size_t position)
+{
+    auto arguments_count = bytecode.at(position + 1);
+    auto arguments_size = bytecode.at(position + 2);
+    size_t offset = position + 3;
+
+    Vector<ByteCodeValueType> arguments;
+    if (arguments_count > 0 && (CharacterCompareType)bytecode.at(offset) == CharacterCompareType::Inverse) {
+        arguments.append(bytecode.at(offset++));
+        --arguments_count;
+    }
+    if (arguments_count == 0)
+        return {};
+
+    u64 table[2] {};
+    auto first_argument = offset;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        auto type = (CharacterCompareType)bytecode.at(offset);
+        if (type != CharacterCompareType::Char && type != CharacterCompareType::CharRange && type != CharacterCompareType::CharClass)
+            return {};
+        if (!add_to_lookup_table(type, bytecode.at(offset + 1), table))
+            return {};
+        offset += 2;
+    }
+
+    arguments.append((ByteCodeValueType)CharacterCompareType::LookupTable);
+    arguments.append(table[0]);
+    arguments.append(table[1]);
+    arguments.append(arguments_count);
+    arguments.append(offset - first_argument);
+    // The arguments stay, for when the table can't be used.
+    for (size_t i = first_argument; i < position + 3 + arguments_size; ++i)
+        arguments.append(bytecode.at(i));
+    return arguments;
+}
+
+void ByteCode::optimize()
+{
+    struct Jump {
+        size_t new_position;
+        size_t old_target;
+    };
+
+    ByteCode optimized;
+    Vector<size_t> new_positions;
+    new_positions.resize(size() + 1);
+    Vector<Jump> jumps;
+
+    MatchState state;
+    while (state.instruction_position < size()) {
+        auto position = state.instruction_position;
+        auto& opcode = get_opcode(state);
+        auto opcode_id = opcode.opcode_id();
+        auto opcode_size = opcode.size();
+        new_positions[position] = optimized.size();
+
+        if (is_jump(opcode_id)) {
+            // Following a chain of jumps changes nothing but where the next instruction is.
+            auto target = position + opcode_size + (ssize_t)at(position + 1);
+            for (size_t hops = 0; hops < 16 && target < size() && (OpCodeId)at(target) == OpCodeId::Jump && target != position; ++hops)
+                target = target + 2 + (ssize_t)at(target + 1);
+            jumps.append({ optimized.size(), target });
+        }
+
+        Optional<Vector<ByteCodeValueType>> arguments;
+        if (opcode_id == OpCodeId::Compare)
+            arguments = arguments_with_lookup_table(*this, position);
+
+        if (arguments.has_value()) {
+            optimized.append(at(position));
+            optimized.append(at(position + 1) + 1);
+            optimized.append(arguments->size());
+            optimized.extend(arguments.release_value());
+        } else {
+            for (size_t i = position; i < position + opcode_size; ++i)
+                optimized.append(at(i));
+        }
+        state.instruction_position += opcode_size;
+    }
+    new_positions[size()] = optimized.size();
+
+    for (auto& jump : jumps) {
+        VERIFY(jump.old_target <= size());
+        optimized[jump.new_position + 1] = (ByteCodeValueType)((ssize_t)new_positions[jump.old_target] - (ssize_t)(jump.new_position + 2));
+    }
+
+    *this = move(optimized);
+}
+
+}
@@ -343,6 +343,21 @@ private:
 class NullLiteral : public Expression {
 };
 
+// A '?' standing in for a value that is bound when the statement is executed.
+// Placeholders are numbered from 0, in the order they appear in the statement.
+class Placeholder : public Expression {
+public:
+    explicit Placeholder(size_t parameter_index)
+        : m_parameter_index(parameter_index)
+    {
+    }
+
+    size_t parameter_index() const { return m_parameter_index; }
+
+private:
+    size_t m_parameter_index;
+};
+
 class NestedExpression : public Expression {
 public:
     const NonnullRefPtr<Expression>& expression() const { return m_expression; }
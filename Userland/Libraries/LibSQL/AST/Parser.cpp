@@ -22,6 +22,8 @@ NonnullRefPtr<Statement> Parser::next_statement()
         return statement;
     };
 
+    m_parser_state.m_placeholders = 0;
+
     if (match(TokenType::With)) {
         auto common_table_expression_list = parse_common_table_expression_list();
         if (!common_table_expression_list)
@@ -382,7 +384,6 @@ NonnullRefPtr<Expression> Parser::parse_expression()
     if (match_secondary_expression())
         expression = parse_secondary_expression(move(expression));
 
-    // FIXME: Parse 'bind-parameter'.
     // FIXME: Parse 'function-name'.
     // FIXME: Parse 'raise-function'.
 
@@ -395,6 +396,9 @@ NonnullRefPtr<Expression> Parser::parse_primary_expression()
     if (auto expression = parse_literal_value_expression(); expression.has_value())
         return move(expression.value());
 
+    if (auto expression = parse_placeholder_expression(); expression.has_value())
+        return move(expression.value());
+
     if (auto expression = parse_column_name_expression(); expression.has_value())
         return move(expression.value());
 
@@ -509,6 +513,14 @@ Optional<NonnullRefPtr<Expression>> Parser::parse_literal_value_expression()
     return {};
 }
 
+Optional<NonnullRefPtr<Expression>> Parser::parse_placeholder_expression()
+{
+    // FIXME: Parse the numbered and named forms of bind parameters ('?NNN', ':AAAA', '@AAAA', and '$AAAA').
+    if (!consume_if(TokenType::Placeholder))
+        return {};
+    return create_ast_node<Placeholder>(m_parser_state.m_placeholders++);
+}
+
 Optional<NonnullRefPtr<Expression>> Parser::parse_column_name_expression(String with_parsed_identifier, bool with_parsed_period)
 {
     if (with_parsed_identifier.is_null() && !match(TokenType::Identifier))
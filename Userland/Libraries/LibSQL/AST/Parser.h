@@ -37,6 +37,7 @@ public:
     NonnullRefPtr<Statement> next_statement();
 
     bool has_errors() const { return m_parser_state.m_errors.size(); }
+    size_t placeholders_in_last_statement() const { return m_parser_state.m_placeholders; }
     const Vector<Error>& errors() const { return m_parser_state.m_errors; }
 
 protected:
@@ -51,6 +52,7 @@ private:
         Vector<Error> m_errors;
         size_t m_current_expression_depth { 0 };
         size_t m_current_subquery_depth { 0 };
+        size_t m_placeholders { 0 };
     };
 
     NonnullRefPtr<Statement> parse_statement();
@@ -69,6 +71,7 @@ private:
     NonnullRefPtr<Expression> parse_secondary_expression(NonnullRefPtr<Expression> primary);
     bool match_secondary_expression() const;
     Optional<NonnullRefPtr<Expression>> parse_literal_value_expression();
+    Optional<NonnullRefPtr<Expression>> parse_placeholder_expression();
     Optional<NonnullRefPtr<Expression>> parse_column_name_expression(String with_parsed_identifier = {}, bool with_parsed_period = false);
     Optional<NonnullRefPtr<Expression>> parse_unary_operator_expression();
     Optional<NonnullRefPtr<Expression>> parse_binary_operator_expression(NonnullRefPtr<Expression> lhs);
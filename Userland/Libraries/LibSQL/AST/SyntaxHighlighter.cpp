@@ -41,39 +41,34 @@ bool SyntaxHighlighter::is_identifier(u64 token) const
 
 void SyntaxHighlighter::rehighlight(Palette const& palette)
 {
-    auto text = m_client->get_text();
-
-    Lexer lexer(text);
-
-    Vector<GUI::TextDocumentSpan> spans;
-
-    auto append_token = [&](Token const& token) {
-        if (token.value().is_empty())
-            return;
-        GUI::TextDocumentSpan span;
-        span.range.set_start({ token.start_position().line - 1, token.start_position().column - 1 });
-        span.range.set_end({ token.end_position().line - 1, token.end_position().column - 1 });
-        auto style = style_for_token_type(palette, token.type());
-        span.attributes.color = style.color;
-        span.attributes.bold = style.bold;
-        span.data = static_cast<u64>(token.type());
-        spans.append(span);
-
-        dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ '{}' {}:{} - {}:{}",
-            token.name(),
-            token.value(),
-            span.range.start().line(), span.range.start().column(),
-            span.range.end().line(), span.range.end().column());
-    };
-
-    for (;;) {
-        auto token = lexer.next();
-        append_token(token);
-        if (token.type() == TokenType::Eof)
-            break;
-    }
-
-    m_client->do_set_spans(move(spans));
+    lex_changed_text([&](auto text, auto& on_span) {
+        Lexer lexer(text);
+
+        auto append_token = [&](Token const& token) {
+            if (token.value().is_empty())
+                return IterationDecision::Continue;
+            GUI::TextDocumentSpan span;
+            span.range.set_start({ token.start_position().line - 1, token.start_position().column - 1 });
+            span.range.set_end({ token.end_position().line - 1, token.end_position().column - 1 });
+            auto style = style_for_token_type(palette, token.type());
+            span.attributes.color = style.color;
+            span.attributes.bold = style.bold;
+            span.data = static_cast<u64>(token.type());
+
+            dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ '{}' {}:{} - {}:{}",
+                token.name(),
+                token.value(),
+                span.range.start().line(), span.range.start().column(),
+                span.range.end().line(), span.range.end().column());
+            return on_span(move(span));
+        };
+
+        for (;;) {
+            auto token = lexer.next();
+            if (append_token(token) == IterationDecision::Break || token.type() == TokenType::Eof)
+                break;
+        }
+    });
 
     m_has_brace_buddies = false;
     highlight_matching_token_pair();
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Format.h>
+#include <AK/QuickSort.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Meta.h>
 
@@ -103,6 +104,104 @@ BTreeIterator BTree::find(Key const& key)
     return end();
 }
 
+BTreeIterator BTree::lower_bound(Key const& key)
+{
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+
+    // Walk down to the leaf the key would be in, remembering the last entry
+    // on the way that is not less than the key. The first such entry in the
+    // leaf, if there is one, comes before it.
+    TreeNode* candidate = nullptr;
+    size_t candidate_index = 0;
+    for (auto node = m_root.ptr(); node;) {
+        size_t ix = 0;
+        while (ix < node->size() && (*node)[ix].compare(key) < 0)
+            ix++;
+        if (ix < node->size()) {
+            candidate = node;
+            candidate_index = ix;
+        }
+        if (node->is_leaf())
+            break;
+        node = node->down_node(ix);
+    }
+    if (!candidate)
+        return end();
+    return BTreeIterator(candidate, (int)candidate_index);
+}
+
+size_t BTree::bulk_load(Vector<Key> keys, float fill_factor)
+{
+    VERIFY(fill_factor > 0.0f && fill_factor <= 1.0f);
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+
+    auto max_keys_in_node = m_root->max_keys_in_node();
+    auto keys_per_node = min(max((size_t)((float)max_keys_in_node * fill_factor), (size_t)2), max_keys_in_node);
+    if (!m_root->is_leaf() || m_root->size() > 0 || keys_per_node < 2) {
+        size_t inserted = 0;
+        for (auto& key : keys) {
+            if (insert(key))
+                inserted++;
+        }
+        return inserted;
+    }
+
+    quick_sort(keys, [](auto& a, auto& b) { return a < b; });
+    if (!duplicates_allowed()) {
+        Vector<Key> unique_keys;
+        for (auto& key : keys) {
+            if (unique_keys.is_empty() || !(unique_keys.last() == key))
+                unique_keys.append(key);
+        }
+        keys = move(unique_keys);
+    }
+    if (keys.is_empty())
+        return 0;
+    auto loaded = keys.size();
+
+    // Every level is built from a run of keys, with a child in between every two keys and on either end
+    // (except in the leaves). The keys are spread evenly over as few nodes as will have them at most
+    // keys_per_node each, where one key in between every two nodes moves up into the next level, together
+    // with the nodes as its children. That ends with the one node that becomes the root, at the block the
+    // empty root used to be.
+    Vector<u32> children;
+    while (true) {
+        auto nodes = (keys.size() + keys_per_node + 1) / (keys_per_node + 1);
+        auto keys_in_nodes = keys.size() - (nodes - 1);
+        Vector<Key> separators;
+        Vector<u32> parents;
+        size_t key_index = 0;
+        size_t child_index = 0;
+        for (size_t node_index = 0; node_index < nodes; node_index++) {
+            auto node_size = keys_in_nodes / nodes + ((node_index < keys_in_nodes % nodes) ? 1 : 0);
+            auto node = make<TreeNode>(*this, nullptr, (nodes == 1) ? pointer() : new_record_pointer());
+            node->m_is_leaf = children.is_empty();
+            node->m_down.clear();
+            for (size_t ix = 0; ix < node_size; ix++) {
+                node->m_down.empend(node.ptr(), node->m_is_leaf ? 0u : children[child_index++]);
+                node->m_entries.append(keys[key_index++]);
+            }
+            node->m_down.empend(node.ptr(), node->m_is_leaf ? 0u : children[child_index++]);
+            add_to_write_ahead_log(node->as_index_node());
+            parents.append(node->pointer());
+            if (node_index + 1 < nodes)
+                separators.append(keys[key_index++]);
+            if (nodes == 1)
+                m_root = move(node);
+        }
+        VERIFY(key_index == keys.size());
+        if (nodes == 1)
+            break;
+        keys = move(separators);
+        children = move(parents);
+    }
+    return loaded;
+}
+
 void BTree::list_tree()
 {
     if (!m_root)
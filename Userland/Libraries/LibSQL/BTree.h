@@ -104,10 +104,24 @@ public:
     bool update_key_pointer(Key const&);
     Optional<u32> get(Key&);
     BTreeIterator find(Key const& key);
+
+    // The first key in sort order that is not less than the given key, or
+    // end() if all keys are less than it.
+    BTreeIterator lower_bound(Key const& key);
     BTreeIterator begin();
     static BTreeIterator end();
     void list_tree();
 
+    /**
+     * Adds all keys at once, and returns how many were added (duplicates of
+     * a key are dropped unless the tree allows them). If the tree is empty,
+     * the keys are sorted, and the tree is built from the leaves up instead
+     * of by inserting them one by one, with nodes filled to fill_factor of
+     * their capacity. Otherwise the keys are just inserted.
+     */
+    static constexpr float default_fill_factor = 0.9f;
+    size_t bulk_load(Vector<Key>, float fill_factor = default_fill_factor);
+
     Function<void(void)> on_new_root;
 
 private:
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/Cursor.h>
+
+namespace SQL {
+
+template<typename BlockSource>
+static Row read_row(BlockSource& source, RefPtr<TableDef> table, u32 pointer)
+{
+    auto buffer_or_error = source.read_block(pointer);
+    if (buffer_or_error.is_error())
+        VERIFY_NOT_REACHED();
+    return Row(table, pointer, buffer_or_error.value());
+}
+
+TableScan::TableScan(Heap& heap, TableDef const& table)
+    : m_heap(heap)
+    , m_table(table)
+    , m_next_pointer(table.pointer())
+{
+}
+
+TableScan::TableScan(Snapshot& snapshot, TableDef const& table)
+    : m_heap(snapshot.heap())
+    , m_snapshot(snapshot)
+    , m_table(table)
+    , m_next_pointer(snapshot.table_pointer(table))
+{
+}
+
+Optional<Row> TableScan::next()
+{
+    if (!m_next_pointer)
+        return {};
+    auto row = m_snapshot ? read_row(*m_snapshot, m_table, m_next_pointer) : read_row(*m_heap, m_table, m_next_pointer);
+    m_next_pointer = row.next_pointer();
+    return row;
+}
+
+IndexScan::IndexScan(Heap& heap, TableDef const& table, BTree& index, BTreeIterator start, Function<bool(Key const&)> in_range)
+    : m_heap(heap)
+    , m_table(table)
+    , m_index(index)
+    , m_position(start)
+    , m_in_range(move(in_range))
+{
+}
+
+Optional<Row> IndexScan::next()
+{
+    if (m_position.is_end() || !m_in_range(*m_position))
+        return {};
+    auto pointer = (*m_position).pointer();
+    m_position++;
+    return read_row(*m_heap, m_table, pointer);
+}
+
+HashLookup::HashLookup(Heap& heap, TableDef const& table, HashIndex& index, Key key)
+    : m_heap(heap)
+    , m_table(table)
+    , m_index(index)
+    , m_key(move(key))
+{
+}
+
+Optional<Row> HashLookup::next()
+{
+    if (m_done)
+        return {};
+    m_done = true;
+    auto pointer = m_index->get(m_key);
+    if (!pointer.has_value())
+        return {};
+    return read_row(*m_heap, m_table, pointer.value());
+}
+
+Filter::Filter(NonnullOwnPtr<Cursor> input, Function<bool(Row const&)> predicate)
+    : m_input(move(input))
+    , m_predicate(move(predicate))
+{
+}
+
+Optional<Row> Filter::next()
+{
+    for (auto row = m_input->next(); row.has_value(); row = m_input->next()) {
+        if (m_predicate(row.value()))
+            return row;
+    }
+    return {};
+}
+
+Project::Project(NonnullOwnPtr<Cursor> input, Vector<String> column_names)
+    : m_input(move(input))
+    , m_column_names(move(column_names))
+{
+}
+
+Optional<Row> Project::next()
+{
+    auto row = m_input->next();
+    if (!row.has_value())
+        return {};
+
+    auto descriptor = row->descriptor();
+    TupleDescriptor projected_descriptor;
+    for (auto& column_name : m_column_names) {
+        auto element = descriptor.find_if([&](auto& element) { return element.name == column_name; });
+        VERIFY(!element.is_end());
+        projected_descriptor.append(*element);
+    }
+    Row projected(projected_descriptor);
+    projected.set_pointer(row->pointer());
+    for (auto& column_name : m_column_names)
+        projected[column_name] = row.value()[column_name];
+    return projected;
+}
+
+Limit::Limit(NonnullOwnPtr<Cursor> input, size_t limit, size_t offset)
+    : m_input(move(input))
+    , m_limit(limit)
+    , m_offset(offset)
+{
+}
+
+Optional<Row> Limit::next()
+{
+    for (; m_offset > 0; --m_offset) {
+        if (!m_input->next().has_value())
+            return {};
+    }
+    if (m_limit == 0)
+        return {};
+    --m_limit;
+    return m_input->next();
+}
+
+}
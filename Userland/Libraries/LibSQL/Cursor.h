@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/HashIndex.h>
+#include <LibSQL/Heap.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+#include <LibSQL/Snapshot.h>
+
+namespace SQL {
+
+/**
+ * A Cursor produces the rows of a query one at a time, when they are asked
+ * for with next(). Cursors are chained into a pipeline, where each one pulls
+ * rows from the one below it, so no more rows are read from the Heap than
+ * the consumer of the pipeline asks for, and none of them are collected in
+ * between.
+ */
+class Cursor {
+public:
+    virtual ~Cursor() = default;
+
+    // The next row, or nothing once all rows have been produced.
+    virtual Optional<Row> next() = 0;
+};
+
+/**
+ * Reads the rows of a table, following the chain its rows are stored in,
+ * either as they are now or as they were when a Snapshot was taken.
+ */
+class TableScan final : public Cursor {
+public:
+    TableScan(Heap&, TableDef const&);
+    TableScan(Snapshot&, TableDef const&);
+    Optional<Row> next() override;
+
+private:
+    NonnullRefPtr<Heap> m_heap;
+    RefPtr<Snapshot> m_snapshot;
+    NonnullRefPtr<TableDef> m_table;
+    u32 m_next_pointer { 0 };
+};
+
+/**
+ * Reads the rows of a table the keys of a BTree index point to, in the
+ * order of the keys, starting at the given position in the index and
+ * stopping at the first key for which in_range does not hold.
+ */
+class IndexScan final : public Cursor {
+public:
+    IndexScan(Heap&, TableDef const&, BTree&, BTreeIterator start, Function<bool(Key const&)> in_range);
+    Optional<Row> next() override;
+
+private:
+    NonnullRefPtr<Heap> m_heap;
+    NonnullRefPtr<TableDef> m_table;
+    NonnullRefPtr<BTree> m_index;
+    BTreeIterator m_position;
+    Function<bool(Key const&)> m_in_range;
+};
+
+/**
+ * Reads the row of a table the key of a HashIndex equal to the given key
+ * points to, if there is one.
+ */
+class HashLookup final : public Cursor {
+public:
+    HashLookup(Heap&, TableDef const&, HashIndex&, Key);
+    Optional<Row> next() override;
+
+private:
+    NonnullRefPtr<Heap> m_heap;
+    NonnullRefPtr<TableDef> m_table;
+    NonnullRefPtr<HashIndex> m_index;
+    Key m_key;
+    bool m_done { false };
+};
+
+/**
+ * Passes on the rows for which the predicate holds.
+ */
+class Filter final : public Cursor {
+public:
+    Filter(NonnullOwnPtr<Cursor>, Function<bool(Row const&)> predicate);
+    Optional<Row> next() override;
+
+private:
+    NonnullOwnPtr<Cursor> m_input;
+    Function<bool(Row const&)> m_predicate;
+};
+
+/**
+ * Passes on the named columns of each row, in the given order.
+ */
+class Project final : public Cursor {
+public:
+    Project(NonnullOwnPtr<Cursor>, Vector<String> column_names);
+    Optional<Row> next() override;
+
+private:
+    NonnullOwnPtr<Cursor> m_input;
+    Vector<String> m_column_names;
+};
+
+/**
+ * Skips the first offset rows, and passes on at most limit of the rest.
+ */
+class Limit final : public Cursor {
+public:
+    Limit(NonnullOwnPtr<Cursor>, size_t limit, size_t offset = 0);
+    Optional<Row> next() override;
+
+private:
+    NonnullOwnPtr<Cursor> m_input;
+    size_t m_limit;
+    size_t m_offset;
+};
+
+}
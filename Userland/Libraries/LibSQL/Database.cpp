@@ -9,16 +9,18 @@
 #include <AK/String.h>
 
 #include <LibSQL/BTree.h>
+#include <LibSQL/Cursor.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
+#include <LibSQL/Snapshot.h>
 #include <LibSQL/Tuple.h>
 
 namespace SQL {
 
-Database::Database(String name)
-    : m_heap(Heap::construct(name))
+Database::Database(String name, u32 block_size, Heap::ReadMode read_mode)
+    : m_heap(Heap::construct(name, block_size, read_mode))
     , m_schemas(BTree::construct(*m_heap, SchemaDef::index_def()->to_tuple_descriptor(), m_heap->schemas_root()))
     , m_tables(BTree::construct(*m_heap, TableDef::index_def()->to_tuple_descriptor(), m_heap->tables_root()))
     , m_table_columns(BTree::construct(*m_heap, ColumnDef::index_def()->to_tuple_descriptor(), m_heap->table_columns_root()))
@@ -107,35 +109,30 @@ RefPtr<TableDef> Database::get_table(String const& schema, String const& name)
     return ret;
 }
 
-Vector<Row> Database::select_all(TableDef const& table)
+NonnullOwnPtr<Cursor> Database::scan(TableDef const& table)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    return make<TableScan>(*m_heap, table);
+}
+
+Vector<Row> Database::select_all(TableDef const& table)
+{
     Vector<Row> ret;
-    for (auto pointer = table.pointer(); pointer; pointer = ret.last().next_pointer()) {
-        auto buffer_or_error = m_heap->read_block(pointer);
-        if (buffer_or_error.is_error())
-            VERIFY_NOT_REACHED();
-        ret.empend(table, pointer, buffer_or_error.value());
-    }
+    auto cursor = scan(table);
+    for (auto row = cursor->next(); row.has_value(); row = cursor->next())
+        ret.append(row.release_value());
     return ret;
 }
 
 Vector<Row> Database::match(TableDef const& table, Key const& key)
 {
-    VERIFY(m_table_cache.get(table.key().hash()).has_value());
     Vector<Row> ret;
 
     // TODO Match key against indexes defined on table. If found,
     // use the index instead of scanning the table.
-    for (auto pointer = table.pointer(); pointer;) {
-        auto buffer_or_error = m_heap->read_block(pointer);
-        if (buffer_or_error.is_error())
-            VERIFY_NOT_REACHED();
-        Row row(table, pointer, buffer_or_error.value());
-        if (row.match(key))
-            ret.append(row);
-        pointer = ret.last().next_pointer();
-    }
+    Filter cursor(scan(table), [&](auto& row) { return row.match(key) == 0; });
+    for (auto row = cursor.next(); row.has_value(); row = cursor.next())
+        ret.append(row.release_value());
     return ret;
 }
 
@@ -151,6 +148,8 @@ bool Database::insert(Row& row)
     auto table_key = row.table()->key();
     table_key.set_pointer(row.pointer());
     VERIFY(m_tables->update_key_pointer(table_key));
+    Threading::MutexLocker locker(m_heap->mutex());
+    m_heap->for_each_snapshot([&](auto& snapshot) { snapshot.preserve_table_pointer(*row.table()); });
     row.table()->set_pointer(row.pointer());
     return true;
 }
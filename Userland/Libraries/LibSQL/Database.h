@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/NonnullOwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <LibCore/Object.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Heap.h>
+#include <LibSQL/Snapshot.h>
 
 namespace SQL {
 
@@ -23,10 +25,13 @@ class Database : public Core::Object {
     C_OBJECT(Database);
 
 public:
-    explicit Database(String);
+    explicit Database(String, u32 block_size = Heap::default_block_size, Heap::ReadMode = Heap::ReadMode::Syscalls);
     ~Database() override = default;
 
     void commit() { m_heap->flush(); }
+    void checkpoint() { m_heap->checkpoint(); }
+    Heap const& heap() const { return *m_heap; }
+    Heap& heap() { return *m_heap; }
 
     void add_schema(SchemaDef const&);
     static Key get_schema_key(String const&);
@@ -36,6 +41,11 @@ public:
     static Key get_table_key(String const&, String const&);
     RefPtr<TableDef> get_table(String const&, String const&);
 
+    // A read-only view of everything committed so far, which can be read
+    // from other threads while this one goes on to change the database.
+    NonnullRefPtr<Snapshot> snapshot() { return m_heap->take_snapshot(); }
+
+    NonnullOwnPtr<Cursor> scan(TableDef const&);
     Vector<Row> select_all(TableDef const&);
     Vector<Row> match(TableDef const&, Key const&);
     bool insert(Row&);
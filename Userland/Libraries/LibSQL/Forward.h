@@ -10,6 +10,8 @@ namespace SQL {
 class BTree;
 class BTreeIterator;
 class ColumnDef;
+struct Condition;
+class Cursor;
 class Database;
 class HashBucket;
 class HashDirectoryNode;
@@ -21,8 +23,11 @@ class IndexNode;
 class IndexDef;
 class Key;
 class KeyPartDef;
+class Planner;
+class QueryPlan;
 class Row;
 class SQLResult;
+class Snapshot;
 class TableDef;
 class TreeNode;
 class Tuple;
@@ -72,6 +77,7 @@ class NullLiteral;
 class NumericLiteral;
 class OrderingTerm;
 class Parser;
+class Placeholder;
 class QualifiedTableName;
 class RenameColumn;
 class RenameTable;
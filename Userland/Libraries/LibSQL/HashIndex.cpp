@@ -44,7 +44,7 @@ HashDirectoryNode::HashDirectoryNode(HashIndex& index, u32 pointer, ByteBuffer&
         u32 local_depth;
         deserialize_from(buffer, offset, local_depth);
         dbgln_if(SQL_DEBUG, "Bucket pointer {} local depth {}", bucket_pointer, local_depth);
-        index.append_bucket(ix, local_depth, bucket_pointer);
+        index.append_bucket(index.m_buckets.size(), local_depth, bucket_pointer);
     }
 }
 
@@ -118,7 +118,7 @@ void HashBucket::inflate()
 size_t HashBucket::max_entries_in_bucket() const
 {
     auto key_size = m_hash_index.descriptor().data_length() + sizeof(u32);
-    return (BLOCKSIZE - 2 * sizeof(u32)) / key_size;
+    return (m_hash_index.heap().block_size() - 2 * sizeof(u32)) / key_size;
 }
 
 Optional<u32> HashBucket::get(Key& key)
@@ -248,33 +248,30 @@ HashBucket* HashIndex::get_bucket_for_insert(Key const& key)
         }
 
         // We previously doubled the directory but the target bucket is
-        // still at an older depth. Create new buckets at the current global
-        // depth and allocate the contents of the existing buckets to the
-        // newly created ones:
+        // still at an older depth. Split it in two, moving the keys whose
+        // hash has the next bit set to the bucket that so far only pointed
+        // back at this one:
         while (bucket->local_depth() < global_depth()) {
-            auto base_index = bucket->index();
-            auto step = 1 << (global_depth() - bucket->local_depth());
-            for (auto ix = base_index + step; ix < size(); ix += step) {
-                auto& sub_bucket = m_buckets[ix];
-                sub_bucket->set_local_depth(bucket->local_depth() + 1);
-                for (auto entry_index = (int)bucket->m_entries.size() - 1; entry_index >= 0; entry_index--) {
-                    if (bucket->m_entries[entry_index].hash() % size() == ix) {
-                        if (!sub_bucket->pointer()) {
-                            sub_bucket->set_pointer(new_record_pointer());
-                        }
-                        sub_bucket->insert(bucket->m_entries.take(entry_index));
-                    }
-                }
-                if (m_buckets[ix]->pointer())
-                    add_to_write_ahead_log(m_buckets[ix]);
+            auto local_depth = bucket->local_depth();
+            auto sibling_index = bucket->index() + (1u << local_depth);
+            auto& sibling = m_buckets[sibling_index];
+            VERIFY(!sibling->pointer());
+            sibling->set_pointer(new_record_pointer());
+            sibling->m_inflated = true;
+            sibling->set_local_depth(local_depth + 1);
+            bucket->set_local_depth(local_depth + 1);
+            auto mask = (1u << (local_depth + 1)) - 1;
+            for (auto entry_index = (int)bucket->m_entries.size() - 1; entry_index >= 0; entry_index--) {
+                if ((bucket->m_entries[entry_index].hash() & mask) == sibling_index)
+                    sibling->m_entries.prepend(bucket->m_entries.take(entry_index));
             }
-            bucket->set_local_depth(bucket->local_depth() + 1);
+            add_to_write_ahead_log(sibling);
             add_to_write_ahead_log(bucket);
             write_directory_to_write_ahead_log();
 
-            auto bucket_after_redistribution = get_bucket(key_hash % size());
-            if (bucket_after_redistribution->size() < bucket_after_redistribution->max_entries_in_bucket()) {
-                return bucket_after_redistribution;
+            bucket = get_bucket(key_hash % size());
+            if (bucket->size() < bucket->max_entries_in_bucket()) {
+                return bucket;
             }
         }
         expand();
@@ -295,7 +292,7 @@ void HashIndex::expand()
 
 void HashIndex::write_directory_to_write_ahead_log()
 {
-    auto num_nodes_required = (size() / HashDirectoryNode::max_pointers_in_node()) + 1;
+    auto num_nodes_required = (size() / HashDirectoryNode::max_pointers_in_node(heap())) + 1;
     while (m_nodes.size() < num_nodes_required)
         m_nodes.append(new_record_pointer());
 
@@ -305,6 +302,7 @@ void HashIndex::write_directory_to_write_ahead_log()
         HashDirectoryNode node(*this, num_node, offset);
         add_to_write_ahead_log(node.as_index_node());
         offset += node.number_of_pointers();
+        num_node++;
     }
 }
 
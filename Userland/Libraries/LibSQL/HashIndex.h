@@ -111,9 +111,9 @@ public:
     HashDirectoryNode(HashDirectoryNode const& other) = default;
     void serialize(ByteBuffer&) const override;
     IndexNode* as_index_node() override { return dynamic_cast<IndexNode*>(this); }
-    [[nodiscard]] u32 number_of_pointers() const { return min(max_pointers_in_node(), m_hash_index.size() - m_offset); }
+    [[nodiscard]] u32 number_of_pointers() const { return min(max_pointers_in_node(m_hash_index.heap()), m_hash_index.size() - m_offset); }
     [[nodiscard]] bool is_last() const { return m_is_last; }
-    static constexpr size_t max_pointers_in_node() { return (BLOCKSIZE - 3 * sizeof(u32)) / (2 * sizeof(u32)); }
+    static size_t max_pointers_in_node(Heap const& heap) { return (heap.block_size() - 3 * sizeof(u32)) / (2 * sizeof(u32)); }
 
 private:
     HashIndex& m_hash_index;
@@ -5,75 +5,286 @@
  */
 
 #include <AK/Format.h>
+#include <AK/NumericLimits.h>
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <LibCore/IODevice.h>
+#include <LibCrypto/Checksum/CRC32.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Serialize.h>
+#include <LibSQL/Snapshot.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 namespace SQL {
 
-Heap::Heap(String file_name)
+// Every flush() appends a block record for each block, followed by a commit record with block set to the
+// number of blocks, and the checksum of their checksums.
+struct [[gnu::packed]] WALRecordHeader {
+    u32 magic;
+    u32 block;
+    u32 length;
+    u32 checksum;
+};
+
+constexpr static u32 wal_block_magic = 0x4b4c4257;  // "WBLK"
+constexpr static u32 wal_commit_magic = 0x4d4d4357; // "WCMM"
+
+static String wal_file_name(String const& file_name)
 {
-    set_name(move(file_name));
-    size_t file_size = 0;
-    struct stat stat_buffer;
-    if (stat(name().characters(), &stat_buffer) != 0) {
-        if (errno != ENOENT) {
-            perror("stat");
-            VERIFY_NOT_REACHED();
-        }
-    } else {
-        file_size = stat_buffer.st_size;
-    }
-    if (file_size > 0)
-        m_next_block = m_end_of_file = file_size / BLOCKSIZE;
+    return String::formatted("{}-wal", file_name);
+}
+
+static u32 checksum_of_checksums(Vector<u32> const& checksums)
+{
+    return Crypto::Checksum::CRC32({ checksums.data(), checksums.size() * sizeof(u32) }).digest();
+}
+
+static bool is_valid_block_size(u32 block_size)
+{
+    return block_size >= Heap::minimum_block_size && block_size <= Heap::maximum_block_size && (block_size & (block_size - 1)) == 0;
+}
 
+Heap::Heap(String file_name, u32 block_size, ReadMode read_mode)
+    : m_block_size(block_size)
+    , m_read_mode(read_mode)
+{
+    VERIFY(is_valid_block_size(block_size));
+    set_name(move(file_name));
     auto file_or_error = Core::File::open(name(), Core::OpenMode::ReadWrite);
     if (file_or_error.is_error()) {
         warnln("Couldn't open '{}': {}", name(), file_or_error.error());
         VERIFY_NOT_REACHED();
     }
     m_file = file_or_error.value();
-    if (file_size > 0)
+    open_wal();
+    recover_from_wal();
+
+    struct stat stat_buffer;
+    if (fstat(m_file->fd(), &stat_buffer) != 0) {
+        perror("fstat");
+        VERIFY_NOT_REACHED();
+    }
+    size_t file_size = stat_buffer.st_size;
+    if (file_size > 0) {
+        // The block size of an existing file is the one it was created with.
         read_zero_block();
-    else
+        m_next_block = m_end_of_file = file_size / m_block_size;
+        map_file();
+    } else {
         initialize_zero_block();
+    }
+}
+
+Heap::~Heap()
+{
+    checkpoint();
+    if (m_wal_size == 0)
+        unlink(wal_file_name(name()).characters());
+}
+
+void Heap::open_wal()
+{
+    auto wal_or_error = Core::File::open(wal_file_name(name()), Core::OpenMode::ReadWrite | Core::OpenMode::Append);
+    if (wal_or_error.is_error()) {
+        warnln("Couldn't open write-ahead log of '{}': {}", name(), wal_or_error.error());
+        VERIFY_NOT_REACHED();
+    }
+    m_wal = wal_or_error.value();
+}
+
+void Heap::recover_from_wal()
+{
+    auto log = m_wal->read_all();
+    if (log.is_empty())
+        return;
+
+    // A flush() counts once its commit record is in the log, and everything after the first record that is
+    // incomplete or doesn't match its checksum was never committed.
+    HashMap<u32, ReadonlyBytes> committed_blocks;
+    HashMap<u32, ReadonlyBytes> blocks;
+    Vector<u32> checksums;
+    size_t offset = 0;
+    while (offset + sizeof(WALRecordHeader) <= log.size()) {
+        WALRecordHeader header;
+        memcpy(&header, log.offset_pointer(offset), sizeof(header));
+        offset += sizeof(header);
+        if (header.magic == wal_block_magic) {
+            if (!is_valid_block_size(header.length) || offset + header.length > log.size())
+                break;
+            auto data = log.bytes().slice(offset, header.length);
+            if (Crypto::Checksum::CRC32(data).digest() != header.checksum)
+                break;
+            blocks.set(header.block, data);
+            checksums.append((u32)header.checksum);
+            offset += header.length;
+        } else if (header.magic == wal_commit_magic) {
+            if (header.block != checksums.size() || checksum_of_checksums(checksums) != header.checksum)
+                break;
+            for (auto& block : blocks)
+                committed_blocks.set(block.key, block.value);
+            blocks.clear();
+            checksums.clear();
+        } else {
+            break;
+        }
+    }
+
+    auto block_numbers = committed_blocks.keys();
+    quick_sort(block_numbers);
+    for (auto block : block_numbers) {
+        auto data = committed_blocks.get(block).value();
+        if (!m_file->seek(block * (off_t)data.size()) || !m_file->write(data.data(), (int)data.size())) {
+            warnln("Couldn't recover block {} of '{}' from its write-ahead log: {}", block, name(), m_file->error_string());
+            VERIFY_NOT_REACHED();
+        }
+    }
+    if (fsync(m_file->fd()) < 0) {
+        perror("fsync");
+        VERIFY_NOT_REACHED();
+    }
+    m_wal->truncate(0);
+    dbgln_if(SQL_DEBUG, "Recovered {} blocks of {} from its write-ahead log", block_numbers.size(), name());
+}
+
+void Heap::map_file()
+{
+    if (m_read_mode != ReadMode::MappedFile)
+        return;
+    m_mapped_file = nullptr;
+    auto mapped_file_or_error = MappedFile::map(name());
+    if (mapped_file_or_error.is_error()) {
+        warnln("Couldn't map '{}', reading it block by block instead: {}", name(), mapped_file_or_error.error());
+        return;
+    }
+    m_mapped_file = mapped_file_or_error.release_value();
 }
 
 Result<ByteBuffer, String> Heap::read_block(u32 block)
 {
-    auto buffer_or_empty = m_write_ahead_log.get(block);
-    if (buffer_or_empty.has_value())
-        return buffer_or_empty.value();
+    Threading::MutexLocker locker(m_mutex);
+    auto page = m_pages.find(block);
+    if (page != m_pages.end()) {
+        ++m_cache_hits;
+        use_page(page->value);
+        return page->value.buffer;
+    }
 
+    ++m_cache_misses;
     VERIFY(block < m_next_block);
     dbgln_if(SQL_DEBUG, "Read heap block {}", block);
-    if (!seek_block(block))
-        VERIFY_NOT_REACHED();
-    auto ret = m_file->read(BLOCKSIZE);
+    ByteBuffer ret;
+    if (m_mapped_file && (block + 1) * (size_t)m_block_size <= m_mapped_file->size()) {
+        ret = ByteBuffer::copy(m_mapped_file->bytes().slice(block * (size_t)m_block_size, m_block_size));
+    } else {
+        if (!seek_block(block))
+            VERIFY_NOT_REACHED();
+        ret = m_file->read(m_block_size);
+    }
     if (ret.is_empty())
         return String("Could not read block");
+    ++m_blocks_read;
+    cache_page(block, ret, false);
     return ret;
 }
 
+void Heap::add_to_wal(u32 block, ByteBuffer& buffer)
+{
+    Threading::MutexLocker locker(m_mutex);
+    if (!m_snapshots.is_empty())
+        preserve_for_snapshots(block);
+    cache_page(block, buffer, true);
+}
+
+void Heap::preserve_for_snapshots(u32 block)
+{
+    // Snapshots are only taken right after a commit, so a block that is dirty
+    // already has been preserved for all of them when it got dirty.
+    if (auto page = m_pages.find(block); page != m_pages.end() && page->value.dirty)
+        return;
+    Optional<ByteBuffer> committed;
+    for (auto* snapshot : m_snapshots) {
+        if (block >= snapshot->m_size || snapshot->m_preserved_blocks.contains(block))
+            continue;
+        if (!committed.has_value()) {
+            auto buffer_or_error = read_block(block);
+            if (buffer_or_error.is_error())
+                VERIFY_NOT_REACHED();
+            committed = buffer_or_error.release_value();
+        }
+        snapshot->m_preserved_blocks.set(block, committed.value());
+    }
+}
+
+NonnullRefPtr<Snapshot> Heap::take_snapshot()
+{
+    Threading::MutexLocker locker(m_mutex);
+    flush();
+    auto snapshot = adopt_ref(*new Snapshot(*this));
+    m_snapshots.append(snapshot.ptr());
+    return snapshot;
+}
+
+void Heap::use_page(Page& page)
+{
+    page.previous_use = page.last_use;
+    page.last_use = ++m_clock;
+}
+
+void Heap::cache_page(u32 block, ByteBuffer const& buffer, bool dirty)
+{
+    auto& page = m_pages.ensure(block);
+    page.buffer = buffer;
+    page.dirty |= dirty;
+    use_page(page);
+    evict_pages();
+}
+
+void Heap::evict_pages()
+{
+    while (m_pages.size() > page_cache_size) {
+        Optional<u32> victim;
+        u64 victim_previous_use = NumericLimits<u64>::max();
+        u64 victim_last_use = NumericLimits<u64>::max();
+        for (auto& it : m_pages) {
+            auto& page = it.value;
+            if (page.dirty || page.logged)
+                continue;
+            if (page.previous_use < victim_previous_use || (page.previous_use == victim_previous_use && page.last_use < victim_last_use)) {
+                victim = it.key;
+                victim_previous_use = page.previous_use;
+                victim_last_use = page.last_use;
+            }
+        }
+        // Dirty and logged pages can only go once they're in the Heap file.
+        if (!victim.has_value())
+            return;
+        m_pages.remove(victim.value());
+    }
+}
+
 bool Heap::write_block(u32 block, ByteBuffer& buffer)
 {
+    Threading::MutexLocker locker(m_mutex);
     VERIFY(block < m_next_block);
     if (!seek_block(block))
         VERIFY_NOT_REACHED();
     dbgln_if(SQL_DEBUG, "Write heap block {} size {}", block, buffer.size());
-    VERIFY(buffer.size() <= BLOCKSIZE);
+    VERIFY(buffer.size() <= m_block_size);
     auto sz = buffer.size();
-    if (sz < BLOCKSIZE) {
-        buffer.resize(BLOCKSIZE);
-        memset(buffer.offset_pointer((int)sz), 0, BLOCKSIZE - sz);
+    if (sz < m_block_size) {
+        buffer.resize(m_block_size);
+        memset(buffer.offset_pointer((int)sz), 0, m_block_size - sz);
     }
     if (m_file->write(buffer.data(), (int)buffer.size())) {
+        ++m_blocks_written;
         if (block == m_end_of_file)
             m_end_of_file++;
+        if (auto page = m_pages.find(block); page != m_pages.end() && page->value.buffer.data() != buffer.data()) {
+            page->value.buffer = buffer;
+            page->value.dirty = false;
+        }
         return true;
     }
     return false;
@@ -92,7 +303,7 @@ bool Heap::seek_block(u32 block)
         warnln("Seeking block {} of file {} which is beyond the end of the file", block, name());
         return false;
     } else {
-        if (!m_file->seek(block * BLOCKSIZE)) {
+        if (!m_file->seek(block * (off_t)m_block_size)) {
             warnln("Could not seek block {} of file {}. The current size is {} blocks",
                 block, name(), m_end_of_file);
             return false;
@@ -103,6 +314,7 @@ bool Heap::seek_block(u32 block)
 
 u32 Heap::new_record_pointer()
 {
+    Threading::MutexLocker locker(m_mutex);
     if (m_free_list) {
         auto block_or_error = read_block(m_free_list);
         if (block_or_error.is_error()) {
@@ -120,20 +332,90 @@ u32 Heap::new_record_pointer()
 
 void Heap::flush()
 {
+    Threading::MutexLocker locker(m_mutex);
     Vector<u32> blocks;
-    for (auto& wal_entry : m_write_ahead_log) {
-        blocks.append(wal_entry.key);
+    for (auto& page : m_pages) {
+        if (page.value.dirty)
+            blocks.append(page.key);
     }
+    if (blocks.is_empty())
+        return;
     quick_sort(blocks);
+
+    ByteBuffer log;
+    Vector<u32> checksums;
     for (auto& block : blocks) {
-        auto buffer_or_empty = m_write_ahead_log.get(block);
-        if (buffer_or_empty->is_empty()) {
+        auto& buffer = m_pages.find(block)->value.buffer;
+        if (buffer.is_empty()) {
             VERIFY_NOT_REACHED();
         }
-        dbgln_if(SQL_DEBUG, "Flushing block {} to {}", block, name());
-        write_block(block, buffer_or_empty.value());
+        VERIFY(buffer.size() <= m_block_size);
+        auto sz = buffer.size();
+        if (sz < m_block_size) {
+            buffer.resize(m_block_size);
+            memset(buffer.offset_pointer((int)sz), 0, m_block_size - sz);
+        }
+        dbgln_if(SQL_DEBUG, "Logging block {} of {}", block, name());
+        auto checksum = Crypto::Checksum::CRC32(buffer.bytes()).digest();
+        WALRecordHeader header { wal_block_magic, block, m_block_size, checksum };
+        log.append(&header, sizeof(header));
+        log.append(buffer.bytes());
+        checksums.append(checksum);
+    }
+    WALRecordHeader commit { wal_commit_magic, (u32)blocks.size(), 0, checksum_of_checksums(checksums) };
+    log.append(&commit, sizeof(commit));
+
+    if (!m_wal->write(log.data(), (int)log.size()) || fsync(m_wal->fd()) < 0) {
+        warnln("Couldn't write to the write-ahead log of '{}': {}", name(), strerror(errno));
+        VERIFY_NOT_REACHED();
+    }
+    m_wal_size += log.size();
+    m_wal_bytes_written += log.size();
+    ++m_commits;
+    for (auto& block : blocks) {
+        auto& page = m_pages.find(block)->value;
+        page.dirty = false;
+        page.logged = true;
     }
-    m_write_ahead_log.clear();
+
+    if (m_wal_size >= wal_checkpoint_size)
+        checkpoint();
+}
+
+void Heap::checkpoint()
+{
+    Threading::MutexLocker locker(m_mutex);
+    flush();
+
+    Vector<u32> blocks;
+    for (auto& page : m_pages) {
+        if (page.value.logged)
+            blocks.append(page.key);
+    }
+    quick_sort(blocks);
+    for (auto& block : blocks) {
+        dbgln_if(SQL_DEBUG, "Checkpointing block {} to {}", block, name());
+        if (!write_block(block, m_pages.find(block)->value.buffer)) {
+            // The log still has everything, so nothing is lost until the next checkpoint.
+            warnln("Couldn't write block {} of '{}': {}", block, name(), m_file->error_string());
+            return;
+        }
+    }
+    if (!blocks.is_empty() && fsync(m_file->fd()) < 0) {
+        perror("fsync");
+        return;
+    }
+    if (m_wal_size > 0 && !m_wal->truncate(0)) {
+        warnln("Couldn't empty the write-ahead log of '{}': {}", name(), m_wal->error_string());
+        return;
+    }
+    m_wal_size = 0;
+    ++m_checkpoints;
+    for (auto& block : blocks)
+        m_pages.find(block)->value.logged = false;
+    if (!blocks.is_empty())
+        map_file();
+    evict_pages();
 }
 
 constexpr static const char* FILE_ID = "SerenitySQL ";
@@ -143,14 +425,20 @@ constexpr static int TABLES_ROOT_OFFSET = 20;
 constexpr static int TABLE_COLUMNS_ROOT_OFFSET = 24;
 constexpr static int FREE_LIST_OFFSET = 28;
 constexpr static int USER_VALUES_OFFSET = 32;
+constexpr static int BLOCK_SIZE_OFFSET = 96;
 
 void Heap::read_zero_block()
 {
     char file_id[256];
-    auto bytes_or_error = read_block(0);
-    if (bytes_or_error.is_error())
+    // The block size is only known once the zero block has been read, but is
+    // at least large enough for everything in it.
+    if (!m_file->seek(0))
+        VERIFY_NOT_REACHED();
+    auto buffer = m_file->read(minimum_block_size);
+    if (buffer.size() != minimum_block_size) {
+        warnln("Couldn't read zero page in {}", name());
         VERIFY_NOT_REACHED();
-    auto buffer = bytes_or_error.value();
+    }
     memcpy(file_id, buffer.offset_pointer(0), strlen(FILE_ID));
     file_id[strlen(FILE_ID)] = 0;
     if (strncmp(file_id, FILE_ID, strlen(FILE_ID)) != 0) {
@@ -174,6 +462,14 @@ void Heap::read_zero_block()
             dbgln_if(SQL_DEBUG, "User value {}: {}", ix, m_user_values[ix]);
         }
     }
+    memcpy(&m_block_size, buffer.offset_pointer(BLOCK_SIZE_OFFSET), sizeof(u32));
+    if (!m_block_size)
+        m_block_size = minimum_block_size;
+    if (!is_valid_block_size(m_block_size)) {
+        warnln("Corrupt block size {} in zero page of {}", m_block_size, name());
+        VERIFY_NOT_REACHED();
+    }
+    dbgln_if(SQL_DEBUG, "Block size: {}", m_block_size);
 }
 
 void Heap::update_zero_block()
@@ -190,7 +486,9 @@ void Heap::update_zero_block()
         }
     }
 
-    auto buffer = ByteBuffer::create_zeroed(BLOCKSIZE);
+    dbgln_if(SQL_DEBUG, "Block size: {}", m_block_size);
+
+    auto buffer = ByteBuffer::create_zeroed(m_block_size);
     buffer.overwrite(0, FILE_ID, strlen(FILE_ID));
     buffer.overwrite(VERSION_OFFSET, &m_version, sizeof(u32));
     buffer.overwrite(SCHEMAS_ROOT_OFFSET, &m_schemas_root, sizeof(u32));
@@ -198,6 +496,7 @@ void Heap::update_zero_block()
     buffer.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer.overwrite(FREE_LIST_OFFSET, &m_free_list, sizeof(u32));
     buffer.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
+    buffer.overwrite(BLOCK_SIZE_OFFSET, &m_block_size, sizeof(u32));
 
     add_to_wal(0, buffer);
 }
@@ -8,17 +8,17 @@
 
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
+#include <AK/MappedFile.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
 #include <LibCore/Object.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Serialize.h>
+#include <LibThreading/Mutex.h>
 
 namespace SQL {
 
-constexpr static u32 BLOCKSIZE = 1024;
-
 /**
  * A Heap is a logical container for database (SQL) data. Conceptually a
  * Heap can be a database file, or a memory block, or another storage medium.
@@ -29,15 +29,35 @@ constexpr static u32 BLOCKSIZE = 1024;
  * assumed that a single SQL database is backed by a single Heap.
  *
  * Currently only B-Trees and tuple stores are implemented.
+ *
+ * The block size is chosen when the Heap file is created, and recorded in
+ * its zero block. Files written before that was possible have 1 KiB
+ * blocks. Larger blocks give the B-Trees and hash indexes more keys per
+ * node, and so fewer blocks to read per lookup.
  */
 class Heap : public Core::Object {
     C_OBJECT(Heap);
 
 public:
-    explicit Heap(String);
-    virtual ~Heap() override { flush(); }
+    static constexpr u32 minimum_block_size = 1024;
+    static constexpr u32 maximum_block_size = 16 * KiB;
+    static constexpr u32 default_block_size = minimum_block_size;
+
+    enum class ReadMode {
+        // Every block that isn't cached is read with a seek and a read.
+        Syscalls,
+        // The file is mapped into memory, so reading a block is a copy out
+        // of the mapping. Writes still go through the file, and the mapping
+        // is renewed whenever flush() wrote anything.
+        MappedFile,
+    };
+
+    explicit Heap(String, u32 block_size = default_block_size, ReadMode = ReadMode::Syscalls);
+    virtual ~Heap() override;
 
     u32 size() const { return m_end_of_file; }
+    u32 block_size() const { return m_block_size; }
+    ReadMode read_mode() const { return m_read_mode; }
     Result<ByteBuffer, String> read_block(u32);
     bool write_block(u32, ByteBuffer&);
     u32 new_record_pointer();
@@ -81,16 +101,97 @@ public:
         update_zero_block();
     }
 
-    void add_to_wal(u32 block, ByteBuffer& buffer) { m_write_ahead_log.set(block, buffer); }
+    void add_to_wal(u32 block, ByteBuffer& buffer);
+
+    /**
+     * Commits the blocks added since the last flush(), by appending them to
+     * the write-ahead log next to the Heap file (its name with "-wal" added)
+     * and syncing that, which takes a single fsync however many blocks there
+     * are. If the process dies after that, the blocks are copied into the
+     * Heap file when it's opened again. Blocks of a flush() that didn't
+     * complete are dropped, since every record in the log is checksummed.
+     */
     void flush();
 
+    /**
+     * Commits, and then copies all logged blocks into the Heap file and
+     * empties the write-ahead log. This happens by itself once the log is
+     * larger than wal_checkpoint_size, and when the Heap is destroyed.
+     */
+    void checkpoint();
+    static constexpr size_t wal_checkpoint_size = 1 * MiB;
+    size_t wal_size() const { return m_wal_size; }
+
+    /**
+     * Blocks are kept in a page cache shared by everything stored in the
+     * Heap. Pages written through add_to_wal() are dirty, and stay until
+     * checkpoint() writes them out. Once there are more than page_cache_size
+     * pages, clean ones are evicted by LRU-2: the page whose second most
+     * recent use lies furthest back goes first, and pages that have only
+     * been used once go before all others. That keeps the interior nodes
+     * every B-Tree descent passes through from being pushed out by a scan.
+     */
+    static constexpr size_t page_cache_size = 256;
+    size_t cached_pages() const { return m_pages.size(); }
+    u64 cache_hits() const { return m_cache_hits; }
+    u64 cache_misses() const { return m_cache_misses; }
+
+    // Counters of the work done since the Heap was opened, for benchmarks
+    // and for SQLServer's statistics.
+    u64 blocks_read() const { return m_blocks_read; }
+    u64 blocks_written() const { return m_blocks_written; }
+    u64 commits() const { return m_commits; }
+    u64 wal_bytes_written() const { return m_wal_bytes_written; }
+    u64 checkpoints() const { return m_checkpoints; }
+
+    /**
+     * Commits, and returns a Snapshot of the Heap as it is now. Until the
+     * snapshot is gone, the committed contents of every block are saved in
+     * it right before add_to_wal() first changes them.
+     *
+     * The Heap may be used from more than one thread this way: one thread
+     * writing it, and others reading through snapshots. Everything that
+     * touches the page cache or the file holds mutex().
+     */
+    NonnullRefPtr<Snapshot> take_snapshot();
+    Threading::Mutex& mutex() { return m_mutex; }
+    template<typename Callback>
+    void for_each_snapshot(Callback callback)
+    {
+        Threading::MutexLocker locker(m_mutex);
+        for (auto* snapshot : m_snapshots)
+            callback(*snapshot);
+    }
+
 private:
+    friend Snapshot;
+
+    struct Page {
+        ByteBuffer buffer;
+        bool dirty { false };
+        bool logged { false };
+        u64 last_use { 0 };
+        u64 previous_use { 0 };
+    };
+
     bool seek_block(u32);
+    void open_wal();
+    void recover_from_wal();
+    void map_file();
     void read_zero_block();
     void initialize_zero_block();
     void update_zero_block();
+    void use_page(Page&);
+    void cache_page(u32, ByteBuffer const&, bool dirty);
+    void evict_pages();
+    void preserve_for_snapshots(u32 block);
 
     RefPtr<Core::File> m_file;
+    RefPtr<Core::File> m_wal;
+    size_t m_wal_size { 0 };
+    u32 m_block_size { default_block_size };
+    ReadMode m_read_mode { ReadMode::Syscalls };
+    RefPtr<MappedFile> m_mapped_file;
     u32 m_free_list { 0 };
     u32 m_next_block { 1 };
     u32 m_end_of_file { 1 };
@@ -99,7 +200,17 @@ private:
     u32 m_table_columns_root { 0 };
     u32 m_version { 0x00000001 };
     Array<u32, 16> m_user_values;
-    HashMap<u32, ByteBuffer> m_write_ahead_log;
+    HashMap<u32, Page> m_pages;
+    u64 m_clock { 0 };
+    u64 m_cache_hits { 0 };
+    u64 m_cache_misses { 0 };
+    u64 m_blocks_read { 0 };
+    u64 m_blocks_written { 0 };
+    u64 m_commits { 0 };
+    u64 m_wal_bytes_written { 0 };
+    u64 m_checkpoints { 0 };
+    Threading::Mutex m_mutex;
+    Vector<Snapshot*> m_snapshots;
 };
 
 }
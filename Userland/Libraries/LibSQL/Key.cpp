@@ -30,6 +30,17 @@ Key::Key(TupleDescriptor const& descriptor, ByteBuffer& buffer, size_t& offset)
 {
 }
 
+Key::Key(TupleDescriptor const& descriptor, ByteBuffer& buffer, size_t& offset, Key const& previous)
+    : Tuple(descriptor)
+{
+    deserialize(buffer, offset, &previous);
+}
+
+void Key::serialize_after(ByteBuffer& buffer, Key const& previous) const
+{
+    Tuple::serialize(buffer, &previous);
+}
+
 Key::Key(RefPtr<IndexDef> index, ByteBuffer& buffer, size_t& offset)
     : Key(index->to_tuple_descriptor())
 {
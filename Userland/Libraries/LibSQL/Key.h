@@ -21,6 +21,14 @@ public:
     Key(RefPtr<IndexDef>, ByteBuffer&, size_t& offset);
     Key(Key const&) = default;
     RefPtr<IndexDef> index() const { return m_index; }
+
+    // Keys next to each other in a B-Tree node often start the same way, so
+    // they are serialized leaving out what they have in common with the key
+    // before them. A key serialized like that can only be read back with
+    // the previous key at hand.
+    Key(TupleDescriptor const&, ByteBuffer&, size_t& offset, Key const& previous);
+    void serialize_after(ByteBuffer&, Key const& previous) const;
+
     [[nodiscard]] virtual size_t data_length() const override { return Tuple::data_length() + sizeof(u32); }
 
 private:
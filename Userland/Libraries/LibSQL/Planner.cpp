@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibSQL/Planner.h>
+#include <math.h>
+
+namespace SQL {
+
+bool Condition::holds_for(Row const& row) const
+{
+    auto& row_value = row[column];
+    if (row_value.is_null() || value.is_null())
+        return false;
+    auto comparison = row_value.compare(value);
+    switch (op) {
+    case Operator::Equals:
+        return comparison == 0;
+    case Operator::LessThan:
+        return comparison < 0;
+    case Operator::LessThanOrEquals:
+        return comparison <= 0;
+    case Operator::GreaterThan:
+        return comparison > 0;
+    case Operator::GreaterThanOrEquals:
+        return comparison >= 0;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+String Condition::to_string() const
+{
+    auto op_string = [&]() {
+        switch (op) {
+        case Operator::Equals:
+            return "=";
+        case Operator::LessThan:
+            return "<";
+        case Operator::LessThanOrEquals:
+            return "<=";
+        case Operator::GreaterThan:
+            return ">";
+        case Operator::GreaterThanOrEquals:
+            return ">=";
+        }
+        VERIFY_NOT_REACHED();
+    };
+    return String::formatted("{} {} {}", column, op_string(), value.to_string().value_or("NULL"));
+}
+
+IndexStatistics IndexStatistics::of(BTree& tree)
+{
+    IndexStatistics statistics;
+    bool is_numeric = tree.descriptor()[0].type != SQLType::Text;
+    Optional<Value> previous;
+    for (auto it = tree.begin(); !it.is_end(); it++) {
+        auto& value = (*it)[0];
+        statistics.entries++;
+        if (!previous.has_value() || previous->compare(value) != 0)
+            statistics.distinct_keys++;
+        previous = value;
+        if (is_numeric && !statistics.minimum.has_value())
+            statistics.minimum = value.to_double();
+    }
+    if (is_numeric && previous.has_value())
+        statistics.maximum = previous->to_double();
+    return statistics;
+}
+
+IndexStatistics IndexStatistics::of(HashIndex& hash_index)
+{
+    // Keys in a HashIndex are unique, and come out of it in no particular
+    // order.
+    IndexStatistics statistics;
+    bool is_numeric = hash_index.descriptor()[0].type != SQLType::Text;
+    for (auto it = hash_index.begin(); !it.is_end(); it++) {
+        statistics.entries++;
+        if (!is_numeric)
+            continue;
+        auto value = (*it)[0].to_double();
+        if (!value.has_value())
+            continue;
+        if (!statistics.minimum.has_value() || value.value() < statistics.minimum.value())
+            statistics.minimum = value;
+        if (!statistics.maximum.has_value() || value.value() > statistics.maximum.value())
+            statistics.maximum = value;
+    }
+    statistics.distinct_keys = statistics.entries;
+    return statistics;
+}
+
+QueryPlan::QueryPlan(Heap& heap, TableDef const& table, Vector<Condition> conditions, double cost)
+    : m_heap(heap)
+    , m_table(table)
+    , m_cost(cost)
+    , m_residual_conditions(move(conditions))
+{
+}
+
+String QueryPlan::explain() const
+{
+    StringBuilder builder;
+    switch (m_access) {
+    case Access::TableScan:
+        builder.appendff("SCAN {}", m_table->name());
+        break;
+    case Access::HashLookup:
+        builder.appendff("SEARCH {} USING HASH INDEX ON {} ({})", m_table->name(), m_index_column, m_lower_bound->to_string());
+        break;
+    case Access::IndexSeek:
+        builder.appendff("SEARCH {} USING INDEX ON {} ({})", m_table->name(), m_index_column, m_lower_bound->to_string());
+        break;
+    case Access::IndexRangeScan:
+        builder.appendff("SEARCH {} USING INDEX ON {} (", m_table->name(), m_index_column);
+        if (m_lower_bound.has_value())
+            builder.append(m_lower_bound->to_string());
+        if (m_lower_bound.has_value() && m_upper_bound.has_value())
+            builder.append(" AND ");
+        if (m_upper_bound.has_value())
+            builder.append(m_upper_bound->to_string());
+        builder.append(")");
+        break;
+    }
+    for (size_t ix = 0; ix < m_residual_conditions.size(); ix++)
+        builder.appendff("{}{}", (ix == 0) ? " WHERE " : " AND ", m_residual_conditions[ix].to_string());
+    builder.appendff(" (estimated cost {})", (size_t)ceil(m_cost));
+    return builder.build();
+}
+
+NonnullOwnPtr<Cursor> QueryPlan::open()
+{
+    OwnPtr<Cursor> cursor;
+    switch (m_access) {
+    case Access::TableScan:
+        cursor = make<TableScan>(*m_heap, *m_table);
+        break;
+    case Access::HashLookup: {
+        Key key(m_hash_index->descriptor());
+        key[0] = m_lower_bound->value;
+        cursor = make<HashLookup>(*m_heap, *m_table, *m_hash_index, move(key));
+        break;
+    }
+    case Access::IndexSeek:
+    case Access::IndexRangeScan: {
+        auto start = m_tree->begin();
+        if (m_lower_bound.has_value()) {
+            Key key(m_tree->descriptor());
+            key[0] = m_lower_bound->value;
+            start = m_tree->lower_bound(key);
+            if (m_lower_bound->op == Condition::Operator::GreaterThan) {
+                while (!start.is_end() && (*start)[0].compare(m_lower_bound->value) == 0)
+                    start++;
+            }
+        }
+        auto upper_bound = m_upper_bound;
+        cursor = make<IndexScan>(*m_heap, *m_table, *m_tree, start, [upper_bound](Key const& key) {
+            if (!upper_bound.has_value())
+                return true;
+            auto comparison = key[0].compare(upper_bound->value);
+            return (upper_bound->op == Condition::Operator::LessThan) ? comparison < 0 : comparison <= 0;
+        });
+        break;
+    }
+    }
+
+    if (m_residual_conditions.is_empty())
+        return cursor.release_nonnull();
+    return make<Filter>(cursor.release_nonnull(), [conditions = m_residual_conditions](Row const& row) {
+        for (auto& condition : conditions) {
+            if (!condition.holds_for(row))
+                return false;
+        }
+        return true;
+    });
+}
+
+Planner::Planner(Heap& heap, TableDef const& table)
+    : m_heap(heap)
+    , m_table(table)
+{
+}
+
+void Planner::add_index(BTree& tree)
+{
+    add_index(tree, tree, nullptr, IndexStatistics::of(tree));
+}
+
+void Planner::add_index(HashIndex& hash_index)
+{
+    add_index(hash_index, nullptr, hash_index, IndexStatistics::of(hash_index));
+}
+
+void Planner::add_index(Index& index, RefPtr<BTree> tree, RefPtr<HashIndex> hash_index, IndexStatistics statistics)
+{
+    auto descriptor = index.descriptor();
+    VERIFY(descriptor.size() == 1);
+    VERIFY(descriptor[0].order == Order::Ascending);
+    // Every row of the table has a key in each of its indexes.
+    m_estimated_rows = max(m_estimated_rows, statistics.entries);
+    m_indexes.append({ descriptor[0].name, move(tree), move(hash_index), statistics });
+}
+
+double Planner::range_selectivity(IndexEntry const& index, Optional<Condition> const& lower, Optional<Condition> const& upper) const
+{
+    auto& statistics = index.statistics;
+    if (statistics.minimum.has_value() && statistics.maximum.has_value()) {
+        auto minimum = statistics.minimum.value();
+        auto maximum = statistics.maximum.value();
+        auto from = lower.has_value() ? lower->value.to_double() : minimum;
+        auto to = upper.has_value() ? upper->value.to_double() : maximum;
+        if (from.has_value() && to.has_value()) {
+            if (maximum <= minimum)
+                return (from.value() <= minimum && to.value() >= maximum) ? 1.0 : 0.0;
+            return clamp((to.value() - from.value()) / (maximum - minimum), 0.0, 1.0);
+        }
+    }
+    auto selectivity = 1.0;
+    if (lower.has_value())
+        selectivity *= default_range_selectivity;
+    if (upper.has_value())
+        selectivity *= default_range_selectivity;
+    return selectivity;
+}
+
+QueryPlan Planner::plan(Vector<Condition> conditions)
+{
+    auto rows = (double)m_estimated_rows;
+    QueryPlan best(*m_heap, *m_table, conditions, rows);
+
+    // Descending a BTree reads about one node per level.
+    auto keys_per_node = max((double)m_heap->block_size() / 16.0, 2.0);
+    auto tree_depth = max(ceil(log(rows + 1.0) / log(keys_per_node)), 1.0);
+
+    for (auto& index : m_indexes) {
+        Optional<size_t> equals;
+        Optional<size_t> lower;
+        Optional<size_t> upper;
+        for (size_t ix = 0; ix < conditions.size(); ix++) {
+            auto& condition = conditions[ix];
+            if (condition.column != index.column || condition.value.is_null())
+                continue;
+            switch (condition.op) {
+            case Condition::Operator::Equals:
+                if (!equals.has_value())
+                    equals = ix;
+                break;
+            case Condition::Operator::GreaterThan:
+            case Condition::Operator::GreaterThanOrEquals:
+                if (!lower.has_value())
+                    lower = ix;
+                break;
+            case Condition::Operator::LessThan:
+            case Condition::Operator::LessThanOrEquals:
+                if (!upper.has_value())
+                    upper = ix;
+                break;
+            }
+        }
+
+        auto rows_per_key = (index.statistics.distinct_keys > 0) ? rows / (double)index.statistics.distinct_keys : 0.0;
+        QueryPlan::Access access;
+        double cost;
+        if (index.hash_index) {
+            if (!equals.has_value())
+                continue;
+            access = QueryPlan::Access::HashLookup;
+            cost = 1.0 + rows_per_key;
+        } else if (equals.has_value()) {
+            access = QueryPlan::Access::IndexSeek;
+            cost = tree_depth + rows_per_key;
+        } else if (lower.has_value() || upper.has_value()) {
+            access = QueryPlan::Access::IndexRangeScan;
+            Optional<Condition> lower_condition;
+            Optional<Condition> upper_condition;
+            if (lower.has_value())
+                lower_condition = conditions[lower.value()];
+            if (upper.has_value())
+                upper_condition = conditions[upper.value()];
+            cost = tree_depth + rows * range_selectivity(index, lower_condition, upper_condition);
+        } else {
+            continue;
+        }
+        if (cost >= best.m_cost)
+            continue;
+
+        auto is_used = [&](size_t ix) {
+            if (equals.has_value())
+                return ix == equals.value();
+            return (lower.has_value() && ix == lower.value()) || (upper.has_value() && ix == upper.value());
+        };
+        Vector<Condition> residual_conditions;
+        for (size_t ix = 0; ix < conditions.size(); ix++) {
+            if (is_used(ix))
+                continue;
+            residual_conditions.append(conditions[ix]);
+        }
+        QueryPlan plan(*m_heap, *m_table, move(residual_conditions), cost);
+        plan.m_access = access;
+        plan.m_index_column = index.column;
+        plan.m_tree = index.tree;
+        plan.m_hash_index = index.hash_index;
+        if (equals.has_value()) {
+            plan.m_lower_bound = conditions[equals.value()];
+            plan.m_upper_bound = conditions[equals.value()];
+        } else {
+            if (lower.has_value())
+                plan.m_lower_bound = conditions[lower.value()];
+            if (upper.has_value())
+                plan.m_upper_bound = conditions[upper.value()];
+        }
+        best = move(plan);
+    }
+    return best;
+}
+
+}
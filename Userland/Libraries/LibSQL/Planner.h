@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Cursor.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/HashIndex.h>
+#include <LibSQL/Heap.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+#include <LibSQL/Value.h>
+
+namespace SQL {
+
+/**
+ * A comparison of a column of a table with a constant value. A query's
+ * where clause is planned as a list of these, all of which must hold.
+ */
+struct Condition {
+    enum class Operator {
+        Equals,
+        LessThan,
+        LessThanOrEquals,
+        GreaterThan,
+        GreaterThanOrEquals,
+    };
+
+    String column;
+    Operator op { Operator::Equals };
+    Value value;
+
+    [[nodiscard]] bool holds_for(Row const&) const;
+    [[nodiscard]] String to_string() const;
+};
+
+/**
+ * What the planner knows about the keys of an index: how many there are,
+ * how many of them are different, and the smallest and largest key, when
+ * the keys are numbers.
+ */
+struct IndexStatistics {
+    size_t entries { 0 };
+    size_t distinct_keys { 0 };
+    Optional<double> minimum;
+    Optional<double> maximum;
+
+    static IndexStatistics of(BTree&);
+    static IndexStatistics of(HashIndex&);
+};
+
+/**
+ * The way the planner chose to read the rows of a table matching a list of
+ * conditions. open() builds the Cursor pipeline reading them, and explain()
+ * describes it, for EXPLAIN.
+ */
+class QueryPlan {
+public:
+    enum class Access {
+        TableScan,
+        IndexSeek,
+        IndexRangeScan,
+        HashLookup,
+    };
+
+    [[nodiscard]] Access access() const { return m_access; }
+    [[nodiscard]] double cost() const { return m_cost; }
+    [[nodiscard]] String explain() const;
+    NonnullOwnPtr<Cursor> open();
+
+private:
+    friend class Planner;
+    QueryPlan(Heap&, TableDef const&, Vector<Condition>, double cost);
+
+    NonnullRefPtr<Heap> m_heap;
+    NonnullRefPtr<TableDef> m_table;
+    Access m_access { Access::TableScan };
+    double m_cost { 0.0 };
+    String m_index_column;
+    RefPtr<BTree> m_tree;
+    RefPtr<HashIndex> m_hash_index;
+    Optional<Condition> m_lower_bound;
+    Optional<Condition> m_upper_bound;
+    Vector<Condition> m_residual_conditions;
+};
+
+/**
+ * Chooses between reading all rows of a table and using one of the indexes
+ * on it, whichever is expected to read the fewest rows and index nodes. The
+ * estimates come from the statistics of the indexes, which are gathered
+ * when they are added. Only indexes on a single, ascending column are used.
+ */
+class Planner {
+public:
+    Planner(Heap&, TableDef const&);
+
+    void add_index(BTree&);
+    void add_index(HashIndex&);
+    [[nodiscard]] size_t estimated_rows() const { return m_estimated_rows; }
+
+    QueryPlan plan(Vector<Condition>);
+
+    // When nothing better is known, a bound on a range is guessed to keep a
+    // third of the keys.
+    static constexpr double default_range_selectivity = 1.0 / 3.0;
+
+private:
+    struct IndexEntry {
+        String column;
+        RefPtr<BTree> tree;
+        RefPtr<HashIndex> hash_index;
+        IndexStatistics statistics;
+    };
+
+    void add_index(Index&, RefPtr<BTree>, RefPtr<HashIndex>, IndexStatistics);
+    double range_selectivity(IndexEntry const&, Optional<Condition> const& lower, Optional<Condition> const& upper) const;
+
+    NonnullRefPtr<Heap> m_heap;
+    NonnullRefPtr<TableDef> m_table;
+    Vector<IndexEntry> m_indexes;
+    size_t m_estimated_rows { 0 };
+};
+
+}
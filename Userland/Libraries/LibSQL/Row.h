@@ -9,6 +9,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/RefPtr.h>
 #include <LibSQL/Forward.h>
+#include <LibSQL/Tuple.h>
 #include <LibSQL/Value.h>
 
 namespace SQL {
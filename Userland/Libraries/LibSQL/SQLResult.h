@@ -9,6 +9,7 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Vector.h>
 #include <LibCore/Object.h>
+#include <LibSQL/Cursor.h>
 #include <LibSQL/Tuple.h>
 #include <LibSQL/Type.h>
 
@@ -51,7 +52,8 @@ constexpr char const* command_tag(SQLCommand command)
     S(TableDoesNotExist, "Table '{}' does not exist")             \
     S(TableExists, "Table '{}' already exist")                    \
     S(InvalidType, "Invalid type '{}'")                           \
-    S(InvalidDatabaseName, "Invalid database name '{}'")
+    S(InvalidDatabaseName, "Invalid database name '{}'")         \
+    S(InvalidNumberOfPlaceholderValues, "Expected {} placeholder values")
 
 enum class SQLErrorCode {
 #undef __ENUMERATE_SQL_ERROR
@@ -113,6 +115,28 @@ public:
     bool has_results() const { return m_has_results; }
     Vector<Tuple> const& results() const { return m_result_set; }
 
+    // Results can also come from a Cursor, which then only produces them as
+    // they are taken with next_result(), after the ones that were appended.
+    void set_cursor(NonnullOwnPtr<Cursor> cursor)
+    {
+        m_has_results = true;
+        m_cursor = move(cursor);
+    }
+
+    Optional<Tuple> next_result()
+    {
+        if (m_next_result < m_result_set.size())
+            return m_result_set[m_next_result++];
+        if (!m_cursor)
+            return {};
+        auto row = m_cursor->next();
+        if (!row.has_value()) {
+            m_cursor = nullptr;
+            return {};
+        }
+        return Tuple(row.release_value());
+    }
+
 private:
     SQLResult() = default;
 
@@ -138,6 +162,8 @@ private:
     int m_delete_count { 0 };
     bool m_has_results { false };
     Vector<Tuple> m_result_set;
+    size_t m_next_result { 0 };
+    OwnPtr<Cursor> m_cursor;
 };
 
 }
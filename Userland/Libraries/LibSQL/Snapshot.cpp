@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/Cursor.h>
+#include <LibSQL/Heap.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Snapshot.h>
+
+namespace SQL {
+
+Snapshot::Snapshot(Heap& heap)
+    : m_heap(heap)
+    , m_size(heap.m_next_block)
+{
+}
+
+Snapshot::~Snapshot()
+{
+    Threading::MutexLocker locker(m_heap->mutex());
+    m_heap->m_snapshots.remove_first_matching([&](auto* snapshot) { return snapshot == this; });
+}
+
+Result<ByteBuffer, String> Snapshot::read_block(u32 block)
+{
+    Threading::MutexLocker locker(m_heap->mutex());
+    VERIFY(block < m_size);
+    if (auto preserved = m_preserved_blocks.get(block); preserved.has_value())
+        return preserved.value();
+    // The block hasn't changed since the snapshot was taken.
+    return m_heap->read_block(block);
+}
+
+u32 Snapshot::table_pointer(TableDef const& table)
+{
+    Threading::MutexLocker locker(m_heap->mutex());
+    if (auto pointer = m_table_pointers.get(table.hash()); pointer.has_value())
+        return pointer.value();
+    return table.pointer();
+}
+
+void Snapshot::preserve_table_pointer(TableDef const& table)
+{
+    if (!m_table_pointers.contains(table.hash()))
+        m_table_pointers.set(table.hash(), table.pointer());
+}
+
+NonnullOwnPtr<Cursor> Snapshot::scan(TableDef const& table)
+{
+    return make<TableScan>(*this, table);
+}
+
+}
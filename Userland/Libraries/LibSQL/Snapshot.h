@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <LibSQL/Forward.h>
+
+namespace SQL {
+
+/**
+ * A Snapshot is a read-only view of a Database as it was committed when
+ * the snapshot was taken, which stays the same while the Database goes on
+ * to change. Taking one copies nothing: the Heap saves the old contents of
+ * a block in every live snapshot right before it first changes the block,
+ * and the Database does the same with the first row of a table before it
+ * inserts a new one in front of it.
+ *
+ * A Snapshot can be read from any thread, concurrently with the thread
+ * writing the Database and with other snapshots.
+ */
+class Snapshot : public RefCounted<Snapshot> {
+public:
+    ~Snapshot();
+
+    Result<ByteBuffer, String> read_block(u32);
+    [[nodiscard]] u32 table_pointer(TableDef const&);
+    NonnullOwnPtr<Cursor> scan(TableDef const&);
+
+    Heap& heap() { return m_heap; }
+    [[nodiscard]] size_t preserved_blocks() const { return m_preserved_blocks.size(); }
+
+private:
+    friend Database;
+    friend Heap;
+    explicit Snapshot(Heap&);
+
+    void preserve_table_pointer(TableDef const&);
+
+    NonnullRefPtr<Heap> m_heap;
+    u32 m_size { 0 };
+    HashMap<u32, ByteBuffer> m_preserved_blocks;
+    HashMap<u32, u32> m_table_pointers;
+};
+
+}
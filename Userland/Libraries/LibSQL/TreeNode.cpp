@@ -122,7 +122,10 @@ TreeNode::TreeNode(BTree& tree, TreeNode* up, u32 pointer, ByteBuffer& buffer, s
                 VERIFY((left == 0) == m_is_leaf);
             else
                 m_is_leaf = (left == 0);
-            m_entries.append(Key(m_tree.descriptor(), buffer, at_offset));
+            if (m_entries.is_empty())
+                m_entries.append(Key(m_tree.descriptor(), buffer, at_offset));
+            else
+                m_entries.append(Key(m_tree.descriptor(), buffer, at_offset, m_entries.last()));
             m_down.empend(this, left);
         }
         u32 right;
@@ -183,7 +186,7 @@ size_t TreeNode::max_keys_in_node()
 {
     auto descriptor = m_tree.descriptor();
     auto key_size = descriptor.data_length() + sizeof(u32);
-    auto ret = (BLOCKSIZE - 2 * sizeof(u32)) / key_size;
+    auto ret = (m_tree.heap().block_size() - 2 * sizeof(u32)) / key_size;
     if ((ret % 2) == 0)
         --ret;
     return ret;
@@ -272,7 +275,10 @@ void TreeNode::serialize(ByteBuffer& buffer) const
             auto& entry = m_entries[ix];
             dbgln_if(SQL_DEBUG, "Serializing Left[{}] = {}", ix, m_down[ix].pointer());
             serialize_to<u32>(buffer, is_leaf() ? 0u : m_down[ix].pointer());
-            entry.serialize(buffer);
+            if (ix == 0)
+                entry.serialize(buffer);
+            else
+                entry.serialize_after(buffer, m_entries[ix - 1]);
         }
         dbgln_if(SQL_DEBUG, "Serializing Right = {}", m_down[size()].pointer());
         serialize_to<u32>(buffer, is_leaf() ? 0u : m_down[size()].pointer());
@@ -44,32 +44,178 @@ Tuple::Tuple(TupleDescriptor const& descriptor, ByteBuffer& buffer)
     deserialize(buffer, offset);
 }
 
-void Tuple::deserialize(ByteBuffer& buffer, size_t& offset)
+static size_t slot_size(SQLType type)
+{
+    // Text keeps its length and shared prefix length in its slot, and its
+    // characters after all slots.
+    return (type == SQLType::Text) ? 2 * sizeof(u8) : size_of(type);
+}
+
+void Tuple::deserialize(ByteBuffer& buffer, size_t& offset, Tuple const* previous)
 {
     dbgln_if(SQL_DEBUG, "deserialize tuple at offset {}", offset);
     deserialize_from<u32>(buffer, offset, m_pointer);
     dbgln_if(SQL_DEBUG, "pointer: {}", m_pointer);
+
+    auto start = offset;
+    auto null_bitmap = buffer.offset_pointer((int)offset);
+    offset += (m_descriptor.size() + 7) / 8;
+    auto text_offset = offset;
+    for (auto& part : m_descriptor)
+        text_offset += slot_size(part.type);
+
+    Vector<EncodedValue> encoded_values;
+    for (auto ix = 0u; ix < m_descriptor.size(); ix++) {
+        EncodedValue encoded;
+        encoded.is_null = null_bitmap[ix / 8] & (1 << (ix % 8));
+        if (m_descriptor[ix].type == SQLType::Text) {
+            encoded.shared_prefix = buffer[offset];
+            encoded.length = buffer[offset + 1];
+            encoded.offset = text_offset;
+            text_offset += encoded.length;
+        } else {
+            encoded.offset = offset;
+            encoded.length = size_of(m_descriptor[ix].type);
+        }
+        offset += slot_size(m_descriptor[ix].type);
+        encoded_values.append(encoded);
+    }
+    offset = text_offset;
+
     m_data.clear();
-    for (auto& part : m_descriptor) {
-        m_data.append(Value(part.type, buffer, offset));
-        dbgln_if(SQL_DEBUG, "Deserialized element {} = {}", part.name, m_data.last().to_string().value());
+    m_undecoded.clear();
+    if (previous) {
+        // Text shared with the previous tuple can only be decoded while that
+        // tuple is around, so these are decoded right away.
+        previous->decode_all();
+        for (auto ix = 0u; ix < m_descriptor.size(); ix++) {
+            auto previous_value = (ix < previous->m_data.size()) ? &previous->m_data[ix] : nullptr;
+            m_data.append(decode(m_descriptor[ix].type, buffer.bytes(), encoded_values[ix], previous_value));
+        }
+        return;
+    }
+
+    m_encoded = buffer.slice(start, offset - start);
+    for (auto ix = 0u; ix < m_descriptor.size(); ix++) {
+        auto& encoded = encoded_values[ix];
+        VERIFY(encoded.shared_prefix == 0);
+        encoded.offset -= start;
+        m_data.append(Value(m_descriptor[ix].type));
+        if (!encoded.is_null)
+            m_undecoded.append(encoded);
+        else
+            m_undecoded.append({});
+    }
+}
+
+Value Tuple::decode(SQLType type, ReadonlyBytes bytes, EncodedValue const& encoded, Value const* previous) const
+{
+    Value value(type);
+    if (encoded.is_null)
+        return value;
+    auto data = bytes.offset(encoded.offset);
+    switch (type) {
+    case SQLType::Text: {
+        StringBuilder builder;
+        if (encoded.shared_prefix > 0) {
+            VERIFY(previous && !previous->is_null());
+            builder.append(previous->to_string().value().substring_view(0, encoded.shared_prefix));
+        }
+        builder.append(StringView(data, encoded.length));
+        value = builder.build();
+        break;
     }
+    case SQLType::Integer: {
+        int integer;
+        memcpy(&integer, data, sizeof(int));
+        value = integer;
+        break;
+    }
+    case SQLType::Float: {
+        double number;
+        memcpy(&number, data, sizeof(double));
+        value = number;
+        break;
+    }
+    }
+    return value;
+}
+
+void Tuple::decode(size_t ix) const
+{
+    if (ix >= m_undecoded.size() || !m_undecoded[ix].has_value())
+        return;
+    m_data[ix] = decode(m_descriptor[ix].type, m_encoded.bytes(), m_undecoded[ix].value(), nullptr);
+    m_undecoded[ix] = {};
+    dbgln_if(SQL_DEBUG, "Decoded element {} = {}", m_descriptor[ix].name, m_data[ix].to_string().value());
+}
+
+void Tuple::decode_all() const
+{
+    for (auto ix = 0u; ix < m_undecoded.size(); ix++)
+        decode(ix);
 }
 
 void Tuple::serialize(ByteBuffer& buffer) const
+{
+    serialize(buffer, nullptr);
+}
+
+void Tuple::serialize(ByteBuffer& buffer, Tuple const* previous) const
 {
     VERIFY(m_descriptor.size() == m_data.size());
+    decode_all();
+    if (previous)
+        previous->decode_all();
     dbgln_if(SQL_DEBUG, "Serializing tuple pointer {}", pointer());
     serialize_to<u32>(buffer, pointer());
+
+    Vector<u8> null_bitmap;
+    null_bitmap.resize((m_descriptor.size() + 7) / 8);
+    for (auto ix = 0u; ix < m_descriptor.size(); ix++) {
+        if (m_data[ix].is_null())
+            null_bitmap[ix / 8] |= 1 << (ix % 8);
+    }
+    buffer.append(null_bitmap.data(), null_bitmap.size());
+
+    StringBuilder text;
     for (auto ix = 0u; ix < m_descriptor.size(); ix++) {
         auto& key_part = m_data[ix];
+        auto type = m_descriptor[ix].type;
         if constexpr (SQL_DEBUG) {
             auto str_opt = key_part.to_string();
             auto& key_part_definition = m_descriptor[ix];
             dbgln("Serialized part {} = {}", key_part_definition.name, (str_opt.has_value()) ? str_opt.value() : "(null)");
         }
-        key_part.serialize(buffer);
+        if (type != SQLType::Text) {
+            if (key_part.is_null()) {
+                u8 zeroes[sizeof(double)] {};
+                buffer.append(zeroes, size_of(type));
+            } else {
+                key_part.serialize(buffer);
+            }
+            continue;
+        }
+
+        u8 shared_prefix = 0;
+        u8 length = 0;
+        if (!key_part.is_null()) {
+            auto string = key_part.to_string().value();
+            auto view = string.substring_view(0, min(string.length(), max_text_length));
+            if (previous && ix < previous->m_data.size() && !previous->m_data[ix].is_null()) {
+                auto previous_string = previous->m_data[ix].to_string().value();
+                auto common_length = min(view.length(), previous_string.length());
+                while (shared_prefix < common_length && view[shared_prefix] == previous_string[shared_prefix])
+                    shared_prefix++;
+            }
+            length = view.length() - shared_prefix;
+            text.append(view.substring_view(shared_prefix));
+        }
+        buffer.append(&shared_prefix, sizeof(u8));
+        buffer.append(&length, sizeof(u8));
     }
+    auto text_view = text.string_view();
+    buffer.append(text_view.characters_without_null_termination(), text_view.length());
 }
 
 Tuple::Tuple(Tuple const& other)
@@ -102,12 +248,14 @@ Optional<size_t> Tuple::index_of(String name) const
 Value const& Tuple::operator[](size_t ix) const
 {
     VERIFY(ix < m_data.size());
+    decode(ix);
     return m_data[ix];
 }
 
 Value& Tuple::operator[](size_t ix)
 {
     VERIFY(ix < m_data.size());
+    decode(ix);
     return m_data[ix];
 }
 
@@ -160,6 +308,7 @@ bool Tuple::is_compatible(Tuple const& other) const
 
 String Tuple::to_string() const
 {
+    decode_all();
     StringBuilder builder;
     for (auto& part : m_data) {
         if (!builder.is_empty()) {
@@ -176,6 +325,7 @@ String Tuple::to_string() const
 
 Vector<String> Tuple::to_string_vector() const
 {
+    decode_all();
     Vector<String> ret;
     for (auto& value : m_data) {
         ret.append(value.to_string().value());
@@ -185,6 +335,7 @@ Vector<String> Tuple::to_string_vector() const
 
 size_t Tuple::size() const
 {
+    decode_all();
     size_t sz = sizeof(u32);
     for (auto& part : m_data) {
         sz += part.size();
@@ -203,10 +354,14 @@ void Tuple::copy_from(const Tuple& other)
         m_data.append(part);
     }
     m_pointer = other.pointer();
+    m_encoded = other.m_encoded;
+    m_undecoded = other.m_undecoded;
 }
 
 int Tuple::compare(const Tuple& other) const
 {
+    decode_all();
+    other.decode_all();
     auto num_values = min(m_data.size(), other.m_data.size());
     VERIFY(num_values > 0);
     for (auto ix = 0u; ix < num_values; ix++) {
@@ -222,6 +377,7 @@ int Tuple::compare(const Tuple& other) const
 
 int Tuple::match(const Tuple& other) const
 {
+    decode_all();
     auto other_index = 0u;
     for (auto& part : other.descriptor()) {
         auto other_value = other[other_index];
@@ -240,6 +396,7 @@ int Tuple::match(const Tuple& other) const
 
 u32 Tuple::hash() const
 {
+    decode_all();
     u32 ret = 0u;
     for (auto& value : m_data) {
         // This is an extension of the pair_int_hash function from AK/HashFunctions.h:
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
+#include <AK/Optional.h>
 #include <AK/Vector.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/TupleDescriptor.h>
@@ -24,6 +26,13 @@ namespace SQL {
  *
  * Tuple is a base class; concrete subclasses are Key, which implements the
  * elements of an index, and Row, which implements the rows in a table.
+ *
+ * A serialized tuple starts with its pointer and a bitmap of its null parts,
+ * followed by one fixed size slot per part: the value itself for numbers,
+ * and for text its length, and how many leading characters it shares with
+ * the same part of the tuple serialized before it (only keys in B-Tree nodes
+ * are serialized against another tuple). The text itself follows the slots.
+ * A tuple read from a buffer only decodes a part when it is first accessed.
  */
 class Tuple {
 public:
@@ -70,15 +79,34 @@ public:
     virtual void serialize(ByteBuffer&) const;
     [[nodiscard]] virtual size_t data_length() const { return descriptor().data_length(); }
 
+    // Text longer than this is cut off when it is serialized.
+    static constexpr size_t max_text_length = 63;
+
 protected:
     [[nodiscard]] Optional<size_t> index_of(String) const;
     void copy_from(Tuple const&);
-    void deserialize(ByteBuffer&, size_t&);
+    void serialize(ByteBuffer&, Tuple const* previous) const;
+    void deserialize(ByteBuffer&, size_t&, Tuple const* previous = nullptr);
 
 private:
+    struct EncodedValue {
+        bool is_null { true };
+        size_t offset { 0 };
+        size_t length { 0 };
+        size_t shared_prefix { 0 };
+    };
+
+    [[nodiscard]] Value decode(SQLType, ReadonlyBytes, EncodedValue const&, Value const* previous) const;
+    void decode(size_t ix) const;
+    void decode_all() const;
+
     TupleDescriptor m_descriptor;
-    Vector<Value> m_data;
+    mutable Vector<Value> m_data;
     u32 m_pointer { 0 };
+
+    // The serialized parts that have not been decoded into m_data yet.
+    ByteBuffer m_encoded;
+    mutable Vector<Optional<EncodedValue>> m_undecoded;
 };
 
 }
@@ -27,7 +27,7 @@ public:
 
     [[nodiscard]] size_t data_length() const
     {
-        size_t sz = sizeof(u32);
+        size_t sz = sizeof(u32) + (size() + 7) / 8;
         for (auto& part : *this) {
             sz += size_of(part.type);
         }
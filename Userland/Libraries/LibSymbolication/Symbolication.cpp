@@ -5,6 +5,8 @@
  */
 
 #include <AK/Checked.h>
+#include <AK/Demangle.h>
+#include <AK/HashTable.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
@@ -12,15 +14,38 @@
 #include <LibCore/File.h>
 #include <LibDebug/DebugInfo.h>
 #include <LibSymbolication/Symbolication.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
+#include <sys/stat.h>
 
 namespace Symbolication {
 
 struct CachedELF {
     NonnullRefPtr<MappedFile> mapped_file;
     NonnullOwnPtr<Debug::DebugInfo> debug_info;
+    // Every address that was looked up so far, as stacks and profiles keep coming back to the same ones.
+    HashMap<FlatPtr, Symbol> symbols;
 };
 
-static HashMap<String, OwnPtr<CachedELF>> s_cache;
+// Which file a cache entry was made from, so that a binary which was rebuilt or replaced since is mapped again.
+struct FileIdentity {
+    dev_t device { 0 };
+    ino_t inode { 0 };
+    time_t modification_time { 0 };
+
+    bool operator==(FileIdentity const&) const = default;
+};
+
+struct CacheEntry {
+    FileIdentity identity;
+    OwnPtr<CachedELF> cached_elf;
+};
+
+static HashMap<String, CacheEntry> s_cache;
+static Threading::Mutex s_cache_lock;
+
+// Fewer addresses than this aren't worth handing to the thread pool.
+static constexpr size_t min_addresses_for_thread_pool = 32;
 
 enum class KernelBaseState {
     Uninitialized,
@@ -58,35 +83,50 @@ Optional<FlatPtr> kernel_base()
     return s_kernel_base;
 }
 
-Optional<Symbol> symbolicate(String const& path, FlatPtr address)
+// Must be called with s_cache_lock held.
+static CachedELF* cached_elf_for(String const& path)
 {
-    if (!s_cache.contains(path)) {
-        auto mapped_file = MappedFile::map(path);
-        if (mapped_file.is_error()) {
-            dbgln("Failed to map {}: {}", path, mapped_file.error().string());
-            s_cache.set(path, {});
-            return {};
-        }
-        auto elf = make<ELF::Image>(mapped_file.value()->bytes());
-        if (!elf->is_valid()) {
-            dbgln("ELF not valid: {}", path);
-            s_cache.set(path, {});
-            {};
-        }
-        auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(move(elf)));
-        s_cache.set(path, move(cached_elf));
+    struct stat st;
+    if (stat(path.characters(), &st) < 0) {
+        s_cache.remove(path);
+        return nullptr;
     }
+    FileIdentity identity { st.st_dev, st.st_ino, st.st_mtime };
+    if (auto it = s_cache.find(path); it != s_cache.end() && it->value.identity == identity)
+        return it->value.cached_elf.ptr();
+
+    auto mapped_file = MappedFile::map(path);
+    if (mapped_file.is_error()) {
+        dbgln("Failed to map {}: {}", path, mapped_file.error().string());
+        s_cache.set(path, { identity, {} });
+        return nullptr;
+    }
+    auto elf = make<ELF::Image>(mapped_file.value()->bytes());
+    if (!elf->is_valid()) {
+        dbgln("ELF not valid: {}", path);
+        s_cache.set(path, { identity, {} });
+        return nullptr;
+    }
+    auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(move(elf)), HashMap<FlatPtr, Symbol> {});
 
-    auto it = s_cache.find(path);
-    VERIFY(it != s_cache.end());
-    auto& cached_elf = it->value;
+    // The lookups run on several threads at once, so build the tables that are otherwise built on first use now.
+    (void)cached_elf->debug_info->elf().find_symbol(0);
+    (void)cached_elf->debug_info->elf().lookup_section({});
+    (void)cached_elf->debug_info->get_source_position_with_inlines(0);
 
-    if (!cached_elf)
-        return {};
+    auto* cached_elf_ptr = cached_elf.ptr();
+    s_cache.set(path, { identity, move(cached_elf) });
+    return cached_elf_ptr;
+}
 
+// Only reads from the CachedELF, so any number of these can run at once.
+static Symbol look_up_symbol(CachedELF const& cached_elf, FlatPtr address)
+{
     u32 offset = 0;
-    auto symbol = cached_elf->debug_info->elf().symbolicate(address, &offset);
-    auto source_position_with_inlines = cached_elf->debug_info->get_source_position_with_inlines(address);
+    String name = "??";
+    if (auto symbol = cached_elf.debug_info->elf().find_symbol(address, &offset); symbol.has_value())
+        name = demangle(symbol->name());
+    auto source_position_with_inlines = cached_elf.debug_info->get_source_position_with_inlines(address);
 
     Vector<Debug::DebugInfo::SourcePosition> positions;
     for (auto& position : source_position_with_inlines.inline_chain) {
@@ -100,12 +140,55 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address)
 
     return Symbol {
         .address = address,
-        .name = move(symbol),
+        .name = move(name),
         .offset = offset,
         .source_positions = move(positions),
     };
 }
 
+Optional<Symbol> symbolicate(String const& path, FlatPtr address)
+{
+    return symbolicate(path, Span<FlatPtr const> { &address, 1 }).first();
+}
+
+Vector<Optional<Symbol>> symbolicate(String const& path, Span<FlatPtr const> addresses)
+{
+    Threading::MutexLocker locker(s_cache_lock);
+
+    Vector<Optional<Symbol>> symbols;
+    symbols.resize(addresses.size());
+    auto* cached_elf = cached_elf_for(path);
+    if (!cached_elf)
+        return symbols;
+
+    struct Lookup {
+        FlatPtr address { 0 };
+        Symbol symbol;
+    };
+    Vector<Lookup> lookups;
+    HashTable<FlatPtr> addresses_to_look_up;
+    for (auto address : addresses) {
+        if (!cached_elf->symbols.contains(address) && addresses_to_look_up.set(address) == AK::HashSetResult::InsertedNewEntry)
+            lookups.append({ address, {} });
+    }
+
+    auto look_up = [&](Lookup& lookup) {
+        lookup.symbol = look_up_symbol(*cached_elf, lookup.address);
+    };
+    if (lookups.size() >= min_addresses_for_thread_pool) {
+        Threading::ThreadPool::the().parallel_for(lookups.span(), look_up);
+    } else {
+        for (auto& lookup : lookups)
+            look_up(lookup);
+    }
+
+    for (auto& lookup : lookups)
+        cached_elf->symbols.set(lookup.address, move(lookup.symbol));
+    for (size_t i = 0; i < addresses.size(); ++i)
+        symbols[i] = cached_elf->symbols.get(addresses[i]);
+    return symbols;
+}
+
 Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
 {
     struct RegionWithSymbols {
@@ -185,7 +268,14 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
         }
     }
 
-    Vector<Symbol> symbols;
+    // Look up all the frames within the same ELF at once.
+    struct Frame {
+        FlatPtr address { 0 };
+        const RegionWithSymbols* region { nullptr };
+        size_t index_in_path { 0 };
+    };
+    Vector<Frame> frames;
+    HashMap<String, Vector<FlatPtr>> addresses_by_path;
     bool first_frame = true;
 
     for (auto address : stack) {
@@ -207,24 +297,35 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
             continue;
         }
 
-        FlatPtr adjusted_address = address - found_region->base;
-
         // We're subtracting 1 from the address because this is the return address,
         // i.e. it is one instruction past the call instruction.
         // However, because the first frame represents the current
         // instruction pointer rather than the return address we don't
         // subtract 1 for that.
-        auto result = symbolicate(found_region->path, adjusted_address - (first_frame ? 0 : 1));
+        FlatPtr adjusted_address = address - found_region->base - (first_frame ? 0 : 1);
         first_frame = false;
+        auto& addresses = addresses_by_path.ensure(found_region->path);
+        frames.append({ address, found_region, addresses.size() });
+        addresses.append(adjusted_address);
+    }
+
+    HashMap<String, Vector<Optional<Symbol>>> symbols_by_path;
+    for (auto& it : addresses_by_path)
+        symbols_by_path.set(it.key, symbolicate(it.key, it.value.span()));
+
+    Vector<Symbol> symbols;
+    symbols.ensure_capacity(frames.size());
+    for (auto& frame : frames) {
+        auto& result = symbols_by_path.find(frame.region->path)->value[frame.index_in_path];
         if (!result.has_value()) {
             symbols.append(Symbol {
-                .address = address,
+                .address = frame.address,
                 .source_positions = {},
             });
             continue;
         }
 
-        symbols.append(result.value());
+        symbols.append(result.release_value());
     }
     return symbols;
 }
@@ -21,5 +21,8 @@ struct Symbol {
 Optional<FlatPtr> kernel_base();
 Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid);
 Optional<Symbol> symbolicate(String const& path, FlatPtr address);
+// Looks up many addresses within the same ELF at once, on the thread pool if there are enough of them, so the caller
+// needs the "thread" promise. The symbols come back in the order of the addresses.
+Vector<Optional<Symbol>> symbolicate(String const& path, Span<FlatPtr const> addresses);
 
 }
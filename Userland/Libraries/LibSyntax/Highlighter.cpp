@@ -105,6 +105,103 @@ void Highlighter::highlight_matching_token_pair()
     }
 }
 
+void Highlighter::lex_changed_text(Function<void(StringView text, SpanCallback const& on_span)> const& lex)
+{
+    auto& old_spans = m_client->spans();
+
+    // The spans that are kept mustn't hold on to the highlighting of the matching token pair.
+    if (m_has_brace_buddies) {
+        for (auto& buddy : m_brace_buddies) {
+            if (buddy.index >= 0 && buddy.index < static_cast<int>(old_spans.size()))
+                old_spans[buddy.index].attributes = buddy.span_backup.attributes;
+        }
+        m_has_brace_buddies = false;
+    }
+
+    auto changed_range = m_client->get_changed_range();
+    if (!changed_range.has_value() || old_spans.is_empty()) {
+        lex_text_from_line(0, 0, {}, lex);
+        return;
+    }
+    changed_range = changed_range->normalized();
+
+    // Up to the change, the lexer sees the same text as before, so it should be back where it was before at the start of a
+    // token that starts a line before the one with the change. Some lexers carry state across lines (like a string with
+    // a newline in it) though, so the tokens up to the change have to turn out the same to be sure.
+    size_t spans_before_change = 0;
+    size_t high = old_spans.size();
+    while (spans_before_change < high) {
+        size_t middle = spans_before_change + (high - spans_before_change) / 2;
+        if (changed_range->start() < old_spans[middle].range.start())
+            high = middle;
+        else
+            spans_before_change = middle + 1;
+    }
+    while (spans_before_change > 0) {
+        auto& start = old_spans[spans_before_change - 1].range.start();
+        if (start.column() == 0 && start.line() < changed_range->start().line())
+            break;
+        --spans_before_change;
+    }
+    if (spans_before_change > 0) {
+        size_t first_new_span = spans_before_change - 1;
+        while (first_new_span > 0 && old_spans[first_new_span - 1].range.start() == old_spans[first_new_span].range.start())
+            --first_new_span;
+        if (lex_text_from_line(old_spans[first_new_span].range.start().line(), first_new_span, changed_range, lex))
+            return;
+    }
+    lex_text_from_line(0, 0, changed_range, lex);
+}
+
+bool Highlighter::lex_text_from_line(size_t start_line, size_t first_new_span, Optional<GUI::TextRange> const& changed_range, Function<void(StringView text, SpanCallback const& on_span)> const& lex)
+{
+    auto& old_spans = m_client->spans();
+    auto& document = m_client->get_document();
+    auto text = start_line == 0 ? m_client->get_text() : document.text_in_range({ { start_line, 0 }, { document.line_count() - 1, document.line(document.line_count() - 1).length() } });
+
+    auto same_as_old_span = [&](size_t index, GUI::TextDocumentSpan const& span) {
+        return index < old_spans.size() && old_spans[index].range == span.range && old_spans[index].data == span.data;
+    };
+
+    Vector<GUI::TextDocumentSpan> spans;
+    spans.append(old_spans.data(), first_new_span);
+    size_t old_span_index = first_new_span;
+    Optional<size_t> resync_line;
+    bool lexer_was_out_of_step = false;
+    lex(text, [&](GUI::TextDocumentSpan span) {
+        span.range.start().set_line(span.range.start().line() + start_line);
+        span.range.end().set_line(span.range.end().line() + start_line);
+
+        if (changed_range.has_value() && span.range.end() < changed_range->start()) {
+            if (start_line != 0 && !same_as_old_span(old_span_index++, span)) {
+                lexer_was_out_of_step = true;
+                return IterationDecision::Break;
+            }
+        } else if (changed_range.has_value() && changed_range->end().line() < span.range.start().line()) {
+            // Once the tokens of a whole line after the change are the same as before, the lexer is back in step and
+            // the rest is the same as well.
+            while (old_span_index < old_spans.size() && old_spans[old_span_index].range.start() < span.range.start())
+                ++old_span_index;
+            if (resync_line.has_value() && span.range.start().line() > *resync_line && same_as_old_span(old_span_index, span)) {
+                spans.append(old_spans.data() + old_span_index, old_spans.size() - old_span_index);
+                return IterationDecision::Break;
+            }
+            if (!same_as_old_span(old_span_index, span))
+                resync_line = {};
+            else if (!resync_line.has_value() && span.range.start().column() == 0)
+                resync_line = span.range.start().line();
+        }
+
+        spans.append(move(span));
+        return IterationDecision::Continue;
+    });
+    if (lexer_was_out_of_step)
+        return false;
+
+    m_client->do_set_spans(move(spans));
+    return true;
+}
+
 void Highlighter::attach(HighlighterClient& client)
 {
     VERIFY(!m_client);
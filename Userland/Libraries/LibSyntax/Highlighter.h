@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
 #include <AK/Noncopyable.h>
 #include <AK/WeakPtr.h>
 #include <LibGUI/TextDocument.h>
@@ -62,6 +64,13 @@ protected:
 
     virtual Vector<MatchingTokenPair> matching_token_pairs_impl() const = 0;
     virtual bool token_types_equal(u64, u64) const = 0;
+
+    // For highlighters whose lexer carries little from one line to the next, other than where it is.
+    // Only lexes from the last token that started a line before the text that changed, up to where a line of tokens lines
+    // up with the ones from before again, and keeps the spans of everything else. `lex` is handed the text to lex, and has
+    // to call `on_span` for each token (with positions relative to that text) until it returns IterationDecision::Break.
+    using SpanCallback = Function<IterationDecision(GUI::TextDocumentSpan)>;
+    void lex_changed_text(Function<void(StringView text, SpanCallback const& on_span)> const& lex);
     void register_nested_token_pairs(Vector<MatchingTokenPair>);
     void clear_nested_token_pairs() { m_nested_token_pairs.clear(); }
     size_t first_free_token_kind_serial_value() const { return m_nested_token_pairs.size(); }
@@ -74,6 +83,10 @@ protected:
     bool m_has_brace_buddies { false };
     BuddySpan m_brace_buddies[2];
     HashTable<MatchingTokenPair> m_nested_token_pairs;
+
+private:
+    // Returns false if the lexer didn't get to the change in step with the old spans, in which case nothing was set.
+    bool lex_text_from_line(size_t start_line, size_t first_new_span, Optional<GUI::TextRange> const& changed_range, Function<void(StringView text, SpanCallback const& on_span)> const& lex);
 };
 
 class ProxyHighlighterClient final : public Syntax::HighlighterClient {
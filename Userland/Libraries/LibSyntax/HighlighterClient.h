@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <LibGUI/Forward.h>
+#include <LibGUI/TextRange.h>
 
 namespace Syntax {
 
@@ -23,6 +25,8 @@ public:
     virtual GUI::TextDocument& highlighter_did_request_document() = 0;
     virtual GUI::TextPosition highlighter_did_request_cursor() const = 0;
     virtual void highlighter_did_set_spans(Vector<GUI::TextDocumentSpan>) = 0;
+    // The part of the text that changed since the spans were last set, if that's known.
+    virtual Optional<GUI::TextRange> highlighter_did_request_changed_range() const { return {}; }
 
     void do_set_spans(Vector<GUI::TextDocumentSpan> spans) { highlighter_did_set_spans(move(spans)); }
     void do_update() { highlighter_did_request_update(); }
@@ -30,6 +34,7 @@ public:
     String get_text() const { return highlighter_did_request_text(); }
     GUI::TextDocument& get_document() { return highlighter_did_request_document(); }
     GUI::TextPosition get_cursor() const { return highlighter_did_request_cursor(); }
+    Optional<GUI::TextRange> get_changed_range() const { return highlighter_did_request_changed_range(); }
 };
 
 }
@@ -24,7 +24,17 @@ constexpr static Array<int, 7>
     rsa_md5_encryption_oid { 1, 2, 840, 113549, 1, 1, 4 },
     rsa_sha1_encryption_oid { 1, 2, 840, 113549, 1, 1, 5 },
     rsa_sha256_encryption_oid { 1, 2, 840, 113549, 1, 1, 11 },
-    rsa_sha512_encryption_oid { 1, 2, 840, 113549, 1, 1, 13 };
+    rsa_sha512_encryption_oid { 1, 2, 840, 113549, 1, 1, 13 },
+    ecdsa_with_sha256_oid { 1, 2, 840, 10045, 4, 3, 2 },
+    ecdsa_with_sha384_oid { 1, 2, 840, 10045, 4, 3, 3 },
+    ecdsa_with_sha512_oid { 1, 2, 840, 10045, 4, 3, 4 },
+    secp256r1_oid { 1, 2, 840, 10045, 3, 1, 7 };
+
+constexpr static Array<int, 6>
+    ec_public_key_oid { 1, 2, 840, 10045, 2, 1 };
+
+constexpr static Array<int, 5>
+    secp384r1_oid { 1, 3, 132, 0, 34 };
 
 constexpr static Array<int, 4>
     subject_alternative_name_oid { 2, 5, 29, 17 };
@@ -153,7 +163,23 @@ Optional<Certificate> Certificate::parse_asn1(ReadonlyBytes buffer, bool)
             field = CertificateKeyAlgorithm ::RSA_SHA256;
         else if (identifier == rsa_sha512_encryption_oid)
             field = CertificateKeyAlgorithm ::RSA_SHA512;
-        else
+        else if (identifier == ecdsa_with_sha256_oid)
+            field = CertificateKeyAlgorithm ::ECDSA_SHA256;
+        else if (identifier == ecdsa_with_sha384_oid)
+            field = CertificateKeyAlgorithm ::ECDSA_SHA384;
+        else if (identifier == ecdsa_with_sha512_oid)
+            field = CertificateKeyAlgorithm ::ECDSA_SHA512;
+        else if (identifier == ec_public_key_oid) {
+            // ECParameters ::= Choice { namedCurve ObjectIdentifier, ... } (RFC 5480 section 2.1.1)
+            field = CertificateKeyAlgorithm ::EC_PUBLIC_KEY;
+            READ_OBJECT_OR_FAIL(ObjectIdentifier, Vector<int>, curve, "AlgorithmIdentifier::parameters");
+            if (curve == secp256r1_oid)
+                certificate.ec_algorithm = CertificateKeyAlgorithm ::EC_SECP256R1;
+            else if (curve == secp384r1_oid)
+                certificate.ec_algorithm = CertificateKeyAlgorithm ::EC_SECP384R1;
+            else
+                return {};
+        } else
             return {};
 
         EXIT_SCOPE("AlgorithmIdentifier");
@@ -299,13 +325,17 @@ Optional<Certificate> Certificate::parse_asn1(ReadonlyBytes buffer, bool)
             return {};
 
         READ_OBJECT_OR_FAIL(BitString, const BitmapView, value, "Certificate::TBSCertificate::subject_public_key_info::subject_public_key_info");
-        // Note: Once we support other kinds of keys, make sure to check the kind here!
-        auto key = Crypto::PK::RSA::parse_rsa_key({ value.data(), value.size_in_bytes() });
-        if (!key.public_key.length()) {
-            dbgln_if(TLS_DEBUG, "Certificate::TBSCertificate::subject_public_key_info::subject_public_key_info: Invalid key");
-            return {};
+        if (certificate.key_algorithm == CertificateKeyAlgorithm::EC_PUBLIC_KEY) {
+            // The subject_public_key of an EC key is the SEC1-encoded point itself.
+            certificate.ec_public_key = ByteBuffer::copy(value.data(), value.size_in_bytes());
+        } else {
+            auto key = Crypto::PK::RSA::parse_rsa_key({ value.data(), value.size_in_bytes() });
+            if (!key.public_key.length()) {
+                dbgln_if(TLS_DEBUG, "Certificate::TBSCertificate::subject_public_key_info::subject_public_key_info: Invalid key");
+                return {};
+            }
+            certificate.public_key = move(key.public_key);
         }
-        certificate.public_key = move(key.public_key);
         EXIT_SCOPE("Certificate::TBSCertificate::subject_public_key_info");
     }
 
@@ -24,6 +24,12 @@ enum class CertificateKeyAlgorithm {
     RSA_SHA1 = 0x05,
     RSA_SHA256 = 0x0b,
     RSA_SHA512 = 0x0d,
+    ECDSA_SHA256 = 0x12,
+    ECDSA_SHA384 = 0x13,
+    ECDSA_SHA512 = 0x14,
+    EC_PUBLIC_KEY = 0x20,
+    EC_SECP256R1 = 0x21,
+    EC_SECP384R1 = 0x22,
 };
 
 class Certificate {
@@ -35,6 +41,8 @@ public:
     ByteBuffer exponent {};
     Crypto::PK::RSAPublicKey<Crypto::UnsignedBigInteger> public_key {};
     Crypto::PK::RSAPrivateKey<Crypto::UnsignedBigInteger> private_key {};
+    // Uncompressed SEC1 point when key_algorithm is EC_PUBLIC_KEY; ec_algorithm names the curve.
+    ByteBuffer ec_public_key {};
     struct Name {
         String country;
         String state;
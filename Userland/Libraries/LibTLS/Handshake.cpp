@@ -34,27 +34,32 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    if (m_context.resumable_session.has_value()) {
+        auto& session = m_context.resumable_session.value();
+        if (!session.session_id.is_empty()) {
+            m_context.session_id_size = min(session.session_id.size(), sizeof(m_context.session_id));
+            memcpy(m_context.session_id, session.session_id.data(), m_context.session_id_size);
+        } else {
+            // RFC 5077 section 3.4: Offer a fresh session ID along with the ticket,
+            // the server echoes it back if it accepts the ticket.
+            m_context.session_id_size = sizeof(m_context.session_id);
+            fill_with_random(m_context.session_id, m_context.session_id_size);
+        }
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
 
     size_t extension_length = 0;
     size_t alpn_length = 0;
-    size_t alpn_negotiated_length = 0;
 
-    // ALPN
-    if (!m_context.negotiated_alpn.is_null()) {
-        alpn_negotiated_length = m_context.negotiated_alpn.length();
-        alpn_length = alpn_negotiated_length + 1;
+    // ALPN: each protocol name is prefixed with its length
+    for (auto& alpn : m_context.alpn)
+        alpn_length += alpn.length() + 1;
+    // 2b extension ID, 2b extension length, 2b list length, the list
+    if (alpn_length)
         extension_length += alpn_length + 6;
-    } else if (m_context.alpn.size()) {
-        for (auto& alpn : m_context.alpn) {
-            size_t length = alpn.length();
-            alpn_length += length + 1;
-        }
-        if (alpn_length)
-            extension_length += alpn_length + 6;
-    }
 
     // Ciphers
     builder.append((u16)(m_context.options.usable_cipher_suites.size() * sizeof(u16)));
@@ -74,6 +79,19 @@ ByteBuffer TLSv12::build_hello()
     // signature_algorithms: 2b extension ID, 2b extension length, 2b vector length, 2xN signatures and hashes
     extension_length += 2 + 2 + 2 + 2 * m_context.options.supported_signature_algorithms.size();
 
+    // supported_groups: 2b extension ID, 2b extension length, 2b vector length, 2xN curves
+    // ec_point_formats: 2b extension ID, 2b extension length, 1b vector length, 1b format
+    auto curve_count = m_context.options.elliptic_curves.size();
+    if (curve_count)
+        extension_length += 2 + 2 + 2 + 2 * curve_count + 2 + 2 + 1 + 1;
+
+    // session_ticket: 2b extension ID, 2b extension length, the ticket (empty to ask for one)
+    ReadonlyBytes ticket;
+    if (m_context.resumable_session.has_value())
+        ticket = m_context.resumable_session->ticket;
+    if (m_context.options.use_session_tickets)
+        extension_length += 2 + 2 + ticket.size();
+
     if (sni_length)
         extension_length += sni_length + 9;
 
@@ -105,9 +123,38 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u8)entry.signature);
     }
 
+    if (curve_count) {
+        // supported_groups extension
+        builder.append((u16)HandshakeExtension::SupportedGroups);
+        builder.append((u16)(2 + 2 * curve_count));
+        builder.append((u16)(2 * curve_count));
+        for (auto curve : m_context.options.elliptic_curves)
+            builder.append((u16)curve);
+
+        // ec_point_formats extension
+        builder.append((u16)HandshakeExtension::ECPointFormats);
+        builder.append((u16)2);
+        builder.append((u8)1);
+        builder.append((u8)ECPointFormat::Uncompressed);
+    }
+
+    if (m_context.options.use_session_tickets) {
+        // session_ticket extension
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)ticket.size());
+        if (!ticket.is_empty())
+            builder.append(ticket);
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        builder.append((u16)(alpn_length + 2));
+        builder.append((u16)alpn_length);
+        for (auto& alpn : m_context.alpn) {
+            builder.append((u8)alpn.length());
+            builder.append((const u8*)alpn.characters(), alpn.length());
+        }
     }
 
     // set the "length" field of the packet
@@ -202,6 +249,15 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    if (m_context.is_resuming) {
+        // In an abbreviated handshake the server finishes first, so we still owe it our Finished.
+        // Application data has to wait until that has been written.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    remember_session();
+
     if (on_tls_ready_to_write)
         on_tls_ready_to_write(*this);
 
@@ -387,6 +443,16 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 payload_res = (i8)Error::UnexpectedMessage;
             }
             break;
+        case NewSessionTicket:
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            break;
         case Finished:
             m_context.cached_handshake.clear();
             if (m_context.handshake_messages[10] >= 1) {
@@ -433,6 +499,11 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
                 break;
             }
+            case Error::NotSafe: {
+                auto packet = build_alert(true, (u8)AlertDescription::HandshakeFailure);
+                write_packet(packet);
+                break;
+            }
             case Error::BadCertificate: {
                 auto packet = build_alert(true, (u8)AlertDescription::BadCertificate);
                 write_packet(packet);
@@ -523,6 +594,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
             }
             m_context.connection_status = ConnectionStatus::Established;
+            remember_session();
+            if (on_tls_ready_to_write)
+                on_tls_ready_to_write(*this);
             break;
         }
         payload_size++;
@@ -7,6 +7,8 @@
 #include <AK/Debug.h>
 #include <AK/Random.h>
 #include <LibCrypto/ASN1/DER.h>
+#include <LibCrypto/Curves/SECP256r1.h>
+#include <LibCrypto/Curves/X25519.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibTLS/TLSv12.h>
 
@@ -224,6 +226,47 @@ void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
     builder.append(outbuf);
 }
 
+void TLSv12::build_ecdhe_pre_master_secret(PacketBuilder& builder)
+{
+    OwnPtr<Crypto::Curves::EllipticCurve> curve;
+    switch (m_context.server_key_exchange_curve) {
+    case NamedCurve::x25519:
+        curve = make<Crypto::Curves::X25519>();
+        break;
+    case NamedCurve::secp256r1:
+        curve = make<Crypto::Curves::SECP256r1>();
+        break;
+    default:
+        dbgln("No usable server key exchange parameters for ECDHE");
+        alert(AlertLevel::Critical, AlertDescription::HandshakeFailure);
+        return;
+    }
+
+    auto private_key = curve->generate_private_key();
+    auto public_key = curve->generate_public_key(private_key);
+    m_context.premaster_key = curve->compute_coordinate(private_key, m_context.server_key_exchange_public_key);
+    if (public_key.is_empty() || m_context.premaster_key.is_empty()) {
+        dbgln("ECDHE key agreement failed");
+        alert(AlertLevel::Critical, AlertDescription::IllegalParameter);
+        return;
+    }
+
+    if constexpr (TLS_DEBUG) {
+        dbgln("PreMaster secret");
+        print_buffer(m_context.premaster_key);
+    }
+
+    if (!compute_master_secret_from_pre_master_secret(48)) {
+        dbgln("oh noes we could not derive a master key :(");
+        return;
+    }
+
+    // RFC 8422 section 5.7: ClientECDiffieHellmanPublic is a single opaque point <1..2^8-1>.
+    builder.append_u24(public_key.size() + 1);
+    builder.append((u8)public_key.size());
+    builder.append(public_key.bytes());
+}
+
 ByteBuffer TLSv12::build_certificate()
 {
     PacketBuilder builder { MessageType::Handshake, m_context.options.version };
@@ -304,11 +347,13 @@ ByteBuffer TLSv12::build_client_key_exchange()
         TODO();
         break;
     case KeyExchangeAlgorithm::ECDHE_RSA:
+    case KeyExchangeAlgorithm::ECDHE_ECDSA:
+        build_ecdhe_pre_master_secret(builder);
+        break;
     case KeyExchangeAlgorithm::ECDH_ECDSA:
     case KeyExchangeAlgorithm::ECDH_RSA:
-    case KeyExchangeAlgorithm::ECDHE_ECDSA:
     case KeyExchangeAlgorithm::ECDH_anon:
-        dbgln("Client key exchange for ECDHE algorithms is not implemented");
+        dbgln("Client key exchange for ECDH algorithms is not implemented");
         TODO();
         break;
     default:
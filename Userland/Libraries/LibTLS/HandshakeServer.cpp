@@ -10,6 +10,7 @@
 
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
+#include <LibCrypto/Curves/SECP256r1.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibTLS/TLSv12.h>
 
@@ -55,6 +56,12 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // An echo of the session ID we offered means the server agreed to resume that session.
+    bool session_id_echoed = m_context.resumable_session.has_value()
+        && session_length
+        && session_length == m_context.session_id_size
+        && !memcmp(m_context.session_id, buffer.offset_pointer(res), session_length);
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -78,6 +85,10 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
+    if (session_id_echoed && cipher != m_context.resumable_session->cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        return (i8)Error::NotSafe;
+    }
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
@@ -98,6 +109,13 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         write_packets = WritePacketStage::ServerHandshake;
     }
 
+    if (session_id_echoed) {
+        resume_session();
+    } else {
+        // Full handshake; whatever we offered is gone.
+        m_context.resumable_session.clear();
+    }
+
     // Presence of extensions is determined by availability of bytes after compression_method
     if (buffer.size() - res >= 2) {
         auto extensions_bytes_total = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res += 2)));
@@ -144,33 +162,27 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 dbgln("SNI host_name: {}", m_context.extensions.SNI);
             }
         } else if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size()) {
-            if (buffer.size() - res > 2) {
-                auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
-                    const u8* alpn = buffer.offset_pointer(res + 2);
-                    size_t alpn_position = 0;
-                    while (alpn_position < alpn_length) {
-                        u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
-                            break;
-                        String alpn_str { (const char*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
-                            break;
-                        }
-                        alpn_position += alpn_length;
-                        if (!m_context.is_server) // server hello must contain one ALPN
-                            break;
-                    }
-                }
-            }
+            // RFC 7301 section 3.1: The server's list contains exactly one of the protocols we offered.
+            if (extension_length < 3)
+                return (i8)Error::BrokenPacket;
+            auto alpn_list_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+            u8 alpn_size = buffer[res + 2];
+            if (alpn_list_length != extension_length - 2 || alpn_size + 1 != alpn_list_length)
+                return (i8)Error::BrokenPacket;
+            String alpn { (const char*)buffer.offset_pointer(res + 3), alpn_size };
+            if (!m_context.alpn.contains_slow(alpn))
+                return (i8)Error::NotUnderstood;
+            m_context.negotiated_alpn = move(alpn);
+            dbgln_if(TLS_DEBUG, "Negotiated ALPN: {}", m_context.negotiated_alpn);
             res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
             print_buffer(buffer.slice(res, extension_length));
             res += extension_length;
             // FIXME: what are we supposed to do here?
+        } else if (extension_type == HandshakeExtension::ECPointFormats) {
+            // RFC 8422 section 5.2: We only offer uncompressed points, which servers must support.
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", (u16)extension_type, extension_length);
             res += extension_length;
@@ -180,6 +192,42 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
     return res;
 }
 
+void TLSv12::resume_session()
+{
+    // RFC 5246 section 7.3: An abbreviated handshake reuses the master secret and skips
+    // the certificate and key exchange messages; the server goes straight to ChangeCipherSpec.
+    auto& session = m_context.resumable_session.value();
+    dbgln_if(TLS_DEBUG, "Resuming session");
+    m_context.is_resuming = true;
+    m_context.master_key = session.master_key;
+    m_context.certificates = session.certificates;
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    expand_key();
+}
+
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // RFC 5077 section 3.3:
+    // struct {
+    //     uint32 ticket_lifetime_hint;
+    //     opaque ticket<0..2^16-1>;
+    // } NewSessionTicket;
+    if (buffer.size() < 3 + 6)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size || size < 6)
+        return (i8)Error::BrokenPacket;
+
+    m_context.session_ticket_lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (size - 6 < ticket_length)
+        return (i8)Error::BrokenPacket;
+
+    m_context.session_ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    return size + 3;
+}
+
 ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
 {
     if (buffer.size() < 3)
@@ -199,7 +247,7 @@ ByteBuffer TLSv12::build_server_key_exchange()
     return {};
 }
 
-ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
+ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes buffer)
 {
     switch (get_key_exchange_algorithm(m_context.cipher)) {
     case KeyExchangeAlgorithm::RSA:
@@ -222,11 +270,12 @@ ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
         TODO();
         break;
     case KeyExchangeAlgorithm::ECDHE_RSA:
+    case KeyExchangeAlgorithm::ECDHE_ECDSA:
+        return handle_ecdhe_server_key_exchange(buffer);
     case KeyExchangeAlgorithm::ECDH_ECDSA:
     case KeyExchangeAlgorithm::ECDH_RSA:
-    case KeyExchangeAlgorithm::ECDHE_ECDSA:
     case KeyExchangeAlgorithm::ECDH_anon:
-        dbgln("Server key exchange for ECDHE algorithms is not implemented");
+        dbgln("Server key exchange for ECDH algorithms is not implemented");
         TODO();
         break;
     default:
@@ -237,4 +286,160 @@ ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
     return 0;
 }
 
+ssize_t TLSv12::handle_ecdhe_server_key_exchange(ReadonlyBytes buffer)
+{
+    // RFC 8422 section 5.4:
+    // struct {
+    //     ECParameters curve_params; // curve_type (1 byte) + named_curve (2 bytes)
+    //     ECPoint public;            // opaque point <1..2^8-1>
+    // } ServerECDHParams;
+    // followed by a digitally-signed hash of client_random + server_random + ServerECDHParams.
+    if (buffer.size() < 3 + 4)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto params_start = 3;
+    auto res = params_start;
+    if ((ECCurveType)buffer[res++] != ECCurveType::NamedCurve) {
+        dbgln("Server key exchange: unsupported curve type {}", buffer[res - 1]);
+        return (i8)Error::NotUnderstood;
+    }
+
+    auto curve = (NamedCurve)AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+    res += 2;
+    if (!m_context.options.elliptic_curves.contains_slow(curve)) {
+        dbgln("Server key exchange: server picked a curve we did not offer ({})", (u16)curve);
+        return (i8)Error::NotSafe;
+    }
+
+    u8 public_key_length = buffer[res++];
+    if (buffer.size() - res < public_key_length + 4u)
+        return (i8)Error::BrokenPacket;
+    auto public_key = buffer.slice(res, public_key_length);
+    res += public_key_length;
+    auto params = buffer.slice(params_start, res - params_start);
+
+    SignatureAndHashAlgorithm signature_algorithm {
+        (HashAlgorithm)buffer[res],
+        (SignatureAlgorithm)buffer[res + 1],
+    };
+    res += 2;
+    u16 signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+    res += 2;
+    if (buffer.size() - res < signature_length)
+        return (i8)Error::BrokenPacket;
+    auto signature = buffer.slice(res, signature_length);
+    res += signature_length;
+
+    if (signature_algorithm.signature != signature_for_key_exchange_algorithm(get_key_exchange_algorithm(m_context.cipher))) {
+        dbgln("Server key exchange: signature algorithm does not match the cipher suite");
+        return (i8)Error::NotSafe;
+    }
+
+    if (!verify_server_key_exchange_signature(params, signature_algorithm, signature)) {
+        dbgln("Server key exchange: signature verification failed");
+        return (i8)Error::NotVerified;
+    }
+
+    m_context.server_key_exchange_curve = curve;
+    m_context.server_key_exchange_public_key = ByteBuffer::copy(public_key);
+    return res;
+}
+
+static Optional<Crypto::Hash::HashKind> hash_kind_for(HashAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case HashAlgorithm::SHA1:
+        return Crypto::Hash::HashKind::SHA1;
+    case HashAlgorithm::SHA256:
+        return Crypto::Hash::HashKind::SHA256;
+    case HashAlgorithm::SHA384:
+        return Crypto::Hash::HashKind::SHA384;
+    case HashAlgorithm::SHA512:
+        return Crypto::Hash::HashKind::SHA512;
+    default:
+        return {};
+    }
+}
+
+// RFC 8017 section 9.2: The DER-encoded DigestInfo prefix that precedes the hash in EMSA-PKCS1-v1_5.
+static ReadonlyBytes digest_info_prefix_for(HashAlgorithm algorithm)
+{
+    static constexpr u8 sha1_prefix[] = { 0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2b, 0x0e, 0x03, 0x02, 0x1a, 0x05, 0x00, 0x04, 0x14 };
+    static constexpr u8 sha256_prefix[] = { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20 };
+    static constexpr u8 sha384_prefix[] = { 0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30 };
+    static constexpr u8 sha512_prefix[] = { 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40 };
+    switch (algorithm) {
+    case HashAlgorithm::SHA1:
+        return { sha1_prefix, sizeof(sha1_prefix) };
+    case HashAlgorithm::SHA256:
+        return { sha256_prefix, sizeof(sha256_prefix) };
+    case HashAlgorithm::SHA384:
+        return { sha384_prefix, sizeof(sha384_prefix) };
+    case HashAlgorithm::SHA512:
+        return { sha512_prefix, sizeof(sha512_prefix) };
+    default:
+        return {};
+    }
+}
+
+bool TLSv12::verify_server_key_exchange_signature(ReadonlyBytes params, SignatureAndHashAlgorithm algorithm, ReadonlyBytes signature) const
+{
+    auto hash_kind = hash_kind_for(algorithm.hash);
+    if (!hash_kind.has_value())
+        return false;
+
+    Crypto::Hash::Manager hash { hash_kind.value() };
+    hash.update(m_context.local_random, sizeof(m_context.local_random));
+    hash.update(m_context.remote_random, sizeof(m_context.remote_random));
+    hash.update(params);
+    auto digest = hash.digest();
+    ReadonlyBytes digest_bytes { digest.immutable_data(), hash.digest_size() };
+
+    auto certificate_index = verify_chain_and_get_matching_certificate(m_context.extensions.SNI);
+    if (!certificate_index.has_value()) {
+        dbgln("certificate verification failed :(");
+        return false;
+    }
+    auto& certificate = m_context.certificates[certificate_index.value()];
+
+    if (algorithm.signature == SignatureAlgorithm::ECDSA) {
+        if (certificate.key_algorithm != CertificateKeyAlgorithm::EC_PUBLIC_KEY || certificate.ec_algorithm != CertificateKeyAlgorithm::EC_SECP256R1) {
+            dbgln("Server key exchange: certificate does not hold a P-256 key");
+            return false;
+        }
+        return Crypto::Curves::SECP256r1::verify(digest_bytes, certificate.ec_public_key, signature);
+    }
+
+    if (algorithm.signature != SignatureAlgorithm::RSA || certificate.key_algorithm != CertificateKeyAlgorithm::RSA_RSA)
+        return false;
+
+    // EMSA-PKCS1-v1_5: 0x00 || 0x01 || 0xff... || 0x00 || DigestInfo prefix || hash
+    auto modulus_size = certificate.public_key.length();
+    auto prefix = digest_info_prefix_for(algorithm.hash);
+    if (signature.size() != modulus_size || modulus_size < prefix.size() + digest_bytes.size() + 11)
+        return false;
+
+    Crypto::PK::RSA rsa(certificate.public_key.modulus(), 0, certificate.public_key.public_exponent());
+    auto decrypted_buffer = ByteBuffer::create_zeroed(modulus_size);
+    auto decrypted = decrypted_buffer.bytes();
+    rsa.verify(signature, decrypted);
+    if (decrypted.size() != modulus_size)
+        return false;
+
+    auto expected = ByteBuffer::create_uninitialized(modulus_size);
+    auto padding_end = modulus_size - prefix.size() - digest_bytes.size();
+    expected[0] = 0x00;
+    expected[1] = 0x01;
+    for (size_t i = 2; i < padding_end - 1; ++i)
+        expected[i] = 0xff;
+    expected[padding_end - 1] = 0x00;
+    prefix.copy_to(expected.bytes().slice(padding_end));
+    digest_bytes.copy_to(expected.bytes().slice(padding_end + prefix.size()));
+    return decrypted == expected.bytes();
+}
+
 }
@@ -19,8 +19,10 @@ ByteBuffer TLSv12::build_alert(bool critical, u8 code)
     builder.append((u8)(critical ? AlertLevel::Critical : AlertLevel::Warning));
     builder.append(code);
 
-    if (critical)
+    if (critical) {
         m_context.critical_error = code;
+        forget_session_if_handshaking();
+    }
 
     auto packet = builder.build();
     update_packet(packet);
@@ -483,13 +485,16 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
             if (level == (u8)AlertLevel::Critical) {
                 dbgln("We were alerted of a critical error: {} ({})", code, alert_name((AlertDescription)code));
                 m_context.critical_error = code;
+                forget_session_if_handshaking();
                 try_disambiguate_error();
                 res = (i8)Error::UnknownError;
             }
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                // A fatal-level close_notify makes servers invalidate the session (RFC 5246 section 7.2),
+                // which would defeat session resumption.
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 m_context.connection_finished = true;
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<Session> SessionCache::get(const String& host)
+{
+    auto it = m_sessions.find(host);
+    if (it == m_sessions.end())
+        return {};
+    if (it->value.expires_at <= time(nullptr)) {
+        m_sessions.remove(it);
+        return {};
+    }
+    return it->value;
+}
+
+void SessionCache::set(const String& host, Session session)
+{
+    if (session.session_id.is_empty() && session.ticket.is_empty())
+        return;
+
+    if (!m_sessions.contains(host) && m_sessions.size() >= max_entries) {
+        // Make room by dropping whichever session expires first.
+        auto oldest = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expires_at < oldest->value.expires_at)
+                oldest = it;
+        }
+        m_sessions.remove(oldest);
+    }
+    m_sessions.set(host, move(session));
+}
+
+void SessionCache::remove(const String& host)
+{
+    m_sessions.remove(host);
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibTLS/Certificate.h>
+#include <LibTLS/CipherSuite.h>
+#include <time.h>
+
+namespace TLS {
+
+// The state needed to resume a TLS 1.2 session with an abbreviated handshake,
+// either by session ID (RFC 5246 section 7.3) or by session ticket (RFC 5077).
+struct Session {
+    CipherSuite cipher { CipherSuite::Invalid };
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+    ByteBuffer master_key;
+    Vector<Certificate> certificates;
+    time_t expires_at { 0 };
+};
+
+// Remembers the most recent resumable session for each host, so that sockets
+// sharing a cache can skip certificate parsing and key exchange on reconnect.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    static NonnullRefPtr<SessionCache> create() { return adopt_ref(*new SessionCache); }
+
+    Optional<Session> get(const String& host);
+    void set(const String& host, Session);
+    void remove(const String& host);
+
+    static constexpr time_t default_lifetime_in_seconds = 60 * 60;
+    static constexpr size_t max_entries = 64;
+
+private:
+    SessionCache() = default;
+
+    HashMap<String, Session> m_sessions;
+};
+
+}
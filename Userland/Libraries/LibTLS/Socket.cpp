@@ -74,6 +74,8 @@ bool TLSv12::write(ReadonlyBytes buffer)
 bool TLSv12::connect(const String& hostname, int port)
 {
     set_sni(hostname);
+    if (m_session_cache)
+        m_context.resumable_session = m_session_cache->get(hostname);
     return Core::Socket::connect(hostname, port);
 }
 
@@ -183,6 +183,54 @@ void TLSv12::set_root_certificates(Vector<Certificate> certificates)
     m_context.root_ceritificates = move(certificates);
 }
 
+void TLSv12::add_alpn(const StringView& alpn)
+{
+    if (m_context.connection_status != ConnectionStatus::Disconnected) {
+        dbgln("invalid state for add_alpn");
+        return;
+    }
+    VERIFY(!alpn.is_empty() && alpn.length() <= 255);
+    m_context.alpn.append(alpn);
+}
+
+bool TLSv12::has_alpn(const StringView& alpn) const
+{
+    return m_context.alpn.contains_slow(alpn);
+}
+
+void TLSv12::remember_session()
+{
+    if (!m_session_cache || m_context.extensions.SNI.is_empty())
+        return;
+
+    Session session;
+    session.cipher = m_context.cipher;
+    session.master_key = m_context.master_key;
+    session.certificates = m_context.certificates;
+    session.expires_at = time(nullptr) + SessionCache::default_lifetime_in_seconds;
+    if (m_context.session_ticket_lifetime_hint)
+        session.expires_at = min(session.expires_at, time(nullptr) + (time_t)m_context.session_ticket_lifetime_hint);
+
+    if (m_context.is_resuming) {
+        // Keep what we resumed with, unless the server handed out a fresh ticket.
+        auto& previous = m_context.resumable_session.value();
+        session.session_id = previous.session_id;
+        session.ticket = m_context.session_ticket.is_empty() ? previous.ticket : m_context.session_ticket;
+    } else {
+        session.session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+        session.ticket = m_context.session_ticket;
+    }
+
+    m_session_cache->set(m_context.extensions.SNI, move(session));
+}
+
+void TLSv12::forget_session_if_handshaking()
+{
+    // A handshake that fails must not be retried with the same session.
+    if (m_session_cache && m_context.connection_status != ConnectionStatus::Established && !m_context.extensions.SNI.is_empty())
+        m_session_cache->remove(m_context.extensions.SNI);
+}
+
 bool Context::verify_chain() const
 {
     if (!options.validate_certificates)
@@ -18,6 +18,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -121,6 +122,7 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
@@ -132,14 +134,37 @@ enum HandshakeType {
 
 enum class HandshakeExtension : u16 {
     ServerName = 0x00,
+    SupportedGroups = 0x0a,
+    ECPointFormats = 0x0b,
     ApplicationLayerProtocolNegotiation = 0x10,
     SignatureAlgorithms = 0x0d,
+    SessionTicket = 0x23,
 };
 
 enum class NameType : u8 {
     HostName = 0x00,
 };
 
+// Defined in RFC 8422 section 5.1.1
+enum class NamedCurve : u16 {
+    Invalid = 0,
+    secp256r1 = 23,
+    secp384r1 = 24,
+    secp521r1 = 25,
+    x25519 = 29,
+    x448 = 30,
+};
+
+// Defined in RFC 8422 section 5.1.2
+enum class ECPointFormat : u8 {
+    Uncompressed = 0,
+};
+
+// Defined in RFC 8422 section 5.4
+enum class ECCurveType : u8 {
+    NamedCurve = 3,
+};
+
 enum class WritePacketStage {
     Initial = 0,
     ClientHandshake = 1,
@@ -164,12 +189,16 @@ enum ClientVerificationStaus {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
-#define ENUMERATE_CIPHERS(C)                                                                                                                    \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)      \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)      \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false) \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false) \
-    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)   \
+#define ENUMERATE_CIPHERS(C)                                                                                                                                    \
+    C(true, CipherSuite::ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true) \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)     \
+    C(true, CipherSuite::ECDHE_ECDSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_ECDSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true) \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)     \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                      \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                      \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)                 \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)                 \
+    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                   \
     C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)
 
 constexpr KeyExchangeAlgorithm get_key_exchange_algorithm(CipherSuite suite)
@@ -217,12 +246,18 @@ struct Options {
 
     OPTION_WITH_DEFAULTS(Version, version, Version::V12)
     OPTION_WITH_DEFAULTS(Vector<SignatureAndHashAlgorithm>, supported_signature_algorithms,
+        { HashAlgorithm::SHA256, SignatureAlgorithm::ECDSA },
+        { HashAlgorithm::SHA384, SignatureAlgorithm::ECDSA },
         { HashAlgorithm::SHA512, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA384, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA256, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA1, SignatureAlgorithm::RSA });
+    OPTION_WITH_DEFAULTS(Vector<NamedCurve>, elliptic_curves,
+        NamedCurve::x25519,
+        NamedCurve::secp256r1);
 
     OPTION_WITH_DEFAULTS(bool, use_sni, true)
+    OPTION_WITH_DEFAULTS(bool, use_session_tickets, true)
     OPTION_WITH_DEFAULTS(bool, use_compression, false)
     OPTION_WITH_DEFAULTS(bool, validate_certificates, true)
 
@@ -242,6 +277,11 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    // The cached session offered in our hello, and whether the server accepted it.
+    Optional<Session> resumable_session;
+    bool is_resuming { false };
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -249,6 +289,8 @@ struct Context {
     Vector<Certificate> client_certificates;
     ByteBuffer master_key;
     ByteBuffer premaster_key;
+    NamedCurve server_key_exchange_curve { NamedCurve::Invalid };
+    ByteBuffer server_key_exchange_public_key;
     u8 cipher_spec_set { 0 };
     struct {
         int created { 0 };
@@ -290,12 +332,13 @@ struct Context {
     bool connection_finished { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[12] { 0 };
     ByteBuffer user_data;
     Vector<Certificate> root_ceritificates;
 
+    // Offered in the ClientHello, most preferred first.
     Vector<String> alpn;
-    StringView negotiated_alpn;
+    String negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -323,6 +366,9 @@ public:
 
     void set_root_certificates(Vector<Certificate>);
 
+    // Sockets sharing a cache resume each other's sessions when connecting to the same host.
+    void set_session_cache(RefPtr<SessionCache> cache) { m_session_cache = move(cache); }
+
     bool add_client_key(ReadonlyBytes certificate_pem_buffer, ReadonlyBytes key_pem_buffer);
     bool add_client_key(Certificate certificate)
     {
@@ -332,7 +378,8 @@ public:
 
     ByteBuffer finish_build();
 
-    const StringView& alpn() const { return m_context.negotiated_alpn; }
+    // The application protocol the server picked from the ones added with add_alpn() (RFC 7301), if any.
+    const String& alpn() const { return m_context.negotiated_alpn; }
     void add_alpn(const StringView& alpn);
     bool has_alpn(const StringView& alpn) const;
 
@@ -397,6 +444,7 @@ private:
     ByteBuffer build_change_cipher_spec();
     ByteBuffer build_verify_request();
     void build_rsa_pre_master_secret(PacketBuilder&);
+    void build_ecdhe_pre_master_secret(PacketBuilder&);
 
     bool flush();
     void write_into_socket();
@@ -408,8 +456,11 @@ private:
     ssize_t handle_handshake_finished(ReadonlyBytes, WritePacketStage&);
     ssize_t handle_certificate(ReadonlyBytes);
     ssize_t handle_server_key_exchange(ReadonlyBytes);
+    ssize_t handle_ecdhe_server_key_exchange(ReadonlyBytes);
+    bool verify_server_key_exchange_signature(ReadonlyBytes params, SignatureAndHashAlgorithm, ReadonlyBytes signature) const;
     ssize_t handle_server_hello_done(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
     ssize_t handle_random(ReadonlyBytes);
@@ -485,6 +536,9 @@ private:
     }
 
     bool expand_key();
+    void resume_session();
+    void remember_session();
+    void forget_session_if_handshaking();
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
@@ -493,6 +547,7 @@ private:
     void try_disambiguate_error() const;
 
     Context m_context;
+    RefPtr<SessionCache> m_session_cache;
 
     OwnPtr<Crypto::Authentication::HMAC<Crypto::Hash::Manager>> m_hmac_local;
     OwnPtr<Crypto::Authentication::HMAC<Crypto::Hash::Manager>> m_hmac_remote;
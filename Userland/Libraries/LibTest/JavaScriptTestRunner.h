@@ -109,6 +109,8 @@ extern RefPtr<JS::VM> g_vm;
 extern bool g_collect_on_every_allocation;
 extern bool g_run_bytecode;
 extern bool g_dump_bytecode;
+extern bool g_jit_bytecode;
+extern bool g_lazy_parse;
 extern String g_currently_running_test;
 struct FunctionWithLength {
     JS::Value (*function)(JS::VM&, JS::GlobalObject&);
@@ -204,6 +206,7 @@ inline AK::Result<NonnullRefPtr<JS::Program>, ParserError> parse_file(const Stri
     file->close();
 
     auto parser = JS::Parser(JS::Lexer(test_file_string));
+    parser.set_lazy_function_parsing(g_lazy_parse);
     auto program = parser.parse_program();
 
     if (parser.has_errors()) {
@@ -316,6 +319,7 @@ inline JSFileResult TestRunner::run_file_test(const String& test_path)
         }
 
         JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object());
+        bytecode_interpreter.set_jit_enabled(g_jit_bytecode);
         bytecode_interpreter.run(unit);
     } else {
         interpreter->run(interpreter->global_object(), *m_test_program);
@@ -338,6 +342,7 @@ inline JSFileResult TestRunner::run_file_test(const String& test_path)
         }
 
         JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object());
+        bytecode_interpreter.set_jit_enabled(g_jit_bytecode);
         bytecode_interpreter.run(unit);
     } else {
         interpreter->run(interpreter->global_object(), *file_program.value());
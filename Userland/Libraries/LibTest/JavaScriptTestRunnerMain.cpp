@@ -20,6 +20,8 @@ RefPtr<::JS::VM> g_vm;
 bool g_collect_on_every_allocation = false;
 bool g_run_bytecode = false;
 bool g_dump_bytecode = false;
+bool g_jit_bytecode = false;
+bool g_lazy_parse = false;
 String g_currently_running_test;
 HashMap<String, FunctionWithLength> s_exposed_global_functions;
 Function<void()> g_main_hook;
@@ -111,6 +113,8 @@ int main(int argc, char** argv)
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(g_run_bytecode, "Use the bytecode interpreter", "run-bytecode", 'b');
     args_parser.add_option(g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(g_jit_bytecode, "Run the bytecode as machine code where possible", "jit", 0);
+    args_parser.add_option(g_lazy_parse, "Only parse functions when they are first called", "lazy-parse", 0);
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -129,6 +133,11 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (g_jit_bytecode && !g_run_bytecode) {
+        warnln("--jit can only be used when --run-bytecode is specified.");
+        return 1;
+    }
+
     String test_root;
 
     if (specified_test_root) {
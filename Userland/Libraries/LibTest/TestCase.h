@@ -40,6 +40,27 @@ private:
 // Helper to hide implementation of TestSuite from users
 void add_test_case_to_suite(const NonnullRefPtr<TestCase>& test_case);
 
+// Benchmarks get run many times over, so whatever they compute without using it has to be passed to do_not_optimize()
+// to keep the compiler from leaving the computation out. It doesn't generate any code itself.
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(T const& value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+// Keeps the compiler from assuming anything about memory across this point, so that stores that are never read again
+// in a benchmark still happen.
+ALWAYS_INLINE void clobber_memory()
+{
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+}
+
 }
 
 #define __TESTCASE_FUNC(x) __test_##x
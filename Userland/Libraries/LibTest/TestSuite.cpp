@@ -7,10 +7,18 @@
 
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
+#include <AK/JsonObject.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
 #include <LibCore/ArgsParser.h>
 #include <LibTest/TestSuite.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
 
 namespace Test {
 
@@ -37,6 +45,24 @@ private:
     struct timeval m_started = {};
 };
 
+static u64 monotonic_time_in_ns()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+}
+
+static String format_duration(double ns)
+{
+    if (ns < 1'000)
+        return String::formatted("{:.1}ns", ns);
+    if (ns < 1'000'000)
+        return String::formatted("{:.2}us", ns / 1'000);
+    if (ns < 1'000'000'000)
+        return String::formatted("{:.2}ms", ns / 1'000'000);
+    return String::formatted("{:.2}s", ns / 1'000'000'000);
+}
+
 // Declared in Macros.h
 void current_test_case_did_fail()
 {
@@ -56,16 +82,22 @@ int TestSuite::main(const String& suite_name, int argc, char** argv)
     Core::ArgsParser args_parser;
 
     bool do_tests_only = getenv("TESTS_ONLY") != nullptr;
+    if (auto* benchmark_results_path = getenv("BENCHMARK_RESULTS"))
+        m_benchmark_results_path = benchmark_results_path;
     bool do_benchmarks_only = false;
     bool do_list_cases = false;
     const char* search_string = "*";
 
     args_parser.add_option(do_tests_only, "Only run tests.", "tests", 0);
-    args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench", 0);
+    args_parser.add_option(do_benchmarks_only, "Only run benchmarks, and time them over many runs.", "bench", 0);
     args_parser.add_option(do_list_cases, "List available test cases.", "list", 0);
+    args_parser.add_option(m_benchmark_time_target_ms, "Roughly how long to spend on each benchmark (1000 by default).", "bench-time", 0, "ms");
+    args_parser.add_option(m_benchmark_results_path, "Append the results of every benchmark to this file as a line of JSON (defaults to $BENCHMARK_RESULTS).", "bench-results", 0, "path");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
+    m_should_sample_benchmarks = do_benchmarks_only || !m_benchmark_results_path.is_empty();
+
     const auto& matching_tests = find_cases(search_string, !do_benchmarks_only, !do_tests_only);
 
     if (do_list_cases) {
@@ -115,7 +147,10 @@ int TestSuite::run(const NonnullRefPtrVector<TestCase>& tests)
         m_current_test_case_passed = true;
 
         TestElapsedTimer timer;
-        t.func()();
+        if (t.is_benchmark() && m_should_sample_benchmarks)
+            run_benchmark(t);
+        else
+            t.func()();
         const auto time = timer.elapsed_milliseconds();
 
         dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
@@ -145,4 +180,71 @@ int TestSuite::run(const NonnullRefPtrVector<TestCase>& tests)
     return (int)test_failed_count;
 }
 
+void TestSuite::run_benchmark(const TestCase& benchmark)
+{
+    // The first run warms up caches and the allocator, and shows how long a run takes. Runs that are too short to time
+    // well get grouped into samples of several runs, and there are as many samples as fit into the time target.
+    static constexpr u64 minimum_sample_time_ns = 10'000'000;
+    static constexpr u64 maximum_sample_count = 1000;
+
+    auto start = monotonic_time_in_ns();
+    benchmark.func()();
+    auto warmup_time_ns = max(monotonic_time_in_ns() - start, static_cast<u64>(1));
+    if (!m_current_test_case_passed)
+        return;
+
+    u64 runs_per_sample = max(minimum_sample_time_ns / warmup_time_ns, static_cast<u64>(1));
+    u64 sample_count = clamp(m_benchmark_time_target_ms * 1'000'000ull / (warmup_time_ns * runs_per_sample), static_cast<u64>(1), static_cast<u64>(maximum_sample_count));
+
+    Vector<double> run_times_ns;
+    run_times_ns.ensure_capacity(sample_count);
+    for (u64 sample = 0; sample < sample_count && m_current_test_case_passed; ++sample) {
+        start = monotonic_time_in_ns();
+        for (u64 run = 0; run < runs_per_sample; ++run)
+            benchmark.func()();
+        run_times_ns.append(static_cast<double>(monotonic_time_in_ns() - start) / runs_per_sample);
+    }
+    if (!m_current_test_case_passed)
+        return;
+
+    quick_sort(run_times_ns);
+    auto percentile = [&](size_t percent) {
+        return run_times_ns[(run_times_ns.size() - 1) * percent / 100];
+    };
+    outln("Benchmark '{}': median {} per run, p10 {}, p90 {}, min {}, max {} ({} samples of {} runs)",
+        benchmark.name(),
+        format_duration(percentile(50)),
+        format_duration(percentile(10)),
+        format_duration(percentile(90)),
+        format_duration(run_times_ns.first()),
+        format_duration(run_times_ns.last()),
+        run_times_ns.size(),
+        runs_per_sample);
+
+    if (m_benchmark_results_path.is_empty())
+        return;
+
+    JsonObject result;
+    result.set("suite", LexicalPath::basename(m_suite_name));
+    result.set("benchmark", benchmark.name());
+    result.set("samples", run_times_ns.size());
+    result.set("runs_per_sample", runs_per_sample);
+    result.set("min_ns", run_times_ns.first());
+    result.set("p10_ns", percentile(10));
+    result.set("median_ns", percentile(50));
+    result.set("p90_ns", percentile(90));
+    result.set("max_ns", run_times_ns.last());
+    auto line = String::formatted("{}\n", result.to_string());
+
+    // Every test binary that run-tests starts appends to the same file, so each line has to go out in one write().
+    int fd = open(m_benchmark_results_path.characters(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        warnln("Couldn't open {} to write benchmark results to: {}", m_benchmark_results_path, strerror(errno));
+        return;
+    }
+    if (write(fd, line.characters(), line.length()) < 0)
+        warnln("Couldn't write benchmark results to {}: {}", m_benchmark_results_path, strerror(errno));
+    close(fd);
+}
+
 }
@@ -44,12 +44,21 @@ public:
     void current_test_case_did_fail() { m_current_test_case_passed = false; }
 
 private:
+    void run_benchmark(const TestCase&);
+
     static TestSuite* s_global;
     NonnullRefPtrVector<TestCase> m_cases;
     u64 m_testtime = 0;
     u64 m_benchtime = 0;
     String m_suite_name;
     bool m_current_test_case_passed = true;
+
+    // Benchmarks only get run over and over to time them when asked to, and once like any test otherwise.
+    bool m_should_sample_benchmarks = false;
+    // Roughly how long every benchmark gets to run its samples in.
+    unsigned m_benchmark_time_target_ms = 1000;
+    // Where to append one line of JSON with the results of every benchmark, if anywhere.
+    String m_benchmark_results_path;
 };
 
 }
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/RefCounted.h>
+#include <AK/StringBuilder.h>
+#include <LibThreading/DirectoryWalker.h>
+#include <LibThreading/ThreadPool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+namespace Threading {
+
+// This many directories are read ahead at most, which keeps every worker busy without reading half the disk into
+// memory when the caller only walks into a few of them.
+static constexpr size_t max_directories_read_ahead = 64;
+
+struct DirectoryWalker::Listing : public RefCounted<Listing> {
+    enum State {
+        Queued,
+        Reading,
+        Done,
+    };
+
+    explicit Listing(String path)
+        : path(move(path))
+    {
+    }
+
+    ~Listing()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&condition);
+    }
+
+    // Whoever gets to move it from Queued to Reading reads the directory, which is how the walker takes over a directory
+    // it needs right now from a worker that hasn't got around to it yet.
+    bool try_start_reading()
+    {
+        auto expected = Queued;
+        return state.compare_exchange_strong(expected, Reading);
+    }
+
+    void finish_reading()
+    {
+        pthread_mutex_lock(&mutex);
+        state.store(Done);
+        pthread_cond_broadcast(&condition);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void wait_until_done()
+    {
+        pthread_mutex_lock(&mutex);
+        while (state.load() != Done)
+            pthread_cond_wait(&condition, &mutex);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    String path;
+    Vector<Entry> entries;
+    int error { 0 };
+    Atomic<State> state { Queued };
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+};
+
+bool DirectoryWalker::Entry::is_directory() const
+{
+    if (has_stat)
+        return S_ISDIR(stat.st_mode);
+    return type == DT_DIR;
+}
+
+DirectoryWalker::DirectoryWalker(Core::DirIterator::Flags flags, StatEntries stat_entries)
+    : m_flags(flags)
+    , m_stat_entries(stat_entries)
+{
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+}
+
+void DirectoryWalker::read(Listing& listing, Core::DirIterator::Flags flags, StatEntries stat_entries)
+{
+    Core::DirIterator iterator(listing.path, flags);
+    if (iterator.has_error()) {
+        listing.error = iterator.error();
+        return;
+    }
+
+    while (iterator.has_next()) {
+        Entry entry;
+        auto name = iterator.next_path();
+        entry.type = iterator.last_type();
+        if (stat_entries == StatEntries::Yes)
+            entry.has_stat = fstatat(iterator.fd(), name.characters(), &entry.stat, AT_SYMLINK_NOFOLLOW) == 0;
+
+        StringBuilder builder;
+        builder.append(listing.path);
+        if (!listing.path.ends_with('/'))
+            builder.append('/');
+        builder.append(name);
+        entry.path = builder.to_string();
+        listing.entries.append(move(entry));
+    }
+    listing.error = iterator.error();
+}
+
+NonnullRefPtr<DirectoryWalker::Listing> DirectoryWalker::start_reading(String const& path)
+{
+    auto listing = adopt_ref(*new Listing(path));
+    // This may still run after the walk is over, so it mustn't touch the walker.
+    ThreadPool::the().submit([listing, flags = m_flags, stat_entries = m_stat_entries]() mutable {
+        if (!listing->try_start_reading())
+            return;
+        read(*listing, flags, stat_entries);
+        listing->finish_reading();
+    });
+    return listing;
+}
+
+void DirectoryWalker::walk(String const& root)
+{
+    struct Frame {
+        Entry directory;
+        NonnullRefPtr<Listing> listing;
+        bool is_ready { false };
+        size_t next_entry { 0 };
+        size_t next_entry_to_read_ahead { 0 };
+    };
+
+    Vector<Frame> stack;
+    stack.append({ {}, adopt_ref(*new Listing(root)) });
+    while (!stack.is_empty()) {
+        auto& frame = stack.last();
+        auto& listing = *frame.listing;
+        if (!frame.is_ready) {
+            if (listing.try_start_reading()) {
+                read(listing, m_flags, m_stat_entries);
+                listing.finish_reading();
+            } else {
+                listing.wait_until_done();
+            }
+            frame.is_ready = true;
+        }
+
+        // Keep reading ahead the directories that come next in this one, which are also the ones to be visited next
+        // once the walk gets back here.
+        while (frame.next_entry_to_read_ahead < listing.entries.size() && m_listings_read_ahead.size() < max_directories_read_ahead) {
+            auto& entry = listing.entries[frame.next_entry_to_read_ahead++];
+            if (entry.is_directory())
+                m_listings_read_ahead.set(entry.path, start_reading(entry.path));
+        }
+
+        if (frame.next_entry == listing.entries.size()) {
+            if (listing.error && on_error)
+                on_error(listing.path, listing.error);
+            if (stack.size() > 1 && on_leave_directory)
+                on_leave_directory(frame.directory);
+            stack.take_last();
+            continue;
+        }
+
+        auto& entry = listing.entries[frame.next_entry++];
+        entry.depth = stack.size();
+        RefPtr<Listing> child_listing;
+        if (auto it = m_listings_read_ahead.find(entry.path); it != m_listings_read_ahead.end()) {
+            child_listing = it->value;
+            m_listings_read_ahead.remove(it);
+        }
+        if (!on_entry(entry))
+            continue;
+
+        if (!child_listing)
+            child_listing = adopt_ref(*new Listing(entry.path));
+        stack.append({ entry, child_listing.release_nonnull() });
+    }
+
+    // Nobody is going to look at the directories that were read ahead in vain, so don't bother reading the rest of them.
+    for (auto& it : m_listings_read_ahead) {
+        if (it.value->try_start_reading())
+            it.value->finish_reading();
+    }
+    m_listings_read_ahead.clear();
+}
+
+}
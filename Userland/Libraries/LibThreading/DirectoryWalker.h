@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <LibCore/DirIterator.h>
+#include <sys/stat.h>
+
+namespace Threading {
+
+// Walks a directory tree depth-first, in the same order as a plain recursive walk with Core::DirIterator would, but reads
+// the directories that are coming up next ahead of time on ThreadPool::the(). That way, waiting for the disk to produce
+// one directory overlaps with the others and with whatever the caller does with the entries. The callbacks are all
+// called on the thread that called walk(), which mustn't be one of the pool's workers.
+class DirectoryWalker {
+public:
+    enum class StatEntries {
+        No,
+        Yes,
+    };
+
+    struct Entry {
+        String path;
+        // How far below the directory that was passed to walk() this is, starting at 1 for its own children.
+        size_t depth { 0 };
+        // One of the DT_* values, which comes for free with the directory entry. It's DT_UNKNOWN on file systems that
+        // don't know, in which case the caller has to look for itself.
+        unsigned char type { DT_UNKNOWN };
+        // Only filled in when walking with StatEntries::Yes, in which case the lstat() happens on the pool.
+        struct stat stat;
+        bool has_stat { false };
+
+        bool is_directory() const;
+    };
+
+    explicit DirectoryWalker(Core::DirIterator::Flags = Core::DirIterator::SkipParentAndBaseDir, StatEntries = StatEntries::No);
+    ~DirectoryWalker();
+
+    // Called for every entry, returns whether to walk into it. Entries that aren't directories (say, a symlink when
+    // following those) are fine to walk into too, it only fails with ENOTDIR.
+    Function<bool(Entry const&)> on_entry;
+    // Called once all the entries below a directory that was walked into have been visited.
+    Function<void(Entry const&)> on_leave_directory;
+    // Called with the errno of a directory that couldn't be read, or not completely.
+    Function<void(String const& path, int error)> on_error;
+
+    void walk(String const& root);
+
+private:
+    struct Listing;
+
+    NonnullRefPtr<Listing> start_reading(String const& path);
+    static void read(Listing&, Core::DirIterator::Flags, StatEntries);
+
+    Core::DirIterator::Flags m_flags;
+    StatEntries m_stat_entries;
+    // The directories that are being read ahead, by path.
+    HashMap<String, NonnullRefPtr<Listing>> m_listings_read_ahead;
+};
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <pthread.h>
+
+namespace Threading {
+
+// Any number of readers, or a single writer. Waiting writers keep new readers out, so taking a
+// read lock a thread already holds can deadlock once a writer is waiting.
+class RWLock {
+    AK_MAKE_NONCOPYABLE(RWLock);
+    AK_MAKE_NONMOVABLE(RWLock);
+
+public:
+    RWLock() { pthread_rwlock_init(&m_rwlock, nullptr); }
+    ~RWLock() { pthread_rwlock_destroy(&m_rwlock); }
+
+    void lock_read() { pthread_rwlock_rdlock(&m_rwlock); }
+    void lock_write() { pthread_rwlock_wrlock(&m_rwlock); }
+    bool try_lock_read() { return pthread_rwlock_tryrdlock(&m_rwlock) == 0; }
+    bool try_lock_write() { return pthread_rwlock_trywrlock(&m_rwlock) == 0; }
+    void unlock() { pthread_rwlock_unlock(&m_rwlock); }
+
+private:
+    pthread_rwlock_t m_rwlock;
+};
+
+class ReadLocker {
+public:
+    ALWAYS_INLINE explicit ReadLocker(RWLock& lock)
+        : m_lock(lock)
+    {
+        m_lock.lock_read();
+    }
+    ALWAYS_INLINE ~ReadLocker() { m_lock.unlock(); }
+
+private:
+    RWLock& m_lock;
+};
+
+class WriteLocker {
+public:
+    ALWAYS_INLINE explicit WriteLocker(RWLock& lock)
+        : m_lock(lock)
+    {
+        m_lock.lock_write();
+    }
+    ALWAYS_INLINE ~WriteLocker() { m_lock.unlock(); }
+
+private:
+    RWLock& m_lock;
+};
+
+}
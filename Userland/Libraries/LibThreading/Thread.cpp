@@ -33,8 +33,8 @@ void Threading::Thread::start()
         nullptr,
         [](void* arg) -> void* {
             Thread* self = static_cast<Thread*>(arg);
+            // m_tid is left alone here, join() still needs it after the thread is done.
             auto exit_code = self->m_action();
-            self->m_tid = 0;
             return reinterpret_cast<void*>(exit_code);
         },
         static_cast<void*>(this));
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+struct ThreadPool::Worker {
+    explicit Worker(ThreadPool& pool)
+        : pool(pool)
+    {
+    }
+
+    ThreadPool& pool;
+    RefPtr<Thread> thread;
+
+    // The owner pushes and pops at the back, thieves take from the front.
+    Mutex mutex;
+    Vector<Function<void()>> jobs;
+};
+
+thread_local ThreadPool::Worker* ThreadPool::s_current_worker;
+
+ThreadPool& ThreadPool::the()
+{
+    static ThreadPool* s_the = &ThreadPool::construct().leak_ref();
+    return *s_the;
+}
+
+ThreadPool::ThreadPool(size_t worker_count)
+{
+    if (worker_count == 0)
+        worker_count = max(static_cast<long>(1), sysconf(_SC_NPROCESSORS_ONLN));
+
+    m_workers.ensure_capacity(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+        m_workers.append(make<Worker>(*this));
+    for (auto& worker : m_workers) {
+        worker.thread = Thread::construct([this, &worker] { return worker_main(worker); }, "Pool worker");
+        worker.thread->start();
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    pthread_mutex_lock(&m_sleep_mutex);
+    m_shutting_down = true;
+    pthread_cond_broadcast(&m_wake_condition);
+    pthread_mutex_unlock(&m_sleep_mutex);
+
+    // Workers only exit once every deque is empty, so nothing that was submitted gets dropped.
+    for (auto& worker : m_workers)
+        (void)worker.thread->join();
+
+    pthread_mutex_destroy(&m_sleep_mutex);
+    pthread_cond_destroy(&m_wake_condition);
+}
+
+ThreadPool::Worker* ThreadPool::current_worker() const
+{
+    if (s_current_worker && &s_current_worker->pool == this)
+        return s_current_worker;
+    return nullptr;
+}
+
+void ThreadPool::submit(Function<void()> job)
+{
+    auto* worker = current_worker();
+    if (!worker)
+        worker = &m_workers[m_next_worker.fetch_add(1) % m_workers.size()];
+
+    {
+        MutexLocker locker(worker->mutex);
+        worker->jobs.append(move(job));
+    }
+
+    pthread_mutex_lock(&m_sleep_mutex);
+    m_pending_job_count.fetch_add(1);
+    pthread_cond_signal(&m_wake_condition);
+    pthread_mutex_unlock(&m_sleep_mutex);
+}
+
+Function<void()> ThreadPool::take_job(Worker* own_worker)
+{
+    if (m_pending_job_count.load() == 0)
+        return nullptr;
+
+    Function<void()> job;
+    if (own_worker) {
+        MutexLocker locker(own_worker->mutex);
+        if (!own_worker->jobs.is_empty())
+            job = own_worker->jobs.take_last();
+    }
+
+    // Start looking somewhere different each time, so the thieves don't all pile onto the first worker.
+    size_t start = m_next_worker.load();
+    for (size_t i = 0; !job && i < m_workers.size(); ++i) {
+        auto& victim = m_workers[(start + i) % m_workers.size()];
+        if (&victim == own_worker)
+            continue;
+        MutexLocker locker(victim.mutex);
+        if (!victim.jobs.is_empty())
+            job = victim.jobs.take_first();
+    }
+
+    if (job)
+        m_pending_job_count.fetch_sub(1);
+    return job;
+}
+
+bool ThreadPool::run_pending_job()
+{
+    auto job = take_job(current_worker());
+    if (!job)
+        return false;
+    job();
+    return true;
+}
+
+size_t ThreadPool::chunk_size_for(size_t element_count) const
+{
+    // A few chunks per worker, so that a slow chunk can be balanced out by the others.
+    size_t chunk_count = min(element_count, m_workers.size() * 4);
+    return (element_count + chunk_count - 1) / chunk_count;
+}
+
+void ThreadPool::wait(JobGroup& group)
+{
+    while (!group.is_done()) {
+        if (!run_pending_job())
+            break;
+    }
+    group.wait_until_done();
+}
+
+intptr_t ThreadPool::worker_main(Worker& worker)
+{
+    s_current_worker = &worker;
+    for (;;) {
+        if (auto job = take_job(&worker)) {
+            job();
+            continue;
+        }
+
+        pthread_mutex_lock(&m_sleep_mutex);
+        while (m_pending_job_count.load() == 0 && !m_shutting_down)
+            pthread_cond_wait(&m_wake_condition, &m_sleep_mutex);
+        bool should_exit = m_shutting_down && m_pending_job_count.load() == 0;
+        pthread_mutex_unlock(&m_sleep_mutex);
+        if (should_exit)
+            return 0;
+    }
+}
+
+}
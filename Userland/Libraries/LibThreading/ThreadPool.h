@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibCore/Event.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Object.h>
+#include <pthread.h>
+
+namespace Threading {
+
+// A fixed set of worker threads, each with its own deque of jobs. Workers run their own jobs newest
+// first and steal the oldest jobs of the others once they run dry, so jobs that fan out into more
+// jobs (like a nested parallel_for()) keep every worker busy without a single shared queue.
+class ThreadPool final : public Core::Object {
+    C_OBJECT(ThreadPool);
+
+public:
+    // The process-wide pool, with one worker per online CPU.
+    static ThreadPool& the();
+
+    virtual ~ThreadPool() override;
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    // Jobs submitted from one of this pool's workers go onto that worker's own deque.
+    void submit(Function<void()> job);
+
+    // Runs job on a worker, then calls on_complete with its result on the event loop that was
+    // current when this was called.
+    template<typename Result>
+    void submit(Function<Result()> job, Function<void(Result)> on_complete)
+    {
+        auto& event_loop = Core::EventLoop::current();
+        submit([this, &event_loop, job = move(job), on_complete = move(on_complete)]() mutable {
+            auto result = job();
+            event_loop.post_event(*this, make<Core::DeferredInvocationEvent>([on_complete = move(on_complete), result = move(result)](auto&) mutable {
+                on_complete(move(result));
+            }));
+            Core::EventLoop::wake();
+        });
+    }
+
+    // Calls callback on every element, with the span split into chunks that run on the workers.
+    // The calling thread works on chunks too while it waits, which also makes this safe to use from
+    // inside a job running on the pool.
+    template<typename T, typename Callback>
+    void parallel_for(Span<T> span, Callback callback)
+    {
+        if (span.is_empty())
+            return;
+        auto chunk_size = chunk_size_for(span.size());
+        JobGroup group;
+        for (size_t offset = chunk_size; offset < span.size(); offset += chunk_size) {
+            auto chunk = span.slice(offset, min(chunk_size, span.size() - offset));
+            group.add();
+            submit([chunk, &callback, &group]() mutable {
+                for (auto& element : chunk)
+                    callback(element);
+                group.done();
+            });
+        }
+        for (auto& element : span.trim(chunk_size))
+            callback(element);
+        wait(group);
+    }
+
+    // Folds every chunk of the span into its own copy of identity with accumulate(U, T&), then folds
+    // the chunk results together in order with combine(U, U). For the result to be deterministic,
+    // combine has to be associative.
+    template<typename T, typename U, typename Accumulate, typename Combine>
+    U parallel_reduce(Span<T> span, U identity, Accumulate accumulate, Combine combine)
+    {
+        if (span.is_empty())
+            return identity;
+        auto chunk_size = chunk_size_for(span.size());
+        Vector<U> partials;
+        partials.ensure_capacity((span.size() + chunk_size - 1) / chunk_size);
+        for (size_t offset = 0; offset < span.size(); offset += chunk_size)
+            partials.append(identity);
+
+        JobGroup group;
+        auto reduce_chunk = [&](size_t index) {
+            auto& partial = partials[index];
+            for (auto& element : span.slice(index * chunk_size, min(chunk_size, span.size() - index * chunk_size)))
+                partial = accumulate(move(partial), element);
+        };
+        for (size_t index = 1; index < partials.size(); ++index) {
+            group.add();
+            submit([&reduce_chunk, &group, index] {
+                reduce_chunk(index);
+                group.done();
+            });
+        }
+        reduce_chunk(0);
+        wait(group);
+
+        U result = move(partials[0]);
+        for (size_t index = 1; index < partials.size(); ++index)
+            result = combine(move(result), move(partials[index]));
+        return result;
+    }
+
+    // Sorts chunks of the span on the workers, then merges them back together in rounds of parallel
+    // merges. Like quick_sort(), this isn't stable.
+    template<typename T, typename LessThan>
+    void parallel_sort(Span<T> span, LessThan less_than)
+    {
+        if (span.size() <= 1)
+            return;
+        size_t chunk_size = (span.size() + worker_count() - 1) / worker_count();
+        Vector<Span<T>> chunks;
+        for (size_t offset = 0; offset < span.size(); offset += chunk_size)
+            chunks.append(span.slice(offset, min(chunk_size, span.size() - offset)));
+        parallel_for(chunks.span(), [&](Span<T>& chunk) { quick_sort(chunk, less_than); });
+
+        struct Merge {
+            size_t start;
+            size_t middle;
+            size_t end;
+        };
+        Vector<Merge> merges;
+        for (size_t width = chunk_size; width < span.size(); width *= 2) {
+            merges.clear_with_capacity();
+            for (size_t start = 0; start + width < span.size(); start += 2 * width)
+                merges.append({ start, start + width, min(start + 2 * width, span.size()) });
+            parallel_for(merges.span(), [&](Merge& merge) {
+                Vector<T> buffer;
+                merge_sorted_halves(span, merge.start, merge.middle, merge.end, less_than, buffer);
+            });
+        }
+    }
+
+private:
+    struct Worker;
+
+    // Counts the jobs of one parallel_for() or parallel_reduce() that haven't finished yet.
+    class JobGroup {
+        AK_MAKE_NONCOPYABLE(JobGroup);
+        AK_MAKE_NONMOVABLE(JobGroup);
+
+    public:
+        JobGroup() = default;
+        ~JobGroup()
+        {
+            pthread_mutex_destroy(&m_mutex);
+            pthread_cond_destroy(&m_condition);
+        }
+
+        void add() { m_remaining.fetch_add(1); }
+
+        void done()
+        {
+            // The waiter may destroy the group as soon as it sees zero, so this has to happen under the mutex
+            // the waiter takes last.
+            pthread_mutex_lock(&m_mutex);
+            if (m_remaining.fetch_sub(1) == 1)
+                pthread_cond_broadcast(&m_condition);
+            pthread_mutex_unlock(&m_mutex);
+        }
+
+        bool is_done() const { return m_remaining.load() == 0; }
+
+        void wait_until_done()
+        {
+            pthread_mutex_lock(&m_mutex);
+            while (m_remaining.load() != 0)
+                pthread_cond_wait(&m_condition, &m_mutex);
+            pthread_mutex_unlock(&m_mutex);
+        }
+
+    private:
+        Atomic<size_t> m_remaining { 0 };
+        pthread_mutex_t m_mutex = PTHREAD_MUTEX_INITIALIZER;
+        pthread_cond_t m_condition = PTHREAD_COND_INITIALIZER;
+    };
+
+    explicit ThreadPool(size_t worker_count = 0);
+
+    size_t chunk_size_for(size_t element_count) const;
+
+    // Runs other jobs until every job in the group is done, then waits for the ones still running elsewhere.
+    void wait(JobGroup&);
+
+    Worker* current_worker() const;
+    Function<void()> take_job(Worker* own_worker);
+    bool run_pending_job();
+    intptr_t worker_main(Worker&);
+
+    static thread_local Worker* s_current_worker;
+
+    NonnullOwnPtrVector<Worker> m_workers;
+    Atomic<size_t> m_next_worker { 0 };
+
+    // Jobs sitting in any deque. Only ever incremented with m_sleep_mutex held, so that a worker going to
+    // sleep can't miss one.
+    Atomic<size_t> m_pending_job_count { 0 };
+    pthread_mutex_t m_sleep_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t m_wake_condition = PTHREAD_COND_INITIALIZER;
+    bool m_shutting_down { false };
+};
+
+// Sorts on ThreadPool::the() once there are enough elements to make that worth it, and with a plain
+// quick_sort() otherwise.
+template<typename T, typename LessThan>
+void parallel_sort(Span<T> span, LessThan less_than)
+{
+    static constexpr size_t parallel_sort_threshold = 16384;
+    if (span.size() < parallel_sort_threshold) {
+        quick_sort(span, less_than);
+        return;
+    }
+    ThreadPool::the().parallel_sort(span, move(less_than));
+}
+
+}
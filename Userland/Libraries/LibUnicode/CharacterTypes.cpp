@@ -106,6 +106,9 @@ static SpecialCasing const* find_matching_special_case(Utf8View const& string, s
 u32 to_unicode_lowercase(u32 code_point)
 {
 #if ENABLE_UNICODE_DATA
+    if (is_ascii(code_point))
+        return AK::to_ascii_lowercase(code_point);
+
     auto unicode_data = Detail::unicode_data_for_code_point(code_point);
     if (unicode_data.has_value())
         return unicode_data->simple_lowercase_mapping;
@@ -118,6 +121,9 @@ u32 to_unicode_lowercase(u32 code_point)
 u32 to_unicode_uppercase(u32 code_point)
 {
 #if ENABLE_UNICODE_DATA
+    if (is_ascii(code_point))
+        return AK::to_ascii_uppercase(code_point);
+
     auto unicode_data = Detail::unicode_data_for_code_point(code_point);
     if (unicode_data.has_value())
         return unicode_data->simple_uppercase_mapping;
@@ -138,6 +144,14 @@ String to_unicode_lowercase_full(StringView const& string)
         u32 code_point = *it;
         size_t byte_length = it.underlying_code_point_length_in_bytes();
 
+        // FIXME: ASCII code points only have locale-specific special casings, which will need the lookup below once
+        //        locales are handled.
+        if (is_ascii(code_point)) {
+            builder.append(static_cast<char>(AK::to_ascii_lowercase(code_point)));
+            index += byte_length;
+            continue;
+        }
+
         auto unicode_data = Detail::unicode_data_for_code_point(code_point);
         if (!unicode_data.has_value()) {
             builder.append_code_point(code_point);
@@ -173,6 +187,14 @@ String to_unicode_uppercase_full(StringView const& string)
         u32 code_point = *it;
         size_t byte_length = it.underlying_code_point_length_in_bytes();
 
+        // FIXME: ASCII code points only have locale-specific special casings, which will need the lookup below once
+        //        locales are handled.
+        if (is_ascii(code_point)) {
+            builder.append(static_cast<char>(AK::to_ascii_uppercase(code_point)));
+            index += byte_length;
+            continue;
+        }
+
         auto unicode_data = Detail::unicode_data_for_code_point(code_point);
         if (!unicode_data.has_value()) {
             builder.append_code_point(code_point);
@@ -8,6 +8,7 @@
 #include <AK/Array.h>
 #include <AK/CharacterTypes.h>
 #include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
 #include <AK/Optional.h>
 #include <AK/QuickSort.h>
 #include <AK/SourceGenerator.h>
@@ -86,7 +87,6 @@ struct UnicodeData {
     Vector<CodePointData> code_point_data;
     Vector<CodePointRange> code_point_ranges;
     Vector<String> general_categories;
-    u32 last_contiguous_code_point { 0 };
 
     PropList prop_list;
     Vector<Alias> prop_aliases;
@@ -238,9 +238,6 @@ static void parse_unicode_data(Core::File& file, UnicodeData& unicode_data)
     Optional<u32> code_point_range_start;
     Optional<u32> code_point_range_index;
 
-    Optional<u32> last_contiguous_code_point;
-    u32 previous_code_point = 0;
-
     while (file.can_read_line()) {
         auto line = file.read_line();
         if (line.is_empty())
@@ -282,9 +279,6 @@ static void parse_unicode_data(Core::File& file, UnicodeData& unicode_data)
 
             code_point_range_start.clear();
             code_point_range_index.clear();
-        } else if ((data.code_point > 0) && (data.code_point - previous_code_point) != 1) {
-            if (!last_contiguous_code_point.has_value())
-                last_contiguous_code_point = previous_code_point;
         }
 
         for (auto const& casing : unicode_data.special_casing) {
@@ -321,11 +315,8 @@ static void parse_unicode_data(Core::File& file, UnicodeData& unicode_data)
         if (!unicode_data.general_categories.contains_slow(data.general_category))
             unicode_data.general_categories.append(data.general_category);
 
-        previous_code_point = data.code_point;
         unicode_data.code_point_data.append(move(data));
     }
-
-    unicode_data.last_contiguous_code_point = *last_contiguous_code_point;
 }
 
 static void generate_unicode_data_header(UnicodeData& unicode_data)
@@ -482,39 +473,54 @@ Optional<Property> property_from_string(StringView const& property);
     outln("{}", generator.as_string_view());
 }
 
+// Code point data is looked up in two stages. The top bits of a code point select a block of code points from the first
+// stage, and the second stage holds the index into s_unicode_data of every code point in each of those blocks. Identical
+// blocks (large parts of Unicode are unassigned, or CJK ideographs) are only stored once, as are identical entries of
+// s_unicode_data. To make the latter possible, the entries leave the code point at 0 and store the case mappings relative
+// to the code point, so that all the code points of, say, a run of capital letters share the same entry.
+static constexpr u32 s_code_point_block_shift = 7;
+static constexpr u32 s_code_point_block_size = 1 << s_code_point_block_shift;
+static constexpr u16 s_unassigned_code_point_index = NumericLimits<u16>::max();
+
+static constexpr auto s_relative_fields = Array {
+    "simple_uppercase_mapping"sv,
+    "simple_lowercase_mapping"sv,
+    "simple_titlecase_mapping"sv,
+};
+
 static void generate_unicode_data_implementation(UnicodeData unicode_data)
 {
     StringBuilder builder;
     SourceGenerator generator { builder };
 
     generator.set("special_casing_size", String::number(unicode_data.special_casing.size()));
-    generator.set("code_point_data_size", String::number(unicode_data.code_point_data.size()));
-    generator.set("last_contiguous_code_point", String::formatted("0x{:x}", unicode_data.last_contiguous_code_point));
+    generator.set("block_shift", String::number(s_code_point_block_shift));
+    generator.set("block_mask", String::formatted("{:#x}", s_code_point_block_size - 1));
+    generator.set("unassigned_index", String::formatted("{:#x}", s_unassigned_code_point_index));
 
     generator.append(R"~~~(
 #include <AK/Array.h>
 #include <AK/CharacterTypes.h>
-#include <AK/Find.h>
 #include <AK/StringView.h>
 #include <LibUnicode/UnicodeData.h>
 
 namespace Unicode {
 )~~~");
 
-    auto append_list_and_size = [&](auto const& list, StringView format) {
+    auto append_list_and_size = [&](StringBuilder& builder, auto const& list, StringView format) {
         if (list.is_empty()) {
-            generator.append(", {}, 0");
+            builder.append(", {}, 0");
             return;
         }
 
         bool first = true;
-        generator.append(", {");
+        builder.append(", {");
         for (auto const& item : list) {
-            generator.append(first ? " " : ", ");
-            generator.append(String::formatted(format, item));
+            builder.append(first ? " " : ", ");
+            builder.append(String::formatted(format, item));
             first = false;
         }
-        generator.append(String::formatted(" }}, {}", list.size()));
+        builder.append(String::formatted(" }}, {}", list.size()));
     };
 
     generator.append(R"~~~(
@@ -526,9 +532,9 @@ static constexpr Array<SpecialCasing, @special_casing_size@> s_special_casing {
     { @code_point@)~~~");
 
         constexpr auto format = "0x{:x}"sv;
-        append_list_and_size(casing.lowercase_mapping, format);
-        append_list_and_size(casing.uppercase_mapping, format);
-        append_list_and_size(casing.titlecase_mapping, format);
+        append_list_and_size(builder, casing.lowercase_mapping, format);
+        append_list_and_size(builder, casing.uppercase_mapping, format);
+        append_list_and_size(builder, casing.titlecase_mapping, format);
 
         generator.set("locale", casing.locale.is_empty() ? "None" : casing.locale);
         generator.append(", Locale::@locale@");
@@ -541,21 +547,24 @@ static constexpr Array<SpecialCasing, @special_casing_size@> s_special_casing {
 
     generator.append(R"~~~(
 } };
+)~~~");
 
-static constexpr Array<UnicodeData, @code_point_data_size@> s_unicode_data { {)~~~");
+    auto format_entry = [&](CodePointData const& data) {
+        StringBuilder entry;
+        entry.append("{ 0");
 
-    auto append_field = [&](StringView name, String value) {
-        if (!s_desired_fields.span().contains_slow(name))
-            return;
+        auto append_field = [&](StringView name, String value) {
+            if (!s_desired_fields.span().contains_slow(name))
+                return;
 
-        generator.set("value", move(value));
-        generator.append(", @value@");
-    };
+            entry.append(", ");
+            entry.append(value);
+        };
 
-    for (auto const& data : unicode_data.code_point_data) {
-        generator.set("code_point", String::formatted("{:#x}", data.code_point));
-        generator.append(R"~~~(
-    { @code_point@)~~~");
+        // Note: The relative mappings are meant to wrap around, as they are added back to the code point as a u32.
+        auto relative_mapping = [&](Optional<u32> const& mapping) {
+            return String::formatted("{:#x}", mapping.value_or(data.code_point) - data.code_point);
+        };
 
         append_field("name", String::formatted("\"{}\"", data.name));
         append_field("general_category", String::formatted("GeneralCategory::{}", data.general_category));
@@ -568,41 +577,111 @@ static constexpr Array<UnicodeData, @code_point_data_size@> s_unicode_data { {)~
         append_field("bidi_mirrored", String::formatted("{}", data.bidi_mirrored));
         append_field("unicode_1_name", String::formatted("\"{}\"", data.unicode_1_name));
         append_field("iso_comment", String::formatted("\"{}\"", data.iso_comment));
-        append_field("simple_uppercase_mapping", String::formatted("{:#x}", data.simple_uppercase_mapping.value_or(data.code_point)));
-        append_field("simple_lowercase_mapping", String::formatted("{:#x}", data.simple_lowercase_mapping.value_or(data.code_point)));
-        append_field("simple_titlecase_mapping", String::formatted("{:#x}", data.simple_titlecase_mapping.value_or(data.code_point)));
-        append_list_and_size(data.special_casing_indices, "&s_special_casing[{}]"sv);
+        append_field("simple_uppercase_mapping", relative_mapping(data.simple_uppercase_mapping));
+        append_field("simple_lowercase_mapping", relative_mapping(data.simple_lowercase_mapping));
+        append_field("simple_titlecase_mapping", relative_mapping(data.simple_titlecase_mapping));
+        append_list_and_size(entry, data.special_casing_indices, "&s_special_casing[{}]"sv);
 
         bool first = true;
         for (auto const& property : data.prop_list) {
-            generator.append(first ? ", " : " | ");
-            generator.append(String::formatted("Property::{}", property));
+            entry.append(first ? ", " : " | ");
+            entry.append(String::formatted("Property::{}", property));
             first = false;
         }
 
-        generator.append(String::formatted(", WordBreakProperty::{}", data.word_break_property));
-        generator.append(" },");
+        entry.append(String::formatted(", WordBreakProperty::{}", data.word_break_property));
+        entry.append(" }");
+        return entry.build();
+    };
+
+    Vector<String> entries;
+    HashMap<String, u16> entry_indices;
+
+    Vector<u16> code_point_indices;
+    code_point_indices.ensure_capacity(0x110000);
+    for (u32 code_point = 0; code_point < 0x110000; ++code_point)
+        code_point_indices.unchecked_append(s_unassigned_code_point_index);
+
+    for (auto const& data : unicode_data.code_point_data) {
+        auto entry = format_entry(data);
+
+        auto index = entry_indices.get(entry);
+        if (!index.has_value()) {
+            VERIFY(entries.size() < s_unassigned_code_point_index);
+            index = static_cast<u16>(entries.size());
+            entry_indices.set(entry, *index);
+            entries.append(move(entry));
+        }
+
+        code_point_indices[data.code_point] = *index;
+    }
+
+    for (auto const& range : unicode_data.code_point_ranges) {
+        auto index = code_point_indices[unicode_data.code_point_data[range.index].code_point];
+        for (u32 code_point = range.first; code_point <= range.last; ++code_point)
+            code_point_indices[code_point] = index;
+    }
+
+    Vector<u16> block_indices;
+    Vector<String> blocks;
+    HashMap<String, u16> unique_block_indices;
+
+    for (size_t block_start = 0; block_start < code_point_indices.size(); block_start += s_code_point_block_size) {
+        StringBuilder block;
+        for (size_t i = 0; i < s_code_point_block_size; ++i) {
+            if (i != 0)
+                block.append(i % 16 ? ", " : ",\n    ");
+            block.append(String::number(code_point_indices[block_start + i]));
+        }
+
+        auto block_string = block.build();
+        auto index = unique_block_indices.get(block_string);
+        if (!index.has_value()) {
+            index = static_cast<u16>(blocks.size());
+            unique_block_indices.set(block_string, *index);
+            blocks.append(move(block_string));
+        }
+
+        block_indices.append(*index);
+    }
+
+    generator.set("unicode_data_size", String::number(entries.size()));
+    generator.set("block_indices_size", String::number(block_indices.size()));
+    generator.set("blocks_size", String::number(blocks.size() * s_code_point_block_size));
+
+    generator.append(R"~~~(
+static constexpr Array<UnicodeData, @unicode_data_size@> s_unicode_data { {)~~~");
+
+    for (auto const& entry : entries) {
+        generator.append("\n    ");
+        generator.append(entry);
+        generator.append(",");
     }
 
     generator.append(R"~~~(
 } };
 
-static Optional<u32> index_of_code_point_in_range(u32 code_point)
-{)~~~");
+static constexpr Array<u16, @block_indices_size@> s_code_point_block_indices { {)~~~");
 
-    for (auto const& range : unicode_data.code_point_ranges) {
-        generator.set("index", String::formatted("{}", range.index));
-        generator.set("first", String::formatted("{:#x}", range.first));
-        generator.set("last", String::formatted("{:#x}", range.last));
+    for (size_t i = 0; i < block_indices.size(); ++i) {
+        generator.append(i % 16 ? " " : "\n    ");
+        generator.append(String::number(block_indices[i]));
+        generator.append(",");
+    }
 
-        generator.append(R"~~~(
-    if ((code_point > @first@) && (code_point < @last@))
-        return @index@;)~~~");
+    generator.append(R"~~~(
+} };
+
+static constexpr Array<u16, @blocks_size@> s_code_point_blocks { {)~~~");
+
+    for (auto const& block : blocks) {
+        generator.append("\n    ");
+        generator.append(block);
+        generator.append(",");
     }
 
     generator.append(R"~~~(
-    return {};
-}
+} };
 
 namespace Detail {
 
@@ -610,21 +689,25 @@ Optional<UnicodeData> unicode_data_for_code_point(u32 code_point)
 {
     VERIFY(is_unicode(code_point));
 
-    if (code_point <= @last_contiguous_code_point@)
-        return s_unicode_data[code_point];
+    auto block_index = s_code_point_block_indices[code_point >> @block_shift@];
+    auto index = s_code_point_blocks[(block_index << @block_shift@) | (code_point & @block_mask@)];
+    if (index == @unassigned_index@)
+        return {};
 
-    if (auto index = index_of_code_point_in_range(code_point); index.has_value()) {
-        auto data_for_range = s_unicode_data[*index];
-        data_for_range.simple_uppercase_mapping = code_point;
-        data_for_range.simple_lowercase_mapping = code_point;
-        return data_for_range;
-    }
+    auto data = s_unicode_data[index];
+    data.code_point = code_point;)~~~");
 
-    auto it = AK::find_if(s_unicode_data.begin(), s_unicode_data.end(), [code_point](auto const& data) { return data.code_point == code_point; });
-    if (it != s_unicode_data.end())
-        return *it;
+    for (auto const& field : s_relative_fields) {
+        if (!s_desired_fields.span().contains_slow(field))
+            continue;
 
-    return {};
+        generator.set("field", field);
+        generator.append(R"~~~(
+    data.@field@ += code_point;)~~~");
+    }
+
+    generator.append(R"~~~(
+    return data;
 }
 
 Optional<Property> property_from_string(StringView const& property)
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <LibVT/Line.h>
 
 namespace VT {
@@ -23,6 +24,10 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
     if (old_length == new_length)
         return;
 
+    expand();
+    if (next_line)
+        next_line->expand();
+
     // Drop the empty cells
     if (m_terminated_at.has_value() && m_cells.size() > m_terminated_at.value())
         m_cells.remove(m_terminated_at.value(), m_cells.size() - m_terminated_at.value());
@@ -38,6 +43,9 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
 
 void Line::set_length(size_t new_length)
 {
+    if (length() == new_length)
+        return;
+    expand();
     m_cells.resize(new_length);
 }
 
@@ -120,6 +128,7 @@ void Line::take_cells_from_next_line(size_t new_length, Line* next_line, bool cu
 
 void Line::clear_range(size_t first_column, size_t last_column, const Attribute& attribute)
 {
+    expand();
     VERIFY(first_column <= last_column);
     VERIFY(last_column < m_cells.size());
     for (size_t i = first_column; i <= last_column; ++i) {
@@ -143,4 +152,86 @@ bool Line::has_only_one_background_color() const
     return true;
 }
 
+static bool have_same_attribute(const Attribute& a, const Attribute& b)
+{
+#ifndef KERNEL
+    if (a.href != b.href || a.href_id != b.href_id)
+        return false;
+#endif
+    return a == b;
+}
+
+void Line::compact()
+{
+    if (is_compact())
+        return;
+
+    if (all_of(m_cells.begin(), m_cells.end(), [](auto& cell) { return cell.code_point <= 0xff; })) {
+        m_narrow_code_points.ensure_capacity(m_cells.size());
+        for (auto& cell : m_cells)
+            m_narrow_code_points.unchecked_append(cell.code_point);
+    } else {
+        m_wide_code_points.ensure_capacity(m_cells.size());
+        for (auto& cell : m_cells)
+            m_wide_code_points.unchecked_append(cell.code_point);
+    }
+
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        if (m_attribute_runs.is_empty() || !have_same_attribute(m_attribute_runs.last().attribute, m_cells[i].attribute))
+            m_attribute_runs.append({ static_cast<u16>(i), m_cells[i].attribute });
+    }
+
+    m_cells.clear();
+    m_is_compact = true;
+}
+
+void Line::expand_compact_cells()
+{
+    VERIFY(is_compact());
+    auto length = this->length();
+    m_cells.ensure_capacity(length);
+    size_t run_index = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (run_index + 1 < m_attribute_runs.size() && m_attribute_runs[run_index + 1].first_column <= i)
+            ++run_index;
+        m_cells.unchecked_append({ code_point(i), m_attribute_runs[run_index].attribute });
+    }
+    discard_compact_cells();
+}
+
+void Line::discard_compact_cells()
+{
+    VERIFY(is_compact());
+    auto length = this->length();
+    m_narrow_code_points.clear();
+    m_wide_code_points.clear();
+    m_attribute_runs.clear();
+    m_is_compact = false;
+    m_cells.resize(length);
+}
+
+const Attribute& Line::compact_attribute_at(size_t index) const
+{
+    VERIFY(index < length());
+    // Find the last run that starts at or before the index.
+    size_t low = 0;
+    size_t high = m_attribute_runs.size();
+    while (high - low > 1) {
+        auto middle = low + (high - low) / 2;
+        if (m_attribute_runs[middle].first_column <= index)
+            low = middle;
+        else
+            high = middle;
+    }
+    return m_attribute_runs[low].attribute;
+}
+
+bool Line::compact_is_empty() const
+{
+    auto is_blank = [](auto code_point) { return code_point == ' '; };
+    if (!all_of(m_narrow_code_points.begin(), m_narrow_code_points.end(), is_blank) || !all_of(m_wide_code_points.begin(), m_wide_code_points.end(), is_blank))
+        return false;
+    return all_of(m_attribute_runs.begin(), m_attribute_runs.end(), [](auto& run) { return run.attribute == Attribute(); });
+}
+
 }
@@ -30,15 +30,29 @@ public:
         bool operator!=(Cell const& other) const { return code_point != other.code_point || attribute != other.attribute; }
     };
 
-    const Attribute& attribute_at(size_t index) const { return m_cells[index].attribute; }
-    Attribute& attribute_at(size_t index) { return m_cells[index].attribute; }
+    const Attribute& attribute_at(size_t index) const
+    {
+        if (is_compact())
+            return compact_attribute_at(index);
+        return m_cells[index].attribute;
+    }
+    Attribute& attribute_at(size_t index)
+    {
+        expand();
+        return m_cells[index].attribute;
+    }
 
-    Cell& cell_at(size_t index) { return m_cells[index]; }
-    const Cell& cell_at(size_t index) const { return m_cells[index]; }
+    Cell& cell_at(size_t index)
+    {
+        expand();
+        return m_cells[index];
+    }
 
     void clear(const Attribute& attribute = Attribute())
     {
         m_terminated_at.clear();
+        if (is_compact())
+            discard_compact_cells();
         clear_range(0, m_cells.size() - 1, attribute);
     }
     void clear_range(size_t first_column, size_t last_column, const Attribute& attribute = Attribute());
@@ -46,11 +60,15 @@ public:
 
     bool is_empty() const
     {
+        if (is_compact())
+            return compact_is_empty();
         return !any_of(m_cells.begin(), m_cells.end(), [](auto& cell) { return cell != Cell(); });
     }
 
     size_t length() const
     {
+        if (is_compact())
+            return m_wide_code_points.is_empty() ? m_narrow_code_points.size() : m_wide_code_points.size();
         return m_cells.size();
     }
     void set_length(size_t);
@@ -58,11 +76,14 @@ public:
 
     u32 code_point(size_t index) const
     {
+        if (is_compact())
+            return m_wide_code_points.is_empty() ? m_narrow_code_points[index] : m_wide_code_points[index];
         return m_cells[index].code_point;
     }
 
     void set_code_point(size_t index, u32 code_point)
     {
+        expand();
         if (m_terminated_at.has_value()) {
             if (index > *m_terminated_at) {
                 m_terminated_at = index + 1;
@@ -78,7 +99,23 @@ public:
     Optional<u16> termination_column() const { return m_terminated_at; }
     void set_terminated(u16 column) { m_terminated_at = column; }
 
+    // Lines in the scrollback don't change anymore, so they're stored in a fraction of the space: one
+    // byte per code point unless the line needs more, and each run of cells with the same attribute
+    // only once. Anything that changes the line turns it back into cells first.
+    void compact();
+    bool is_compact() const { return m_is_compact; }
+
 private:
+    void expand()
+    {
+        if (is_compact())
+            expand_compact_cells();
+    }
+    void expand_compact_cells();
+    void discard_compact_cells();
+    const Attribute& compact_attribute_at(size_t index) const;
+    bool compact_is_empty() const;
+
     void take_cells_from_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
     void push_cells_into_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
 
@@ -86,6 +123,17 @@ private:
     bool m_dirty { false };
     // Note: The alignment is 8, so this member lives in the padding (that already existed before it was introduced)
     [[no_unique_address]] Optional<u16> m_terminated_at;
+
+    struct AttributeRun {
+        u16 first_column { 0 };
+        Attribute attribute;
+    };
+
+    // Only one of these is used, depending on whether any code point is above U+00FF.
+    Vector<u8> m_narrow_code_points;
+    Vector<u32> m_wide_code_points;
+    Vector<AttributeRun> m_attribute_runs;
+    bool m_is_compact { false };
 };
 
 }
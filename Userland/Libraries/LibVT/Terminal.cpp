@@ -46,6 +46,22 @@ void Terminal::clear_history()
     m_history_start = 0;
     m_client.terminal_history_changed(-previous_history_size);
 }
+
+void Terminal::linearize_history()
+{
+    if (m_history_start == 0)
+        return;
+    // Rotating by reversing both parts and then the whole thing only swaps pointers, and doesn't need another vector.
+    auto& lines = static_cast<Vector<NonnullOwnPtr<Line>>&>(m_history);
+    auto reverse = [&](size_t start, size_t end) {
+        while (start + 1 < end)
+            swap(lines[start++], lines[--end]);
+    };
+    reverse(0, m_history_start);
+    reverse(m_history_start, lines.size());
+    reverse(0, lines.size());
+    m_history_start = 0;
+}
 #endif
 
 void Terminal::alter_ansi_mode(bool should_set, Parameters params)
@@ -794,8 +810,12 @@ void Terminal::scroll_up(u16 region_top, u16 region_bottom, size_t count)
     }
     // Set dirty flag on swapped lines.
     // The other lines have implicitly been set dirty by being cleared.
-    for (u16 row = region_top; row <= region_bottom - count; ++row)
-        active_buffer()[row].set_dirty(true);
+    if (region_top == 0 && region_bottom == rows() - 1) {
+        m_rows_scrolled_since_flush += count;
+    } else {
+        for (u16 row = region_top; row <= region_bottom - count; ++row)
+            active_buffer()[row].set_dirty(true);
+    }
     m_client.terminal_history_changed(history_delta);
 }
 
@@ -1495,6 +1515,7 @@ void Terminal::set_size(u16 columns, u16 rows)
     };
 
     auto old_history_size = m_history.size();
+    linearize_history();
     m_history.extend(move(m_normal_screen_buffer));
     CursorPosition cursor_tracker { cursor_row() + old_history_size, cursor_column() };
     resize_and_rewrap(m_history, cursor_tracker);
@@ -1525,6 +1546,11 @@ void Terminal::set_size(u16 columns, u16 rows)
 
     cursor_tracker.row -= m_history.size();
 
+    // Rewrapping turned some of the history back into cells, and the screen lines that scrolled into it
+    // haven't been compacted yet.
+    for (auto& line : m_history)
+        line.compact();
+
     if (m_history.size() != old_history_size) {
         m_client.terminal_history_changed(-old_history_size);
         m_client.terminal_history_changed(m_history.size());
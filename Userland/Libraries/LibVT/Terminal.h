@@ -63,6 +63,9 @@ public:
     }
 
     bool m_need_full_flush { false };
+    // How many rows the whole screen scrolled up since the client last flushed. The lines that moved aren't marked
+    // as dirty, as the client can move what it has already drawn of them instead.
+    size_t m_rows_scrolled_since_flush { 0 };
 
 #ifndef KERNEL
     void invalidate_cursor();
@@ -150,15 +153,10 @@ public:
         }
 
         if (m_max_history_lines > value) {
-            NonnullOwnPtrVector<Line> new_history;
-            new_history.ensure_capacity(value);
+            // Drop the oldest lines, which are the first ones once the ring starts at the beginning.
+            linearize_history();
             auto existing_line_count = min(m_history.size(), value);
-            for (size_t i = m_history.size() - existing_line_count; i < m_history.size(); ++i) {
-                auto j = (m_history_start + i) % m_history.size();
-                new_history.unchecked_append(move(static_cast<Vector<NonnullOwnPtr<Line>>&>(m_history).at(j)));
-            }
-            m_history = move(new_history);
-            m_history_start = 0;
+            m_history.remove(0, m_history.size() - existing_line_count);
             m_client.terminal_history_changed(value - existing_line_count);
         }
         m_max_history_lines = value;
@@ -369,6 +367,8 @@ protected:
 
     EscapeSequenceParser m_parser;
 #ifndef KERNEL
+    // Once it has grown to max_history_size(), the history is a ring whose oldest line is at m_history_start,
+    // and each new line takes the place of the oldest one. The lines in it are all compact.
     size_t m_history_start = 0;
     NonnullOwnPtrVector<Line> m_history;
     void add_line_to_history(NonnullOwnPtr<Line>&& line)
@@ -376,6 +376,7 @@ protected:
         if (max_history_size() == 0)
             return;
 
+        line->compact();
         if (m_history.size() < max_history_size()) {
             VERIFY(m_history_start == 0);
             m_history.append(move(line));
@@ -384,6 +385,8 @@ protected:
         m_history.ptr_at(m_history_start) = move(line);
         m_history_start = (m_history_start + 1) % m_history.size();
     }
+    // Rotates the ring so that it starts at the beginning of m_history.
+    void linearize_history();
 
     NonnullOwnPtrVector<Line>& active_buffer() { return m_use_alternate_screen_buffer ? m_alternate_screen_buffer : m_normal_screen_buffer; };
     const NonnullOwnPtrVector<Line>& active_buffer() const { return m_use_alternate_screen_buffer ? m_alternate_screen_buffer : m_normal_screen_buffer; };
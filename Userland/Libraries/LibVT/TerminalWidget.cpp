@@ -6,6 +6,7 @@
 
 #include "TerminalWidget.h"
 #include <AK/LexicalPath.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -19,6 +20,7 @@
 #include <LibGUI/Action.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/Clipboard.h>
+#include <LibGUI/DisplayLink.h>
 #include <LibGUI/DragOperation.h>
 #include <LibGUI/Icon.h>
 #include <LibGUI/Menu.h>
@@ -31,6 +33,7 @@
 #include <LibGfx/StylePainter.h>
 #include <ctype.h>
 #include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -48,28 +51,41 @@ void TerminalWidget::set_pty_master_fd(int fd)
     }
     m_notifier = Core::Notifier::construct(m_ptm_fd, Core::Notifier::Read);
     m_notifier->on_ready_to_read = [this] {
-        u8 buffer[BUFSIZ];
-        ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
-        if (nread < 0) {
-            dbgln("Terminal read error: {}", strerror(errno));
-            perror("read(ptm)");
-            GUI::Application::the()->quit(1);
-            return;
-        }
-        if (nread == 0) {
-            dbgln("TerminalWidget: EOF on master pty, firing on_command_exit hook.");
-            if (on_command_exit)
-                on_command_exit();
-            int rc = close(m_ptm_fd);
-            if (rc < 0) {
-                perror("close");
+        // Take in everything that's there before painting anything, but don't hold up the event loop forever
+        // with a program that never stops writing.
+        Core::ElapsedTimer elapsed_timer;
+        elapsed_timer.start();
+        for (;;) {
+            u8 buffer[BUFSIZ];
+            ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
+            if (nread < 0) {
+                dbgln("Terminal read error: {}", strerror(errno));
+                perror("read(ptm)");
+                GUI::Application::the()->quit(1);
+                return;
             }
-            set_pty_master_fd(-1);
-            return;
+            if (nread == 0) {
+                flush_dirty_lines();
+                dbgln("TerminalWidget: EOF on master pty, firing on_command_exit hook.");
+                if (on_command_exit)
+                    on_command_exit();
+                int rc = close(m_ptm_fd);
+                if (rc < 0) {
+                    perror("close");
+                }
+                set_pty_master_fd(-1);
+                return;
+            }
+            for (ssize_t i = 0; i < nread; ++i)
+                m_terminal.on_input(buffer[i]);
+
+            if (static_cast<size_t>(nread) < sizeof(buffer) || elapsed_timer.elapsed() >= 10)
+                break;
+            pollfd poll_fd { m_ptm_fd, POLLIN, 0 };
+            if (poll(&poll_fd, 1, 0) <= 0 || !(poll_fd.revents & POLLIN))
+                break;
         }
-        for (ssize_t i = 0; i < nread; ++i)
-            m_terminal.on_input(buffer[i]);
-        flush_dirty_lines();
+        schedule_flush();
     };
 }
 
@@ -151,6 +167,8 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy, RefPtr<Co
 
 TerminalWidget::~TerminalWidget()
 {
+    if (m_flush_display_link_id)
+        GUI::DisplayLink::unregister_callback(m_flush_display_link_id);
 }
 
 Gfx::IntRect TerminalWidget::glyph_rect(u16 row, u16 column)
@@ -260,18 +278,48 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
 {
     GUI::Frame::paint_event(event);
 
-    GUI::Painter painter(*this);
+    GUI::Painter widget_painter(*this);
 
     auto visual_beep_active = m_visual_beep_timer->is_active();
 
-    painter.add_clip_rect(event.rect());
+    widget_painter.add_clip_rect(event.rect());
 
     Gfx::IntRect terminal_buffer_rect(frame_inner_rect().top_left(), { frame_inner_rect().width() - m_scrollbar->width(), frame_inner_rect().height() });
+    widget_painter.add_clip_rect(terminal_buffer_rect);
+
+    // The rows are rendered into m_rendered_rows, which then goes onto the window as a whole.
+    if (!m_rendered_rows || m_rendered_rows->size() != size() || m_rendered_rows->scale() != widget_painter.target()->scale()) {
+        m_rendered_rows = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, size(), widget_painter.target()->scale());
+        if (!m_rendered_rows)
+            return;
+        invalidate_rendered_rows();
+    }
+    bool can_reuse_rows = !m_reusable_rows.is_empty()
+        && !visual_beep_active
+        && !has_selection()
+        && m_hovered_href_id.is_null()
+        && m_scrollbar->value() == m_scrollbar->max();
+    auto should_render_row = [&](u16 visual_row) {
+        if (!event.rect().contains(row_rect(visual_row)))
+            return false;
+        return !can_reuse_rows || visual_row >= m_reusable_rows.size() || !m_reusable_rows[visual_row];
+    };
+
+    ScopeGuard blit_rendered_rows = [&] {
+        m_reusable_rows.clear();
+        if (event.rect().contains(terminal_buffer_rect))
+            m_rendered_rows_are_stale = false;
+        widget_painter.blit(terminal_buffer_rect.location(), *m_rendered_rows, terminal_buffer_rect, 1.0f, false);
+    };
+
+    Gfx::Painter painter(*m_rendered_rows);
+    painter.add_clip_rect(event.rect());
     painter.add_clip_rect(terminal_buffer_rect);
 
+    // Rows that are rendered fill their whole rect anyway.
     if (visual_beep_active)
         painter.clear_rect(frame_inner_rect(), terminal_color_to_rgb(VT::Color::named(VT::Color::ANSIColor::Red)));
-    else
+    else if (!can_reuse_rows)
         painter.clear_rect(frame_inner_rect(), terminal_color_to_rgb(VT::Color::named(VT::Color::ANSIColor::DefaultBackground)).with_alpha(m_opacity));
     invalidate_cursor();
 
@@ -288,7 +336,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
     Vector<Gfx::IntRect> hovered_href_rects;
     if (!m_hovered_href_id.is_null()) {
         for (u16 visual_row = 0; visual_row < m_terminal.rows(); ++visual_row) {
-            auto& line = m_terminal.line(first_row_from_history + visual_row);
+            const auto& line = m_terminal.line(first_row_from_history + visual_row);
             for (size_t column = 0; column < line.length(); ++column) {
                 if (m_hovered_href_id == line.attribute_at(column).href_id) {
                     bool merged_with_existing_rect = false;
@@ -309,10 +357,10 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
 
     // Pass: Paint background & text decorations.
     for (u16 visual_row = 0; visual_row < m_terminal.rows(); ++visual_row) {
-        auto row_rect = this->row_rect(visual_row);
-        if (!event.rect().contains(row_rect))
+        if (!should_render_row(visual_row))
             continue;
-        auto& line = m_terminal.line(first_row_from_history + visual_row);
+        auto row_rect = this->row_rect(visual_row);
+        const auto& line = m_terminal.line(first_row_from_history + visual_row);
         bool has_only_one_background_color = line.has_only_one_background_color();
         if (visual_beep_active)
             painter.clear_rect(row_rect, terminal_color_to_rgb(VT::Color::named(VT::Color::ANSIColor::Red)));
@@ -388,10 +436,9 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
 
     // Pass: Paint foreground (text).
     for (u16 visual_row = 0; visual_row < m_terminal.rows(); ++visual_row) {
-        auto row_rect = this->row_rect(visual_row);
-        if (!event.rect().contains(row_rect))
+        if (!should_render_row(visual_row))
             continue;
-        auto& line = m_terminal.line(first_row_from_history + visual_row);
+        const auto& line = m_terminal.line(first_row_from_history + visual_row);
         for (size_t column = 0; column < line.length(); ++column) {
             auto attribute = line.attribute_at(column);
             bool should_reverse_fill_for_cursor_or_selection = m_cursor_blink_state
@@ -423,7 +470,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
 
     // Draw cursor.
     if (m_cursor_blink_state && row_with_cursor < m_terminal.rows()) {
-        auto& cursor_line = m_terminal.line(first_row_from_history + row_with_cursor);
+        const auto& cursor_line = m_terminal.line(first_row_from_history + row_with_cursor);
         if (m_terminal.cursor_row() >= (m_terminal.rows() - rows_from_history))
             return;
 
@@ -477,22 +524,72 @@ void TerminalWidget::invalidate_cursor()
 
 void TerminalWidget::flush_dirty_lines()
 {
+    auto scrolled_rows = exchange(m_terminal.m_rows_scrolled_since_flush, 0);
     // FIXME: Update smarter when scrolled
-    if (m_terminal.m_need_full_flush || m_scrollbar->value() != m_scrollbar->max()) {
+    if (m_terminal.m_need_full_flush || m_scrollbar->value() != m_scrollbar->max() || (scrolled_rows && !scroll_rendered_rows(scrolled_rows))) {
         update();
         m_terminal.m_need_full_flush = false;
+        invalidate_rendered_rows();
         return;
     }
     Gfx::IntRect rect;
+    // Everything moved, but only the rows that came into view or changed have to be rendered again.
+    if (scrolled_rows)
+        rect = row_rect(0).united(row_rect(m_terminal.rows() - 1));
     for (int i = 0; i < m_terminal.rows(); ++i) {
         if (m_terminal.visible_line(i).is_dirty()) {
             rect = rect.united(row_rect(i));
             m_terminal.visible_line(i).set_dirty(false);
+            if (static_cast<size_t>(i) < m_reusable_rows.size())
+                m_reusable_rows[i] = false;
         }
     }
     update(rect);
 }
 
+// Flushes once the next frame is due, so that output arriving faster than it can be shown only gets painted once per frame.
+void TerminalWidget::schedule_flush()
+{
+    if (m_flush_display_link_id)
+        return;
+    m_flush_display_link_id = GUI::DisplayLink::register_callback([this](i32) {
+        GUI::DisplayLink::unregister_callback(exchange(m_flush_display_link_id, 0));
+        flush_dirty_lines();
+    });
+}
+
+// Moves the rendered rows up along with the text when the whole screen scrolled.
+// Returns false if they have to be rendered from scratch anyway.
+bool TerminalWidget::scroll_rendered_rows(size_t count)
+{
+    size_t rows = m_terminal.rows();
+    if (!m_rendered_rows || m_rendered_rows_are_stale || m_rendered_rows->size() != size() || count >= rows)
+        return false;
+    if (has_selection() || !m_hovered_href_id.is_null() || m_visual_beep_timer->is_active())
+        return false;
+
+    // Rows that still had to be rendered before this scroll still have to be rendered after it.
+    Vector<bool> reusable_rows;
+    reusable_rows.resize(rows);
+    for (size_t row = 0; row + count < rows; ++row)
+        reusable_rows[row] = m_reusable_rows.is_empty() || (row + count < m_reusable_rows.size() && m_reusable_rows[row + count]);
+    m_reusable_rows = move(reusable_rows);
+
+    int scale = m_rendered_rows->scale();
+    auto physical_rect = row_rect(0).united(row_rect(rows - 1)).intersected(m_rendered_rows->rect()) * scale;
+    int distance = count * m_line_height * scale;
+    size_t bytes_per_row = physical_rect.width() * sizeof(Gfx::RGBA32);
+    for (int y = physical_rect.top(); y + distance <= physical_rect.bottom(); ++y)
+        memcpy(m_rendered_rows->scanline(y) + physical_rect.left(), m_rendered_rows->scanline(y + distance) + physical_rect.left(), bytes_per_row);
+    return true;
+}
+
+void TerminalWidget::invalidate_rendered_rows()
+{
+    m_reusable_rows.clear();
+    m_rendered_rows_are_stale = true;
+}
+
 void TerminalWidget::resize_event(GUI::ResizeEvent& event)
 {
     relayout(event.size());
@@ -546,6 +643,7 @@ void TerminalWidget::set_opacity(u8 new_opacity)
 
     window()->set_has_alpha_channel(new_opacity < 255);
     m_opacity = new_opacity;
+    invalidate_rendered_rows();
     update();
 }
 
@@ -727,7 +825,7 @@ void TerminalWidget::doubleclick_event(GUI::MouseEvent& event)
         m_triple_click_timer.start();
 
         auto position = buffer_position_at(event.position());
-        auto& line = m_terminal.line(position.row());
+        const auto& line = m_terminal.line(position.row());
         bool want_whitespace = line.code_point(position.column()) == ' ';
 
         int start_column = 0;
@@ -919,7 +1017,7 @@ String TerminalWidget::selected_text() const
         int first_column = first_selection_column_on_row(row);
         int last_column = last_selection_column_on_row(row);
         for (int column = first_column; column <= last_column; ++column) {
-            auto& line = m_terminal.line(row);
+            const auto& line = m_terminal.line(row);
             if (line.attribute_at(column).is_untouched()) {
                 builder.append('\n');
                 break;
@@ -962,6 +1060,8 @@ void TerminalWidget::terminal_history_changed(int delta)
 
 void TerminalWidget::terminal_did_resize(u16 columns, u16 rows)
 {
+    invalidate_rendered_rows();
+
     auto pixel_size = widget_size_for_font(font());
     m_pixel_width = pixel_size.width();
     m_pixel_height = pixel_size.height();
@@ -1118,6 +1218,7 @@ void TerminalWidget::did_change_font()
 {
     GUI::Frame::did_change_font();
     m_line_height = font().glyph_height() + m_line_spacing;
+    invalidate_rendered_rows();
     if (!size().is_empty())
         relayout(size());
 }
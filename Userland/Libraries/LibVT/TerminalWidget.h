@@ -140,6 +140,10 @@ private:
     void update_cursor();
     void invalidate_cursor();
 
+    void schedule_flush();
+    bool scroll_rendered_rows(size_t count);
+    void invalidate_rendered_rows();
+
     void relayout(const Gfx::IntSize&);
 
     void update_copy_action();
@@ -190,6 +194,13 @@ private:
     bool m_in_relayout { false };
 
     RefPtr<Core::Notifier> m_notifier;
+    i32 m_flush_display_link_id { 0 };
+
+    // The rows as they were last painted, so that a paint only has to render the ones that changed.
+    RefPtr<Gfx::Bitmap> m_rendered_rows;
+    bool m_rendered_rows_are_stale { true };
+    // Rows of m_rendered_rows that the next paint can leave alone, since they only moved up when the output scrolled.
+    Vector<bool> m_reusable_rows;
 
     u8 m_opacity { 255 };
     bool m_cursor_blink_state { true };
@@ -171,8 +171,9 @@ bool Decoder::reconstruct(size_t, u32, u32, TXSize)
 bool Decoder::update_reference_frames()
 {
     for (auto i = 0; i < NUM_REF_FRAMES; i++) {
-        dbgln("updating frame {}? {}", i, (m_parser->m_refresh_frame_flags & (1 << i)) == 1);
-        if ((m_parser->m_refresh_frame_flags & (1 << i)) != 1)
+        bool should_refresh = m_parser->m_refresh_frame_flags & (1 << i);
+        dbgln("updating frame {}? {}", i, should_refresh);
+        if (!should_refresh)
             continue;
         m_parser->m_ref_frame_width[i] = m_parser->m_frame_width;
         m_parser->m_ref_frame_height[i] = m_parser->m_frame_height;
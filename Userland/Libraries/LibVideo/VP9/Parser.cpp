@@ -65,6 +65,10 @@ bool Parser::parse_frame(ByteBuffer const& frame_data)
         dbgln("No header");
         return true;
     }
+    // The uncompressed header ends on a byte boundary, and the tiles start right after the compressed header.
+    size_t tiles_offset = frame_data.size() - m_bit_stream->bytes_remaining() + m_header_size_in_bytes;
+    if (tiles_offset > frame_data.size())
+        return false;
     m_probability_tables->load_probs(m_frame_context_idx);
     m_probability_tables->load_probs2(m_frame_context_idx);
     m_syntax_element_counter->clear_counts();
@@ -75,7 +79,7 @@ bool Parser::parse_frame(ByteBuffer const& frame_data)
     dbgln("Finished reading compressed header");
     SAFE_CALL(m_bit_stream->exit_bool());
 
-    SAFE_CALL(decode_tiles());
+    SAFE_CALL(decode_tiles(frame_data.bytes().slice(tiles_offset)));
     SAFE_CALL(refresh_probs());
 
     dbgln("Finished reading frame!");
@@ -758,28 +762,54 @@ void Parser::allocate_tile_data()
     m_allocated_dimensions = dimensions;
 }
 
-bool Parser::decode_tiles()
+bool Parser::locate_tiles(ReadonlyBytes data)
 {
     auto tile_cols = 1 << m_tile_cols_log2;
     auto tile_rows = 1 << m_tile_rows_log2;
-    allocate_tile_data();
-    SAFE_CALL(clear_above_context());
+    m_tiles.clear_with_capacity();
     for (auto tile_row = 0; tile_row < tile_rows; tile_row++) {
         for (auto tile_col = 0; tile_col < tile_cols; tile_col++) {
             auto last_tile = (tile_row == tile_rows - 1) && (tile_col == tile_cols - 1);
-            auto tile_size = last_tile ? m_bit_stream->bytes_remaining() : m_bit_stream->read_f(32);
-            m_mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
-            m_mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
-            m_mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
-            m_mi_col_end = get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2);
-            SAFE_CALL(m_bit_stream->init_bool(tile_size));
-            SAFE_CALL(decode_tile());
-            SAFE_CALL(m_bit_stream->exit_bool());
+            size_t tile_size = data.size();
+            if (!last_tile) {
+                if (data.size() < 4)
+                    return false;
+                tile_size = (static_cast<u32>(data[0]) << 24u) | (data[1] << 16u) | (data[2] << 8u) | data[3];
+                data = data.slice(4);
+                if (tile_size > data.size())
+                    return false;
+            }
+            m_tiles.append({
+                get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2),
+                get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2),
+                get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2),
+                get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2),
+                data.trim(tile_size),
+            });
+            data = data.slice(tile_size);
         }
     }
     return true;
 }
 
+bool Parser::decode_tiles(ReadonlyBytes data)
+{
+    SAFE_CALL(locate_tiles(data));
+    allocate_tile_data();
+    SAFE_CALL(clear_above_context());
+    for (auto& tile : m_tiles) {
+        m_mi_row_start = tile.mi_row_start;
+        m_mi_row_end = tile.mi_row_end;
+        m_mi_col_start = tile.mi_col_start;
+        m_mi_col_end = tile.mi_col_end;
+        m_bit_stream = make<BitStream>(tile.data.data(), tile.data.size());
+        SAFE_CALL(m_bit_stream->init_bool(tile.data.size()));
+        SAFE_CALL(decode_tile());
+        SAFE_CALL(m_bit_stream->exit_bool());
+    }
+    return true;
+}
+
 void Parser::clear_context(Vector<u8>& context, size_t size)
 {
     context.resize_and_keep_capacity(size);
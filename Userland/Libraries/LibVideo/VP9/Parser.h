@@ -95,7 +95,8 @@ private:
     bool setup_compound_reference_mode();
 
     /* (6.4) Decode Tiles Syntax */
-    bool decode_tiles();
+    bool locate_tiles(ReadonlyBytes);
+    bool decode_tiles(ReadonlyBytes);
     bool clear_above_context();
     u32 get_tile_offset(u32 tile_num, u32 mis, u32 tile_size_log2);
     bool decode_tile();
@@ -179,6 +180,17 @@ private:
     i8 m_loop_filter_ref_deltas[MAX_REF_FRAMES];
     i8 m_loop_filter_mode_deltas[2];
 
+    // Where a tile's data is in the frame, and which mode info units it covers. All tiles are located before
+    // any of them is decoded, so that each one reads from a bit stream of its own.
+    struct TileLayout {
+        u32 mi_row_start { 0 };
+        u32 mi_row_end { 0 };
+        u32 mi_col_start { 0 };
+        u32 mi_col_end { 0 };
+        ReadonlyBytes data;
+    };
+    Vector<TileLayout> m_tiles;
+
     Vector<Vector<u8>> m_above_nonzero_context;
     Vector<Vector<u8>> m_left_nonzero_context;
     Vector<u8> m_above_seg_pred_context;
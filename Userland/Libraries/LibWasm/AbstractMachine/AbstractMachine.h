@@ -351,13 +351,19 @@ public:
             return true;
         auto new_size = m_data.size() + size_to_grow;
         // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
+        size_t maximum_size = Constants::page_size * 65536;
+        if (new_size >= maximum_size)
             return false;
         if (auto max = m_type.limits().max(); max.has_value()) {
             if (max.value() * Constants::page_size < new_size)
                 return false;
+            maximum_size = min(maximum_size, max.value() * Constants::page_size);
         }
         auto previous_size = m_size;
+        // Memories tend to grow a few pages at a time, so reserve ahead to avoid copying all of it every time.
+        // Large allocations are backed by fresh mappings, so the reserve only costs address space until used.
+        if (new_size > m_data.capacity())
+            m_data.ensure_capacity(min(max(new_size, m_data.capacity() * 2), maximum_size));
         m_data.resize(new_size);
         m_size = new_size;
         // The spec requires that we zero out everything on grow
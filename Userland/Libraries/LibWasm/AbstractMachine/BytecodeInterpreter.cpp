@@ -32,7 +32,9 @@ namespace Wasm {
 
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
-    m_stack_info = {};
+    // Looking up the stack bounds is expensive, and calls made from wasm run on the same stack anyway.
+    if (configuration.depth() == 0)
+        m_stack_info = {};
     m_trap.clear();
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
@@ -60,25 +62,28 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    TRAP_IF_NOT(label.has_value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
-
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
+    auto& entries = configuration.stack().entries();
+    size_t label_position = entries.size();
+    size_t labels_to_skip = index.value() + 1;
+    while (label_position > 0) {
+        if (entries[--label_position].has<Label>() && --labels_to_skip == 0)
+            break;
     }
+    TRAP_IF_NOT(labels_to_skip == 0);
+    auto label = entries[label_position].get<Label>();
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label.continuation().value(), label.arity());
+
+    // The label stays, and the results take the place of whatever was pushed after it.
+    TRAP_IF_NOT(entries.size() - label_position - 1 >= label.arity());
+    size_t results_position = entries.size() - label.arity();
+    for (size_t i = 0; i < label.arity(); ++i) {
+        TRAP_IF_NOT(entries[results_position + i].has<Value>());
+        if (results_position != label_position + 1)
+            entries[label_position + 1 + i] = move(entries[results_position + i]);
+    }
+    entries.shrink(label_position + 1 + label.arity(), true);
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
-
-    configuration.ip() = label->continuation();
+    configuration.ip() = label.continuation();
 }
 
 template<typename ReadType, typename PushType>
@@ -94,13 +99,14 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
     TRAP_IF_NOT(!configuration.stack().is_empty());
     auto& entry = configuration.stack().peek();
     TRAP_IF_NOT(entry.has<Value>());
-    auto base = entry.get<Value>().to<i32>();
+    auto base = entry.get<Value>().to<u32>();
     if (!base.has_value()) {
         m_trap = Trap { "Memory access out of bounds" };
         return;
     }
-    auto instance_address = base.value() + static_cast<i64>(arg.offset);
-    if (instance_address < 0 || static_cast<u64>(instance_address + sizeof(ReadType)) > memory->size()) {
+    // Addresses and offsets are both unsigned 32-bit, so their sum can't overflow in 64 bits.
+    u64 instance_address = static_cast<u64>(base.value()) + arg.offset;
+    if (instance_address + sizeof(ReadType) > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + sizeof(ReadType), memory->size());
         return;
@@ -119,10 +125,10 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
     TRAP_IF_NOT(!configuration.stack().is_empty());
     auto entry = configuration.stack().pop();
     TRAP_IF_NOT(entry.has<Value>());
-    auto base = entry.get<Value>().to<i32>();
+    auto base = entry.get<Value>().to<u32>();
     TRAP_IF_NOT(base.has_value());
-    auto instance_address = base.value() + static_cast<i64>(arg.offset);
-    if (instance_address < 0 || static_cast<u64>(instance_address + data.size()) > memory->size()) {
+    u64 instance_address = static_cast<u64>(base.value()) + arg.offset;
+    if (instance_address + data.size() > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + data.size(), memory->size());
         return;
@@ -258,38 +264,28 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
         return;                                                                               \
     } while (false)
 
+// The callers have already checked that the data is in bounds.
 template<typename T>
 T BytecodeInterpreter::read_value(ReadonlyBytes data)
 {
     LittleEndian<T> value;
-    InputMemoryStream stream { data };
-    stream >> value;
-    if (stream.handle_any_error()) {
-        dbgln("Read from {} failed", data.data());
-        m_trap = Trap { "Read from memory failed" };
-    }
+    __builtin_memcpy(&value, data.data(), sizeof(T));
     return value;
 }
 
 template<>
 float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
 {
-    InputMemoryStream stream { data };
     LittleEndian<u32> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
+    __builtin_memcpy(&raw_value, data.data(), sizeof(u32));
     return bit_cast<float>(static_cast<u32>(raw_value));
 }
 
 template<>
 double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
 {
-    InputMemoryStream stream { data };
     LittleEndian<u64> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
+    __builtin_memcpy(&raw_value, data.data(), sizeof(u64));
     return bit_cast<double>(static_cast<u64>(raw_value));
 }
 
@@ -305,12 +301,7 @@ template<>
 struct ConvertToRaw<float> {
     u32 operator()(float value)
     {
-        LittleEndian<u32> res;
-        ReadonlyBytes bytes { &value, sizeof(float) };
-        InputMemoryStream stream { bytes };
-        stream >> res;
-        VERIFY(!stream.has_any_error());
-        return static_cast<u32>(res);
+        return LittleEndian<u32>(bit_cast<u32>(value));
     }
 };
 
@@ -318,12 +309,7 @@ template<>
 struct ConvertToRaw<double> {
     u64 operator()(double value)
     {
-        LittleEndian<u64> res;
-        ReadonlyBytes bytes { &value, sizeof(double) };
-        InputMemoryStream stream { bytes };
-        stream >> res;
-        VERIFY(!stream.has_any_error());
-        return static_cast<u64>(res);
+        return LittleEndian<u64>(bit_cast<u64>(value));
     }
 };
 
@@ -372,21 +358,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 template<typename T, typename R>
 ALWAYS_INLINE static T rotl(T value, R shift)
 {
@@ -496,6 +467,34 @@ ALWAYS_INLINE static T float_min(T lhs, T rhs)
     return min(lhs, rhs);
 }
 
+static bool compare_i32(OpCode comparison, i32 lhs, i32 rhs)
+{
+    switch (comparison.value()) {
+    case Instructions::i32_eq.value():
+        return lhs == rhs;
+    case Instructions::i32_ne.value():
+        return lhs != rhs;
+    case Instructions::i32_lts.value():
+        return lhs < rhs;
+    case Instructions::i32_ltu.value():
+        return static_cast<u32>(lhs) < static_cast<u32>(rhs);
+    case Instructions::i32_gts.value():
+        return lhs > rhs;
+    case Instructions::i32_gtu.value():
+        return static_cast<u32>(lhs) > static_cast<u32>(rhs);
+    case Instructions::i32_les.value():
+        return lhs <= rhs;
+    case Instructions::i32_leu.value():
+        return static_cast<u32>(lhs) <= static_cast<u32>(rhs);
+    case Instructions::i32_ges.value():
+        return lhs >= rhs;
+    case Instructions::i32_geu.value():
+        return static_cast<u32>(lhs) >= static_cast<u32>(rhs);
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
@@ -1098,6 +1097,62 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         UNARY_MAP(double, saturating_truncate<i64>, i64);
     case Instructions::i64_trunc_sat_f64_u.value():
         UNARY_MAP(double, saturating_truncate<u64>, i64);
+    // The synthetic instructions stand in for a sequence of instructions, and skip over the rest of it.
+    case Instructions::synthetic_i32_add2local.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalPairArgs>();
+        auto& locals = configuration.frame().locals();
+        auto lhs = locals[args.lhs.value()].to<u32>();
+        auto rhs = locals[args.rhs.value()].to<u32>();
+        TRAP_IF_NOT(lhs.has_value());
+        TRAP_IF_NOT(rhs.has_value());
+        configuration.stack().push(Value(static_cast<i32>(lhs.value() + rhs.value())));
+        ip = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_i32_addconstlocal.value(): {
+        auto& args = instruction.arguments().get<Instruction::LocalAndConstantArgs>();
+        auto lhs = configuration.frame().locals()[args.local.value()].to<u32>();
+        TRAP_IF_NOT(lhs.has_value());
+        configuration.stack().push(Value(static_cast<i32>(lhs.value() + static_cast<u32>(args.constant))));
+        ip = ip.value() + 3;
+        return;
+    }
+    case Instructions::synthetic_local_get_i32_add.value(): {
+        TRAP_IF_NOT(!configuration.stack().is_empty());
+        auto& lhs_entry = configuration.stack().peek();
+        TRAP_IF_NOT(lhs_entry.has<Value>());
+        auto lhs = lhs_entry.get<Value>().to<u32>();
+        auto rhs = configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()].to<u32>();
+        TRAP_IF_NOT(lhs.has_value());
+        TRAP_IF_NOT(rhs.has_value());
+        lhs_entry = Value(static_cast<i32>(lhs.value() + rhs.value()));
+        ip = ip.value() + 2;
+        return;
+    }
+    case Instructions::synthetic_i32_compare_br_if.value(): {
+        auto& args = instruction.arguments().get<Instruction::CompareAndBranchArgs>();
+        TRAP_IF_NOT(!configuration.stack().is_empty());
+        auto rhs_entry = configuration.stack().pop();
+        TRAP_IF_NOT(rhs_entry.has<Value>());
+        auto rhs = rhs_entry.get<Value>().to<i32>();
+        TRAP_IF_NOT(rhs.has_value());
+        bool condition;
+        if (args.comparison == Instructions::i32_eqz) {
+            condition = rhs.value() == 0;
+        } else {
+            TRAP_IF_NOT(!configuration.stack().is_empty());
+            auto lhs_entry = configuration.stack().pop();
+            TRAP_IF_NOT(lhs_entry.has<Value>());
+            auto lhs = lhs_entry.get<Value>().to<i32>();
+            TRAP_IF_NOT(lhs.has_value());
+            condition = compare_i32(args.comparison, lhs.value(), rhs.value());
+        }
+        if (!condition) {
+            ip = ip.value() + 2;
+            return;
+        }
+        return branch_to_label(configuration, args.label);
+    }
     case Instructions::memory_init.value():
     case Instructions::data_drop.value():
     case Instructions::memory_copy.value():
@@ -216,7 +216,11 @@ static constexpr OpCode i32_trunc_sat_f32_s = 0xfc00,
                         table_size = 0xfc10,
                         table_fill = 0xfc11,
                         structured_else = 0xff00,
-                        structured_end = 0xff01;
+                        structured_end = 0xff01,
+                        synthetic_i32_add2local = 0xff02,
+                        synthetic_i32_addconstlocal = 0xff03,
+                        synthetic_local_get_i32_add = 0xff04,
+                        synthetic_i32_compare_br_if = 0xff05;
 
 static constexpr u32 i32_trunc_sat_f32_s_second = 0,
                      i32_trunc_sat_f32_u_second = 1,
@@ -7,6 +7,7 @@
 #include <AK/LEB128.h>
 #include <AK/ScopeGuard.h>
 #include <AK/ScopeLogger.h>
+#include <LibThreading/ThreadPool.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
@@ -1132,13 +1133,65 @@ ParseResult<CodeSection::Code> CodeSection::Code::parse(InputStream& stream)
     return Code { static_cast<u32>(size), func.release_value() };
 }
 
+// Below this many bytes of function bodies, handing them to other threads costs more than parsing them right here.
+static constexpr size_t parallel_code_parse_threshold = 256 * KiB;
+
 ParseResult<CodeSection> CodeSection::parse(InputStream& stream)
 {
     ScopeLogger<WASM_BINPARSER_DEBUG> logger("CodeSection");
-    auto result = parse_vector<Code>(stream);
-    if (result.is_error())
-        return result.error();
-    return CodeSection { result.release_value() };
+    size_t count;
+    if (!LEB128::read_unsigned(stream, count))
+        return with_eof_check(stream, ParseError::ExpectedSize);
+
+    // Every body is prefixed with its size, so only the bytes have to be read in order. The bodies don't depend
+    // on each other, which lets a large code section be parsed on several threads once it has been read in.
+    struct PendingCode {
+        size_t offset { 0 };
+        size_t size { 0 };
+        Optional<ParseResult<Func>> func;
+    };
+    Vector<PendingCode> pending_codes;
+    Vector<u8> bytes;
+    for (size_t i = 0; i < count; ++i) {
+        size_t size;
+        if (!LEB128::read_unsigned(stream, size))
+            return with_eof_check(stream, ParseError::InvalidSize);
+
+        // This grows with what was actually read, so a bogus size can't make us allocate more than the input holds.
+        auto offset = bytes.size();
+        for (size_t remaining = size; remaining > 0;) {
+            auto chunk_offset = bytes.size();
+            bytes.resize(chunk_offset + min(remaining, 64 * KiB));
+            auto nread = stream.read(bytes.span().slice(chunk_offset));
+            if (nread == 0)
+                return with_eof_check(stream, ParseError::UnexpectedEof);
+            bytes.resize(chunk_offset + nread);
+            remaining -= nread;
+        }
+        pending_codes.append({ offset, size, {} });
+    }
+
+    auto parse_code = [&](PendingCode& code) {
+        InputMemoryStream code_stream { bytes.span().slice(code.offset, code.size) };
+        code.func = Func::parse(code_stream);
+        code_stream.handle_any_error();
+    };
+    if (bytes.size() >= parallel_code_parse_threshold) {
+        Threading::ThreadPool::the().parallel_for(pending_codes.span(), parse_code);
+    } else {
+        for (auto& code : pending_codes)
+            parse_code(code);
+    }
+
+    Vector<Code> functions;
+    functions.ensure_capacity(pending_codes.size());
+    for (auto& code : pending_codes) {
+        auto& func = code.func.value();
+        if (func.is_error())
+            return func.error();
+        functions.unchecked_append(Code { static_cast<u32>(code.size), func.release_value() });
+    }
+    return CodeSection { move(functions) };
 }
 
 ParseResult<DataSection::Data> DataSection::Data::parse(InputStream& stream)
@@ -1356,6 +1409,45 @@ ParseResult<Module> Module::parse(InputStream& stream)
     return Module { move(sections) };
 }
 
+static bool is_i32_comparison(OpCode opcode)
+{
+    return opcode.value() >= Instructions::i32_eqz.value() && opcode.value() <= Instructions::i32_geu.value();
+}
+
+// Replaces common instruction sequences with synthetic instructions that do the work of the whole
+// sequence in one go, which saves pushing and popping the intermediate values.
+// A synthetic instruction takes the place of the first instruction of its sequence, and the interpreter
+// skips the rest. Keeping the rest in place means no instruction pointer changes, and since nothing
+// ever jumps into the middle of a sequence (that takes a block, loop, if, else or end), they never run.
+static Expression fuse_instruction_sequences(Expression const& expression)
+{
+    auto instructions = expression.instructions();
+    auto opcode_at = [&](size_t index) {
+        return index < instructions.size() ? instructions[index].opcode() : Instructions::nop;
+    };
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        auto& instruction = instructions[i];
+        if (instruction.opcode() == Instructions::local_get) {
+            auto local = instruction.arguments().get<LocalIndex>();
+            if (opcode_at(i + 1) == Instructions::local_get && opcode_at(i + 2) == Instructions::i32_add) {
+                instruction = Instruction { Instructions::synthetic_i32_add2local, Instruction::LocalPairArgs { local, instructions[i + 1].arguments().get<LocalIndex>() } };
+                i += 2;
+            } else if (opcode_at(i + 1) == Instructions::i32_const && opcode_at(i + 2) == Instructions::i32_add) {
+                instruction = Instruction { Instructions::synthetic_i32_addconstlocal, Instruction::LocalAndConstantArgs { local, instructions[i + 1].arguments().get<i32>() } };
+                i += 2;
+            } else if (opcode_at(i + 1) == Instructions::i32_add) {
+                instruction = Instruction { Instructions::synthetic_local_get_i32_add, local };
+                i += 1;
+            }
+        } else if (is_i32_comparison(instruction.opcode()) && opcode_at(i + 1) == Instructions::br_if) {
+            instruction = Instruction { Instructions::synthetic_i32_compare_br_if, Instruction::CompareAndBranchArgs { instruction.opcode(), instructions[i + 1].arguments().get<LabelIndex>() } };
+            i += 1;
+        }
+    }
+    return Expression { move(instructions) };
+}
+
 void Module::populate_sections()
 {
     FunctionSection const* function_section { nullptr };
@@ -1364,15 +1456,34 @@ void Module::populate_sections()
         // FIXME: This should be considered invalid once validation is implemented.
         if (!function_section)
             return;
-        size_t index = 0;
+        struct PendingFunction {
+            CodeSection::Code const* code { nullptr };
+            Optional<Expression> body;
+        };
+        Vector<PendingFunction> pending_functions;
+        pending_functions.ensure_capacity(section.functions().size());
+        size_t code_size = 0;
         for (auto& entry : section.functions()) {
+            pending_functions.unchecked_append({ &entry, {} });
+            code_size += entry.size();
+        }
+        auto lower = [](PendingFunction& function) { function.body = fuse_instruction_sequences(function.code->func().body()); };
+        if (code_size >= parallel_code_parse_threshold) {
+            Threading::ThreadPool::the().parallel_for(pending_functions.span(), lower);
+        } else {
+            for (auto& function : pending_functions)
+                lower(function);
+        }
+
+        size_t index = 0;
+        for (auto& function : pending_functions) {
             auto& type_index = function_section->types()[index];
             Vector<ValueType> locals;
-            for (auto& local : entry.func().locals()) {
+            for (auto& local : function.code->func().locals()) {
                 for (size_t i = 0; i < local.n(); ++i)
                     locals.append(local.type());
             }
-            m_functions.empend(type_index, move(locals), entry.func().body());
+            m_functions.empend(type_index, move(locals), function.body.release_value());
             ++index;
         }
     });
@@ -434,6 +434,9 @@ void Printer::print(Wasm::Instruction const& instruction)
             [&](TableIndex const& index) { print("(table index {})", index.value()); },
             [&](Instruction::IndirectCallArgs const& args) { print("(indirect (type index {}) (table index {}))", args.type.value(), args.table.value()); },
             [&](Instruction::MemoryArgument const& args) { print("(memory (align {}) (offset {}))", args.align, args.offset); },
+            [&](Instruction::LocalPairArgs const& args) { print("(local index {}) (local index {})", args.lhs.value(), args.rhs.value()); },
+            [&](Instruction::LocalAndConstantArgs const& args) { print("(local index {}) (constant {})", args.local.value(), args.constant); },
+            [&](Instruction::CompareAndBranchArgs const& args) { print("({}) (label index {})", instruction_name(args.comparison), args.label.value()); },
             [&](Instruction::StructuredInstructionArgs const& args) { print("(structured (else {}) (end {}))", args.else_ip.has_value() ? String::number(args.else_ip->value()) : "(none)", args.end_ip.value()); },
             [&](Instruction::TableBranchArgs const& args) {
                 print("(table_branch");
@@ -859,4 +862,8 @@ HashMap<Wasm::OpCode, String> Wasm::Names::instruction_names {
     { Instructions::table_fill, "table.fill" },
     { Instructions::structured_else, "synthetic:else" },
     { Instructions::structured_end, "synthetic:end" },
+    { Instructions::synthetic_i32_add2local, "synthetic:i32.add2local" },
+    { Instructions::synthetic_i32_addconstlocal, "synthetic:i32.addconstlocal" },
+    { Instructions::synthetic_local_get_i32_add, "synthetic:local.get.i32.add" },
+    { Instructions::synthetic_i32_compare_br_if, "synthetic:i32.compare.br_if" },
 };
@@ -417,6 +417,22 @@ public:
         u32 offset;
     };
 
+    // Arguments of the synthetic instructions that stand in for common instruction sequences.
+    struct LocalPairArgs {
+        LocalIndex lhs;
+        LocalIndex rhs;
+    };
+
+    struct LocalAndConstantArgs {
+        LocalIndex local;
+        i32 constant;
+    };
+
+    struct CompareAndBranchArgs {
+        OpCode comparison;
+        LabelIndex label;
+    };
+
     template<typename T>
     explicit Instruction(OpCode opcode, T argument)
         : m_opcode(opcode)
@@ -434,13 +450,16 @@ private:
     // clang-format off
     Variant<
         BlockType,
+        CompareAndBranchArgs,
         DataIndex,
         ElementIndex,
         FunctionIndex,
         GlobalIndex,
         IndirectCallArgs,
         LabelIndex,
+        LocalAndConstantArgs,
         LocalIndex,
+        LocalPairArgs,
         MemoryArgument,
         StructuredInstructionArgs,
         TableBranchArgs,
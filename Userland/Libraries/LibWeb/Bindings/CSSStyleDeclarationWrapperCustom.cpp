@@ -20,7 +20,7 @@ bool CSSStyleDeclarationWrapper::internal_has_property(JS::PropertyName const& n
     return property_id != CSS::PropertyID::Invalid;
 }
 
-JS::Value CSSStyleDeclarationWrapper::internal_get(JS::PropertyName const& name, JS::Value receiver) const
+JS::Value CSSStyleDeclarationWrapper::internal_get(JS::PropertyName const& name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (!name.is_string())
         return Base::internal_get(name, receiver);
@@ -35,7 +35,7 @@ JS::Value CSSStyleDeclarationWrapper::internal_get(JS::PropertyName const& name,
     return js_string(vm(), String::empty());
 }
 
-bool CSSStyleDeclarationWrapper::internal_set(JS::PropertyName const& name, JS::Value value, JS::Value receiver)
+bool CSSStyleDeclarationWrapper::internal_set(JS::PropertyName const& name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     if (!name.is_string())
         return Base::internal_set(name, value, receiver);
@@ -12,7 +12,7 @@
 
 namespace Web::Bindings {
 
-JS::Value HTMLCollectionWrapper::internal_get(JS::PropertyName const& property_name, JS::Value receiver) const
+JS::Value HTMLCollectionWrapper::internal_get(JS::PropertyName const& property_name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (property_name.is_symbol())
         return Base::internal_get(property_name, receiver);
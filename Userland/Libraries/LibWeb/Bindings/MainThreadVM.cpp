@@ -4,16 +4,35 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/Timer.h>
+#include <LibJS/Heap/Heap.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
 
 namespace Web::Bindings {
 
+// How long one slice of sweeping may keep the event loop from doing anything else.
+static constexpr int incremental_sweep_time_budget_ms = 2;
+
 JS::VM& main_thread_vm()
 {
     static RefPtr<JS::VM> vm;
-    if (!vm)
+    static RefPtr<Core::Timer> sweep_timer;
+    if (!vm) {
         vm = JS::VM::create();
+
+        // Destroying the dead cells is what makes collections on big pages take long, so we do that a
+        // little at a time from the event loop instead.
+        sweep_timer = Core::Timer::create_single_shot(0, [] {
+            if (vm->heap().sweep_incrementally(incremental_sweep_time_budget_ms))
+                sweep_timer->start();
+        });
+        vm->heap().set_sweeps_incrementally(true);
+        vm->heap().on_sweep_pending = [] {
+            if (!sweep_timer->is_active())
+                sweep_timer->start();
+        };
+    }
     return *vm;
 }
 
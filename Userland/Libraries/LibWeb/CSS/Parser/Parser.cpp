@@ -903,8 +903,8 @@ Optional<StyleDeclarationRule> Parser::consume_a_declaration(TokenStream<T>& tok
             auto last_token = last.m_token;
             auto second_last_token = second_last.m_token;
 
-            if (second_last_token.is(Token::Type::Delim) && second_last_token.m_value.to_string().equals_ignoring_case("!")) {
-                if (last_token.is(Token::Type::Ident) && last_token.m_value.to_string().equals_ignoring_case("important")) {
+            if (second_last_token.is(Token::Type::Delim) && second_last_token.m_value.equals_ignoring_case("!")) {
+                if (last_token.is(Token::Type::Ident) && last_token.m_value.equals_ignoring_case("important")) {
                     declaration.m_values.remove(declaration.m_values.size() - 2);
                     declaration.m_values.remove(declaration.m_values.size() - 1);
                     declaration.m_important = true;
@@ -1440,8 +1440,8 @@ Optional<Length> Parser::parse_length(ParsingContext const& context, StyleCompon
     Optional<float> numeric_value;
 
     if (component_value.is(Token::Type::Dimension)) {
-        auto length_string = component_value.token().m_value.string_view();
-        auto unit_string = component_value.token().m_unit.string_view();
+        auto length_string = component_value.token().m_value;
+        auto unit_string = component_value.token().m_unit;
 
         if (unit_string.equals_ignoring_case("%")) {
             type = Length::Type::Percentage;
@@ -1479,7 +1479,7 @@ Optional<Length> Parser::parse_length(ParsingContext const& context, StyleCompon
 
         numeric_value = try_parse_float(length_string);
     } else if (component_value.is(Token::Type::Number)) {
-        auto value_string = component_value.token().m_value.string_view();
+        auto value_string = component_value.token().m_value;
         if (value_string == "0") {
             type = Length::Type::Px;
             numeric_value = 0;
@@ -1489,7 +1489,7 @@ Optional<Length> Parser::parse_length(ParsingContext const& context, StyleCompon
         }
     } else if (component_value.is(Token::Type::Percentage)) {
         type = Length::Type::Percentage;
-        auto value_string = component_value.token().m_value.string_view();
+        auto value_string = component_value.token().m_value;
         numeric_value = try_parse_float(value_string);
     }
 
@@ -1517,7 +1517,7 @@ RefPtr<StyleValue> Parser::parse_numeric_value(ParsingContext const&, StyleCompo
         if (number.m_number_type == Token::NumberType::Integer) {
             return NumericStyleValue::create(number.to_integer());
         } else {
-            auto float_value = try_parse_float(number.m_value.string_view());
+            auto float_value = try_parse_float(number.m_value);
             if (float_value.has_value())
                 return NumericStyleValue::create(float_value.value());
         }
@@ -1592,9 +1592,9 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && g_val.is(Token::NumberType::Integer)
                 && b_val.is(Token::NumberType::Integer)) {
 
-                auto maybe_r = r_val.m_value.string_view().to_uint<u8>();
-                auto maybe_g = g_val.m_value.string_view().to_uint<u8>();
-                auto maybe_b = b_val.m_value.string_view().to_uint<u8>();
+                auto maybe_r = r_val.m_value.to_uint<u8>();
+                auto maybe_g = g_val.m_value.to_uint<u8>();
+                auto maybe_b = b_val.m_value.to_uint<u8>();
                 if (maybe_r.has_value() && maybe_g.has_value() && maybe_b.has_value())
                     return Color(maybe_r.value(), maybe_g.value(), maybe_b.value());
 
@@ -1602,9 +1602,9 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && g_val.is(Token::Type::Percentage)
                 && b_val.is(Token::Type::Percentage)) {
 
-                auto maybe_r = try_parse_float(r_val.m_value.string_view());
-                auto maybe_g = try_parse_float(g_val.m_value.string_view());
-                auto maybe_b = try_parse_float(b_val.m_value.string_view());
+                auto maybe_r = try_parse_float(r_val.m_value);
+                auto maybe_g = try_parse_float(g_val.m_value);
+                auto maybe_b = try_parse_float(b_val.m_value);
                 if (maybe_r.has_value() && maybe_g.has_value() && maybe_b.has_value()) {
                     u8 r = clamp(lroundf(maybe_r.value() * 2.55f), 0, 255);
                     u8 g = clamp(lroundf(maybe_g.value() * 2.55f), 0, 255);
@@ -1626,10 +1626,10 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && b_val.is(Token::NumberType::Integer)
                 && a_val.is(Token::Type::Number)) {
 
-                auto maybe_r = r_val.m_value.string_view().to_uint<u8>();
-                auto maybe_g = g_val.m_value.string_view().to_uint<u8>();
-                auto maybe_b = b_val.m_value.string_view().to_uint<u8>();
-                auto maybe_a = try_parse_float(a_val.m_value.string_view());
+                auto maybe_r = r_val.m_value.to_uint<u8>();
+                auto maybe_g = g_val.m_value.to_uint<u8>();
+                auto maybe_b = b_val.m_value.to_uint<u8>();
+                auto maybe_a = try_parse_float(a_val.m_value);
                 if (maybe_r.has_value() && maybe_g.has_value() && maybe_b.has_value() && maybe_a.has_value()) {
                     u8 a = clamp(lroundf(maybe_a.value() * 255.0f), 0, 255);
                     return Color(maybe_r.value(), maybe_g.value(), maybe_b.value(), a);
@@ -1640,10 +1640,10 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && b_val.is(Token::Type::Percentage)
                 && a_val.is(Token::Type::Number)) {
 
-                auto maybe_r = try_parse_float(r_val.m_value.string_view());
-                auto maybe_g = try_parse_float(g_val.m_value.string_view());
-                auto maybe_b = try_parse_float(b_val.m_value.string_view());
-                auto maybe_a = try_parse_float(a_val.m_value.string_view());
+                auto maybe_r = try_parse_float(r_val.m_value);
+                auto maybe_g = try_parse_float(g_val.m_value);
+                auto maybe_b = try_parse_float(b_val.m_value);
+                auto maybe_a = try_parse_float(a_val.m_value);
                 if (maybe_r.has_value() && maybe_g.has_value() && maybe_b.has_value() && maybe_a.has_value()) {
                     u8 r = clamp(lroundf(maybe_r.value() * 2.55f), 0, 255);
                     u8 g = clamp(lroundf(maybe_g.value() * 2.55f), 0, 255);
@@ -1664,9 +1664,9 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && s_val.is(Token::Type::Percentage)
                 && l_val.is(Token::Type::Percentage)) {
 
-                auto maybe_h = try_parse_float(h_val.m_value.string_view());
-                auto maybe_s = try_parse_float(s_val.m_value.string_view());
-                auto maybe_l = try_parse_float(l_val.m_value.string_view());
+                auto maybe_h = try_parse_float(h_val.m_value);
+                auto maybe_s = try_parse_float(s_val.m_value);
+                auto maybe_l = try_parse_float(l_val.m_value);
                 if (maybe_h.has_value() && maybe_s.has_value() && maybe_l.has_value()) {
                     float h = maybe_h.value();
                     float s = maybe_s.value() / 100.0f;
@@ -1688,10 +1688,10 @@ Optional<Color> Parser::parse_color(ParsingContext const&, StyleComponentValueRu
                 && l_val.is(Token::Type::Percentage)
                 && a_val.is(Token::Type::Number)) {
 
-                auto maybe_h = try_parse_float(h_val.m_value.string_view());
-                auto maybe_s = try_parse_float(s_val.m_value.string_view());
-                auto maybe_l = try_parse_float(l_val.m_value.string_view());
-                auto maybe_a = try_parse_float(a_val.m_value.string_view());
+                auto maybe_h = try_parse_float(h_val.m_value);
+                auto maybe_s = try_parse_float(s_val.m_value);
+                auto maybe_l = try_parse_float(l_val.m_value);
+                auto maybe_a = try_parse_float(a_val.m_value);
                 if (maybe_h.has_value() && maybe_s.has_value() && maybe_l.has_value() && maybe_a.has_value()) {
                     float h = maybe_h.value();
                     float s = maybe_s.value() / 100.0f;
@@ -5,6 +5,7 @@
  */
 
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <LibWeb/CSS/Parser/Token.h>
 
 namespace Web::CSS {
@@ -22,7 +23,7 @@ String Token::to_debug_string() const
         break;
     case Type::Ident:
         builder.append("Identifier: ");
-        builder.append(m_value.to_string());
+        builder.append(m_value);
         return builder.to_string();
     case Type::Function:
         builder.append("Function");
@@ -32,11 +33,11 @@ String Token::to_debug_string() const
         break;
     case Type::Hash:
         builder.append("Hash: ");
-        builder.append(m_value.to_string());
+        builder.append(m_value);
         return builder.to_string();
     case Type::String:
         builder.append("String: ");
-        builder.append(m_value.to_string());
+        builder.append(m_value);
         return builder.to_string();
     case Type::BadString:
         builder.append("Invalid String");
@@ -49,22 +50,22 @@ String Token::to_debug_string() const
         break;
     case Type::Delim:
         builder.append("Delimiter: ");
-        builder.append(m_value.to_string());
+        builder.append(m_value);
         return builder.to_string();
     case Type::Number:
         builder.append("Number: ");
-        builder.append(m_value.to_string());
+        builder.append(m_value);
         builder.append(m_number_type == NumberType::Integer ? " (int)" : " (float)");
         return builder.to_string();
     case Type::Percentage:
         builder.append("Percentage: ");
-        builder.append(m_value.to_string());
-        builder.append(m_unit.to_string());
+        builder.append(m_value);
+        builder.append(m_unit);
         return builder.to_string();
     case Type::Dimension:
         builder.append("Dimension: ");
-        builder.append(m_value.to_string());
-        builder.append(m_unit.to_string());
+        builder.append(m_value);
+        builder.append(m_unit);
         return builder.to_string();
     case Type::Whitespace:
         builder.append("Whitespace");
@@ -111,7 +112,7 @@ String Token::to_debug_string() const
     builder.append(" ");
 
     builder.append(" { value: '");
-    builder.append(m_value.to_string());
+    builder.append(m_value);
 
     if (m_type == Token::Type::Hash) {
         builder.append("', hash_type: '");
@@ -140,7 +141,7 @@ String Token::to_debug_string() const
         }
 
         builder.append("', unit: '");
-        builder.append(m_unit.to_string());
+        builder.append(m_unit);
     }
 
     builder.append("' }");
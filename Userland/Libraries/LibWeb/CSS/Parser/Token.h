@@ -8,7 +8,7 @@
 #pragma once
 
 #include <AK/String.h>
-#include <AK/StringBuilder.h>
+#include <AK/StringView.h>
 
 namespace Web::CSS {
 
@@ -61,31 +61,31 @@ public:
     StringView ident() const
     {
         VERIFY(m_type == Type::Ident);
-        return m_value.string_view();
+        return m_value;
     }
 
     StringView delim() const
     {
         VERIFY(m_type == Type::Delim);
-        return m_value.string_view();
+        return m_value;
     }
 
     StringView string() const
     {
         VERIFY(m_type == Type::String);
-        return m_value.string_view();
+        return m_value;
     }
 
     StringView url() const
     {
         VERIFY(m_type == Type::Url);
-        return m_value.string_view();
+        return m_value;
     }
 
     StringView at_keyword() const
     {
         VERIFY(m_type == Type::AtKeyword);
-        return m_value.string_view();
+        return m_value;
     }
 
     HashType hash_type() const
@@ -96,14 +96,14 @@ public:
     StringView hash_value() const
     {
         VERIFY(m_type == Type::Hash);
-        return m_value.string_view();
+        return m_value;
     }
 
     bool is(NumberType number_type) const { return is(Token::Type::Number) && m_number_type == number_type; }
     StringView number_string_value() const
     {
         VERIFY(m_type == Type::Number);
-        return m_value.string_view();
+        return m_value;
     }
     int to_integer() const
     {
@@ -115,12 +115,12 @@ public:
     StringView dimension_unit() const
     {
         VERIFY(m_type == Type::Dimension);
-        return m_unit.string_view();
+        return m_unit;
     }
     StringView dimension_value() const
     {
         VERIFY(m_type == Type::Dimension);
-        return m_value.string_view();
+        return m_value;
     }
     int dimension_value_int() const { return dimension_value().to_int().value(); }
 
@@ -139,8 +139,11 @@ public:
 private:
     Type m_type { Type::Invalid };
 
-    StringBuilder m_value;
-    StringBuilder m_unit;
+    // These are views of m_source, which is the whole input of the tokenizer unless the value had to be decoded (say,
+    // because it has escapes in it). That way, tokens don't copy their values out of the input, and are cheap to copy.
+    StringView m_value;
+    StringView m_unit;
+    String m_source;
     HashType m_hash_type { HashType::Unrestricted };
     NumberType m_number_type { NumberType::Integer };
 };
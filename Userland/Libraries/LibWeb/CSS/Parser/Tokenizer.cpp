@@ -195,6 +195,16 @@ Tokenizer::Tokenizer(const StringView& input, const String& encoding)
     // FIXME: preprocess the stream
     // https://www.w3.org/TR/css-syntax-3/#input-preprocessing
     m_decoded_input = decoder->to_utf8(input);
+
+    // Tokens are views of the input, so any invalid UTF-8 has to be replaced up front, rather than whenever a code
+    // point is decoded.
+    if (!Utf8View(m_decoded_input).validate()) {
+        StringBuilder builder(m_decoded_input.length());
+        for (auto code_point : Utf8View(m_decoded_input))
+            builder.append_code_point(code_point);
+        m_decoded_input = builder.to_string();
+    }
+
     m_utf8_view = Utf8View(m_decoded_input);
     m_utf8_iterator = m_utf8_view.begin();
 }
@@ -261,6 +271,16 @@ U32Triplet Tokenizer::peek_triplet() const
     return values;
 }
 
+size_t Tokenizer::current_byte_offset() const
+{
+    return m_utf8_view.byte_offset_of(m_utf8_iterator);
+}
+
+TokenValue Tokenizer::input_since(size_t byte_offset) const
+{
+    return { m_decoded_input.substring_view(byte_offset, current_byte_offset() - byte_offset), {} };
+}
+
 Token Tokenizer::create_new_token(Token::Type type)
 {
     Token token = {};
@@ -273,19 +293,23 @@ Token Tokenizer::create_eof_token()
     return create_new_token(Token::Type::EndOfFile);
 }
 
-Token Tokenizer::create_value_token(Token::Type type, String value)
+Token Tokenizer::create_value_token(Token::Type type, TokenValue value)
 {
     Token token;
     token.m_type = type;
-    token.m_value.append(move(value));
+    token.m_value = value.view;
+    token.m_source = value.decoded.is_null() ? m_decoded_input : move(value.decoded);
     return token;
 }
 
-Token Tokenizer::create_value_token(Token::Type type, u32 value)
+Token Tokenizer::create_delim_token()
 {
-    Token token = {};
-    token.m_type = type;
-    token.m_value.append_code_point(value);
+    // A delimiter is the code point that was just consumed.
+    auto offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
+    Token token;
+    token.m_type = Token::Type::Delim;
+    token.m_value = m_decoded_input.substring_view(offset, m_prev_utf8_iterator.underlying_code_point_length_in_bytes());
+    token.m_source = m_decoded_input;
     return token;
 }
 
@@ -331,7 +355,7 @@ Token Tokenizer::consume_an_ident_like_token()
 {
     auto string = consume_a_name();
 
-    if (string.equals_ignoring_case("url") && is_left_paren(peek_code_point())) {
+    if (string.view.equals_ignoring_case("url") && is_left_paren(peek_code_point())) {
         (void)next_code_point();
 
         for (;;) {
@@ -363,12 +387,12 @@ Token Tokenizer::consume_an_ident_like_token()
 
 CSSNumber Tokenizer::consume_a_number()
 {
-    StringBuilder repr;
+    auto start = current_byte_offset();
     Token::NumberType type = Token::NumberType::Integer;
 
     auto next_input = peek_code_point();
     if (is_plus_sign(next_input) || is_hyphen_minus(next_input)) {
-        repr.append_code_point(next_code_point());
+        (void)next_code_point();
     }
 
     for (;;) {
@@ -376,13 +400,13 @@ CSSNumber Tokenizer::consume_a_number()
         if (!is_ascii_digit(digits))
             break;
 
-        repr.append_code_point(next_code_point());
+        (void)next_code_point();
     }
 
     auto maybe_number = peek_twin();
     if (is_full_stop(maybe_number.first) && is_ascii_digit(maybe_number.second)) {
-        repr.append_code_point(next_code_point());
-        repr.append_code_point(next_code_point());
+        (void)next_code_point();
+        (void)next_code_point();
 
         type = Token::NumberType::Number;
 
@@ -391,7 +415,7 @@ CSSNumber Tokenizer::consume_a_number()
             if (!is_ascii_digit(digit))
                 break;
 
-            repr.append_code_point(next_code_point());
+            (void)next_code_point();
         }
     }
 
@@ -399,13 +423,13 @@ CSSNumber Tokenizer::consume_a_number()
     if (is_E(maybe_exp.first) || is_e(maybe_exp.first)) {
         if (is_plus_sign(maybe_exp.second) || is_hyphen_minus(maybe_exp.second)) {
             if (is_ascii_digit(maybe_exp.third)) {
-                repr.append_code_point(next_code_point());
-                repr.append_code_point(next_code_point());
-                repr.append_code_point(next_code_point());
+                (void)next_code_point();
+                (void)next_code_point();
+                (void)next_code_point();
             }
         } else if (is_ascii_digit(maybe_exp.second)) {
-            repr.append_code_point(next_code_point());
-            repr.append_code_point(next_code_point());
+            (void)next_code_point();
+            (void)next_code_point();
         }
 
         type = Token::NumberType::Number;
@@ -415,31 +439,39 @@ CSSNumber Tokenizer::consume_a_number()
             if (!is_ascii_digit(digits))
                 break;
 
-            repr.append_code_point(next_code_point());
+            (void)next_code_point();
         }
     }
 
-    return { repr.to_string(), type };
+    return { input_since(start).view, type };
 }
 
-String Tokenizer::consume_a_name()
+TokenValue Tokenizer::consume_a_name()
 {
-    StringBuilder result;
+    // The name is a view of the input until there's an escape in it, from which on it's built up code point by code point.
+    auto start = current_byte_offset();
+    Optional<StringBuilder> decoded;
 
     for (;;) {
+        auto offset = current_byte_offset();
         auto input = next_code_point();
 
         if (is_eof(input))
             break;
 
         if (is_name_code_point(input)) {
-            result.append_code_point(input);
+            if (decoded.has_value())
+                decoded->append_code_point(input);
             continue;
         }
 
         auto next = peek_code_point();
         if (!is_eof(next) && is_valid_escape_sequence({ input, next })) {
-            result.append_code_point(consume_escaped_code_point());
+            if (!decoded.has_value()) {
+                decoded = StringBuilder {};
+                decoded->append(m_decoded_input.substring_view(start, offset - start));
+            }
+            decoded->append_code_point(consume_escaped_code_point());
             continue;
         }
 
@@ -447,11 +479,14 @@ String Tokenizer::consume_a_name()
         break;
     }
 
-    return result.to_string();
+    if (!decoded.has_value())
+        return input_since(start);
+
+    auto string = decoded->to_string();
+    return { string, string };
 }
 Token Tokenizer::consume_a_url_token()
 {
-    auto token = create_new_token(Token::Type::Url);
     for (;;) {
         if (!is_whitespace(peek_code_point())) {
             break;
@@ -460,17 +495,28 @@ Token Tokenizer::consume_a_url_token()
         (void)next_code_point();
     }
 
-    for (;;) {
+    // The URL is a view of the input until there's an escape in it, from which on it's built up code point by code point.
+    auto start = current_byte_offset();
+    Optional<StringBuilder> decoded;
+    auto create_url_token = [&](size_t end) {
+        if (decoded.has_value()) {
+            auto string = decoded->to_string();
+            return create_value_token(Token::Type::Url, { string, string });
+        }
+        return create_value_token(Token::Type::Url, { m_decoded_input.substring_view(start, end - start), {} });
+    };
 
+    for (;;) {
+        auto offset = current_byte_offset();
         auto input = peek_code_point();
         if (is_eof(input)) {
             log_parse_error();
-            return token;
+            return create_url_token(offset);
         }
 
         if (is_right_paren(input)) {
             (void)next_code_point();
-            return token;
+            return create_url_token(offset);
         }
 
         if (is_whitespace(input)) {
@@ -479,16 +525,18 @@ Token Tokenizer::consume_a_url_token()
                     break;
                 }
 
-                input = next_code_point();
+                (void)next_code_point();
             }
 
+            input = peek_code_point();
             if (is_eof(input)) {
                 log_parse_error();
-                return token;
+                return create_url_token(offset);
             }
 
             if (is_right_paren(input)) {
-                return token;
+                (void)next_code_point();
+                return create_url_token(offset);
             }
 
             consume_the_remnants_of_a_bad_url();
@@ -504,16 +552,24 @@ Token Tokenizer::consume_a_url_token()
 
         if (is_reverse_solidus(input)) {
             if (is_valid_escape_sequence(peek_twin())) {
-                token.m_value.append_code_point(consume_escaped_code_point());
-            } else {
-                log_parse_error();
                 (void)next_code_point();
-                consume_the_remnants_of_a_bad_url();
-                return create_new_token(Token::Type::BadUrl);
+                if (!decoded.has_value()) {
+                    decoded = StringBuilder {};
+                    decoded->append(m_decoded_input.substring_view(start, offset - start));
+                }
+                decoded->append_code_point(consume_escaped_code_point());
+                continue;
             }
+
+            log_parse_error();
+            (void)next_code_point();
+            consume_the_remnants_of_a_bad_url();
+            return create_new_token(Token::Type::BadUrl);
         }
 
-        token.m_value.append_code_point(next_code_point());
+        input = next_code_point();
+        if (decoded.has_value())
+            decoded->append_code_point(input);
     }
 }
 
@@ -550,26 +606,28 @@ Token Tokenizer::consume_a_numeric_token()
 {
     auto number = consume_a_number();
     if (would_start_an_identifier()) {
-        auto token = create_new_token(Token::Type::Dimension);
-        token.m_value.append(number.value);
-        token.m_number_type = number.type;
-
         auto unit = consume_a_name();
-        token.m_unit.append(unit);
+        auto token = create_value_token(Token::Type::Dimension, { number.value, {} });
+        token.m_number_type = number.type;
+        if (unit.decoded.is_null()) {
+            token.m_unit = unit.view;
+            return token;
+        }
 
+        // The number and the unit have to be views of the same String.
+        token.m_source = String::formatted("{}{}", number.value, unit.view);
+        token.m_value = token.m_source.substring_view(0, number.value.length());
+        token.m_unit = token.m_source.substring_view(number.value.length());
         return token;
     }
 
     if (is_percent(peek_code_point())) {
         (void)next_code_point();
 
-        auto token = create_new_token(Token::Type::Percentage);
-        token.m_value.append(number.value);
-        return token;
+        return create_value_token(Token::Type::Percentage, { number.value, {} });
     }
 
-    auto token = create_new_token(Token::Type::Number);
-    token.m_value.append(number.value);
+    auto token = create_value_token(Token::Type::Number, { number.value, {} });
     token.m_number_type = number.type;
     return token;
 }
@@ -641,18 +699,29 @@ bool Tokenizer::would_start_an_identifier(U32Triplet values)
 
 Token Tokenizer::consume_string_token(u32 ending_code_point)
 {
-    auto token = create_new_token(Token::Type::String);
+    // The string is a view of the input until there's an escape in it, from which on it's built up code point by code
+    // point.
+    auto start = current_byte_offset();
+    Optional<StringBuilder> decoded;
+    auto create_string_token = [&](size_t end) {
+        if (decoded.has_value()) {
+            auto string = decoded->to_string();
+            return create_value_token(Token::Type::String, { string, string });
+        }
+        return create_value_token(Token::Type::String, { m_decoded_input.substring_view(start, end - start), {} });
+    };
 
     for (;;) {
+        auto offset = current_byte_offset();
         auto input = next_code_point();
 
         if (is_eof(input)) {
             log_parse_error();
-            return token;
+            return create_string_token(offset);
         }
 
         if (input == ending_code_point)
-            return token;
+            return create_string_token(offset);
 
         if (is_newline(input)) {
             reconsume_current_input_code_point();
@@ -660,6 +729,11 @@ Token Tokenizer::consume_string_token(u32 ending_code_point)
         }
 
         if (is_reverse_solidus(input)) {
+            if (!decoded.has_value()) {
+                decoded = StringBuilder {};
+                decoded->append(m_decoded_input.substring_view(start, offset - start));
+            }
+
             auto next_input = peek_code_point();
             if (is_eof(next_input))
                 continue;
@@ -669,11 +743,12 @@ Token Tokenizer::consume_string_token(u32 ending_code_point)
                 continue;
             }
 
-            auto escaped = consume_escaped_code_point();
-            token.m_value.append_code_point(escaped);
+            decoded->append_code_point(consume_escaped_code_point());
+            continue;
         }
 
-        token.m_value.append_code_point(input);
+        if (decoded.has_value())
+            decoded->append_code_point(input);
     }
 }
 
@@ -738,18 +813,13 @@ Token Tokenizer::consume_a_token()
         auto maybe_escape = peek_twin();
 
         if (is_name_code_point(next_input) || is_valid_escape_sequence(maybe_escape)) {
-            auto token = create_new_token(Token::Type::Hash);
-
-            if (would_start_an_identifier())
-                token.m_hash_type = Token::HashType::Id;
-
-            auto name = consume_a_name();
-            token.m_value.append(name);
-
+            auto hash_type = would_start_an_identifier() ? Token::HashType::Id : Token::HashType::Unrestricted;
+            auto token = create_value_token(Token::Type::Hash, consume_a_name());
+            token.m_hash_type = hash_type;
             return token;
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_apostrophe(input)) {
@@ -774,7 +844,7 @@ Token Tokenizer::consume_a_token()
             return consume_a_numeric_token();
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_comma(input)) {
@@ -802,7 +872,7 @@ Token Tokenizer::consume_a_token()
             return consume_an_ident_like_token();
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_full_stop(input)) {
@@ -812,7 +882,7 @@ Token Tokenizer::consume_a_token()
             return consume_a_numeric_token();
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_colon(input)) {
@@ -837,7 +907,7 @@ Token Tokenizer::consume_a_token()
             return create_new_token(Token::Type::CDO);
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_at(input)) {
@@ -848,7 +918,7 @@ Token Tokenizer::consume_a_token()
             return create_value_token(Token::Type::AtKeyword, name);
         }
 
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_open_square_bracket(input)) {
@@ -864,7 +934,7 @@ Token Tokenizer::consume_a_token()
         }
 
         log_parse_error();
-        return create_value_token(Token::Type::Delim, input);
+        return create_delim_token();
     }
 
     if (is_closed_square_bracket(input)) {
@@ -895,7 +965,7 @@ Token Tokenizer::consume_a_token()
     }
 
     dbgln_if(CSS_TOKENIZER_DEBUG, "is delimiter");
-    return create_value_token(Token::Type::Delim, input);
+    return create_delim_token();
 }
 
 }
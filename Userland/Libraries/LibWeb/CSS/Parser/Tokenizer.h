@@ -59,10 +59,20 @@ public:
 
 class CSSNumber {
 public:
-    String value;
+    // A view of the input, as numbers never need decoding.
+    StringView value;
     Token::NumberType type {};
 };
 
+// The value of a token, which is a view of the input, unless the value had to be decoded. Then it's a view of a String
+// of its own.
+class TokenValue {
+public:
+    StringView view;
+    // Only set if the value had to be decoded.
+    String decoded;
+};
+
 class Tokenizer {
 
 public:
@@ -78,15 +88,18 @@ private:
     [[nodiscard]] U32Twin peek_twin() const;
     [[nodiscard]] U32Triplet peek_triplet() const;
 
+    [[nodiscard]] size_t current_byte_offset() const;
+    [[nodiscard]] TokenValue input_since(size_t byte_offset) const;
+
     [[nodiscard]] static Token create_new_token(Token::Type);
-    [[nodiscard]] static Token create_value_token(Token::Type, String value);
-    [[nodiscard]] static Token create_value_token(Token::Type, u32 value);
+    [[nodiscard]] Token create_value_token(Token::Type, TokenValue);
+    [[nodiscard]] Token create_delim_token();
     [[nodiscard]] Token consume_a_token();
     [[nodiscard]] Token consume_string_token(u32 ending_code_point);
     [[nodiscard]] Token consume_a_numeric_token();
     [[nodiscard]] Token consume_an_ident_like_token();
     [[nodiscard]] CSSNumber consume_a_number();
-    [[nodiscard]] String consume_a_name();
+    [[nodiscard]] TokenValue consume_a_name();
     [[nodiscard]] u32 consume_escaped_code_point();
     [[nodiscard]] Token consume_a_url_token();
     void consume_the_remnants_of_a_bad_url();
@@ -6,21 +6,27 @@
 
 #pragma once
 
-#include <AK/HashMap.h>
+#include <AK/FlyString.h>
+#include <AK/String.h>
 #include <LibWeb/CSS/StyleResolver.h>
-#include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 
 namespace Web::CSS {
 
+// Marks the elements whose style may be affected by a change to one of an element's attributes as needing a style
+// update, going by which ids, classes and attributes the document's selectors look at.
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    StyleInvalidator(DOM::Element&, FlyString const& attribute_name);
     ~StyleInvalidator();
 
+    static void invalidate(DOM::Element&, StyleInvalidationScope);
+
 private:
-    DOM::Document& m_document;
-    HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
+    DOM::Element& m_element;
+    FlyString m_attribute_name;
+    String m_old_value;
+    bool m_enabled { false };
 };
 
 }
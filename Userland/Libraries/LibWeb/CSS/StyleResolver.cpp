@@ -16,6 +16,7 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <ctype.h>
 #include <stdio.h>
 
@@ -63,9 +64,119 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
     }
 }
 
-Vector<MatchingRule> StyleResolver::collect_matching_rules(DOM::Element const& element) const
+void StyleResolver::invalidate_rule_cache()
 {
-    Vector<MatchingRule> matching_rules;
+    m_rule_cache = nullptr;
+}
+
+StyleResolver::RuleCache const& StyleResolver::rule_cache() const
+{
+    if (!m_rule_cache || m_rule_cache->was_built_in_quirks_mode != document().in_quirks_mode())
+        build_rule_cache();
+    return *m_rule_cache;
+}
+
+static void collect_selector_features(Selector const& selector, SelectorFeatures& features, StyleInvalidationScope outer_scope = StyleInvalidationScope::None)
+{
+    auto& compound_selectors = selector.compound_selectors();
+    for (size_t i = 0; i < compound_selectors.size(); ++i) {
+        // A change to what the rightmost compound selector matches affects the element itself. Further to the left,
+        // it's the combinator to the right of the compound selector that decides which elements can be affected.
+        auto scope = outer_scope;
+        if (i == compound_selectors.size() - 1) {
+            scope |= StyleInvalidationScope::Element;
+        } else {
+            switch (compound_selectors[i + 1].combinator) {
+            case Selector::Combinator::NextSibling:
+            case Selector::Combinator::SubsequentSibling:
+                scope |= StyleInvalidationScope::FollowingSiblings;
+                break;
+            case Selector::Combinator::Column:
+                scope |= StyleInvalidationScope::Descendants | StyleInvalidationScope::FollowingSiblings;
+                break;
+            default:
+                scope |= StyleInvalidationScope::Descendants;
+                break;
+            }
+        }
+
+        for (auto& simple_selector : compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                features.ids.ensure(simple_selector.value) |= scope;
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                features.classes.ensure(simple_selector.value) |= scope;
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                features.attribute_names.ensure(simple_selector.attribute.name) |= scope;
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass:
+                switch (simple_selector.pseudo_class.type) {
+                case Selector::SimpleSelector::PseudoClass::Type::Hover:
+                    features.hover |= scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Link:
+                    features.attribute_names.ensure(HTML::AttributeNames::href) |= scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Disabled:
+                case Selector::SimpleSelector::PseudoClass::Type::Enabled:
+                    features.attribute_names.ensure(HTML::AttributeNames::disabled) |= scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Checked:
+                    features.attribute_names.ensure(HTML::AttributeNames::checked) |= scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Not:
+                    for (auto& not_selector : simple_selector.pseudo_class.not_selector)
+                        collect_selector_features(not_selector, features, scope);
+                    break;
+                default:
+                    break;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+static bool is_structural(Selector const& selector)
+{
+    for (auto& compound_selector : selector.compound_selectors()) {
+        if (compound_selector.combinator == Selector::Combinator::NextSibling || compound_selector.combinator == Selector::Combinator::SubsequentSibling)
+            return true;
+        for (auto& simple_selector : compound_selector.simple_selectors) {
+            if (simple_selector.type != Selector::SimpleSelector::Type::PseudoClass)
+                continue;
+            switch (simple_selector.pseudo_class.type) {
+            case Selector::SimpleSelector::PseudoClass::Type::FirstChild:
+            case Selector::SimpleSelector::PseudoClass::Type::LastChild:
+            case Selector::SimpleSelector::PseudoClass::Type::OnlyChild:
+            case Selector::SimpleSelector::PseudoClass::Type::Empty:
+            case Selector::SimpleSelector::PseudoClass::Type::FirstOfType:
+            case Selector::SimpleSelector::PseudoClass::Type::LastOfType:
+            case Selector::SimpleSelector::PseudoClass::Type::NthChild:
+            case Selector::SimpleSelector::PseudoClass::Type::NthLastChild:
+                return true;
+            case Selector::SimpleSelector::PseudoClass::Type::Not:
+                for (auto& not_selector : simple_selector.pseudo_class.not_selector) {
+                    if (is_structural(not_selector))
+                        return true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+void StyleResolver::build_rule_cache() const
+{
+    m_rule_cache = make<RuleCache>();
+    m_rule_cache->was_built_in_quirks_mode = document().in_quirks_mode();
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
@@ -75,18 +186,87 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(DOM::Element const& e
         static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
-                    break;
+                MatchingRule matching_rule { rule, style_sheet_index, rule_index, selector_index, selector.specificity() };
+                collect_selector_features(selector, m_rule_cache->features);
+                if (is_structural(selector))
+                    m_rule_cache->structural_rules.append(matching_rule);
+
+                // An id narrows things down the most, then a class, then the tag name.
+                Optional<FlyString> id;
+                Optional<FlyString> class_name;
+                Optional<FlyString> tag_name;
+                if (!selector.compound_selectors().is_empty()) {
+                    for (auto& simple_selector : selector.compound_selectors().last().simple_selectors) {
+                        if (simple_selector.type == Selector::SimpleSelector::Type::Id && !id.has_value())
+                            id = simple_selector.value;
+                        else if (simple_selector.type == Selector::SimpleSelector::Type::Class && !class_name.has_value())
+                            class_name = simple_selector.value;
+                        else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !tag_name.has_value())
+                            tag_name = simple_selector.value;
+                    }
                 }
+
+                if (id.has_value())
+                    m_rule_cache->rules_by_id.ensure(*id).append(move(matching_rule));
+                else if (class_name.has_value())
+                    m_rule_cache->rules_by_class.ensure(*class_name).append(move(matching_rule));
+                else if (tag_name.has_value())
+                    m_rule_cache->rules_by_tag_name.ensure(*tag_name).append(move(matching_rule));
+                else
+                    m_rule_cache->other_rules.append(move(matching_rule));
+
                 ++selector_index;
             }
             ++rule_index;
         });
         ++style_sheet_index;
     });
+}
+
+Vector<MatchingRule> StyleResolver::collect_matching_rules(DOM::Element const& element) const
+{
+    auto& rule_cache = this->rule_cache();
+
+    Vector<MatchingRule> matching_rules;
+    auto add_matching_rules = [&](Vector<MatchingRule> const& candidates) {
+        for (auto& candidate : candidates) {
+            ++m_selector_match_attempts;
+            if (SelectorEngine::matches(candidate.rule->selectors()[candidate.selector_index], element))
+                matching_rules.append(candidate);
+        }
+    };
+
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_null()) {
+        if (auto it = rule_cache.rules_by_id.find(FlyString { id }); it != rule_cache.rules_by_id.end())
+            add_matching_rules(it->value);
+    }
+    for (auto& class_name : element.class_names()) {
+        if (auto it = rule_cache.rules_by_class.find(class_name); it != rule_cache.rules_by_class.end())
+            add_matching_rules(it->value);
+    }
+    if (auto it = rule_cache.rules_by_tag_name.find(element.local_name()); it != rule_cache.rules_by_tag_name.end())
+        add_matching_rules(it->value);
+    add_matching_rules(rule_cache.other_rules);
 
-    return matching_rules;
+    // A rule only applies once, with the first of its selectors that matches, even if several of them do.
+    quick_sort(matching_rules, [](MatchingRule const& a, MatchingRule const& b) {
+        if (a.style_sheet_index != b.style_sheet_index)
+            return a.style_sheet_index < b.style_sheet_index;
+        if (a.rule_index != b.rule_index)
+            return a.rule_index < b.rule_index;
+        return a.selector_index < b.selector_index;
+    });
+    Vector<MatchingRule> unique_matching_rules;
+    unique_matching_rules.ensure_capacity(matching_rules.size());
+    for (auto& matching_rule : matching_rules) {
+        if (!unique_matching_rules.is_empty()) {
+            auto& previous = unique_matching_rules.last();
+            if (previous.style_sheet_index == matching_rule.style_sheet_index && previous.rule_index == matching_rule.rule_index)
+                continue;
+        }
+        unique_matching_rules.unchecked_append(move(matching_rule));
+    }
+    return unique_matching_rules;
 }
 
 void StyleResolver::sort_matching_rules(Vector<MatchingRule>& matching_rules) const
@@ -1967,8 +2147,92 @@ Optional<StyleProperty> StyleResolver::resolve_custom_property(DOM::Element& ele
     return resolved_with_specificity.style;
 }
 
+static bool is_hovered(DOM::Element const& element)
+{
+    auto* hovered_node = element.document().hovered_node();
+    return hovered_node && element.is_inclusive_ancestor_of(*hovered_node);
+}
+
+static bool have_same_attributes(DOM::Element const& element, DOM::Element const& other)
+{
+    size_t attribute_count = 0;
+    bool have_same_attributes = true;
+    element.for_each_attribute([&](auto& name, auto& value) {
+        ++attribute_count;
+        if (have_same_attributes && other.attribute(name) != value)
+            have_same_attributes = false;
+    });
+    if (!have_same_attributes)
+        return false;
+
+    size_t other_attribute_count = 0;
+    other.for_each_attribute([&](auto&, auto&) {
+        ++other_attribute_count;
+    });
+    return attribute_count == other_attribute_count;
+}
+
+bool StyleResolver::can_share_style(DOM::Element const& element, DOM::Element const& candidate) const
+{
+    if (!candidate.specified_css_values() || candidate.needs_style_update())
+        return false;
+    if (candidate.local_name() != element.local_name() || candidate.namespace_() != element.namespace_())
+        return false;
+
+    // Everything selectors and presentational hints look at is in the attributes, including the inline style.
+    if (!have_same_attributes(element, candidate))
+        return false;
+    if (is_hovered(candidate) || candidate.is_focused() || candidate.is_active())
+        return false;
+
+    for (auto& rule : rule_cache().structural_rules) {
+        auto& selector = rule.rule->selectors()[rule.selector_index];
+        if (SelectorEngine::matches(selector, element) != SelectorEngine::matches(selector, candidate))
+            return false;
+    }
+    return true;
+}
+
+RefPtr<StyleProperties> StyleResolver::find_shareable_style(DOM::Element& element) const
+{
+    static constexpr size_t max_candidates = 16;
+
+    auto* parent = element.parent_element();
+    if (!parent || !parent->specified_css_values())
+        return nullptr;
+    if (is_hovered(element) || element.is_focused() || element.is_active())
+        return nullptr;
+
+    size_t candidates_left = max_candidates;
+    auto shareable_style_of = [&](DOM::Element* last_candidate) -> RefPtr<StyleProperties> {
+        for (auto* candidate = last_candidate; candidate && candidates_left > 0; candidate = candidate->previous_element_sibling()) {
+            --candidates_left;
+            if (can_share_style(element, *candidate))
+                return const_cast<StyleProperties*>(candidate->specified_css_values());
+        }
+        return nullptr;
+    };
+
+    if (auto style = shareable_style_of(element.previous_element_sibling()))
+        return style;
+
+    // Cousins inherit the same values if their parents share their style, so they can share theirs too.
+    for (auto* parent_sibling = parent->previous_element_sibling(); parent_sibling && candidates_left > 0; parent_sibling = parent_sibling->previous_element_sibling()) {
+        if (parent_sibling->specified_css_values() != parent->specified_css_values()) {
+            --candidates_left;
+            continue;
+        }
+        if (auto style = shareable_style_of(parent_sibling->last_element_child()))
+            return style;
+    }
+    return nullptr;
+}
+
 NonnullRefPtr<StyleProperties> StyleResolver::resolve_style(DOM::Element& element) const
 {
+    if (auto shared_style = find_shareable_style(element))
+        return shared_style.release_nonnull();
+
     auto style = StyleProperties::create();
 
     if (auto* parent_style = element.parent_element() ? element.parent_element()->specified_css_values() : nullptr) {
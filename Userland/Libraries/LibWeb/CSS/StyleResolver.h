@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <AK/EnumBits.h>
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
@@ -22,6 +25,25 @@ struct MatchingRule {
     u32 specificity { 0 };
 };
 
+// The elements whose style may change when something about an element changes.
+enum class StyleInvalidationScope : u8 {
+    None = 0,
+    Element = 1 << 0,
+    Descendants = 1 << 1,
+    // The siblings after the element, and everything inside them.
+    FollowingSiblings = 1 << 2,
+};
+
+AK_ENUM_BITWISE_OPERATORS(StyleInvalidationScope);
+
+// What the selectors in the document depend on, and how far a change to each of those things reaches.
+struct SelectorFeatures {
+    HashMap<FlyString, StyleInvalidationScope> ids;
+    HashMap<FlyString, StyleInvalidationScope> classes;
+    HashMap<FlyString, StyleInvalidationScope> attribute_names;
+    StyleInvalidationScope hover { StyleInvalidationScope::None };
+};
+
 class StyleResolver {
 public:
     explicit StyleResolver(DOM::Document&);
@@ -43,11 +65,41 @@ public:
 
     static bool is_inherited_property(CSS::PropertyID);
 
+    // Must be called whenever the set of style rules that apply to the document changes.
+    void invalidate_rule_cache();
+
+    size_t selector_match_attempts() const { return m_selector_match_attempts; }
+
+    SelectorFeatures const& selector_features() const { return rule_cache().features; }
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
+    // Selectors are filed under the id, a class or the tag name their rightmost compound selector requires,
+    // so an element only has to be matched against the selectors that could possibly apply to it.
+    struct RuleCache {
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
+        Vector<MatchingRule> other_rules;
+        // Selectors that look at an element's siblings or children. Two elements can only share their style if
+        // these match both or neither of them.
+        Vector<MatchingRule> structural_rules;
+        SelectorFeatures features;
+        bool was_built_in_quirks_mode { false };
+    };
+
+    RuleCache const& rule_cache() const;
+    void build_rule_cache() const;
+
+    // Elements that would end up with the same style as a recently styled sibling or cousin just get that style.
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+    bool can_share_style(DOM::Element const&, DOM::Element const& candidate) const;
+
     DOM::Document& m_document;
+    mutable OwnPtr<RuleCache> m_rule_cache;
+    mutable size_t m_selector_match_attempts { 0 };
 };
 
 }
@@ -804,12 +804,12 @@ public:
 
     if (interface.extended_attributes.contains("CustomGet")) {
         generator.append(R"~~~(
-    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver) const override;
+    virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) const override;
 )~~~");
     }
     if (interface.extended_attributes.contains("CustomSet")) {
         generator.append(R"~~~(
-    virtual bool internal_set(JS::PropertyName const&, JS::Value, JS::Value receiver) override;
+    virtual bool internal_set(JS::PropertyName const&, JS::Value, JS::Value receiver, JS::CacheablePropertyMetadata* = nullptr) override;
 )~~~");
     }
 
@@ -6,6 +6,7 @@
 
 #include <LibWeb/DOM/CharacterData.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -24,8 +25,10 @@ void CharacterData::set_data(String data)
     if (m_data == data)
         return;
     m_data = move(data);
-    // FIXME: This is definitely too aggressive.
-    document().schedule_forced_layout();
+    if (auto* layout_node = this->layout_node()) {
+        layout_node->set_needs_layout();
+        document().schedule_layout_update();
+    }
 }
 
 }
@@ -11,10 +11,11 @@
 #include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
 #include <LibJS/Interpreter.h>
-#include <LibJS/Parser.h>
 #include <LibJS/Runtime/FunctionObject.h>
+#include <LibJS/ScriptCache.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
 #include <LibWeb/Bindings/WindowObject.h>
+#include <LibWeb/CSS/StyleInvalidator.h>
 #include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/DOM/Comment.h>
@@ -72,6 +73,10 @@ Document::Document(const URL& url)
     m_forced_layout_timer = Core::Timer::create_single_shot(0, [this] {
         force_layout();
     });
+
+    m_layout_update_timer = Core::Timer::create_single_shot(0, [this] {
+        update_layout();
+    });
 }
 
 Document::~Document()
@@ -157,6 +162,13 @@ void Document::schedule_forced_layout()
     m_forced_layout_timer->start();
 }
 
+void Document::schedule_layout_update()
+{
+    if (m_layout_update_timer->is_active())
+        return;
+    m_layout_update_timer->start();
+}
+
 bool Document::is_child_allowed(const Node& node) const
 {
     switch (node.type()) {
@@ -320,6 +332,7 @@ void Document::tear_down_layout_tree()
     }
 
     m_layout_root = nullptr;
+    m_viewport_size_of_last_layout = {};
 }
 
 Color Document::background_color(const Palette& palette) const
@@ -402,14 +415,28 @@ void Document::update_layout()
     if (!browsing_context())
         return;
 
+    auto viewport_size = browsing_context()->viewport_rect().size();
+
     if (!m_layout_root) {
         Layout::TreeBuilder tree_builder;
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
+        m_layout_root->set_needs_layout();
+    } else if (m_viewport_size_of_last_layout != viewport_size) {
+        // Viewport-relative sizes may have changed anywhere, so nothing keeps its previous layout.
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([&](auto& box) {
+            box.set_width_of_last_layout({});
+            return IterationDecision::Continue;
+        });
+        m_layout_root->set_needs_layout();
+    } else if (!m_layout_root->needs_layout() && !m_layout_root->child_needs_layout()) {
+        return;
     }
+    m_viewport_size_of_last_layout = viewport_size;
 
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
 
+    m_layout_root->clear_needs_layout();
     m_layout_root->set_needs_display();
 
     if (browsing_context()->is_top_level()) {
@@ -492,7 +519,22 @@ void Document::set_hovered_node(Node* node)
     RefPtr<Node> old_hovered_node = move(m_hovered_node);
     m_hovered_node = node;
 
-    invalidate_style();
+    auto hover_scope = style_resolver().selector_features().hover;
+    if (hover_scope == CSS::StyleInvalidationScope::None)
+        return;
+
+    // Only the elements that started or stopped being hovered are affected, and those are the inclusive ancestors
+    // of one of the two nodes that aren't inclusive ancestors of the other.
+    auto invalidate_hover_changes = [&](Node* from, Node* other) {
+        for (auto* ancestor = from; ancestor; ancestor = ancestor->parent()) {
+            if (other && ancestor->is_inclusive_ancestor_of(*other))
+                break;
+            if (is<Element>(*ancestor))
+                CSS::StyleInvalidator::invalidate(verify_cast<Element>(*ancestor), hover_scope);
+        }
+    };
+    invalidate_hover_changes(old_hovered_node.ptr(), m_hovered_node.ptr());
+    invalidate_hover_changes(m_hovered_node.ptr(), old_hovered_node.ptr());
 }
 
 NonnullRefPtr<HTMLCollection> Document::get_elements_by_name(String const& name)
@@ -670,15 +712,17 @@ JS::Interpreter& Document::interpreter()
 
 JS::Value Document::run_javascript(const StringView& source, const StringView& filename)
 {
-    auto parser = JS::Parser(JS::Lexer(source, filename));
-    auto program = parser.parse_program();
-    if (parser.has_errors()) {
-        parser.print_errors(false);
+    // Most functions on a page never run, so we don't spend time and memory on their AST until they do.
+    auto result = JS::ScriptCache::the().parse(filename, source, true);
+    if (result.is_error()) {
+        for (auto& error : result.error())
+            warnln("SyntaxError: {}", error.to_string());
         return JS::js_undefined();
     }
+    auto script = result.release_value();
     auto& interpreter = document().interpreter();
     auto& vm = interpreter.vm();
-    interpreter.run(interpreter.global_object(), *program);
+    interpreter.run(interpreter.global_object(), script->program());
     if (vm.exception())
         vm.clear_exception();
     return vm.last_value();
@@ -14,6 +14,7 @@
 #include <AK/URL.h>
 #include <AK/WeakPtr.h>
 #include <LibCore/Forward.h>
+#include <LibGfx/Size.h>
 #include <LibJS/Forward.h>
 #include <LibWeb/Bindings/ScriptExecutionContext.h>
 #include <LibWeb/Bindings/WindowObject.h>
@@ -151,6 +152,7 @@ public:
 
     void schedule_style_update();
     void schedule_forced_layout();
+    void schedule_layout_update();
 
     NonnullRefPtr<HTMLCollection> get_elements_by_name(String const&);
     NonnullRefPtr<HTMLCollection> get_elements_by_tag_name(FlyString const&);
@@ -316,6 +318,10 @@ private:
 
     RefPtr<Core::Timer> m_style_update_timer;
     RefPtr<Core::Timer> m_forced_layout_timer;
+    RefPtr<Core::Timer> m_layout_update_timer;
+
+    // The layout tree is only laid out again if something in it needs layout, or the viewport changed size.
+    Optional<Gfx::IntSize> m_viewport_size_of_last_layout;
 
     String m_source;
 
@@ -21,6 +21,7 @@
 #include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/InlineNode.h>
 #include <LibWeb/Layout/ListItemBox.h>
+#include <LibWeb/Layout/ReplacedBox.h>
 #include <LibWeb/Layout/TableBox.h>
 #include <LibWeb/Layout/TableCellBox.h>
 #include <LibWeb/Layout/TableRowBox.h>
@@ -72,7 +73,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
     if (name.is_empty())
         return InvalidCharacterError::create("Attribute name must not be empty");
 
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -80,14 +81,25 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
         m_attributes.empend(name, value);
 
     parse_attribute(name, value);
+    did_change_attribute();
     return {};
 }
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
+    did_change_attribute();
+}
+
+void Element::did_change_attribute()
+{
+    // The size of replaced content (images, canvases, ...) can depend on attributes rather than style.
+    if (is<Layout::ReplacedBox>(layout_node())) {
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
+    }
 }
 
 bool Element::has_class(const FlyString& class_name, CaseSensitivity case_sensitivity) const
@@ -168,29 +180,60 @@ enum class StyleDifference {
     None,
     NeedsRepaint,
     NeedsRelayout,
+    NeedsLayoutTreeRebuild,
 };
 
-static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, const Document& document)
+// Properties that only change how things are painted, not where they go.
+static bool property_affects_layout(CSS::PropertyID property_id)
+{
+    switch (property_id) {
+    case CSS::PropertyID::BackgroundColor:
+    case CSS::PropertyID::BackgroundImage:
+    case CSS::PropertyID::BackgroundRepeat:
+    case CSS::PropertyID::BackgroundRepeatX:
+    case CSS::PropertyID::BackgroundRepeatY:
+    case CSS::PropertyID::BorderBottomColor:
+    case CSS::PropertyID::BorderColor:
+    case CSS::PropertyID::BorderLeftColor:
+    case CSS::PropertyID::BorderRightColor:
+    case CSS::PropertyID::BorderTopColor:
+    case CSS::PropertyID::BoxShadow:
+    case CSS::PropertyID::Color:
+    case CSS::PropertyID::Cursor:
+    case CSS::PropertyID::TextDecorationColor:
+    case CSS::PropertyID::TextDecorationLine:
+    case CSS::PropertyID::TextDecorationStyle:
+        return false;
+    default:
+        return true;
+    }
+}
+
+static bool has_layout_affecting_difference(const CSS::StyleProperties& style, const CSS::StyleProperties& other_style)
+{
+    bool has_difference = false;
+    style.for_each_property([&](auto property_id, auto& value) {
+        if (has_difference || !property_affects_layout(property_id))
+            return;
+        auto other_value = other_style.property(property_id);
+        if (!other_value.has_value() || *other_value.value() != value)
+            has_difference = true;
+    });
+    return has_difference;
+}
+
+static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style)
 {
     if (old_style == new_style)
         return StyleDifference::None;
 
-    bool needs_repaint = false;
-    bool needs_relayout = false;
-
     if (new_style.display() != old_style.display())
-        needs_relayout = true;
-
-    if (new_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black))
-        needs_repaint = true;
-    else if (new_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black))
-        needs_repaint = true;
+        return StyleDifference::NeedsLayoutTreeRebuild;
 
-    if (needs_relayout)
+    if (has_layout_affecting_difference(old_style, new_style) || has_layout_affecting_difference(new_style, old_style))
         return StyleDifference::NeedsRelayout;
-    if (needs_repaint)
-        return StyleDifference::NeedsRepaint;
-    return StyleDifference::None;
+
+    return StyleDifference::NeedsRepaint;
 }
 
 void Element::recompute_style()
@@ -200,6 +243,14 @@ void Element::recompute_style()
     auto old_specified_css_values = m_specified_css_values;
     auto new_specified_css_values = document().style_resolver().resolve_style(*this);
     m_specified_css_values = new_specified_css_values;
+
+    // Children inherit from this element, so they only have to be looked at again if its style actually changed.
+    if (!old_specified_css_values || *old_specified_css_values != *new_specified_css_values) {
+        for_each_child_of_type<Element>([&](auto& child) {
+            child.set_needs_style_update(true);
+        });
+    }
+
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
@@ -209,16 +260,21 @@ void Element::recompute_style()
         return;
     }
 
-    auto diff = StyleDifference::NeedsRelayout;
+    auto diff = StyleDifference::NeedsLayoutTreeRebuild;
     if (old_specified_css_values)
-        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
+        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values);
     if (diff == StyleDifference::None)
         return;
     layout_node()->apply_style(*new_specified_css_values);
-    if (diff == StyleDifference::NeedsRelayout) {
+    if (diff == StyleDifference::NeedsLayoutTreeRebuild) {
         document().schedule_forced_layout();
         return;
     }
+    if (diff == StyleDifference::NeedsRelayout) {
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
+        return;
+    }
     if (diff == StyleDifference::NeedsRepaint) {
         layout_node()->set_needs_display();
     }
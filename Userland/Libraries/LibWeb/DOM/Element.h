@@ -112,6 +112,7 @@ private:
     const Attribute* find_attribute(const FlyString& name) const;
 
     void make_html_uppercased_qualified_name();
+    void did_change_attribute();
 
     QualifiedName m_qualified_name;
     String m_html_uppercased_qualified_name;
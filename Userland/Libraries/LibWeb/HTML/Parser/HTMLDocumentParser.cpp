@@ -5,8 +5,12 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/ScopeGuard.h>
 #include <AK/SourceLocation.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Utf32View.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/Timer.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/Document.h>
@@ -23,6 +27,7 @@
 #include <LibWeb/HTML/HTMLTemplateElement.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -92,6 +97,9 @@ static Vector<FlyString> s_quirks_public_ids = {
     "-//WebTechs//DTD Mozilla HTML//"
 };
 
+// How long the parser may keep the event loop waiting when parsing a document incrementally.
+static constexpr int incremental_parsing_time_slice_ms = 10;
+
 RefPtr<DOM::Document> parse_html_document(const StringView& data, const URL& url, const String& encoding)
 {
     auto document = DOM::Document::create(url);
@@ -104,7 +112,6 @@ HTMLDocumentParser::HTMLDocumentParser(DOM::Document& document, const StringView
     : m_tokenizer(input, encoding)
     , m_document(document)
 {
-    m_document->set_should_invalidate_styles_on_attribute_changes(false);
     auto standardized_encoding = TextCodec::get_standardized_encoding(encoding);
     VERIFY(standardized_encoding.has_value());
     m_document->set_encoding(standardized_encoding.value());
@@ -112,15 +119,71 @@ HTMLDocumentParser::HTMLDocumentParser(DOM::Document& document, const StringView
 
 HTMLDocumentParser::~HTMLDocumentParser()
 {
-    m_document->set_should_invalidate_styles_on_attribute_changes(true);
 }
 
 void HTMLDocumentParser::run(const URL& url)
 {
+    TemporaryChange is_running_change { m_is_running, true };
+
     m_document->set_url(url);
     m_document->set_source(m_tokenizer.source());
+    process_tokens({});
+    the_end();
+}
+
+void HTMLDocumentParser::run_incrementally(const URL& url, Function<void()> on_complete)
+{
+    m_document->set_url(url);
+    m_document->set_source(m_tokenizer.source());
+
+    m_on_incremental_parsing_complete = move(on_complete);
+    m_incremental_parsing_timer = Core::Timer::create_single_shot(0, [this] {
+        continue_incremental_parsing();
+    });
+    m_incremental_parsing_timer->start();
+}
+
+void HTMLDocumentParser::continue_incremental_parsing()
+{
+    TemporaryChange is_running_change { m_is_running, true };
+
+    if (!process_tokens(incremental_parsing_time_slice_ms)) {
+        m_incremental_parsing_timer->start();
+        return;
+    }
+    if (m_aborted)
+        return;
+
+    the_end();
+    if (auto on_complete = move(m_on_incremental_parsing_complete))
+        on_complete();
+}
+
+void HTMLDocumentParser::abort()
+{
+    m_aborted = true;
+    m_stop_parsing = true;
+    if (m_incremental_parsing_timer)
+        m_incremental_parsing_timer->stop();
+}
+
+bool HTMLDocumentParser::process_tokens(Optional<int> time_budget_ms)
+{
+    // Attributes set by the parser don't need to invalidate style, but the ones set by anything that runs
+    // between two slices of incremental parsing do.
+    m_document->set_should_invalidate_styles_on_attribute_changes(false);
+    ScopeGuard invalidate_styles_on_attribute_changes_again = [&] {
+        m_document->set_should_invalidate_styles_on_attribute_changes(true);
+    };
+
+    Core::ElapsedTimer timer;
+    timer.start();
+
+    for (size_t processed_tokens = 0;; ++processed_tokens) {
+        // Looking at the clock is only worth it every so often, most tokens take next to no time at all.
+        if (time_budget_ms.has_value() && processed_tokens % 64 == 63 && timer.elapsed() >= *time_budget_ms)
+            return false;
 
-    for (;;) {
         auto optional_token = m_tokenizer.next_token();
         if (!optional_token.has_value())
             break;
@@ -148,7 +211,11 @@ void HTMLDocumentParser::run(const URL& url)
     }
 
     flush_character_insertions();
+    return true;
+}
 
+void HTMLDocumentParser::the_end()
+{
     // "The end"
 
     m_document->set_ready_state("interactive");
@@ -1888,6 +1955,10 @@ void HTMLDocumentParser::handle_text(HTMLToken& token)
         NonnullRefPtr<HTMLScriptElement> script = verify_cast<HTMLScriptElement>(current_node());
         m_stack_of_open_elements.pop();
         m_insertion_mode = m_original_insertion_mode;
+        // Loading an external script blocks the parser, so this is a good time to get the resources after it going.
+        if (script->has_attribute(HTML::AttributeNames::src))
+            run_the_preload_scanner();
+
         // FIXME: Handle tokenizer insertion point stuff here.
         increment_script_nesting_level();
         script->prepare_script({});
@@ -2988,6 +3059,17 @@ DOM::Document& HTMLDocumentParser::document()
     return *m_document;
 }
 
+void HTMLDocumentParser::run_the_preload_scanner()
+{
+    // The scanner goes through everything up to the end of the input, so once is enough.
+    if (m_has_run_preload_scanner || m_parsing_fragment)
+        return;
+    m_has_run_preload_scanner = true;
+
+    HTMLPreloadScanner scanner(document(), m_tokenizer.unprocessed_source());
+    scanner.scan();
+}
+
 NonnullRefPtrVector<DOM::Node> HTMLDocumentParser::parse_html_fragment(DOM::Element& context_element, const StringView& markup)
 {
     auto temp_document = DOM::Document::create();
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <LibCore/Forward.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
@@ -50,6 +52,16 @@ public:
 
     void run(const URL&);
 
+    // Parses the input a slice at a time, going back to the event loop in between, so that the page can be painted
+    // and respond to input while it's still loading. on_complete is called once the whole document has been parsed.
+    void run_incrementally(const URL&, Function<void()> on_complete);
+
+    // Stops parsing for good. The document is left the way it was, and run_incrementally() won't call on_complete.
+    void abort();
+
+    // Whether the parser is currently in the middle of parsing, which means it's somewhere up the call stack.
+    bool is_running() const { return m_is_running; }
+
     DOM::Document& document();
 
     static NonnullRefPtrVector<DOM::Node> parse_html_fragment(DOM::Element& context_element, const StringView&);
@@ -142,6 +154,12 @@ private:
     void clear_the_stack_back_to_a_table_row_context();
     void close_the_cell();
 
+    void run_the_preload_scanner();
+
+    bool process_tokens(Optional<int> time_budget_ms);
+    void continue_incremental_parsing();
+    void the_end();
+
     InsertionMode m_insertion_mode { InsertionMode::Initial };
     InsertionMode m_original_insertion_mode { InsertionMode::Initial };
 
@@ -159,6 +177,8 @@ private:
     bool m_aborted { false };
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
+    bool m_has_run_preload_scanner { false };
+    bool m_is_running { false };
     size_t m_script_nesting_level { 0 };
 
     NonnullRefPtr<DOM::Document> m_document;
@@ -170,6 +190,9 @@ private:
 
     RefPtr<DOM::Text> m_character_insertion_node;
     StringBuilder m_character_insertion_builder;
+
+    RefPtr<Core::Timer> m_incremental_parsing_timer;
+    Function<void()> m_on_incremental_parsing_complete;
 };
 
 }
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document, StringView const& input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8")
+{
+}
+
+void HTMLPreloadScanner::scan()
+{
+    for (;;) {
+        auto token = m_tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (token->is_start_tag())
+            process_start_tag(*token);
+    }
+
+    for (auto& url : m_image_urls)
+        ResourceLoader::the().preload(Resource::Type::Image, LoadRequest::create_for_url_on_page(url, m_document.page()));
+    m_image_urls.clear();
+}
+
+void HTMLPreloadScanner::process_start_tag(HTMLToken& token)
+{
+    auto& tag_name = token.tag_name();
+
+    if (tag_name == HTML::TagNames::script) {
+        auto type = token.attribute(HTML::AttributeNames::type);
+        if (type.is_null() || type.is_empty() || type.equals_ignoring_case("text/javascript") || type.equals_ignoring_case("application/javascript"))
+            preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::src));
+    } else if (tag_name == HTML::TagNames::link) {
+        if (token.attribute(HTML::AttributeNames::rel).equals_ignoring_case("stylesheet"))
+            preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::href));
+    } else if (tag_name == HTML::TagNames::img) {
+        preload(Resource::Type::Image, token.attribute(HTML::AttributeNames::src));
+    }
+
+    // The tree builder is what normally tells the tokenizer how to read the contents of these elements,
+    // so the scanner has to do it itself. Otherwise, markup in a script would be mistaken for real tags.
+    if (tag_name.is_one_of(HTML::TagNames::title, HTML::TagNames::textarea))
+        m_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+    else if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes))
+        m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+    else if (tag_name == HTML::TagNames::noscript && m_document.is_scripting_enabled())
+        m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+    else if (tag_name == HTML::TagNames::script)
+        m_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+    else if (tag_name == HTML::TagNames::plaintext)
+        m_tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, StringView const& url_string)
+{
+    if (url_string.is_empty())
+        return;
+    auto url = m_document.complete_url(url_string);
+    if (!url.is_valid())
+        return;
+
+    if (type == Resource::Type::Image) {
+        m_image_urls.append(move(url));
+        return;
+    }
+
+    dbgln_if(PARSER_DEBUG, "Preload scanner found {}", url);
+    ResourceLoader::the().preload(type, LoadRequest::create_for_url_on_page(url, m_document.page()));
+}
+
+}
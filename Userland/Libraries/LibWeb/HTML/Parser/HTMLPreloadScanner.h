@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// While the parser is stuck waiting for a script, the preload scanner tokenizes the rest of the input on its own
+// and starts loading the scripts, style sheets and images it finds there, so they're already on their way by
+// the time the parser gets to them.
+class HTMLPreloadScanner {
+public:
+    HTMLPreloadScanner(DOM::Document&, StringView const& input);
+
+    void scan();
+
+private:
+    void process_start_tag(HTMLToken&);
+    void preload(Resource::Type, StringView const& url);
+
+    DOM::Document& m_document;
+    HTMLTokenizer m_tokenizer;
+
+    // Images don't keep anything else from making progress, so they're only requested when everything else has been.
+    Vector<URL> m_image_urls;
+};
+
+}
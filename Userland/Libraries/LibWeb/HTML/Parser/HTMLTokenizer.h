@@ -121,6 +121,9 @@ public:
 
     String source() const { return m_decoded_input; }
 
+    // The part of the input that hasn't been tokenized yet.
+    StringView unprocessed_source() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
+
 private:
     void skip(size_t count);
     Optional<u32> next_code_point();
@@ -153,9 +153,9 @@ void InProcessWebView::page_did_unhover_link()
         on_link_hover({});
 }
 
-void InProcessWebView::page_did_invalidate(const Gfx::IntRect&)
+void InProcessWebView::page_did_invalidate(const Gfx::IntRect& content_rect)
 {
-    update();
+    update(to_widget_rect(content_rect));
 }
 
 void InProcessWebView::page_did_change_favicon(const Gfx::Bitmap& bitmap)
@@ -209,6 +209,7 @@ void InProcessWebView::paint_event(GUI::PaintEvent& event)
     PaintContext context(painter, palette(), { horizontal_scrollbar().value(), vertical_scrollbar().value() });
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_viewport_rect(viewport_rect_in_content_coordinates());
+    context.set_paint_rect(to_content_rect(event.rect()));
     context.set_has_focus(is_focused());
     layout_root()->paint_all_phases(context);
 }
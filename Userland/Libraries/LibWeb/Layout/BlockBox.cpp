@@ -51,8 +51,16 @@ void BlockBox::paint(PaintContext& context, PaintPhase phase)
         context.painter().translate(-m_scroll_offset.to_type<int>());
     }
 
+    bool can_skip_fragments_outside_paint_rect = context.has_paint_rect() && !is_fixed_position();
     for (auto& line_box : m_line_boxes) {
         for (auto& fragment : line_box.fragments()) {
+            if (can_skip_fragments_outside_paint_rect) {
+                auto fragment_rect = enclosing_int_rect(fragment.absolute_rect());
+                if (should_clip_overflow())
+                    fragment_rect.translate_by(-m_scroll_offset.to_type<int>());
+                if (context.is_outside_paint_rect(fragment_rect))
+                    continue;
+            }
             if (context.should_show_line_box_borders())
                 context.painter().draw_rect(enclosing_int_rect(fragment.absolute_rect()), Color::Green);
             fragment.paint(context, phase);
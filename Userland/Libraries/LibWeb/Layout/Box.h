@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Layout/LineBox.h>
@@ -122,6 +123,11 @@ public:
 
     virtual float width_of_logical_containing_block() const;
 
+    // The width the insides of this box were last laid out at in LayoutMode::Default, if they haven't been laid out
+    // differently since. Their layout can be reused as long as the box and its descendants don't need layout.
+    Optional<float> width_of_last_layout() const { return m_width_of_last_layout; }
+    void set_width_of_last_layout(Optional<float> width) { m_width_of_last_layout = width; }
+
     struct BorderRadiusData {
         // FIXME: Use floats here
         int top_left { 0 };
@@ -159,6 +165,8 @@ private:
     WeakPtr<LineBoxFragment> m_containing_line_box_fragment;
 
     OwnPtr<StackingContext> m_stacking_context;
+
+    Optional<float> m_width_of_last_layout;
 };
 
 template<>
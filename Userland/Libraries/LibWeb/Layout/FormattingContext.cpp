@@ -65,7 +65,48 @@ bool FormattingContext::creates_block_formatting_context(const Box& box)
     return false;
 }
 
+bool FormattingContext::can_reuse_previous_layout(Box const& box) const
+{
+    if (box.needs_layout() || box.child_needs_layout())
+        return false;
+    if (!box.width_of_last_layout().has_value() || box.width_of_last_layout().value() != box.width())
+        return false;
+
+    // Floats and absolutely positioned boxes may be placed relative to things outside of the box.
+    bool has_out_of_flow_descendant = false;
+    box.for_each_in_subtree_of_type<Box>([&](auto& descendant) {
+        if (descendant.is_floating() || descendant.is_absolutely_positioned()) {
+            has_out_of_flow_descendant = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    if (has_out_of_flow_descendant)
+        return false;
+
+    // Unless the box starts a block formatting context of its own, its lines have to flow around the floats of ours.
+    if (creates_block_formatting_context(box))
+        return true;
+    if (!is_block_formatting_context())
+        return false;
+    auto& bfc = static_cast<BlockFormattingContext const&>(*this);
+    return bfc.left_floating_boxes().is_empty() && bfc.right_floating_boxes().is_empty();
+}
+
 void FormattingContext::layout_inside(Box& box, LayoutMode layout_mode)
+{
+    if (layout_mode == LayoutMode::Default && can_reuse_previous_layout(box))
+        return;
+
+    layout_inside_without_reuse(box, layout_mode);
+
+    if (layout_mode == LayoutMode::Default)
+        box.set_width_of_last_layout(box.width());
+    else
+        box.set_width_of_last_layout({});
+}
+
+void FormattingContext::layout_inside_without_reuse(Box& box, LayoutMode layout_mode)
 {
     if (creates_block_formatting_context(box)) {
         BlockFormattingContext context(box, this);
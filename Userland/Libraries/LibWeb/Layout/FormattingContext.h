@@ -32,6 +32,8 @@ protected:
     virtual ~FormattingContext();
 
     void layout_inside(Box&, LayoutMode);
+    void layout_inside_without_reuse(Box&, LayoutMode);
+    bool can_reuse_previous_layout(Box const&) const;
 
     struct ShrinkToFitResult {
         float preferred_width { 0 };
@@ -139,6 +139,24 @@ void Node::split_into_lines(InlineFormattingContext& context, LayoutMode layout_
     });
 }
 
+void Node::set_needs_layout()
+{
+    m_needs_layout = true;
+    for (auto* ancestor = parent(); ancestor && !ancestor->m_child_needs_layout; ancestor = ancestor->parent())
+        ancestor->m_child_needs_layout = true;
+}
+
+void Node::clear_needs_layout()
+{
+    m_needs_layout = false;
+    if (!m_child_needs_layout)
+        return;
+    m_child_needs_layout = false;
+    for_each_child([](auto& child) {
+        child.clear_needs_layout();
+    });
+}
+
 void Node::set_needs_display()
 {
     if (auto* block = containing_block()) {
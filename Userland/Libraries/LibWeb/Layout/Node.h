@@ -136,6 +136,13 @@ public:
 
     virtual void set_needs_display();
 
+    // A node needs layout when something about it changed that affects where things go. Its ancestors are told
+    // that something inside them needs layout, so the clean parts of the tree can keep their previous layout.
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout();
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -184,6 +191,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { false };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
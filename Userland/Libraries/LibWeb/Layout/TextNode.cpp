@@ -198,6 +198,16 @@ void TextNode::compute_text_for_rendering(bool collapse, bool previous_is_empty_
     m_text_for_rendering = builder.to_string();
 }
 
+int TextNode::measure_chunk(Gfx::Font const& font, Chunk const& chunk)
+{
+    u64 key = (static_cast<u64>(chunk.start) << 32) | chunk.length;
+    if (auto width = m_chunk_widths.get(key); width.has_value())
+        return width.value();
+    auto width = font.width(chunk.view);
+    m_chunk_widths.set(key, width);
+    return width;
+}
+
 void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, LayoutMode layout_mode, bool do_collapse, bool do_wrap_lines, bool do_wrap_breaks)
 {
     auto& containing_block = context.containing_block();
@@ -209,6 +219,14 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
     float available_width = context.available_width_at_line(line_boxes.size() - 1) - line_boxes.last().width();
 
     compute_text_for_rendering(do_collapse, line_boxes.last().is_empty_or_ends_in_whitespace());
+
+    // Widths measured by an earlier layout, say at another viewport width, are still good as long as the text and the font haven't changed.
+    if (m_font_of_chunk_widths.ptr() != &font || m_text_of_chunk_widths != m_text_for_rendering) {
+        m_chunk_widths.clear();
+        m_font_of_chunk_widths = font;
+        m_text_of_chunk_widths = m_text_for_rendering;
+    }
+
     ChunkIterator iterator(m_text_for_rendering, layout_mode, do_wrap_lines, do_wrap_breaks);
 
     for (;;) {
@@ -232,7 +250,7 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
                 chunk.view = chunk.view.substring_view(1, chunk.view.byte_length() - 1);
             }
 
-            chunk_width = font.width(chunk.view) + font.glyph_spacing();
+            chunk_width = measure_chunk(font, chunk) + font.glyph_spacing();
 
             if (line_boxes.last().width() > 0 && chunk_width > available_width) {
                 containing_block.add_line_box();
@@ -242,7 +260,7 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
                     continue;
             }
         } else {
-            chunk_width = font.width(chunk.view);
+            chunk_width = measure_chunk(font, chunk);
         }
 
         line_boxes.last().add_fragment(*this, chunk.start, chunk.length, chunk_width, font.glyph_height());
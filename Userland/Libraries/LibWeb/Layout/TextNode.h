@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/Utf8View.h>
 #include <LibWeb/DOM/Text.h>
 #include <LibWeb/Layout/Node.h>
@@ -64,8 +65,14 @@ private:
     void split_into_lines_by_rules(InlineFormattingContext&, LayoutMode, bool do_collapse, bool do_wrap_lines, bool do_wrap_breaks);
     void paint_cursor_if_needed(PaintContext&, const LineBoxFragment&) const;
     void paint_text_decoration(Gfx::Painter&, LineBoxFragment const&) const;
+    int measure_chunk(Gfx::Font const&, Chunk const&);
 
     String m_text_for_rendering;
+
+    // The width of each chunk of m_text_of_chunk_widths that has been laid out, keyed by its start and length.
+    HashMap<u64, int> m_chunk_widths;
+    RefPtr<Gfx::Font const> m_font_of_chunk_widths;
+    String m_text_of_chunk_widths;
 };
 
 template<>
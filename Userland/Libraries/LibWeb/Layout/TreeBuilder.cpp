@@ -129,6 +129,12 @@ RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
     if (auto* root = dom_node.document().layout_node())
         fixup_tables(*root);
 
+    // A partial layout tree is inserted into the existing one, which needs to make room for it.
+    if (dom_node.parent()) {
+        if (auto* layout_node = dom_node.layout_node())
+            layout_node->set_needs_layout();
+    }
+
     return move(m_layout_root);
 }
 
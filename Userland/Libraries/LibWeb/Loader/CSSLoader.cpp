@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <AK/URL.h>
+#include <LibCore/MemoryPressure.h>
 #include <LibWeb/CSS/CSSImportRule.h>
 #include <LibWeb/CSS/Parser/DeprecatedCSSParser.h>
 #include <LibWeb/CSS/StyleSheet.h>
@@ -16,6 +17,71 @@
 
 namespace Web {
 
+// Parsed style sheets are kept around per process, so that documents which load the same style sheet (think of every
+// page of a site, or several tabs) don't tokenize and parse it all over again. What a sheet parses to also depends on
+// the document, which relative URLs are completed against, and on whether it's in quirks mode, so those are part of
+// the key too. The rules are shared between all the sheets made from a cache entry, which is fine since style rules
+// can't be changed once parsed. Import rules can, as they get their sheet set once it's loaded, so every sheet gets
+// its own copies of those.
+struct CachedStyleSheet {
+    URL url;
+    URL document_url;
+    bool in_quirks_mode { false };
+    unsigned text_hash { 0 };
+    String text;
+    NonnullRefPtrVector<CSS::CSSRule> rules;
+};
+
+static constexpr size_t max_cached_style_sheets = 32;
+
+static Vector<CachedStyleSheet>& cached_style_sheets()
+{
+    static Vector<CachedStyleSheet> cache;
+    [[maybe_unused]] static bool clears_under_memory_pressure = [] {
+        Core::MemoryPressure::add_handler([](auto level) {
+            if (level != MemoryPressureLevel::None)
+                cache.clear();
+        });
+        return true;
+    }();
+    return cache;
+}
+
+static NonnullRefPtr<CSS::CSSStyleSheet> create_style_sheet_from_cached_rules(NonnullRefPtrVector<CSS::CSSRule> const& cached_rules)
+{
+    NonnullRefPtrVector<CSS::CSSRule> rules;
+    rules.ensure_capacity(cached_rules.size());
+    for (auto& rule : cached_rules) {
+        if (rule.type() == CSS::CSSRule::Type::Import)
+            rules.append(CSS::CSSImportRule::create(static_cast<CSS::CSSImportRule const&>(rule).url()));
+        else
+            rules.append(rule);
+    }
+    return CSS::CSSStyleSheet::create(move(rules));
+}
+
+static RefPtr<CSS::CSSStyleSheet> parse_css_with_cache(DOM::Document const& document, URL const& url, StringView const& text)
+{
+    auto text_hash = text.hash();
+    auto& cache = cached_style_sheets();
+    for (auto& entry : cache) {
+        if (entry.text_hash == text_hash && entry.in_quirks_mode == document.in_quirks_mode() && entry.url == url
+            && entry.document_url == document.url() && entry.text == text) {
+            dbgln_if(CSS_LOADER_DEBUG, "CSSLoader: Using cached style sheet for {}", url);
+            return create_style_sheet_from_cached_rules(entry.rules);
+        }
+    }
+
+    auto sheet = parse_css(CSS::DeprecatedParsingContext(document), text);
+    if (!sheet)
+        return nullptr;
+
+    if (cache.size() == max_cached_style_sheets)
+        cache.take_first();
+    cache.append(CachedStyleSheet { url, document.url(), document.in_quirks_mode(), text_hash, text, sheet->rules() });
+    return create_style_sheet_from_cached_rules(sheet->rules());
+}
+
 CSSLoader::CSSLoader(DOM::Element& owner_element)
     : m_owner_element(owner_element)
 {
@@ -23,7 +89,7 @@ CSSLoader::CSSLoader(DOM::Element& owner_element)
 
 void CSSLoader::load_from_text(const String& text)
 {
-    m_style_sheet = parse_css(CSS::DeprecatedParsingContext(m_owner_element.document()), text);
+    m_style_sheet = parse_css_with_cache(m_owner_element.document(), m_owner_element.document().url(), text);
     if (!m_style_sheet) {
         m_style_sheet = CSS::CSSStyleSheet::create({});
         m_style_sheet->set_owner_node(&m_owner_element);
@@ -51,7 +117,7 @@ void CSSLoader::resource_did_load()
         dbgln_if(CSS_LOADER_DEBUG, "CSSLoader: Resource did load, has encoded data. URL: {}", resource()->url());
     }
 
-    auto sheet = parse_css(CSS::DeprecatedParsingContext(m_owner_element.document()), resource()->encoded_data());
+    auto sheet = parse_css_with_cache(m_owner_element.document(), resource()->url(), resource()->encoded_data());
     if (!sheet) {
         dbgln_if(CSS_LOADER_DEBUG, "CSSLoader: Failed to parse stylesheet: {}", resource()->url());
         return;
@@ -65,6 +131,7 @@ void CSSLoader::resource_did_load()
     if (!was_imported) {
         m_style_sheet->rules() = sheet->rules();
     }
+    m_owner_element.document().style_resolver().invalidate_rule_cache();
 
     if (on_load)
         on_load();
@@ -112,14 +112,9 @@ static bool build_gemini_document(DOM::Document& document, const ByteBuffer& dat
     return true;
 }
 
-bool FrameLoader::parse_document(DOM::Document& document, const ByteBuffer& data)
+static bool build_document(DOM::Document& document, const ByteBuffer& data)
 {
     auto& mime_type = document.content_type();
-    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
-        auto parser = HTML::HTMLDocumentParser::create_with_uncertain_encoding(document, data);
-        parser->run(document.url());
-        return true;
-    }
     if (mime_type.starts_with("image/"))
         return build_image_document(document, data);
     if (mime_type == "text/plain" || mime_type == "application/json")
@@ -132,6 +127,36 @@ bool FrameLoader::parse_document(DOM::Document& document, const ByteBuffer& data
     return false;
 }
 
+bool FrameLoader::parse_document(DOM::Document& document, const ByteBuffer& data)
+{
+    auto& mime_type = document.content_type();
+    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
+        // HTML can be large, so it's parsed a bit at a time to keep the page usable in the meantime.
+        m_parser = HTML::HTMLDocumentParser::create_with_uncertain_encoding(document, data);
+        m_parser->run_incrementally(document.url(), [this, url = document.url()] {
+            document_did_finish_parsing(url);
+        });
+        return true;
+    }
+
+    if (!build_document(document, data))
+        return false;
+    document_did_finish_parsing(document.url());
+    return true;
+}
+
+void FrameLoader::abort_parsing()
+{
+    if (m_parser) {
+        m_parser->abort();
+        m_aborted_parsers.append(m_parser.release_nonnull());
+    }
+
+    // A parser that is still running is somewhere up the call stack, say in the script that started this load,
+    // so it has to stay around until it has returned.
+    m_aborted_parsers.remove_all_matching([](auto& parser) { return !parser->is_running(); });
+}
+
 bool FrameLoader::load(const LoadRequest& request, Type type)
 {
     if (!request.is_valid()) {
@@ -202,6 +227,8 @@ bool FrameLoader::load(const URL& url, Type type)
 
 void FrameLoader::load_html(const StringView& html, const URL& url)
 {
+    abort_parsing();
+
     auto document = DOM::Document::create(url);
     HTML::HTMLDocumentParser parser(document, html, "utf-8");
     parser.run(url);
@@ -267,18 +294,20 @@ void FrameLoader::resource_did_load()
     document->set_encoding(resource()->encoding());
     document->set_content_type(resource()->mime_type());
 
+    abort_parsing();
     browsing_context().set_document(document);
 
-    if (!parse_document(*document, resource()->encoded_data())) {
-        load_error_page(url, "Failed to parse content.");
-        return;
-    }
-
     // FIXME: Support multiple instances of the Set-Cookie response header.
     auto set_cookie = resource()->response_headers().get("Set-Cookie");
     if (set_cookie.has_value())
         document->set_cookie(set_cookie.value(), Cookie::Source::Http);
 
+    if (!parse_document(*document, resource()->encoded_data()))
+        load_error_page(url, "Failed to parse content.");
+}
+
+void FrameLoader::document_did_finish_parsing(const URL& url)
+{
     if (!url.fragment().is_empty())
         browsing_context().scroll_to_anchor(url.fragment());
 
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -41,9 +44,14 @@ private:
 
     void load_error_page(const URL& failed_url, const String& error_message);
     bool parse_document(DOM::Document&, const ByteBuffer& data);
+    void document_did_finish_parsing(const URL&);
+    void abort_parsing();
 
     BrowsingContext& m_browsing_context;
     size_t m_redirects_count { 0 };
+
+    OwnPtr<HTML::HTMLDocumentParser> m_parser;
+    Vector<NonnullOwnPtr<HTML::HTMLDocumentParser>> m_aborted_parsers;
 };
 
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <AK/Function.h>
 #include <LibGfx/Bitmap.h>
 #include <LibImageDecoderClient/Client.h>
@@ -11,6 +12,18 @@
 
 namespace Web {
 
+// How much memory decoded images may use before the ones that aren't visible get discarded.
+// They're decoded again if they're needed later on.
+static constexpr size_t decoded_images_memory_budget = 128 * MiB;
+
+static size_t s_decoded_images_size_in_bytes;
+
+static ImageResource::DecodedImagesList& decoded_images()
+{
+    static ImageResource::DecodedImagesList list;
+    return list;
+}
+
 ImageResource::ImageResource(const LoadRequest& request)
     : Resource(Type::Image, request)
 {
@@ -18,6 +31,7 @@ ImageResource::ImageResource(const LoadRequest& request)
 
 ImageResource::~ImageResource()
 {
+    discard_decoded_frames();
 }
 
 int ImageResource::frame_duration(size_t frame_index) const
@@ -52,8 +66,28 @@ void ImageResource::decode_if_needed() const
         return;
 
     NonnullRefPtr decoder = image_decoder_client();
-    auto image = decoder->decode_image(encoded_data());
+    did_decode(decoder->decode_image(encoded_data()));
+}
+
+void ImageResource::did_load_encoded_data()
+{
+    if (!has_encoded_data()) {
+        notify_clients_did_load();
+        return;
+    }
 
+    // Start decoding right away, so that ImageDecoder works on all the images of a page at once rather than one
+    // after the other as their clients get around to them. Whoever needs the image before it's done decodes it
+    // synchronously instead.
+    image_decoder_client().decode_image_async(encoded_data(), [this, protector = NonnullRefPtr(*this)](auto image) {
+        if (!m_has_attempted_decode && m_decoded_frames.is_empty())
+            did_decode(image);
+        notify_clients_did_load();
+    });
+}
+
+void ImageResource::did_decode(Optional<ImageDecoderClient::DecodedImage> const& image) const
+{
     if (image.has_value()) {
         m_loop_count = image.value().loop_count;
         m_animated = image.value().is_animated;
@@ -62,29 +96,64 @@ void ImageResource::decode_if_needed() const
             auto& frame = m_decoded_frames[i];
             frame.bitmap = image.value().frames[i].bitmap;
             frame.duration = image.value().frames[i].duration;
+            if (frame.bitmap)
+                m_decoded_size_in_bytes += frame.bitmap->size_in_bytes();
         }
+        s_decoded_images_size_in_bytes += m_decoded_size_in_bytes;
+        decoded_images().append(const_cast<ImageResource&>(*this));
+        discard_decoded_frames_over_budget();
     }
 
     m_has_attempted_decode = true;
 }
 
+void ImageResource::discard_decoded_frames() const
+{
+    decoded_images().remove(const_cast<ImageResource&>(*this));
+    s_decoded_images_size_in_bytes -= m_decoded_size_in_bytes;
+    m_decoded_size_in_bytes = 0;
+    m_decoded_frames.clear();
+    m_has_attempted_decode = false;
+}
+
+bool ImageResource::is_visible_in_viewport() const
+{
+    bool visible_in_viewport = false;
+    const_cast<ImageResource&>(*this).for_each_client([&](auto& client) {
+        if (static_cast<const ImageResourceClient&>(client).is_visible_in_viewport())
+            visible_in_viewport = true;
+    });
+    return visible_in_viewport;
+}
+
+void ImageResource::discard_decoded_frames_over_budget()
+{
+    // Whatever is visible stays, even if that alone is over the budget.
+    auto it = decoded_images().begin();
+    while (s_decoded_images_size_in_bytes > decoded_images_memory_budget && it != decoded_images().end()) {
+        auto& image = *it;
+        ++it;
+        if (image.is_visible_in_viewport())
+            continue;
+        dbgln_if(IMAGE_LOADER_DEBUG, "ImageResource: Discarding decoded frames of {} to stay within budget", image.url());
+        image.discard_decoded_frames();
+    }
+}
+
 const Gfx::Bitmap* ImageResource::bitmap(size_t frame_index) const
 {
     decode_if_needed();
     if (frame_index >= m_decoded_frames.size())
         return nullptr;
+    // Move it to the end of the list, since it has just been used.
+    if (m_decoded_images_list_node.is_in_list())
+        decoded_images().append(const_cast<ImageResource&>(*this));
     return m_decoded_frames[frame_index].bitmap;
 }
 
 void ImageResource::update_volatility()
 {
-    bool visible_in_viewport = false;
-    for_each_client([&](auto& client) {
-        if (static_cast<const ImageResourceClient&>(client).is_visible_in_viewport())
-            visible_in_viewport = true;
-    });
-
-    if (!visible_in_viewport) {
+    if (!is_visible_in_viewport()) {
         for (auto& frame : m_decoded_frames) {
             if (frame.bitmap)
                 frame.bitmap->set_volatile();
@@ -106,8 +175,7 @@ void ImageResource::update_volatility()
     if (still_has_decoded_image)
         return;
 
-    m_decoded_frames.clear();
-    m_has_attempted_decode = false;
+    discard_decoded_frames();
 }
 
 ImageResourceClient::~ImageResourceClient()
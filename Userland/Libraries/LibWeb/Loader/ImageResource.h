@@ -6,8 +6,13 @@
 
 #pragma once
 
+#include <AK/IntrusiveList.h>
 #include <LibWeb/Loader/Resource.h>
 
+namespace ImageDecoderClient {
+struct DecodedImage;
+}
+
 namespace Web {
 
 class ImageResource final : public Resource {
@@ -44,12 +49,26 @@ public:
 private:
     explicit ImageResource(const LoadRequest&);
 
+    virtual void did_load_encoded_data() override;
+
     void decode_if_needed() const;
+    void did_decode(Optional<ImageDecoderClient::DecodedImage> const&) const;
+    void discard_decoded_frames() const;
+    bool is_visible_in_viewport() const;
+    static void discard_decoded_frames_over_budget();
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+    mutable size_t m_decoded_size_in_bytes { 0 };
+
+    // Images with decoded frames are kept in the order they were last used in, so that the ones that haven't been
+    // looked at in the longest time can be discarded first when decoded images use up too much memory.
+    mutable IntrusiveListNode<ImageResource> m_decoded_images_list_node;
+
+public:
+    using DecodedImagesList = IntrusiveList<ImageResource, RawPtr<ImageResource>, &ImageResource::m_decoded_images_list_node>;
 };
 
 class ImageResourceClient : public ResourceClient {
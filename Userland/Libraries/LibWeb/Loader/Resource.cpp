@@ -71,7 +71,6 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
     m_encoded_data = ByteBuffer::copy(data);
     m_response_headers = headers;
     m_status_code = move(status_code);
-    m_loaded = true;
 
     auto content_type = headers.get("Content-Type");
 
@@ -99,6 +98,12 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
         }
     }
 
+    did_load_encoded_data();
+}
+
+void Resource::notify_clients_did_load()
+{
+    m_loaded = true;
     for_each_client([](auto& client) {
         client.resource_did_load();
     });
@@ -48,6 +48,7 @@ public:
     const ByteBuffer& encoded_data() const { return m_encoded_data; }
 
     const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers() const { return m_response_headers; }
+    const Optional<u32>& status_code() const { return m_status_code; }
 
     void register_client(Badge<ResourceClient>, ResourceClient&);
     void unregister_client(Badge<ResourceClient>, ResourceClient&);
@@ -64,6 +65,11 @@ public:
 protected:
     explicit Resource(Type, const LoadRequest&);
 
+    // Called once the data has been loaded, so that subclasses can get it ready before letting the clients know.
+    // The resource only counts as loaded once they have been.
+    virtual void did_load_encoded_data() { notify_clients_did_load(); }
+    void notify_clients_did_load();
+
 private:
     LoadRequest m_request;
     ByteBuffer m_encoded_data;
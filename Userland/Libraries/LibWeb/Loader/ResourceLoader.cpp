@@ -9,6 +9,7 @@
 #include <AK/JsonObject.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
+#include <LibCore/MemoryPressure.h>
 #include <LibProtocol/Request.h>
 #include <LibProtocol/RequestClient.h>
 #include <LibWeb/Loader/ContentFilter.h>
@@ -30,10 +31,55 @@ ResourceLoader::ResourceLoader()
     : m_protocol_client(Protocol::RequestClient::construct())
     , m_user_agent(default_user_agent)
 {
+    // Whatever is still in use is kept alive by its clients, so this only drops what might have been loaded again.
+    Core::MemoryPressure::add_handler([this](auto level) {
+        if (level != MemoryPressureLevel::None)
+            clear_cache();
+    });
 }
 
+static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
+
+static bool should_cache(const LoadRequest& request)
+{
+    return request.url().protocol() != "file";
+}
+
+// Lets load_sync() wait for a resource that someone else already started loading.
+class PendingResourceWaiter final : public ResourceClient {
+public:
+    PendingResourceWaiter(Resource& resource, Core::EventLoop& loop)
+        : m_loop(loop)
+    {
+        set_resource(&resource);
+    }
+
+private:
+    virtual void resource_did_load() override { m_loop.quit(0); }
+    virtual void resource_did_fail() override { m_loop.quit(0); }
+
+    Core::EventLoop& m_loop;
+};
+
 void ResourceLoader::load_sync(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
 {
+    // If the preload scanner already asked for this, there's no need to request it a second time.
+    if (auto it = s_resource_cache.find(request); it != s_resource_cache.end() && it->value->type() == Resource::Type::Generic) {
+        NonnullRefPtr<Resource> resource = it->value;
+        if (!resource->is_loaded() && !resource->is_failed()) {
+            Core::EventLoop loop;
+            PendingResourceWaiter waiter(resource, loop);
+            loop.exec();
+        }
+        if (resource->is_failed()) {
+            if (error_callback)
+                error_callback(resource->error(), resource->status_code());
+            return;
+        }
+        success_callback(resource->encoded_data(), resource->response_headers(), resource->status_code());
+        return;
+    }
+
     Core::EventLoop loop;
 
     load(
@@ -51,14 +97,12 @@ void ResourceLoader::load_sync(const LoadRequest& request, Function<void(Readonl
     loop.exec();
 }
 
-static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
-
 RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRequest& request)
 {
     if (!request.is_valid())
         return nullptr;
 
-    bool use_cache = request.url().protocol() != "file";
+    bool use_cache = should_cache(request);
 
     if (use_cache) {
         auto it = s_resource_cache.find(request);
@@ -89,6 +133,15 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
     return resource;
 }
 
+void ResourceLoader::preload(Resource::Type type, const LoadRequest& request)
+{
+    // Resources that aren't cached would just be loaded again by whoever needs them.
+    if (!request.is_valid() || !should_cache(request))
+        return;
+    dbgln_if(CACHE_DEBUG, "Preloading resource: {}", request.url());
+    load_resource(type, request);
+}
+
 void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
 {
     auto& url = request.url();
@@ -150,7 +203,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
     if (url.protocol() == "http" || url.protocol() == "https" || url.protocol() == "gemini") {
         HashMap<String, String> headers;
         headers.set("User-Agent", m_user_agent);
-        headers.set("Accept-Encoding", "gzip, deflate");
+        headers.set("Accept-Encoding", "gzip, deflate, zstd");
 
         for (auto& it : request.headers()) {
             headers.set(it.key, it.value);
@@ -36,6 +36,13 @@ public:
     Gfx::IntRect viewport_rect() const { return m_viewport_rect; }
     void set_viewport_rect(const Gfx::IntRect& rect) { m_viewport_rect = rect; }
 
+    // The part of the page that actually needs to be painted, in content coordinates. When painting only what was
+    // damaged, things entirely outside of it are skipped.
+    bool has_paint_rect() const { return m_paint_rect.has_value(); }
+    const Gfx::IntRect& paint_rect() const { return m_paint_rect.value(); }
+    void set_paint_rect(const Optional<Gfx::IntRect>& rect) { m_paint_rect = rect; }
+    bool is_outside_paint_rect(const Gfx::IntRect& rect) const { return m_paint_rect.has_value() && !m_paint_rect->intersects(rect); }
+
     const Gfx::IntPoint& scroll_offset() const { return m_scroll_offset; }
 
     bool has_focus() const { return m_focus; }
@@ -46,6 +53,7 @@ private:
     Palette m_palette;
     Optional<SVGContext> m_svg_context;
     Gfx::IntRect m_viewport_rect;
+    Optional<Gfx::IntRect> m_paint_rect;
     Gfx::IntPoint m_scroll_offset;
     bool m_should_show_line_box_borders { false };
     bool m_focus { false };
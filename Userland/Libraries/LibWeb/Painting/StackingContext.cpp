@@ -30,6 +30,17 @@ StackingContext::StackingContext(Box& box, StackingContext* parent)
     }
 }
 
+// Backgrounds and borders stay inside the border box, except for box shadows.
+static bool background_and_borders_are_outside_paint_rect(PaintContext const& context, Node const& node)
+{
+    if (!context.has_paint_rect() || !is<Box>(node) || node.is_fixed_position())
+        return false;
+    auto& box = verify_cast<Box>(node);
+    if (box.computed_values().box_shadow().has_value())
+        return false;
+    return context.is_outside_paint_rect(enclosing_int_rect(box.bordered_rect()));
+}
+
 void StackingContext::paint_descendants(PaintContext& context, Node& box, StackingContextPaintPhase phase)
 {
     box.for_each_child([&](auto& child) {
@@ -38,16 +49,20 @@ void StackingContext::paint_descendants(PaintContext& context, Node& box, Stacki
         switch (phase) {
         case StackingContextPaintPhase::BackgroundAndBorders:
             if (!child.is_floating() && !child.is_positioned()) {
-                child.paint(context, PaintPhase::Background);
-                child.paint(context, PaintPhase::Border);
+                if (!background_and_borders_are_outside_paint_rect(context, child)) {
+                    child.paint(context, PaintPhase::Background);
+                    child.paint(context, PaintPhase::Border);
+                }
                 paint_descendants(context, child, phase);
             }
             break;
         case StackingContextPaintPhase::Floats:
             if (!child.is_positioned()) {
                 if (child.is_floating()) {
-                    child.paint(context, PaintPhase::Background);
-                    child.paint(context, PaintPhase::Border);
+                    if (!background_and_borders_are_outside_paint_rect(context, child)) {
+                        child.paint(context, PaintPhase::Background);
+                        child.paint(context, PaintPhase::Border);
+                    }
                     paint_descendants(context, child, StackingContextPaintPhase::BackgroundAndBorders);
                 }
                 paint_descendants(context, child, phase);
@@ -115,6 +130,8 @@ void StackingContext::paint(PaintContext& context)
             return;
         Gfx::Painter painter(*new_bitmap);
         PaintContext paint_context(painter, context.palette(), context.scroll_offset());
+        if (context.has_paint_rect())
+            paint_context.set_paint_rect(context.paint_rect());
         paint_internal(paint_context);
         context.painter().blit(Gfx::IntPoint(m_box.absolute_position()), *new_bitmap, Gfx::IntRect(m_box.absolute_rect()), opacity.value());
     } else {
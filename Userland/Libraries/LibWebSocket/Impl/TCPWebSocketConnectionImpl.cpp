@@ -34,6 +34,11 @@ void TCPWebSocketConnectionImpl::connect(ConnectionInfo const& connection)
     m_socket->on_connected = [this] {
         on_connected();
     };
+    m_socket->on_connection_failed = [this] {
+        deferred_invoke([this](auto&) {
+            on_connection_error();
+        });
+    };
     bool success = m_socket->connect(connection.url().host(), connection.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
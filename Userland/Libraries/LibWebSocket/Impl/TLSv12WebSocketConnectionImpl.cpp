@@ -42,6 +42,11 @@ void TLSv12WebSocketConnectionImpl::connect(ConnectionInfo const& connection)
     m_socket->on_tls_certificate_request = [](auto&) {
         // FIXME : Once we handle TLS certificate requests, handle it here as well.
     };
+    m_socket->on_connection_failed = [this] {
+        deferred_invoke([this](auto&) {
+            on_connection_error();
+        });
+    };
     bool success = m_socket->connect(connection.url().host(), connection.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
@@ -37,10 +37,14 @@ ClientConnection::ClientConnection(NonnullRefPtr<Core::LocalSocket> client_socke
 
 ClientConnection::~ClientConnection()
 {
+    if (m_stream)
+        m_stream->close();
 }
 
 void ClientConnection::die()
 {
+    if (m_stream)
+        m_stream->close();
     s_connections.remove(client_id());
 }
 
@@ -103,6 +107,8 @@ void ClientConnection::set_paused(bool paused)
 {
     if (m_queue)
         m_queue->set_paused(paused);
+    if (m_stream)
+        m_stream->set_paused(paused);
 }
 
 void ClientConnection::clear_buffer(bool paused)
@@ -111,6 +117,16 @@ void ClientConnection::clear_buffer(bool paused)
         m_queue->clear(paused);
 }
 
+Messages::AudioServer::CreateStreamResponse ClientConnection::create_stream()
+{
+    if (m_stream)
+        m_stream->close();
+    m_stream = m_mixer.create_stream();
+    if (!m_stream)
+        return { Optional<IPC::File> {}, Core::AnonymousBuffer {} };
+    return { IPC::File(m_stream->client_fd(), IPC::File::CloseAfterSending), m_stream->shared_buffer() };
+}
+
 Messages::AudioServer::GetPlayingBufferResponse ClientConnection::get_playing_buffer()
 {
     int id = -1;
@@ -19,6 +19,7 @@ namespace AudioServer {
 
 class BufferQueue;
 class Mixer;
+class SampleStream;
 
 class ClientConnection final : public IPC::ClientConnection<AudioClientEndpoint, AudioServerEndpoint> {
     C_OBJECT(ClientConnection)
@@ -42,12 +43,14 @@ private:
     virtual Messages::AudioServer::GetPlayedSamplesResponse get_played_samples() override;
     virtual void set_paused(bool) override;
     virtual void clear_buffer(bool) override;
+    virtual Messages::AudioServer::CreateStreamResponse create_stream() override;
     virtual Messages::AudioServer::GetPlayingBufferResponse get_playing_buffer() override;
     virtual Messages::AudioServer::GetMutedResponse get_muted() override;
     virtual void set_muted(bool) override;
 
     Mixer& m_mixer;
     RefPtr<BufferQueue> m_queue;
+    RefPtr<SampleStream> m_stream;
 };
 
 }
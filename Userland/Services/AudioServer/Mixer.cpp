@@ -4,19 +4,55 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/Array.h>
-#include <AK/MemoryStream.h>
+#include <AK/Endian.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
 #include <AudioServer/ClientConnection.h>
 #include <AudioServer/Mixer.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
-#include <strings.h>
+#include <string.h>
+#include <unistd.h>
 
 namespace AudioServer {
 
-u8 Mixer::m_zero_filled_buffer[4096];
+// Adds up both channels of a frame at once.
+static void add_frames(Span<Audio::Frame> mix, const Audio::Frame* frames)
+{
+    using AK::SIMD::f64x2;
+    static_assert(sizeof(Audio::Frame) == sizeof(f64x2));
+    for (size_t i = 0; i < mix.size(); ++i) {
+        f64x2 mixed_frame, frame;
+        memcpy(&mixed_frame, &mix[i], sizeof(f64x2));
+        memcpy(&frame, &frames[i], sizeof(f64x2));
+        mixed_frame += frame;
+        memcpy(static_cast<void*>(&mix[i]), &mixed_frame, sizeof(f64x2));
+    }
+}
+
+// Scales and clips the mix to what the device takes, both channels of a frame at once.
+static void convert_to_output(Span<const Audio::Frame> mix, int volume, LittleEndian<i16>* output)
+{
+    using AK::SIMD::f64x2;
+    constexpr double max_sample = NumericLimits<i16>::max();
+    double factor = volume / 100.0 * max_sample;
+    f64x2 scale = { factor, factor };
+    f64x2 upper_bound = { max_sample, max_sample };
+    f64x2 lower_bound = { -max_sample, -max_sample };
+    for (size_t i = 0; i < mix.size(); ++i) {
+        f64x2 frame;
+        memcpy(&frame, &mix[i], sizeof(f64x2));
+        frame *= scale;
+        frame = frame > upper_bound ? upper_bound : frame;
+        frame = frame < lower_bound ? lower_bound : frame;
+        auto samples = __builtin_convertvector(frame, AK::SIMD::i32x2);
+        output[2 * i] = samples[0];
+        output[2 * i + 1] = samples[1];
+    }
+}
 
-Mixer::Mixer()
+Mixer::Mixer(size_t period_in_frames)
     : m_device(Core::File::construct("/dev/audio", this))
     , m_sound_thread(Threading::Thread::construct(
           [this] {
@@ -24,15 +60,16 @@ Mixer::Mixer()
               return 0;
           },
           "AudioServer[mixer]"))
+    , m_period_in_frames(period_in_frames)
 {
+    pthread_mutex_init(&m_pending_mutex, nullptr);
+    pthread_cond_init(&m_pending_cond, nullptr);
+
     if (!m_device->open(Core::OpenMode::WriteOnly)) {
         dbgln("Can't open audio device: {}", m_device->error_string());
         return;
     }
 
-    pthread_mutex_init(&m_pending_mutex, nullptr);
-    pthread_cond_init(&m_pending_cond, nullptr);
-
     m_sound_thread->start();
 }
 
@@ -51,23 +88,59 @@ NonnullRefPtr<BufferQueue> Mixer::create_queue(ClientConnection& client)
     return queue;
 }
 
+RefPtr<SampleStream> Mixer::create_stream()
+{
+    // Leave room for a couple of periods, so that the client has a period's time to refill the stream
+    // while the mixer plays the other. Any more would just add latency.
+    size_t capacity_in_frames = 1;
+    while (capacity_in_frames < 2 * m_period_in_frames)
+        capacity_in_frames *= 2;
+    auto stream = SampleStream::create(capacity_in_frames);
+    if (!stream)
+        return {};
+    pthread_mutex_lock(&m_pending_mutex);
+    m_pending_streams.append(*stream);
+    m_added_queue = true;
+    pthread_cond_signal(&m_pending_cond);
+    pthread_mutex_unlock(&m_pending_mutex);
+    return stream;
+}
+
+void Mixer::take_pending(Vector<NonnullRefPtr<BufferQueue>>& queues, Vector<NonnullRefPtr<SampleStream>>& streams)
+{
+    queues.extend(move(m_pending_mixing));
+    streams.extend(move(m_pending_streams));
+    m_added_queue = false;
+}
+
 void Mixer::mix()
 {
     decltype(m_pending_mixing) active_mix_queues;
+    decltype(m_pending_streams) active_streams;
+    Vector<Audio::Frame> mixed_buffer;
+    mixed_buffer.resize(m_period_in_frames);
+    Vector<LittleEndian<i16>> output_buffer;
+    output_buffer.resize(2 * m_period_in_frames);
 
     for (;;) {
-        if (active_mix_queues.is_empty() || m_added_queue) {
+        if (active_mix_queues.is_empty() && active_streams.is_empty()) {
             pthread_mutex_lock(&m_pending_mutex);
-            pthread_cond_wait(&m_pending_cond, &m_pending_mutex);
-            active_mix_queues.extend(move(m_pending_mixing));
+            while (!m_added_queue)
+                pthread_cond_wait(&m_pending_cond, &m_pending_mutex);
+            take_pending(active_mix_queues, active_streams);
             pthread_mutex_unlock(&m_pending_mutex);
-            m_added_queue = false;
+        } else if (m_added_queue) {
+            // Never wait for the IPC thread while something is playing, the newcomer can join in with the next period.
+            if (pthread_mutex_trylock(&m_pending_mutex) == 0) {
+                take_pending(active_mix_queues, active_streams);
+                pthread_mutex_unlock(&m_pending_mutex);
+            }
         }
 
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->client(); });
+        active_streams.remove_all_matching([&](auto& stream) { return stream->is_closed(); });
 
-        Audio::Frame mixed_buffer[1024];
-        auto mixed_buffer_length = (int)(sizeof(mixed_buffer) / sizeof(Audio::Frame));
+        mixed_buffer.span().fill({});
 
         // Mix the buffers together into the output
         for (auto& queue : active_mix_queues) {
@@ -76,8 +149,7 @@ void Mixer::mix()
                 continue;
             }
 
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
+            for (auto& mixed_sample : mixed_buffer) {
                 Audio::Frame sample;
                 if (!queue->get_next_sample(sample))
                     break;
@@ -85,30 +157,11 @@ void Mixer::mix()
             }
         }
 
-        if (m_muted) {
-            m_device->write(m_zero_filled_buffer, sizeof(m_zero_filled_buffer));
-        } else {
-            Array<u8, 4096> buffer;
-            OutputMemoryStream stream { buffer };
-
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
+        for (auto& stream : active_streams)
+            stream->mix_into(mixed_buffer.span());
 
-                mixed_sample.scale(m_main_volume);
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = mixed_sample.left * NumericLimits<i16>::max();
-                stream << out_sample;
-
-                out_sample = mixed_sample.right * NumericLimits<i16>::max();
-                stream << out_sample;
-            }
-
-            VERIFY(stream.is_end());
-            VERIFY(!stream.has_any_error());
-            m_device->write(stream.data(), stream.size());
-        }
+        convert_to_output(mixed_buffer.span(), m_muted ? 0 : m_main_volume.load(), output_buffer.data());
+        m_device->write(reinterpret_cast<const u8*>(output_buffer.data()), output_buffer.size() * sizeof(i16));
     }
 }
 
@@ -127,9 +180,8 @@ void Mixer::set_main_volume(int volume)
 
 void Mixer::set_muted(bool muted)
 {
-    if (m_muted == muted)
+    if (m_muted.exchange(muted) == muted)
         return;
-    m_muted = muted;
     ClientConnection::for_each([muted](ClientConnection& client) {
         client.did_change_muted_state({}, muted);
     });
@@ -145,4 +197,58 @@ void BufferQueue::enqueue(NonnullRefPtr<Audio::Buffer>&& buffer)
     m_remaining_samples += buffer->sample_count();
     m_queue.enqueue(move(buffer));
 }
+
+RefPtr<SampleStream> SampleStream::create(size_t capacity_in_frames)
+{
+    auto ring_buffer = Core::SharedRingBuffer::create(capacity_in_frames * sizeof(Audio::Frame));
+    if (!ring_buffer.has_value()) {
+        dbgln("SampleStream: Failed to create ring buffer");
+        return {};
+    }
+    int fd_pair[2] { 0 };
+    if (pipe(fd_pair) != 0) {
+        dbgln("SampleStream: pipe() failed: {}", strerror(errno));
+        return {};
+    }
+    // The mixer thread mustn't block, and a full pipe already has the client's attention.
+    fcntl(fd_pair[1], F_SETFL, fcntl(fd_pair[1], F_GETFL) | O_NONBLOCK);
+    return adopt_ref(*new SampleStream(ring_buffer.release_value(), fd_pair[0], fd_pair[1]));
+}
+
+SampleStream::SampleStream(Core::SharedRingBuffer ring_buffer, int client_fd, int wakeup_fd)
+    : m_ring_buffer(move(ring_buffer))
+    , m_client_fd(client_fd)
+    , m_wakeup_fd(wakeup_fd)
+{
+}
+
+SampleStream::~SampleStream()
+{
+    ::close(m_wakeup_fd);
+}
+
+void SampleStream::mix_into(Span<Audio::Frame> mix)
+{
+    if (m_paused.load(AK::MemoryOrder::memory_order_relaxed))
+        return;
+
+    size_t mixed_count = 0;
+    while (mixed_count < mix.size()) {
+        // Clients only ever write whole frames, and the capacity is a multiple of the frame size,
+        // so no frame is split across the end of the buffer.
+        auto bytes = m_ring_buffer.peek();
+        size_t count = min(bytes.size() / sizeof(Audio::Frame), mix.size() - mixed_count);
+        if (count == 0)
+            break;
+        add_frames(mix.slice(mixed_count, count), reinterpret_cast<const Audio::Frame*>(bytes.data()));
+        m_ring_buffer.consume(count * sizeof(Audio::Frame));
+        mixed_count += count;
+    }
+
+    if (mixed_count > 0 && m_ring_buffer.should_wake_writer()) {
+        u8 wakeup = 0;
+        [[maybe_unused]] auto rc = ::write(m_wakeup_fd, &wakeup, sizeof(wakeup));
+    }
+}
+
 }
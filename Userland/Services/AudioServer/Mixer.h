@@ -16,6 +16,7 @@
 #include <AK/WeakPtr.h>
 #include <LibAudio/Buffer.h>
 #include <LibCore/File.h>
+#include <LibCore/SharedRingBuffer.h>
 #include <LibThreading/Mutex.h>
 #include <LibThreading/Thread.h>
 
@@ -90,13 +91,45 @@ private:
     WeakPtr<ClientConnection> m_client;
 };
 
+// Samples that a client writes straight into shared memory, from where the mixer picks them up every period.
+// Only the ring buffer is shared between the client and the mixer thread, so neither of them ever waits for the
+// other, and there's no IPC message per buffer. The client waits for room on a pipe, which the mixer pokes.
+class SampleStream : public RefCounted<SampleStream> {
+public:
+    static RefPtr<SampleStream> create(size_t capacity_in_frames);
+    ~SampleStream();
+
+    // Both of these are meant to be sent to the client.
+    int client_fd() const { return m_client_fd; }
+    const Core::AnonymousBuffer& shared_buffer() const { return m_ring_buffer.anonymous_buffer(); }
+
+    void set_paused(bool paused) { m_paused.store(paused, AK::MemoryOrder::memory_order_relaxed); }
+    void close() { m_closed.store(true, AK::MemoryOrder::memory_order_relaxed); }
+    bool is_closed() const { return m_closed.load(AK::MemoryOrder::memory_order_relaxed); }
+
+    // Adds as many frames as the client has written (up to the size of the mix) into the mix.
+    void mix_into(Span<Audio::Frame> mix);
+
+private:
+    SampleStream(Core::SharedRingBuffer, int client_fd, int wakeup_fd);
+
+    Core::SharedRingBuffer m_ring_buffer;
+    int m_client_fd { -1 };
+    int m_wakeup_fd { -1 };
+    Atomic<bool> m_paused { false };
+    Atomic<bool> m_closed { false };
+};
+
 class Mixer : public Core::Object {
     C_OBJECT(Mixer)
 public:
-    Mixer();
+    static constexpr size_t DefaultPeriodInFrames = 1024;
+
+    explicit Mixer(size_t period_in_frames = DefaultPeriodInFrames);
     virtual ~Mixer() override;
 
     NonnullRefPtr<BufferQueue> create_queue(ClientConnection&);
+    RefPtr<SampleStream> create_stream();
 
     int main_volume() const { return m_main_volume; }
     void set_main_volume(int volume);
@@ -105,7 +138,10 @@ public:
     void set_muted(bool);
 
 private:
+    void take_pending(Vector<NonnullRefPtr<BufferQueue>>& queues, Vector<NonnullRefPtr<SampleStream>>& streams);
+
     Vector<NonnullRefPtr<BufferQueue>> m_pending_mixing;
+    Vector<NonnullRefPtr<SampleStream>> m_pending_streams;
     Atomic<bool> m_added_queue { false };
     pthread_mutex_t m_pending_mutex;
     pthread_cond_t m_pending_cond;
@@ -114,10 +150,9 @@ private:
 
     NonnullRefPtr<Threading::Thread> m_sound_thread;
 
-    bool m_muted { false };
-    int m_main_volume { 100 };
-
-    static u8 m_zero_filled_buffer[4096];
+    size_t m_period_in_frames { DefaultPeriodInFrames };
+    Atomic<bool> m_muted { false };
+    Atomic<int> m_main_volume { 100 };
 
     void mix();
 };
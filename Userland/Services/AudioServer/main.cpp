@@ -5,18 +5,29 @@
  */
 
 #include "Mixer.h"
+#include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
-    if (pledge("stdio recvfd thread accept cpath rpath wpath unix", nullptr) < 0) {
+    if (pledge("stdio recvfd sendfd thread accept cpath rpath wpath unix", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
 
+    // Smaller periods mean less latency, but each one costs a wakeup of the mixer thread.
+    int period_in_frames = AudioServer::Mixer::DefaultPeriodInFrames;
+    Core::ArgsParser args_parser;
+    args_parser.add_option(period_in_frames, "Number of frames to mix at a time", "period", 'p', "frames");
+    args_parser.parse(argc, argv);
+    if (period_in_frames < 64 || period_in_frames > 16384) {
+        warnln("The period has to be between 64 and 16384 frames");
+        return 1;
+    }
+
     Core::EventLoop event_loop;
-    AudioServer::Mixer mixer;
+    AudioServer::Mixer mixer(period_in_frames);
 
     auto server = Core::LocalServer::construct();
     bool ok = server->take_over_from_system_server();
@@ -32,7 +43,7 @@ int main(int, char**)
         IPC::new_client_connection<AudioServer::ClientConnection>(client_socket.release_nonnull(), client_id, mixer);
     };
 
-    if (pledge("stdio recvfd thread accept", nullptr) < 0) {
+    if (pledge("stdio recvfd sendfd thread accept", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -9,6 +9,7 @@
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <LibCompress/Gzip.h>
 #include <LibCore/File.h>
+#include <LibCore/FileStream.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCoreDump/Backtrace.h>
 #include <LibCoreDump/Reader.h>
@@ -41,19 +42,21 @@ static bool compress_coredump(const String& coredump_path)
         return false;
     }
     auto coredump_file = file_or_error.value();
-    auto compressed_coredump = Compress::GzipCompressor::compress_all(coredump_file->bytes());
-    if (!compressed_coredump.has_value()) {
-        dbgln("Could not compress coredump '{}'", coredump_path);
+    auto output_path = String::formatted("{}.gz", coredump_path);
+    auto output_stream_or_error = Core::OutputFileStream::open_buffered(output_path);
+    if (output_stream_or_error.is_error()) {
+        dbgln("Could not open '{}' for writing: {}", output_path, output_stream_or_error.error());
         return false;
     }
-    auto output_path = String::formatted("{}.gz", coredump_path);
-    auto output_file_or_error = Core::File::open(output_path, Core::OpenMode::WriteOnly);
-    if (output_file_or_error.is_error()) {
-        dbgln("Could not open '{}' for writing: {}", output_path, output_file_or_error.error());
+    // Compress straight into the file, rather than holding all of the compressed coredump in memory first.
+    auto& output_stream = output_stream_or_error.value();
+    Compress::GzipCompressor compressor { output_stream };
+    if (!compressor.write_or_error(coredump_file->bytes())) {
+        dbgln("Could not compress coredump '{}'", coredump_path);
         return false;
     }
-    auto output_file = output_file_or_error.value();
-    if (!output_file->write(compressed_coredump.value().data(), compressed_coredump.value().size())) {
+    output_stream.flush();
+    if (output_stream.handle_any_error()) {
         dbgln("Could not write compressed coredump '{}'", output_path);
         return false;
     }
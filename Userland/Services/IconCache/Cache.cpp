@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/LexicalPath.h>
+#include <IconCache/Cache.h>
+
+namespace IconCache {
+
+Cache& Cache::the()
+{
+    static Cache s_the;
+    return s_the;
+}
+
+RefPtr<Gfx::Bitmap> Cache::load(String const& path)
+{
+    if (!path.starts_with("/res/icons/") || LexicalPath::canonicalized_path(path) != path)
+        return nullptr;
+    auto bitmap = Gfx::Bitmap::try_load_from_file(path);
+    if (!bitmap)
+        return nullptr;
+    return bitmap->to_bitmap_backed_by_anonymous_buffer();
+}
+
+RefPtr<Gfx::Bitmap> Cache::icon(String const& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        auto bitmap = load(path);
+        m_entries.set(path, { bitmap, 0 });
+        return bitmap;
+    }
+
+    auto& entry = it->value;
+    if (entry.bitmap && entry.bitmap->is_volatile()) {
+        bool was_purged = false;
+        if (!entry.bitmap->set_nonvolatile(was_purged) || was_purged) {
+            dbgln_if(ICON_CACHE_DEBUG, "IconCache: {} was purged, decoding it again", path);
+            entry.bitmap = load(path);
+        }
+    }
+    return entry.bitmap;
+}
+
+void Cache::add_user(String const& path)
+{
+    auto it = m_entries.find(path);
+    VERIFY(it != m_entries.end());
+    ++it->value.user_count;
+}
+
+void Cache::remove_user(String const& path)
+{
+    auto it = m_entries.find(path);
+    VERIFY(it != m_entries.end());
+    auto& entry = it->value;
+    VERIFY(entry.user_count > 0);
+    if (--entry.user_count == 0 && entry.bitmap)
+        entry.bitmap->set_volatile();
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <LibGfx/Bitmap.h>
+
+namespace IconCache {
+
+// Every icon that has been asked for, decoded once into a buffer that can be shared with all clients. An icon that no
+// connected client has asked for is left volatile, so the kernel can take its memory back when it runs low.
+class Cache {
+public:
+    static Cache& the();
+
+    // Null if the icon doesn't exist, or isn't in /res/icons.
+    RefPtr<Gfx::Bitmap> icon(String const& path);
+
+    // Clients keep what they've been given for as long as they're around, so they count as users until they disconnect.
+    void add_user(String const& path);
+    void remove_user(String const& path);
+
+private:
+    Cache() = default;
+
+    struct Entry {
+        RefPtr<Gfx::Bitmap> bitmap;
+        size_t user_count { 0 };
+    };
+
+    static RefPtr<Gfx::Bitmap> load(String const& path);
+
+    HashMap<String, Entry> m_entries;
+};
+
+}
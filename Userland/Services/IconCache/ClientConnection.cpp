@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <IconCache/Cache.h>
+#include <IconCache/ClientConnection.h>
+
+namespace IconCache {
+
+static HashMap<int, RefPtr<ClientConnection>> s_connections;
+
+ClientConnection::ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id)
+    : IPC::ClientConnection<IconCacheClientEndpoint, IconCacheServerEndpoint>(*this, move(socket), client_id)
+{
+    s_connections.set(client_id, *this);
+}
+
+ClientConnection::~ClientConnection()
+{
+}
+
+void ClientConnection::die()
+{
+    for (auto& path : m_icons)
+        Cache::the().remove_user(path);
+    m_icons.clear();
+    s_connections.remove(client_id());
+}
+
+Messages::IconCacheServer::GetIconResponse ClientConnection::get_icon(String const& path)
+{
+    auto bitmap = Cache::the().icon(path);
+    if (!bitmap)
+        return Gfx::ShareableBitmap {};
+    if (m_icons.set(path) == AK::HashSetResult::InsertedNewEntry)
+        Cache::the().add_user(path);
+    return bitmap->to_shareable_bitmap();
+}
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <IconCache/IconCacheClientEndpoint.h>
+#include <IconCache/IconCacheServerEndpoint.h>
+#include <LibIPC/ClientConnection.h>
+
+namespace IconCache {
+
+class ClientConnection final
+    : public IPC::ClientConnection<IconCacheClientEndpoint, IconCacheServerEndpoint> {
+    C_OBJECT(ClientConnection);
+
+public:
+    explicit ClientConnection(NonnullRefPtr<Core::LocalSocket>, int client_id);
+    virtual ~ClientConnection() override;
+
+    virtual void die() override;
+
+private:
+    virtual Messages::IconCacheServer::GetIconResponse get_icon(String const&) override;
+
+    HashTable<String> m_icons;
+};
+
+}
@@ -9,6 +9,7 @@
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageDecoder.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace ImageDecoder {
 
@@ -30,37 +31,72 @@ void ClientConnection::die()
     exit(0);
 }
 
-Messages::ImageDecoderServer::DecodeImageResponse ClientConnection::decode_image(Core::AnonymousBuffer const& encoded_buffer)
-{
-    if (!encoded_buffer.is_valid()) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
-        return nullptr;
-    }
+struct DecodedImage {
+    bool success { false };
+    bool is_animated { false };
+    u32 loop_count { 0 };
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    Vector<u32> durations;
+};
 
+static DecodedImage decode(Core::AnonymousBuffer const& encoded_buffer)
+{
     auto decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() });
 
     if (!decoder) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return {};
     }
 
     if (!decoder->frame_count()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return {};
     }
 
-    Vector<Gfx::ShareableBitmap> bitmaps;
-    Vector<u32> durations;
+    DecodedImage image;
+    image.success = true;
+    image.is_animated = decoder->is_animated();
+    image.loop_count = decoder->loop_count();
     for (size_t i = 0; i < decoder->frame_count(); ++i) {
         auto frame = decoder->frame(i);
         if (frame.image)
-            bitmaps.append(frame.image->to_shareable_bitmap());
+            image.bitmaps.append(frame.image->to_shareable_bitmap());
         else
-            bitmaps.append(Gfx::ShareableBitmap {});
-        durations.append(frame.duration);
+            image.bitmaps.append(Gfx::ShareableBitmap {});
+        image.durations.append(frame.duration);
+    }
+    return image;
+}
+
+Messages::ImageDecoderServer::DecodeImageResponse ClientConnection::decode_image(Core::AnonymousBuffer const& encoded_buffer)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        return nullptr;
+    }
+
+    auto image = decode(encoded_buffer);
+    if (!image.success)
+        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+    return { image.is_animated, image.loop_count, move(image.bitmaps), move(image.durations) };
+}
+
+void ClientConnection::decode_image_async(i32 request_id, Core::AnonymousBuffer const& encoded_buffer)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        async_did_decode_image(request_id, false, false, 0, {}, {});
+        return;
     }
 
-    return { decoder->is_animated(), static_cast<u32>(decoder->loop_count()), bitmaps, durations };
+    // Every request gets decoded on its own worker, and the replies go out in whatever order they finish in.
+    Threading::ThreadPool::the().submit<DecodedImage>(
+        [encoded_buffer] {
+            return decode(encoded_buffer);
+        },
+        [this, protector = NonnullRefPtr(*this), request_id](DecodedImage image) {
+            async_did_decode_image(request_id, image.success, image.is_animated, image.loop_count, image.bitmaps, image.durations);
+        });
 }
 
 }
@@ -27,6 +27,7 @@ public:
 
 private:
     virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&) override;
+    virtual void decode_image_async(i32 request_id, Core::AnonymousBuffer const&) override;
 };
 
 }
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <IndexServer/ClientConnection.h>
+#include <IndexServer/FileIndex.h>
+
+namespace IndexServer {
+
+static HashMap<int, RefPtr<ClientConnection>> s_connections;
+
+// Nobody needs more results than fit on a screen or two, and they all have to go through one message.
+static constexpr u32 max_results_per_search = 1000;
+
+ClientConnection::ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id, FileIndex& index)
+    : IPC::ClientConnection<IndexClientEndpoint, IndexServerEndpoint>(*this, move(socket), client_id)
+    , m_index(index)
+{
+    s_connections.set(client_id, *this);
+}
+
+ClientConnection::~ClientConnection()
+{
+}
+
+void ClientConnection::die()
+{
+    s_connections.remove(client_id());
+}
+
+Messages::IndexServer::SearchResponse ClientConnection::search(String const& query, String const& directory, u32 max_results)
+{
+    return m_index.search(query, directory, min(max_results, max_results_per_search));
+}
+
+}
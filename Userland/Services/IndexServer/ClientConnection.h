@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <IndexServer/IndexClientEndpoint.h>
+#include <IndexServer/IndexServerEndpoint.h>
+#include <LibIPC/ClientConnection.h>
+
+namespace IndexServer {
+
+class FileIndex;
+
+class ClientConnection final : public IPC::ClientConnection<IndexClientEndpoint, IndexServerEndpoint> {
+    C_OBJECT(ClientConnection);
+
+public:
+    ~ClientConnection() override;
+
+    virtual void die() override;
+
+private:
+    explicit ClientConnection(NonnullRefPtr<Core::LocalSocket>, int client_id, FileIndex&);
+
+    virtual Messages::IndexServer::SearchResponse search(String const&, String const&, u32) override;
+
+    FileIndex& m_index;
+};
+
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "FileIndex.h"
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <AK/LexicalPath.h>
+#include <AK/MappedFile.h>
+#include <AK/MemoryStream.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DirIterator.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace IndexServer {
+
+static constexpr u32 index_file_magic = 0x58444946; // "FIDX"
+static constexpr u32 index_file_version = 1;
+static constexpr size_t directories_per_scan_batch = 32;
+static constexpr int save_delay_ms = 10000;
+
+FileIndex::FileIndex(String index_path)
+    : m_index_path(move(index_path))
+{
+    auto watcher_or_error = Core::FileWatcher::create();
+    if (watcher_or_error.is_error()) {
+        dbgln("FileIndex: Can't watch the file system, the index will go stale: {}", watcher_or_error.error());
+    } else {
+        m_watcher = watcher_or_error.release_value();
+        m_watcher->on_change = [this](auto& event) {
+            did_change_file_system(event);
+        };
+    }
+
+    m_save_timer = Core::Timer::create_single_shot(save_delay_ms, [this] { save(); }, this);
+
+    if (!load()) {
+        m_entries.clear();
+        m_entries_by_trigram.clear();
+        m_entries.append({ {}, invalid_id, true, false, 0, {} });
+    }
+    // Whatever was loaded may be out of date, but it's good enough to answer queries until the scan has caught up.
+    enqueue_scan(root_id);
+}
+
+FileIndex::~FileIndex()
+{
+}
+
+u32 FileIndex::trigram_at(StringView name, size_t index)
+{
+    return (to_ascii_lowercase(name[index]) << 16) | (to_ascii_lowercase(name[index + 1]) << 8) | to_ascii_lowercase(name[index + 2]);
+}
+
+void FileIndex::index_name(EntryID id)
+{
+    auto& name = m_entries[id].name;
+    for (size_t i = 0; i + 3 <= name.length(); ++i) {
+        auto& entries = m_entries_by_trigram.ensure(trigram_at(name, i));
+        if (entries.is_empty() || entries.last() != id)
+            entries.append(id);
+    }
+}
+
+FileIndex::EntryID FileIndex::add_entry(EntryID parent, String name, bool is_directory, time_t modified_time)
+{
+    EntryID id = m_entries.size();
+    m_entries.append({ move(name), parent, is_directory, false, modified_time, {} });
+    m_entries[parent].children.append(id);
+    index_name(id);
+    return id;
+}
+
+void FileIndex::remove_entry(EntryID id)
+{
+    VERIFY(id != root_id);
+    m_entries[m_entries[id].parent].children.remove_first_matching([&](auto child) { return child == id; });
+
+    // The trigram table still refers to removed entries until the next compact(), so they're only marked as deleted.
+    Vector<EntryID> entries_to_remove { id };
+    while (!entries_to_remove.is_empty()) {
+        auto removed_id = entries_to_remove.take_last();
+        auto& entry = m_entries[removed_id];
+        if (entry.is_directory && m_watcher)
+            (void)m_watcher->remove_watch(path_of(removed_id));
+        entry.is_deleted = true;
+        ++m_deleted_entry_count;
+        entries_to_remove.extend(move(entry.children));
+    }
+}
+
+Optional<FileIndex::EntryID> FileIndex::find_child(EntryID parent, StringView name) const
+{
+    for (auto child : m_entries[parent].children) {
+        if (m_entries[child].name == name)
+            return child;
+    }
+    return {};
+}
+
+Optional<FileIndex::EntryID> FileIndex::find_entry(StringView path) const
+{
+    EntryID id = root_id;
+    for (auto& name : path.split_view('/')) {
+        auto child = find_child(id, name);
+        if (!child.has_value())
+            return {};
+        id = child.value();
+    }
+    return id;
+}
+
+String FileIndex::path_of(EntryID id) const
+{
+    if (id == root_id)
+        return "/";
+    Vector<StringView, 16> names;
+    for (; id != root_id; id = m_entries[id].parent)
+        names.append(m_entries[id].name);
+    StringBuilder builder;
+    for (size_t i = names.size(); i > 0; --i) {
+        builder.append('/');
+        builder.append(names[i - 1]);
+    }
+    return builder.to_string();
+}
+
+bool FileIndex::is_below(EntryID id, EntryID ancestor) const
+{
+    for (; id != root_id; id = m_entries[id].parent) {
+        if (m_entries[id].parent == ancestor)
+            return true;
+    }
+    return false;
+}
+
+Vector<String> FileIndex::search(StringView query, StringView directory, size_t max_results) const
+{
+    Vector<String> results;
+    if (query.is_empty() || max_results == 0)
+        return results;
+
+    Optional<EntryID> directory_id;
+    if (!directory.is_empty()) {
+        directory_id = find_entry(LexicalPath::canonicalized_path(directory));
+        if (!directory_id.has_value())
+            return results;
+    }
+
+    auto try_add = [&](EntryID id) {
+        auto& entry = m_entries[id];
+        if (entry.is_deleted || !entry.name.contains(query, CaseSensitivity::CaseInsensitive))
+            return;
+        if (directory_id.has_value() && !is_below(id, directory_id.value()))
+            return;
+        results.append(path_of(id));
+    };
+
+    // Queries that are too short to have a trigram are rare enough to just look at every name.
+    if (query.length() < 3) {
+        for (EntryID id = root_id + 1; id < m_entries.size() && results.size() < max_results; ++id)
+            try_add(id);
+        return results;
+    }
+
+    Vector<EntryID> const* candidates = nullptr;
+    for (size_t i = 0; i + 3 <= query.length(); ++i) {
+        auto it = m_entries_by_trigram.find(trigram_at(query, i));
+        if (it == m_entries_by_trigram.end())
+            return results;
+        if (!candidates || it->value.size() < candidates->size())
+            candidates = &it->value;
+    }
+    for (size_t i = 0; i < candidates->size() && results.size() < max_results; ++i)
+        try_add(candidates->at(i));
+    return results;
+}
+
+void FileIndex::enqueue_scan(EntryID id)
+{
+    m_directories_to_scan.enqueue(id);
+    if (m_scan_is_scheduled)
+        return;
+    m_scan_is_scheduled = true;
+    deferred_invoke([this](auto&) {
+        scan_next_directories();
+    });
+}
+
+void FileIndex::scan_next_directories()
+{
+    // Only a few directories at a time, so that queries don't have to wait for the whole file system to be read.
+    m_scan_is_scheduled = false;
+    for (size_t i = 0; i < directories_per_scan_batch && !m_directories_to_scan.is_empty(); ++i) {
+        auto id = m_directories_to_scan.dequeue();
+        if (!m_entries[id].is_deleted)
+            scan_directory(id);
+    }
+
+    if (!m_directories_to_scan.is_empty()) {
+        m_scan_is_scheduled = true;
+        deferred_invoke([this](auto&) {
+            scan_next_directories();
+        });
+        return;
+    }
+    dbgln_if(FILE_INDEX_DEBUG, "FileIndex: Scan finished with {} entries", m_entries.size() - m_deleted_entry_count);
+    if (m_deleted_entry_count > m_entries.size() / 2)
+        compact();
+}
+
+void FileIndex::scan_directory(EntryID id)
+{
+    auto path = path_of(id);
+    if (path.is_one_of("/dev"sv, "/proc"sv, "/sys"sv))
+        return;
+
+    struct stat st;
+    if (lstat(path.characters(), &st) < 0 || !S_ISDIR(st.st_mode)) {
+        if (id != root_id) {
+            remove_entry(id);
+            did_modify_index();
+        }
+        return;
+    }
+
+    // Start watching before reading the directory, so that nothing that changes in between goes unnoticed.
+    if (m_watcher && !m_watcher->is_watching(path)) {
+        auto result = m_watcher->add_watch(path, Core::FileWatcherEvent::Type::ChildCreated | Core::FileWatcherEvent::Type::ChildDeleted);
+        if (result.is_error())
+            dbgln("FileIndex: {}", result.error());
+    }
+
+    // A directory that looks the same as when it was indexed still has the same children, but theirs may have changed.
+    if (m_entries[id].modified_time == st.st_mtime) {
+        for (auto child : m_entries[id].children) {
+            if (m_entries[child].is_directory)
+                m_directories_to_scan.enqueue(child);
+        }
+        return;
+    }
+
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    if (iterator.has_error())
+        return;
+
+    HashMap<String, EntryID> previous_children;
+    for (auto child : m_entries[id].children)
+        previous_children.set(m_entries[child].name, child);
+
+    while (iterator.has_next()) {
+        auto name = iterator.next_path();
+        struct stat child_st;
+        if (fstatat(iterator.fd(), name.characters(), &child_st, AT_SYMLINK_NOFOLLOW) < 0)
+            continue;
+        bool is_directory = S_ISDIR(child_st.st_mode);
+
+        auto previous_child = previous_children.get(name);
+        previous_children.remove(name);
+        if (previous_child.has_value() && m_entries[previous_child.value()].is_directory != is_directory) {
+            remove_entry(previous_child.value());
+            previous_child = {};
+        }
+        auto child = previous_child.has_value() ? previous_child.value() : add_entry(id, move(name), is_directory, 0);
+        if (is_directory)
+            m_directories_to_scan.enqueue(child);
+    }
+    for (auto& it : previous_children)
+        remove_entry(it.value);
+
+    m_entries[id].modified_time = st.st_mtime;
+    did_modify_index();
+}
+
+void FileIndex::did_change_file_system(Core::FileWatcherEvent const& event)
+{
+    LexicalPath path(event.event_path);
+    auto parent = find_entry(path.dirname());
+    if (!parent.has_value())
+        return;
+
+    auto child = find_child(parent.value(), path.basename());
+    if (has_flag(event.type, Core::FileWatcherEvent::Type::ChildCreated)) {
+        struct stat st;
+        if (child.has_value() || lstat(event.event_path.characters(), &st) < 0)
+            return;
+        auto id = add_entry(parent.value(), path.basename(), S_ISDIR(st.st_mode), 0);
+        if (m_entries[id].is_directory)
+            enqueue_scan(id);
+    } else if (has_flag(event.type, Core::FileWatcherEvent::Type::ChildDeleted)) {
+        if (!child.has_value())
+            return;
+        remove_entry(child.value());
+    }
+    did_modify_index();
+}
+
+void FileIndex::did_modify_index()
+{
+    m_save_timer->restart();
+}
+
+void FileIndex::compact()
+{
+    // Parents always come before their children, so the new IDs of the parents are known by the time they're needed.
+    Vector<EntryID> new_ids;
+    new_ids.resize(m_entries.size());
+    Vector<Entry> entries;
+    entries.ensure_capacity(m_entries.size() - m_deleted_entry_count);
+    for (EntryID id = 0; id < m_entries.size(); ++id) {
+        auto& entry = m_entries[id];
+        if (entry.is_deleted)
+            continue;
+        new_ids[id] = entries.size();
+        entries.append({ move(entry.name), id == root_id ? invalid_id : new_ids[entry.parent], entry.is_directory, false, entry.modified_time, {} });
+        if (id != root_id)
+            entries[new_ids[entry.parent]].children.append(new_ids[id]);
+    }
+
+    m_entries = move(entries);
+    m_deleted_entry_count = 0;
+    m_entries_by_trigram.clear();
+    for (EntryID id = root_id + 1; id < m_entries.size(); ++id)
+        index_name(id);
+}
+
+// The index file is a header of magic, version and entry count, followed by the entries in order of their ID. Each one is
+// the ID of its parent, whether it is a directory, its modification time and the length of its name, followed by the name.
+bool FileIndex::load()
+{
+    auto file_or_error = MappedFile::map(m_index_path);
+    if (file_or_error.is_error())
+        return false;
+    auto file = file_or_error.release_value();
+    InputMemoryStream stream { file->bytes() };
+
+    u32 magic = 0;
+    u32 version = 0;
+    u32 entry_count = 0;
+    stream >> magic >> version >> entry_count;
+    if (stream.handle_any_error() || magic != index_file_magic || version != index_file_version || entry_count == 0)
+        return false;
+
+    m_entries.ensure_capacity(entry_count);
+    for (u32 id = 0; id < entry_count; ++id) {
+        u32 parent = 0;
+        u8 is_directory = 0;
+        i64 modified_time = 0;
+        u32 name_length = 0;
+        stream >> parent >> is_directory >> modified_time >> name_length;
+        if (stream.handle_any_error() || name_length > stream.remaining())
+            return false;
+        String name { reinterpret_cast<char const*>(file->bytes().offset_pointer(stream.offset())), name_length };
+        stream.discard_or_error(name_length);
+
+        if (id == root_id) {
+            m_entries.append({ {}, invalid_id, true, false, static_cast<time_t>(modified_time), {} });
+            continue;
+        }
+        if (parent >= id || !m_entries[parent].is_directory || name.is_empty())
+            return false;
+        add_entry(parent, move(name), is_directory, modified_time);
+    }
+    dbgln_if(FILE_INDEX_DEBUG, "FileIndex: Loaded {} entries from {}", m_entries.size(), m_index_path);
+    return true;
+}
+
+void FileIndex::save()
+{
+    if (m_deleted_entry_count > 0 && m_directories_to_scan.is_empty())
+        compact();
+
+    DuplexMemoryStream stream;
+    // Entries that are still waiting to be removed in compact() are left out, so the IDs in the file are different.
+    Vector<EntryID> new_ids;
+    new_ids.resize(m_entries.size());
+    u32 entry_count = 0;
+    for (auto& entry : m_entries) {
+        if (!entry.is_deleted)
+            ++entry_count;
+    }
+    stream << index_file_magic << index_file_version << entry_count;
+    for (EntryID id = 0, new_id = 0; id < m_entries.size(); ++id) {
+        auto& entry = m_entries[id];
+        if (entry.is_deleted)
+            continue;
+        new_ids[id] = new_id++;
+        u32 parent = id == root_id ? invalid_id : new_ids[entry.parent];
+        stream << parent << static_cast<u8>(entry.is_directory) << static_cast<i64>(entry.modified_time) << static_cast<u32>(entry.name.length());
+        stream << entry.name.bytes();
+    }
+    auto data = stream.copy_into_contiguous_buffer();
+
+    // Never leave a partially written index behind.
+    auto temporary_path = String::formatted("{}.new", m_index_path);
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dbgln("FileIndex: Failed to create {}: {}", temporary_path, strerror(errno));
+        return;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        auto rc = write(fd, data.data() + written, data.size() - written);
+        if (rc <= 0)
+            break;
+        written += rc;
+    }
+    close(fd);
+    if (written < data.size() || rename(temporary_path.characters(), m_index_path.characters()) < 0) {
+        dbgln("FileIndex: Failed to write {}: {}", m_index_path, strerror(errno));
+        unlink(temporary_path.characters());
+        return;
+    }
+    dbgln_if(FILE_INDEX_DEBUG, "FileIndex: Saved {} entries to {}", entry_count, m_index_path);
+}
+
+}
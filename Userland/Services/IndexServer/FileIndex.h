@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Queue.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/FileWatcher.h>
+#include <LibCore/Object.h>
+#include <LibCore/Timer.h>
+
+namespace IndexServer {
+
+// The names of all files in the file system, kept up to date by watching every directory for children coming and going.
+// A name is found through the trigrams (runs of three characters) in it, so a lookup only has to look at names that
+// contain the rarest trigram of the query. The index is saved to disk, so that it can answer lookups right away
+// after a restart, while the file system is checked for what changed in the meantime.
+class FileIndex final : public Core::Object {
+    C_OBJECT(FileIndex);
+
+public:
+    virtual ~FileIndex() override;
+
+    // The paths of up to `max_results` files whose name contains `query`, ignoring case. When `directory` isn't empty,
+    // only files below it are considered.
+    Vector<String> search(StringView query, StringView directory, size_t max_results) const;
+
+private:
+    explicit FileIndex(String index_path);
+
+    using EntryID = u32;
+    static constexpr EntryID root_id = 0;
+    static constexpr EntryID invalid_id = NumericLimits<EntryID>::max();
+
+    struct Entry {
+        String name;
+        EntryID parent { invalid_id };
+        bool is_directory { false };
+        bool is_deleted { false };
+        // For directories, so that one which hasn't changed since it was indexed doesn't have to be read again.
+        time_t modified_time { 0 };
+        Vector<EntryID> children;
+    };
+
+    EntryID add_entry(EntryID parent, String name, bool is_directory, time_t modified_time);
+    void remove_entry(EntryID);
+    Optional<EntryID> find_entry(StringView path) const;
+    Optional<EntryID> find_child(EntryID parent, StringView name) const;
+    String path_of(EntryID) const;
+    bool is_below(EntryID, EntryID ancestor) const;
+
+    void index_name(EntryID);
+    static u32 trigram_at(StringView name, size_t index);
+
+    void scan_directory(EntryID);
+    void scan_next_directories();
+    void enqueue_scan(EntryID);
+    void did_change_file_system(Core::FileWatcherEvent const&);
+    void did_modify_index();
+    void compact();
+
+    bool load();
+    void save();
+
+    String m_index_path;
+    Vector<Entry> m_entries;
+    size_t m_deleted_entry_count { 0 };
+    HashMap<u32, Vector<EntryID>> m_entries_by_trigram;
+
+    Queue<EntryID> m_directories_to_scan;
+    bool m_scan_is_scheduled { false };
+    RefPtr<Core::FileWatcher> m_watcher;
+    RefPtr<Core::Timer> m_save_timer;
+};
+
+}
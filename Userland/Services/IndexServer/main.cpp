@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <IndexServer/ClientConnection.h>
+#include <IndexServer/FileIndex.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/LocalServer.h>
+#include <LibCore/StandardPaths.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int main(int, char**)
+{
+    if (pledge("stdio accept rpath wpath cpath", nullptr) < 0) {
+        perror("pledge");
+        return 1;
+    }
+
+    auto cache_directory = String::formatted("{}/.cache", Core::StandardPaths::home_directory());
+    auto index_directory = String::formatted("{}/IndexServer", cache_directory);
+    for (auto& path : { cache_directory, index_directory }) {
+        if (mkdir(path.characters(), 0700) < 0 && errno != EEXIST)
+            dbgln("IndexServer: Failed to create {}: {}", path, strerror(errno));
+    }
+
+    if (unveil("/", "r") < 0) {
+        perror("unveil");
+        return 1;
+    }
+    if (unveil(index_directory.characters(), "rwc") < 0) {
+        perror("unveil");
+        return 1;
+    }
+    if (unveil(nullptr, nullptr) < 0) {
+        perror("unveil");
+        return 1;
+    }
+
+    Core::EventLoop event_loop;
+    auto index = IndexServer::FileIndex::construct(String::formatted("{}/files", index_directory));
+
+    auto server = Core::LocalServer::construct();
+    bool ok = server->take_over_from_system_server();
+    VERIFY(ok);
+    server->on_ready_to_accept = [&] {
+        auto client_socket = server->accept();
+        if (!client_socket) {
+            dbgln("IndexServer: accept failed.");
+            return;
+        }
+        static int s_next_client_id = 0;
+        int client_id = ++s_next_client_id;
+        IPC::new_client_connection<IndexServer::ClientConnection>(client_socket.release_nonnull(), client_id, *index);
+    };
+
+    return event_loop.exec();
+}
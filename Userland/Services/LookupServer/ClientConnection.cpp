@@ -30,6 +30,8 @@ void ClientConnection::die()
 
 Messages::LookupServer::LookupNameResponse ClientConnection::lookup_name(String const& name)
 {
+    // The lookup may have to wait for the network, during which the client could go away.
+    NonnullRefPtr protector { *this };
     auto answers = LookupServer::the().lookup(name, DNSRecordType::A);
     if (answers.is_empty())
         return { 1, Vector<String>() };
@@ -50,9 +52,29 @@ Messages::LookupServer::LookupAddressResponse ClientConnection::lookup_address(S
         ip_address[2],
         ip_address[1],
         ip_address[0]);
+    NonnullRefPtr protector { *this };
     auto answers = LookupServer::the().lookup(name, DNSRecordType::PTR);
     if (answers.is_empty())
         return { 1, String() };
     return { 0, answers[0].record_data() };
 }
+
+void ClientConnection::start_lookup_name(i32 request_id, String const& name)
+{
+    // Other requests on this connection go on being handled while we wait, and may well finish first.
+    LookupServer::the().lookup(name, DNSRecordType::A, [this, protector = NonnullRefPtr(*this), request_id](Vector<DNSAnswer> answers) {
+        if (answers.is_empty()) {
+            async_lookup_name_finished(request_id, 1, {}, 0);
+            return;
+        }
+        Vector<String> addresses;
+        u32 ttl = NumericLimits<u32>::max();
+        for (auto& answer : answers) {
+            addresses.append(answer.record_data());
+            ttl = min(ttl, answer.ttl());
+        }
+        async_lookup_name_finished(request_id, 0, move(addresses), ttl);
+    });
+}
+
 }
@@ -23,7 +23,7 @@ DNSAnswer::DNSAnswer(const DNSName& name, DNSRecordType type, DNSRecordClass cla
 
 bool DNSAnswer::has_expired() const
 {
-    return time(nullptr) >= m_received_time + m_ttl;
+    return time(nullptr) >= expiration_time();
 }
 
 }
@@ -44,6 +44,7 @@ public:
     const String& record_data() const { return m_record_data; }
     bool mdns_cache_flush() const { return m_mdns_cache_flush; }
 
+    time_t expiration_time() const { return m_received_time + m_ttl; }
     bool has_expired() const;
 
 private:
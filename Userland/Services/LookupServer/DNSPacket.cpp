@@ -117,10 +117,6 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
     packet.m_query_or_response = header.is_response();
     packet.m_code = header.response_code();
 
-    // FIXME: Should we parse further in this case?
-    if (packet.code() != Code::NOERROR)
-        return packet;
-
     size_t offset = sizeof(DNSPacketHeader);
 
     for (u16 i = 0; i < header.question_count(); i++) {
@@ -138,6 +134,10 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
         dbgln_if(LOOKUPSERVER_DEBUG, "Question #{}: name=_{}_, type={}, class={}", i, question.name(), question.record_type(), question.class_code());
     }
 
+    // FIXME: Should we parse further in this case?
+    if (packet.code() != Code::NOERROR && packet.code() != Code::NXDOMAIN)
+        return packet;
+
     for (u16 i = 0; i < header.answer_count(); ++i) {
         auto name = DNSName::parse(raw_data, offset, raw_size);
 
@@ -176,6 +176,23 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
         offset += record.data_length();
     }
 
+    for (u16 i = 0; i < header.authority_count(); ++i) {
+        DNSName::parse(raw_data, offset, raw_size);
+        if (offset + sizeof(DNSRecordWithoutName) > raw_size)
+            break;
+        auto& record = *(const DNSRecordWithoutName*)(&raw_data[offset]);
+        offset += sizeof(DNSRecordWithoutName);
+        if (offset + record.data_length() > raw_size)
+            break;
+
+        // The last field of an SOA record says how long answers that don't exist may be cached for (RFC 2308).
+        if ((DNSRecordType)record.type() == DNSRecordType::SOA && record.data_length() >= 20) {
+            u32 minimum_ttl = *(const NetworkOrdered<u32>*)(&raw_data[offset + record.data_length() - sizeof(u32)]);
+            packet.m_negative_caching_ttl = min(record.ttl(), minimum_ttl);
+        }
+        offset += record.data_length();
+    }
+
     return packet;
 }
 
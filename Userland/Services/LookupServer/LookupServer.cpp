@@ -17,7 +17,6 @@
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/LocalSocket.h>
-#include <LibCore/UDPSocket.h>
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
@@ -149,21 +148,53 @@ static String get_hostname()
     return buffer;
 }
 
+static DNSAnswer with_original_case(const DNSName& name, const DNSAnswer& answer, u32 ttl)
+{
+    return { name, answer.type(), answer.class_code(), ttl, answer.record_data(), answer.mdns_cache_flush() };
+}
+
+static Vector<DNSAnswer> answers_from_upstream_query(const DNSName& name, const UpstreamQuery& query)
+{
+    Vector<DNSAnswer> answers;
+    for (auto& answer : query.answers()) {
+        if (answer.type() == query.record_type())
+            answers.append(with_original_case(name, answer, answer.ttl()));
+    }
+    return answers;
+}
+
 Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, DNSRecordType record_type)
 {
     dbgln_if(LOOKUPSERVER_DEBUG, "Got request for '{}'", name.as_string());
 
+    if (auto answers = lookup_without_nameservers(name, record_type); answers.has_value())
+        return answers.release_value();
+
+    auto query = upstream_query_for(name, record_type);
+    query->wait();
+    return answers_from_upstream_query(name, query);
+}
+
+void LookupServer::lookup(const DNSName& name, DNSRecordType record_type, Function<void(Vector<DNSAnswer>)> callback)
+{
+    dbgln_if(LOOKUPSERVER_DEBUG, "Got request for '{}'", name.as_string());
+
+    if (auto answers = lookup_without_nameservers(name, record_type); answers.has_value()) {
+        callback(answers.release_value());
+        return;
+    }
+
+    auto query = upstream_query_for(name, record_type);
+    query->when_finished([name, query, callback = move(callback)] {
+        callback(answers_from_upstream_query(name, query));
+    });
+}
+
+Optional<Vector<DNSAnswer>> LookupServer::lookup_without_nameservers(const DNSName& name, DNSRecordType record_type)
+{
     Vector<DNSAnswer> answers;
     auto add_answer = [&](const DNSAnswer& answer) {
-        DNSAnswer answer_with_original_case {
-            name,
-            answer.type(),
-            answer.class_code(),
-            answer.ttl(),
-            answer.record_data(),
-            answer.mdns_cache_flush(),
-        };
-        answers.append(answer_with_original_case);
+        answers.append(with_original_case(name, answer, answer.ttl()));
     };
 
     // First, try /etc/hosts.
@@ -187,16 +218,23 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, DNSRecordType record
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.get(name); cached_answers.has_value()) {
-        for (auto& answer : cached_answers.value()) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end()) {
+        auto now = time(nullptr);
+        auto& entry = it->value;
+        entry.answers.remove_all_matching([&](auto& answer) { return now >= answer.expiration_time(); });
+        entry.negative_answers.remove_all_matching([&](auto& negative_answer) { return now >= negative_answer.expiration_time; });
+        for (auto& answer : entry.answers) {
+            if (answer.type() == record_type) {
                 dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
-                add_answer(answer);
+                answers.append(with_original_case(name, answer, answer.expiration_time() - now));
             }
         }
         if (!answers.is_empty())
             return answers;
+        if (entry.negative_answers.first_matching([&](auto& negative_answer) { return negative_answer.type == record_type; }).has_value()) {
+            dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {} ({})", name.as_string(), record_type);
+            return answers;
+        }
     }
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
@@ -207,161 +245,150 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, DNSRecordType record
         return answers;
     }
 
-    // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<DNSAnswer> upstream_answers;
-        do {
-            upstream_answers = lookup(name, nameserver, did_get_response, record_type);
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
-        }
-    }
+    // Otherwise, we'll have to ask the upstream nameservers.
+    return {};
+}
 
-    // Sixth, fail.
-    if (answers.is_empty()) {
-        dbgln("Tried all nameservers but never got a response :(");
-        return {};
+NonnullRefPtr<UpstreamQuery> LookupServer::upstream_query_for(const DNSName& name, DNSRecordType record_type)
+{
+    for (auto& upstream_query : m_upstream_queries) {
+        if (upstream_query.name() == name && upstream_query.record_type() == record_type) {
+            dbgln_if(LOOKUPSERVER_DEBUG, "Joining the upstream query for '{}' ({})", name.as_string(), record_type);
+            return upstream_query;
+        }
     }
 
-    return answers;
+    auto query = UpstreamQuery::construct(name, record_type, m_nameservers);
+    m_upstream_queries.append(query);
+    // NOTE: This comes first, so that the answers are in the cache by the time anyone else hears about them.
+    query->when_finished([this, query = query.ptr()] {
+        did_finish_upstream_query(*query);
+    });
+    query->start();
+    return query;
 }
 
-Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, const String& nameserver, bool& did_get_response, DNSRecordType record_type, ShouldRandomizeCase should_randomize_case)
+void LookupServer::did_finish_upstream_query(UpstreamQuery& query)
 {
-    DNSPacket request;
-    request.set_is_query();
-    request.set_id(get_random_uniform(UINT16_MAX));
-    DNSName name_in_question = name;
-    if (should_randomize_case == ShouldRandomizeCase::Yes)
-        name_in_question.randomize_case();
-    request.add_question({ name_in_question, record_type, DNSRecordClass::IN, false });
-
-    auto buffer = request.to_byte_buffer();
-
-    auto udp_socket = Core::UDPSocket::construct();
-    udp_socket->set_blocking(true);
-
-    struct timeval timeout {
-        1, 0
-    };
+    m_upstream_queries.remove_first_matching([&](auto& upstream_query) { return upstream_query.ptr() == &query; });
 
-    int rc = setsockopt(udp_socket->fd(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-    if (rc < 0) {
-        perror("setsockopt(SOL_SOCKET, SO_RCVTIMEO)");
-        return {};
+    switch (query.result()) {
+    case UpstreamQuery::Result::Answered:
+        for (auto& answer : query.answers()) {
+            put_in_cache(answer);
+            // When the name is an alias, the answers are for its canonical name. Remember them for the alias
+            // as well, so we don't have to ask again about that.
+            if (answer.type() == query.record_type() && !(answer.name() == query.name()))
+                put_in_cache({ query.name(), answer.type(), answer.class_code(), answer.ttl(), answer.record_data(), false });
+        }
+        break;
+    case UpstreamQuery::Result::NoAnswers:
+        for (auto& answer : query.answers())
+            put_in_cache(answer);
+        [[fallthrough]];
+    case UpstreamQuery::Result::NameDoesNotExist:
+        // Without an SOA record, we don't know how long this holds (RFC 2308), so we'll just ask again next time.
+        if (query.negative_caching_ttl().has_value())
+            put_negative_answer_in_cache(query.name(), query.record_type(), query.negative_caching_ttl().value());
+        break;
+    case UpstreamQuery::Result::Pending:
+    case UpstreamQuery::Result::Failed:
+        break;
     }
+}
 
-    if (!udp_socket->connect(nameserver, 53))
-        return {};
-
-    if (!udp_socket->write(buffer))
-        return {};
-
-    u8 response_buffer[4096];
-    int nrecv = udp_socket->read(response_buffer, sizeof(response_buffer));
-    if (nrecv == 0)
-        return {};
-
-    did_get_response = true;
-
-    auto o_response = DNSPacket::from_raw_packet(response_buffer, nrecv);
-    if (!o_response.has_value())
-        return {};
-
-    auto& response = o_response.value();
+void LookupServer::put_in_cache(const DNSAnswer& answer)
+{
+    if (answer.has_expired())
+        return;
 
-    if (response.id() != request.id()) {
-        dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return {};
+    auto it = m_lookup_cache.find(answer.name());
+    if (it == m_lookup_cache.end()) {
+        make_room_in_cache();
+        m_lookup_cache.set(answer.name(), { { answer }, {} });
+        return;
     }
 
-    if (response.code() == DNSPacket::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
-            // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
-        }
-        return {};
-    }
+    auto& entry = it->value;
+    if (answer.mdns_cache_flush()) {
+        auto now = time(nullptr);
 
-    if (response.question_count() != request.question_count()) {
-        dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return {};
-    }
+        entry.answers.remove_all_matching([&](DNSAnswer const& other_answer) {
+            if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
+                return false;
 
-    // Verify the questions in our request and in their response match exactly, including case.
-    for (size_t i = 0; i < request.question_count(); ++i) {
-        auto& request_question = request.questions()[i];
-        auto& response_question = response.questions()[i];
-        bool exact_match = request_question.class_code() == response_question.class_code()
-            && request_question.record_type() == response_question.record_type()
-            && request_question.name().as_string() == response_question.name().as_string();
-        if (!exact_match) {
-            dbgln("Request and response questions do not match");
-            dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return {};
-        }
-    }
+            if (other_answer.received_time() >= now - 1)
+                return false;
 
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return {};
+            dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
+            return true;
+        });
     }
+    // Don't pile up copies of the same record as it keeps getting refreshed.
+    entry.answers.remove_all_matching([&](DNSAnswer const& other_answer) {
+        return other_answer.type() == answer.type() && other_answer.class_code() == answer.class_code() && other_answer.record_data() == answer.record_data();
+    });
+    entry.negative_answers.remove_all_matching([&](auto& negative_answer) { return negative_answer.type == answer.type(); });
+    entry.answers.append(answer);
+}
 
-    Vector<DNSAnswer, 8> answers;
-    for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
-            continue;
-        answers.append(answer);
-    }
+void LookupServer::put_negative_answer_in_cache(const DNSName& name, DNSRecordType record_type, u32 ttl)
+{
+    ttl = min(ttl, MaxNegativeCachingTTL);
+    if (ttl == 0)
+        return;
+    NegativeAnswer negative_answer { record_type, time(nullptr) + ttl };
 
-    return answers;
+    auto it = m_lookup_cache.find(name);
+    if (it == m_lookup_cache.end()) {
+        make_room_in_cache();
+        m_lookup_cache.set(name, { {}, { negative_answer } });
+        return;
+    }
+    it->value.negative_answers.remove_all_matching([&](auto& other_negative_answer) { return other_negative_answer.type == record_type; });
+    it->value.negative_answers.append(negative_answer);
 }
 
-void LookupServer::put_in_cache(const DNSAnswer& answer)
+void LookupServer::make_room_in_cache()
 {
-    if (answer.has_expired())
+    if (m_lookup_cache.size() < MaxCacheSize)
         return;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
+    // First, get rid of everything that has expired.
+    auto now = time(nullptr);
+    Vector<DNSName> empty_entries;
+    for (auto& it : m_lookup_cache) {
+        auto& entry = it.value;
+        entry.answers.remove_all_matching([&](auto& answer) { return now >= answer.expiration_time(); });
+        entry.negative_answers.remove_all_matching([&](auto& negative_answer) { return now >= negative_answer.expiration_time; });
+        if (entry.answers.is_empty() && entry.negative_answers.is_empty())
+            empty_entries.append(it.key);
+    }
+    for (auto& name : empty_entries)
+        m_lookup_cache.remove(name);
+    if (m_lookup_cache.size() < MaxCacheSize)
+        return;
 
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
-
-            it->value.remove_all_matching([&](DNSAnswer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
-
-                if (other_answer.received_time() >= now - 1)
-                    return false;
-
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
+    // Then, drop the entry that would have expired first.
+    auto entry_expiration_time = [](CacheEntry const& entry) {
+        time_t expiration_time = 0;
+        for (auto& answer : entry.answers)
+            expiration_time = max(expiration_time, answer.expiration_time());
+        for (auto& negative_answer : entry.negative_answers)
+            expiration_time = max(expiration_time, negative_answer.expiration_time);
+        return expiration_time;
+    };
+    auto victim = m_lookup_cache.begin();
+    auto victim_expiration_time = entry_expiration_time(victim->value);
+    for (auto it = m_lookup_cache.begin(); it != m_lookup_cache.end(); ++it) {
+        auto expiration_time = entry_expiration_time(it->value);
+        if (expiration_time < victim_expiration_time) {
+            victim = it;
+            victim_expiration_time = expiration_time;
         }
-        it->value.append(answer);
     }
+    dbgln_if(LOOKUPSERVER_DEBUG, "Evicting '{}' from the cache", victim->key.as_string());
+    m_lookup_cache.remove(victim);
 }
 
 }
@@ -10,6 +10,8 @@
 #include "DNSPacket.h"
 #include "DNSServer.h"
 #include "MulticastDNS.h"
+#include "UpstreamQuery.h"
+#include <AK/NonnullRefPtrVector.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCore/Object.h>
 
@@ -23,14 +25,36 @@ class LookupServer final : public Core::Object {
 public:
     static LookupServer& the();
     Vector<DNSAnswer> lookup(const DNSName& name, DNSRecordType record_type);
+    // Like the above, but instead of waiting for the nameservers, calls the callback once there's an answer.
+    void lookup(const DNSName& name, DNSRecordType record_type, Function<void(Vector<DNSAnswer>)> callback);
 
 private:
+    static constexpr size_t MaxCacheSize = 256;
+    // Nameservers may ask for answers not to exist for a very long time, but we'd rather check again sooner.
+    static constexpr u32 MaxNegativeCachingTTL = 3600;
+
+    struct NegativeAnswer {
+        DNSRecordType type;
+        time_t expiration_time;
+    };
+
+    struct CacheEntry {
+        Vector<DNSAnswer> answers;
+        // The record types the nameservers told us there is nothing of.
+        Vector<NegativeAnswer> negative_answers;
+    };
+
     LookupServer();
 
     void load_etc_hosts();
     void put_in_cache(const DNSAnswer&);
+    void put_negative_answer_in_cache(const DNSName&, DNSRecordType, u32 ttl);
+    void make_room_in_cache();
 
-    Vector<DNSAnswer> lookup(const DNSName& hostname, const String& nameserver, bool& did_get_response, DNSRecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    // Returns nothing if only the nameservers can tell.
+    Optional<Vector<DNSAnswer>> lookup_without_nameservers(const DNSName&, DNSRecordType);
+    NonnullRefPtr<UpstreamQuery> upstream_query_for(const DNSName&, DNSRecordType);
+    void did_finish_upstream_query(UpstreamQuery&);
 
     RefPtr<Core::LocalServer> m_local_server;
     RefPtr<DNSServer> m_dns_server;
@@ -38,7 +62,9 @@ private:
     Vector<String> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_etc_hosts;
-    HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_lookup_cache;
+    HashMap<DNSName, CacheEntry, DNSName::Traits> m_lookup_cache;
+    // Queries that are still waiting for the nameservers, which clients asking for the same thing join.
+    NonnullRefPtrVector<UpstreamQuery> m_upstream_queries;
 };
 
 }
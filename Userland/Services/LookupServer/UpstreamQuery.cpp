@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "UpstreamQuery.h"
+#include <AK/Debug.h>
+#include <AK/Random.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/socket.h>
+
+namespace LookupServer {
+
+UpstreamQuery::UpstreamQuery(const DNSName& name, DNSRecordType record_type, const Vector<String>& nameservers, Core::Object* parent)
+    : Core::Object(parent)
+    , m_name(name)
+    , m_record_type(record_type)
+{
+    for (auto& address : nameservers)
+        m_nameservers.append({ address, nullptr, {}, 0, name });
+}
+
+void UpstreamQuery::start()
+{
+    for (size_t i = 0; i < m_nameservers.size(); ++i) {
+        auto& nameserver = m_nameservers[i];
+        build_request(nameserver);
+        nameserver.socket = Core::UDPSocket::construct(this);
+        nameserver.socket->set_blocking(false);
+        if (!nameserver.socket->connect(nameserver.address, 53)) {
+            dbgln("Failed to connect to nameserver '{}'", nameserver.address);
+            nameserver.has_failed = true;
+            continue;
+        }
+        // NOTE: The nameservers never move around, so it's fine to hold on to the index.
+        nameserver.socket->on_ready_to_read = [this, i] { receive_response(m_nameservers[i]); };
+    }
+
+    m_timeout_timer = Core::Timer::construct(AttemptTimeoutInMilliseconds, [this] {
+        if (m_attempt_count == MaxAttempts) {
+            dbgln("Never got a response from any nameserver for '{}'", m_name);
+            finish(Result::Failed);
+            return;
+        }
+        send_requests();
+    },
+        this);
+    send_requests();
+}
+
+void UpstreamQuery::build_request(Nameserver& nameserver)
+{
+    DNSPacket request;
+    request.set_is_query();
+    request.set_id(get_random_uniform(UINT16_MAX));
+    nameserver.name_in_question = m_name;
+    if (nameserver.should_randomize_case == ShouldRandomizeCase::Yes)
+        nameserver.name_in_question.randomize_case();
+    request.add_question({ nameserver.name_in_question, m_record_type, DNSRecordClass::IN, false });
+    nameserver.id = request.id();
+    nameserver.request = request.to_byte_buffer();
+}
+
+void UpstreamQuery::send_requests()
+{
+    ++m_attempt_count;
+    bool did_send_any = false;
+    for (auto& nameserver : m_nameservers) {
+        if (nameserver.has_failed)
+            continue;
+        dbgln_if(LOOKUPSERVER_DEBUG, "Asking nameserver '{}' about '{}' (attempt {})", nameserver.address, m_name, m_attempt_count);
+        // A late response to an earlier attempt is just as good, which is why the ID stays the same.
+        if (send(nameserver.socket->fd(), nameserver.request.data(), nameserver.request.size(), 0) < 0) {
+            perror("send");
+            nameserver.has_failed = true;
+            continue;
+        }
+        did_send_any = true;
+    }
+    if (!did_send_any) {
+        finish(Result::Failed);
+        return;
+    }
+    m_timeout_timer->restart();
+}
+
+void UpstreamQuery::receive_response(Nameserver& nameserver)
+{
+    u8 response_buffer[4096];
+    Bytes datagrams[] = { { response_buffer, sizeof(response_buffer) } };
+    auto received_count = nameserver.socket->receive_datagrams(datagrams);
+    if (!received_count.has_value()) {
+        // Most likely, the nameserver isn't there and we got an ICMP error back.
+        if (nameserver.socket->error() != EAGAIN)
+            did_fail(nameserver);
+        return;
+    }
+    if (received_count.value() == 0 || m_result != Result::Pending)
+        return;
+
+    auto o_response = DNSPacket::from_raw_packet(datagrams[0].data(), datagrams[0].size());
+    if (!o_response.has_value())
+        return;
+
+    auto& response = o_response.value();
+
+    if (response.id() != nameserver.id) {
+        dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), nameserver.id);
+        return;
+    }
+
+    if (response.code() == DNSPacket::Code::REFUSED) {
+        if (nameserver.should_randomize_case == ShouldRandomizeCase::Yes) {
+            // Retry with 0x20 case randomization turned off.
+            nameserver.should_randomize_case = ShouldRandomizeCase::No;
+            build_request(nameserver);
+            if (send(nameserver.socket->fd(), nameserver.request.data(), nameserver.request.size(), 0) < 0)
+                did_fail(nameserver);
+            return;
+        }
+        did_fail(nameserver);
+        return;
+    }
+
+    // Verify that the question in the response matches ours exactly, including case.
+    // Anything else might be an attempt at poisoning our cache, so let's keep waiting for the real response.
+    if (response.question_count() != 1) {
+        dbgln("LookupServer: Question count ({} vs 1) :(", response.question_count());
+        return;
+    }
+    auto& response_question = response.questions()[0];
+    bool exact_match = response_question.class_code() == DNSRecordClass::IN
+        && response_question.record_type() == m_record_type
+        && response_question.name().as_string() == nameserver.name_in_question.as_string();
+    if (!exact_match) {
+        dbgln("Request and response questions do not match");
+        dbgln("   Request: name=_{}_, type={}, class={}", nameserver.name_in_question.as_string(), m_record_type, DNSRecordClass::IN);
+        dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
+        return;
+    }
+
+    m_negative_caching_ttl = response.negative_caching_ttl();
+
+    if (response.code() == DNSPacket::Code::NXDOMAIN) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "Nameserver '{}' says '{}' doesn't exist", nameserver.address, m_name);
+        finish(Result::NameDoesNotExist);
+        return;
+    }
+
+    if (response.code() != DNSPacket::Code::NOERROR) {
+        dbgln("Nameserver '{}' responded with code {} for '{}'", nameserver.address, (u8)response.code(), m_name);
+        did_fail(nameserver);
+        return;
+    }
+
+    m_answers = response.answers();
+    bool has_answers_of_type = m_answers.first_matching([&](auto& answer) { return answer.type() == m_record_type; }).has_value();
+    finish(has_answers_of_type ? Result::Answered : Result::NoAnswers);
+}
+
+void UpstreamQuery::did_fail(Nameserver& nameserver)
+{
+    nameserver.has_failed = true;
+    for (auto& other_nameserver : m_nameservers) {
+        if (!other_nameserver.has_failed)
+            return;
+    }
+    dbgln("All nameservers failed to look up '{}'", m_name);
+    finish(Result::Failed);
+}
+
+void UpstreamQuery::finish(Result result)
+{
+    if (m_result != Result::Pending)
+        return;
+    m_result = result;
+    m_timeout_timer->stop();
+
+    // Whoever was waiting for us may let go of us now, but we're most likely still in the middle of handling a response.
+    deferred_invoke([protector = NonnullRefPtr(*this)](auto&) {});
+
+    for (auto* event_loop : m_waiting_event_loops)
+        event_loop->quit(0);
+    m_waiting_event_loops.clear();
+    auto finish_callbacks = move(m_finish_callbacks);
+    for (auto& callback : finish_callbacks)
+        callback();
+}
+
+void UpstreamQuery::when_finished(Function<void()> callback)
+{
+    if (m_result != Result::Pending) {
+        callback();
+        return;
+    }
+    m_finish_callbacks.append(move(callback));
+}
+
+void UpstreamQuery::wait()
+{
+    if (m_result != Result::Pending)
+        return;
+    Core::EventLoop event_loop;
+    m_waiting_event_loops.append(&event_loop);
+    event_loop.exec();
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "DNSAnswer.h"
+#include "DNSName.h"
+#include "DNSPacket.h"
+#include <AK/Function.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Object.h>
+#include <LibCore/Timer.h>
+#include <LibCore/UDPSocket.h>
+
+namespace LookupServer {
+
+// Asks all the upstream nameservers about a name at once, and goes with whichever gives a proper response first.
+class UpstreamQuery final : public Core::Object {
+    C_OBJECT(UpstreamQuery);
+
+public:
+    static constexpr int AttemptTimeoutInMilliseconds = 1000;
+    static constexpr int MaxAttempts = 3;
+
+    enum class Result {
+        Pending,
+        Answered,
+        // The name exists, but there are no records of the type we asked for.
+        NoAnswers,
+        NameDoesNotExist,
+        Failed,
+    };
+
+    const DNSName& name() const { return m_name; }
+    DNSRecordType record_type() const { return m_record_type; }
+    Result result() const { return m_result; }
+
+    // All the records the nameserver answered with, which may be of other types (like CNAME) too.
+    const Vector<DNSAnswer>& answers() const { return m_answers; }
+    Optional<u32> negative_caching_ttl() const { return m_negative_caching_ttl; }
+
+    void start();
+
+    // Calls the callback once the query is done, right away if it already is.
+    void when_finished(Function<void()>);
+
+    // Runs a nested event loop until the query is done, so that other clients can be served meanwhile.
+    void wait();
+
+private:
+    UpstreamQuery(const DNSName&, DNSRecordType, const Vector<String>& nameservers, Core::Object* parent = nullptr);
+
+    struct Nameserver {
+        String address;
+        RefPtr<Core::UDPSocket> socket;
+        ByteBuffer request;
+        u16 id { 0 };
+        DNSName name_in_question;
+        ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+        bool has_failed { false };
+    };
+
+    void build_request(Nameserver&);
+    void send_requests();
+    void receive_response(Nameserver&);
+    void did_fail(Nameserver&);
+    void finish(Result);
+
+    DNSName m_name;
+    DNSRecordType m_record_type;
+    Vector<Nameserver> m_nameservers;
+    RefPtr<Core::Timer> m_timeout_timer;
+    int m_attempt_count { 0 };
+
+    Result m_result { Result::Pending };
+    Vector<DNSAnswer> m_answers;
+    Optional<u32> m_negative_caching_ttl;
+    Vector<Function<void()>> m_finish_callbacks;
+    Vector<Core::EventLoop*> m_waiting_event_loops;
+};
+
+}
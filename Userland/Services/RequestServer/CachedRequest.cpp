@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Timer.h>
+#include <RequestServer/CachedRequest.h>
+#include <RequestServer/HttpCache.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ClientConnection& client, NonnullRefPtr<CachedResponse> response, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_response(move(response))
+    , m_start_timer(Core::Timer::create_single_shot(0, [this] {
+        set_status_code(m_response->status_code());
+        set_response_headers(m_response->headers());
+        send_cached_body(m_response);
+    }))
+{
+    // The client only learns the request's ID once start_request() has returned, so answer from the event loop.
+    m_start_timer->start();
+}
+
+CachedRequest::~CachedRequest()
+{
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ClientConnection& client, NonnullRefPtr<CachedResponse> response, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
+{
+    return adopt_own(*new CachedRequest(client, move(response), move(output_stream)));
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Forward.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request answered entirely by the HTTP cache.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override;
+    static NonnullOwnPtr<CachedRequest> create(ClientConnection&, NonnullRefPtr<CachedResponse>, NonnullOwnPtr<ResponseBodyStream>&&);
+
+private:
+    explicit CachedRequest(ClientConnection&, NonnullRefPtr<CachedResponse>, NonnullOwnPtr<ResponseBodyStream>&&);
+
+    NonnullRefPtr<CachedResponse> m_response;
+    NonnullRefPtr<Core::Timer> m_start_timer;
+};
+
+}
@@ -41,22 +41,23 @@ Messages::RequestServer::StartRequestResponse ClientConnection::start_request(St
 {
     if (!url.is_valid()) {
         dbgln("StartRequest: Invalid URL requested: '{}'", url);
-        return { -1, Optional<IPC::File> {} };
+        return { -1, Optional<IPC::File> {}, Core::AnonymousBuffer {} };
     }
     auto* protocol = Protocol::find_by_name(url.protocol());
     if (!protocol) {
         dbgln("StartRequest: No protocol handler for URL: '{}'", url);
-        return { -1, Optional<IPC::File> {} };
+        return { -1, Optional<IPC::File> {}, Core::AnonymousBuffer {} };
     }
     auto request = protocol->start_request(*this, method, url, request_headers.entries(), request_body);
     if (!request) {
         dbgln("StartRequest: Protocol handler failed to start request: '{}'", url);
-        return { -1, Optional<IPC::File> {} };
+        return { -1, Optional<IPC::File> {}, Core::AnonymousBuffer {} };
     }
     auto id = request->id();
     auto fd = request->request_fd();
+    auto body_buffer = request->response_body_buffer();
     m_requests.set(id, move(request));
-    return { id, IPC::File(fd, IPC::File::CloseAfterSending) };
+    return { id, IPC::File(fd, IPC::File::CloseAfterSending), move(body_buffer) };
 }
 
 Messages::RequestServer::StopRequestResponse ClientConnection::stop_request(i32 request_id)
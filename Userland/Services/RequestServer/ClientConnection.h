@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <LibCore/AnonymousBuffer.h>
 #include <LibIPC/ClientConnection.h>
 #include <RequestServer/Forward.h>
 #include <RequestServer/RequestClientEndpoint.h>
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <AK/WeakPtr.h>
+#include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace RequestServer {
+
+// Keeps the connections that finished HTTP(S) jobs leave open, so later requests to the same origin
+// can skip the TCP (and TLS) handshakes. At most MaxConnectionsPerOrigin connections to one origin
+// exist at a time; jobs beyond that wait until one of them is released.
+//
+// Servers that speak HTTP/2 get a single connection, which all jobs to the origin share as streams.
+// Whether they do is only known once the first connection's TLS handshake is done, so until then,
+// other jobs to the origin wait.
+template<typename JobType, typename SocketType>
+class ConnectionPool {
+public:
+    static constexpr size_t MaxConnectionsPerOrigin = 6;
+    static constexpr int IdleTimeoutMilliseconds = 30000;
+
+    void start_job(JobType& job)
+    {
+        auto key = origin_key(job.request().url());
+        auto it = m_origins.find(key);
+        if (it == m_origins.end()) {
+            m_origins.set(key, make<Origin>());
+            it = m_origins.find(key);
+        }
+        auto& origin = *it->value;
+        if (!can_start_job(origin)) {
+            origin.waiting_jobs.append(job.template make_weak_ptr<JobType>());
+            return;
+        }
+        start_job_now(job, key, origin);
+    }
+
+private:
+    struct IdleConnection {
+        NonnullRefPtr<SocketType> socket;
+        NonnullRefPtr<Core::Timer> expiry_timer;
+    };
+
+    struct Origin {
+        size_t connections_in_use { 0 };
+        // Most recently released last.
+        Vector<IdleConnection> idle_connections;
+        Vector<WeakPtr<JobType>> waiting_jobs;
+
+        // Shared by all jobs to the origin, for as long as the server speaks HTTP/2.
+        RefPtr<HTTP::Http2Connection> http2_connection;
+        RefPtr<Core::Timer> http2_expiry_timer;
+        // Whether a new connection is in its handshake, which will tell whether the server speaks HTTP/2.
+        bool is_negotiating_protocol { false };
+        // Until a server picks HTTP/1.1, we hope that it might speak HTTP/2.
+        bool may_speak_http2 { true };
+
+        bool is_unused() const
+        {
+            return connections_in_use == 0 && idle_connections.is_empty() && waiting_jobs.is_empty() && !http2_connection && !is_negotiating_protocol;
+        }
+    };
+
+    static String origin_key(const URL& url)
+    {
+        return String::formatted("{}:{}", url.host(), url.port());
+    }
+
+    static bool can_start_job(const Origin& origin)
+    {
+        if (origin.http2_connection)
+            return origin.http2_connection->can_start_stream();
+        return !origin.is_negotiating_protocol && origin.connections_in_use < MaxConnectionsPerOrigin;
+    }
+
+    void start_job_now(JobType& job, const String& key, Origin& origin)
+    {
+        if constexpr (requires { job.on_protocol_negotiated; }) {
+            if (origin.http2_connection) {
+                origin.http2_expiry_timer->stop();
+                job.start(NonnullRefPtr<HTTP::Http2Connection>(*origin.http2_connection));
+                return;
+            }
+        }
+
+        ++origin.connections_in_use;
+        job.on_connection_released = [this, key](auto socket) {
+            did_release_connection(key, move(socket));
+        };
+
+        if (origin.idle_connections.is_empty()) {
+            if constexpr (requires { job.on_protocol_negotiated; }) {
+                origin.is_negotiating_protocol = origin.may_speak_http2;
+                job.on_protocol_negotiated = [this, key](auto connection) {
+                    did_negotiate_protocol(key, move(connection));
+                };
+            }
+            job.start();
+            return;
+        }
+
+        // The most recently used connection is the least likely to have been closed by the server in the meantime.
+        auto connection = origin.idle_connections.take_last();
+        connection.expiry_timer->stop();
+        stop_watching_idle_connection(*connection.socket);
+        job.start(move(connection.socket));
+    }
+
+    void start_waiting_jobs(const String& key, Origin& origin)
+    {
+        while (!origin.waiting_jobs.is_empty() && can_start_job(origin)) {
+            auto job = origin.waiting_jobs.take_first();
+            if (!job || job->is_cancelled())
+                continue;
+            start_job_now(*job, key, origin);
+        }
+
+        if (origin.is_unused())
+            m_origins.remove(key);
+    }
+
+    void did_release_connection(const String& key, RefPtr<SocketType> socket)
+    {
+        auto it = m_origins.find(key);
+        VERIFY(it != m_origins.end());
+        auto& origin = *it->value;
+        VERIFY(origin.connections_in_use > 0);
+        --origin.connections_in_use;
+        // The connection may not have made it through its handshake.
+        origin.is_negotiating_protocol = false;
+
+        if (socket)
+            keep_idle_connection(key, origin, socket.release_nonnull());
+
+        start_waiting_jobs(key, origin);
+    }
+
+    void did_negotiate_protocol(const String& key, RefPtr<HTTP::Http2Connection> connection)
+    {
+        auto it = m_origins.find(key);
+        VERIFY(it != m_origins.end());
+        auto& origin = *it->value;
+        origin.is_negotiating_protocol = false;
+        origin.may_speak_http2 = connection;
+
+        if (connection) {
+            // The job that made the connection now runs on it as a stream, and won't release it.
+            VERIFY(origin.connections_in_use > 0);
+            --origin.connections_in_use;
+            // Another connection may have gotten there first, in which case this one only serves its own job.
+            if (!origin.http2_connection)
+                share_http2_connection(key, origin, connection.release_nonnull());
+        }
+
+        start_waiting_jobs(key, origin);
+    }
+
+    void share_http2_connection(const String& key, Origin& origin, NonnullRefPtr<HTTP::Http2Connection> connection)
+    {
+        connection->on_can_start_stream = [this, key] {
+            auto it = m_origins.find(key);
+            VERIFY(it != m_origins.end());
+            auto& origin = *it->value;
+            if (origin.http2_connection->stream_count() == 0 && origin.waiting_jobs.is_empty())
+                origin.http2_expiry_timer->start();
+            start_waiting_jobs(key, origin);
+        };
+        connection->on_close = [this, key, connection = connection.ptr()] {
+            forget_http2_connection(key, *connection);
+        };
+
+        origin.http2_expiry_timer = Core::Timer::create_single_shot(IdleTimeoutMilliseconds, [this, key] {
+            auto it = m_origins.find(key);
+            if (it == m_origins.end() || !it->value->http2_connection)
+                return;
+            NonnullRefPtr connection = *it->value->http2_connection;
+            connection->close();
+        });
+        origin.http2_connection = move(connection);
+    }
+
+    void forget_http2_connection(const String& key, HTTP::Http2Connection& connection)
+    {
+        auto it = m_origins.find(key);
+        if (it == m_origins.end() || it->value->http2_connection.ptr() != &connection)
+            return;
+        auto& origin = *it->value;
+        connection.on_can_start_stream = nullptr;
+        connection.on_close = nullptr;
+        origin.http2_expiry_timer->stop();
+        origin.http2_expiry_timer = nullptr;
+        origin.http2_connection = nullptr;
+        // Whoever is still waiting gets a new connection.
+        start_waiting_jobs(key, origin);
+    }
+
+    void keep_idle_connection(const String& key, Origin& origin, NonnullRefPtr<SocketType> socket)
+    {
+        auto* socket_ptr = socket.ptr();
+        auto expiry_timer = Core::Timer::create_single_shot(IdleTimeoutMilliseconds, [this, key, socket_ptr] {
+            forget_idle_connection(key, *socket_ptr);
+        });
+        expiry_timer->start();
+
+        watch_idle_connection(key, *socket);
+
+        origin.idle_connections.append({ move(socket), move(expiry_timer) });
+    }
+
+    // While idle, the server has nothing to say to us; anything showing up means it's closing the connection.
+    void watch_idle_connection(const String& key, SocketType& socket)
+    {
+        auto on_closing = [this, key, socket = &socket] {
+            stop_watching_idle_connection(*socket);
+            // We're inside one of the socket's own callbacks, so let go of it once that has returned.
+            socket->deferred_invoke([this, key](auto& object) {
+                forget_idle_connection(key, static_cast<SocketType&>(object));
+            });
+        };
+        if constexpr (requires { socket.on_tls_finished; }) {
+            socket.on_tls_ready_to_read = [on_closing](auto&) { on_closing(); };
+            socket.on_tls_error = [on_closing](auto) { on_closing(); };
+            socket.on_tls_finished = move(on_closing);
+        } else {
+            socket.on_ready_to_read = move(on_closing);
+        }
+    }
+
+    static void stop_watching_idle_connection(SocketType& socket)
+    {
+        if constexpr (requires { socket.on_tls_finished; }) {
+            socket.on_tls_ready_to_read = nullptr;
+            socket.on_tls_error = nullptr;
+            socket.on_tls_finished = nullptr;
+        } else {
+            socket.on_ready_to_read = nullptr;
+        }
+    }
+
+    void forget_idle_connection(const String& key, SocketType& socket)
+    {
+        auto it = m_origins.find(key);
+        if (it == m_origins.end())
+            return;
+        auto& origin = *it->value;
+        origin.idle_connections.remove_first_matching([&](auto& connection) {
+            return connection.socket.ptr() == &socket;
+        });
+        if (origin.is_unused())
+            m_origins.remove(it);
+    }
+
+    HashMap<String, NonnullOwnPtr<Origin>> m_origins;
+};
+
+}
@@ -8,13 +8,17 @@
 
 namespace RequestServer {
 
+class CachedRequest;
+class CachedResponse;
 class ClientConnection;
 class Request;
 class GeminiProtocol;
+class HttpCache;
 class HttpRequest;
 class HttpProtocol;
 class HttpsRequest;
 class HttpsProtocol;
 class Protocol;
+class ResponseBodyStream;
 
 }
@@ -26,15 +26,12 @@ OwnPtr<Request> GeminiProtocol::start_request(ClientConnection& client, const St
     Gemini::GeminiRequest request;
     request.set_url(url);
 
-    auto pipe_result = get_pipe_for_request();
-    if (pipe_result.is_error())
+    auto output_stream = create_response_body_stream();
+    if (!output_stream)
         return {};
 
-    auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
-    output_stream->make_unbuffered();
     auto job = Gemini::GeminiJob::construct(request, *output_stream);
-    auto protocol_request = GeminiRequest::create_with_job({}, client, (Gemini::GeminiJob&)*job, move(output_stream));
-    protocol_request->set_request_fd(pipe_result.value().read_fd);
+    auto protocol_request = GeminiRequest::create_with_job({}, client, (Gemini::GeminiJob&)*job, output_stream.release_nonnull());
     job->start();
     return protocol_request;
 }
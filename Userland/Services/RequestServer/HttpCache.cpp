@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <RequestServer/HttpCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+static constexpr size_t max_body_size = 8 * MiB;
+static constexpr size_t max_disk_usage = 64 * MiB;
+static constexpr size_t max_memory_usage = 16 * MiB;
+static constexpr time_t max_heuristic_freshness_lifetime = 24 * 60 * 60;
+
+template<typename Headers>
+static Optional<String> find_header(const Headers& headers, const StringView& name)
+{
+    for (auto& header : headers) {
+        if (header.key.equals_ignoring_case(name))
+            return header.value;
+    }
+    return {};
+}
+
+// Returns the value of a Cache-Control directive, or an empty string for a directive without one.
+template<typename Headers>
+static Optional<String> cache_control_directive(const Headers& headers, const StringView& name)
+{
+    auto cache_control = find_header(headers, "Cache-Control");
+    if (!cache_control.has_value())
+        return {};
+    for (auto& part : cache_control.value().split_view(',')) {
+        auto directive = part.trim_whitespace();
+        auto equals = directive.find('=');
+        auto directive_name = equals.has_value() ? directive.substring_view(0, equals.value()) : directive;
+        if (!directive_name.trim_whitespace().equals_ignoring_case(name))
+            continue;
+        if (!equals.has_value())
+            return String::empty();
+        return String { directive.substring_view(equals.value() + 1).trim_whitespace() };
+    }
+    return {};
+}
+
+static Optional<time_t> parse_http_date(const String& value)
+{
+    // Only the preferred format (RFC 7231, section 7.1.1.1); dates in the obsolete ones are treated like invalid ones.
+    auto date_time = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S GMT", value);
+    if (!date_time.has_value())
+        return {};
+    return date_time.value().timestamp();
+}
+
+static bool write_all(int fd, ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto nwritten = write(fd, bytes.data(), bytes.size());
+        if (nwritten < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        bytes = bytes.slice(nwritten);
+    }
+    return true;
+}
+
+ReadonlyBytes CachedResponse::body() const
+{
+    if (m_body.has_value())
+        return m_body.value().bytes();
+    VERIFY(m_file);
+    return m_file->bytes().slice(m_body_offset, m_body_size);
+}
+
+time_t CachedResponse::freshness_lifetime() const
+{
+    if (auto max_age = cache_control_directive(m_headers, "max-age"); max_age.has_value())
+        return max_age.value().to_uint().value_or(0);
+
+    Optional<time_t> date;
+    if (auto value = m_headers.get("Date"); value.has_value())
+        date = parse_http_date(value.value());
+    // Without a Date, the time we received the response is the best guess for when it was sent.
+    auto sent_at = date.value_or(m_response_time);
+
+    if (auto expires = m_headers.get("Expires"); expires.has_value()) {
+        // An invalid date (like "0") means that the response has already expired.
+        auto expires_at = parse_http_date(expires.value());
+        if (!expires_at.has_value() || expires_at.value() <= sent_at)
+            return 0;
+        return expires_at.value() - sent_at;
+    }
+
+    // Something that hasn't changed for a long time is unlikely to change soon (RFC 7234, section 4.2.2).
+    if (auto last_modified = m_headers.get("Last-Modified"); last_modified.has_value()) {
+        auto modified_at = parse_http_date(last_modified.value());
+        if (modified_at.has_value() && modified_at.value() < sent_at)
+            return min((sent_at - modified_at.value()) / 10, max_heuristic_freshness_lifetime);
+    }
+    return 0;
+}
+
+time_t CachedResponse::current_age() const
+{
+    time_t age = 0;
+    if (auto value = m_headers.get("Age"); value.has_value())
+        age = value.value().to_uint().value_or(0);
+    return age + max<time_t>(0, time(nullptr) - m_response_time);
+}
+
+bool CachedResponse::is_fresh() const
+{
+    if (cache_control_directive(m_headers, "no-cache").has_value())
+        return false;
+    return freshness_lifetime() > current_age();
+}
+
+RefPtr<CachedResponse> HttpCache::Transaction::fresh_response() const
+{
+    if (!m_stored_response || m_must_revalidate || !m_stored_response->is_fresh())
+        return nullptr;
+    return m_stored_response;
+}
+
+void HttpCache::Transaction::add_validators(HashMap<String, String>& request_headers) const
+{
+    if (!m_stored_response)
+        return;
+    if (auto etag = m_stored_response->headers().get("ETag"); etag.has_value())
+        request_headers.set("If-None-Match", etag.value());
+    if (auto last_modified = m_stored_response->headers().get("Last-Modified"); last_modified.has_value())
+        request_headers.set("If-Modified-Since", last_modified.value());
+}
+
+RefPtr<CachedResponse> HttpCache::Transaction::did_receive_headers(u32 status_code, const ResponseHeaders& headers)
+{
+    if (m_response_time != 0)
+        return revalidated_response();
+    m_response_time = time(nullptr);
+
+    if (status_code == 304 && m_stored_response) {
+        HttpCache::the().refresh(*m_stored_response, headers, m_response_time);
+        m_revalidated = true;
+        return m_stored_response;
+    }
+
+    m_recording = is_storable(status_code, headers);
+    if (m_recording) {
+        m_status_code = status_code;
+        m_headers = headers;
+    } else if (m_stored_response) {
+        // The server has moved on from what we have stored.
+        HttpCache::the().remove(m_url);
+    }
+    return nullptr;
+}
+
+void HttpCache::Transaction::did_receive_body_data(ReadonlyBytes bytes)
+{
+    if (!m_recording)
+        return;
+    if (m_body.size() + bytes.size() > max_body_size) {
+        m_recording = false;
+        m_body.clear();
+        return;
+    }
+    m_body.append(bytes);
+}
+
+void HttpCache::Transaction::did_finish(bool success)
+{
+    if (!m_recording)
+        return;
+    m_recording = false;
+    if (success)
+        HttpCache::the().store(m_url, m_status_code, move(m_headers), m_response_time, move(m_body));
+}
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache s_the;
+    return s_the;
+}
+
+HttpCache::HttpCache()
+{
+    auto cache_directory = String::formatted("{}/.cache", Core::StandardPaths::home_directory());
+    m_directory = String::formatted("{}/RequestServer", cache_directory);
+    for (auto& path : { cache_directory, m_directory }) {
+        if (mkdir(path.characters(), 0700) < 0 && errno != EEXIST)
+            dbgln("HttpCache: Failed to create {}: {}", path, strerror(errno));
+    }
+}
+
+RefPtr<HttpCache::Transaction> HttpCache::begin(const String& method, const URL& url, const HashMap<String, String>& request_headers)
+{
+    if (!method.equals_ignoring_case("GET")) {
+        // Whatever we have stored is likely out of date after an unsafe request (RFC 7234, section 4.4).
+        remove(url);
+        return nullptr;
+    }
+
+    if (cache_control_directive(request_headers, "no-store").has_value())
+        return nullptr;
+
+    // Partial, authenticated and conditional requests are between the client and the server.
+    for (auto* name : { "Range", "Authorization", "If-None-Match", "If-Modified-Since", "If-Match", "If-Unmodified-Since", "If-Range" }) {
+        if (find_header(request_headers, name).has_value())
+            return nullptr;
+    }
+
+    auto max_age = cache_control_directive(request_headers, "max-age");
+    auto pragma = find_header(request_headers, "Pragma");
+    bool must_revalidate = cache_control_directive(request_headers, "no-cache").has_value()
+        || (max_age.has_value() && max_age.value() == "0")
+        || (pragma.has_value() && pragma.value().contains("no-cache", CaseSensitivity::CaseInsensitive));
+
+    return adopt_ref(*new Transaction(url, find(url), must_revalidate));
+}
+
+bool HttpCache::is_storable(u32 status_code, const ResponseHeaders& headers)
+{
+    // The status codes that are cacheable by default (RFC 7231, section 6.1), minus the ones for requests we don't cache.
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 404:
+    case 410:
+        break;
+    default:
+        return false;
+    }
+
+    if (cache_control_directive(headers, "no-store").has_value())
+        return false;
+
+    // We don't keep the request headers around to match against, except for Accept-Encoding,
+    // which is the same for every request we make.
+    if (auto vary = headers.get("Vary"); vary.has_value()) {
+        for (auto& name : vary.value().split_view(',')) {
+            if (!name.trim_whitespace().equals_ignoring_case("Accept-Encoding"))
+                return false;
+        }
+    }
+
+    // Handing out the same cookies again could undo whatever the client has done with them since.
+    if (headers.contains("Set-Cookie"))
+        return false;
+
+    // Without a lifetime or a way to revalidate it, the stored response would never be used.
+    return headers.contains("ETag") || headers.contains("Last-Modified") || headers.contains("Expires")
+        || cache_control_directive(headers, "max-age").has_value();
+}
+
+String HttpCache::file_name_for(const URL& url) const
+{
+    auto digest = Crypto::Hash::SHA1::hash(url.to_string());
+    return encode_hex({ digest.immutable_data(), digest.data_length() });
+}
+
+RefPtr<CachedResponse> HttpCache::find(const URL& url)
+{
+    RefPtr<CachedResponse> response;
+    if (auto it = m_responses.find(url.to_string()); it != m_responses.end())
+        response = it->value;
+    else
+        response = load(url);
+
+    if (response)
+        response->m_last_used = ++m_use_counter;
+    return response;
+}
+
+// A stored response starts with the URL, the status code and the time it was received on a line each,
+// then come the headers as "Name: value" lines and an empty line, followed by the body.
+RefPtr<CachedResponse> HttpCache::load(const URL& url)
+{
+    auto file_or_error = MappedFile::map(String::formatted("{}/{}", m_directory, file_name_for(url)));
+    if (file_or_error.is_error())
+        return nullptr;
+    auto file = file_or_error.release_value();
+
+    StringView contents { (const char*)file->data(), file->size() };
+    size_t offset = 0;
+    auto next_line = [&]() -> Optional<StringView> {
+        auto line_end = contents.find('\n', offset);
+        if (!line_end.has_value())
+            return {};
+        auto line = contents.substring_view(offset, line_end.value() - offset);
+        offset = line_end.value() + 1;
+        return line;
+    };
+
+    auto stored_url = next_line();
+    if (!stored_url.has_value() || stored_url.value() != url.to_string())
+        return nullptr;
+    auto status_code_line = next_line();
+    auto response_time_line = next_line();
+    if (!status_code_line.has_value() || !response_time_line.has_value())
+        return nullptr;
+    auto status_code = status_code_line.value().to_uint();
+    auto response_time = response_time_line.value().to_uint<u64>();
+    if (!status_code.has_value() || !response_time.has_value())
+        return nullptr;
+
+    ResponseHeaders headers;
+    for (;;) {
+        auto line = next_line();
+        if (!line.has_value())
+            return nullptr;
+        if (line.value().is_empty())
+            break;
+        auto colon = line.value().find(':');
+        if (!colon.has_value())
+            return nullptr;
+        headers.set(line.value().substring_view(0, colon.value()), line.value().substring_view(colon.value() + 1).trim_whitespace());
+    }
+
+    auto response = adopt_ref(*new CachedResponse(url, status_code.value(), move(headers), response_time.value()));
+    response->m_body_offset = offset;
+    response->m_body_size = file->size() - offset;
+    response->m_file = move(file);
+    add_to_index(response);
+    return response;
+}
+
+void HttpCache::store(const URL& url, u32 status_code, ResponseHeaders headers, time_t response_time, ByteBuffer body)
+{
+    auto response = adopt_ref(*new CachedResponse(url, status_code, move(headers), response_time));
+    if (!write_to_disk(*response, body))
+        return;
+    dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Stored {} ({} bytes)", url, body.size());
+    response->m_body_size = body.size();
+    response->m_body = move(body);
+    response->m_last_used = ++m_use_counter;
+    add_to_index(response);
+}
+
+void HttpCache::refresh(CachedResponse& response, const ResponseHeaders& headers, time_t response_time)
+{
+    // A 304 response carries updated metadata for the stored one (RFC 7234, section 4.3.4), but says nothing about its body.
+    for (auto& header : headers) {
+        if (header.key.equals_ignoring_case("Content-Length") || header.key.equals_ignoring_case("Content-Encoding") || header.key.equals_ignoring_case("Transfer-Encoding"))
+            continue;
+        response.m_headers.set(header.key, header.value);
+    }
+    response.m_response_time = response_time;
+    write_to_disk(response, response.body());
+    dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Revalidated {}", response.url());
+}
+
+void HttpCache::remove(const URL& url)
+{
+    remove_from_index(url.to_string());
+
+    auto file_name = file_name_for(url);
+    if (unlink(String::formatted("{}/{}", m_directory, file_name).characters()) < 0)
+        return;
+    if (auto entry = m_disk_entries.get(file_name); entry.has_value()) {
+        m_disk_usage -= entry.value().size;
+        m_disk_entries.remove(file_name);
+    }
+}
+
+void HttpCache::add_to_index(NonnullRefPtr<CachedResponse> response)
+{
+    auto key = response->url().to_string();
+    remove_from_index(key);
+    m_memory_usage += response->m_body_size;
+    m_responses.set(key, response);
+
+    // Drop the least recently used responses (but not this one) until their bodies fit again.
+    while (m_memory_usage > max_memory_usage && m_responses.size() > 1) {
+        Optional<String> least_recently_used;
+        u64 oldest_use = NumericLimits<u64>::max();
+        for (auto& it : m_responses) {
+            if (it.value.ptr() != response.ptr() && it.value->m_last_used < oldest_use) {
+                least_recently_used = it.key;
+                oldest_use = it.value->m_last_used;
+            }
+        }
+        remove_from_index(least_recently_used.value());
+    }
+}
+
+void HttpCache::remove_from_index(const String& key)
+{
+    auto it = m_responses.find(key);
+    if (it == m_responses.end())
+        return;
+    m_memory_usage -= it->value->m_body_size;
+    m_responses.remove(it);
+}
+
+bool HttpCache::write_to_disk(CachedResponse& response, ReadonlyBytes body)
+{
+    StringBuilder builder;
+    builder.appendff("{}\n{}\n{}\n", response.url(), response.status_code(), response.m_response_time);
+    for (auto& header : response.headers())
+        builder.appendff("{}: {}\n", header.key, header.value);
+    builder.append('\n');
+    auto metadata = builder.to_byte_buffer();
+
+    // Other RequestServers read from the same directory, so never let them see a partially written file.
+    auto file_name = file_name_for(response.url());
+    auto path = String::formatted("{}/{}", m_directory, file_name);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dbgln("HttpCache: Failed to create {}: {}", temporary_path, strerror(errno));
+        return false;
+    }
+    bool success = write_all(fd, metadata) && write_all(fd, body);
+    close(fd);
+    if (!success || rename(temporary_path.characters(), path.characters()) < 0) {
+        dbgln("HttpCache: Failed to write {}: {}", path, strerror(errno));
+        unlink(temporary_path.characters());
+        return false;
+    }
+
+    if (!m_has_scanned_disk)
+        scan_disk();
+    if (auto entry = m_disk_entries.get(file_name); entry.has_value())
+        m_disk_usage -= entry.value().size;
+    auto size = metadata.size() + body.size();
+    m_disk_entries.set(file_name, { size, time(nullptr) });
+    m_disk_usage += size;
+    evict_from_disk();
+    return true;
+}
+
+void HttpCache::scan_disk()
+{
+    m_has_scanned_disk = true;
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto file_name = iterator.next_path();
+        struct stat st;
+        if (stat(String::formatted("{}/{}", m_directory, file_name).characters(), &st) < 0)
+            continue;
+        m_disk_entries.set(file_name, { (size_t)st.st_size, st.st_mtime });
+        m_disk_usage += st.st_size;
+    }
+}
+
+void HttpCache::evict_from_disk()
+{
+    if (m_disk_usage <= max_disk_usage)
+        return;
+
+    // Make room for a while, rather than deleting a file for every one we write.
+    Vector<String> file_names;
+    for (auto& it : m_disk_entries)
+        file_names.append(it.key);
+    quick_sort(file_names, [&](auto& a, auto& b) {
+        return m_disk_entries.get(a).value().modified < m_disk_entries.get(b).value().modified;
+    });
+    for (auto& file_name : file_names) {
+        if (m_disk_usage <= max_disk_usage * 3 / 4)
+            break;
+        // Responses in the index stay usable, their bodies are in memory or mapped already.
+        unlink(String::formatted("{}/{}", m_directory, file_name).characters());
+        m_disk_usage -= m_disk_entries.get(file_name).value().size;
+        m_disk_entries.remove(file_name);
+    }
+}
+
+}
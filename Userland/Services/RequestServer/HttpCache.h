@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/MappedFile.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <time.h>
+
+namespace RequestServer {
+
+using ResponseHeaders = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+// A response stored by HttpCache.
+class CachedResponse : public RefCounted<CachedResponse> {
+public:
+    const URL& url() const { return m_url; }
+    u32 status_code() const { return m_status_code; }
+    const ResponseHeaders& headers() const { return m_headers; }
+    ReadonlyBytes body() const;
+
+    // Whether the response may still be used without asking the server first (RFC 7234, section 4.2).
+    bool is_fresh() const;
+    bool has_validators() const { return m_headers.contains("ETag") || m_headers.contains("Last-Modified"); }
+
+private:
+    friend class HttpCache;
+
+    CachedResponse(URL url, u32 status_code, ResponseHeaders headers, time_t response_time)
+        : m_url(move(url))
+        , m_status_code(status_code)
+        , m_headers(move(headers))
+        , m_response_time(response_time)
+    {
+    }
+
+    time_t freshness_lifetime() const;
+    time_t current_age() const;
+
+    URL m_url;
+    u32 m_status_code { 0 };
+    ResponseHeaders m_headers;
+    time_t m_response_time { 0 };
+    // The body is either in memory or mapped from disk.
+    Optional<ByteBuffer> m_body;
+    RefPtr<MappedFile> m_file;
+    size_t m_body_offset { 0 };
+    size_t m_body_size { 0 };
+    u64 m_last_used { 0 };
+};
+
+// A private HTTP cache (RFC 7234) for GET requests, shared by every RequestServer through its on-disk store.
+// Each RequestServer keeps an index of the responses it has recently used, along with their bodies.
+class HttpCache {
+public:
+    // Follows one request through the cache: whether a stored response can answer it right away,
+    // how to revalidate a stale one, and whether the response from the network should be stored.
+    class Transaction : public RefCounted<Transaction> {
+    public:
+        // A stored response that can be used as-is, if there is one.
+        RefPtr<CachedResponse> fresh_response() const;
+        // Makes the request conditional, so the server can confirm that our stored copy is still good.
+        void add_validators(HashMap<String, String>& request_headers) const;
+
+        // Returns the stored response if the server just confirmed it, in which case its body should be used instead.
+        RefPtr<CachedResponse> did_receive_headers(u32 status_code, const ResponseHeaders&);
+        void did_receive_body_data(ReadonlyBytes);
+        void did_finish(bool success);
+
+        RefPtr<CachedResponse> revalidated_response() const { return m_revalidated ? m_stored_response : nullptr; }
+
+    private:
+        friend class HttpCache;
+        Transaction(URL url, RefPtr<CachedResponse> stored_response, bool must_revalidate)
+            : m_url(move(url))
+            , m_stored_response(move(stored_response))
+            , m_must_revalidate(must_revalidate)
+        {
+        }
+
+        URL m_url;
+        RefPtr<CachedResponse> m_stored_response;
+        bool m_must_revalidate { false };
+        bool m_revalidated { false };
+        bool m_recording { false };
+        u32 m_status_code { 0 };
+        ResponseHeaders m_headers;
+        time_t m_response_time { 0 };
+        ByteBuffer m_body;
+    };
+
+    static HttpCache& the();
+
+    const String& directory() const { return m_directory; }
+
+    // Returns null if the request has to go to the network without involving the cache.
+    RefPtr<Transaction> begin(const String& method, const URL&, const HashMap<String, String>& request_headers);
+
+private:
+    HttpCache();
+
+    struct DiskEntry {
+        size_t size { 0 };
+        time_t modified { 0 };
+    };
+
+    static bool is_storable(u32 status_code, const ResponseHeaders&);
+
+    RefPtr<CachedResponse> find(const URL&);
+    RefPtr<CachedResponse> load(const URL&);
+    void store(const URL&, u32 status_code, ResponseHeaders, time_t response_time, ByteBuffer body);
+    void refresh(CachedResponse&, const ResponseHeaders&, time_t response_time);
+    void remove(const URL&);
+
+    void add_to_index(NonnullRefPtr<CachedResponse>);
+    void remove_from_index(const String& key);
+
+    String file_name_for(const URL&) const;
+    bool write_to_disk(CachedResponse&, ReadonlyBytes body);
+    void scan_disk();
+    void evict_from_disk();
+
+    String m_directory;
+    HashMap<String, NonnullRefPtr<CachedResponse>> m_responses;
+    HashMap<String, DiskEntry> m_disk_entries;
+    bool m_has_scanned_disk { false };
+    size_t m_disk_usage { 0 };
+    size_t m_memory_usage { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
@@ -14,21 +15,44 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
+#include <RequestServer/ResponseBodyStream.h>
 
 namespace RequestServer::Detail {
 
 template<typename TSelf, typename TJob>
-void init(TSelf* self, TJob job)
+void init(TSelf* self, TJob job, RefPtr<HttpCache::Transaction> cache_transaction)
 {
-    job->on_headers_received = [self](auto& headers, auto response_code) {
+    job->on_headers_received = [self, cache_transaction](auto& headers, auto response_code) mutable {
+        if (cache_transaction && response_code.has_value()) {
+            if (auto cached_response = cache_transaction->did_receive_headers(response_code.value(), headers)) {
+                // The server confirmed that our stored copy is still good, so pass that on instead.
+                self->set_status_code(cached_response->status_code());
+                self->set_response_headers(cached_response->headers());
+                return;
+            }
+        }
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
-    job->on_finish = [self](bool success) {
+    if (cache_transaction) {
+        job->on_body_data = [cache_transaction](auto bytes) mutable {
+            cache_transaction->did_receive_body_data(bytes);
+        };
+    }
+
+    job->on_finish = [self, cache_transaction](bool success) mutable {
+        if (cache_transaction) {
+            if (auto cached_response = cache_transaction->revalidated_response(); cached_response && success)
+                return self->send_cached_body(cached_response.release_nonnull());
+            cache_transaction->did_finish(success && !self->job().body_was_cut_short());
+        }
+
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -52,15 +76,14 @@ void init(TSelf* self, TJob job)
     }
 }
 
-template<typename TBadgedProtocol, typename TPipeResult>
-OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ClientConnection& client, const String& method, const URL& url, const HashMap<String, String>& headers, ReadonlyBytes body, TPipeResult&& pipe_result)
+template<typename TBadgedProtocol>
+OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ClientConnection& client, const String& method, const URL& url, const HashMap<String, String>& headers, ReadonlyBytes body, OwnPtr<ResponseBodyStream> output_stream, Function<void(typename TBadgedProtocol::Type::JobType&)> start_job = nullptr)
 {
     using TJob = typename TBadgedProtocol::Type::JobType;
     using TRequest = typename TBadgedProtocol::Type::RequestType;
 
-    if (pipe_result.is_error()) {
+    if (!output_stream)
         return {};
-    }
 
     HTTP::HttpRequest request;
     if (method.equals_ignoring_case("post"))
@@ -68,15 +91,26 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ClientConnection& clie
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+
+    auto cache_transaction = HttpCache::the().begin(method, url, headers);
+    auto request_headers = headers;
+    if (cache_transaction) {
+        if (auto cached_response = cache_transaction->fresh_response()) {
+            return CachedRequest::create(client, cached_response.release_nonnull(), output_stream.release_nonnull());
+        }
+        cache_transaction->add_validators(request_headers);
+    }
+    request.set_headers(request_headers);
     request.set_body(body);
+    request.set_keep_alive(true);
 
-    auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
-    output_stream->make_unbuffered();
     auto job = TJob::construct(request, *output_stream);
-    auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
-    protocol_request->set_request_fd(pipe_result.value().read_fd);
-    job->start();
+    auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, output_stream.release_nonnull());
+    init(protocol_request.ptr(), job, move(cache_transaction));
+    if (start_job)
+        start_job(*job);
+    else
+        job->start();
     return protocol_request;
 }
 
@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <LibHTTP/HttpJob.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/ConnectionPool.h>
 #include <RequestServer/HttpRequest.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
@@ -28,6 +29,9 @@ public:
     ~HttpProtocol() override = default;
 
     virtual OwnPtr<Request> start_request(ClientConnection&, const String& method, const URL&, const HashMap<String, String>& headers, ReadonlyBytes body) override;
+
+private:
+    ConnectionPool<HTTP::HttpJob, Core::Socket> m_connection_pool;
 };
 
 }
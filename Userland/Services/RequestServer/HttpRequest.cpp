@@ -5,17 +5,15 @@
  */
 
 #include <LibHTTP/HttpJob.h>
-#include <RequestServer/HttpCommon.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpRequest.h>
 
 namespace RequestServer {
 
-HttpRequest::HttpRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+HttpRequest::HttpRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
     : Request(client, move(output_stream))
     , m_job(job)
 {
-    Detail::init(this, job);
 }
 
 HttpRequest::~HttpRequest()
@@ -25,7 +23,7 @@ HttpRequest::~HttpRequest()
     m_job->shutdown();
 }
 
-NonnullOwnPtr<HttpRequest> HttpRequest::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+NonnullOwnPtr<HttpRequest> HttpRequest::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
 {
     return adopt_own(*new HttpRequest(client, move(job), move(output_stream)));
 }
@@ -21,12 +21,16 @@ namespace RequestServer {
 
 HttpsProtocol::HttpsProtocol()
     : Protocol("https")
+    , m_session_cache(TLS::SessionCache::create())
 {
 }
 
 OwnPtr<Request> HttpsProtocol::start_request(ClientConnection& client, const String& method, const URL& url, const HashMap<String, String>& headers, ReadonlyBytes body)
 {
-    return Detail::start_request(Badge<HttpsProtocol> {}, client, method, url, headers, body, get_pipe_for_request());
+    return Detail::start_request(Badge<HttpsProtocol> {}, client, method, url, headers, body, create_response_body_stream(), [this](auto& job) {
+        job.set_session_cache(m_session_cache);
+        m_connection_pool.start_job(job);
+    });
 }
 
 }
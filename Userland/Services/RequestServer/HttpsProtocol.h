@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <LibHTTP/HttpsJob.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/ConnectionPool.h>
 #include <RequestServer/HttpsRequest.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
@@ -28,6 +29,11 @@ public:
     ~HttpsProtocol() override = default;
 
     virtual OwnPtr<Request> start_request(ClientConnection&, const String& method, const URL&, const HashMap<String, String>& headers, ReadonlyBytes body) override;
+
+private:
+    // Shared by every connection this RequestServer makes, so reconnects resume their TLS session.
+    NonnullRefPtr<TLS::SessionCache> m_session_cache;
+    ConnectionPool<HTTP::HttpsJob, TLS::TLSv12> m_connection_pool;
 };
 
 }
@@ -5,17 +5,15 @@
  */
 
 #include <LibHTTP/HttpsJob.h>
-#include <RequestServer/HttpCommon.h>
 #include <RequestServer/HttpsProtocol.h>
 #include <RequestServer/HttpsRequest.h>
 
 namespace RequestServer {
 
-HttpsRequest::HttpsRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+HttpsRequest::HttpsRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
     : Request(client, move(output_stream))
     , m_job(job)
 {
-    Detail::init(this, job);
 }
 
 void HttpsRequest::set_certificate(String certificate, String key)
@@ -30,7 +28,7 @@ HttpsRequest::~HttpsRequest()
     m_job->shutdown();
 }
 
-NonnullOwnPtr<HttpsRequest> HttpsRequest::create_with_job(Badge<HttpsProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+NonnullOwnPtr<HttpsRequest> HttpsRequest::create_with_job(Badge<HttpsProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
 {
     return adopt_own(*new HttpsRequest(client, move(job), move(output_stream)));
 }
@@ -6,10 +6,7 @@
 
 #include <AK/HashMap.h>
 #include <RequestServer/Protocol.h>
-#include <errno.h>
-#include <fcntl.h>
-#include <string.h>
-#include <unistd.h>
+#include <RequestServer/ResponseBodyStream.h>
 
 namespace RequestServer {
 
@@ -34,16 +31,9 @@ Protocol::~Protocol()
     VERIFY_NOT_REACHED();
 }
 
-Result<Protocol::Pipe, String> Protocol::get_pipe_for_request()
+OwnPtr<ResponseBodyStream> Protocol::create_response_body_stream()
 {
-    int fd_pair[2] { 0 };
-    if (pipe(fd_pair) != 0) {
-        auto saved_errno = errno;
-        dbgln("Protocol: pipe() failed: {}", strerror(saved_errno));
-        return String { strerror(saved_errno) };
-    }
-    fcntl(fd_pair[1], F_SETFL, fcntl(fd_pair[1], F_GETFL) | O_NONBLOCK);
-    return Pipe { fd_pair[0], fd_pair[1] };
+    return ResponseBodyStream::create();
 }
 
 }
@@ -5,7 +5,9 @@
  */
 
 #include <AK/Badge.h>
+#include <LibCore/Timer.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer {
@@ -13,7 +15,7 @@ namespace RequestServer {
 // FIXME: What about rollover?
 static i32 s_next_id = 1;
 
-Request::Request(ClientConnection& client, NonnullOwnPtr<OutputFileStream>&& output_stream)
+Request::Request(ClientConnection& client, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
     : m_client(client)
     , m_id(s_next_id++)
     , m_output_stream(move(output_stream))
@@ -51,6 +53,33 @@ void Request::did_progress(Optional<u32> total_size, u32 downloaded_size)
     m_client.did_progress_request({}, *this);
 }
 
+void Request::send_cached_body(NonnullRefPtr<CachedResponse> response)
+{
+    m_cached_response = move(response);
+    m_cached_body_offset = 0;
+    write_cached_body();
+}
+
+void Request::write_cached_body()
+{
+    auto body = m_cached_response->body();
+    while (m_cached_body_offset < body.size()) {
+        auto nwritten = m_output_stream->write(body.slice(m_cached_body_offset));
+        if (nwritten == 0) {
+            // The ring buffer is full, try again once the client has had a chance to read from it.
+            if (!m_cached_body_timer)
+                m_cached_body_timer = Core::Timer::create_single_shot(50, [this] { write_cached_body(); });
+            m_cached_body_timer->start();
+            return;
+        }
+        m_cached_body_offset += nwritten;
+    }
+
+    set_downloaded_size(body.size());
+    did_progress(body.size(), body.size());
+    did_finish(true);
+}
+
 void Request::did_request_certificates()
 {
     m_client.did_request_certificates({}, *this);
@@ -6,13 +6,14 @@
 
 #pragma once
 
-#include <AK/FileStream.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <LibCore/Forward.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/ResponseBodyStream.h>
 
 namespace RequestServer {
 
@@ -31,9 +32,9 @@ public:
     void stop();
     virtual void set_certificate(String, String);
 
-    // FIXME: Want Badge<Protocol>, but can't make one from HttpProtocol, etc.
-    void set_request_fd(int fd) { m_request_fd = fd; }
-    int request_fd() const { return m_request_fd; }
+    // Where the client finds the response body.
+    int request_fd() const { return m_output_stream->client_fd(); }
+    const Core::AnonymousBuffer& response_body_buffer() const { return m_output_stream->shared_buffer(); }
 
     void did_finish(bool success);
     void did_progress(Optional<u32> total_size, u32 downloaded_size);
@@ -41,21 +42,28 @@ public:
     void did_request_certificates();
     void set_response_headers(const HashMap<String, String, CaseInsensitiveStringTraits>&);
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
-    const OutputFileStream& output_stream() const { return *m_output_stream; }
+    const ResponseBodyStream& output_stream() const { return *m_output_stream; }
+
+    // Sends the body of a response from the HTTP cache instead of one from the network, then finishes the request.
+    void send_cached_body(NonnullRefPtr<CachedResponse>);
 
 protected:
-    explicit Request(ClientConnection&, NonnullOwnPtr<OutputFileStream>&&);
+    explicit Request(ClientConnection&, NonnullOwnPtr<ResponseBodyStream>&&);
 
 private:
+    void write_cached_body();
+
     ClientConnection& m_client;
     i32 m_id { 0 };
-    int m_request_fd { -1 }; // Passed to client.
     URL m_url;
     Optional<u32> m_status_code;
     Optional<u32> m_total_size {};
     size_t m_downloaded_size { 0 };
-    NonnullOwnPtr<OutputFileStream> m_output_stream;
+    NonnullOwnPtr<ResponseBodyStream> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+    RefPtr<CachedResponse> m_cached_response;
+    size_t m_cached_body_offset { 0 };
+    RefPtr<Core::Timer> m_cached_body_timer;
 };
 
 }
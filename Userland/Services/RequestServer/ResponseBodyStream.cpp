@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <RequestServer/ResponseBodyStream.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+OwnPtr<ResponseBodyStream> ResponseBodyStream::create()
+{
+    auto ring_buffer = Core::SharedRingBuffer::create(Capacity);
+    if (!ring_buffer.has_value()) {
+        dbgln("ResponseBodyStream: Failed to create ring buffer");
+        return {};
+    }
+    int fd_pair[2] { 0 };
+    if (pipe(fd_pair) != 0) {
+        dbgln("ResponseBodyStream: pipe() failed: {}", strerror(errno));
+        return {};
+    }
+    // A full pipe already has the client's attention.
+    fcntl(fd_pair[1], F_SETFL, fcntl(fd_pair[1], F_GETFL) | O_NONBLOCK);
+    return adopt_own(*new ResponseBodyStream(ring_buffer.release_value(), fd_pair[0], fd_pair[1]));
+}
+
+ResponseBodyStream::ResponseBodyStream(Core::SharedRingBuffer ring_buffer, int client_fd, int wakeup_fd)
+    : m_ring_buffer(move(ring_buffer))
+    , m_client_fd(client_fd)
+    , m_wakeup_fd(wakeup_fd)
+{
+}
+
+ResponseBodyStream::~ResponseBodyStream()
+{
+    close(m_wakeup_fd);
+}
+
+size_t ResponseBodyStream::write(ReadonlyBytes bytes)
+{
+    auto nwritten = m_ring_buffer.write(bytes);
+    m_size += nwritten;
+    if (nwritten > 0 && m_ring_buffer.should_wake_reader()) {
+        u8 wakeup = 0;
+        [[maybe_unused]] auto rc = ::write(m_wakeup_fd, &wakeup, sizeof(wakeup));
+    }
+    return nwritten;
+}
+
+bool ResponseBodyStream::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_recoverable_error();
+        return false;
+    }
+    return true;
+}
+
+}
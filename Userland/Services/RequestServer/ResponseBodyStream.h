@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Stream.h>
+#include <LibCore/SharedRingBuffer.h>
+
+namespace RequestServer {
+
+// Where a response body goes on its way to the client: Into a ring buffer that the client maps as well, so
+// the bytes only get copied once. Next to it is a pipe, on which the client sleeps while the buffer is empty,
+// and which tells it that the body is complete by being closed.
+class ResponseBodyStream final : public OutputStream {
+public:
+    static constexpr size_t Capacity = 256 * KiB;
+
+    static OwnPtr<ResponseBodyStream> create();
+    virtual ~ResponseBodyStream() override;
+
+    // Both of these are meant to be sent to the client.
+    int client_fd() const { return m_client_fd; }
+    const Core::AnonymousBuffer& shared_buffer() const { return m_ring_buffer.anonymous_buffer(); }
+
+    // How much has been written so far.
+    size_t size() const { return m_size; }
+
+    // Writes as much as the client has made room for.
+    virtual size_t write(ReadonlyBytes) override;
+    virtual bool write_or_error(ReadonlyBytes) override;
+
+private:
+    ResponseBodyStream(Core::SharedRingBuffer, int client_fd, int wakeup_fd);
+
+    Core::SharedRingBuffer m_ring_buffer;
+    int m_client_fd { -1 };
+    int m_wakeup_fd { -1 };
+    size_t m_size { 0 };
+};
+
+}
@@ -10,12 +10,13 @@
 #include <LibTLS/Certificate.h>
 #include <RequestServer/ClientConnection.h>
 #include <RequestServer/GeminiProtocol.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpsProtocol.h>
 
 int main(int, char**)
 {
-    if (pledge("stdio inet accept unix rpath sendfd recvfd", nullptr) < 0) {
+    if (pledge("stdio inet accept unix rpath wpath cpath sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -23,9 +24,12 @@ int main(int, char**)
     // Ensure the certificates are read out here.
     [[maybe_unused]] auto& certs = DefaultRootCACertificates::the();
 
+    // This finds (and creates) the cache directory.
+    auto& cache = RequestServer::HttpCache::the();
+
     Core::EventLoop event_loop;
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
-    if (pledge("stdio inet accept unix sendfd recvfd", nullptr) < 0) {
+    if (pledge("stdio inet accept unix rpath wpath cpath sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -33,6 +37,10 @@ int main(int, char**)
         perror("unveil");
         return 1;
     }
+    if (unveil(cache.directory().characters(), "rwc") < 0) {
+        perror("unveil");
+        return 1;
+    }
     if (unveil(nullptr, nullptr) < 0) {
         perror("unveil");
         return 1;
@@ -55,6 +55,18 @@ void ClientConnection::disconnect(int connection_id)
         dbgln("Database connection has disappeared");
 }
 
+Messages::SQLServer::StatisticsResponse ClientConnection::statistics(int connection_id)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ClientConnection::statistics(connection_id: {})", connection_id);
+    auto database_connection = DatabaseConnection::connection_for(connection_id);
+    if (!database_connection || !database_connection->database()) {
+        dbgln("Database connection has disappeared");
+        return { 0, 0, 0, 0, 0, 0 };
+    }
+    auto& heap = database_connection->database()->heap();
+    return { heap.blocks_read(), heap.blocks_written(), heap.cache_hits(), heap.cache_misses(), heap.commits(), heap.wal_bytes_written() };
+}
+
 Messages::SQLServer::SqlStatementResponse ClientConnection::sql_statement(int connection_id, String const& sql)
 {
     dbgln_if(SQLSERVER_DEBUG, "ClientConnection::sql_statement(connection_id: {}, sql: '{}')", connection_id, sql);
@@ -69,12 +81,12 @@ Messages::SQLServer::SqlStatementResponse ClientConnection::sql_statement(int co
     }
 }
 
-void ClientConnection::statement_execute(int statement_id)
+void ClientConnection::statement_execute(int statement_id, Vector<String> const& placeholder_values)
 {
     dbgln_if(SQLSERVER_DEBUG, "ClientConnection::statement_execute_query(statement_id: {})", statement_id);
     auto statement = SQLStatement::statement_for(statement_id);
     if (statement && statement->connection()->client_id() == client_id()) {
-        statement->execute();
+        statement->execute(placeholder_values);
     } else {
         dbgln_if(SQLSERVER_DEBUG, "Statement has disappeared");
         async_execution_error(statement_id, (int)SQL::SQLErrorCode::StatementUnavailable, String::formatted("{}", statement_id));
@@ -28,8 +28,9 @@ public:
 private:
     virtual Messages::SQLServer::ConnectResponse connect(String const&) override;
     virtual Messages::SQLServer::SqlStatementResponse sql_statement(int, String const&) override;
-    virtual void statement_execute(int) override;
+    virtual void statement_execute(int, Vector<String> const&) override;
     virtual void disconnect(int) override;
+    virtual Messages::SQLServer::StatisticsResponse statistics(int) override;
 };
 
 }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <LibCore/Timer.h>
 #include <SQLServer/ClientConnection.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
@@ -23,6 +24,27 @@ RefPtr<DatabaseConnection> DatabaseConnection::connection_for(int connection_id)
 
 static int s_next_connection_id = 0;
 
+// Connections to the same database share it, so that their statements can be committed together.
+static HashMap<String, WeakPtr<SQL::Database>> s_databases;
+static HashMap<String, Vector<Function<void()>>> s_pending_commits;
+static constexpr int checkpoint_interval_ms = 5000;
+
+static NonnullRefPtr<SQL::Database> open_database(String const& database_name)
+{
+    if (auto database = s_databases.get(database_name); database.has_value() && database.value())
+        return *database.value();
+
+    auto database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", database_name));
+    s_databases.set(database_name, database->make_weak_ptr<SQL::Database>());
+    // Copying the write-ahead log into the database file then mostly happens in between statements,
+    // rather than while committing one.
+    auto& database_ref = *database;
+    auto timer = Core::Timer::create_repeating(
+        checkpoint_interval_ms, [&database_ref] { database_ref.checkpoint(); }, database);
+    timer->start();
+    return database;
+}
+
 DatabaseConnection::DatabaseConnection(String database_name, int client_id)
     : Object()
     , m_database_name(move(database_name))
@@ -39,7 +61,7 @@ DatabaseConnection::DatabaseConnection(String database_name, int client_id)
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection {} initiating connection with database '{}'", connection_id(), m_database_name);
     s_connections.set(m_connection_id, *this);
     deferred_invoke([&](Object&) {
-        m_database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", m_database_name));
+        m_database = open_database(m_database_name);
         m_accept_statements = true;
         auto client_connection = ClientConnection::client_connection_for(client_id);
         if (client_connection)
@@ -54,6 +76,11 @@ void DatabaseConnection::disconnect()
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection::disconnect(connection_id {}, database '{}'", connection_id(), m_database_name);
     m_accept_statements = false;
     deferred_invoke([&](Object&) {
+        if (m_database) {
+            auto& heap = m_database->heap();
+            dbgln_if(SQLSERVER_DEBUG, "Database '{}' page cache: {} hits, {} misses, {} pages cached", m_database_name, heap.cache_hits(), heap.cache_misses(), heap.cached_pages());
+            dbgln_if(SQLSERVER_DEBUG, "Database '{}' storage: {} blocks read, {} blocks written, {} commits, {} WAL bytes, {} checkpoints", m_database_name, heap.blocks_read(), heap.blocks_written(), heap.commits(), heap.wal_bytes_written(), heap.checkpoints());
+        }
         m_database = nullptr;
         s_connections.remove(m_connection_id);
         auto client_connection = ClientConnection::client_connection_for(client_id());
@@ -64,6 +91,27 @@ void DatabaseConnection::disconnect()
     });
 }
 
+void DatabaseConnection::commit_and_then(Function<void()> on_commit)
+{
+    auto& pending_commit = s_pending_commits.ensure(m_database_name);
+    pending_commit.append(move(on_commit));
+    if (pending_commit.size() > 1)
+        return;
+
+    // Everything executed on any connection to the database before the event loop gets to this shares
+    // one commit, and with that one fsync.
+    m_database->deferred_invoke([database = NonnullRefPtr(*m_database), database_name = m_database_name](auto&) mutable {
+        auto pending_commit = s_pending_commits.find(database_name);
+        VERIFY(pending_commit != s_pending_commits.end());
+        auto callbacks = move(pending_commit->value);
+        s_pending_commits.remove(database_name);
+
+        database->commit();
+        for (auto& callback : callbacks)
+            callback();
+    });
+}
+
 int DatabaseConnection::sql_statement(String const& sql)
 {
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection::sql_statement(connection_id {}, database '{}', sql '{}'", connection_id(), m_database_name, sql);
@@ -21,6 +21,10 @@ class DatabaseConnection final : public Core::Object {
     int client_id() const { return m_client_id; }
     RefPtr<SQL::Database> database() { return m_database; }
     void disconnect();
+
+    // Commits the statements executed so far, together with those of other connections to the same
+    // database, and calls on_commit once that's done.
+    void commit_and_then(Function<void()> on_commit);
     int sql_statement(String const& sql);
 
 private:
@@ -51,46 +51,85 @@ void SQLStatement::report_error(SQL::SQLError error)
     m_result = nullptr;
 }
 
-void SQLStatement::execute()
+void SQLStatement::execute(Vector<String> placeholder_values)
 {
-    dbgln_if(SQLSERVER_DEBUG, "SQLStatement::execute(statement_id {}", statement_id());
+    dbgln_if(SQLSERVER_DEBUG, "SQLStatement::execute(statement_id {}, {} placeholder values)", statement_id(), placeholder_values.size());
     auto client_connection = ClientConnection::client_connection_for(connection()->client_id());
     if (!client_connection) {
         warnln("Cannot yield next result. Client disconnected");
         return;
     }
 
-    deferred_invoke([&](Object&) {
-        auto maybe_error = parse();
-        if (maybe_error.has_value()) {
-            report_error(maybe_error.value());
+    deferred_invoke([&, placeholder_values = move(placeholder_values)](Object&) mutable {
+        if (!m_statement) {
+            auto maybe_error = parse();
+            if (maybe_error.has_value()) {
+                report_error(maybe_error.value());
+                return;
+            }
+        }
+        if (placeholder_values.size() != m_placeholders) {
+            report_error({ SQL::SQLErrorCode::InvalidNumberOfPlaceholderValues, String::number(m_placeholders) });
             return;
         }
+        // FIXME: Bind the values to the placeholders once statements with expressions are executed.
+        m_placeholder_values = move(placeholder_values);
         m_result = m_statement->execute(*connection()->database());
         if (m_result->error().code != SQL::SQLErrorCode::NoError) {
             report_error(m_result->error());
             return;
         }
-        auto client_connection = ClientConnection::client_connection_for(connection()->client_id());
-        if (!client_connection) {
-            warnln("Cannot return statement execution results. Client disconnected");
-            return;
-        }
-        client_connection->async_execution_success(statement_id(), m_result->has_results(), m_result->updated(), m_result->inserted(), m_result->deleted());
-        if (m_result->has_results()) {
-            m_index = 0;
-            next();
-        }
+        connection()->commit_and_then([this, protector = NonnullRefPtr(*this)]() {
+            if (!connection())
+                return;
+            auto client_connection = ClientConnection::client_connection_for(connection()->client_id());
+            if (!client_connection) {
+                warnln("Cannot return statement execution results. Client disconnected");
+                return;
+            }
+            client_connection->async_execution_success(statement_id(), m_result->has_results(), m_result->updated(), m_result->inserted(), m_result->deleted());
+            if (m_result->has_results()) {
+                m_index = 0;
+                next();
+            }
+        });
     });
 }
 
+struct ParsedStatement {
+    NonnullRefPtr<SQL::AST::Statement> statement;
+    size_t placeholders { 0 };
+    u64 last_use { 0 };
+};
+
+static HashMap<String, ParsedStatement> s_parsed_statements;
+static u64 s_parse_clock = 0;
+
 Optional<SQL::SQLError> SQLStatement::parse()
 {
+    if (auto parsed = s_parsed_statements.find(m_sql); parsed != s_parsed_statements.end()) {
+        parsed->value.last_use = ++s_parse_clock;
+        m_statement = parsed->value.statement;
+        m_placeholders = parsed->value.placeholders;
+        return {};
+    }
+
     auto parser = SQL::AST::Parser(SQL::AST::Lexer(m_sql));
     m_statement = parser.next_statement();
     if (parser.has_errors()) {
         return SQL::SQLError { SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_string() };
     }
+    m_placeholders = parser.placeholders_in_last_statement();
+
+    if (s_parsed_statements.size() >= parsed_statement_cache_size) {
+        auto least_recently_used = s_parsed_statements.begin();
+        for (auto it = s_parsed_statements.begin(); it != s_parsed_statements.end(); ++it) {
+            if (it->value.last_use < least_recently_used->value.last_use)
+                least_recently_used = it;
+        }
+        s_parsed_statements.remove(least_recently_used);
+    }
+    s_parsed_statements.set(m_sql, { *m_statement, m_placeholders, ++s_parse_clock });
     return {};
 }
 
@@ -102,15 +141,20 @@ void SQLStatement::next()
         warnln("Cannot yield next result. Client disconnected");
         return;
     }
-    if (m_index < m_result->results().size()) {
-        auto& tuple = m_result->results()[m_index++];
-        client_connection->async_next_result(statement_id(), tuple.to_string_vector());
-        deferred_invoke([&](Object&) {
-            next();
-        });
-    } else {
-        client_connection->async_results_exhausted(statement_id(), (int)m_index);
+    // Results go out as they are produced, a batch per turn of the event loop, so the client gets the
+    // first ones without waiting for the whole result, and other connections aren't kept waiting either.
+    for (size_t ix = 0; ix < results_batch_size; ix++) {
+        auto tuple = m_result->next_result();
+        if (!tuple.has_value()) {
+            client_connection->async_results_exhausted(statement_id(), (int)m_index);
+            return;
+        }
+        m_index++;
+        client_connection->async_next_result(statement_id(), tuple->to_string_vector());
     }
+    deferred_invoke([&](Object&) {
+        next();
+    });
 }
 
 }
@@ -24,7 +24,15 @@ class SQLStatement final : public Core::Object {
     int statement_id() const { return m_statement_id; }
     String const& sql() const { return m_sql; }
     DatabaseConnection* connection() { return dynamic_cast<DatabaseConnection*>(parent()); }
-    void execute();
+    void execute(Vector<String> placeholder_values = {});
+
+    static constexpr size_t results_batch_size = 64;
+
+    // Statements are parsed once, when they are first executed. Parsed statements are also kept by
+    // their text, for the parsed_statement_cache_size texts used most recently, so that a client
+    // preparing the same statement again, like an importer running the same INSERT for every row,
+    // doesn't get it parsed again either.
+    static constexpr size_t parsed_statement_cache_size = 64;
 
 private:
     SQLStatement(DatabaseConnection&, String sql);
@@ -36,6 +44,8 @@ private:
     String m_sql;
     size_t m_index { 0 };
     RefPtr<SQL::AST::Statement> m_statement { nullptr };
+    size_t m_placeholders { 0 };
+    Vector<String> m_placeholder_values;
     RefPtr<SQL::SQLResult> m_result { nullptr };
 };
 
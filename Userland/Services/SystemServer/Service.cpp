@@ -122,14 +122,61 @@ void Service::handle_socket_connection()
     }
 }
 
+void Service::resolve_dependencies(const HashMap<String, Service*>& enabled_services)
+{
+    for (auto& name : m_after) {
+        if (auto service = enabled_services.get(name); service.has_value())
+            m_dependencies.append({ service.value(), false });
+    }
+    for (auto& name : m_requires) {
+        auto service = enabled_services.get(name);
+        if (!service.has_value()) {
+            dbgln("Not starting {}, as it requires {}, which isn't enabled", this->name(), name);
+            m_has_failed = true;
+            return;
+        }
+        m_dependencies.append({ service.value(), true });
+    }
+}
+
+bool Service::activate_if_ready()
+{
+    if (m_was_activated || m_has_failed)
+        return false;
+
+    for (auto& dependency : m_dependencies) {
+        if (dependency.service->has_failed()) {
+            if (!dependency.is_required)
+                continue;
+            dbgln("Not starting {}, as {} has failed", name(), dependency.service->name());
+            m_has_failed = true;
+            return true;
+        }
+        if (!dependency.service->has_started())
+            return false;
+    }
+
+    activate();
+    return true;
+}
+
 void Service::activate()
 {
     VERIFY(m_pid < 0);
 
+    if (!m_was_activated) {
+        extern Core::ElapsedTimer g_boot_timer;
+        dbgln("Starting {} after {} ms", name(), g_boot_timer.elapsed());
+        m_was_activated = true;
+    }
+
     if (m_lazy)
         setup_notifier();
     else
         spawn();
+
+    if (!m_one_shot)
+        m_has_started = true;
 }
 
 void Service::spawn(int socket_fd)
@@ -142,6 +189,8 @@ void Service::spawn(int socket_fd)
     if (pid < 0) {
         perror("fork");
         dbgln("Failed to spawn {}. Sucks, dude :(", name());
+        if (m_one_shot)
+            m_has_failed = true;
     } else if (pid == 0) {
         // We are the child.
 
@@ -254,6 +303,16 @@ void Service::did_exit(int exit_code)
     s_service_map.remove(m_pid);
     m_pid = -1;
 
+    if (m_one_shot && !m_has_started && !m_has_failed) {
+        dbgln("Service {} has finished after {} ms", name(), m_run_timer.elapsed());
+        if (exit_code == 0)
+            m_has_started = true;
+        else
+            m_has_failed = true;
+        if (on_finish)
+            on_finish();
+    }
+
     if (!m_keep_alive)
         return;
 
@@ -315,6 +374,9 @@ Service::Service(const Core::ConfigFile& config, const StringView& name)
     m_boot_modes = config.read_entry(name, "BootModes", "graphical").split(',');
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
+    m_one_shot = config.read_bool_entry(name, "OneShot");
+    m_after = config.read_entry(name, "After").split(',');
+    m_requires = config.read_entry(name, "Requires").split(',');
 
     String socket_entry = config.read_entry(name, "Socket");
     String socket_permissions_entry = config.read_entry(name, "SocketPermissions", "0600");
@@ -346,6 +408,8 @@ Service::Service(const Core::ConfigFile& config, const StringView& name)
     VERIFY(!m_accept_socket_connections || (m_sockets.size() == 1 && m_lazy && m_multi_instance));
     // MultiInstance doesn't work with KeepAlive.
     VERIFY(!m_multi_instance || !m_keep_alive);
+    // OneShot services get spawned once, right away.
+    VERIFY(!m_one_shot || (!m_lazy && !m_multi_instance && !m_keep_alive));
 
     if (is_enabled())
         setup_sockets();
@@ -391,6 +455,7 @@ void Service::save_to(JsonObject& json)
     json.set("user", m_user);
     json.set("multi_instance", m_multi_instance);
     json.set("accept_socket_connections", m_accept_socket_connections);
+    json.set("one_shot", m_one_shot);
 
     if (m_pid > 0)
         json.set("pid", m_pid);
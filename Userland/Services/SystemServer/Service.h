@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <LibCore/Account.h>
@@ -21,6 +23,27 @@ public:
     void activate();
     void did_exit(int exit_code);
 
+    // Looks up the services named in After and Requires among the enabled ones.
+    void resolve_dependencies(const HashMap<String, Service*>& enabled_services);
+    void clear_dependencies() { m_dependencies.clear(); }
+    template<typename Callback>
+    void for_each_dependency(Callback callback) const
+    {
+        for (auto& dependency : m_dependencies)
+            callback(*dependency.service);
+    }
+
+    // Activates the service once the ones it comes after have started, or gives up on it if one it requires has
+    // failed. Returns whether either of those happened.
+    bool activate_if_ready();
+    // Whether the services that come after this one can go ahead. One-shot services only count as started once
+    // they've exited successfully.
+    bool has_started() const { return m_has_started; }
+    bool has_failed() const { return m_has_failed; }
+
+    // Called once a one-shot service has exited, which may let the services after it start.
+    Function<void()> on_finish;
+
     static Service* find_by_pid(pid_t);
 
     // FIXME: Port to Core::Property
@@ -69,6 +92,21 @@ private:
     Vector<String> m_environment;
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
+    // Services that have to start before this one, if they're enabled.
+    Vector<String> m_after;
+    // Services that have to start before this one, without which this one doesn't start at all.
+    Vector<String> m_requires;
+    // Whether this service does its job and exits, rather than running until it's shut down.
+    bool m_one_shot { false };
+
+    struct Dependency {
+        Service* service { nullptr };
+        bool is_required { false };
+    };
+    Vector<Dependency> m_dependencies;
+    bool m_was_activated { false };
+    bool m_has_started { false };
+    bool m_has_failed { false };
 
     // The resolved user account to run this service as.
     Optional<Core::Account> m_account;
@@ -8,7 +8,10 @@
 #include <AK/Assertions.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <LibCore/ConfigFile.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
@@ -22,6 +25,7 @@
 #include <unistd.h>
 
 String g_boot_mode = "graphical";
+Core::ElapsedTimer g_boot_timer;
 
 static void sigchld_handler(int)
 {
@@ -181,8 +185,52 @@ static void create_tmp_coredump_directory()
     umask(old_umask);
 }
 
+static void break_dependency_cycles(NonnullRefPtrVector<Service>& services)
+{
+    // Whatever is left over once everything that could ever start has been taken away waits on a cycle.
+    HashTable<Service*> can_start;
+    bool made_progress = true;
+    while (made_progress) {
+        made_progress = false;
+        for (auto& service : services) {
+            if (can_start.contains(&service))
+                continue;
+            bool dependencies_can_start = true;
+            service.for_each_dependency([&](Service& dependency) {
+                if (!can_start.contains(&dependency))
+                    dependencies_can_start = false;
+            });
+            if (dependencies_can_start) {
+                can_start.set(&service);
+                made_progress = true;
+            }
+        }
+    }
+
+    for (auto& service : services) {
+        if (can_start.contains(&service))
+            continue;
+        dbgln("Service {} waits on a dependency cycle, starting it right away instead", service.name());
+        service.clear_dependencies();
+    }
+}
+
+static void activate_ready_services(NonnullRefPtrVector<Service>& services)
+{
+    // Starting one service can let the ones after it start too, so keep going until nothing changes.
+    bool made_progress = true;
+    while (made_progress) {
+        made_progress = false;
+        for (auto& service : services) {
+            if (service.activate_if_ready())
+                made_progress = true;
+        }
+    }
+}
+
 int main(int, char**)
 {
+    g_boot_timer.start();
     prepare_devfs();
 
     if (pledge("stdio proc exec tty accept unix rpath wpath cpath chown fattr id sigaction", nullptr) < 0) {
@@ -208,10 +256,20 @@ int main(int, char**)
             services.append(service);
     }
 
-    // After we've set them all up, activate them!
-    dbgln("Activating {} services...", services.size());
+    HashMap<String, Service*> services_by_name;
     for (auto& service : services)
-        service.activate();
+        services_by_name.set(service.name(), &service);
+    for (auto& service : services) {
+        service.resolve_dependencies(services_by_name);
+        service.on_finish = [&services] {
+            activate_ready_services(services);
+        };
+    }
+    break_dependency_cycles(services);
+
+    // After we've set them all up, activate them! Those that come after others get activated once those have started.
+    dbgln("Activating {} services...", services.size());
+    activate_ready_services(services);
 
     return event_loop.exec();
 }
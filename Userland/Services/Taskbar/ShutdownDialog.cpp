@@ -9,6 +9,7 @@
 #include <AK/Vector.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
+#include <LibGUI/IconCache.h>
 #include <LibGUI/ImageWidget.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/RadioButton.h>
@@ -63,7 +64,7 @@ ShutdownDialog::ShutdownDialog()
     icon_wrapper.set_layout<GUI::VerticalBoxLayout>();
 
     auto& icon_image = icon_wrapper.add<GUI::ImageWidget>();
-    icon_image.set_bitmap(Gfx::Bitmap::try_load_from_file("/res/icons/32x32/shutdown.png"));
+    icon_image.set_bitmap(GUI::IconCache::load_bitmap("/res/icons/32x32/shutdown.png"));
 
     auto& right_container = content_container.add<GUI::Widget>();
     right_container.set_layout<GUI::VerticalBoxLayout>();
@@ -112,7 +113,7 @@ ShutdownDialog::ShutdownDialog()
     center_on_screen();
     set_resizable(false);
     set_title("Exit SerenityOS");
-    set_icon(Gfx::Bitmap::try_load_from_file("/res/icons/16x16/power.png"));
+    set_icon(GUI::IconCache::load_bitmap("/res/icons/16x16/power.png"));
 
     // Request WindowServer to re-update us on the current theme as we might've not been alive for the last notification.
     refresh_system_theme();
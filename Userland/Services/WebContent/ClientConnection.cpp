@@ -107,12 +107,17 @@ void ClientConnection::set_viewport_rect(const Gfx::IntRect& rect)
 
 void ClientConnection::add_backing_store(i32 backing_store_id, const Gfx::ShareableBitmap& bitmap)
 {
+    remove_backing_store(backing_store_id);
     m_backing_stores.set(backing_store_id, *bitmap.bitmap());
 }
 
 void ClientConnection::remove_backing_store(i32 backing_store_id)
 {
-    m_backing_stores.remove(backing_store_id);
+    auto it = m_backing_stores.find(backing_store_id);
+    if (it == m_backing_stores.end())
+        return;
+    m_page_host->forget_backing_store(*it->value);
+    m_backing_stores.remove(it);
 }
 
 void ClientConnection::paint(const Gfx::IntRect& content_rect, i32 backing_store_id)
@@ -188,6 +193,7 @@ void ClientConnection::debug_request(const String& request, const String& argume
             for (auto& sheet : doc->style_sheets().sheets()) {
                 Web::dump_sheet(sheet);
             }
+            dbgln("Selector match attempts: {}", doc->style_resolver().selector_match_attempts());
         }
     }
 
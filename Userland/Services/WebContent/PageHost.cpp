@@ -9,6 +9,8 @@
 #include <LibGfx/Painter.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/HTMLHtmlElement.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Page/BrowsingContext.h>
 #include <WebContent/WebContentClientEndpoint.h>
@@ -44,6 +46,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(const Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    m_backing_store_states.clear();
 }
 
 Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
@@ -54,6 +57,47 @@ Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
     return document->layout_node();
 }
 
+// Content that stays put in the viewport while the page scrolls underneath it can't be moved along with the rest.
+static bool has_content_fixed_to_viewport(Web::Layout::InitialContainingBlockBox& layout_root)
+{
+    if (layout_root.document().background_image())
+        return true;
+    if (auto* html = layout_root.document().html_element(); html && html->layout_node() && html->layout_node()->background_image())
+        return true;
+    bool found = false;
+    layout_root.for_each_in_inclusive_subtree_of_type<Web::Layout::Box>([&](auto& box) {
+        if (!box.is_fixed_position())
+            return IterationDecision::Continue;
+        found = true;
+        return IterationDecision::Break;
+    });
+    return found;
+}
+
+// Moves the pixels already in the bitmap by the given offset. Whatever is moved in from outside is left as it was.
+static void move_bitmap_contents(Gfx::Bitmap& bitmap, const Gfx::IntPoint& offset)
+{
+    VERIFY(bitmap.bpp() == 32);
+    int width = bitmap.physical_width() - abs(offset.x());
+    int height = bitmap.physical_height() - abs(offset.y());
+    int source_x = max(0, -offset.x());
+    int source_y = max(0, -offset.y());
+
+    auto move_row = [&](int y) {
+        auto* source = bitmap.scanline(source_y + y) + source_x;
+        auto* destination = bitmap.scanline(source_y + y + offset.y()) + source_x + offset.x();
+        memmove(destination, source, width * sizeof(Gfx::RGBA32));
+    };
+    // Rows are moved in the order that never overwrites a row before it has been moved itself.
+    if (offset.y() > 0) {
+        for (int y = height - 1; y >= 0; --y)
+            move_row(y);
+    } else {
+        for (int y = 0; y < height; ++y)
+            move_row(y);
+    }
+}
+
 void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
 {
     Gfx::Painter painter(target);
@@ -61,14 +105,46 @@ void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
 
     auto* layout_root = this->layout_root();
     if (!layout_root) {
+        m_backing_store_states.remove(&target);
         painter.fill_rect(bitmap_rect, Color::White);
         return;
     }
 
-    Web::PaintContext context(painter, palette(), content_rect.top_left());
-    context.set_should_show_line_box_borders(m_should_show_line_box_borders);
-    context.set_viewport_rect(content_rect);
-    layout_root->paint_all_phases(context);
+    // When the bitmap still holds most of what it should show, say after a scroll, that part is moved into
+    // place and only what was newly exposed or invalidated in the meantime gets painted.
+    Vector<Gfx::IntRect, 4> paint_rects;
+    auto it = m_backing_store_states.find(&target);
+    if (it != m_backing_store_states.end() && it->value.content_rect == content_rect) {
+        paint_rects.append(it->value.damage.intersected(content_rect));
+    } else if (it != m_backing_store_states.end() && it->value.content_rect.size() == content_rect.size() && target.scale() == 1
+        && it->value.content_rect.intersects(content_rect) && !has_content_fixed_to_viewport(*layout_root)) {
+        auto previous_content_rect = it->value.content_rect;
+        move_bitmap_contents(target, previous_content_rect.location() - content_rect.location());
+        paint_rects = content_rect.shatter(previous_content_rect.intersected(content_rect));
+        paint_rects.append(it->value.damage.intersected(content_rect));
+    } else {
+        paint_rects.append(content_rect);
+    }
+    m_backing_store_states.set(&target, { content_rect, {} });
+
+    for (auto& paint_rect : paint_rects) {
+        if (paint_rect.is_empty())
+            continue;
+
+        Gfx::PainterStateSaver saver(painter);
+        painter.add_clip_rect(paint_rect.translated(-content_rect.location()));
+
+        Web::PaintContext context(painter, palette(), content_rect.top_left());
+        context.set_should_show_line_box_borders(m_should_show_line_box_borders);
+        context.set_viewport_rect(content_rect);
+        context.set_paint_rect(paint_rect);
+        layout_root->paint_all_phases(context);
+    }
+}
+
+void PageHost::forget_backing_store(const Gfx::Bitmap& bitmap)
+{
+    m_backing_store_states.remove(&bitmap);
 }
 
 void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
@@ -78,14 +154,23 @@ void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
 
 void PageHost::page_did_invalidate(const Gfx::IntRect& content_rect)
 {
+    for (auto& it : m_backing_store_states)
+        it.value.damage = it.value.damage.united(content_rect);
     m_client.async_did_invalidate_content_rect(content_rect);
 }
 
 void PageHost::page_did_change_selection()
 {
+    // FIXME: Only invalidate what the old and new selection cover.
+    m_backing_store_states.clear();
     m_client.async_did_change_selection();
 }
 
+void PageHost::page_did_set_document_in_top_level_browsing_context(Web::DOM::Document*)
+{
+    m_backing_store_states.clear();
+}
+
 void PageHost::page_did_request_cursor_change(Gfx::StandardCursor cursor)
 {
     m_client.async_did_request_cursor_change((u32)cursor);
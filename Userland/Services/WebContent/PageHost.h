@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
 
@@ -25,6 +26,7 @@ public:
     const Web::Page& page() const { return *m_page; }
 
     void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&);
+    void forget_backing_store(const Gfx::Bitmap&);
 
     void set_palette_impl(const Gfx::PaletteImpl&);
     void set_viewport_rect(const Gfx::IntRect&);
@@ -61,6 +63,7 @@ private:
     virtual void page_did_request_image_context_menu(const Gfx::IntPoint&, const URL&, const String& target, unsigned modifiers, const Gfx::Bitmap*) override;
     virtual String page_did_request_cookie(const URL&, Web::Cookie::Source) override;
     virtual void page_did_set_cookie(const URL&, const Web::Cookie::ParsedCookie&, Web::Cookie::Source) override;
+    virtual void page_did_set_document_in_top_level_browsing_context(Web::DOM::Document*) override;
 
     explicit PageHost(ClientConnection&);
 
@@ -72,6 +75,14 @@ private:
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
     Gfx::IntRect m_screen_rect;
     bool m_should_show_line_box_borders { false };
+
+    // What each backing store was last painted with, so that only what was invalidated or scrolled into view
+    // since then has to be painted again.
+    struct BackingStoreState {
+        Gfx::IntRect content_rect;
+        Gfx::IntRect damage;
+    };
+    HashMap<const Gfx::Bitmap*, BackingStoreState> m_backing_store_states;
 };
 
 }
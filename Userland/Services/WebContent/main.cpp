@@ -12,7 +12,7 @@
 int main(int, char**)
 {
     Core::EventLoop event_loop;
-    if (pledge("stdio recvfd sendfd accept unix rpath", nullptr) < 0) {
+    if (pledge("stdio recvfd sendfd accept unix rpath thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
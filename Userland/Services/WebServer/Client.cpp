@@ -9,33 +9,40 @@
 #include <AK/Debug.h>
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
-#include <AK/MemoryStream.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
 #include <AK/URL.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
-#include <LibCore/File.h>
-#include <LibCore/FileStream.h>
-#include <LibCore/MimeData.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 namespace WebServer {
 
-Client::Client(NonnullRefPtr<Core::TCPSocket> socket, Core::Object* parent)
+// Requests whose headers don't fit into this are turned away.
+static constexpr size_t MaxRequestHeaderSize = 64 * KiB;
+
+Client::Client(NonnullRefPtr<Core::TCPSocket> socket, Threading::ThreadPool& thread_pool, Core::Object* parent)
     : Core::Object(parent)
     , m_socket(socket)
+    , m_thread_pool(thread_pool)
 {
 }
 
 void Client::die()
 {
+    m_read_notifier->set_enabled(false);
+    m_idle_timer->stop();
     deferred_invoke([this](auto& object) {
         NonnullRefPtr protector { object };
         remove_from_parent();
@@ -44,30 +51,94 @@ void Client::die()
 
 void Client::start()
 {
-    m_socket->on_ready_to_read = [this] {
-        StringBuilder builder;
-        for (;;) {
-            auto line = m_socket->read_line();
-            if (line.is_empty())
+    // We keep track of readability ourselves, as reading has to pause while a worker is busy with a request.
+    m_read_notifier = Core::Notifier::construct(m_socket->fd(), Core::Notifier::Event::Read, this);
+    m_read_notifier->on_ready_to_read = [this] { read_from_socket(); };
+    m_idle_timer = Core::Timer::create_single_shot(IdleTimeoutInMilliseconds, [this] { die(); }, this);
+    m_idle_timer->start();
+}
+
+void Client::read_from_socket()
+{
+    u8 buffer[PAGE_SIZE];
+    for (;;) {
+        auto nread = recv(m_socket->fd(), buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (nread < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
                 break;
-            builder.append(line);
-            builder.append("\r\n");
+            perror("recv");
+            die();
+            return;
         }
-
-        auto request = builder.to_byte_buffer();
-        dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", String::copy(request));
-        handle_request(request);
-        die();
-    };
+        if (nread == 0) {
+            die();
+            return;
+        }
+        m_received_data.append(buffer, nread);
+        if (m_received_data.size() > MaxRequestHeaderSize)
+            break;
+    }
+    handle_next_request();
 }
 
-void Client::handle_request(ReadonlyBytes raw_request)
+void Client::handle_next_request()
 {
-    auto request_or_error = HTTP::HttpRequest::from_raw_request(raw_request);
-    if (!request_or_error.has_value())
+    if (m_is_handling_request)
+        return;
+
+    auto received_bytes = m_received_data.bytes();
+    Optional<size_t> header_size;
+    for (size_t i = 3; i < received_bytes.size(); ++i) {
+        if (received_bytes.slice(i - 3, 4) == "\r\n\r\n"sv.bytes()) {
+            header_size = i + 1;
+            break;
+        }
+    }
+    if (!header_size.has_value()) {
+        if (received_bytes.size() > MaxRequestHeaderSize)
+            die();
+        return;
+    }
+
+    dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", StringView { received_bytes.trim(header_size.value()) });
+    auto request_or_error = HTTP::HttpRequest::from_raw_request(received_bytes.trim(header_size.value()));
+    // The client may have sent more requests along with this one, which we'll look at once this one is done.
+    m_received_data = ByteBuffer::copy(received_bytes.slice(header_size.value()));
+    if (!request_or_error.has_value()) {
+        die();
         return;
-    auto& request = request_or_error.value();
+    }
+    auto request = request_or_error.release_value();
+
+    // We don't read request bodies, so there's no telling where the next request would start.
+    for (auto& header : request.headers()) {
+        if (header.name.equals_ignoring_case("Content-Length") && header.value.to_uint().value_or(1) != 0)
+            request.set_keep_alive(false);
+    }
+
+    m_is_handling_request = true;
+    m_read_notifier->set_enabled(false);
+    m_idle_timer->stop();
+    m_thread_pool.submit<bool>(
+        [this, request = move(request)] {
+            return handle_request(request);
+        },
+        [this, protector = NonnullRefPtr(*this)](bool keep_connection) {
+            m_is_handling_request = false;
+            if (!keep_connection) {
+                die();
+                return;
+            }
+            m_read_notifier->set_enabled(true);
+            m_idle_timer->restart();
+            handle_next_request();
+        });
+}
 
+bool Client::handle_request(HTTP::HttpRequest const& request)
+{
     if constexpr (WEBSERVER_DEBUG) {
         dbgln("Got HTTP request: {} {}", request.method_name(), request.resource());
         for (auto& header : request.headers()) {
@@ -75,18 +146,14 @@ void Client::handle_request(ReadonlyBytes raw_request)
         }
     }
 
-    if (request.method() != HTTP::HttpRequest::Method::GET) {
-        send_error_response(501, request);
-        return;
-    }
+    if (request.method() != HTTP::HttpRequest::Method::GET)
+        return send_error_response(501, request);
 
     // Check for credentials if they are required
     if (Configuration::the().credentials().has_value()) {
         bool has_authenticated = verify_credentials(request.headers());
-        if (!has_authenticated) {
-            send_error_response(401, request, { "WWW-Authenticate: Basic realm=\"WebServer\", charset=\"UTF-8\"" });
-            return;
-        }
+        if (!has_authenticated)
+            return send_error_response(401, request, { "WWW-Authenticate: Basic realm=\"WebServer\", charset=\"UTF-8\"" });
     }
 
     auto requested_path = LexicalPath::join("/", request.resource()).string();
@@ -97,7 +164,11 @@ void Client::handle_request(ReadonlyBytes raw_request)
     path_builder.append(requested_path);
     auto real_path = path_builder.to_string();
 
-    if (Core::File::is_directory(real_path)) {
+    auto file = FileCache::the().get(real_path);
+    if (!file)
+        return send_error_response(404, request);
+
+    if (file->type == FileCache::Type::Directory) {
 
         if (!request.resource().ends_with("/")) {
             StringBuilder red;
@@ -105,41 +176,53 @@ void Client::handle_request(ReadonlyBytes raw_request)
             red.append(requested_path);
             red.append("/");
 
-            send_redirect(red.to_string(), request);
-            return;
+            return send_redirect(red.to_string(), request);
         }
 
         StringBuilder index_html_path_builder;
         index_html_path_builder.append(real_path);
         index_html_path_builder.append("/index.html");
         auto index_html_path = index_html_path_builder.to_string();
-        if (!Core::File::exists(index_html_path)) {
-            handle_directory_listing(requested_path, real_path, request);
-            return;
-        }
-        real_path = index_html_path;
+        file = FileCache::the().get(index_html_path);
+        if (!file)
+            return handle_directory_listing(requested_path, real_path, request);
     }
 
-    auto file = Core::File::construct(real_path);
-    if (!file->open(Core::OpenMode::ReadOnly)) {
-        send_error_response(404, request);
-        return;
-    }
+    if (file->type != FileCache::Type::RegularFile)
+        return send_error_response(403, request);
 
-    if (file->is_device()) {
-        send_error_response(403, request);
-        return;
-    }
-
-    Core::InputFileStream stream { file };
+    return send_file_response(file->fd, file->size, request, file->content_type);
+}
 
-    send_response(stream, request, Core::guess_mime_type_based_on_filename(real_path));
+bool Client::send(ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto nsent = ::send(m_socket->fd(), bytes.data(), bytes.size(), 0);
+        if (nsent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                pollfd socket_pollfd { m_socket->fd(), POLLOUT, 0 };
+                if (poll(&socket_pollfd, 1, -1) < 0 && errno != EINTR) {
+                    perror("poll");
+                    return false;
+                }
+                continue;
+            }
+            perror("send");
+            return false;
+        }
+        bytes = bytes.slice(nsent);
+    }
+    return true;
 }
 
-void Client::send_response(InputStream& response, HTTP::HttpRequest const& request, String const& content_type)
+bool Client::send_response_header(unsigned code, HTTP::HttpRequest const& request, String const& content_type, u64 content_length, Vector<String> const& headers)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n");
+    builder.appendff("HTTP/1.1 {} ", code);
+    builder.append(HTTP::HttpResponse::reason_phrase_for_code(code));
+    builder.append("\r\n");
     builder.append("Server: WebServer (SerenityOS)\r\n");
     builder.append("X-Frame-Options: SAMEORIGIN\r\n");
     builder.append("X-Content-Type-Options: nosniff\r\n");
@@ -147,58 +230,90 @@ void Client::send_response(InputStream& response, HTTP::HttpRequest const& reque
     builder.append("Content-Type: ");
     builder.append(content_type);
     builder.append("\r\n");
+    builder.appendff("Content-Length: {}\r\n", content_length);
+    builder.append(request.keep_alive() ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
+
+    for (auto& header : headers) {
+        builder.append(header);
+        builder.append("\r\n");
+    }
+
     builder.append("\r\n");
 
-    m_socket->write(builder.to_string());
-    log_response(200, request);
+    log_response(code, request);
+    return send(builder.string_view().bytes());
+}
 
-    char buffer[PAGE_SIZE];
-    do {
-        auto size = response.read({ buffer, sizeof(buffer) });
-        if (response.unreliable_eof() && size == 0)
-            break;
+bool Client::send_response(ReadonlyBytes response, HTTP::HttpRequest const& request, String const& content_type)
+{
+    if (!send_response_header(200, request, content_type, response.size()))
+        return false;
+    return send(response) && request.keep_alive();
+}
 
-        m_socket->write({ buffer, size });
-    } while (true);
+bool Client::send_file_response(int fd, u64 size, HTTP::HttpRequest const& request, String const& content_type)
+{
+    if (!send_response_header(200, request, content_type, size))
+        return false;
+
+    // The kernel sends the file straight from the file system, without copying it through our buffers.
+    // Other workers may be sending the same cached file at the same time, so we keep our own offset.
+    off_t offset = 0;
+    while ((u64)offset < size) {
+        auto nsent = sendfile(m_socket->fd(), fd, &offset, min<u64>(size - offset, 1 * MiB));
+        if (nsent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                pollfd socket_pollfd { m_socket->fd(), POLLOUT, 0 };
+                if (poll(&socket_pollfd, 1, -1) < 0 && errno != EINTR) {
+                    perror("poll");
+                    return false;
+                }
+                continue;
+            }
+            perror("sendfile");
+            return false;
+        }
+        // The file got shorter than the Content-Length we promised, so the response can't be completed.
+        if (nsent == 0)
+            return false;
+    }
+    return request.keep_alive();
 }
 
-void Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
+bool Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
-    StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n");
-    builder.append("Location: ");
-    builder.append(redirect_path);
-    builder.append("\r\n");
-    builder.append("\r\n");
+    StringBuilder location;
+    location.append("Location: ");
+    location.append(redirect_path);
 
-    m_socket->write(builder.to_string());
+    if (!send_response_header(301, request, "text/html", 0, { location.to_string() }))
+        return false;
+    return request.keep_alive();
+}
 
-    log_response(301, request);
+static String load_image_data(StringView path)
+{
+    auto file_or_error = MappedFile::map(path);
+    VERIFY(!file_or_error.is_error());
+    return encode_base64(file_or_error.value()->bytes());
 }
 
-static String folder_image_data()
+// Directory listings are generated on the workers, so these are initialized the thread-safe way.
+static String const& folder_image_data()
 {
-    static String cache;
-    if (cache.is_empty()) {
-        auto file_or_error = MappedFile::map("/res/icons/16x16/filetype-folder.png");
-        VERIFY(!file_or_error.is_error());
-        cache = encode_base64(file_or_error.value()->bytes());
-    }
+    static String const cache = load_image_data("/res/icons/16x16/filetype-folder.png");
     return cache;
 }
 
-static String file_image_data()
+static String const& file_image_data()
 {
-    static String cache;
-    if (cache.is_empty()) {
-        auto file_or_error = MappedFile::map("/res/icons/16x16/filetype-unknown.png");
-        VERIFY(!file_or_error.is_error());
-        cache = encode_base64(file_or_error.value()->bytes());
-    }
+    static String const cache = load_image_data("/res/icons/16x16/filetype-unknown.png");
     return cache;
 }
 
-void Client::handle_directory_listing(String const& requested_path, String const& real_path, HTTP::HttpRequest const& request)
+bool Client::handle_directory_listing(String const& requested_path, String const& real_path, HTTP::HttpRequest const& request)
 {
     StringBuilder builder;
 
@@ -272,31 +387,22 @@ void Client::handle_directory_listing(String const& requested_path, String const
     builder.append("</html>\n");
 
     auto response = builder.to_string();
-    InputMemoryStream stream { response.bytes() };
-    send_response(stream, request, "text/html");
+    return send_response(response.bytes(), request, "text/html");
 }
 
-void Client::send_error_response(unsigned code, HTTP::HttpRequest const& request, Vector<String> const& headers)
+bool Client::send_error_response(unsigned code, HTTP::HttpRequest const& request, Vector<String> const& headers)
 {
     auto reason_phrase = HTTP::HttpResponse::reason_phrase_for_code(code);
     StringBuilder builder;
-    builder.appendff("HTTP/1.0 {} ", code);
-    builder.append(reason_phrase);
-    builder.append("\r\n");
-
-    for (auto& header : headers) {
-        builder.append(header);
-        builder.append("\r\n");
-    }
-
-    builder.append("\r\n");
     builder.append("<!DOCTYPE html><html><body><h1>");
     builder.appendff("{} ", code);
     builder.append(reason_phrase);
     builder.append("</h1></body></html>");
-    m_socket->write(builder.to_string());
+    auto body = builder.to_string();
 
-    log_response(code, request);
+    if (!send_response_header(code, request, "text/html", body.length(), headers))
+        return false;
+    return send(body.bytes()) && request.keep_alive();
 }
 
 void Client::log_response(unsigned code, HTTP::HttpRequest const& request)
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibCore/TCPSocket.h>
-#include <LibHTTP/Forward.h>
+#include <LibCore/Timer.h>
+#include <LibHTTP/HttpRequest.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace WebServer {
 
@@ -16,21 +20,37 @@ class Client final : public Core::Object {
     C_OBJECT(Client);
 
 public:
+    // How long a kept-alive connection may sit idle before we close it.
+    static constexpr int IdleTimeoutInMilliseconds = 30000;
+
     void start();
 
 private:
-    Client(NonnullRefPtr<Core::TCPSocket>, Core::Object* parent);
+    Client(NonnullRefPtr<Core::TCPSocket>, Threading::ThreadPool&, Core::Object* parent);
 
-    void handle_request(ReadonlyBytes);
-    void send_response(InputStream&, HTTP::HttpRequest const&, String const& content_type);
-    void send_redirect(StringView redirect, HTTP::HttpRequest const&);
-    void send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
+    void read_from_socket();
+    void handle_next_request();
     void die();
+
+    // Everything below runs on one of the worker threads, and only touches the socket through its fd.
+    // The return values say whether the connection can be used for another request.
+    bool handle_request(HTTP::HttpRequest const&);
+    bool send(ReadonlyBytes);
+    bool send_response_header(unsigned code, HTTP::HttpRequest const&, String const& content_type, u64 content_length, Vector<String> const& headers = {});
+    bool send_response(ReadonlyBytes, HTTP::HttpRequest const&, String const& content_type);
+    bool send_file_response(int fd, u64 size, HTTP::HttpRequest const&, String const& content_type);
+    bool send_redirect(StringView redirect, HTTP::HttpRequest const&);
+    bool send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void log_response(unsigned code, HTTP::HttpRequest const&);
-    void handle_directory_listing(String const& requested_path, String const& real_path, HTTP::HttpRequest const&);
+    bool handle_directory_listing(String const& requested_path, String const& real_path, HTTP::HttpRequest const&);
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
     NonnullRefPtr<Core::TCPSocket> m_socket;
+    Threading::ThreadPool& m_thread_pool;
+    RefPtr<Core::Notifier> m_read_notifier;
+    RefPtr<Core::Timer> m_idle_timer;
+    ByteBuffer m_received_data;
+    bool m_is_handling_request { false };
 };
 
 }
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/MimeData.h>
+#include <WebServer/FileCache.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace WebServer {
+
+static bool has_expired(timespec const& expiration_time, timespec const& now)
+{
+    return now.tv_sec > expiration_time.tv_sec || (now.tv_sec == expiration_time.tv_sec && now.tv_nsec >= expiration_time.tv_nsec);
+}
+
+FileCache::Entry::~Entry()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+FileCache& FileCache::the()
+{
+    static FileCache* s_the = new FileCache;
+    return *s_the;
+}
+
+RefPtr<FileCache::Entry> FileCache::look_up(String const& path)
+{
+    auto entry = adopt_ref(*new Entry);
+    struct stat st;
+    if (stat(path.characters(), &st) < 0)
+        return {};
+
+    if (S_ISDIR(st.st_mode)) {
+        entry->type = Type::Directory;
+    } else if (S_ISREG(st.st_mode)) {
+        entry->type = Type::RegularFile;
+        entry->fd = open(path.characters(), O_RDONLY | O_CLOEXEC);
+        if (entry->fd < 0)
+            return {};
+        // The file may have been replaced since we looked, so describe the one we actually opened.
+        if (fstat(entry->fd, &st) < 0 || !S_ISREG(st.st_mode))
+            return {};
+        entry->content_type = Core::guess_mime_type_based_on_filename(path);
+    }
+    entry->size = st.st_size;
+    entry->modification_time = st.st_mtime;
+    return entry;
+}
+
+RefPtr<FileCache::Entry> FileCache::get(String const& path)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+    {
+        Threading::MutexLocker locker(m_lock);
+        if (auto it = m_entries.find(path); it != m_entries.end()) {
+            if (!has_expired(it->value->expiration_time, now))
+                return it->value;
+            m_entries.remove(it);
+        }
+    }
+
+    // Other threads can go on using the cache while we're waiting for the file system.
+    auto entry = look_up(path);
+    if (!entry)
+        return {};
+    entry->expiration_time = now;
+    entry->expiration_time.tv_sec += EntryLifetimeInMilliseconds / 1000;
+    entry->expiration_time.tv_nsec += (EntryLifetimeInMilliseconds % 1000) * 1000000;
+
+    Threading::MutexLocker locker(m_lock);
+    if (m_entries.size() >= MaxEntryCount)
+        evict_entries(now);
+    m_entries.set(path, *entry);
+    return entry;
+}
+
+void FileCache::evict_entries(timespec const& now)
+{
+    Vector<String> expired_paths;
+    for (auto& it : m_entries) {
+        if (has_expired(it.value->expiration_time, now))
+            expired_paths.append(it.key);
+    }
+    for (auto& path : expired_paths)
+        m_entries.remove(path);
+
+    // Everything is still fresh, so make room by dropping whatever comes first. Files that are being
+    // sent stay open until the sending is done, as the senders hold on to their entries.
+    while (m_entries.size() >= MaxEntryCount)
+        m_entries.remove(m_entries.begin());
+}
+
+}
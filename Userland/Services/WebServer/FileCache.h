@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <LibThreading/Mutex.h>
+#include <sys/types.h>
+#include <time.h>
+
+namespace WebServer {
+
+// What we know about the paths that were requested lately, along with open files for the regular ones, so that
+// popular files don't have to be looked up and opened again for every request. This is shared by all the worker
+// threads. Entries are only trusted for a moment, after which the file system is asked again.
+class FileCache {
+public:
+    static constexpr int EntryLifetimeInMilliseconds = 1000;
+    static constexpr size_t MaxEntryCount = 256;
+
+    enum class Type {
+        RegularFile,
+        Directory,
+        Other,
+    };
+
+    struct Entry : public RefCounted<Entry> {
+        ~Entry();
+
+        Type type { Type::Other };
+        // Only open for regular files. Read it with an explicit offset, as other threads may be using it too.
+        int fd { -1 };
+        off_t size { 0 };
+        time_t modification_time { 0 };
+        String content_type;
+        timespec expiration_time { 0, 0 };
+    };
+
+    static FileCache& the();
+
+    // Returns nothing if there's nothing at the path, or it can't be opened.
+    RefPtr<Entry> get(String const& path);
+
+private:
+    static RefPtr<Entry> look_up(String const& path);
+    void evict_entries(timespec const& now);
+
+    Threading::Mutex m_lock;
+    HashMap<String, NonnullRefPtr<Entry>> m_entries;
+};
+
+}
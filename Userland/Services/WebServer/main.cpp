@@ -11,8 +11,10 @@
 #include <LibCore/File.h>
 #include <LibCore/TCPServer.h>
 #include <LibHTTP/HttpRequest.h>
+#include <LibThreading/ThreadPool.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <signal.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -26,12 +28,14 @@ int main(int argc, char** argv)
     int port = default_port;
     String username;
     String password;
+    int thread_count = 0;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(listen_address, "IP address to listen on", "listen-address", 'l', "listen_address");
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
     args_parser.add_option(username, "HTTP basic authentication username", "user", 'U', "username");
     args_parser.add_option(password, "HTTP basic authentication password", "pass", 'P', "password");
+    args_parser.add_option(thread_count, "Number of threads handling requests (default: one per CPU)", "threads", 't', "count");
     args_parser.add_positional_argument(root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -51,6 +55,11 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (thread_count < 0) {
+        warnln("Invalid thread count: {}", thread_count);
+        return 1;
+    }
+
     auto real_root_path = Core::File::real_path_for(root_path);
 
     if (!Core::File::exists(real_root_path)) {
@@ -58,7 +67,7 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    if (pledge("stdio accept rpath inet unix", nullptr) < 0) {
+    if (pledge("stdio accept rpath inet unix thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -68,14 +77,18 @@ int main(int argc, char** argv)
     if (!username.is_empty() && !password.is_empty())
         configuration.set_credentials(HTTP::HttpRequest::BasicAuthenticationCredentials { username, password });
 
+    // Clients going away while we're still sending to them shouldn't take the whole server down.
+    signal(SIGPIPE, SIG_IGN);
+
     Core::EventLoop loop;
 
+    auto thread_pool = Threading::ThreadPool::construct(thread_count);
     auto server = Core::TCPServer::construct();
 
     server->on_ready_to_accept = [&] {
         auto client_socket = server->accept();
         VERIFY(client_socket);
-        auto client = WebServer::Client::construct(client_socket.release_nonnull(), server);
+        auto client = WebServer::Client::construct(client_socket.release_nonnull(), *thread_pool, server);
         client->start();
     };
 
@@ -98,7 +111,7 @@ int main(int argc, char** argv)
 
     unveil(nullptr, nullptr);
 
-    if (pledge("stdio accept rpath", nullptr) < 0) {
+    if (pledge("stdio accept rpath thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -1115,6 +1115,17 @@ void ClientConnection::set_flash_flush(bool enabled)
     Compositor::the().set_flash_flush(enabled);
 }
 
+Messages::WindowServer::GetComposeTimingResponse ClientConnection::get_compose_timing()
+{
+    auto& timing = Compositor::the().compose_timing();
+    return { timing.frame_count, timing.last.to_microseconds(), timing.longest.to_microseconds(), timing.total.to_microseconds() };
+}
+
+void ClientConnection::reset_compose_timing()
+{
+    Compositor::the().reset_compose_timing();
+}
+
 void ClientConnection::set_window_parent_from_client(i32 client_id, i32 parent_id, i32 child_id)
 {
     auto child_window = window_from_id(child_id);
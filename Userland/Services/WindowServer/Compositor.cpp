@@ -21,6 +21,8 @@
 #include <LibGfx/Painter.h>
 #include <LibGfx/StylePainter.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/ThreadPool.h>
+#include <time.h>
 
 namespace WindowServer {
 
@@ -96,6 +98,7 @@ void CompositorScreenData::init_bitmaps(Compositor& compositor, Screen& screen)
     m_flush_rects.clear_with_capacity();
     m_flush_transparent_rects.clear_with_capacity();
     m_flush_special_rects.clear_with_capacity();
+    m_back_buffer_stale_rects.clear_with_capacity();
 
     auto size = screen.size();
     m_front_bitmap = nullptr;
@@ -152,6 +155,39 @@ Gfx::IntPoint Compositor::window_transition_offset(Window& window)
     return window.window_stack().transition_offset();
 }
 
+// A rect of physical pixels to be copied to the same place in another bitmap of the same size.
+struct PixelCopy {
+    Gfx::Bitmap* to;
+    Gfx::Bitmap const* from;
+    Gfx::IntRect rect;
+};
+
+// Copies are cut into bands of rows, so that even a single rect spanning the whole screen is shared among the workers.
+static constexpr int pixel_copy_band_height = 64;
+
+static void append_pixel_copies(Vector<PixelCopy>& copies, Gfx::Bitmap& to, Gfx::Bitmap const& from, Gfx::IntRect const& rect)
+{
+    for (int y = rect.top(); y <= rect.bottom(); y += pixel_copy_band_height)
+        copies.append({ &to, &from, { rect.x(), y, rect.width(), min(pixel_copy_band_height, rect.bottom() + 1 - y) } });
+}
+
+// The copies must not overlap, since they are all done at once.
+static void perform_pixel_copies(Vector<PixelCopy>& copies)
+{
+    Threading::ThreadPool::the().parallel_for(copies.span(), [](PixelCopy& copy) {
+        auto& rect = copy.rect;
+        for (int y = rect.top(); y <= rect.bottom(); ++y)
+            fast_u32_copy(copy.to->scanline(y) + rect.x(), copy.from->scanline(y) + rect.x(), rect.width());
+    });
+}
+
+static Time monotonic_now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Time::from_timespec(now);
+}
+
 void Compositor::compose()
 {
     auto& wm = WindowManager::the();
@@ -169,6 +205,15 @@ void Compositor::compose()
         return;
     }
 
+    auto compose_start_time = monotonic_now();
+    ScopeGuard record_compose_time = [&] {
+        auto compose_time = monotonic_now() - compose_start_time;
+        m_compose_timing.frame_count++;
+        m_compose_timing.last = compose_time;
+        m_compose_timing.longest = max(m_compose_timing.longest, compose_time);
+        m_compose_timing.total += compose_time;
+    };
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -441,6 +486,9 @@ void Compositor::compose()
                             return color;
                         });
                     }
+                } else if (window.is_opaque()) {
+                    // Whatever an opaque window's backing store has in its alpha channel is meaningless, so it's copied straight over.
+                    painter.blit(dst, *backing_store, dirty_rect_in_backing_coordinates, 1.0f, false);
                 } else {
                     painter.blit(dst, *backing_store, dirty_rect_in_backing_coordinates, window.opacity());
                 }
@@ -562,16 +610,24 @@ void Compositor::compose()
             render_overlays();
         }
 
-        // Copy anything rendered to the temporary buffer to the back buffer
+        // Copy anything rendered to the temporary buffer to the back buffer, for all screens at once
+        Vector<PixelCopy> copies;
         Screen::for_each([&](auto& screen) {
             auto screen_rect = screen.rect();
             auto& screen_data = screen.compositor_screen_data();
             for (auto& rect : screen_data.m_flush_transparent_rects.rects())
-                screen_data.m_back_painter->blit(rect.location(), *screen_data.m_temp_bitmap, rect.translated(-screen_rect.location()));
+                append_pixel_copies(copies, *screen_data.m_back_bitmap, *screen_data.m_temp_bitmap, rect.translated(-screen_rect.location()) * screen.scale_factor());
             return IterationDecision::Continue;
         });
+        perform_pixel_copies(copies);
     }
 
+    // Everything this frame paints from here on draws over what is already in the back buffer.
+    Screen::for_each([&](auto& screen) {
+        screen.compositor_screen_data().bring_back_buffer_up_to_date(screen);
+        return IterationDecision::Continue;
+    });
+
     m_invalidated_any = false;
     m_invalidated_window = false;
     m_invalidated_cursor = false;
@@ -654,53 +710,34 @@ void Compositor::flush(Screen& screen)
     }
 
     if (screen_data.m_screen_can_set_buffer) {
+        // The buffer we flip away from is missing everything drawn this frame. Rather than copying that over now,
+        // the next frame brings it up to date, and only where it doesn't paint over it anyway.
+        if (!screen_data.m_has_flipped) {
+            screen_data.m_back_buffer_stale_rects = screen.rect();
+        } else {
+            screen_data.m_back_buffer_stale_rects.add(screen_data.m_flush_rects);
+            screen_data.m_back_buffer_stale_rects.add(screen_data.m_flush_transparent_rects);
+            screen_data.m_back_buffer_stale_rects.add(screen_data.m_flush_special_rects);
+        }
         screen_data.flip_buffers(screen);
         screen_data.m_has_flipped = true;
+        return;
     }
 
+    // Without buffer flipping, flushing means that we copy the changed rects from the
+    // backing bitmap to the display framebuffer.
+    Vector<PixelCopy> copies;
     auto do_flush = [&](Gfx::IntRect rect) {
         VERIFY(screen_rect.contains(rect));
         rect.translate_by(-screen_rect.location());
 
         // Almost everything in Compositor is in logical coordinates, with the painters having
-        // a scale applied. But this routine accesses the backbuffer pixels directly, so it
-        // must work in physical coordinates.
-        auto scaled_rect = rect * screen.scale_factor();
-        Gfx::RGBA32* front_ptr = screen_data.m_front_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        Gfx::RGBA32* back_ptr = screen_data.m_back_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        size_t pitch = screen_data.m_back_bitmap->pitch();
-
-        // NOTE: The meaning of a flush depends on whether we can flip buffers or not.
-        //
-        //       If flipping is supported, flushing means that we've flipped, and now we
-        //       copy the changed bits from the front buffer to the back buffer, to keep
-        //       them in sync.
-        //
-        //       If flipping is not supported, flushing means that we copy the changed
-        //       rects from the backing bitmap to the display framebuffer.
-
-        Gfx::RGBA32* to_ptr;
-        const Gfx::RGBA32* from_ptr;
-
-        if (screen_data.m_screen_can_set_buffer) {
-            to_ptr = back_ptr;
-            from_ptr = front_ptr;
-        } else {
-            to_ptr = front_ptr;
-            from_ptr = back_ptr;
-        }
+        // a scale applied. But the copies access the pixels directly, so they must work in
+        // physical coordinates.
+        append_pixel_copies(copies, *screen_data.m_front_bitmap, *screen_data.m_back_bitmap, rect * screen.scale_factor());
 
-        for (int y = 0; y < scaled_rect.height(); ++y) {
-            fast_u32_copy(to_ptr, from_ptr, scaled_rect.width());
-            from_ptr = (const Gfx::RGBA32*)((const u8*)from_ptr + pitch);
-            to_ptr = (Gfx::RGBA32*)((u8*)to_ptr + pitch);
-        }
-        if (device_can_flush_buffers) {
-            // Whether or not we need to flush buffers, we need to at least track what we modified
-            // so that we can flush these areas next time before we flip buffers. Or, if we don't
-            // support buffer flipping then we will flush them shortly.
+        if (device_can_flush_buffers)
             screen.queue_flush_display_rect(rect);
-        }
     };
     for (auto& rect : screen_data.m_flush_rects.rects())
         do_flush(rect);
@@ -708,15 +745,16 @@ void Compositor::flush(Screen& screen)
         do_flush(rect);
     for (auto& rect : screen_data.m_flush_special_rects.rects())
         do_flush(rect);
-    if (device_can_flush_buffers && !screen_data.m_screen_can_set_buffer) {
-        // If we also support flipping buffers we don't really need to flush these areas right now.
-        // Instead, we skip this step and just keep track of them until shortly before the next flip.
-        // If we however don't support flipping buffers then we need to flush the changed areas right
-        // now so that they can be sent to the device.
+    perform_pixel_copies(copies);
+
+    if (device_can_flush_buffers)
         screen.flush_display(screen_data.m_buffers_are_flipped ? 1 : 0);
-    }
 }
 
+// Lots of small updates (terminal output, animations) would otherwise leave the dirty area in hundreds of
+// slivers, and every one of them costs a pass over each window while composing.
+static constexpr size_t max_dirty_screen_rect_count = 64;
+
 void Compositor::invalidate_screen()
 {
     invalidate_screen(Screen::bounding_rect());
@@ -725,6 +763,7 @@ void Compositor::invalidate_screen()
 void Compositor::invalidate_screen(const Gfx::IntRect& screen_rect)
 {
     m_dirty_screen_rects.add(screen_rect.intersected(Screen::bounding_rect()));
+    m_dirty_screen_rects.limit_fragmentation(max_dirty_screen_rect_count);
 
     if (m_invalidated_any)
         return;
@@ -737,6 +776,7 @@ void Compositor::invalidate_screen(const Gfx::IntRect& screen_rect)
 void Compositor::invalidate_screen(Gfx::DisjointRectSet const& rects)
 {
     m_dirty_screen_rects.add(rects.intersected(Screen::bounding_rect()));
+    m_dirty_screen_rects.limit_fragmentation(max_dirty_screen_rect_count);
 
     if (m_invalidated_any)
         return;
@@ -934,6 +974,26 @@ void Compositor::remove_overlay(Overlay& overlay)
     overlay_rects_changed();
 }
 
+void CompositorScreenData::bring_back_buffer_up_to_date(Screen& screen)
+{
+    if (m_back_buffer_stale_rects.is_empty())
+        return;
+
+    auto screen_rect = screen.rect();
+    auto stale_rects = m_back_buffer_stale_rects.shatter(m_flush_rects).shatter(m_flush_transparent_rects).shatter(m_flush_special_rects);
+    m_back_buffer_stale_rects.clear_with_capacity();
+
+    Vector<PixelCopy> copies;
+    for (auto& rect : stale_rects.rects()) {
+        auto screen_relative_rect = rect.translated(-screen_rect.location());
+        append_pixel_copies(copies, *m_back_bitmap, *m_front_bitmap, screen_relative_rect * screen.scale_factor());
+        // The device has to be told about these before the back buffer gets flipped to the front.
+        if (screen.can_device_flush_buffers())
+            screen.queue_flush_display_rect(screen_relative_rect);
+    }
+    perform_pixel_copies(copies);
+}
+
 void CompositorScreenData::draw_cursor(Screen& screen, const Gfx::IntRect& cursor_rect)
 {
     auto& wm = WindowManager::the();
@@ -1202,6 +1262,12 @@ void Compositor::recompute_occlusions()
                 visible_opaque = move(opaque_render_rects);
 
             auto render_rect_on_screen = w.frame().render_rect().translated(transition_offset);
+            if (!remaining_visible_screen_rects.intersects(render_rect_on_screen)) {
+                // The windows in front of this one cover it entirely with their opaque parts, so nothing
+                // of it is rendered and there's no need to look at what's covering it in detail.
+                w.set_occluded(!never_occlude(w.window_stack()));
+                return IterationDecision::Continue;
+            }
             auto visible_window_rects = remaining_visible_screen_rects.intersected(w.rect().translated(transition_offset));
             Gfx::DisjointRectSet opaque_covering;
             Gfx::DisjointRectSet transparent_covering;
@@ -8,6 +8,7 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
@@ -54,10 +55,14 @@ struct CompositorScreenData {
     Gfx::DisjointRectSet m_flush_transparent_rects;
     Gfx::DisjointRectSet m_flush_special_rects;
 
+    // With buffer flipping, what the last frame drew is missing from the buffer that became the back buffer.
+    Gfx::DisjointRectSet m_back_buffer_stale_rects;
+
     Gfx::Painter& overlay_painter() { return *m_temp_painter; }
 
     void init_bitmaps(Compositor&, Screen&);
     void flip_buffers(Screen&);
+    void bring_back_buffer_up_to_date(Screen&);
     void draw_cursor(Screen&, const Gfx::IntRect&);
     bool restore_cursor_back(Screen&, Gfx::IntRect&);
 
@@ -182,6 +187,16 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    // How long compose() took, for every pass that had anything to do.
+    struct ComposeTiming {
+        u64 frame_count { 0 };
+        Time last;
+        Time longest;
+        Time total;
+    };
+    ComposeTiming const& compose_timing() const { return m_compose_timing; }
+    void reset_compose_timing() { m_compose_timing = {}; }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -219,6 +234,7 @@ private:
     bool m_invalidated_window { false };
     bool m_invalidated_cursor { false };
     bool m_overlay_rects_changed { false };
+    ComposeTiming m_compose_timing;
 
     IntrusiveList<Overlay, RawPtr<Overlay>, &Overlay::m_list_node> m_overlay_list;
     Gfx::DisjointRectSet m_overlay_rects;
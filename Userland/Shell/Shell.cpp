@@ -28,6 +28,7 @@
 #include <inttypes.h>
 #include <pwd.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -726,6 +727,60 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     argv.append(nullptr);
 
+    auto create_job = [&](pid_t child, pid_t pgid) -> RefPtr<Job> {
+        StringBuilder cmd;
+        cmd.join(" ", command.argv);
+
+        auto command_copy = AST::Command(command);
+        // Clear the next chain if it's to be immediately executed
+        // as the child will run this chain.
+        if (command.should_immediately_execute_next)
+            command_copy.next_chain.clear();
+        auto job = Job::create(child, pgid, cmd.build(), find_last_job_id() + 1, move(command_copy));
+        jobs.set((u64)child, job);
+
+        job->on_exit = [this](auto job) {
+            if (!job->exited())
+                return;
+
+            if (job->is_running_in_background() && job->should_announce_exit())
+                warnln("Shell: Job {} ({}) exited\n", job->job_id(), job->cmd());
+            else if (job->signaled() && job->should_announce_signal())
+                warnln("Shell: Job {} ({}) {}\n", job->job_id(), job->cmd(), strsignal(job->termination_signal()));
+
+            last_return_code = job->exit_code();
+            job->disown();
+
+            if (m_editor && job->exit_code() == 0 && is_allowed_to_modify_termios(job->command())) {
+                m_editor->refetch_default_termios();
+                default_termios = m_editor->default_termios();
+                termios = m_editor->termios();
+            }
+
+            run_tail(job);
+        };
+
+        fds.collect();
+
+        return *job;
+    };
+
+    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
+
+    // Whatever the shell has to run itself still needs a fork, everything else can be spawned.
+    auto can_be_spawned = !command.argv.is_empty()
+        && !command.should_immediately_execute_next
+        && !has_builtin(command.argv.first())
+        && !has_function(command.argv.first());
+    if (can_be_spawned) {
+        if (auto child = spawn_process(command, argv, rewirings, fds); child > 0) {
+            if (command.pipeline && is_first)
+                command.pipeline->pgid = child;
+            pid_t pgid = is_first ? child : command.pipeline->pgid;
+            return create_job(child, pgid);
+        }
+    }
+
     int sync_pipe[2];
     if (pipe(sync_pipe) < 0) {
         perror("pipe");
@@ -794,8 +849,6 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[0]);
 
-    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
-
     if (command.pipeline) {
         if (is_first) {
             command.pipeline->pgid = child;
@@ -827,41 +880,80 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[1]);
 
-    StringBuilder cmd;
-    cmd.join(" ", command.argv);
-
-    auto command_copy = AST::Command(command);
-    // Clear the next chain if it's to be immediately executed
-    // as the child will run this chain.
-    if (command.should_immediately_execute_next)
-        command_copy.next_chain.clear();
-    auto job = Job::create(child, pgid, cmd.build(), find_last_job_id() + 1, move(command_copy));
-    jobs.set((u64)child, job);
-
-    job->on_exit = [this](auto job) {
-        if (!job->exited())
+    return create_job(child, pgid);
+}
+
+// Launches an external command without forking first, as a fork would copy our whole (and not exactly small) address
+// space, only for the child to throw it away again right after. The redirections are done with file actions instead,
+// which mirror what the forked child would do with them. Returns -1 if that didn't work out for whatever reason, in
+// which case nothing has run yet, and the caller forks and execs as usual. That also takes care of complaining about
+// commands that can't be run.
+pid_t Shell::spawn_process(const AST::Command& command, const Vector<const char*>& argv, const NonnullRefPtrVector<AST::Rewiring>& rewirings, const FileDescriptionCollector& fds)
+{
+    auto should_set_process_group = !m_is_subshell || command.pipeline;
+    // A forked child waits for us to hand it the terminal before it execs, a spawned one has to get it from the kernel.
+    int terminal_fd = -1;
+    if (!m_is_subshell) {
+        if (isatty(STDIN_FILENO))
+            terminal_fd = STDIN_FILENO;
+        else if (isatty(STDOUT_FILENO))
+            terminal_fd = STDOUT_FILENO;
+    }
+#ifndef POSIX_SPAWN_TCSETPGROUP
+    if (terminal_fd != -1)
+        return -1;
+#endif
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    ScopeGuard destroy_file_actions = [&] { posix_spawn_file_actions_destroy(&file_actions); };
+
+    // Closing an fd that isn't open makes the spawn fail, where the forked child wouldn't have cared.
+    Vector<int, 32> closed_fds;
+    auto add_close = [&](int fd) {
+        if (closed_fds.contains_slow(fd))
             return;
+        posix_spawn_file_actions_addclose(&file_actions, fd);
+        closed_fds.append(fd);
+    };
 
-        if (job->is_running_in_background() && job->should_announce_exit())
-            warnln("Shell: Job {} ({}) exited\n", job->job_id(), job->cmd());
-        else if (job->signaled() && job->should_announce_signal())
-            warnln("Shell: Job {} ({}) {}\n", job->job_id(), job->cmd(), strsignal(job->termination_signal()));
-
-        last_return_code = job->exit_code();
-        job->disown();
-
-        if (m_editor && job->exit_code() == 0 && is_allowed_to_modify_termios(job->command())) {
-            m_editor->refetch_default_termios();
-            default_termios = m_editor->default_termios();
-            termios = m_editor->termios();
+    for (auto& rewiring : rewirings) {
+        posix_spawn_file_actions_adddup2(&file_actions, rewiring.old_fd, rewiring.new_fd);
+        closed_fds.remove_all_matching([&](int fd) { return fd == rewiring.new_fd; });
+        if (rewiring.other_pipe_end) {
+            if (rewiring.fd_action == AST::Rewiring::Close::RefreshNew)
+                add_close(rewiring.other_pipe_end->new_fd);
+            else if (rewiring.fd_action == AST::Rewiring::Close::RefreshOld)
+                add_close(rewiring.other_pipe_end->old_fd);
         }
+    }
+    for (auto fd : fds.fds())
+        add_close(fd);
 
-        run_tail(job);
-    };
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    ScopeGuard destroy_attributes = [&] { posix_spawnattr_destroy(&attributes); };
 
-    fds.collect();
+    short flags = 0;
+    if (should_set_process_group) {
+        flags |= POSIX_SPAWN_SETPGROUP;
+        posix_spawnattr_setpgroup(&attributes, command.pipeline && command.pipeline->pgid != -1 ? command.pipeline->pgid : 0);
+    }
+#ifdef POSIX_SPAWN_TCSETPGROUP
+    if (terminal_fd != -1) {
+        flags |= POSIX_SPAWN_TCSETPGROUP;
+        posix_spawnattr_tcsetpgrp_np(&attributes, terminal_fd);
+    }
+#endif
+    posix_spawnattr_setflags(&attributes, flags);
 
-    return *job;
+    pid_t child;
+    int rc = posix_spawnp(&child, argv[0], &file_actions, &attributes, const_cast<char* const*>(argv.data()), environ);
+    if (rc != 0) {
+        dbgln_if(SH_DEBUG, "posix_spawnp({}) failed: {}, falling back to fork()", argv[0], strerror(rc));
+        return -1;
+    }
+    return child;
 }
 
 void Shell::execute_process(Vector<const char*>&& argv)
@@ -301,6 +301,7 @@ private:
     void run_tail(const AST::Command&, const AST::NodeWithAction&, int head_exit_code);
 
     [[noreturn]] void execute_process(Vector<const char*>&& argv);
+    pid_t spawn_process(const AST::Command&, const Vector<const char*>& argv, const NonnullRefPtrVector<AST::Rewiring>&, const FileDescriptionCollector&);
 
     virtual void custom_event(Core::CustomEvent&) override;
 
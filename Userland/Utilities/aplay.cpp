@@ -9,6 +9,7 @@
 #include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
 #include <stdio.h>
+#include <unistd.h>
 
 int main(int argc, char** argv)
 {
@@ -23,6 +24,7 @@ int main(int argc, char** argv)
     Core::EventLoop loop;
 
     auto audio_client = Audio::ClientConnection::construct();
+    bool is_streaming = audio_client->open_stream();
     NonnullRefPtr<Audio::Loader> loader = Audio::Loader::create(path);
     if (loader->has_error()) {
         warnln("Failed to load audio file: {}", loader->error_string());
@@ -41,10 +43,15 @@ int main(int argc, char** argv)
             out("\033[u");
             out("{}/{}", loader->loaded_samples(), loader->total_samples());
             fflush(stdout);
-            audio_client->enqueue(*samples);
+            if (is_streaming)
+                audio_client->write_to_stream({ samples->samples(), static_cast<size_t>(samples->sample_count()) });
+            else
+                audio_client->enqueue(*samples);
         } else if (should_loop) {
             loader->reset();
-        } else if (audio_client->get_remaining_samples()) {
+        } else if (is_streaming && audio_client->frames_in_stream()) {
+            usleep(10000);
+        } else if (!is_streaming && audio_client->get_remaining_samples()) {
             sleep(1);
         } else {
             break;
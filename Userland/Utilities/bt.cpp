@@ -15,7 +15,7 @@
 
 int main(int argc, char** argv)
 {
-    if (pledge("stdio rpath", nullptr) < 0) {
+    if (pledge("stdio rpath thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -7,12 +7,108 @@
 #include <AK/LexicalPath.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibThreading/DirectoryWalker.h>
+#include <LibThreading/ThreadPool.h>
+#include <errno.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+struct FileToCopy {
+    String destination_path;
+    String source_path;
+    Optional<Core::File::CopyError> error;
+};
+
+struct CopiedDirectory {
+    String path;
+    mode_t mode;
+};
+
+static bool is_directory(Threading::DirectoryWalker::Entry const& entry)
+{
+    // Symlinks are followed, like Core::File::copy_file_or_directory() does.
+    if (entry.type != DT_LNK && entry.type != DT_UNKNOWN)
+        return entry.type == DT_DIR;
+    return Core::File::is_directory(entry.path);
+}
+
+// Does what Core::File::copy_directory() does, but walks the tree with a DirectoryWalker and copies the files on the
+// thread pool. The directories are all created up front on this thread, so the copies don't depend on each other.
+static Result<void, Core::File::CopyError> copy_directory(String const& destination_path, String const& source_path, Core::File::LinkMode link_mode)
+{
+    struct stat source_stat;
+    if (stat(source_path.characters(), &source_stat) < 0)
+        return Core::File::CopyError { OSError(errno), false };
+
+    if (mkdir(destination_path.characters(), 0755) < 0)
+        return Core::File::CopyError { OSError(errno), false };
+
+    auto source_real_path = String::formatted("{}/", Core::File::real_path_for(source_path));
+    auto destination_real_path = String::formatted("{}/", Core::File::real_path_for(destination_path));
+    if (destination_real_path.starts_with(source_real_path))
+        return Core::File::CopyError { OSError(EINVAL), false };
+
+    Optional<Core::File::CopyError> error;
+    Vector<CopiedDirectory> directories;
+    directories.append({ destination_path, source_stat.st_mode });
+    Vector<FileToCopy> files;
+    Vector<String> destination_stack;
+    destination_stack.append(destination_path);
+
+    Threading::DirectoryWalker walker(Core::DirIterator::SkipDots);
+    walker.on_entry = [&](auto& entry) {
+        auto entry_destination_path = String::formatted("{}/{}", destination_stack.last(), LexicalPath::basename(entry.path));
+        if (!is_directory(entry)) {
+            files.append({ move(entry_destination_path), entry.path, {} });
+            return false;
+        }
+
+        struct stat entry_stat;
+        if (stat(entry.path.characters(), &entry_stat) < 0 || mkdir(entry_destination_path.characters(), 0755) < 0) {
+            if (!error.has_value())
+                error = Core::File::CopyError { OSError(errno), false };
+            return false;
+        }
+        directories.append({ entry_destination_path, entry_stat.st_mode });
+        destination_stack.append(move(entry_destination_path));
+        return true;
+    };
+    walker.on_leave_directory = [&](auto&) {
+        destination_stack.take_last();
+    };
+    walker.on_error = [&](auto&, int error_code) {
+        if (!error.has_value())
+            error = Core::File::CopyError { OSError(error_code), false };
+    };
+    walker.walk(source_path);
+
+    Threading::ThreadPool::the().parallel_for(files.span(), [link_mode](FileToCopy& file) {
+        auto result = Core::File::copy_file_or_directory(file.destination_path, file.source_path, Core::File::RecursionMode::Disallowed, link_mode, Core::File::AddDuplicateFileMarker::No);
+        if (result.is_error())
+            file.error = result.error();
+    });
+    for (auto& file : files) {
+        if (file.error.has_value() && !error.has_value())
+            error = file.error;
+    }
+    if (error.has_value())
+        return error.release_value();
+
+    // Only now that everything is in them, in case the source directories aren't writable.
+    auto my_umask = umask(0);
+    umask(my_umask);
+    for (size_t i = directories.size(); i > 0; --i) {
+        auto& directory = directories[i - 1];
+        if (chmod(directory.path.characters(), directory.mode & ~my_umask) < 0)
+            return Core::File::CopyError { OSError(errno), false };
+    }
+    return {};
+}
+
 int main(int argc, char** argv)
 {
-    if (pledge("stdio rpath wpath cpath fattr", nullptr) < 0) {
+    if (pledge("stdio rpath wpath cpath fattr thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -39,11 +135,14 @@ int main(int argc, char** argv)
             ? String::formatted("{}/{}", destination, LexicalPath::basename(source))
             : destination;
 
-        auto result = Core::File::copy_file_or_directory(
-            destination_path, source,
-            recursion_allowed ? Core::File::RecursionMode::Allowed : Core::File::RecursionMode::Disallowed,
-            link ? Core::File::LinkMode::Allowed : Core::File::LinkMode::Disallowed,
-            Core::File::AddDuplicateFileMarker::No);
+        auto link_mode = link ? Core::File::LinkMode::Allowed : Core::File::LinkMode::Disallowed;
+        auto result = recursion_allowed && Core::File::is_directory(source)
+            ? copy_directory(destination_path, source, link_mode)
+            : Core::File::copy_file_or_directory(
+                destination_path, source,
+                recursion_allowed ? Core::File::RecursionMode::Allowed : Core::File::RecursionMode::Disallowed,
+                link_mode,
+                Core::File::AddDuplicateFileMarker::No);
 
         if (result.is_error()) {
             if (result.error().tried_recursing)
@@ -15,6 +15,8 @@
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/Object.h>
+#include <LibThreading/DirectoryWalker.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <stdio.h>
@@ -127,45 +129,22 @@ int parse_args(int argc, char** argv, Vector<String>& files, DuOption& du_option
     return 0;
 }
 
-int print_space_usage(const String& path, const DuOption& du_option, int max_depth)
+static void print_entry(const String& path, const struct stat& stat, const DuOption& du_option)
 {
-    struct stat path_stat;
-    if (lstat(path.characters(), &path_stat) < 0) {
-        perror("lstat");
-        return 1;
-    }
-
-    int ret = 0;
-
-    if (--max_depth >= 0 && S_ISDIR(path_stat.st_mode)) {
-        auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error()) {
-            warnln("du: cannot read directory '{}': {}", path, di.error_string());
-            ret = 1;
-        }
-        while (di.has_next()) {
-            const auto child_path = di.next_full_path();
-            if (du_option.all || Core::File::is_directory(child_path)) {
-                if (print_space_usage(child_path, du_option, max_depth))
-                    return 1;
-            }
-        }
-    }
-
     const auto basename = LexicalPath::basename(path);
     for (const auto& pattern : du_option.excluded_patterns) {
         if (basename.matches(pattern, CaseSensitivity::CaseSensitive))
-            return 0;
+            return;
     }
 
-    off_t size = path_stat.st_size;
+    off_t size = stat.st_size;
     if (du_option.apparent_size) {
         const auto block_size = 512;
-        size = path_stat.st_blocks * block_size;
+        size = stat.st_blocks * block_size;
     }
 
     if ((du_option.threshold > 0 && size < du_option.threshold) || (du_option.threshold < 0 && size > -du_option.threshold))
-        return 0;
+        return;
 
     if (du_option.human_readable) {
         out("{}", human_readable_size(size));
@@ -178,13 +157,13 @@ int print_space_usage(const String& path, const DuOption& du_option, int max_dep
     if (du_option.time_type == DuOption::TimeType::NotUsed) {
         outln("\t{}", path);
     } else {
-        auto time = path_stat.st_mtime;
+        auto time = stat.st_mtime;
         switch (du_option.time_type) {
         case DuOption::TimeType::Access:
-            time = path_stat.st_atime;
+            time = stat.st_atime;
             break;
         case DuOption::TimeType::Status:
-            time = path_stat.st_ctime;
+            time = stat.st_ctime;
             break;
         default:
             break;
@@ -193,6 +172,48 @@ int print_space_usage(const String& path, const DuOption& du_option, int max_dep
         const auto formatted_time = Core::DateTime::from_timestamp(time).to_string();
         outln("\t{}\t{}", formatted_time, path);
     }
+}
+
+int print_space_usage(const String& path, const DuOption& du_option, int max_depth)
+{
+    struct stat path_stat;
+    if (lstat(path.characters(), &path_stat) < 0) {
+        perror("lstat");
+        return 1;
+    }
+
+    int ret = 0;
+
+    if (max_depth > 0 && S_ISDIR(path_stat.st_mode)) {
+        // The children of a directory are printed before it, and the walker leaves a directory only after visiting them.
+        Threading::DirectoryWalker walker(Core::DirIterator::SkipParentAndBaseDir, Threading::DirectoryWalker::StatEntries::Yes);
+        walker.on_entry = [&](auto& entry) {
+            auto stat = entry.stat;
+            if (!entry.has_stat && lstat(entry.path.characters(), &stat) < 0) {
+                warnln("du: cannot access '{}': {}", entry.path, strerror(errno));
+                ret = 1;
+                return false;
+            }
+            bool is_directory = S_ISDIR(stat.st_mode);
+            if (!du_option.all && !is_directory && !(S_ISLNK(stat.st_mode) && Core::File::is_directory(entry.path)))
+                return false;
+            if (is_directory && entry.depth < static_cast<size_t>(max_depth))
+                return true;
+            print_entry(entry.path, stat, du_option);
+            return false;
+        };
+        walker.on_leave_directory = [&](auto& entry) {
+            auto stat = entry.stat;
+            if (entry.has_stat || lstat(entry.path.characters(), &stat) == 0)
+                print_entry(entry.path, stat, du_option);
+        };
+        walker.on_error = [&](auto& directory_path, int error) {
+            warnln("du: cannot read directory '{}': {}", directory_path, strerror(error));
+            ret = 1;
+        };
+        walker.walk(path);
+    }
 
+    print_entry(path, path_stat, du_option);
     return ret;
 }
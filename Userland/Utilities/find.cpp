@@ -10,12 +10,13 @@
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
 #include <AK/Vector.h>
-#include <LibCore/DirIterator.h>
+#include <LibThreading/DirectoryWalker.h>
 #include <errno.h>
 #include <getopt.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -447,27 +448,38 @@ static const char* parse_options(int argc, char* argv[])
     }
 }
 
-static void walk_tree(const char* root_path, Command& command)
+static bool should_walk_into(Threading::DirectoryWalker::Entry const& entry)
 {
-    command.evaluate(root_path);
-
-    Core::DirIterator dir_iterator(root_path, Core::DirIterator::SkipParentAndBaseDir);
-    if (dir_iterator.has_error() && dir_iterator.error() == ENOTDIR)
-        return;
-
-    while (dir_iterator.has_next()) {
-        auto path = dir_iterator.next_full_path();
+    auto type = entry.type;
+    if (type == DT_UNKNOWN) {
         struct stat stat;
-        if (g_follow_symlinks || ::lstat(path.characters(), &stat) < 0 || !S_ISLNK(stat.st_mode))
-            walk_tree(path.characters(), command);
-        else
-            command.evaluate(path.characters());
+        if (::lstat(entry.path.characters(), &stat) < 0)
+            return true;
+        if (S_ISDIR(stat.st_mode))
+            type = DT_DIR;
+        else if (S_ISLNK(stat.st_mode))
+            type = DT_LNK;
     }
+    return type == DT_DIR || (type == DT_LNK && g_follow_symlinks);
+}
 
-    if (dir_iterator.has_error()) {
-        warnln("{}: {}", root_path, dir_iterator.error_string());
+static void walk_tree(const char* root_path, Command& command)
+{
+    command.evaluate(root_path);
+
+    Threading::DirectoryWalker walker;
+    walker.on_entry = [&](auto& entry) {
+        command.evaluate(entry.path.characters());
+        return should_walk_into(entry);
+    };
+    walker.on_error = [](auto& path, int error) {
+        // Following a symlink to something that isn't a directory, or being given one as the root, is fine.
+        if (error == ENOTDIR)
+            return;
+        warnln("{}: {}", path, strerror(error));
         g_there_was_an_error = true;
-    }
+    };
+    walker.walk(root_path);
 }
 
 int main(int argc, char* argv[])
@@ -15,13 +15,20 @@ int main(int argc, char** argv)
     Vector<String> filenames;
     bool keep_input_files { false };
     bool write_to_stdout { false };
+    int thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(thread_count, "Compress on this many threads", "jobs", 'j', "count");
     args_parser.add_positional_argument(filenames, "File to compress", "FILE");
     args_parser.parse(argc, argv);
 
+    if (thread_count < 1) {
+        warnln("The number of jobs must be at least 1");
+        return 1;
+    }
+
     if (write_to_stdout)
         keep_input_files = true;
 
@@ -37,7 +44,7 @@ int main(int argc, char** argv)
         }
         auto file = file_or_error.value();
 
-        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes());
+        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes(), thread_count);
         if (!compressed_file.has_value()) {
             warnln("Failed gzip compressing input file");
             return 1;
@@ -90,6 +90,8 @@ static bool s_dump_ast = false;
 static bool s_dump_bytecode = false;
 static bool s_run_bytecode = false;
 static bool s_opt_bytecode = false;
+static bool s_jit_bytecode = false;
+static bool s_lazy_parse = false;
 static bool s_print_last_result = false;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String::formatted("{}/.js-history", Core::StandardPaths::home_directory());
@@ -616,9 +618,29 @@ static bool write_to_file(String const& path)
     return true;
 }
 
+static void dump_inline_cache_statistics(JS::Bytecode::Executable const& executable)
+{
+    auto dump_caches = [](StringView kind, auto const& caches) {
+        u64 total_hits = 0;
+        u64 total_misses = 0;
+        for (size_t i = 0; i < caches.size(); ++i) {
+            auto& cache = caches[i];
+            if (cache.hits || cache.misses)
+                outln("{} cache {}: {} hits, {} misses", kind, i, cache.hits, cache.misses);
+            total_hits += cache.hits;
+            total_misses += cache.misses;
+        }
+        outln("{} caches: {} hits, {} misses", kind, total_hits, total_misses);
+    };
+    outln();
+    dump_caches("Property lookup", executable.property_lookup_caches);
+    dump_caches("Global variable", executable.global_variable_caches);
+}
+
 static bool parse_and_run(JS::Interpreter& interpreter, StringView const& source)
 {
     auto parser = JS::Parser(JS::Lexer(source));
+    parser.set_lazy_function_parsing(s_lazy_parse);
     auto program = parser.parse_program();
 
     if (s_dump_ast)
@@ -637,6 +659,7 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView const& source
                 auto& passes = JS::Bytecode::Interpreter::optimization_pipeline();
                 passes.perform(unit);
                 dbgln("Optimisation passes took {}us", passes.elapsed());
+                passes.dump_timings();
             }
 
             if (s_dump_bytecode) {
@@ -650,7 +673,10 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView const& source
 
             if (s_run_bytecode) {
                 JS::Bytecode::Interpreter bytecode_interpreter(interpreter.global_object());
+                bytecode_interpreter.set_jit_enabled(s_jit_bytecode);
                 bytecode_interpreter.run(unit);
+                if (s_dump_bytecode)
+                    dump_inline_cache_statistics(unit);
             } else {
                 return true;
             }
@@ -907,6 +933,8 @@ int main(int argc, char** argv)
     args_parser.add_option(s_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(s_jit_bytecode, "Run the bytecode as machine code where possible", "jit", 'j');
+    args_parser.add_option(s_lazy_parse, "Only parse functions when they are first called", "lazy-parse", 'z');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
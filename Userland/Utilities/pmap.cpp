@@ -50,7 +50,7 @@ int main(int argc, char** argv)
 #endif
 
     if (extended) {
-        outln("Address{}           Size   Resident      Dirty Access  VMObject Type  Purgeable   CoW Pages Name", padding);
+        outln("Address{}           Size   Resident      Dirty     Shared    Private Access  VMObject Type  Purgeable   CoW Pages Name", padding);
     } else {
         outln("Address{}           Size Access  Name", padding);
     }
@@ -81,6 +81,8 @@ int main(int argc, char** argv)
         if (extended) {
             auto resident = map.get("amount_resident").to_string();
             auto dirty = map.get("amount_dirty").to_string();
+            auto shared = map.get("amount_shared").to_string();
+            auto private_resident = map.get("amount_private").to_string();
             auto vmobject = map.get("vmobject").to_string();
             if (vmobject.ends_with("VMObject"))
                 vmobject = vmobject.substring(0, vmobject.length() - 8);
@@ -88,6 +90,8 @@ int main(int argc, char** argv)
             auto cow_pages = map.get("cow_pages").to_string();
             out("{:>10} ", resident);
             out("{:>10} ", dirty);
+            out("{:>10} ", shared);
+            out("{:>10} ", private_resident);
             out("{:6} ", access);
             out("{:14} ", vmobject);
             out("{:10} ", purgeable);
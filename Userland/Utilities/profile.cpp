@@ -4,11 +4,36 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/StringView.h>
 #include <LibCore/ArgsParser.h>
+#include <poll.h>
 #include <serenity.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+// Moves the events that have been collected so far from the kernel into the output file.
+static bool stream_events(pid_t pid, FILE* output, bool& is_first_event)
+{
+    static char buffer[64 * KiB];
+    for (;;) {
+        auto nread = profiling_read(pid, buffer, sizeof(buffer));
+        if (nread < 0) {
+            perror("profiling_read");
+            return false;
+        }
+        if (nread == 0)
+            return true;
+        // The kernel gives us one event per line, which we turn into the "events" array of a perfcore file.
+        for (auto& event : StringView { buffer, static_cast<size_t>(nread) }.split_view('\n')) {
+            if (!is_first_event)
+                fputc(',', output);
+            is_first_event = false;
+            fwrite(event.characters_without_null_termination(), 1, event.length(), output);
+        }
+    }
+}
 
 int main(int argc, char** argv)
 {
@@ -21,6 +46,8 @@ int main(int argc, char** argv)
     bool enable = false;
     bool disable = false;
     bool all_processes = false;
+    unsigned sampling_frequency = 0;
+    const char* output_path = nullptr;
     u64 event_mask = PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
     bool seen_event_type_arg = false;
@@ -32,6 +59,8 @@ int main(int argc, char** argv)
     args_parser.add_option(free, "Free the profiling buffer for the associated process(es).", nullptr, 'f');
     args_parser.add_option(wait, "Enable profiling and wait for user input to disable.", nullptr, 'w');
     args_parser.add_option(cmd_argument, "Command", nullptr, 'c', "command");
+    args_parser.add_option(sampling_frequency, "Take samples this many times per second", nullptr, 'F', "frequency");
+    args_parser.add_option(output_path, "Stream the events into this file while waiting, so the kernel's buffer doesn't fill up", nullptr, 'o', "path");
     args_parser.add_option(Core::ArgsParser::Option {
         true, "Enable tracking specific event type", nullptr, 't', "event_type",
         [&](String event_type) {
@@ -46,6 +75,16 @@ int main(int argc, char** argv)
                 event_mask |= PERF_EVENT_KFREE;
             else if (event_type == "page_fault")
                 event_mask |= PERF_EVENT_PAGE_FAULT;
+            else if (event_type == "cpu_cycles")
+                event_mask |= PERF_EVENT_CPU_CYCLES;
+            else if (event_type == "instructions")
+                event_mask |= PERF_EVENT_INSTRUCTIONS;
+            else if (event_type == "cache_misses")
+                event_mask |= PERF_EVENT_CACHE_MISSES;
+            else if (event_type == "branch_misses")
+                event_mask |= PERF_EVENT_BRANCH_MISSES;
+            else if (event_type == "off_cpu")
+                event_mask |= PERF_EVENT_BLOCK | PERF_EVENT_UNBLOCK;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -55,7 +94,8 @@ int main(int argc, char** argv)
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, kmalloc, kfree and off_cpu.");
+        outln("If the CPU has performance-monitoring counters, it can also be one of: cpu_cycles, instructions, cache_misses and branch_misses.");
     };
 
     if (!args_parser.parse(argc, argv, Core::ArgsParser::FailureBehavior::PrintUsage)) {
@@ -72,6 +112,16 @@ int main(int argc, char** argv)
     if (!seen_event_type_arg)
         event_mask |= PERF_EVENT_SAMPLE;
 
+    if (sampling_frequency != 0 && profiling_set_sampling_frequency(sampling_frequency) < 0) {
+        perror("profiling_set_sampling_frequency");
+        return 1;
+    }
+
+    if (output_path && !wait) {
+        warnln("-o <path> requires -w.");
+        return 1;
+    }
+
     if (pid_argument || all_processes) {
         if (!(enable ^ disable ^ wait ^ free)) {
             warnln("-p <PID> requires -e xor -d xor -w xor -f.");
@@ -90,8 +140,26 @@ int main(int argc, char** argv)
                 return 0;
         }
 
+        FILE* output = nullptr;
+        bool is_first_event = true;
+        if (output_path) {
+            output = fopen(output_path, "w");
+            if (!output) {
+                perror("fopen");
+                return 1;
+            }
+            fputs("{\"events\":[", output);
+        }
+
         if (wait) {
             outln("Profiling enabled, waiting for user input to disable...");
+            if (output) {
+                pollfd input { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+                while (poll(&input, 1, 100) == 0) {
+                    if (!stream_events(pid, output, is_first_event))
+                        return 1;
+                }
+            }
             (void)getchar();
         }
 
@@ -103,6 +171,14 @@ int main(int argc, char** argv)
             outln("Profiling disabled.");
         }
 
+        if (output) {
+            if (!stream_events(pid, output, is_first_event))
+                return 1;
+            fputs("]}", output);
+            fclose(output);
+            outln("Wrote events to {}", output_path);
+        }
+
         if (free && profiling_free_buffer(pid) < 0) {
             perror("profiling_disable");
             return 1;
@@ -10,6 +10,7 @@
 #include <LibCore/File.h>
 #include <LibRegex/Regex.h>
 #include <LibTest/TestRunner.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <spawn.h>
 #include <sys/wait.h>
@@ -276,6 +277,7 @@ int main(int argc, char** argv)
     String test_glob;
     String exclude_pattern;
     String config_file;
+    String benchmark_results_path;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(Core::ArgsParser::Option {
@@ -298,6 +300,7 @@ int main(int argc, char** argv)
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     args_parser.add_option(exclude_pattern, "Regular expression to use to exclude paths from being considered tests", "exclude-pattern", 'e', "pattern");
     args_parser.add_option(config_file, "Configuration file to use", "config-file", 'c', "filename");
+    args_parser.add_option(benchmark_results_path, "Time the benchmarks, and collect their results in this file as JSON lines", "benchmark-results", 'b', "path");
     args_parser.add_positional_argument(specified_test_root, "Tests root directory", "path", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -321,6 +324,19 @@ int main(int argc, char** argv)
 
     test_root = Core::File::real_path_for(test_root);
 
+    if (!benchmark_results_path.is_empty()) {
+        // Every test appends its own results, so start out with an empty file. The tests run in their own directories,
+        // so they get passed its full path.
+        int fd = open(benchmark_results_path.characters(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            auto saved_errno = errno;
+            warnln("Couldn't open {}: {}", benchmark_results_path, strerror(saved_errno));
+            return 1;
+        }
+        close(fd);
+        setenv("BENCHMARK_RESULTS", Core::File::real_path_for(benchmark_results_path).characters(), 1);
+    }
+
     if (chdir(test_root.characters()) < 0) {
         auto saved_errno = errno;
         warnln("chdir failed: {}", strerror(saved_errno));
@@ -7,6 +7,7 @@
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibThreading/ThreadPool.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -15,7 +16,7 @@
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
-    if (pledge("stdio", nullptr) > 0) {
+    if (pledge("stdio thread", nullptr) > 0) {
         perror("pledge");
         return 1;
     }
@@ -37,7 +38,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
         lines.append({ buffer, AK::ShouldChomp::Chomp });
     }
 
-    quick_sort(lines, [](auto& a, auto& b) {
+    Threading::parallel_sort(lines.span(), [](auto& a, auto& b) {
         return strcmp(a.characters(), b.characters()) < 0;
     });
 
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Function.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Cursor.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/HashIndex.h>
+#include <LibSQL/Heap.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static int s_rows = 10000;
+static u32 s_block_size = SQL::Heap::default_block_size;
+static bool s_mapped_reads = false;
+
+// The keys are inserted and looked up in an order that is the same on every run, but not sorted.
+static Vector<int> shuffled_keys(int count)
+{
+    Vector<int> keys;
+    keys.ensure_capacity(count);
+    for (int ix = 0; ix < count; ++ix)
+        keys.unchecked_append(ix);
+
+    u32 state = 2463534242;
+    for (int ix = count - 1; ix > 0; --ix) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        swap(keys[ix], keys[state % (ix + 1)]);
+    }
+    return keys;
+}
+
+static void report(StringView what, int count, int milliseconds)
+{
+    auto per_second = milliseconds > 0 ? (u64)count * 1000 / milliseconds : (u64)count * 1000;
+    auto microseconds_each = count > 0 ? (double)milliseconds * 1000 / count : 0;
+    outln("  {:<24} {:>8} in {:>6} ms, {:>10}/s, {:.2} us each", what, count, milliseconds, per_second, microseconds_each);
+}
+
+static void report_heap(SQL::Heap const& heap)
+{
+    outln("  {} blocks read, {} blocks written, {} cache hits, {} cache misses",
+        heap.blocks_read(), heap.blocks_written(), heap.cache_hits(), heap.cache_misses());
+    outln("  {} commits, {} WAL bytes written, {} checkpoints, file is {} blocks",
+        heap.commits(), heap.wal_bytes_written(), heap.checkpoints(), heap.size());
+}
+
+static SQL::Heap::ReadMode read_mode()
+{
+    return s_mapped_reads ? SQL::Heap::ReadMode::MappedFile : SQL::Heap::ReadMode::Syscalls;
+}
+
+static int measure(Function<void()> benchmark)
+{
+    Core::ElapsedTimer timer;
+    timer.start();
+    benchmark();
+    return timer.elapsed();
+}
+
+static SQL::TupleDescriptor index_descriptor()
+{
+    SQL::TupleDescriptor descriptor;
+    descriptor.append({ "key_value", SQL::SQLType::Integer, SQL::Order::Ascending });
+    descriptor.append({ "text_value", SQL::SQLType::Text, SQL::Order::Ascending });
+    return descriptor;
+}
+
+static SQL::Key make_key(SQL::TupleDescriptor const& descriptor, int key_value)
+{
+    SQL::Key key(descriptor);
+    key[0] = key_value;
+    key[1] = String::formatted("Key {}", key_value);
+    key.set_pointer(key_value + 1);
+    return key;
+}
+
+static void benchmark_btree(String const& path, Vector<int> const& keys)
+{
+    outln("BTree:");
+    auto descriptor = index_descriptor();
+    {
+        auto heap = SQL::Heap::construct(path, s_block_size, read_mode());
+        heap->set_user_value(0, heap->new_record_pointer());
+        auto btree = SQL::BTree::construct(heap, descriptor, true, heap->user_value(0));
+        btree->on_new_root = [&]() {
+            heap->set_user_value(0, btree->root());
+        };
+
+        report("insert", keys.size(), measure([&] {
+            for (auto key_value : keys)
+                btree->insert(make_key(descriptor, key_value));
+        }));
+        report("commit", 1, measure([&] { heap->flush(); }));
+        report_heap(heap);
+    }
+    {
+        auto heap = SQL::Heap::construct(path, s_block_size, read_mode());
+        auto btree = SQL::BTree::construct(heap, descriptor, true, heap->user_value(0));
+
+        report("point lookup", keys.size(), measure([&] {
+            for (auto key_value : keys) {
+                auto key = make_key(descriptor, key_value);
+                VERIFY(btree->get(key).has_value());
+            }
+        }));
+        int count = 0;
+        report("scan", keys.size(), measure([&] {
+            for (auto iter = btree->begin(); !iter.is_end(); iter++)
+                ++count;
+        }));
+        VERIFY(count == (int)keys.size());
+        report_heap(heap);
+    }
+}
+
+static void benchmark_hash_index(String const& path, Vector<int> const& keys)
+{
+    outln("HashIndex:");
+    auto descriptor = index_descriptor();
+    {
+        auto heap = SQL::Heap::construct(path, s_block_size, read_mode());
+        auto directory_pointer = heap->new_record_pointer();
+        heap->set_user_value(0, directory_pointer);
+        auto hash_index = SQL::HashIndex::construct(heap, descriptor, directory_pointer);
+
+        report("insert", keys.size(), measure([&] {
+            for (auto key_value : keys)
+                hash_index->insert(make_key(descriptor, key_value));
+        }));
+        report("commit", 1, measure([&] { heap->flush(); }));
+        report_heap(heap);
+    }
+    {
+        auto heap = SQL::Heap::construct(path, s_block_size, read_mode());
+        auto hash_index = SQL::HashIndex::construct(heap, descriptor, heap->user_value(0));
+
+        report("point lookup", keys.size(), measure([&] {
+            for (auto key_value : keys) {
+                auto key = make_key(descriptor, key_value);
+                VERIFY(hash_index->get(key).has_value());
+            }
+        }));
+        int count = 0;
+        report("scan", keys.size(), measure([&] {
+            for (auto iter = hash_index->begin(); !iter.is_end(); iter++)
+                ++count;
+        }));
+        VERIFY(count == (int)keys.size());
+        report_heap(heap);
+    }
+}
+
+static void benchmark_database(String const& path, Vector<int> const& keys)
+{
+    outln("Database:");
+    {
+        auto db = SQL::Database::construct(path, s_block_size, read_mode());
+        auto schema = SQL::SchemaDef::construct("BenchSchema");
+        db->add_schema(schema);
+        auto table_def = SQL::TableDef::construct(schema, "BenchTable");
+        table_def->append_column("TextColumn", SQL::SQLType::Text);
+        table_def->append_column("IntColumn", SQL::SQLType::Integer);
+        db->add_table(table_def);
+        auto table = db->get_table("BenchSchema", "BenchTable");
+        VERIFY(table);
+
+        report("insert", keys.size(), measure([&] {
+            for (auto key_value : keys) {
+                SQL::Row row(*table);
+                row["TextColumn"] = String::formatted("Row {}", key_value);
+                row["IntColumn"] = key_value;
+                VERIFY(db->insert(row));
+            }
+        }));
+        report("commit", 1, measure([&] { db->commit(); }));
+        report("checkpoint", 1, measure([&] { db->checkpoint(); }));
+        report_heap(db->heap());
+    }
+    {
+        auto db = SQL::Database::construct(path, s_block_size, read_mode());
+        auto table = db->get_table("BenchSchema", "BenchTable");
+        VERIFY(table);
+
+        int count = 0;
+        report("scan", keys.size(), measure([&] {
+            auto cursor = db->scan(*table);
+            for (auto row = cursor->next(); row.has_value(); row = cursor->next())
+                ++count;
+        }));
+        VERIFY(count == (int)keys.size());
+        report("scan again", keys.size(), measure([&] {
+            count = db->select_all(*table).size();
+        }));
+        VERIFY(count == (int)keys.size());
+        report_heap(db->heap());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    char const* directory = "/tmp";
+    int block_size = s_block_size;
+    bool only_btree = false;
+    bool only_hash_index = false;
+    bool only_database = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how fast LibSQL stores and finds rows, and how much I/O that takes.");
+    args_parser.add_option(s_rows, "Number of rows or keys to store (default: 10000)", "rows", 'n', "count");
+    args_parser.add_option(block_size, "Block size of the database files in bytes (default: 1024)", "block-size", 'b', "bytes");
+    args_parser.add_option(directory, "Directory to put the database files in (default: /tmp)", "directory", 'd', "path");
+    args_parser.add_option(s_mapped_reads, "Read blocks through a mapping of the file", "mapped", 'm');
+    args_parser.add_option(only_btree, "Benchmark the BTree", "btree", 0);
+    args_parser.add_option(only_hash_index, "Benchmark the HashIndex", "hash-index", 0);
+    args_parser.add_option(only_database, "Benchmark the Database", "database", 0);
+    args_parser.parse(argc, argv);
+
+    if (s_rows <= 0 || block_size < (int)SQL::Heap::minimum_block_size || block_size > (int)SQL::Heap::maximum_block_size) {
+        warnln("Row count must be positive and the block size between {} and {}", SQL::Heap::minimum_block_size, SQL::Heap::maximum_block_size);
+        return 1;
+    }
+    s_block_size = block_size;
+    bool run_all = !only_btree && !only_hash_index && !only_database;
+
+    auto keys = shuffled_keys(s_rows);
+    auto path = String::formatted("{}/sql-bench-{}.db", directory, getpid());
+    outln("{} rows, {} byte blocks, {} reads", s_rows, s_block_size, s_mapped_reads ? "mapped" : "syscall");
+
+    auto remove_files = [&] {
+        unlink(path.characters());
+        unlink(String::formatted("{}-wal", path).characters());
+    };
+    if (run_all || only_btree) {
+        benchmark_btree(path, keys);
+        remove_files();
+    }
+    if (run_all || only_hash_index) {
+        benchmark_hash_index(path, keys);
+        remove_files();
+    }
+    if (run_all || only_database) {
+        benchmark_database(path, keys);
+        remove_files();
+    }
+    return 0;
+}
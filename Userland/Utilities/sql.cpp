@@ -163,11 +163,16 @@ int main()
             if (piece.is_empty())
                 continue;
 
-            if (piece.starts_with('.')) {
+            if (piece == ".stats") {
+                auto statistics = sql_client->statistics(the_connection_id);
+                outln("{} blocks read, {} blocks written", statistics.blocks_read(), statistics.blocks_written());
+                outln("{} cache hits, {} cache misses", statistics.cache_hits(), statistics.cache_misses());
+                outln("{} commits, {} WAL bytes written", statistics.commits(), statistics.wal_bytes_written());
+            } else if (piece.starts_with('.')) {
                 handle_command(piece);
             } else {
                 auto statement_id = sql_client->sql_statement(the_connection_id, piece);
-                sql_client->async_statement_execute(statement_id);
+                sql_client->async_statement_execute(statement_id, {});
                 return;
             }
         } while (s_keep_running);
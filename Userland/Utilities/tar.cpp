@@ -6,10 +6,13 @@
 
 #include <AK/Assertions.h>
 #include <AK/LexicalPath.h>
+#include <AK/OwnPtr.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
 #include <LibArchive/TarStream.h>
 #include <LibCompress/Gzip.h>
+#include <LibCompress/Lz4.h>
+#include <LibCompress/Zstd.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/FileStream.h>
@@ -27,6 +30,8 @@ int main(int argc, char** argv)
     bool list = false;
     bool verbose = false;
     bool gzip = false;
+    bool zstd = false;
+    bool lz4 = false;
     const char* archive_file = nullptr;
     Vector<const char*> paths;
 
@@ -36,6 +41,8 @@ int main(int argc, char** argv)
     args_parser.add_option(list, "List contents", "list", 't');
     args_parser.add_option(verbose, "Print paths", "verbose", 'v');
     args_parser.add_option(gzip, "compress or uncompress file using gzip", "gzip", 'z');
+    args_parser.add_option(zstd, "compress or uncompress file using zstd", "zstd", 0);
+    args_parser.add_option(lz4, "compress or uncompress file using lz4", "lz4", 0);
     args_parser.add_option(archive_file, "Archive file", "file", 'f', "FILE");
     args_parser.add_positional_argument(paths, "Paths", "PATHS", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
@@ -45,6 +52,11 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (gzip + zstd + lz4 > 1) {
+        warnln("at most one of --gzip, --zstd and --lz4 can be used");
+        return 1;
+    }
+
     if (list || extract) {
         auto file = Core::File::standard_input();
 
@@ -59,10 +71,17 @@ int main(int argc, char** argv)
 
         Core::InputFileStream file_stream(file);
         Compress::GzipDecompressor gzip_stream(file_stream);
-
-        InputStream& file_input_stream = file_stream;
-        InputStream& gzip_input_stream = gzip_stream;
-        Archive::TarInputStream tar_stream((gzip) ? gzip_input_stream : file_input_stream);
+        Compress::ZstdDecompressor zstd_stream(file_stream);
+        Compress::Lz4Decompressor lz4_stream(file_stream);
+
+        InputStream* input_stream = &file_stream;
+        if (gzip)
+            input_stream = &gzip_stream;
+        else if (zstd)
+            input_stream = &zstd_stream;
+        else if (lz4)
+            input_stream = &lz4_stream;
+        Archive::TarInputStream tar_stream(*input_stream);
         if (!tar_stream.valid()) {
             warnln("the provided file is not a well-formatted ustar file");
             return 1;
@@ -140,10 +159,21 @@ int main(int argc, char** argv)
 
         Core::OutputFileStream file_stream(file);
         Compress::GzipCompressor gzip_stream(file_stream);
-
-        OutputStream& file_output_stream = file_stream;
-        OutputStream& gzip_output_stream = gzip_stream;
-        Archive::TarOutputStream tar_stream((gzip) ? gzip_output_stream : file_output_stream);
+        // These have to be flushed once the archive is complete, so they only exist when they are used.
+        OwnPtr<Compress::ZstdCompressor> zstd_stream;
+        OwnPtr<Compress::Lz4Compressor> lz4_stream;
+
+        OutputStream* output_stream = &file_stream;
+        if (gzip) {
+            output_stream = &gzip_stream;
+        } else if (zstd) {
+            zstd_stream = make<Compress::ZstdCompressor>(file_stream);
+            output_stream = zstd_stream.ptr();
+        } else if (lz4) {
+            lz4_stream = make<Compress::Lz4Compressor>(file_stream);
+            output_stream = lz4_stream.ptr();
+        }
+        Archive::TarOutputStream tar_stream(*output_stream);
 
         auto add_file = [&](String path) {
             auto file = Core::File::construct(path);
@@ -194,6 +224,10 @@ int main(int argc, char** argv)
         }
 
         tar_stream.finish();
+        if (zstd_stream)
+            zstd_stream->final_flush();
+        if (lz4_stream)
+            lz4_stream->final_flush();
 
         return 0;
     }
@@ -9,66 +9,66 @@
 #include <AK/NumberFormat.h>
 #include <LibArchive/Zip.h>
 #include <LibCompress/Deflate.h>
+#include <LibCompress/Zstd.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/File.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibThreading/ThreadPool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool write_file(const String& path, ReadonlyBytes data)
 {
-    if (zip_member.is_directory) {
-        if (mkdir(zip_member.name.characters(), 0755) < 0) {
-            perror("mkdir");
+    int fd = open(path.characters(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return false;
+    while (!data.is_empty()) {
+        auto nwritten = write(fd, data.data(), data.size());
+        if (nwritten < 0) {
+            int saved_errno = errno;
+            close(fd);
+            errno = saved_errno;
             return false;
         }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
+        data = data.slice(nwritten);
     }
-    auto new_file = Core::File::construct(zip_member.name);
-    if (!new_file->open(Core::OpenMode::WriteOnly)) {
-        warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
-        return false;
-    }
-
-    if (!quiet)
-        outln(" extracting: {}", zip_member.name);
+    return close(fd) == 0;
+}
 
-    // TODO: verify CRC32s match!
+// Decompresses and writes one file member. This runs on the thread pool, so it reports problems
+// by returning an error message rather than printing them.
+static String unpack_zip_file(const Archive::ZipMember& zip_member)
+{
+    Optional<ByteBuffer> decompressed_data;
     switch (zip_member.compression_method) {
-    case Archive::ZipCompressionMethod::Store: {
-        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+    case Archive::ZipCompressionMethod::Store:
         break;
-    }
-    case Archive::ZipCompressionMethod::Deflate: {
-        auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (!decompressed_data.has_value()) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+    case Archive::ZipCompressionMethod::Deflate:
+        decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
+        break;
+    case Archive::ZipCompressionMethod::Zstd:
+        decompressed_data = Compress::ZstdDecompressor::decompress_all(zip_member.compressed_data);
         break;
-    }
     default:
         VERIFY_NOT_REACHED();
     }
 
-    if (!new_file->close()) {
-        warnln("Can't close file {}: {}", zip_member.name, new_file->error_string());
-        return false;
+    auto data = zip_member.compressed_data;
+    if (zip_member.compression_method != Archive::ZipCompressionMethod::Store) {
+        if (!decompressed_data.has_value() || decompressed_data.value().size() != zip_member.uncompressed_size)
+            return String::formatted("Failed decompressing file {}", zip_member.name);
+        data = decompressed_data.value().bytes();
     }
 
-    return true;
+    if (Crypto::Checksum::CRC32(data).digest() != zip_member.crc32)
+        return String::formatted("Checksum mismatch in file {}", zip_member.name);
+
+    if (!write_file(zip_member.name, data))
+        return String::formatted("Can't write file {}: {}", zip_member.name, strerror(errno));
+
+    return {};
 }
 
 int main(int argc, char** argv)
@@ -109,12 +109,11 @@ int main(int argc, char** argv)
         warnln("Failed to open {}: {}", zip_file_path, file_or_error.error());
         return 1;
     }
-    auto& mapped_file = *file_or_error.value();
 
     if (!quiet)
         warnln("Archive: {}", zip_file_path);
 
-    auto zip_file = Archive::Zip::try_create(mapped_file.bytes());
+    auto zip_file = Archive::Zip::try_create(file_or_error.release_value());
     if (!zip_file.has_value()) {
         warnln("Invalid zip file {}", zip_file_path);
         return 1;
@@ -134,9 +133,41 @@ int main(int argc, char** argv)
         }
     }
 
-    auto success = zip_file->for_each_member([&](auto zip_member) {
-        return unpack_zip_member(zip_member, quiet) ? IterationDecision::Continue : IterationDecision::Break;
+    // Directories are created up front, so that the files can then be unpacked in any order.
+    struct FileToUnpack {
+        Archive::ZipMember member;
+        String error;
+    };
+    Vector<FileToUnpack> files;
+    auto success = zip_file->for_each_member([&](auto& zip_member) {
+        if (!zip_member.is_directory) {
+            files.append({ zip_member, {} });
+            return IterationDecision::Continue;
+        }
+        if (mkdir(zip_member.name.characters(), 0755) < 0) {
+            perror("mkdir");
+            return IterationDecision::Break;
+        }
+        if (!quiet)
+            outln(" extracting: {}", zip_member.name);
+        return IterationDecision::Continue;
+    });
+    if (!success)
+        return 1;
+
+    // The members are independent of each other, so they are decompressed in parallel.
+    Threading::ThreadPool::the().parallel_for(files.span(), [](FileToUnpack& file) {
+        file.error = unpack_zip_file(file.member);
     });
 
+    for (auto& file : files) {
+        if (!file.error.is_null()) {
+            warnln("{}", file.error);
+            success = false;
+        } else if (!quiet) {
+            outln(" extracting: {}", file.member.name);
+        }
+    }
+
     return success ? 0 : 1;
 }
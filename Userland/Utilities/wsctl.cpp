@@ -13,12 +13,29 @@ int main(int argc, char** argv)
     auto app = GUI::Application::construct(argc, argv);
 
     int flash_flush = -1;
+    bool show_compose_timing = false;
+    bool reset_compose_timing = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(flash_flush, "Flash flush (repaint) rectangles", "flash-flush", 'f', "0/1");
+    args_parser.add_option(show_compose_timing, "Show how long composing frames took", "compose-timing", 't');
+    args_parser.add_option(reset_compose_timing, "Reset the compose timing statistics", "reset-compose-timing", 'r');
     args_parser.parse(argc, argv);
 
     if (flash_flush != -1) {
         GUI::WindowServerConnection::the().async_set_flash_flush(flash_flush);
     }
+    if (show_compose_timing) {
+        auto timing = GUI::WindowServerConnection::the().get_compose_timing();
+        auto frame_count = timing.frame_count();
+        outln("Frames composed: {}", frame_count);
+        if (frame_count > 0) {
+            outln("Last:    {} us", timing.last_microseconds());
+            outln("Longest: {} us", timing.longest_microseconds());
+            outln("Average: {} us", timing.total_microseconds() / static_cast<i64>(frame_count));
+        }
+    }
+    if (reset_compose_timing) {
+        GUI::WindowServerConnection::the().async_reset_compose_timing();
+    }
     return 0;
 }
@@ -19,14 +19,21 @@ int main(int argc, char** argv)
     Vector<String> source_paths;
     bool recurse = false;
     bool force = false;
+    int thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_positional_argument(zip_path, "Zip file path", "zipfile", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(source_paths, "Input files to be archived", "files", Core::ArgsParser::Required::Yes);
     args_parser.add_option(recurse, "Travel the directory structure recursively", "recurse-paths", 'r');
     args_parser.add_option(force, "Overwrite existing zip file", "force", 'f');
+    args_parser.add_option(thread_count, "Deflate every file on this many threads", "jobs", 0, "count");
     args_parser.parse(argc, argv);
 
+    if (thread_count < 1) {
+        warnln("The number of jobs must be at least 1");
+        return 1;
+    }
+
     String zip_file_path { zip_path };
     if (Core::File::exists(zip_file_path)) {
         if (force) {
@@ -60,7 +67,7 @@ int main(int argc, char** argv)
         Archive::ZipMember member {};
         member.name = canonicalized_path;
 
-        auto deflate_buffer = Compress::DeflateCompressor::compress_all(file_buffer);
+        auto deflate_buffer = Compress::DeflateCompressor::compress_all_in_parallel(file_buffer, thread_count);
         if (deflate_buffer.has_value() && deflate_buffer.value().size() < file_buffer.size()) {
             member.compressed_data = deflate_buffer.value().bytes();
             member.compression_method = Archive::ZipCompressionMethod::Deflate;